@@ -0,0 +1,42 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/allocator.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace pw::allocator {
+
+void* Allocator::Reallocate(void* ptr,
+                            size_t old_size,
+                            size_t alignment,
+                            size_t new_size) {
+  if (ptr == nullptr) {
+    return Allocate(new_size, alignment);
+  }
+  if (Resize(ptr, old_size, alignment, new_size)) {
+    return ptr;
+  }
+
+  void* new_ptr = Allocate(new_size, alignment);
+  if (new_ptr == nullptr) {
+    return nullptr;
+  }
+  std::memcpy(new_ptr, ptr, std::min(old_size, new_size));
+  Deallocate(ptr, old_size, alignment);
+  return new_ptr;
+}
+
+}  // namespace pw::allocator
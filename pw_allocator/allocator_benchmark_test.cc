@@ -0,0 +1,287 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Benchmarks allocators by replaying allocation traces through the Allocator
+// interface. Traces are either recorded from a device, in the TraceEvent
+// format, or generated from synthetic workloads. For each allocator and trace,
+// benchmarks the time to replay the trace, and prints the allocations that
+// failed and the fragmentation of the free memory at points through the trace.
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/freelist_heap.h"
+#include "pw_allocator/thread_cache.h"
+#include "pw_allocator/tlsf_heap.h"
+#include "pw_unit_test/benchmark.h"
+
+namespace pw::allocator {
+namespace {
+
+// One operation of a trace. A size of 0 frees the allocation in the slot;
+// otherwise the slot, which must be empty, receives a new allocation.
+struct TraceEvent {
+  uint16_t slot;
+  uint16_t size;
+};
+
+constexpr size_t kSlots = 128;
+
+// An example of a recorded trace: a request handler building and then
+// releasing a list of buffers. Traces captured from a device may be pasted in
+// this format.
+constexpr TraceEvent kRecordedTrace[] = {
+    {0, 64},  {1, 24}, {2, 200}, {3, 24}, {4, 96},  {1, 0},  {5, 512},
+    {3, 0},   {6, 24}, {2, 0},   {7, 48}, {4, 0},   {8, 128}, {5, 0},
+    {9, 300}, {6, 0},  {7, 0},   {8, 0},  {10, 32}, {9, 0},  {0, 0},
+    {10, 0},
+};
+
+// Deterministic pseudo-random numbers, so runs are comparable.
+class Lcg {
+ public:
+  uint32_t Next() {
+    state_ = state_ * 6364136223846793005u + 1442695040888963407u;
+    return uint32_t(state_ >> 33);
+  }
+
+  // Returns a number from min to max, inclusive.
+  uint32_t Between(uint32_t min, uint32_t max) {
+    return min + Next() % (max - min + 1);
+  }
+
+ private:
+  uint64_t state_ = 1;
+};
+
+constexpr size_t kOperations = 4000;
+
+// Allocates or frees a random slot, with random sizes.
+std::vector<TraceEvent> RandomSizes() {
+  std::vector<TraceEvent> trace;
+  std::array<bool, 64> used = {};
+  Lcg random;
+  while (trace.size() < kOperations) {
+    const uint16_t slot = random.Next() % used.size();
+    trace.push_back({slot, uint16_t(used[slot] ? 0 : random.Between(1, 256))});
+    used[slot] = !used[slot];
+  }
+  return trace;
+}
+
+// A producer allocates messages that a consumer frees in order, with up to 16
+// in flight.
+std::vector<TraceEvent> ProducerConsumer() {
+  constexpr size_t kQueueDepth = 16;
+  std::vector<TraceEvent> trace;
+  Lcg random;
+  size_t produced = 0;
+  size_t consumed = 0;
+  while (trace.size() < kOperations) {
+    const bool produce = produced - consumed < kQueueDepth &&
+                         (produced == consumed || random.Next() % 2 == 0);
+    if (produce) {
+      trace.push_back({uint16_t(produced++ % kQueueDepth),
+                       uint16_t(random.Between(32, 128))});
+    } else {
+      trace.push_back({uint16_t(consumed++ % kQueueDepth), 0});
+    }
+  }
+  return trace;
+}
+
+// Short-lived small allocations, interleaved with large allocations that are
+// held for a long time. The long-lived allocations split the free memory.
+std::vector<TraceEvent> LongAndShortLived() {
+  constexpr size_t kLongLivedSlots = 8;
+  constexpr size_t kShortLivedSlots = 32;
+  std::vector<TraceEvent> trace;
+  std::array<bool, kLongLivedSlots + kShortLivedSlots> used = {};
+  Lcg random;
+  while (trace.size() < kOperations) {
+    uint16_t slot;
+    uint16_t size;
+    if (random.Next() % 16 == 0) {
+      slot = random.Next() % kLongLivedSlots;
+      size = random.Between(256, 512);
+    } else {
+      slot = kLongLivedSlots + random.Next() % kShortLivedSlots;
+      size = random.Between(8, 64);
+    }
+    trace.push_back({slot, uint16_t(used[slot] ? 0 : size)});
+    used[slot] = !used[slot];
+  }
+  return trace;
+}
+
+struct Results {
+  size_t operations = 0;
+  size_t failures = 0;
+
+  // Fragmentation, in percent, after each quarter of the trace.
+  std::array<unsigned, 4> fragmentation = {};
+};
+
+constexpr size_t kHeapSize = 8192;
+
+// Returns the share of free memory outside the largest allocation that would
+// succeed. This only uses the Allocator interface, so it applies to any
+// allocator. The free memory includes allocator overhead, so an empty heap
+// does not report 0.
+unsigned MeasureFragmentation(Allocator& allocator, size_t live_bytes) {
+  size_t low = 0;
+  size_t high = kHeapSize;
+  while (low < high) {
+    const size_t size = (low + high + 1) / 2;
+    void* ptr = allocator.Allocate(size, alignof(void*));
+    if (ptr != nullptr) {
+      allocator.Deallocate(ptr, size, alignof(void*));
+      low = size;
+    } else {
+      high = size - 1;
+    }
+  }
+  const size_t free_bytes = kHeapSize - live_bytes;
+  return 100 - low * 100 / free_bytes;
+}
+
+// Replays a trace. Allocations that fail leave their slot empty, and the free
+// of that slot is skipped. If results is set, the operations, failures and
+// fragmentation are recorded; fragmentation is not measured otherwise, so that
+// it is not included in benchmark times.
+void Replay(Allocator& allocator,
+            std::span<const TraceEvent> trace,
+            Results* results = nullptr) {
+  struct Slot {
+    void* ptr;
+    size_t size;
+  };
+  std::array<Slot, kSlots> slots = {};
+  size_t live_bytes = 0;
+
+  for (size_t i = 0; i < trace.size(); ++i) {
+    Slot& slot = slots[trace[i].slot % kSlots];
+    const size_t size = trace[i].size;
+
+    if (size != 0 || slot.ptr != nullptr) {
+      if (size == 0) {
+        allocator.Deallocate(slot.ptr, slot.size, alignof(void*));
+        live_bytes -= slot.size;
+        slot = {};
+      } else {
+        slot.ptr = allocator.Allocate(size, alignof(void*));
+        if (slot.ptr != nullptr) {
+          slot.size = size;
+          live_bytes += size;
+        }
+      }
+
+      if (results != nullptr) {
+        results->operations += 1;
+        if (size != 0 && slot.ptr == nullptr) {
+          results->failures += 1;
+        }
+      }
+    }
+
+    if (results == nullptr) {
+      continue;
+    }
+    for (size_t q = 0; q < results->fragmentation.size(); ++q) {
+      if (i + 1 == trace.size() * (q + 1) / results->fragmentation.size()) {
+        results->fragmentation[q] = MeasureFragmentation(allocator, live_bytes);
+      }
+    }
+  }
+
+  for (Slot& slot : slots) {
+    allocator.Deallocate(slot.ptr, slot.size, alignof(void*));
+  }
+}
+
+// ThreadCache with a single thread needs no lock.
+struct NoLock {
+  void lock() {}
+  void unlock() {}
+};
+
+// Runs a trace against each allocator, each over a fresh heap. Each iteration
+// of the benchmark replays the whole trace, which frees every allocation it
+// makes, so the heap is empty between iterations.
+void Benchmark(const char* name, std::span<const TraceEvent> trace) {
+  auto run = [name, trace](const char* allocator_name, Allocator& allocator) {
+    Results results;
+    Replay(allocator, trace, &results);
+    EXPECT_GT(results.operations, 0u);
+    std::printf(
+        "%s, %s: %zu of %zu operations failed, "
+        "fragmentation %u%% %u%% %u%% %u%%\n",
+        name,
+        allocator_name,
+        results.failures,
+        results.operations,
+        results.fragmentation[0],
+        results.fragmentation[1],
+        results.fragmentation[2],
+        results.fragmentation[3]);
+
+    char case_name[64];
+    std::snprintf(case_name,
+                  sizeof(case_name),
+                  "%s, %s (%zu events)",
+                  name,
+                  allocator_name,
+                  trace.size());
+    unit_test::RunBenchmark(
+        case_name, {}, [&allocator, trace](unit_test::BenchmarkState& state) {
+          for (auto _ : state) {
+            Replay(allocator, trace);
+          }
+        });
+  };
+
+  alignas(Block) static std::byte buffer[kHeapSize];
+  {
+    FreeListHeapBuffer heap(buffer);
+    run("FreeListHeap", heap.allocator());
+  }
+  {
+    TlsfHeap heap(buffer);
+    run("TlsfHeap", heap);
+  }
+  {
+    TlsfHeap heap(buffer);
+    NoLock lock;
+    ThreadCache cache(heap, lock);
+    run("ThreadCache", cache);
+  }
+}
+
+TEST(AllocatorBenchmark, RecordedTrace) {
+  Benchmark("Recorded trace", kRecordedTrace);
+}
+
+TEST(AllocatorBenchmark, SyntheticWorkloads) {
+  Benchmark("Random sizes", RandomSizes());
+  Benchmark("Producer/consumer", ProducerConsumer());
+  Benchmark("Long and short lived", LongAndShortLived());
+}
+
+}  // namespace
+}  // namespace pw::allocator
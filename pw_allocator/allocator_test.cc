@@ -0,0 +1,128 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/allocator.h"
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include "gtest/gtest.h"
+#include "pw_allocator/arena.h"
+#include "pw_allocator/fixed_block_allocator.h"
+#include "pw_allocator/freelist_heap.h"
+#include "pw_allocator/tlsf_heap.h"
+
+namespace pw::allocator {
+namespace {
+
+constexpr size_t kRegionSize = 1024;
+
+// Exercises an allocator only through the Allocator interface.
+void AllocateAndFree(Allocator& allocator) {
+  void* ptr = allocator.Allocate(24, alignof(uint32_t));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(ptr) % alignof(uint32_t));
+  std::memset(ptr, 0x5a, 24);
+
+  EXPECT_TRUE(allocator.Resize(ptr, 24, alignof(uint32_t), 16));
+  allocator.Deallocate(ptr, 16, alignof(uint32_t));
+  allocator.Deallocate(nullptr, 16, alignof(uint32_t));
+
+  EXPECT_EQ(nullptr, allocator.Allocate(0, 1));
+}
+
+TEST(Allocator, FreeListHeap) {
+  alignas(Block) std::byte buf[kRegionSize];
+  FreeListHeapBuffer heap(buf);
+  AllocateAndFree(heap.allocator());
+}
+
+TEST(Allocator, TlsfHeap) {
+  alignas(Block) std::byte buf[kRegionSize];
+  TlsfHeap heap(buf);
+  AllocateAndFree(heap);
+}
+
+TEST(Allocator, Arena) {
+  alignas(std::max_align_t) std::byte buf[kRegionSize];
+  Arena arena(buf);
+  AllocateAndFree(arena);
+}
+
+TEST(Allocator, FixedBlockAllocator) {
+  alignas(uint32_t) std::byte buf[kRegionSize];
+  FixedBlockAllocator blocks(buf, 32);
+  AllocateAndFree(blocks);
+
+  Allocator& allocator = blocks;
+  EXPECT_EQ(nullptr, allocator.Allocate(33, 1));
+  EXPECT_EQ(nullptr, allocator.Allocate(16, 64));
+}
+
+TEST(Allocator, HeapRejectsLargeAlignment) {
+  alignas(Block) std::byte buf[kRegionSize];
+  TlsfHeap heap(buf);
+  Allocator& allocator = heap;
+  EXPECT_EQ(nullptr, allocator.Allocate(16, 2 * alignof(Block)));
+}
+
+TEST(Allocator, ReallocateMovesAndCopies) {
+  alignas(std::max_align_t) std::byte buf[kRegionSize];
+  Arena arena(buf);
+  Allocator& allocator = arena;
+
+  uint8_t* first = static_cast<uint8_t*>(allocator.Allocate(4, 1));
+  ASSERT_NE(first, nullptr);
+  std::memcpy(first, "abc", 4);
+
+  // The newest allocation grows in place.
+  EXPECT_EQ(first, allocator.Reallocate(first, 4, 1, 8));
+
+  // An older allocation must move.
+  ASSERT_NE(allocator.Allocate(4, 1), nullptr);
+  uint8_t* moved = static_cast<uint8_t*>(allocator.Reallocate(first, 8, 1, 16));
+  ASSERT_NE(moved, nullptr);
+  EXPECT_NE(first, moved);
+  EXPECT_STREQ("abc", reinterpret_cast<char*>(moved));
+
+  EXPECT_EQ(nullptr, allocator.Reallocate(moved, 16, 1, kRegionSize));
+}
+
+struct Counted {
+  Counted(int v) : value(v) { count++; }
+  ~Counted() { count--; }
+
+  int value;
+  static int count;
+};
+
+int Counted::count = 0;
+
+TEST(Allocator, NewAndDelete) {
+  alignas(Block) std::byte buf[kRegionSize];
+  TlsfHeap heap(buf);
+  Allocator& allocator = heap;
+
+  Counted* object = allocator.New<Counted>(7);
+  ASSERT_NE(object, nullptr);
+  EXPECT_EQ(7, object->value);
+  EXPECT_EQ(1, Counted::count);
+
+  allocator.Delete(object);
+  EXPECT_EQ(0, Counted::count);
+}
+
+}  // namespace
+}  // namespace pw::allocator
@@ -0,0 +1,89 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/arena.h"
+
+#include <cstdint>
+
+#include "pw_assert/assert.h"
+
+namespace pw::allocator {
+namespace {
+
+uintptr_t AlignUp(uintptr_t value, size_t alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+}  // namespace
+
+void* Arena::DoAllocate(size_t size, size_t alignment) {
+  PW_DCHECK(alignment != 0u && (alignment & (alignment - 1)) == 0u,
+            "Alignment must be a power of two");
+
+  const uintptr_t start = reinterpret_cast<uintptr_t>(region_.data());
+  const size_t offset = AlignUp(start + offset_, alignment) - start;
+  if (offset <= region_.size() && size <= region_.size() - offset) {
+    offset_ = offset + size;
+    return region_.data() + offset;
+  }
+  return AllocateOverflow(size, alignment);
+}
+
+bool Arena::DoResize(void* ptr, size_t old_size, size_t, size_t new_size) {
+  if (new_size <= old_size) {
+    return true;
+  }
+
+  // Overflow allocations are not in the region, so never grow.
+  std::byte* bytes = static_cast<std::byte*>(ptr);
+  if (bytes < region_.data() || bytes >= region_.data() + offset_) {
+    return false;
+  }
+  const size_t offset = bytes - region_.data();
+  if (offset + old_size != offset_ || new_size > region_.size() - offset) {
+    return false;
+  }
+  offset_ = offset + new_size;
+  return true;
+}
+
+void* Arena::AllocateOverflow(size_t size, size_t alignment) {
+  if (overflow_heap_ == nullptr) {
+    return nullptr;
+  }
+
+  // Leave room to align the allocation after the header.
+  void* raw =
+      overflow_heap_->Allocate(sizeof(OverflowHeader) + alignment - 1 + size);
+  if (raw == nullptr) {
+    return nullptr;
+  }
+
+  OverflowHeader* header = static_cast<OverflowHeader*>(raw);
+  header->next = overflow_;
+  overflow_ = header;
+  return reinterpret_cast<void*>(AlignUp(
+      reinterpret_cast<uintptr_t>(header) + sizeof(OverflowHeader), alignment));
+}
+
+void Arena::RollBack(const Mark& mark) {
+  while (overflow_ != mark.overflow) {
+    OverflowHeader* next = overflow_->next;
+    overflow_heap_->Free(overflow_);
+    overflow_ = next;
+  }
+  offset_ = mark.offset;
+}
+
+}  // namespace pw::allocator
@@ -0,0 +1,149 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/arena.h"
+
+#include <cstdint>
+#include <span>
+
+#include "gtest/gtest.h"
+
+namespace pw::allocator {
+namespace {
+
+constexpr size_t kArenaSize = 256;
+
+TEST(Arena, AllocatesInOrder) {
+  alignas(std::max_align_t) std::byte buf[kArenaSize];
+  Arena arena(buf);
+
+  std::byte* first = static_cast<std::byte*>(arena.Allocate(10, 1));
+  std::byte* second = static_cast<std::byte*>(arena.Allocate(6, 1));
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(first, buf);
+  EXPECT_EQ(second, buf + 10);
+  EXPECT_EQ(16u, arena.used_bytes());
+  EXPECT_EQ(kArenaSize - 16, arena.available_bytes());
+}
+
+TEST(Arena, AlignsAllocations) {
+  alignas(std::max_align_t) std::byte buf[kArenaSize];
+  Arena arena(buf);
+
+  ASSERT_NE(arena.Allocate(1, 1), nullptr);
+  void* ptr = arena.Allocate(8, 8);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(ptr) % 8);
+  EXPECT_EQ(16u, arena.used_bytes());
+
+  uint32_t* value = arena.New<uint32_t>(42u);
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(value) % alignof(uint32_t));
+  EXPECT_EQ(42u, *value);
+}
+
+TEST(Arena, ReturnsNullWhenFullWithoutOverflow) {
+  alignas(std::max_align_t) std::byte buf[kArenaSize];
+  Arena arena(buf);
+
+  EXPECT_NE(arena.Allocate(kArenaSize, 1), nullptr);
+  EXPECT_EQ(arena.Allocate(1, 1), nullptr);
+  EXPECT_EQ(0u, arena.available_bytes());
+}
+
+TEST(Arena, ResetReleasesEverything) {
+  alignas(std::max_align_t) std::byte buf[kArenaSize];
+  Arena arena(buf);
+
+  ASSERT_NE(arena.Allocate(kArenaSize - 16, 1), nullptr);
+  arena.Reset();
+  EXPECT_EQ(0u, arena.used_bytes());
+  EXPECT_EQ(buf, arena.Allocate(kArenaSize, 1));
+}
+
+TEST(Arena, ScopeRollsBack) {
+  alignas(std::max_align_t) std::byte buf[kArenaSize];
+  Arena arena(buf);
+
+  ASSERT_NE(arena.Allocate(32, 1), nullptr);
+  {
+    Arena::Scope scope(arena);
+    ASSERT_NE(arena.Allocate(64, 1), nullptr);
+    {
+      Arena::Scope inner(arena);
+      ASSERT_NE(arena.Allocate(64, 1), nullptr);
+      EXPECT_EQ(160u, arena.used_bytes());
+    }
+    EXPECT_EQ(96u, arena.used_bytes());
+  }
+  EXPECT_EQ(32u, arena.used_bytes());
+}
+
+class ArenaWithOverflow : public ::testing::Test {
+ protected:
+  static constexpr size_t kHeapSize = 1024;
+
+  ArenaWithOverflow()
+      : freelist_({16, 32, 64, 128, 256, 512}),
+        heap_(heap_buffer_, freelist_),
+        arena_(arena_buffer_, &heap_) {}
+
+  bool HeapCanAllocate(size_t size) {
+    void* ptr = heap_.Allocate(size);
+    if (ptr == nullptr) {
+      return false;
+    }
+    heap_.Free(ptr);
+    return true;
+  }
+
+  alignas(std::max_align_t) std::byte arena_buffer_[kArenaSize];
+  alignas(Block) std::byte heap_buffer_[kHeapSize];
+  FreeListBuffer<6> freelist_;
+  FreeListHeap heap_;
+  Arena arena_;
+};
+
+TEST_F(ArenaWithOverflow, OverflowsToHeap) {
+  ASSERT_NE(arena_.Allocate(kArenaSize, 1), nullptr);
+
+  std::byte* ptr = static_cast<std::byte*>(arena_.Allocate(100, 8));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_TRUE(ptr >= heap_buffer_ && ptr < heap_buffer_ + kHeapSize);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(ptr) % 8);
+  EXPECT_EQ(kArenaSize, arena_.used_bytes());
+
+  // The heap cannot satisfy this, so the arena returns null.
+  EXPECT_EQ(arena_.Allocate(kHeapSize, 1), nullptr);
+}
+
+TEST_F(ArenaWithOverflow, ScopeFreesOverflowAllocations) {
+  constexpr size_t kLargeSize = 600;
+  ASSERT_NE(arena_.Allocate(kArenaSize, 1), nullptr);
+  ASSERT_NE(arena_.Allocate(100, 1), nullptr);
+  {
+    Arena::Scope scope(arena_);
+    ASSERT_NE(arena_.Allocate(kLargeSize, 1), nullptr);
+    EXPECT_FALSE(HeapCanAllocate(kLargeSize));
+  }
+  EXPECT_TRUE(HeapCanAllocate(kLargeSize));
+
+  // The allocation made before the scope is only freed on Reset.
+  EXPECT_FALSE(HeapCanAllocate(kHeapSize - 100));
+  arena_.Reset();
+  EXPECT_TRUE(HeapCanAllocate(kHeapSize - 100));
+}
+
+}  // namespace
+}  // namespace pw::allocator
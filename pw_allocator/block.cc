@@ -14,6 +14,7 @@
 
 #include "pw_allocator/block.h"
 
+#include <algorithm>
 #include <cstring>
 
 namespace pw::allocator {
@@ -245,4 +246,31 @@ bool Block::CheckPoisonBytes() const {
   return true;
 }
 
+void Block::PoisonFreeSpace(size_t start, size_t end) {
+#if defined(PW_ALLOCATOR_POISON_ENABLE) && PW_ALLOCATOR_POISON_ENABLE
+  end = std::min(end, InnerSize());
+  if (start < end) {
+    memset(UsableSpace() + start, static_cast<int>(FREE_PATTERN), end - start);
+  }
+#else
+  static_cast<void>(start);
+  static_cast<void>(end);
+#endif  // PW_ALLOCATOR_POISON_ENABLE
+}
+
+bool Block::CheckFreePattern(size_t start) const {
+#if defined(PW_ALLOCATOR_POISON_ENABLE) && PW_ALLOCATOR_POISON_ENABLE
+  const std::byte* usable_space = reinterpret_cast<const std::byte*>(this) +
+                                  sizeof(*this) + PW_ALLOCATOR_POISON_OFFSET;
+  for (size_t i = start; i < InnerSize(); ++i) {
+    if (usable_space[i] != FREE_PATTERN) {
+      return false;
+    }
+  }
+#else
+  static_cast<void>(start);
+#endif  // PW_ALLOCATOR_POISON_ENABLE
+  return true;
+}
+
 }  // namespace pw::allocator
@@ -408,4 +408,23 @@ TEST(Block, CanPoisonBlock) {
 #endif  // PW_ALLOCATOR_POISON_ENABLE
 }
 
+TEST(Block, CanPoisonFreeSpace) {
+  constexpr size_t kN = 1024;
+  alignas(Block*) byte bytes[kN] = {};
+
+  Block* block = nullptr;
+  Block::Init(std::span(bytes, kN), &block);
+
+  block->PoisonFreeSpace(16, kN);
+  EXPECT_TRUE(block->CheckFreePattern(16));
+
+#if defined(PW_ALLOCATOR_POISON_ENABLE) && PW_ALLOCATOR_POISON_ENABLE
+  EXPECT_FALSE(block->CheckFreePattern(0));
+
+  block->UsableSpace()[100] = std::byte(0);
+  EXPECT_FALSE(block->CheckFreePattern(16));
+  EXPECT_TRUE(block->CheckFreePattern(101));
+#endif  // PW_ALLOCATOR_POISON_ENABLE
+}
+
 }  // namespace pw::allocator
@@ -0,0 +1,93 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/fixed_block_allocator.h"
+
+#include "pw_assert/assert.h"
+
+namespace pw::allocator {
+
+FixedBlockAllocator::FixedBlockAllocator(std::span<std::byte> region,
+                                         size_t block_size,
+                                         Concurrency concurrency)
+    : region_(region),
+      block_size_(block_size),
+      block_count_(std::min<size_t>(region.size() / block_size, kEndIndex - 1)),
+      concurrency_(concurrency),
+      head_(kEndIndex) {
+  const size_t block_size_alignment = block_size % alignof(uint32_t);
+  PW_CHECK_UINT_EQ(block_size_alignment, 0);
+  PW_CHECK_UINT_GE(block_size, sizeof(uint32_t));
+
+  // Link the blocks in address order.
+  for (size_t i = 0; i < block_count_; ++i) {
+    NextIndex(i) = i + 1 < block_count_ ? i + 1 : kEndIndex;
+  }
+  if (block_count_ != 0u) {
+    head_.store(0, std::memory_order_relaxed);
+  }
+}
+
+void* FixedBlockAllocator::Allocate() {
+  uint32_t head = head_.load(std::memory_order_acquire);
+  uint32_t index;
+  if (concurrency_ == Concurrency::kSingleContext) {
+    index = head & kIndexMask;
+    if (index == kEndIndex) {
+      return nullptr;
+    }
+    head_.store(NewHead(head, NextIndex(index)), std::memory_order_relaxed);
+  } else {
+    // If another context takes this block first, the next index read here may
+    // be stale, but the counter makes the compare-and-swap fail.
+    do {
+      index = head & kIndexMask;
+      if (index == kEndIndex) {
+        return nullptr;
+      }
+    } while (!head_.compare_exchange_weak(head,
+                                          NewHead(head, NextIndex(index)),
+                                          std::memory_order_acq_rel,
+                                          std::memory_order_acquire));
+  }
+  return region_.data() + index * block_size_;
+}
+
+void FixedBlockAllocator::Free(void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  PW_DCHECK(Contains(ptr), "Freed pointer is not from this allocator");
+
+  const size_t offset = static_cast<std::byte*>(ptr) - region_.data();
+  const size_t offset_in_block = offset % block_size_;
+  PW_DCHECK_UINT_EQ(offset_in_block, 0);
+  const uint32_t index = offset / block_size_;
+
+  uint32_t head = head_.load(std::memory_order_relaxed);
+  if (concurrency_ == Concurrency::kSingleContext) {
+    NextIndex(index) = head & kIndexMask;
+    head_.store(NewHead(head, index), std::memory_order_release);
+    return;
+  }
+
+  do {
+    NextIndex(index) = head & kIndexMask;
+  } while (!head_.compare_exchange_weak(head,
+                                        NewHead(head, index),
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed));
+}
+
+}  // namespace pw::allocator
@@ -0,0 +1,145 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/fixed_block_allocator.h"
+
+#include <cstdint>
+#include <span>
+
+#include "gtest/gtest.h"
+
+namespace pw::allocator {
+namespace {
+
+constexpr size_t kBlockSize = 32;
+constexpr size_t kBlockCount = 8;
+
+TEST(FixedBlockAllocator, AllocatesEveryBlockOnce) {
+  alignas(uint32_t) std::byte buf[kBlockSize * kBlockCount + 10];
+  FixedBlockAllocator allocator(buf, kBlockSize);
+  EXPECT_EQ(kBlockCount, allocator.block_count());
+  EXPECT_EQ(kBlockSize, allocator.block_size());
+
+  void* blocks[kBlockCount];
+  for (size_t i = 0; i < kBlockCount; ++i) {
+    blocks[i] = allocator.Allocate();
+    ASSERT_NE(blocks[i], nullptr);
+    EXPECT_TRUE(allocator.Contains(blocks[i]));
+
+    const size_t offset = static_cast<std::byte*>(blocks[i]) - buf;
+    EXPECT_EQ(0u, offset % kBlockSize);
+    for (size_t j = 0; j < i; ++j) {
+      EXPECT_NE(blocks[i], blocks[j]);
+    }
+  }
+
+  EXPECT_EQ(nullptr, allocator.Allocate());
+  EXPECT_FALSE(allocator.Contains(buf + kBlockSize * kBlockCount));
+}
+
+TEST(FixedBlockAllocator, FreedBlockIsReused) {
+  alignas(uint32_t) std::byte buf[kBlockSize * kBlockCount];
+  FixedBlockAllocator allocator(buf, kBlockSize);
+
+  void* blocks[kBlockCount];
+  for (void*& block : blocks) {
+    block = allocator.Allocate();
+  }
+
+  allocator.Free(blocks[3]);
+  allocator.Free(blocks[5]);
+  allocator.Free(nullptr);
+
+  // Blocks are reused last freed first.
+  EXPECT_EQ(blocks[5], allocator.Allocate());
+  EXPECT_EQ(blocks[3], allocator.Allocate());
+  EXPECT_EQ(nullptr, allocator.Allocate());
+}
+
+TEST(FixedBlockAllocator, LockFree_AllocateAndFree) {
+  alignas(uint32_t) std::byte buf[kBlockSize * kBlockCount];
+  FixedBlockAllocator allocator(
+      buf, kBlockSize, FixedBlockAllocator::Concurrency::kLockFree);
+
+  void* blocks[kBlockCount];
+  for (void*& block : blocks) {
+    block = allocator.Allocate();
+    ASSERT_NE(block, nullptr);
+  }
+  EXPECT_EQ(nullptr, allocator.Allocate());
+
+  for (void* block : blocks) {
+    allocator.Free(block);
+  }
+  for (size_t i = 0; i < kBlockCount; ++i) {
+    EXPECT_NE(nullptr, allocator.Allocate());
+  }
+  EXPECT_EQ(nullptr, allocator.Allocate());
+}
+
+TEST(FixedBlockAllocator, RegionSmallerThanBlock) {
+  alignas(uint32_t) std::byte buf[kBlockSize - 4];
+  FixedBlockAllocator allocator(buf, kBlockSize);
+  EXPECT_EQ(0u, allocator.block_count());
+  EXPECT_EQ(nullptr, allocator.Allocate());
+}
+
+struct Object {
+  Object(int a, int b) : sum(a + b) { constructed++; }
+  ~Object() { destroyed++; }
+
+  int sum;
+  char padding[13];
+
+  static int constructed;
+  static int destroyed;
+};
+
+int Object::constructed = 0;
+int Object::destroyed = 0;
+
+TEST(Pool, NewAndDelete) {
+  Pool<Object, 3> pool;
+  Object::constructed = 0;
+  Object::destroyed = 0;
+
+  Object* a = pool.New(1, 2);
+  Object* b = pool.New(3, 4);
+  Object* c = pool.New(5, 6);
+  ASSERT_NE(a, nullptr);
+  ASSERT_NE(b, nullptr);
+  ASSERT_NE(c, nullptr);
+  EXPECT_EQ(3, a->sum);
+  EXPECT_EQ(7, b->sum);
+  EXPECT_EQ(11, c->sum);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(b) % alignof(Object));
+
+  EXPECT_EQ(nullptr, pool.New(0, 0));
+  EXPECT_EQ(3, Object::constructed);
+
+  pool.Delete(b);
+  EXPECT_EQ(1, Object::destroyed);
+  Object* d = pool.New(10, 20);
+  EXPECT_EQ(b, d);
+  EXPECT_EQ(30, d->sum);
+
+  pool.Delete(a);
+  pool.Delete(c);
+  pool.Delete(d);
+  pool.Delete(nullptr);
+  EXPECT_EQ(4, Object::destroyed);
+}
+
+}  // namespace
+}  // namespace pw::allocator
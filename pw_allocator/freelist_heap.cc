@@ -14,6 +14,7 @@
 
 #include "pw_allocator/freelist_heap.h"
 
+#include <algorithm>
 #include <cstring>
 
 #include "pw_assert/assert.h"
@@ -26,6 +27,7 @@ FreeListHeap::FreeListHeap(std::span<std::byte> region, FreeList& freelist)
   Block* block;
   Block::Init(region, &block);
 
+  PoisonFree(block, region.data(), region.data() + region.size());
   freelist_.AddChunk(BlockToSpan(block));
 
   region_ = region;
@@ -56,6 +58,8 @@ void* FreeListHeap::Allocate(size_t size) {
   chunk_block->MarkUsed();
 
   heap_stats_.bytes_allocated += size;
+  heap_stats_.peak_bytes_allocated = std::max(heap_stats_.peak_bytes_allocated,
+                                              heap_stats_.bytes_allocated);
   heap_stats_.cumulative_allocated += size;
   heap_stats_.total_allocate_calls += 1;
 
@@ -80,6 +84,14 @@ void FreeListHeap::Free(void* ptr) {
     return;
   }
   chunk_block->MarkFree();
+
+  // The bytes to paint as freed: the block, from the guard bytes of a previous
+  // block it merges with, up to the freelist node of a next block it merges
+  // with. The rest of the free neighbours is painted already.
+  const std::byte* poison_begin =
+      reinterpret_cast<std::byte*>(chunk_block) - PW_ALLOCATOR_POISON_OFFSET;
+  const std::byte* poison_end = region_.data() + region_.size();
+
   // Can we combine with the left or right blocks?
   Block* prev = chunk_block->Prev();
   Block* next = nullptr;
@@ -98,9 +110,12 @@ void FreeListHeap::Free(void* ptr) {
   }
 
   if (next != nullptr && !next->Used()) {
+    poison_end = next->UsableSpace() + FreeList::NodeSize();
     freelist_.RemoveChunk(BlockToSpan(next));
     chunk_block->MergeNext();
   }
+  PoisonFree(chunk_block, poison_begin, poison_end);
+
   // Add back to the freelist
   freelist_.AddChunk(BlockToSpan(chunk_block));
 
@@ -109,6 +124,55 @@ void FreeListHeap::Free(void* ptr) {
   heap_stats_.total_free_calls += 1;
 }
 
+void* FreeListHeap::DoAllocate(size_t size, size_t alignment) {
+  return alignment <= alignof(Block) ? Allocate(size) : nullptr;
+}
+
+bool FreeListHeap::DoResize(void* ptr, size_t, size_t, size_t new_size) {
+  return ResizeInPlace(Block::FromUsableSpace(static_cast<std::byte*>(ptr)),
+                       new_size);
+}
+
+bool FreeListHeap::ResizeInPlace(Block* block, size_t size) {
+  const size_t old_size = block->InnerSize();
+
+  // Free bytes from a next block are painted, after its freelist node.
+  const std::byte* poison_end = region_.data() + region_.size();
+
+  // Blocks are only split and merged while free.
+  block->MarkFree();
+  if (size > old_size) {
+    Block* next = block->Last() ? nullptr : block->Next();
+    if (next == nullptr || next->Used() ||
+        old_size + next->OuterSize() < size) {
+      block->MarkUsed();
+      return false;
+    }
+    poison_end = next->UsableSpace() + FreeList::NodeSize();
+    freelist_.RemoveChunk(BlockToSpan(next));
+    block->MergeNext();
+  }
+
+  // Give back the tail, if it can hold a block, merged with a free next block.
+  Block* leftover;
+  if (block->Split(size, &leftover).ok()) {
+    if (!leftover->Last() && !leftover->Next()->Used()) {
+      poison_end = leftover->Next()->UsableSpace() + FreeList::NodeSize();
+      freelist_.RemoveChunk(BlockToSpan(leftover->Next()));
+      leftover->MergeNext();
+    }
+    PoisonFree(leftover, leftover->UsableSpace(), poison_end);
+    freelist_.AddChunk(BlockToSpan(leftover));
+  }
+  block->MarkUsed();
+
+  heap_stats_.bytes_allocated += block->InnerSize();
+  heap_stats_.bytes_allocated -= old_size;
+  heap_stats_.peak_bytes_allocated = std::max(heap_stats_.peak_bytes_allocated,
+                                              heap_stats_.bytes_allocated);
+  return true;
+}
+
 // Follows constract of the C standard realloc() function
 // If ptr is free'd, will return nullptr.
 void* FreeListHeap::Realloc(void* ptr, size_t size) {
@@ -135,10 +199,8 @@ void* FreeListHeap::Realloc(void* ptr, size_t size) {
   }
   size_t old_size = chunk_block->InnerSize();
 
-  // Do nothing and return ptr if the required memory size is smaller than
-  // the current size.
-  // TODO: Currently do not support shrink of memory chunk.
-  if (old_size >= size) {
+  // Shrink, or grow into a free next block, without copying if possible.
+  if (ResizeInPlace(chunk_block, size)) {
     return ptr;
   }
 
@@ -161,6 +223,62 @@ void* FreeListHeap::Calloc(size_t num, size_t size) {
   return ptr;
 }
 
+FreeListHeap::FreeBlockStats FreeListHeap::GetFreeBlockStats() const {
+  FreeBlockStats stats = {};
+  const Block* block = reinterpret_cast<const Block*>(region_.data());
+  while (true) {
+    if (!block->Used()) {
+      stats.free_bytes += block->InnerSize();
+      stats.free_blocks += 1;
+      stats.largest_free_block =
+          std::max(stats.largest_free_block, block->InnerSize());
+    }
+    if (block->Last()) {
+      break;
+    }
+    block = block->Next();
+  }
+  return stats;
+}
+
+Status FreeListHeap::CheckIntegrity() const {
+  const std::byte* region_end = region_.data() + region_.size();
+  const Block* block = reinterpret_cast<const Block*>(region_.data());
+  while (true) {
+    // Check the link to the next block before IsValid follows it.
+    const std::byte* next = reinterpret_cast<const std::byte*>(block->Next());
+    if (next > region_end || block->Last() != (next == region_end) ||
+        !block->IsValid()) {
+      PW_LOG_ERROR("The heap block at %p is corrupted.", block);
+      return Status::DataLoss();
+    }
+    if (!block->Used() && !block->CheckFreePattern(FreeList::NodeSize())) {
+      PW_LOG_ERROR("The free heap block at %p was written after it was freed.",
+                   block);
+      return Status::DataLoss();
+    }
+    if (block->Last()) {
+      return OkStatus();
+    }
+    block = block->Next();
+  }
+}
+
+void FreeListHeap::PoisonFree(Block* block,
+                              const std::byte* begin,
+                              const std::byte* end) {
+#if defined(PW_ALLOCATOR_POISON_ENABLE) && PW_ALLOCATOR_POISON_ENABLE
+  const std::byte* usable_space = block->UsableSpace();
+  const size_t start = begin > usable_space ? begin - usable_space : 0u;
+  block->PoisonFreeSpace(std::max(start, FreeList::NodeSize()),
+                         end > usable_space ? end - usable_space : 0u);
+#else
+  static_cast<void>(block);
+  static_cast<void>(begin);
+  static_cast<void>(end);
+#endif  // PW_ALLOCATOR_POISON_ENABLE
+}
+
 void FreeListHeap::LogHeapStats() {
   PW_LOG_INFO(" ");
   PW_LOG_INFO("    The current heap information: ");
@@ -168,6 +286,8 @@ void FreeListHeap::LogHeapStats() {
               static_cast<unsigned int>(heap_stats_.total_bytes));
   PW_LOG_INFO("          The current allocated heap memory is %u bytes.",
               static_cast<unsigned int>(heap_stats_.bytes_allocated));
+  PW_LOG_INFO("          The peak allocated heap memory is %u bytes.",
+              static_cast<unsigned int>(heap_stats_.peak_bytes_allocated));
   PW_LOG_INFO("          The cumulative allocated heap memory is %u bytes.",
               static_cast<unsigned int>(heap_stats_.cumulative_allocated));
   PW_LOG_INFO("          The cumulative freed heap memory is %u bytes.",
@@ -179,6 +299,13 @@ void FreeListHeap::LogHeapStats() {
   PW_LOG_INFO(
       "          free() is called %u times. (realloc() counted as one time)",
       static_cast<unsigned int>(heap_stats_.total_free_calls));
+
+  const FreeBlockStats free_blocks = GetFreeBlockStats();
+  PW_LOG_INFO("          The largest of %u free blocks is %u bytes.",
+              static_cast<unsigned int>(free_blocks.free_blocks),
+              static_cast<unsigned int>(free_blocks.largest_free_block));
+  PW_LOG_INFO("          The free heap memory is %u%% fragmented.",
+              static_cast<unsigned int>(free_blocks.fragmentation_percent()));
   PW_LOG_INFO(" ");
 }
 
@@ -14,6 +14,7 @@
 
 #include "pw_allocator/freelist_heap.h"
 
+#include <cstring>
 #include <span>
 
 #include "gtest/gtest.h"
@@ -207,10 +208,60 @@ TEST(FreeListHeap, ReallocSmallerSize) {
   void* ptr1 = allocator.Allocate(kAllocSize);
   void* ptr2 = allocator.Realloc(ptr1, kNewAllocSize);
 
-  // For smaller sizes, Realloc will not shrink the block.
+  // For smaller sizes, Realloc shrinks the block in place.
   EXPECT_EQ(ptr1, ptr2);
 }
 
+TEST(FreeListHeap, ReallocShrinkReturnsTail) {
+  constexpr size_t N = 2048;
+  constexpr size_t kAllocSize = 1024;
+  constexpr size_t kNewAllocSize = 256;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  FreeListHeapBuffer allocator(buf);
+
+  void* ptr1 = allocator.Allocate(kAllocSize);
+  void* ptr2 = allocator.Allocate(kAllocSize / 2);
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  EXPECT_EQ(nullptr, allocator.Allocate(kAllocSize / 2));
+
+  EXPECT_EQ(ptr1, allocator.Realloc(ptr1, kNewAllocSize));
+
+  // The tail of the first block is free again.
+  void* ptr3 = allocator.Allocate(kAllocSize / 2);
+  ASSERT_NE(ptr3, nullptr);
+  EXPECT_GT(ptr3, ptr1);
+  EXPECT_LT(ptr3, ptr2);
+}
+
+TEST(FreeListHeap, ReallocGrowsIntoFreeNextBlock) {
+  constexpr size_t N = 2048;
+  constexpr size_t kAllocSize = 256;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  FreeListHeapBuffer allocator(buf);
+
+  int* ptr1 = static_cast<int*>(allocator.Allocate(kAllocSize));
+  void* ptr2 = allocator.Allocate(kAllocSize);
+  void* ptr3 = allocator.Allocate(kAllocSize);
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  ASSERT_NE(ptr3, nullptr);
+  *ptr1 = 42;
+
+  // Once the next block is free, the block grows into it without moving.
+  allocator.Free(ptr2);
+  EXPECT_EQ(ptr1, allocator.Realloc(ptr1, 2 * kAllocSize));
+  EXPECT_EQ(42, *ptr1);
+
+  // The next block is in use, so the block moves.
+  int* moved = static_cast<int*>(allocator.Realloc(ptr1, 3 * kAllocSize));
+  ASSERT_NE(moved, nullptr);
+  EXPECT_NE(ptr1, moved);
+  EXPECT_EQ(42, *moved);
+}
+
 TEST(FreeListHeap, ReallocTooLarge) {
   constexpr size_t N = 2048;
   constexpr size_t kAllocSize = 512;
@@ -227,6 +278,101 @@ TEST(FreeListHeap, ReallocTooLarge) {
   EXPECT_EQ(nullptr, ptr2);
 }
 
+TEST(FreeListHeap, FreeBlockStats) {
+  constexpr size_t N = 2048;
+  constexpr size_t kAllocSize = 256;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  FreeListHeapBuffer allocator(buf);
+
+  void* ptrs[3];
+  for (void*& ptr : ptrs) {
+    ptr = allocator.Allocate(kAllocSize);
+    ASSERT_NE(ptr, nullptr);
+  }
+  allocator.Free(ptrs[1]);
+
+  const FreeListHeap::FreeBlockStats stats = allocator.GetFreeBlockStats();
+  EXPECT_EQ(2u, stats.free_blocks);
+  EXPECT_EQ(kAllocSize, stats.free_bytes - stats.largest_free_block);
+  EXPECT_EQ(100 - stats.largest_free_block * 100 / stats.free_bytes,
+            stats.fragmentation_percent());
+  EXPECT_EQ(3 * kAllocSize, allocator.heap_stats().peak_bytes_allocated);
+}
+
+TEST(FreeListHeap, CheckIntegrityOfValidHeap) {
+  constexpr size_t N = 2048;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  FreeListHeapBuffer allocator(buf);
+  EXPECT_EQ(OkStatus(), allocator.CheckIntegrity());
+
+  void* ptrs[4];
+  for (void*& ptr : ptrs) {
+    ptr = allocator.Allocate(128);
+    ASSERT_NE(ptr, nullptr);
+  }
+  allocator.Free(ptrs[1]);
+  allocator.Free(ptrs[2]);
+  ptrs[0] = allocator.Realloc(ptrs[0], 64);
+  ptrs[3] = allocator.Realloc(ptrs[3], 512);
+  ASSERT_NE(ptrs[3], nullptr);
+  EXPECT_EQ(OkStatus(), allocator.CheckIntegrity());
+
+  allocator.Free(ptrs[0]);
+  allocator.Free(ptrs[3]);
+  EXPECT_EQ(OkStatus(), allocator.CheckIntegrity());
+}
+
+TEST(FreeListHeap, CheckIntegrityFindsCorruptedHeader) {
+  constexpr size_t N = 2048;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  FreeListHeapBuffer allocator(buf);
+  void* ptr1 = allocator.Allocate(128);
+  void* ptr2 = allocator.Allocate(128);
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+
+  // Clobber the prev pointer in the header of the second block.
+  Block* block = Block::FromUsableSpace(static_cast<std::byte*>(ptr2));
+  std::memset(reinterpret_cast<std::byte*>(block) + sizeof(Block*),
+              0x55,
+              sizeof(Block*));
+  EXPECT_EQ(Status::DataLoss(), allocator.CheckIntegrity());
+}
+
+#if defined(PW_ALLOCATOR_POISON_ENABLE) && PW_ALLOCATOR_POISON_ENABLE
+TEST(FreeListHeap, CheckIntegrityFindsOverflow) {
+  constexpr size_t N = 2048;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  FreeListHeapBuffer allocator(buf);
+  std::byte* ptr = static_cast<std::byte*>(allocator.Allocate(128));
+  ASSERT_NE(ptr, nullptr);
+  ASSERT_NE(allocator.Allocate(128), nullptr);
+  EXPECT_EQ(OkStatus(), allocator.CheckIntegrity());
+
+  ptr[128] = std::byte(0);
+  EXPECT_EQ(Status::DataLoss(), allocator.CheckIntegrity());
+}
+
+TEST(FreeListHeap, CheckIntegrityFindsWriteAfterFree) {
+  constexpr size_t N = 2048;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  FreeListHeapBuffer allocator(buf);
+  std::byte* ptr = static_cast<std::byte*>(allocator.Allocate(128));
+  ASSERT_NE(ptr, nullptr);
+  ASSERT_NE(allocator.Allocate(128), nullptr);
+  allocator.Free(ptr);
+  EXPECT_EQ(OkStatus(), allocator.CheckIntegrity());
+
+  ptr[100] = std::byte(0);
+  EXPECT_EQ(Status::DataLoss(), allocator.CheckIntegrity());
+}
+#endif  // PW_ALLOCATOR_POISON_ENABLE
+
 TEST(FreeListHeap, CanCalloc) {
   constexpr size_t N = 2048;
   constexpr size_t kAllocSize = 128;
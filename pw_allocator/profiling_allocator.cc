@@ -0,0 +1,123 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/profiling_allocator.h"
+
+namespace pw::allocator {
+
+void* ProfilingAllocator::AllocateFrom(uint32_t call_site,
+                                       size_t size,
+                                       size_t alignment) {
+  if (size == 0) {
+    return nullptr;
+  }
+
+  const size_t header_size = HeaderSize(alignment);
+  std::byte* raw = static_cast<std::byte*>(
+      allocator_.Allocate(header_size + size, InnerAlignment(alignment)));
+  if (raw == nullptr) {
+    failures_.Increment();
+    return nullptr;
+  }
+
+  void* ptr = raw + header_size;
+  HeaderOf(ptr).call_site = call_site;
+
+  allocations_.Increment();
+  RecordSize(size);
+  AddUsedBytes(size);
+  AddToCallSite(call_site, size);
+  return ptr;
+}
+
+void ProfilingAllocator::DoDeallocate(void* ptr,
+                                      size_t size,
+                                      size_t alignment) {
+  deallocations_.Increment();
+  used_bytes_.Set(used_bytes_.value() - size);
+  AddToCallSite(HeaderOf(ptr).call_site, -static_cast<uint32_t>(size));
+
+  const size_t header_size = HeaderSize(alignment);
+  allocator_.Deallocate(static_cast<std::byte*>(ptr) - header_size,
+                        header_size + size,
+                        InnerAlignment(alignment));
+}
+
+bool ProfilingAllocator::DoResize(void* ptr,
+                                  size_t old_size,
+                                  size_t alignment,
+                                  size_t new_size) {
+  const size_t header_size = HeaderSize(alignment);
+  if (!allocator_.Resize(static_cast<std::byte*>(ptr) - header_size,
+                         header_size + old_size,
+                         InnerAlignment(alignment),
+                         header_size + new_size)) {
+    return false;
+  }
+
+  const uint32_t delta = new_size - old_size;
+  used_bytes_.Set(used_bytes_.value() - old_size);
+  AddUsedBytes(new_size);
+  AddToCallSite(HeaderOf(ptr).call_site, delta);
+  return true;
+}
+
+void ProfilingAllocator::UpdateHeapMetrics() {
+  if (heap_ == nullptr) {
+    return;
+  }
+  const FreeListHeap::FreeBlockStats stats = heap_->GetFreeBlockStats();
+  largest_free_block_.Set(stats.largest_free_block);
+  fragmentation_percent_.Set(stats.fragmentation_percent());
+}
+
+void ProfilingAllocator::RecordSize(size_t size) {
+  if (size <= 16) {
+    size_16_.Increment();
+  } else if (size <= 64) {
+    size_64_.Increment();
+  } else if (size <= 256) {
+    size_256_.Increment();
+  } else if (size <= 1024) {
+    size_1024_.Increment();
+  } else {
+    size_larger_.Increment();
+  }
+}
+
+void ProfilingAllocator::AddToCallSite(uint32_t call_site, uint32_t delta) {
+  if (call_site == kUnknownCallSite) {
+    return;
+  }
+
+  // Sites after the first kMaxCallSites are only counted in the totals.
+  for (std::optional<metric::TypedMetric<uint32_t>>& site : call_site_bytes_) {
+    if (!site.has_value()) {
+      site.emplace(call_site, 0u, call_sites_.metrics());
+    }
+    if (site->name() == (call_site & 0x7fff'ffff)) {
+      site->Increment(delta);
+      return;
+    }
+  }
+}
+
+void ProfilingAllocator::AddUsedBytes(size_t size) {
+  used_bytes_.Increment(size);
+  if (used_bytes_.value() > peak_bytes_.value()) {
+    peak_bytes_.Set(used_bytes_.value());
+  }
+}
+
+}  // namespace pw::allocator
@@ -0,0 +1,158 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/profiling_allocator.h"
+
+#include <cstdint>
+#include <span>
+
+#include "gtest/gtest.h"
+
+namespace pw::allocator {
+namespace {
+
+class ProfilingAllocatorTest : public ::testing::Test {
+ protected:
+  static constexpr size_t kHeapSize = 2048;
+
+  ProfilingAllocatorTest()
+      : freelist_({16, 32, 64, 128, 256, 512}),
+        heap_(std::span(buffer_), freelist_),
+        profiler_(heap_, &heap_) {}
+
+  // Returns the value of the metric with the given name in group.
+  static std::optional<uint32_t> MetricValue(const metric::Group& group,
+                                             metric::Token name) {
+    for (const metric::Metric& metric : group.metrics()) {
+      if (metric.name() == (name & 0x7fff'ffff)) {
+        return metric.as_int();
+      }
+    }
+    return std::nullopt;
+  }
+
+  const metric::Group* Child(metric::Token name) {
+    for (const metric::Group& group : profiler_.metrics().children()) {
+      if (group.name() == name) {
+        return &group;
+      }
+    }
+    return nullptr;
+  }
+
+  alignas(Block) std::byte buffer_[kHeapSize];
+  FreeListBuffer<6> freelist_;
+  FreeListHeap heap_;
+  ProfilingAllocator profiler_;
+};
+
+TEST_F(ProfilingAllocatorTest, TracksUsedAndPeakBytes) {
+  Allocator& allocator = profiler_;
+
+  void* first = allocator.Allocate(100, alignof(uint32_t));
+  void* second = allocator.Allocate(200, alignof(uint32_t));
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(second) % alignof(uint32_t));
+  EXPECT_EQ(300u, profiler_.used_bytes());
+
+  allocator.Deallocate(first, 100, alignof(uint32_t));
+  EXPECT_EQ(200u, profiler_.used_bytes());
+  EXPECT_EQ(300u, profiler_.peak_bytes());
+
+  EXPECT_TRUE(allocator.Resize(second, 200, alignof(uint32_t), 150));
+  EXPECT_EQ(150u, profiler_.used_bytes());
+  allocator.Deallocate(second, 150, alignof(uint32_t));
+  EXPECT_EQ(0u, profiler_.used_bytes());
+
+  EXPECT_EQ(nullptr, allocator.Allocate(kHeapSize, 1));
+  const metric::Group& metrics = profiler_.metrics();
+  EXPECT_EQ(2u, MetricValue(metrics, PW_TOKENIZER_STRING_TOKEN("allocations")));
+  EXPECT_EQ(2u, MetricValue(metrics, PW_TOKENIZER_STRING_TOKEN("deallocations")));
+  EXPECT_EQ(1u, MetricValue(metrics, PW_TOKENIZER_STRING_TOKEN("failures")));
+}
+
+TEST_F(ProfilingAllocatorTest, SizeHistogram) {
+  Allocator& allocator = profiler_;
+  for (size_t size : {1, 16, 17, 300, 1100}) {
+    void* ptr = allocator.Allocate(size, 1);
+    ASSERT_NE(ptr, nullptr);
+    allocator.Deallocate(ptr, size, 1);
+  }
+
+  const metric::Group* histogram = Child(PW_TOKENIZER_STRING_TOKEN("size_histogram"));
+  ASSERT_NE(histogram, nullptr);
+  EXPECT_EQ(2u, MetricValue(*histogram, PW_TOKENIZER_STRING_TOKEN("up_to_16")));
+  EXPECT_EQ(1u, MetricValue(*histogram, PW_TOKENIZER_STRING_TOKEN("up_to_64")));
+  EXPECT_EQ(0u, MetricValue(*histogram, PW_TOKENIZER_STRING_TOKEN("up_to_256")));
+  EXPECT_EQ(1u, MetricValue(*histogram, PW_TOKENIZER_STRING_TOKEN("up_to_1024")));
+  EXPECT_EQ(1u, MetricValue(*histogram, PW_TOKENIZER_STRING_TOKEN("larger")));
+}
+
+TEST_F(ProfilingAllocatorTest, TracksCallSites) {
+  constexpr uint32_t kSiteA = 0x1234;
+  constexpr uint32_t kSiteB = 0x5678;
+
+  void* a1 = profiler_.AllocateFrom(kSiteA, 40, 1);
+  void* a2 = profiler_.AllocateFrom(kSiteA, 24, 1);
+  void* b = profiler_.AllocateFrom(kSiteB, 8, 1);
+  void* c = PW_ALLOCATOR_PROFILED_ALLOCATE(profiler_, 12, 1);
+  ASSERT_NE(a1, nullptr);
+  ASSERT_NE(a2, nullptr);
+  ASSERT_NE(b, nullptr);
+  ASSERT_NE(c, nullptr);
+
+  Allocator& allocator = profiler_;
+  allocator.Deallocate(a1, 40, 1);
+
+  const metric::Group* sites = Child(PW_TOKENIZER_STRING_TOKEN("call_sites"));
+  ASSERT_NE(sites, nullptr);
+  EXPECT_EQ(24u, MetricValue(*sites, kSiteA));
+  EXPECT_EQ(8u, MetricValue(*sites, kSiteB));
+
+  // The macro's call site is the one left.
+  size_t site_count = 0;
+  for (const metric::Metric& metric : sites->metrics()) {
+    site_count += 1;
+    if (metric.name() != kSiteA && metric.name() != kSiteB) {
+      EXPECT_EQ(12u, metric.as_int());
+    }
+  }
+  EXPECT_EQ(3u, site_count);
+}
+
+TEST_F(ProfilingAllocatorTest, HeapMetrics) {
+  Allocator& allocator = profiler_;
+  void* ptrs[3];
+  for (void*& ptr : ptrs) {
+    ptr = allocator.Allocate(256, 1);
+    ASSERT_NE(ptr, nullptr);
+  }
+  allocator.Deallocate(ptrs[1], 256, 1);
+
+  profiler_.UpdateHeapMetrics();
+  const FreeListHeap::FreeBlockStats stats = heap_.GetFreeBlockStats();
+  EXPECT_EQ(2u, stats.free_blocks);
+  EXPECT_GT(stats.fragmentation_percent(), 0u);
+
+  const metric::Group& metrics = profiler_.metrics();
+  EXPECT_EQ(stats.largest_free_block,
+            MetricValue(metrics, PW_TOKENIZER_STRING_TOKEN("largest_free_block")));
+  EXPECT_EQ(
+      stats.fragmentation_percent(),
+      MetricValue(metrics, PW_TOKENIZER_STRING_TOKEN("fragmentation_percent")));
+}
+
+}  // namespace
+}  // namespace pw::allocator
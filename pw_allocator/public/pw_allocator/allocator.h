@@ -0,0 +1,87 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace pw::allocator {
+
+// Interface for memory allocators, so that code which allocates can be given
+// the allocation strategy that suits it, such as a FreeListHeap, TlsfHeap,
+// Arena or FixedBlockAllocator.
+//
+// The size and alignment of an allocation are passed back to Deallocate and
+// Resize, so implementations need not store them.
+class Allocator {
+ public:
+  virtual ~Allocator() = default;
+
+  // Returns size bytes aligned to alignment, which must be a power of two, or
+  // nullptr if the allocation fails. Allocators may not support alignments
+  // larger than their natural alignment, in which case they return nullptr.
+  void* Allocate(size_t size, size_t alignment) {
+    return size == 0 ? nullptr : DoAllocate(size, alignment);
+  }
+
+  // Releases an allocation from Allocate. ptr may be nullptr.
+  void Deallocate(void* ptr, size_t size, size_t alignment) {
+    if (ptr != nullptr) {
+      DoDeallocate(ptr, size, alignment);
+    }
+  }
+
+  // Changes the size of an allocation in place. Returns false, leaving the
+  // allocation unchanged, if it cannot be resized without moving it.
+  bool Resize(void* ptr, size_t old_size, size_t alignment, size_t new_size) {
+    return ptr != nullptr && new_size != 0 &&
+           (new_size == old_size ||
+            DoResize(ptr, old_size, alignment, new_size));
+  }
+
+  // Resizes an allocation, moving it to a new allocation if it cannot be
+  // resized in place. Returns nullptr and leaves the old allocation unchanged
+  // on failure.
+  void* Reallocate(void* ptr,
+                   size_t old_size,
+                   size_t alignment,
+                   size_t new_size);
+
+  // Constructs a T, or returns nullptr if the allocation fails.
+  template <typename T, typename... Args>
+  T* New(Args&&... args) {
+    void* ptr = Allocate(sizeof(T), alignof(T));
+    return ptr == nullptr ? nullptr : new (ptr) T(std::forward<Args>(args)...);
+  }
+
+  // Destroys and releases an object from New. object may be nullptr.
+  template <typename T>
+  void Delete(T* object) {
+    if (object != nullptr) {
+      object->~T();
+      Deallocate(object, sizeof(T), alignof(T));
+    }
+  }
+
+ private:
+  virtual void* DoAllocate(size_t size, size_t alignment) = 0;
+
+  virtual void DoDeallocate(void* ptr, size_t size, size_t alignment) = 0;
+
+  // Allocators that cannot resize in place need not override this.
+  virtual bool DoResize(void*, size_t, size_t, size_t) { return false; }
+};
+
+}  // namespace pw::allocator
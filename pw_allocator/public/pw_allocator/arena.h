@@ -0,0 +1,114 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/freelist_heap.h"
+
+namespace pw::allocator {
+
+// A monotonic allocator for objects that are all released together, such as
+// the temporary structures of one request. Allocate bumps an offset into the
+// region, and Reset releases everything in constant time. There is no Free.
+//
+// If an overflow heap is given, allocations that do not fit in the region are
+// taken from it and freed on Reset, or when the Scope they were made in ends.
+class Arena : public Allocator {
+ private:
+  // Precedes each overflow allocation, linking them newest first.
+  struct OverflowHeader {
+    OverflowHeader* next;
+  };
+
+  struct Mark {
+    size_t offset;
+    OverflowHeader* overflow;
+  };
+
+ public:
+  // Releases the Arena's allocations made while the Scope exists when it goes
+  // out of scope. Scopes must end in the reverse order they were created.
+  class Scope {
+   public:
+    explicit Scope(Arena& arena) : arena_(arena), mark_(arena.mark()) {}
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    ~Scope() { arena_.RollBack(mark_); }
+
+   private:
+    Arena& arena_;
+    const Mark mark_;
+  };
+
+  explicit Arena(std::span<std::byte> region, FreeListHeap* overflow = nullptr)
+      : region_(region), offset_(0), overflow_heap_(overflow), overflow_(nullptr) {}
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  ~Arena() { Reset(); }
+
+  // Allocate returns nullptr if the size does not fit in the region or the
+  // overflow heap. Deallocate does nothing.
+
+  // Constructs a T in the arena. Destructors are never run, so T must be
+  // trivially destructible.
+  template <typename T, typename... Args>
+  T* New(Args&&... args) {
+    static_assert(std::is_trivially_destructible_v<T>,
+                  "Arena does not run destructors");
+    void* ptr = Allocate(sizeof(T), alignof(T));
+    return ptr == nullptr ? nullptr : new (ptr) T(std::forward<Args>(args)...);
+  }
+
+  // Releases all allocations. This is constant time unless allocations were
+  // taken from the overflow heap, which are freed one by one.
+  void Reset() { RollBack(Mark{}); }
+
+  // Bytes of the region in use, not counting overflow allocations.
+  size_t used_bytes() const { return offset_; }
+  size_t available_bytes() const { return region_.size() - offset_; }
+
+ private:
+  void* DoAllocate(size_t size, size_t alignment) override;
+  void DoDeallocate(void*, size_t, size_t) override {}
+
+  // Any allocation may shrink, and the newest allocation in the region may
+  // grow into the rest of the region.
+  bool DoResize(void* ptr,
+                size_t old_size,
+                size_t alignment,
+                size_t new_size) override;
+
+  Mark mark() const { return {offset_, overflow_}; }
+
+  void* AllocateOverflow(size_t size, size_t alignment);
+
+  void RollBack(const Mark& mark);
+
+  const std::span<std::byte> region_;
+  size_t offset_;
+  FreeListHeap* const overflow_heap_;
+  OverflowHeader* overflow_;  // The newest overflow allocation.
+};
+
+}  // namespace pw::allocator
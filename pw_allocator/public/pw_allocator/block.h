@@ -215,6 +215,16 @@ class Block final {
   // This function will do nothing if the block is valid.
   void CrashIfInvalid();
 
+  // Paints the usable space of a free block, from offset start up to offset
+  // end, with a pattern, so that writes to the block after it was freed can be
+  // found by CheckFreePattern. Does nothing unless heap poisoning is enabled.
+  void PoisonFreeSpace(size_t start, size_t end);
+
+  // Returns false if the usable space from offset start to the end of the
+  // block is not painted by PoisonFreeSpace. Always returns true unless heap
+  // poisoning is enabled.
+  bool CheckFreePattern(size_t start) const;
+
  private:
   static constexpr uintptr_t kInUseFlag = 0x1;
   static constexpr uintptr_t kLastFlag = 0x2;
@@ -226,6 +236,7 @@ class Block final {
                                                   std::byte{0xdc},
                                                   std::byte{0xae},
                                                   std::byte{0x4e}};
+  static constexpr std::byte FREE_PATTERN{0xfd};
   enum BlockStatus {
     VALID,
     MISALIGNED,
@@ -0,0 +1,155 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <utility>
+
+#include "pw_allocator/allocator.h"
+
+namespace pw::allocator {
+
+// An allocator of fixed size blocks from a region, for objects of one size such
+// as RPC call contexts or packet buffers. Allocate and Free take constant time
+// and there is no per-block header: free blocks are kept in an intrusive list
+// that stores the index of the next free block in each free block.
+//
+// With Concurrency::kLockFree, Allocate and Free may be called concurrently
+// from several threads and interrupts. The list head is updated with
+// compare-and-swap, with a counter in the head so a block that is freed and
+// allocated again while another context is popping it is detected. This needs
+// an atomic compare-and-swap of 32 bits on the target.
+//
+// The region is split into as many block_size blocks as fit, up to 65534. The
+// region must be aligned for the objects stored, and block_size must be a
+// multiple of alignof(uint32_t).
+class FixedBlockAllocator : public Allocator {
+ public:
+  enum class Concurrency {
+    // Allocate and Free are only called from one context at a time.
+    kSingleContext,
+
+    // Allocate and Free may be called concurrently.
+    kLockFree,
+  };
+
+  FixedBlockAllocator(std::span<std::byte> region,
+                      size_t block_size,
+                      Concurrency concurrency = Concurrency::kSingleContext);
+
+  FixedBlockAllocator(const FixedBlockAllocator&) = delete;
+  FixedBlockAllocator& operator=(const FixedBlockAllocator&) = delete;
+
+  using Allocator::Allocate;
+
+  // Returns a free block, or nullptr if all blocks are allocated.
+  void* Allocate();
+
+  // Returns a block from Allocate to the allocator. ptr may be nullptr.
+  void Free(void* ptr);
+
+  // True if ptr is in the allocator's region, such as to find which allocator
+  // a block came from.
+  bool Contains(const void* ptr) const {
+    const std::byte* bytes = static_cast<const std::byte*>(ptr);
+    return bytes >= region_.data() &&
+           bytes < region_.data() + block_count_ * block_size_;
+  }
+
+  size_t block_size() const { return block_size_; }
+  size_t block_count() const { return block_count_; }
+
+ private:
+  // Allocations of up to block_size() bytes succeed if every block is aligned
+  // to the requested alignment.
+  void* DoAllocate(size_t size, size_t alignment) override {
+    const bool aligned =
+        reinterpret_cast<uintptr_t>(region_.data()) % alignment == 0u &&
+        block_size_ % alignment == 0u;
+    return size <= block_size_ && aligned ? Allocate() : nullptr;
+  }
+  void DoDeallocate(void* ptr, size_t, size_t) override { Free(ptr); }
+  bool DoResize(void*, size_t, size_t, size_t new_size) override {
+    return new_size <= block_size_;
+  }
+
+  static constexpr uint32_t kIndexMask = 0xffff;
+  static constexpr uint32_t kEndIndex = kIndexMask;
+  static constexpr uint32_t kTagIncrement = kIndexMask + 1;
+
+  uint32_t& NextIndex(uint32_t index) {
+    return *reinterpret_cast<uint32_t*>(region_.data() + index * block_size_);
+  }
+
+  // The new head with the given index. The counter in the upper bits changes
+  // on each update of the head.
+  static uint32_t NewHead(uint32_t old_head, uint32_t index) {
+    return ((old_head & ~kIndexMask) + kTagIncrement) | index;
+  }
+
+  const std::span<std::byte> region_;
+  const size_t block_size_;
+  const size_t block_count_;
+  const Concurrency concurrency_;
+
+  // Index of the first free block in the low 16 bits, and the update counter.
+  std::atomic<uint32_t> head_;
+};
+
+// A pool of kCapacity objects of type T, allocated from a FixedBlockAllocator
+// with storage in the pool.
+template <typename T, size_t kCapacity>
+class Pool {
+ public:
+  explicit Pool(FixedBlockAllocator::Concurrency concurrency =
+                    FixedBlockAllocator::Concurrency::kSingleContext)
+      : allocator_(storage_, kBlockSize, concurrency) {}
+
+  // Constructs a T in a free block, or returns nullptr if the pool is empty.
+  template <typename... Args>
+  T* New(Args&&... args) {
+    void* block = allocator_.Allocate();
+    return block == nullptr ? nullptr
+                            : new (block) T(std::forward<Args>(args)...);
+  }
+
+  // Destroys an object from New and returns its block to the pool.
+  void Delete(T* object) {
+    if (object != nullptr) {
+      object->~T();
+      allocator_.Free(object);
+    }
+  }
+
+  FixedBlockAllocator& allocator() { return allocator_; }
+
+ private:
+  static_assert(kCapacity > 0u && kCapacity < 0xffff);
+
+  static constexpr size_t kAlignment = std::max(alignof(T), alignof(uint32_t));
+  static constexpr size_t kBlockSize =
+      (std::max(sizeof(T), sizeof(uint32_t)) + kAlignment - 1) /
+      kAlignment * kAlignment;
+
+  // Declared before allocator_, which builds its free list in the storage.
+  alignas(kAlignment) std::byte storage_[kBlockSize * kCapacity];
+  FixedBlockAllocator allocator_;
+};
+
+}  // namespace pw::allocator
@@ -78,6 +78,10 @@ class FreeList {
   //   NOT_FOUND: The chunk could not be found in this freelist.
   Status RemoveChunk(std::span<std::byte> chunk);
 
+  // The list node stored in the first bytes of each chunk in the list. Chunks
+  // smaller than this cannot be added.
+  static constexpr size_t NodeSize() { return sizeof(FreeListNode); }
+
  private:
   // For a given size, find which index into chunks_ the node should be written
   // to.
@@ -17,12 +17,14 @@
 #include <cstddef>
 #include <span>
 
+#include "pw_allocator/allocator.h"
 #include "pw_allocator/block.h"
 #include "pw_allocator/freelist.h"
+#include "pw_status/status.h"
 
 namespace pw::allocator {
 
-class FreeListHeap {
+class FreeListHeap : public Allocator {
  public:
   template <size_t N>
   friend class FreeListHeapBuffer;
@@ -33,17 +35,60 @@ class FreeListHeap {
     size_t cumulative_freed;
     size_t total_allocate_calls;
     size_t total_free_calls;
+    size_t peak_bytes_allocated;
+  };
+
+  // The free blocks in the heap. The fragmentation is the share of free bytes
+  // outside the largest free block, which cannot serve a single allocation.
+  struct FreeBlockStats {
+    size_t free_bytes;
+    size_t free_blocks;
+    size_t largest_free_block;
+
+    // From 0, where all free bytes are in one block, to 100.
+    size_t fragmentation_percent() const {
+      return free_bytes == 0u
+                 ? 0u
+                 : 100u - largest_free_block * 100u / free_bytes;
+    }
   };
   FreeListHeap(std::span<std::byte> region, FreeList& freelist);
 
+  using Allocator::Allocate;
+
   void* Allocate(size_t size);
   void Free(void* ptr);
   void* Realloc(void* ptr, size_t size);
   void* Calloc(size_t num, size_t size);
 
+  // Walks the heap's blocks, so takes time linear in their number.
+  FreeBlockStats GetFreeBlockStats() const;
+
+  // Walks the heap's blocks and checks their headers and, with heap poisoning
+  // enabled, the guard bytes around each block and the pattern painted over
+  // freed memory. Allocate and Free only check the blocks they touch, so call
+  // this periodically, such as from an idle task, to find corruption near
+  // where it happened. Returns DATA_LOSS, after logging the corrupted block,
+  // if the heap is corrupted. Takes time linear in the heap size.
+  Status CheckIntegrity() const;
+
   void LogHeapStats();
 
  private:
+  // Allocations are aligned to alignof(Block); larger alignments fail.
+  void* DoAllocate(size_t size, size_t alignment) override;
+  void DoDeallocate(void* ptr, size_t, size_t) override { Free(ptr); }
+  bool DoResize(void* ptr, size_t, size_t, size_t new_size) override;
+
+  // Resizes a used block without moving it, by merging it with a free next
+  // block to grow, and returning the tail to the freelist. Returns false if
+  // the block cannot grow to size.
+  bool ResizeInPlace(Block* block, size_t size);
+
+  // With heap poisoning enabled, paints the bytes of a free block from begin to
+  // end, clamped to the block's usable space after its freelist node.
+  void PoisonFree(Block* block, const std::byte* begin, const std::byte* end);
+
   std::span<std::byte> BlockToSpan(Block* block) {
     return std::span<std::byte>(block->UsableSpace(), block->InnerSize());
   }
@@ -73,8 +118,17 @@ class FreeListHeapBuffer {
     return heap_.heap_stats_;
   };
 
+  FreeListHeap::FreeBlockStats GetFreeBlockStats() const {
+    return heap_.GetFreeBlockStats();
+  }
+
+  Status CheckIntegrity() const { return heap_.CheckIntegrity(); }
+
   void LogHeapStats() { heap_.LogHeapStats(); }
 
+  // The heap as an Allocator, to pass to code that takes one.
+  Allocator& allocator() { return heap_; }
+
  private:
   FreeListBuffer<N> freelist_;
   FreeListHeap heap_;
@@ -0,0 +1,139 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/freelist_heap.h"
+#include "pw_metric/metric.h"
+#include "pw_preprocessor/util.h"
+#include "pw_tokenizer/tokenize.h"
+
+// Allocates from a ProfilingAllocator and attributes the allocation to the
+// calling file and line, tokenized in the "metrics" domain so it detokenizes
+// with the metric names.
+#define PW_ALLOCATOR_PROFILED_ALLOCATE(profiling_allocator, size, alignment) \
+  [&] {                                                                      \
+    constexpr uint32_t _pw_allocator_call_site = PW_TOKENIZE_STRING_DOMAIN(  \
+        "metrics", __FILE__ ":" PW_STRINGIFY(__LINE__));                     \
+    return (profiling_allocator)                                             \
+        .AllocateFrom(_pw_allocator_call_site, (size), (alignment));         \
+  }()
+
+namespace pw::allocator {
+
+// An Allocator that forwards to another allocator and records its use in a
+// pw_metric group, so it may be read with the metric RPC service or dumped to
+// logs. The metrics are:
+//
+//   used_bytes, peak_bytes: Bytes requested and not yet freed, and their peak.
+//   allocations, deallocations, failures: Call counts.
+//   size_histogram: Allocations by requested size.
+//   call_sites: The bytes not yet freed from each of the first kMaxCallSites
+//       call sites of PW_ALLOCATOR_PROFILED_ALLOCATE, named by call site.
+//   largest_free_block, fragmentation_percent: If a FreeListHeap is given,
+//       from FreeListHeap::GetFreeBlockStats when UpdateHeapMetrics is called.
+//
+// To track call sites, each allocation is preceded by a header recording its
+// call site; this costs at least 4 bytes per allocation.
+class ProfilingAllocator final : public Allocator {
+ public:
+  static constexpr size_t kMaxCallSites = 8;
+
+  // heap, if given, is walked by UpdateHeapMetrics. It is usually the
+  // allocator itself.
+  explicit ProfilingAllocator(Allocator& allocator,
+                              const FreeListHeap* heap = nullptr)
+      : allocator_(allocator), heap_(heap) {}
+
+  // Allocates and attributes the allocation to call_site, a token. Use
+  // PW_ALLOCATOR_PROFILED_ALLOCATE to tokenize the caller's location.
+  void* AllocateFrom(uint32_t call_site, size_t size, size_t alignment);
+
+  // Updates the free block metrics from the heap. This walks every block, so
+  // is meant to be called before reading the metrics rather than on each
+  // allocation.
+  void UpdateHeapMetrics();
+
+  metric::Group& metrics() { return metrics_; }
+  const metric::Group& metrics() const { return metrics_; }
+
+  uint32_t used_bytes() const { return used_bytes_.value(); }
+  uint32_t peak_bytes() const { return peak_bytes_.value(); }
+
+ private:
+  // Call site for allocations through the Allocator interface.
+  static constexpr uint32_t kUnknownCallSite = 0;
+
+  struct Header {
+    uint32_t call_site;
+  };
+
+  void* DoAllocate(size_t size, size_t alignment) override {
+    return AllocateFrom(kUnknownCallSite, size, alignment);
+  }
+
+  void DoDeallocate(void* ptr, size_t size, size_t alignment) override;
+
+  bool DoResize(void* ptr,
+                size_t old_size,
+                size_t alignment,
+                size_t new_size) override;
+
+  // Bytes before each allocation, which hold the Header at their end.
+  static size_t HeaderSize(size_t alignment) {
+    return alignment > sizeof(Header) ? alignment : sizeof(Header);
+  }
+  static size_t InnerAlignment(size_t alignment) {
+    return alignment > alignof(Header) ? alignment : alignof(Header);
+  }
+  static Header& HeaderOf(void* ptr) {
+    return *reinterpret_cast<Header*>(static_cast<std::byte*>(ptr) -
+                                      sizeof(Header));
+  }
+
+  void RecordSize(size_t size);
+
+  // Adds delta (which may wrap to a subtraction) to the call site's bytes.
+  void AddToCallSite(uint32_t call_site, uint32_t delta);
+
+  void AddUsedBytes(size_t size);
+
+  Allocator& allocator_;
+  const FreeListHeap* const heap_;
+
+  PW_METRIC_GROUP(metrics_, "allocator");
+  PW_METRIC(metrics_, used_bytes_, "used_bytes", 0u);
+  PW_METRIC(metrics_, peak_bytes_, "peak_bytes", 0u);
+  PW_METRIC(metrics_, allocations_, "allocations", 0u);
+  PW_METRIC(metrics_, deallocations_, "deallocations", 0u);
+  PW_METRIC(metrics_, failures_, "failures", 0u);
+  PW_METRIC(metrics_, largest_free_block_, "largest_free_block", 0u);
+  PW_METRIC(metrics_, fragmentation_percent_, "fragmentation_percent", 0u);
+
+  PW_METRIC_GROUP(metrics_, size_histogram_, "size_histogram");
+  PW_METRIC(size_histogram_, size_16_, "up_to_16", 0u);
+  PW_METRIC(size_histogram_, size_64_, "up_to_64", 0u);
+  PW_METRIC(size_histogram_, size_256_, "up_to_256", 0u);
+  PW_METRIC(size_histogram_, size_1024_, "up_to_1024", 0u);
+  PW_METRIC(size_histogram_, size_larger_, "larger", 0u);
+
+  PW_METRIC_GROUP(metrics_, call_sites_, "call_sites");
+  std::optional<metric::TypedMetric<uint32_t>> call_site_bytes_[kMaxCallSites];
+};
+
+}  // namespace pw::allocator
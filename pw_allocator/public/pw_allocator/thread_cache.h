@@ -0,0 +1,158 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+
+#include "pw_allocator/allocator.h"
+
+namespace pw::allocator {
+namespace internal {
+
+// Lists of free small blocks by size class, for ThreadCache.
+class SizeClassCache {
+ public:
+  static constexpr size_t kClassCount = 4;
+  static constexpr size_t kMinClassSize = 16;
+  static constexpr size_t kClassAlignment = alignof(void*);
+  static constexpr size_t kNoClass = kClassCount;
+
+  // A class holding more than kMaxBlocks blocks is drained to kBatchSize.
+  // Refill takes kBatchSize blocks.
+  static constexpr size_t kMaxBlocks = 16;
+  static constexpr size_t kBatchSize = kMaxBlocks / 2;
+
+  static constexpr size_t ClassSize(size_t size_class) {
+    return kMinClassSize << size_class;
+  }
+
+  // Returns the smallest class that holds size bytes at alignment, or kNoClass.
+  static size_t ClassFor(size_t size, size_t alignment);
+
+  constexpr SizeClassCache() : lists_{}, counts_{} {}
+
+  // Returns a cached block of the class, or nullptr if there is none.
+  void* Pop(size_t size_class);
+
+  // Caches a block of at least ClassSize(size_class) bytes. Returns true if the
+  // class now holds more than kMaxBlocks blocks and should be drained.
+  bool Push(size_t size_class, void* ptr);
+
+  // Allocates up to kBatchSize blocks of the class from shared.
+  void Refill(Allocator& shared, size_t size_class);
+
+  // Returns blocks of the class to shared until keep remain.
+  void Drain(Allocator& shared, size_t size_class, size_t keep);
+
+  void DrainAll(Allocator& shared);
+
+  size_t count(size_t size_class) const { return counts_[size_class]; }
+
+ private:
+  struct FreeNode {
+    FreeNode* next;
+  };
+
+  FreeNode* lists_[kClassCount];
+  size_t counts_[kClassCount];
+};
+
+}  // namespace internal
+
+// A cache of small blocks for one thread or core, in front of an allocator
+// shared with other threads or cores and guarded by shared_lock.
+//
+// Small allocations, of up to 128 bytes, are taken from and freed to the
+// cache without taking the lock. When a size class runs out, a batch of blocks
+// is allocated from the shared allocator under one hold of the lock, and when
+// a class holds too many blocks, half are returned the same way. Larger
+// allocations go straight to the shared allocator, under the lock.
+//
+// A ThreadCache itself is not thread safe; each thread or core uses its own.
+// Blocks may be freed to a different ThreadCache than allocated them, as long
+// as all caches share an allocator. Lock may be any type with lock() and
+// unlock(), such as pw::sync::SpinLock or pw::sync::Mutex.
+template <typename Lock>
+class ThreadCache final : public Allocator {
+ public:
+  ThreadCache(Allocator& shared, Lock& shared_lock)
+      : shared_(shared), lock_(shared_lock) {}
+
+  ThreadCache(const ThreadCache&) = delete;
+  ThreadCache& operator=(const ThreadCache&) = delete;
+
+  ~ThreadCache() {
+    std::lock_guard lock(lock_);
+    cache_.DrainAll(shared_);
+  }
+
+ private:
+  using Cache = internal::SizeClassCache;
+
+  void* DoAllocate(size_t size, size_t alignment) override {
+    const size_t size_class = Cache::ClassFor(size, alignment);
+    if (size_class == Cache::kNoClass) {
+      std::lock_guard lock(lock_);
+      return shared_.Allocate(size, alignment);
+    }
+
+    void* ptr = cache_.Pop(size_class);
+    if (ptr == nullptr) {
+      {
+        std::lock_guard lock(lock_);
+        cache_.Refill(shared_, size_class);
+      }
+      ptr = cache_.Pop(size_class);
+    }
+    return ptr;
+  }
+
+  void DoDeallocate(void* ptr, size_t size, size_t alignment) override {
+    const size_t size_class = Cache::ClassFor(size, alignment);
+    if (size_class == Cache::kNoClass) {
+      std::lock_guard lock(lock_);
+      shared_.Deallocate(ptr, size, alignment);
+      return;
+    }
+
+    if (cache_.Push(size_class, ptr)) {
+      std::lock_guard lock(lock_);
+      cache_.Drain(shared_, size_class, Cache::kBatchSize);
+    }
+  }
+
+  // Small blocks may change size within their class. A block that shrinks to
+  // a smaller class is later cached in that class.
+  bool DoResize(void* ptr,
+                size_t old_size,
+                size_t alignment,
+                size_t new_size) override {
+    const size_t size_class = Cache::ClassFor(old_size, alignment);
+    if (size_class != Cache::kNoClass) {
+      return new_size <= Cache::ClassSize(size_class);
+    }
+    if (Cache::ClassFor(new_size, alignment) != Cache::kNoClass) {
+      return false;
+    }
+    std::lock_guard lock(lock_);
+    return shared_.Resize(ptr, old_size, alignment, new_size);
+  }
+
+  Allocator& shared_;
+  Lock& lock_;
+  Cache cache_;
+};
+
+}  // namespace pw::allocator
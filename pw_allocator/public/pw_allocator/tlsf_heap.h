@@ -0,0 +1,130 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/block.h"
+
+namespace pw::allocator {
+
+// A heap with constant time Allocate and Free, using two level segregated fit
+// (TLSF) over a chain of Blocks.
+//
+// Free blocks are kept in lists by size class. The first level divides sizes
+// by powers of two, and the second level divides each power of two into
+// kSecondLevelCount equal ranges. Sizes below kSmallBlockSize instead map
+// linearly into the first list. A bitmap of the non-empty first level classes
+// and, for each of them, a bitmap of the non-empty second level lists, are
+// searched with a find-first-set instruction instead of walking lists.
+//
+// Allocate rounds the requested size up to the next size class, so that the
+// first block of any list it finds is large enough. If there is none, only the
+// first block of the list for the requested size is checked. An allocation may
+// therefore fail while another block in that list is large enough; that is the
+// cost of the constant time search.
+//
+// As an example, with a kSmallBlockSize of 128 bytes and 16 second level lists,
+// free blocks of 200 bytes are in first level list 1 (128 to 255 bytes), second
+// level list 9 (200 to 207 bytes).
+//
+// Free blocks store their list links in their usable space, so each block holds
+// at least two pointers.
+class TlsfHeap : public Allocator {
+ public:
+  static constexpr size_t kSecondLevelLog2 = 4;
+  static constexpr size_t kSecondLevelCount = size_t(1) << kSecondLevelLog2;
+  static constexpr size_t kAlignmentLog2 = __builtin_ctz(alignof(Block));
+  static constexpr size_t kFirstLevelShift = kSecondLevelLog2 + kAlignmentLog2;
+  static constexpr size_t kSmallBlockSize = size_t(1) << kFirstLevelShift;
+  static constexpr size_t kFirstLevelCount = 24;
+  static constexpr size_t kMaxRegionSizeBytes =
+      size_t(1) << (kFirstLevelShift + kFirstLevelCount - 1);
+
+  // The region must be aligned to alignof(Block), and smaller than
+  // kMaxRegionSizeBytes.
+  explicit TlsfHeap(std::span<std::byte> region);
+
+  TlsfHeap(const TlsfHeap&) = delete;
+  TlsfHeap& operator=(const TlsfHeap&) = delete;
+
+  using Allocator::Allocate;
+
+  void* Allocate(size_t size);
+  void Free(void* ptr);
+  void* Realloc(void* ptr, size_t size);
+  void* Calloc(size_t num, size_t size);
+
+ private:
+  // Allocations are aligned to alignof(Block); larger alignments fail.
+  void* DoAllocate(size_t size, size_t alignment) override {
+    return alignment <= alignof(Block) ? Allocate(size) : nullptr;
+  }
+  void DoDeallocate(void* ptr, size_t, size_t) override { Free(ptr); }
+  bool DoResize(void* ptr, size_t, size_t, size_t new_size) override {
+    Block* block = Block::FromUsableSpace(static_cast<std::byte*>(ptr));
+    return new_size <= block->InnerSize();
+  }
+
+  struct FreeNode {
+    Block* next;
+    Block* prev;
+  };
+
+  struct ListIndex {
+    size_t first;
+    size_t second;
+  };
+
+  static_assert(kSecondLevelCount <= 32 && kFirstLevelCount < 32,
+                "TLSF bitmaps must fit in 32 bits");
+
+  // Returns the list that holds free blocks with an inner size of size.
+  static ListIndex MapSize(size_t size);
+
+  // Returns the first list in which every block is at least size bytes.
+  static ListIndex MapSearchSize(size_t size);
+
+  static size_t Log2(size_t value) {
+    return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(value);
+  }
+
+  static FreeNode& Node(Block* block) {
+    return *reinterpret_cast<FreeNode*>(block->UsableSpace());
+  }
+
+  // Returns the first free block in the list at index or a later list with
+  // larger blocks, or nullptr if there is none.
+  Block* FindFreeBlock(ListIndex index) const;
+
+  void InsertFreeBlock(Block* block);
+  void RemoveFreeBlock(Block* block);
+
+  void InvalidFreeCrash();
+
+  std::span<std::byte> region_;
+
+  // Bit i is set if any list in first level class i has a free block.
+  uint32_t first_level_bitmap_;
+
+  // Bit j of entry i is set if list [i][j] has a free block.
+  uint32_t second_level_bitmaps_[kFirstLevelCount];
+
+  Block* free_lists_[kFirstLevelCount][kSecondLevelCount];
+};
+
+}  // namespace pw::allocator
@@ -0,0 +1,70 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/thread_cache.h"
+
+namespace pw::allocator::internal {
+
+size_t SizeClassCache::ClassFor(size_t size, size_t alignment) {
+  if (alignment > kClassAlignment) {
+    return kNoClass;
+  }
+  for (size_t size_class = 0; size_class < kClassCount; ++size_class) {
+    if (size <= ClassSize(size_class)) {
+      return size_class;
+    }
+  }
+  return kNoClass;
+}
+
+void* SizeClassCache::Pop(size_t size_class) {
+  FreeNode* node = lists_[size_class];
+  if (node != nullptr) {
+    lists_[size_class] = node->next;
+    counts_[size_class] -= 1;
+  }
+  return node;
+}
+
+bool SizeClassCache::Push(size_t size_class, void* ptr) {
+  FreeNode* node = static_cast<FreeNode*>(ptr);
+  node->next = lists_[size_class];
+  lists_[size_class] = node;
+  counts_[size_class] += 1;
+  return counts_[size_class] > kMaxBlocks;
+}
+
+void SizeClassCache::Refill(Allocator& shared, size_t size_class) {
+  for (size_t i = 0; i < kBatchSize; ++i) {
+    void* ptr = shared.Allocate(ClassSize(size_class), kClassAlignment);
+    if (ptr == nullptr) {
+      return;
+    }
+    Push(size_class, ptr);
+  }
+}
+
+void SizeClassCache::Drain(Allocator& shared, size_t size_class, size_t keep) {
+  while (counts_[size_class] > keep) {
+    shared.Deallocate(Pop(size_class), ClassSize(size_class), kClassAlignment);
+  }
+}
+
+void SizeClassCache::DrainAll(Allocator& shared) {
+  for (size_t size_class = 0; size_class < kClassCount; ++size_class) {
+    Drain(shared, size_class, 0);
+  }
+}
+
+}  // namespace pw::allocator::internal
@@ -0,0 +1,158 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/thread_cache.h"
+
+#include <span>
+
+#include "gtest/gtest.h"
+#include "pw_allocator/tlsf_heap.h"
+
+namespace pw::allocator {
+namespace {
+
+using internal::SizeClassCache;
+
+// Counts how often the shared allocator is locked.
+class FakeLock {
+ public:
+  void lock() {
+    EXPECT_FALSE(locked_);
+    locked_ = true;
+    lock_count_ += 1;
+  }
+  void unlock() {
+    EXPECT_TRUE(locked_);
+    locked_ = false;
+  }
+
+  size_t lock_count() const { return lock_count_; }
+
+ private:
+  bool locked_ = false;
+  size_t lock_count_ = 0;
+};
+
+class ThreadCacheTest : public ::testing::Test {
+ protected:
+  static constexpr size_t kHeapSize = 4096;
+
+  ThreadCacheTest() : heap_(std::span(buffer_)) {}
+
+  // True if the heap has no allocations left in it.
+  bool HeapIsEmpty() {
+    constexpr size_t kInnerSize =
+        kHeapSize - sizeof(Block) - 2 * PW_ALLOCATOR_POISON_OFFSET;
+    void* ptr = heap_.Allocate(kInnerSize);
+    if (ptr == nullptr) {
+      return false;
+    }
+    heap_.Free(ptr);
+    return true;
+  }
+
+  alignas(Block) std::byte buffer_[kHeapSize];
+  TlsfHeap heap_;
+  FakeLock lock_;
+};
+
+TEST(SizeClassCache, ClassFor) {
+  EXPECT_EQ(0u, SizeClassCache::ClassFor(1, 1));
+  EXPECT_EQ(0u, SizeClassCache::ClassFor(16, alignof(void*)));
+  EXPECT_EQ(1u, SizeClassCache::ClassFor(17, 1));
+  EXPECT_EQ(3u, SizeClassCache::ClassFor(128, 1));
+  EXPECT_EQ(SizeClassCache::kNoClass, SizeClassCache::ClassFor(129, 1));
+  EXPECT_EQ(SizeClassCache::kNoClass,
+            SizeClassCache::ClassFor(16, 2 * alignof(void*)));
+}
+
+TEST_F(ThreadCacheTest, SmallAllocationsRefillInBatches) {
+  ThreadCache cache(heap_, lock_);
+  Allocator& allocator = cache;
+
+  void* ptrs[SizeClassCache::kBatchSize + 1];
+  for (void*& ptr : ptrs) {
+    ptr = allocator.Allocate(24, 1);
+    ASSERT_NE(ptr, nullptr);
+  }
+
+  // One refill served the first batch; the last allocation needed another.
+  EXPECT_EQ(2u, lock_.lock_count());
+
+  for (void* ptr : ptrs) {
+    allocator.Deallocate(ptr, 24, 1);
+  }
+  EXPECT_EQ(2u, lock_.lock_count());
+
+  // Freed blocks are reused without the lock.
+  EXPECT_NE(nullptr, allocator.Allocate(32, 1));
+  EXPECT_EQ(2u, lock_.lock_count());
+}
+
+TEST_F(ThreadCacheTest, DrainsWhenClassIsFull) {
+  ThreadCache cache(heap_, lock_);
+  Allocator& allocator = cache;
+
+  constexpr size_t kCount = SizeClassCache::kMaxBlocks + 1;
+  void* ptrs[kCount];
+  for (void*& ptr : ptrs) {
+    ptr = allocator.Allocate(8, 1);
+    ASSERT_NE(ptr, nullptr);
+  }
+  const size_t locks_after_allocate = lock_.lock_count();
+
+  for (void* ptr : ptrs) {
+    allocator.Deallocate(ptr, 8, 1);
+  }
+  EXPECT_EQ(locks_after_allocate + 1, lock_.lock_count());
+}
+
+TEST_F(ThreadCacheTest, LargeAllocationsUseSharedAllocator) {
+  ThreadCache cache(heap_, lock_);
+  Allocator& allocator = cache;
+
+  void* ptr = allocator.Allocate(512, 1);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(1u, lock_.lock_count());
+
+  allocator.Deallocate(ptr, 512, 1);
+  EXPECT_EQ(2u, lock_.lock_count());
+}
+
+TEST_F(ThreadCacheTest, DestructorReturnsCachedBlocks) {
+  {
+    ThreadCache cache(heap_, lock_);
+    Allocator& allocator = cache;
+    void* ptr = allocator.Allocate(100, 1);
+    ASSERT_NE(ptr, nullptr);
+    allocator.Deallocate(ptr, 100, 1);
+    EXPECT_FALSE(HeapIsEmpty());
+  }
+  EXPECT_TRUE(HeapIsEmpty());
+}
+
+TEST_F(ThreadCacheTest, FreeToAnotherCache) {
+  {
+    ThreadCache first(heap_, lock_);
+    ThreadCache second(heap_, lock_);
+
+    void* ptr = static_cast<Allocator&>(first).Allocate(40, 1);
+    ASSERT_NE(ptr, nullptr);
+    static_cast<Allocator&>(second).Deallocate(ptr, 40, 1);
+  }
+  EXPECT_TRUE(HeapIsEmpty());
+}
+
+}  // namespace
+}  // namespace pw::allocator
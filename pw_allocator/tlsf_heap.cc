@@ -0,0 +1,245 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/tlsf_heap.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_assert/assert.h"
+
+namespace pw::allocator {
+
+TlsfHeap::TlsfHeap(std::span<std::byte> region)
+    : region_(region),
+      first_level_bitmap_(0),
+      second_level_bitmaps_{},
+      free_lists_{} {
+  PW_CHECK_UINT_LT(region.size(), kMaxRegionSizeBytes);
+
+  Block* block;
+  if (Block::Init(region, &block).ok() &&
+      block->InnerSize() >= sizeof(FreeNode)) {
+    InsertFreeBlock(block);
+  }
+}
+
+void* TlsfHeap::Allocate(size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+
+  // Round up as Block::Split does, so the size class is that of the block.
+  size = std::max(size, sizeof(FreeNode));
+  size = (size + alignof(Block) - 1) & ~(alignof(Block) - 1);
+
+  Block* block = nullptr;
+  const ListIndex index = MapSearchSize(size);
+  if (index.first < kFirstLevelCount) {
+    block = FindFreeBlock(index);
+  }
+
+  // If no larger list has a block, the first block in the list for the size
+  // itself may still be large enough.
+  if (block == nullptr) {
+    const ListIndex exact_index = MapSize(size);
+    if (exact_index.first >= kFirstLevelCount) {
+      return nullptr;
+    }
+    block = free_lists_[exact_index.first][exact_index.second];
+    if (block == nullptr || block->InnerSize() < size) {
+      return nullptr;
+    }
+  }
+  RemoveFreeBlock(block);
+  block->CrashIfInvalid();
+
+  // Split off the rest of the block if it can hold a free block.
+  const size_t min_split_size =
+      sizeof(Block) + 2 * PW_ALLOCATOR_POISON_OFFSET + sizeof(FreeNode);
+  Block* leftover;
+  if (block->InnerSize() - size >= min_split_size &&
+      block->Split(size, &leftover).ok()) {
+    InsertFreeBlock(leftover);
+  }
+
+  block->MarkUsed();
+  return block->UsableSpace();
+}
+
+void TlsfHeap::Free(void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+
+  std::byte* bytes = static_cast<std::byte*>(ptr);
+  if (bytes < region_.data() || bytes >= region_.data() + region_.size()) {
+    InvalidFreeCrash();
+    return;
+  }
+
+  Block* block = Block::FromUsableSpace(bytes);
+  block->CrashIfInvalid();
+  if (!block->Used()) {
+    InvalidFreeCrash();
+    return;
+  }
+  block->MarkFree();
+
+  // Merge with free neighbours, so the free blocks never need to be walked.
+  Block* prev = block->Prev();
+  if (prev != nullptr && !prev->Used()) {
+    RemoveFreeBlock(prev);
+    block->MergePrev();
+
+    // block is now invalid; prev now encompasses it.
+    block = prev;
+  }
+
+  if (!block->Last()) {
+    Block* next = block->Next();
+    if (!next->Used()) {
+      RemoveFreeBlock(next);
+      block->MergeNext();
+    }
+  }
+
+  InsertFreeBlock(block);
+}
+
+// Follows the contract of the C standard realloc() function, as
+// FreeListHeap::Realloc does.
+void* TlsfHeap::Realloc(void* ptr, size_t size) {
+  if (size == 0) {
+    Free(ptr);
+    return nullptr;
+  }
+
+  if (ptr == nullptr) {
+    return Allocate(size);
+  }
+
+  std::byte* bytes = static_cast<std::byte*>(ptr);
+  if (bytes < region_.data() || bytes >= region_.data() + region_.size()) {
+    return nullptr;
+  }
+
+  Block* block = Block::FromUsableSpace(bytes);
+  if (!block->Used()) {
+    return nullptr;
+  }
+  const size_t old_size = block->InnerSize();
+  if (old_size >= size) {
+    return ptr;
+  }
+
+  void* new_ptr = Allocate(size);
+  if (new_ptr == nullptr) {
+    return nullptr;
+  }
+  std::memcpy(new_ptr, ptr, old_size);
+
+  Free(ptr);
+  return new_ptr;
+}
+
+void* TlsfHeap::Calloc(size_t num, size_t size) {
+  void* ptr = Allocate(num * size);
+  if (ptr != nullptr) {
+    std::memset(ptr, 0, num * size);
+  }
+  return ptr;
+}
+
+TlsfHeap::ListIndex TlsfHeap::MapSize(size_t size) {
+  if (size < kSmallBlockSize) {
+    return {0, size >> kAlignmentLog2};
+  }
+
+  const size_t log2 = Log2(size);
+  return {log2 - kFirstLevelShift + 1,
+          (size >> (log2 - kSecondLevelLog2)) - kSecondLevelCount};
+}
+
+TlsfHeap::ListIndex TlsfHeap::MapSearchSize(size_t size) {
+  // Each small list holds a single size, but larger lists hold a range of
+  // sizes. Rounding up to the next list's smallest size means any block found
+  // is large enough.
+  if (size >= kSmallBlockSize) {
+    size += (size_t(1) << (Log2(size) - kSecondLevelLog2)) - 1;
+  }
+  return MapSize(size);
+}
+
+Block* TlsfHeap::FindFreeBlock(ListIndex index) const {
+  uint32_t second_level_map =
+      second_level_bitmaps_[index.first] & (~uint32_t(0) << index.second);
+
+  if (second_level_map == 0) {
+    // No list in this class is large enough; use the smallest larger class.
+    const uint32_t first_level_map =
+        first_level_bitmap_ & (~uint32_t(0) << (index.first + 1));
+    if (first_level_map == 0) {
+      return nullptr;
+    }
+    index.first = __builtin_ctz(first_level_map);
+    second_level_map = second_level_bitmaps_[index.first];
+  }
+
+  index.second = __builtin_ctz(second_level_map);
+  return free_lists_[index.first][index.second];
+}
+
+void TlsfHeap::InsertFreeBlock(Block* block) {
+  const ListIndex index = MapSize(block->InnerSize());
+  Block*& head = free_lists_[index.first][index.second];
+
+  Node(block).next = head;
+  Node(block).prev = nullptr;
+  if (head != nullptr) {
+    Node(head).prev = block;
+  }
+  head = block;
+
+  first_level_bitmap_ |= uint32_t(1) << index.first;
+  second_level_bitmaps_[index.first] |= uint32_t(1) << index.second;
+}
+
+void TlsfHeap::RemoveFreeBlock(Block* block) {
+  const ListIndex index = MapSize(block->InnerSize());
+  Block*& head = free_lists_[index.first][index.second];
+  FreeNode& node = Node(block);
+
+  if (node.prev != nullptr) {
+    Node(node.prev).next = node.next;
+  } else {
+    head = node.next;
+  }
+  if (node.next != nullptr) {
+    Node(node.next).prev = node.prev;
+  }
+
+  if (head == nullptr) {
+    second_level_bitmaps_[index.first] &= ~(uint32_t(1) << index.second);
+    if (second_level_bitmaps_[index.first] == 0) {
+      first_level_bitmap_ &= ~(uint32_t(1) << index.first);
+    }
+  }
+}
+
+void TlsfHeap::InvalidFreeCrash() {
+  PW_DCHECK(false, "You tried to free an invalid pointer!");
+}
+
+}  // namespace pw::allocator
@@ -0,0 +1,191 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/tlsf_heap.h"
+
+#include <cstring>
+#include <span>
+
+#include "gtest/gtest.h"
+
+namespace pw::allocator {
+
+constexpr size_t kBlockOverhead =
+    sizeof(Block) + 2 * PW_ALLOCATOR_POISON_OFFSET;
+
+TEST(TlsfHeap, CanAllocate) {
+  constexpr size_t N = 2048;
+  constexpr size_t kAllocSize = 512;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeap heap(buf);
+
+  void* ptr = heap.Allocate(kAllocSize);
+
+  ASSERT_NE(ptr, nullptr);
+  // The first allocation is the start of the region.
+  EXPECT_EQ(ptr, &buf[0] + sizeof(Block) + PW_ALLOCATOR_POISON_OFFSET);
+}
+
+TEST(TlsfHeap, AllocationsDontOverlap) {
+  constexpr size_t N = 2048;
+  constexpr size_t kAllocSize = 512;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeap heap(buf);
+
+  void* ptr1 = heap.Allocate(kAllocSize);
+  void* ptr2 = heap.Allocate(kAllocSize);
+
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+
+  uintptr_t ptr1_start = reinterpret_cast<uintptr_t>(ptr1);
+  uintptr_t ptr1_end = ptr1_start + kAllocSize;
+  uintptr_t ptr2_start = reinterpret_cast<uintptr_t>(ptr2);
+
+  EXPECT_GT(ptr2_start, ptr1_end);
+}
+
+TEST(TlsfHeap, ReturnedPointersAreAligned) {
+  constexpr size_t N = 2048;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeap heap(buf);
+
+  for (size_t size : {1, 3, 7, 13}) {
+    void* ptr = heap.Allocate(size);
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignof(void*), 0u);
+  }
+}
+
+TEST(TlsfHeap, ReturnsNullWhenAllocationTooLarge) {
+  constexpr size_t N = 2048;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeap heap(buf);
+
+  EXPECT_EQ(heap.Allocate(N), nullptr);
+  EXPECT_EQ(heap.Allocate(0), nullptr);
+}
+
+TEST(TlsfHeap, ReturnsNullWhenFull) {
+  constexpr size_t N = 2048;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeap heap(buf);
+
+  EXPECT_NE(heap.Allocate(N - kBlockOverhead), nullptr);
+  EXPECT_EQ(heap.Allocate(1), nullptr);
+}
+
+TEST(TlsfHeap, FreeMergesNeighbours) {
+  constexpr size_t N = 2048;
+  constexpr size_t kAllocSize = 256;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeap heap(buf);
+
+  void* ptrs[4];
+  for (void*& ptr : ptrs) {
+    ptr = heap.Allocate(kAllocSize);
+    ASSERT_NE(ptr, nullptr);
+  }
+
+  // Free the middle blocks, then their neighbours, in an order that needs both
+  // previous and next merges.
+  heap.Free(ptrs[1]);
+  heap.Free(ptrs[2]);
+  heap.Free(ptrs[0]);
+  heap.Free(ptrs[3]);
+
+  // The whole region is one block again.
+  void* ptr = heap.Allocate(N - kBlockOverhead);
+  EXPECT_EQ(ptr, ptrs[0]);
+}
+
+TEST(TlsfHeap, ReusesFreedBlockUnderFragmentation) {
+  constexpr size_t N = 4096;
+  constexpr size_t kAllocSize = 48;
+  constexpr size_t kCount = 32;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeap heap(buf);
+
+  void* ptrs[kCount];
+  for (void*& ptr : ptrs) {
+    ptr = heap.Allocate(kAllocSize);
+    ASSERT_NE(ptr, nullptr);
+  }
+
+  // Free every other block, leaving many small holes.
+  for (size_t i = 0; i < kCount; i += 2) {
+    heap.Free(ptrs[i]);
+  }
+
+  // An allocation that fits a hole is taken from one of them.
+  void* ptr = heap.Allocate(kAllocSize);
+  bool from_hole = false;
+  for (size_t i = 0; i < kCount; i += 2) {
+    from_hole = from_hole || ptr == ptrs[i];
+  }
+  EXPECT_TRUE(from_hole);
+
+  // A larger allocation comes from the rest of the region.
+  void* large = heap.Allocate(4 * kAllocSize);
+  ASSERT_NE(large, nullptr);
+  EXPECT_GT(large, ptrs[kCount - 1]);
+}
+
+TEST(TlsfHeap, FreeNullIsIgnored) {
+  constexpr size_t N = 256;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfHeap heap(buf);
+  heap.Free(nullptr);
+  EXPECT_NE(heap.Allocate(N - kBlockOverhead), nullptr);
+}
+
+TEST(TlsfHeap, ReallocHasSameContent) {
+  constexpr size_t N = 2048;
+  alignas(Block) std::byte buf[N] = {std::byte(1)};
+
+  TlsfHeap heap(buf);
+
+  int* ptr1 = static_cast<int*>(heap.Allocate(sizeof(int)));
+  ASSERT_NE(ptr1, nullptr);
+  *ptr1 = 42;
+  int* ptr2 = static_cast<int*>(heap.Realloc(ptr1, 64 * sizeof(int)));
+  ASSERT_NE(ptr2, nullptr);
+  EXPECT_EQ(*ptr2, 42);
+}
+
+TEST(TlsfHeap, CanCalloc) {
+  constexpr size_t N = 2048;
+  constexpr size_t kAllocSize = 143;
+  constexpr size_t kNum = 3;
+  alignas(Block) std::byte buf[N];
+  std::memset(buf, 0xa5, sizeof(buf));
+
+  TlsfHeap heap(buf);
+
+  std::byte* ptr = static_cast<std::byte*>(heap.Calloc(kNum, kAllocSize));
+  ASSERT_NE(ptr, nullptr);
+  for (size_t i = 0; i < kNum * kAllocSize; i++) {
+    EXPECT_EQ(ptr[i], std::byte{0});
+  }
+}
+
+}  // namespace pw::allocator
@@ -14,7 +14,11 @@
 
 #include "pw_base64/base64.h"
 
+#include <array>
 #include <cstdint>
+#include <cstring>
+
+#include "pw_base64_private/config.h"
 
 namespace pw::base64 {
 namespace {
@@ -42,41 +46,96 @@ constexpr char BitGroup1Char(uint8_t byte0, uint8_t byte1 = 0) {
 constexpr char BitGroup2Char(uint8_t byte1, uint8_t byte2 = 0) {
   return encode_bits[((byte1 & 0b00001111) << 2) | ((byte2 & 0b11000000) >> 6)];
 }
-constexpr char BitGroup3Char(uint8_t byte2) {
-  return encode_bits[byte2 & 0b00111111];
+
+#if PW_BASE64_ENCODE_PAIR_TABLE
+
+// Table that encodes a 12-bit pattern as two Base64 characters.
+constexpr std::array<std::array<char, 2>, 4096> GeneratePairTable() {
+  std::array<std::array<char, 2>, 4096> table{};
+  for (size_t i = 0; i < table.size(); ++i) {
+    table[i] = {encode_bits[i >> 6], encode_bits[i & 0x3f]};
+  }
+  return table;
 }
 
+constexpr std::array<std::array<char, 2>, 4096> encode_pairs =
+    GeneratePairTable();
+
+// Encodes a 24-bit group as four characters.
+inline void EncodeGroup(uint32_t group, char* output) {
+  std::memcpy(&output[0], encode_pairs[group >> 12].data(), 2);
+  std::memcpy(&output[2], encode_pairs[group & 0xfff].data(), 2);
+}
+
+#else
+
+// Encodes a 24-bit group as four characters.
+inline void EncodeGroup(uint32_t group, char* output) {
+  output[0] = encode_bits[group >> 18];
+  output[1] = encode_bits[(group >> 12) & 0x3f];
+  output[2] = encode_bits[(group >> 6) & 0x3f];
+  output[3] = encode_bits[group & 0x3f];
+}
+
+#endif  // PW_BASE64_ENCODE_PAIR_TABLE
+
 // Decoding functions
-constexpr char kMinValidChar = '+';
-constexpr char kMaxValidChar = 'z';
 constexpr uint8_t kX = 0xff;  // Value used for invalid characters
 
-// Table that decodes a Base64 character to its 6-bit value. Supports the
-// standard (+/) and URL-safe (-_) alphabets. Starts from the lowest-value valid
-// character, which is +.
-constexpr uint8_t decode_char[] = {
-    62, kX, 62, kX, 63, 52, 53, 54, 55, 56,  //  0 - 09
-    57, 58, 59, 60, 61, kX, kX, kX, 0,  kX,  // 10 - 19
-    kX, kX, 0,  1,  2,  3,  4,  5,  6,  7,   // 20 - 29
-    8,  9,  10, 11, 12, 13, 14, 15, 16, 17,  // 30 - 39
-    18, 19, 20, 21, 22, 23, 24, 25, kX, kX,  // 40 - 49
-    kX, kX, 63, kX, 26, 27, 28, 29, 30, 31,  // 50 - 59
-    32, 33, 34, 35, 36, 37, 38, 39, 40, 41,  // 60 - 69
-    42, 43, 44, 45, 46, 47, 48, 49, 50, 51,  // 70 - 79
-};
+// Table that decodes any character to its 6-bit value, or to kX if it is not a
+// Base64 character. Supports the standard (+/) and URL-safe (-_) alphabets.
+// The padding character = decodes to 0. Since valid values are below 64,
+// OR-ing decoded values together detects an invalid character with one check.
+constexpr std::array<uint8_t, 256> GenerateDecodeTable() {
+  std::array<uint8_t, 256> table{};
+  for (uint8_t& value : table) {
+    value = kX;
+  }
+  for (uint8_t i = 0; i < 64u; ++i) {
+    table[static_cast<uint8_t>(encode_bits[i])] = i;
+  }
+  table['-'] = 62;
+  table['_'] = 63;
+  table['='] = 0;
+  return table;
+}
+
+constexpr std::array<uint8_t, 256> decode_char = GenerateDecodeTable();
 
 constexpr uint8_t CharToBits(char ch) {
-  return decode_char[ch - kMinValidChar];
+  return decode_char[static_cast<uint8_t>(ch)];
 }
 
-constexpr uint8_t Byte0(uint8_t bits0, uint8_t bits1) {
-  return (bits0 << 2) | ((bits1 & 0b110000) >> 4);
-}
-constexpr uint8_t Byte1(uint8_t bits1, uint8_t bits2) {
-  return ((bits1 & 0b001111) << 4) | ((bits2 & 0b111100) >> 2);
+// Returns the number of padding characters at the end of the Base64 data.
+size_t Padding(const char* base64, size_t base64_size_bytes) {
+  if (base64[base64_size_bytes - 2] == kPadding) {
+    return 2;
+  }
+  return base64[base64_size_bytes - 1] == kPadding ? 1 : 0;
 }
-constexpr uint8_t Byte2(uint8_t bits2, uint8_t bits3) {
-  return ((bits2 & 0b000011) << 6) | bits3;
+
+// Decodes groups of 4 characters into 3 bytes. Returns the bitwise OR of all
+// decoded 6-bit values, which has its top bit set if any character was invalid.
+// The output may be the same as the input, since each group is read before it
+// is written.
+uint8_t DecodeGroups(const char* base64,
+                     size_t base64_size_bytes,
+                     uint8_t* binary) {
+  uint8_t all_bits = 0;
+  for (size_t ch = 0; ch < base64_size_bytes; ch += kEncodedGroupSize) {
+    const uint8_t bits0 = CharToBits(base64[ch + 0]);
+    const uint8_t bits1 = CharToBits(base64[ch + 1]);
+    const uint8_t bits2 = CharToBits(base64[ch + 2]);
+    const uint8_t bits3 = CharToBits(base64[ch + 3]);
+    all_bits |= bits0 | bits1 | bits2 | bits3;
+
+    const uint32_t group =
+        uint32_t(bits0) << 18 | uint32_t(bits1) << 12 | bits2 << 6 | bits3;
+    *binary++ = uint8_t(group >> 16);
+    *binary++ = uint8_t(group >> 8);
+    *binary++ = uint8_t(group);
+  }
+  return all_bits;
 }
 
 }  // namespace
@@ -88,11 +147,9 @@ extern "C" void pw_Base64Encode(const void* binary_data,
 
   // Encode groups of 3 source bytes into 4 output characters.
   size_t remaining = binary_size_bytes;
-  for (; remaining >= 3u; remaining -= 3u, bytes += 3) {
-    *output++ = BitGroup0Char(bytes[0]);
-    *output++ = BitGroup1Char(bytes[0], bytes[1]);
-    *output++ = BitGroup2Char(bytes[1], bytes[2]);
-    *output++ = BitGroup3Char(bytes[2]);
+  for (; remaining >= 3u; remaining -= 3u, bytes += 3, output += 4) {
+    EncodeGroup(uint32_t(bytes[0]) << 16 | uint32_t(bytes[1]) << 8 | bytes[2],
+                output);
   }
 
   // If the source data length isn't a multiple of 3, pad the end with either 1
@@ -118,26 +175,10 @@ extern "C" size_t pw_Base64Decode(const char* base64,
     return 0;
   }
 
-  uint8_t* binary = static_cast<uint8_t*>(output);
-  for (size_t ch = 0; ch < base64_size_bytes; ch += kEncodedGroupSize) {
-    const uint8_t char0 = CharToBits(base64[ch + 0]);
-    const uint8_t char1 = CharToBits(base64[ch + 1]);
-    const uint8_t char2 = CharToBits(base64[ch + 2]);
-    const uint8_t char3 = CharToBits(base64[ch + 3]);
-
-    *binary++ = Byte0(char0, char1);
-    *binary++ = Byte1(char1, char2);
-    *binary++ = Byte2(char2, char3);
-  }
-
-  size_t pad = 0;
-  if (base64[base64_size_bytes - 2] == kPadding) {
-    pad = 2;
-  } else if (base64[base64_size_bytes - 1] == kPadding) {
-    pad = 1;
-  }
-
-  return binary - static_cast<uint8_t*>(output) - pad;
+  // Check the padding first, since decoding in place overwrites the input.
+  const size_t pad = Padding(base64, base64_size_bytes);
+  DecodeGroups(base64, base64_size_bytes, static_cast<uint8_t*>(output));
+  return MaxDecodedSize(base64_size_bytes) - pad;
 }
 
 extern "C" bool pw_Base64IsValid(const char* base64_data, size_t base64_size) {
@@ -145,13 +186,11 @@ extern "C" bool pw_Base64IsValid(const char* base64_data, size_t base64_size) {
     return false;
   }
 
+  uint8_t all_bits = 0;
   for (size_t i = 0; i < base64_size; ++i) {
-    if (base64_data[i] < kMinValidChar || base64_data[i] > kMaxValidChar ||
-        CharToBits(base64_data[i]) == kX /* invalid char */) {
-      return false;
-    }
+    all_bits |= CharToBits(base64_data[i]);
   }
-  return true;
+  return (all_bits & 0x80u) == 0u;
 }
 
 size_t Encode(std::span<const std::byte> binary,
@@ -166,10 +205,23 @@ size_t Encode(std::span<const std::byte> binary,
 
 size_t Decode(std::string_view base64, std::span<std::byte> output_buffer) {
   if (output_buffer.size_bytes() < MaxDecodedSize(base64.size()) ||
-      !IsValid(base64)) {
+      base64.size() % kEncodedGroupSize != 0) {
+    return 0;
+  }
+  if (base64.empty()) {
+    return 0;
+  }
+
+  // Validate while decoding, rather than in a separate pass.
+  const size_t pad = Padding(base64.data(), base64.size());
+  const uint8_t all_bits =
+      DecodeGroups(base64.data(),
+                   base64.size(),
+                   reinterpret_cast<uint8_t*>(output_buffer.data()));
+  if ((all_bits & 0x80u) != 0u) {
     return 0;
   }
-  return Decode(base64, output_buffer.data());
+  return MaxDecodedSize(base64.size()) - pad;
 }
 
 }  // namespace pw::base64
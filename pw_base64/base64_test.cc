@@ -349,6 +349,41 @@ TEST(Base64, Decode_InPlace) {
   EXPECT_EQ(0, std::memcmp(expected, buf, sizeof(expected) - 1));
 }
 
+TEST(Base64, Decode_InPlace_SingleGroup) {
+  char buf[] = "aGk=";
+  EXPECT_EQ(2u, Decode(std::string_view(buf, 4), std::as_writable_bytes(std::span(buf, 4))));
+  EXPECT_EQ(0, std::memcmp("hi", buf, 2));
+}
+
+TEST(Base64, Decode_InvalidCharacters_ReturnsZero) {
+  std::byte buffer[12] = {};
+  std::span<std::byte> output(buffer);
+  EXPECT_EQ(0u, Decode("aaaabbbbcc#%", output));
+  EXPECT_EQ(0u, Decode("#aaa", output));
+  EXPECT_EQ(0u, Decode("aaa\xff", output));
+  EXPECT_EQ(0u, Decode(std::string_view("aa\0a", 4), output));
+}
+
+TEST(Base64, EncodeDecode_AllLengths) {
+  std::byte binary[64];
+  for (size_t i = 0; i < sizeof(binary); ++i) {
+    binary[i] = std::byte(i * 37 + 11);
+  }
+
+  for (size_t size = 0; size <= sizeof(binary); ++size) {
+    char encoded[EncodedSize(sizeof(binary))];
+    const size_t encoded_size = Encode(std::span(binary, size), std::span(encoded));
+    ASSERT_EQ(EncodedSize(size), encoded_size);
+    ASSERT_TRUE(IsValid(std::string_view(encoded, encoded_size)));
+
+    std::byte decoded[MaxDecodedSize(EncodedSize(sizeof(binary)))];
+    ASSERT_EQ(size,
+              Decode(std::string_view(encoded, encoded_size),
+                     std::span(decoded)));
+    EXPECT_EQ(0, std::memcmp(binary, decoded, size));
+  }
+}
+
 TEST(Base64, Decode_UrlSafeDecode) {
   char output[9] = {};
 
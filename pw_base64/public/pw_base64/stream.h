@@ -0,0 +1,99 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <limits>
+
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
+
+namespace pw::base64 {
+
+// Base64EncodingWriter Base64 encodes the bytes written to it and writes the
+// characters to another stream::Writer. Bytes that do not complete a 3-byte
+// group are held until the next write, so data may be written in pieces of any
+// size. Call Finish() after the last write to encode the final partial group
+// and its padding.
+//
+// If the output writer fails, the error is returned, and some of the encoded
+// data may have been written.
+class Base64EncodingWriter final : public stream::Writer {
+ public:
+  constexpr Base64EncodingWriter(stream::Writer& output)
+      : output_(output), pending_{}, pending_size_(0) {}
+
+  // Writes the 1 or 2 bytes held from previous writes, with padding. Returns
+  // the status of the output writer.
+  Status Finish();
+
+  size_t ConservativeWriteLimit() const override {
+    const size_t limit = output_.ConservativeWriteLimit();
+    if (limit == std::numeric_limits<size_t>::max()) {
+      return limit;
+    }
+    return limit / 4 * 3;
+  }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override;
+
+  stream::Writer& output_;
+  std::array<std::byte, 3> pending_;
+  size_t pending_size_;
+};
+
+// Base64DecodingReader reads Base64 characters from another stream::Reader and
+// returns the decoded bytes. Characters that do not complete a 4-character
+// group are held until the next read, and decoded bytes that do not fit in the
+// destination are returned by the next read.
+//
+// Read() returns DATA_LOSS if the input contains an invalid character or ends
+// in the middle of a group.
+class Base64DecodingReader final : public stream::Reader {
+ public:
+  constexpr Base64DecodingReader(stream::Reader& input)
+      : input_(input),
+        partial_{},
+        partial_size_(0),
+        leftover_{},
+        leftover_offset_(0),
+        leftover_size_(0) {}
+
+  size_t ConservativeReadLimit() const override {
+    const size_t limit = input_.ConservativeReadLimit();
+    if (limit == std::numeric_limits<size_t>::max()) {
+      return limit;
+    }
+    return (partial_size_ + limit) / 4 * 3 + leftover_size_;
+  }
+
+ private:
+  StatusWithSize DoRead(ByteSpan dest) override;
+
+  // Copies decoded bytes held from the previous read to dest.
+  size_t TakeLeftover(ByteSpan dest);
+
+  stream::Reader& input_;
+  std::array<char, 4> partial_;
+  size_t partial_size_;
+  std::array<std::byte, 2> leftover_;
+  size_t leftover_offset_;
+  size_t leftover_size_;
+};
+
+}  // namespace pw::base64
@@ -0,0 +1,23 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// PW_BASE64_ENCODE_PAIR_TABLE selects how Base64 is encoded. When enabled, each
+// 12-bit half of a 3-byte group is encoded with one lookup in an 8 KiB table of
+// character pairs, which halves the lookups per group. When disabled, each
+// 6-bit group is encoded with one lookup in a 64-byte table. The pair table is
+// worthwhile on hosts and on devices with flash to spare.
+#ifndef PW_BASE64_ENCODE_PAIR_TABLE
+#define PW_BASE64_ENCODE_PAIR_TABLE 0
+#endif  // PW_BASE64_ENCODE_PAIR_TABLE
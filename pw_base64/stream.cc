@@ -0,0 +1,133 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_base64/stream.h"
+
+#include <algorithm>
+#include <string_view>
+
+#include "pw_base64/base64.h"
+#include "pw_status/try.h"
+
+namespace pw::base64 {
+namespace {
+
+// Bytes are encoded and characters are decoded through stack buffers of this
+// many characters.
+constexpr size_t kChunkChars = 64;
+
+}  // namespace
+
+Status Base64EncodingWriter::DoWrite(ConstByteSpan data) {
+  // Complete the group started by a previous write.
+  if (pending_size_ != 0u) {
+    const size_t needed = std::min(pending_.size() - pending_size_, data.size());
+    std::copy_n(data.begin(), needed, pending_.begin() + pending_size_);
+    pending_size_ += needed;
+    data = data.subspan(needed);
+
+    if (pending_size_ < pending_.size()) {
+      return OkStatus();
+    }
+
+    char encoded[EncodedSize(pending_.size())];
+    Encode(pending_, encoded);
+    pending_size_ = 0;
+    PW_TRY(output_.Write(encoded, sizeof(encoded)));
+  }
+
+  // Encode whole groups, a chunk at a time.
+  const size_t whole_groups_size = data.size() - data.size() % 3;
+  for (ConstByteSpan groups = data.first(whole_groups_size); !groups.empty();) {
+    const ConstByteSpan chunk =
+        groups.first(std::min(groups.size(), kChunkChars / 4 * 3));
+    char encoded[kChunkChars];
+    Encode(chunk, encoded);
+    PW_TRY(output_.Write(encoded, EncodedSize(chunk.size())));
+    groups = groups.subspan(chunk.size());
+  }
+
+  // Hold the remaining bytes until the next write or Finish().
+  std::copy(data.begin() + whole_groups_size, data.end(), pending_.begin());
+  pending_size_ = data.size() - whole_groups_size;
+  return OkStatus();
+}
+
+Status Base64EncodingWriter::Finish() {
+  if (pending_size_ == 0u) {
+    return OkStatus();
+  }
+  char encoded[EncodedSize(pending_.size())];
+  Encode(std::span(pending_).first(pending_size_), encoded);
+  pending_size_ = 0;
+  return output_.Write(encoded, sizeof(encoded));
+}
+
+size_t Base64DecodingReader::TakeLeftover(ByteSpan dest) {
+  const size_t size = std::min(leftover_size_, dest.size());
+  std::copy_n(leftover_.begin() + leftover_offset_, size, dest.begin());
+  leftover_offset_ += size;
+  leftover_size_ -= size;
+  return size;
+}
+
+StatusWithSize Base64DecodingReader::DoRead(ByteSpan dest) {
+  size_t written = TakeLeftover(dest);
+
+  // Read until at least one byte is decoded, since a read may return only part
+  // of a group.
+  while (written == 0u && !dest.empty()) {
+    // Read no more groups than are needed to fill the destination, so that at
+    // most the last group's bytes need to be held for the next read.
+    char chars[kChunkChars];
+    std::copy_n(partial_.begin(), partial_size_, chars);
+    const size_t groups_wanted = (dest.size() + 2) / 3;
+    const size_t to_read =
+        std::min(sizeof(chars), groups_wanted * 4) - partial_size_;
+
+    const Result<ByteSpan> result = input_.Read(&chars[partial_size_], to_read);
+    if (!result.ok()) {
+      if (result.status().IsOutOfRange() && partial_size_ != 0u) {
+        return StatusWithSize::DataLoss();
+      }
+      return StatusWithSize(result.status(), 0);
+    }
+
+    const size_t size = partial_size_ + result.value().size();
+    const size_t whole_groups_size = size - size % 4;
+    const std::string_view groups(chars, whole_groups_size);
+    if (!IsValid(groups)) {
+      return StatusWithSize::DataLoss();
+    }
+
+    partial_size_ = size - whole_groups_size;
+    std::copy_n(&chars[whole_groups_size], partial_size_, partial_.begin());
+
+    for (size_t i = 0; i < groups.size(); i += 4) {
+      std::byte group[3];
+      const size_t group_size = Decode(groups.substr(i, 4), group);
+      const size_t fits = std::min(group_size, dest.size() - written);
+      std::copy_n(group, fits, dest.data() + written);
+      written += fits;
+
+      // Only the last group can overflow the destination.
+      leftover_offset_ = 0;
+      leftover_size_ = group_size - fits;
+      std::copy(&group[fits], &group[group_size], leftover_.begin());
+    }
+  }
+  return StatusWithSize(written);
+}
+
+}  // namespace pw::base64
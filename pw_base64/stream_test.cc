@@ -0,0 +1,193 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_base64/stream.h"
+
+#include <cstring>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_base64/base64.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::base64 {
+namespace {
+
+constexpr std::string_view kMessage = "This is a secret message";
+constexpr std::string_view kEncoded = "VGhpcyBpcyBhIHNlY3JldCBtZXNzYWdl";
+
+std::string_view AsString(ConstByteSpan bytes) {
+  return std::string_view(reinterpret_cast<const char*>(bytes.data()),
+                          bytes.size());
+}
+
+ConstByteSpan AsBytes(std::string_view string) {
+  return std::as_bytes(std::span(string));
+}
+
+TEST(Base64EncodingWriter, WholeMessage) {
+  stream::MemoryWriterBuffer<64> output;
+  Base64EncodingWriter writer(output);
+  ASSERT_EQ(OkStatus(), writer.Write(AsBytes(kMessage)));
+  ASSERT_EQ(OkStatus(), writer.Finish());
+  EXPECT_EQ(kEncoded, AsString(output.WrittenData()));
+}
+
+TEST(Base64EncodingWriter, OneByteAtATime) {
+  stream::MemoryWriterBuffer<64> output;
+  Base64EncodingWriter writer(output);
+  for (std::byte b : AsBytes(kMessage)) {
+    ASSERT_EQ(OkStatus(), writer.Write(b));
+  }
+  ASSERT_EQ(OkStatus(), writer.Finish());
+  EXPECT_EQ(kEncoded, AsString(output.WrittenData()));
+}
+
+TEST(Base64EncodingWriter, Finish_AddsPadding) {
+  stream::MemoryWriterBuffer<16> output;
+  Base64EncodingWriter writer(output);
+  ASSERT_EQ(OkStatus(), writer.Write(AsBytes("hi")));
+  EXPECT_TRUE(output.WrittenData().empty());
+  ASSERT_EQ(OkStatus(), writer.Finish());
+  EXPECT_EQ("aGk=", AsString(output.WrittenData()));
+}
+
+TEST(Base64EncodingWriter, LargeWrite_MatchesEncode) {
+  std::byte data[500];
+  for (size_t i = 0; i < sizeof(data); ++i) {
+    data[i] = std::byte(i * 7 + 3);
+  }
+  char expected[EncodedSize(sizeof(data))];
+  Encode(data, expected);
+
+  stream::MemoryWriterBuffer<sizeof(expected)> output;
+  Base64EncodingWriter writer(output);
+  ASSERT_EQ(OkStatus(), writer.Write(std::span(data).first(100)));
+  ASSERT_EQ(OkStatus(), writer.Write(std::span(data).subspan(100)));
+  ASSERT_EQ(OkStatus(), writer.Finish());
+  EXPECT_EQ(std::string_view(expected, sizeof(expected)),
+            AsString(output.WrittenData()));
+}
+
+TEST(Base64EncodingWriter, OutputFull_ReturnsError) {
+  stream::MemoryWriterBuffer<4> output;
+  Base64EncodingWriter writer(output);
+  EXPECT_EQ(Status::ResourceExhausted(), writer.Write(AsBytes(kMessage)));
+}
+
+TEST(Base64DecodingReader, WholeMessage) {
+  stream::MemoryReader input(AsBytes(kEncoded));
+  Base64DecodingReader reader(input);
+  std::byte buffer[64];
+  Result<ByteSpan> result = reader.Read(buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(kMessage, AsString(result.value()));
+  EXPECT_EQ(Status::OutOfRange(), reader.Read(buffer).status());
+}
+
+TEST(Base64DecodingReader, SmallReads) {
+  for (size_t read_size = 1; read_size < 8; ++read_size) {
+    stream::MemoryReader input(AsBytes(kEncoded));
+    Base64DecodingReader reader(input);
+
+    char decoded[64];
+    size_t decoded_size = 0;
+    std::byte buffer[8];
+    while (true) {
+      Result<ByteSpan> result = reader.Read(std::span(buffer, read_size));
+      if (!result.ok()) {
+        EXPECT_EQ(Status::OutOfRange(), result.status());
+        break;
+      }
+      ASSERT_LE(result.value().size(), read_size);
+      std::memcpy(&decoded[decoded_size],
+                  result.value().data(),
+                  result.value().size());
+      decoded_size += result.value().size();
+    }
+    EXPECT_EQ(kMessage, std::string_view(decoded, decoded_size));
+  }
+}
+
+// Returns one character per read, to split groups across reads.
+class OneByteReader : public stream::Reader {
+ public:
+  OneByteReader(std::string_view data) : data_(data) {}
+
+ private:
+  StatusWithSize DoRead(ByteSpan dest) override {
+    if (data_.empty()) {
+      return StatusWithSize::OutOfRange();
+    }
+    dest[0] = std::byte(data_[0]);
+    data_.remove_prefix(1);
+    return StatusWithSize(1);
+  }
+
+  std::string_view data_;
+};
+
+TEST(Base64DecodingReader, PartialGroups_CarriedAcrossReads) {
+  OneByteReader input("aGk=");
+  Base64DecodingReader reader(input);
+  std::byte buffer[8];
+  Result<ByteSpan> result = reader.Read(buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ("hi", AsString(result.value()));
+}
+
+TEST(Base64DecodingReader, InvalidCharacter_DataLoss) {
+  stream::MemoryReader input(AsBytes("aGk#"));
+  Base64DecodingReader reader(input);
+  std::byte buffer[8];
+  EXPECT_EQ(Status::DataLoss(), reader.Read(buffer).status());
+}
+
+TEST(Base64DecodingReader, TruncatedGroup_DataLoss) {
+  stream::MemoryReader input(AsBytes("aGk=aG"));
+  Base64DecodingReader reader(input);
+  std::byte buffer[8];
+  Result<ByteSpan> result = reader.Read(buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ("hi", AsString(result.value()));
+  EXPECT_EQ(Status::DataLoss(), reader.Read(buffer).status());
+}
+
+TEST(Base64Stream, RoundTrip) {
+  std::byte data[300];
+  for (size_t i = 0; i < sizeof(data); ++i) {
+    data[i] = std::byte(i * 13 + 5);
+  }
+
+  stream::MemoryWriterBuffer<EncodedSize(sizeof(data))> encoded;
+  Base64EncodingWriter writer(encoded);
+  ASSERT_EQ(OkStatus(), writer.Write(data));
+  ASSERT_EQ(OkStatus(), writer.Finish());
+
+  stream::MemoryReader input(encoded.WrittenData());
+  Base64DecodingReader reader(input);
+  std::byte decoded[sizeof(data)];
+  size_t decoded_size = 0;
+  while (decoded_size < sizeof(decoded)) {
+    Result<ByteSpan> result =
+        reader.Read(std::span(decoded).subspan(decoded_size).first(
+            std::min<size_t>(29, sizeof(decoded) - decoded_size)));
+    ASSERT_EQ(OkStatus(), result.status());
+    decoded_size += result.value().size();
+  }
+  EXPECT_EQ(0, std::memcmp(data, decoded, sizeof(data)));
+}
+
+}  // namespace
+}  // namespace pw::base64
@@ -84,7 +84,7 @@ def parse_args() -> argparse.Namespace:
 
 def run_bloaty(
     filename: str,
-    config: str,
+    config: Optional[str],
     base_file: Optional[str] = None,
     data_sources: Iterable[str] = (),
     extra_args: Iterable[str] = ()
@@ -93,7 +93,8 @@ def run_bloaty(
 
     Args:
         filename: Path to the binary.
-        config: Path to Bloaty config file.
+        config: Path to Bloaty config file. May be None to use Bloaty's
+            defaults.
         base_file: Path to a base binary. If provided, a size diff is performed.
         data_sources: List of Bloaty data sources for the report.
         extra_args: Additional command-line arguments to pass to Bloaty.
@@ -112,7 +113,6 @@ def run_bloaty(
     # yapf: disable
     cmd = [
         bloaty_path,
-        '-c', config,
         '-d', ','.join(data_sources),
         '--domain', 'vm',
         filename,
@@ -120,6 +120,9 @@ def run_bloaty(
     ]
     # yapf: enable
 
+    if config is not None:
+        cmd[1:1] = ['-c', config]
+
     if base_file is not None:
         cmd.extend(['--', base_file])
 
@@ -0,0 +1,408 @@
+# Copyright 2021 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Records per-symbol binary sizes and diffs them against a baseline.
+
+A size snapshot is a JSON file recording the flash and RAM used by a binary,
+broken down by section, by module (compile unit), and by symbol. Snapshots are
+taken with Bloaty. Stack frame sizes may also be recorded from the .su files
+emitted by compiling with -fstack-usage.
+
+Diffing a snapshot against a stored baseline produces machine-readable JSON or
+CSV listing every size that changed, so that size regressions can be tracked
+over time and checked in CI.
+"""
+
+import argparse
+import csv
+import io
+import json
+import logging
+from pathlib import Path
+import re
+import sys
+from typing import Dict, Iterable, List, NamedTuple, Optional, TextIO
+
+import pw_cli.log
+
+from pw_bloat.bloat import run_bloaty
+
+_LOG = logging.getLogger(__name__)
+
+# Sections which only occupy RAM.
+DEFAULT_RAM_SECTIONS = r'^\.(bss|noinit|heap|stack|tbss)\b'
+
+# Sections which occupy RAM and whose initial contents are stored in flash.
+DEFAULT_INITIALIZED_RAM_SECTIONS = r'^\.(data|tdata|ramfunc)\b'
+
+# Maps section name -> name -> size in bytes.
+SizesBySection = Dict[str, Dict[str, int]]
+
+
+class SizeSnapshot(NamedTuple):
+    """The sizes of the parts of a binary."""
+    label: str
+    flash: int
+    ram: int
+    sections: Dict[str, int]
+    modules: SizesBySection
+    symbols: SizesBySection
+
+    # Maps function -> stack frame size in bytes.
+    stack: Dict[str, int]
+
+    def to_json(self) -> str:
+        return json.dumps(self._asdict(), indent=2, sort_keys=True)
+
+    @classmethod
+    def from_json(cls, data: str) -> 'SizeSnapshot':
+        return cls(**json.loads(data))
+
+
+class SectionClassifier:
+    """Determines whether sections occupy flash, RAM, or both."""
+    def __init__(
+            self,
+            ram_sections: str = DEFAULT_RAM_SECTIONS,
+            initialized_ram_sections: str = DEFAULT_INITIALIZED_RAM_SECTIONS):
+        self._ram = re.compile(ram_sections)
+        self._initialized_ram = re.compile(initialized_ram_sections)
+
+    def memory(self, section: str) -> str:
+        """Returns 'ram', 'flash', or 'both' for a section."""
+        if self._initialized_ram.search(section):
+            return 'both'
+        if self._ram.search(section):
+            return 'ram'
+        return 'flash'
+
+    def in_ram(self, section: str) -> bool:
+        return self.memory(section) != 'flash'
+
+    def in_flash(self, section: str) -> bool:
+        return self.memory(section) != 'ram'
+
+
+def parse_bloaty_csv(raw_csv: str) -> SizesBySection:
+    """Parses Bloaty CSV output from a sections,<source> breakdown.
+
+    Returns:
+        Map of section name to map of data source item to VM size in bytes.
+    """
+    sizes: SizesBySection = {}
+
+    reader = csv.reader(io.StringIO(raw_csv))
+    header = next(reader, None)
+    if header is None:
+        return sizes
+
+    size_column = header.index('vmsize')
+    for row in reader:
+        size = int(row[size_column])
+        if size == 0:
+            continue
+
+        items = sizes.setdefault(row[0], {})
+        items[row[1]] = items.get(row[1], 0) + size
+
+    return sizes
+
+
+def parse_stack_usage(lines: Iterable[str]) -> Dict[str, int]:
+    """Parses the contents of GCC .su files.
+
+    Each line has the form "file:line:column:function<TAB>bytes<TAB>qualifiers".
+    Functions are named "function (file)", since static functions in different
+    files may share a name.
+    """
+    stack: Dict[str, int] = {}
+
+    for line in lines:
+        fields = line.rstrip('\n').split('\t')
+        if len(fields) < 2:
+            continue
+
+        location, size = fields[0], fields[1]
+        parts = location.split(':', 3)
+        if len(parts) != 4 or not size.isdigit():
+            continue
+
+        name = f'{parts[3]} ({parts[0]})'
+        stack[name] = max(stack.get(name, 0), int(size))
+
+    return stack
+
+
+def read_stack_usage(directories: Iterable[Path]) -> Dict[str, int]:
+    """Reads all .su files under the directories."""
+    stack: Dict[str, int] = {}
+
+    for directory in directories:
+        for path in sorted(directory.rglob('*.su')):
+            for name, size in parse_stack_usage(
+                    path.read_text().splitlines()).items():
+                stack[name] = max(stack.get(name, 0), size)
+
+    return stack
+
+
+def create_snapshot(label: str,
+                    symbols: SizesBySection,
+                    modules: SizesBySection,
+                    stack: Dict[str, int],
+                    classifier: SectionClassifier) -> SizeSnapshot:
+    """Creates a snapshot from per-section symbol and module sizes."""
+    sections = {
+        section: sum(items.values())
+        for section, items in symbols.items()
+    }
+
+    return SizeSnapshot(
+        label=label,
+        flash=sum(size for section, size in sections.items()
+                  if classifier.in_flash(section)),
+        ram=sum(size for section, size in sections.items()
+                if classifier.in_ram(section)),
+        sections=sections,
+        modules=modules,
+        symbols=symbols,
+        stack=stack,
+    )
+
+
+def take_snapshot(binary: str,
+                  label: str,
+                  bloaty_config: Optional[str] = None,
+                  stack_usage_dirs: Iterable[Path] = (),
+                  classifier: SectionClassifier = SectionClassifier()
+                  ) -> SizeSnapshot:
+    """Runs Bloaty on a binary and creates a snapshot of its sizes."""
+    def breakdown(data_source: str) -> SizesBySection:
+        output = run_bloaty(binary,
+                            bloaty_config,
+                            data_sources=['sections', data_source],
+                            extra_args=['--csv', '-n', '0'])
+        return parse_bloaty_csv(output.decode())
+
+    return create_snapshot(label, breakdown('fullsymbols'),
+                           breakdown('compileunits'),
+                           read_stack_usage(stack_usage_dirs), classifier)
+
+
+class SizeDelta(NamedTuple):
+    """A size that differs between two snapshots."""
+    kind: str  # total, section, module, symbol, or stack
+    section: str
+    name: str
+    memory: str  # ram, flash, both, or stack
+    before: int
+    after: int
+
+    @property
+    def delta(self) -> int:
+        return self.after - self.before
+
+    def as_dict(self) -> Dict[str, object]:
+        return dict(self._asdict(), delta=self.delta)
+
+
+def _diff_sizes(before: Dict[str, int], after: Dict[str, int]):
+    for name in sorted(before.keys() | after.keys()):
+        old, new = before.get(name, 0), after.get(name, 0)
+        if old != new:
+            yield name, old, new
+
+
+def diff_snapshots(
+    baseline: SizeSnapshot,
+    current: SizeSnapshot,
+    classifier: SectionClassifier = SectionClassifier()
+) -> List[SizeDelta]:
+    """Lists the sizes that changed between two snapshots.
+
+    Totals come first, followed by sections, modules, symbols, and stack
+    frames. Within each kind, the largest growth comes first.
+    """
+    deltas = [
+        SizeDelta('total', '', name, name, old, new)
+        for name, old, new in _diff_sizes(
+            dict(flash=baseline.flash, ram=baseline.ram),
+            dict(flash=current.flash, ram=current.ram))
+    ]
+
+    deltas.extend(
+        SizeDelta('section', name, name, classifier.memory(name), old, new)
+        for name, old, new in _diff_sizes(baseline.sections, current.sections))
+
+    for kind, before, after in (('module', baseline.modules, current.modules),
+                                ('symbol', baseline.symbols, current.symbols)):
+        for section in sorted(before.keys() | after.keys()):
+            deltas.extend(
+                SizeDelta(kind, section, name, classifier.memory(section), old,
+                          new) for name, old, new in _diff_sizes(
+                              before.get(section, {}), after.get(section, {})))
+
+    deltas.extend(
+        SizeDelta('stack', '', name, 'stack', old, new)
+        for name, old, new in _diff_sizes(baseline.stack, current.stack))
+
+    kinds = ['total', 'section', 'module', 'symbol', 'stack']
+    deltas.sort(key=lambda d: (kinds.index(d.kind), -d.delta))
+    return deltas
+
+
+def write_json(deltas: Iterable[SizeDelta], output: TextIO) -> None:
+    json.dump([d.as_dict() for d in deltas], output, indent=2)
+    output.write('\n')
+
+
+def write_csv(deltas: Iterable[SizeDelta], output: TextIO) -> None:
+    writer = csv.writer(output, lineterminator='\n')
+    writer.writerow(
+        ['kind', 'section', 'name', 'memory', 'before', 'after', 'delta'])
+    for d in deltas:
+        writer.writerow(
+            [d.kind, d.section, d.name, d.memory, d.before, d.after, d.delta])
+
+
+def _check_growth(deltas: Iterable[SizeDelta], memory: str,
+                  limit: Optional[int]) -> bool:
+    for d in deltas:
+        if d.kind == 'total' and d.name == memory:
+            _LOG.info('%s: %+d bytes (%d -> %d)', memory, d.delta, d.before,
+                      d.after)
+            if limit is not None and d.delta > limit:
+                _LOG.error('%s grew by %d bytes; at most %d are allowed',
+                           memory, d.delta, limit)
+                return False
+    return True
+
+
+def report_diff(baseline: SizeSnapshot,
+                current: SizeSnapshot,
+                classifier: SectionClassifier,
+                json_output: Optional[Path] = None,
+                csv_output: Optional[Path] = None,
+                max_flash_growth: Optional[int] = None,
+                max_ram_growth: Optional[int] = None) -> bool:
+    """Writes the diff between two snapshots and checks the growth limits.
+
+    Returns:
+        False if flash or RAM grew by more than allowed.
+    """
+    deltas = diff_snapshots(baseline, current, classifier)
+
+    if json_output:
+        with json_output.open('w') as output:
+            write_json(deltas, output)
+
+    if csv_output:
+        with csv_output.open('w') as output:
+            write_csv(deltas, output)
+
+    flash_ok = _check_growth(deltas, 'flash', max_flash_growth)
+    ram_ok = _check_growth(deltas, 'ram', max_ram_growth)
+    return flash_ok and ram_ok
+
+
+def _add_diff_arguments(parser: argparse.ArgumentParser) -> None:
+    parser.add_argument('--diff-json',
+                        type=Path,
+                        help='File in which to write the diff as JSON')
+    parser.add_argument('--diff-csv',
+                        type=Path,
+                        help='File in which to write the diff as CSV')
+    parser.add_argument('--max-flash-growth',
+                        type=int,
+                        help='Fail if flash grows by more than this many bytes')
+    parser.add_argument('--max-ram-growth',
+                        type=int,
+                        help='Fail if RAM grows by more than this many bytes')
+    parser.add_argument('--ram-sections',
+                        default=DEFAULT_RAM_SECTIONS,
+                        help='Regex matching sections which only occupy RAM')
+    parser.add_argument(
+        '--initialized-ram-sections',
+        default=DEFAULT_INITIALIZED_RAM_SECTIONS,
+        help='Regex matching sections which occupy both RAM and flash')
+
+
+def parse_args() -> argparse.Namespace:
+    """Parses the script's arguments."""
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    subparsers = parser.add_subparsers(dest='command', required=True)
+
+    snapshot = subparsers.add_parser(
+        'snapshot',
+        help='Take a snapshot of a binary, optionally diffing it against a '
+        'baseline')
+    snapshot.add_argument('binary', help='The binary of which to take sizes')
+    snapshot.add_argument('--out',
+                          type=Path,
+                          required=True,
+                          help='File in which to write the snapshot')
+    snapshot.add_argument('--label', help='Name for the binary')
+    snapshot.add_argument('--bloaty-config',
+                          help='Data source configuration for Bloaty')
+    snapshot.add_argument('--stack-usage-dir',
+                          type=Path,
+                          action='append',
+                          default=[],
+                          help='Directory containing .su files to record')
+    snapshot.add_argument('--baseline',
+                          type=Path,
+                          help='Snapshot against which to diff the binary')
+    _add_diff_arguments(snapshot)
+
+    diff = subparsers.add_parser('diff', help='Diff two stored snapshots')
+    diff.add_argument('baseline', type=Path, help='The earlier snapshot')
+    diff.add_argument('current', type=Path, help='The later snapshot')
+    _add_diff_arguments(diff)
+
+    return parser.parse_args()
+
+
+def main() -> int:
+    """Program entry point."""
+    args = parse_args()
+    classifier = SectionClassifier(args.ram_sections,
+                                   args.initialized_ram_sections)
+
+    if args.command == 'snapshot':
+        current = take_snapshot(args.binary, args.label or Path(
+            args.binary).name, args.bloaty_config, args.stack_usage_dir,
+                                classifier)
+        args.out.write_text(current.to_json())
+        _LOG.debug('Snapshot written to %s', args.out)
+
+        if not args.baseline:
+            return 0
+
+        if args.baseline.exists():
+            baseline = SizeSnapshot.from_json(args.baseline.read_text())
+        else:
+            # Write an empty diff so that the outputs always exist.
+            _LOG.warning('Baseline %s does not exist', args.baseline)
+            baseline = current
+    else:
+        baseline = SizeSnapshot.from_json(args.baseline.read_text())
+        current = SizeSnapshot.from_json(args.current.read_text())
+
+    ok = report_diff(baseline, current, classifier, args.diff_json,
+                     args.diff_csv, args.max_flash_growth, args.max_ram_growth)
+    return 0 if ok else 1
+
+
+if __name__ == '__main__':
+    pw_cli.log.install()
+    sys.exit(main())
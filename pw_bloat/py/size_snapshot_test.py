@@ -0,0 +1,192 @@
+# Copyright 2021 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Tests for the size_snapshot module."""
+
+import io
+import unittest
+
+from pw_bloat import size_snapshot
+from pw_bloat.size_snapshot import SectionClassifier, SizeDelta, SizeSnapshot
+
+SYMBOLS_CSV = '''\
+sections,fullsymbols,vmsize,filesize
+.text,main,100,100
+.text,pw::Foo(),60,60
+.text,pw::Foo(),4,4
+.rodata,kTable,32,32
+.data,counter,8,8
+.bss,buffer,256,0
+.debug_info,[Unmapped],0,4000
+'''
+
+MODULES_CSV = '''\
+sections,compileunits,vmsize,filesize
+.text,main.cc,100,100
+.text,foo.cc,64,64
+.rodata,foo.cc,32,32
+.data,main.cc,8,8
+.bss,foo.cc,256,0
+'''
+
+STACK_USAGE = '''\
+main.cc:10:5:int main()\t48\tstatic
+foo.cc:7:6:void pw::Foo()\t128\tdynamic,bounded
+foo.cc:20:13:void Helper()\t16\tstatic
+bar.cc:3:13:void Helper()\t24\tstatic
+not a stack usage line
+'''
+
+
+def _snapshot() -> SizeSnapshot:
+    return size_snapshot.create_snapshot(
+        'test', size_snapshot.parse_bloaty_csv(SYMBOLS_CSV),
+        size_snapshot.parse_bloaty_csv(MODULES_CSV),
+        size_snapshot.parse_stack_usage(STACK_USAGE.splitlines()),
+        SectionClassifier())
+
+
+class SectionClassifierTest(unittest.TestCase):
+    """Tests the SectionClassifier class."""
+    def test_default_sections(self) -> None:
+        classifier = SectionClassifier()
+        self.assertEqual(classifier.memory('.text'), 'flash')
+        self.assertEqual(classifier.memory('.rodata'), 'flash')
+        self.assertEqual(classifier.memory('.data'), 'both')
+        self.assertEqual(classifier.memory('.bss'), 'ram')
+        self.assertEqual(classifier.memory('.bss.foo'), 'ram')
+        self.assertEqual(classifier.memory('.noinit'), 'ram')
+        self.assertEqual(classifier.memory('.database'), 'flash')
+
+    def test_custom_sections(self) -> None:
+        classifier = SectionClassifier(r'^\.ram_', r'^\.fast_')
+        self.assertEqual(classifier.memory('.bss'), 'flash')
+        self.assertEqual(classifier.memory('.ram_buffers'), 'ram')
+        self.assertEqual(classifier.memory('.fast_code'), 'both')
+
+
+class SnapshotTest(unittest.TestCase):
+    """Tests creating snapshots."""
+    def test_parse_bloaty_csv(self) -> None:
+        self.assertEqual(
+            size_snapshot.parse_bloaty_csv(SYMBOLS_CSV), {
+                '.text': {
+                    'main': 100,
+                    'pw::Foo()': 64
+                },
+                '.rodata': {
+                    'kTable': 32
+                },
+                '.data': {
+                    'counter': 8
+                },
+                '.bss': {
+                    'buffer': 256
+                },
+            })
+
+    def test_parse_bloaty_csv_empty(self) -> None:
+        self.assertEqual(size_snapshot.parse_bloaty_csv(''), {})
+
+    def test_parse_stack_usage(self) -> None:
+        self.assertEqual(
+            size_snapshot.parse_stack_usage(STACK_USAGE.splitlines()), {
+                'int main() (main.cc)': 48,
+                'void pw::Foo() (foo.cc)': 128,
+                'void Helper() (foo.cc)': 16,
+                'void Helper() (bar.cc)': 24,
+            })
+
+    def test_totals(self) -> None:
+        snapshot = _snapshot()
+        self.assertEqual(snapshot.flash, 100 + 64 + 32 + 8)
+        self.assertEqual(snapshot.ram, 8 + 256)
+        self.assertEqual(snapshot.sections['.text'], 164)
+        self.assertEqual(snapshot.modules['.text']['foo.cc'], 64)
+
+    def test_json_round_trip(self) -> None:
+        snapshot = _snapshot()
+        self.assertEqual(SizeSnapshot.from_json(snapshot.to_json()), snapshot)
+
+
+class DiffTest(unittest.TestCase):
+    """Tests diffing snapshots."""
+    def setUp(self) -> None:
+        super().setUp()
+        self.baseline = _snapshot()
+
+        symbols = size_snapshot.parse_bloaty_csv(SYMBOLS_CSV)
+        symbols['.bss']['buffer'] = 512
+        symbols['.text']['pw::Bar()'] = 20
+        del symbols['.rodata']
+        modules = size_snapshot.parse_bloaty_csv(MODULES_CSV)
+        modules['.bss']['foo.cc'] = 512
+        stack = size_snapshot.parse_stack_usage(STACK_USAGE.splitlines())
+        stack['int main() (main.cc)'] = 64
+
+        self.current = size_snapshot.create_snapshot('test', symbols, modules,
+                                                     stack,
+                                                     SectionClassifier())
+
+    def test_identical_snapshots(self) -> None:
+        self.assertEqual(
+            size_snapshot.diff_snapshots(self.baseline, self.baseline), [])
+
+    def test_deltas(self) -> None:
+        deltas = size_snapshot.diff_snapshots(self.baseline, self.current)
+        self.assertEqual(deltas, [
+            SizeDelta('total', '', 'ram', 'ram', 264, 520),
+            SizeDelta('total', '', 'flash', 'flash', 204, 192),
+            SizeDelta('section', '.bss', '.bss', 'ram', 256, 512),
+            SizeDelta('section', '.text', '.text', 'flash', 164, 184),
+            SizeDelta('section', '.rodata', '.rodata', 'flash', 32, 0),
+            SizeDelta('module', '.bss', 'foo.cc', 'ram', 256, 512),
+            SizeDelta('symbol', '.bss', 'buffer', 'ram', 256, 512),
+            SizeDelta('symbol', '.text', 'pw::Bar()', 'flash', 0, 20),
+            SizeDelta('symbol', '.rodata', 'kTable', 'flash', 32, 0),
+            SizeDelta('stack', '', 'int main() (main.cc)', 'stack', 48, 64),
+        ])
+
+    def test_write_csv(self) -> None:
+        output = io.StringIO()
+        size_snapshot.write_csv(
+            [SizeDelta('symbol', '.bss', 'buffer', 'ram', 256, 512)], output)
+        self.assertEqual(
+            output.getvalue(), 'kind,section,name,memory,before,after,delta\n'
+            'symbol,.bss,buffer,ram,256,512,256\n')
+
+    def test_write_json(self) -> None:
+        output = io.StringIO()
+        size_snapshot.write_json(
+            [SizeDelta('total', '', 'ram', 'ram', 10, 4)], output)
+        self.assertIn('"delta": -6', output.getvalue())
+
+    def test_growth_limits(self) -> None:
+        classifier = SectionClassifier()
+        self.assertTrue(
+            size_snapshot.report_diff(self.baseline, self.current, classifier))
+        self.assertTrue(
+            size_snapshot.report_diff(self.baseline,
+                                      self.current,
+                                      classifier,
+                                      max_flash_growth=0,
+                                      max_ram_growth=256))
+        self.assertFalse(
+            size_snapshot.report_diff(self.baseline,
+                                      self.current,
+                                      classifier,
+                                      max_ram_growth=255))
+
+
+if __name__ == '__main__':
+    unittest.main()
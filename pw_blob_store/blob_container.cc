@@ -0,0 +1,365 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_blob_store/blob_container.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_assert/assert.h"
+#include "pw_checksum/crc32.h"
+#include "pw_kvs/alignment.h"
+#include "pw_log/log.h"
+#include "pw_status/try.h"
+
+namespace pw::blob_store {
+
+Status BlobContainer::Init() {
+  if (initialized_) {
+    return OkStatus();
+  }
+
+  PW_LOG_INFO("Init BlobContainer");
+
+  const size_t write_size_alignment =
+      flash_write_size_bytes_ % partition_.alignment_bytes();
+  const size_t sector_alignment =
+      partition_.sector_size_bytes() % flash_write_size_bytes_;
+  PW_CHECK_UINT_EQ(write_size_alignment, 0);
+  PW_CHECK_UINT_EQ(sector_alignment, 0);
+  PW_CHECK_UINT_GE(write_buffer_.size_bytes(), flash_write_size_bytes_);
+
+  const StatusWithSize result = kvs_.Get(name_, std::as_writable_bytes(index_));
+  bool index_valid = result.ok() && result.size() == index_.size_bytes();
+  if (!index_valid && !result.IsNotFound()) {
+    PW_LOG_ERROR("BlobContainer init - Index does not match the container");
+  }
+
+  // Find the end of the blobs, checking that the index is sensible.
+  next_address_ = 0;
+  for (const IndexEntry& entry : index_) {
+    if (!index_valid || entry.size_bytes == 0u) {
+      continue;
+    }
+    if (entry.address % flash_write_size_bytes_ != 0u ||
+        entry.address > partition_.size_bytes() ||
+        entry.size_bytes > partition_.size_bytes() - entry.address) {
+      PW_LOG_ERROR("BlobContainer init - Index has an invalid entry");
+      index_valid = false;
+      break;
+    }
+    next_address_ = std::max<size_t>(
+        next_address_,
+        AlignUp(entry.address + entry.size_bytes, flash_write_size_bytes_));
+  }
+
+  if (!index_valid) {
+    std::fill(index_.begin(), index_.end(), IndexEntry{});
+    next_address_ = 0;
+  }
+
+  // Data may have been written after the last blob by a write that did not
+  // finish. The next blob starts in the next sector in that case, since flash
+  // can't be rewritten without an erase.
+  bool erased = true;
+  if (next_address_ < partition_.size_bytes()) {
+    partition_.IsRegionErased(
+        next_address_, partition_.size_bytes() - next_address_, &erased);
+  }
+  if (erased) {
+    erased_end_ = partition_.size_bytes();
+  } else {
+    next_address_ = AlignUp(next_address_, partition_.sector_size_bytes());
+    erased_end_ = next_address_;
+  }
+
+  PW_LOG_DEBUG("BlobContainer init - %u blobs, next blob at %u",
+               static_cast<unsigned>(size()),
+               static_cast<unsigned>(next_address_));
+
+  initialized_ = true;
+  return OkStatus();
+}
+
+Status BlobContainer::Clear() {
+  if (!initialized_) {
+    return Status::FailedPrecondition();
+  }
+  if (writer_open_ || readers_open_ != 0u) {
+    return Status::Unavailable();
+  }
+
+  const Status status = kvs_.Delete(name_);
+  if (!status.ok() && !status.IsNotFound()) {
+    return status;
+  }
+
+  std::fill(index_.begin(), index_.end(), IndexEntry{});
+
+  // Sectors that held blobs are erased again as new blobs are written.
+  if (next_address_ != 0u) {
+    erased_end_ = 0;
+  }
+  next_address_ = 0;
+  return OkStatus();
+}
+
+size_t BlobContainer::size() const {
+  return std::count_if(index_.begin(), index_.end(), [](const IndexEntry& e) {
+    return e.size_bytes != 0u;
+  });
+}
+
+size_t BlobContainer::BlobSizeBytes(std::string_view name) const {
+  const IndexEntry* entry = FindSlot(NameHash(name));
+  return entry == nullptr ? 0 : entry->size_bytes;
+}
+
+size_t BlobContainer::FreeBytes() const {
+  return partition_.size_bytes() - next_address_;
+}
+
+uint32_t BlobContainer::NameHash(std::string_view name) {
+  return checksum::Crc32::Calculate(
+      std::as_bytes(std::span(name.data(), name.size())));
+}
+
+BlobContainer::IndexEntry* BlobContainer::FindSlot(uint32_t name_hash) const {
+  // Blobs are never removed individually, so probing can stop at the first
+  // empty slot.
+  const size_t start = name_hash % index_.size();
+  for (size_t i = 0; i < index_.size(); ++i) {
+    IndexEntry& entry = index_[(start + i) % index_.size()];
+    if (entry.size_bytes == 0u || entry.name_hash == name_hash) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+Status BlobContainer::OpenWrite(std::string_view name) {
+  if (!initialized_) {
+    return Status::FailedPrecondition();
+  }
+  if (writer_open_) {
+    return Status::Unavailable();
+  }
+
+  write_name_hash_ = NameHash(name);
+  write_slot_ = FindSlot(write_name_hash_);
+  if (write_slot_ == nullptr) {
+    return Status::ResourceExhausted();
+  }
+
+  PW_LOG_DEBUG("BlobContainer writer open at %u",
+               static_cast<unsigned>(next_address_));
+
+  writer_open_ = true;
+  write_error_ = false;
+  write_start_ = next_address_;
+  write_size_bytes_ = 0;
+  flash_address_ = next_address_;
+  if (checksum_algo_ != nullptr) {
+    checksum_algo_->Reset();
+  }
+  return OkStatus();
+}
+
+Status BlobContainer::Write(ConstByteSpan data) {
+  if (write_error_) {
+    return Status::DataLoss();
+  }
+  if (data.size_bytes() > WriteBytesRemaining()) {
+    return Status::ResourceExhausted();
+  }
+
+  while (!data.empty()) {
+    const size_t buffered = WriteBufferBytesUsed();
+    const size_t add_bytes =
+        std::min(flash_write_size_bytes_ - buffered, data.size_bytes());
+    std::memcpy(write_buffer_.data() + buffered, data.data(), add_bytes);
+    write_size_bytes_ += add_bytes;
+    data = data.subspan(add_bytes);
+
+    if (WriteBufferBytesUsed() == flash_write_size_bytes_ &&
+        !CommitToFlash(flash_write_size_bytes_).ok()) {
+      write_error_ = true;
+      return Status::DataLoss();
+    }
+  }
+  return OkStatus();
+}
+
+Status BlobContainer::CloseWrite() {
+  auto do_close_write = [&]() -> Status {
+    if (write_error_) {
+      return Status::DataLoss();
+    }
+    if (write_size_bytes_ == 0u) {
+      return OkStatus();
+    }
+
+    // Pad the final partial chunk to flash_write_size_bytes_ and write it.
+    const size_t buffered = WriteBufferBytesUsed();
+    if (buffered != 0u) {
+      std::memset(write_buffer_.data() + buffered,
+                  static_cast<int>(partition_.erased_memory_content()),
+                  flash_write_size_bytes_ - buffered);
+      if (!CommitToFlash(buffered).ok()) {
+        return Status::DataLoss();
+      }
+    }
+
+    IndexEntry entry = {
+        .name_hash = write_name_hash_,
+        .address = static_cast<uint32_t>(write_start_),
+        .size_bytes = static_cast<uint32_t>(write_size_bytes_),
+        .checksum = 0,
+    };
+    if (checksum_algo_ != nullptr) {
+      ConstByteSpan checksum = checksum_algo_->Finish();
+      std::memcpy(&entry.checksum,
+                  checksum.data(),
+                  std::min(checksum.size(), sizeof(entry.checksum)));
+      if (!VerifyWrite(write_start_, write_size_bytes_, entry.checksum).ok()) {
+        return Status::DataLoss();
+      }
+    }
+
+    next_address_ = AlignUp(flash_address_, flash_write_size_bytes_);
+
+    const IndexEntry previous_entry = *write_slot_;
+    *write_slot_ = entry;
+    if (!kvs_.Put(name_, std::as_bytes(index_)).ok()) {
+      *write_slot_ = previous_entry;
+      return Status::DataLoss();
+    }
+    return OkStatus();
+  };
+
+  const Status status = do_close_write();
+  writer_open_ = false;
+  write_slot_ = nullptr;
+  if (!status.ok()) {
+    // The chunk at flash_address_ may hold data from a failed flash write, so
+    // the next blob starts after it.
+    next_address_ =
+        std::min(AlignUp(flash_address_ + 1, flash_write_size_bytes_),
+                 partition_.size_bytes());
+    return Status::DataLoss();
+  }
+
+  PW_LOG_DEBUG("BlobContainer writer close, %u byte blob",
+               static_cast<unsigned>(write_size_bytes_));
+  return OkStatus();
+}
+
+Status BlobContainer::CloseRead() {
+  PW_CHECK_UINT_GT(readers_open_, 0);
+  readers_open_--;
+  return OkStatus();
+}
+
+Status BlobContainer::CommitToFlash(size_t data_bytes) {
+  PW_TRY(EraseUpTo(flash_address_ + flash_write_size_bytes_));
+
+  const ConstByteSpan chunk = write_buffer_.first(flash_write_size_bytes_);
+  PW_TRY(partition_.Write(flash_address_, chunk));
+  if (checksum_algo_ != nullptr) {
+    checksum_algo_->Update(chunk.first(data_bytes));
+  }
+  flash_address_ += data_bytes;
+  return OkStatus();
+}
+
+Status BlobContainer::EraseUpTo(kvs::FlashPartition::Address end_address) {
+  if (end_address <= erased_end_) {
+    return OkStatus();
+  }
+
+  const size_t sector_size = partition_.sector_size_bytes();
+  const size_t num_sectors =
+      (end_address - erased_end_ + sector_size - 1) / sector_size;
+  PW_TRY(partition_.Erase(erased_end_, num_sectors));
+  erased_end_ += num_sectors * sector_size;
+  return OkStatus();
+}
+
+Status BlobContainer::VerifyWrite(kvs::FlashPartition::Address address,
+                                  size_t size_bytes,
+                                  uint32_t checksum) {
+  checksum_algo_->Reset();
+
+  constexpr size_t kReadBufferSizeBytes = 32;
+  std::array<std::byte, kReadBufferSizeBytes> buffer;
+  const kvs::FlashPartition::Address end = address + size_bytes;
+  while (address < end) {
+    const size_t read_size = std::min(size_t(end - address), buffer.size());
+    PW_TRY(partition_.Read(address, std::span(buffer).first(read_size)));
+    checksum_algo_->Update(buffer.data(), read_size);
+    address += read_size;
+  }
+  checksum_algo_->Finish();
+
+  return checksum_algo_->Verify(std::as_bytes(std::span(&checksum, 1)));
+}
+
+Status BlobContainer::BlobReader::Open(std::string_view name, size_t offset) {
+  PW_DASSERT(!open_);
+  if (!container_.initialized_) {
+    return Status::FailedPrecondition();
+  }
+
+  const IndexEntry* entry = container_.FindSlot(NameHash(name));
+  if (entry == nullptr || entry->size_bytes == 0u) {
+    return Status::NotFound();
+  }
+  if (offset >= entry->size_bytes) {
+    return Status::InvalidArgument();
+  }
+
+  address_ = entry->address;
+  size_bytes_ = entry->size_bytes;
+  offset_ = offset;
+  open_ = true;
+  container_.readers_open_++;
+  return OkStatus();
+}
+
+Result<ConstByteSpan> BlobContainer::BlobReader::GetMemoryMappedBlob() const {
+  PW_DASSERT(open_);
+  std::byte* mcu_address =
+      container_.partition_.PartitionAddressToMcuAddress(address_);
+  if (mcu_address == nullptr) {
+    return Status::Unimplemented();
+  }
+  return ConstByteSpan(mcu_address, size_bytes_);
+}
+
+StatusWithSize BlobContainer::BlobReader::DoRead(ByteSpan dest) {
+  PW_DASSERT(open_);
+  if (offset_ >= size_bytes_) {
+    return StatusWithSize::OutOfRange();
+  }
+
+  const size_t read_size = std::min(size_bytes_ - offset_, dest.size_bytes());
+  StatusWithSize result =
+      container_.partition_.Read(address_ + offset_, dest.first(read_size));
+  if (result.ok()) {
+    offset_ += result.size();
+  }
+  return result;
+}
+
+}  // namespace pw::blob_store
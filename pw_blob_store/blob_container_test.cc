@@ -0,0 +1,280 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_blob_store/blob_container.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <span>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/test_key_value_store.h"
+#include "pw_random/xor_shift.h"
+
+namespace pw::blob_store {
+namespace {
+
+class BlobContainerTest : public ::testing::Test {
+ protected:
+  BlobContainerTest() : flash_(kFlashAlignment), partition_(&flash_) {}
+
+  void SetUp() override {
+    random::XorShiftStarRng64 rng(0xb10b);
+    rng.Get(source_buffer_);
+  }
+
+  ConstByteSpan Source(size_t offset, size_t size_bytes) {
+    return std::span(source_buffer_).subspan(offset, size_bytes);
+  }
+
+  void WriteBlob(BlobContainer& container,
+                 std::string_view name,
+                 ConstByteSpan data) {
+    BlobContainer::BlobWriter writer(container);
+    ASSERT_EQ(OkStatus(), writer.Open(name));
+    ASSERT_EQ(OkStatus(), writer.Write(data));
+    EXPECT_EQ(data.size_bytes(), writer.CurrentSizeBytes());
+    ASSERT_EQ(OkStatus(), writer.Close());
+  }
+
+  // Reads the blob with a stream and memory mapped and checks the data.
+  void VerifyBlob(BlobContainer& container,
+                  std::string_view name,
+                  ConstByteSpan expected) {
+    EXPECT_EQ(expected.size_bytes(), container.BlobSizeBytes(name));
+
+    BlobContainer::BlobReader reader(container);
+    ASSERT_EQ(OkStatus(), reader.Open(name));
+    ASSERT_EQ(expected.size_bytes(), reader.ConservativeReadLimit());
+
+    std::array<std::byte, kPartitionSize> read_buffer;
+    auto result = reader.Read(read_buffer);
+    ASSERT_EQ(OkStatus(), result.status());
+    ASSERT_EQ(expected.size_bytes(), result.value().size_bytes());
+    EXPECT_EQ(0,
+              std::memcmp(expected.data(),
+                          result.value().data(),
+                          expected.size_bytes()));
+    EXPECT_EQ(0u, reader.ConservativeReadLimit());
+
+    Result<ConstByteSpan> mapped = reader.GetMemoryMappedBlob();
+    ASSERT_TRUE(mapped.ok());
+    ASSERT_EQ(expected.size_bytes(), mapped.value().size_bytes());
+    EXPECT_EQ(
+        0,
+        std::memcmp(expected.data(), mapped.value().data(), expected.size()));
+    EXPECT_EQ(OkStatus(), reader.Close());
+  }
+
+  static constexpr size_t kFlashAlignment = 16;
+  static constexpr size_t kSectorSize = 1024;
+  static constexpr size_t kSectorCount = 4;
+  static constexpr size_t kPartitionSize = kSectorSize * kSectorCount;
+  static constexpr size_t kWriteSize = 64;
+  static constexpr size_t kMaxBlobs = 4;
+
+  using Container = BlobContainerBuffer<kMaxBlobs, kWriteSize>;
+
+  kvs::FakeFlashMemoryBuffer<kSectorSize, kSectorCount> flash_;
+  kvs::FlashPartition partition_;
+  kvs::ChecksumCrc16 checksum_;
+  std::array<std::byte, kPartitionSize> source_buffer_;
+};
+
+TEST_F(BlobContainerTest, Init_Empty) {
+  Container container(
+      "Container_init", partition_, &checksum_, kvs::TestKvs(), kWriteSize);
+  ASSERT_EQ(OkStatus(), container.Init());
+  EXPECT_TRUE(container.empty());
+  EXPECT_EQ(kMaxBlobs, container.max_size());
+  EXPECT_EQ(kPartitionSize, container.FreeBytes());
+
+  BlobContainer::BlobReader reader(container);
+  EXPECT_EQ(Status::NotFound(), reader.Open("missing"));
+}
+
+TEST_F(BlobContainerTest, MultipleBlobs_PackedInPartition) {
+  Container container(
+      "Container_pack", partition_, &checksum_, kvs::TestKvs(), kWriteSize);
+  ASSERT_EQ(OkStatus(), container.Init());
+
+  WriteBlob(container, "font", Source(0, 100));
+  WriteBlob(container, "image", Source(100, 700));
+  WriteBlob(container, "model", Source(800, 1500));
+  EXPECT_EQ(3u, container.size());
+
+  // Each blob starts at the next multiple of the write size.
+  EXPECT_EQ(kPartitionSize - (128 + 704 + 1536), container.FreeBytes());
+
+  VerifyBlob(container, "font", Source(0, 100));
+  VerifyBlob(container, "image", Source(100, 700));
+  VerifyBlob(container, "model", Source(800, 1500));
+}
+
+TEST_F(BlobContainerTest, Init_LoadsIndex) {
+  {
+    Container container(
+        "Container_load", partition_, &checksum_, kvs::TestKvs(), kWriteSize);
+    ASSERT_EQ(OkStatus(), container.Init());
+    WriteBlob(container, "a", Source(0, 200));
+    WriteBlob(container, "b", Source(200, 300));
+  }
+
+  Container container(
+      "Container_load", partition_, &checksum_, kvs::TestKvs(), kWriteSize);
+  ASSERT_EQ(OkStatus(), container.Init());
+  EXPECT_EQ(2u, container.size());
+  VerifyBlob(container, "a", Source(0, 200));
+  VerifyBlob(container, "b", Source(200, 300));
+
+  // New blobs are written after the existing ones.
+  WriteBlob(container, "c", Source(500, 100));
+  VerifyBlob(container, "a", Source(0, 200));
+  VerifyBlob(container, "c", Source(500, 100));
+}
+
+TEST_F(BlobContainerTest, Write_ReplacesBlobWithSameName) {
+  Container container(
+      "Container_replace", partition_, &checksum_, kvs::TestKvs(), kWriteSize);
+  ASSERT_EQ(OkStatus(), container.Init());
+
+  WriteBlob(container, "asset", Source(0, 100));
+
+  // A reader of the old blob is not affected by the new one.
+  BlobContainer::BlobReader reader(container);
+  ASSERT_EQ(OkStatus(), reader.Open("asset"));
+
+  WriteBlob(container, "asset", Source(100, 250));
+  EXPECT_EQ(1u, container.size());
+  VerifyBlob(container, "asset", Source(100, 250));
+
+  EXPECT_EQ(100u, reader.ConservativeReadLimit());
+  EXPECT_EQ(OkStatus(), reader.Close());
+}
+
+TEST_F(BlobContainerTest, Open_IndexFull) {
+  Container container(
+      "Container_full", partition_, &checksum_, kvs::TestKvs(), kWriteSize);
+  ASSERT_EQ(OkStatus(), container.Init());
+
+  const char* names[] = {"0", "1", "2", "3"};
+  for (size_t i = 0; i < kMaxBlobs; ++i) {
+    WriteBlob(container, names[i], Source(i * 10, 10));
+  }
+
+  BlobContainer::BlobWriter writer(container);
+  EXPECT_EQ(Status::ResourceExhausted(), writer.Open("4"));
+
+  // Existing blobs can still be replaced.
+  WriteBlob(container, "2", Source(0, 30));
+  VerifyBlob(container, "2", Source(0, 30));
+}
+
+TEST_F(BlobContainerTest, Write_NoSpace) {
+  Container container(
+      "Container_space", partition_, &checksum_, kvs::TestKvs(), kWriteSize);
+  ASSERT_EQ(OkStatus(), container.Init());
+  WriteBlob(container, "big", Source(0, kPartitionSize - kSectorSize));
+
+  BlobContainer::BlobWriter writer(container);
+  ASSERT_EQ(OkStatus(), writer.Open("other"));
+  EXPECT_EQ(kSectorSize, writer.ConservativeWriteLimit());
+  EXPECT_EQ(Status::ResourceExhausted(),
+            writer.Write(Source(0, kSectorSize + 1)));
+  EXPECT_EQ(OkStatus(), writer.Write(Source(0, kSectorSize)));
+  EXPECT_EQ(OkStatus(), writer.Close());
+  EXPECT_EQ(0u, container.FreeBytes());
+}
+
+TEST_F(BlobContainerTest, Reader_InvalidOffset) {
+  Container container(
+      "Container_offset", partition_, &checksum_, kvs::TestKvs(), kWriteSize);
+  ASSERT_EQ(OkStatus(), container.Init());
+  WriteBlob(container, "blob", Source(0, 64));
+
+  BlobContainer::BlobReader reader(container);
+  EXPECT_EQ(Status::InvalidArgument(), reader.Open("blob", 64));
+  ASSERT_EQ(OkStatus(), reader.Open("blob", 60));
+  EXPECT_EQ(4u, reader.ConservativeReadLimit());
+  EXPECT_EQ(OkStatus(), reader.Close());
+}
+
+TEST_F(BlobContainerTest, Init_AfterInterruptedWrite_SkipsToNextSector) {
+  alignas(BlobContainer::BlobWriter) std::byte
+      writer_storage[sizeof(BlobContainer::BlobWriter)];
+  {
+    Container container("Container_interrupt",
+                        partition_,
+                        &checksum_,
+                        kvs::TestKvs(),
+                        kWriteSize);
+    ASSERT_EQ(OkStatus(), container.Init());
+    WriteBlob(container, "kept", Source(0, 100));
+
+    // The writer is never closed, as if the device rebooted.
+    auto& writer = *new (&writer_storage) BlobContainer::BlobWriter(container);
+    ASSERT_EQ(OkStatus(), writer.Open("lost"));
+    ASSERT_EQ(OkStatus(), writer.Write(Source(100, 200)));
+  }
+
+  Container container("Container_interrupt",
+                      partition_,
+                      &checksum_,
+                      kvs::TestKvs(),
+                      kWriteSize);
+  ASSERT_EQ(OkStatus(), container.Init());
+  EXPECT_EQ(1u, container.size());
+  EXPECT_EQ(0u, container.BlobSizeBytes("lost"));
+  EXPECT_EQ(kPartitionSize - kSectorSize, container.FreeBytes());
+
+  WriteBlob(container, "new", Source(300, 500));
+  VerifyBlob(container, "kept", Source(0, 100));
+  VerifyBlob(container, "new", Source(300, 500));
+}
+
+TEST_F(BlobContainerTest, Clear_RemovesAllBlobs) {
+  Container container(
+      "Container_clear", partition_, &checksum_, kvs::TestKvs(), kWriteSize);
+  ASSERT_EQ(OkStatus(), container.Init());
+  WriteBlob(container, "a", Source(0, 1500));
+  WriteBlob(container, "b", Source(1500, 100));
+
+  {
+    BlobContainer::BlobReader reader(container);
+    ASSERT_EQ(OkStatus(), reader.Open("a"));
+    EXPECT_EQ(Status::Unavailable(), container.Clear());
+  }
+
+  ASSERT_EQ(OkStatus(), container.Clear());
+  EXPECT_TRUE(container.empty());
+  EXPECT_EQ(kPartitionSize, container.FreeBytes());
+
+  // The flash with the old blobs is erased as it is written again.
+  WriteBlob(container, "c", Source(100, 2000));
+  VerifyBlob(container, "c", Source(100, 2000));
+
+  Container reloaded(
+      "Container_clear", partition_, &checksum_, kvs::TestKvs(), kWriteSize);
+  ASSERT_EQ(OkStatus(), reloaded.Init());
+  EXPECT_EQ(1u, reloaded.size());
+  VerifyBlob(reloaded, "c", Source(100, 2000));
+}
+
+}  // namespace
+}  // namespace pw::blob_store
@@ -15,7 +15,10 @@
 #include "pw_blob_store/blob_store.h"
 
 #include <algorithm>
+#include <array>
+#include <cstring>
 
+#include "pw_kvs/alignment.h"
 #include "pw_log/log.h"
 #include "pw_status/try.h"
 
@@ -51,6 +54,7 @@ Status BlobStore::Init() {
   bool erased = false;
   if (partition_.IsErased(&erased).ok() && erased) {
     flash_erased_ = true;
+    erased_end_ = MaxDataSizeBytes();
 
     // Blob data is considered valid as soon as the flash is erased. Even though
     // there are 0 bytes written, they are valid.
@@ -80,7 +84,7 @@ Status BlobStore::LoadMetadata() {
 
 size_t BlobStore::MaxDataSizeBytes() const { return partition_.size_bytes(); }
 
-Status BlobStore::OpenWrite() {
+Status BlobStore::PrepareWriter(bool double_buffered) {
   if (!initialized_) {
     return Status::FailedPrecondition();
   }
@@ -91,6 +95,26 @@ Status BlobStore::OpenWrite() {
     return Status::Unavailable();
   }
 
+  size_t double_buffer_size_bytes = 0;
+  if (double_buffered) {
+    // Each buffer holds whole chunks, so a full buffer is written to flash
+    // without moving any bytes.
+    double_buffer_size_bytes =
+        AlignDown(write_buffer_.size_bytes() / 2, flash_write_size_bytes_);
+    if (double_buffer_size_bytes == 0) {
+      return Status::InvalidArgument();
+    }
+  }
+
+  double_buffer_size_bytes_ = double_buffer_size_bytes;
+  fill_buffer_offset_ = 0;
+  full_buffer_bytes_ = 0;
+  return OkStatus();
+}
+
+Status BlobStore::OpenWrite(bool double_buffered) {
+  PW_TRY(PrepareWriter(double_buffered));
+
   PW_LOG_DEBUG("Blob writer open");
 
   writer_open_ = true;
@@ -100,6 +124,124 @@ Status BlobStore::OpenWrite() {
   return OkStatus();
 }
 
+Status BlobStore::ResumeWrite(bool double_buffered) {
+  PW_TRY(PrepareWriter(double_buffered));
+
+  writer_open_ = true;
+
+  if (!LoadWriteProgress().ok()) {
+    PW_LOG_DEBUG("Blob writer open, no write progress to resume");
+    Invalidate();
+    return OkStatus();
+  }
+
+  PW_LOG_DEBUG("Blob writer open, resuming write at %u bytes",
+               static_cast<unsigned>(write_address_));
+  return OkStatus();
+}
+
+Status BlobStore::LoadWriteProgress() {
+  WriteProgress progress;
+  if (!kvs_.Get(MetadataKey(), &progress).ok()) {
+    return Status::NotFound();
+  }
+
+  // Only whole flash_write_size_bytes_ chunks are written before the close, so
+  // any other size was not saved by this configuration of the blob.
+  if (progress.max_data_size_bytes != MaxDataSizeBytes() ||
+      progress.data_size_bytes > MaxDataSizeBytes() ||
+      progress.data_size_bytes % flash_write_size_bytes_ != 0) {
+    PW_LOG_ERROR("BlobStore resume - Saved write progress is invalid");
+    return Status::DataLoss();
+  }
+
+  // Data may have been written after the progress was saved. Flash can't be
+  // rewritten without an erase, so in that case the write resumes at the start
+  // of the sector holding the end of the saved data and later sectors are
+  // erased.
+  const size_t saved_bytes = progress.data_size_bytes;
+  bool erased = true;
+  if (saved_bytes < MaxDataSizeBytes()) {
+    PW_TRY(partition_.IsRegionErased(
+        saved_bytes, MaxDataSizeBytes() - saved_bytes, &erased));
+  }
+  const size_t resume_bytes =
+      erased ? saved_bytes
+             : saved_bytes - saved_bytes % partition_.sector_size_bytes();
+  if (resume_bytes == 0) {
+    return Status::NotFound();
+  }
+
+  // Check all of the saved data against the CRC32, while calculating the blob
+  // checksum and CRC32 for the data the write resumes after.
+  ResetChecksum();
+  checksum::Crc32 crc32;
+  checksum::Crc32 resume_crc32;
+
+  kvs::FlashPartition::Address address = 0;
+  constexpr size_t kReadBufferSizeBytes = 32;
+  std::array<std::byte, kReadBufferSizeBytes> buffer;
+  while (address < saved_bytes) {
+    const size_t end = address < resume_bytes ? resume_bytes : saved_bytes;
+    const size_t read_size = std::min(end - address, buffer.size());
+    const ConstByteSpan data = std::span(buffer).first(read_size);
+    PW_TRY(partition_.Read(address, std::span(buffer).first(read_size)));
+
+    crc32.Update(data);
+    if (address < resume_bytes && checksum_algo_ != nullptr) {
+      checksum_algo_->Update(data);
+    }
+    address += read_size;
+    if (address == resume_bytes) {
+      resume_crc32 = crc32;
+    }
+  }
+
+  if (crc32.value() != progress.crc32) {
+    PW_LOG_ERROR("BlobStore resume - Data in flash does not match progress");
+    return Status::DataLoss();
+  }
+
+  if (!erased) {
+    const size_t first_sector = resume_bytes / partition_.sector_size_bytes();
+    if (!partition_
+             .Erase(resume_bytes, partition_.sector_count() - first_sector)
+             .ok()) {
+      return Status::DataLoss();
+    }
+  }
+
+  metadata_.reset();
+  valid_data_ = true;
+  flash_erased_ = false;
+  write_address_ = resume_bytes;
+  flash_address_ = resume_bytes;
+  erased_end_ = MaxDataSizeBytes();
+  flash_crc32_ = resume_crc32;
+  return OkStatus();
+}
+
+Status BlobStore::SaveWriteProgress() {
+  PW_TRY(FlushAll());
+
+  if (flash_address_ == 0) {
+    return OkStatus();
+  }
+
+  const WriteProgress progress = {
+      .crc32 = flash_crc32_.value(),
+      .data_size_bytes = flash_address_,
+      .max_data_size_bytes = MaxDataSizeBytes(),
+  };
+  if (!kvs_.Put(MetadataKey(), progress).ok()) {
+    return Status::DataLoss();
+  }
+
+  PW_LOG_DEBUG("Blob write progress saved at %u bytes",
+               static_cast<unsigned>(flash_address_));
+  return OkStatus();
+}
+
 Status BlobStore::OpenRead() {
   if (!initialized_) {
     return Status::FailedPrecondition();
@@ -141,7 +283,7 @@ Status BlobStore::CloseWrite() {
 
     // Do a Flush of any flash_write_size_bytes_ sized chunks so any remaining
     // bytes in the write buffer are less than flash_write_size_bytes_.
-    PW_TRY(Flush());
+    PW_TRY(FlushAll());
 
     // If any bytes remain in buffer it is because it is a chunk less than
     // flash_write_size_bytes_. Pad the chunk to flash_write_size_bytes_ and
@@ -160,7 +302,9 @@ Status BlobStore::CloseWrite() {
                   std::min(checksum.size(), sizeof(metadata_.checksum)));
     }
 
-    if (!ValidateChecksum().ok()) {
+    // The data was already checked as it was written in the other modes.
+    if (write_verification_ == WriteVerification::kReadBackOnClose &&
+        !ValidateChecksum().ok()) {
       Invalidate();
       return Status::DataLoss();
     }
@@ -289,11 +433,21 @@ Status BlobStore::AddToWriteBuffer(ConstByteSpan data) {
     return Status::ResourceExhausted();
   }
 
-  size_t bytes_in_buffer = WriteBufferBytesUsed();
+  // When double buffered, data that does not fit in the fill buffer continues
+  // in the other buffer once the fill buffer becomes the full buffer.
+  while (data.size_bytes() > 0) {
+    const ByteSpan fill_buffer = FillBuffer();
+    const size_t bytes_in_buffer = WriteBufferBytesUsed() - full_buffer_bytes_;
+    const size_t add_bytes =
+        std::min(fill_buffer.size_bytes() - bytes_in_buffer, data.size_bytes());
+    PW_DCHECK_UINT_GT(add_bytes, 0);
+
+    std::memcpy(fill_buffer.data() + bytes_in_buffer, data.data(), add_bytes);
+    write_address_ += add_bytes;
+    data = data.subspan(add_bytes);
 
-  std::memcpy(
-      write_buffer_.data() + bytes_in_buffer, data.data(), data.size_bytes());
-  write_address_ += data.size_bytes();
+    SwapFullWriteBuffer();
+  }
 
   return OkStatus();
 }
@@ -312,7 +466,41 @@ Status BlobStore::Flush() {
     return Status::DataLoss();
   }
 
-  ByteSpan data = std::span(write_buffer_.data(), WriteBufferBytesUsed());
+  if (full_buffer_bytes_ == 0) {
+    return FlushFillBuffer();
+  }
+
+  // Write only the full buffer, so data can continue to be added to the fill
+  // buffer without waiting for it to be written as well.
+  const size_t full_buffer_offset =
+      double_buffer_size_bytes_ - fill_buffer_offset_;
+  ConstByteSpan data =
+      write_buffer_.subspan(full_buffer_offset, full_buffer_bytes_);
+  while (data.size_bytes() > 0) {
+    if (!CommitToFlash(data.first(flash_write_size_bytes_)).ok()) {
+      return Status::DataLoss();
+    }
+    data = data.subspan(flash_write_size_bytes_);
+  }
+  full_buffer_bytes_ = 0;
+
+  SwapFullWriteBuffer();
+  return OkStatus();
+}
+
+Status BlobStore::FlushAll() {
+  // Each Flush writes at most one buffer when double buffered.
+  while (full_buffer_bytes_ != 0) {
+    PW_TRY(Flush());
+  }
+  return Flush();
+}
+
+Status BlobStore::FlushFillBuffer() {
+  PW_DCHECK_UINT_EQ(full_buffer_bytes_, 0);
+  const ByteSpan fill_buffer = FillBuffer();
+
+  ByteSpan data = fill_buffer.first(WriteBufferBytesUsed());
   while (data.size_bytes() >= flash_write_size_bytes_) {
     if (!CommitToFlash(data.first(flash_write_size_bytes_)).ok()) {
       return Status::DataLoss();
@@ -328,7 +516,7 @@ Status BlobStore::Flush() {
     PW_DCHECK_UINT_EQ(data.size_bytes(), WriteBufferBytesUsed());
     // For any leftover bytes less than the flash write size, move them to the
     // start of the bufer.
-    std::memmove(write_buffer_.data(), data.data(), data.size_bytes());
+    std::memmove(fill_buffer.data(), data.data(), data.size_bytes());
   } else {
     PW_DCHECK_UINT_EQ(data.size_bytes(), 0);
   }
@@ -336,6 +524,15 @@ Status BlobStore::Flush() {
   return OkStatus();
 }
 
+void BlobStore::SwapFullWriteBuffer() {
+  if (double_buffer_size_bytes_ == 0 || full_buffer_bytes_ != 0 ||
+      WriteBufferBytesUsed() < double_buffer_size_bytes_) {
+    return;
+  }
+  full_buffer_bytes_ = double_buffer_size_bytes_;
+  fill_buffer_offset_ = double_buffer_size_bytes_ - fill_buffer_offset_;
+}
+
 Status BlobStore::FlushFinalPartialChunk() {
   size_t bytes_in_buffer = WriteBufferBytesUsed();
 
@@ -349,12 +546,13 @@ Status BlobStore::FlushFinalPartialChunk() {
       static_cast<unsigned>(bytes_in_buffer));
 
   // Zero out the remainder of the buffer.
-  auto zero_span = write_buffer_.subspan(bytes_in_buffer);
+  const ByteSpan fill_buffer = FillBuffer();
+  auto zero_span = fill_buffer.subspan(bytes_in_buffer);
   std::memset(zero_span.data(),
               static_cast<int>(partition_.erased_memory_content()),
               zero_span.size_bytes());
 
-  ConstByteSpan remaining_bytes = write_buffer_.first(flash_write_size_bytes_);
+  ConstByteSpan remaining_bytes = fill_buffer.first(flash_write_size_bytes_);
   return CommitToFlash(remaining_bytes, bytes_in_buffer);
 }
 
@@ -362,18 +560,50 @@ Status BlobStore::CommitToFlash(ConstByteSpan source, size_t data_bytes) {
   if (data_bytes == 0) {
     data_bytes = source.size_bytes();
   }
+  // Sectors are erased as the write reaches them, if they were not erased
+  // ahead of time.
+  Status status = EraseUpTo(flash_address_ + source.size_bytes());
+  if (!status.ok()) {
+    valid_data_ = false;
+    return status;
+  }
+
   flash_erased_ = false;
-  StatusWithSize result = partition_.Write(flash_address_, source);
+  status = partition_.Write(flash_address_, source).status();
+  if (status.ok() &&
+      write_verification_ == WriteVerification::kReadBackOnWrite) {
+    status = VerifyFlashWrite(flash_address_, source);
+  }
   flash_address_ += data_bytes;
+  flash_crc32_.Update(source.first(data_bytes));
   if (checksum_algo_ != nullptr) {
     checksum_algo_->Update(source.first(data_bytes));
   }
 
-  if (!result.status().ok()) {
+  if (!status.ok()) {
     valid_data_ = false;
   }
 
-  return result.status();
+  return status;
+}
+
+Status BlobStore::VerifyFlashWrite(kvs::FlashPartition::Address address,
+                                   ConstByteSpan data) {
+  constexpr size_t kReadBufferSizeBytes = 32;
+  std::array<std::byte, kReadBufferSizeBytes> buffer;
+  while (!data.empty()) {
+    const size_t read_size = std::min(data.size_bytes(), buffer.size());
+    PW_TRY(partition_.Read(address, std::span(buffer).first(read_size)));
+
+    if (std::memcmp(buffer.data(), data.data(), read_size) != 0) {
+      PW_LOG_ERROR("Blob data read back from flash at %u does not match",
+                   static_cast<unsigned>(address));
+      return Status::DataLoss();
+    }
+    address += read_size;
+    data = data.subspan(read_size);
+  }
+  return OkStatus();
 }
 
 // Needs to be in .cc file since PW_CHECK doesn't like being in .h files.
@@ -384,19 +614,63 @@ size_t BlobStore::WriteBufferBytesUsed() const {
 
 // Needs to be in .cc file since PW_DCHECK doesn't like being in .h files.
 size_t BlobStore::WriteBufferBytesFree() const {
-  PW_DCHECK_UINT_GE(write_buffer_.size_bytes(), WriteBufferBytesUsed());
-  size_t buffer_remaining = write_buffer_.size_bytes() - WriteBufferBytesUsed();
+  const size_t buffer_size = double_buffer_size_bytes_ == 0
+                                 ? write_buffer_.size_bytes()
+                                 : 2 * double_buffer_size_bytes_;
+  PW_DCHECK_UINT_GE(buffer_size, WriteBufferBytesUsed());
+  size_t buffer_remaining = buffer_size - WriteBufferBytesUsed();
   return std::min(buffer_remaining, WriteBytesRemaining());
 }
 
 Status BlobStore::EraseIfNeeded() {
   if (flash_address_ == 0) {
-    // Always just erase. Erase is smart enough to only erase if needed.
-    return Erase();
+    // Only erase the start of the partition before the first write. Later
+    // sectors are erased as the write reaches them, so the write does not wait
+    // for the whole partition to be erased.
+    PW_TRY(EraseUpTo(flash_write_size_bytes_));
+
+    // Blob data is considered valid as soon as the flash is erased. Even though
+    // there are 0 bytes written, they are valid.
+    valid_data_ = true;
   }
   return OkStatus();
 }
 
+Status BlobStore::PreErase(size_t max_sectors) {
+  if (erased_end_ >= MaxDataSizeBytes()) {
+    return Status::NotFound();
+  }
+  PW_DCHECK_UINT_GE(erased_end_, flash_address_);
+  return EraseSectorsAhead(max_sectors);
+}
+
+Status BlobStore::EraseUpTo(kvs::FlashPartition::Address end_address) {
+  if (end_address <= erased_end_) {
+    return OkStatus();
+  }
+  PW_DCHECK_UINT_GE(erased_end_, flash_address_);
+
+  const size_t sector_size = partition_.sector_size_bytes();
+  return EraseSectorsAhead((end_address - erased_end_ + sector_size - 1) /
+                           sector_size);
+}
+
+Status BlobStore::EraseSectorsAhead(size_t max_sectors) {
+  const size_t sector_size = partition_.sector_size_bytes();
+  const size_t num_sectors =
+      std::min(max_sectors, (MaxDataSizeBytes() - erased_end_) / sector_size);
+  if (num_sectors == 0) {
+    return OkStatus();
+  }
+
+  PW_LOG_DEBUG("Blob erase %u sectors at %u",
+               static_cast<unsigned>(num_sectors),
+               static_cast<unsigned>(erased_end_));
+  PW_TRY(partition_.Erase(erased_end_, num_sectors));
+  erased_end_ += num_sectors * sector_size;
+  return OkStatus();
+}
+
 StatusWithSize BlobStore::Read(size_t offset, ByteSpan dest) const {
   if (!ValidToRead()) {
     return StatusWithSize::FailedPrecondition();
@@ -444,7 +718,8 @@ Status BlobStore::Erase() {
 
   Invalidate();
 
-  Status status = partition_.Erase();
+  // Sectors already erased ahead of time do not need to be erased again.
+  Status status = EraseUpTo(MaxDataSizeBytes());
 
   if (status.ok()) {
     flash_erased_ = true;
@@ -463,8 +738,17 @@ Status BlobStore::Invalidate() {
   // there are 0 bytes written, they are valid.
   valid_data_ = flash_erased_;
   ResetChecksum();
+  flash_crc32_.clear();
+
+  // Sectors erased ahead of the written data remain erased, but any sectors
+  // with data must be erased again before the next blob is written.
+  if (flash_address_ != 0) {
+    erased_end_ = 0;
+  }
   write_address_ = 0;
   flash_address_ = 0;
+  fill_buffer_offset_ = 0;
+  full_buffer_bytes_ = 0;
 
   Status status = kvs_.Delete(MetadataKey());
 
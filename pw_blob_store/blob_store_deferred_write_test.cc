@@ -51,20 +51,29 @@ class DeferredWriteTest : public ::testing::Test {
 
   // Fill the source buffer with random pattern based on given seed, written to
   // BlobStore in specified chunk size.
-  void ChunkWriteTest(size_t chunk_size, size_t flush_interval) {
+  void ChunkWriteTest(size_t chunk_size,
+                      size_t flush_interval,
+                      BlobStore::DeferredWriter::Buffering buffering =
+                          BlobStore::DeferredWriter::Buffering::kSingle) {
     constexpr size_t kWriteSize = 64;
     kvs::ChecksumCrc16 checksum;
 
     size_t bytes_since_flush = 0;
 
     char name[16] = {};
-    snprintf(name, sizeof(name), "Blob%u", static_cast<unsigned>(chunk_size));
+    snprintf(name,
+             sizeof(name),
+             "Blob%u%s",
+             static_cast<unsigned>(chunk_size),
+             buffering == BlobStore::DeferredWriter::Buffering::kDouble
+                 ? "_double"
+                 : "");
 
     BlobStoreBuffer<kBufferSize> blob(
         name, partition_, &checksum, kvs::TestKvs(), kWriteSize);
     EXPECT_EQ(OkStatus(), blob.Init());
 
-    BlobStore::DeferredWriter writer(blob);
+    BlobStore::DeferredWriter writer(blob, buffering);
     EXPECT_EQ(OkStatus(), writer.Open());
 
     ByteSpan source = buffer_;
@@ -165,6 +174,78 @@ TEST_F(DeferredWriteTest, ChunkWrite256) {
   ChunkWriteTest(256, 256);
 }
 
+TEST_F(DeferredWriteTest, DoubleBuffered_ChunkWrite5) {
+  InitBufferToRandom(0x5);
+  ChunkWriteTest(5, 64, BlobStore::DeferredWriter::Buffering::kDouble);
+}
+
+TEST_F(DeferredWriteTest, DoubleBuffered_ChunkWrite64FullBufferFill) {
+  // Flush each time one of the two buffers is full.
+  InitBufferToRandom(0x64);
+  ChunkWriteTest(
+      64, kBufferSize / 2, BlobStore::DeferredWriter::Buffering::kDouble);
+}
+
+TEST_F(DeferredWriteTest, DoubleBuffered_FlushWritesFullBuffer) {
+  InitBufferToRandom(0xd0b1e);
+  constexpr size_t kWriteSize = 64;
+  constexpr size_t kHalfBuffer = kBufferSize / 2;
+  kvs::ChecksumCrc16 checksum;
+
+  BlobStoreBuffer<kBufferSize> blob(
+      "Blob_double", partition_, &checksum, kvs::TestKvs(), kWriteSize);
+  ASSERT_EQ(OkStatus(), blob.Init());
+
+  BlobStore::DeferredWriter writer(
+      blob, BlobStore::DeferredWriter::Buffering::kDouble);
+  ASSERT_EQ(OkStatus(), writer.Open());
+
+  // Fill one buffer and part of the other.
+  const ConstByteSpan source = buffer_;
+  ASSERT_EQ(OkStatus(), writer.Write(source.first(kHalfBuffer + 100)));
+  EXPECT_EQ(kBufferSize - kHalfBuffer - 100, writer.ConservativeWriteLimit());
+
+  // Only the full buffer is written.
+  const size_t bytes_written = partition_.bytes_written();
+  ASSERT_EQ(OkStatus(), writer.Flush());
+  EXPECT_EQ(kHalfBuffer, partition_.bytes_written() - bytes_written);
+  EXPECT_EQ(kBufferSize - 100, writer.ConservativeWriteLimit());
+
+  // Data continues to be added while the other buffer is partly filled.
+  ASSERT_EQ(OkStatus(),
+            writer.Write(source.subspan(kHalfBuffer + 100, kHalfBuffer)));
+
+  // With no full buffer, whole chunks of the fill buffer are written.
+  ASSERT_EQ(OkStatus(), writer.Flush());
+  ASSERT_EQ(OkStatus(), writer.Flush());
+  ASSERT_EQ(OkStatus(), writer.Write(source.subspan(kBufferSize + 100)));
+  EXPECT_EQ(OkStatus(), writer.Close());
+
+  BlobStore::BlobReader reader(blob);
+  ASSERT_EQ(OkStatus(), reader.Open());
+  Result<ConstByteSpan> result = reader.GetMemoryMappedBlob();
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ(buffer_.size(), result.value().size_bytes());
+  VerifyFlash(result.value());
+  EXPECT_EQ(OkStatus(), reader.Close());
+}
+
+TEST_F(DeferredWriteTest, DoubleBuffered_BufferTooSmall) {
+  constexpr size_t kWriteSize = 64;
+  BlobStoreBuffer<kWriteSize> blob(
+      "Blob_small", partition_, nullptr, kvs::TestKvs(), kWriteSize);
+  ASSERT_EQ(OkStatus(), blob.Init());
+
+  BlobStore::DeferredWriter writer(
+      blob, BlobStore::DeferredWriter::Buffering::kDouble);
+  EXPECT_EQ(Status::InvalidArgument(), writer.Open());
+  EXPECT_FALSE(writer.IsOpen());
+
+  BlobStore::DeferredWriter single_writer(blob);
+  EXPECT_EQ(OkStatus(), single_writer.Open());
+  EXPECT_EQ(OkStatus(), single_writer.Close());
+}
+
 // TODO: test that has dirty flash, invalidated blob, open writer, invalidate
 // (not erase) and start writing (does the auto/implicit erase).
 
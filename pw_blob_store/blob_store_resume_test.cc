@@ -0,0 +1,212 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <span>
+
+#include "gtest/gtest.h"
+#include "pw_blob_store/blob_store.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/test_key_value_store.h"
+#include "pw_random/xor_shift.h"
+
+namespace pw::blob_store {
+namespace {
+
+class BlobStoreResumeTest : public ::testing::Test {
+ protected:
+  BlobStoreResumeTest() : flash_(kFlashAlignment), partition_(&flash_) {}
+
+  void SetUp() override {
+    ASSERT_EQ(OkStatus(), partition_.Erase());
+
+    random::XorShiftStarRng64 rng(0x5eed);
+    rng.Get(source_buffer_);
+  }
+
+  // Creates a writer that is never closed or destroyed, as if the device
+  // rebooted while the writer was open.
+  BlobStore::BlobWriter& InterruptedWriter(BlobStore& blob) {
+    return *new (&interrupted_writer_) BlobStore::BlobWriter(blob);
+  }
+
+  ConstByteSpan Source(size_t offset, size_t end = kBlobDataSize) {
+    return std::span(source_buffer_).subspan(offset, end - offset);
+  }
+
+  // Verifies the complete blob is readable and matches the source data.
+  void VerifyBlob(BlobStore& blob) {
+    BlobStore::BlobReader reader(blob);
+    ASSERT_EQ(OkStatus(), reader.Open());
+    Result<ConstByteSpan> result = reader.GetMemoryMappedBlob();
+    ASSERT_TRUE(result.ok());
+    ASSERT_EQ(kBlobDataSize, result.value().size_bytes());
+    EXPECT_EQ(0,
+              std::memcmp(source_buffer_.data(),
+                          result.value().data(),
+                          source_buffer_.size()));
+    EXPECT_EQ(OkStatus(), reader.Close());
+  }
+
+  static constexpr size_t kFlashAlignment = 16;
+  static constexpr size_t kSectorSize = 2048;
+  static constexpr size_t kSectorCount = 2;
+  static constexpr size_t kBlobDataSize = (kSectorCount * kSectorSize);
+  static constexpr size_t kBufferSize = 256;
+
+  kvs::FakeFlashMemoryBuffer<kSectorSize, kSectorCount> flash_;
+  kvs::FlashPartition partition_;
+  kvs::ChecksumCrc16 checksum_;
+  std::array<std::byte, kBlobDataSize> source_buffer_;
+
+  alignas(BlobStore::BlobWriter) std::byte
+      interrupted_writer_[sizeof(BlobStore::BlobWriter)];
+};
+
+TEST_F(BlobStoreResumeTest, Resume_NoSavedProgress_StartsNewBlob) {
+  BlobStoreBuffer<kBufferSize> blob(
+      "Resume_new", partition_, &checksum_, kvs::TestKvs(), kBufferSize);
+  ASSERT_EQ(OkStatus(), blob.Init());
+
+  BlobStore::BlobWriter writer(blob);
+  ASSERT_EQ(OkStatus(), writer.Resume());
+  EXPECT_EQ(0u, writer.CurrentSizeBytes());
+  ASSERT_EQ(OkStatus(), writer.Write(Source(0)));
+  ASSERT_EQ(OkStatus(), writer.Close());
+
+  VerifyBlob(blob);
+}
+
+TEST_F(BlobStoreResumeTest, Resume_CompleteBlob_StartsNewBlob) {
+  BlobStoreBuffer<kBufferSize> blob(
+      "Resume_done", partition_, &checksum_, kvs::TestKvs(), kBufferSize);
+  ASSERT_EQ(OkStatus(), blob.Init());
+
+  BlobStore::BlobWriter writer(blob);
+  ASSERT_EQ(OkStatus(), writer.Open());
+  ASSERT_EQ(OkStatus(), writer.Write(Source(0)));
+  ASSERT_EQ(OkStatus(), writer.SaveProgress());
+  ASSERT_EQ(OkStatus(), writer.Close());
+
+  // A closed blob replaces the saved progress, so there is nothing to resume.
+  ASSERT_EQ(OkStatus(), writer.Resume());
+  EXPECT_EQ(0u, writer.CurrentSizeBytes());
+  ASSERT_EQ(OkStatus(), writer.Discard());
+  ASSERT_EQ(OkStatus(), writer.Close());
+}
+
+TEST_F(BlobStoreResumeTest, Resume_ContinuesFromSavedProgress) {
+  constexpr size_t kSavedBytes = 4 * kBufferSize;
+  {
+    BlobStoreBuffer<kBufferSize> blob(
+        "Resume_saved", partition_, &checksum_, kvs::TestKvs(), kBufferSize);
+    ASSERT_EQ(OkStatus(), blob.Init());
+
+    BlobStore::BlobWriter& writer = InterruptedWriter(blob);
+    ASSERT_EQ(OkStatus(), writer.Open());
+    ASSERT_EQ(OkStatus(), writer.Write(Source(0, kSavedBytes)));
+    ASSERT_EQ(OkStatus(), writer.SaveProgress());
+
+    // Bytes still in the write buffer are lost at the reboot.
+    ASSERT_EQ(OkStatus(), writer.Write(Source(kSavedBytes, kSavedBytes + 20)));
+  }
+
+  BlobStoreBuffer<kBufferSize> blob(
+      "Resume_saved", partition_, &checksum_, kvs::TestKvs(), kBufferSize);
+  ASSERT_EQ(OkStatus(), blob.Init());
+
+  // The partially written blob is not readable.
+  BlobStore::BlobReader reader(blob);
+  EXPECT_EQ(Status::FailedPrecondition(), reader.Open());
+
+  BlobStore::BlobWriter writer(blob);
+  ASSERT_EQ(OkStatus(), writer.Resume());
+  ASSERT_EQ(kSavedBytes, writer.CurrentSizeBytes());
+  ASSERT_EQ(OkStatus(), writer.Write(Source(kSavedBytes)));
+  ASSERT_EQ(OkStatus(), writer.Close());
+
+  VerifyBlob(blob);
+
+  // The blob checksum covers the data from both sessions.
+  BlobStoreBuffer<kBufferSize> reloaded_blob(
+      "Resume_saved", partition_, &checksum_, kvs::TestKvs(), kBufferSize);
+  ASSERT_EQ(OkStatus(), reloaded_blob.Init());
+  VerifyBlob(reloaded_blob);
+}
+
+TEST_F(BlobStoreResumeTest, Resume_DataWrittenAfterSave_ResumesAtSector) {
+  constexpr size_t kSavedBytes = kSectorSize + 2 * kBufferSize;
+  {
+    BlobStoreBuffer<kBufferSize> blob(
+        "Resume_sector", partition_, &checksum_, kvs::TestKvs(), kBufferSize);
+    ASSERT_EQ(OkStatus(), blob.Init());
+
+    BlobStore::BlobWriter& writer = InterruptedWriter(blob);
+    ASSERT_EQ(OkStatus(), writer.Open());
+    ASSERT_EQ(OkStatus(), writer.Write(Source(0, kSavedBytes)));
+    ASSERT_EQ(OkStatus(), writer.SaveProgress());
+
+    // This data reaches flash, but the progress does not include it.
+    ASSERT_EQ(OkStatus(),
+              writer.Write(Source(kSavedBytes, kSavedBytes + kBufferSize)));
+  }
+
+  BlobStoreBuffer<kBufferSize> blob(
+      "Resume_sector", partition_, &checksum_, kvs::TestKvs(), kBufferSize);
+  ASSERT_EQ(OkStatus(), blob.Init());
+
+  BlobStore::BlobWriter writer(blob);
+  ASSERT_EQ(OkStatus(), writer.Resume());
+  ASSERT_EQ(kSectorSize, writer.CurrentSizeBytes());
+  ASSERT_EQ(OkStatus(), writer.Write(Source(kSectorSize)));
+  ASSERT_EQ(OkStatus(), writer.Close());
+
+  VerifyBlob(blob);
+}
+
+TEST_F(BlobStoreResumeTest, Resume_CorruptData_StartsNewBlob) {
+  constexpr size_t kSavedBytes = 4 * kBufferSize;
+  {
+    BlobStoreBuffer<kBufferSize> blob(
+        "Resume_corrupt", partition_, &checksum_, kvs::TestKvs(), kBufferSize);
+    ASSERT_EQ(OkStatus(), blob.Init());
+
+    BlobStore::BlobWriter& writer = InterruptedWriter(blob);
+    ASSERT_EQ(OkStatus(), writer.Open());
+    ASSERT_EQ(OkStatus(), writer.Write(Source(0, kSavedBytes)));
+    ASSERT_EQ(OkStatus(), writer.SaveProgress());
+  }
+
+  flash_.buffer()[kBufferSize] ^= std::byte{0x01};
+
+  BlobStoreBuffer<kBufferSize> blob(
+      "Resume_corrupt", partition_, &checksum_, kvs::TestKvs(), kBufferSize);
+  ASSERT_EQ(OkStatus(), blob.Init());
+
+  BlobStore::BlobWriter writer(blob);
+  ASSERT_EQ(OkStatus(), writer.Resume());
+  ASSERT_EQ(0u, writer.CurrentSizeBytes());
+  ASSERT_EQ(OkStatus(), writer.Write(Source(0)));
+  ASSERT_EQ(OkStatus(), writer.Close());
+
+  VerifyBlob(blob);
+}
+
+}  // namespace
+}  // namespace pw::blob_store
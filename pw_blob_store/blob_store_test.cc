@@ -21,6 +21,7 @@
 
 #include "gtest/gtest.h"
 #include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/crc32_checksum.h"
 #include "pw_kvs/fake_flash_memory.h"
 #include "pw_kvs/flash_memory.h"
 #include "pw_kvs/test_key_value_store.h"
@@ -135,6 +136,43 @@ class BlobStoreTest : public ::testing::Test {
     VerifyFlash(read_buffer);
   }
 
+  // Writes the source buffer as a blob with the given write verification.
+  // Returns the bytes read from flash by the writes and the close. The blob is
+  // then loaded by a new BlobStore to check that it is valid.
+  void WriteWithVerification(BlobStore::WriteVerification write_verification,
+                             size_t* write_bytes_read,
+                             size_t* close_bytes_read) {
+    constexpr size_t kBufferSize = 256;
+    kvs::ChecksumCrc32 checksum;
+    BlobStoreBuffer<kBufferSize> blob("Blob_verify",
+                                      partition_,
+                                      &checksum,
+                                      kvs::TestKvs(),
+                                      kBufferSize,
+                                      write_verification);
+    ASSERT_EQ(OkStatus(), blob.Init());
+
+    BlobStore::BlobWriter writer(blob);
+    ASSERT_EQ(OkStatus(), writer.Open());
+    size_t bytes_read = partition_.bytes_read();
+    ASSERT_EQ(OkStatus(), writer.Write(source_buffer_));
+    *write_bytes_read = partition_.bytes_read() - bytes_read;
+
+    bytes_read = partition_.bytes_read();
+    ASSERT_EQ(OkStatus(), writer.Close());
+    *close_bytes_read = partition_.bytes_read() - bytes_read;
+
+    BlobStoreBuffer<kBufferSize> reloaded_blob(
+        "Blob_verify", partition_, &checksum, kvs::TestKvs(), kBufferSize);
+    ASSERT_EQ(OkStatus(), reloaded_blob.Init());
+    BlobStore::BlobReader reader(reloaded_blob);
+    ASSERT_EQ(OkStatus(), reader.Open());
+    Result<ConstByteSpan> result = reader.GetMemoryMappedBlob();
+    ASSERT_TRUE(result.ok());
+    VerifyFlash(result.value());
+    EXPECT_EQ(OkStatus(), reader.Close());
+  }
+
   void VerifyFlash(ConstByteSpan verify_bytes, size_t offset = 0) {
     // Should be defined as same size.
     EXPECT_EQ(source_buffer_.size(), flash_.buffer().size_bytes());
@@ -248,6 +286,122 @@ TEST_F(BlobStoreTest, MultipleErase) {
   EXPECT_EQ(OkStatus(), writer.Erase());
 }
 
+TEST_F(BlobStoreTest, Write_ErasesSectorsAsWriteReachesThem) {
+  std::array<std::byte, kBlobDataSize> flash_contents;
+  std::memset(flash_contents.data(), 0x5a, flash_contents.size());
+  InitFlashTo(flash_contents);
+  InitSourceBufferToRandom(0x2020);
+
+  constexpr size_t kBufferSize = 256;
+  kvs::ChecksumCrc16 checksum;
+  BlobStoreBuffer<kBufferSize> blob(
+      "Blob_lazy", partition_, &checksum, kvs::TestKvs(), kBufferSize);
+  EXPECT_EQ(OkStatus(), blob.Init());
+
+  BlobStore::BlobWriter writer(blob);
+  EXPECT_EQ(OkStatus(), writer.Open());
+  ASSERT_EQ(OkStatus(),
+            writer.Write(std::span(source_buffer_).first(kBufferSize)));
+
+  // Only the first sector is erased so far.
+  EXPECT_EQ(std::byte{0x5a}, flash_.buffer()[kSectorSize]);
+
+  ASSERT_EQ(OkStatus(),
+            writer.Write(std::span(source_buffer_).subspan(kBufferSize)));
+  EXPECT_EQ(OkStatus(), writer.Close());
+  VerifyFlash(flash_.buffer());
+}
+
+TEST_F(BlobStoreTest, PreErase_ErasesAheadOfWrite) {
+  std::array<std::byte, kBlobDataSize> flash_contents;
+  std::memset(flash_contents.data(), 0x5a, flash_contents.size());
+  InitFlashTo(flash_contents);
+  InitSourceBufferToRandom(0x1234);
+
+  constexpr size_t kBufferSize = 256;
+  kvs::ChecksumCrc16 checksum;
+  BlobStoreBuffer<kBufferSize> blob(
+      "Blob_pre_erase", partition_, &checksum, kvs::TestKvs(), kBufferSize);
+  EXPECT_EQ(OkStatus(), blob.Init());
+
+  BlobStore::BlobWriter writer(blob);
+  EXPECT_EQ(OkStatus(), writer.Open());
+
+  EXPECT_EQ(OkStatus(), writer.PreErase());
+  EXPECT_EQ(flash_.erased_memory_content(), flash_.buffer()[0]);
+  EXPECT_EQ(std::byte{0x5a}, flash_.buffer()[kSectorSize]);
+
+  EXPECT_EQ(OkStatus(), writer.PreErase());
+  EXPECT_EQ(flash_.erased_memory_content(), flash_.buffer()[kSectorSize]);
+  EXPECT_EQ(Status::NotFound(), writer.PreErase());
+
+  ASSERT_EQ(OkStatus(), writer.Write(source_buffer_));
+  EXPECT_EQ(OkStatus(), writer.Close());
+  VerifyFlash(flash_.buffer());
+}
+
+TEST_F(BlobStoreTest, PreErase_AfterWrittenData) {
+  std::array<std::byte, kBlobDataSize> flash_contents;
+  std::memset(flash_contents.data(), 0x5a, flash_contents.size());
+  InitFlashTo(flash_contents);
+  InitSourceBufferToRandom(0x4242);
+
+  constexpr size_t kBufferSize = 256;
+  kvs::ChecksumCrc16 checksum;
+  BlobStoreBuffer<kBufferSize> blob(
+      "Blob_pre_erase2", partition_, &checksum, kvs::TestKvs(), kBufferSize);
+  EXPECT_EQ(OkStatus(), blob.Init());
+
+  BlobStore::BlobWriter writer(blob);
+  EXPECT_EQ(OkStatus(), writer.Open());
+  ASSERT_EQ(OkStatus(),
+            writer.Write(std::span(source_buffer_).first(kBufferSize)));
+
+  // The first sector was erased by the write, so only the rest is erased.
+  EXPECT_EQ(OkStatus(), writer.PreErase(kSectorCount));
+  EXPECT_EQ(flash_.erased_memory_content(), flash_.buffer()[kSectorSize]);
+  EXPECT_EQ(Status::NotFound(), writer.PreErase());
+  VerifyFlash(flash_.buffer().first(kBufferSize));
+
+  ASSERT_EQ(OkStatus(),
+            writer.Write(std::span(source_buffer_).subspan(kBufferSize)));
+  EXPECT_EQ(OkStatus(), writer.Close());
+  VerifyFlash(flash_.buffer());
+}
+
+TEST_F(BlobStoreTest, WriteVerification_ReadBackOnClose) {
+  InitSourceBufferToRandom(0x3232);
+  size_t write_bytes_read;
+  size_t close_bytes_read;
+  WriteWithVerification(BlobStore::WriteVerification::kReadBackOnClose,
+                        &write_bytes_read,
+                        &close_bytes_read);
+  EXPECT_EQ(0u, write_bytes_read);
+  EXPECT_EQ(kBlobDataSize, close_bytes_read);
+}
+
+TEST_F(BlobStoreTest, WriteVerification_ReadBackOnWrite) {
+  InitSourceBufferToRandom(0x3233);
+  size_t write_bytes_read;
+  size_t close_bytes_read;
+  WriteWithVerification(BlobStore::WriteVerification::kReadBackOnWrite,
+                        &write_bytes_read,
+                        &close_bytes_read);
+  EXPECT_EQ(kBlobDataSize, write_bytes_read);
+  EXPECT_EQ(0u, close_bytes_read);
+}
+
+TEST_F(BlobStoreTest, WriteVerification_None) {
+  InitSourceBufferToRandom(0x3234);
+  size_t write_bytes_read;
+  size_t close_bytes_read;
+  WriteWithVerification(BlobStore::WriteVerification::kNone,
+                        &write_bytes_read,
+                        &close_bytes_read);
+  EXPECT_EQ(0u, write_bytes_read);
+  EXPECT_EQ(0u, close_bytes_read);
+}
+
 TEST_F(BlobStoreTest, OffsetRead) {
   InitSourceBufferToRandom(0x11309);
   WriteTestBlock();
@@ -292,6 +446,54 @@ TEST_F(BlobStoreTest, InvalidReadOffset) {
   ASSERT_EQ(Status::InvalidArgument(), reader.Open(kOffset));
 }
 
+TEST_F(BlobStoreTest, SeekAndReadAt) {
+  InitSourceBufferToRandom(0x5eec);
+  WriteTestBlock();
+
+  kvs::ChecksumCrc16 checksum;
+
+  char name[16] = "TestBlobBlock";
+  constexpr size_t kBufferSize = 16;
+  BlobStoreBuffer<kBufferSize> blob(
+      name, partition_, &checksum, kvs::TestKvs(), kBufferSize);
+  EXPECT_EQ(OkStatus(), blob.Init());
+  BlobStore::BlobReader reader(blob);
+  ASSERT_EQ(OkStatus(), reader.Open());
+
+  // ReadAt reads any region without moving the read offset.
+  constexpr size_t kOffset = kBlobDataSize / 2 + 3;
+  std::array<std::byte, 32> read_buffer;
+  StatusWithSize result = reader.ReadAt(kOffset, read_buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(read_buffer.size(), result.size());
+  VerifyFlash(read_buffer, kOffset);
+  EXPECT_EQ(0u, reader.Tell());
+  EXPECT_EQ(kBlobDataSize, reader.ConservativeReadLimit());
+
+  // Reads are limited to the end of the blob.
+  result = reader.ReadAt(kBlobDataSize - 5, read_buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(5u, result.size());
+  VerifyFlash(std::span(read_buffer).first(5), kBlobDataSize - 5);
+  EXPECT_EQ(Status::OutOfRange(),
+            reader.ReadAt(kBlobDataSize, read_buffer).status());
+
+  // Seek moves the offset that Read continues from.
+  ASSERT_EQ(OkStatus(), reader.Seek(kOffset));
+  EXPECT_EQ(kBlobDataSize - kOffset, reader.ConservativeReadLimit());
+  auto read_result = reader.Read(read_buffer);
+  ASSERT_EQ(OkStatus(), read_result.status());
+  VerifyFlash(read_result.value(), kOffset);
+  EXPECT_EQ(kOffset + read_buffer.size(), reader.Tell());
+
+  // Seeking back is allowed, seeking past the data is not.
+  ASSERT_EQ(OkStatus(), reader.Seek(0));
+  EXPECT_EQ(kBlobDataSize, reader.ConservativeReadLimit());
+  EXPECT_EQ(Status::InvalidArgument(), reader.Seek(kBlobDataSize));
+  EXPECT_EQ(0u, reader.Tell());
+  EXPECT_EQ(OkStatus(), reader.Close());
+}
+
 // Test reading with a read buffer larger than the available data in the
 TEST_F(BlobStoreTest, ReadBufferIsLargerThanData) {
   InitSourceBufferToRandom(0x57326);
@@ -0,0 +1,358 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "pw_assert/light.h"
+#include "pw_kvs/checksum.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+
+namespace pw::blob_store {
+
+// BlobContainer stores several named blobs in a single FlashPartition. Blobs
+// are packed one after another, each starting at a multiple of
+// flash_write_size_bytes, so small blobs do not each use whole sectors. An
+// index of the blobs is stored in the KVS.
+//
+// Blobs are found by the hash of their name, so opening a blob takes constant
+// time. The names themselves are not stored, so the names used with a
+// container must have distinct hashes.
+//
+// The container only appends to the partition. Writing a blob with the name of
+// an existing blob replaces it, but the space of the replaced blob is only
+// reclaimed when the container is cleared. Sectors are erased as writes reach
+// them.
+//
+// Write blob:
+//  0) Create BlobWriter instance
+//  1) BlobWriter::Open(name).
+//  2) Add data using BlobWriter::Write().
+//  3) BlobWriter::Close().
+//
+// Read blob:
+//  0) Create BlobReader instance
+//  1) BlobReader::Open(name).
+//  2) Read data using BlobReader::Read() or
+//     BlobReader::GetMemoryMappedBlob().
+//  3) BlobReader::Close().
+class BlobContainer {
+ public:
+  // Implement stream::Writer for a blob in the container. Only one writer is
+  // allowed to be open at a time. Readers may be open while a blob is written;
+  // a reader of a blob that is replaced continues to read the previous data.
+  class BlobWriter final : public stream::Writer {
+   public:
+    constexpr BlobWriter(BlobContainer& container)
+        : container_(container), open_(false) {}
+    BlobWriter(const BlobWriter&) = delete;
+    BlobWriter& operator=(const BlobWriter&) = delete;
+    ~BlobWriter() {
+      if (open_) {
+        Close();
+      }
+    }
+
+    // Open a blob for writing. The blob is not visible to readers until the
+    // writer is closed. Returns:
+    //
+    // OK - success.
+    // FAILED_PRECONDITION - container not initialized.
+    // UNAVAILABLE - another writer is already open.
+    // RESOURCE_EXHAUSTED - the index has no room for another blob.
+    Status Open(std::string_view name) {
+      PW_DASSERT(!open_);
+      Status status = container_.OpenWrite(name);
+      if (status.ok()) {
+        open_ = true;
+      }
+      return status;
+    }
+
+    // Finalize the blob write. Flush all remaining buffered data to flash,
+    // verify it, and add the blob to the index. A blob with no data is not
+    // added. Close fails in the closed state, do NOT retry Close on error.
+    // Returns:
+    //
+    // OK - success.
+    // DATA_LOSS - Error writing data, verifying it or saving the index. The
+    //     blob is not added.
+    Status Close() {
+      PW_DASSERT(open_);
+      open_ = false;
+      return container_.CloseWrite();
+    }
+
+    bool IsOpen() { return open_; }
+
+    // Number of bytes that can still be written to this blob.
+    size_t ConservativeWriteLimit() const override {
+      PW_DASSERT(open_);
+      return container_.WriteBytesRemaining();
+    }
+
+    size_t CurrentSizeBytes() const {
+      PW_DASSERT(open_);
+      return container_.write_size_bytes_;
+    }
+
+   private:
+    Status DoWrite(ConstByteSpan data) override {
+      PW_DASSERT(open_);
+      return container_.Write(data);
+    }
+
+    BlobContainer& container_;
+    bool open_;
+  };
+
+  // Implement stream::Reader for a blob in the container. Multiple readers may
+  // be open at the same time.
+  class BlobReader final : public stream::Reader {
+   public:
+    constexpr BlobReader(BlobContainer& container)
+        : container_(container),
+          open_(false),
+          address_(0),
+          size_bytes_(0),
+          offset_(0) {}
+    BlobReader(const BlobReader&) = delete;
+    BlobReader& operator=(const BlobReader&) = delete;
+    ~BlobReader() {
+      if (open_) {
+        Close();
+      }
+    }
+
+    // Open to read the named blob at the given offset in to the blob. Returns:
+    //
+    // OK - success.
+    // FAILED_PRECONDITION - container not initialized.
+    // NOT_FOUND - there is no blob with the name.
+    // INVALID_ARGUMENT - Invalid offset.
+    Status Open(std::string_view name, size_t offset = 0);
+
+    // Finish reading a blob. Returns:
+    //
+    // OK - success.
+    Status Close() {
+      PW_DASSERT(open_);
+      open_ = false;
+      return container_.CloseRead();
+    }
+
+    bool IsOpen() { return open_; }
+
+    // Number of bytes remaining in the blob after the current offset.
+    size_t ConservativeReadLimit() const override {
+      PW_DASSERT(open_);
+      return size_bytes_ - offset_;
+    }
+
+    // Get a span with the MCU pointer and size of the data. Returns:
+    //
+    // OK with span - Valid span respresenting the blob data
+    // UNIMPLEMENTED - Memory mapped access not supported for this partition.
+    Result<ConstByteSpan> GetMemoryMappedBlob() const;
+
+   private:
+    StatusWithSize DoRead(ByteSpan dest) override;
+
+    BlobContainer& container_;
+    bool open_;
+    kvs::FlashPartition::Address address_;
+    size_t size_bytes_;
+    size_t offset_;
+  };
+
+  // Initialize the container. Loads the index of blobs and finds where the
+  // next blob can be written. Returns:
+  //
+  // OK - success.
+  Status Init();
+
+  // Remove all blobs. The flash is erased as new blobs are written. Returns:
+  //
+  // OK - success.
+  // FAILED_PRECONDITION - container not initialized.
+  // UNAVAILABLE - a writer or reader is open.
+  // [error status] - failed to remove the index from the KVS.
+  Status Clear();
+
+  // Number of blobs in the container.
+  size_t size() const;
+
+  // Maximum number of blobs in the container.
+  size_t max_size() const { return index_.size(); }
+
+  bool empty() const { return size() == 0u; }
+
+  // Size in bytes of the named blob, or 0 if there is no such blob.
+  size_t BlobSizeBytes(std::string_view name) const;
+
+  // Number of bytes of the partition that are not yet used by blobs.
+  size_t FreeBytes() const;
+
+ protected:
+  // One blob in the index. A slot with a size of 0 is empty.
+  struct IndexEntry {
+    uint32_t name_hash;
+    uint32_t address;
+    uint32_t size_bytes;
+    uint32_t checksum;
+  };
+
+  // name - Name of the container, used for the index KVS key.
+  // partition - Flash partition to use for the blobs.
+  // checksum_algo - Optional checksum for blob integrity checking. Use nullptr
+  //     for no check.
+  // kvs - KVS used for storing the index.
+  // index - Storage for the index, one entry per blob.
+  // write_buffer - Used for buffering writes. Needs to be at least
+  //     flash_write_size_bytes.
+  // flash_write_size_bytes - Size in bytes to use for flash write operations.
+  //     Must be a multiple of the flash write alignment that evenly divides the
+  //     flash sector size.
+  BlobContainer(std::string_view name,
+                kvs::FlashPartition& partition,
+                kvs::ChecksumAlgorithm* checksum_algo,
+                kvs::KeyValueStore& kvs,
+                std::span<IndexEntry> index,
+                ByteSpan write_buffer,
+                size_t flash_write_size_bytes)
+      : name_(name),
+        partition_(partition),
+        checksum_algo_(checksum_algo),
+        kvs_(kvs),
+        index_(index),
+        write_buffer_(write_buffer),
+        flash_write_size_bytes_(flash_write_size_bytes),
+        initialized_(false),
+        writer_open_(false),
+        write_error_(false),
+        readers_open_(0),
+        next_address_(0),
+        erased_end_(0),
+        write_slot_(nullptr),
+        write_name_hash_(0),
+        write_start_(0),
+        write_size_bytes_(0),
+        flash_address_(0) {}
+
+  BlobContainer(const BlobContainer&) = delete;
+  BlobContainer& operator=(const BlobContainer&) = delete;
+
+ private:
+  static uint32_t NameHash(std::string_view name);
+
+  // Returns the index slot of the blob with the hash, or the empty slot where
+  // it would be added, or nullptr if the index is full.
+  IndexEntry* FindSlot(uint32_t name_hash) const;
+
+  Status OpenWrite(std::string_view name);
+  Status CloseWrite();
+  Status Write(ConstByteSpan data);
+
+  Status CloseRead();
+
+  // Write the full write buffer to flash. The last chunk of a blob may have
+  // fewer data bytes than flash_write_size_bytes_.
+  Status CommitToFlash(size_t data_bytes);
+
+  // Erase the sectors that are not yet erased up to the one holding
+  // end_address.
+  Status EraseUpTo(kvs::FlashPartition::Address end_address);
+
+  // Calculate the checksum of the blob in flash and compare it to the
+  // checksum calculated as it was written.
+  Status VerifyWrite(kvs::FlashPartition::Address address,
+                     size_t size_bytes,
+                     uint32_t checksum);
+
+  size_t WriteBufferBytesUsed() const {
+    return write_size_bytes_ - (flash_address_ - write_start_);
+  }
+
+  size_t WriteBytesRemaining() const {
+    return partition_.size_bytes() - flash_address_ - WriteBufferBytesUsed();
+  }
+
+  std::string_view name_;
+  kvs::FlashPartition& partition_;
+  // checksum_algo_ of nullptr indicates no checksum algorithm.
+  kvs::ChecksumAlgorithm* const checksum_algo_;
+  kvs::KeyValueStore& kvs_;
+  std::span<IndexEntry> index_;
+  ByteSpan write_buffer_;
+  const size_t flash_write_size_bytes_;
+
+  bool initialized_;
+
+  // BlobWriter instance is currently open.
+  bool writer_open_;
+
+  // A write to the open blob failed, so it will not be added at close.
+  bool write_error_;
+
+  // Count of open BlobReader instances.
+  size_t readers_open_;
+
+  // Address at which the next blob is written.
+  kvs::FlashPartition::Address next_address_;
+
+  // End of the erased flash after the blobs. Always at a sector boundary.
+  kvs::FlashPartition::Address erased_end_;
+
+  // State of the blob being written.
+  IndexEntry* write_slot_;
+  uint32_t write_name_hash_;
+  kvs::FlashPartition::Address write_start_;
+  size_t write_size_bytes_;
+  kvs::FlashPartition::Address flash_address_;
+};
+
+// Creates a BlobContainer with an index of kMaxBlobs entries and a write
+// buffer of kBufferSizeBytes.
+template <size_t kMaxBlobs, size_t kBufferSizeBytes>
+class BlobContainerBuffer : public BlobContainer {
+ public:
+  explicit BlobContainerBuffer(std::string_view name,
+                               kvs::FlashPartition& partition,
+                               kvs::ChecksumAlgorithm* checksum_algo,
+                               kvs::KeyValueStore& kvs,
+                               size_t flash_write_size_bytes)
+      : BlobContainer(name,
+                      partition,
+                      checksum_algo,
+                      kvs,
+                      index_storage_,
+                      buffer_,
+                      flash_write_size_bytes),
+        index_storage_{} {}
+
+ private:
+  static_assert(kMaxBlobs > 0u);
+
+  std::array<IndexEntry, kMaxBlobs> index_storage_;
+  std::array<std::byte, kBufferSizeBytes> buffer_;
+};
+
+}  // namespace pw::blob_store
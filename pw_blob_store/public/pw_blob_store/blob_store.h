@@ -16,6 +16,7 @@
 #include <span>
 
 #include "pw_assert/light.h"
+#include "pw_checksum/crc32.h"
 #include "pw_kvs/checksum.h"
 #include "pw_kvs/flash_memory.h"
 #include "pw_kvs/key_value_store.h"
@@ -40,14 +41,39 @@ namespace pw::blob_store {
 //  2) Add data using BlobWriter::Write().
 //  3) BlobWriter::Close().
 //
+// Resumable write blob, such as for a download that may be interrupted by a
+// reboot:
+//  0) Create BlobWriter instance
+//  1) BlobWriter::Resume().
+//  2) Add data starting at BlobWriter::CurrentSizeBytes(), periodically calling
+//     BlobWriter::SaveProgress().
+//  3) BlobWriter::Close().
+//
 // Read blob:
 //  0) Create BlobReader instance
 //  1) BlobReader::Open().
-//  2) Read data using BlobReader::Read() or
-//     BlobReader::GetMemoryMappedBlob().
+//  2) Read data using BlobReader::Read() and BlobReader::Seek(),
+//     BlobReader::ReadAt(), or BlobReader::GetMemoryMappedBlob().
 //  3) BlobReader::Close().
 class BlobStore {
  public:
+  // How the blob data written to flash is checked. In every mode, the checksum
+  // is calculated from the data as it is written and is saved with the blob's
+  // metadata, so Init still verifies the blob against it.
+  enum class WriteVerification {
+    // At close, read the whole blob back from flash and verify its checksum.
+    kReadBackOnClose,
+
+    // Read back each chunk as it is written to flash and compare it to the
+    // data written. Errors are found at the write that caused them, and the
+    // close does not read the blob again.
+    kReadBackOnWrite,
+
+    // Trust the flash writes that succeed, such as for flash that verifies its
+    // own writes. The blob is not read back.
+    kNone,
+  };
+
   // Implement the stream::Writer and erase interface for a BlobStore. If not
   // already erased, the Write will do any needed erase.
   //
@@ -55,7 +81,8 @@ class BlobStore {
   // Additionally, writters are unable to open if a reader is already open.
   class BlobWriter : public stream::Writer {
    public:
-    constexpr BlobWriter(BlobStore& store) : store_(store), open_(false) {}
+    constexpr BlobWriter(BlobStore& store)
+        : BlobWriter(store, /*double_buffered=*/false) {}
     BlobWriter(const BlobWriter&) = delete;
     BlobWriter& operator=(const BlobWriter&) = delete;
     virtual ~BlobWriter() {
@@ -73,13 +100,44 @@ class BlobStore {
     //     already open.
     Status Open() {
       PW_DASSERT(!open_);
-      Status status = store_.OpenWrite();
+      Status status = store_.OpenWrite(double_buffered_);
       if (status.ok()) {
         open_ = true;
       }
       return status;
     }
 
+    // Open a blob for writing, continuing the interrupted write of a previous
+    // session from its last SaveProgress(). If there is no saved progress, or
+    // the data in flash no longer matches it, any existing blob is invalidated
+    // and the write starts from the beginning, as with Open(). Writing
+    // continues at CurrentSizeBytes(), which may be less than the saved
+    // progress if the flash after it was not erased. Returns:
+    //
+    // OK - success, continue writing at CurrentSizeBytes().
+    // UNAVAILABLE - Unable to open, another writer or reader instance is
+    //     already open.
+    Status Resume() {
+      PW_DASSERT(!open_);
+      Status status = store_.ResumeWrite(double_buffered_);
+      if (status.ok()) {
+        open_ = true;
+      }
+      return status;
+    }
+
+    // Flush whole flash_write_size_bytes chunks of buffered data to flash and
+    // save the write progress in the KVS, so a later Resume() continues after
+    // the last byte in flash. Buffered bytes less than flash_write_size_bytes
+    // are not saved and must be written again after a Resume(). Returns:
+    //
+    // OK - success.
+    // DATA_LOSS - Error writing data or saving the progress.
+    Status SaveProgress() {
+      PW_DASSERT(open_);
+      return store_.SaveWriteProgress();
+    }
+
     // Finalize a blob write. Flush all remaining buffered data to storage and
     // store blob metadata. Close fails in the closed state, do NOT retry Close
     // on error. An error may or may not result in an invalid blob stored.
@@ -107,6 +165,19 @@ class BlobStore {
       return store_.Erase();
     }
 
+    // Erase up to max_sectors of the partition ahead of the written data, such
+    // as in idle time before or during a write, so that writes do not wait for
+    // the erase. Writes erase any sectors they reach that are not yet erased.
+    // Returns:
+    //
+    // OK - success, sectors erased.
+    // NOT_FOUND - the partition ahead of the written data is already erased.
+    // [error status] - flash erase failed.
+    Status PreErase(size_t max_sectors = 1) {
+      PW_DASSERT(open_);
+      return store_.PreErase(max_sectors);
+    }
+
     // Discard the current blob. Any written bytes to this point are considered
     // invalid. Returns:
     //
@@ -132,6 +203,9 @@ class BlobStore {
     }
 
    protected:
+    constexpr BlobWriter(BlobStore& store, bool double_buffered)
+        : store_(store), open_(false), double_buffered_(double_buffered) {}
+
     Status DoWrite(ConstByteSpan data) override {
       PW_DASSERT(open_);
       return store_.Write(data);
@@ -139,6 +213,9 @@ class BlobStore {
 
     BlobStore& store_;
     bool open_;
+
+   private:
+    const bool double_buffered_;
   };
 
   // Implement the stream::Writer and erase interface with deferred action for a
@@ -146,9 +223,20 @@ class BlobStore {
   //
   // Only one writter (of either type) is allowed to be open at a time.
   // Additionally, writters are unable to open if a reader is already open.
+  //
+  // With Buffering::kDouble, the write buffer is split in two buffers of whole
+  // flash_write_size_bytes chunks. When one buffer fills, data continues to be
+  // added to the other, and Flush() programs only the full buffer. This bounds
+  // the time of each Flush() to one buffer and lets data keep arriving while a
+  // full buffer waits to be programmed. Open() returns INVALID_ARGUMENT if the
+  // write buffer is smaller than two flash_write_size_bytes chunks.
   class DeferredWriter final : public BlobWriter {
    public:
-    constexpr DeferredWriter(BlobStore& store) : BlobWriter(store) {}
+    enum class Buffering { kSingle, kDouble };
+
+    constexpr DeferredWriter(BlobStore& store,
+                             Buffering buffering = Buffering::kSingle)
+        : BlobWriter(store, buffering == Buffering::kDouble) {}
     DeferredWriter(const DeferredWriter&) = delete;
     DeferredWriter& operator=(const DeferredWriter&) = delete;
     virtual ~DeferredWriter() {}
@@ -156,6 +244,9 @@ class BlobStore {
     // Flush data in the write buffer. Only a multiple of flash_write_size_bytes
     // are written in the flush. Any remainder is held until later for either
     // a flush with flash_write_size_bytes buffered or the writer is closed.
+    //
+    // When double buffered, only the full buffer is written if there is one,
+    // and the buffer being filled is kept for a later flush.
     Status Flush() {
       PW_DASSERT(open_);
       return store_.Flush();
@@ -180,7 +271,9 @@ class BlobStore {
 
   // Implement stream::Reader interface for BlobStore. Multiple readers may be
   // open at the same time, but readers may not be open with a writer open.
-  class BlobReader final : public stream::Reader {
+  class BlobReader final : public stream::Reader,
+                           public stream::Seekable,
+                           public stream::PositionalReader {
    public:
     constexpr BlobReader(BlobStore& store)
         : store_(store), open_(false), offset_(0) {}
@@ -248,6 +341,36 @@ class BlobStore {
     }
 
    private:
+    // Move the offset that the next Read() starts at. Returns:
+    //
+    // OK - success.
+    // INVALID_ARGUMENT - offset is not within the blob.
+    Status DoSeek(size_t offset) override {
+      PW_DASSERT(open_);
+      if (offset >= store_.ReadableDataBytes()) {
+        return Status::InvalidArgument();
+      }
+      offset_ = offset;
+      return OkStatus();
+    }
+
+    size_t DoTell() const override {
+      PW_DASSERT(open_);
+      return offset_;
+    }
+
+    // Read up to dest.size_bytes() bytes starting at offset in to the blob,
+    // without changing the offset used by Read(). Returns:
+    //
+    // OK with size - number of bytes read, less than dest if the blob ends
+    //     first.
+    // OUT_OF_RANGE - offset is not within the blob.
+    // [error status] - flash read failed.
+    StatusWithSize DoReadAt(size_t offset, ByteSpan dest) const override {
+      PW_DASSERT(open_);
+      return store_.Read(offset, dest);
+    }
+
     StatusWithSize DoRead(ByteSpan dest) override {
       PW_DASSERT(open_);
       StatusWithSize status = store_.Read(offset_, dest);
@@ -275,18 +398,22 @@ class BlobStore {
   //     This should be chosen to balance optimal write size and required buffer
   //     size. Must be greater than or equal to flash write alignment, less than
   //     or equal to flash sector size.
+  // write_verification - How data written to flash is checked.
   BlobStore(std::string_view name,
             kvs::FlashPartition& partition,
             kvs::ChecksumAlgorithm* checksum_algo,
             kvs::KeyValueStore& kvs,
             ByteSpan write_buffer,
-            size_t flash_write_size_bytes)
+            size_t flash_write_size_bytes,
+            WriteVerification write_verification =
+                WriteVerification::kReadBackOnClose)
       : name_(name),
         partition_(partition),
         checksum_algo_(checksum_algo),
         kvs_(kvs),
         write_buffer_(write_buffer),
         flash_write_size_bytes_(flash_write_size_bytes),
+        write_verification_(write_verification),
         initialized_(false),
         valid_data_(false),
         flash_erased_(false),
@@ -294,7 +421,11 @@ class BlobStore {
         readers_open_(0),
         metadata_({}),
         write_address_(0),
-        flash_address_(0) {}
+        flash_address_(0),
+        erased_end_(0),
+        double_buffer_size_bytes_(0),
+        fill_buffer_offset_(0),
+        full_buffer_bytes_(0) {}
 
   BlobStore(const BlobStore&) = delete;
   BlobStore& operator=(const BlobStore&) = delete;
@@ -318,7 +449,38 @@ class BlobStore {
   // OK - success.
   // UNAVAILABLE - Unable to open writer, another writer or reader instance is
   //     already open.
-  Status OpenWrite();
+  // INVALID_ARGUMENT - double_buffered and the write buffer is too small.
+  Status OpenWrite(bool double_buffered);
+
+  // Open to do a blob write, continuing from the saved write progress if there
+  // is valid progress for the data in flash. Returns:
+  //
+  // OK - success.
+  // UNAVAILABLE - Unable to open writer, another writer or reader instance is
+  //     already open.
+  // INVALID_ARGUMENT - double_buffered and the write buffer is too small.
+  Status ResumeWrite(bool double_buffered);
+
+  // Checks that a writer may be opened and sets up the write buffer for single
+  // or double buffering. Returns:
+  //
+  // OK - a writer may be opened.
+  // FAILED_PRECONDITION - not initialized.
+  // UNAVAILABLE - another writer or reader instance is already open.
+  // INVALID_ARGUMENT - double_buffered and the write buffer is too small.
+  Status PrepareWriter(bool double_buffered);
+
+  // Restores the write state from the saved write progress, after verifying
+  // the data in flash matches it. Returns:
+  //
+  // OK - write state restored, write continues at write_address_.
+  // NOT_FOUND - no saved write progress.
+  // DATA_LOSS - saved progress is invalid or does not match flash.
+  Status LoadWriteProgress();
+
+  // Flush whole chunks to flash and save the write progress, as described for
+  // BlobWriter::SaveProgress().
+  Status SaveWriteProgress();
 
   // Open to do a blob read. Returns:
   //
@@ -364,7 +526,8 @@ class BlobStore {
 
   // Flush data in the write buffer. Only a multiple of flash_write_size_bytes
   // are written in the flush. Any remainder is held until later for either a
-  // flush with flash_write_size_bytes buffered or the writer is closed.
+  // flush with flash_write_size_bytes buffered or the writer is closed. When
+  // double buffered, only the full buffer is written if there is one.
   //
   // OK - successful write/enqueue of data.
   // DATA_LOSS - Error during write (this flush or previous write/flush). No
@@ -372,6 +535,27 @@ class BlobStore {
   //     erase/new blob started).
   Status Flush();
 
+  // Flush all whole flash_write_size_bytes chunks in the write buffer, from
+  // both buffers when double buffered.
+  Status FlushAll();
+
+  // Commit the whole flash_write_size_bytes chunks of the fill buffer and move
+  // any remainder to its start.
+  Status FlushFillBuffer();
+
+  // When double buffered, make a full fill buffer the full buffer waiting to be
+  // flushed, if that buffer is empty, and continue filling the other buffer.
+  void SwapFullWriteBuffer();
+
+  // The part of the write buffer that buffered data is added to. This is the
+  // whole write buffer unless double buffered.
+  ByteSpan FillBuffer() const {
+    return double_buffer_size_bytes_ == 0
+               ? write_buffer_
+               : write_buffer_.subspan(fill_buffer_offset_,
+                                       double_buffer_size_bytes_);
+  }
+
   // Flush a chunk of data in the write buffer smaller than
   // flash_write_size_bytes. This is only for the final flush as part of the
   // CloseWrite. The partial chunk is padded to flash_write_size_bytes and a
@@ -389,6 +573,15 @@ class BlobStore {
   // to alignment.
   Status CommitToFlash(ConstByteSpan source, size_t data_bytes = 0);
 
+  // Read back data written to flash at address and compare it to the data
+  // that was written. Returns:
+  //
+  // OK - flash matches the data.
+  // DATA_LOSS - flash does not match the data.
+  // [error status] - flash read failed.
+  Status VerifyFlashWrite(kvs::FlashPartition::Address address,
+                          ConstByteSpan data);
+
   // Blob is valid/OK to write to. Blob is considered valid to write if no data
   // has been written due to the auto/implicit erase on write start.
   //
@@ -437,6 +630,17 @@ class BlobStore {
 
   Status Erase();
 
+  // Erase up to max_sectors ahead of the written data, as described for
+  // BlobWriter::PreErase().
+  Status PreErase(size_t max_sectors);
+
+  // Erase the sectors of the partition that are not yet erased, up to the
+  // sector holding end_address.
+  Status EraseUpTo(kvs::FlashPartition::Address end_address);
+
+  // Erase up to max_sectors, starting at erased_end_.
+  Status EraseSectorsAhead(size_t max_sectors);
+
   Status Invalidate();
 
   void ResetChecksum() {
@@ -468,6 +672,26 @@ class BlobStore {
     }
   };
 
+  // Progress of an in-progress blob write, saved under the same key as the
+  // BlobMetadata of a complete blob so there is only ever one of the two. The
+  // two are told apart by size, since the KVS only reads a value into a type
+  // of the same size, so code that only knows BlobMetadata does not mistake an
+  // in-progress write for a complete blob.
+  struct WriteProgress {
+    // CRC32 of the blob data in flash, which unlike checksum_algo_ can be
+    // calculated incrementally without finishing it.
+    uint32_t crc32;
+
+    // Number of blob data bytes written to flash.
+    size_t data_size_bytes;
+
+    // MaxDataSizeBytes() of the partition the data was written to.
+    size_t max_data_size_bytes;
+  };
+
+  static_assert(sizeof(WriteProgress) != sizeof(BlobMetadata),
+                "WriteProgress and BlobMetadata are distinguished by size");
+
   std::string_view name_;
   kvs::FlashPartition& partition_;
   // checksum_algo_ of nullptr indicates no checksum algorithm.
@@ -480,6 +704,8 @@ class BlobStore {
   // alignment, LE flash sector size.
   const size_t flash_write_size_bytes_;
 
+  const WriteVerification write_verification_;
+
   //
   // Internal state for Blob store
   //
@@ -511,6 +737,27 @@ class BlobStore {
   // Current index of end of data written to flash. Number of buffered data
   // bytes is write_address_ - flash_address_.
   kvs::FlashPartition::Address flash_address_;
+
+  // End of the erased flash after flash_address_. Flash from flash_address_ to
+  // erased_end_ is erased and ready to write, if erased_end_ is past
+  // flash_address_. Sectors are erased in order, so this is always at a sector
+  // boundary.
+  kvs::FlashPartition::Address erased_end_;
+
+  // Size in bytes of each of the two buffers the write buffer is split in when
+  // double buffered, or 0 when single buffered.
+  size_t double_buffer_size_bytes_;
+
+  // Offset in the write buffer of the buffer data is added to. Buffered bytes
+  // in the fill buffer follow the bytes of the full buffer.
+  size_t fill_buffer_offset_;
+
+  // Bytes in the full buffer waiting to be written to flash when double
+  // buffered. Either 0 or double_buffer_size_bytes_.
+  size_t full_buffer_bytes_;
+
+  // CRC32 of the data written to flash, saved with the write progress.
+  checksum::Crc32 flash_crc32_;
 };
 
 // Creates a BlobStore with the buffer of kBufferSizeBytes.
@@ -528,6 +775,7 @@ class BlobStore {
 //     This should be chosen to balance optimal write size and required buffer
 //     size. Must be greater than or equal to flash write alignment, less than
 //     or equal to flash sector size.
+// write_verification - How data written to flash is checked.
 
 template <size_t kBufferSizeBytes>
 class BlobStoreBuffer : public BlobStore {
@@ -536,13 +784,16 @@ class BlobStoreBuffer : public BlobStore {
                            kvs::FlashPartition& partition,
                            kvs::ChecksumAlgorithm* checksum_algo,
                            kvs::KeyValueStore& kvs,
-                           size_t flash_write_size_bytes)
+                           size_t flash_write_size_bytes,
+                           WriteVerification write_verification =
+                               WriteVerification::kReadBackOnClose)
       : BlobStore(name,
                   partition,
                   checksum_algo,
                   kvs,
                   buffer_,
-                  flash_write_size_bytes) {}
+                  flash_write_size_bytes,
+                  write_verification) {}
 
  private:
   std::array<std::byte, kBufferSizeBytes> buffer_;
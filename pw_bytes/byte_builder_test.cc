@@ -16,6 +16,7 @@
 
 #include <array>
 #include <cstddef>
+#include <cstring>
 
 #include "gtest/gtest.h"
 
@@ -275,6 +276,60 @@ TEST(ByteBuilder, PopBack_Empty) {
   EXPECT_TRUE(bb.empty());
 }
 
+TEST(ByteBuilder, PutUint16s_MatchesPutUint16) {
+  constexpr uint16_t kValues[] = {0x0102, 0xA7F1, 0x0000, 0xFFFE, 0x8001};
+  for (std::endian order : {std::endian::little, std::endian::big}) {
+    ByteBuffer<sizeof(kValues)> bulk;
+    bulk.PutUint16s(kValues, order);
+    ASSERT_EQ(OkStatus(), bulk.status());
+
+    ByteBuffer<sizeof(kValues)> single;
+    for (uint16_t value : kValues) {
+      single.PutUint16(value, order);
+    }
+    ASSERT_EQ(single.size(), bulk.size());
+    EXPECT_EQ(0, std::memcmp(single.data(), bulk.data(), bulk.size()));
+  }
+}
+
+TEST(ByteBuilder, PutInt32s_BigEndian) {
+  constexpr int32_t kValues[] = {0x01020304, -2};
+  ByteBuffer<8> bb;
+  bb.PutInt32s(kValues, std::endian::big);
+  ASSERT_EQ(OkStatus(), bb.status());
+
+  constexpr auto kExpected =
+      bytes::Array<0x01, 0x02, 0x03, 0x04, 0xFF, 0xFF, 0xFF, 0xFE>();
+  EXPECT_EQ(0, std::memcmp(kExpected.data(), bb.data(), kExpected.size()));
+}
+
+TEST(ByteBuilder, PutUint64s_LittleEndian) {
+  constexpr uint64_t kValues[] = {0x0102030405060708};
+  ByteBuffer<8> bb;
+  bb.PutUint64s(kValues);
+  ASSERT_EQ(OkStatus(), bb.status());
+
+  constexpr auto kExpected =
+      bytes::Array<0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01>();
+  EXPECT_EQ(0, std::memcmp(kExpected.data(), bb.data(), kExpected.size()));
+}
+
+TEST(ByteBuilder, PutUint32s_DoesNotFit_AppendsNothing) {
+  constexpr uint32_t kValues[] = {1, 2, 3};
+  ByteBuffer<10> bb;
+  bb.PutUint8(0);
+  bb.PutUint32s(kValues);
+  EXPECT_EQ(Status::ResourceExhausted(), bb.status());
+  EXPECT_EQ(1u, bb.size());
+}
+
+TEST(ByteBuilder, PutUint16s_Empty) {
+  ByteBuffer<2> bb;
+  bb.PutUint16s(std::span<const uint16_t>());
+  EXPECT_EQ(OkStatus(), bb.status());
+  EXPECT_TRUE(bb.empty());
+}
+
 TEST(ByteBuffer, Assign) {
   std::array<byte, 3> buffer = MakeBytes(0x01, 0x02, 0x03);
   ByteBuffer<10> one;
@@ -862,5 +917,31 @@ TEST(ByteBuffer, Iterator_ReadValues_8Bytes) {
   EXPECT_EQ(it.ReadUint64(), uint64_t(0x000001E8A7A0D569));
   EXPECT_EQ(it.ReadInt64(std::endian::big), int64_t(0xFFFFFE17585F2A97));
 }
+
+TEST(ByteBuffer, Iterator_ReadArrays) {
+  constexpr uint16_t kUint16s[] = {0xA7F1, 0x0102, 0xFFFF};
+  constexpr int32_t kInt32s[] = {-5, 0x01020304};
+  constexpr uint64_t kUint64s[] = {0x000001E8A7A0D569, 0xFFFFFE17585F2A97};
+
+  ByteBuffer<sizeof(kUint16s) + sizeof(kInt32s) + sizeof(kUint64s)> bb;
+  bb.PutUint16s(kUint16s, std::endian::big);
+  bb.PutInt32s(kInt32s);
+  bb.PutUint64s(kUint64s, std::endian::big);
+  ASSERT_EQ(OkStatus(), bb.status());
+
+  uint16_t uint16s[3];
+  int32_t int32s[2];
+  uint64_t uint64s[2];
+  auto it = bb.begin();
+  it.ReadUint16s(uint16s, std::endian::big);
+  it.ReadInt32s(int32s);
+  it.ReadUint64s(uint64s, std::endian::big);
+
+  EXPECT_EQ(bb.end(), it);
+  EXPECT_EQ(0, std::memcmp(kUint16s, uint16s, sizeof(uint16s)));
+  EXPECT_EQ(0, std::memcmp(kInt32s, int32s, sizeof(int32s)));
+  EXPECT_EQ(0, std::memcmp(kUint64s, uint64s, sizeof(uint64s)));
+}
+
 }  // namespace
 }  // namespace pw
@@ -0,0 +1,90 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_bytes/byte_chain.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace pw {
+
+size_t ByteChain::size() const {
+  size_t total = 0;
+  for (const Chunk& chunk : *this) {
+    total += chunk.size();
+  }
+  return total;
+}
+
+size_t ByteChain::chunk_count() const {
+  size_t count = 0;
+  for (auto it = begin(); it != end(); ++it) {
+    count += 1;
+  }
+  return count;
+}
+
+void ByteChain::push_front(Chunk& chunk) {
+  chunk.next_ = head_;
+  head_ = &chunk;
+  if (tail_ == nullptr) {
+    tail_ = &chunk;
+  }
+}
+
+void ByteChain::push_back(Chunk& chunk) {
+  chunk.next_ = nullptr;
+  if (tail_ == nullptr) {
+    head_ = &chunk;
+  } else {
+    tail_->next_ = &chunk;
+  }
+  tail_ = &chunk;
+}
+
+void ByteChain::pop_front() {
+  Chunk* const chunk = head_;
+  head_ = chunk->next_;
+  chunk->next_ = nullptr;
+  if (head_ == nullptr) {
+    tail_ = nullptr;
+  }
+}
+
+void ByteChain::clear() {
+  while (!empty()) {
+    pop_front();
+  }
+}
+
+size_t ByteChain::CopyTo(ByteSpan dest, size_t offset) const {
+  size_t copied = 0;
+  for (const Chunk& chunk : *this) {
+    if (copied == dest.size()) {
+      break;
+    }
+    if (offset >= chunk.size()) {
+      offset -= chunk.size();
+      continue;
+    }
+    const ConstByteSpan data = chunk.data().subspan(offset);
+    const size_t to_copy = std::min(data.size(), dest.size() - copied);
+    std::memcpy(dest.data() + copied, data.data(), to_copy);
+    copied += to_copy;
+    offset = 0;
+  }
+  return copied;
+}
+
+}  // namespace pw
@@ -0,0 +1,155 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_bytes/byte_chain.h"
+
+#include <array>
+#include <cstddef>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+
+namespace pw {
+namespace {
+
+TEST(ByteChain, Empty) {
+  ByteChain chain;
+  EXPECT_TRUE(chain.empty());
+  EXPECT_EQ(0u, chain.size());
+  EXPECT_EQ(0u, chain.chunk_count());
+  EXPECT_EQ(chain.begin(), chain.end());
+  EXPECT_TRUE(chain.ClaimPrefix(1).empty());
+  EXPECT_TRUE(chain.ClaimSuffix(1).empty());
+}
+
+TEST(ByteChain, PushFrontAndBack_IteratesInOrder) {
+  std::array<std::byte, 2> a = bytes::Array<1, 2>();
+  std::array<std::byte, 1> b = bytes::Array<3>();
+  std::array<std::byte, 3> c = bytes::Array<4, 5, 6>();
+  ByteChain::Chunk chunk_a(a);
+  ByteChain::Chunk chunk_b(b);
+  ByteChain::Chunk chunk_c(c);
+
+  ByteChain chain;
+  chain.push_back(chunk_b);
+  chain.push_front(chunk_a);
+  chain.push_back(chunk_c);
+
+  EXPECT_EQ(3u, chain.chunk_count());
+  EXPECT_EQ(6u, chain.size());
+  EXPECT_EQ(&chunk_a, &chain.front());
+  EXPECT_EQ(&chunk_c, &chain.back());
+
+  const ByteChain::Chunk* expected[] = {&chunk_a, &chunk_b, &chunk_c};
+  size_t i = 0;
+  for (const ByteChain::Chunk& chunk : chain) {
+    ASSERT_LT(i, 3u);
+    EXPECT_EQ(expected[i++], &chunk);
+  }
+  EXPECT_EQ(3u, i);
+  chain.clear();
+}
+
+TEST(ByteChain, PopFront) {
+  std::byte buffer[4] = {};
+  ByteChain::Chunk first(buffer);
+  ByteChain::Chunk second(buffer);
+
+  ByteChain chain;
+  chain.push_back(first);
+  chain.push_back(second);
+  chain.pop_front();
+  EXPECT_EQ(&second, &chain.front());
+  chain.pop_front();
+  EXPECT_TRUE(chain.empty());
+
+  // Chunks can be reused after they are removed.
+  chain.push_back(first);
+  EXPECT_EQ(&first, &chain.back());
+  chain.clear();
+}
+
+TEST(ByteChain, Chunk_Headroom) {
+  std::byte buffer[8] = {};
+  ByteChain::Chunk chunk(buffer, 3, 2);
+  EXPECT_EQ(3u, chunk.headroom());
+  EXPECT_EQ(3u, chunk.tailroom());
+  EXPECT_EQ(2u, chunk.size());
+  EXPECT_EQ(&buffer[3], chunk.data().data());
+
+  EXPECT_TRUE(chunk.ClaimPrefix(4).empty());
+  ByteSpan prefix = chunk.ClaimPrefix(2);
+  EXPECT_EQ(&buffer[1], prefix.data());
+  EXPECT_EQ(2u, prefix.size());
+  EXPECT_EQ(4u, chunk.size());
+
+  EXPECT_TRUE(chunk.ClaimSuffix(4).empty());
+  ByteSpan suffix = chunk.ClaimSuffix(3);
+  EXPECT_EQ(&buffer[5], suffix.data());
+  EXPECT_EQ(0u, chunk.tailroom());
+  EXPECT_EQ(7u, chunk.size());
+
+  chunk.DiscardPrefix(1);
+  chunk.DiscardSuffix(2);
+  EXPECT_EQ(&buffer[2], chunk.data().data());
+  EXPECT_EQ(4u, chunk.size());
+
+  chunk.DiscardPrefix(10);
+  EXPECT_TRUE(chunk.empty());
+}
+
+TEST(ByteChain, ClaimPrefix_UsesFirstChunk) {
+  std::byte header_buffer[6] = {};
+  std::byte payload_buffer[4] = {};
+  ByteChain::Chunk header(header_buffer, 4, 0);
+  ByteChain::Chunk payload(payload_buffer, 0, 2);
+
+  ByteChain chain;
+  chain.push_back(header);
+  chain.push_back(payload);
+
+  ByteSpan prefix = chain.ClaimPrefix(3);
+  EXPECT_EQ(&header_buffer[1], prefix.data());
+  ByteSpan suffix = chain.ClaimSuffix(2);
+  EXPECT_EQ(&payload_buffer[2], suffix.data());
+  EXPECT_EQ(7u, chain.size());
+  chain.clear();
+}
+
+TEST(ByteChain, CopyTo_GathersChunks) {
+  std::array<std::byte, 3> a = bytes::Array<1, 2, 3>();
+  std::array<std::byte, 2> b = bytes::Array<4, 5>();
+  ByteChain::Chunk chunk_a(a);
+  ByteChain::Chunk empty(ByteSpan{});
+  ByteChain::Chunk chunk_b(b);
+
+  ByteChain chain;
+  chain.push_back(chunk_a);
+  chain.push_back(empty);
+  chain.push_back(chunk_b);
+
+  std::array<std::byte, 8> dest = {};
+  EXPECT_EQ(5u, chain.CopyTo(dest));
+  EXPECT_EQ(dest, (bytes::Array<1, 2, 3, 4, 5, 0, 0, 0>()));
+
+  dest = {};
+  EXPECT_EQ(2u, chain.CopyTo(std::span(dest).first(2), 2));
+  EXPECT_EQ(dest, (bytes::Array<3, 4, 0, 0, 0, 0, 0, 0>()));
+
+  EXPECT_EQ(0u, chain.CopyTo(dest, 5));
+  chain.clear();
+}
+
+}  // namespace
+}  // namespace pw
@@ -18,6 +18,7 @@
 #include <bit>
 #include <cstddef>
 #include <cstring>
+#include <span>
 
 #include "pw_bytes/endian.h"
 #include "pw_bytes/span.h"
@@ -189,7 +190,47 @@ class ByteBuilder {
       return value;
     }
 
+    // The bulk Read methods fill the span with ordered (Little/Big Endian)
+    // values located at the iterator position and move the iterator forward by
+    // the size of the span in bytes. Like the single-value Read methods, they
+    // do not check bounds.
+    void ReadInt16s(std::span<int16_t> values,
+                    std::endian order = std::endian::little) {
+      ReadManyInOrder(values, order);
+    }
+
+    void ReadUint16s(std::span<uint16_t> values,
+                     std::endian order = std::endian::little) {
+      ReadManyInOrder(values, order);
+    }
+
+    void ReadInt32s(std::span<int32_t> values,
+                    std::endian order = std::endian::little) {
+      ReadManyInOrder(values, order);
+    }
+
+    void ReadUint32s(std::span<uint32_t> values,
+                     std::endian order = std::endian::little) {
+      ReadManyInOrder(values, order);
+    }
+
+    void ReadInt64s(std::span<int64_t> values,
+                    std::endian order = std::endian::little) {
+      ReadManyInOrder(values, order);
+    }
+
+    void ReadUint64s(std::span<uint64_t> values,
+                     std::endian order = std::endian::little) {
+      ReadManyInOrder(values, order);
+    }
+
    private:
+    template <typename T>
+    void ReadManyInOrder(std::span<T> values, std::endian order) {
+      CopyManyInOrder<T>(order, byte_, values.data(), values.size());
+      byte_ += values.size_bytes();
+    }
+
     const std::byte* byte_;
   };
 
@@ -326,6 +367,39 @@ class ByteBuilder {
     return PutUint64(static_cast<uint64_t>(value), order);
   }
 
+  // Bulk put methods for inserting arrays of 16, 32, and 64-bit ints. The
+  // bounds are checked once for the whole array. If the values do not fit, no
+  // bytes are appended and the status is set to RESOURCE_EXHAUSTED.
+  ByteBuilder& PutInt16s(std::span<const int16_t> values,
+                         std::endian order = std::endian::little) {
+    return WriteManyInOrder(values, order);
+  }
+
+  ByteBuilder& PutUint16s(std::span<const uint16_t> values,
+                          std::endian order = std::endian::little) {
+    return WriteManyInOrder(values, order);
+  }
+
+  ByteBuilder& PutInt32s(std::span<const int32_t> values,
+                         std::endian order = std::endian::little) {
+    return WriteManyInOrder(values, order);
+  }
+
+  ByteBuilder& PutUint32s(std::span<const uint32_t> values,
+                          std::endian order = std::endian::little) {
+    return WriteManyInOrder(values, order);
+  }
+
+  ByteBuilder& PutInt64s(std::span<const int64_t> values,
+                         std::endian order = std::endian::little) {
+    return WriteManyInOrder(values, order);
+  }
+
+  ByteBuilder& PutUint64s(std::span<const uint64_t> values,
+                          std::endian order = std::endian::little) {
+    return WriteManyInOrder(values, order);
+  }
+
  protected:
   // Functions to support ByteBuffer copies.
   constexpr ByteBuilder(const ByteSpan& buffer, const ByteBuilder& other)
@@ -341,6 +415,38 @@ class ByteBuilder {
   ByteBuilder& WriteInOrder(T value) {
     return append(&value, sizeof(value));
   }
+
+  template <typename T>
+  ByteBuilder& WriteManyInOrder(std::span<const T> values, std::endian order) {
+    std::byte* const append_destination = buffer_.data() + size_;
+    CopyManyInOrder<T>(order,
+                       values.data(),
+                       append_destination,
+                       ResizeForAppend(values.size_bytes()) / sizeof(T));
+    return *this;
+  }
+
+  // Copies count values between buffers, reversing the bytes of each value if
+  // the order is not the native order. The loop has no calls or branches, so
+  // compilers vectorize it.
+  template <typename T>
+  static void CopyManyInOrder(std::endian order,
+                              const void* source,
+                              void* destination,
+                              size_t count) {
+    if (order == std::endian::native) {
+      std::memcpy(destination, source, count * sizeof(T));
+      return;
+    }
+    const std::byte* const from = static_cast<const std::byte*>(source);
+    std::byte* const to = static_cast<std::byte*>(destination);
+    for (size_t i = 0; i < count; ++i) {
+      T value;
+      std::memcpy(&value, from + i * sizeof(T), sizeof(T));
+      value = bytes::internal::ReverseBytes(value);
+      std::memcpy(to + i * sizeof(T), &value, sizeof(T));
+    }
+  }
   size_t ResizeForAppend(size_t bytes_to_append);
 
   const ByteSpan buffer_;
@@ -0,0 +1,212 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+
+#include "pw_bytes/span.h"
+
+namespace pw {
+
+// ByteChain is a chain of non-owning byte buffers, which lets the layers of a
+// protocol stack wrap data without copying it. For example, a payload, an RPC
+// packet header, and an HDLC frame header can each be a chunk in one chain.
+//
+// Each chunk's data is a subrange of its buffer. The bytes before the data are
+// headroom and the bytes after it are tailroom. Lower layers can claim headroom
+// or tailroom to add headers or footers in place, rather than adding chunks.
+//
+// Neither ByteChain nor its chunks own memory. A chunk can only be in one chain
+// at a time, and must outlive the chain it is in.
+//
+// Usage:
+//
+//   std::byte buffer[64];
+//   ByteChain::Chunk packet(buffer, /*data_offset=*/8, /*data_size=*/0);
+//   ByteChain::Chunk payload(payload_bytes);
+//
+//   ByteChain chain;
+//   chain.push_back(packet);
+//   chain.push_back(payload);
+//
+//   ByteSpan header = chain.ClaimPrefix(4);  // Uses the headroom in buffer.
+//
+class ByteChain {
+ public:
+  class Chunk;
+  class iterator;
+  using const_iterator = iterator;
+
+  constexpr ByteChain() : head_(nullptr), tail_(nullptr) {}
+
+  // Chunks are linked to one chain, so chains cannot be copied.
+  ByteChain(const ByteChain&) = delete;
+  ByteChain& operator=(const ByteChain&) = delete;
+
+  // True if the chain has no chunks.
+  bool empty() const { return head_ == nullptr; }
+
+  // Returns the total number of data bytes in all chunks. Operation is O(n) in
+  // the number of chunks.
+  size_t size() const;
+
+  // Returns the number of chunks. Operation is O(n).
+  size_t chunk_count() const;
+
+  // Adds a chunk, which must not be in a chain, to the front or back.
+  void push_front(Chunk& chunk);
+  void push_back(Chunk& chunk);
+
+  // Removes the first chunk. The chain must not be empty.
+  void pop_front();
+
+  // Removes all chunks from the chain.
+  void clear();
+
+  // The first and last chunks. The chain must not be empty.
+  Chunk& front() const { return *head_; }
+  Chunk& back() const { return *tail_; }
+
+  // Grows the first chunk's data into its headroom, or the last chunk's data
+  // into its tailroom, and returns the claimed bytes. Returns an empty span if
+  // the chain is empty or there is not enough room.
+  ByteSpan ClaimPrefix(size_t size_bytes);
+  ByteSpan ClaimSuffix(size_t size_bytes);
+
+  // Copies the data bytes, starting at the offset into the chain, to dest.
+  // Returns the number of bytes copied, which is less than dest.size() if the
+  // chain runs out of bytes.
+  size_t CopyTo(ByteSpan dest, size_t offset = 0) const;
+
+  // Iterates over the chunks in the chain.
+  iterator begin() const;
+  iterator end() const;
+
+ private:
+  Chunk* head_;
+  Chunk* tail_;
+};
+
+// A buffer in a ByteChain, with data in a subrange of the buffer.
+class ByteChain::Chunk {
+ public:
+  // A chunk whose data is the whole buffer, with no headroom or tailroom.
+  constexpr Chunk(ByteSpan data) : Chunk(data, 0, data.size()) {}
+
+  // A chunk with data_size bytes of data at data_offset in the buffer. The
+  // data must fit in the buffer.
+  constexpr Chunk(ByteSpan buffer, size_t data_offset, size_t data_size)
+      : buffer_(buffer),
+        begin_(data_offset),
+        end_(data_offset + data_size),
+        next_(nullptr) {}
+
+  // Chunks are linked into chains, so they cannot be copied.
+  Chunk(const Chunk&) = delete;
+  Chunk& operator=(const Chunk&) = delete;
+
+  ByteSpan data() const { return buffer_.subspan(begin_, end_ - begin_); }
+  size_t size() const { return end_ - begin_; }
+  bool empty() const { return begin_ == end_; }
+
+  // Bytes available before and after the data.
+  size_t headroom() const { return begin_; }
+  size_t tailroom() const { return buffer_.size() - end_; }
+
+  // Grows the data into the headroom or tailroom and returns the claimed
+  // bytes. Returns an empty span if there is not enough room.
+  ByteSpan ClaimPrefix(size_t size_bytes) {
+    if (size_bytes > headroom()) {
+      return ByteSpan();
+    }
+    begin_ -= size_bytes;
+    return buffer_.subspan(begin_, size_bytes);
+  }
+
+  ByteSpan ClaimSuffix(size_t size_bytes) {
+    if (size_bytes > tailroom()) {
+      return ByteSpan();
+    }
+    end_ += size_bytes;
+    return buffer_.subspan(end_ - size_bytes, size_bytes);
+  }
+
+  // Shrinks the data from the front or back, returning the bytes to the
+  // headroom or tailroom. Discards at most size() bytes.
+  void DiscardPrefix(size_t size_bytes) {
+    begin_ += size_bytes < size() ? size_bytes : size();
+  }
+
+  void DiscardSuffix(size_t size_bytes) {
+    end_ -= size_bytes < size() ? size_bytes : size();
+  }
+
+ private:
+  friend class ByteChain;
+
+  ByteSpan buffer_;
+  size_t begin_;
+  size_t end_;
+  Chunk* next_;
+};
+
+// Forward iterator over the chunks in a ByteChain.
+class ByteChain::iterator {
+ public:
+  using difference_type = ptrdiff_t;
+  using value_type = Chunk;
+  using pointer = Chunk*;
+  using reference = Chunk&;
+  using iterator_category = std::forward_iterator_tag;
+
+  constexpr iterator() : chunk_(nullptr) {}
+
+  Chunk& operator*() const { return *chunk_; }
+  Chunk* operator->() const { return chunk_; }
+
+  iterator& operator++() {
+    chunk_ = chunk_->next_;
+    return *this;
+  }
+
+  iterator operator++(int) {
+    iterator previous = *this;
+    operator++();
+    return previous;
+  }
+
+  bool operator==(const iterator& rhs) const { return chunk_ == rhs.chunk_; }
+  bool operator!=(const iterator& rhs) const { return chunk_ != rhs.chunk_; }
+
+ private:
+  friend class ByteChain;
+
+  constexpr iterator(Chunk* chunk) : chunk_(chunk) {}
+
+  Chunk* chunk_;
+};
+
+inline ByteChain::iterator ByteChain::begin() const { return iterator(head_); }
+inline ByteChain::iterator ByteChain::end() const { return iterator(); }
+
+inline ByteSpan ByteChain::ClaimPrefix(size_t size_bytes) {
+  return head_ == nullptr ? ByteSpan() : head_->ClaimPrefix(size_bytes);
+}
+
+inline ByteSpan ByteChain::ClaimSuffix(size_t size_bytes) {
+  return tail_ == nullptr ? ByteSpan() : tail_->ClaimSuffix(size_bytes);
+}
+
+}  // namespace pw
@@ -0,0 +1,123 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Benchmarks the CRC-16-CCITT and CRC32 implementations selected by the module
+// configuration. Each checksum is benchmarked over a range of buffer sizes and
+// start offsets, and reported with its throughput.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+
+#include "gtest/gtest.h"
+#include "pw_checksum/crc16_ccitt.h"
+#include "pw_checksum/crc32.h"
+#include "pw_checksum_private/config.h"
+#include "pw_unit_test/benchmark.h"
+
+namespace pw::checksum {
+namespace {
+
+using unit_test::BenchmarkState;
+
+constexpr size_t kSizes[] = {1, 4, 16, 64, 256, 1024, 4096};
+constexpr size_t kOffsets[] = {0, 1, 2, 3, 4};
+
+constexpr size_t kMaxSize = 4096;
+constexpr size_t kMaxOffset = 8;
+
+const char* Crc16CcittImplementation() {
+  switch (PW_CHECKSUM_CRC16_CCITT_IMPLEMENTATION) {
+    case PW_CHECKSUM_CRC16_CCITT_NIBBLE_TABLE:
+      return "nibble table";
+    case PW_CHECKSUM_CRC16_CCITT_BYTE_TABLE:
+      return "byte table";
+    case PW_CHECKSUM_CRC16_CCITT_SLICING_BY_4:
+      return "slicing-by-4";
+  }
+  return "unknown";
+}
+
+const char* Crc32Implementation() {
+  switch (PW_CHECKSUM_CRC32_IMPLEMENTATION) {
+    case PW_CHECKSUM_CRC32_BYTE_TABLE:
+      return "byte table";
+    case PW_CHECKSUM_CRC32_SLICING_BY_4:
+      return "slicing-by-4";
+    case PW_CHECKSUM_CRC32_SLICING_BY_8:
+      return "slicing-by-8";
+    case PW_CHECKSUM_CRC32_ARM_CRC32:
+      return "ARMv8 CRC32 instructions";
+  }
+  return "unknown";
+}
+
+// Benchmarks the checksum function for each size and offset.
+template <typename Function>
+void Benchmark(const char* name,
+               const char* implementation,
+               Function checksum) {
+  alignas(8) std::array<std::byte, kMaxSize + kMaxOffset> buffer;
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    buffer[i] = std::byte(i * 131 + 17);
+  }
+
+  for (size_t size : kSizes) {
+    for (size_t offset : kOffsets) {
+      const std::span<const std::byte> data =
+          std::span(buffer).subspan(offset, size);
+
+      char case_name[64];
+      std::snprintf(case_name,
+                    sizeof(case_name),
+                    "%s (%s), %zu bytes, offset %zu",
+                    name,
+                    implementation,
+                    size,
+                    offset);
+      unit_test::RunBenchmark(
+          case_name,
+          {
+              .repetitions = 3,
+              .min_repetition_time_us = 2000,
+              .bytes_per_iteration = static_cast<uint32_t>(size),
+          },
+          [&](BenchmarkState& state) {
+            for (auto _ : state) {
+              unit_test::DoNotOptimize(checksum(data));
+            }
+          });
+    }
+  }
+}
+
+TEST(ChecksumBenchmark, Crc16Ccitt) {
+  Benchmark("CRC-16-CCITT",
+            Crc16CcittImplementation(),
+            [](std::span<const std::byte> data) {
+              return Crc16Ccitt::Calculate(data);
+            });
+}
+
+TEST(ChecksumBenchmark, Crc32) {
+  Benchmark(
+      "CRC32", Crc32Implementation(), [](std::span<const std::byte> data) {
+        return Crc32::Calculate(data);
+      });
+}
+
+}  // namespace
+}  // namespace pw::checksum
@@ -14,56 +14,120 @@
 
 #include "pw_checksum/crc16_ccitt.h"
 
+#include <array>
+
+#include "pw_checksum_private/config.h"
+
 namespace pw::checksum {
 namespace {
 
-constexpr uint16_t kCrc16CcittTable[256]{
-    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
-    0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
-    0x1231, 0x0210, 0x3273, 0x2252, 0x52b5, 0x4294, 0x72f7, 0x62d6,
-    0x9339, 0x8318, 0xb37b, 0xa35a, 0xd3bd, 0xc39c, 0xf3ff, 0xe3de,  // 32
-    0x2462, 0x3443, 0x0420, 0x1401, 0x64e6, 0x74c7, 0x44a4, 0x5485,
-    0xa56a, 0xb54b, 0x8528, 0x9509, 0xe5ee, 0xf5cf, 0xc5ac, 0xd58d,
-    0x3653, 0x2672, 0x1611, 0x0630, 0x76d7, 0x66f6, 0x5695, 0x46b4,
-    0xb75b, 0xa77a, 0x9719, 0x8738, 0xf7df, 0xe7fe, 0xd79d, 0xc7bc,  // 64
-    0x48c4, 0x58e5, 0x6886, 0x78a7, 0x0840, 0x1861, 0x2802, 0x3823,
-    0xc9cc, 0xd9ed, 0xe98e, 0xf9af, 0x8948, 0x9969, 0xa90a, 0xb92b,
-    0x5af5, 0x4ad4, 0x7ab7, 0x6a96, 0x1a71, 0x0a50, 0x3a33, 0x2a12,
-    0xdbfd, 0xcbdc, 0xfbbf, 0xeb9e, 0x9b79, 0x8b58, 0xbb3b, 0xab1a,  // 96
-    0x6ca6, 0x7c87, 0x4ce4, 0x5cc5, 0x2c22, 0x3c03, 0x0c60, 0x1c41,
-    0xedae, 0xfd8f, 0xcdec, 0xddcd, 0xad2a, 0xbd0b, 0x8d68, 0x9d49,
-    0x7e97, 0x6eb6, 0x5ed5, 0x4ef4, 0x3e13, 0x2e32, 0x1e51, 0x0e70,
-    0xff9f, 0xefbe, 0xdfdd, 0xcffc, 0xbf1b, 0xaf3a, 0x9f59, 0x8f78,  // 128
-    0x9188, 0x81a9, 0xb1ca, 0xa1eb, 0xd10c, 0xc12d, 0xf14e, 0xe16f,
-    0x1080, 0x00a1, 0x30c2, 0x20e3, 0x5004, 0x4025, 0x7046, 0x6067,
-    0x83b9, 0x9398, 0xa3fb, 0xb3da, 0xc33d, 0xd31c, 0xe37f, 0xf35e,
-    0x02b1, 0x1290, 0x22f3, 0x32d2, 0x4235, 0x5214, 0x6277, 0x7256,  // 160
-    0xb5ea, 0xa5cb, 0x95a8, 0x8589, 0xf56e, 0xe54f, 0xd52c, 0xc50d,
-    0x34e2, 0x24c3, 0x14a0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
-    0xa7db, 0xb7fa, 0x8799, 0x97b8, 0xe75f, 0xf77e, 0xc71d, 0xd73c,
-    0x26d3, 0x36f2, 0x0691, 0x16b0, 0x6657, 0x7676, 0x4615, 0x5634,  // 192
-    0xd94c, 0xc96d, 0xf90e, 0xe92f, 0x99c8, 0x89e9, 0xb98a, 0xa9ab,
-    0x5844, 0x4865, 0x7806, 0x6827, 0x18c0, 0x08e1, 0x3882, 0x28a3,
-    0xcb7d, 0xdb5c, 0xeb3f, 0xfb1e, 0x8bf9, 0x9bd8, 0xabbb, 0xbb9a,
-    0x4a75, 0x5a54, 0x6a37, 0x7a16, 0x0af1, 0x1ad0, 0x2ab3, 0x3a92,  // 224
-    0xfd2e, 0xed0f, 0xdd6c, 0xcd4d, 0xbdaa, 0xad8b, 0x9de8, 0x8dc9,
-    0x7c26, 0x6c07, 0x5c64, 0x4c45, 0x3ca2, 0x2c83, 0x1ce0, 0x0cc1,
-    0xef1f, 0xff3e, 0xcf5d, 0xdf7c, 0xaf9b, 0xbfba, 0x8fd9, 0x9ff8,
-    0x6e17, 0x7e36, 0x4e55, 0x5e74, 0x2e93, 0x3eb2, 0x0ed1, 0x1ef0,  // 256
-};
+constexpr uint16_t kPolynomial = 0x1021;
 
-}  // namespace
+// Returns the CRC of the top bits of value, shifted through the polynomial
+// one bit at a time.
+constexpr uint16_t ShiftBits(uint16_t value, int bits) {
+  for (int bit = 0; bit < bits; ++bit) {
+    value = static_cast<uint16_t>((value & 0x8000u) != 0u
+                                      ? (value << 1) ^ kPolynomial
+                                      : value << 1);
+  }
+  return value;
+}
 
-extern "C" uint16_t pw_checksum_Crc16Ccitt(const void* data,
-                                           size_t size_bytes,
-                                           uint16_t value) {
-  const uint8_t* const array = static_cast<const uint8_t*>(data);
+#if PW_CHECKSUM_CRC16_CCITT_IMPLEMENTATION == \
+    PW_CHECKSUM_CRC16_CCITT_NIBBLE_TABLE
 
+constexpr std::array<uint16_t, 16> GenerateNibbleTable() {
+  std::array<uint16_t, 16> table{};
+  for (uint16_t i = 0; i < 16u; ++i) {
+    table[i] = ShiftBits(static_cast<uint16_t>(i << 12), 4);
+  }
+  return table;
+}
+
+constexpr std::array<uint16_t, 16> kCrc16CcittTable = GenerateNibbleTable();
+
+static_assert(kCrc16CcittTable[1] == 0x1021u);
+static_assert(kCrc16CcittTable[15] == 0xf1efu);
+
+constexpr uint16_t UpdateNibble(uint16_t value, uint8_t nibble) {
+  return static_cast<uint16_t>(kCrc16CcittTable[(value >> 12) ^ nibble] ^
+                               (value << 4));
+}
+
+uint16_t Calculate(const uint8_t* data, size_t size_bytes, uint16_t value) {
   for (size_t i = 0; i < size_bytes; ++i) {
-    value = kCrc16CcittTable[((value >> 8) ^ array[i]) & 0xffu] ^ (value << 8);
+    value = UpdateNibble(value, data[i] >> 4);
+    value = UpdateNibble(value, data[i] & 0xfu);
+  }
+  return value;
+}
+
+#else
+
+#if PW_CHECKSUM_CRC16_CCITT_IMPLEMENTATION == \
+        PW_CHECKSUM_CRC16_CCITT_BYTE_TABLE || \
+    PW_CHECKSUM_CRC16_CCITT_IMPLEMENTATION == \
+        PW_CHECKSUM_CRC16_CCITT_SLICING_BY_4
+constexpr size_t kTableCount = PW_CHECKSUM_CRC16_CCITT_IMPLEMENTATION;
+#else
+#error "PW_CHECKSUM_CRC16_CCITT_IMPLEMENTATION must be one of the \
+implementations listed in pw_checksum_private/config.h"
+#endif  // PW_CHECKSUM_CRC16_CCITT_IMPLEMENTATION
+
+using Tables = std::array<std::array<uint16_t, 256>, kTableCount>;
+
+// Table 0 is the usual byte-at-a-time table. Table k gives the CRC of a byte
+// followed by k zero bytes, which lets slicing-by-4 look up four bytes in
+// parallel.
+constexpr Tables GenerateTables() {
+  Tables tables{};
+  for (uint16_t i = 0; i < 256u; ++i) {
+    tables[0][i] = ShiftBits(static_cast<uint16_t>(i << 8), 8);
+  }
+  for (size_t k = 1; k < kTableCount; ++k) {
+    for (size_t i = 0; i < 256u; ++i) {
+      const uint16_t previous = tables[k - 1][i];
+      tables[k][i] =
+          static_cast<uint16_t>(tables[0][previous >> 8] ^ (previous << 8));
+    }
+  }
+  return tables;
+}
+
+constexpr Tables kCrc16CcittTables = GenerateTables();
+
+static_assert(kCrc16CcittTables[0][1] == 0x1021u);
+static_assert(kCrc16CcittTables[0][255] == 0x1ef0u);
+
+uint16_t Calculate(const uint8_t* data, size_t size_bytes, uint16_t value) {
+#if PW_CHECKSUM_CRC16_CCITT_IMPLEMENTATION == \
+    PW_CHECKSUM_CRC16_CCITT_SLICING_BY_4
+  for (; size_bytes >= 4u; size_bytes -= 4u, data += 4) {
+    const uint8_t high = static_cast<uint8_t>(data[0] ^ (value >> 8));
+    const uint8_t low = static_cast<uint8_t>(data[1] ^ (value & 0xffu));
+    value = static_cast<uint16_t>(
+        kCrc16CcittTables[3][high] ^ kCrc16CcittTables[2][low] ^
+        kCrc16CcittTables[1][data[2]] ^ kCrc16CcittTables[0][data[3]]);
   }
+#endif  // PW_CHECKSUM_CRC16_CCITT_IMPLEMENTATION
 
+  for (; size_bytes > 0u; --size_bytes) {
+    value = static_cast<uint16_t>(
+        kCrc16CcittTables[0][((value >> 8) ^ *data++) & 0xffu] ^ (value << 8));
+  }
   return value;
 }
 
+#endif  // PW_CHECKSUM_CRC16_CCITT_IMPLEMENTATION ==
+        // PW_CHECKSUM_CRC16_CCITT_NIBBLE_TABLE
+
+}  // namespace
+
+extern "C" uint16_t pw_checksum_Crc16Ccitt(const void* data,
+                                           size_t size_bytes,
+                                           uint16_t value) {
+  return Calculate(static_cast<const uint8_t*>(data), size_bytes, value);
+}
+
 }  // namespace pw::checksum
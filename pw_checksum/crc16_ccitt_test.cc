@@ -14,6 +14,8 @@
 
 #include "pw_checksum/crc16_ccitt.h"
 
+#include <array>
+#include <span>
 #include <string_view>
 
 #include "gtest/gtest.h"
@@ -57,6 +59,34 @@ TEST(Crc16, String) {
             kStringCrc);
 }
 
+// Bit-at-a-time CRC-16-CCITT, for checking the table-based implementation.
+uint16_t ReferenceCrc16(const uint8_t* data, size_t size_bytes) {
+  uint16_t crc = Crc16Ccitt::kInitialValue;
+  for (size_t i = 0; i < size_bytes; ++i) {
+    crc ^= static_cast<uint16_t>(data[i] << 8);
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = static_cast<uint16_t>((crc & 0x8000u) != 0u ? (crc << 1) ^ 0x1021
+                                                          : crc << 1);
+    }
+  }
+  return crc;
+}
+
+TEST(Crc16, AllLengthsAndAlignments_MatchReference) {
+  std::array<uint8_t, 40> data;
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 53 + 7);
+  }
+
+  for (size_t offset = 0; offset < 4u; ++offset) {
+    for (size_t size = 0; size <= data.size() - offset; ++size) {
+      const uint8_t* start = data.data() + offset;
+      ASSERT_EQ(ReferenceCrc16(start, size),
+                Crc16Ccitt::Calculate(std::as_bytes(std::span(start, size))));
+    }
+  }
+}
+
 TEST(Crc16Class, Buffer) {
   Crc16Ccitt crc16;
   crc16.Update(std::as_bytes(std::span(kBytes)));
@@ -13,6 +13,8 @@
 // the License.
 #include "pw_checksum/crc32.h"
 
+#include <algorithm>
+#include <array>
 #include <span>
 #include <string_view>
 
@@ -77,6 +79,70 @@ TEST(Crc32Class, String) {
   EXPECT_EQ(crc32.value(), kStringCrc);
 }
 
+// Bit-at-a-time CRC32, for checking the table or instruction based
+// implementation.
+uint32_t ReferenceCrc32(const uint8_t* data, size_t size_bytes) {
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i = 0; i < size_bytes; ++i) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ ((crc & 1u) != 0u ? 0xEDB88320u : 0u);
+    }
+  }
+  return ~crc;
+}
+
+TEST(Crc32, AllLengthsAndAlignments_MatchReference) {
+  std::array<uint8_t, 80> data;
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 37 + 11);
+  }
+
+  for (size_t offset = 0; offset < 8u; ++offset) {
+    for (size_t size = 0; size <= data.size() - offset; ++size) {
+      const uint8_t* start = data.data() + offset;
+      ASSERT_EQ(ReferenceCrc32(start, size),
+                Crc32::Calculate(std::as_bytes(std::span(start, size))));
+    }
+  }
+}
+
+TEST(Crc32Class, UnevenPieces_MatchesWholeBuffer) {
+  Crc32 crc32;
+  const auto bytes = std::as_bytes(std::span(kString));
+  size_t position = 0;
+  for (size_t piece = 1; position < bytes.size(); ++piece) {
+    const size_t size = std::min(piece, bytes.size() - position);
+    crc32.Update(bytes.subspan(position, size));
+    position += size;
+  }
+  EXPECT_EQ(crc32.value(), kStringCrc);
+}
+
+TEST(Crc32, Combine_EverySplit) {
+  const auto bytes = std::as_bytes(std::span(kString));
+  for (size_t split = 0; split <= bytes.size(); ++split) {
+    const uint32_t crc_a = Crc32::Calculate(bytes.first(split));
+    const uint32_t crc_b = Crc32::Calculate(bytes.subspan(split));
+    ASSERT_EQ(kStringCrc, Crc32::Combine(crc_a, crc_b, bytes.size() - split));
+  }
+}
+
+TEST(Crc32, Combine_EmptySecondBlock) {
+  EXPECT_EQ(kBufferCrc,
+            Crc32::Combine(kBufferCrc, PW_CHECKSUM_EMPTY_CRC32, 0));
+}
+
+TEST(Crc32, Combine_LargeZeroBlock) {
+  std::array<std::byte, 4096> zeros{};
+  const uint32_t crc_zeros = Crc32::Calculate(zeros);
+
+  Crc32 crc32;
+  crc32.Update(std::as_bytes(std::span(kBytes)));
+  crc32.Update(zeros);
+  EXPECT_EQ(crc32.value(), Crc32::Combine(kBufferCrc, crc_zeros, zeros.size()));
+}
+
 extern "C" uint32_t CallChecksumCrc32(const void* data, size_t size_bytes);
 extern "C" uint32_t CallChecksumCrc32Append(const void* data,
                                             size_t size_bytes,
@@ -54,6 +54,14 @@ static inline uint32_t pw_checksum_Crc32Append(const void* data,
   return ~_pw_checksum_InternalCrc32(data, size_bytes, ~previous_result);
 }
 
+// Returns the CRC32 of the concatenation of two blocks of data, A followed by
+// B, given the CRC32 of each block and the length of B. The data itself is not
+// needed, so CRCs of chunks calculated separately can be combined. The cost is
+// O(log(size_bytes_b)).
+uint32_t pw_checksum_Crc32Combine(uint32_t crc_a,
+                                  uint32_t crc_b,
+                                  size_t size_bytes_b);
+
 #ifdef __cplusplus
 }  // extern "C"
 
@@ -73,6 +81,12 @@ class Crc32 {
     return pw_checksum_Crc32(data.data(), data.size_bytes());
   }
 
+  // Returns the CRC32 of data A followed by data B, given the CRC32 of each and
+  // the length of B in bytes.
+  static uint32_t Combine(uint32_t crc_a, uint32_t crc_b, size_t size_bytes_b) {
+    return pw_checksum_Crc32Combine(crc_a, crc_b, size_bytes_b);
+  }
+
   constexpr Crc32() : state_(kInitialValue) {}
 
   void Update(std::span<const std::byte> data) {
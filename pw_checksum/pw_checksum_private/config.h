@@ -0,0 +1,54 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// Implementations of the CRC32 calculation, which trade code size for speed.
+//
+// A 256-entry lookup table processes one byte at a time (1 KiB of tables).
+#define PW_CHECKSUM_CRC32_BYTE_TABLE 1
+// Slicing-by-4 processes four bytes at a time with four tables (4 KiB).
+#define PW_CHECKSUM_CRC32_SLICING_BY_4 4
+// Slicing-by-8 processes eight bytes at a time with eight tables (8 KiB).
+#define PW_CHECKSUM_CRC32_SLICING_BY_8 8
+// The ARMv8 CRC32 instructions process four or eight bytes at a time and use
+// no tables. Requires __ARM_FEATURE_CRC32 (e.g. -march=armv8-a+crc).
+#define PW_CHECKSUM_CRC32_ARM_CRC32 32
+
+// PW_CHECKSUM_CRC32_IMPLEMENTATION selects the CRC32 implementation. The
+// default is the CRC32 instructions when the target supports them, since they
+// need no tables, and the 256-entry table otherwise. The slicing
+// implementations are faster but larger, so builds opt into them.
+#ifndef PW_CHECKSUM_CRC32_IMPLEMENTATION
+#ifdef __ARM_FEATURE_CRC32
+#define PW_CHECKSUM_CRC32_IMPLEMENTATION PW_CHECKSUM_CRC32_ARM_CRC32
+#else
+#define PW_CHECKSUM_CRC32_IMPLEMENTATION PW_CHECKSUM_CRC32_BYTE_TABLE
+#endif  // __ARM_FEATURE_CRC32
+#endif  // PW_CHECKSUM_CRC32_IMPLEMENTATION
+
+// Implementations of the CRC-16-CCITT calculation.
+//
+// A 16-entry table processes four bits at a time (32 bytes of tables).
+#define PW_CHECKSUM_CRC16_CCITT_NIBBLE_TABLE 0
+// A 256-entry table processes one byte at a time (512 bytes).
+#define PW_CHECKSUM_CRC16_CCITT_BYTE_TABLE 1
+// Slicing-by-4 processes four bytes at a time with four tables (2 KiB).
+#define PW_CHECKSUM_CRC16_CCITT_SLICING_BY_4 4
+
+// PW_CHECKSUM_CRC16_CCITT_IMPLEMENTATION selects the CRC-16-CCITT
+// implementation. The default is the 256-entry table.
+#ifndef PW_CHECKSUM_CRC16_CCITT_IMPLEMENTATION
+#define PW_CHECKSUM_CRC16_CCITT_IMPLEMENTATION \
+  PW_CHECKSUM_CRC16_CCITT_BYTE_TABLE
+#endif  // PW_CHECKSUM_CRC16_CCITT_IMPLEMENTATION
@@ -0,0 +1,51 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_chrono/counter_extender.h"
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace pw::chrono {
+namespace {
+
+TEST(CounterExtender, CountsUp) {
+  CounterExtender extender;
+  EXPECT_EQ(0u, extender.extended_count());
+  EXPECT_EQ(5u, extender.Update(5));
+  EXPECT_EQ(5u, extender.Update(5));
+  EXPECT_EQ(1000u, extender.Update(1000));
+  EXPECT_EQ(1000u, extender.extended_count());
+}
+
+TEST(CounterExtender, ExtendsAcrossWraps) {
+  CounterExtender extender;
+  EXPECT_EQ(0xFFFF'FFF0u, extender.Update(0xFFFF'FFF0u));
+  EXPECT_EQ(0x1'0000'0010u, extender.Update(0x10));
+  EXPECT_EQ(0x1'8000'0000u, extender.Update(0x8000'0000u));
+  EXPECT_EQ(0x2'0000'0001u, extender.Update(1));
+}
+
+TEST(CounterExtender, Constexpr) {
+  constexpr uint64_t kCount = [] {
+    CounterExtender extender;
+    extender.Update(0xFFFF'FFFFu);
+    return extender.Update(1);
+  }();
+  static_assert(kCount == 0x1'0000'0001u);
+}
+
+}  // namespace
+}  // namespace pw::chrono
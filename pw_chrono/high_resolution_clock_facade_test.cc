@@ -0,0 +1,60 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_chrono/high_resolution_clock.h"
+
+#include <chrono>
+
+#include "gtest/gtest.h"
+#include "pw_chrono/system_clock.h"
+
+namespace pw::chrono {
+namespace {
+
+// Bounds the busy loops, as in system_clock_facade_test.cc, so that a clock
+// which does not tick fails rather than hanging the test.
+constexpr uint64_t kMaxIterations = 6'000'000'000 / 10;
+
+TEST(HighResolutionClock, Now) {
+  const HighResolutionClock::time_point start_time = HighResolutionClock::now();
+  // Verify the clock moves forward.
+  bool clock_moved_forward = false;
+  for (uint64_t i = 0; i < kMaxIterations; ++i) {
+    if (HighResolutionClock::now() > start_time) {
+      clock_moved_forward = true;
+      break;
+    }
+  }
+  EXPECT_TRUE(clock_moved_forward);
+}
+
+TEST(HighResolutionClock, FinerThanSystemClock) {
+  static_assert(std::ratio_less_equal_v<HighResolutionClock::period,
+                                        SystemClock::period>);
+  static_assert(std::ratio_less_equal_v<HighResolutionClock::period,
+                                        std::micro>,
+                "A HighResolutionClock should resolve at least microseconds");
+}
+
+TEST(HighResolutionClock, IsMonotonic) {
+  HighResolutionClock::time_point last = HighResolutionClock::now();
+  for (int i = 0; i < 10000; ++i) {
+    const HighResolutionClock::time_point now = HighResolutionClock::now();
+    ASSERT_GE(now, last);
+    last = now;
+  }
+}
+
+}  // namespace
+}  // namespace pw::chrono
@@ -0,0 +1,46 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+namespace pw::chrono {
+
+// Extends a free-running 32-bit hardware counter, such as a cycle counter, to
+// 64 bits. The counter must be read and passed to Update() before it advances
+// by 2^32 ticks since the last update, or time will be lost.
+//
+// This class is not thread or IRQ safe. Callers must serialize calls to
+// Update(), for example by masking interrupts.
+class CounterExtender {
+ public:
+  constexpr CounterExtender() = default;
+
+  // Returns the 64-bit count for the current value of the 32-bit counter.
+  constexpr uint64_t Update(uint32_t count) {
+    // Unsigned subtraction gives the ticks since the last update, even if the
+    // counter wrapped in between.
+    extended_count_ += static_cast<uint32_t>(
+        count - static_cast<uint32_t>(extended_count_));
+    return extended_count_;
+  }
+
+  // The count as of the last update.
+  constexpr uint64_t extended_count() const { return extended_count_; }
+
+ private:
+  uint64_t extended_count_ = 0;
+};
+
+}  // namespace pw::chrono
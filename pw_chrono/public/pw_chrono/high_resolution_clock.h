@@ -0,0 +1,89 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <stdint.h>
+
+// The backend implements this header to provide the following
+// HighResolutionClock parameters:
+//   PW_CHRONO_HIGH_RESOLUTION_CLOCK_PERIOD_SECONDS_NUMERATOR
+//   PW_CHRONO_HIGH_RESOLUTION_CLOCK_PERIOD_SECONDS_DENOMINATOR
+//   constexpr bool pw::chrono::backend::kHighResolutionClockNmiSafe;
+#include "pw_chrono_backend/high_resolution_clock_config.h"
+
+#include <chrono>
+#include <ratio>
+
+namespace pw::chrono {
+namespace backend {
+
+// A HighResolutionClock tick has the units of one HighResolutionClock::period
+// duration. This must be thread and IRQ safe and provided by the backend.
+int64_t GetHighResolutionClockTickCount();
+
+}  // namespace backend
+
+// The HighResolutionClock is a monotonic clock with a much finer resolution
+// than SystemClock, which typically counts RTOS ticks. It is meant for timing
+// short sections of code, such as hot paths, trace events, and benchmarks. On
+// Cortex-M it is typically the CPU cycle counter.
+//
+// Unlike SystemClock, it is not used for timeouts or sleeping, and its epoch
+// is unrelated to SystemClock's. It may stop while the CPU sleeps, and it may
+// tick at a different rate if the CPU clock is changed.
+//
+// HighResolutionClock is compatible with C++'s Clock & TrivialClock.
+//
+// Example:
+//
+//   const HighResolutionClock::time_point start = HighResolutionClock::now();
+//   ProcessPacket(packet);
+//   const std::chrono::nanoseconds elapsed =
+//       std::chrono::duration_cast<std::chrono::nanoseconds>(
+//           HighResolutionClock::now() - start);
+//
+// This code is thread & IRQ safe, it may be NMI safe depending on is_nmi_safe.
+struct HighResolutionClock {
+  using rep = int64_t;
+  // The period must be provided by the backend.
+  using period =
+      std::ratio<PW_CHRONO_HIGH_RESOLUTION_CLOCK_PERIOD_SECONDS_NUMERATOR,
+                 PW_CHRONO_HIGH_RESOLUTION_CLOCK_PERIOD_SECONDS_DENOMINATOR>;
+  using duration = std::chrono::duration<rep, period>;
+  using time_point = std::chrono::time_point<HighResolutionClock>;
+
+  // The time points of this clock cannot decrease.
+  static constexpr bool is_monotonic = true;
+
+  // The rate may change with the CPU clock and the clock may stop while the
+  // CPU sleeps.
+  static constexpr bool is_steady = false;
+
+  // The now() function may work in non-masking interrupts, depending on the
+  // backend. This must be provided by the backend.
+  static constexpr bool is_nmi_safe = backend::kHighResolutionClockNmiSafe;
+
+  // This is thread and IRQ safe. This must be provided by the backend.
+  static time_point now() noexcept {
+    return time_point(duration(backend::GetHighResolutionClockTickCount()));
+  }
+};
+
+}  // namespace pw::chrono
+
+// The backend can opt to include an inlined implementation of the following:
+//   int64_t GetHighResolutionClockTickCount();
+#if __has_include("pw_chrono_backend/high_resolution_clock_inline.h")
+#include "pw_chrono_backend/high_resolution_clock_inline.h"
+#endif  // __has_include("pw_chrono_backend/high_resolution_clock_inline.h")
@@ -0,0 +1,80 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_chrono/system_clock.h"
+#include "pw_chrono_backend/system_timer_native.h"
+
+namespace pw::chrono {
+
+// The SystemTimer invokes a callback once, when its deadline in the
+// SystemClock's time is reached. Timers are one-shot; the callback may
+// schedule its timer again to make it periodic.
+//
+// The callback runs in the backend's timer context, such as the FreeRTOS timer
+// service task, ThreadX's system timer thread, or a thread shared by all timers
+// with the STL backend. Callbacks must not block, since that delays every
+// other timer.
+//
+// A SystemTimer must not be destroyed from its own callback, and the callback
+// must not run while the SystemTimer is destroyed; Cancel() does not wait for a
+// callback which has already started.
+//
+// Subsystems with many timers, such as per-call deadlines, may drive a
+// TimerWheel from a single SystemTimer rather than creating a SystemTimer for
+// each.
+class SystemTimer {
+ public:
+  using native_handle_type = backend::NativeSystemTimerHandle;
+
+  // Invoked with the deadline which expired, and the arg passed to the
+  // constructor.
+  using ExpiryCallback = void (*)(SystemClock::time_point expired_deadline,
+                                  void* arg);
+
+  SystemTimer(ExpiryCallback callback, void* arg = nullptr);
+
+  // Cancels the timer.
+  ~SystemTimer();
+
+  SystemTimer(const SystemTimer&) = delete;
+  SystemTimer(SystemTimer&&) = delete;
+  SystemTimer& operator=(const SystemTimer&) = delete;
+  SystemTimer& operator=(SystemTimer&&) = delete;
+
+  // Invokes the callback after at least the delay has passed, replacing any
+  // pending deadline. This is thread safe, but not interrupt safe.
+  void InvokeAfter(SystemClock::duration delay_at_least) {
+    // Add a tick, since now() may be part way through the current tick.
+    InvokeAt(SystemClock::now() + delay_at_least + SystemClock::duration(1));
+  }
+
+  // Invokes the callback at or after the timestamp, replacing any pending
+  // deadline. A timestamp in the past invokes the callback as soon as possible.
+  // This is thread safe, but not interrupt safe.
+  void InvokeAt(SystemClock::time_point timestamp);
+
+  // Cancels the pending deadline, if any. This is thread safe, but not
+  // interrupt safe.
+  void Cancel();
+
+  native_handle_type native_handle();
+
+ private:
+  backend::NativeSystemTimer native_type_;
+};
+
+}  // namespace pw::chrono
+
+#include "pw_chrono_backend/system_timer_inline.h"
@@ -0,0 +1,141 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace pw::chrono {
+
+// A hierarchical timer wheel, which keeps track of many timers with O(1)
+// Schedule() and Cancel(), and finds expired timers in batches.
+//
+// Time is measured in ticks of the wheel, which are unrelated to any clock;
+// the user picks the resolution, such as 1 ms, and converts deadlines to ticks.
+// The wheel has kLevels levels of kSlots slots. A timer is placed in the
+// lowest level whose slots span its remaining time, and moves down a level
+// each time the wheel reaches the slot it is in. Timers further out than the
+// top level can span, about 16.7 million ticks, are parked in the top level
+// and moved again when they are reached.
+//
+// Advance() moves every timer which has expired onto an expired list, which
+// the user drains with PopExpired(), so expiry callbacks can run outside of
+// any lock which guards the wheel. Advance() only visits occupied slots, so
+// its cost depends on the number of timers, not on how far time moved.
+//
+// The TimerWheel is not thread safe. Its memory use is fixed: a pointer per
+// slot, plus a 64 bit occupancy mask per level.
+class TimerWheel {
+ public:
+  using Tick = uint64_t;
+
+  static constexpr size_t kLevels = 4;
+  static constexpr size_t kSlotBits = 6;
+  static constexpr size_t kSlots = size_t(1) << kSlotBits;
+
+  // A timer to place in the wheel. Users typically derive from Timer to
+  // associate a callback and state with it.
+  class Timer {
+   public:
+    constexpr Timer() = default;
+
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+
+    // Whether the timer is scheduled or has expired and not been popped.
+    bool scheduled() const { return list_ != nullptr; }
+
+    // The tick the timer was last scheduled for.
+    Tick deadline() const { return deadline_; }
+
+   private:
+    friend class TimerWheel;
+
+    Timer* prev_ = nullptr;
+    Timer* next_ = nullptr;
+    Timer** list_ = nullptr;  // Head of the list the timer is in.
+    Tick deadline_ = 0;
+  };
+
+  // Creates a wheel whose current tick is now.
+  explicit constexpr TimerWheel(Tick now = 0) : now_(now) {}
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  // Schedules the timer to expire at the deadline, or reschedules it if it is
+  // already scheduled. A deadline at or before now() expires immediately.
+  void Schedule(Timer& timer, Tick deadline);
+
+  // Removes the timer from the wheel, or from the expired list. Returns whether
+  // the timer was scheduled.
+  bool Cancel(Timer& timer);
+
+  // Moves the wheel forward to now, and moves every timer whose deadline is at
+  // or before now onto the expired list, in deadline order. Returns the number
+  // of timers which expired. now must not be before now().
+  size_t Advance(Tick now);
+
+  // Removes and returns the next expired timer, or nullptr if there is none.
+  Timer* PopExpired();
+
+  // The earliest tick at which Advance() has work to do, or std::nullopt if no
+  // timers are waiting. This is the time to sleep until; it may be before the
+  // earliest deadline, when a timer must move down a level.
+  std::optional<Tick> NextEventTick() const;
+
+  // Whether PopExpired() would return a timer.
+  bool has_expired() const { return expired_ != nullptr; }
+
+  // The number of timers in the wheel, including expired ones.
+  size_t size() const { return size_; }
+
+  Tick now() const { return now_; }
+
+ private:
+  // The furthest from now() that a timer is placed; later timers are parked.
+  static constexpr Tick kMaxDelta = (Tick(1) << (kSlotBits * kLevels)) - 1;
+
+  // Puts the timer in the slot for its deadline, or on the expired list.
+  // Returns whether it expired.
+  bool Place(Timer& timer);
+
+  void PushFront(Timer** list, Timer& timer);
+  void Unlink(Timer& timer);
+  void AppendExpired(Timer& timer);
+
+  // Moves every timer in a slot to where it belongs now. Returns the number
+  // which expired.
+  size_t Cascade(size_t level, size_t slot);
+
+  // The next tick after now() at which the level's occupied slot begins.
+  std::optional<Tick> NextSlotTick(size_t level) const;
+
+  // The earliest of NextSlotTick() for all levels.
+  std::optional<Tick> NextSlotTick() const;
+
+  Timer*& SlotHead(size_t level, size_t slot) {
+    return slots_[level * kSlots + slot];
+  }
+
+  Tick now_;
+  size_t size_ = 0;
+  uint64_t occupied_[kLevels] = {};
+  Timer* slots_[kLevels * kSlots] = {};
+  Timer* expired_ = nullptr;
+  Timer* expired_tail_ = nullptr;
+};
+
+}  // namespace pw::chrono
@@ -0,0 +1,123 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_chrono/system_timer.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+
+#include "gtest/gtest.h"
+#include "pw_sync/counting_semaphore.h"
+
+using namespace std::chrono_literals;
+
+namespace pw::chrono {
+namespace {
+
+constexpr SystemClock::duration kShortDelay =
+    std::chrono::duration_cast<SystemClock::duration>(5ms);
+constexpr SystemClock::duration kTimeout =
+    std::chrono::duration_cast<SystemClock::duration>(1s);
+
+struct Expiry {
+  sync::CountingSemaphore invoked;
+  SystemClock::time_point deadline;
+  SystemClock::time_point invoked_at;
+  SystemTimer* reschedule = nullptr;
+  int reschedule_count = 0;
+};
+
+void RecordExpiry(SystemClock::time_point expired_deadline, void* arg) {
+  Expiry& expiry = *static_cast<Expiry*>(arg);
+  expiry.deadline = expired_deadline;
+  expiry.invoked_at = SystemClock::now();
+  if (expiry.reschedule != nullptr && expiry.reschedule_count > 0) {
+    expiry.reschedule_count -= 1;
+    expiry.reschedule->InvokeAt(expired_deadline + kShortDelay);
+  }
+  expiry.invoked.release();
+}
+
+TEST(SystemTimer, InvokeAfter_InvokesCallbackAfterDeadline) {
+  Expiry expiry;
+  SystemTimer timer(RecordExpiry, &expiry);
+
+  const SystemClock::time_point before = SystemClock::now();
+  timer.InvokeAfter(kShortDelay);
+  ASSERT_TRUE(expiry.invoked.try_acquire_for(kTimeout));
+  EXPECT_GE(expiry.deadline, before + kShortDelay);
+  EXPECT_GE(expiry.invoked_at, expiry.deadline);
+}
+
+TEST(SystemTimer, InvokeAt_PastDeadlineInvokesCallback) {
+  Expiry expiry;
+  SystemTimer timer(RecordExpiry, &expiry);
+
+  const SystemClock::time_point deadline = SystemClock::now() - kShortDelay;
+  timer.InvokeAt(deadline);
+  ASSERT_TRUE(expiry.invoked.try_acquire_for(kTimeout));
+  EXPECT_EQ(deadline, expiry.deadline);
+}
+
+TEST(SystemTimer, Cancel_PreventsCallback) {
+  Expiry expiry;
+  SystemTimer timer(RecordExpiry, &expiry);
+
+  timer.InvokeAfter(kShortDelay);
+  timer.Cancel();
+  EXPECT_FALSE(expiry.invoked.try_acquire_for(kShortDelay * 10));
+}
+
+TEST(SystemTimer, InvokeAt_ReplacesDeadline) {
+  Expiry expiry;
+  SystemTimer timer(RecordExpiry, &expiry);
+
+  timer.InvokeAfter(kTimeout * 60);
+  const SystemClock::time_point deadline = SystemClock::now() + kShortDelay;
+  timer.InvokeAt(deadline);
+  ASSERT_TRUE(expiry.invoked.try_acquire_for(kTimeout));
+  EXPECT_EQ(deadline, expiry.deadline);
+  EXPECT_FALSE(expiry.invoked.try_acquire_for(kShortDelay * 10));
+}
+
+TEST(SystemTimer, Callback_ReschedulesTimer) {
+  Expiry expiry;
+  SystemTimer timer(RecordExpiry, &expiry);
+  expiry.reschedule = &timer;
+  expiry.reschedule_count = 2;
+
+  timer.InvokeAfter(kShortDelay);
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(expiry.invoked.try_acquire_for(kTimeout));
+  }
+  EXPECT_EQ(0, expiry.reschedule_count);
+  EXPECT_FALSE(expiry.invoked.try_acquire_for(kShortDelay * 10));
+}
+
+TEST(SystemTimer, ManyTimers_AllExpire) {
+  Expiry expiry;
+  std::array<std::optional<SystemTimer>, 16> timers;
+  for (size_t i = 0; i < timers.size(); ++i) {
+    timers[i].emplace(RecordExpiry, &expiry);
+    timers[i]->InvokeAfter(kShortDelay * (i % 4));
+  }
+  for (size_t i = 0; i < timers.size(); ++i) {
+    ASSERT_TRUE(expiry.invoked.try_acquire_for(kTimeout));
+  }
+}
+
+}  // namespace
+}  // namespace pw::chrono
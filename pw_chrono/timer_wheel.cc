@@ -0,0 +1,193 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_chrono/timer_wheel.h"
+
+namespace pw::chrono {
+
+void TimerWheel::Schedule(Timer& timer, Tick deadline) {
+  if (timer.scheduled()) {
+    Unlink(timer);
+  } else {
+    size_ += 1;
+  }
+  timer.deadline_ = deadline;
+  Place(timer);
+}
+
+bool TimerWheel::Cancel(Timer& timer) {
+  if (!timer.scheduled()) {
+    return false;
+  }
+  Unlink(timer);
+  size_ -= 1;
+  return true;
+}
+
+size_t TimerWheel::Advance(Tick now) {
+  size_t expired = 0;
+
+  while (true) {
+    const std::optional<Tick> next = NextSlotTick();
+    if (!next.has_value() || next.value() > now) {
+      break;
+    }
+
+    // Move timers down from the higher levels first, since some of them may
+    // land in the level 0 slot for this tick.
+    now_ = next.value();
+    for (size_t level = kLevels - 1; level > 0; --level) {
+      const size_t shift = kSlotBits * level;
+      if ((now_ & ((Tick(1) << shift) - 1)) == 0) {
+        expired += Cascade(level, (now_ >> shift) & (kSlots - 1));
+      }
+    }
+    expired += Cascade(0, now_ & (kSlots - 1));
+  }
+
+  if (now > now_) {
+    now_ = now;
+  }
+  return expired;
+}
+
+TimerWheel::Timer* TimerWheel::PopExpired() {
+  Timer* const timer = expired_;
+  if (timer != nullptr) {
+    Unlink(*timer);
+    size_ -= 1;
+  }
+  return timer;
+}
+
+std::optional<TimerWheel::Tick> TimerWheel::NextEventTick() const {
+  if (expired_ != nullptr) {
+    return now_;
+  }
+  return NextSlotTick();
+}
+
+bool TimerWheel::Place(Timer& timer) {
+  if (timer.deadline_ <= now_) {
+    AppendExpired(timer);
+    return true;
+  }
+
+  const Tick delta = timer.deadline_ - now_;
+  const Tick target = delta > kMaxDelta ? now_ + kMaxDelta : timer.deadline_;
+
+  size_t level = 0;
+  while (level + 1 < kLevels &&
+         ((target - now_) >> (kSlotBits * (level + 1))) != 0) {
+    level += 1;
+  }
+  const size_t slot = (target >> (kSlotBits * level)) & (kSlots - 1);
+  PushFront(&SlotHead(level, slot), timer);
+  occupied_[level] |= uint64_t(1) << slot;
+  return false;
+}
+
+void TimerWheel::PushFront(Timer** list, Timer& timer) {
+  timer.prev_ = nullptr;
+  timer.next_ = *list;
+  if (*list != nullptr) {
+    (*list)->prev_ = &timer;
+  }
+  *list = &timer;
+  timer.list_ = list;
+}
+
+void TimerWheel::AppendExpired(Timer& timer) {
+  timer.prev_ = expired_tail_;
+  timer.next_ = nullptr;
+  if (expired_tail_ != nullptr) {
+    expired_tail_->next_ = &timer;
+  } else {
+    expired_ = &timer;
+  }
+  expired_tail_ = &timer;
+  timer.list_ = &expired_;
+}
+
+void TimerWheel::Unlink(Timer& timer) {
+  if (timer.prev_ != nullptr) {
+    timer.prev_->next_ = timer.next_;
+  } else {
+    *timer.list_ = timer.next_;
+  }
+  if (timer.next_ != nullptr) {
+    timer.next_->prev_ = timer.prev_;
+  }
+
+  if (timer.list_ == &expired_) {
+    if (expired_tail_ == &timer) {
+      expired_tail_ = timer.prev_;
+    }
+  } else if (*timer.list_ == nullptr) {
+    const size_t index = size_t(timer.list_ - slots_);
+    occupied_[index / kSlots] &= ~(uint64_t(1) << (index % kSlots));
+  }
+
+  timer.prev_ = nullptr;
+  timer.next_ = nullptr;
+  timer.list_ = nullptr;
+}
+
+size_t TimerWheel::Cascade(size_t level, size_t slot) {
+  const uint64_t bit = uint64_t(1) << slot;
+  if ((occupied_[level] & bit) == 0) {
+    return 0;
+  }
+  Timer* timer = SlotHead(level, slot);
+  SlotHead(level, slot) = nullptr;
+  occupied_[level] &= ~bit;
+
+  size_t expired = 0;
+  while (timer != nullptr) {
+    Timer* const next = timer->next_;
+    expired += Place(*timer) ? 1 : 0;
+    timer = next;
+  }
+  return expired;
+}
+
+std::optional<TimerWheel::Tick> TimerWheel::NextSlotTick(size_t level) const {
+  const uint64_t occupied = occupied_[level];
+  if (occupied == 0) {
+    return std::nullopt;
+  }
+
+  // Find the first occupied slot after the current one, wrapping around to the
+  // current slot itself, which then holds timers for the next rotation.
+  const size_t shift = kSlotBits * level;
+  const Tick base = now_ >> shift;
+  const size_t start = size_t(base + 1) & (kSlots - 1);
+  const uint64_t rotated =
+      start == 0 ? occupied : (occupied >> start) | (occupied << (64 - start));
+  const Tick distance = Tick(__builtin_ctzll(rotated)) + 1;
+  return (base + distance) << shift;
+}
+
+std::optional<TimerWheel::Tick> TimerWheel::NextSlotTick() const {
+  std::optional<Tick> next;
+  for (size_t level = 0; level < kLevels; ++level) {
+    const std::optional<Tick> tick = NextSlotTick(level);
+    if (tick.has_value() && (!next.has_value() || tick < next)) {
+      next = tick;
+    }
+  }
+  return next;
+}
+
+}  // namespace pw::chrono
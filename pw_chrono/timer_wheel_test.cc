@@ -0,0 +1,160 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_chrono/timer_wheel.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace pw::chrono {
+namespace {
+
+using Tick = TimerWheel::Tick;
+
+struct TestTimer : public TimerWheel::Timer {
+  int id = 0;
+};
+
+TEST(TimerWheel, Advance_ExpiresTimerAtDeadline) {
+  TimerWheel wheel;
+  TestTimer timer;
+  wheel.Schedule(timer, 100);
+  EXPECT_TRUE(timer.scheduled());
+  EXPECT_EQ(1u, wheel.size());
+
+  EXPECT_EQ(0u, wheel.Advance(99));
+  EXPECT_EQ(nullptr, wheel.PopExpired());
+  EXPECT_EQ(1u, wheel.Advance(100));
+  EXPECT_EQ(&timer, wheel.PopExpired());
+  EXPECT_FALSE(timer.scheduled());
+  EXPECT_EQ(0u, wheel.size());
+  EXPECT_EQ(nullptr, wheel.PopExpired());
+}
+
+TEST(TimerWheel, Schedule_PastDeadlineExpiresImmediately) {
+  TimerWheel wheel(50);
+  TestTimer timer;
+  wheel.Schedule(timer, 50);
+  EXPECT_TRUE(wheel.has_expired());
+  EXPECT_EQ(50u, wheel.NextEventTick());
+  EXPECT_EQ(&timer, wheel.PopExpired());
+}
+
+TEST(TimerWheel, Cancel_RemovesTimer) {
+  TimerWheel wheel;
+  TestTimer first;
+  TestTimer second;
+  wheel.Schedule(first, 10);
+  wheel.Schedule(second, 5000);
+
+  EXPECT_TRUE(wheel.Cancel(second));
+  EXPECT_FALSE(wheel.Cancel(second));
+  EXPECT_EQ(1u, wheel.size());
+  EXPECT_EQ(1u, wheel.Advance(10000));
+
+  EXPECT_TRUE(wheel.Cancel(first));
+  EXPECT_FALSE(wheel.has_expired());
+  EXPECT_EQ(0u, wheel.size());
+  EXPECT_EQ(std::nullopt, wheel.NextEventTick());
+}
+
+TEST(TimerWheel, Schedule_ReschedulesTimer) {
+  TimerWheel wheel;
+  TestTimer timer;
+  wheel.Schedule(timer, 10);
+  wheel.Schedule(timer, 300000);
+  EXPECT_EQ(1u, wheel.size());
+
+  EXPECT_EQ(0u, wheel.Advance(299999));
+  EXPECT_EQ(1u, wheel.Advance(300000));
+  EXPECT_EQ(&timer, wheel.PopExpired());
+}
+
+TEST(TimerWheel, NextEventTick_ReachesDeadlineInFewSteps) {
+  TimerWheel wheel(7);
+  TestTimer timer;
+  constexpr Tick kDeadline = 123456789;
+  wheel.Schedule(timer, kDeadline);
+
+  int steps = 0;
+  while (!wheel.has_expired()) {
+    const std::optional<Tick> next = wheel.NextEventTick();
+    ASSERT_TRUE(next.has_value());
+    ASSERT_LE(next.value(), kDeadline);
+    wheel.Advance(next.value());
+    steps += 1;
+  }
+  EXPECT_EQ(kDeadline, wheel.now());
+  EXPECT_LE(steps, 16);
+}
+
+// Compares the wheel with the deadlines of many timers, scheduled across all
+// levels, while the wheel advances in uneven steps.
+TEST(TimerWheel, Advance_ManyTimersExpireInOrder) {
+  TimerWheel wheel(1000);
+  std::array<TestTimer, 200> timers;
+
+  uint32_t random = 1;
+  const auto next_random = [&random]() {
+    random = random * 1103515245u + 12345u;
+    return random >> 4;
+  };
+
+  for (size_t i = 0; i < timers.size(); ++i) {
+    timers[i].id = int(i);
+    const Tick range = Tick(1) << (4 * (i % 7) + 2);
+    wheel.Schedule(timers[i], wheel.now() + 1 + next_random() % range);
+  }
+  ASSERT_EQ(timers.size(), wheel.size());
+
+  size_t popped = 0;
+  Tick last_deadline = 0;
+  while (popped < timers.size()) {
+    const Tick now = wheel.now() + 1 + next_random() % 50000;
+    const size_t expired = wheel.Advance(now);
+
+    size_t count = 0;
+    while (TimerWheel::Timer* timer = wheel.PopExpired()) {
+      EXPECT_LE(timer->deadline(), now);
+      EXPECT_GE(timer->deadline(), last_deadline);
+      last_deadline = timer->deadline();
+      count += 1;
+    }
+    EXPECT_EQ(expired, count);
+    popped += count;
+
+    for (const TestTimer& timer : timers) {
+      EXPECT_EQ(timer.deadline() > now, timer.scheduled());
+    }
+  }
+  EXPECT_EQ(0u, wheel.size());
+}
+
+TEST(TimerWheel, Advance_ParksTimersBeyondTopLevel) {
+  TimerWheel wheel;
+  TestTimer timer;
+  constexpr Tick kDeadline = Tick(1) << 40;
+  wheel.Schedule(timer, kDeadline);
+
+  EXPECT_EQ(0u, wheel.Advance(kDeadline - 1));
+  EXPECT_TRUE(timer.scheduled());
+  EXPECT_EQ(1u, wheel.Advance(kDeadline));
+  EXPECT_EQ(&timer, wheel.PopExpired());
+}
+
+}  // namespace
+}  // namespace pw::chrono
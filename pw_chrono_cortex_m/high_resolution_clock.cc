@@ -0,0 +1,64 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_chrono/high_resolution_clock.h"
+
+#include <cstdint>
+
+#include "pw_chrono/counter_extender.h"
+
+namespace pw::chrono::backend {
+namespace {
+
+// Memory mapped registers. (ARMv7-M Sections C1.6.5 and C1.8.7)
+volatile uint32_t& cortex_m_demcr =
+    *reinterpret_cast<volatile uint32_t*>(0xE000EDFCu);
+volatile uint32_t& cortex_m_dwt_ctrl =
+    *reinterpret_cast<volatile uint32_t*>(0xE0001000u);
+volatile uint32_t& cortex_m_dwt_cyccnt =
+    *reinterpret_cast<volatile uint32_t*>(0xE0001004u);
+
+constexpr uint32_t kDemcrTraceEnable = 0x1u << 24;  // TRCENA
+constexpr uint32_t kDwtCtrlCycleCountEnable = 0x1u;  // CYCCNTENA
+
+CounterExtender cycle_count;
+
+}  // namespace
+
+// The DWT cycle counter is only 32 bits, which wraps in under a minute at
+// typical clock rates, so it is extended to 64 bits. now() must be called at
+// least once per wrap, such as from a periodic tick, or time will be lost.
+int64_t GetHighResolutionClockTickCount() {
+  uint32_t primask;
+  asm volatile(
+      "mrs %0, primask\n"
+      "cpsid i"
+      : "=r"(primask)
+      :
+      : "memory");
+
+  // The counter is enabled on first use, so no initialization is needed. A
+  // debugger may also have enabled it.
+  if ((cortex_m_dwt_ctrl & kDwtCtrlCycleCountEnable) == 0) {
+    cortex_m_demcr |= kDemcrTraceEnable;
+    cortex_m_dwt_cyccnt = 0;
+    cortex_m_dwt_ctrl |= kDwtCtrlCycleCountEnable;
+  }
+  const uint64_t count = cycle_count.Update(cortex_m_dwt_cyccnt);
+
+  asm volatile("msr primask, %0" : : "r"(primask) : "memory");
+  return static_cast<int64_t>(count);
+}
+
+}  // namespace pw::chrono::backend
@@ -0,0 +1,23 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// The frequency of the CPU clock, which the DWT cycle counter counts, in Hz.
+// This must be set to the target's core clock frequency.
+#ifndef PW_CHRONO_CORTEX_M_CFG_CPU_CLOCK_HZ
+#error "PW_CHRONO_CORTEX_M_CFG_CPU_CLOCK_HZ must be set to the core clock rate"
+#endif  // PW_CHRONO_CORTEX_M_CFG_CPU_CLOCK_HZ
+
+static_assert(PW_CHRONO_CORTEX_M_CFG_CPU_CLOCK_HZ > 0,
+              "Invalid CPU clock frequency configuration");
@@ -0,0 +1,29 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_chrono_cortex_m/config.h"
+
+// The clock counts CPU cycles.
+#define PW_CHRONO_HIGH_RESOLUTION_CLOCK_PERIOD_SECONDS_NUMERATOR 1
+#define PW_CHRONO_HIGH_RESOLUTION_CLOCK_PERIOD_SECONDS_DENOMINATOR \
+  PW_CHRONO_CORTEX_M_CFG_CPU_CLOCK_HZ
+
+namespace pw::chrono::backend {
+
+// The 64-bit count is extended with interrupts masked, which does not mask
+// NMIs.
+constexpr inline bool kHighResolutionClockNmiSafe = false;
+
+}  // namespace pw::chrono::backend
@@ -0,0 +1,36 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "FreeRTOS.h"
+#include "pw_chrono/system_clock.h"
+#include "timers.h"
+
+namespace pw::chrono::backend {
+
+struct NativeSystemTimer {
+  StaticTimer_t tcb;
+  TimerHandle_t handle;
+  void (*callback)(SystemClock::time_point expired_deadline, void* arg);
+  void* arg;
+  SystemClock::time_point expiry_deadline;
+
+  // Cleared by Cancel(), since an expiry may already be queued for the timer
+  // service task when the timer is stopped.
+  bool enabled;
+};
+
+using NativeSystemTimerHandle = TimerHandle_t;
+
+}  // namespace pw::chrono::backend
@@ -0,0 +1,141 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_chrono/system_timer.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "FreeRTOS.h"
+#include "pw_assert/assert.h"
+#include "pw_chrono_freertos/system_clock_constants.h"
+#include "task.h"
+#include "timers.h"
+
+static_assert(configUSE_TIMERS == 1,
+              "The FreeRTOS pw::chrono::SystemTimer backend requires timers");
+static_assert(configSUPPORT_STATIC_ALLOCATION == 1,
+              "The FreeRTOS pw::chrono::SystemTimer backend creates timers "
+              "with xTimerCreateStatic");
+static_assert(INCLUDE_xTimerPendFunctionCall == 1,
+              "The FreeRTOS pw::chrono::SystemTimer backend requires "
+              "xTimerPendFunctionCall");
+
+namespace pw::chrono {
+namespace {
+
+bool InTimerServiceTask() {
+  return xTaskGetCurrentTaskHandle() == xTimerGetTimerDaemonTaskHandle();
+}
+
+// The timer service task empties the timer command queue, so it must not block
+// on it, such as when a callback schedules its timer again.
+TickType_t CommandBlockTime() {
+  return InTimerServiceTask() ? 0 : portMAX_DELAY;
+}
+
+// Deadlines further away than kMaxTimeout take several timer periods.
+void StartTimer(backend::NativeSystemTimer& native,
+                SystemClock::duration remaining) {
+  const SystemClock::duration period =
+      std::clamp(remaining, SystemClock::duration(1), freertos::kMaxTimeout);
+  PW_CHECK_INT_EQ(xTimerChangePeriod(native.handle,
+                                     static_cast<TickType_t>(period.count()),
+                                     CommandBlockTime()),
+                  pdPASS,
+                  "Increase configTIMER_QUEUE_LENGTH");
+}
+
+void HandleTimerCallback(TimerHandle_t handle) {
+  auto& native =
+      *static_cast<backend::NativeSystemTimer*>(pvTimerGetTimerID(handle));
+
+  // Suspend the scheduler so that InvokeAt() and Cancel() cannot run between
+  // checking the deadline and restarting the timer.
+  vTaskSuspendAll();
+  if (!native.enabled) {
+    xTaskResumeAll();
+    return;
+  }
+  const SystemClock::time_point now = SystemClock::now();
+  if (now < native.expiry_deadline) {
+    StartTimer(native, native.expiry_deadline - now);
+    xTaskResumeAll();
+    return;
+  }
+  native.enabled = false;
+  const SystemClock::time_point deadline = native.expiry_deadline;
+  xTaskResumeAll();
+
+  native.callback(deadline, native.arg);
+}
+
+void SignalDeleted(void* deleted, uint32_t) {
+  static_cast<std::atomic<bool>*>(deleted)->store(true);
+}
+
+}  // namespace
+
+SystemTimer::SystemTimer(ExpiryCallback callback, void* arg) {
+  native_type_.callback = callback;
+  native_type_.arg = arg;
+  native_type_.enabled = false;
+  // The period is replaced whenever the timer is started.
+  native_type_.handle = xTimerCreateStatic("",
+                                           1,
+                                           pdFALSE,  // One shot.
+                                           &native_type_,
+                                           HandleTimerCallback,
+                                           &native_type_.tcb);
+  PW_CHECK_NOTNULL(native_type_.handle);
+}
+
+SystemTimer::~SystemTimer() {
+  PW_DCHECK(!InTimerServiceTask(),
+            "A SystemTimer must not be destroyed by a timer callback");
+  Cancel();
+  PW_CHECK_INT_EQ(xTimerDelete(native_type_.handle, portMAX_DELAY), pdPASS);
+
+  // The timer service task uses the timer's storage until it processes the
+  // delete command. Commands are processed in order, so once a later pended
+  // call runs, the storage is free.
+  std::atomic<bool> deleted = false;
+  PW_CHECK_INT_EQ(
+      xTimerPendFunctionCall(SignalDeleted, &deleted, 0, portMAX_DELAY),
+      pdPASS);
+  while (!deleted.load()) {
+    vTaskDelay(1);
+  }
+}
+
+void SystemTimer::InvokeAt(SystemClock::time_point timestamp) {
+  vTaskSuspendAll();
+  native_type_.expiry_deadline = timestamp;
+  native_type_.enabled = true;
+  xTaskResumeAll();
+
+  StartTimer(native_type_, timestamp - SystemClock::now());
+}
+
+void SystemTimer::Cancel() {
+  vTaskSuspendAll();
+  native_type_.enabled = false;
+  xTaskResumeAll();
+
+  PW_CHECK_INT_EQ(xTimerStop(native_type_.handle, CommandBlockTime()),
+                  pdPASS,
+                  "Increase configTIMER_QUEUE_LENGTH");
+}
+
+}  // namespace pw::chrono
@@ -0,0 +1,30 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_chrono/system_clock.h"
+#include "pw_chrono/timer_wheel.h"
+
+namespace pw::chrono::backend {
+
+// STL timers share a TimerWheel, which one thread drives.
+struct NativeSystemTimer : public TimerWheel::Timer {
+  void (*callback)(SystemClock::time_point expired_deadline, void* arg);
+  void* arg;
+  SystemClock::time_point expiry_deadline;
+};
+
+using NativeSystemTimerHandle = NativeSystemTimer&;
+
+}  // namespace pw::chrono::backend
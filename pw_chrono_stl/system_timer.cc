@@ -0,0 +1,126 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_chrono/system_timer.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "pw_chrono/timer_wheel.h"
+
+namespace pw::chrono {
+namespace {
+
+// Deadlines are rounded up to the wheel's resolution.
+constexpr SystemClock::duration kWheelTickPeriod =
+    std::chrono::duration_cast<SystemClock::duration>(
+        std::chrono::milliseconds(1));
+
+// Runs the expiry callbacks of every SystemTimer on a single thread.
+class TimerService {
+ public:
+  static TimerService& Instance() {
+    // The service is never destroyed, since its thread runs until the process
+    // exits.
+    static TimerService* const service = new TimerService();
+    return *service;
+  }
+
+  void Schedule(backend::NativeSystemTimer& timer,
+                SystemClock::time_point deadline) {
+    std::lock_guard lock(mutex_);
+    timer.expiry_deadline = deadline;
+    wheel_.Schedule(timer, RoundUpToTick(deadline));
+    wake_.notify_one();
+  }
+
+  void Cancel(backend::NativeSystemTimer& timer) {
+    std::lock_guard lock(mutex_);
+    wheel_.Cancel(timer);
+  }
+
+ private:
+  TimerService()
+      : start_(SystemClock::now()),
+        thread_([this] { Run(); }) {
+    thread_.detach();
+  }
+
+  TimerWheel::Tick RoundUpToTick(SystemClock::time_point time) const {
+    if (time <= start_) {
+      return 0;
+    }
+    return TimerWheel::Tick((time - start_ + kWheelTickPeriod -
+                             SystemClock::duration(1)) /
+                            kWheelTickPeriod);
+  }
+
+  TimerWheel::Tick RoundDownToTick(SystemClock::time_point time) const {
+    return time <= start_ ? 0 : TimerWheel::Tick((time - start_) /
+                                                 kWheelTickPeriod);
+  }
+
+  void Run() {
+    std::unique_lock lock(mutex_);
+    while (true) {
+      wheel_.Advance(RoundDownToTick(SystemClock::now()));
+
+      // Release the lock for each callback, so callbacks may schedule timers.
+      while (TimerWheel::Timer* expired = wheel_.PopExpired()) {
+        auto& timer = static_cast<backend::NativeSystemTimer&>(*expired);
+        const auto callback = timer.callback;
+        void* const arg = timer.arg;
+        const SystemClock::time_point deadline = timer.expiry_deadline;
+        lock.unlock();
+        callback(deadline, arg);
+        lock.lock();
+      }
+
+      const std::optional<TimerWheel::Tick> next = wheel_.NextEventTick();
+      if (next.has_value()) {
+        wake_.wait_for(lock,
+                       start_ + next.value() * kWheelTickPeriod -
+                           SystemClock::now());
+      } else {
+        wake_.wait(lock);
+      }
+    }
+  }
+
+  const SystemClock::time_point start_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  TimerWheel wheel_;
+  std::thread thread_;
+};
+
+}  // namespace
+
+SystemTimer::SystemTimer(ExpiryCallback callback, void* arg) {
+  native_type_.callback = callback;
+  native_type_.arg = arg;
+}
+
+SystemTimer::~SystemTimer() { Cancel(); }
+
+void SystemTimer::InvokeAt(SystemClock::time_point timestamp) {
+  TimerService::Instance().Schedule(native_type_, timestamp);
+}
+
+void SystemTimer::Cancel() { TimerService::Instance().Cancel(native_type_); }
+
+}  // namespace pw::chrono
@@ -0,0 +1,34 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_chrono/system_clock.h"
+#include "tx_api.h"
+
+namespace pw::chrono::backend {
+
+struct NativeSystemTimer {
+  TX_TIMER tcb;
+  void (*callback)(SystemClock::time_point expired_deadline, void* arg);
+  void* arg;
+  SystemClock::time_point expiry_deadline;
+
+  // Cleared by Cancel(), since the timer thread may already have taken an
+  // expired timer off the timer list when it is deactivated.
+  bool enabled;
+};
+
+using NativeSystemTimerHandle = TX_TIMER&;
+
+}  // namespace pw::chrono::backend
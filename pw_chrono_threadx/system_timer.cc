@@ -0,0 +1,109 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_chrono/system_timer.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "pw_assert/assert.h"
+#include "pw_chrono_threadx/system_clock_constants.h"
+#include "pw_sync/spin_lock.h"
+#include "tx_api.h"
+
+static_assert(sizeof(ULONG) >= sizeof(void*),
+              "The ThreadX pw::chrono::SystemTimer backend passes a pointer as "
+              "the timer's ULONG expiration input");
+
+namespace pw::chrono {
+namespace {
+
+// Guards the deadlines and enabled flags of all timers against the timer
+// thread.
+sync::SpinLock timer_spin_lock;
+
+// Deadlines further away than kMaxTimeout take several timer periods. The timer
+// must be inactive.
+void StartTimer(backend::NativeSystemTimer& native,
+                SystemClock::duration remaining) {
+  const SystemClock::duration ticks =
+      std::clamp(remaining, SystemClock::duration(1), threadx::kMaxTimeout);
+  PW_CHECK_UINT_EQ(
+      TX_SUCCESS,
+      tx_timer_change(&native.tcb, static_cast<ULONG>(ticks.count()), 0));
+  PW_CHECK_UINT_EQ(TX_SUCCESS, tx_timer_activate(&native.tcb));
+}
+
+void HandleTimerCallback(ULONG void_native_ptr) {
+  auto& native =
+      *reinterpret_cast<backend::NativeSystemTimer*>(void_native_ptr);
+  const SystemClock::time_point now = SystemClock::now();
+
+  timer_spin_lock.lock();
+  if (!native.enabled) {
+    timer_spin_lock.unlock();
+    return;
+  }
+  if (now < native.expiry_deadline) {
+    StartTimer(native, native.expiry_deadline - now);
+    timer_spin_lock.unlock();
+    return;
+  }
+  native.enabled = false;
+  const SystemClock::time_point deadline = native.expiry_deadline;
+  timer_spin_lock.unlock();
+
+  native.callback(deadline, native.arg);
+}
+
+}  // namespace
+
+SystemTimer::SystemTimer(ExpiryCallback callback, void* arg) {
+  native_type_.callback = callback;
+  native_type_.arg = arg;
+  native_type_.enabled = false;
+  // The expiration is replaced whenever the timer is started, but must not be
+  // 0.
+  PW_CHECK_UINT_EQ(TX_SUCCESS,
+                   tx_timer_create(&native_type_.tcb,
+                                   const_cast<CHAR*>(""),
+                                   HandleTimerCallback,
+                                   reinterpret_cast<ULONG>(&native_type_),
+                                   1,
+                                   0,  // One shot.
+                                   TX_NO_ACTIVATE));
+}
+
+SystemTimer::~SystemTimer() {
+  Cancel();
+  PW_CHECK_UINT_EQ(TX_SUCCESS, tx_timer_delete(&native_type_.tcb));
+}
+
+void SystemTimer::InvokeAt(SystemClock::time_point timestamp) {
+  const SystemClock::time_point now = SystemClock::now();
+
+  std::lock_guard lock(timer_spin_lock);
+  native_type_.expiry_deadline = timestamp;
+  native_type_.enabled = true;
+  PW_CHECK_UINT_EQ(TX_SUCCESS, tx_timer_deactivate(&native_type_.tcb));
+  StartTimer(native_type_, timestamp - now);
+}
+
+void SystemTimer::Cancel() {
+  std::lock_guard lock(timer_spin_lock);
+  native_type_.enabled = false;
+  PW_CHECK_UINT_EQ(TX_SUCCESS, tx_timer_deactivate(&native_type_.tcb));
+}
+
+}  // namespace pw::chrono
@@ -0,0 +1,143 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/bit_set.h"
+
+#include <cstddef>
+#include <iterator>
+
+#include "gtest/gtest.h"
+
+namespace pw {
+namespace {
+
+constexpr BitSet<40> kConstexprBits = BitSet<40>().set(3).set(39);
+static_assert(kConstexprBits.test(3) && kConstexprBits[39]);
+static_assert(!kConstexprBits.test(4));
+static_assert(BitSet<40>::kWords == 2u);
+
+TEST(BitSet, Construct_Empty) {
+  BitSet<70> bits;
+  EXPECT_EQ(70u, bits.size());
+  EXPECT_EQ(0u, bits.count());
+  EXPECT_TRUE(bits.none());
+  EXPECT_FALSE(bits.any());
+  EXPECT_FALSE(bits.all());
+  EXPECT_EQ(bits.end(), bits.begin());
+}
+
+TEST(BitSet, SetResetFlip) {
+  BitSet<70> bits;
+  bits.set(0).set(33).set(69);
+  EXPECT_TRUE(bits.test(0));
+  EXPECT_TRUE(bits.test(33));
+  EXPECT_TRUE(bits.test(69));
+  EXPECT_EQ(3u, bits.count());
+
+  bits.reset(33);
+  EXPECT_FALSE(bits.test(33));
+  bits.flip(33).flip(0);
+  EXPECT_TRUE(bits.test(33));
+  EXPECT_FALSE(bits.test(0));
+  bits.set(1, true).set(69, false);
+  EXPECT_TRUE(bits.test(1));
+  EXPECT_FALSE(bits.test(69));
+}
+
+TEST(BitSet, SetAll_KeepsUnusedBitsClear) {
+  BitSet<70> bits;
+  bits.set();
+  EXPECT_TRUE(bits.all());
+  EXPECT_EQ(70u, bits.count());
+  EXPECT_EQ(0x3fu, bits.words()[2]);
+
+  bits.flip();
+  EXPECT_TRUE(bits.none());
+  bits.flip();
+  EXPECT_EQ(70u, bits.count());
+
+  bits.reset();
+  EXPECT_TRUE(bits.none());
+}
+
+TEST(BitSet, All_ExactWords) {
+  BitSet<64> bits;
+  bits.set();
+  EXPECT_TRUE(bits.all());
+  bits.reset(63);
+  EXPECT_FALSE(bits.all());
+}
+
+TEST(BitSet, FindSet) {
+  BitSet<100> bits;
+  EXPECT_EQ(BitSet<100>::kNotFound, bits.FindFirstSet());
+  EXPECT_EQ(BitSet<100>::kNotFound, bits.FindLastSet());
+
+  bits.set(5).set(31).set(32).set(99);
+  EXPECT_EQ(5u, bits.FindFirstSet());
+  EXPECT_EQ(5u, bits.FindNextSet(5));
+  EXPECT_EQ(31u, bits.FindNextSet(6));
+  EXPECT_EQ(32u, bits.FindNextSet(32));
+  EXPECT_EQ(99u, bits.FindNextSet(33));
+  EXPECT_EQ(BitSet<100>::kNotFound, bits.FindNextSet(100));
+  EXPECT_EQ(99u, bits.FindLastSet());
+
+  bits.reset(99);
+  EXPECT_EQ(32u, bits.FindLastSet());
+  EXPECT_EQ(BitSet<100>::kNotFound, bits.FindNextSet(33));
+}
+
+TEST(BitSet, FindClear) {
+  BitSet<40> bits;
+  EXPECT_EQ(0u, bits.FindFirstClear());
+
+  bits.set();
+  EXPECT_EQ(BitSet<40>::kNotFound, bits.FindFirstClear());
+
+  bits.reset(35);
+  bits.reset(7);
+  EXPECT_EQ(7u, bits.FindFirstClear());
+  EXPECT_EQ(35u, bits.FindNextClear(8));
+  EXPECT_EQ(BitSet<40>::kNotFound, bits.FindNextClear(36));
+}
+
+TEST(BitSet, Iterate_SetBits) {
+  BitSet<96> bits;
+  bits.set(0).set(1).set(40).set(64).set(95);
+
+  size_t expected[] = {0, 1, 40, 64, 95};
+  size_t i = 0;
+  for (size_t bit : bits) {
+    ASSERT_LT(i, std::size(expected));
+    EXPECT_EQ(expected[i], bit);
+    i += 1;
+  }
+  EXPECT_EQ(std::size(expected), i);
+}
+
+TEST(BitSet, WordOperations) {
+  BitSet<40> a;
+  BitSet<40> b;
+  a.set(1).set(2).set(35);
+  b.set(2).set(3).set(35);
+
+  EXPECT_EQ(BitSet<40>().set(2).set(35), a & b);
+  EXPECT_EQ(BitSet<40>().set(1).set(2).set(3).set(35), a | b);
+  EXPECT_EQ(BitSet<40>().set(1).set(3), a ^ b);
+  EXPECT_EQ(37u, (~a).count());
+  EXPECT_NE(a, b);
+}
+
+}  // namespace
+}  // namespace pw
@@ -0,0 +1,260 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/hash_map.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace pw::containers {
+namespace {
+
+static_assert(hash_map_impl::SlotCount(0) == 2);
+static_assert(hash_map_impl::SlotCount(3) == 4);
+static_assert(hash_map_impl::SlotCount(4) == 8);
+static_assert(hash_map_impl::SlotCount(12) == 16);
+static_assert(hash_map_impl::SlotCount(13) == 32);
+
+struct Counter {
+  static int created;
+  static int destroyed;
+
+  static void Reset() { created = destroyed = 0; }
+
+  Counter(int val = 0) : value(val) { created += 1; }
+  Counter(const Counter& other) : value(other.value) { created += 1; }
+  Counter(Counter&& other) : value(other.value) {
+    other.value = 0;
+    created += 1;
+  }
+  Counter& operator=(const Counter&) = default;
+  ~Counter() { destroyed += 1; }
+
+  int value;
+};
+
+int Counter::created = 0;
+int Counter::destroyed = 0;
+
+// Hashes every key to the same value, so all keys share one probe sequence.
+struct CollidingHash {
+  size_t operator()(int) const { return 0; }
+};
+
+TEST(HashMap, Construct_Empty) {
+  HashMap<int, int, 8> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_FALSE(map.full());
+  EXPECT_EQ(0u, map.size());
+  EXPECT_EQ(8u, map.max_size());
+  EXPECT_EQ(map.begin(), map.end());
+}
+
+TEST(HashMap, Construct_InitializerList) {
+  HashMap<int, char, 4> map = {{1, 'a'}, {2, 'b'}, {3, 'c'}};
+  EXPECT_EQ(3u, map.size());
+  EXPECT_EQ('a', map.find(1)->second);
+  EXPECT_EQ('b', map.find(2)->second);
+  EXPECT_EQ('c', map.find(3)->second);
+}
+
+TEST(HashMap, Construct_InitializerListLargerThanCapacity) {
+  HashMap<int, char, 2> map = {{1, 'a'}, {2, 'b'}, {3, 'c'}};
+  EXPECT_TRUE(map.full());
+  EXPECT_TRUE(map.contains(1));
+  EXPECT_TRUE(map.contains(2));
+  EXPECT_FALSE(map.contains(3));
+}
+
+TEST(HashMap, Insert_NewAndExistingKeys) {
+  HashMap<int, int, 4> map;
+  auto [it, inserted] = map.insert({5, 50});
+  EXPECT_TRUE(inserted);
+  EXPECT_EQ(5, it->first);
+  EXPECT_EQ(50, it->second);
+
+  auto result = map.insert({5, 55});
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(it, result.first);
+  EXPECT_EQ(50, result.first->second);
+  EXPECT_EQ(1u, map.size());
+}
+
+TEST(HashMap, Insert_FailsWhenFull) {
+  HashMap<int, int, 3> map = {{1, 1}, {2, 2}, {3, 3}};
+  ASSERT_TRUE(map.full());
+
+  auto result = map.insert({4, 4});
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(map.end(), result.first);
+  EXPECT_EQ(3u, map.size());
+
+  // Existing keys are still found when the map is full.
+  result = map.insert({2, 20});
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(2, result.first->second);
+}
+
+TEST(HashMap, TryEmplace_ConstructsValueInPlace) {
+  Counter::Reset();
+  {
+    HashMap<int, Counter, 4> map;
+    EXPECT_TRUE(map.try_emplace(1, 10).second);
+    EXPECT_FALSE(map.try_emplace(1, 20).second);
+    EXPECT_EQ(10, map.find(1)->second.value);
+    EXPECT_EQ(1, Counter::created);
+  }
+  EXPECT_EQ(Counter::created, Counter::destroyed);
+}
+
+TEST(HashMap, InsertOrAssign) {
+  HashMap<int, int, 2> map;
+  EXPECT_TRUE(map.insert_or_assign(1, 10).second);
+  EXPECT_FALSE(map.insert_or_assign(1, 11).second);
+  EXPECT_EQ(11, map.find(1)->second);
+
+  ASSERT_TRUE(map.insert_or_assign(2, 20).second);
+  auto result = map.insert_or_assign(3, 30);
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(map.end(), result.first);
+}
+
+TEST(HashMap, Find_MissingKey) {
+  HashMap<int, int, 4> map = {{1, 1}};
+  EXPECT_EQ(map.end(), map.find(2));
+  EXPECT_FALSE(map.contains(2));
+  EXPECT_EQ(0u, map.count(2));
+  EXPECT_EQ(1u, map.count(1));
+}
+
+TEST(HashMap, Erase_ByKey) {
+  HashMap<int, int, 4> map = {{1, 1}, {2, 2}};
+  EXPECT_EQ(1u, map.erase(1));
+  EXPECT_EQ(0u, map.erase(1));
+  EXPECT_FALSE(map.contains(1));
+  EXPECT_TRUE(map.contains(2));
+  EXPECT_EQ(1u, map.size());
+}
+
+TEST(HashMap, Erase_ByIterator) {
+  HashMap<int, int, 4> map = {{1, 1}, {2, 2}};
+  map.erase(map.find(2));
+  EXPECT_FALSE(map.contains(2));
+  EXPECT_EQ(1u, map.size());
+}
+
+TEST(HashMap, Erase_MakesRoomWhenFull) {
+  HashMap<int, int, 2> map = {{1, 1}, {2, 2}};
+  ASSERT_EQ(1u, map.erase(1));
+  EXPECT_TRUE(map.insert({3, 3}).second);
+  EXPECT_TRUE(map.full());
+}
+
+TEST(HashMap, Erase_ShiftsCollidingKeysBack) {
+  HashMap<int, int, 6, CollidingHash> map;
+  for (int i = 0; i < 6; ++i) {
+    ASSERT_TRUE(map.insert({i, i * 10}).second);
+  }
+
+  // Erasing keys from the middle of the shared probe sequence must not hide
+  // the keys after them.
+  ASSERT_EQ(1u, map.erase(2));
+  ASSERT_EQ(1u, map.erase(0));
+  for (int i : {1, 3, 4, 5}) {
+    ASSERT_NE(map.end(), map.find(i));
+    EXPECT_EQ(i * 10, map.find(i)->second);
+  }
+  EXPECT_FALSE(map.contains(0));
+  EXPECT_FALSE(map.contains(2));
+
+  EXPECT_TRUE(map.insert({2, 200}).second);
+  EXPECT_EQ(200, map.find(2)->second);
+}
+
+TEST(HashMap, InsertAndErase_ManyKeys) {
+  HashMap<uint32_t, uint32_t, 48> map;
+  for (uint32_t round = 0; round < 20; ++round) {
+    for (uint32_t i = 0; i < 48; ++i) {
+      ASSERT_TRUE(map.insert({round * 1000 + i * 64, i}).second);
+    }
+    ASSERT_TRUE(map.full());
+    for (uint32_t i = 0; i < 48; i += 2) {
+      ASSERT_EQ(1u, map.erase(round * 1000 + i * 64));
+    }
+    for (uint32_t i = 0; i < 48; ++i) {
+      EXPECT_EQ(i % 2u, map.count(round * 1000 + i * 64));
+    }
+    map.clear();
+  }
+}
+
+TEST(HashMap, Iterate_VisitsEachEntryOnce) {
+  HashMap<int, int, 8> map = {{1, 10}, {2, 20}, {3, 30}, {4, 40}};
+  int key_sum = 0;
+  int value_sum = 0;
+  for (const auto& [key, value] : map) {
+    key_sum += key;
+    value_sum += value;
+  }
+  EXPECT_EQ(10, key_sum);
+  EXPECT_EQ(100, value_sum);
+
+  for (auto& item : map) {
+    item.second += 1;
+  }
+  EXPECT_EQ(41, map.find(4)->second);
+}
+
+TEST(HashMap, Clear_DestroysEntries) {
+  Counter::Reset();
+  HashMap<int, Counter, 4> map;
+  map.try_emplace(1, 1);
+  map.try_emplace(2, 2);
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(Counter::created, Counter::destroyed);
+}
+
+TEST(HashMap, Copy_BetweenCapacities) {
+  HashMap<int, int, 4> map = {{1, 10}, {2, 20}};
+  HashMap<int, int, 8> copy(map);
+  EXPECT_EQ(2u, copy.size());
+  EXPECT_EQ(20, copy.find(2)->second);
+
+  HashMap<int, int, 4> assigned;
+  assigned = map;
+  EXPECT_EQ(10, assigned.find(1)->second);
+  EXPECT_EQ(2u, map.size());
+}
+
+TEST(HashMap, Move_EmptiesSource) {
+  HashMap<int, int, 4> map = {{1, 10}, {2, 20}};
+  HashMap<int, int, 4> moved(std::move(map));
+  EXPECT_EQ(2u, moved.size());
+  EXPECT_EQ(10, moved.find(1)->second);
+  EXPECT_TRUE(map.empty());  // NOLINT(bugprone-use-after-move)
+}
+
+TEST(HashMap, GenericCapacity_UsableThroughBase) {
+  HashMap<int, int, 4> map;
+  HashMap<int, int>& generic = map;
+  EXPECT_TRUE(generic.insert({1, 10}).second);
+  EXPECT_EQ(4u, generic.max_size());
+  EXPECT_EQ(10, map.find(1)->second);
+}
+
+}  // namespace
+}  // namespace pw::containers
@@ -0,0 +1,181 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/inline_deque.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#include "gtest/gtest.h"
+
+namespace pw {
+namespace {
+
+static_assert(inline_deque_impl::SlotCount(1) == 1);
+static_assert(inline_deque_impl::SlotCount(5) == 8);
+static_assert(inline_deque_impl::SlotCount(8) == 8);
+
+struct Counter {
+  static int created;
+  static int destroyed;
+
+  static void Reset() { created = destroyed = 0; }
+
+  Counter(int val = 0) : value(val) { created += 1; }
+  Counter(const Counter& other) : value(other.value) { created += 1; }
+  Counter(Counter&& other) : value(other.value) {
+    other.value = 0;
+    created += 1;
+  }
+  ~Counter() { destroyed += 1; }
+
+  int value;
+};
+
+int Counter::created = 0;
+int Counter::destroyed = 0;
+
+template <typename Deque>
+void ExpectItems(const Deque& deque, std::initializer_list<int> expected) {
+  ASSERT_EQ(expected.size(), deque.size());
+  size_t index = 0;
+  for (int value : expected) {
+    EXPECT_EQ(value, deque[index]);
+    index += 1;
+  }
+  EXPECT_TRUE(std::equal(deque.begin(), deque.end(), expected.begin()));
+}
+
+TEST(InlineDeque, Construct_Empty) {
+  InlineDeque<int, 5> deque;
+  EXPECT_TRUE(deque.empty());
+  EXPECT_FALSE(deque.full());
+  EXPECT_EQ(0u, deque.size());
+  EXPECT_EQ(5u, deque.max_size());
+  EXPECT_EQ(deque.begin(), deque.end());
+}
+
+TEST(InlineDeque, Construct_InitializerList) {
+  InlineDeque<int, 4> deque = {1, 2, 3};
+  ExpectItems(deque, {1, 2, 3});
+  EXPECT_EQ(1, deque.front());
+  EXPECT_EQ(3, deque.back());
+}
+
+TEST(InlineDeque, PushBack_PopFront_WrapsAround) {
+  InlineDeque<int, 4> deque;
+  for (int i = 0; i < 100; ++i) {
+    deque.push_back(i);
+    if (deque.size() == 3u) {
+      EXPECT_EQ(i - 2, deque.front());
+      deque.pop_front();
+    }
+  }
+  ExpectItems(deque, {98, 99});
+}
+
+TEST(InlineDeque, PushFront_PopBack) {
+  InlineDeque<int, 3> deque;
+  deque.push_front(2);
+  deque.push_front(1);
+  deque.push_back(3);
+  ExpectItems(deque, {1, 2, 3});
+  EXPECT_TRUE(deque.full());
+
+  deque.pop_back();
+  ExpectItems(deque, {1, 2});
+  deque.pop_front();
+  deque.pop_front();
+  EXPECT_TRUE(deque.empty());
+}
+
+TEST(InlineDeque, Push_FullDoesNothing) {
+  InlineDeque<int, 3> deque = {1, 2, 3};
+  deque.push_back(4);
+  deque.push_front(0);
+  ExpectItems(deque, {1, 2, 3});
+}
+
+TEST(InlineDeque, Pop_EmptyDoesNothing) {
+  InlineDeque<int, 2> deque;
+  deque.pop_front();
+  deque.pop_back();
+  EXPECT_TRUE(deque.empty());
+}
+
+TEST(InlineDeque, Iterate_Backwards) {
+  InlineDeque<int, 4> deque;
+  deque.push_back(2);
+  deque.push_front(1);
+  deque.push_back(3);
+
+  int expected = 3;
+  for (auto it = deque.end(); it != deque.begin();) {
+    --it;
+    EXPECT_EQ(expected, *it);
+    expected -= 1;
+  }
+}
+
+TEST(InlineDeque, Modify_ThroughIterator) {
+  InlineDeque<int, 4> deque = {1, 2, 3};
+  for (int& item : deque) {
+    item *= 10;
+  }
+  ExpectItems(deque, {10, 20, 30});
+}
+
+TEST(InlineDeque, Destroy_DestroysItems) {
+  Counter::Reset();
+  {
+    InlineDeque<Counter, 4> deque;
+    deque.emplace_back(1);
+    deque.emplace_front(0);
+    deque.emplace_back(2);
+    deque.pop_front();
+    EXPECT_EQ(1, Counter::destroyed);
+  }
+  EXPECT_EQ(3, Counter::created);
+  EXPECT_EQ(3, Counter::destroyed);
+}
+
+TEST(InlineDeque, Copy) {
+  InlineDeque<int, 4> deque = {1, 2, 3};
+  InlineDeque<int, 8> copy(deque);
+  ExpectItems(copy, {1, 2, 3});
+
+  InlineDeque<int, 4> assigned;
+  assigned.push_back(9);
+  assigned = deque;
+  ExpectItems(assigned, {1, 2, 3});
+}
+
+TEST(InlineDeque, Move) {
+  InlineDeque<int, 4> deque = {1, 2, 3};
+  InlineDeque<int, 4> moved(std::move(deque));
+  ExpectItems(moved, {1, 2, 3});
+  EXPECT_TRUE(deque.empty());  // NOLINT(bugprone-use-after-move)
+}
+
+TEST(InlineDeque, Generic) {
+  InlineDeque<int, 4> deque;
+  InlineDeque<int>& generic = deque;
+  generic.push_back(1);
+  generic.push_front(0);
+  EXPECT_EQ(4u, generic.max_size());
+  ExpectItems(deque, {0, 1});
+}
+
+}  // namespace
+}  // namespace pw
@@ -0,0 +1,132 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/inline_function.h"
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace pw {
+namespace {
+
+int Multiply(int a, int b) { return a * b; }
+
+// Counts live instances to check that callables are destroyed exactly once.
+struct Counted {
+  static int alive;
+
+  Counted() { alive += 1; }
+  Counted(const Counted&) { alive += 1; }
+  Counted(Counted&&) { alive += 1; }
+  ~Counted() { alive -= 1; }
+
+  int operator()(int value) const { return value + 1; }
+};
+
+int Counted::alive = 0;
+
+TEST(InlineFunction, DefaultConstructed_IsEmpty) {
+  InlineFunction<void()> function;
+  EXPECT_FALSE(function);
+  EXPECT_TRUE(function == nullptr);
+
+  InlineFunction<void()> null_function = nullptr;
+  EXPECT_FALSE(null_function);
+}
+
+TEST(InlineFunction, FunctionPointer) {
+  InlineFunction<int(int, int)> function = Multiply;
+  ASSERT_TRUE(function);
+  EXPECT_EQ(12, function(3, 4));
+
+  int (*null_pointer)(int, int) = nullptr;
+  InlineFunction<int(int, int)> empty = null_pointer;
+  EXPECT_FALSE(empty);
+}
+
+TEST(InlineFunction, CapturingLambda) {
+  int total = 0;
+  int step = 5;
+  InlineFunction<void()> add = [&total, step]() { total += step; };
+
+  add();
+  add();
+  EXPECT_EQ(10, total);
+}
+
+TEST(InlineFunction, MutableLambda_KeepsState) {
+  InlineFunction<int()> counter = [count = 0]() mutable { return ++count; };
+  EXPECT_EQ(1, counter());
+  EXPECT_EQ(2, counter());
+  EXPECT_EQ(3, counter());
+}
+
+TEST(InlineFunction, LargerSize_HoldsLargerCaptures) {
+  uint32_t a = 1, b = 2, c = 3, d = 4, e = 5, f = 6;
+  InlineFunction<uint32_t(), 6 * sizeof(uint32_t)> sum = [a, b, c, d, e, f]() {
+    return a + b + c + d + e + f;
+  };
+  EXPECT_EQ(21u, sum());
+}
+
+TEST(InlineFunction, Move_TransfersCallable) {
+  int value = 0;
+  InlineFunction<void(int)> set = [&value](int new_value) {
+    value = new_value;
+  };
+
+  InlineFunction<void(int)> moved(std::move(set));
+  EXPECT_FALSE(set);  // NOLINT(bugprone-use-after-move)
+  ASSERT_TRUE(moved);
+  moved(7);
+  EXPECT_EQ(7, value);
+
+  InlineFunction<void(int)> assigned;
+  assigned = std::move(moved);
+  EXPECT_FALSE(moved);  // NOLINT(bugprone-use-after-move)
+  assigned(9);
+  EXPECT_EQ(9, value);
+}
+
+TEST(InlineFunction, NonTrivialCallable_DestroyedOnce) {
+  Counted::alive = 0;
+  {
+    InlineFunction<int(int)> function = Counted();
+    EXPECT_EQ(1, Counted::alive);
+    EXPECT_EQ(2, function(1));
+
+    InlineFunction<int(int)> moved = std::move(function);
+    EXPECT_EQ(1, Counted::alive);
+    EXPECT_EQ(3, moved(2));
+
+    moved = nullptr;
+    EXPECT_EQ(0, Counted::alive);
+
+    moved = Counted();
+    EXPECT_EQ(1, Counted::alive);
+  }
+  EXPECT_EQ(0, Counted::alive);
+}
+
+TEST(InlineFunction, AssignCallable_ReplacesPrevious) {
+  InlineFunction<int(int)> function = [](int value) { return value * 2; };
+  EXPECT_EQ(4, function(2));
+
+  function = [](int value) { return value * 3; };
+  EXPECT_EQ(6, function(2));
+}
+
+}  // namespace
+}  // namespace pw
@@ -0,0 +1,105 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/inline_queue.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace pw {
+namespace {
+
+struct Sample {
+  uint32_t timestamp;
+  int16_t value;
+};
+
+TEST(InlineQueue, PushAndPop_FirstInFirstOut) {
+  InlineQueue<Sample, 3> queue;
+  queue.push({1, 10});
+  queue.emplace(Sample{2, 20});
+  queue.push({3, 30});
+  EXPECT_TRUE(queue.full());
+
+  queue.push({4, 40});
+  EXPECT_EQ(3u, queue.size());
+
+  EXPECT_EQ(1u, queue.front().timestamp);
+  EXPECT_EQ(3u, queue.back().timestamp);
+  queue.pop();
+  EXPECT_EQ(2u, queue.front().timestamp);
+  queue.push({4, 40});
+  EXPECT_EQ(4u, queue.back().timestamp);
+
+  int16_t expected = 20;
+  for (const Sample& sample : queue) {
+    EXPECT_EQ(expected, sample.value);
+    expected += 10;
+  }
+}
+
+TEST(InlineQueue, Generic) {
+  InlineQueue<int, 2> queue = {1, 2};
+  InlineQueue<int>& generic = queue;
+  EXPECT_EQ(2u, generic.max_size());
+  generic.pop();
+  generic.push(3);
+  EXPECT_EQ(2, queue.front());
+  EXPECT_EQ(3, queue.back());
+}
+
+TEST(InlineQueue, Copy) {
+  InlineQueue<int, 4> queue = {1, 2};
+  InlineQueue<int, 4> copy(queue);
+  queue.pop();
+  EXPECT_EQ(2u, copy.size());
+  EXPECT_EQ(1, copy.front());
+}
+
+TEST(InlineSpscQueue, PushAndPop) {
+  InlineSpscQueue<Sample, 4> queue;
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(4u, queue.max_size());
+
+  Sample sample;
+  EXPECT_FALSE(queue.try_pop(sample));
+
+  for (uint32_t i = 0; i < 4; ++i) {
+    EXPECT_TRUE(queue.try_push({i, 0}));
+  }
+  EXPECT_FALSE(queue.try_push({4, 0}));
+  EXPECT_EQ(4u, queue.size());
+
+  for (uint32_t i = 0; i < 4; ++i) {
+    ASSERT_TRUE(queue.try_pop(sample));
+    EXPECT_EQ(i, sample.timestamp);
+  }
+  EXPECT_FALSE(queue.try_pop(sample));
+}
+
+TEST(InlineSpscQueue, WrapsAround) {
+  InlineSpscQueue<int, 2> queue;
+  int value = 0;
+  for (int i = 0; i < 50; ++i) {
+    ASSERT_TRUE(queue.try_push(i));
+    ASSERT_TRUE(queue.try_pop(value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_TRUE(queue.empty());
+}
+
+}  // namespace
+}  // namespace pw
@@ -0,0 +1,198 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/intrusive_doubly_linked_list.h"
+
+#include <array>
+#include <cstddef>
+
+#include "gtest/gtest.h"
+
+namespace pw {
+namespace {
+
+class TestItem : public IntrusiveDoublyLinkedList<TestItem>::Item {
+ public:
+  TestItem() : number_(0) {}
+  TestItem(int number) : number_(number) {}
+
+  int GetNumber() const { return number_; }
+
+ private:
+  int number_;
+};
+
+using List = IntrusiveDoublyLinkedList<TestItem>;
+
+// Checks the list's items in both directions.
+void ExpectItems(List& list, std::initializer_list<int> expected) {
+  ASSERT_EQ(expected.size(), list.size());
+
+  auto it = list.begin();
+  for (int number : expected) {
+    EXPECT_EQ(number, it->GetNumber());
+    ++it;
+  }
+  EXPECT_EQ(list.end(), it);
+
+  for (auto expected_it = std::rbegin(expected);
+       expected_it != std::rend(expected);
+       ++expected_it) {
+    --it;
+    EXPECT_EQ(*expected_it, it->GetNumber());
+  }
+  EXPECT_EQ(list.begin(), it);
+}
+
+TEST(IntrusiveDoublyLinkedList, Construct_Empty) {
+  List list;
+  EXPECT_TRUE(list.empty());
+  EXPECT_EQ(0u, list.size());
+  EXPECT_EQ(list.begin(), list.end());
+}
+
+TEST(IntrusiveDoublyLinkedList, PushFrontAndBack) {
+  std::array<TestItem, 3> items{{{0}, {1}, {2}}};
+  List list;
+  list.push_back(items[1]);
+  list.push_front(items[0]);
+  list.push_back(items[2]);
+
+  EXPECT_FALSE(list.empty());
+  EXPECT_EQ(&items[0], &list.front());
+  EXPECT_EQ(&items[2], &list.back());
+  ExpectItems(list, {0, 1, 2});
+  list.clear();
+}
+
+TEST(IntrusiveDoublyLinkedList, Insert) {
+  std::array<TestItem, 3> items{{{0}, {1}, {2}}};
+  List list;
+  list.push_back(items[2]);
+
+  EXPECT_EQ(&items[0], &*list.insert(list.begin(), items[0]));
+  list.insert(++list.begin(), items[1]);
+  ExpectItems(list, {0, 1, 2});
+  list.clear();
+}
+
+TEST(IntrusiveDoublyLinkedList, PopFrontAndBack) {
+  std::array<TestItem, 3> items{{{0}, {1}, {2}}};
+  List list;
+  for (TestItem& item : items) {
+    list.push_back(item);
+  }
+
+  list.pop_front();
+  ExpectItems(list, {1, 2});
+  list.pop_back();
+  ExpectItems(list, {1});
+  list.pop_back();
+  EXPECT_TRUE(list.empty());
+
+  // Popped items can be added again.
+  list.push_back(items[2]);
+  list.push_back(items[0]);
+  ExpectItems(list, {2, 0});
+  list.clear();
+}
+
+TEST(IntrusiveDoublyLinkedList, Erase_ReturnsNext) {
+  std::array<TestItem, 3> items{{{0}, {1}, {2}}};
+  List list;
+  for (TestItem& item : items) {
+    list.push_back(item);
+  }
+
+  auto it = list.erase(++list.begin());
+  EXPECT_EQ(2, it->GetNumber());
+  ExpectItems(list, {0, 2});
+
+  it = list.erase(it);
+  EXPECT_EQ(list.end(), it);
+  ExpectItems(list, {0});
+  list.clear();
+}
+
+TEST(IntrusiveDoublyLinkedList, Remove) {
+  std::array<TestItem, 4> items{{{0}, {1}, {2}, {3}}};
+  List list;
+  for (TestItem& item : items) {
+    list.push_back(item);
+  }
+
+  EXPECT_TRUE(list.remove(items[2]));
+  ExpectItems(list, {0, 1, 3});
+  EXPECT_FALSE(list.remove(items[2]));
+
+  EXPECT_TRUE(list.remove(items[0]));
+  EXPECT_TRUE(list.remove(items[3]));
+  ExpectItems(list, {1});
+  EXPECT_TRUE(list.remove(items[1]));
+  EXPECT_TRUE(list.empty());
+}
+
+TEST(IntrusiveDoublyLinkedList, Remove_NotInList) {
+  TestItem item(1);
+  List list;
+  EXPECT_FALSE(list.remove(item));
+}
+
+TEST(IntrusiveDoublyLinkedList, Clear_ItemsCanBeReinserted) {
+  std::array<TestItem, 2> items{{{0}, {1}}};
+  List list;
+  list.push_back(items[0]);
+  list.push_back(items[1]);
+  list.clear();
+  EXPECT_TRUE(list.empty());
+
+  List other;
+  other.push_back(items[1]);
+  other.push_back(items[0]);
+  ExpectItems(other, {1, 0});
+  other.clear();
+}
+
+TEST(IntrusiveDoublyLinkedList, ItemsRemoveThemselvesWhenDestructed) {
+  TestItem first(0);
+  List list;
+  list.push_back(first);
+  {
+    TestItem second(1);
+    list.push_back(second);
+    TestItem third(2);
+    list.push_back(third);
+    ExpectItems(list, {0, 1, 2});
+  }
+  ExpectItems(list, {0});
+  list.clear();
+}
+
+TEST(IntrusiveDoublyLinkedList, ConstIterator) {
+  std::array<TestItem, 2> items{{{3}, {4}}};
+  List list;
+  list.push_back(items[0]);
+  list.push_back(items[1]);
+
+  const List& const_list = list;
+  int sum = 0;
+  for (const TestItem& item : const_list) {
+    sum += item.GetNumber();
+  }
+  EXPECT_EQ(7, sum);
+  list.clear();
+}
+
+}  // namespace
+}  // namespace pw
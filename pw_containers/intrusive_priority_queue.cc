@@ -0,0 +1,154 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/intrusive_priority_queue.h"
+
+#include "pw_assert/assert.h"
+
+namespace pw::intrusive_priority_queue_impl {
+
+Heap::Item::~Item() {
+  PW_CHECK(!queued(),
+           "Items must be removed from a pw::IntrusivePriorityQueue before "
+           "they are destroyed");
+}
+
+void Heap::push(Item& item, Precedes precedes) {
+  PW_CHECK(!item.queued(),
+           "Cannot add an item to a pw::IntrusivePriorityQueue that is "
+           "already in a queue");
+  SetRoot(Meld(root_, &item, precedes));
+  size_ += 1;
+}
+
+void Heap::pop(Precedes precedes) {
+  Item* const old_root = root_;
+  SetRoot(MergePairs(old_root->child_, precedes));
+  old_root->Reset();
+  size_ -= 1;
+}
+
+bool Heap::remove(Item& item, Precedes precedes) {
+  if (!item.queued()) {
+    return false;
+  }
+  if (&item == root_) {
+    pop(precedes);
+    return true;
+  }
+
+  // Unlink the item's subtree from its parent or left sibling.
+  if (item.prev_->child_ == &item) {
+    item.prev_->child_ = item.next_;
+  } else {
+    item.prev_->next_ = item.next_;
+  }
+  if (item.next_ != nullptr) {
+    item.next_->prev_ = item.prev_;
+  }
+
+  // Merge the item's children back into the heap.
+  Item* const children = MergePairs(item.child_, precedes);
+  SetRoot(Meld(root_, children, precedes));
+  item.Reset();
+  size_ -= 1;
+  return true;
+}
+
+void Heap::clear() {
+  // Visit every item without recursion by splicing each item's children onto
+  // the list of items still to visit.
+  Item* pending = root_;
+  while (pending != nullptr) {
+    Item* const item = pending;
+    pending = item->next_;
+
+    if (Item* child = item->child_; child != nullptr) {
+      Item* last = child;
+      while (last->next_ != nullptr) {
+        last = last->next_;
+      }
+      last->next_ = pending;
+      pending = child;
+    }
+    item->Reset();
+  }
+  root_ = nullptr;
+  size_ = 0;
+}
+
+Heap::Item* Heap::Meld(Item* first, Item* second, Precedes precedes) {
+  if (first == nullptr) {
+    return second;
+  }
+  if (second == nullptr) {
+    return first;
+  }
+  if (precedes(*second, *first)) {
+    Item* const temp = first;
+    first = second;
+    second = temp;
+  }
+
+  // Make second the first child of first.
+  second->next_ = first->child_;
+  if (first->child_ != nullptr) {
+    first->child_->prev_ = second;
+  }
+  second->prev_ = first;
+  first->child_ = second;
+  return first;
+}
+
+Heap::Item* Heap::MergePairs(Item* first, Precedes precedes) {
+  // First pass: meld pairs from left to right, pushing each result onto a
+  // stack linked through next_.
+  Item* stack = nullptr;
+  while (first != nullptr) {
+    Item* const a = first;
+    Item* const b = a->next_;
+    if (b == nullptr) {
+      a->next_ = stack;
+      stack = a;
+      break;
+    }
+    first = b->next_;
+    a->next_ = nullptr;
+    b->next_ = nullptr;
+
+    Item* const pair = Meld(a, b, precedes);
+    pair->next_ = stack;
+    stack = pair;
+  }
+
+  // Second pass: meld the pairs from right to left.
+  Item* result = nullptr;
+  while (stack != nullptr) {
+    Item* const next = stack->next_;
+    stack->next_ = nullptr;
+    result = Meld(stack, result, precedes);
+    stack = next;
+  }
+  return result;
+}
+
+void Heap::SetRoot(Item* root) {
+  root_ = root;
+  if (root != nullptr) {
+    root->next_ = nullptr;
+    root->prev_ = root;
+  }
+}
+
+}  // namespace pw::intrusive_priority_queue_impl
@@ -0,0 +1,193 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/intrusive_priority_queue.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+
+#include "gtest/gtest.h"
+
+namespace pw {
+namespace {
+
+class TestItem : public IntrusivePriorityQueue<TestItem>::Item {
+ public:
+  TestItem() : TestItem(0) {}
+  TestItem(int priority) : priority_(priority) {}
+
+  bool operator<(const TestItem& other) const {
+    return priority_ < other.priority_;
+  }
+  bool operator>(const TestItem& other) const {
+    return priority_ > other.priority_;
+  }
+
+  int priority() const { return priority_; }
+  void set_priority(int priority) { priority_ = priority; }
+
+ private:
+  int priority_;
+};
+
+using Queue = IntrusivePriorityQueue<TestItem>;
+
+TEST(IntrusivePriorityQueue, Construct_Empty) {
+  Queue queue;
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(0u, queue.size());
+}
+
+TEST(IntrusivePriorityQueue, Push_TopIsLargest) {
+  std::array<TestItem, 5> items{{{5}, {3}, {9}, {1}, {4}}};
+  Queue queue;
+  for (TestItem& item : items) {
+    queue.push(item);
+  }
+  EXPECT_EQ(5u, queue.size());
+  EXPECT_EQ(&items[2], &queue.top());
+  queue.clear();
+}
+
+TEST(IntrusivePriorityQueue, Pop_InPriorityOrder) {
+  std::array<TestItem, 8> items{{{5}, {3}, {9}, {1}, {4}, {8}, {2}, {3}}};
+  Queue queue;
+  for (TestItem& item : items) {
+    queue.push(item);
+  }
+
+  for (int expected : {9, 8, 5, 4, 3, 3, 2, 1}) {
+    ASSERT_FALSE(queue.empty());
+    EXPECT_EQ(expected, queue.top().priority());
+    queue.pop();
+  }
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(IntrusivePriorityQueue, GreaterCompare_TopIsSmallest) {
+  class MinItem : public IntrusivePriorityQueue<MinItem, std::greater<>>::Item {
+   public:
+    MinItem(int value) : value(value) {}
+    bool operator>(const MinItem& other) const { return value > other.value; }
+    int value;
+  };
+
+  std::array<MinItem, 4> items{{{5}, {1}, {7}, {4}}};
+  IntrusivePriorityQueue<MinItem, std::greater<>> queue;
+  for (MinItem& item : items) {
+    queue.push(item);
+  }
+
+  for (int expected : {1, 4, 5, 7}) {
+    ASSERT_FALSE(queue.empty());
+    EXPECT_EQ(expected, queue.top().value);
+    queue.pop();
+  }
+  queue.clear();
+}
+
+TEST(IntrusivePriorityQueue, Remove_ArbitraryItems) {
+  std::array<TestItem, 6> items{{{6}, {1}, {5}, {2}, {4}, {3}}};
+  Queue queue;
+  for (TestItem& item : items) {
+    queue.push(item);
+  }
+  queue.pop();  // Restructure the heap so items have children.
+
+  EXPECT_TRUE(queue.remove(items[5]));  // 3
+  EXPECT_FALSE(queue.remove(items[5]));
+  EXPECT_TRUE(queue.remove(items[2]));  // 5, the top
+  EXPECT_FALSE(queue.remove(items[0]));  // Already popped.
+  EXPECT_EQ(3u, queue.size());
+
+  for (int expected : {4, 2, 1}) {
+    EXPECT_EQ(expected, queue.top().priority());
+    queue.pop();
+  }
+}
+
+TEST(IntrusivePriorityQueue, Update_MovesItem) {
+  std::array<TestItem, 3> items{{{1}, {2}, {3}}};
+  Queue queue;
+  for (TestItem& item : items) {
+    queue.push(item);
+  }
+
+  items[0].set_priority(10);
+  queue.update(items[0]);
+  EXPECT_EQ(&items[0], &queue.top());
+
+  items[0].set_priority(0);
+  queue.update(items[0]);
+  EXPECT_EQ(&items[2], &queue.top());
+  queue.clear();
+}
+
+TEST(IntrusivePriorityQueue, Clear_ItemsCanBeReused) {
+  std::array<TestItem, 4> items{{{4}, {3}, {2}, {1}}};
+  Queue queue;
+  for (TestItem& item : items) {
+    queue.push(item);
+  }
+  queue.pop();
+  queue.clear();
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(0u, queue.size());
+
+  Queue other;
+  for (TestItem& item : items) {
+    other.push(item);
+  }
+  EXPECT_EQ(4u, other.size());
+  EXPECT_EQ(4, other.top().priority());
+  other.clear();
+}
+
+TEST(IntrusivePriorityQueue, ManyOperations_MatchSortedOrder) {
+  constexpr size_t kItems = 64;
+  std::array<TestItem, kItems> items;
+  Queue queue;
+
+  uint32_t random = 1;
+  auto next_random = [&random]() {
+    random = random * 1103515245u + 12345u;
+    return static_cast<int>((random >> 16) % 1000);
+  };
+
+  for (TestItem& item : items) {
+    item.set_priority(next_random());
+    queue.push(item);
+  }
+
+  // Remove every third item, then check that the rest pop in order.
+  size_t removed = 0;
+  for (size_t i = 0; i < kItems; i += 3) {
+    ASSERT_TRUE(queue.remove(items[i]));
+    removed += 1;
+  }
+  ASSERT_EQ(kItems - removed, queue.size());
+
+  int previous = std::numeric_limits<int>::max();
+  while (!queue.empty()) {
+    EXPECT_GE(previous, queue.top().priority());
+    previous = queue.top().priority();
+    queue.pop();
+  }
+}
+
+}  // namespace
+}  // namespace pw
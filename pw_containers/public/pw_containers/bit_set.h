@@ -0,0 +1,306 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+namespace pw {
+
+// BitSet is a fixed-size set of bits, like std::bitset, with operations for
+// finding set and clear bits. Bits are stored in 32-bit words, and searches
+// skip whole words at a time, using count-trailing-zeros to find the bit within
+// a word. This makes BitSet suitable for allocation maps and slot tables.
+//
+// Iterating over a BitSet visits the indices of its set bits in ascending
+// order:
+//
+//   BitSet<64> free_slots;
+//   for (size_t slot : free_slots) {
+//     ...
+//   }
+//
+template <size_t kBits>
+class BitSet {
+ public:
+  using Word = uint32_t;
+
+  static constexpr size_t kBitsPerWord = 32;
+  static constexpr size_t kWords = (kBits + kBitsPerWord - 1) / kBitsPerWord;
+
+  class Iterator;
+  using iterator = Iterator;
+  using const_iterator = Iterator;
+
+  // Returned by the Find functions when no bit is found.
+  static constexpr size_t kNotFound = kBits;
+
+  constexpr BitSet() : words_{} {}
+
+  static constexpr size_t size() { return kBits; }
+
+  // Bit access. All bit indices must be less than size().
+  constexpr bool test(size_t bit) const {
+    return (words_[bit / kBitsPerWord] & Mask(bit)) != 0u;
+  }
+
+  constexpr bool operator[](size_t bit) const { return test(bit); }
+
+  constexpr BitSet& set(size_t bit) {
+    words_[bit / kBitsPerWord] |= Mask(bit);
+    return *this;
+  }
+
+  constexpr BitSet& set(size_t bit, bool value) {
+    return value ? set(bit) : reset(bit);
+  }
+
+  // Sets all bits.
+  constexpr BitSet& set() {
+    for (Word& word : words_) {
+      word = ~Word(0);
+    }
+    ClearUnusedBits();
+    return *this;
+  }
+
+  constexpr BitSet& reset(size_t bit) {
+    words_[bit / kBitsPerWord] &= ~Mask(bit);
+    return *this;
+  }
+
+  // Clears all bits.
+  constexpr BitSet& reset() {
+    for (Word& word : words_) {
+      word = 0;
+    }
+    return *this;
+  }
+
+  constexpr BitSet& flip(size_t bit) {
+    words_[bit / kBitsPerWord] ^= Mask(bit);
+    return *this;
+  }
+
+  constexpr BitSet& flip() {
+    for (Word& word : words_) {
+      word = ~word;
+    }
+    ClearUnusedBits();
+    return *this;
+  }
+
+  // Queries.
+
+  // The number of set bits.
+  size_t count() const {
+    size_t total = 0;
+    for (Word word : words_) {
+      total += static_cast<size_t>(__builtin_popcount(word));
+    }
+    return total;
+  }
+
+  constexpr bool any() const {
+    for (Word word : words_) {
+      if (word != 0u) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  constexpr bool none() const { return !any(); }
+
+  constexpr bool all() const {
+    for (size_t i = 0; i + 1 < kWords; ++i) {
+      if (words_[i] != ~Word(0)) {
+        return false;
+      }
+    }
+    return kWords == 0u || words_[kWords - 1] == LastWordMask();
+  }
+
+  // Returns the index of the lowest set bit, or kNotFound.
+  size_t FindFirstSet() const { return FindNextSet(0); }
+
+  // Returns the index of the lowest set bit at or after bit, or kNotFound.
+  size_t FindNextSet(size_t bit) const {
+    if (bit >= kBits) {
+      return kNotFound;
+    }
+    size_t index = bit / kBitsPerWord;
+    Word word = words_[index] & (~Word(0) << (bit % kBitsPerWord));
+    while (true) {
+      if (word != 0u) {
+        return index * kBitsPerWord + CountTrailingZeros(word);
+      }
+      if (++index == kWords) {
+        return kNotFound;
+      }
+      word = words_[index];
+    }
+  }
+
+  // Returns the index of the lowest clear bit, or kNotFound.
+  size_t FindFirstClear() const { return FindNextClear(0); }
+
+  // Returns the index of the lowest clear bit at or after bit, or kNotFound.
+  size_t FindNextClear(size_t bit) const {
+    if (bit >= kBits) {
+      return kNotFound;
+    }
+    size_t index = bit / kBitsPerWord;
+    Word word = ~words_[index] & (~Word(0) << (bit % kBitsPerWord));
+    while (true) {
+      if (word != 0u) {
+        const size_t found = index * kBitsPerWord + CountTrailingZeros(word);
+        return found < kBits ? found : kNotFound;
+      }
+      if (++index == kWords) {
+        return kNotFound;
+      }
+      word = ~words_[index];
+    }
+  }
+
+  // Returns the index of the highest set bit, or kNotFound.
+  size_t FindLastSet() const {
+    for (size_t index = kWords; index > 0u; --index) {
+      if (const Word word = words_[index - 1]; word != 0u) {
+        return index * kBitsPerWord - 1 -
+               static_cast<size_t>(__builtin_clz(word));
+      }
+    }
+    return kNotFound;
+  }
+
+  // Iterates over the indices of the set bits.
+  Iterator begin() const { return Iterator(*this, FindFirstSet()); }
+  Iterator end() const { return Iterator(*this, kNotFound); }
+
+  // Word-wise operations.
+
+  constexpr BitSet& operator&=(const BitSet& other) {
+    for (size_t i = 0; i < kWords; ++i) {
+      words_[i] &= other.words_[i];
+    }
+    return *this;
+  }
+
+  constexpr BitSet& operator|=(const BitSet& other) {
+    for (size_t i = 0; i < kWords; ++i) {
+      words_[i] |= other.words_[i];
+    }
+    return *this;
+  }
+
+  constexpr BitSet& operator^=(const BitSet& other) {
+    for (size_t i = 0; i < kWords; ++i) {
+      words_[i] ^= other.words_[i];
+    }
+    return *this;
+  }
+
+  constexpr BitSet operator~() const { return BitSet(*this).flip(); }
+
+  friend constexpr BitSet operator&(BitSet lhs, const BitSet& rhs) {
+    return lhs &= rhs;
+  }
+  friend constexpr BitSet operator|(BitSet lhs, const BitSet& rhs) {
+    return lhs |= rhs;
+  }
+  friend constexpr BitSet operator^(BitSet lhs, const BitSet& rhs) {
+    return lhs ^= rhs;
+  }
+
+  friend constexpr bool operator==(const BitSet& lhs, const BitSet& rhs) {
+    for (size_t i = 0; i < kWords; ++i) {
+      if (lhs.words_[i] != rhs.words_[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+  friend constexpr bool operator!=(const BitSet& lhs, const BitSet& rhs) {
+    return !(lhs == rhs);
+  }
+
+  // The underlying words. Bit i is bit i % 32 of word i / 32. Unused bits of
+  // the last word are always 0.
+  constexpr const std::array<Word, kWords>& words() const { return words_; }
+
+ private:
+  static constexpr Word Mask(size_t bit) {
+    return Word(1) << (bit % kBitsPerWord);
+  }
+
+  static constexpr Word LastWordMask() {
+    return kBits % kBitsPerWord == 0u
+               ? ~Word(0)
+               : (Word(1) << (kBits % kBitsPerWord)) - 1;
+  }
+
+  static size_t CountTrailingZeros(Word word) {
+    return static_cast<size_t>(__builtin_ctz(word));
+  }
+
+  constexpr void ClearUnusedBits() {
+    if constexpr (kWords > 0u) {
+      words_[kWords - 1] &= LastWordMask();
+    }
+  }
+
+  std::array<Word, kWords> words_;
+};
+
+// Iterates over the indices of the set bits of a BitSet, in ascending order.
+template <size_t kBits>
+class BitSet<kBits>::Iterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = size_t;
+  using difference_type = ptrdiff_t;
+  using pointer = const size_t*;
+  using reference = size_t;
+
+  size_t operator*() const { return bit_; }
+
+  Iterator& operator++() {
+    bit_ = bits_->FindNextSet(bit_ + 1);
+    return *this;
+  }
+
+  Iterator operator++(int) {
+    Iterator original = *this;
+    operator++();
+    return original;
+  }
+
+  bool operator==(const Iterator& other) const { return bit_ == other.bit_; }
+  bool operator!=(const Iterator& other) const { return bit_ != other.bit_; }
+
+ private:
+  friend class BitSet;
+
+  constexpr Iterator(const BitSet& bits, size_t bit)
+      : bits_(&bits), bit_(bit) {}
+
+  const BitSet* bits_;
+  size_t bit_;
+};
+
+}  // namespace pw
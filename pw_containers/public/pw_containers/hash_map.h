@@ -0,0 +1,446 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "pw_polyfill/language_feature_macros.h"
+
+namespace pw::containers {
+namespace hash_map_impl {
+
+// Used as kCapacity in the generic-capacity HashMap<Key, Value> interface.
+PW_INLINE_VARIABLE constexpr size_t kGeneric = size_t(-1);
+
+// Returns the number of slots for a capacity: the smallest power of two, and
+// at least 2, that keeps the table at most 75% full.
+constexpr size_t SlotCount(size_t capacity) {
+  size_t slots = 2;
+  while (slots * 3 < capacity * 4) {
+    slots *= 2;
+  }
+  return slots;
+}
+
+constexpr unsigned Log2(size_t value) {
+  unsigned log = 0;
+  while (value > 1u) {
+    value /= 2;
+    log += 1;
+  }
+  return log;
+}
+
+}  // namespace hash_map_impl
+
+// HashMap is an unordered associative container, similar to std::unordered_map,
+// backed by a fixed-size table stored inline. It never allocates. HashMaps are
+// declared with their capacity (e.g. HashMap<uint32_t, Handler*, 16>), but can
+// be used and referred to without it (e.g. HashMap<uint32_t, Handler*>), which
+// keeps code size small since the implementation is shared by all capacities.
+//
+// The table uses open addressing with linear probing. It has enough slots to
+// stay at most 75% full, so lookups, insertions, and removals take O(1)
+// expected time. Removal shifts later entries of a probe sequence back rather
+// than leaving tombstones, so the table does not slow down over time.
+//
+// Inserting into a full HashMap fails rather than growing it: insert() and
+// try_emplace() return end() and false. For this reason, there is no
+// operator[]. Insertion and removal invalidate iterators and references.
+template <typename Key,
+          typename Value,
+          size_t kCapacity = hash_map_impl::kGeneric,
+          typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class HashMap
+    : public HashMap<Key, Value, hash_map_impl::kGeneric, Hash, KeyEqual> {
+ private:
+  using Base = HashMap<Key, Value, hash_map_impl::kGeneric, Hash, KeyEqual>;
+
+ public:
+  using typename Base::value_type;
+
+  HashMap() : Base(slots_.data(), occupied_.data(), kSlots, kCapacity) {}
+
+  HashMap(std::initializer_list<value_type> list) : HashMap() {
+    Base::insert(list);
+  }
+
+  HashMap(const HashMap& other) : HashMap() { Base::operator=(other); }
+
+  template <size_t kOtherCapacity>
+  HashMap(const HashMap<Key, Value, kOtherCapacity, Hash, KeyEqual>& other)
+      : HashMap() {
+    Base::operator=(other);
+  }
+
+  HashMap(HashMap&& other) noexcept : HashMap() {
+    Base::operator=(std::move(other));
+  }
+
+  template <size_t kOtherCapacity>
+  HashMap(HashMap<Key, Value, kOtherCapacity, Hash, KeyEqual>&& other) noexcept
+      : HashMap() {
+    Base::operator=(std::move(other));
+  }
+
+  HashMap& operator=(const HashMap& other) {
+    Base::operator=(other);
+    return *this;
+  }
+
+  HashMap& operator=(HashMap&& other) noexcept {
+    Base::operator=(std::move(other));
+    return *this;
+  }
+
+  // All other HashMap methods are implemented on the generic HashMap base.
+
+ private:
+  static constexpr size_t kSlots = hash_map_impl::SlotCount(kCapacity);
+
+  alignas(value_type) std::array<typename Base::Slot, kSlots> slots_;
+  std::array<bool, kSlots> occupied_ = {};
+};
+
+// Defines the generic-capacity HashMap<Key, Value> specialization, which serves
+// as the base class for HashMaps of any capacity. Except for constructors, all
+// HashMap methods are implemented on this class.
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+class HashMap<Key, Value, hash_map_impl::kGeneric, Hash, KeyEqual> {
+ private:
+  template <bool kConst>
+  class Iterator;
+
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<const Key, Value>;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = value_type*;
+  using const_pointer = const value_type*;
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  HashMap(const HashMap&) = delete;
+  HashMap(HashMap&&) = delete;
+
+  HashMap& operator=(const HashMap& other) {
+    if (&other != this) {
+      clear();
+      for (const value_type& item : other) {
+        try_emplace(item.first, item.second);
+      }
+    }
+    return *this;
+  }
+
+  HashMap& operator=(HashMap&& other) noexcept {
+    if (&other != this) {
+      clear();
+      for (value_type& item : other) {
+        try_emplace(item.first, std::move(item.second));
+      }
+      other.clear();
+    }
+    return *this;
+  }
+
+  // Iterators, which visit entries in an unspecified order.
+  iterator begin() noexcept { return iterator(this, NextOccupied(0)); }
+  const_iterator begin() const noexcept {
+    return const_iterator(this, NextOccupied(0));
+  }
+  const_iterator cbegin() const noexcept { return begin(); }
+
+  iterator end() noexcept { return iterator(this, slot_count_); }
+  const_iterator end() const noexcept {
+    return const_iterator(this, slot_count_);
+  }
+  const_iterator cend() const noexcept { return end(); }
+
+  // Capacity.
+  [[nodiscard]] bool empty() const noexcept { return size() == 0u; }
+
+  // True if no more entries can be inserted.
+  [[nodiscard]] bool full() const noexcept { return size() == max_size(); }
+
+  size_type size() const noexcept { return size_; }
+
+  size_type max_size() const noexcept { return max_size_; }
+
+  // Lookup.
+  iterator find(const key_type& key) {
+    return iterator(this, FindSlot(key));
+  }
+  const_iterator find(const key_type& key) const {
+    return const_iterator(this, FindSlot(key));
+  }
+
+  bool contains(const key_type& key) const { return find(key) != end(); }
+
+  size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+  // Modifiers.
+
+  // Inserts an entry constructed from key and args, unless the key is already
+  // present. Returns the entry for the key and whether it was inserted, or
+  // end() and false if the key is absent and the HashMap is full.
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+    return TryEmplace(key, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+    return TryEmplace(std::move(key), std::forward<Args>(args)...);
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return try_emplace(value.first, value.second);
+  }
+
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return try_emplace(value.first, std::move(value.second));
+  }
+
+  void insert(std::initializer_list<value_type> list) {
+    for (const value_type& value : list) {
+      insert(value);
+    }
+  }
+
+  // Inserts an entry, or assigns to the value of the existing entry for the
+  // key. Returns end() and false if the key is absent and the HashMap is full.
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& value) {
+    const size_t slot = FindSlot(key);
+    if (slot != slot_count_) {
+      Get(slot).second = std::forward<M>(value);
+      return {iterator(this, slot), false};
+    }
+    return try_emplace(key, std::forward<M>(value));
+  }
+
+  // Removes the entry for the key, if any. Returns the number removed.
+  size_type erase(const key_type& key) {
+    const size_t slot = FindSlot(key);
+    if (slot == slot_count_) {
+      return 0;
+    }
+    EraseSlot(slot);
+    return 1;
+  }
+
+  // Removes the entry at a valid iterator. Entries after it in its probe
+  // sequence move, so continue iterating from begin(), or erase by key.
+  void erase(const_iterator position) { EraseSlot(position.slot_); }
+
+  void clear() noexcept {
+    for (size_t slot = 0; slot < slot_count_; ++slot) {
+      if (occupied_[slot]) {
+        Destroy(slot);
+      }
+    }
+    size_ = 0;
+  }
+
+ protected:
+  // Uninitialized storage for one entry.
+  using Slot = std::aligned_storage_t<sizeof(value_type), alignof(value_type)>;
+
+  HashMap(Slot* slots, bool* occupied, size_t slot_count, size_t max_size)
+      : slots_(slots),
+        occupied_(occupied),
+        slot_count_(slot_count),
+        max_size_(max_size),
+        shift_(sizeof(size_t) * 8 - hash_map_impl::Log2(slot_count)),
+        size_(0) {}
+
+  ~HashMap() { clear(); }
+
+ private:
+  template <typename, typename, size_t, typename, typename>
+  friend class HashMap;
+
+#ifdef __cpp_lib_launder
+  value_type& Get(size_t slot) {
+    return *std::launder(reinterpret_cast<value_type*>(&slots_[slot]));
+  }
+  const value_type& Get(size_t slot) const {
+    return *std::launder(reinterpret_cast<const value_type*>(&slots_[slot]));
+  }
+#else
+  value_type& Get(size_t slot) {
+    return *reinterpret_cast<value_type*>(&slots_[slot]);
+  }
+  const value_type& Get(size_t slot) const {
+    return *reinterpret_cast<const value_type*>(&slots_[slot]);
+  }
+#endif  // __cpp_lib_launder
+
+  // Returns the home slot of a key. Fibonacci hashing spreads the hash across
+  // the table, so identity hashes such as std::hash<int>'s do not cluster.
+  size_t HomeSlot(const key_type& key) const {
+    constexpr size_t kMultiplier = sizeof(size_t) == sizeof(uint64_t)
+                                       ? size_t(0x9e3779b97f4a7c15u)
+                                       : size_t(0x9e3779b9u);
+    return (static_cast<size_t>(Hash()(key)) * kMultiplier) >> shift_;
+  }
+
+  size_t Next(size_t slot) const { return (slot + 1) & (slot_count_ - 1); }
+
+  // Returns the slot holding the key, or slot_count_ if it is absent.
+  size_t FindSlot(const key_type& key) const {
+    for (size_t slot = HomeSlot(key); occupied_[slot]; slot = Next(slot)) {
+      if (KeyEqual()(Get(slot).first, key)) {
+        return slot;
+      }
+    }
+    return slot_count_;
+  }
+
+  size_t NextOccupied(size_t slot) const {
+    while (slot < slot_count_ && !occupied_[slot]) {
+      ++slot;
+    }
+    return slot;
+  }
+
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> TryEmplace(K&& key, Args&&... args) {
+    // The key is either in its probe sequence or absent, so the first free
+    // slot after it is where to insert it. The table is never full, so there
+    // is always a free slot.
+    size_t slot = HomeSlot(key);
+    for (; occupied_[slot]; slot = Next(slot)) {
+      if (KeyEqual()(Get(slot).first, key)) {
+        return {iterator(this, slot), false};
+      }
+    }
+
+    if (full()) {
+      return {end(), false};
+    }
+
+    new (&slots_[slot]) value_type(
+        std::piecewise_construct,
+        std::forward_as_tuple(std::forward<K>(key)),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+    occupied_[slot] = true;
+    size_ += 1;
+    return {iterator(this, slot), true};
+  }
+
+  void Destroy(size_t slot) {
+    Get(slot).~value_type();
+    occupied_[slot] = false;
+  }
+
+  void EraseSlot(size_t slot) {
+    Destroy(slot);
+    size_ -= 1;
+
+    // Shift back later entries in the probe sequence that would no longer be
+    // found past the hole: those whose home slot is not between the hole and
+    // their slot.
+    const size_t mask = slot_count_ - 1;
+    size_t hole = slot;
+    for (size_t next = Next(slot); occupied_[next]; next = Next(next)) {
+      const size_t home = HomeSlot(Get(next).first);
+      if (((next - home) & mask) >= ((next - hole) & mask)) {
+        new (&slots_[hole]) value_type(std::move(Get(next)));
+        occupied_[hole] = true;
+        Destroy(next);
+        hole = next;
+      }
+    }
+  }
+
+  Slot* const slots_;
+  bool* const occupied_;
+  const size_t slot_count_;
+  const size_t max_size_;
+  const unsigned shift_;
+  size_t size_;
+};
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+template <bool kConst>
+class HashMap<Key, Value, hash_map_impl::kGeneric, Hash, KeyEqual>::Iterator {
+ private:
+  using Map = std::conditional_t<kConst, const HashMap, HashMap>;
+
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = HashMap::value_type;
+  using difference_type = ptrdiff_t;
+  using pointer = std::conditional_t<kConst, const value_type*, value_type*>;
+  using reference = std::conditional_t<kConst, const value_type&, value_type&>;
+
+  constexpr Iterator() = default;
+
+  // Allow converting an iterator to a const_iterator.
+  template <bool kOtherConst,
+            typename = std::enable_if_t<kConst && !kOtherConst>>
+  constexpr Iterator(const Iterator<kOtherConst>& other)
+      : map_(other.map_), slot_(other.slot_) {}
+
+  reference operator*() const { return map_->Get(slot_); }
+  pointer operator->() const { return &map_->Get(slot_); }
+
+  Iterator& operator++() {
+    slot_ = map_->NextOccupied(slot_ + 1);
+    return *this;
+  }
+
+  Iterator operator++(int) {
+    Iterator original = *this;
+    operator++();
+    return original;
+  }
+
+  friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+    return lhs.map_ == rhs.map_ && lhs.slot_ == rhs.slot_;
+  }
+  friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+    return !(lhs == rhs);
+  }
+
+ private:
+  friend class HashMap;
+  template <bool>
+  friend class Iterator;
+
+  constexpr Iterator(Map* map, size_t slot) : map_(map), slot_(slot) {}
+
+  Map* map_ = nullptr;
+  size_t slot_ = 0;
+};
+
+}  // namespace pw::containers
@@ -0,0 +1,340 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "pw_polyfill/language_feature_macros.h"
+
+namespace pw {
+namespace inline_deque_impl {
+
+// Used as kCapacity in the generic-capacity InlineDeque<T> interface.
+PW_INLINE_VARIABLE constexpr size_t kGeneric = size_t(-1);
+
+// Items are stored in a ring of a power-of-two number of slots, so indices
+// wrap with a mask rather than a division or a branch.
+constexpr size_t SlotCount(size_t capacity) {
+  size_t slots = 1;
+  while (slots < capacity) {
+    slots *= 2;
+  }
+  return slots;
+}
+
+template <typename T>
+using Slot = std::aligned_storage_t<sizeof(T), alignof(T)>;
+
+// Inline storage for the items of a sized InlineDeque or InlineQueue. This is
+// a base class so that it is constructed before the generic base that uses it.
+template <typename T, size_t kCapacity>
+struct Storage {
+  static constexpr size_t kSlots = SlotCount(kCapacity);
+
+  alignas(T) std::array<Slot<T>, kSlots> slots;
+};
+
+}  // namespace inline_deque_impl
+
+// InlineDeque is a double-ended queue, similar to std::deque, backed by a
+// fixed-size ring buffer stored inline. Items can be added and removed at both
+// ends in O(1). InlineDeques are declared with their capacity (e.g.
+// InlineDeque<Event, 8>) but can be used and referred to without it (e.g.
+// InlineDeque<Event>), which keeps code size small since the implementation is
+// shared by all capacities.
+//
+// Like pw::Vector, adding an item to a full InlineDeque does nothing; check
+// full() first if items must not be dropped.
+template <typename T, size_t kCapacity = inline_deque_impl::kGeneric>
+class InlineDeque : private inline_deque_impl::Storage<T, kCapacity>,
+                    public InlineDeque<T, inline_deque_impl::kGeneric> {
+ private:
+  using Storage = inline_deque_impl::Storage<T, kCapacity>;
+  using Base = InlineDeque<T, inline_deque_impl::kGeneric>;
+
+ public:
+  InlineDeque() noexcept
+      : Base(Storage::slots.data(), Storage::kSlots, kCapacity) {}
+
+  InlineDeque(std::initializer_list<T> list) : InlineDeque() {
+    Base::assign(list.begin(), list.end());
+  }
+
+  InlineDeque(const InlineDeque& other) : InlineDeque() {
+    Base::assign(other.begin(), other.end());
+  }
+
+  template <size_t kOtherCapacity>
+  InlineDeque(const InlineDeque<T, kOtherCapacity>& other) : InlineDeque() {
+    Base::assign(other.begin(), other.end());
+  }
+
+  InlineDeque(InlineDeque&& other) noexcept : InlineDeque() {
+    Base::MoveFrom(other);
+  }
+
+  template <size_t kOtherCapacity>
+  InlineDeque(InlineDeque<T, kOtherCapacity>&& other) noexcept
+      : InlineDeque() {
+    Base::MoveFrom(other);
+  }
+
+  InlineDeque& operator=(const InlineDeque& other) {
+    Base::assign(other.begin(), other.end());
+    return *this;
+  }
+
+  InlineDeque& operator=(InlineDeque&& other) noexcept {
+    Base::clear();
+    Base::MoveFrom(other);
+    return *this;
+  }
+
+  // All other InlineDeque methods are implemented on the generic InlineDeque.
+};
+
+// Defines the generic-capacity InlineDeque<T> specialization, which serves as
+// the base class for InlineDeques of any capacity. Except for constructors, all
+// InlineDeque methods are implemented on this class.
+template <typename T>
+class InlineDeque<T, inline_deque_impl::kGeneric> {
+ private:
+  template <bool kConst>
+  class Iterator;
+
+ public:
+  using value_type = T;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = value_type*;
+  using const_pointer = const value_type*;
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  InlineDeque(const InlineDeque&) = delete;
+  InlineDeque(InlineDeque&&) = delete;
+
+  InlineDeque& operator=(const InlineDeque& other) {
+    if (&other != this) {
+      assign(other.begin(), other.end());
+    }
+    return *this;
+  }
+
+  template <typename InputIterator>
+  void assign(InputIterator first, InputIterator last) {
+    clear();
+    while (first != last) {
+      push_back(*first++);
+    }
+  }
+
+  // Access. The deque must not be empty, and index must be less than size().
+  reference operator[](size_type index) { return Get(index); }
+  const_reference operator[](size_type index) const { return Get(index); }
+
+  reference front() { return Get(0); }
+  const_reference front() const { return Get(0); }
+
+  reference back() { return Get(size_ - 1); }
+  const_reference back() const { return Get(size_ - 1); }
+
+  // Iterators, from front to back.
+  iterator begin() noexcept { return iterator(this, 0); }
+  const_iterator begin() const noexcept { return const_iterator(this, 0); }
+  const_iterator cbegin() const noexcept { return begin(); }
+
+  iterator end() noexcept { return iterator(this, size_); }
+  const_iterator end() const noexcept { return const_iterator(this, size_); }
+  const_iterator cend() const noexcept { return end(); }
+
+  // Capacity.
+  [[nodiscard]] bool empty() const noexcept { return size_ == 0u; }
+
+  // True if no more items can be added.
+  [[nodiscard]] bool full() const noexcept { return size_ == max_size_; }
+
+  size_type size() const noexcept { return size_; }
+
+  size_type max_size() const noexcept { return max_size_; }
+
+  // Modify.
+
+  void clear() noexcept {
+    while (!empty()) {
+      pop_back();
+    }
+    head_ = 0;
+  }
+
+  void push_back(const T& value) { emplace_back(value); }
+
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  void push_front(const T& value) { emplace_front(value); }
+
+  void push_front(T&& value) { emplace_front(std::move(value)); }
+
+  template <typename... Args>
+  void emplace_back(Args&&... args) {
+    if (!full()) {
+      new (&slots_[Wrap(head_ + size_)]) T(std::forward<Args>(args)...);
+      size_ += 1;
+    }
+  }
+
+  template <typename... Args>
+  void emplace_front(Args&&... args) {
+    if (!full()) {
+      const size_t slot = Wrap(head_ - 1);
+      new (&slots_[slot]) T(std::forward<Args>(args)...);
+      head_ = slot;
+      size_ += 1;
+    }
+  }
+
+  void pop_front() {
+    if (!empty()) {
+      front().~T();
+      head_ = Wrap(head_ + 1);
+      size_ -= 1;
+    }
+  }
+
+  void pop_back() {
+    if (!empty()) {
+      back().~T();
+      size_ -= 1;
+    }
+  }
+
+ protected:
+  using Slot = inline_deque_impl::Slot<T>;
+
+  InlineDeque(Slot* slots, size_t slot_count, size_t max_size) noexcept
+      : slots_(slots), mask_(slot_count - 1), max_size_(max_size) {}
+
+  ~InlineDeque() { clear(); }
+
+  void MoveFrom(InlineDeque& other) noexcept {
+    for (T& item : other) {
+      emplace_back(std::move(item));
+    }
+    other.clear();
+  }
+
+ private:
+  size_t Wrap(size_t index) const { return index & mask_; }
+
+#ifdef __cpp_lib_launder
+  T& Get(size_t index) {
+    return *std::launder(
+        reinterpret_cast<T*>(&slots_[Wrap(head_ + index)]));
+  }
+  const T& Get(size_t index) const {
+    return *std::launder(
+        reinterpret_cast<const T*>(&slots_[Wrap(head_ + index)]));
+  }
+#else
+  T& Get(size_t index) {
+    return *reinterpret_cast<T*>(&slots_[Wrap(head_ + index)]);
+  }
+  const T& Get(size_t index) const {
+    return *reinterpret_cast<const T*>(&slots_[Wrap(head_ + index)]);
+  }
+#endif  // __cpp_lib_launder
+
+  Slot* const slots_;
+  const size_t mask_;
+  const size_t max_size_;
+
+  // The slot of the front item, and the number of items.
+  size_t head_ = 0;
+  size_t size_ = 0;
+};
+
+template <typename T>
+template <bool kConst>
+class InlineDeque<T, inline_deque_impl::kGeneric>::Iterator {
+ private:
+  using Deque = std::conditional_t<kConst, const InlineDeque, InlineDeque>;
+
+ public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = T;
+  using difference_type = ptrdiff_t;
+  using pointer = std::conditional_t<kConst, const T*, T*>;
+  using reference = std::conditional_t<kConst, const T&, T&>;
+
+  constexpr Iterator() = default;
+
+  // Allow converting an iterator to a const_iterator.
+  template <bool kOtherConst,
+            typename = std::enable_if_t<kConst && !kOtherConst>>
+  constexpr Iterator(const Iterator<kOtherConst>& other)
+      : deque_(other.deque_), index_(other.index_) {}
+
+  reference operator*() const { return deque_->Get(index_); }
+  pointer operator->() const { return &deque_->Get(index_); }
+
+  Iterator& operator++() {
+    index_ += 1;
+    return *this;
+  }
+
+  Iterator operator++(int) {
+    Iterator original = *this;
+    operator++();
+    return original;
+  }
+
+  Iterator& operator--() {
+    index_ -= 1;
+    return *this;
+  }
+
+  Iterator operator--(int) {
+    Iterator original = *this;
+    operator--();
+    return original;
+  }
+
+  friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+    return lhs.deque_ == rhs.deque_ && lhs.index_ == rhs.index_;
+  }
+  friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+    return !(lhs == rhs);
+  }
+
+ private:
+  friend class InlineDeque;
+  template <bool>
+  friend class Iterator;
+
+  constexpr Iterator(Deque* deque, size_t index)
+      : deque_(deque), index_(index) {}
+
+  Deque* deque_ = nullptr;
+  size_t index_ = 0;
+};
+
+}  // namespace pw
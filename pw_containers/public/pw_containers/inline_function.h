@@ -0,0 +1,200 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "pw_polyfill/language_feature_macros.h"
+
+namespace pw {
+namespace inline_function_impl {
+
+// By default, InlineFunction has room for a lambda that captures two pointers,
+// such as an object and a buffer.
+PW_INLINE_VARIABLE constexpr size_t kDefaultSize = 2 * sizeof(void*);
+
+// Returns the callable stored at the given address.
+template <typename T>
+T& Get(void* callable) {
+#ifdef __cpp_lib_launder
+  return *std::launder(static_cast<T*>(callable));
+#else
+  return *static_cast<T*>(callable);
+#endif  // __cpp_lib_launder
+}
+
+}  // namespace inline_function_impl
+
+template <typename Signature,
+          size_t kSize = inline_function_impl::kDefaultSize>
+class InlineFunction;
+
+// InlineFunction is a move-only callable wrapper, like std::function, that
+// stores its callable in a fixed-size inline buffer instead of on the heap.
+// Callables that do not fit in kSize bytes fail to compile. Invoking an
+// InlineFunction is a single indirect call.
+//
+// Callables that are trivially copyable and destructible, such as function
+// pointers and lambdas that capture pointers or integers, are moved with
+// memcpy and need no destructor call.
+//
+// Usage:
+//
+//   InlineFunction<void(int)> on_value = [this](int value) { Set(value); };
+//   on_value(3);
+//
+template <typename Return, typename... Args, size_t kSize>
+class InlineFunction<Return(Args...), kSize> {
+ public:
+  constexpr InlineFunction() noexcept : invoke_(nullptr), manage_(nullptr) {}
+
+  constexpr InlineFunction(std::nullptr_t) noexcept : InlineFunction() {}
+
+  template <typename Callable,
+            typename = std::enable_if_t<!std::is_same_v<
+                std::remove_cv_t<std::remove_reference_t<Callable>>,
+                InlineFunction>>>
+  InlineFunction(Callable&& callable) : InlineFunction() {
+    Set(std::forward<Callable>(callable));
+  }
+
+  InlineFunction(InlineFunction&& other) noexcept : InlineFunction() {
+    MoveFrom(other);
+  }
+
+  InlineFunction(const InlineFunction&) = delete;
+  InlineFunction& operator=(const InlineFunction&) = delete;
+
+  InlineFunction& operator=(InlineFunction&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  InlineFunction& operator=(std::nullptr_t) noexcept {
+    Reset();
+    return *this;
+  }
+
+  template <typename Callable,
+            typename = std::enable_if_t<!std::is_same_v<
+                std::remove_cv_t<std::remove_reference_t<Callable>>,
+                InlineFunction>>>
+  InlineFunction& operator=(Callable&& callable) {
+    Reset();
+    Set(std::forward<Callable>(callable));
+    return *this;
+  }
+
+  ~InlineFunction() { Reset(); }
+
+  explicit operator bool() const noexcept { return invoke_ != nullptr; }
+
+  // Calls the stored callable. Undefined behavior if the function is empty.
+  Return operator()(Args... args) const {
+    return invoke_(const_cast<void*>(static_cast<const void*>(&storage_)),
+                   std::forward<Args>(args)...);
+  }
+
+  friend bool operator==(const InlineFunction& function, std::nullptr_t) {
+    return !function;
+  }
+  friend bool operator!=(const InlineFunction& function, std::nullptr_t) {
+    return static_cast<bool>(function);
+  }
+
+ private:
+  using Invoke = Return (*)(void* callable, Args... args);
+
+  // Moves the callable from source to uninitialized destination, then destroys
+  // source. If destination is null, only destroys source.
+  using Manage = void (*)(void* destination, void* source);
+
+  template <typename Callable>
+  void Set(Callable&& callable) {
+    using Stored = std::decay_t<Callable>;
+
+    // A null function pointer results in an empty InlineFunction.
+    if constexpr (std::is_pointer_v<std::remove_reference_t<Callable>>) {
+      if (callable == nullptr) {
+        return;
+      }
+    }
+
+    static_assert(sizeof(Stored) <= kSize,
+                  "The callable is too large for this InlineFunction; "
+                  "increase kSize or capture less");
+    static_assert(alignof(Stored) <= alignof(std::max_align_t),
+                  "The callable is over-aligned for InlineFunction");
+
+    new (&storage_) Stored(std::forward<Callable>(callable));
+    invoke_ = &InvokeCallable<Stored>;
+
+    if constexpr (std::is_trivially_copyable_v<Stored>) {
+      manage_ = nullptr;
+    } else {
+      manage_ = &ManageCallable<Stored>;
+    }
+  }
+
+  void MoveFrom(InlineFunction& other) noexcept {
+    if (other.invoke_ == nullptr) {
+      return;
+    }
+    if (other.manage_ == nullptr) {
+      std::memcpy(&storage_, &other.storage_, sizeof(storage_));
+    } else {
+      other.manage_(&storage_, &other.storage_);
+    }
+    invoke_ = other.invoke_;
+    manage_ = other.manage_;
+    other.invoke_ = nullptr;
+    other.manage_ = nullptr;
+  }
+
+  void Reset() noexcept {
+    if (manage_ != nullptr) {
+      manage_(nullptr, &storage_);
+    }
+    invoke_ = nullptr;
+    manage_ = nullptr;
+  }
+
+  template <typename Stored>
+  static Return InvokeCallable(void* callable, Args... args) {
+    return inline_function_impl::Get<Stored>(callable)(
+        std::forward<Args>(args)...);
+  }
+
+  template <typename Stored>
+  static void ManageCallable(void* destination, void* source) {
+    Stored& callable = inline_function_impl::Get<Stored>(source);
+    if (destination != nullptr) {
+      new (destination) Stored(std::move(callable));
+    }
+    callable.~Stored();
+  }
+
+  alignas(std::max_align_t) std::byte storage_[kSize];
+  Invoke invoke_;
+  Manage manage_;
+};
+
+}  // namespace pw
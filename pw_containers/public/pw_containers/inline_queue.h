@@ -0,0 +1,204 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "pw_containers/inline_deque.h"
+
+namespace pw {
+
+// InlineQueue is a first-in, first-out queue, similar to std::queue, backed by
+// a fixed-size ring buffer stored inline. It is an InlineDeque restricted to
+// pushing at the back and popping at the front. As with InlineDeque, queues
+// are declared with their capacity (e.g. InlineQueue<Sample, 16>) but can be
+// referred to without it (e.g. InlineQueue<Sample>), and pushing to a full
+// queue does nothing.
+template <typename T, size_t kCapacity = inline_deque_impl::kGeneric>
+class InlineQueue : private inline_deque_impl::Storage<T, kCapacity>,
+                    public InlineQueue<T, inline_deque_impl::kGeneric> {
+ private:
+  using Storage = inline_deque_impl::Storage<T, kCapacity>;
+  using Base = InlineQueue<T, inline_deque_impl::kGeneric>;
+
+ public:
+  InlineQueue() noexcept
+      : Base(Storage::slots.data(), Storage::kSlots, kCapacity) {}
+
+  InlineQueue(std::initializer_list<T> list) : InlineQueue() {
+    Base::assign(list.begin(), list.end());
+  }
+
+  InlineQueue(const InlineQueue& other) : InlineQueue() {
+    Base::assign(other.begin(), other.end());
+  }
+
+  InlineQueue(InlineQueue&& other) noexcept : InlineQueue() {
+    Base::MoveFrom(other);
+  }
+
+  InlineQueue& operator=(const InlineQueue& other) {
+    Base::assign(other.begin(), other.end());
+    return *this;
+  }
+
+  InlineQueue& operator=(InlineQueue&& other) noexcept {
+    Base::clear();
+    Base::MoveFrom(other);
+    return *this;
+  }
+};
+
+// The generic-capacity InlineQueue<T>, which implements all InlineQueue
+// methods on top of the generic InlineDeque<T>.
+template <typename T>
+class InlineQueue<T, inline_deque_impl::kGeneric>
+    : private InlineDeque<T, inline_deque_impl::kGeneric> {
+ private:
+  using Deque = InlineDeque<T, inline_deque_impl::kGeneric>;
+
+ public:
+  using typename Deque::const_iterator;
+  using typename Deque::const_reference;
+  using typename Deque::iterator;
+  using typename Deque::reference;
+  using typename Deque::size_type;
+  using typename Deque::value_type;
+
+  using Deque::assign;
+  using Deque::back;
+  using Deque::begin;
+  using Deque::cbegin;
+  using Deque::cend;
+  using Deque::clear;
+  using Deque::empty;
+  using Deque::end;
+  using Deque::front;
+  using Deque::full;
+  using Deque::max_size;
+  using Deque::size;
+
+  void push(const T& value) { Deque::emplace_back(value); }
+
+  void push(T&& value) { Deque::emplace_back(std::move(value)); }
+
+  template <typename... Args>
+  void emplace(Args&&... args) {
+    Deque::emplace_back(std::forward<Args>(args)...);
+  }
+
+  // Removes the front item, if any.
+  void pop() { Deque::pop_front(); }
+
+ protected:
+  using typename Deque::Slot;
+
+  InlineQueue(Slot* slots, size_t slot_count, size_t max_size) noexcept
+      : Deque(slots, slot_count, max_size) {}
+
+  void MoveFrom(InlineQueue& other) noexcept { Deque::MoveFrom(other); }
+};
+
+// InlineSpscQueue is a lock-free queue for passing items from one producer to
+// one consumer, for example from an interrupt handler to a thread. The
+// producer calls only try_push(); the consumer calls only try_pop(). Indices
+// are atomics, and each is written by only one side, so no lock is needed.
+//
+// The capacity must be a power of two, so the ever-increasing indices wrap
+// into the ring with a mask.
+template <typename T, size_t kCapacity>
+class InlineSpscQueue {
+ public:
+  static_assert(kCapacity > 0u && (kCapacity & (kCapacity - 1)) == 0u,
+                "InlineSpscQueue capacity must be a power of two");
+
+  constexpr InlineSpscQueue() : head_(0), tail_(0) {}
+
+  InlineSpscQueue(const InlineSpscQueue&) = delete;
+  InlineSpscQueue& operator=(const InlineSpscQueue&) = delete;
+
+  ~InlineSpscQueue() {
+    const size_t tail = tail_.load(std::memory_order_acquire);
+    for (size_t head = head_.load(); head != tail; ++head) {
+      Get(head & kMask)->~T();
+    }
+  }
+
+  // Called by the producer. Returns false if the queue is full.
+  template <typename... Args>
+  bool try_emplace(Args&&... args) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == kCapacity) {
+      return false;
+    }
+    new (&slots_[tail & kMask]) T(std::forward<Args>(args)...);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_push(const T& value) { return try_emplace(value); }
+
+  bool try_push(T&& value) { return try_emplace(std::move(value)); }
+
+  // Called by the consumer. Moves the front item into value and returns true,
+  // or returns false if the queue is empty.
+  bool try_pop(T& value) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    T* item = Get(head & kMask);
+    value = std::move(*item);
+    item->~T();
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // The number of queued items. Exact only when called by the producer or
+  // consumer while the other side is idle.
+  size_t size() const {
+    return tail_.load(std::memory_order_acquire) -
+           head_.load(std::memory_order_acquire);
+  }
+
+  bool empty() const { return size() == 0u; }
+
+  static constexpr size_t max_size() { return kCapacity; }
+
+ private:
+  static constexpr size_t kMask = kCapacity - 1;
+
+#ifdef __cpp_lib_launder
+  T* Get(size_t slot) {
+    return std::launder(reinterpret_cast<T*>(&slots_[slot]));
+  }
+#else
+  T* Get(size_t slot) { return reinterpret_cast<T*>(&slots_[slot]); }
+#endif  // __cpp_lib_launder
+
+  // The number of items ever popped, written only by the consumer, and ever
+  // pushed, written only by the producer.
+  std::atomic<size_t> head_;
+  std::atomic<size_t> tail_;
+
+  alignas(T) std::array<inline_deque_impl::Slot<T>, kCapacity> slots_;
+};
+
+}  // namespace pw
@@ -0,0 +1,87 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+namespace pw::intrusive_priority_queue_impl {
+
+// A pairing heap: a tree in which each item precedes its children. Each item's
+// children form a list through their next_ pointers. prev_ points to the item's
+// left sibling, or to its parent if it is the first child.
+class Heap {
+ public:
+  class Item {
+   protected:
+    constexpr Item() : child_(nullptr), next_(nullptr), prev_(nullptr) {}
+
+    bool queued() const { return prev_ != nullptr; }
+
+    // Items must be removed from their queue before they are destroyed.
+    ~Item();
+
+   private:
+    friend class Heap;
+
+    void Reset() {
+      child_ = nullptr;
+      next_ = nullptr;
+      prev_ = nullptr;
+    }
+
+    Item* child_;
+    Item* next_;
+    Item* prev_;  // Points to this for the root; nullptr if not queued.
+  };
+
+  // Returns true if lhs should be dequeued before rhs.
+  using Precedes = bool (*)(const Item& lhs, const Item& rhs);
+
+  constexpr Heap() : root_(nullptr), size_(0) {}
+
+  // Heaps cannot be copied, since each Item can only be in one heap.
+  Heap(const Heap&) = delete;
+  Heap& operator=(const Heap&) = delete;
+
+  bool empty() const { return root_ == nullptr; }
+
+  size_t size() const { return size_; }
+
+  Item* top() const { return root_; }
+
+  void push(Item& item, Precedes precedes);
+
+  void pop(Precedes precedes);
+
+  // Removes an item from anywhere in the heap. Returns false if it was not
+  // queued.
+  bool remove(Item& item, Precedes precedes);
+
+  void clear();
+
+ private:
+  // Combines two heaps, returning the new root.
+  static Item* Meld(Item* first, Item* second, Precedes precedes);
+
+  // Combines a list of sibling heaps into one with the two-pass pairing
+  // strategy, which gives pop() and remove() amortized O(log n) cost.
+  static Item* MergePairs(Item* first, Precedes precedes);
+
+  void SetRoot(Item* root);
+
+  Item* root_;
+  size_t size_;
+};
+
+}  // namespace pw::intrusive_priority_queue_impl
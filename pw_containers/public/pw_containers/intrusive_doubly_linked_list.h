@@ -0,0 +1,131 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "pw_containers/internal/intrusive_doubly_linked_list_impl.h"
+
+namespace pw {
+
+// IntrusiveDoublyLinkedList provides doubly-linked list functionality for
+// derived class items, like IntrusiveList does for singly-linked lists. Each
+// item links to both of its neighbors, so removing an item is O(1), rather
+// than requiring a search for its predecessor. This suits lists that items
+// join and leave often, such as lists of active operations.
+//
+// As with IntrusiveList, an item must remain in scope for as long as it is in
+// a list, and can only be in one list at a time. Items remove themselves from
+// their list when destroyed.
+//
+// Usage:
+//
+//   class Operation
+//      : public IntrusiveDoublyLinkedList<Operation>::Item {};
+//
+//   IntrusiveDoublyLinkedList<Operation> operations;
+//
+//   Operation operation;
+//   operations.push_back(operation);
+//   ...
+//   operations.remove(operation);  // O(1)
+//
+template <typename T>
+class IntrusiveDoublyLinkedList {
+ public:
+  class Item : public intrusive_doubly_linked_list_impl::List::Item {
+   protected:
+    constexpr Item() = default;
+  };
+
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using pointer = T*;
+  using reference = T&;
+  using iterator = intrusive_doubly_linked_list_impl::Iterator<T, Item>;
+  using const_iterator =
+      intrusive_doubly_linked_list_impl::Iterator<std::add_const_t<T>,
+                                                  const Item>;
+
+  constexpr IntrusiveDoublyLinkedList() { CheckItemType(); }
+
+  [[nodiscard]] bool empty() const noexcept { return list_.empty(); }
+
+  void push_front(T& item) { list_.insert(list_.begin(), item); }
+
+  void push_back(T& item) { list_.insert(list_.end(), item); }
+
+  // Inserts item before pos. Returns an iterator to the inserted item.
+  iterator insert(iterator pos, T& item) {
+    list_.insert(&(*pos), item);
+    return iterator(&item);
+  }
+
+  // Removes the first or last item in the list. The list must not be empty.
+  void pop_front() { list_.erase(*list_.begin()); }
+  void pop_back() { list_.erase(*(--end())); }
+
+  // Removes the item at pos from the list. The item is not destructed. Returns
+  // the iterator following the removed item.
+  iterator erase(iterator pos) {
+    T& item = *pos++;
+    list_.erase(item);
+    return pos;
+  }
+
+  // Removes all items from the list. The items themselves are not destructed.
+  void clear() { list_.clear(); }
+
+  // Removes this specific item from the list in O(1), if it is in a list.
+  // Returns true if the item was removed; false if it was not in a list. The
+  // item must be in this list or in no list.
+  bool remove(T& item) { return list_.remove(item); }
+
+  // Reference to the first element in the list. Undefined behavior if empty().
+  T& front() { return *begin(); }
+
+  // Reference to the last element in the list. Undefined behavior if empty().
+  T& back() { return *(--end()); }
+
+  iterator begin() noexcept {
+    return iterator(static_cast<Item*>(list_.begin()));
+  }
+  const_iterator begin() const noexcept {
+    return const_iterator(static_cast<const Item*>(list_.begin()));
+  }
+  const_iterator cbegin() const noexcept { return begin(); }
+
+  iterator end() noexcept { return iterator(static_cast<Item*>(list_.end())); }
+  const_iterator end() const noexcept {
+    return const_iterator(static_cast<const Item*>(list_.end()));
+  }
+  const_iterator cend() const noexcept { return end(); }
+
+  // Operation is O(size).
+  size_t size() const { return list_.size(); }
+
+ private:
+  // Check that T is an Item in a function, since the class T will not be fully
+  // defined when the IntrusiveDoublyLinkedList<T> class is instantiated.
+  static constexpr void CheckItemType() {
+    static_assert(std::is_base_of<Item, T>(),
+                  "IntrusiveDoublyLinkedList items must be derived from "
+                  "IntrusiveDoublyLinkedList<T>::Item");
+  }
+
+  intrusive_doubly_linked_list_impl::List list_;
+};
+
+}  // namespace pw
@@ -0,0 +1,116 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+#include "pw_containers/internal/intrusive_priority_queue_impl.h"
+
+namespace pw {
+
+// IntrusivePriorityQueue is a priority queue of items that inherit from
+// IntrusivePriorityQueue<T>::Item, like the items of an IntrusiveList. It
+// never allocates, so it suits timers, deadlines, and schedulers.
+//
+// Like std::priority_queue, the top item is the one that Compare orders last.
+// With the default std::less<T>, that is the LARGEST item. For a min-heap, such
+// as a queue of deadlines where the earliest is next, use std::greater<>. The
+// queue is a pairing heap: push() is O(1), and pop() and remove() of any item
+// are amortized O(log n).
+//
+// An item can only be in one queue at a time, and must be removed before it is
+// destroyed. If an item's priority changes while it is queued, call update().
+//
+// Usage:
+//
+//   struct Deadline
+//       : public IntrusivePriorityQueue<Deadline, std::greater<>>::Item {
+//     bool operator>(const Deadline& other) const { return time > other.time; }
+//     uint32_t time;
+//   };
+//
+//   // The earliest deadline is at the top.
+//   IntrusivePriorityQueue<Deadline, std::greater<>> deadlines;
+//   deadlines.push(deadline);
+//   Deadline& next = deadlines.top();
+//
+template <typename T, typename Compare = std::less<T>>
+class IntrusivePriorityQueue {
+ private:
+  using Heap = intrusive_priority_queue_impl::Heap;
+
+ public:
+  class Item : public Heap::Item {
+   protected:
+    constexpr Item() = default;
+  };
+
+  using value_type = T;
+  using size_type = size_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using value_compare = Compare;
+
+  constexpr IntrusivePriorityQueue() { CheckItemType(); }
+
+  [[nodiscard]] bool empty() const noexcept { return heap_.empty(); }
+
+  // Operation is O(1).
+  size_type size() const noexcept { return heap_.size(); }
+
+  // The item to dequeue next. Undefined behavior if empty().
+  T& top() const { return *static_cast<T*>(static_cast<Item*>(heap_.top())); }
+
+  // Adds an item, which must not be in a queue.
+  void push(T& item) { heap_.push(item, &Precedes); }
+
+  // Removes the top item. The queue must not be empty.
+  void pop() { heap_.pop(&Precedes); }
+
+  // Removes this specific item, if it is queued. The item must be in this
+  // queue or in none. Returns true if the item was removed.
+  bool remove(T& item) { return heap_.remove(item, &Precedes); }
+
+  // Moves a queued item to its new place after its priority changed.
+  void update(T& item) {
+    if (heap_.remove(item, &Precedes)) {
+      heap_.push(item, &Precedes);
+    }
+  }
+
+  // Removes all items from the queue. The items themselves are not destructed.
+  void clear() { heap_.clear(); }
+
+ private:
+  // The heap keeps the item that precedes all others at the top. As in
+  // std::priority_queue, an item precedes another if Compare orders it after.
+  static bool Precedes(const Heap::Item& lhs, const Heap::Item& rhs) {
+    return Compare()(static_cast<const T&>(static_cast<const Item&>(rhs)),
+                     static_cast<const T&>(static_cast<const Item&>(lhs)));
+  }
+
+  // Check that T is an Item in a function, since the class T will not be fully
+  // defined when the IntrusivePriorityQueue<T> class is instantiated.
+  static constexpr void CheckItemType() {
+    static_assert(std::is_base_of<Item, T>(),
+                  "IntrusivePriorityQueue items must be derived from "
+                  "IntrusivePriorityQueue<T>::Item");
+  }
+
+  Heap heap_;
+};
+
+}  // namespace pw
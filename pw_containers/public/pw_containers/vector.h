@@ -16,10 +16,13 @@
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstring>
 #include <initializer_list>
 #include <iterator>
 #include <limits>
+#include <memory>
 #include <new>
+#include <span>
 #include <type_traits>
 #include <utility>
 
@@ -35,6 +38,13 @@ using IsIterator = std::negation<
 // Used as kMaxSize in the generic-size Vector<T> interface.
 PW_INLINE_VARIABLE constexpr size_t kGeneric = size_t(-1);
 
+// True if the items from an Iterator can be copied into a Vector<T> with
+// memcpy.
+template <typename T, typename Iterator>
+PW_INLINE_VARIABLE constexpr bool kCanMemcpy =
+    std::is_trivially_copyable_v<T> && std::is_pointer_v<Iterator> &&
+    std::is_same_v<std::remove_cv_t<std::remove_pointer_t<Iterator>>, T>;
+
 }  // namespace vector_impl
 
 // The Vector class is similar to std::vector, except it is backed by a
@@ -47,6 +57,9 @@ PW_INLINE_VARIABLE constexpr size_t kGeneric = size_t(-1);
 // the maximum size in a variable. This allows Vectors to be used without having
 // to know their maximum size at compile time. It also keeps code size small
 // since function implementations are shared for all maximum sizes.
+//
+// For trivially copyable types, Vector copies, inserts, and erases elements
+// with memcpy and memmove rather than element by element.
 template <typename T, size_t kMaxSize = vector_impl::kGeneric>
 class Vector : public Vector<T, vector_impl::kGeneric> {
  public:
@@ -284,12 +297,17 @@ class Vector<T, vector_impl::kGeneric> {
 
   void clear() noexcept;
 
-  // TODO(hepler): insert, emplace, and erase are not yet implemented.
-  //    Currently, items can only be added to or removed from the end.
-  iterator insert(const_iterator index, const T& value);
+  // Like push_back and emplace_back, single-item insert and emplace do
+  // nothing if the vector is full; they return end() in that case.
+  iterator insert(const_iterator index, const T& value) {
+    return emplace(index, value);
+  }
 
-  iterator insert(const_iterator index, T&& value);
+  iterator insert(const_iterator index, T&& value) {
+    return emplace(index, std::move(value));
+  }
 
+  // TODO(hepler): Inserting multiple items is not yet implemented.
   iterator insert(const_iterator index, size_type count, const T& value);
 
   template <typename Iterator>
@@ -306,6 +324,12 @@ class Vector<T, vector_impl::kGeneric> {
 
   void push_back(const T& value) { emplace_back(value); }
 
+  // Copies the items to the end of the vector. Like push_back, items that do
+  // not fit in the vector are not added.
+  void append(std::span<const T> items) {
+    CopyFrom(items.data(), items.data() + items.size());
+  }
+
   void push_back(T&& value) { emplace_back(std::move(value)); }
 
   template <typename... Args>
@@ -402,8 +426,10 @@ bool operator>=(const Vector<T, kLhsSize>& lhs,
 
 template <typename T>
 void Vector<T, vector_impl::kGeneric>::clear() noexcept {
-  for (auto& item : *this) {
-    item.~T();
+  if constexpr (!std::is_trivially_destructible_v<T>) {
+    for (auto& item : *this) {
+      item.~T();
+    }
   }
   size_ = 0;
 }
@@ -417,6 +443,70 @@ void Vector<T, vector_impl::kGeneric>::emplace_back(Args&&... args) {
   }
 }
 
+template <typename T>
+template <typename... Args>
+typename Vector<T, vector_impl::kGeneric>::iterator
+Vector<T, vector_impl::kGeneric>::emplace(const_iterator index,
+                                          Args&&... args) {
+  if (full()) {
+    return end();
+  }
+
+  const size_type position = static_cast<size_type>(index - cbegin());
+  if (position == size()) {
+    emplace_back(std::forward<Args>(args)...);
+    return end() - 1;
+  }
+
+  // Construct the item first, since the arguments may refer to items that are
+  // about to move. Then shift the items after the position back by one.
+  T item(std::forward<Args>(args)...);
+
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    iterator position_it = begin() + position;
+    std::memmove(static_cast<void*>(position_it + 1),
+                 position_it,
+                 (size() - position) * sizeof(T));
+    std::memcpy(static_cast<void*>(position_it), &item, sizeof(T));
+    size_ += 1;
+    return position_it;
+  }
+
+  emplace_back(std::move(back()));
+  iterator position_it = begin() + position;
+  std::move_backward(position_it, end() - 2, end() - 1);
+  *position_it = std::move(item);
+  return position_it;
+}
+
+template <typename T>
+typename Vector<T, vector_impl::kGeneric>::iterator
+Vector<T, vector_impl::kGeneric>::erase(const_iterator index) {
+  return erase(index, index + 1);
+}
+
+template <typename T>
+typename Vector<T, vector_impl::kGeneric>::iterator
+Vector<T, vector_impl::kGeneric>::erase(const_iterator first,
+                                        const_iterator last) {
+  iterator first_it = begin() + (first - cbegin());
+
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    const size_t erased = static_cast<size_t>(last - first);
+    std::memmove(static_cast<void*>(first_it),
+                 first_it + erased,
+                 static_cast<size_t>(end() - first_it - erased) * sizeof(T));
+    size_ -= static_cast<size_type>(erased);
+    return first_it;
+  }
+
+  iterator new_end = std::move(begin() + (last - cbegin()), end(), first_it);
+  while (end() != new_end) {
+    pop_back();
+  }
+  return first_it;
+}
+
 template <typename T>
 void Vector<T, vector_impl::kGeneric>::pop_back() {
   if (!empty()) {
@@ -440,23 +530,42 @@ void Vector<T, vector_impl::kGeneric>::resize(size_type new_size,
 template <typename T>
 template <typename Iterator>
 void Vector<T, vector_impl::kGeneric>::CopyFrom(Iterator first, Iterator last) {
-  while (first != last) {
-    push_back(*first++);
+  if constexpr (vector_impl::kCanMemcpy<T, Iterator>) {
+    const size_t count = std::min(static_cast<size_t>(last - first),
+                                  max_size() - size());
+    if (count != 0u) {
+      std::memcpy(static_cast<void*>(end()), first, count * sizeof(T));
+      size_ += static_cast<size_type>(count);
+    }
+  } else {
+    while (first != last) {
+      push_back(*first++);
+    }
   }
 }
 
 template <typename T>
 void Vector<T, vector_impl::kGeneric>::MoveFrom(Vector& other) noexcept {
-  for (auto&& item : other) {
-    emplace_back(std::move(item));
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    CopyFrom(other.cbegin(), other.cend());
+  } else {
+    for (auto&& item : other) {
+      emplace_back(std::move(item));
+    }
   }
   other.clear();
 }
 
 template <typename T>
 void Vector<T, vector_impl::kGeneric>::Append(size_type count, const T& value) {
-  for (size_t i = 0; i < count; ++i) {
-    push_back(value);
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    const size_t to_add = std::min(size_t(count), max_size() - size());
+    std::uninitialized_fill_n(end(), to_add, value);
+    size_ += static_cast<size_type>(to_add);
+  } else {
+    for (size_t i = 0; i < count; ++i) {
+      push_back(value);
+    }
   }
 }
 
@@ -0,0 +1,180 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <tuple>
+#include <utility>
+
+#include "pw_containers/vector.h"
+
+namespace pw::containers {
+
+// A sorted associative array backed by a pw::Vector, the mutable counterpart of
+// FlatMap. Entries are kept sorted by key in contiguous storage, so lookups
+// are binary searches over a compact array, which for maps of up to a few
+// hundred entries is faster and smaller than node-based or hashed maps.
+// Inserting and erasing move the entries after the position.
+//
+//   VectorMap<uint16_t, Channel*, 32> channels;
+//   channels.insert({id, &channel});
+//
+// Inserting into a full VectorMap fails rather than growing it: insert() and
+// try_emplace() return end() and false. Insertion and removal invalidate
+// iterators. Keys must not be modified through iterators.
+template <typename Key, typename Value, size_t kMaxSize>
+class VectorMap {
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<Key, Value>;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using container_type = Vector<value_type, kMaxSize>;
+  using iterator = typename container_type::iterator;
+  using const_iterator = typename container_type::const_iterator;
+
+  VectorMap() = default;
+
+  // Entries may be given in any order. If a key is repeated, the first entry
+  // for it is kept.
+  VectorMap(std::initializer_list<value_type> list) { insert(list); }
+
+  // Capacity.
+  [[nodiscard]] bool empty() const noexcept { return items_.empty(); }
+  [[nodiscard]] bool full() const noexcept { return items_.full(); }
+  size_type size() const noexcept { return items_.size(); }
+  size_type max_size() const noexcept { return items_.max_size(); }
+
+  // Lookup.
+  bool contains(const key_type& key) const { return find(key) != end(); }
+
+  size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+  iterator find(const key_type& key) {
+    return begin() + (std::as_const(*this).find(key) - cbegin());
+  }
+
+  const_iterator find(const key_type& key) const {
+    const_iterator it = lower_bound(key);
+    return it != end() && !(key < it->first) ? it : end();
+  }
+
+  iterator lower_bound(const key_type& key) {
+    return begin() + (std::as_const(*this).lower_bound(key) - cbegin());
+  }
+
+  // Finds the first entry with a key not less than key. The search is
+  // branchless: each step halves the range with a conditional move rather
+  // than a branch the CPU must predict, so its cost depends only on the size.
+  const_iterator lower_bound(const key_type& key) const {
+    size_type count = size();
+    if (count == 0u) {
+      return end();
+    }
+
+    const_iterator base = begin();
+    while (count > 1u) {
+      const size_type half = count / 2;
+      base = base[half].first < key ? base + half : base;
+      count -= half;
+    }
+    return base + (base->first < key ? 1 : 0);
+  }
+
+  iterator upper_bound(const key_type& key) {
+    return begin() + (std::as_const(*this).upper_bound(key) - cbegin());
+  }
+
+  const_iterator upper_bound(const key_type& key) const {
+    const_iterator it = lower_bound(key);
+    return it != end() && !(key < it->first) ? it + 1 : it;
+  }
+
+  // Modifiers.
+
+  // Inserts an entry constructed from key and args, unless the key is already
+  // present. Returns the entry for the key and whether it was inserted, or
+  // end() and false if the key is absent and the VectorMap is full.
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+    iterator it = lower_bound(key);
+    if (it != end() && !(key < it->first)) {
+      return {it, false};
+    }
+    if (full()) {
+      return {end(), false};
+    }
+    return {items_.emplace(it,
+                           std::piecewise_construct,
+                           std::forward_as_tuple(key),
+                           std::forward_as_tuple(std::forward<Args>(args)...)),
+            true};
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return try_emplace(value.first, value.second);
+  }
+
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return try_emplace(value.first, std::move(value.second));
+  }
+
+  void insert(std::initializer_list<value_type> list) {
+    for (const value_type& value : list) {
+      insert(value);
+    }
+  }
+
+  // Inserts an entry, or assigns to the value of the existing entry for the
+  // key. Returns end() and false if the key is absent and the map is full.
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& value) {
+    iterator it = find(key);
+    if (it != end()) {
+      it->second = std::forward<M>(value);
+      return {it, false};
+    }
+    return try_emplace(key, std::forward<M>(value));
+  }
+
+  // Removes the entry for the key, if any. Returns the number removed.
+  size_type erase(const key_type& key) {
+    const_iterator it = find(key);
+    if (it == end()) {
+      return 0;
+    }
+    items_.erase(it);
+    return 1;
+  }
+
+  // Removes the entry at a valid iterator. Returns the entry after it.
+  iterator erase(const_iterator position) { return items_.erase(position); }
+
+  void clear() noexcept { items_.clear(); }
+
+  // Iterators, which visit entries in key order.
+  iterator begin() noexcept { return items_.begin(); }
+  const_iterator begin() const noexcept { return items_.begin(); }
+  const_iterator cbegin() const noexcept { return items_.cbegin(); }
+  iterator end() noexcept { return items_.end(); }
+  const_iterator end() const noexcept { return items_.end(); }
+  const_iterator cend() const noexcept { return items_.cend(); }
+
+ private:
+  container_type items_;
+};
+
+}  // namespace pw::containers
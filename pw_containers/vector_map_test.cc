@@ -0,0 +1,166 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/vector_map.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+
+#include "gtest/gtest.h"
+
+namespace pw::containers {
+namespace {
+
+template <typename Map>
+bool IsSorted(const Map& map) {
+  return std::is_sorted(map.begin(), map.end(), [](auto& lhs, auto& rhs) {
+    return lhs.first < rhs.first;
+  });
+}
+
+TEST(VectorMap, Construct_Empty) {
+  VectorMap<int, char, 4> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(0u, map.size());
+  EXPECT_EQ(4u, map.max_size());
+  EXPECT_EQ(map.end(), map.find(1));
+  EXPECT_EQ(map.end(), map.lower_bound(1));
+  EXPECT_EQ(map.end(), map.upper_bound(1));
+}
+
+TEST(VectorMap, Construct_InitializerListIsSorted) {
+  VectorMap<int, char, 5> map = {{50, 'd'}, {-3, 'a'}, {1, 'c'}, {0, 'b'}};
+  EXPECT_EQ(4u, map.size());
+  EXPECT_TRUE(IsSorted(map));
+  EXPECT_EQ(-3, map.begin()->first);
+  EXPECT_EQ('c', map.find(1)->second);
+}
+
+TEST(VectorMap, Construct_InitializerListKeepsFirstDuplicate) {
+  VectorMap<int, char, 5> map = {{1, 'a'}, {1, 'b'}};
+  EXPECT_EQ(1u, map.size());
+  EXPECT_EQ('a', map.find(1)->second);
+}
+
+TEST(VectorMap, Insert_KeepsOrder) {
+  VectorMap<int, int, 8> map;
+  for (int key : {5, 1, 7, 3, 2, 8, 6, 4}) {
+    auto [it, inserted] = map.insert({key, key * 10});
+    ASSERT_TRUE(inserted);
+    EXPECT_EQ(key, it->first);
+    EXPECT_EQ(key * 10, it->second);
+  }
+  EXPECT_TRUE(IsSorted(map));
+  EXPECT_TRUE(map.full());
+}
+
+TEST(VectorMap, Insert_ExistingKey) {
+  VectorMap<int, int, 4> map = {{1, 10}};
+  auto [it, inserted] = map.insert({1, 11});
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(map.begin(), it);
+  EXPECT_EQ(10, it->second);
+}
+
+TEST(VectorMap, Insert_FailsWhenFull) {
+  VectorMap<int, int, 2> map = {{1, 10}, {3, 30}};
+  auto result = map.insert({2, 20});
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(map.end(), result.first);
+  EXPECT_FALSE(map.contains(2));
+
+  result = map.insert({3, 31});
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(30, result.first->second);
+}
+
+TEST(VectorMap, InsertOrAssign) {
+  VectorMap<int, int, 4> map;
+  EXPECT_TRUE(map.insert_or_assign(2, 20).second);
+  EXPECT_FALSE(map.insert_or_assign(2, 21).second);
+  EXPECT_EQ(21, map.find(2)->second);
+}
+
+TEST(VectorMap, Bounds) {
+  VectorMap<int, char, 5> map = {{-3, 'a'}, {0, 'b'}, {1, 'c'}, {50, 'd'}};
+  EXPECT_EQ(map.begin(), map.lower_bound(-10));
+  EXPECT_EQ(map.begin(), map.lower_bound(-3));
+  EXPECT_EQ(map.begin() + 1, map.upper_bound(-3));
+  EXPECT_EQ(map.begin() + 3, map.lower_bound(2));
+  EXPECT_EQ(map.begin() + 3, map.upper_bound(2));
+  EXPECT_EQ(map.begin() + 3, map.lower_bound(50));
+  EXPECT_EQ(map.end(), map.upper_bound(50));
+  EXPECT_EQ(map.end(), map.lower_bound(51));
+}
+
+TEST(VectorMap, LowerBound_MatchesStdLowerBoundForAllSizes) {
+  VectorMap<int, int, 33> map;
+  for (int size = 0; size <= 33; ++size) {
+    for (int key = -1; key <= 2 * size + 1; ++key) {
+      auto expected = std::lower_bound(
+          map.begin(), map.end(), key, [](const auto& item, int k) {
+            return item.first < k;
+          });
+      ASSERT_EQ(expected, map.lower_bound(key));
+    }
+    map.insert({2 * size, size});
+  }
+}
+
+TEST(VectorMap, Erase_ByKey) {
+  VectorMap<int, int, 4> map = {{1, 10}, {2, 20}, {3, 30}};
+  EXPECT_EQ(1u, map.erase(2));
+  EXPECT_EQ(0u, map.erase(2));
+  EXPECT_EQ(2u, map.size());
+  EXPECT_FALSE(map.contains(2));
+  EXPECT_EQ(30, map.find(3)->second);
+  EXPECT_TRUE(IsSorted(map));
+}
+
+TEST(VectorMap, Erase_ByIterator) {
+  VectorMap<int, int, 4> map = {{1, 10}, {2, 20}, {3, 30}};
+  auto it = map.erase(map.begin());
+  EXPECT_EQ(2, it->first);
+  EXPECT_EQ(2u, map.size());
+}
+
+TEST(VectorMap, MatchesStdMap) {
+  VectorMap<unsigned, unsigned, 64> map;
+  std::map<unsigned, unsigned> expected;
+
+  unsigned key = 1;
+  for (unsigned i = 0; i < 1000; ++i) {
+    key = key * 1103515245u + 12345u;
+    const unsigned small_key = (key >> 16) % 100;
+    if (key % 3 == 0) {
+      EXPECT_EQ(expected.erase(small_key), map.erase(small_key));
+    } else if (!map.full()) {
+      EXPECT_EQ(expected.insert({small_key, i}).second,
+                map.insert({small_key, i}).second);
+    }
+  }
+
+  ASSERT_EQ(expected.size(), map.size());
+  EXPECT_TRUE(std::equal(map.begin(),
+                         map.end(),
+                         expected.begin(),
+                         [](const auto& lhs, const auto& rhs) {
+                           return lhs.first == rhs.first &&
+                                  lhs.second == rhs.second;
+                         }));
+}
+
+}  // namespace
+}  // namespace pw::containers
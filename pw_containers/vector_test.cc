@@ -15,6 +15,7 @@
 #include "pw_containers/vector.h"
 
 #include <cstddef>
+#include <type_traits>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -52,6 +53,12 @@ struct MoveOnly {
     other.value = kDeleted;
   }
 
+  MoveOnly& operator=(MoveOnly&& other) {
+    value = other.value;
+    other.value = kDeleted;
+    return *this;
+  }
+
   static constexpr int kDeleted = -1138;
 
   int value;
@@ -75,6 +82,13 @@ struct Counter {
     moved += 1;
   }
 
+  Counter& operator=(Counter&& other) {
+    value = other.value;
+    other.value = 0;
+    moved += 1;
+    return *this;
+  }
+
   ~Counter() { destroyed += 1; }
 
   int value;
@@ -408,6 +422,129 @@ TEST(Vector, Modify_Resize_Zero) {
   EXPECT_EQ(vector.size(), 0u);
 }
 
+TEST(Vector, Modify_Insert_Middle) {
+  Vector<int, 5> vector{1, 2, 4};
+  Vector<int, 5>::iterator it = vector.insert(vector.begin() + 2, 3);
+
+  EXPECT_EQ(it, vector.begin() + 2);
+  EXPECT_EQ(vector, (Vector<int, 5>{1, 2, 3, 4}));
+
+  vector.insert(vector.begin(), 0);
+  EXPECT_EQ(vector, (Vector<int, 5>{0, 1, 2, 3, 4}));
+}
+
+TEST(Vector, Modify_Insert_End) {
+  Vector<int, 5> vector{1, 2};
+  EXPECT_EQ(vector.insert(vector.end(), 3), vector.begin() + 2);
+  EXPECT_EQ(vector, (Vector<int, 5>{1, 2, 3}));
+}
+
+TEST(Vector, Modify_Insert_Full) {
+  Vector<int, 2> vector{1, 2};
+  EXPECT_EQ(vector.insert(vector.begin(), 0), vector.end());
+  EXPECT_EQ(vector, (Vector<int, 2>{1, 2}));
+}
+
+TEST(Vector, Modify_Insert_ItemFromVector) {
+  Vector<int, 5> vector{1, 2, 3};
+  vector.insert(vector.begin(), vector.back());
+  EXPECT_EQ(vector, (Vector<int, 5>{3, 1, 2, 3}));
+}
+
+TEST(Vector, Modify_Emplace_Move) {
+  Vector<MoveOnly, 4> vector;
+  vector.emplace_back(1);
+  vector.emplace_back(3);
+  vector.emplace(vector.begin() + 1, 2);
+
+  ASSERT_EQ(vector.size(), 3u);
+  EXPECT_EQ(vector[0].value, 1);
+  EXPECT_EQ(vector[1].value, 2);
+  EXPECT_EQ(vector[2].value, 3);
+}
+
+TEST(Vector, Modify_Erase) {
+  Counter::Reset();
+  {
+    Vector<Counter, 5> vector{1, 2, 3, 4};
+    Counter::Reset();
+
+    Vector<Counter, 5>::iterator it = vector.erase(vector.begin() + 1);
+    EXPECT_EQ(it->value, 3);
+    ASSERT_EQ(vector.size(), 3u);
+    EXPECT_EQ(vector[0].value, 1);
+    EXPECT_EQ(vector[1].value, 3);
+    EXPECT_EQ(vector[2].value, 4);
+    EXPECT_EQ(Counter::destroyed, 1);
+
+    it = vector.erase(vector.end() - 1);
+    EXPECT_EQ(it, vector.end());
+    EXPECT_EQ(vector.size(), 2u);
+  }
+}
+
+TEST(Vector, Modify_Erase_Range) {
+  Vector<int, 6> vector{0, 1, 2, 3, 4, 5};
+  Vector<int, 6>::iterator it =
+      vector.erase(vector.begin() + 1, vector.begin() + 4);
+
+  EXPECT_EQ(*it, 4);
+  EXPECT_EQ(vector, (Vector<int, 6>{0, 4, 5}));
+
+  vector.erase(vector.begin(), vector.end());
+  EXPECT_TRUE(vector.empty());
+}
+
+TEST(Vector, Modify_Append) {
+  constexpr int kItems[] = {3, 4, 5};
+  Vector<int, 6> vector{1, 2};
+
+  vector.append(kItems);
+  EXPECT_EQ(vector, (Vector<int, 6>{1, 2, 3, 4, 5}));
+
+  vector.append(kItems);
+  EXPECT_EQ(vector, (Vector<int, 6>{1, 2, 3, 4, 5, 3}));
+}
+
+TEST(Vector, Modify_Append_NonTrivial) {
+  const Counter items[] = {1, 2, 3};
+  Vector<Counter, 2> vector;
+
+  vector.append(items);
+  ASSERT_EQ(vector.size(), 2u);
+  EXPECT_EQ(vector[0].value, 1);
+  EXPECT_EQ(vector[1].value, 2);
+}
+
+TEST(Vector, TriviallyCopyable_CopyInsertErase) {
+  struct Point {
+    int x;
+    int y;
+  };
+  static_assert(std::is_trivially_copyable_v<Point>);
+
+  Vector<Point, 5> vector{{1, 1}, {3, 3}};
+  vector.insert(vector.begin() + 1, Point{2, 2});
+  vector.insert(vector.begin(), Point{0, 0});
+  ASSERT_EQ(vector.size(), 4u);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(vector[i].x, i);
+  }
+
+  Vector<Point, 3> copy(vector);
+  ASSERT_EQ(copy.size(), 3u);
+  EXPECT_EQ(copy[2].y, 2);
+
+  Vector<Point, 5> moved(std::move(vector));
+  EXPECT_TRUE(vector.empty());
+  ASSERT_EQ(moved.size(), 4u);
+
+  moved.erase(moved.begin(), moved.begin() + 2);
+  ASSERT_EQ(moved.size(), 2u);
+  EXPECT_EQ(moved[0].x, 2);
+  EXPECT_EQ(moved[1].x, 3);
+}
+
 TEST(Vector, Generic) {
   Vector<int, 10> vector{1, 2, 3, 4, 5};
 
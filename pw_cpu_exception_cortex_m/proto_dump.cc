@@ -11,10 +11,13 @@
 // WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
 // License for the specific language governing permissions and limitations under
 // the License.
+#include "pw_cpu_exception_cortex_m/proto_dump.h"
+
 #include "pw_cpu_exception_cortex_m/cpu_state.h"
 #include "pw_cpu_exception_cortex_m_protos/cpu_state.pwpb.h"
 #include "pw_preprocessor/compiler.h"
 #include "pw_protobuf/encoder.h"
+#include "pw_protobuf/stream_encoder.h"
 
 namespace pw::cpu_exception {
 
@@ -61,4 +64,45 @@ Status DumpCpuStateProto(protobuf::Encoder& dest,
   return OkStatus();
 }
 
+Status DumpCpuStateProto(protobuf::StreamEncoder& dest,
+                         const pw_cpu_exception_State& cpu_state) {
+  using Fields = cortex_m::ArmV7mCpuState::Fields;
+  const auto write = [&dest](Fields field, uint32_t value) {
+    dest.WriteUint32(static_cast<uint32_t>(field), value);
+  };
+
+  // Special and mem-mapped registers.
+  write(Fields::PC, cpu_state.base.pc);
+  write(Fields::LR, cpu_state.base.lr);
+  write(Fields::PSR, cpu_state.base.psr);
+  write(Fields::MSP, cpu_state.extended.msp);
+  write(Fields::PSP, cpu_state.extended.psp);
+  write(Fields::EXC_RETURN, cpu_state.extended.exc_return);
+  write(Fields::CFSR, cpu_state.extended.cfsr);
+  write(Fields::MMFAR, cpu_state.extended.mmfar);
+  write(Fields::BFAR, cpu_state.extended.bfar);
+  write(Fields::ICSR, cpu_state.extended.icsr);
+  write(Fields::HFSR, cpu_state.extended.hfsr);
+  write(Fields::SHCSR, cpu_state.extended.shcsr);
+  write(Fields::CONTROL, cpu_state.extended.control);
+
+  // General purpose registers.
+  write(Fields::R0, cpu_state.base.r0);
+  write(Fields::R1, cpu_state.base.r1);
+  write(Fields::R2, cpu_state.base.r2);
+  write(Fields::R3, cpu_state.base.r3);
+  write(Fields::R4, cpu_state.extended.r4);
+  write(Fields::R5, cpu_state.extended.r5);
+  write(Fields::R6, cpu_state.extended.r6);
+  write(Fields::R7, cpu_state.extended.r7);
+  write(Fields::R8, cpu_state.extended.r8);
+  write(Fields::R9, cpu_state.extended.r9);
+  write(Fields::R10, cpu_state.extended.r10);
+  write(Fields::R11, cpu_state.extended.r11);
+  write(Fields::R12, cpu_state.base.r12);
+
+  // Errors are sticky, so a failed write is reflected here.
+  return dest.status();
+}
+
 }  // namespace pw::cpu_exception
@@ -13,15 +13,24 @@
 // the License.
 #pragma once
 
+#include <cstddef>
+
 #include "pw_cpu_exception_cortex_m/cpu_state.h"
 #include "pw_protobuf/encoder.h"
+#include "pw_protobuf/stream_encoder.h"
 #include "pw_status/status.h"
 
 namespace pw::cpu_exception {
 
+// The maximum size of an encoded ArmV7mCpuState proto. Each of the 26 uint32
+// fields takes up to 5 bytes, plus a 1-byte key, or a 2-byte key for fields 16
+// and up.
+inline constexpr size_t kMaxCpuStateProtoSizeBytes =
+    15 * (1 + 5) + 11 * (2 + 5);
+
 // Dumps the cpu state struct as a proto (defined in
 // pw_cpu_exception_cortex_m_protos/cpu_state.proto). The final proto is up to
-// 144 bytes in size, so ensure your encoder is properly sized.
+// kMaxCpuStateProtoSizeBytes in size, so ensure your encoder is properly sized.
 //
 // Returns:
 //   OK - Entire proto was written to the encoder.
@@ -30,4 +39,11 @@ namespace pw::cpu_exception {
 Status DumpCpuStateProto(protobuf::Encoder& dest,
                          const pw_cpu_exception_State& cpu_state);
 
+// Writes the fields of the cpu state proto to a streaming encoder, which may
+// write them straight to a stream::Writer or be the nested encoder for a field
+// of a larger message, such as ArmV7mSnapshot's cpu_state. Returns the
+// encoder's status.
+Status DumpCpuStateProto(protobuf::StreamEncoder& dest,
+                         const pw_cpu_exception_State& cpu_state);
+
 }  // namespace pw::cpu_exception
@@ -0,0 +1,87 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "pw_bytes/span.h"
+#include "pw_cpu_exception_cortex_m/cpu_state.h"
+#include "pw_cpu_exception_cortex_m/proto_dump.h"
+#include "pw_protobuf/stream_encoder.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+
+namespace pw::cpu_exception {
+
+// Writes an ArmV7mSnapshot proto (defined in
+// pw_cpu_exception_cortex_m_protos/cpu_state.proto) straight to a
+// stream::Writer, such as a flash partition or a UART, as each part of the
+// crash is captured. The stack and the log and trace entries are written from
+// where they are in memory, without being copied. Only the CPU state is
+// buffered, in kMaxCpuStateProtoSizeBytes bytes within the SnapshotWriter, so
+// its length can be written before it.
+//
+//   void pw_cpu_exception_DefaultHandler(pw_cpu_exception_State* state) {
+//     SnapshotWriter snapshot(crash_writer);
+//     snapshot.WriteCpuState(*state);
+//     snapshot.WriteStack(FaultingStack(*state), kMaxStackSizeBytes);
+//     trace_reader.PeekAndPopFront(
+//         [&snapshot](std::byte, ConstByteSpan data, ConstByteSpan wrapped) {
+//           return snapshot.WriteTraceEntry(data, wrapped);
+//         });
+//     ...
+//   }
+//
+// Errors are sticky: after a write fails, all further writes return the same
+// error, which is also returned by status().
+class SnapshotWriter {
+ public:
+  explicit SnapshotWriter(stream::Writer& writer)
+      : encoder_(writer, scratch_buffer_) {}
+
+  SnapshotWriter(const SnapshotWriter&) = delete;
+  SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+  // Writes the CPU state registers.
+  Status WriteCpuState(const pw_cpu_exception_State& cpu_state);
+
+  // Writes the address of the stack and up to max_size_bytes of it. stack is
+  // the used part of the stack, from the stack pointer up to the top of the
+  // stack; the bytes closest to the stack pointer are written.
+  Status WriteStack(ConstByteSpan stack, size_t max_size_bytes);
+
+  // Writes a log or trace entry. The entry is data followed by wrapped_data,
+  // which matches the arguments that PrefixedEntryRingBuffer's
+  // PeekAndPopFront() passes for an entry that wraps around the buffer.
+  Status WriteLogEntry(ConstByteSpan data,
+                       ConstByteSpan wrapped_data = ConstByteSpan());
+
+  Status WriteTraceEntry(ConstByteSpan data,
+                         ConstByteSpan wrapped_data = ConstByteSpan());
+
+  // Returns OK if every part of the snapshot has been written, or the first
+  // error otherwise.
+  Status status() const { return encoder_.status(); }
+
+ private:
+  Status WriteEntry(uint32_t field_number,
+                    ConstByteSpan data,
+                    ConstByteSpan wrapped_data);
+
+  std::array<std::byte, kMaxCpuStateProtoSizeBytes> scratch_buffer_;
+  protobuf::StreamEncoder encoder_;
+};
+
+}  // namespace pw::cpu_exception
@@ -0,0 +1,64 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_cpu_exception_cortex_m/snapshot.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "pw_cpu_exception_cortex_m_protos/cpu_state.pwpb.h"
+
+namespace pw::cpu_exception {
+
+using Fields = cortex_m::ArmV7mSnapshot::Fields;
+
+Status SnapshotWriter::WriteCpuState(const pw_cpu_exception_State& cpu_state) {
+  {
+    protobuf::StreamEncoder cpu_state_encoder =
+        encoder_.GetNestedEncoder(static_cast<uint32_t>(Fields::CPU_STATE));
+    DumpCpuStateProto(cpu_state_encoder, cpu_state);
+  }  // The CPU state is written here.
+  return encoder_.status();
+}
+
+Status SnapshotWriter::WriteStack(ConstByteSpan stack, size_t max_size_bytes) {
+  encoder_.WriteUint64(static_cast<uint32_t>(Fields::STACK_POINTER),
+                       reinterpret_cast<uintptr_t>(stack.data()));
+  return encoder_.WriteBytes(
+      static_cast<uint32_t>(Fields::STACK),
+      stack.first(std::min(stack.size(), max_size_bytes)));
+}
+
+Status SnapshotWriter::WriteLogEntry(ConstByteSpan data,
+                                     ConstByteSpan wrapped_data) {
+  return WriteEntry(static_cast<uint32_t>(Fields::LOG_ENTRIES),
+                    data,
+                    wrapped_data);
+}
+
+Status SnapshotWriter::WriteTraceEntry(ConstByteSpan data,
+                                       ConstByteSpan wrapped_data) {
+  return WriteEntry(static_cast<uint32_t>(Fields::TRACE_ENTRIES),
+                    data,
+                    wrapped_data);
+}
+
+Status SnapshotWriter::WriteEntry(uint32_t field_number,
+                                  ConstByteSpan data,
+                                  ConstByteSpan wrapped_data) {
+  const ConstByteSpan chunks[] = {data, wrapped_data};
+  return encoder_.WriteBytes(field_number, chunks);
+}
+
+}  // namespace pw::cpu_exception
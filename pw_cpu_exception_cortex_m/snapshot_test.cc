@@ -0,0 +1,199 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_cpu_exception_cortex_m/snapshot.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_cpu_exception_cortex_m_protos/cpu_state.pwpb.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::cpu_exception {
+namespace {
+
+using SnapshotFields = cortex_m::ArmV7mSnapshot::Fields;
+using CpuStateFields = cortex_m::ArmV7mCpuState::Fields;
+
+constexpr std::byte kStack[] = {
+    std::byte{0x10}, std::byte{0x11}, std::byte{0x12}, std::byte{0x13}};
+constexpr std::byte kEntry[] = {std::byte{'a'}, std::byte{'b'}, std::byte{'c'}};
+
+// Counts the calls to Write(), which go straight to memory.
+class CountingWriter : public stream::Writer {
+ public:
+  CountingWriter(ByteSpan buffer) : writer_(buffer) {}
+
+  size_t writes() const { return writes_; }
+  ConstByteSpan data() const {
+    return ConstByteSpan(writer_.data(), writer_.bytes_written());
+  }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    writes_ += 1;
+    return writer_.Write(data);
+  }
+
+  stream::MemoryWriter writer_;
+  size_t writes_ = 0;
+};
+
+pw_cpu_exception_State TestCpuState() {
+  pw_cpu_exception_State state = {};
+  state.base.pc = 0x08001234;
+  state.base.lr = 0x08005678;
+  state.base.r12 = 12;
+  state.extended.cfsr = 0x00020000;
+  state.extended.shcsr = 0x00070000;
+  state.extended.r11 = 0xffffffff;
+  return state;
+}
+
+bool SameBytes(ConstByteSpan actual, ConstByteSpan expected) {
+  return actual.size() == expected.size() &&
+         std::memcmp(actual.data(), expected.data(), actual.size()) == 0;
+}
+
+TEST(SnapshotWriter, WriteCpuState_MatchesDumpCpuStateProto) {
+  const pw_cpu_exception_State state = TestCpuState();
+
+  std::array<std::byte, 256> expected_buffer;
+  protobuf::NestedEncoder expected(expected_buffer);
+  ASSERT_EQ(OkStatus(), DumpCpuStateProto(expected, state));
+  Result<ConstByteSpan> expected_proto = expected.Encode();
+  ASSERT_EQ(OkStatus(), expected_proto.status());
+
+  std::array<std::byte, 256> buffer;
+  CountingWriter writer(buffer);
+  SnapshotWriter snapshot(writer);
+  ASSERT_EQ(OkStatus(), snapshot.WriteCpuState(state));
+
+  protobuf::Decoder decoder(writer.data());
+  ASSERT_EQ(OkStatus(), decoder.Next());
+  EXPECT_EQ(static_cast<uint32_t>(SnapshotFields::CPU_STATE),
+            decoder.FieldNumber());
+  ConstByteSpan cpu_state;
+  ASSERT_EQ(OkStatus(), decoder.ReadBytes(&cpu_state));
+  EXPECT_TRUE(SameBytes(cpu_state, expected_proto.value()));
+  EXPECT_EQ(Status::OutOfRange(), decoder.Next());
+
+  // The nested message is written with its key and length.
+  EXPECT_EQ(2u, writer.writes());
+}
+
+TEST(SnapshotWriter, WriteCpuState_LargestStateFitsScratchBuffer) {
+  pw_cpu_exception_State state;
+  std::memset(&state, 0xff, sizeof(state));
+
+  std::array<std::byte, 256> buffer;
+  stream::MemoryWriter writer(buffer);
+  SnapshotWriter snapshot(writer);
+  EXPECT_EQ(OkStatus(), snapshot.WriteCpuState(state));
+
+  protobuf::Decoder decoder(writer.WrittenData());
+  ASSERT_EQ(OkStatus(), decoder.Next());
+  ConstByteSpan cpu_state;
+  ASSERT_EQ(OkStatus(), decoder.ReadBytes(&cpu_state));
+  EXPECT_EQ(kMaxCpuStateProtoSizeBytes, cpu_state.size());
+}
+
+TEST(SnapshotWriter, WriteStack_WritesBoundedWindowInPlace) {
+  std::array<std::byte, 64> buffer;
+  CountingWriter writer(buffer);
+  SnapshotWriter snapshot(writer);
+  ASSERT_EQ(OkStatus(), snapshot.WriteStack(kStack, 3));
+
+  protobuf::Decoder decoder(writer.data());
+  ASSERT_EQ(OkStatus(), decoder.Next());
+  EXPECT_EQ(static_cast<uint32_t>(SnapshotFields::STACK_POINTER),
+            decoder.FieldNumber());
+  uint64_t stack_pointer = 0;
+  ASSERT_EQ(OkStatus(), decoder.ReadUint64(&stack_pointer));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(kStack), stack_pointer);
+
+  ASSERT_EQ(OkStatus(), decoder.Next());
+  EXPECT_EQ(static_cast<uint32_t>(SnapshotFields::STACK),
+            decoder.FieldNumber());
+  ConstByteSpan stack;
+  ASSERT_EQ(OkStatus(), decoder.ReadBytes(&stack));
+  EXPECT_TRUE(SameBytes(stack, std::span(kStack).first(3)));
+
+  // The stack pointer, then the key and length and the stack itself.
+  EXPECT_EQ(3u, writer.writes());
+}
+
+TEST(SnapshotWriter, WriteStack_SmallerThanBound) {
+  std::array<std::byte, 64> buffer;
+  stream::MemoryWriter writer(buffer);
+  SnapshotWriter snapshot(writer);
+  ASSERT_EQ(OkStatus(), snapshot.WriteStack(kStack, 512));
+
+  protobuf::Decoder decoder(writer.WrittenData());
+  ASSERT_EQ(OkStatus(), decoder.Next());
+  ASSERT_EQ(OkStatus(), decoder.Next());
+  ConstByteSpan stack;
+  ASSERT_EQ(OkStatus(), decoder.ReadBytes(&stack));
+  EXPECT_TRUE(SameBytes(stack, kStack));
+}
+
+TEST(SnapshotWriter, WriteEntries_JoinsWrappedData) {
+  std::array<std::byte, 64> buffer;
+  stream::MemoryWriter writer(buffer);
+  SnapshotWriter snapshot(writer);
+  ASSERT_EQ(OkStatus(), snapshot.WriteLogEntry(kEntry));
+  ASSERT_EQ(OkStatus(),
+            snapshot.WriteTraceEntry(std::span(kEntry).first(1),
+                                     std::span(kEntry).subspan(1)));
+
+  protobuf::Decoder decoder(writer.WrittenData());
+  ConstByteSpan entry;
+  ASSERT_EQ(OkStatus(), decoder.Next());
+  EXPECT_EQ(static_cast<uint32_t>(SnapshotFields::LOG_ENTRIES),
+            decoder.FieldNumber());
+  ASSERT_EQ(OkStatus(), decoder.ReadBytes(&entry));
+  EXPECT_TRUE(SameBytes(entry, kEntry));
+
+  ASSERT_EQ(OkStatus(), decoder.Next());
+  EXPECT_EQ(static_cast<uint32_t>(SnapshotFields::TRACE_ENTRIES),
+            decoder.FieldNumber());
+  ASSERT_EQ(OkStatus(), decoder.ReadBytes(&entry));
+  EXPECT_TRUE(SameBytes(entry, kEntry));
+}
+
+TEST(SnapshotWriter, WriterFull_ErrorIsSticky) {
+  std::array<std::byte, 8> buffer;
+  stream::MemoryWriter writer(buffer);
+  SnapshotWriter snapshot(writer);
+
+  EXPECT_EQ(OkStatus(), snapshot.WriteLogEntry(kEntry));
+  EXPECT_EQ(Status::ResourceExhausted(),
+            snapshot.WriteCpuState(TestCpuState()));
+  EXPECT_EQ(Status::ResourceExhausted(), snapshot.WriteLogEntry(kEntry));
+  EXPECT_EQ(Status::ResourceExhausted(), snapshot.status());
+
+  // The entry written before the error is intact.
+  protobuf::Decoder decoder(writer.WrittenData());
+  ConstByteSpan entry;
+  ASSERT_EQ(OkStatus(), decoder.Next());
+  ASSERT_EQ(OkStatus(), decoder.ReadBytes(&entry));
+  EXPECT_TRUE(SameBytes(entry, kEntry));
+}
+
+}  // namespace
+}  // namespace pw::cpu_exception
@@ -0,0 +1,161 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_fuzzer/execution_budget.h"
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+#include "pw_assert/assert.h"
+#include "pw_log/log.h"
+
+// Provided by the sanitizer runtimes that replace malloc, such as ASan. The
+// declaration is weak so that fuzzers can be built without them, for example
+// when they run as unit tests.
+extern "C" int __sanitizer_install_malloc_and_free_hooks(
+    void (*malloc_hook)(const volatile void*, size_t),
+    void (*free_hook)(const volatile void*)) __attribute__((weak));
+
+namespace pw::fuzzer {
+namespace {
+
+std::atomic<size_t> total_allocations{0};
+std::atomic<size_t> total_allocated_bytes{0};
+
+void MallocHook(const volatile void*, size_t size) {
+  total_allocations.fetch_add(1, std::memory_order_relaxed);
+  total_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void FreeHook(const volatile void*) {}
+
+// Installs the allocation hooks the first time it is called.
+bool AllocationsCounted() {
+  static const bool installed =
+      __sanitizer_install_malloc_and_free_hooks != nullptr &&
+      __sanitizer_install_malloc_and_free_hooks(MallocHook, FreeHook) != 0;
+  return installed;
+}
+
+template <typename T>
+T SaturatingLimit(T base, T per_byte, size_t input_size) {
+  constexpr T kMax = std::numeric_limits<T>::max();
+  if (base == kMax) {
+    return kMax;
+  }
+  if (per_byte != 0 &&
+      static_cast<uintmax_t>(input_size) >
+          static_cast<uintmax_t>((kMax - base) / per_byte)) {
+    return kMax;
+  }
+  return base + per_byte * static_cast<T>(input_size);
+}
+
+}  // namespace
+
+std::chrono::nanoseconds ExecutionBudget::TimeLimit(size_t input_size) const {
+  return std::chrono::nanoseconds(SaturatingLimit(
+      time_.count(), time_per_byte_.count(), input_size));
+}
+
+size_t ExecutionBudget::AllocationLimit(size_t input_size) const {
+  return SaturatingLimit(allocations_, allocations_per_byte_, input_size);
+}
+
+size_t ExecutionBudget::AllocatedBytesLimit(size_t input_size) const {
+  return SaturatingLimit(
+      allocated_bytes_, allocated_bytes_per_byte_, input_size);
+}
+
+Status ExecutionBudget::Check(const ExecutionCost& cost,
+                              size_t input_size) const {
+  if (cost.time > TimeLimit(input_size)) {
+    return Status::DeadlineExceeded();
+  }
+  if (cost.allocations_counted &&
+      (cost.allocations > AllocationLimit(input_size) ||
+       cost.allocated_bytes > AllocatedBytesLimit(input_size))) {
+    return Status::ResourceExhausted();
+  }
+  return OkStatus();
+}
+
+ExecutionMeter::ExecutionMeter()
+    : start_allocations_(
+          AllocationsCounted()
+              ? total_allocations.load(std::memory_order_relaxed)
+              : 0),
+      start_allocated_bytes_(
+          total_allocated_bytes.load(std::memory_order_relaxed)) {
+  // Start the clock last, so that installing the hooks is not measured.
+  start_ = chrono::SystemClock::now();
+}
+
+ExecutionCost ExecutionMeter::cost() const {
+  const chrono::SystemClock::time_point end = chrono::SystemClock::now();
+
+  ExecutionCost cost;
+  cost.time = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start_);
+  cost.allocations_counted = AllocationsCounted();
+  cost.allocations = 0;
+  cost.allocated_bytes = 0;
+
+  if (cost.allocations_counted) {
+    cost.allocations =
+        total_allocations.load(std::memory_order_relaxed) - start_allocations_;
+    cost.allocated_bytes =
+        total_allocated_bytes.load(std::memory_order_relaxed) -
+        start_allocated_bytes_;
+  }
+  return cost;
+}
+
+BudgetScope::~BudgetScope() {
+  const ExecutionCost cost = meter_.cost();
+
+  if (!cost.allocations_counted &&
+      (budget_.AllocationLimit(input_size_) != ExecutionBudget::kUnlimited ||
+       budget_.AllocatedBytesLimit(input_size_) !=
+           ExecutionBudget::kUnlimited)) {
+    static bool warned = false;
+    if (!warned) {
+      warned = true;
+      PW_LOG_WARN(
+          "Allocations cannot be counted without a sanitizer allocator; "
+          "allocation budgets are not checked");
+    }
+  }
+
+  const Status status = budget_.Check(cost, input_size_);
+  if (status.ok()) {
+    return;
+  }
+
+  PW_CRASH(
+      "Fuzz target exceeded its execution budget (%s) on a %u-byte input: "
+      "%lld ns (limit %lld ns), %llu allocations (limit %llu), "
+      "%llu bytes allocated (limit %llu)",
+      status.str(),
+      static_cast<unsigned>(input_size_),
+      static_cast<long long>(cost.time.count()),
+      static_cast<long long>(budget_.TimeLimit(input_size_).count()),
+      static_cast<unsigned long long>(cost.allocations),
+      static_cast<unsigned long long>(budget_.AllocationLimit(input_size_)),
+      static_cast<unsigned long long>(cost.allocated_bytes),
+      static_cast<unsigned long long>(
+          budget_.AllocatedBytesLimit(input_size_)));
+}
+
+}  // namespace pw::fuzzer
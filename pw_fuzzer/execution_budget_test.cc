@@ -0,0 +1,112 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_fuzzer/execution_budget.h"
+
+#include <chrono>
+
+#include "gtest/gtest.h"
+
+namespace pw::fuzzer {
+namespace {
+
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::chrono::nanoseconds;
+
+constexpr auto kBudget = ExecutionBudget()
+                             .Time(milliseconds(1), microseconds(1))
+                             .Allocations(2, 1)
+                             .AllocatedBytes(64, 8);
+
+ExecutionCost Cost(nanoseconds time,
+                   size_t allocations,
+                   size_t allocated_bytes,
+                   bool allocations_counted = true) {
+  ExecutionCost cost;
+  cost.time = time;
+  cost.allocations = allocations;
+  cost.allocated_bytes = allocated_bytes;
+  cost.allocations_counted = allocations_counted;
+  return cost;
+}
+
+TEST(ExecutionBudget, Default_IsUnlimited) {
+  constexpr ExecutionBudget budget;
+  EXPECT_EQ(nanoseconds::max(), budget.TimeLimit(1000));
+  EXPECT_EQ(ExecutionBudget::kUnlimited, budget.AllocationLimit(1000));
+  EXPECT_EQ(ExecutionBudget::kUnlimited, budget.AllocatedBytesLimit(1000));
+  EXPECT_EQ(OkStatus(),
+            budget.Check(Cost(nanoseconds::max(), 100000, 100000), 0));
+}
+
+TEST(ExecutionBudget, Limits_GrowWithInputSize) {
+  EXPECT_EQ(milliseconds(1), kBudget.TimeLimit(0));
+  EXPECT_EQ(microseconds(1100), kBudget.TimeLimit(100));
+  EXPECT_EQ(2u, kBudget.AllocationLimit(0));
+  EXPECT_EQ(102u, kBudget.AllocationLimit(100));
+  EXPECT_EQ(864u, kBudget.AllocatedBytesLimit(100));
+}
+
+TEST(ExecutionBudget, Limits_Saturate) {
+  constexpr auto budget =
+      ExecutionBudget().Time(nanoseconds(1), nanoseconds::max()).Allocations(
+          1, ExecutionBudget::kUnlimited);
+  EXPECT_EQ(nanoseconds::max(), budget.TimeLimit(2));
+  EXPECT_EQ(ExecutionBudget::kUnlimited, budget.AllocationLimit(2));
+  EXPECT_EQ(nanoseconds(1), budget.TimeLimit(0));
+}
+
+TEST(ExecutionBudget, Check_WithinBudget) {
+  EXPECT_EQ(OkStatus(), kBudget.Check(Cost(microseconds(1100), 102, 864), 100));
+}
+
+TEST(ExecutionBudget, Check_TimeExceeded) {
+  EXPECT_EQ(Status::DeadlineExceeded(),
+            kBudget.Check(Cost(microseconds(1101), 0, 0), 100));
+}
+
+TEST(ExecutionBudget, Check_AllocationsExceeded) {
+  EXPECT_EQ(Status::ResourceExhausted(),
+            kBudget.Check(Cost(nanoseconds(0), 103, 0), 100));
+  EXPECT_EQ(Status::ResourceExhausted(),
+            kBudget.Check(Cost(nanoseconds(0), 0, 865), 100));
+}
+
+TEST(ExecutionBudget, Check_UncountedAllocationsAreNotChecked) {
+  EXPECT_EQ(OkStatus(),
+            kBudget.Check(Cost(nanoseconds(0), 1000, 1000, false), 0));
+}
+
+TEST(ExecutionMeter, MeasuresTime) {
+  ExecutionMeter meter;
+  const auto start = chrono::SystemClock::now();
+  while (chrono::SystemClock::now() - start < milliseconds(2)) {
+  }
+  const ExecutionCost cost = meter.cost();
+  EXPECT_GE(cost.time, milliseconds(2));
+  if (!cost.allocations_counted) {
+    EXPECT_EQ(0u, cost.allocations);
+    EXPECT_EQ(0u, cost.allocated_bytes);
+  }
+}
+
+TEST(BudgetScope, WithinBudget_DoesNotCrash) {
+  BudgetScope scope(ExecutionBudget().Time(std::chrono::seconds(10),
+                                           nanoseconds(0)),
+                    16);
+}
+
+}  // namespace
+}  // namespace pw::fuzzer
@@ -0,0 +1,137 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <limits>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_status/status.h"
+
+namespace pw::fuzzer {
+
+// The cost of executing a fuzz target on one input.
+struct ExecutionCost {
+  std::chrono::nanoseconds time;
+  size_t allocations;
+  size_t allocated_bytes;
+
+  // Allocations are counted through sanitizer allocator hooks, which are only
+  // available when the binary is linked with a sanitizer that replaces malloc,
+  // such as ASan. Otherwise, allocations and allocated_bytes are 0.
+  bool allocations_counted;
+};
+
+// Limits on the cost of executing a fuzz target on one input. Each limit is a
+// fixed amount plus an amount per byte of input, so a target whose cost grows
+// linearly with its input stays within budget for any input length, while one
+// with a quadratic path does not. Limits are unlimited unless set.
+//
+//   constexpr auto kBudget = pw::fuzzer::ExecutionBudget()
+//                                .Time(std::chrono::milliseconds(1),
+//                                      std::chrono::microseconds(1))
+//                                .Allocations(0, 0);
+//
+class ExecutionBudget {
+ public:
+  static constexpr size_t kUnlimited = std::numeric_limits<size_t>::max();
+
+  constexpr ExecutionBudget() = default;
+
+  constexpr ExecutionBudget Time(std::chrono::nanoseconds base,
+                                 std::chrono::nanoseconds per_byte) const {
+    ExecutionBudget budget = *this;
+    budget.time_ = base;
+    budget.time_per_byte_ = per_byte;
+    return budget;
+  }
+
+  constexpr ExecutionBudget Allocations(size_t base, size_t per_byte) const {
+    ExecutionBudget budget = *this;
+    budget.allocations_ = base;
+    budget.allocations_per_byte_ = per_byte;
+    return budget;
+  }
+
+  constexpr ExecutionBudget AllocatedBytes(size_t base, size_t per_byte) const {
+    ExecutionBudget budget = *this;
+    budget.allocated_bytes_ = base;
+    budget.allocated_bytes_per_byte_ = per_byte;
+    return budget;
+  }
+
+  // Checks the cost of executing an input of input_size bytes. Returns
+  // DEADLINE_EXCEEDED if the time limit was exceeded, RESOURCE_EXHAUSTED if an
+  // allocation limit was exceeded, or OK. Allocation limits are not checked if
+  // allocations were not counted.
+  Status Check(const ExecutionCost& cost, size_t input_size) const;
+
+  // The limits for an input of input_size bytes. Saturates at the maximum.
+  std::chrono::nanoseconds TimeLimit(size_t input_size) const;
+  size_t AllocationLimit(size_t input_size) const;
+  size_t AllocatedBytesLimit(size_t input_size) const;
+
+ private:
+  std::chrono::nanoseconds time_ = std::chrono::nanoseconds::max();
+  std::chrono::nanoseconds time_per_byte_ = std::chrono::nanoseconds(0);
+  size_t allocations_ = kUnlimited;
+  size_t allocations_per_byte_ = 0;
+  size_t allocated_bytes_ = kUnlimited;
+  size_t allocated_bytes_per_byte_ = 0;
+};
+
+// Measures the cost of executing code from construction until cost() is
+// called.
+class ExecutionMeter {
+ public:
+  ExecutionMeter();
+
+  ExecutionCost cost() const;
+
+ private:
+  chrono::SystemClock::time_point start_;
+  size_t start_allocations_;
+  size_t start_allocated_bytes_;
+};
+
+// Measures a fuzz target's execution on one input, and crashes if it exceeds
+// the budget. libFuzzer then saves the input as a crash artifact, so a
+// performance bug is reported and minimized like any other crash. Declare a
+// BudgetScope at the start of LLVMFuzzerTestOneInput:
+//
+//   extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+//     pw::fuzzer::BudgetScope budget(kBudget, size);
+//     ...
+//
+// Time limits measure wall-clock time, so they should leave a generous margin
+// for the sanitizers and a loaded machine. Performance bugs typically exceed a
+// linear budget by orders of magnitude.
+class BudgetScope {
+ public:
+  BudgetScope(const ExecutionBudget& budget, size_t input_size)
+      : budget_(budget), input_size_(input_size) {}
+
+  BudgetScope(const BudgetScope&) = delete;
+  BudgetScope& operator=(const BudgetScope&) = delete;
+
+  ~BudgetScope();
+
+ private:
+  const ExecutionBudget budget_;
+  const size_t input_size_;
+  const ExecutionMeter meter_;
+};
+
+}  // namespace pw::fuzzer
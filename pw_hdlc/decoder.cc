@@ -14,6 +14,8 @@
 
 #include "pw_hdlc/decoder.h"
 
+#include <cstring>
+
 #include "pw_assert/assert.h"
 #include "pw_bytes/endian.h"
 #include "pw_hdlc_private/protocol.h"
@@ -22,6 +24,101 @@
 using std::byte;
 
 namespace pw::hdlc {
+namespace {
+
+// Word-at-a-time search, as in strlen and memchr implementations. Each byte of
+// a word is compared by XORing it with the target, which zeroes matching
+// bytes, and then detecting a zero byte.
+using Word = size_t;
+
+constexpr Word RepeatByte(byte b) {
+  return ~Word{0} / 0xFFu * std::to_integer<Word>(b);
+}
+
+constexpr Word kLowBits = RepeatByte(byte{0x01});
+constexpr Word kHighBits = RepeatByte(byte{0x80});
+
+constexpr bool HasZeroByte(Word word) {
+  return ((word - kLowBits) & ~word & kHighBits) != 0u;
+}
+
+// Returns the index of the first flag or escape byte, or data.size() if there
+// is none.
+size_t FindFlagOrEscape(ConstByteSpan data) {
+  size_t i = 0;
+
+  for (; i + sizeof(Word) <= data.size(); i += sizeof(Word)) {
+    Word word;
+    std::memcpy(&word, &data[i], sizeof(word));
+    if (HasZeroByte(word ^ RepeatByte(kFlag)) ||
+        HasZeroByte(word ^ RepeatByte(kEscape))) {
+      break;
+    }
+  }
+
+  for (; i < data.size(); ++i) {
+    if (NeedsEscaping(data[i])) {
+      break;
+    }
+  }
+  return i;
+}
+
+// Returns the index of the first flag byte, or data.size() if there is none.
+size_t FindFlag(ConstByteSpan data) {
+  const void* flag = std::memchr(
+      data.data(), std::to_integer<int>(kFlag), data.size_bytes());
+  return flag == nullptr ? data.size()
+                         : static_cast<size_t>(static_cast<const byte*>(flag) -
+                                               data.data());
+}
+
+}  // namespace
+
+Result<Frame> Decoder::ProcessUntilResult(ConstByteSpan& data,
+                                          bool in_place) {
+  while (!data.empty()) {
+    if (state_ == State::kFrame) {
+      const size_t run = FindFlagOrEscape(data);
+
+      // A frame that started in this data and ends at a flag without any
+      // escapes is already decoded. Check it where it is instead of copying it.
+      if (in_place && current_frame_size_ == 0u && run != 0u &&
+          run < data.size() && data[run] == kFlag) {
+        const ConstByteSpan frame = data.first(run);
+        data = data.subspan(run + 1);  // The flag also starts the next frame.
+
+        const Status status = CheckFrame(
+            frame.size(), VerifyFrameCheckSequence(frame));
+        if (status.ok()) {
+          return Frame(frame);
+        }
+        return status;
+      }
+
+      AppendRun(data.first(run));
+      data = data.subspan(run);
+    } else if (state_ == State::kInterFrame) {
+      // Count bytes to track how many are discarded.
+      const size_t discarded = FindFlag(data);
+      current_frame_size_ += discarded;
+      data = data.subspan(discarded);
+    }
+
+    if (data.empty()) {
+      break;
+    }
+
+    // Flag and escape bytes, and the byte after an escape, go through the state
+    // machine.
+    Result<Frame> result = Process(data[0]);
+    data = data.subspan(1);
+    if (result.status() != Status::Unavailable()) {
+      return result;
+    }
+  }
+  return Status::Unavailable();
+}
 
 Result<Frame> Decoder::Process(const byte new_byte) {
   switch (state_) {
@@ -31,6 +128,9 @@ Result<Frame> Decoder::Process(const byte new_byte) {
 
         // Report an error if non-flag bytes were read between frames.
         if (current_frame_size_ != 0u) {
+          statistics_.discarded_bytes +=
+              static_cast<uint32_t>(current_frame_size_);
+          statistics_.resyncs += 1;
           Reset();
           return Status::DataLoss();
         }
@@ -42,7 +142,8 @@ Result<Frame> Decoder::Process(const byte new_byte) {
     }
     case State::kFrame: {
       if (new_byte == kFlag) {
-        const Status status = CheckFrame();
+        const Status status =
+            CheckFrame(current_frame_size_, VerifyFrameCheckSequence());
 
         const size_t completed_frame_size = current_frame_size_;
         Reset();
@@ -65,6 +166,7 @@ Result<Frame> Decoder::Process(const byte new_byte) {
       if (new_byte == kFlag) {
         state_ = State::kFrame;
         Reset();
+        statistics_.framing_errors += 1;
         return Status::DataLoss();
       }
 
@@ -72,6 +174,7 @@ Result<Frame> Decoder::Process(const byte new_byte) {
         // Two escape characters in a row is illegal -- invalidate this frame.
         // The frame is reported abandoned when the next flag byte appears.
         state_ = State::kInterFrame;
+        statistics_.framing_errors += 1;
 
         // Count the escape byte so that the inter-frame state detects an error.
         current_frame_size_ += 1;
@@ -103,30 +206,74 @@ void Decoder::AppendByte(byte new_byte) {
   current_frame_size_ += 1;
 }
 
-Status Decoder::CheckFrame() const {
+void Decoder::AppendRun(ConstByteSpan run) {
+  // Short runs do not fill the ring buffer; append them byte by byte.
+  if (run.size() < last_read_bytes_.size()) {
+    for (byte b : run) {
+      AppendByte(b);
+    }
+    return;
+  }
+
+  if (current_frame_size_ < max_size()) {
+    std::memcpy(&buffer_[current_frame_size_],
+                run.data(),
+                std::min(run.size(), max_size() - current_frame_size_));
+  }
+
+  // The run evicts every byte in the ring buffer, and all but the last four
+  // bytes of the run, into the running checksum. Until four bytes are read,
+  // the ring buffer fills from index 0.
+  std::array<byte, sizeof(uint32_t)> evicted;
+  const size_t evicted_count =
+      std::min(current_frame_size_, last_read_bytes_.size());
+  size_t index =
+      current_frame_size_ >= last_read_bytes_.size() ? last_read_bytes_index_
+                                                     : 0;
+  for (size_t i = 0; i < evicted_count; ++i) {
+    evicted[i] = last_read_bytes_[index];
+    index = (index + 1) % last_read_bytes_.size();
+  }
+  fcs_.Update(std::span(evicted).first(evicted_count));
+  fcs_.Update(run.first(run.size() - last_read_bytes_.size()));
+
+  std::memcpy(last_read_bytes_.data(),
+              run.last(last_read_bytes_.size()).data(),
+              last_read_bytes_.size());
+  last_read_bytes_index_ = 0;
+
+  // Always increase size: if it is larger than the buffer, overflow occurred.
+  current_frame_size_ += run.size();
+}
+
+Status Decoder::CheckFrame(size_t frame_size, bool frame_check_sequence_ok) {
   // Empty frames are not an error; repeated flag characters are okay.
-  if (current_frame_size_ == 0u) {
+  if (frame_size == 0u) {
     return Status::Unavailable();
   }
 
-  if (current_frame_size_ < Frame::kMinSizeBytes) {
+  if (frame_size < Frame::kMinSizeBytes) {
     PW_LOG_ERROR("Received %lu-byte frame; frame must be at least 6 bytes",
-                 static_cast<unsigned long>(current_frame_size_));
+                 static_cast<unsigned long>(frame_size));
+    statistics_.framing_errors += 1;
     return Status::DataLoss();
   }
 
-  if (!VerifyFrameCheckSequence()) {
+  if (!frame_check_sequence_ok) {
     PW_LOG_ERROR("Frame check sequence verification failed");
+    statistics_.fcs_errors += 1;
     return Status::DataLoss();
   }
 
-  if (current_frame_size_ > max_size()) {
+  if (frame_size > max_size()) {
     PW_LOG_ERROR("Frame size [%lu] exceeds the maximum buffer size [%lu]",
-                 static_cast<unsigned long>(current_frame_size_),
+                 static_cast<unsigned long>(frame_size),
                  static_cast<unsigned long>(max_size()));
+    statistics_.oversize_frames += 1;
     return Status::ResourceExhausted();
   }
 
+  statistics_.frames += 1;
   return OkStatus();
 }
 
@@ -145,4 +292,14 @@ bool Decoder::VerifyFrameCheckSequence() const {
   return actual_fcs == fcs_.value();
 }
 
+bool Decoder::VerifyFrameCheckSequence(ConstByteSpan frame) {
+  if (frame.size() < sizeof(uint32_t)) {
+    return false;
+  }
+
+  const auto fcs = frame.last<sizeof(uint32_t)>();
+  return bytes::ReadInOrder<uint32_t>(std::endian::little, fcs) ==
+         checksum::Crc32::Calculate(frame.first(frame.size() - fcs.size()));
+}
+
 }  // namespace pw::hdlc
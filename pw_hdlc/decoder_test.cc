@@ -16,10 +16,13 @@
 
 #include <array>
 #include <cstddef>
+#include <cstring>
 
 #include "gtest/gtest.h"
 #include "pw_bytes/array.h"
+#include "pw_hdlc/encoder.h"
 #include "pw_hdlc_private/protocol.h"
+#include "pw_stream/memory_stream.h"
 
 namespace pw::hdlc {
 namespace {
@@ -124,5 +127,294 @@ TEST(Decoder, TooLargeForBuffer_DecodesNextFrame) {
   EXPECT_EQ(OkStatus(), decoder.Process(kFlag).status());
 }
 
+TEST(Decoder, ProcessSpan_DecodesFramesWithEscapes) {
+  DecoderBuffer<64> decoder;
+  constexpr auto kPayload =
+      bytes::Array<0x7E, 1, 2, 3, 4, 5, 6, 7, 8, 0x7D, 9, 10, 0x7E, 0x7E>();
+
+  std::array<byte, 128> encoded;
+  stream::MemoryWriter writer(encoded);
+  ASSERT_EQ(OkStatus(), WriteUIFrame(123, kPayload, writer));
+  ASSERT_EQ(OkStatus(), WriteUIFrame(45, kPayload, writer));
+
+  size_t frames = 0;
+  decoder.Process(writer.WrittenData(), [&](const Result<Frame>& result) {
+    ASSERT_EQ(OkStatus(), result.status());
+    EXPECT_EQ(frames == 0 ? 123u : 45u, result.value().address());
+    ASSERT_EQ(kPayload.size(), result.value().data().size());
+    EXPECT_EQ(0,
+              std::memcmp(kPayload.data(),
+                          result.value().data().data(),
+                          kPayload.size()));
+    frames += 1;
+  });
+  EXPECT_EQ(2u, frames);
+}
+
+// Decodes a stream byte by byte and in chunks of every size, and checks that
+// the span fast path and in-place decoding report the same results as the byte
+// state machine.
+TEST(Decoder, ProcessSpan_MatchesProcessByte) {
+  std::array<byte, 512> stream;
+  stream::MemoryWriter writer(stream);
+
+  std::array<byte, 40> payload;
+  for (size_t i = 0; i < payload.size(); ++i) {
+    payload[i] = byte(i * 13 + 0x70);  // Includes flag and escape bytes.
+  }
+
+  ASSERT_EQ(OkStatus(), writer.Write(bytes::String("garbage")));
+  // Too large for the decoder's buffer.
+  ASSERT_EQ(OkStatus(), WriteUIFrame(1, payload, writer));
+  ASSERT_EQ(OkStatus(), WriteUIFrame(2, std::span(payload).first(3), writer));
+  ASSERT_EQ(OkStatus(), WriteUIFrame(3, ConstByteSpan(), writer));
+  // Data without a valid frame check sequence.
+  ASSERT_EQ(OkStatus(), writer.Write(payload));
+  ASSERT_EQ(OkStatus(), WriteUIFrame(4, payload, writer));
+  // Bad frame check sequence, then an invalid escape.
+  ASSERT_EQ(OkStatus(), writer.Write(bytes::String("~123456789~")));
+  ASSERT_EQ(OkStatus(), writer.Write(bytes::String("~1234\x7d\x7e~")));
+  ASSERT_EQ(OkStatus(), WriteUIFrame(5, std::span(payload).first(20), writer));
+  const ConstByteSpan data = writer.WrittenData();
+
+  struct Decoded {
+    Status status;
+    unsigned address;
+    size_t size;
+  };
+  auto record = [](std::array<Decoded, 16>& results, size_t& count) {
+    return [&results, &count](const Result<Frame>& result) {
+      ASSERT_LT(count, results.size());
+      results[count++] = {result.status(),
+                          result.ok() ? result.value().address() : 0u,
+                          result.ok() ? result.value().data().size() : 0u};
+    };
+  };
+
+  std::array<Decoded, 16> expected;
+  size_t expected_count = 0;
+  {
+    DecoderBuffer<40> decoder;
+    auto callback = record(expected, expected_count);
+    for (byte b : data) {
+      Result<Frame> result = decoder.Process(b);
+      if (result.status() != Status::Unavailable()) {
+        callback(result);
+      }
+    }
+  }
+  ASSERT_EQ(9u, expected_count);
+  EXPECT_EQ(Status::ResourceExhausted(), expected[1].status);
+
+  for (size_t chunk = 1; chunk <= data.size(); ++chunk) {
+    DecoderBuffer<40> decoder;
+    std::array<Decoded, 16> actual;
+    size_t actual_count = 0;
+
+    for (size_t i = 0; i < data.size(); i += chunk) {
+      decoder.Process(data.subspan(i, std::min(chunk, data.size() - i)),
+                      record(actual, actual_count));
+    }
+
+    DecoderBuffer<40> in_place_decoder;
+    std::array<Decoded, 16> in_place;
+    size_t in_place_count = 0;
+
+    for (size_t i = 0; i < data.size(); i += chunk) {
+      in_place_decoder.ProcessInPlace(
+          data.subspan(i, std::min(chunk, data.size() - i)),
+          record(in_place, in_place_count));
+    }
+
+    ASSERT_EQ(expected_count, actual_count);
+    ASSERT_EQ(expected_count, in_place_count);
+    for (size_t i = 0; i < expected_count; ++i) {
+      EXPECT_EQ(expected[i].status, actual[i].status);
+      EXPECT_EQ(expected[i].address, actual[i].address);
+      EXPECT_EQ(expected[i].size, actual[i].size);
+      EXPECT_EQ(expected[i].status, in_place[i].status);
+      EXPECT_EQ(expected[i].address, in_place[i].address);
+      EXPECT_EQ(expected[i].size, in_place[i].size);
+    }
+  }
+}
+
+TEST(Decoder, ProcessInPlace_UnescapedFramePointsIntoInput) {
+  DecoderBuffer<16> decoder;
+  constexpr auto kData = bytes::String("~1234\xa3\xe0\xe3\x9b~");
+
+  size_t frames = 0;
+  decoder.ProcessInPlace(kData, [&](const Result<Frame>& result) {
+    ASSERT_EQ(OkStatus(), result.status());
+    EXPECT_EQ(unsigned{'1'}, result.value().address());
+    ASSERT_EQ(2u, result.value().data().size());
+    EXPECT_EQ(&kData[3], result.value().data().data());
+    frames += 1;
+  });
+  EXPECT_EQ(1u, frames);
+}
+
+TEST(Decoder, ProcessInPlace_EscapedFrameUsesBuffer) {
+  std::array<byte, 16> buffer;
+  Decoder decoder(buffer);
+  constexpr auto kPayload = bytes::Array<0x7E, 0x7D>();
+
+  std::array<byte, 32> encoded;
+  stream::MemoryWriter writer(encoded);
+  ASSERT_EQ(OkStatus(), WriteUIFrame(1, kPayload, writer));
+
+  size_t frames = 0;
+  decoder.ProcessInPlace(writer.WrittenData(), [&](const Result<Frame>& result) {
+    ASSERT_EQ(OkStatus(), result.status());
+    ASSERT_EQ(2u, result.value().data().size());
+    EXPECT_EQ(&buffer[2], result.value().data().data());
+    EXPECT_EQ(byte{0x7E}, result.value().data()[0]);
+    EXPECT_EQ(byte{0x7D}, result.value().data()[1]);
+    frames += 1;
+  });
+  EXPECT_EQ(1u, frames);
+}
+
+TEST(Decoder, ProcessInPlace_FrameSplitAcrossCallsUsesBuffer) {
+  std::array<byte, 16> buffer;
+  Decoder decoder(buffer);
+  constexpr auto kData = bytes::String("~1234\xa3\xe0\xe3\x9b~");
+
+  size_t frames = 0;
+  auto callback = [&](const Result<Frame>& result) {
+    ASSERT_EQ(OkStatus(), result.status());
+    EXPECT_EQ(&buffer[2], result.value().data().data());
+    frames += 1;
+  };
+  decoder.ProcessInPlace(std::span(kData).first(4), callback);
+  decoder.ProcessInPlace(std::span(kData).subspan(4), callback);
+  EXPECT_EQ(1u, frames);
+}
+
+TEST(Decoder, ProcessInPlace_ReportsErrors) {
+  DecoderBuffer<8> decoder;
+  Status status;
+  auto callback = [&status](const Result<Frame>& result) {
+    status = result.status();
+  };
+
+  decoder.ProcessInPlace(bytes::String("~12345678~"), callback);
+  EXPECT_EQ(Status::DataLoss(), status);
+
+  decoder.ProcessInPlace(bytes::String("~1234~"), callback);
+  EXPECT_EQ(Status::DataLoss(), status);
+
+  decoder.ProcessInPlace(bytes::String("~12345\x1c\x3a\xf5\xcb~"), callback);
+  EXPECT_EQ(Status::ResourceExhausted(), status);
+
+  decoder.ProcessInPlace(bytes::String("~1234\xa3\xe0\xe3\x9b~"), callback);
+  EXPECT_EQ(OkStatus(), status);
+}
+
+// Decodes data with each of the decoder APIs and checks that they count the
+// same statistics.
+void ExpectStatistics(ConstByteSpan data, const DecoderStatistics& expected) {
+  auto ignore = [](const Result<Frame>&) {};
+  DecoderBuffer<8> by_byte;
+  DecoderBuffer<8> by_span;
+  DecoderBuffer<8> in_place;
+
+  for (byte b : data) {
+    by_byte.Process(b);
+  }
+  by_span.Process(data, ignore);
+  in_place.ProcessInPlace(data, ignore);
+
+  for (const Decoder* decoder : {static_cast<Decoder*>(&by_byte),
+                                 static_cast<Decoder*>(&by_span),
+                                 static_cast<Decoder*>(&in_place)}) {
+    const DecoderStatistics& actual = decoder->statistics();
+    EXPECT_EQ(expected.frames, actual.frames);
+    EXPECT_EQ(expected.fcs_errors, actual.fcs_errors);
+    EXPECT_EQ(expected.oversize_frames, actual.oversize_frames);
+    EXPECT_EQ(expected.framing_errors, actual.framing_errors);
+    EXPECT_EQ(expected.discarded_bytes, actual.discarded_bytes);
+    EXPECT_EQ(expected.resyncs, actual.resyncs);
+  }
+}
+
+TEST(Decoder, Statistics_StartAtZero) {
+  DecoderBuffer<8> decoder;
+  EXPECT_EQ(0u, decoder.statistics().frames);
+  EXPECT_EQ(0u, decoder.statistics().resyncs);
+}
+
+TEST(Decoder, Statistics_ValidFrames) {
+  ExpectStatistics(
+      bytes::String("~1234\xa3\xe0\xe3\x9b~~1234\xa3\xe0\xe3\x9b~"),
+      {/*frames=*/2,
+       /*fcs_errors=*/0,
+       /*oversize_frames=*/0,
+       /*framing_errors=*/0,
+       /*discarded_bytes=*/0,
+       /*resyncs=*/0});
+}
+
+TEST(Decoder, Statistics_FcsError) {
+  ExpectStatistics(bytes::String("~12345678~"),
+                   {/*frames=*/0,
+                    /*fcs_errors=*/1,
+                    /*oversize_frames=*/0,
+                    /*framing_errors=*/0,
+                    /*discarded_bytes=*/0,
+                    /*resyncs=*/0});
+}
+
+TEST(Decoder, Statistics_OversizeFrame) {
+  ExpectStatistics(bytes::String("~12345\x1c\x3a\xf5\xcb~"),
+                   {/*frames=*/0,
+                    /*fcs_errors=*/0,
+                    /*oversize_frames=*/1,
+                    /*framing_errors=*/0,
+                    /*discarded_bytes=*/0,
+                    /*resyncs=*/0});
+}
+
+TEST(Decoder, Statistics_FramingErrors) {
+  // A frame that is too short, followed by an escaped flag.
+  ExpectStatistics(bytes::String("~1234~12\x7d~"),
+                   {/*frames=*/0,
+                    /*fcs_errors=*/0,
+                    /*oversize_frames=*/0,
+                    /*framing_errors=*/2,
+                    /*discarded_bytes=*/0,
+                    /*resyncs=*/0});
+}
+
+TEST(Decoder, Statistics_DiscardedBytesAndResync) {
+  // Bytes before the first flag are discarded.
+  ExpectStatistics(bytes::String("xyz~1234\xa3\xe0\xe3\x9b~"),
+                   {/*frames=*/1,
+                    /*fcs_errors=*/0,
+                    /*oversize_frames=*/0,
+                    /*framing_errors=*/0,
+                    /*discarded_bytes=*/3,
+                    /*resyncs=*/1});
+}
+
+TEST(Decoder, Statistics_DoubleEscapeDiscardsFrame) {
+  // The frame is abandoned at the second escape, and the rest of it is
+  // discarded until the next flag.
+  ExpectStatistics(bytes::String("~12\x7d\x7d" "ab~"),
+                   {/*frames=*/0,
+                    /*fcs_errors=*/0,
+                    /*oversize_frames=*/0,
+                    /*framing_errors=*/1,
+                    /*discarded_bytes=*/5,
+                    /*resyncs=*/1});
+}
+
+TEST(Decoder, Statistics_NotResetByClear) {
+  DecoderBuffer<8> decoder;
+  decoder.Process(bytes::String("~12345678~"), [](const Result<Frame>&) {});
+  decoder.Clear();
+  EXPECT_EQ(1u, decoder.statistics().fcs_errors);
+}
+
 }  // namespace
 }  // namespace pw::hdlc
@@ -32,19 +32,9 @@ namespace internal {
 // Indicates this an information packet with sequence numbers set to 0.
 constexpr byte kUnusedControl = byte{0};
 
-Status EscapeAndWrite(const byte b, stream::Writer& writer) {
-  if (b == kFlag) {
-    return writer.Write(kEscapedFlag);
-  }
-  if (b == kEscape) {
-    return writer.Write(kEscapedEscape);
-  }
-  return writer.Write(b);
-}
-
 Status Encoder::StartInformationFrame(uint8_t address) {
   fcs_.clear();
-  if (Status status = writer_.Write(kFlag); !status.ok()) {
+  if (Status status = Append(std::span(&kFlag, 1)); !status.ok()) {
     return status;
   }
 
@@ -55,7 +45,7 @@ Status Encoder::StartInformationFrame(uint8_t address) {
 
 Status Encoder::StartUnnumberedFrame(uint8_t address) {
   fcs_.clear();
-  if (Status status = writer_.Write(kFlag); !status.ok()) {
+  if (Status status = Append(std::span(&kFlag, 1)); !status.ok()) {
     return status;
   }
 
@@ -69,14 +59,19 @@ Status Encoder::WriteData(ConstByteSpan data) {
   while (true) {
     auto end = std::find_if(begin, data.end(), NeedsEscaping);
 
-    if (Status status = writer_.Write(std::span(begin, end)); !status.ok()) {
+    // Update the FCS with each run as it is staged, while it is in cache.
+    const ConstByteSpan run(begin, end);
+    fcs_.Update(run);
+    if (Status status = Append(run); !status.ok()) {
       return status;
     }
     if (end == data.end()) {
-      fcs_.Update(data);
       return OkStatus();
     }
-    if (Status status = EscapeAndWrite(*end, writer_); !status.ok()) {
+
+    fcs_.Update(*end);
+    if (Status status = Append(*end == kFlag ? kEscapedFlag : kEscapedEscape);
+        !status.ok()) {
       return status;
     }
     begin = end + 1;
@@ -89,7 +84,38 @@ Status Encoder::FinishFrame() {
       !status.ok()) {
     return status;
   }
-  return writer_.Write(kFlag);
+  if (Status status = Append(std::span(&kFlag, 1)); !status.ok()) {
+    return status;
+  }
+  return Flush();
+}
+
+Status Encoder::Append(ConstByteSpan data) {
+  // Large runs skip the staging buffer to avoid copying them.
+  if (data.size() >= staging_buffer_.size()) {
+    if (Status status = Flush(); !status.ok()) {
+      return status;
+    }
+    return data.empty() ? OkStatus() : writer_.Write(data);
+  }
+
+  if (data.size() > staging_buffer_.size() - staged_) {
+    if (Status status = Flush(); !status.ok()) {
+      return status;
+    }
+  }
+  std::memcpy(staging_buffer_.data() + staged_, data.data(), data.size());
+  staged_ += data.size();
+  return OkStatus();
+}
+
+Status Encoder::Flush() {
+  if (staged_ == 0u) {
+    return OkStatus();
+  }
+  const size_t size = staged_;
+  staged_ = 0;
+  return writer_.Write(staging_buffer_.first(size));
 }
 
 size_t Encoder::MaxEncodedSize(uint8_t address, ConstByteSpan payload) {
@@ -107,12 +133,20 @@ size_t Encoder::MaxEncodedSize(uint8_t address, ConstByteSpan payload) {
 Status WriteUIFrame(uint8_t address,
                     ConstByteSpan payload,
                     stream::Writer& writer) {
+  std::array<byte, kDefaultStagingBufferSizeBytes> staging_buffer;
+  return WriteUIFrame(address, payload, writer, staging_buffer);
+}
+
+Status WriteUIFrame(uint8_t address,
+                    ConstByteSpan payload,
+                    stream::Writer& writer,
+                    ByteSpan staging_buffer) {
   if (internal::Encoder::MaxEncodedSize(address, payload) >
       writer.ConservativeWriteLimit()) {
     return Status::ResourceExhausted();
   }
 
-  internal::Encoder encoder(writer);
+  internal::Encoder encoder(writer, staging_buffer);
 
   if (Status status = encoder.StartUnnumberedFrame(address); !status.ok()) {
     return status;
@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstring>
 
 #include "gtest/gtest.h"
 #include "pw_bytes/array.h"
@@ -172,6 +173,108 @@ TEST(WriteUnnumberedFrame, WriterError) {
             WriteUIFrame(kAddress, bytes::Array<0x01>(), writer));
 }
 
+// Records each write so tests can check how frames are split into writes.
+class CountingWriter : public stream::Writer {
+ public:
+  CountingWriter(ByteSpan buffer) : writer_(buffer) {}
+
+  size_t writes() const { return writes_; }
+  ConstByteSpan data() const {
+    return ConstByteSpan(writer_.data(), writer_.bytes_written());
+  }
+
+  size_t ConservativeWriteLimit() const override {
+    return writer_.ConservativeWriteLimit();
+  }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    writes_ += 1;
+    return writer_.Write(data);
+  }
+
+  stream::MemoryWriter writer_;
+  size_t writes_ = 0;
+};
+
+constexpr auto kPayloadWithEscapes = bytes::Array<0x7E,
+                                                  0x7B,
+                                                  0x61,
+                                                  0x62,
+                                                  0x63,
+                                                  0x7D,
+                                                  0x7E,
+                                                  0x64,
+                                                  0x65,
+                                                  0x66,
+                                                  0x67,
+                                                  0x68>();
+
+TEST(WriteUnnumberedFrame, DefaultStagingBuffer_SmallFrameIsOneWrite) {
+  std::array<byte, 64> buffer;
+  CountingWriter writer(buffer);
+
+  ASSERT_EQ(OkStatus(), WriteUIFrame(kAddress, kPayloadWithEscapes, writer));
+  EXPECT_EQ(1u, writer.writes());
+}
+
+TEST(WriteUnnumberedFrame, StagingBuffer_AllSizesWriteTheSameFrame) {
+  std::array<byte, 64> expected_buffer;
+  stream::MemoryWriter expected(expected_buffer);
+  ASSERT_EQ(OkStatus(), WriteUIFrame(kAddress, kPayloadWithEscapes, expected));
+
+  for (size_t size = 0; size <= MaxEncodedSize(kPayloadWithEscapes.size());
+       ++size) {
+    std::array<byte, 64> buffer;
+    CountingWriter writer(buffer);
+    std::array<byte, MaxEncodedSize(kPayloadWithEscapes.size())> staging;
+
+    ASSERT_EQ(OkStatus(),
+              WriteUIFrame(kAddress,
+                           kPayloadWithEscapes,
+                           writer,
+                           std::span(staging).first(size)));
+    ASSERT_EQ(expected.bytes_written(), writer.data().size());
+    EXPECT_EQ(0,
+              std::memcmp(expected.data(),
+                          writer.data().data(),
+                          expected.bytes_written()));
+    if (size >= expected.bytes_written()) {
+      EXPECT_EQ(1u, writer.writes());
+    }
+  }
+}
+
+TEST(WriteUnnumberedFrame, StagingBuffer_LargeRunsAreWrittenDirectly) {
+  constexpr auto payload = bytes::Initialized<40>(0x11);
+  std::array<byte, 64> buffer;
+  CountingWriter writer(buffer);
+  std::array<byte, 8> staging;
+
+  ASSERT_EQ(OkStatus(), WriteUIFrame(kAddress, payload, writer, staging));
+  // Header, payload, and frame check sequence with the closing flag.
+  EXPECT_EQ(3u, writer.writes());
+  EXPECT_EQ(payload.size() + 8, writer.data().size());
+}
+
+TEST(WriteUnnumberedFrame, StagingBuffer_WriterError) {
+  ErrorWriter writer;
+  std::array<byte, 4> staging;
+  EXPECT_EQ(Status::Unimplemented(),
+            WriteUIFrame(kAddress, kPayloadWithEscapes, writer, staging));
+}
+
+TEST(MaxEncodedSize, FitsFrameWithAllBytesEscaped) {
+  static_assert(MaxEncodedSize(0) == 13u);
+
+  constexpr auto payload = bytes::Initialized<10>(0x7e);
+  std::array<byte, MaxEncodedSize(payload.size())> buffer;
+  stream::MemoryWriter writer(buffer);
+
+  ASSERT_EQ(OkStatus(), WriteUIFrame(0x7e, payload, writer));
+  EXPECT_LE(writer.bytes_written(), buffer.size());
+}
+
 }  // namespace
 
 namespace internal {
@@ -0,0 +1,45 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_hdlc/frame_demux.h"
+
+#include <algorithm>
+
+namespace pw::hdlc {
+
+void FrameDemux::Process(ConstByteSpan data) {
+  decoder_.ProcessInPlace(data, [this](const Result<Frame>& result) {
+    if (result.ok()) {
+      Dispatch(result.value());
+    } else {
+      decode_errors_ += 1;
+    }
+  });
+}
+
+void FrameDemux::Dispatch(const Frame& frame) {
+  auto route = std::find_if(routes_.begin(), routes_.end(), [&](auto& r) {
+    return r.address == frame.address();
+  });
+
+  if (route != routes_.end()) {
+    route->handler.HandleFrame(frame);
+  } else if (default_handler_ != nullptr) {
+    default_handler_->HandleFrame(frame);
+  } else {
+    dropped_frames_ += 1;
+  }
+}
+
+}  // namespace pw::hdlc
@@ -0,0 +1,157 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_hdlc/frame_demux.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_hdlc/encoder.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::hdlc {
+namespace {
+
+constexpr unsigned kRpcAddress = 'R';
+constexpr unsigned kLogAddress = 'L';
+
+class RecordingHandler : public FrameHandler {
+ public:
+  void HandleFrame(const Frame& frame) override {
+    last_address_ = frame.address();
+    last_size_ = frame.data().size();
+    std::memcpy(last_data_.data(), frame.data().data(), last_size_);
+    frames_ += 1;
+  }
+
+  size_t frames() const { return frames_; }
+  unsigned last_address() const { return last_address_; }
+  ConstByteSpan last_data() const {
+    return std::span(last_data_).first(last_size_);
+  }
+
+ private:
+  size_t frames_ = 0;
+  unsigned last_address_ = 0;
+  std::array<std::byte, 32> last_data_;
+  size_t last_size_ = 0;
+};
+
+class FrameDemuxTest : public ::testing::Test {
+ protected:
+  FrameDemuxTest()
+      : routes_{FrameDemux::Route{kRpcAddress, rpc_},
+                FrameDemux::Route{kLogAddress, log_}},
+        writer_(stream_) {}
+
+  void WriteFrame(unsigned address, ConstByteSpan payload) {
+    ASSERT_EQ(OkStatus(),
+              WriteUIFrame(static_cast<uint8_t>(address), payload, writer_));
+  }
+
+  ConstByteSpan stream() const {
+    return std::span(stream_).first(writer_.bytes_written());
+  }
+
+  RecordingHandler rpc_;
+  RecordingHandler log_;
+  const std::array<FrameDemux::Route, 2> routes_;
+  std::array<std::byte, 32> decode_buffer_;
+  std::array<std::byte, 128> stream_;
+  stream::MemoryWriter writer_;
+};
+
+TEST_F(FrameDemuxTest, DispatchesFramesByAddress) {
+  FrameDemux demux(decode_buffer_, routes_);
+
+  WriteFrame(kRpcAddress, bytes::String("rpc"));
+  WriteFrame(kLogAddress, bytes::String("log~"));
+  WriteFrame(kRpcAddress, bytes::String("rpc 2"));
+  demux.Process(stream());
+
+  EXPECT_EQ(2u, rpc_.frames());
+  EXPECT_EQ(1u, log_.frames());
+  EXPECT_EQ(kLogAddress, log_.last_address());
+  ASSERT_EQ(4u, log_.last_data().size());
+  EXPECT_EQ(0, std::memcmp("log~", log_.last_data().data(), 4));
+  ASSERT_EQ(5u, rpc_.last_data().size());
+  EXPECT_EQ(0, std::memcmp("rpc 2", rpc_.last_data().data(), 5));
+  EXPECT_EQ(0u, demux.decode_errors());
+}
+
+TEST_F(FrameDemuxTest, FramesSplitAcrossCalls) {
+  FrameDemux demux(decode_buffer_, routes_);
+
+  WriteFrame(kRpcAddress, bytes::String("hello"));
+  WriteFrame(kLogAddress, bytes::String("world"));
+  for (std::byte b : stream()) {
+    demux.Process(std::span(&b, 1));
+  }
+
+  EXPECT_EQ(1u, rpc_.frames());
+  EXPECT_EQ(1u, log_.frames());
+}
+
+TEST_F(FrameDemuxTest, UnknownAddress_Dropped) {
+  FrameDemux demux(decode_buffer_, routes_);
+
+  WriteFrame('?', bytes::String("who"));
+  demux.Process(stream());
+
+  EXPECT_EQ(0u, rpc_.frames());
+  EXPECT_EQ(0u, log_.frames());
+  EXPECT_EQ(1u, demux.dropped_frames());
+}
+
+TEST_F(FrameDemuxTest, UnknownAddress_DefaultHandler) {
+  RecordingHandler other;
+  FrameDemux demux(decode_buffer_, routes_, &other);
+
+  WriteFrame('?', bytes::String("who"));
+  demux.Process(stream());
+
+  EXPECT_EQ(1u, other.frames());
+  EXPECT_EQ(static_cast<unsigned>('?'), other.last_address());
+  EXPECT_EQ(0u, demux.dropped_frames());
+}
+
+TEST_F(FrameDemuxTest, CorruptFrame_CountedAndSkipped) {
+  FrameDemux demux(decode_buffer_, routes_);
+
+  WriteFrame(kRpcAddress, bytes::String("bad"));
+  WriteFrame(kLogAddress, bytes::String("good"));
+  stream_[3] ^= std::byte{1};  // Corrupt the payload of the first frame.
+  demux.Process(stream());
+
+  EXPECT_EQ(0u, rpc_.frames());
+  EXPECT_EQ(1u, log_.frames());
+  EXPECT_EQ(1u, demux.decode_errors());
+}
+
+TEST_F(FrameDemuxTest, Dispatch_DecodedFrame) {
+  FrameDemux demux(decode_buffer_, routes_);
+
+  constexpr auto frame_data = bytes::Concat(
+      static_cast<uint8_t>(kLogAddress), uint8_t{0x03}, uint32_t{0});
+  demux.Dispatch(Frame(frame_data));
+
+  EXPECT_EQ(1u, log_.frames());
+  EXPECT_EQ(0u, log_.last_data().size());
+}
+
+}  // namespace
+}  // namespace pw::hdlc
@@ -0,0 +1,158 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Benchmarks HDLC encoding and decoding. Frames are encoded and decoded for a
+// range of payload sizes and densities of bytes that must be escaped, and each
+// case is reported with its throughput in payload bytes. Decoding is measured
+// byte by byte, with the span API, and with in-place decoding.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+
+#include "gtest/gtest.h"
+#include "pw_hdlc/decoder.h"
+#include "pw_hdlc/encoder.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_unit_test/benchmark.h"
+
+namespace pw::hdlc {
+namespace {
+
+using unit_test::BenchmarkState;
+
+constexpr uint8_t kAddress = 'R';
+constexpr size_t kPayloadSizes[] = {16, 256, 1024};
+constexpr unsigned kEscapePercents[] = {0, 1, 50};
+
+constexpr size_t kMaxPayloadSize = 1024;
+
+// Deterministic pseudo-random numbers, so runs are comparable.
+class Lcg {
+ public:
+  uint32_t Next() {
+    state_ = state_ * 6364136223846793005u + 1442695040888963407u;
+    return uint32_t(state_ >> 33);
+  }
+
+ private:
+  uint64_t state_ = 1;
+};
+
+// Fills the payload with random bytes, of which escape_percent are flag bytes.
+// The other bytes never need escaping.
+void FillPayload(std::span<std::byte> payload, unsigned escape_percent) {
+  Lcg random;
+  for (std::byte& b : payload) {
+    if (random.Next() % 100 < escape_percent) {
+      b = std::byte{0x7e};
+    } else {
+      b = std::byte(random.Next() % 0x7d);
+    }
+  }
+}
+
+enum class DecodeMode { kByte, kSpan, kInPlace };
+
+const char* DecodeModeName(DecodeMode mode) {
+  switch (mode) {
+    case DecodeMode::kByte:
+      return "decode byte";
+    case DecodeMode::kSpan:
+      return "decode span";
+    case DecodeMode::kInPlace:
+      return "decode in place";
+  }
+  return "decode";
+}
+
+void Benchmark(size_t payload_size, unsigned escape_percent) {
+  std::array<std::byte, kMaxPayloadSize> payload_buffer;
+  std::span<std::byte> payload =
+      std::span(payload_buffer).first(payload_size);
+  FillPayload(payload, escape_percent);
+
+  std::array<std::byte, MaxEncodedSize(kMaxPayloadSize)> frame_buffer;
+  stream::MemoryWriter writer(frame_buffer);
+  ASSERT_EQ(OkStatus(), WriteUIFrame(kAddress, payload, writer));
+  const std::span<const std::byte> frame(writer.data(), writer.bytes_written());
+
+  // Each iteration encodes or decodes one frame.
+  const unit_test::BenchmarkOptions options = {
+      .bytes_per_iteration = static_cast<uint32_t>(payload_size),
+  };
+  char name[64];
+
+  std::snprintf(name,
+                sizeof(name),
+                "encode, %zu-byte payload, %u%% escapes",
+                payload_size,
+                escape_percent);
+  unit_test::RunBenchmark(name, options, [payload](BenchmarkState& state) {
+    std::array<std::byte, MaxEncodedSize(kMaxPayloadSize)> encoded;
+    for (auto _ : state) {
+      stream::MemoryWriter encoder_writer(encoded);
+      EXPECT_EQ(OkStatus(), WriteUIFrame(kAddress, payload, encoder_writer));
+    }
+  });
+
+  for (DecodeMode mode :
+       {DecodeMode::kByte, DecodeMode::kSpan, DecodeMode::kInPlace}) {
+    std::snprintf(name,
+                  sizeof(name),
+                  "%s, %zu-byte payload, %u%% escapes",
+                  DecodeModeName(mode),
+                  payload_size,
+                  escape_percent);
+    unit_test::RunBenchmark(
+        name, options, [frame, mode](BenchmarkState& state) {
+          std::array<std::byte, kMaxPayloadSize + Frame::kMinSizeBytes> buffer;
+          Decoder decoder(buffer);
+          uint32_t decoded = 0;
+          auto count = [&decoded](const Result<Frame>& result) {
+            decoded += result.ok() ? 1 : 0;
+          };
+
+          for (auto _ : state) {
+            switch (mode) {
+              case DecodeMode::kByte:
+                for (std::byte b : frame) {
+                  decoded += decoder.Process(b).ok() ? 1 : 0;
+                }
+                break;
+              case DecodeMode::kSpan:
+                decoder.Process(frame, count);
+                break;
+              case DecodeMode::kInPlace:
+                decoder.ProcessInPlace(frame, count);
+                break;
+            }
+          }
+          EXPECT_EQ(state.iterations(), decoded);
+        });
+  }
+}
+
+TEST(HdlcBenchmark, EncodeAndDecode) {
+  for (unsigned escape_percent : kEscapePercents) {
+    for (size_t payload_size : kPayloadSizes) {
+      Benchmark(payload_size, escape_percent);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace pw::hdlc
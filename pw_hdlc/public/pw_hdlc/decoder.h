@@ -61,10 +61,41 @@ class Frame {
                           frame_.size() - kMinSizeBytes);
   }
 
+  // The address, control, and data fields, without the frame check sequence.
+  constexpr ConstByteSpan contents() const {
+    return frame_.first(frame_.size() - kFcsSize);
+  }
+
  private:
   ConstByteSpan frame_;
 };
 
+// Counts of the frames and errors a Decoder has seen, for diagnosing noisy
+// links. The counts start at zero when the Decoder is created and are not reset
+// by Clear(). They wrap around on overflow.
+struct DecoderStatistics {
+  // Valid frames that fit in the decoder's buffer.
+  uint32_t frames;
+
+  // Frames whose frame check sequence did not match their contents.
+  uint32_t fcs_errors;
+
+  // Valid frames that were too large for the decoder's buffer.
+  uint32_t oversize_frames;
+
+  // Frames that were shorter than the minimum frame size or that contained an
+  // invalid escape sequence.
+  uint32_t framing_errors;
+
+  // Bytes that were discarded because they were not inside a frame. These are
+  // counted when the next flag is found.
+  uint32_t discarded_bytes;
+
+  // Times the decoder found a flag after discarding bytes, and so regained
+  // framing.
+  uint32_t resyncs;
+};
+
 // The Decoder class facilitates decoding of data frames using the HDLC
 // protocol, by returning packets as they are decoded and storing incomplete
 // data frames in a buffer.
@@ -79,7 +110,8 @@ class Decoder {
         last_read_bytes_({}),
         last_read_bytes_index_(0),
         current_frame_size_(0),
-        state_(State::kInterFrame) {}
+        state_(State::kInterFrame),
+        statistics_{} {}
 
   Decoder(const Decoder&) = delete;
   Decoder& operator=(const Decoder&) = delete;
@@ -99,17 +131,35 @@ class Decoder {
 
   // Processes a span of data and calls the provided callback with each frame or
   // error.
+  //
+  // This is faster than calling Process(std::byte) for each byte. Runs of bytes
+  // without flag or escape characters are found a word at a time, copied into
+  // the frame buffer in bulk, and added to the frame check sequence at once.
   template <typename F, typename... Args>
   void Process(ConstByteSpan data, F&& callback, Args&&... args) {
-    for (std::byte b : data) {
-      auto result = Process(b);
-      if (result.status() != Status::Unavailable()) {
-        std::invoke(
-            std::forward<F>(callback), std::forward<Args>(args)..., result);
-      }
-    }
+    ProcessSpan(data,
+                /*in_place=*/false,
+                std::forward<F>(callback),
+                std::forward<Args>(args)...);
   }
 
+  // Processes a span of data like Process(ConstByteSpan, ...), but without
+  // copying frames that need no unescaping. If a frame is entirely within data
+  // and contains no escape characters, the Frame passed to the callback points
+  // into data instead of the decoder's buffer, so it is only valid while data
+  // is. Other frames are decoded into the decoder's buffer. Frames larger than
+  // the buffer are reported as RESOURCE_EXHAUSTED either way.
+  template <typename F, typename... Args>
+  void ProcessInPlace(ConstByteSpan data, F&& callback, Args&&... args) {
+    ProcessSpan(data,
+                /*in_place=*/true,
+                std::forward<F>(callback),
+                std::forward<Args>(args)...);
+  }
+
+  // Returns counts of the frames and errors seen by this decoder.
+  const DecoderStatistics& statistics() const { return statistics_; }
+
   // Returns the maximum size of the Decoder's frame buffer.
   size_t max_size() const { return buffer_.size(); }
 
@@ -133,12 +183,40 @@ class Decoder {
     fcs_.clear();
   }
 
+  template <typename F, typename... Args>
+  void ProcessSpan(ConstByteSpan data,
+                   bool in_place,
+                   F&& callback,
+                   Args&&... args) {
+    while (!data.empty()) {
+      auto result = ProcessUntilResult(data, in_place);
+      if (result.status() != Status::Unavailable()) {
+        std::invoke(
+            std::forward<F>(callback), std::forward<Args>(args)..., result);
+      }
+    }
+  }
+
+  // Processes bytes from the start of data until a frame or error is ready or
+  // the data runs out. Advances data past the processed bytes. If in_place is
+  // true, frames without escapes that are entirely within data are returned
+  // without copying them.
+  Result<Frame> ProcessUntilResult(ConstByteSpan& data, bool in_place);
+
   void AppendByte(std::byte new_byte);
 
-  Status CheckFrame() const;
+  // Appends a run of bytes that contains no flag or escape characters.
+  void AppendRun(ConstByteSpan run);
+
+  // Checks a complete frame of the given size and counts the result. Returns
+  // UNAVAILABLE for empty frames, which are not an error.
+  Status CheckFrame(size_t frame_size, bool frame_check_sequence_ok);
 
   bool VerifyFrameCheckSequence() const;
 
+  // Verifies the frame check sequence of a complete frame.
+  static bool VerifyFrameCheckSequence(ConstByteSpan frame);
+
   const ByteSpan buffer_;
 
   // Ring buffer of the last four bytes read into the current frame, to allow
@@ -154,6 +232,8 @@ class Decoder {
   size_t current_frame_size_;
 
   State state_;
+
+  DecoderStatistics statistics_;
 };
 
 // DecoderBuffers declare a buffer along with a Decoder.
@@ -0,0 +1,56 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_hdlc/decoder.h"
+#include "pw_metric/metric.h"
+
+namespace pw::hdlc {
+
+// Publishes a Decoder's statistics as pw_metric counters, so they can be read
+// with the other metrics on a device (e.g. through the metric service).
+//
+// The Decoder counts with plain integers, so it stays cheap to create and use.
+// Call Update() to copy the counts into the metrics before they are read.
+class DecoderMetrics {
+ public:
+  DecoderMetrics(const Decoder& decoder) : decoder_(decoder) {}
+
+  DecoderMetrics(const DecoderMetrics&) = delete;
+  DecoderMetrics& operator=(const DecoderMetrics&) = delete;
+
+  void Update() {
+    const DecoderStatistics& statistics = decoder_.statistics();
+    frames_.Set(statistics.frames);
+    fcs_errors_.Set(statistics.fcs_errors);
+    oversize_frames_.Set(statistics.oversize_frames);
+    framing_errors_.Set(statistics.framing_errors);
+    discarded_bytes_.Set(statistics.discarded_bytes);
+    resyncs_.Set(statistics.resyncs);
+  }
+
+  metric::Group& metrics() { return metrics_; }
+
+ private:
+  const Decoder& decoder_;
+  PW_METRIC_GROUP(metrics_, "hdlc_decoder");
+  PW_METRIC(metrics_, frames_, "frames", 0u);
+  PW_METRIC(metrics_, fcs_errors_, "fcs_errors", 0u);
+  PW_METRIC(metrics_, oversize_frames_, "oversize_frames", 0u);
+  PW_METRIC(metrics_, framing_errors_, "framing_errors", 0u);
+  PW_METRIC(metrics_, discarded_bytes_, "discarded_bytes", 0u);
+  PW_METRIC(metrics_, resyncs_, "resyncs", 0u);
+};
+
+}  // namespace pw::hdlc
@@ -13,12 +13,31 @@
 // the License.
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 #include "pw_bytes/span.h"
 #include "pw_status/status.h"
 #include "pw_stream/stream.h"
 
 namespace pw::hdlc {
 
+// The size of the staging buffer WriteUIFrame uses when none is provided.
+inline constexpr size_t kDefaultStagingBufferSizeBytes = 64;
+
+// Returns the largest possible size of an encoded UI-frame with a payload of
+// the given size, which is reached if every byte of the address, payload, and
+// frame check sequence must be escaped. Use this to size buffers that hold
+// encoded frames.
+constexpr size_t MaxEncodedSize(size_t payload_size) {
+  constexpr size_t kFlagsSize = 2;
+  constexpr size_t kMaxAddressSize = 2;
+  constexpr size_t kControlSize = 1;  // The UI-frame control is never escaped.
+  constexpr size_t kMaxFcsSize = 8;
+  return kFlagsSize + kMaxAddressSize + kControlSize + 2 * payload_size +
+         kMaxFcsSize;
+}
+
 // Writes an HDLC unnumbered information frame (UI-frame) to the provided
 // writer. The frame contains the following:
 //
@@ -29,8 +48,22 @@ namespace pw::hdlc {
 //   - Frame check sequence (CRC-32)
 //   - HDLC flag byte (0x7e)
 //
+// The frame is escaped and its frame check sequence calculated in a single
+// pass. Escaped data is collected in a kDefaultStagingBufferSizeBytes buffer
+// on the stack, so the writer receives a few large writes rather than one write
+// per escaped byte.
 Status WriteUIFrame(uint8_t address,
                     ConstByteSpan payload,
                     stream::Writer& writer);
 
+// Writes an HDLC UI-frame, collecting the escaped data in the provided staging
+// buffer. The writer receives a write each time the staging buffer fills and
+// one when the frame is finished; data runs at least as large as the staging
+// buffer are written directly. A staging buffer of MaxEncodedSize(payload_size)
+// bytes writes each frame in a single call.
+Status WriteUIFrame(uint8_t address,
+                    ConstByteSpan payload,
+                    stream::Writer& writer,
+                    ByteSpan staging_buffer);
+
 }  // namespace pw::hdlc
@@ -0,0 +1,83 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include "pw_bytes/span.h"
+#include "pw_hdlc/decoder.h"
+
+namespace pw::hdlc {
+
+// Receives frames from a FrameDemux.
+class FrameHandler {
+ public:
+  virtual ~FrameHandler() = default;
+
+  // Handles a valid frame. The frame is only valid for the duration of the
+  // call.
+  virtual void HandleFrame(const Frame& frame) = 0;
+};
+
+// Decodes an HDLC stream and dispatches each frame to the handler registered
+// for its address. All addresses share one decoder, so the stream is decoded
+// once no matter how many consumers there are (e.g. RPC, logs, and a router).
+//
+// WARNING: FrameDemux is not thread-safe. Process() must only be called from
+// one thread at a time.
+class FrameDemux {
+ public:
+  struct Route {
+    unsigned address;
+    FrameHandler& handler;
+  };
+
+  // Frames for addresses without a route are passed to default_handler, or
+  // dropped if it is null.
+  constexpr FrameDemux(ByteSpan decode_buffer,
+                       std::span<const Route> routes,
+                       FrameHandler* default_handler = nullptr)
+      : decoder_(decode_buffer),
+        routes_(routes),
+        default_handler_(default_handler),
+        decode_errors_(0),
+        dropped_frames_(0) {}
+
+  FrameDemux(const FrameDemux&) = delete;
+  FrameDemux& operator=(const FrameDemux&) = delete;
+
+  // Decodes a chunk of the stream and dispatches each frame that completes.
+  // Frames that are entirely within data and need no unescaping are dispatched
+  // without being copied.
+  void Process(ConstByteSpan data);
+
+  // Dispatches a frame that was decoded elsewhere to its handler.
+  void Dispatch(const Frame& frame);
+
+  // The number of frames that were corrupt or too large for the decode buffer.
+  size_t decode_errors() const { return decode_errors_; }
+
+  // The number of valid frames that had no handler.
+  size_t dropped_frames() const { return dropped_frames_; }
+
+ private:
+  Decoder decoder_;
+  const std::span<const Route> routes_;
+  FrameHandler* const default_handler_;
+  size_t decode_errors_;
+  size_t dropped_frames_;
+};
+
+}  // namespace pw::hdlc
@@ -13,15 +13,23 @@
 // the License.
 #pragma once
 
+#include <cstddef>
+
+#include "pw_bytes/span.h"
 #include "pw_checksum/crc32.h"
 #include "pw_stream/stream.h"
 
 namespace pw::hdlc::internal {
 
-// Encodes and writes HDLC frames.
+// Encodes and writes HDLC frames. Escaped data is collected in a staging
+// buffer, which is written to the output when it fills up and when the frame
+// is finished, so a frame takes one or a few writes. Runs of data at least as
+// large as the staging buffer are written directly. With an empty staging
+// buffer, every run is written directly.
 class Encoder {
  public:
-  constexpr Encoder(stream::Writer& output) : writer_(output) {}
+  constexpr Encoder(stream::Writer& output, ByteSpan staging_buffer = {})
+      : writer_(output), staging_buffer_(staging_buffer), staged_(0) {}
 
   // Writes the header for an I-frame. After successfully calling
   // StartInformationFrame, WriteData may be called any number of times.
@@ -35,7 +43,8 @@ class Encoder {
   // StartInformationFrame call, and prior to a FinishFrame() call.
   Status WriteData(ConstByteSpan data);
 
-  // Finishes a frame. Writes the frame check sequence and a terminating flag.
+  // Finishes a frame. Writes the frame check sequence and a terminating flag,
+  // then flushes the staging buffer.
   Status FinishFrame();
 
   // Runs a pass through a payload, returning the worst-case encoded size for a
@@ -43,7 +52,15 @@ class Encoder {
   static size_t MaxEncodedSize(uint8_t address, ConstByteSpan payload);
 
  private:
+  // Appends bytes that need no escaping to the staging buffer.
+  Status Append(ConstByteSpan data);
+
+  // Writes the contents of the staging buffer to the output.
+  Status Flush();
+
   stream::Writer& writer_;
+  const ByteSpan staging_buffer_;
+  size_t staged_;
   checksum::Crc32 fcs_;
 };
 
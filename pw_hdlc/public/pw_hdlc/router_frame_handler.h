@@ -0,0 +1,40 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_hdlc/frame_demux.h"
+#include "pw_router/static_router.h"
+
+namespace pw::hdlc {
+
+// Passes frames from a FrameDemux to a StaticRouter. Each frame is routed as
+// its address, control, and data fields. The router should use a
+// DecodedFrameParser, which reads the address from the decoded frame instead
+// of decoding the frame again.
+//
+// Routing errors are counted by the router's metrics.
+class RouterFrameHandler final : public FrameHandler {
+ public:
+  constexpr RouterFrameHandler(router::StaticRouter& router)
+      : router_(router) {}
+
+  void HandleFrame(const Frame& frame) final {
+    router_.RoutePacket(frame.contents());
+  }
+
+ private:
+  router::StaticRouter& router_;
+};
+
+}  // namespace pw::hdlc
@@ -14,11 +14,15 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <span>
 
 #include "pw_assert/light.h"
 #include "pw_hdlc/encoder.h"
 #include "pw_rpc/channel.h"
+#include "pw_stream/memory_stream.h"
 #include "pw_stream/stream.h"
 
 namespace pw::hdlc {
@@ -86,4 +90,150 @@ class RpcChannelOutputBuffer : public rpc::ChannelOutput {
   const uint8_t address_;
 };
 
+// RpcChannelOutput for transports that send asynchronously, such as a UART
+// driven by DMA. Packets are encoded as HDLC frames into one of two frame
+// buffers. A finished frame is passed to StartSend(), which hands it to the
+// driver and returns without waiting. While that frame is on the wire, the
+// next packet is encoded into the other buffer and queued. When the driver
+// calls SendComplete(), the queued frame is started immediately, so the line
+// stays busy without the CPU waiting on the transfer.
+//
+// If a frame is on the wire and another is already queued,
+// SendAndReleaseBuffer() returns RESOURCE_EXHAUSTED without encoding the packet.
+//
+// WARNING: Packets must be sent from one thread at a time. If multiple threads
+// send packets, wrap this in a pw::rpc::SynchronizedChannelOutput.
+// SendComplete() may be called from an interrupt.
+template <size_t kMaxPacketSize>
+class AsyncRpcChannelOutput : public rpc::ChannelOutput {
+ public:
+  // Each frame buffer fits the largest possible frame for a packet.
+  static constexpr size_t kFrameBufferSize = MaxEncodedSize(kMaxPacketSize);
+
+  std::span<std::byte> AcquireBuffer() final { return packet_buffer_; }
+
+  // Encodes the packet into a free frame buffer, and starts sending it if no
+  // other frame is on the wire. The packet buffer may be reused as soon as
+  // this returns.
+  Status SendAndReleaseBuffer(std::span<const std::byte> buffer) final {
+    PW_DASSERT(buffer.data() == packet_buffer_.data());
+    if (buffer.empty()) {
+      return OkStatus();
+    }
+
+    // Only this function queues frames, and SendComplete() only moves the
+    // queued frame to the wire, so the buffer that is not sending stays free.
+    uint8_t state = state_.load(std::memory_order_acquire);
+    if (Queued(state) != kNone) {
+      return Status::ResourceExhausted();
+    }
+    const uint8_t index = Sending(state) == 0u ? 1u : 0u;
+
+    // Encode directly into the frame buffer; an empty staging buffer avoids a
+    // second copy.
+    stream::MemoryWriter writer(frame_buffers_[index]);
+    if (Status status = WriteUIFrame(address_, buffer, writer, ByteSpan());
+        !status.ok()) {
+      return status;
+    }
+    frame_sizes_[index] = writer.bytes_written();
+
+    bool start;
+    do {
+      start = Sending(state) == kNone;
+      // The compare-exchange publishes the frame to SendComplete().
+    } while (!state_.compare_exchange_weak(
+        state,
+        start ? State(index, kNone) : State(Sending(state), index),
+        std::memory_order_acq_rel,
+        std::memory_order_acquire));
+
+    if (!start) {
+      return OkStatus();
+    }
+
+    Status status = StartSend(Frame(index));
+    if (!status.ok()) {
+      // No frame was on the wire, so SendComplete() cannot race with this.
+      state_.store(State(kNone, kNone), std::memory_order_release);
+    }
+    return status;
+  }
+
+  // Called by the driver when the frame passed to StartSend() has been sent or
+  // the transfer failed. Calls OnSendComplete() and starts the queued frame,
+  // if there is one. Safe to call from an interrupt.
+  void SendComplete(Status status) {
+    while (true) {
+      OnSendComplete(status);
+
+      uint8_t state = state_.load(std::memory_order_acquire);
+      while (!state_.compare_exchange_weak(state,
+                                           State(Queued(state), kNone),
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+      }
+
+      const uint8_t next = Queued(state);
+      if (next == kNone) {
+        return;
+      }
+
+      // If the queued frame cannot be started, it is reported as complete with
+      // the error and the next one is tried.
+      status = StartSend(Frame(next));
+      if (status.ok()) {
+        return;
+      }
+    }
+  }
+
+  // The number of frames that are on the wire or queued to be sent.
+  size_t frames_in_flight() const {
+    const uint8_t state = state_.load(std::memory_order_relaxed);
+    return (Sending(state) == kNone ? 0u : 1u) +
+           (Queued(state) == kNone ? 0u : 1u);
+  }
+
+ protected:
+  constexpr AsyncRpcChannelOutput(uint8_t address, const char* channel_name)
+      : ChannelOutput(channel_name),
+        packet_buffer_{},
+        frame_buffers_{},
+        frame_sizes_{},
+        state_(State(kNone, kNone)),
+        address_(address) {}
+
+ private:
+  static constexpr uint8_t kNone = 2;
+
+  // The state packs the index of the frame on the wire and the index of the
+  // queued frame into one byte, so both change together atomically.
+  static constexpr uint8_t State(uint8_t sending, uint8_t queued) {
+    return static_cast<uint8_t>(sending | (queued << 2));
+  }
+  static constexpr uint8_t Sending(uint8_t state) { return state & 0x3; }
+  static constexpr uint8_t Queued(uint8_t state) { return state >> 2; }
+
+  std::span<const std::byte> Frame(uint8_t index) const {
+    return std::span(frame_buffers_[index]).first(frame_sizes_[index]);
+  }
+
+  // Starts sending an encoded frame. Must not block until the transfer is
+  // done. Returns OK if the transfer was started, in which case the driver
+  // must later call SendComplete(). May be called from SendComplete(), and so
+  // from an interrupt.
+  virtual Status StartSend(std::span<const std::byte> frame) = 0;
+
+  // Called from SendComplete() for each frame that finishes or fails to start.
+  // Runs in the same context as SendComplete(), which may be an interrupt.
+  virtual void OnSendComplete(Status) {}
+
+  std::array<std::byte, kMaxPacketSize> packet_buffer_;
+  std::array<std::array<std::byte, kFrameBufferSize>, 2> frame_buffers_;
+  std::array<size_t, 2> frame_sizes_;
+  std::atomic<uint8_t> state_;
+  const uint8_t address_;
+};
+
 }  // namespace pw::hdlc
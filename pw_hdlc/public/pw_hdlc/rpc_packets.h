@@ -16,6 +16,7 @@
 #include <cstdint>
 
 #include "pw_hdlc/decoder.h"
+#include "pw_hdlc/frame_demux.h"
 #include "pw_rpc/channel.h"
 #include "pw_rpc/server.h"
 #include "pw_status/status.h"
@@ -31,4 +32,20 @@ Status ReadAndProcessPackets(rpc::Server& server,
                              std::span<std::byte> decode_buffer,
                              unsigned rpc_address = kDefaultRpcAddress);
 
+// Passes frames from a FrameDemux to an RPC server. Register it with the
+// FrameDemux for the RPC address.
+class RpcFrameHandler final : public FrameHandler {
+ public:
+  constexpr RpcFrameHandler(rpc::Server& server, rpc::ChannelOutput& output)
+      : server_(server), output_(output) {}
+
+  void HandleFrame(const Frame& frame) final {
+    server_.ProcessPacket(frame.data(), output_);
+  }
+
+ private:
+  rpc::Server& server_;
+  rpc::ChannelOutput& output_;
+};
+
 }  // namespace pw::hdlc
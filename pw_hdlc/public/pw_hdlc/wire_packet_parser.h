@@ -42,4 +42,31 @@ class WirePacketParser final : public router::PacketParser {
   uint8_t address_shift_;
 };
 
+// HDLC frame parser for routers that operates on frames that were already
+// decoded, such as those dispatched by a FrameDemux. Packets are the address,
+// control, and data fields of a frame (Frame::contents()). The decoder has
+// verified the frame check sequence, so parsing only reads the address.
+//
+// Like WirePacketParser, this assumes 1-byte HDLC address fields, optionally
+// shifted to use a smaller address size.
+class DecodedFrameParser final : public router::PacketParser {
+ public:
+  constexpr DecodedFrameParser(uint8_t address_bits = 8)
+      : address_(0), address_shift_(8 - address_bits) {
+    PW_ASSERT(address_bits <= 8);
+  }
+
+  // Reads the address from a decoded frame. Fails if the packet is too short
+  // to hold an address and control field.
+  bool Parse(ConstByteSpan packet) final;
+
+  std::optional<uint32_t> GetDestinationAddress() const final {
+    return address_;
+  }
+
+ private:
+  uint8_t address_;
+  uint8_t address_shift_;
+};
+
 }  // namespace pw::hdlc
@@ -123,5 +123,129 @@ TEST(RpcChannelOutputBuffer, 1BytePayload) {
       0);
 }
 
+class TestAsyncOutput : public AsyncRpcChannelOutput<kSinkBufferSize> {
+ public:
+  constexpr TestAsyncOutput()
+      : AsyncRpcChannelOutput(kAddress, "TestAsyncOutput") {}
+
+  // Encodes a one-byte packet and sends it.
+  Status SendByte(char value) {
+    std::span<byte> buffer = AcquireBuffer();
+    buffer[0] = byte(value);
+    return SendAndReleaseBuffer(buffer.first(1));
+  }
+
+  // Returns the payload byte of a frame passed to StartSend().
+  char sent_payload(size_t index) const {
+    return static_cast<char>(sent_frames_[index][3]);
+  }
+  size_t sent_size(size_t index) const { return sent_frames_[index].size(); }
+  size_t sent_count() const { return sent_count_; }
+  size_t completions() const { return completions_; }
+  Status last_status() const { return last_status_; }
+
+  void set_start_status(Status status) { start_status_ = status; }
+
+ private:
+  Status StartSend(std::span<const byte> frame) override {
+    if (start_status_.ok()) {
+      sent_frames_[sent_count_] = frame;
+      sent_count_ += 1;
+    }
+    return start_status_;
+  }
+
+  void OnSendComplete(Status status) override {
+    completions_ += 1;
+    last_status_ = status;
+  }
+
+  std::span<const byte> sent_frames_[8];
+  size_t sent_count_ = 0;
+  size_t completions_ = 0;
+  Status last_status_;
+  Status start_status_;
+};
+
+TEST(AsyncRpcChannelOutput, Send_EncodesFrameAndStartsSending) {
+  TestAsyncOutput output;
+
+  ASSERT_EQ(OkStatus(), output.SendByte('A'));
+
+  constexpr auto expected = bytes::Concat(
+      kFlag, kAddress, kControl, 'A', uint32_t{0x8D137C66}, kFlag);
+  ASSERT_EQ(1u, output.sent_count());
+  ASSERT_EQ(expected.size(), output.sent_size(0));
+  EXPECT_EQ(1u, output.frames_in_flight());
+
+  output.SendComplete(OkStatus());
+  EXPECT_EQ(0u, output.frames_in_flight());
+  EXPECT_EQ(1u, output.completions());
+}
+
+TEST(AsyncRpcChannelOutput, SendWhileSending_QueuesFrameInOtherBuffer) {
+  TestAsyncOutput output;
+
+  ASSERT_EQ(OkStatus(), output.SendByte('A'));
+  ASSERT_EQ(OkStatus(), output.SendByte('B'));
+  EXPECT_EQ(1u, output.sent_count());
+  EXPECT_EQ(2u, output.frames_in_flight());
+
+  // Both frame buffers are in use.
+  EXPECT_EQ(Status::ResourceExhausted(), output.SendByte('C'));
+
+  // Completing the first frame starts the queued one.
+  output.SendComplete(OkStatus());
+  ASSERT_EQ(2u, output.sent_count());
+  EXPECT_EQ(1u, output.frames_in_flight());
+  EXPECT_EQ('A', output.sent_payload(0));
+  EXPECT_EQ('B', output.sent_payload(1));
+
+  // The first buffer is free again while the second frame is on the wire.
+  ASSERT_EQ(OkStatus(), output.SendByte('C'));
+  output.SendComplete(OkStatus());
+  output.SendComplete(OkStatus());
+  ASSERT_EQ(3u, output.sent_count());
+  EXPECT_EQ('C', output.sent_payload(2));
+  EXPECT_EQ(0u, output.frames_in_flight());
+  EXPECT_EQ(3u, output.completions());
+}
+
+TEST(AsyncRpcChannelOutput, StartSendFails_ReturnsErrorAndFreesBuffer) {
+  TestAsyncOutput output;
+  output.set_start_status(Status::Unavailable());
+
+  EXPECT_EQ(Status::Unavailable(), output.SendByte('A'));
+  EXPECT_EQ(0u, output.frames_in_flight());
+  EXPECT_EQ(0u, output.completions());
+
+  output.set_start_status(OkStatus());
+  EXPECT_EQ(OkStatus(), output.SendByte('B'));
+  EXPECT_EQ(1u, output.frames_in_flight());
+}
+
+TEST(AsyncRpcChannelOutput, QueuedFrameFailsToStart_ReportedAsComplete) {
+  TestAsyncOutput output;
+
+  ASSERT_EQ(OkStatus(), output.SendByte('A'));
+  ASSERT_EQ(OkStatus(), output.SendByte('B'));
+
+  output.set_start_status(Status::Unavailable());
+  output.SendComplete(OkStatus());
+
+  EXPECT_EQ(2u, output.completions());
+  EXPECT_EQ(Status::Unavailable(), output.last_status());
+  EXPECT_EQ(0u, output.frames_in_flight());
+}
+
+TEST(AsyncRpcChannelOutput, EmptyPacket_SendsNothing) {
+  TestAsyncOutput output;
+
+  EXPECT_EQ(OkStatus(),
+            output.SendAndReleaseBuffer(output.AcquireBuffer().first(0)));
+  EXPECT_EQ(0u, output.sent_count());
+  EXPECT_EQ(0u, output.frames_in_flight());
+}
+
 }  // namespace
 }  // namespace pw::hdlc
@@ -0,0 +1,88 @@
+#!/usr/bin/env python
+# Copyright 2021 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Measures RPC latency and throughput of the example over HDLC."""
+
+import argparse
+import os
+from pathlib import Path
+
+import serial  # type: ignore
+
+from pw_hdlc.rpc import HdlcRpcClient, default_channels
+from pw_hdlc.rpc_console import SocketClientImpl
+from pw_rpc.benchmark import Benchmark
+
+PROTO = Path(os.environ['PW_ROOT'], 'pw_rpc/pw_rpc_protos/benchmark.proto')
+
+
+def script(device: str, baud: int, socket_addr: str, size: int,
+           iterations: int, stream_count: int, stream_size: int) -> None:
+    """Runs the unary latency and stream throughput benchmarks."""
+    if socket_addr is None:
+        ser = serial.Serial(device, baud, timeout=0.01)
+        read = lambda: ser.read(4096)
+        write = ser.write
+    else:
+        sock = SocketClientImpl(socket_addr)
+        read = sock.read
+        write = sock.write
+
+    client = HdlcRpcClient(read, [PROTO], default_channels(write))
+    benchmark = Benchmark(client.rpcs().pw.rpc.Benchmark)
+
+    print('UnaryEcho:', benchmark.unary_latency(size, iterations))
+    print('ServerStream:',
+          benchmark.stream_throughput(stream_count, stream_size))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+    group = parser.add_mutually_exclusive_group()
+    group.add_argument('--device',
+                       '-d',
+                       default='/dev/ttyACM0',
+                       help='serial device to use')
+    group.add_argument('--socket-addr',
+                       '-s',
+                       help='connect to a socket instead, such as '
+                       'localhost:33000 for the host example')
+    parser.add_argument('--baud',
+                        '-b',
+                        type=int,
+                        default=115200,
+                        help='baud rate for the serial device')
+    parser.add_argument('--size',
+                        type=int,
+                        default=64,
+                        help='UnaryEcho payload size in bytes')
+    parser.add_argument('--iterations',
+                        type=int,
+                        default=1000,
+                        help='number of UnaryEcho calls to time')
+    parser.add_argument('--stream-count',
+                        type=int,
+                        default=1000,
+                        help='number of ServerStream responses')
+    parser.add_argument('--stream-size',
+                        type=int,
+                        default=128,
+                        help='ServerStream payload size in bytes')
+    script(**vars(parser.parse_args()))
+
+
+if __name__ == '__main__':
+    main()
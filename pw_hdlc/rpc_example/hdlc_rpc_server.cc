@@ -19,6 +19,7 @@
 #include "pw_hdlc/encoder.h"
 #include "pw_hdlc/rpc_packets.h"
 #include "pw_log/log.h"
+#include "pw_rpc/benchmark_service_raw.h"
 #include "pw_rpc/echo_service_nanopb.h"
 #include "pw_rpc/server.h"
 #include "pw_rpc_system_server/rpc_server.h"
@@ -29,9 +30,11 @@ namespace {
 using std::byte;
 
 pw::rpc::EchoService echo_service;
+pw::rpc::BenchmarkService benchmark_service;
 
 void RegisterServices() {
   pw::rpc::system_server::Server().RegisterService(echo_service);
+  pw::rpc::system_server::Server().RegisterService(benchmark_service);
 }
 
 }  // namespace
@@ -48,4 +48,14 @@ bool WirePacketParser::Parse(ConstByteSpan packet) {
   return status.ok() || status.IsResourceExhausted();
 }
 
+bool DecodedFrameParser::Parse(ConstByteSpan packet) {
+  // A decoded frame without its FCS has at least an address and control byte.
+  if (packet.size_bytes() < 2) {
+    return false;
+  }
+
+  address_ = static_cast<uint8_t>(packet[0]) >> address_shift_;
+  return true;
+}
+
 }  // namespace pw::hdlc
@@ -127,5 +127,26 @@ TEST(WirePacketParser, Parse_EmptyPacket) {
   EXPECT_FALSE(parser.Parse({}));
 }
 
+TEST(DecodedFrameParser, Parse_ReadsAddress) {
+  DecodedFrameParser parser;
+  EXPECT_TRUE(
+      parser.Parse(bytes::Concat(kAddress, kControl, bytes::String("hello"))));
+  auto maybe_address = parser.GetDestinationAddress();
+  EXPECT_TRUE(maybe_address.has_value());
+  EXPECT_EQ(maybe_address.value(), kAddress);
+}
+
+TEST(DecodedFrameParser, Parse_AddressBits) {
+  DecodedFrameParser parser(4);
+  EXPECT_TRUE(parser.Parse(bytes::Concat(std::byte{0xab}, kControl)));
+  EXPECT_EQ(parser.GetDestinationAddress().value(), 0xau);
+}
+
+TEST(DecodedFrameParser, Parse_TooShort) {
+  DecodedFrameParser parser;
+  EXPECT_FALSE(parser.Parse({}));
+  EXPECT_FALSE(parser.Parse(bytes::Concat(kAddress)));
+}
+
 }  // namespace
 }  // namespace pw::hdlc
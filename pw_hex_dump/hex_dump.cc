@@ -14,8 +14,9 @@
 
 #include "pw_hex_dump/hex_dump.h"
 
-#include <cctype>
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <string_view>
 
 #include "pw_status/status_with_size.h"
@@ -37,11 +38,25 @@ constexpr const std::string_view kAsciiHeader("Text");
 // Minimum number of hex characters to use when displaying dump offset.
 constexpr const size_t kMinOffsetChars = 4;
 
+constexpr const char kHexDigits[] = "0123456789abcdef";
+
+// Matches std::isprint() in the "C" locale, without the locale lookup.
 char PrintableChar(std::byte b) {
-  if (std::isprint(std::to_integer<char>(b)) == 0) {
-    return '.';
+  const char c = std::to_integer<char>(b);
+  return c >= ' ' && c <= '~' ? c : '.';
+}
+
+// Writes the lowest width hex digits of value, zero padded.
+char* WriteHex(uintptr_t value, size_t width, char* out) {
+  for (size_t i = width; i > 0; --i) {
+    out[i - 1] = kHexDigits[value & 0xF];
+    value >>= 4;
   }
-  return std::to_integer<char>(b);
+  return out + width;
+}
+
+char* WriteString(std::string_view value, char* out) {
+  return std::copy(value.begin(), value.end(), out);
 }
 
 }  // namespace
@@ -60,8 +75,8 @@ Status DumpAddr(std::span<char> dest, uintptr_t addr) {
   return IntToHexString(addr, dest.subspan(2), sizeof(uintptr_t) * 2).status();
 }
 
-Status FormattedHexDumper::PrintFormatHeader() {
-  StringBuilder builder(dest_);
+StatusWithSize FormattedHexDumper::PrintFormatHeader(std::span<char> dest) {
+  StringBuilder builder(dest);
 
   if (flags.prefix_mode != AddressMode::kDisabled) {
     std::string_view header(flags.prefix_mode == AddressMode::kOffset
@@ -70,9 +85,7 @@ Status FormattedHexDumper::PrintFormatHeader() {
     // Pad to align to address width.
     size_t padding = 0;
     if (flags.prefix_mode == AddressMode::kOffset) {
-      size_t offs_width =
-          HexDigitCount(source_data_.size_bytes() + current_offset_);
-      padding = std::max(offs_width, kMinOffsetChars);
+      padding = OffsetWidth();
     } else {
       padding = kHexAddrStringSize;
     }
@@ -118,7 +131,7 @@ Status FormattedHexDumper::PrintFormatHeader() {
     builder << kAsciiHeader;
   }
 
-  return builder.status();
+  return builder.status_with_size();
 }
 
 Status FormattedHexDumper::DumpLine() {
@@ -130,84 +143,138 @@ Status FormattedHexDumper::DumpLine() {
     return Status::FailedPrecondition();
   }
 
-  if (dest_[0] == 0 && flags.show_header) {
+  if (header_pending_ && flags.show_header) {
     // First line, print out dump format header.
-    return PrintFormatHeader();
+    header_pending_ = false;
+    return PrintFormatHeader(dest_).status();
   }
 
-  StringBuilder builder(dest_);
-  // Dump address/offset prefix.
-  // TODO(amontanez): This block can be much nicer if StringBuilder exposed an
-  // easy way to control zero padding for hex address.
-  if (flags.prefix_mode != AddressMode::kDisabled) {
-    uintptr_t val;
-    if (flags.prefix_mode == AddressMode::kAbsolute) {
-      val = reinterpret_cast<uintptr_t>(source_data_.data());
-      builder << "0x";
-      uint8_t significant = HexDigitCount(val);
-      builder.append(sizeof(uintptr_t) * 2 - significant, '0');
-    } else {
-      val = current_offset_;
-      size_t significant =
-          HexDigitCount(source_data_.size_bytes() + current_offset_);
-      if (significant < kMinOffsetChars) {
-        builder.append(kMinOffsetChars - significant, '0');
-      }
-    }
-    if (val != 0) {
-      builder << reinterpret_cast<void*>(val);
-    } else {
-      builder.append(2, '0');
+  header_pending_ = false;
+  *FormatLine(dest_.data()) = '\0';
+  return OkStatus();
+}
+
+StatusWithSize FormattedHexDumper::DumpLines(std::span<char> dest) {
+  if (source_data_.empty()) {
+    return StatusWithSize::ResourceExhausted();
+  }
+
+  // Each line is followed by a newline.
+  const size_t line_size = MaxLineSize() + 1;
+  if (flags.bytes_per_line == 0 || dest.size() < line_size) {
+    return StatusWithSize::FailedPrecondition();
+  }
+
+  size_t written = 0;
+  if (header_pending_ && flags.show_header) {
+    // Room is left for the newline.
+    StatusWithSize header = PrintFormatHeader(dest.first(dest.size() - 1));
+    if (!header.ok()) {
+      return StatusWithSize::FailedPrecondition();
     }
-    builder << kAddressSeparator;
+    written = header.size();
+    dest[written++] = '\n';
   }
+  header_pending_ = false;
 
-  size_t bytes_in_line = std::min(source_data_.size_bytes(),
-                                  static_cast<size_t>(flags.bytes_per_line));
-  // Convert raw bytes to hex characters.
-  for (size_t i = 0; i < bytes_in_line; ++i) {
-    // Early loop termination for when bytes_remaining <
-    // bytes_per_line.
-    uint8_t c = std::to_integer<uint8_t>(source_data_[i]);
-    // TODO(amontanez): Maybe StringBuilder can be augmented to support full-
-    // width bytes? (`04` instead of `4`, for example)
-    builder << std::byte(c >> 4);
-    builder << std::byte(c & 0xF);
-    if (flags.group_every != 0 && (i + 1) % flags.group_every == 0) {
-      builder << ' ';
+  while (!source_data_.empty() && dest.size() - written >= line_size) {
+    char* const end = FormatLine(&dest[written]);
+    *end = '\n';
+    written = static_cast<size_t>(end - dest.data()) + 1;
+  }
+  return StatusWithSize(written);
+}
+
+Status FormattedHexDumper::Dump(stream::Writer& writer,
+                                std::span<char> buffer) {
+  while (true) {
+    const StatusWithSize result = DumpLines(buffer);
+    if (result.IsResourceExhausted()) {
+      return OkStatus();
+    }
+    if (!result.ok()) {
+      return result.status();
+    }
+    if (Status status = writer.Write(buffer.data(), result.size());
+        !status.ok()) {
+      return status;
     }
   }
-  // Add padding spaces to ensure lines are aligned.
+}
+
+size_t FormattedHexDumper::OffsetWidth() const {
+  return std::max<size_t>(
+      HexDigitCount(source_data_.size_bytes() + current_offset_),
+      kMinOffsetChars);
+}
+
+size_t FormattedHexDumper::MaxLineSize() const {
+  size_t size = flags.bytes_per_line * 2;
   if (flags.show_ascii) {
-    for (size_t i = bytes_in_line;
-         i < static_cast<size_t>(flags.bytes_per_line);
-         ++i) {
-      builder.append(2, ' ');
-      if (flags.group_every != 0 && (i + 1) % flags.group_every == 0) {
-        builder << ' ';
-      }
-    }
+    size += kSectionSeparator.length() + flags.bytes_per_line;
   }
+  if (flags.prefix_mode == AddressMode::kAbsolute) {
+    size += kHexAddrStringSize + kAddressSeparator.length();
+  } else if (flags.prefix_mode == AddressMode::kOffset) {
+    size += OffsetWidth() + kAddressSeparator.length();
+  }
+  if (flags.group_every != 0 && flags.bytes_per_line != 0) {
+    size += (flags.bytes_per_line - 1) / flags.group_every;
+  }
+  return size;
+}
 
-  // Removes extraneous space from end when bytes_per_line is divisible by
-  // group_every. kSectionSeparator includes a space, so it's unnecessary.
-  // Ommitting the space from the section separator actually makes for more
-  // workarounds and code duplication, so this is better.
-  if (flags.group_every != 0 && flags.bytes_per_line % flags.group_every == 0) {
-    builder.pop_back();
+char* FormattedHexDumper::FormatLine(char* out) {
+  // Dump address/offset prefix.
+  if (flags.prefix_mode == AddressMode::kAbsolute) {
+    out = WriteString("0x", out);
+    out = WriteHex(reinterpret_cast<uintptr_t>(source_data_.data()),
+                   sizeof(uintptr_t) * 2,
+                   out);
+    out = WriteString(kAddressSeparator, out);
+  } else if (flags.prefix_mode == AddressMode::kOffset) {
+    out = WriteHex(current_offset_, OffsetWidth(), out);
+    out = WriteString(kAddressSeparator, out);
+  }
+
+  const size_t bytes_in_line = std::min(
+      source_data_.size_bytes(), static_cast<size_t>(flags.bytes_per_line));
+  // Lines are padded with spaces to align the ASCII column. A group separator
+  // is not written after the last column.
+  const size_t columns =
+      flags.show_ascii ? flags.bytes_per_line : bytes_in_line;
+  size_t group_remaining = flags.group_every;
+
+  // Convert raw bytes to hex characters.
+  for (size_t i = 0; i < columns; ++i) {
+    if (i < bytes_in_line) {
+      const uint8_t c = std::to_integer<uint8_t>(source_data_[i]);
+      out[0] = kHexDigits[c >> 4];
+      out[1] = kHexDigits[c & 0xF];
+    } else {
+      out[0] = ' ';
+      out[1] = ' ';
+    }
+    out += 2;
+    if (group_remaining != 0 && --group_remaining == 0) {
+      if (i + 1 < columns) {
+        *out++ = ' ';
+      }
+      group_remaining = flags.group_every;
+    }
   }
 
   // Interpret bytes as characters.
   if (flags.show_ascii) {
-    builder << kSectionSeparator;
+    out = WriteString(kSectionSeparator, out);
     for (size_t i = 0; i < bytes_in_line; ++i) {
-      builder << PrintableChar(source_data_[i]);
+      *out++ = PrintableChar(source_data_[i]);
     }
   }
 
   source_data_ = source_data_.subspan(bytes_in_line);
   current_offset_ += bytes_in_line;
-  return builder.status();
+  return out;
 }
 
 Status FormattedHexDumper::SetLineBuffer(std::span<char> dest) {
@@ -220,6 +287,7 @@ Status FormattedHexDumper::SetLineBuffer(std::span<char> dest) {
 
 Status FormattedHexDumper::BeginDump(ConstByteSpan data) {
   current_offset_ = 0;
+  header_pending_ = true;
   source_data_ = data;
   if (data.data() == nullptr) {
     return Status::InvalidArgument();
@@ -231,25 +299,8 @@ Status FormattedHexDumper::BeginDump(ConstByteSpan data) {
 }
 
 Status FormattedHexDumper::ValidateBufferSize() {
-  // Minimum size is number of bytes per line as hex pairs plus the null
-  // terminator.
-  size_t required_size = flags.bytes_per_line * 2 + 1;
-  if (flags.show_ascii) {
-    required_size += kSectionSeparator.length() + flags.bytes_per_line;
-  }
-  if (flags.prefix_mode == AddressMode::kAbsolute) {
-    required_size += kHexAddrStringSize;
-    required_size += kAddressSeparator.length();
-  } else if (flags.prefix_mode == AddressMode::kOffset) {
-    required_size +=
-        HexDigitCount(std::max(source_data_.size_bytes(), kMinOffsetChars));
-    required_size += kAddressSeparator.length();
-  }
-  if (flags.group_every != 0) {
-    required_size += (flags.bytes_per_line - 1) / flags.group_every;
-  }
-
-  if (dest_.size_bytes() < required_size) {
+  // Minimum size is the longest line plus the null terminator.
+  if (dest_.size_bytes() < MaxLineSize() + 1) {
     return Status::ResourceExhausted();
   }
 
@@ -23,6 +23,7 @@
 
 #include "gtest/gtest.h"
 #include "pw_log/log.h"
+#include "pw_stream/memory_stream.h"
 
 namespace pw::dump {
 namespace {
@@ -333,6 +334,126 @@ TEST_F(HexDump, FormattedHexDump_AbsolutePrefix) {
   EXPECT_STREQ(expected2.data(), dest_.data());
 }
 
+TEST_F(HexDump, FormattedHexDump_PartialLineGroups) {
+  constexpr const char* expected1 = "6d792074 65737420";
+  constexpr const char* expected2 = "73747269 6e670a";
+
+  default_flags_.bytes_per_line = 8;
+  default_flags_.group_every = 4;
+  dumper_ = FormattedHexDumper(dest_, default_flags_);
+
+  EXPECT_TRUE(dumper_.BeginDump(short_string).ok());
+  EXPECT_TRUE(dumper_.DumpLine().ok());
+  EXPECT_STREQ(expected1, dest_.data());
+  EXPECT_TRUE(dumper_.DumpLine().ok());
+  EXPECT_STREQ(expected2, dest_.data());
+}
+
+TEST_F(HexDump, DumpLines_MatchesDumpLine) {
+  default_flags_.show_ascii = true;
+  default_flags_.show_header = true;
+  default_flags_.prefix_mode = FormattedHexDumper::AddressMode::kOffset;
+  dumper_ = FormattedHexDumper(dest_, default_flags_);
+
+  std::array<char, 512> expected = {};
+  size_t expected_size = 0;
+  EXPECT_TRUE(dumper_.BeginDump(source_data).ok());
+  while (dumper_.DumpLine().ok()) {
+    const size_t length = std::strlen(dest_.data());
+    std::memcpy(&expected[expected_size], dest_.data(), length);
+    expected_size += length;
+    expected[expected_size++] = '\n';
+  }
+
+  std::array<char, 512> batch;
+  EXPECT_TRUE(dumper_.BeginDump(source_data).ok());
+  StatusWithSize result = dumper_.DumpLines(batch);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(std::string_view(expected.data(), expected_size),
+            std::string_view(batch.data(), result.size()));
+  EXPECT_EQ(Status::ResourceExhausted(), dumper_.DumpLines(batch).status());
+}
+
+TEST_F(HexDump, DumpLines_OnlyWholeLines) {
+  constexpr std::string_view kExpected1 =
+      "a4 cc 32 62 9b 46 38 1a\n23 1a 2a 7a bc e2 40 a0\n";
+  constexpr std::string_view kExpected2 =
+      "ff 33 e5 2b 9e 9f 6b 3c\nbe 9b 89 3c 7e 4a 7a 48\n";
+
+  default_flags_.bytes_per_line = 8;
+  dumper_ = FormattedHexDumper(dest_, default_flags_);
+
+  // Room for two lines and part of a third.
+  std::array<char, 60> batch;
+  EXPECT_TRUE(dumper_.BeginDump(source_data).ok());
+  StatusWithSize result = dumper_.DumpLines(batch);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(kExpected1, std::string_view(batch.data(), result.size()));
+
+  result = dumper_.DumpLines(batch);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(kExpected2, std::string_view(batch.data(), result.size()));
+
+  result = dumper_.DumpLines(batch);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ("18\n", std::string_view(batch.data(), result.size()));
+  EXPECT_EQ(Status::ResourceExhausted(), dumper_.DumpLines(batch).status());
+}
+
+TEST_F(HexDump, DumpLines_BufferTooSmall) {
+  std::array<char, 47> batch;  // One short of a line and its newline.
+  EXPECT_TRUE(dumper_.BeginDump(source_data).ok());
+  EXPECT_EQ(Status::FailedPrecondition(), dumper_.DumpLines(batch).status());
+  EXPECT_EQ(OkStatus(), dumper_.DumpLines(std::span(dest_).first(48)).status());
+}
+
+// Counts the calls to Write(), which go straight to memory.
+class CountingWriter : public stream::Writer {
+ public:
+  CountingWriter(ByteSpan buffer) : writer_(buffer) {}
+
+  size_t writes() const { return writes_; }
+  std::string_view data() const {
+    return std::string_view(reinterpret_cast<const char*>(writer_.data()),
+                            writer_.bytes_written());
+  }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    writes_ += 1;
+    return writer_.Write(data);
+  }
+
+  stream::MemoryWriter writer_;
+  size_t writes_ = 0;
+};
+
+TEST_F(HexDump, Dump_WritesBatchesToWriter) {
+  default_flags_.bytes_per_line = 4;
+  dumper_ = FormattedHexDumper(dest_, default_flags_);
+
+  std::array<std::byte, 256> output;
+  CountingWriter writer(output);
+  // Room for three 12-character lines at a time.
+  std::array<char, 40> batch;
+  EXPECT_TRUE(dumper_.BeginDump(source_data).ok());
+  EXPECT_EQ(OkStatus(), dumper_.Dump(writer, batch));
+
+  EXPECT_EQ(
+      "a4 cc 32 62\n9b 46 38 1a\n23 1a 2a 7a\nbc e2 40 a0\n"
+      "ff 33 e5 2b\n9e 9f 6b 3c\nbe 9b 89 3c\n7e 4a 7a 48\n18\n",
+      writer.data());
+  EXPECT_EQ(3u, writer.writes());
+}
+
+TEST_F(HexDump, Dump_ReturnsWriterError) {
+  std::array<std::byte, 8> output;
+  stream::MemoryWriter writer(output);
+  std::array<char, 64> batch;
+  EXPECT_TRUE(dumper_.BeginDump(source_data).ok());
+  EXPECT_EQ(Status::ResourceExhausted(), dumper_.Dump(writer, batch));
+}
+
 TEST_F(SmallBuffer, TinyHexDump) {
   constexpr const char* expected = "a4cc32";
 
@@ -19,6 +19,8 @@
 
 #include "pw_bytes/span.h"
 #include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
 
 namespace pw::dump {
 
@@ -142,11 +144,51 @@ class FormattedHexDumper {
   //     formatting configuration.
   Status DumpLine();
 
+  // Dumps as many whole lines as fit in dest, each followed by a newline, and
+  // returns the number of characters written. The output is not null
+  // terminated, and the line buffer is not used. The header is the first line,
+  // if it is enabled and has not been dumped yet.
+  //
+  // Returns:
+  //   OK - One or more lines have been written to dest.
+  //   RESOURCE_EXHAUSTED - All the data has been dumped.
+  //   FAILED_PRECONDITION - dest is too small to fit one line.
+  StatusWithSize DumpLines(std::span<char> dest);
+
+  // Dumps all of the remaining data to the writer. Lines are formatted into
+  // buffer with DumpLines(), and each filled buffer is written with a single
+  // call to the writer, so a larger buffer means fewer, larger writes.
+  //
+  // Example usage:
+  //
+  //   std::array<char, 512> buffer;
+  //   FormattedHexDumper hex_dumper;
+  //   hex_dumper.BeginDump(flash_region);
+  //   hex_dumper.Dump(uart_writer, buffer);
+  //
+  // Returns:
+  //   OK - All the data has been dumped.
+  //   FAILED_PRECONDITION - buffer is too small to fit one line.
+  //   Any error returned by the writer, in which case the dump stops.
+  Status Dump(stream::Writer& writer, std::span<char> buffer);
+
  private:
   Status ValidateBufferSize();
-  Status PrintFormatHeader();
+  StatusWithSize PrintFormatHeader(std::span<char> dest);
+
+  // The number of hex digits in an offset prefix.
+  size_t OffsetWidth() const;
+
+  // The length of the longest line of data, without a null terminator.
+  size_t MaxLineSize() const;
+
+  // Formats the next line of data at out, without a null terminator, and
+  // advances past it. Returns the end of the line. out must have room for
+  // MaxLineSize() characters.
+  char* FormatLine(char* out);
 
   size_t current_offset_;
+  bool header_pending_ = false;
   std::span<char> dest_;
   ConstByteSpan source_data_;
 };
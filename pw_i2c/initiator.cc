@@ -0,0 +1,55 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_i2c/initiator.h"
+
+#include <algorithm>
+
+#include "pw_status/try.h"
+
+namespace pw::i2c {
+
+Status Initiator::DoTransferFor(std::span<const Message> messages,
+                                chrono::SystemClock::duration for_at_least) {
+  const chrono::SystemClock::time_point deadline =
+      chrono::SystemClock::now() + for_at_least;
+
+  for (size_t i = 0; i < messages.size(); ++i) {
+    const Message& message = messages[i];
+    const chrono::SystemClock::duration remaining =
+        std::max(deadline - chrono::SystemClock::now(),
+                 chrono::SystemClock::duration::zero());
+
+    // A write followed by a read of the same device, such as selecting and
+    // then reading a register, is performed as one write-read transaction.
+    if (message.is_write() && i + 1 < messages.size() &&
+        messages[i + 1].is_read() &&
+        messages[i + 1].address().GetTenBit() ==
+            message.address().GetTenBit()) {
+      i += 1;
+      PW_TRY(DoWriteReadFor(message.address(),
+                            message.tx_buffer(),
+                            messages[i].rx_buffer(),
+                            remaining));
+    } else {
+      PW_TRY(DoWriteReadFor(message.address(),
+                            message.tx_buffer(),
+                            message.rx_buffer(),
+                            remaining));
+    }
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::i2c
@@ -0,0 +1,191 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_i2c/initiator.h"
+
+#include <array>
+#include <cstddef>
+
+#include "gtest/gtest.h"
+
+namespace pw::i2c {
+namespace {
+
+constexpr auto kTimeout =
+    std::chrono::duration_cast<chrono::SystemClock::duration>(
+        std::chrono::milliseconds(10));
+
+// Records each transaction and fills read buffers with the device address.
+class RecordingInitiator : public Initiator {
+ public:
+  struct Transaction {
+    uint16_t address;
+    size_t tx_size;
+    size_t rx_size;
+  };
+
+  std::array<Transaction, 8> transactions = {};
+  size_t count = 0;
+  size_t fail_at = 8;
+
+ private:
+  Status DoWriteReadFor(Address device_address,
+                        ConstByteSpan tx_buffer,
+                        ByteSpan rx_buffer,
+                        chrono::SystemClock::duration) override {
+    if (count == fail_at) {
+      return Status::Unavailable();
+    }
+    transactions[count++] = {
+        device_address.GetTenBit(), tx_buffer.size(), rx_buffer.size()};
+    for (std::byte& b : rx_buffer) {
+      b = std::byte(device_address.GetTenBit());
+    }
+    return OkStatus();
+  }
+};
+
+TEST(Initiator, TransferFor_CombinesWriteThenReadOfSameDevice) {
+  const Address sensor(0x12);
+  const Address display(0x34);
+  const std::byte reg[1] = {std::byte{0x0f}};
+  std::byte value[2] = {};
+  const std::byte pixels[3] = {};
+
+  const Message messages[] = {
+      Message::WriteMessage(sensor, reg),
+      Message::ReadMessage(sensor, value),
+      Message::WriteMessage(display, pixels),
+      Message::ReadMessage(sensor, value),
+  };
+
+  RecordingInitiator initiator;
+  EXPECT_EQ(OkStatus(), initiator.TransferFor(messages, kTimeout));
+
+  ASSERT_EQ(3u, initiator.count);
+  EXPECT_EQ(0x12u, initiator.transactions[0].address);
+  EXPECT_EQ(1u, initiator.transactions[0].tx_size);
+  EXPECT_EQ(2u, initiator.transactions[0].rx_size);
+  EXPECT_EQ(0x34u, initiator.transactions[1].address);
+  EXPECT_EQ(3u, initiator.transactions[1].tx_size);
+  EXPECT_EQ(0u, initiator.transactions[1].rx_size);
+  EXPECT_EQ(0u, initiator.transactions[2].tx_size);
+  EXPECT_EQ(2u, initiator.transactions[2].rx_size);
+  EXPECT_EQ(std::byte{0x12}, value[1]);
+}
+
+TEST(Initiator, TransferFor_DoesNotCombineDifferentDevices) {
+  const std::byte reg[1] = {};
+  std::byte value[1] = {};
+  const Message messages[] = {
+      Message::WriteMessage(Address(0x12), reg),
+      Message::ReadMessage(Address(0x13), value),
+  };
+
+  RecordingInitiator initiator;
+  EXPECT_EQ(OkStatus(), initiator.TransferFor(messages, kTimeout));
+  EXPECT_EQ(2u, initiator.count);
+}
+
+TEST(Initiator, TransferFor_StopsAtFirstError) {
+  const std::byte data[1] = {};
+  const Message messages[] = {
+      Message::WriteMessage(Address(0x01), data),
+      Message::WriteMessage(Address(0x02), data),
+      Message::WriteMessage(Address(0x03), data),
+  };
+
+  RecordingInitiator initiator;
+  initiator.fail_at = 1;
+  EXPECT_EQ(Status::Unavailable(), initiator.TransferFor(messages, kTimeout));
+  EXPECT_EQ(1u, initiator.count);
+}
+
+TEST(Initiator, TransferFor_Empty) {
+  RecordingInitiator initiator;
+  EXPECT_EQ(OkStatus(), initiator.TransferFor({}, kTimeout));
+  EXPECT_EQ(0u, initiator.count);
+}
+
+void FailTest(Status, void*) { FAIL(); }
+
+TEST(Initiator, StartTransfer_UnimplementedByDefault) {
+  RecordingInitiator initiator;
+  EXPECT_EQ(Status::Unimplemented(), initiator.StartTransfer({}, FailTest));
+}
+
+// Completes asynchronous transfers when Complete() is called, as an interrupt
+// handler would.
+class AsyncInitiator : public RecordingInitiator {
+ public:
+  void Complete() {
+    const Status status = TransferFor(pending_, kTimeout);
+    pending_ = {};
+    callback_(status, arg_);
+  }
+
+ private:
+  Status DoStartTransfer(std::span<const Message> messages,
+                         TransferCallback callback,
+                         void* arg) override {
+    if (!pending_.empty()) {
+      return Status::Unavailable();
+    }
+    pending_ = messages;
+    callback_ = callback;
+    arg_ = arg;
+    return OkStatus();
+  }
+
+  std::span<const Message> pending_;
+  TransferCallback callback_ = nullptr;
+  void* arg_ = nullptr;
+};
+
+TEST(Initiator, StartTransfer_InvokesCallbackOnCompletion) {
+  std::byte value[1] = {};
+  const Message messages[] = {Message::ReadMessage(Address(0x42), value)};
+
+  AsyncInitiator initiator;
+  Status result = Status::Unknown();
+  ASSERT_EQ(OkStatus(),
+            initiator.StartTransfer(
+                messages,
+                [](Status status, void* arg) {
+                  *static_cast<Status*>(arg) = status;
+                },
+                &result));
+  EXPECT_EQ(Status::Unavailable(), initiator.StartTransfer(messages, FailTest));
+  EXPECT_EQ(Status::Unknown(), result);
+
+  initiator.Complete();
+  EXPECT_EQ(OkStatus(), result);
+  EXPECT_EQ(std::byte{0x42}, value[0]);
+}
+
+TEST(Message, Buffers) {
+  std::byte buffer[4] = {};
+  const Message write = Message::WriteMessage(Address(0x10), buffer);
+  EXPECT_TRUE(write.is_write());
+  EXPECT_EQ(4u, write.tx_buffer().size());
+  EXPECT_TRUE(write.rx_buffer().empty());
+
+  const Message read = Message::ReadMessage(Address(0x10), buffer);
+  EXPECT_TRUE(read.is_read());
+  EXPECT_EQ(buffer, read.rx_buffer().data());
+  EXPECT_TRUE(read.tx_buffer().empty());
+}
+
+}  // namespace
+}  // namespace pw::i2c
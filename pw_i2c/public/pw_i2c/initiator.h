@@ -14,6 +14,7 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 
 #include "pw_bytes/span.h"
 #include "pw_chrono/system_clock.h"
@@ -22,6 +23,55 @@
 
 namespace pw::i2c {
 
+// One write or read of a batched I2C transfer. A Message refers to its buffer,
+// which must remain valid while the transfer is in progress.
+class Message {
+ public:
+  // Writes the bytes in tx_buffer to the device.
+  static constexpr Message WriteMessage(Address device_address,
+                                        ConstByteSpan tx_buffer) {
+    return Message(device_address, tx_buffer.data(), tx_buffer.size(), false);
+  }
+
+  // Reads from the device into rx_buffer.
+  static constexpr Message ReadMessage(Address device_address,
+                                       ByteSpan rx_buffer) {
+    return Message(device_address, rx_buffer.data(), rx_buffer.size(), true);
+  }
+
+  constexpr Address address() const { return address_; }
+
+  constexpr bool is_read() const { return read_; }
+  constexpr bool is_write() const { return !read_; }
+
+  // The bytes to write. Empty for read messages.
+  constexpr ConstByteSpan tx_buffer() const {
+    return read_ ? ConstByteSpan() : ConstByteSpan(data_, size_bytes_);
+  }
+
+  // The buffer to read into. Empty for write messages.
+  ByteSpan rx_buffer() const {
+    // Read messages are only created from mutable buffers.
+    return read_ ? ByteSpan(const_cast<std::byte*>(data_), size_bytes_)
+                 : ByteSpan();
+  }
+
+ private:
+  constexpr Message(Address device_address,
+                    const std::byte* data,
+                    size_t size_bytes,
+                    bool read)
+      : address_(device_address),
+        data_(data),
+        size_bytes_(size_bytes),
+        read_(read) {}
+
+  Address address_;
+  const std::byte* data_;
+  size_t size_bytes_;
+  bool read_;
+};
+
 // Base driver interface for I2C initiating I2C transactions in a thread safe
 // manner. Other documentation sources may call this style of interface an I2C
 // "master", "central" or "controller".
@@ -182,7 +232,79 @@ class Initiator {
         device_address, ConstByteSpan(), ignored_buffer, for_at_least);
   }
 
+  // Performs a batch of write and read messages back to back, stopping at the
+  // first error. Batching many small transactions, such as the register reads
+  // of a sensor polling loop, avoids acquiring the bus and waiting for each
+  // transaction separately. Ideally, the messages are one transaction with a
+  // repeated START between messages:
+  //
+  //   START + Message 1 + START + Message 2 + ... + START + Message N + STOP
+  //
+  // Initiators without native support for batches perform each write message
+  // that is followed by a read of the same address as one WriteReadFor(), and
+  // every other message as its own transaction. On a multi-initiator bus, other
+  // transactions may then occur between those transactions.
+  //
+  // The timeout defines the minimum duration one may block waiting for both
+  // exclusive bus access and the completion of every message.
+  //
+  // Preconditions:
+  // The Addresses must be supported by the Initiator, i.e. do not use a 10
+  //     address if the Initiator only supports 7 bit. This will assert.
+  //
+  // Returns:
+  // Ok - Success.
+  // InvalidArgument - An address is larger than the 10 bit address space.
+  // DeadlineExceeded - Was unable to acquire exclusive Initiator access
+  //   and complete the messages in time.
+  // Unavailable - NACK condition occurred, meaning an addressed device did
+  //   not respond or was unable to process the request.
+  // FailedPrecondition - The interface is not currently initialized and/or
+  //    enabled.
+  Status TransferFor(std::span<const Message> messages,
+                     chrono::SystemClock::duration for_at_least) {
+    return DoTransferFor(messages, for_at_least);
+  }
+
+  // Invoked once when an asynchronous transfer completes, with the status that
+  // TransferFor() would have returned. Initiators may invoke the callback from
+  // an interrupt, so it must be interrupt safe.
+  using TransferCallback = void (*)(Status status, void* arg);
+
+  // Starts performing a batch of messages, as TransferFor() would, and returns
+  // without waiting for them to complete. Initiators may perform the transfer
+  // with DMA or interrupts, so the CPU is free until the callback is invoked.
+  //
+  // The messages and their buffers must remain valid until the callback is
+  // invoked. Only one asynchronous transfer may be in progress at a time.
+  //
+  // Returns:
+  // Ok - The transfer started; the callback will be invoked once.
+  // Unavailable - Another asynchronous transfer is in progress.
+  // FailedPrecondition - The interface is not currently initialized and/or
+  //    enabled.
+  // Unimplemented - The Initiator does not support asynchronous transfers.
+  //
+  // The callback is not invoked if the transfer did not start.
+  Status StartTransfer(std::span<const Message> messages,
+                       TransferCallback callback,
+                       void* arg = nullptr) {
+    return DoStartTransfer(messages, callback, arg);
+  }
+
  private:
+  // Performs the messages with DoWriteReadFor(). Initiators that can perform a
+  // batch as one transaction should override this.
+  virtual Status DoTransferFor(std::span<const Message> messages,
+                               chrono::SystemClock::duration for_at_least);
+
+  // Initiators that support asynchronous transfers must override this.
+  virtual Status DoStartTransfer(std::span<const Message>,
+                                 TransferCallback,
+                                 void*) {
+    return Status::Unimplemented();
+  }
+
   virtual Status DoWriteReadFor(Address device_address,
                                 ConstByteSpan tx_buffer,
                                 ByteSpan rx_buffer,
@@ -16,6 +16,7 @@
 
 #include "gtest/gtest.h"
 #include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/crc32_checksum.h"
 
 namespace pw::kvs {
 namespace {
@@ -68,6 +69,30 @@ TEST(Checksum, Reset) {
   EXPECT_EQ(state[1], byte{0xFF});
 }
 
+TEST(ChecksumCrc32, UpdateAndVerify) {
+  ChecksumCrc32 crc32_algo;
+  ChecksumAlgorithm& algo = crc32_algo;
+
+  const uint32_t crc =
+      checksum::Crc32::Calculate(std::as_bytes(std::span(kString)));
+  algo.Update(kString.data(), 10);
+  algo.Update(kString.data() + 10, kString.size() - 10);
+  algo.Finish();
+  EXPECT_EQ(OkStatus(), algo.Verify(std::as_bytes(std::span(&crc, 1))));
+}
+
+TEST(ChecksumCrc32, Reset) {
+  ChecksumCrc32 algo;
+  algo.Update(std::as_bytes(std::span(kString)));
+  algo.Finish();
+  algo.Reset();
+
+  const uint32_t empty_crc = PW_CHECKSUM_EMPTY_CRC32;
+  EXPECT_EQ(OkStatus(), algo.Verify(std::as_bytes(std::span(&empty_crc, 1))));
+  algo.Finish();
+  EXPECT_EQ(OkStatus(), algo.Verify(std::as_bytes(std::span(&empty_crc, 1))));
+}
+
 TEST(IgnoreChecksum, NeverUpdate_VerifyWithoutData) {
   IgnoreChecksum checksum;
 
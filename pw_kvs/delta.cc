@@ -0,0 +1,234 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/internal/delta.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_status/try.h"
+
+namespace pw::kvs::internal {
+
+using std::byte;
+
+size_t DeltaPatches::encoded_size() const {
+  size_t size = sizeof(DeltaHeader);
+  for (const DeltaPatch& patch : patches()) {
+    size += sizeof(DeltaPatch) + patch.size;
+  }
+  return size;
+}
+
+void DeltaPatches::AddChange(size_t offset) {
+  if (count_ != 0u) {
+    DeltaPatch& last = patches_[count_ - 1];
+    const size_t last_end = last.offset + last.size;
+
+    if (count_ == kMaxDeltaPatches ||
+        offset - last_end <= sizeof(DeltaPatch)) {
+      last.size = static_cast<uint16_t>(offset + 1 - last.offset);
+      return;
+    }
+  }
+
+  patches_[count_] = {.offset = static_cast<uint16_t>(offset), .size = 1};
+  count_ += 1;
+}
+
+size_t DeltaPatches::EncodeChunks(
+    const DeltaHeader& header,
+    std::span<const byte> new_value,
+    std::span<std::span<const byte>, kMaxValueChunks> chunks) const {
+  size_t count = 0;
+  chunks[count++] = std::as_bytes(std::span(&header, 1));
+
+  for (const DeltaPatch& patch : patches()) {
+    chunks[count++] = std::as_bytes(std::span(&patch, 1));
+    chunks[count++] = new_value.subspan(patch.offset, patch.size);
+  }
+  return count;
+}
+
+Status DeltaChain::Load(FlashPartition& partition,
+                        const EntryFormats& formats,
+                        const Entry& newest) {
+  partition_ = &partition;
+  key_length_ = newest.key_length();
+  length_ = 0;
+
+  Entry::KeyBuffer newest_key;
+  PW_TRY(newest.ReadKey(newest_key));
+
+  Entry entry = newest;
+  size_t chain_length = 0;
+
+  while (true) {
+    addresses_[length_] = entry.address();
+    sizes_[length_] = entry.size();
+    length_ += 1;
+
+    if (!entry.delta()) {
+      if (length_ == 1u) {
+        value_size_ = entry.value_size();
+      } else if (entry.value_size() != value_size_ ||
+                 delta_count() != chain_length) {
+        return Status::DataLoss();
+      }
+      return OkStatus();
+    }
+
+    if (length_ == kMaxEntries || entry.value_size() < sizeof(DeltaHeader)) {
+      return Status::DataLoss();
+    }
+
+    DeltaHeader header;
+    PW_TRY(partition.Read(entry.value_address(), sizeof(header), &header));
+
+    if (length_ == 1u) {
+      value_size_ = header.value_size;
+      chain_length = header.chain_length;
+    }
+
+    // Each delta records its position in the chain, so a delta that refers to
+    // an entry from another chain is detected.
+    if (header.value_size != value_size_ ||
+        header.chain_length != chain_length - delta_count() ||
+        header.previous_address >= partition.size_bytes()) {
+      return Status::DataLoss();
+    }
+
+    Entry previous;
+    Status status =
+        Entry::Read(partition, header.previous_address, formats, &previous);
+    if (status.IsNotFound()) {
+      return Status::DataLoss();
+    }
+    PW_TRY(status);
+
+    if (previous.deleted() || previous.key_length() != key_length_ ||
+        previous.transaction_id() >= entry.transaction_id()) {
+      return Status::DataLoss();
+    }
+
+    Entry::KeyBuffer key;
+    PW_TRY(previous.ReadKey(key));
+    if (std::memcmp(key.data(), newest_key.data(), key_length_) != 0) {
+      return Status::DataLoss();
+    }
+
+    entry = previous;
+  }
+}
+
+StatusWithSize DeltaChain::ReadValue(std::span<byte> buffer,
+                                     size_t offset_bytes) const {
+  if (offset_bytes > value_size_) {
+    return StatusWithSize::OutOfRange();
+  }
+
+  const size_t remaining_bytes = value_size_ - offset_bytes;
+  const size_t read_size = std::min(buffer.size(), remaining_bytes);
+
+  PW_TRY_WITH_SIZE(ReadWindow(offset_bytes, buffer.first(read_size)));
+
+  if (read_size != remaining_bytes) {
+    return StatusWithSize::ResourceExhausted(read_size);
+  }
+  return StatusWithSize(read_size);
+}
+
+Status DeltaChain::ReadWindow(size_t offset_bytes,
+                              std::span<byte> window) const {
+  if (offset_bytes + window.size() > value_size_) {
+    return Status::OutOfRange();
+  }
+
+  // Start from the full entry's value, then apply the deltas in order.
+  PW_TRY(partition_->Read(value_address(length_ - 1u) + offset_bytes, window));
+
+  for (size_t index = length_ - 1u; index > 0u; --index) {
+    PW_TRY(ApplyDelta(index - 1u, offset_bytes, window));
+  }
+  return OkStatus();
+}
+
+Status DeltaChain::ApplyDelta(size_t index,
+                              size_t offset_bytes,
+                              std::span<byte> window) const {
+  Address address = value_address(index);
+  const Address entry_end = addresses_[index] + sizes_[index];
+  const size_t window_end = offset_bytes + window.size();
+
+  DeltaHeader header;
+  PW_TRY(partition_->Read(address, sizeof(header), &header));
+  address += sizeof(header);
+
+  for (size_t i = 0; i < header.patch_count; ++i) {
+    DeltaPatch patch;
+    PW_TRY(partition_->Read(address, sizeof(patch), &patch));
+    address += sizeof(patch);
+
+    if (size_t(patch.offset) + patch.size > value_size_ ||
+        address + patch.size > entry_end) {
+      return Status::DataLoss();
+    }
+
+    // Patches are in offset order, so none of the rest overlap the window.
+    if (patch.offset >= window_end) {
+      break;
+    }
+
+    const size_t start = std::max<size_t>(patch.offset, offset_bytes);
+    const size_t end = std::min<size_t>(patch.offset + patch.size, window_end);
+    if (start < end) {
+      PW_TRY(partition_->Read(address + (start - patch.offset),
+                              window.subspan(start - offset_bytes, end - start)));
+    }
+    address += patch.size;
+  }
+  return OkStatus();
+}
+
+Status DeltaChain::VerifyChecksumsInFlash(const EntryFormats& formats) const {
+  for (Address address : addresses()) {
+    Entry entry;
+    PW_TRY(Entry::Read(*partition_, address, formats, &entry));
+    PW_TRY(entry.VerifyChecksumInFlash());
+  }
+  return OkStatus();
+}
+
+Status DeltaChain::FindChanges(std::span<const byte> new_value,
+                               DeltaPatches& patches) const {
+  if (new_value.size() != value_size_) {
+    return Status::InvalidArgument();
+  }
+
+  std::array<byte, kWindowSizeBytes> buffer;
+  for (size_t offset = 0; offset < value_size_;) {
+    const size_t read_size = std::min(buffer.size(), value_size_ - offset);
+    PW_TRY(ReadWindow(offset, std::span(buffer).first(read_size)));
+
+    for (size_t i = 0; i < read_size; ++i) {
+      if (buffer[i] != new_value[offset + i]) {
+        patches.AddChange(offset + i);
+      }
+    }
+    offset += read_size;
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::kvs::internal
@@ -20,6 +20,7 @@
 #include <cinttypes>
 #include <cstring>
 
+#include "pw_kvs/internal/delta.h"
 #include "pw_kvs_private/config.h"
 #include "pw_log/log.h"
 #include "pw_status/try.h"
@@ -45,7 +46,10 @@ Status Entry::Read(FlashPartition& partition,
   if (partition.AppearsErased(std::as_bytes(std::span(&header.magic, 1)))) {
     return Status::NotFound();
   }
-  if (header.key_length_bytes > kMaxKeyLength) {
+  const uint8_t batch_flags = header.key_length_bytes & ~kKeyLengthMask;
+  if (batch_flags != uint8_t(BatchState::kNone) &&
+      batch_flags != uint8_t(BatchState::kMember) &&
+      batch_flags != uint8_t(BatchState::kCommit)) {
     return Status::DataLoss();
   }
 
@@ -76,41 +80,87 @@ Status Entry::ReadKey(FlashPartition& partition,
 Entry::Entry(FlashPartition& partition,
              Address address,
              const EntryFormat& format,
+             const uint32_t magic,
              Key key,
-             std::span<const byte> value,
+             std::span<const std::span<const byte>> value_chunks,
              uint16_t value_size_bytes,
-             uint32_t transaction_id)
+             uint32_t transaction_id,
+             BatchState batch_state)
     : Entry(&partition,
             address,
             format,
-            {.magic = format.magic,
+            {.magic = magic,
              .checksum = 0,
              .alignment_units =
                  alignment_bytes_to_units(partition.alignment_bytes()),
-             .key_length_bytes = static_cast<uint8_t>(key.size()),
+             .key_length_bytes =
+                 static_cast<uint8_t>(key.size() | uint8_t(batch_state)),
              .value_size_bytes = value_size_bytes,
              .transaction_id = transaction_id}) {
   if (checksum_algo_ != nullptr) {
-    std::span<const byte> checksum = CalculateChecksum(key, value);
+    std::span<const byte> checksum = CalculateChecksum(key, value_chunks);
     std::memcpy(&header_.checksum,
                 checksum.data(),
                 std::min(checksum.size(), sizeof(header_.checksum)));
   }
 }
 
-StatusWithSize Entry::Write(Key key, std::span<const byte> value) const {
+Status Entry::Compacted(FlashPartition& partition,
+                        Address address,
+                        const EntryFormat& format,
+                        Key key,
+                        const DeltaChain& chain,
+                        uint32_t transaction_id,
+                        Entry* entry) {
+  *entry = Entry(&partition,
+                 address,
+                 format,
+                 {.magic = format.magic,
+                  .checksum = 0,
+                  .alignment_units =
+                      alignment_bytes_to_units(partition.alignment_bytes()),
+                  .key_length_bytes = static_cast<uint8_t>(key.size()),
+                  .value_size_bytes = static_cast<uint16_t>(chain.value_size()),
+                  .transaction_id = transaction_id});
+  return entry->CalculateChecksumFromChain(key, chain);
+}
+
+StatusWithSize Entry::WriteChunks(
+    Key key, std::span<const std::span<const byte>> value_chunks) const {
+  FlashPartition::Output flash(partition(), address_);
+  AlignedWriterBuffer<kWriteBufferSize> writer(alignment_bytes(), flash);
+
+  PW_TRY_WITH_SIZE(writer.Write(&header_, sizeof(header_)));
+  PW_TRY_WITH_SIZE(writer.Write(std::as_bytes(std::span(key))));
+  for (const std::span<const byte>& chunk : value_chunks) {
+    PW_TRY_WITH_SIZE(writer.Write(chunk));
+  }
+  return writer.Flush();
+}
+
+StatusWithSize Entry::WriteCompacted(Key key, const DeltaChain& chain) const {
   FlashPartition::Output flash(partition(), address_);
-  return AlignedWrite<kWriteBufferSize>(flash,
-                                        alignment_bytes(),
-                                        {std::as_bytes(std::span(&header_, 1)),
-                                         std::as_bytes(std::span(key)),
-                                         value});
+  AlignedWriterBuffer<kWriteBufferSize> writer(alignment_bytes(), flash);
+
+  PW_TRY_WITH_SIZE(writer.Write(&header_, sizeof(header_)));
+  PW_TRY_WITH_SIZE(writer.Write(std::as_bytes(std::span(key))));
+
+  std::array<byte, DeltaChain::kWindowSizeBytes> buffer;
+  for (size_t offset = 0; offset < value_size();) {
+    const std::span window =
+        std::span(buffer).first(std::min(buffer.size(), value_size() - offset));
+    PW_TRY_WITH_SIZE(chain.ReadWindow(offset, window));
+    PW_TRY_WITH_SIZE(writer.Write(window));
+    offset += window.size();
+  }
+  return writer.Flush();
 }
 
 Status Entry::Update(const EntryFormat& new_format,
                      uint32_t new_transaction_id) {
   checksum_algo_ = new_format.checksum;
   header_.magic = new_format.magic;
+  delta_ = false;
   header_.alignment_units =
       alignment_bytes_to_units(partition_->alignment_bytes());
   header_.transaction_id = new_transaction_id;
@@ -122,6 +172,15 @@ Status Entry::Update(const EntryFormat& new_format,
   return CalculateChecksumFromFlash();
 }
 
+Status Entry::ClearBatchState() {
+  if (batch_state() == BatchState::kNone) {
+    return OkStatus();
+  }
+
+  header_.key_length_bytes &= kKeyLengthMask;
+  return CalculateChecksumFromFlash();
+}
+
 StatusWithSize Entry::Copy(Address new_address) const {
   PW_LOG_DEBUG("Copying entry from %u to %u as ID %" PRIu32,
                unsigned(address()),
@@ -190,16 +249,17 @@ Status Entry::VerifyChecksum(Key key, std::span<const byte> value) const {
   if (checksum_algo_ == nullptr) {
     return header_.checksum == 0 ? OkStatus() : Status::DataLoss();
   }
-  CalculateChecksum(key, value);
+  CalculateChecksum(key, std::span(&value, 1));
   return checksum_algo_->Verify(checksum_bytes());
 }
 
 Status Entry::VerifyChecksumInFlash() const {
-  // Read the entire entry piece-by-piece into a small buffer. If the entry is
-  // 32 B or less, only one read is required.
+  // Read the entire entry piece-by-piece into a buffer, and add each piece to
+  // the checksum at once. If the entry fits in the buffer, only one read is
+  // required.
   union {
     EntryHeader header_to_verify;
-    byte buffer[sizeof(EntryHeader) * 2];
+    byte buffer[kReadBufferSizeBytes];
   };
 
   size_t bytes_to_read = size();
@@ -258,7 +318,7 @@ void Entry::DebugLog() const {
 }
 
 std::span<const byte> Entry::CalculateChecksum(
-    const Key key, std::span<const byte> value) const {
+    const Key key, std::span<const std::span<const byte>> value_chunks) const {
   checksum_algo_->Reset();
 
   {
@@ -267,7 +327,9 @@ std::span<const byte> Entry::CalculateChecksum(
 
     checksum_algo_->Update(&header_for_checksum, sizeof(header_for_checksum));
     checksum_algo_->Update(std::as_bytes(std::span(key)));
-    checksum_algo_->Update(value);
+    for (const std::span<const byte>& chunk : value_chunks) {
+      checksum_algo_->Update(chunk);
+    }
   }
 
   AddPaddingBytesToChecksum();
@@ -308,6 +370,35 @@ Status Entry::CalculateChecksumFromFlash() {
   return OkStatus();
 }
 
+Status Entry::CalculateChecksumFromChain(Key key, const DeltaChain& chain) {
+  header_.checksum = 0;
+
+  if (checksum_algo_ == nullptr) {
+    return OkStatus();
+  }
+
+  checksum_algo_->Reset();
+  checksum_algo_->Update(&header_, sizeof(header_));
+  checksum_algo_->Update(std::as_bytes(std::span(key)));
+
+  std::array<byte, DeltaChain::kWindowSizeBytes> buffer;
+  for (size_t offset = 0; offset < value_size();) {
+    const std::span window =
+        std::span(buffer).first(std::min(buffer.size(), value_size() - offset));
+    PW_TRY(chain.ReadWindow(offset, window));
+    checksum_algo_->Update(window);
+    offset += window.size();
+  }
+
+  AddPaddingBytesToChecksum();
+
+  std::span checksum = checksum_algo_->Finish();
+  std::memcpy(&header_.checksum,
+              checksum.data(),
+              std::min(checksum.size(), sizeof(header_.checksum)));
+  return OkStatus();
+}
+
 void Entry::AddPaddingBytesToChecksum() const {
   constexpr byte padding[kMinAlignmentBytes - 1] = {};
   size_t padding_to_add = Padding(content_size(), alignment_bytes());
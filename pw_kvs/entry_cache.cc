@@ -17,6 +17,7 @@
 
 #include "pw_kvs/internal/entry_cache.h"
 
+#include <algorithm>
 #include <cinttypes>
 
 #include "pw_kvs/flash_memory.h"
@@ -68,70 +69,86 @@ StatusWithSize EntryCache::Find(FlashPartition& partition,
   Entry::KeyBuffer key_buffer;
   bool error_detected = false;
 
-  for (size_t i = 0; i < descriptors_.size(); ++i) {
-    if (descriptors_[i].key_hash == hash) {
-      bool key_found = false;
-      Key read_key;
-
-      for (Address address : addresses(i)) {
-        Status read_result =
-            Entry::ReadKey(partition, address, key.size(), key_buffer.data());
-
-        read_key = Key(key_buffer.data(), key.size());
-
-        if (read_result.ok() && hash == internal::Hash(read_key)) {
-          key_found = true;
-          break;
-        } else {
-          // A hash mismatch can be caused by reading invalid data or a key hash
-          // collision of keys with differing size. To verify the data read from
-          // flash is good, validate the entry.
-          Entry entry;
-          read_result = Entry::Read(partition, address, formats, &entry);
-          if (read_result.ok() && entry.VerifyChecksumInFlash().ok()) {
-            key_found = true;
-            break;
-          }
-
-          PW_LOG_WARN(
-              "   Found corrupt entry, invalidating this copy of the key");
-          error_detected = true;
-          sectors.FromAddress(address).mark_corrupt();
-        }
-      }
-      size_t error_val = error_detected ? 1 : 0;
-
-      if (!key_found) {
-        PW_LOG_ERROR("No valid entries for key. Data has been lost!");
-        return StatusWithSize::DataLoss(error_val);
-      } else if (key == read_key) {
-        PW_LOG_DEBUG("Found match for key hash 0x%08" PRIx32, hash);
-        *metadata = EntryMetadata(descriptors_[i], addresses(i));
-        return StatusWithSize(error_val);
-      } else {
-        PW_LOG_WARN("Found key hash collision for 0x%08" PRIx32, hash);
-        return StatusWithSize::AlreadyExists(error_val);
+  const int index = FindIndex(hash);
+  if (index == -1) {
+    return StatusWithSize::NotFound();
+  }
+
+  const size_t i = index;
+  bool key_found = false;
+  Key read_key;
+
+  for (Address address : addresses(i)) {
+    Status read_result =
+        Entry::ReadKey(partition, address, key.size(), key_buffer.data());
+
+    read_key = Key(key_buffer.data(), key.size());
+
+    if (read_result.ok() && hash == internal::Hash(read_key)) {
+      key_found = true;
+      break;
+    } else {
+      // A hash mismatch can be caused by reading invalid data or a key hash
+      // collision of keys with differing size. To verify the data read from
+      // flash is good, validate the entry.
+      Entry entry;
+      read_result = Entry::Read(partition, address, formats, &entry);
+      if (read_result.ok() && entry.VerifyChecksumInFlash().ok()) {
+        key_found = true;
+        break;
       }
+
+      PW_LOG_WARN("   Found corrupt entry, invalidating this copy of the key");
+      error_detected = true;
+      sectors.FromAddress(address).mark_corrupt();
     }
   }
-  return StatusWithSize::NotFound();
+  size_t error_val = error_detected ? 1 : 0;
+
+  if (!key_found) {
+    PW_LOG_ERROR("No valid entries for key. Data has been lost!");
+    return StatusWithSize::DataLoss(error_val);
+  } else if (key == read_key) {
+    PW_LOG_DEBUG("Found match for key hash 0x%08" PRIx32, hash);
+    *metadata = EntryMetadata(descriptors_[i], addresses(i));
+    return StatusWithSize(error_val);
+  } else {
+    PW_LOG_WARN("Found key hash collision for 0x%08" PRIx32, hash);
+    return StatusWithSize::AlreadyExists(error_val);
+  }
+}
+
+void EntryCache::Reset() const {
+  descriptors_.clear();
+  std::fill(hash_index_.begin(), hash_index_.end(), kEmptySlot);
+  if (value_cache_ != nullptr) {
+    value_cache_->Clear();
+  }
+  if (key_prefix_index_ != nullptr) {
+    key_prefix_index_->Clear();
+  }
 }
 
 EntryMetadata EntryCache::AddNew(const KeyDescriptor& descriptor,
-                                 Address entry_address) const {
+                                 Address entry_address,
+                                 Key key) const {
   // TODO(hepler): DCHECK(!full());
   Address* first_address = ResetAddresses(descriptors_.size(), entry_address);
   descriptors_.push_back(descriptor);
-  return EntryMetadata(descriptors_.back(), std::span(first_address, 1));
+  AddToHashIndex(descriptors_.size() - 1);
+  EntryMetadata metadata(descriptors_.back(), std::span(first_address, 1));
+  if (!key.empty()) {
+    SetKeyPrefix(metadata, key);
+  }
+  return metadata;
 }
 
-// TODO: This method is the trigger of the O(valid_entries * all_entries) time
-// complexity for reading. At some cost to memory, this could be optimized by
-// using a hash table instead of scanning, but in practice this should be fine
-// for a small number of keys
+// Without a hash index, this method is the trigger of the
+// O(valid_entries * all_entries) time complexity for reading.
 Status EntryCache::AddNewOrUpdateExisting(const KeyDescriptor& descriptor,
                                           Address address,
-                                          size_t sector_size_bytes) const {
+                                          size_t sector_size_bytes,
+                                          Key key) const {
   // With the new key descriptor, either add it to the descriptor table or
   // overwrite an existing entry with an older version of the key.
   const int index = FindIndex(descriptor.key_hash);
@@ -141,7 +158,7 @@ Status EntryCache::AddNewOrUpdateExisting(const KeyDescriptor& descriptor,
     if (full()) {
       return Status::ResourceExhausted();
     }
-    AddNew(descriptor, address);
+    AddNew(descriptor, address, key);
     return OkStatus();
   }
 
@@ -193,7 +210,22 @@ size_t EntryCache::present_entries() const {
 }
 
 int EntryCache::FindIndex(uint32_t key_hash) const {
-  for (size_t i = 0; i < descriptors_.size(); ++i) {
+  if (hash_index_.empty()) {
+    for (size_t i = 0; i < descriptors_.size(); ++i) {
+      if (descriptors_[i].key_hash == key_hash) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  // The index is never more than half full, so probing always reaches an
+  // empty slot.
+  const size_t mask = hash_index_.size() - 1;
+  for (size_t slot = HashIndexStart(key_hash);
+       hash_index_[slot] != kEmptySlot;
+       slot = (slot + 1) & mask) {
+    const size_t i = hash_index_[slot] - 1;
     if (descriptors_[i].key_hash == key_hash) {
       return i;
     }
@@ -201,6 +233,19 @@ int EntryCache::FindIndex(uint32_t key_hash) const {
   return -1;
 }
 
+void EntryCache::AddToHashIndex(size_t descriptor_index) const {
+  if (hash_index_.empty()) {
+    return;
+  }
+
+  const size_t mask = hash_index_.size() - 1;
+  size_t slot = HashIndexStart(descriptors_[descriptor_index].key_hash);
+  while (hash_index_[slot] != kEmptySlot) {
+    slot = (slot + 1) & mask;
+  }
+  hash_index_[slot] = static_cast<HashIndexSlot>(descriptor_index + 1);
+}
+
 void EntryCache::AddAddressIfRoom(size_t descriptor_index,
                                   Address address) const {
   Address* const existing = first_address(descriptor_index);
@@ -31,10 +31,13 @@ class EmptyEntryCache : public ::testing::Test {
   static constexpr size_t kMaxEntries = 32;
   static constexpr size_t kRedundancy = 3;
 
-  EmptyEntryCache() : entries_(descriptors_, addresses_, kRedundancy) {}
+  EmptyEntryCache()
+      : hash_index_{},
+        entries_(descriptors_, addresses_, kRedundancy, hash_index_) {}
 
   Vector<KeyDescriptor, kMaxEntries> descriptors_;
   EntryCache::AddressList<kMaxEntries, kRedundancy> addresses_;
+  EntryCache::HashIndex<kMaxEntries> hash_index_;
 
   EntryCache entries_;
 };
@@ -109,6 +112,55 @@ TEST_F(EmptyEntryCache, AddNewOrUpdateExisting_NewEntry_Full) {
   EXPECT_EQ(kMaxEntries, entries_.total_entries());
 }
 
+TEST_F(EmptyEntryCache, AddNewOrUpdateExisting_FullWithIndexCollisions) {
+  // Every hash maps to the same starting slot in the hash index.
+  constexpr uint32_t kStride = EntryCache::HashIndexSize(kMaxEntries) << 16;
+
+  for (uint32_t i = 0; i < kMaxEntries; ++i) {
+    ASSERT_EQ(OkStatus(),
+              entries_.AddNewOrUpdateExisting(
+                  {i * kStride, 1, EntryState::kValid}, i, 1));
+  }
+  ASSERT_TRUE(entries_.full());
+
+  // Updating each entry finds the existing descriptor rather than adding one.
+  for (uint32_t i = 0; i < kMaxEntries; ++i) {
+    ASSERT_EQ(OkStatus(),
+              entries_.AddNewOrUpdateExisting(
+                  {i * kStride, 2, EntryState::kValid}, 100 + i, 1));
+  }
+  EXPECT_EQ(kMaxEntries, entries_.total_entries());
+
+  uint32_t expected_address = 100;
+  for (const EntryMetadata& entry : entries_) {
+    EXPECT_EQ(2u, entry.transaction_id());
+    EXPECT_EQ(expected_address++, entry.first_address());
+  }
+}
+
+TEST(EntryCache, AddNewOrUpdateExisting_WithoutHashIndex) {
+  Vector<KeyDescriptor, 4> descriptors;
+  EntryCache::AddressList<4, 1> addresses;
+  EntryCache entries(descriptors, addresses, 1);
+
+  ASSERT_EQ(OkStatus(),
+            entries.AddNewOrUpdateExisting(kDescriptor, 1000, 2000));
+  KeyDescriptor updated = kDescriptor;
+  updated.transaction_id += 1;
+  ASSERT_EQ(OkStatus(), entries.AddNewOrUpdateExisting(updated, 3000, 2000));
+
+  EXPECT_EQ(1u, entries.total_entries());
+  EXPECT_EQ(3000u, entries.begin()->first_address());
+}
+
+TEST(EntryCache, HashIndexSize) {
+  static_assert(EntryCache::HashIndexSize(1) == 2u);
+  static_assert(EntryCache::HashIndexSize(2) == 4u);
+  static_assert(EntryCache::HashIndexSize(3) == 8u);
+  static_assert(EntryCache::HashIndexSize(256) == 512u);
+  static_assert(EntryCache::HashIndexSize(257) == 1024u);
+}
+
 TEST_F(EmptyEntryCache, AddNewOrUpdateExisting_UpdatedEntry) {
   KeyDescriptor kd = kDescriptor;
   kd.transaction_id += 3;
@@ -314,6 +366,15 @@ TEST_F(InitializedEntryCache, Reset_ClearsEntryCounts) {
   EXPECT_EQ(kMaxEntries, entries_.max_entries());
 }
 
+TEST_F(InitializedEntryCache, Reset_ClearsHashIndex) {
+  entries_.Reset();
+
+  EntryMetadata metadata;
+  EXPECT_EQ(Status::NotFound(),
+            entries_.Find(partition_, sectors_, format_, kTheKey, &metadata)
+                .status());
+}
+
 TEST_F(InitializedEntryCache, Find_PresentEntry) {
   EntryMetadata metadata;
 
@@ -79,6 +79,31 @@ Status FakeFlashMemory::Erase(Address address, size_t num_sectors) {
   return OkStatus();
 }
 
+Status FakeFlashMemory::StartErase(Address address, size_t num_sectors) {
+  if (erase_in_progress()) {
+    return Status::Unavailable();
+  }
+  if (erase_poll_count_ == 0u) {
+    return Erase(address, num_sectors);
+  }
+
+  pending_erase_address_ = address;
+  pending_erase_sectors_ = num_sectors;
+  erase_polls_remaining_ = erase_poll_count_;
+  return OkStatus();
+}
+
+Status FakeFlashMemory::PollErase() {
+  if (!erase_in_progress()) {
+    return OkStatus();
+  }
+  erase_polls_remaining_ -= 1;
+  if (erase_in_progress()) {
+    return Status::Unavailable();
+  }
+  return Erase(pending_erase_address_, pending_erase_sectors_);
+}
+
 StatusWithSize FakeFlashMemory::Read(Address address,
                                      std::span<std::byte> output) {
   if (address + output.size() >= sector_count() * size_bytes()) {
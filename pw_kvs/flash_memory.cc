@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <cinttypes>
+#include <cstdint>
 #include <cstring>
 
 #include "pw_assert/assert.h"
@@ -57,7 +58,9 @@ FlashPartition::FlashPartition(
           alignment_bytes == 0
               ? flash_.alignment_bytes()
               : std::max(alignment_bytes, uint32_t(flash_.alignment_bytes()))),
-      permission_(permission) {
+      permission_(permission),
+      bytes_read_(0),
+      bytes_written_(0) {
   uint32_t misalignment = (alignment_bytes_ % flash_.alignment_bytes());
   PW_DCHECK_UINT_EQ(misalignment,
                     0,
@@ -66,20 +69,21 @@ FlashPartition::FlashPartition(
 }
 
 Status FlashPartition::Erase(Address address, size_t num_sectors) {
-  if (permission_ == PartitionPermission::kReadOnly) {
-    return Status::PermissionDenied();
-  }
-
-  PW_TRY(CheckBounds(address, num_sectors * sector_size_bytes()));
-  const size_t address_sector_offset = address % sector_size_bytes();
-  PW_CHECK_UINT_EQ(address_sector_offset, 0u);
-
+  PW_TRY(CheckErase(address, num_sectors));
   return flash_.Erase(PartitionToFlashAddress(address), num_sectors);
 }
 
+Status FlashPartition::StartErase(Address address, size_t num_sectors) {
+  PW_TRY(CheckErase(address, num_sectors));
+  return flash_.StartErase(PartitionToFlashAddress(address), num_sectors);
+}
+
 StatusWithSize FlashPartition::Read(Address address, std::span<byte> output) {
   PW_TRY_WITH_SIZE(CheckBounds(address, output.size()));
-  return flash_.Read(PartitionToFlashAddress(address), output);
+  const StatusWithSize result =
+      flash_.Read(PartitionToFlashAddress(address), output);
+  bytes_read_ += result.size();
+  return result;
 }
 
 StatusWithSize FlashPartition::Write(Address address,
@@ -92,7 +96,10 @@ StatusWithSize FlashPartition::Write(Address address,
   PW_CHECK_UINT_EQ(address_alignment_offset, 0u);
   const size_t size_alignment_offset = data.size() % alignment_bytes();
   PW_CHECK_UINT_EQ(size_alignment_offset, 0u);
-  return flash_.Write(PartitionToFlashAddress(address), data);
+  const StatusWithSize result =
+      flash_.Write(PartitionToFlashAddress(address), data);
+  bytes_written_ += result.size();
+  return result;
 }
 
 Status FlashPartition::IsRegionErased(Address source_flash_address,
@@ -114,7 +121,6 @@ Status FlashPartition::IsRegionErased(Address source_flash_address,
   }
 
   byte buffer[kMaxFlashAlignment];
-  const byte erased_byte = flash_.erased_memory_content();
   size_t offset = 0;
   *is_erased = false;
   while (length > 0u) {
@@ -122,11 +128,9 @@ Status FlashPartition::IsRegionErased(Address source_flash_address,
     size_t read_size = std::min(sizeof(buffer), length);
     PW_TRY(Read(source_flash_address + offset, read_size, buffer).status());
 
-    for (byte b : std::span(buffer, read_size)) {
-      if (b != erased_byte) {
-        // Detected memory chunk is not entirely erased
-        return OkStatus();
-      }
+    if (!AppearsErased(std::span(buffer, read_size))) {
+      // Detected memory chunk is not entirely erased
+      return OkStatus();
     }
 
     offset += read_size;
@@ -137,15 +141,41 @@ Status FlashPartition::IsRegionErased(Address source_flash_address,
 }
 
 bool FlashPartition::AppearsErased(std::span<const byte> data) const {
-  byte erased_content = flash_.erased_memory_content();
-  for (byte b : data) {
-    if (b != erased_content) {
+  const byte erased_content = flash_.erased_memory_content();
+
+  // Compare a word at a time, since erased regions are often large. The words
+  // are copied out of the data, which may not be aligned.
+  uintptr_t erased_word;
+  std::memset(&erased_word, int(erased_content), sizeof(erased_word));
+
+  size_t i = 0;
+  for (; i + sizeof(erased_word) <= data.size(); i += sizeof(erased_word)) {
+    uintptr_t word;
+    std::memcpy(&word, &data[i], sizeof(word));
+    if (word != erased_word) {
+      return false;
+    }
+  }
+
+  for (; i < data.size(); ++i) {
+    if (data[i] != erased_content) {
       return false;
     }
   }
   return true;
 }
 
+Status FlashPartition::CheckErase(Address address, size_t num_sectors) const {
+  if (permission_ == PartitionPermission::kReadOnly) {
+    return Status::PermissionDenied();
+  }
+
+  PW_TRY(CheckBounds(address, num_sectors * sector_size_bytes()));
+  const size_t address_sector_offset = address % sector_size_bytes();
+  PW_CHECK_UINT_EQ(address_sector_offset, 0u);
+  return OkStatus();
+}
+
 Status FlashPartition::CheckBounds(Address address, size_t length) const {
   if (address + length > size_bytes()) {
     PW_LOG_ERROR(
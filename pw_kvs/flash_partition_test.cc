@@ -12,6 +12,7 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <algorithm>
 #include <span>
 
 #include "gtest/gtest.h"
@@ -180,6 +181,80 @@ TEST(FlashPartitionTest, EraseTest) {
   }
 }
 
+TEST(FlashPartitionTest, StartErase) {
+  FlashPartition& test_partition = FlashTestPartition();
+  WriteData(test_partition, 0x55);
+
+  ASSERT_EQ(OkStatus(), test_partition.StartErase(0, 1));
+
+  Status status;
+  do {
+    status = test_partition.PollErase();
+  } while (status.IsUnavailable());
+  ASSERT_EQ(OkStatus(), status);
+
+  bool is_erased = false;
+  ASSERT_EQ(OkStatus(),
+            test_partition.IsRegionErased(
+                0, test_partition.sector_size_bytes(), &is_erased));
+  EXPECT_TRUE(is_erased);
+
+  // Only the requested sector is erased.
+  if (test_partition.sector_count() > 1u) {
+    ASSERT_EQ(OkStatus(),
+              test_partition.IsRegionErased(test_partition.sector_size_bytes(),
+                                            test_partition.sector_size_bytes(),
+                                            &is_erased));
+    EXPECT_FALSE(is_erased);
+  }
+}
+
+TEST(FlashPartitionTest, AppearsErased_ChecksEveryByte) {
+  FlashPartition& test_partition = FlashTestPartition();
+  const std::byte erased = test_partition.erased_memory_content();
+
+  std::byte data[67];
+  std::fill(std::begin(data), std::end(data), erased);
+  EXPECT_TRUE(test_partition.AppearsErased(data));
+  EXPECT_TRUE(test_partition.AppearsErased(std::span(data).subspan(3)));
+  EXPECT_TRUE(test_partition.AppearsErased(std::span<std::byte>()));
+
+  // A single written byte must be detected at any position, including in the
+  // bytes before or after the whole words.
+  for (size_t i = 0; i < sizeof(data); ++i) {
+    data[i] = ~erased;
+    EXPECT_FALSE(test_partition.AppearsErased(data));
+    EXPECT_FALSE(test_partition.AppearsErased(std::span(data).subspan(i)));
+    data[i] = erased;
+  }
+}
+
+TEST(FlashPartitionTest, CountsBytesReadAndWritten) {
+  FlashPartition& test_partition = FlashTestPartition();
+  ASSERT_EQ(OkStatus(), test_partition.Erase(0, 1));
+
+  const size_t alignment = test_partition.alignment_bytes();
+  const size_t bytes_read = test_partition.bytes_read();
+  const size_t bytes_written = test_partition.bytes_written();
+
+  std::byte data[kMaxFlashAlignment] = {};
+  ASSERT_EQ(alignment,
+            test_partition.Write(0, std::span(data, alignment)).size());
+  EXPECT_EQ(bytes_written + alignment, test_partition.bytes_written());
+  EXPECT_EQ(bytes_read, test_partition.bytes_read());
+
+  ASSERT_EQ(alignment,
+            test_partition.Read(0, std::span(data, alignment)).size());
+  EXPECT_EQ(bytes_read + alignment, test_partition.bytes_read());
+
+  // Failed writes are not counted.
+  EXPECT_NE(OkStatus(),
+            test_partition.Write(test_partition.size_bytes(),
+                                 std::span(data, alignment))
+                .status());
+  EXPECT_EQ(bytes_written + alignment, test_partition.bytes_written());
+}
+
 TEST(FlashPartitionTest, AlignmentCheck) {
   FlashPartition& test_partition = FlashTestPartition();
   const size_t alignment = test_partition.alignment_bytes();
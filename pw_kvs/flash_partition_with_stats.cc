@@ -71,6 +71,18 @@ Status FlashPartitionWithStats::SaveStorageStats(const KeyValueStore& kvs,
 }
 
 Status FlashPartitionWithStats::Erase(Address address, size_t num_sectors) {
+  RecordErase(address, num_sectors);
+  return FlashPartition::Erase(address, num_sectors);
+}
+
+Status FlashPartitionWithStats::StartErase(Address address,
+                                           size_t num_sectors) {
+  RecordErase(address, num_sectors);
+  return FlashPartition::StartErase(address, num_sectors);
+}
+
+void FlashPartitionWithStats::RecordErase(Address address,
+                                          size_t num_sectors) {
   size_t base_index = address / FlashPartition::sector_size_bytes();
   if (base_index < sector_counters_.size()) {
     num_sectors = std::min(num_sectors, (sector_counters_.size() - base_index));
@@ -78,8 +90,6 @@ Status FlashPartitionWithStats::Erase(Address address, size_t num_sectors) {
       sector_counters_[base_index + i]++;
     }
   }
-
-  return FlashPartition::Erase(address, num_sectors);
 }
 
 }  // namespace pw::kvs
@@ -18,7 +18,8 @@ namespace pw::kvs::internal {
 
 const EntryFormat* EntryFormats::Find(const uint32_t magic) const {
   for (const EntryFormat& format : formats_) {
-    if (format.magic == magic) {
+    if (format.magic == magic ||
+        (format.delta_magic != 0u && format.delta_magic == magic)) {
       return &format;
     }
   }
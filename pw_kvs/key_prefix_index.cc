@@ -0,0 +1,62 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/key_prefix_index.h"
+
+#include <algorithm>
+
+#include "pw_kvs/internal/hash.h"
+
+namespace pw::kvs {
+
+void KeyPrefixIndex::Clear() {
+  std::fill(tags_.begin(), tags_.end(), kUnknown);
+}
+
+bool KeyPrefixIndex::MayMatch(size_t descriptor_index, Key prefix) {
+  if (!known(descriptor_index)) {
+    return true;
+  }
+
+  const size_t namespace_length = NamespaceLength(prefix);
+  if (namespace_length == 0u) {
+    return true;
+  }
+
+  if (tags_[descriptor_index] ==
+      Tag(Key(prefix.data(), namespace_length))) {
+    return true;
+  }
+
+  skipped_keys_ += 1;
+  return false;
+}
+
+size_t KeyPrefixIndex::NamespaceLength(Key key) {
+  for (size_t i = 0; i < key.size(); ++i) {
+    if (key[i] == '/') {
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+uint32_t KeyPrefixIndex::Tag(Key key) {
+  const size_t namespace_length = NamespaceLength(key);
+  const uint32_t hash = internal::Hash(
+      namespace_length == 0u ? key : Key(key.data(), namespace_length));
+  return hash == kUnknown ? 1 : hash;
+}
+
+}  // namespace pw::kvs
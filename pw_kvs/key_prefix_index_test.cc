@@ -0,0 +1,86 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/key_prefix_index.h"
+
+#include "gtest/gtest.h"
+
+namespace pw::kvs {
+namespace {
+
+class KeyPrefixIndexTest : public ::testing::Test {
+ protected:
+  static constexpr size_t kMaxEntries = 4;
+
+  KeyPrefixIndexBuffer<kMaxEntries> index_;
+};
+
+TEST_F(KeyPrefixIndexTest, Empty_EverythingMayMatch) {
+  EXPECT_EQ(kMaxEntries, index_.max_entries());
+  for (size_t i = 0; i < kMaxEntries; ++i) {
+    EXPECT_FALSE(index_.known(i));
+    EXPECT_TRUE(index_.MayMatch(i, "net/"));
+  }
+  EXPECT_EQ(0u, index_.skipped_keys());
+}
+
+TEST_F(KeyPrefixIndexTest, MatchesNamespace) {
+  index_.Set(0, "net/ip");
+  index_.Set(1, "cfg/mode");
+  ASSERT_TRUE(index_.known(0));
+  ASSERT_TRUE(index_.known(1));
+
+  EXPECT_TRUE(index_.MayMatch(0, "net/"));
+  EXPECT_TRUE(index_.MayMatch(0, "net/mask"));
+  EXPECT_FALSE(index_.MayMatch(1, "net/"));
+  EXPECT_FALSE(index_.MayMatch(1, "net/ip"));
+  EXPECT_TRUE(index_.MayMatch(1, "cfg/"));
+  EXPECT_EQ(2u, index_.skipped_keys());
+
+  index_.ResetCounters();
+  EXPECT_EQ(0u, index_.skipped_keys());
+}
+
+TEST_F(KeyPrefixIndexTest, KeyWithoutNamespace) {
+  index_.Set(0, "net");
+  EXPECT_FALSE(index_.MayMatch(0, "net/"));
+  EXPECT_TRUE(index_.MayMatch(0, "ne"));
+  EXPECT_TRUE(index_.MayMatch(0, "x"));
+  EXPECT_EQ(1u, index_.skipped_keys());
+}
+
+TEST_F(KeyPrefixIndexTest, PrefixWithoutSlash_MayMatchAnyNamespace) {
+  index_.Set(0, "net/ip");
+  index_.Set(1, "cfg/mode");
+  EXPECT_TRUE(index_.MayMatch(0, ""));
+  EXPECT_TRUE(index_.MayMatch(0, "ne"));
+  EXPECT_TRUE(index_.MayMatch(1, "ne"));
+  EXPECT_EQ(0u, index_.skipped_keys());
+}
+
+TEST_F(KeyPrefixIndexTest, Clear) {
+  index_.Set(0, "net/ip");
+  index_.Clear();
+  EXPECT_FALSE(index_.known(0));
+  EXPECT_TRUE(index_.MayMatch(0, "cfg/"));
+}
+
+TEST_F(KeyPrefixIndexTest, OutOfRange_NotRecorded) {
+  index_.Set(kMaxEntries, "net/ip");
+  EXPECT_FALSE(index_.known(kMaxEntries));
+  EXPECT_TRUE(index_.MayMatch(kMaxEntries, "cfg/"));
+}
+
+}  // namespace
+}  // namespace pw::kvs
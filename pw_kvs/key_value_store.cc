@@ -19,6 +19,7 @@
 #include "pw_kvs/key_value_store.h"
 
 #include <algorithm>
+#include <array>
 #include <cinttypes>
 #include <cstring>
 #include <type_traits>
@@ -37,6 +38,19 @@ constexpr bool InvalidKey(Key key) {
   return key.empty() || (key.size() > internal::Entry::kMaxKeyLength);
 }
 
+// The value of a checkpoint entry starts with this header. It is followed by
+// the SectorDescriptors for all sectors, the KeyDescriptors, and finally the
+// address lists for the KeyDescriptors (redundancy addresses each).
+struct CheckpointHeader {
+  uint32_t sector_count;
+  uint32_t sector_size_bytes;
+  uint32_t redundancy;
+  uint32_t entry_count;
+};
+
+static_assert(std::is_trivially_copyable_v<internal::SectorDescriptor>);
+static_assert(std::is_trivially_copyable_v<internal::KeyDescriptor>);
+
 }  // namespace
 
 KeyValueStore::KeyValueStore(FlashPartition* partition,
@@ -46,21 +60,47 @@ KeyValueStore::KeyValueStore(FlashPartition* partition,
                              Vector<SectorDescriptor>& sector_descriptor_list,
                              const SectorDescriptor** temp_sectors_to_skip,
                              Vector<KeyDescriptor>& key_descriptor_list,
-                             Address* addresses)
+                             Address* addresses,
+                             std::span<internal::EntryCache::HashIndexSlot>
+                                 hash_index)
     : partition_(*partition),
       formats_(formats),
-      sectors_(sector_descriptor_list, *partition, temp_sectors_to_skip),
-      entry_cache_(key_descriptor_list, addresses, redundancy),
+      sectors_(sector_descriptor_list,
+               *partition,
+               temp_sectors_to_skip,
+               options.wear_leveling_policy),
+      entry_cache_(key_descriptor_list,
+                   addresses,
+                   redundancy,
+                   hash_index,
+                   options.value_cache,
+                   options.key_prefix_index),
       options_(options),
       initialized_(InitializationState::kNotInitialized),
       error_detected_(false),
       internal_stats_({}),
-      last_transaction_id_(0) {}
+      io_stats_({}),
+      io_cause_(IoCause::kNone),
+      io_bytes_read_mark_(0),
+      io_bytes_written_mark_(0),
+      last_transaction_id_(0),
+      step_gc_sector_(nullptr),
+      step_gc_next_entry_(0),
+      checkpoint_sector_(nullptr),
+      erasing_sector_(nullptr) {}
 
 Status KeyValueStore::Init() {
+  IoScope io_scope(*this, IoCause::kInit);
+
+  // The sectors are read again, so a background erase must finish first. If it
+  // failed, the sector is found to be corrupt.
+  FinishBackgroundErase();
+
   initialized_ = InitializationState::kNotInitialized;
   error_detected_ = false;
   last_transaction_id_ = 0;
+  step_gc_sector_ = nullptr;
+  step_gc_next_entry_ = 0;
 
   INF("Initializing key value store");
   if (partition_.sector_count() > sectors_.max_size()) {
@@ -89,7 +129,15 @@ Status KeyValueStore::Init() {
     return Status::FailedPrecondition();
   }
 
-  Status metadata_result = InitializeMetadata();
+  Status metadata_result = LoadCheckpoint();
+  if (metadata_result.ok()) {
+    INF("KVS init: Loaded metadata from checkpoint");
+  } else {
+    if (!metadata_result.IsNotFound()) {
+      INF("KVS init: Checkpoint cannot be used; reading all entries");
+    }
+    metadata_result = InitializeMetadata();
+  }
 
   if (!error_detected_) {
     initialized_ = InitializationState::kReady;
@@ -142,6 +190,7 @@ Status KeyValueStore::InitializeMetadata() {
 
   sectors_.Reset();
   entry_cache_.Reset();
+  checkpoint_sector_ = nullptr;
 
   DBG("First pass: Read all entries from all sectors");
   Address sector_address = 0;
@@ -156,6 +205,10 @@ Status KeyValueStore::InitializeMetadata() {
 
     size_t sector_corrupt_bytes = 0;
 
+    // Batches are contiguous within a sector, so an uncommitted batch at the
+    // end of a sector is discarded.
+    PendingBatch pending_batch{};
+
     for (int num_entries_in_sector = 0; true; num_entries_in_sector++) {
       DBG("Load entry: sector=%u, entry#=%d, address=%u",
           unsigned(sector_address),
@@ -168,7 +221,8 @@ Status KeyValueStore::InitializeMetadata() {
       }
 
       Address next_entry_address;
-      Status status = LoadEntry(entry_address, &next_entry_address);
+      Status status =
+          LoadEntry(entry_address, &next_entry_address, pending_batch);
       if (status.IsNotFound()) {
         DBG("Hit un-written data in sector; moving to the next sector");
         break;
@@ -180,6 +234,10 @@ Status KeyValueStore::InitializeMetadata() {
         error_detected_ = true;
         corrupt_entries++;
 
+        // A batch with a corrupt entry cannot be committed.
+        pending_batch.active = false;
+        pending_batch.follows_corruption = true;
+
         status = ScanForEntry(sector,
                               entry_address + Entry::kMinAlignmentBytes,
                               &next_entry_address);
@@ -203,6 +261,17 @@ Status KeyValueStore::InitializeMetadata() {
                                 (entry_address - sector_address));
     }
 
+    // A checkpoint that is the only entry in its sector would be loaded by a
+    // later Init, so it must be discarded before flash is changed.
+    Entry checkpoint;
+    if (sector_corrupt_bytes == 0u && !sector.Empty(sector_size_bytes) &&
+        ReadCheckpointEntry(sector, &checkpoint).ok() &&
+        checkpoint.next_address() == sectors_.NextWritableAddress(sector)) {
+      DBG("Sector %u holds an unused checkpoint", sectors_.Index(sector));
+      checkpoint_sector_ = &sector;
+      sector.set_writable_bytes(0);
+    }
+
     if (sector_corrupt_bytes > 0) {
       // If the sector contains corrupt data, prevent any further entries from
       // being written to it by indicating that it has no space. This should
@@ -263,6 +332,27 @@ Status KeyValueStore::InitializeMetadata() {
       }
     }
 
+    // The older entries in a delta chain are valid too, since the value is
+    // read from them.
+    Entry newest;
+    if (!metadata.addresses().empty() &&
+        Entry::Read(partition_, metadata.first_address(), formats_, &newest)
+            .ok() &&
+        newest.delta()) {
+      internal::DeltaChain chain;
+      if (chain.Load(partition_, formats_, newest).ok()) {
+        for (size_t i = 1; i < chain.addresses().size(); ++i) {
+          sectors_.FromAddress(chain.addresses()[i])
+              .AddValidBytes(chain.entry_size(i));
+        }
+        metadata.set_delta_count(chain.delta_count());
+      } else {
+        WRN("Key 0x%08x has a broken delta chain", unsigned(metadata.hash()));
+        corrupt_entries++;
+        error_detected_ = true;
+      }
+    }
+
     if (metadata.IsNewerThan(last_transaction_id_)) {
       last_transaction_id_ = metadata.transaction_id();
       newest_key = metadata.addresses().back();
@@ -352,22 +442,97 @@ bool KeyValueStore::CheckForErrors() {
 }
 
 Status KeyValueStore::LoadEntry(Address entry_address,
-                                Address* next_entry_address) {
+                                Address* next_entry_address,
+                                PendingBatch& pending_batch) {
   Entry entry;
   PW_TRY(Entry::Read(partition_, entry_address, formats_, &entry));
 
+  // Checkpoint entries have no key. They are only used by LoadCheckpoint, so
+  // they are skipped after checking that they are intact.
+  if (entry.checkpoint()) {
+    PW_TRY(entry.VerifyChecksumInFlash());
+    *next_entry_address = entry.next_address();
+    return OkStatus();
+  }
+
   // Read the key from flash & validate the entry (which reads the value).
   Entry::KeyBuffer key_buffer;
-  PW_TRY_ASSIGN(size_t key_length, entry.ReadKey(key_buffer));
-  const Key key(key_buffer.data(), key_length);
+  PW_TRY(entry.ReadKey(key_buffer));
 
   PW_TRY(entry.VerifyChecksumInFlash());
 
   // A valid entry was found, so update the next entry address before doing any
   // of the checks that happen in AddNewOrUpdateExisting.
   *next_entry_address = entry.next_address();
+
+  const bool continues_batch =
+      pending_batch.active &&
+      pending_batch.transaction_id == entry.transaction_id();
+  const bool follows_corruption = pending_batch.follows_corruption;
+  pending_batch.follows_corruption = false;
+
+  switch (entry.batch_state()) {
+    case Entry::BatchState::kNone:
+      break;
+    case Entry::BatchState::kMember:
+      if (!continues_batch) {
+        if (pending_batch.active) {
+          DBG("Discarding uncommitted batch %u",
+              unsigned(pending_batch.transaction_id));
+        }
+        pending_batch = {.active = true,
+                         .follows_corruption = false,
+                         .intact = !follows_corruption,
+                         .first_address = entry_address,
+                         .transaction_id = entry.transaction_id()};
+      }
+      // Batch entries are loaded once the commit entry is found.
+      return OkStatus();
+    case Entry::BatchState::kCommit:
+      if (continues_batch && pending_batch.intact) {
+        pending_batch.active = false;
+        PW_TRY(LoadBatchEntries(pending_batch.first_address, entry_address));
+        break;
+      }
+      // A commit entry is always preceded by the other entries in its batch.
+      // If they are missing or corrupt, the whole batch is discarded.
+      DBG("Discarding incomplete batch %u", unsigned(entry.transaction_id()));
+      pending_batch.active = false;
+      return OkStatus();
+  }
+
+  if (pending_batch.active) {
+    DBG("Discarding uncommitted batch %u",
+        unsigned(pending_batch.transaction_id));
+    pending_batch.active = false;
+  }
+
+  return AddLoadedEntry(entry);
+}
+
+Status KeyValueStore::LoadBatchEntries(Address first_address,
+                                       Address commit_address) {
+  // The entries were read and verified when they were first found, but could
+  // not be loaded until the batch was known to be committed.
+  for (Address address = first_address; address < commit_address;) {
+    Entry entry;
+    PW_TRY(Entry::Read(partition_, address, formats_, &entry));
+    PW_TRY(AddLoadedEntry(entry));
+    address = entry.next_address();
+  }
+  return OkStatus();
+}
+
+Status KeyValueStore::AddLoadedEntry(const Entry& entry) {
+  Entry::KeyBuffer key_buffer;
+  PW_TRY_ASSIGN(size_t key_length, entry.ReadKey(key_buffer));
+  const Key key(key_buffer.data(), key_length);
+
   return entry_cache_.AddNewOrUpdateExisting(
-      entry.descriptor(key), entry.address(), partition_.sector_size_bytes());
+      entry.descriptor(key),
+      entry.address(),
+      partition_.sector_size_bytes(),
+      key);
 }
 
 // Scans flash memory within a sector to find a KVS entry magic.
@@ -382,19 +547,34 @@ Status KeyValueStore::ScanForEntry(const SectorDescriptor& sector,
   // Entry::kMinAlignmentBytes. However, that multiple can vary between entries.
   // When scanning, we don't have an entry to tell us what the current alignment
   // is, so the minimum alignment is used to be exhaustive.
-  for (Address address = AlignUp(start_address, Entry::kMinAlignmentBytes);
-       sectors_.AddressInSector(sector, address);
-       address += Entry::kMinAlignmentBytes) {
-    uint32_t magic;
-    StatusWithSize read_result =
-        partition_.Read(address, std::as_writable_bytes(std::span(&magic, 1)));
-    if (!read_result.ok()) {
+  //
+  // The sector is read in large blocks, so each flash read covers many
+  // possible entry addresses. Erased blocks are skipped without checking each
+  // address for a magic.
+  static_assert(kReadBufferSizeBytes % Entry::kMinAlignmentBytes == 0u);
+  std::array<byte, kReadBufferSizeBytes> buffer;
+
+  const Address sector_end =
+      sectors_.BaseAddress(sector) + partition_.sector_size_bytes();
+
+  for (Address block = AlignUp(start_address, Entry::kMinAlignmentBytes);
+       block < sector_end;
+       block += buffer.size()) {
+    const std::span<byte> data = std::span(buffer).first(
+        std::min<size_t>(buffer.size(), sector_end - block));
+    if (!partition_.Read(block, data).ok() || partition_.AppearsErased(data)) {
       continue;
     }
-    if (formats_.KnownMagic(magic)) {
-      DBG("Found entry magic at address %u", unsigned(address));
-      *next_entry_address = address;
-      return OkStatus();
+
+    for (size_t offset = 0; offset < data.size();
+         offset += Entry::kMinAlignmentBytes) {
+      uint32_t magic;
+      std::memcpy(&magic, &data[offset], sizeof(magic));
+      if (formats_.KnownMagic(magic)) {
+        DBG("Found entry magic at address %u", unsigned(block + offset));
+        *next_entry_address = block + offset;
+        return OkStatus();
+      }
     }
   }
 
@@ -412,8 +592,36 @@ StatusWithSize KeyValueStore::Get(Key key,
   return Get(key, metadata, value_buffer, offset_bytes);
 }
 
+Status KeyValueStore::GetMapped(Key key, std::span<const byte>* value) const {
+  PW_TRY(CheckReadOperation(key));
+
+  EntryMetadata metadata;
+  PW_TRY(FindExisting(key, &metadata));
+
+  Entry entry;
+  PW_TRY(ReadEntry(metadata, entry));
+
+  // A delta-encoded value is spread across multiple entries.
+  if (entry.delta()) {
+    return Status::Unimplemented();
+  }
+
+  const byte* mapped_value =
+      partition_.PartitionAddressToMcuAddress(entry.value_address());
+  if (mapped_value == nullptr) {
+    return Status::Unimplemented();
+  }
+
+  // Verify the value in place, since the caller reads it directly from flash.
+  const std::span<const byte> value_span(mapped_value, entry.value_size());
+  PW_TRY(entry.VerifyChecksum(key, value_span));
+  *value = value_span;
+  return OkStatus();
+}
+
 Status KeyValueStore::PutBytes(Key key, std::span<const byte> value) {
   PW_TRY(CheckWriteOperation(key));
+  IoScope io_scope(*this, IoCause::kPut);
   DBG("Writing key/value; key length=%u, value length=%u",
       unsigned(key.size()),
       unsigned(value.size()));
@@ -444,8 +652,146 @@ Status KeyValueStore::PutBytes(Key key, std::span<const byte> value) {
   return status;
 }
 
+Status KeyValueStore::PutBatch(std::span<const BatchEntry> entries) {
+  size_t batch_size;
+  PW_TRY(CheckBatch(entries, &batch_size));
+  IoScope io_scope(*this, IoCause::kPut);
+
+  DBG("Writing batch of %u entries (%u B)",
+      unsigned(entries.size()),
+      unsigned(batch_size));
+
+  // Find space for a contiguous copy of the batch in each redundant sector.
+  // This may involve garbage collecting one or more sectors.
+  Address* reserved_addresses = entry_cache_.TempReservedAddressesForWrite();
+  PW_TRY(GetAddressesForWrite(reserved_addresses, batch_size));
+
+  // All entries in the batch share one transaction ID.
+  last_transaction_id_ += 1;
+  const uint32_t transaction_id = last_transaction_id_;
+
+  PW_TRY(AppendBatch(entries, reserved_addresses[0], transaction_id));
+
+  // The batch is committed, so update the key descriptors to the new entries.
+  Address address = reserved_addresses[0];
+  for (const BatchEntry& batch_entry : entries) {
+    const Entry entry = Entry::Valid(partition_,
+                                     address,
+                                     formats_.primary(),
+                                     batch_entry.key,
+                                     batch_entry.value,
+                                     transaction_id);
+    EntryMetadata prior_metadata;
+    Status status = FindEntry(batch_entry.key, &prior_metadata);
+    if (status.ok()) {
+      Entry prior_entry;
+      PW_TRY(ReadEntry(prior_metadata, prior_entry));
+      UpdateKeyDescriptor(entry, address, &prior_metadata, prior_entry.size());
+    } else if (status.IsNotFound()) {
+      entry_cache_.AddNew(
+          entry.descriptor(batch_entry.key), address, batch_entry.key);
+    } else {
+      return status;
+    }
+    address = entry.next_address();
+  }
+
+  // Write the additional copies of the batch, if redundancy is greater than 1.
+  for (size_t i = 1; i < redundancy(); ++i) {
+    PW_TRY(AppendBatch(entries, reserved_addresses[i], transaction_id));
+
+    address = reserved_addresses[i];
+    for (const BatchEntry& batch_entry : entries) {
+      EntryMetadata metadata;
+      PW_TRY(FindEntry(batch_entry.key, &metadata));
+      metadata.AddNewAddress(address);
+      address += Entry::size(partition_, batch_entry.key, batch_entry.value);
+    }
+  }
+  return OkStatus();
+}
+
+Status KeyValueStore::CheckBatch(std::span<const BatchEntry> entries,
+                                 size_t* batch_size) {
+  if (entries.empty()) {
+    return Status::InvalidArgument();
+  }
+
+  size_t new_keys = 0;
+  *batch_size = 0;
+
+  for (size_t i = 0; i < entries.size(); ++i) {
+    const BatchEntry& batch_entry = entries[i];
+    PW_TRY(CheckWriteOperation(batch_entry.key));
+
+    for (size_t j = 0; j < i; ++j) {
+      if (entries[j].key == batch_entry.key) {
+        DBG("Key repeated in batch");
+        return Status::InvalidArgument();
+      }
+    }
+
+    EntryMetadata metadata;
+    Status status = FindEntry(batch_entry.key, &metadata);
+    if (status.IsNotFound()) {
+      new_keys += 1;
+    } else if (!status.ok()) {
+      return status;
+    }
+
+    *batch_size += Entry::size(partition_, batch_entry.key, batch_entry.value);
+  }
+
+  if (*batch_size > partition_.sector_size_bytes()) {
+    DBG("%u B batch cannot fit in one sector", unsigned(*batch_size));
+    return Status::InvalidArgument();
+  }
+
+  if (new_keys > entry_cache_.max_entries() - entry_cache_.total_entries()) {
+    WRN("KVS full: trying to store %u new entries, but can't. Have %u entries",
+        unsigned(new_keys),
+        unsigned(entry_cache_.total_entries()));
+    return Status::ResourceExhausted();
+  }
+  return OkStatus();
+}
+
+Status KeyValueStore::AppendBatch(std::span<const BatchEntry> entries,
+                                  Address address,
+                                  uint32_t transaction_id) {
+  SectorDescriptor& sector = sectors_.FromAddress(address);
+  size_t written_bytes = 0;
+
+  for (size_t i = 0; i < entries.size(); ++i) {
+    // A single entry is atomic on its own, so it is written as a normal entry.
+    Entry::BatchState batch_state = Entry::BatchState::kNone;
+    if (entries.size() > 1u) {
+      batch_state = i + 1 == entries.size() ? Entry::BatchState::kCommit
+                                            : Entry::BatchState::kMember;
+    }
+    const Entry entry = Entry::Valid(partition_,
+                                     address,
+                                     formats_.primary(),
+                                     entries[i].key,
+                                     entries[i].value,
+                                     transaction_id,
+                                     batch_state);
+    Status status = AppendEntry(entry, entries[i].key, entries[i].value);
+    if (!status.ok()) {
+      // The batch was not committed, so the entries already written in this
+      // copy are not valid.
+      sector.RemoveValidBytes(written_bytes);
+      return status;
+    }
+    written_bytes += entry.size();
+    address = entry.next_address();
+  }
+  return OkStatus();
+}
+
 Status KeyValueStore::Delete(Key key) {
   PW_TRY(CheckWriteOperation(key));
+  IoScope io_scope(*this, IoCause::kPut);
 
   EntryMetadata metadata;
   PW_TRY(FindExisting(key, &metadata));
@@ -467,6 +813,26 @@ void KeyValueStore::Item::ReadKey() {
   }
 }
 
+bool KeyValueStore::ReadKeyIfPrefixMatches(Item& item, Key prefix) const {
+  const EntryMetadata& metadata = *item.iterator_;
+  if (!entry_cache_.KeyPrefixMayMatch(metadata, prefix)) {
+    return false;
+  }
+
+  item.ReadKey();
+  const Key key(item.key());
+  if (key.empty()) {
+    return false;  // The entry could not be read.
+  }
+
+  // Keys loaded from a checkpoint are not in the index until they are read.
+  if (!entry_cache_.KeyPrefixKnown(metadata)) {
+    entry_cache_.SetKeyPrefix(metadata, key);
+  }
+  return key.size() >= prefix.size() &&
+         Key(key.data(), prefix.size()) == prefix;
+}
+
 KeyValueStore::iterator& KeyValueStore::iterator::operator++() {
   // Skip to the next entry that is valid (not deleted).
   while (++item_.iterator_ != item_.kvs_.entry_cache_.end() &&
@@ -539,20 +905,68 @@ StatusWithSize KeyValueStore::Get(Key key,
                                   const EntryMetadata& metadata,
                                   std::span<std::byte> value_buffer,
                                   size_t offset_bytes) const {
+  std::span<const byte> cached_value;
+  if (offset_bytes == 0u &&
+      entry_cache_.FindCachedValue(metadata, &cached_value)) {
+    const size_t read_size = std::min(value_buffer.size(), cached_value.size());
+    std::memcpy(value_buffer.data(), cached_value.data(), read_size);
+
+    if (read_size != cached_value.size()) {
+      return StatusWithSize::ResourceExhausted(read_size);
+    }
+    return StatusWithSize(read_size);
+  }
+
+  return GetFromFlash(key, metadata, value_buffer, offset_bytes);
+}
+
+StatusWithSize KeyValueStore::GetFromFlash(Key key,
+                                           const EntryMetadata& metadata,
+                                           std::span<std::byte> value_buffer,
+                                           size_t offset_bytes) const {
   Entry entry;
 
   PW_TRY_WITH_SIZE(ReadEntry(metadata, entry));
 
+  if (entry.delta()) {
+    return GetFromDeltaChain(entry, metadata, value_buffer, offset_bytes);
+  }
+
   StatusWithSize result = entry.ReadValue(value_buffer, offset_bytes);
-  if (result.ok() && options_.verify_on_read && offset_bytes == 0u) {
+  if (!result.ok() || offset_bytes != 0u) {
+    return result;
+  }
+
+  if (options_.verify_on_read) {
     Status verify_result =
         entry.VerifyChecksum(key, value_buffer.first(result.size()));
     if (!verify_result.ok()) {
       std::memset(value_buffer.data(), 0, result.size());
       return StatusWithSize(verify_result, 0);
     }
+  }
 
-    return StatusWithSize(verify_result, result.size());
+  entry_cache_.CacheValue(metadata, value_buffer.first(result.size()));
+  return result;
+}
+
+StatusWithSize KeyValueStore::GetFromDeltaChain(
+    const Entry& newest,
+    const EntryMetadata& metadata,
+    std::span<std::byte> value_buffer,
+    size_t offset_bytes) const {
+  internal::DeltaChain chain;
+  PW_TRY_WITH_SIZE(chain.Load(partition_, formats_, newest));
+
+  // The checksums cover the entries rather than the value they represent, so
+  // they are verified in flash.
+  if (options_.verify_on_read && offset_bytes == 0u) {
+    PW_TRY_WITH_SIZE(chain.VerifyChecksumsInFlash(formats_));
+  }
+
+  StatusWithSize result = chain.ReadValue(value_buffer, offset_bytes);
+  if (result.ok() && offset_bytes == 0u) {
+    entry_cache_.CacheValue(metadata, value_buffer.first(result.size()));
   }
   return result;
 }
@@ -574,7 +988,12 @@ Status KeyValueStore::FixedSizeGet(Key key,
                                    size_t size_bytes) const {
   // Ensure that the size of the stored value matches the size of the type.
   // Otherwise, report error. This check avoids potential memory corruption.
-  PW_TRY_ASSIGN(const size_t actual_size, ValueSize(metadata));
+  std::span<const byte> cached_value;
+  const bool cached = entry_cache_.FindCachedValue(metadata, &cached_value);
+  size_t actual_size = cached_value.size();
+  if (!cached) {
+    PW_TRY_ASSIGN(actual_size, ValueSize(metadata));
+  }
 
   if (actual_size != size_bytes) {
     DBG("Requested %u B read, but value is %u B",
@@ -583,8 +1002,13 @@ Status KeyValueStore::FixedSizeGet(Key key,
     return Status::InvalidArgument();
   }
 
-  StatusWithSize result =
-      Get(key, metadata, std::span(static_cast<byte*>(value), size_bytes), 0);
+  if (cached) {
+    std::memcpy(value, cached_value.data(), size_bytes);
+    return OkStatus();
+  }
+
+  StatusWithSize result = GetFromFlash(
+      key, metadata, std::span(static_cast<byte*>(value), size_bytes), 0);
 
   return result.status();
 }
@@ -593,6 +1017,13 @@ StatusWithSize KeyValueStore::ValueSize(const EntryMetadata& metadata) const {
   Entry entry;
   PW_TRY_WITH_SIZE(ReadEntry(metadata, entry));
 
+  if (entry.delta()) {
+    internal::DeltaHeader header;
+    PW_TRY_WITH_SIZE(
+        partition_.Read(entry.value_address(), sizeof(header), &header));
+    return StatusWithSize(header.value_size);
+  }
+
   return StatusWithSize(entry.value_size());
 }
 
@@ -652,7 +1083,8 @@ Status KeyValueStore::WriteEntry(Key key,
   // check if the values match. Directly compare the prior and new values
   // because the checksum can not be depended on to establish equality, it can
   // only be depended on to establish inequality.
-  if (prior_entry != nullptr && prior_entry->value_size() == value.size() &&
+  if (prior_entry != nullptr && !prior_entry->delta() &&
+      prior_entry->value_size() == value.size() &&
       prior_metadata->state() == new_state &&
       prior_entry->ValueMatches(value).ok()) {
     // The new value matches the prior value, don't need to write anything. Just
@@ -662,6 +1094,22 @@ Status KeyValueStore::WriteEntry(Key key,
     return OkStatus();
   }
 
+  // If the format supports it, a value that changed only slightly is written
+  // as a delta of the prior value, which is much smaller than the full value.
+  if (prior_entry != nullptr) {
+    internal::DeltaChain chain;
+    internal::DeltaPatches patches;
+    if (PlanDeltaEntry(
+            *prior_metadata, *prior_entry, new_state, value, chain, patches)) {
+      if (patches.empty()) {
+        DBG("Write for key 0x%08x with matching value skipped",
+            unsigned(prior_metadata->hash()));
+        return OkStatus();
+      }
+      return WriteDeltaEntry(key, value, *prior_metadata, *prior_entry, patches);
+    }
+  }
+
   // List of addresses for sectors with space for this entry.
   Address* reserved_addresses = entry_cache_.TempReservedAddressesForWrite();
 
@@ -670,13 +1118,22 @@ Status KeyValueStore::WriteEntry(Key key,
   const size_t entry_size = Entry::size(partition_, key, value);
   PW_TRY(GetAddressesForWrite(reserved_addresses, entry_size));
 
+  // Garbage collection may have compacted the prior value's delta chain, which
+  // replaces the prior entry.
+  size_t prior_size = prior_entry != nullptr ? prior_entry->size() : 0;
+  if (prior_entry != nullptr &&
+      prior_metadata->transaction_id() != prior_entry->transaction_id()) {
+    Entry compacted_entry;
+    PW_TRY(ReadEntry(*prior_metadata, compacted_entry));
+    prior_size = compacted_entry.size();
+  }
+
   // Write the entry at the first address that was found.
   Entry entry = CreateEntry(reserved_addresses[0], key, value, new_state);
   PW_TRY(AppendEntry(entry, key, value));
 
   // After writing the first entry successfully, update the key descriptors.
   // Once a single new the entry is written, the old entries are invalidated.
-  size_t prior_size = prior_entry != nullptr ? prior_entry->size() : 0;
   EntryMetadata new_metadata =
       CreateOrUpdateKeyDescriptor(entry, key, prior_metadata, prior_size);
 
@@ -689,6 +1146,115 @@ Status KeyValueStore::WriteEntry(Key key,
   return OkStatus();
 }
 
+bool KeyValueStore::PlanDeltaEntry(const EntryMetadata& prior_metadata,
+                                   const Entry& prior_entry,
+                                   EntryState new_state,
+                                   std::span<const byte> value,
+                                   internal::DeltaChain& chain,
+                                   internal::DeltaPatches& patches) const {
+  const EntryFormat& format = formats_.primary();
+  const size_t max_chain_length = std::min<size_t>(
+      format.max_delta_chain_length, internal::kMaxDeltaChainLength);
+
+  // Deltas are only used without redundancy. A chain's older entries are not
+  // duplicated, and compacting a chain during garbage collection would need
+  // space for every copy of the full value at once.
+  if (format.delta_magic == 0u || redundancy() != 1u ||
+      new_state != EntryState::kValid ||
+      prior_metadata.state() != EntryState::kValid ||
+      prior_metadata.delta_count() >= max_chain_length) {
+    return false;
+  }
+
+  // If the prior value cannot be read, write the full value instead.
+  if (!chain.Load(partition_, formats_, prior_entry).ok() ||
+      chain.value_size() != value.size() ||
+      !chain.FindChanges(value, patches).ok()) {
+    return false;
+  }
+
+  // Each delta makes reads slower, so only use it if it saves most of the
+  // space of a full value.
+  return patches.encoded_size() * 2 <= value.size();
+}
+
+Status KeyValueStore::WriteDeltaEntry(Key key,
+                                      std::span<const byte> value,
+                                      EntryMetadata& prior_metadata,
+                                      const Entry& prior_entry,
+                                      const internal::DeltaPatches& patches) {
+  Address* reserved_addresses = entry_cache_.TempReservedAddressesForWrite();
+  PW_TRY(GetAddressesForWrite(
+      reserved_addresses,
+      Entry::size(partition_, key, patches.encoded_size())));
+
+  // Finding space may have relocated the prior entry or compacted its chain.
+  Entry previous;
+  PW_TRY(ReadEntry(prior_metadata, previous));
+  if (previous.transaction_id() != prior_entry.transaction_id()) {
+    DBG("Delta chain for key 0x%08x was compacted; retrying write",
+        unsigned(prior_metadata.hash()));
+    return WriteEntry(
+        key, value, EntryState::kValid, &prior_metadata, &previous);
+  }
+
+  const internal::DeltaHeader header{
+      .previous_address = previous.address(),
+      .value_size = static_cast<uint16_t>(value.size()),
+      .patch_count = static_cast<uint8_t>(patches.patches().size()),
+      .chain_length = static_cast<uint8_t>(prior_metadata.delta_count() + 1),
+  };
+  std::array<std::span<const byte>, internal::DeltaPatches::kMaxValueChunks>
+      chunks;
+  const std::span<const std::span<const byte>> value_chunks =
+      std::span(chunks).first(patches.EncodeChunks(header, value, chunks));
+
+  // Burn a transaction ID for the same reasons as in CreateEntry.
+  last_transaction_id_ += 1;
+  Entry entry = Entry::Delta(partition_,
+                             reserved_addresses[0],
+                             formats_.primary(),
+                             key,
+                             value_chunks,
+                             last_transaction_id_);
+
+  DBG("Writing %u B delta for key 0x%08x with %u patches",
+      unsigned(entry.size()),
+      unsigned(prior_metadata.hash()),
+      unsigned(header.patch_count));
+  PW_TRY(DiscardCheckpoint());
+  PW_TRY(FinishAppendEntry(entry, entry.WriteDelta(key, value_chunks)));
+
+  // The prior entry is now part of the chain, so none of it is stale.
+  entry_cache_.InvalidateCachedValue(prior_metadata);
+  prior_metadata.Reset(entry.descriptor(prior_metadata.hash()),
+                       entry.address());
+  prior_metadata.set_delta_count(header.chain_length);
+  return OkStatus();
+}
+
+void KeyValueStore::ReleaseDeltaChain(const EntryMetadata& metadata) {
+  if (metadata.delta_count() == 0u) {
+    return;
+  }
+
+  Entry newest;
+  internal::DeltaChain chain;
+  if (!ReadEntry(metadata, newest).ok() ||
+      !chain.Load(partition_, formats_, newest).ok()) {
+    // The sectors' valid bytes are recounted when the KVS is repaired.
+    ERR("Unable to read delta chain for key 0x%08x",
+        unsigned(metadata.hash()));
+    error_detected_ = true;
+    return;
+  }
+
+  for (size_t i = 1; i < chain.addresses().size(); ++i) {
+    sectors_.FromAddress(chain.addresses()[i])
+        .RemoveValidBytes(chain.entry_size(i));
+  }
+}
+
 KeyValueStore::EntryMetadata KeyValueStore::CreateOrUpdateKeyDescriptor(
     const Entry& entry,
     Key key,
@@ -696,7 +1262,7 @@ KeyValueStore::EntryMetadata KeyValueStore::CreateOrUpdateKeyDescriptor(
     size_t prior_size) {
   // If there is no prior descriptor, create a new one.
   if (prior_metadata == nullptr) {
-    return entry_cache_.AddNew(entry.descriptor(key), entry.address());
+    return entry_cache_.AddNew(entry.descriptor(key), entry.address(), key);
   }
 
   return UpdateKeyDescriptor(
@@ -708,6 +1274,9 @@ KeyValueStore::EntryMetadata KeyValueStore::UpdateKeyDescriptor(
     Address new_address,
     EntryMetadata* prior_metadata,
     size_t prior_size) {
+  entry_cache_.InvalidateCachedValue(*prior_metadata);
+  ReleaseDeltaChain(*prior_metadata);
+
   // Remove valid bytes for the old entry and its copies, which are now stale.
   for (Address address : prior_metadata->addresses()) {
     sectors_.FromAddress(address).RemoveValidBytes(prior_size);
@@ -741,7 +1310,7 @@ Status KeyValueStore::GetAddressesForWrite(Address* write_addresses,
 Status KeyValueStore::GetSectorForWrite(SectorDescriptor** sector,
                                         size_t entry_size,
                                         std::span<const Address> reserved) {
-  Status result = sectors_.FindSpace(sector, entry_size, reserved);
+  Status result = FindSpaceForWrite(sector, entry_size, reserved);
 
   size_t gc_sector_count = 0;
   bool do_auto_gc = options_.gc_on_write != GargbageCollectOnWrite::kDisabled;
@@ -763,7 +1332,7 @@ Status KeyValueStore::GetSectorForWrite(SectorDescriptor** sector,
       return gc_status;
     }
 
-    result = sectors_.FindSpace(sector, entry_size, reserved);
+    result = FindSpaceForWrite(sector, entry_size, reserved);
 
     gc_sector_count++;
     // Allow total sectors + 2 number of GC cycles so that once reclaimable
@@ -795,8 +1364,12 @@ Status KeyValueStore::MarkSectorCorruptIfNotOk(Status status,
 Status KeyValueStore::AppendEntry(const Entry& entry,
                                   Key key,
                                   std::span<const byte> value) {
-  const StatusWithSize result = entry.Write(key, value);
+  PW_TRY(DiscardCheckpoint());
+  return FinishAppendEntry(entry, entry.Write(key, value));
+}
 
+Status KeyValueStore::FinishAppendEntry(const Entry& entry,
+                                        const StatusWithSize result) {
   SectorDescriptor& sector = sectors_.FromAddress(entry.address());
 
   if (!result.ok()) {
@@ -819,6 +1392,11 @@ Status KeyValueStore::AppendEntry(const Entry& entry,
 StatusWithSize KeyValueStore::CopyEntryToSector(Entry& entry,
                                                 SectorDescriptor* new_sector,
                                                 Address new_address) {
+  // A copied entry does not need its batch flags, since its batch has already
+  // been committed. Copied alone, it would look like an uncommitted batch.
+  PW_TRY_WITH_SIZE(entry.ClearBatchState());
+  PW_TRY_WITH_SIZE(DiscardCheckpoint());
+
   const StatusWithSize result = entry.Copy(new_address);
 
   PW_TRY_WITH_SIZE(MarkSectorCorruptIfNotOk(result.status(), new_sector));
@@ -843,7 +1421,8 @@ StatusWithSize KeyValueStore::CopyEntryToSector(Entry& entry,
 Status KeyValueStore::RelocateEntry(
     const EntryMetadata& metadata,
     KeyValueStore::Address& address,
-    std::span<const Address> reserved_addresses) {
+    std::span<const Address> reserved_addresses,
+    RelocationSpace space) {
   Entry entry;
   PW_TRY(ReadEntry(metadata, entry));
 
@@ -855,8 +1434,15 @@ Status KeyValueStore::RelocateEntry(
   // an immediate extra relocation).
   SectorDescriptor* new_sector;
 
-  PW_TRY(sectors_.FindSpaceDuringGarbageCollection(
-      &new_sector, entry.size(), metadata.addresses(), reserved_addresses));
+  if (space == RelocationSpace::kIncludingFreeSector) {
+    PW_TRY(sectors_.FindSpaceDuringGarbageCollection(
+        &new_sector, entry.size(), metadata.addresses(), reserved_addresses));
+  } else {
+    // The key's other addresses are skipped as well, so redundant copies stay
+    // in different sectors.
+    PW_DCHECK(reserved_addresses.empty());
+    PW_TRY(sectors_.FindSpace(&new_sector, entry.size(), metadata.addresses()));
+  }
 
   Address new_address = sectors_.NextWritableAddress(*new_sector);
   PW_TRY_ASSIGN(const size_t result_size,
@@ -864,13 +1450,96 @@ Status KeyValueStore::RelocateEntry(
   sectors_.FromAddress(address).RemoveValidBytes(result_size);
   address = new_address;
 
+  // The value is unchanged, but drop the cached copy so the next read verifies
+  // the relocated entry.
+  entry_cache_.InvalidateCachedValue(metadata);
+
   return OkStatus();
 }
 
+Status KeyValueStore::CompactDeltaChain(
+    EntryMetadata& metadata,
+    SectorDescriptor* sector_to_gc,
+    std::span<const Address> reserved_addresses,
+    RelocationSpace space) {
+  Entry newest;
+  PW_TRY(ReadEntry(metadata, newest));
+
+  internal::DeltaChain chain;
+  PW_TRY(chain.Load(partition_, formats_, newest));
+
+  Entry::KeyBuffer key_buffer;
+  PW_TRY_ASSIGN(const size_t key_length, newest.ReadKey(key_buffer));
+  const Key key(key_buffer.data(), key_length);
+
+  last_transaction_id_ += 1;
+  Entry entry;
+  PW_TRY(Entry::Compacted(partition_,
+                          0,
+                          formats_.primary(),
+                          key,
+                          chain,
+                          last_transaction_id_,
+                          &entry));
+
+  DBG("  Compacting %u deltas for key 0x%08x into a %u B entry",
+      unsigned(chain.delta_count()),
+      unsigned(metadata.hash()),
+      unsigned(entry.size()));
+
+  // Mark the sector being garbage collected as full while the new entries are
+  // written, so none of them are written to it.
+  const size_t gc_sector_writable_bytes =
+      sector_to_gc != nullptr ? sector_to_gc->writable_bytes() : 0;
+  if (sector_to_gc != nullptr) {
+    sector_to_gc->set_writable_bytes(0);
+  }
+
+  Status status = OkStatus();
+  for (size_t i = 0; status.ok() && i < redundancy(); ++i) {
+    // Once the first entry is written, the metadata refers to the new entries,
+    // so each copy is written to a different sector.
+    const std::span<const Address> addresses_to_skip =
+        i == 0u ? std::span<const Address>() : metadata.addresses();
+
+    SectorDescriptor* new_sector;
+    if (space == RelocationSpace::kIncludingFreeSector) {
+      status = sectors_.FindSpaceDuringGarbageCollection(
+          &new_sector, entry.size(), addresses_to_skip, reserved_addresses);
+    } else {
+      PW_DCHECK(reserved_addresses.empty());
+      status = sectors_.FindSpace(&new_sector, entry.size(), addresses_to_skip);
+    }
+    if (!status.ok()) {
+      break;
+    }
+
+    entry.set_address(sectors_.NextWritableAddress(*new_sector));
+    status = DiscardCheckpoint();
+    if (status.ok()) {
+      status = FinishAppendEntry(entry, entry.WriteCompacted(key, chain));
+    }
+
+    if (status.ok()) {
+      if (i == 0u) {
+        UpdateKeyDescriptor(entry, entry.address(), &metadata, newest.size());
+      } else {
+        metadata.AddNewAddress(entry.address());
+      }
+    }
+  }
+
+  if (sector_to_gc != nullptr) {
+    sector_to_gc->set_writable_bytes(gc_sector_writable_bytes);
+  }
+  return status;
+}
+
 Status KeyValueStore::FullMaintenanceHelper(MaintenanceType maintenance_type) {
   if (initialized_ == InitializationState::kNotInitialized) {
     return Status::FailedPrecondition();
   }
+  IoScope io_scope(*this, IoCause::kGarbageCollection);
 
   // Full maintenance can be a potentially heavy operation, and should be
   // relatively infrequent, so log start/end at INFO level.
@@ -943,9 +1612,370 @@ Status KeyValueStore::PartialMaintenance() {
   return GarbageCollect(std::span<const Address>());
 }
 
+Status KeyValueStore::StepMaintenance(size_t max_bytes_to_relocate) {
+  if (initialized_ == InitializationState::kNotInitialized) {
+    return Status::FailedPrecondition();
+  }
+  IoScope io_scope(*this, IoCause::kGarbageCollection);
+
+  PW_TRY(FinishBackgroundErase());
+
+  // The sector is made unwritable when its garbage collection starts. If it is
+  // writable again, another operation already garbage collected it.
+  if (step_gc_sector_ != nullptr && step_gc_sector_->writable_bytes() != 0) {
+    DBG("Step GC sector %u was garbage collected elsewhere",
+        sectors_.Index(step_gc_sector_));
+    step_gc_sector_ = nullptr;
+  }
+
+  if (step_gc_sector_ == nullptr) {
+    CheckForErrors();
+    // Do automatic repair, if KVS options allow for it.
+    if (error_detected_ && options_.recovery != ErrorRecovery::kManual) {
+      PW_TRY(Repair());
+    }
+
+    SectorDescriptor* sector = sectors_.FindSectorToGarbageCollect({});
+    if (sector == nullptr ||
+        sector->RecoverableBytes(partition_.sector_size_bytes()) == 0) {
+      return Status::NotFound();
+    }
+
+    DBG("Step GC starting on sector %u", sectors_.Index(sector));
+
+    // Stop new entries from being written to the sector while its valid
+    // entries are relocated over multiple steps.
+    sector->set_writable_bytes(0);
+    step_gc_sector_ = sector;
+    step_gc_next_entry_ = 0;
+  }
+
+  SectorDescriptor& sector = *step_gc_sector_;
+
+  // Step 1: Move valid entries in the GC sector to other sectors, resuming from
+  // where the last step stopped.
+  if (sector.valid_bytes() != 0) {
+    const size_t initial_valid_bytes = sector.valid_bytes();
+    size_t index = 0;
+
+    for (EntryMetadata& metadata : entry_cache_) {
+      if (index++ < step_gc_next_entry_) {
+        continue;
+      }
+
+      Status status = RelocateKeyAddressesInSector(
+          sector, metadata, {}, RelocationSpace::kExcludingFreeSector);
+
+      if (status.IsResourceExhausted()) {
+        // Relocating would use the free sector, which must stay available
+        // between steps. Garbage collect the remainder of the sector at once.
+        DBG("Step GC has no space outside the free sector, finishing sector");
+        step_gc_sector_ = nullptr;
+        return GarbageCollectSector(sector, {});
+      }
+      PW_TRY(status);
+      step_gc_next_entry_ = index;
+
+      if (initial_valid_bytes - sector.valid_bytes() >= max_bytes_to_relocate) {
+        return OkStatus();
+      }
+    }
+
+    if (sector.valid_bytes() != 0) {
+      ERR("  Failed to relocate valid entries from sector being garbage "
+          "collected, %u valid bytes remain",
+          unsigned(sector.valid_bytes()));
+      step_gc_sector_ = nullptr;
+      return Status::Internal();
+    }
+    return OkStatus();
+  }
+
+  // Step 2: Reinitialize the sector.
+  step_gc_sector_ = nullptr;
+  PW_TRY(EraseSectorWithNoValidEntries(sector));
+  DBG("Step GC of sector %u complete", sectors_.Index(sector));
+  return OkStatus();
+}
+
+Status KeyValueStore::WriteCheckpoint() {
+  if (!initialized() || error_detected_) {
+    return Status::FailedPrecondition();
+  }
+
+  // The checkpoint saves the sector descriptors, which must not change after
+  // it is written.
+  PW_TRY(FinishBackgroundErase());
+
+  // Only the latest checkpoint may exist, so erase the previous one first.
+  PW_TRY(DiscardCheckpoint());
+
+  const size_t sector_size_bytes = partition_.sector_size_bytes();
+  const CheckpointHeader header{
+      .sector_count = uint32_t(sectors_.size()),
+      .sector_size_bytes = uint32_t(sector_size_bytes),
+      .redundancy = uint32_t(redundancy()),
+      .entry_count = uint32_t(entry_cache_.total_entries()),
+  };
+  const std::span<const byte> value_chunks[] = {
+      std::as_bytes(std::span(&header, 1)),
+      std::as_bytes(std::span(&*sectors_.begin(), sectors_.size())),
+      std::as_bytes(entry_cache_.descriptors()),
+      std::as_bytes(entry_cache_.address_lists()),
+  };
+
+  size_t value_size = 0;
+  for (const std::span<const byte>& chunk : value_chunks) {
+    value_size += chunk.size();
+  }
+  if (value_size > max_key_value_size_bytes()) {
+    DBG("Checkpoint of %u B does not fit in a sector", unsigned(value_size));
+    return Status::ResourceExhausted();
+  }
+
+  // The checkpoint is written to an empty sector, and another empty sector
+  // must remain to be the always free sector.
+  SectorDescriptor* checkpoint_sector = nullptr;
+  size_t empty_sectors = 0;
+  for (SectorDescriptor& sector : sectors_) {
+    if (sector.Empty(sector_size_bytes)) {
+      empty_sectors += 1;
+      if (checkpoint_sector == nullptr) {
+        checkpoint_sector = &sector;
+      }
+    }
+  }
+  if (empty_sectors < 2u) {
+    DBG("No empty sector is available for a checkpoint");
+    return Status::ResourceExhausted();
+  }
+
+  // The checkpoint sector is not writable while it holds the checkpoint. Mark
+  // it as such before writing, so the checkpoint records that state.
+  checkpoint_sector->set_writable_bytes(0);
+
+  const Entry entry =
+      Entry::Checkpoint(partition_,
+                        sectors_.BaseAddress(*checkpoint_sector),
+                        formats_.primary(),
+                        value_chunks,
+                        last_transaction_id_ + 1);
+  DBG("Writing %u B checkpoint to sector %u",
+      unsigned(entry.size()),
+      sectors_.Index(checkpoint_sector));
+
+  Status status = entry.WriteCheckpoint(value_chunks).status();
+  if (status.ok() && options_.verify_on_write) {
+    status = entry.VerifyChecksumInFlash();
+  }
+  if (!status.ok()) {
+    // The checkpoint sector contents are unknown, so treat it as corrupt.
+    return MarkSectorCorruptIfNotOk(status, checkpoint_sector);
+  }
+
+  last_transaction_id_ += 1;
+  checkpoint_sector_ = checkpoint_sector;
+  return OkStatus();
+}
+
+Status KeyValueStore::LoadCheckpoint() {
+  checkpoint_sector_ = nullptr;
+
+  // The sector descriptors are empty before the first Init, so reset them to
+  // have one per sector in the partition.
+  sectors_.Reset();
+
+  // A checkpoint is always the first entry in its sector, so only the first
+  // entry of each sector needs to be checked to find it.
+  SectorDescriptor* checkpoint_sector = nullptr;
+  Entry checkpoint;
+  for (SectorDescriptor& sector : sectors_) {
+    Entry entry;
+    if (ReadCheckpointEntry(sector, &entry).ok() &&
+        (checkpoint_sector == nullptr ||
+         entry.transaction_id() > checkpoint.transaction_id())) {
+      checkpoint_sector = &sector;
+      checkpoint = entry;
+    }
+  }
+  if (checkpoint_sector == nullptr) {
+    return Status::NotFound();
+  }
+
+  DBG("Found checkpoint in sector %u", sectors_.Index(checkpoint_sector));
+  PW_TRY(checkpoint.VerifyChecksumInFlash());
+
+  // The checkpoint only matches the flash contents if nothing was written to
+  // its sector after it.
+  const Address sector_end =
+      sectors_.BaseAddress(*checkpoint_sector) + partition_.sector_size_bytes();
+  bool erased = false;
+  PW_TRY(partition_.IsRegionErased(checkpoint.next_address(),
+                                   sector_end - checkpoint.next_address(),
+                                   &erased));
+  if (!erased) {
+    DBG("Checkpoint is followed by other data");
+    return Status::DataLoss();
+  }
+
+  Status status = RestoreCheckpoint(checkpoint);
+  if (!status.ok()) {
+    sectors_.Reset();
+    entry_cache_.Reset();
+    return status;
+  }
+
+  checkpoint_sector_ = &sectors_.FromAddress(checkpoint.address());
+  last_transaction_id_ = checkpoint.transaction_id();
+  return OkStatus();
+}
+
+Status KeyValueStore::RestoreCheckpoint(const Entry& checkpoint) {
+  const size_t sector_size_bytes = partition_.sector_size_bytes();
+  Address address = checkpoint.address() + sizeof(internal::EntryHeader);
+
+  CheckpointHeader header;
+  PW_TRY(partition_.Read(address, sizeof(header), &header));
+  address += sizeof(header);
+
+  // The checkpoint must be for the current KVS configuration.
+  if (header.sector_count != partition_.sector_count() ||
+      header.sector_size_bytes != sector_size_bytes ||
+      header.redundancy != redundancy() ||
+      header.entry_count > entry_cache_.max_entries() ||
+      checkpoint.value_size() !=
+          sizeof(header) + header.sector_count * sizeof(SectorDescriptor) +
+              header.entry_count *
+                  (sizeof(KeyDescriptor) + redundancy() * sizeof(Address))) {
+    DBG("Checkpoint does not match the KVS configuration");
+    return Status::FailedPrecondition();
+  }
+
+  sectors_.Reset();
+  entry_cache_.Reset();
+
+  bool empty_sector_found = false;
+  const SectorDescriptor& checkpoint_sector =
+      sectors_.FromAddress(checkpoint.address());
+
+  for (SectorDescriptor& sector : sectors_) {
+    PW_TRY(partition_.Read(address, sizeof(sector), &sector));
+    address += sizeof(sector);
+
+    if (sector.corrupt() || sector.writable_bytes() > sector_size_bytes ||
+        sector.valid_bytes() > sector_size_bytes - sector.writable_bytes()) {
+      return Status::DataLoss();
+    }
+    if (&sector == &checkpoint_sector) {
+      if (sector.writable_bytes() != 0u || sector.valid_bytes() != 0u) {
+        return Status::DataLoss();
+      }
+      continue;
+    }
+
+    // As a check that the checkpoint matches the flash contents, each sector's
+    // writable space must start with erased flash.
+    if (sector.writable_bytes() > 0u) {
+      std::array<byte, Entry::kMinAlignmentBytes> next_data;
+      PW_TRY(partition_.Read(sectors_.NextWritableAddress(sector), next_data));
+      if (!partition_.AppearsErased(next_data)) {
+        DBG("Sector %u was written after the checkpoint",
+            sectors_.Index(sector));
+        return Status::DataLoss();
+      }
+    }
+    if (sector.Empty(sector_size_bytes)) {
+      empty_sector_found = true;
+    }
+  }
+
+  if (!empty_sector_found) {
+    return Status::DataLoss();
+  }
+
+  // Read each descriptor and its addresses. The temporary address buffer has
+  // room for redundancy() addresses.
+  Address* const addresses = entry_cache_.TempReservedAddressesForWrite();
+  const Address descriptors_end =
+      address + header.entry_count * sizeof(KeyDescriptor);
+  Address addresses_address = descriptors_end;
+  uint32_t newest_transaction_id = 0;
+  Address newest_address = 0;
+
+  for (Address descriptor_address = address;
+       descriptor_address < descriptors_end;
+       descriptor_address += sizeof(KeyDescriptor)) {
+    KeyDescriptor descriptor;
+    PW_TRY(partition_.Read(descriptor_address, sizeof(descriptor), &descriptor));
+    PW_TRY(partition_.Read(
+        addresses_address, redundancy() * sizeof(Address), addresses));
+    addresses_address += redundancy() * sizeof(Address);
+
+    if (descriptor.transaction_id >= checkpoint.transaction_id() ||
+        addresses[0] >= partition_.size_bytes()) {
+      return Status::DataLoss();
+    }
+
+    EntryMetadata metadata = entry_cache_.AddNew(descriptor, addresses[0]);
+    for (size_t i = 1; i < redundancy(); ++i) {
+      if (addresses[i] < partition_.size_bytes()) {
+        metadata.AddNewAddress(addresses[i]);
+      }
+    }
+
+    if (metadata.IsNewerThan(newest_transaction_id)) {
+      newest_transaction_id = metadata.transaction_id();
+      newest_address = metadata.addresses().back();
+    }
+  }
+
+  sectors_.set_last_new_sector(newest_address);
+  return OkStatus();
+}
+
+Status KeyValueStore::ReadCheckpointEntry(const SectorDescriptor& sector,
+                                          Entry* checkpoint) {
+  PW_TRY(Entry::Read(
+      partition_, sectors_.BaseAddress(sector), formats_, checkpoint));
+  if (!checkpoint->checkpoint()) {
+    return Status::NotFound();
+  }
+  return OkStatus();
+}
+
+Status KeyValueStore::DiscardCheckpoint() {
+  if (checkpoint_sector_ == nullptr) {
+    return OkStatus();
+  }
+  DBG("Discarding checkpoint in sector %u", sectors_.Index(checkpoint_sector_));
+  return EraseSectorWithNoValidEntries(*checkpoint_sector_);
+}
+
+Status KeyValueStore::FindSpaceForWrite(SectorDescriptor** sector,
+                                        size_t entry_size,
+                                        std::span<const Address> reserved) {
+  // Check whether a background erase finished without waiting for it. Wait for
+  // it only if its sector is needed.
+  Status erase_status = PollBackgroundErase();
+  if (!erase_status.ok() && !erase_status.IsUnavailable()) {
+    return erase_status;
+  }
+
+  Status result = sectors_.FindSpace(sector, entry_size, reserved);
+  if (result.IsResourceExhausted() && erase_status.IsUnavailable()) {
+    PW_TRY(FinishBackgroundErase());
+    result = sectors_.FindSpace(sector, entry_size, reserved);
+  }
+  return result;
+}
+
 Status KeyValueStore::GarbageCollect(
     std::span<const Address> reserved_addresses) {
   DBG("Garbage Collect a single sector");
+  IoScope io_scope(*this, IoCause::kGarbageCollection);
+
+  // The sector being erased may be the best sector to garbage collect.
+  PW_TRY(FinishBackgroundErase());
   for (Address address : reserved_addresses) {
     DBG("   Avoid address %u", unsigned(address));
   }
@@ -965,14 +1995,32 @@ Status KeyValueStore::GarbageCollect(
 
 Status KeyValueStore::RelocateKeyAddressesInSector(
     SectorDescriptor& sector_to_gc,
-    const EntryMetadata& metadata,
-    std::span<const Address> reserved_addresses) {
+    EntryMetadata& metadata,
+    std::span<const Address> reserved_addresses,
+    RelocationSpace space) {
+  // The older entries in a delta chain cannot be moved, since the newer entries
+  // refer to their addresses. Instead, the chain is compacted into a new entry.
+  if (metadata.delta_count() != 0u) {
+    Entry newest;
+    PW_TRY(ReadEntry(metadata, newest));
+
+    internal::DeltaChain chain;
+    PW_TRY(chain.Load(partition_, formats_, newest));
+
+    for (size_t i = 1; i < chain.addresses().size(); ++i) {
+      if (sectors_.AddressInSector(sector_to_gc, chain.addresses()[i])) {
+        return CompactDeltaChain(
+            metadata, &sector_to_gc, reserved_addresses, space);
+      }
+    }
+  }
+
   for (FlashPartition::Address& address : metadata.addresses()) {
     if (sectors_.AddressInSector(sector_to_gc, address)) {
       DBG("  Relocate entry for Key 0x%08" PRIx32 ", sector %u",
           metadata.hash(),
           sectors_.Index(sectors_.FromAddress(address)));
-      PW_TRY(RelocateEntry(metadata, address, reserved_addresses));
+      PW_TRY(RelocateEntry(metadata, address, reserved_addresses, space));
     }
   }
 
@@ -983,6 +2031,7 @@ Status KeyValueStore::GarbageCollectSector(
     SectorDescriptor& sector_to_gc,
     std::span<const Address> reserved_addresses) {
   DBG("  Garbage Collect sector %u", sectors_.Index(sector_to_gc));
+  IoScope io_scope(*this, IoCause::kGarbageCollection);
 
   // Step 1: Move any valid entries in the GC sector to other sectors
   if (sector_to_gc.valid_bytes() != 0) {
@@ -1000,22 +2049,109 @@ Status KeyValueStore::GarbageCollectSector(
   }
 
   // Step 2: Reinitialize the sector
-  if (!sector_to_gc.Empty(partition_.sector_size_bytes())) {
-    sector_to_gc.mark_corrupt();
+  PW_TRY(EraseSectorWithNoValidEntries(sector_to_gc));
+
+  DBG("  Garbage Collect sector %u complete", sectors_.Index(sector_to_gc));
+  return OkStatus();
+}
+
+Status KeyValueStore::EraseSectorWithNoValidEntries(SectorDescriptor& sector) {
+  // Only one erase is in progress at a time. This may also finish erasing this
+  // sector.
+  PW_TRY(FinishBackgroundErase());
+
+  if (!sector.Empty(partition_.sector_size_bytes())) {
+    if (&sector != checkpoint_sector_) {
+      PW_TRY(DiscardCheckpoint());
+    }
     internal_stats_.sector_erase_count++;
-    PW_TRY(partition_.Erase(sectors_.BaseAddress(sector_to_gc), 1));
-    sector_to_gc.set_writable_bytes(partition_.sector_size_bytes());
+    IoCounters* const counters = CurrentIoCounters();
+    if (counters != nullptr) {
+      counters->sector_erases += 1;
+    }
+
+    // The checkpoint sector is always erased before returning, since it is
+    // erased before other changes to flash.
+    if (options_.erase_in_background && &sector != checkpoint_sector_) {
+      DBG("Starting background erase of sector %u", sectors_.Index(sector));
+
+      // The sector is unwritable, not corrupt, while it is erased, so checking
+      // for errors during the erase does not report one.
+      sector.set_writable_bytes(0);
+      if (Status status =
+              partition_.StartErase(sectors_.BaseAddress(sector), 1);
+          !status.ok()) {
+        sector.mark_corrupt();
+        return status;
+      }
+      erasing_sector_ = &sector;
+
+      const Status status = PollBackgroundErase();
+      return status.IsUnavailable() ? OkStatus() : status;
+    }
+
+    sector.mark_corrupt();
+    PW_TRY(partition_.Erase(sectors_.BaseAddress(sector), 1));
+    sector.set_writable_bytes(partition_.sector_size_bytes());
+
+    if (&sector == checkpoint_sector_) {
+      checkpoint_sector_ = nullptr;
+    }
   }
+  return OkStatus();
+}
 
-  DBG("  Garbage Collect sector %u complete", sectors_.Index(sector_to_gc));
+Status KeyValueStore::PollBackgroundErase() {
+  if (erasing_sector_ == nullptr) {
+    return OkStatus();
+  }
+
+  const Status status = partition_.PollErase();
+  if (status.IsUnavailable()) {
+    return status;
+  }
+
+  SectorDescriptor& sector = *erasing_sector_;
+  erasing_sector_ = nullptr;
+  if (!status.ok()) {
+    // Mark the sector as corrupt, so it is garbage collected again.
+    ERR("Background erase of sector %u failed", sectors_.Index(sector));
+    sector.mark_corrupt();
+    return status;
+  }
+
+  DBG("Background erase of sector %u complete", sectors_.Index(sector));
+  sector.set_writable_bytes(partition_.sector_size_bytes());
   return OkStatus();
 }
 
+Status KeyValueStore::FinishBackgroundErase() {
+  Status status;
+  do {
+    status = PollBackgroundErase();
+  } while (status.IsUnavailable());
+  return status;
+}
+
 StatusWithSize KeyValueStore::UpdateEntriesToPrimaryFormat() {
   size_t entries_updated = 0;
   for (EntryMetadata& prior_metadata : entry_cache_) {
     Entry entry;
     PW_TRY_WITH_SIZE(ReadEntry(prior_metadata, entry));
+
+    // A delta chain is updated by compacting it into a new full entry. Space is
+    // found without garbage collection, which could compact the chain itself.
+    if (prior_metadata.delta_count() != 0u) {
+      bool on_primary;
+      PW_TRY_WITH_SIZE(DeltaChainOnPrimaryFormat(entry, &on_primary));
+      if (!on_primary) {
+        entries_updated++;
+        PW_TRY_WITH_SIZE(CompactDeltaChain(
+            prior_metadata, nullptr, {}, RelocationSpace::kExcludingFreeSector));
+      }
+      continue;
+    }
+
     if (formats_.primary().magic == entry.magic()) {
       // Ignore entries that are already on the primary format.
       continue;
@@ -1063,6 +2199,23 @@ StatusWithSize KeyValueStore::UpdateEntriesToPrimaryFormat() {
   return StatusWithSize(entries_updated);
 }
 
+Status KeyValueStore::DeltaChainOnPrimaryFormat(const Entry& newest,
+                                                bool* on_primary) {
+  internal::DeltaChain chain;
+  PW_TRY(chain.Load(partition_, formats_, newest));
+
+  const EntryFormat& primary = formats_.primary();
+  *on_primary = true;
+  for (Address address : chain.addresses()) {
+    Entry entry;
+    PW_TRY(Entry::Read(partition_, address, formats_, &entry));
+    if (entry.magic() != primary.magic && entry.magic() != primary.delta_magic) {
+      *on_primary = false;
+    }
+  }
+  return OkStatus();
+}
+
 // Add any missing redundant entries/copies for a key.
 Status KeyValueStore::AddRedundantEntries(EntryMetadata& metadata) {
   Entry entry;
@@ -1140,6 +2293,7 @@ Status KeyValueStore::EnsureFreeSectorExists() {
 }
 
 Status KeyValueStore::EnsureEntryRedundancy() {
+  IoScope io_scope(*this, IoCause::kRepair);
   Status repair_status = OkStatus();
 
   if (redundancy() == 1) {
@@ -1174,6 +2328,7 @@ Status KeyValueStore::EnsureEntryRedundancy() {
 }
 
 Status KeyValueStore::FixErrors() {
+  IoScope io_scope(*this, IoCause::kRepair);
   DBG("Fixing KVS errors");
 
   // Step 1: Garbage collect any sectors marked as corrupt.
@@ -1203,16 +2358,49 @@ Status KeyValueStore::FixErrors() {
 }
 
 Status KeyValueStore::Repair() {
+  IoScope io_scope(*this, IoCause::kRepair);
   // If errors have been detected, just reinit the KVS metadata. This does a
   // full deep error check and any needed repairs. Then repair any errors.
   INF("Starting KVS repair");
 
   DBG("Reinitialize KVS metadata");
+  FinishBackgroundErase();
   InitializeMetadata();
 
   return FixErrors();
 }
 
+void KeyValueStore::SetIoCause(IoCause cause) {
+  const size_t bytes_read = partition_.bytes_read();
+  const size_t bytes_written = partition_.bytes_written();
+
+  IoCounters* const counters = CurrentIoCounters();
+  if (counters != nullptr) {
+    counters->bytes_read += bytes_read - io_bytes_read_mark_;
+    counters->bytes_written += bytes_written - io_bytes_written_mark_;
+  }
+
+  io_bytes_read_mark_ = bytes_read;
+  io_bytes_written_mark_ = bytes_written;
+  io_cause_ = cause;
+}
+
+KeyValueStore::IoCounters* KeyValueStore::CurrentIoCounters() {
+  switch (io_cause_) {
+    case IoCause::kPut:
+      return &io_stats_.put;
+    case IoCause::kGarbageCollection:
+      return &io_stats_.garbage_collection;
+    case IoCause::kRepair:
+      return &io_stats_.repair;
+    case IoCause::kInit:
+      return &io_stats_.init;
+    case IoCause::kNone:
+      break;
+  }
+  return nullptr;
+}
+
 KeyValueStore::Entry KeyValueStore::CreateEntry(Address address,
                                                 Key key,
                                                 std::span<const byte> value,
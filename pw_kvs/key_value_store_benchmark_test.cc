@@ -0,0 +1,287 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Benchmarks KeyValueStore operations over a FakeFlashMemory. Flash operation
+// times are simulated with latency models, so the results are deterministic and
+// reflect the flash operations the KVS performs rather than the speed of the
+// host. For each model, reports p50 and p99 Put, Get, and Delete latency, write
+// amplification (bytes programmed per byte of key and value written), and how
+// often garbage collection erases a sector.
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_status/try.h"
+#include "pw_string/string_builder.h"
+
+namespace pw::kvs {
+namespace {
+
+// Time taken by each type of flash operation.
+struct LatencyModel {
+  const char* name;
+  uint32_t read_setup_ns;
+  uint32_t read_ns_per_byte;
+  uint32_t program_setup_ns;
+  uint32_t program_ns_per_byte;
+  uint32_t erase_ns_per_sector;
+};
+
+// Approximate timings from typical datasheet values.
+constexpr LatencyModel kLatencyModels[] = {
+    {
+        .name = "Internal MCU flash",
+        .read_setup_ns = 50,
+        .read_ns_per_byte = 10,
+        .program_setup_ns = 1'000,
+        .program_ns_per_byte = 4'000,
+        .erase_ns_per_sector = 20'000'000,
+    },
+    {
+        .name = "SPI NOR flash",
+        .read_setup_ns = 1'000,
+        .read_ns_per_byte = 40,
+        .program_setup_ns = 10'000,
+        .program_ns_per_byte = 2'700,
+        .erase_ns_per_sector = 45'000'000,
+    },
+};
+
+// FlashMemory that forwards operations to another FlashMemory and tracks the
+// simulated time and number of bytes programmed.
+class LatencyModelFlash : public FlashMemory {
+ public:
+  LatencyModelFlash(FlashMemory& flash, const LatencyModel& model)
+      : FlashMemory(flash.sector_size_bytes(),
+                    flash.sector_count(),
+                    flash.alignment_bytes()),
+        flash_(flash),
+        model_(model),
+        elapsed_ns_(0),
+        bytes_programmed_(0) {}
+
+  Status Enable() override { return flash_.Enable(); }
+
+  Status Disable() override { return flash_.Disable(); }
+
+  bool IsEnabled() const override { return flash_.IsEnabled(); }
+
+  Status Erase(Address address, size_t num_sectors) override {
+    elapsed_ns_ += uint64_t(model_.erase_ns_per_sector) * num_sectors;
+    return flash_.Erase(address, num_sectors);
+  }
+
+  StatusWithSize Read(Address address, std::span<std::byte> output) override {
+    elapsed_ns_ +=
+        model_.read_setup_ns + uint64_t(model_.read_ns_per_byte) * output.size();
+    return flash_.Read(address, output);
+  }
+
+  StatusWithSize Write(Address address,
+                       std::span<const std::byte> data) override {
+    elapsed_ns_ += model_.program_setup_ns +
+                   uint64_t(model_.program_ns_per_byte) * data.size();
+    bytes_programmed_ += data.size();
+    return flash_.Write(address, data);
+  }
+
+  std::byte* FlashAddressToMcuAddress(Address address) const override {
+    return flash_.FlashAddressToMcuAddress(address);
+  }
+
+  uint64_t elapsed_ns() const { return elapsed_ns_; }
+
+  size_t bytes_programmed() const { return bytes_programmed_; }
+
+ private:
+  FlashMemory& flash_;
+  const LatencyModel& model_;
+  uint64_t elapsed_ns_;
+  size_t bytes_programmed_;
+};
+
+// Latencies of one type of operation.
+class Latencies {
+ public:
+  void Add(uint64_t ns) { ns_.push_back(ns); }
+
+  size_t count() const { return ns_.size(); }
+
+  // Returns the latency below which the given percent of operations fall.
+  uint64_t Percentile(unsigned percent) {
+    if (ns_.empty()) {
+      return 0;
+    }
+    std::sort(ns_.begin(), ns_.end());
+    return ns_[(ns_.size() - 1) * percent / 100];
+  }
+
+ private:
+  std::vector<uint64_t> ns_;
+};
+
+// Shape of the simulated workload.
+struct Workload {
+  size_t operations;
+  size_t keys;
+  size_t max_value_size;
+  unsigned put_percent;
+  unsigned delete_percent;  // The remaining operations are Gets.
+};
+
+constexpr Workload kWorkload = {
+    .operations = 2000,
+    .keys = 32,
+    .max_value_size = 128,
+    .put_percent = 30,
+    .delete_percent = 5,
+};
+
+struct BenchmarkResults {
+  Latencies put;
+  Latencies get;
+  Latencies remove;
+  size_t logical_bytes_written;
+  size_t bytes_programmed;
+  size_t sectors_erased;
+};
+
+// Deterministic pseudo-random numbers, so runs are comparable.
+class Lcg {
+ public:
+  uint32_t Next() {
+    state_ = state_ * 6364136223846793005u + 1442695040888963407u;
+    return uint32_t(state_ >> 33);
+  }
+
+ private:
+  uint64_t state_ = 1;
+};
+
+constexpr size_t kSectorSize = 1024;
+constexpr size_t kSectorCount = 8;
+
+// For KVS magic value always use a random 32 bit integer rather than a
+// human readable 4 bytes. See pw_kvs/format.h for more information.
+constexpr EntryFormat kFormat{.magic = 0x7b1c2a46, .checksum = nullptr};
+
+// Runs the workload on an empty KVS. Returns an error if a KVS operation does
+// not have the expected result.
+Status RunBenchmark(const LatencyModel& model,
+                    const Workload& workload,
+                    BenchmarkResults& results) {
+  FakeFlashMemoryBuffer<kSectorSize, kSectorCount> fake_flash(16);
+  LatencyModelFlash flash(fake_flash, model);
+  FlashPartition partition(&flash);
+  PW_TRY(partition.Erase());
+
+  KeyValueStoreBuffer<64, kSectorCount> kvs(&partition, kFormat);
+  PW_TRY(kvs.Init());
+
+  std::array<std::byte, kWorkload.max_value_size> value;
+  if (workload.max_value_size > value.size()) {
+    return Status::InvalidArgument();
+  }
+  std::vector<bool> present(workload.keys);
+  Lcg random;
+
+  results.logical_bytes_written = 0;
+  const size_t starting_bytes_programmed = flash.bytes_programmed();
+  const size_t starting_erases = kvs.GetStorageStats().sector_erase_count;
+
+  for (size_t i = 0; i < workload.operations; ++i) {
+    const size_t key_index = random.Next() % workload.keys;
+    StringBuffer<16> key;
+    key.Format("key_%u", unsigned(key_index));
+
+    const unsigned operation = random.Next() % 100;
+    const uint64_t start_ns = flash.elapsed_ns();
+
+    if (operation < workload.put_percent) {
+      const size_t size = 1 + random.Next() % workload.max_value_size;
+      std::fill_n(value.begin(), size, std::byte(i));
+      PW_TRY(kvs.Put(key.view(), std::span(value).first(size)));
+      results.put.Add(flash.elapsed_ns() - start_ns);
+      results.logical_bytes_written += key.size() + size;
+      present[key_index] = true;
+    } else if (operation < workload.put_percent + workload.delete_percent) {
+      const Status status = kvs.Delete(key.view());
+      if (status != (present[key_index] ? OkStatus() : Status::NotFound())) {
+        return Status::Internal();
+      }
+      results.remove.Add(flash.elapsed_ns() - start_ns);
+      present[key_index] = false;
+    } else {
+      const Status status = kvs.Get(key.view(), value).status();
+      if (status != (present[key_index] ? OkStatus() : Status::NotFound())) {
+        return Status::Internal();
+      }
+      results.get.Add(flash.elapsed_ns() - start_ns);
+    }
+  }
+
+  results.bytes_programmed =
+      flash.bytes_programmed() - starting_bytes_programmed;
+  results.sectors_erased =
+      kvs.GetStorageStats().sector_erase_count - starting_erases;
+  return OkStatus();
+}
+
+void PrintLatencies(const char* operation, Latencies& latencies) {
+  std::printf("  %-6s %5zu ops  p50 %8.1f us  p99 %8.1f us\n",
+              operation,
+              latencies.count(),
+              latencies.Percentile(50) / 1000.0,
+              latencies.Percentile(99) / 1000.0);
+}
+
+TEST(KeyValueStoreBenchmark, LatencyModels) {
+  for (const LatencyModel& model : kLatencyModels) {
+    BenchmarkResults results;
+    ASSERT_EQ(OkStatus(), RunBenchmark(model, kWorkload, results));
+
+    std::printf("%s\n", model.name);
+    PrintLatencies("Put", results.put);
+    PrintLatencies("Get", results.get);
+    PrintLatencies("Delete", results.remove);
+
+    const double write_amplification =
+        double(results.bytes_programmed) / results.logical_bytes_written;
+    std::printf("  Write amplification: %.2f B programmed per logical B\n",
+                write_amplification);
+    std::printf("  GC: %zu sectors erased, %.1f per 1000 Puts\n",
+                results.sectors_erased,
+                results.sectors_erased * 1000.0 / results.put.count());
+
+    // Sanity checks on the results. Tighten these to catch regressions.
+    EXPECT_GT(results.put.count(), 0u);
+    EXPECT_GT(results.get.count(), 0u);
+    EXPECT_GT(results.remove.count(), 0u);
+    EXPECT_LE(results.put.Percentile(50), results.put.Percentile(99));
+    EXPECT_LE(results.get.Percentile(50), results.get.Percentile(99));
+    EXPECT_GE(write_amplification, 1.0);
+    EXPECT_GT(results.sectors_erased, 0u);
+  }
+}
+
+}  // namespace
+}  // namespace pw::kvs
@@ -77,14 +77,16 @@ template <uint32_t (*kChecksum)(std::span<const byte>,
 constexpr auto MakeValidEntry(uint32_t magic,
                               uint32_t id,
                               const char (&key)[kKeyLengthWithNull],
-                              const std::array<byte, kValueSize>& value) {
+                              const std::array<byte, kValueSize>& value,
+                              internal::Entry::BatchState batch_state =
+                                  internal::Entry::BatchState::kNone) {
   constexpr size_t kKeyLength = kKeyLengthWithNull - 1;
 
   auto data =
       bytes::Concat(magic,
                     uint32_t(0),
                     uint8_t(kAlignmentBytes / 16 - 1),
-                    uint8_t(kKeyLength),
+                    uint8_t(kKeyLength | uint8_t(batch_state)),
                     uint16_t(kValueSize),
                     id,
                     bytes::String(key),
@@ -348,6 +350,204 @@ TEST_F(KvsErrorHandling, Init_CorruptKey_RevertsToPreviousVersion) {
   EXPECT_EQ(32u, kvs_.GetStorageStats().in_use_bytes);
 }
 
+constexpr auto kBatchMember = internal::Entry::BatchState::kMember;
+constexpr auto kBatchCommit = internal::Entry::BatchState::kCommit;
+
+TEST_F(KvsErrorHandling, GetMapped_CorruptValue_ReturnsDataLoss) {
+  InitFlashTo(bytes::Concat(kEntry1, kEntry2));
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+
+  // Corrupt the value of key1 after Init has verified it.
+  flash_.buffer()[20] = byte(0xef);
+
+  std::span<const byte> mapped;
+  EXPECT_EQ(Status::DataLoss(), kvs_.GetMapped("key1", &mapped));
+
+  ASSERT_EQ(OkStatus(), kvs_.GetMapped("k2", &mapped));
+  ASSERT_EQ(6u, mapped.size());
+  EXPECT_EQ(0, std::memcmp("value2", mapped.data(), mapped.size()));
+}
+
+TEST_F(KvsErrorHandling, Init_CommittedBatch_LoadsAllEntries) {
+  InitFlashTo(bytes::Concat(
+      kEntry1,
+      MakeValidEntry(kMagic, 7, "key1", bytes::String("new1"), kBatchMember),
+      MakeValidEntry(kMagic, 7, "k2", bytes::String("new2"), kBatchCommit)));
+
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+  EXPECT_EQ(2u, kvs_.size());
+  EXPECT_EQ(7u, kvs_.transaction_count());
+
+  char buffer[64] = {};
+  ASSERT_EQ(OkStatus(), kvs_.Get("key1", std::as_writable_bytes(std::span(buffer))).status());
+  EXPECT_STREQ("new1", buffer);
+  ASSERT_EQ(OkStatus(), kvs_.Get("k2", std::as_writable_bytes(std::span(buffer))).status());
+  EXPECT_STREQ("new2", buffer);
+
+  EXPECT_EQ(64u, kvs_.GetStorageStats().in_use_bytes);
+}
+
+TEST_F(KvsErrorHandling, Init_UncommittedBatch_IsDiscarded) {
+  InitFlashTo(bytes::Concat(
+      kEntry1,
+      MakeValidEntry(kMagic, 7, "key1", bytes::String("new1"), kBatchMember),
+      MakeValidEntry(kMagic, 7, "k2", bytes::String("new2"), kBatchMember)));
+
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+  EXPECT_EQ(1u, kvs_.size());
+
+  char buffer[64] = {};
+  ASSERT_EQ(OkStatus(), kvs_.Get("key1", std::as_writable_bytes(std::span(buffer))).status());
+  EXPECT_STREQ("value1", buffer);
+  EXPECT_EQ(Status::NotFound(), kvs_.Get("k2", std::span<byte>()).status());
+
+  auto stats = kvs_.GetStorageStats();
+  EXPECT_EQ(32u, stats.in_use_bytes);
+  EXPECT_EQ(64u, stats.reclaimable_bytes);
+}
+
+TEST_F(KvsErrorHandling, Init_BatchWithCorruptEntry_IsDiscarded) {
+  InitFlashTo(bytes::Concat(
+      kEntry1,
+      MakeValidEntry(kMagic, 7, "key1", bytes::String("new1"), kBatchMember),
+      MakeValidEntry(kMagic, 7, "k2", bytes::String("new2"), kBatchCommit)));
+
+  // Corrupt a byte of the first batch entry (addresses 32-63).
+  flash_.buffer()[50] = byte(0xef);
+
+  ASSERT_EQ(Status::DataLoss(), kvs_.Init());
+  EXPECT_EQ(1u, kvs_.size());
+
+  char buffer[64] = {};
+  ASSERT_EQ(OkStatus(), kvs_.Get("key1", std::as_writable_bytes(std::span(buffer))).status());
+  EXPECT_STREQ("value1", buffer);
+  EXPECT_EQ(Status::NotFound(), kvs_.Get("k2", std::span<byte>()).status());
+}
+
+TEST_F(KvsErrorHandling, PutBatch_WriteFailure_KeepsPriorValues) {
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+  ASSERT_EQ(OkStatus(), kvs_.Put("key1", bytes::String("value1")));
+
+  // Fail writing the commit entry, which is the second entry in the batch.
+  flash_.InjectWriteError(
+      FlashError::Unconditional(Status::Unavailable(), 1, 1));
+
+  KeyValueStore::Batch<2> batch;
+  ASSERT_EQ(OkStatus(), batch.Put("key1", bytes::String("new1")));
+  ASSERT_EQ(OkStatus(), batch.Put("k2", bytes::String("new2")));
+  EXPECT_EQ(Status::Unavailable(), kvs_.PutBatch(batch));
+  EXPECT_EQ(true, kvs_.error_detected());
+
+  char buffer[64] = {};
+  ASSERT_EQ(OkStatus(),
+            kvs_.Get("key1", std::as_writable_bytes(std::span(buffer)))
+                .status());
+  EXPECT_STREQ("value1", buffer);
+  EXPECT_EQ(Status::NotFound(), kvs_.Get("k2", std::span<byte>()).status());
+  EXPECT_EQ(1u, kvs_.size());
+  EXPECT_EQ(32u, kvs_.GetStorageStats().in_use_bytes);
+}
+
+TEST_F(KvsErrorHandling, Checkpoint_InitRestoresStateWithoutReadingEntries) {
+  constexpr auto kEntry1New =
+      MakeValidEntry(kMagic, 4, "key1", bytes::String("new1"));
+  InitFlashTo(bytes::Concat(kEntry1, kEntry2, kEntry1New));
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+  const auto stats = kvs_.GetStorageStats();
+
+  ASSERT_EQ(OkStatus(), kvs_.WriteCheckpoint());
+
+  // Corrupt the stale entry for key1. Reading all entries would detect this.
+  flash_.buffer()[20] = byte(0xef);
+
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+  EXPECT_EQ(2u, kvs_.size());
+  EXPECT_EQ(5u, kvs_.transaction_count());
+  EXPECT_EQ(stats.in_use_bytes, kvs_.GetStorageStats().in_use_bytes);
+
+  char buffer[64] = {};
+  ASSERT_EQ(OkStatus(),
+            kvs_.Get("key1", std::as_writable_bytes(std::span(buffer)))
+                .status());
+  EXPECT_STREQ("new1", buffer);
+  ASSERT_EQ(OkStatus(),
+            kvs_.Get("k2", std::as_writable_bytes(std::span(buffer))).status());
+  EXPECT_STREQ("value2", buffer);
+}
+
+TEST_F(KvsErrorHandling, Checkpoint_UsedByNewKvsAfterRestart) {
+  constexpr auto kEntry1New =
+      MakeValidEntry(kMagic, 4, "key1", bytes::String("new1"));
+  InitFlashTo(bytes::Concat(kEntry1, kEntry2, kEntry1New));
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+  ASSERT_EQ(OkStatus(), kvs_.WriteCheckpoint());
+
+  // Corrupt the stale entry for key1. Reading all entries would detect this.
+  flash_.buffer()[20] = byte(0xef);
+
+  // A KVS that was never initialized, as after a reboot, finds the checkpoint.
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> restarted_kvs(
+      &partition_, default_format, kNoGcOptions);
+  ASSERT_EQ(OkStatus(), restarted_kvs.Init());
+  EXPECT_EQ(2u, restarted_kvs.size());
+  EXPECT_EQ(5u, restarted_kvs.transaction_count());
+
+  char buffer[64] = {};
+  ASSERT_EQ(OkStatus(),
+            restarted_kvs.Get("key1", std::as_writable_bytes(std::span(buffer)))
+                .status());
+  EXPECT_STREQ("new1", buffer);
+}
+
+TEST_F(KvsErrorHandling, Checkpoint_DiscardedBeforeWrite) {
+  InitFlashTo(bytes::Concat(kEntry1, kEntry2));
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+  ASSERT_EQ(OkStatus(), kvs_.WriteCheckpoint());
+
+  // The checkpoint may be rewritten, replacing the old one.
+  ASSERT_EQ(OkStatus(), kvs_.WriteCheckpoint());
+  EXPECT_EQ(1u, kvs_.GetStorageStats().sector_erase_count);
+
+  ASSERT_EQ(OkStatus(), kvs_.Put("k3y", bytes::String("value3")));
+  EXPECT_EQ(2u, kvs_.GetStorageStats().sector_erase_count);
+
+  // Corrupt kEntry1, which the KVS must read since there is no checkpoint.
+  flash_.buffer()[20] = byte(0xef);
+
+  EXPECT_EQ(Status::DataLoss(), kvs_.Init());
+  EXPECT_EQ(2u, kvs_.size());
+  char buffer[64] = {};
+  ASSERT_EQ(OkStatus(),
+            kvs_.Get("k3y", std::as_writable_bytes(std::span(buffer)))
+                .status());
+  EXPECT_STREQ("value3", buffer);
+}
+
+TEST_F(KvsErrorHandling, Checkpoint_NotUsedIfFlashChanged) {
+  InitFlashTo(bytes::Concat(kEntry1, kEntry2));
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+  ASSERT_EQ(OkStatus(), kvs_.WriteCheckpoint());
+
+  // Write an entry without the KVS, as if by a different program.
+  ASSERT_EQ(OkStatus(), partition_.Write(64, kEntry3).status());
+
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+  EXPECT_EQ(3u, kvs_.size());
+  char buffer[64] = {};
+  ASSERT_EQ(OkStatus(),
+            kvs_.Get("k3y", std::as_writable_bytes(std::span(buffer)))
+                .status());
+  EXPECT_STREQ("value3", buffer);
+}
+
+TEST_F(KvsErrorHandling, Checkpoint_RequiresInitializedKvs) {
+  EXPECT_EQ(Status::FailedPrecondition(), kvs_.WriteCheckpoint());
+
+  InitFlashTo(bytes::Concat(kEntry1, kEntry1));
+  ASSERT_EQ(Status::DataLoss(), kvs_.Init());
+  EXPECT_EQ(Status::FailedPrecondition(), kvs_.WriteCheckpoint());
+}
+
 // The Put_WriteFailure_EntryNotAddedButBytesMarkedWritten test is run with both
 // the KvsErrorRecovery and KvsErrorHandling test fixtures (different KVS
 // configurations).
@@ -0,0 +1,334 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <span>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/internal/entry.h"
+#include "pw_kvs/key_value_store.h"
+
+namespace pw::kvs {
+namespace {
+
+using std::byte;
+
+constexpr size_t kMaxEntries = 32;
+constexpr size_t kSectors = 8;
+constexpr size_t kSectorSize = 512;
+constexpr size_t kValueSize = 300;
+constexpr size_t kMaxDeltas = 4;
+
+ChecksumCrc16 checksum;
+
+// For KVS magic value always use a random 32 bit integer rather than a
+// human readable 4 bytes. See pw_kvs/format.h for more information.
+const EntryFormat delta_format{.magic = 0x5a1b9c3e,
+                               .checksum = &checksum,
+                               .delta_magic = 0xc2e87d41,
+                               .max_delta_chain_length = kMaxDeltas};
+
+using Value = std::array<byte, kValueSize>;
+
+Value MakeValue(uint8_t seed) {
+  Value value;
+  for (size_t i = 0; i < value.size(); ++i) {
+    value[i] = byte(seed + i * 7);
+  }
+  return value;
+}
+
+template <size_t kRedundancy>
+class DeltaTest : public ::testing::Test {
+ protected:
+  DeltaTest()
+      : flash_(internal::Entry::kMinAlignmentBytes),
+        partition_(&flash_),
+        kvs_(&partition_, delta_format, options()) {}
+
+  void SetUp() override {
+    ASSERT_EQ(OkStatus(), partition_.Erase());
+    ASSERT_EQ(OkStatus(), kvs_.Init());
+  }
+
+  static constexpr Options options() {
+    return {.gc_on_write = GargbageCollectOnWrite::kAsManySectorsNeeded};
+  }
+
+  size_t in_use_bytes() const { return kvs_.GetStorageStats().in_use_bytes; }
+
+  size_t full_entry_size(Key key) const {
+    return internal::Entry::size(partition_, key, kValueSize);
+  }
+
+  void ExpectValue(Key key, const Value& expected) {
+    Value value;
+    StatusWithSize result = kvs_.Get(key, std::as_writable_bytes(std::span(value)));
+    ASSERT_EQ(OkStatus(), result.status());
+    ASSERT_EQ(kValueSize, result.size());
+    EXPECT_EQ(0, std::memcmp(value.data(), expected.data(), kValueSize));
+
+    EXPECT_EQ(kValueSize, kvs_.ValueSize(key).size());
+  }
+
+  // Writes small changes to several large values, which garbage collects every
+  // sector many times. The values must be intact after each write, and after the
+  // KVS is reinitialized.
+  template <size_t kKeyCount>
+  void RepeatedSmallChanges() {
+    constexpr const char* kKeys[] = {"one", "two", "three"};
+    static_assert(kKeyCount <= std::size(kKeys));
+    std::array<Value, kKeyCount> values;
+    for (size_t i = 0; i < values.size(); ++i) {
+      values[i] = MakeValue(20 + i);
+      ASSERT_EQ(OkStatus(), kvs_.Put(kKeys[i], values[i]));
+    }
+
+    uint32_t random = 1;
+    for (size_t write = 0; write < 200; ++write) {
+      random = random * 1103515245 + 12345;
+      const size_t index = (random >> 16) % values.size();
+      const size_t position = (random >> 8) % kValueSize;
+      values[index][position] = byte(random >> 24);
+
+      ASSERT_EQ(OkStatus(), kvs_.Put(kKeys[index], values[index]));
+      for (size_t i = 0; i < values.size(); ++i) {
+        ExpectValue(kKeys[i], values[i]);
+      }
+    }
+
+    // The sectors' valid bytes, which include the entries in delta chains, are
+    // counted the same way when the KVS is initialized.
+    const size_t in_use = in_use_bytes();
+    ASSERT_EQ(OkStatus(), kvs_.Init());
+    EXPECT_EQ(in_use, in_use_bytes());
+    for (size_t i = 0; i < values.size(); ++i) {
+      ExpectValue(kKeys[i], values[i]);
+    }
+    EXPECT_FALSE(kvs_.error_detected());
+  }
+
+  FakeFlashMemoryBuffer<kSectorSize, kSectors> flash_;
+  FlashPartition partition_;
+  KeyValueStoreBuffer<kMaxEntries, kSectors, kRedundancy> kvs_;
+};
+
+using DeltaEncoding = DeltaTest<1>;
+using DeltaEncodingRedundant = DeltaTest<2>;
+
+TEST_F(DeltaEncoding, SmallChange_WritesDelta) {
+  Value value = MakeValue(1);
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+  const size_t full_size = in_use_bytes();
+  EXPECT_EQ(full_entry_size("key"), full_size);
+
+  value[10] = byte(0);
+  value[200] = byte(0);
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+
+  // The delta is much smaller than the full value, and the full entry it
+  // applies to is still in use.
+  EXPECT_GT(in_use_bytes(), full_size);
+  EXPECT_LE(in_use_bytes(), full_size + 64);
+  ExpectValue("key", value);
+}
+
+TEST_F(DeltaEncoding, ChainOfDeltas_ReadsEachValue) {
+  Value value = MakeValue(2);
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+
+  for (size_t i = 0; i < kMaxDeltas; ++i) {
+    value[i * 50] = byte(0xa0 + i);
+    value[i * 50 + 40] = byte(0xb0 + i);
+    ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+    ExpectValue("key", value);
+  }
+  EXPECT_LT(in_use_bytes(), 2 * full_entry_size("key"));
+
+  // Once the chain is at its maximum length, the full value is written and the
+  // chain is stale.
+  value[1] = byte(0xcc);
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+  EXPECT_EQ(full_entry_size("key"), in_use_bytes());
+  ExpectValue("key", value);
+}
+
+TEST_F(DeltaEncoding, UnchangedValue_NotWritten) {
+  Value value = MakeValue(3);
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+  value[5] = byte(0x55);
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+
+  const KeyValueStore::StorageStats before = kvs_.GetStorageStats();
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+  const KeyValueStore::StorageStats after = kvs_.GetStorageStats();
+
+  EXPECT_EQ(before.in_use_bytes, after.in_use_bytes);
+  EXPECT_EQ(before.writable_bytes, after.writable_bytes);
+}
+
+TEST_F(DeltaEncoding, LargeChange_WritesFullValue) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", MakeValue(4)));
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", MakeValue(5)));
+
+  EXPECT_EQ(full_entry_size("key"), in_use_bytes());
+  ExpectValue("key", MakeValue(5));
+}
+
+TEST_F(DeltaEncoding, DifferentSize_WritesFullValue) {
+  Value value = MakeValue(6);
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+  value[0] = byte(0);
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", std::span(value).first(100)));
+  EXPECT_EQ(internal::Entry::size(partition_, "key", 100), in_use_bytes());
+  EXPECT_EQ(100u, kvs_.ValueSize("key").size());
+}
+
+TEST_F(DeltaEncoding, ReadWithOffset) {
+  Value value = MakeValue(7);
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+  for (size_t i = 0; i < value.size(); i += 40) {
+    value[i] = byte(0xee);
+  }
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+
+  std::array<byte, 64> buffer;
+  for (size_t offset = 0; offset < kValueSize; offset += buffer.size()) {
+    const size_t expected_size = std::min(buffer.size(), kValueSize - offset);
+    StatusWithSize result = kvs_.Get("key", buffer, offset);
+    EXPECT_EQ(expected_size, result.size());
+    EXPECT_EQ(0, std::memcmp(buffer.data(), &value[offset], expected_size));
+  }
+
+  // A buffer that is too small gets as much of the value as fits.
+  StatusWithSize result = kvs_.Get("key", std::span(buffer).first(10));
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(10u, result.size());
+  EXPECT_EQ(0, std::memcmp(buffer.data(), value.data(), 10));
+}
+
+TEST_F(DeltaEncoding, Delete_ReleasesChain) {
+  Value value = MakeValue(8);
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+  value[100] = byte(0);
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+
+  ASSERT_EQ(OkStatus(), kvs_.Delete("key"));
+  EXPECT_EQ(internal::Entry::size(partition_, "key", 0), in_use_bytes());
+  EXPECT_EQ(Status::NotFound(), kvs_.Get("key", value).status());
+}
+
+TEST_F(DeltaEncoding, GetMapped_Unimplemented) {
+  Value value = MakeValue(9);
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+
+  std::span<const byte> mapped;
+  ASSERT_EQ(OkStatus(), kvs_.GetMapped("key", &mapped));
+
+  value[100] = byte(0);
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+  EXPECT_EQ(Status::Unimplemented(), kvs_.GetMapped("key", &mapped));
+}
+
+TEST_F(DeltaEncoding, CorruptEntryInChain_DataLoss) {
+  Value value = MakeValue(10);
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+  value[250] = byte(0);
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+
+  // Corrupt a byte of the full entry's value that the delta does not replace.
+  const auto found = std::search(flash_.buffer().begin(),
+                                 flash_.buffer().end(),
+                                 &value[40],
+                                 &value[56]);
+  ASSERT_NE(found, flash_.buffer().end());
+  found[10] = ~found[10];
+
+  Value read_value;
+  EXPECT_EQ(Status::DataLoss(), kvs_.Get("key", read_value).status());
+}
+
+TEST_F(DeltaEncoding, Reinit_RestoresChain) {
+  Value value = MakeValue(11);
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+  value[20] = byte(0);
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+  value[220] = byte(0);
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+  const size_t in_use = in_use_bytes();
+
+  KeyValueStoreBuffer<kMaxEntries, kSectors> kvs(&partition_, delta_format);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  EXPECT_EQ(in_use, kvs.GetStorageStats().in_use_bytes);
+
+  Value read_value;
+  ASSERT_EQ(OkStatus(), kvs.Get("key", read_value).status());
+  EXPECT_EQ(0, std::memcmp(value.data(), read_value.data(), kValueSize));
+
+  // The reloaded chain continues to grow up to the limit.
+  value[120] = byte(0);
+  ASSERT_EQ(OkStatus(), kvs.Put("key", value));
+  EXPECT_GT(kvs.GetStorageStats().in_use_bytes, in_use);
+  EXPECT_LT(kvs.GetStorageStats().in_use_bytes, 2 * full_entry_size("key"));
+}
+
+TEST_F(DeltaEncoding, HeavyMaintenance_CompactsChainOnOldFormat) {
+  Value value = MakeValue(12);
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+  value[30] = byte(0);
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+
+  const EntryFormat formats[] = {
+      {.magic = 0x3d6b0f55, .checksum = &checksum}, delta_format};
+  KeyValueStoreBuffer<kMaxEntries, kSectors, 1, 2> kvs(&partition_, formats);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+
+  ASSERT_EQ(OkStatus(), kvs.HeavyMaintenance());
+  EXPECT_EQ(full_entry_size("key"), kvs.GetStorageStats().in_use_bytes);
+
+  Value read_value;
+  ASSERT_EQ(OkStatus(), kvs.Get("key", read_value).status());
+  EXPECT_EQ(0, std::memcmp(value.data(), read_value.data(), kValueSize));
+}
+
+TEST_F(DeltaEncoding, RepeatedSmallChanges_GarbageCollected) {
+  RepeatedSmallChanges<3>();
+}
+
+TEST_F(DeltaEncodingRedundant, SmallChange_WritesFullValue) {
+  Value value = MakeValue(9);
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+
+  value[10] = byte(0);
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", value));
+
+  // Each copy of the value is a full entry, since deltas are not redundant.
+  EXPECT_EQ(2 * full_entry_size("key"), in_use_bytes());
+  ExpectValue("key", value);
+}
+
+TEST_F(DeltaEncodingRedundant, RepeatedSmallChanges_GarbageCollected) {
+  RepeatedSmallChanges<2>();
+}
+
+}  // namespace
+}  // namespace pw::kvs
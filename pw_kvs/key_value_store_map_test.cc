@@ -63,6 +63,7 @@ enum Options {
   kReinit,
   kReinitWithFullGC,
   kReinitWithPartialGC,
+  kReinitWithStepGC,
 };
 
 template <typename T>
@@ -151,6 +152,8 @@ class KvsTester {
         GCFull();
       } else if (options == kReinitWithPartialGC && random_int() % 40 == 0) {
         GCPartial();
+      } else if (options == kReinitWithStepGC && random_int() % 10 == 0) {
+        GCStep(random_int() % 256);
       }
     }
 
@@ -164,6 +167,7 @@ class KvsTester {
       label << ((options != kNone) ? "Reinit" : "");
       label << ((options == kReinitWithFullGC) ? "FullGC" : "");
       label << ((options == kReinitWithPartialGC) ? "PartialGC" : "");
+      label << ((options == kReinitWithStepGC) ? "StepGC" : "");
       label << ((kvs_.redundancy() > 1) ? "Redundant" : "");
 
       partition_.SaveStorageStats(kvs_, label.data());
@@ -347,6 +351,20 @@ class KvsTester {
     FinishOperation("GCPartial", status);
   }
 
+  void GCStep(size_t max_bytes_to_relocate) {
+    StartOperation("GCStep");
+    KeyValueStore::StorageStats pre_stats = kvs_.GetStorageStats();
+    Status status = kvs_.StepMaintenance(max_bytes_to_relocate);
+    KeyValueStore::StorageStats post_stats = kvs_.GetStorageStats();
+    if (status.IsNotFound()) {
+      EXPECT_EQ(pre_stats.reclaimable_bytes, 0U);
+    } else {
+      EXPECT_EQ(OkStatus(), status);
+    }
+    EXPECT_EQ(post_stats.in_use_bytes, pre_stats.in_use_bytes);
+    FinishOperation("GCStep", status);
+  }
+
   // Logs that an operation started and checks that the KVS matches the map. If
   // a key is provided, that is included in the logs.
   void StartOperation(const std::string& operation,
@@ -457,6 +475,14 @@ FakeFlashMemoryBuffer<kParams.sector_size,
                 200,                                                          \
                 123,                                                          \
                 kReinitWithPartialGC);                                        \
+  _TEST_VARIANT(name,                                                         \
+                RandomValidInputs,                                            \
+                1ReinitStepGC,                                                \
+                300,                                                          \
+                6006411,                                                      \
+                kReinitWithStepGC);                                           \
+  _TEST_VARIANT(                                                              \
+      name, RandomValidInputs, 2ReinitStepGC, 300, 123, kReinitWithStepGC);   \
   static_assert(true, "Don't forget a semicolon!")
 
 RUN_TESTS_WITH_PARAMETERS(Basic,
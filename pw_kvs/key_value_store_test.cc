@@ -18,6 +18,7 @@
 
 #include "pw_kvs/key_value_store.h"
 
+#include <algorithm>
 #include <array>
 #include <cstdio>
 #include <cstring>
@@ -264,6 +265,448 @@ TEST(InMemoryKvs, WriteAndReadOneKey) {
   EXPECT_EQ(kvs.size(), 1u);
 }
 
+TEST(InMemoryKvs, GetMapped) {
+  // Create and erase the fake flash.
+  Flash flash;
+  ASSERT_OK(flash.partition.Erase());
+
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&flash.partition,
+                                                          default_format);
+  ASSERT_OK(kvs.Init());
+
+  constexpr char kValue[] = "a value in flash";
+  ASSERT_OK(kvs.Put("Key1", std::as_bytes(std::span(kValue))));
+
+  std::span<const std::byte> mapped;
+  ASSERT_OK(kvs.GetMapped("Key1", &mapped));
+  ASSERT_EQ(sizeof(kValue), mapped.size());
+  EXPECT_EQ(0, std::memcmp(kValue, mapped.data(), sizeof(kValue)));
+
+  // The span points directly into the flash memory.
+  const std::byte* flash_begin = flash.memory.buffer().data();
+  EXPECT_GE(mapped.data(), flash_begin);
+  EXPECT_LT(mapped.data(), flash_begin + flash.memory.buffer().size());
+
+  EXPECT_EQ(Status::NotFound(), kvs.GetMapped("Key2", &mapped));
+  ASSERT_OK(kvs.Delete("Key1"));
+  EXPECT_EQ(Status::NotFound(), kvs.GetMapped("Key1", &mapped));
+  EXPECT_EQ(Status::InvalidArgument(), kvs.GetMapped("", &mapped));
+}
+
+TEST(InMemoryKvs, ValueCache) {
+  // Create and erase the fake flash.
+  Flash flash;
+  ASSERT_OK(flash.partition.Erase());
+
+  ValueCacheBuffer<2, 32> cache;
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(
+      &flash.partition, default_format, {.value_cache = &cache});
+  ASSERT_OK(kvs.Init());
+
+  ASSERT_OK(kvs.Put("Key1", uint32_t(0xfeedbeef)));
+
+  uint32_t value = 0;
+  ASSERT_OK(kvs.Get("Key1", &value));
+  EXPECT_EQ(0xfeedbeefu, value);
+  EXPECT_EQ(0u, cache.hits());
+  EXPECT_EQ(1u, cache.misses());
+
+  // Corrupt the value in flash. Reads are served from the cache, so the
+  // corruption is not seen.
+  const uint32_t original = 0xfeedbeef;
+  const std::span<byte> buffer_in_flash = flash.memory.buffer();
+  auto value_in_flash =
+      std::search(buffer_in_flash.begin(),
+                  buffer_in_flash.end(),
+                  reinterpret_cast<const byte*>(&original),
+                  reinterpret_cast<const byte*>(&original + 1));
+  ASSERT_NE(value_in_flash, buffer_in_flash.end());
+  *value_in_flash = byte{0};
+
+  value = 0;
+  ASSERT_OK(kvs.Get("Key1", &value));
+  EXPECT_EQ(0xfeedbeefu, value);
+
+  std::array<byte, 4> buffer;
+  ASSERT_EQ(sizeof(value), kvs.Get("Key1", buffer).size());
+  EXPECT_EQ(0, std::memcmp(&value, buffer.data(), buffer.size()));
+
+  ASSERT_EQ(Status::ResourceExhausted(),
+            kvs.Get("Key1", std::span(buffer).first(2)).status());
+  EXPECT_EQ(3u, cache.hits());
+  EXPECT_EQ(1u, cache.misses());
+}
+
+TEST(InMemoryKvs, ValueCache_InvalidatedByPutAndDelete) {
+  // Create and erase the fake flash.
+  Flash flash;
+  ASSERT_OK(flash.partition.Erase());
+
+  ValueCacheBuffer<2, 32> cache;
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(
+      &flash.partition, default_format, {.value_cache = &cache});
+  ASSERT_OK(kvs.Init());
+
+  uint32_t value = 0;
+  ASSERT_OK(kvs.Put("Key1", uint32_t(1)));
+  ASSERT_OK(kvs.Get("Key1", &value));
+  ASSERT_OK(kvs.Get("Key1", &value));
+  EXPECT_EQ(1u, value);
+  EXPECT_EQ(1u, cache.hits());
+
+  ASSERT_OK(kvs.Put("Key1", uint32_t(2)));
+  ASSERT_OK(kvs.Get("Key1", &value));
+  EXPECT_EQ(2u, value);
+  EXPECT_EQ(1u, cache.hits());
+  EXPECT_EQ(2u, cache.misses());
+
+  ASSERT_OK(kvs.Delete("Key1"));
+  EXPECT_EQ(Status::NotFound(), kvs.Get("Key1", &value));
+}
+
+TEST(InMemoryKvs, ValueCache_InvalidatedByGarbageCollection) {
+  // Create and erase the fake flash.
+  Flash flash;
+  ASSERT_OK(flash.partition.Erase());
+
+  ValueCacheBuffer<2, 32> cache;
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(
+      &flash.partition, default_format, {.value_cache = &cache});
+  ASSERT_OK(kvs.Init());
+
+  uint32_t value = 0;
+  ASSERT_OK(kvs.Put("Key1", uint32_t(1)));
+  ASSERT_OK(kvs.Put("Key2", uint32_t(2)));
+  ASSERT_OK(kvs.Put("Key2", uint32_t(3)));
+  ASSERT_OK(kvs.Get("Key1", &value));
+
+  // Garbage collecting the sector relocates Key1.
+  ASSERT_OK(kvs.HeavyMaintenance());
+
+  ASSERT_OK(kvs.Get("Key1", &value));
+  EXPECT_EQ(1u, value);
+  EXPECT_EQ(0u, cache.hits());
+  EXPECT_EQ(2u, cache.misses());
+}
+
+constexpr const char* kPrefixTestKeys[] = {
+    "net/ip", "cfg/mode", "net/mask", "net", "cfg/net/ip", "network"};
+
+// Writes kPrefixTestKeys and returns the keys ForEachWithPrefix finds for
+// "net/" as bits, in the order of kPrefixTestKeys.
+uint32_t FindNetKeys(const KeyValueStore& kvs) {
+  uint32_t found = 0;
+  kvs.ForEachWithPrefix("net/", [&found](const KeyValueStore::Item& item) {
+    for (size_t i = 0; i < std::size(kPrefixTestKeys); ++i) {
+      if (std::strcmp(kPrefixTestKeys[i], item.key()) == 0) {
+        found |= 1u << i;
+      }
+    }
+  });
+  return found;
+}
+
+constexpr uint32_t kNetKeys = 0b101;
+
+TEST(InMemoryKvs, ForEachWithPrefix_WithoutIndex) {
+  Flash flash;
+  ASSERT_OK(flash.partition.Erase());
+
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&flash.partition,
+                                                          default_format);
+  ASSERT_OK(kvs.Init());
+  for (const char* key : kPrefixTestKeys) {
+    ASSERT_OK(kvs.Put(key, uint32_t(1)));
+  }
+  ASSERT_OK(kvs.Delete("net/mask"));
+
+  EXPECT_EQ(0b001u, FindNetKeys(kvs));
+
+  size_t count = 0;
+  kvs.ForEachWithPrefix("", [&count](const KeyValueStore::Item&) { count++; });
+  EXPECT_EQ(kvs.size(), count);
+}
+
+TEST(InMemoryKvs, ForEachWithPrefix_SkipsOtherNamespaces) {
+  Flash flash;
+  ASSERT_OK(flash.partition.Erase());
+
+  KeyPrefixIndexBuffer<kMaxEntries> index;
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(
+      &flash.partition, default_format, {.key_prefix_index = &index});
+  ASSERT_OK(kvs.Init());
+  for (const char* key : kPrefixTestKeys) {
+    ASSERT_OK(kvs.Put(key, uint32_t(1)));
+  }
+
+  EXPECT_EQ(kNetKeys, FindNetKeys(kvs));
+  EXPECT_EQ(4u, index.skipped_keys());
+
+  // A prefix without a namespace reads every key.
+  index.ResetCounters();
+  size_t count = 0;
+  kvs.ForEachWithPrefix("net", [&count](const KeyValueStore::Item&) {
+    count++;
+  });
+  EXPECT_EQ(4u, count);
+  EXPECT_EQ(0u, index.skipped_keys());
+}
+
+TEST(InMemoryKvs, ForEachWithPrefix_IndexRebuiltByInit) {
+  Flash flash;
+  ASSERT_OK(flash.partition.Erase());
+  {
+    KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&flash.partition,
+                                                            default_format);
+    ASSERT_OK(kvs.Init());
+    for (const char* key : kPrefixTestKeys) {
+      ASSERT_OK(kvs.Put(key, uint32_t(1)));
+    }
+  }
+
+  KeyPrefixIndexBuffer<kMaxEntries> index;
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(
+      &flash.partition, default_format, {.key_prefix_index = &index});
+  ASSERT_OK(kvs.Init());
+
+  EXPECT_EQ(kNetKeys, FindNetKeys(kvs));
+  EXPECT_EQ(4u, index.skipped_keys());
+}
+
+TEST(InMemoryKvs, ForEachWithPrefix_IndexFilledAfterCheckpoint) {
+  Flash flash;
+  ASSERT_OK(flash.partition.Erase());
+  {
+    KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&flash.partition,
+                                                            default_format);
+    ASSERT_OK(kvs.Init());
+    for (const char* key : kPrefixTestKeys) {
+      ASSERT_OK(kvs.Put(key, uint32_t(1)));
+    }
+    ASSERT_OK(kvs.WriteCheckpoint());
+  }
+
+  KeyPrefixIndexBuffer<kMaxEntries> index;
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(
+      &flash.partition, default_format, {.key_prefix_index = &index});
+  ASSERT_OK(kvs.Init());
+
+  // Keys restored from the checkpoint are read the first time.
+  EXPECT_EQ(kNetKeys, FindNetKeys(kvs));
+  EXPECT_EQ(0u, index.skipped_keys());
+
+  EXPECT_EQ(kNetKeys, FindNetKeys(kvs));
+  EXPECT_EQ(4u, index.skipped_keys());
+}
+
+TEST(InMemoryKvs, IoStats_AttributedToOperation) {
+  Flash flash;
+  ASSERT_OK(flash.partition.Erase());
+
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&flash.partition,
+                                                          default_format);
+  ASSERT_OK(kvs.Init());
+
+  KeyValueStore::IoStats stats = kvs.GetIoStats();
+  EXPECT_NE(0u, stats.init.bytes_read);
+  EXPECT_EQ(0u, stats.init.bytes_written);
+  EXPECT_EQ(0u, stats.put.bytes_read);
+  EXPECT_EQ(0u, stats.put.bytes_written);
+
+  // Write a key that is never rewritten, so garbage collection relocates it.
+  ASSERT_OK(kvs.Put("Key0", uint32_t(0)));
+  const size_t entry_size = kvs.GetStorageStats().in_use_bytes;
+  stats = kvs.GetIoStats();
+  EXPECT_EQ(entry_size, stats.put.bytes_written);
+  ASSERT_OK(kvs.Put("Key1", uint32_t(1)));
+
+  // Reads are not counted.
+  const size_t put_bytes_read = kvs.GetIoStats().put.bytes_read;
+  uint32_t value;
+  ASSERT_OK(kvs.Get("Key0", &value));
+  EXPECT_EQ(put_bytes_read, kvs.GetIoStats().put.bytes_read);
+
+  // Rewrite the other key until garbage collection relocates and erases.
+  size_t puts = 2;
+  while (kvs.GetStorageStats().sector_erase_count == 0u) {
+    ASSERT_OK(kvs.Put("Key1", uint32_t(puts++)));
+  }
+  stats = kvs.GetIoStats();
+  EXPECT_EQ(puts * entry_size, stats.put.bytes_written);
+  EXPECT_EQ(0u, stats.put.sector_erases);
+  EXPECT_EQ(1u, stats.garbage_collection.sector_erases);
+
+  // Garbage collecting every sector relocates Key0.
+  ASSERT_OK(kvs.HeavyMaintenance());
+  stats = kvs.GetIoStats();
+  EXPECT_EQ(puts * entry_size, stats.put.bytes_written);
+  EXPECT_NE(0u, stats.garbage_collection.bytes_read);
+  EXPECT_GE(stats.garbage_collection.bytes_written, entry_size);
+  EXPECT_EQ(kvs.GetStorageStats().sector_erase_count,
+            stats.garbage_collection.sector_erases);
+  EXPECT_EQ(0u, stats.repair.bytes_written);
+
+  // The counters are kept by Init.
+  const size_t init_bytes_read = stats.init.bytes_read;
+  const size_t gc_sector_erases = stats.garbage_collection.sector_erases;
+  ASSERT_OK(kvs.Init());
+  stats = kvs.GetIoStats();
+  EXPECT_GT(stats.init.bytes_read, init_bytes_read);
+  EXPECT_EQ(gc_sector_erases, stats.garbage_collection.sector_erases);
+
+  kvs.ResetIoStats();
+  stats = kvs.GetIoStats();
+  EXPECT_EQ(0u, stats.init.bytes_read);
+  EXPECT_EQ(0u, stats.put.bytes_written);
+  EXPECT_EQ(0u, stats.garbage_collection.sector_erases);
+}
+
+TEST(InMemoryKvs, IoStats_Repair) {
+  Flash flash;
+  ASSERT_OK(flash.partition.Erase());
+
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&flash.partition,
+                                                          default_format);
+  ASSERT_OK(kvs.Init());
+  ASSERT_OK(kvs.Put("Key1", uint32_t(1)));
+  ASSERT_OK(kvs.Put("Key2", uint32_t(2)));
+
+  // Corrupt Key1's value. Init detects the error and repairs the sector.
+  const uint32_t original = 1;
+  const std::span<byte> buffer_in_flash = flash.memory.buffer();
+  auto value_in_flash =
+      std::search(buffer_in_flash.begin(),
+                  buffer_in_flash.end(),
+                  reinterpret_cast<const byte*>(&original),
+                  reinterpret_cast<const byte*>(&original + 1));
+  ASSERT_NE(value_in_flash, buffer_in_flash.end());
+  *value_in_flash = byte{0xef};
+
+  kvs.ResetIoStats();
+  kvs.Init();
+  const KeyValueStore::IoStats stats = kvs.GetIoStats();
+  EXPECT_NE(0u, stats.init.bytes_read);
+  EXPECT_NE(0u, stats.garbage_collection.sector_erases);
+  EXPECT_NE(0u, stats.repair.bytes_read + stats.garbage_collection.bytes_read);
+  EXPECT_EQ(0u, stats.put.bytes_written);
+}
+
+TEST(InMemoryKvs, EraseInBackground_WritesContinueDuringErase) {
+  // Create and erase the fake flash.
+  Flash flash;
+  ASSERT_OK(flash.partition.Erase());
+
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(
+      &flash.partition, default_format, {.erase_in_background = true});
+  ASSERT_OK(kvs.Init());
+
+  // Erases finish only after many polls, so they outlast several writes.
+  flash.memory.set_erase_poll_count(100);
+
+  // Write a key that is never rewritten to the start of each sector, so
+  // garbage collecting a sector relocates it to the free sector.
+  constexpr const char* kSectorKeys[] = {"A", "B", "C", "D", "E", "F", "G"};
+  uint32_t write = 0;
+  while (kvs.GetStorageStats().sector_erase_count == 0u) {
+    ASSERT_LT(write / 16, std::size(kSectorKeys));
+    if (write % 16 == 0u) {
+      ASSERT_OK(kvs.Put(kSectorKeys[write / 16], write));
+    }
+    ASSERT_OK(kvs.Put("Key1", ++write));
+  }
+  EXPECT_TRUE(flash.memory.erase_in_progress());
+
+  // The free sector, which holds the relocated entry, still has space for new
+  // entries.
+  for (size_t i = 0; i < 4; ++i) {
+    ASSERT_OK(kvs.Put("Key1", ++write));
+  }
+  EXPECT_TRUE(flash.memory.erase_in_progress());
+
+  uint32_t value = 0;
+  ASSERT_OK(kvs.Get("Key1", &value));
+  EXPECT_EQ(write, value);
+  ASSERT_OK(kvs.Get("A", &value));
+  EXPECT_EQ(0u, value);
+}
+
+TEST(InMemoryKvs, EraseInBackground_WaitsForErasedSector) {
+  // Create and erase the fake flash.
+  Flash flash;
+  ASSERT_OK(flash.partition.Erase());
+
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(
+      &flash.partition, default_format, {.erase_in_background = true});
+  ASSERT_OK(kvs.Init());
+  flash.memory.set_erase_poll_count(100);
+
+  // Writing enough to garbage collect every sector several times needs the
+  // erased sectors before their erases finish on their own.
+  for (uint32_t write = 1; write <= 500u; ++write) {
+    ASSERT_OK(kvs.Put("Key1", write));
+    ASSERT_OK(kvs.Put("Key2", ~write));
+  }
+  EXPECT_GT(kvs.GetStorageStats().sector_erase_count,
+            flash.memory.sector_count());
+
+  uint32_t value = 0;
+  ASSERT_OK(kvs.Get("Key1", &value));
+  EXPECT_EQ(500u, value);
+  ASSERT_OK(kvs.Get("Key2", &value));
+  EXPECT_EQ(~uint32_t(500), value);
+
+  // Reinitializing finishes the erase, and finds no errors.
+  ASSERT_OK(kvs.Init());
+  EXPECT_FALSE(flash.memory.erase_in_progress());
+  ASSERT_OK(kvs.Get("Key1", &value));
+  EXPECT_EQ(500u, value);
+}
+
+TEST(InMemoryKvs, EraseInBackground_MaintenanceDuringEraseFindsNoErrors) {
+  // Create and erase the fake flash.
+  Flash flash;
+  ASSERT_OK(flash.partition.Erase());
+
+  // With manual recovery, a detected error is only cleared by maintenance and
+  // makes WriteCheckpoint fail.
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(
+      &flash.partition,
+      default_format,
+      {.recovery = ErrorRecovery::kManual, .erase_in_background = true});
+  ASSERT_OK(kvs.Init());
+  flash.memory.set_erase_poll_count(100);
+
+  // Writes until garbage collection starts a background erase. A key that is
+  // never rewritten starts each sector, so the erased sector is not the one
+  // holding the checkpoint, which is erased in the foreground.
+  char sector_key[] = "A";
+  uint32_t write = 0;
+  auto start_erase = [&]() {
+    while (!flash.memory.erase_in_progress()) {
+      ASSERT_LE(sector_key[0], 'Z');
+      if (write % 16 == 0u) {
+        ASSERT_OK(kvs.Put(sector_key, write));
+        sector_key[0] += 1;
+      }
+      ASSERT_OK(kvs.Put("Key1", ++write));
+    }
+  };
+
+  start_erase();
+  EXPECT_FALSE(kvs.CheckForErrors());
+  EXPECT_OK(kvs.PartialMaintenance());
+  EXPECT_FALSE(kvs.error_detected());
+  EXPECT_OK(kvs.WriteCheckpoint());
+
+  start_erase();
+  EXPECT_OK(kvs.FullMaintenance());
+  EXPECT_FALSE(kvs.error_detected());
+
+  uint32_t value = 0;
+  ASSERT_OK(kvs.Get("Key1", &value));
+  EXPECT_EQ(write, value);
+}
+
 TEST(InMemoryKvs, WriteOneKeyValueMultipleTimes) {
   // Create and erase the fake flash.
   Flash flash;
@@ -411,6 +854,188 @@ TEST_F(LargeEmptyInitializedKvs, FullMaintenance) {
   EXPECT_EQ(stats.reclaimable_bytes, 0u);
 }
 
+TEST_F(LargeEmptyInitializedKvs, StepMaintenance) {
+  const uint8_t kValue1 = 0xDA;
+  const uint8_t kValue2 = 0x12;
+
+  EXPECT_EQ(Status::NotFound(), kvs_.StepMaintenance(1));
+
+  // Write each key and write them again, leaving stale entries in the same
+  // sector as the valid entries.
+  for (const char* key : keys) {
+    ASSERT_EQ(OkStatus(), kvs_.Put(key, kValue1));
+  }
+  for (const char* key : keys) {
+    ASSERT_EQ(OkStatus(), kvs_.Put(key, kValue2));
+  }
+
+  KeyValueStore::StorageStats stats = kvs_.GetStorageStats();
+  ASSERT_GT(stats.reclaimable_bytes, 0u);
+  const size_t in_use_bytes = stats.in_use_bytes;
+
+  // Relocate one entry per step, then erase the sector in a final step.
+  for (size_t i = 0; i < keys.size() + 1; ++i) {
+    EXPECT_EQ(0u, kvs_.GetStorageStats().sector_erase_count);
+    ASSERT_EQ(OkStatus(), kvs_.StepMaintenance(1));
+    EXPECT_EQ(in_use_bytes, kvs_.GetStorageStats().in_use_bytes);
+  }
+
+  stats = kvs_.GetStorageStats();
+  EXPECT_EQ(stats.sector_erase_count, 1u);
+  EXPECT_EQ(stats.reclaimable_bytes, 0u);
+  EXPECT_EQ(Status::NotFound(), kvs_.StepMaintenance(1));
+
+  for (const char* key : keys) {
+    uint8_t value;
+    ASSERT_EQ(OkStatus(), kvs_.Get(key, &value));
+    EXPECT_EQ(kValue2, value);
+  }
+}
+
+TEST_F(LargeEmptyInitializedKvs, StepMaintenance_InterleavedWithPut) {
+  const uint8_t kValue1 = 0xDA;
+  const uint8_t kValue2 = 0x12;
+
+  for (const char* key : keys) {
+    ASSERT_EQ(OkStatus(), kvs_.Put(key, kValue1));
+    ASSERT_EQ(OkStatus(), kvs_.Put(key, kValue2));
+  }
+
+  ASSERT_EQ(OkStatus(), kvs_.StepMaintenance(1));
+
+  // Writes during garbage collection go to other sectors.
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], kValue1));
+
+  Status status;
+  do {
+    status = kvs_.StepMaintenance(1);
+  } while (status.ok());
+  EXPECT_EQ(Status::NotFound(), status);
+
+  uint8_t value;
+  ASSERT_EQ(OkStatus(), kvs_.Get(keys[0], &value));
+  EXPECT_EQ(kValue1, value);
+  for (size_t i = 1; i < keys.size(); ++i) {
+    ASSERT_EQ(OkStatus(), kvs_.Get(keys[i], &value));
+    EXPECT_EQ(kValue2, value);
+  }
+  EXPECT_EQ(kvs_.GetStorageStats().reclaimable_bytes, 0u);
+}
+
+TEST_F(LargeEmptyInitializedKvs, PutBatch) {
+  const uint8_t kValue1 = 0xDA;
+  const uint32_t kValue2 = 0x12345678;
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint8_t(0)));
+  const uint32_t transaction_count = kvs_.transaction_count();
+
+  KeyValueStore::Batch<2> batch;
+  ASSERT_EQ(OkStatus(), batch.Put(keys[0], kValue1));
+  ASSERT_EQ(OkStatus(), batch.Put(keys[1], kValue2));
+  EXPECT_EQ(Status::ResourceExhausted(), batch.Put(keys[2], kValue1));
+  ASSERT_EQ(OkStatus(), kvs_.PutBatch(batch));
+
+  // The whole batch is written with one transaction ID.
+  EXPECT_EQ(transaction_count + 1, kvs_.transaction_count());
+  EXPECT_EQ(2u, kvs_.size());
+
+  uint8_t value1;
+  uint32_t value2;
+  ASSERT_EQ(OkStatus(), kvs_.Get(keys[0], &value1));
+  EXPECT_EQ(kValue1, value1);
+  ASSERT_EQ(OkStatus(), kvs_.Get(keys[1], &value2));
+  EXPECT_EQ(kValue2, value2);
+
+  // The batch is loaded after reinitializing.
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+  EXPECT_EQ(2u, kvs_.size());
+  ASSERT_EQ(OkStatus(), kvs_.Get(keys[0], &value1));
+  EXPECT_EQ(kValue1, value1);
+  ASSERT_EQ(OkStatus(), kvs_.Get(keys[1], &value2));
+  EXPECT_EQ(kValue2, value2);
+}
+
+TEST_F(LargeEmptyInitializedKvs, PutBatch_InvalidBatches) {
+  const uint8_t kValue = 0xDA;
+  EXPECT_EQ(Status::InvalidArgument(),
+            kvs_.PutBatch(std::span<const KeyValueStore::BatchEntry>()));
+
+  KeyValueStore::Batch<3> batch;
+  ASSERT_EQ(OkStatus(), batch.Put(keys[0], kValue));
+  ASSERT_EQ(OkStatus(), batch.Put(keys[1], kValue));
+  ASSERT_EQ(OkStatus(), batch.Put(keys[0], kValue));
+  EXPECT_EQ(Status::InvalidArgument(), kvs_.PutBatch(batch));
+
+  batch.clear();
+  ASSERT_EQ(OkStatus(), batch.Put("", kValue));
+  EXPECT_EQ(Status::InvalidArgument(), kvs_.PutBatch(batch));
+
+  // Batches that do not fit in a sector are rejected.
+  batch.clear();
+  auto big_data = std::as_bytes(std::span(&large_test_flash, 1));
+  const auto half_sector =
+      big_data.subspan(0, large_test_partition.sector_size_bytes() / 2);
+  ASSERT_EQ(OkStatus(), batch.Put(keys[0], half_sector));
+  ASSERT_EQ(OkStatus(), batch.Put(keys[1], half_sector));
+  EXPECT_EQ(Status::InvalidArgument(), kvs_.PutBatch(batch));
+
+  EXPECT_TRUE(kvs_.empty());
+  EXPECT_EQ(0u, kvs_.transaction_count());
+}
+
+TEST_F(LargeEmptyInitializedKvs, PutBatch_SurvivesGarbageCollection) {
+  const uint8_t kValue1 = 0xDA;
+  const uint8_t kValue2 = 0x12;
+
+  KeyValueStore::Batch<3> batch;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    ASSERT_EQ(OkStatus(), batch.Put(keys[i], kValue1));
+  }
+  ASSERT_EQ(OkStatus(), kvs_.PutBatch(batch));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], kValue2));
+
+  // Relocated batch entries are written as ordinary entries, so they are still
+  // loaded after the sector with the original batch is erased.
+  ASSERT_EQ(OkStatus(), kvs_.HeavyMaintenance());
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+  EXPECT_EQ(3u, kvs_.size());
+
+  uint8_t value;
+  ASSERT_EQ(OkStatus(), kvs_.Get(keys[0], &value));
+  EXPECT_EQ(kValue2, value);
+  ASSERT_EQ(OkStatus(), kvs_.Get(keys[1], &value));
+  EXPECT_EQ(kValue1, value);
+  ASSERT_EQ(OkStatus(), kvs_.Get(keys[2], &value));
+  EXPECT_EQ(kValue1, value);
+}
+
+TEST_F(LargeEmptyInitializedKvs, WriteCheckpoint) {
+  const uint8_t kValue1 = 0xDA;
+  const uint8_t kValue2 = 0x12;
+  for (const char* key : keys) {
+    ASSERT_EQ(OkStatus(), kvs_.Put(key, kValue1));
+  }
+  ASSERT_EQ(OkStatus(), kvs_.Delete(keys[1]));
+
+  ASSERT_EQ(OkStatus(), kvs_.WriteCheckpoint());
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+  EXPECT_EQ(keys.size() - 1, kvs_.size());
+
+  uint8_t value;
+  ASSERT_EQ(OkStatus(), kvs_.Get(keys[0], &value));
+  EXPECT_EQ(kValue1, value);
+  EXPECT_EQ(Status::NotFound(), kvs_.Get(keys[1], &value));
+  ASSERT_EQ(OkStatus(), kvs_.Get(keys[2], &value));
+  EXPECT_EQ(kValue1, value);
+
+  // The KVS is writable after loading a checkpoint, and the checkpoint is not
+  // used again once the KVS changes.
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[1], kValue2));
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+  EXPECT_EQ(keys.size(), kvs_.size());
+  ASSERT_EQ(OkStatus(), kvs_.Get(keys[1], &value));
+  EXPECT_EQ(kValue2, value);
+}
+
 TEST(InMemoryKvs, Put_MaxValueSize) {
   // Create and erase the fake flash.
   Flash flash;
@@ -113,5 +113,38 @@ TEST_F(WearTest, TwoPassFillWithLargeAndLarger) {
             2u * partition_.average_erase_count());
 }
 
+// Wear some sectors before the KVS is used and check that using the erase
+// counts as the wear leveling policy evens out the wear.
+TEST(WearLevelingPolicyTest, PrefersLessWornSectors) {
+  constexpr size_t kSectors = 16;
+  FakeFlashMemoryBuffer<512, kSectors> flash(
+      internal::Entry::kMinAlignmentBytes);
+  FlashPartitionWithStatsBuffer<kSectors> partition(
+      &flash, 0, flash.sector_count());
+  partition.ResetCounters();
+
+  for (size_t sector = 0; sector < kSectors / 2; ++sector) {
+    for (size_t i = 0; i < 20; ++i) {
+      ASSERT_EQ(OkStatus(),
+                partition.Erase(sector * partition.sector_size_bytes(), 1));
+    }
+  }
+
+  KeyValueStoreBuffer<256, kSectors> kvs(
+      &partition, format, {.wear_leveling_policy = &partition});
+  ASSERT_EQ(OkStatus(), kvs.Init());
+
+  for (size_t i = 0; i < kSectors * 20; ++i) {
+    test_data[0]++;
+    ASSERT_EQ(OkStatus(), kvs.Put("large_entry", std::span(test_data)));
+  }
+
+  // The less worn sectors catch up to the pre-worn sectors. Without the policy,
+  // every sector is erased about the same number of additional times, so the
+  // pre-worn sectors remain far ahead.
+  EXPECT_GE(partition.min_erase_count(), 20u);
+  EXPECT_LE(partition.max_erase_count(), partition.min_erase_count() + 1u);
+}
+
 }  // namespace
 }  // namespace pw::kvs
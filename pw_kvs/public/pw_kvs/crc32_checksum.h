@@ -0,0 +1,42 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <span>
+
+#include "pw_checksum/crc32.h"
+#include "pw_kvs/checksum.h"
+
+namespace pw::kvs {
+
+class ChecksumCrc32 final : public ChecksumAlgorithm {
+ public:
+  ChecksumCrc32()
+      : ChecksumAlgorithm(std::as_bytes(std::span<uint32_t>(&value_, 1))) {}
+
+  void Reset() override {
+    crc_.clear();
+    value_ = crc_.value();
+  }
+
+  void Update(std::span<const std::byte> data) override { crc_.Update(data); }
+
+ private:
+  void Finalize() override { value_ = crc_.value(); }
+
+  checksum::Crc32 crc_;
+  uint32_t value_ = PW_CHECKSUM_EMPTY_CRC32;
+};
+
+}  // namespace pw::kvs
@@ -106,6 +106,13 @@ class FakeFlashMemory : public FlashMemory {
   // Erase num_sectors starting at a given address.
   Status Erase(Address address, size_t num_sectors) override;
 
+  // Starts erasing num_sectors starting at a given address. If background
+  // erases are enabled with set_erase_poll_count, the sectors are erased by a
+  // later PollErase call.
+  Status StartErase(Address address, size_t num_sectors) override;
+
+  Status PollErase() override;
+
   // Reads bytes from flash into buffer.
   StatusWithSize Read(Address address, std::span<std::byte> output) override;
 
@@ -137,12 +144,26 @@ class FakeFlashMemory : public FlashMemory {
     return true;
   }
 
+  // Makes StartErase return without erasing. The erase finishes on the
+  // poll_count-th call to PollErase. A poll_count of 0 makes StartErase erase
+  // immediately, which is the default.
+  void set_erase_poll_count(size_t poll_count) {
+    erase_poll_count_ = poll_count;
+  }
+
+  bool erase_in_progress() const { return erase_polls_remaining_ != 0u; }
+
  private:
   static inline Vector<FlashError, 0> no_errors_;
 
   const std::span<std::byte> buffer_;
   Vector<FlashError>& read_errors_;
   Vector<FlashError>& write_errors_;
+
+  size_t erase_poll_count_ = 0;
+  size_t erase_polls_remaining_ = 0;
+  Address pending_erase_address_ = 0;
+  size_t pending_erase_sectors_ = 0;
 };
 
 // Creates an FakeFlashMemory backed by a std::array. The array is initialized
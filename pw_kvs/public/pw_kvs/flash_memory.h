@@ -71,6 +71,27 @@ class FlashMemory {
   // OUT_OF_RANGE - erases past the end of the memory
   virtual Status Erase(Address flash_address, size_t num_sectors) = 0;
 
+  // Starts erasing num_sectors at a given address without waiting for the
+  // erase to finish, such as with a DMA or interrupt driven flash controller.
+  // Only one erase may be in progress at a time, and the erasing sectors must
+  // not be accessed until PollErase reports that it finished. Returns the same
+  // codes as Erase, or:
+  //
+  // UNAVAILABLE - another erase is in progress
+  //
+  // The default implementation performs a blocking Erase.
+  virtual Status StartErase(Address flash_address, size_t num_sectors) {
+    return Erase(flash_address, num_sectors);
+  }
+
+  // Checks whether the erase started by StartErase finished. Returns:
+  //
+  // OK - the erase finished, or no erase was started
+  // UNAVAILABLE - the erase is in progress
+  //
+  // If the erase failed, returns the same codes as Erase.
+  virtual Status PollErase() { return OkStatus(); }
+
   // Reads bytes from flash into buffer. Blocking call. Returns:
   //
   // OK - success
@@ -201,6 +222,21 @@ class FlashPartition {
 
   Status Erase() { return Erase(0, this->sector_count()); }
 
+  // Starts erasing num_sectors at a given address without waiting for the
+  // erase to finish. The erasing sectors must not be accessed until PollErase
+  // reports that it finished. Returns the same codes as Erase, or:
+  //
+  // UNAVAILABLE - another erase is in progress
+  virtual Status StartErase(Address address, size_t num_sectors);
+
+  // Checks whether the erase started by StartErase finished. Returns:
+  //
+  // OK - the erase finished, or no erase was started
+  // UNAVAILABLE - the erase is in progress
+  //
+  // If the erase failed, returns the same codes as Erase.
+  Status PollErase() { return flash_.PollErase(); }
+
   // Reads bytes from flash into buffer. Blocking call. Returns:
   //
   // OK - success.
@@ -287,9 +323,18 @@ class FlashPartition {
 
   uint32_t start_sector_index() const { return start_sector_index_; }
 
+  // The total number of bytes read and written by Read() and Write(),
+  // including reads by IsRegionErased(). Derived classes that override Read()
+  // or Write() without calling them are not counted.
+  size_t bytes_read() const { return bytes_read_; }
+  size_t bytes_written() const { return bytes_written_; }
+
  protected:
   Status CheckBounds(Address address, size_t len) const;
 
+  // Checks that the sectors may be erased, as done by Erase and StartErase.
+  Status CheckErase(Address address, size_t num_sectors) const;
+
   FlashMemory& flash() const { return flash_; }
 
  private:
@@ -298,6 +343,9 @@ class FlashPartition {
   const uint32_t sector_count_;
   const uint32_t alignment_bytes_;
   const PartitionPermission permission_;
+
+  size_t bytes_read_;
+  size_t bytes_written_;
 };
 
 }  // namespace kvs
@@ -19,6 +19,7 @@
 #include "pw_containers/vector.h"
 #include "pw_kvs/flash_memory.h"
 #include "pw_kvs/key_value_store.h"
+#include "pw_kvs/wear_leveling_policy.h"
 #include "pw_status/status.h"
 
 #ifndef PW_KVS_RECORD_PARTITION_STATS
@@ -28,7 +29,10 @@
 
 namespace pw::kvs {
 
-class FlashPartitionWithStats : public FlashPartition {
+// A FlashPartition that counts erases per sector. The erase counts may be used
+// as the KVS wear leveling policy by setting Options::wear_leveling_policy.
+class FlashPartitionWithStats : public FlashPartition,
+                                public WearLevelingPolicy {
  public:
   // Save flash partition and KVS storage stats. Does not save if
   // sector_counters_ is zero.
@@ -38,6 +42,8 @@ class FlashPartitionWithStats : public FlashPartition {
 
   Status Erase(Address address, size_t num_sectors) override;
 
+  Status StartErase(Address address, size_t num_sectors) override;
+
   std::span<size_t> sector_erase_counters() {
     return std::span(sector_counters_.data(), sector_counters_.size());
   }
@@ -68,6 +74,14 @@ class FlashPartitionWithStats : public FlashPartition {
 
   void ResetCounters() { sector_counters_.assign(sector_count(), 0); }
 
+  // Reports the sector's erase count as its wear. Returns 0 for all sectors if
+  // stats are disabled.
+  size_t SectorWear(size_t sector_index) const override {
+    return sector_index < sector_counters_.size()
+               ? sector_counters_[sector_index]
+               : 0;
+  }
+
  protected:
   FlashPartitionWithStats(
       Vector<size_t>& sector_counters,
@@ -86,6 +100,8 @@ class FlashPartitionWithStats : public FlashPartition {
   }
 
  private:
+  void RecordErase(Address address, size_t num_sectors);
+
   Vector<size_t>& sector_counters_;
 };
 
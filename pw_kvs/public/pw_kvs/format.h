@@ -41,9 +41,11 @@ struct EntryHeader {
   // number of bytes, add one to this number and multiply by 16.
   uint8_t alignment_units;
 
-  // The length of the key in bytes. The key is not null terminated.
+  // The length of the key in bytes. The key is not null terminated. A key
+  // length of 0 is reserved for KVS checkpoint entries.
   //  6 bits, 0:5 - key length - maximum 64 characters
-  //  2 bits, 6:7 - reserved
+  //  1 bit,  6   - set if the entry is part of a batch
+  //  1 bit,  7   - set if the entry is the final, commit entry of a batch
   uint8_t key_length_bytes;
 
   // Byte length of the value; maximum of 65534. The max uint16_t value (65535
@@ -103,6 +105,17 @@ struct EntryFormat {
   // The checksum algorithm is used to calculate checksums for KVS entries. If
   // it is null, no checksum is used.
   ChecksumAlgorithm* checksum;
+
+  // Magic for delta entries, which store only the bytes of a value that changed
+  // since the key's previous entry. Like magic, this should be a random 32 bit
+  // integer, and it must differ from the magic of every format. If it is 0,
+  // values are always written in full.
+  uint32_t delta_magic = 0;
+
+  // The maximum number of delta entries that are applied to a full entry to
+  // read a value. Once a value has this many deltas, the next write stores the
+  // full value. Limited to internal::kMaxDeltaChainLength.
+  uint8_t max_delta_chain_length = 0;
 };
 
 }  // namespace kvs
@@ -0,0 +1,182 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// This file defines the in-flash format of delta entries and the classes for
+// reading and encoding them.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/format.h"
+#include "pw_kvs/internal/entry.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw {
+namespace kvs {
+namespace internal {
+
+// The value of a delta entry starts with this header. It is followed by
+// patch_count patches, each of which is a DeltaPatch followed by the bytes that
+// replace the previous value starting at the patch's offset.
+struct DeltaHeader {
+  // Address of the entry this delta applies to, which may also be a delta.
+  uint32_t previous_address;
+
+  // Size of the value after applying the delta. Deltas never change the size.
+  uint16_t value_size;
+
+  uint8_t patch_count;
+
+  // Number of delta entries in the chain, including this one.
+  uint8_t chain_length;
+};
+
+static_assert(sizeof(DeltaHeader) == 8, "DeltaHeader must not have padding");
+
+struct DeltaPatch {
+  uint16_t offset;
+  uint16_t size;
+};
+
+static_assert(sizeof(DeltaPatch) == 4, "DeltaPatch must not have padding");
+
+// Limits on delta entries, which bound the work needed to read a value.
+inline constexpr size_t kMaxDeltaChainLength = 8;
+inline constexpr size_t kMaxDeltaPatches = 8;
+
+// The changes from one value to another, as a list of patches.
+class DeltaPatches {
+ public:
+  // The header, patch headers, and changed bytes of a delta entry's value.
+  static constexpr size_t kMaxValueChunks = 1 + 2 * kMaxDeltaPatches;
+
+  constexpr DeltaPatches() : patches_{}, count_(0) {}
+
+  std::span<const DeltaPatch> patches() const {
+    return std::span(patches_.data(), count_);
+  }
+
+  bool empty() const { return count_ == 0u; }
+
+  // The size of a delta entry's value with these patches.
+  size_t encoded_size() const;
+
+  // Records that the byte at the offset changed. Offsets must be added in
+  // increasing order. Changes that are close together share a patch, since a
+  // patch header costs as much as a few unchanged bytes. Once all patches are
+  // used, the last patch grows to cover any later changes.
+  void AddChange(size_t offset);
+
+  // Fills in the value chunks of a delta entry that applies these patches to
+  // produce new_value. Returns the number of chunks used.
+  size_t EncodeChunks(
+      const DeltaHeader& header,
+      std::span<const std::byte> new_value,
+      std::span<std::span<const std::byte>, kMaxValueChunks> chunks) const;
+
+ private:
+  std::array<DeltaPatch, kMaxDeltaPatches> patches_;
+  size_t count_;
+};
+
+// The entries that make up a value: zero or more delta entries and the full
+// entry the oldest delta applies to. The value is read by reading the full
+// entry's value and applying each delta's patches from oldest to newest.
+class DeltaChain {
+ public:
+  using Address = FlashPartition::Address;
+
+  // Entries in a chain: kMaxDeltaChainLength deltas and a full entry.
+  static constexpr size_t kMaxEntries = kMaxDeltaChainLength + 1;
+
+  // The whole value is read piece-by-piece in windows of this size.
+  static constexpr size_t kWindowSizeBytes = 4 * Entry::kMinAlignmentBytes;
+
+  constexpr DeltaChain()
+      : partition_(nullptr),
+        addresses_{},
+        sizes_{},
+        length_(0),
+        key_length_(0),
+        value_size_(0) {}
+
+  // Loads the chain that ends with the newest entry for a key. If that entry is
+  // a full entry, the chain contains only that entry. Returns flash partition
+  // Read error codes, or one of the following:
+  //
+  //          OK: the chain was loaded
+  //   DATA_LOSS: an entry in the chain is missing or belongs to another key
+  //
+  Status Load(FlashPartition& partition,
+              const EntryFormats& formats,
+              const Entry& newest);
+
+  // The size of the value the chain represents.
+  size_t value_size() const { return value_size_; }
+
+  // The number of delta entries, which excludes the full entry.
+  size_t delta_count() const { return length_ - 1u; }
+
+  // The addresses of the entries in the chain, from newest to oldest. The last
+  // entry is the full entry.
+  std::span<const Address> addresses() const {
+    return std::span(addresses_.data(), length_);
+  }
+
+  // The total size of the entry at the index in addresses(), including padding.
+  size_t entry_size(size_t index) const { return sizes_[index]; }
+
+  // Reads the value into the buffer, with the same results as
+  // Entry::ReadValue.
+  StatusWithSize ReadValue(std::span<std::byte> buffer,
+                           size_t offset_bytes = 0) const;
+
+  // Reads the part of the value at the offset that fills the window. The window
+  // must be within the value.
+  Status ReadWindow(size_t offset_bytes, std::span<std::byte> window) const;
+
+  // Verifies the checksum of each entry in the chain.
+  Status VerifyChecksumsInFlash(const EntryFormats& formats) const;
+
+  // Finds the changes from the chain's value to a new value of the same size.
+  Status FindChanges(std::span<const std::byte> new_value,
+                     DeltaPatches& patches) const;
+
+ private:
+  Address value_address(size_t index) const {
+    return addresses_[index] + sizeof(EntryHeader) + key_length_;
+  }
+
+  // Applies the patches of the delta at the index in addresses() that overlap
+  // the window.
+  Status ApplyDelta(size_t index,
+                    size_t offset_bytes,
+                    std::span<std::byte> window) const;
+
+  FlashPartition* partition_;
+  std::array<Address, kMaxEntries> addresses_;
+  std::array<uint16_t, kMaxEntries> sizes_;
+  uint8_t length_;
+  uint8_t key_length_;
+  uint16_t value_size_;
+};
+
+}  // namespace internal
+}  // namespace kvs
+}  // namespace pw
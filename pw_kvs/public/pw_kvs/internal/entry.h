@@ -33,6 +33,8 @@ namespace pw {
 namespace kvs {
 namespace internal {
 
+class DeltaChain;
+
 // Entry represents a key-value entry in a flash partition.
 class Entry {
  public:
@@ -41,6 +43,15 @@ class Entry {
 
   using Address = FlashPartition::Address;
 
+  // Entries written together by KeyValueStore::PutBatch are flagged as part of
+  // a batch. The batch only takes effect if its final, commit entry is written.
+  // The values are the flag bits stored in EntryHeader::key_length_bytes.
+  enum class BatchState : uint8_t {
+    kNone = 0b00 << 6,
+    kMember = 0b01 << 6,
+    kCommit = 0b11 << 6,
+  };
+
   // Buffer capable of holding any valid key (without a null terminator);
   using KeyBuffer = std::array<char, kMaxKeyLength>;
 
@@ -67,9 +78,40 @@ class Entry {
                      const EntryFormat& format,
                      Key key,
                      std::span<const std::byte> value,
-                     uint32_t transaction_id) {
-    return Entry(
-        partition, address, format, key, value, value.size(), transaction_id);
+                     uint32_t transaction_id,
+                     BatchState batch_state = BatchState::kNone) {
+    return Entry(partition,
+                 address,
+                 format,
+                 format.magic,
+                 key,
+                 std::span(&value, 1),
+                 value.size(),
+                 transaction_id,
+                 batch_state);
+  }
+
+  // Creates a new Entry for a KeyValueStore checkpoint, which has no key. The
+  // value is split across multiple buffers and is their concatenation.
+  static Entry Checkpoint(
+      FlashPartition& partition,
+      Address address,
+      const EntryFormat& format,
+      std::span<const std::span<const std::byte>> value_chunks,
+      uint32_t transaction_id) {
+    size_t value_size = 0;
+    for (const std::span<const std::byte>& chunk : value_chunks) {
+      value_size += chunk.size();
+    }
+    return Entry(partition,
+                 address,
+                 format,
+                 format.magic,
+                 Key(),
+                 value_chunks,
+                 value_size,
+                 transaction_id,
+                 BatchState::kNone);
   }
 
   // Creates a new Entry for a tombstone entry, which marks a deleted key.
@@ -81,12 +123,48 @@ class Entry {
     return Entry(partition,
                  address,
                  format,
+                 format.magic,
                  key,
                  {},
                  kDeletedValueLength,
-                 transaction_id);
+                 transaction_id,
+                 BatchState::kNone);
   }
 
+  // Creates a new Entry for a delta entry, which stores changes to the key's
+  // previous value. The format must have a delta magic. The value is split
+  // across multiple buffers and is their concatenation.
+  static Entry Delta(FlashPartition& partition,
+                     Address address,
+                     const EntryFormat& format,
+                     Key key,
+                     std::span<const std::span<const std::byte>> value_chunks,
+                     uint32_t transaction_id) {
+    size_t value_size = 0;
+    for (const std::span<const std::byte>& chunk : value_chunks) {
+      value_size += chunk.size();
+    }
+    return Entry(partition,
+                 address,
+                 format,
+                 format.delta_magic,
+                 key,
+                 value_chunks,
+                 value_size,
+                 transaction_id,
+                 BatchState::kNone);
+  }
+
+  // Creates a new Entry with the full value that a delta chain represents. The
+  // value is read from the chain's entries to calculate the checksum.
+  static Status Compacted(FlashPartition& partition,
+                          Address address,
+                          const EntryFormat& format,
+                          Key key,
+                          const DeltaChain& chain,
+                          uint32_t transaction_id,
+                          Entry* entry);
+
   Entry() = default;
 
   KeyDescriptor descriptor(Key key) const { return descriptor(Hash(key)); }
@@ -97,13 +175,39 @@ class Entry {
                          deleted() ? EntryState::kDeleted : EntryState::kValid};
   }
 
-  StatusWithSize Write(Key key, std::span<const std::byte> value) const;
+  StatusWithSize Write(Key key, std::span<const std::byte> value) const {
+    return WriteChunks(key, std::span(&value, 1));
+  }
+
+  // Writes a checkpoint entry created with the same value chunks.
+  StatusWithSize WriteCheckpoint(
+      std::span<const std::span<const std::byte>> value_chunks) const {
+    return WriteChunks(Key(), value_chunks);
+  }
+
+  // Writes a delta entry created with the same value chunks.
+  StatusWithSize WriteDelta(
+      Key key, std::span<const std::span<const std::byte>> value_chunks) const {
+    return WriteChunks(key, value_chunks);
+  }
+
+  // Writes an entry created by Compacted from the same chain. The value is read
+  // from the chain's entries again as it is written.
+  StatusWithSize WriteCompacted(Key key, const DeltaChain& chain) const;
 
   // Changes the format and transcation ID for this entry. In order to calculate
   // the new checksum, the entire entry is read into a small stack-allocated
   // buffer. The updated entry may be written to flash using the Copy function.
+  // Delta entries cannot be updated, since their value depends on other
+  // entries; they are compacted into a full entry instead.
   Status Update(const EntryFormat& new_format, uint32_t new_transaction_id);
 
+  // Removes this entry from its batch, if it is part of one. Entries are
+  // removed from their batch when copied, since a copied entry's batch has
+  // already been committed. The checksum is recalculated from flash if the
+  // batch flags change.
+  Status ClearBatchState();
+
   // Writes this entry at a new address. The key and value are read from the
   // entry's current address. The Entry object's header, which may be newer than
   // what is in flash, is used.
@@ -132,7 +236,13 @@ class Entry {
   static size_t size(const FlashPartition& partition,
                      Key key,
                      std::span<const std::byte> value) {
-    return AlignUp(sizeof(EntryHeader) + key.size() + value.size(),
+    return size(partition, key, value.size());
+  }
+
+  static size_t size(const FlashPartition& partition,
+                     Key key,
+                     size_t value_size) {
+    return AlignUp(sizeof(EntryHeader) + key.size() + value_size,
                    std::max(partition.alignment_bytes(), kMinAlignmentBytes));
   }
 
@@ -151,7 +261,18 @@ class Entry {
   size_t size() const { return AlignUp(content_size(), alignment_bytes()); }
 
   // The length of the key in bytes. Keys are not null terminated.
-  size_t key_length() const { return header_.key_length_bytes; }
+  size_t key_length() const {
+    return header_.key_length_bytes & kKeyLengthMask;
+  }
+
+  BatchState batch_state() const {
+    return static_cast<BatchState>(header_.key_length_bytes & ~kKeyLengthMask);
+  }
+
+  // The address of the value, which follows the header and key.
+  Address value_address() const {
+    return address_ + sizeof(EntryHeader) + key_length();
+  }
 
   // The size of the value, without padding. The size is 0 if this is a
   // tombstone entry.
@@ -163,23 +284,36 @@ class Entry {
 
   uint32_t transaction_id() const { return header_.transaction_id; }
 
+  // True if this is a KeyValueStore checkpoint entry, which has no key.
+  bool checkpoint() const {
+    return key_length() == 0u && !deleted() &&
+           batch_state() == BatchState::kNone;
+  }
+
   // True if this is a tombstone entry.
   bool deleted() const {
     return header_.value_size_bytes == kDeletedValueLength;
   }
 
+  // True if this is a delta entry, whose value is a DeltaHeader and patches to
+  // apply to the key's previous value rather than the value itself.
+  bool delta() const { return delta_; }
+
   void DebugLog() const;
 
  private:
   static constexpr uint16_t kDeletedValueLength = 0xFFFF;
+  static constexpr uint8_t kKeyLengthMask = kMaxKeyLength;
 
   Entry(FlashPartition& partition,
         Address address,
         const EntryFormat& format,
+        uint32_t magic,
         Key key,
-        std::span<const std::byte> value,
+        std::span<const std::span<const std::byte>> value_chunks,
         uint16_t value_size_bytes,
-        uint32_t transaction_id);
+        uint32_t transaction_id,
+        BatchState batch_state);
 
   constexpr Entry(FlashPartition* partition,
                   Address address,
@@ -188,12 +322,17 @@ class Entry {
       : partition_(partition),
         address_(address),
         checksum_algo_(format.checksum),
-        header_(header) {}
+        header_(header),
+        delta_(format.delta_magic != 0u && header.magic == format.delta_magic) {
+  }
 
   FlashPartition& partition() const { return *partition_; }
 
   size_t alignment_bytes() const { return (header_.alignment_units + 1) * 16; }
 
+  StatusWithSize WriteChunks(
+      Key key, std::span<const std::span<const std::byte>> value_chunks) const;
+
   // The total size of the entry, excluding padding.
   size_t content_size() const {
     return sizeof(EntryHeader) + key_length() + value_size();
@@ -204,10 +343,12 @@ class Entry {
   }
 
   std::span<const std::byte> CalculateChecksum(
-      Key key, std::span<const std::byte> value) const;
+      Key key, std::span<const std::span<const std::byte>> value_chunks) const;
 
   Status CalculateChecksumFromFlash();
 
+  Status CalculateChecksumFromChain(Key key, const DeltaChain& chain);
+
   // Update the checksum with 0s to pad the entry to its alignment boundary.
   void AddPaddingBytesToChecksum() const;
 
@@ -219,6 +360,7 @@ class Entry {
   Address address_;
   ChecksumAlgorithm* checksum_algo_;
   EntryHeader header_;
+  bool delta_;
 };
 
 }  // namespace internal
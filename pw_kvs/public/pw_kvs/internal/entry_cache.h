@@ -24,6 +24,8 @@
 #include "pw_kvs/internal/key_descriptor.h"
 #include "pw_kvs/internal/sectors.h"
 #include "pw_kvs/key.h"
+#include "pw_kvs/key_prefix_index.h"
+#include "pw_kvs/value_cache.h"
 
 namespace pw {
 namespace kvs {
@@ -43,6 +45,13 @@ class EntryMetadata {
 
   EntryState state() const { return descriptor_->state; }
 
+  // The number of delta entries in this entry's chain, if it is delta encoded.
+  size_t delta_count() const { return descriptor_->delta_count; }
+
+  void set_delta_count(size_t delta_count) {
+    descriptor_->delta_count = static_cast<uint8_t>(delta_count);
+  }
+
   // The first known address of this entry.
   uint32_t first_address() const { return addresses_[0]; }
 
@@ -144,15 +153,95 @@ class EntryCache {
   template <size_t kMaxEntries, size_t kRedundancy>
   using AddressList = Address[kMaxEntries * kRedundancy + kRedundancy];
 
+  // Slot in the optional hash index. Holds the descriptor index + 1, or
+  // kEmptySlot if the slot is unused.
+  using HashIndexSlot = uint16_t;
+
+  static constexpr HashIndexSlot kEmptySlot = 0;
+
+  // The number of hash index slots to use for the specified number of entries.
+  // This is the smallest power of two that keeps the index at most half full,
+  // which keeps linear probe sequences short.
+  static constexpr size_t HashIndexSize(size_t max_entries) {
+    size_t size = 1;
+    while (size < 2 * max_entries) {
+      size *= 2;
+    }
+    return size;
+  }
+
+  // The type to use for a hash index that supports the specified number of
+  // entries.
+  template <size_t kMaxEntries>
+  using HashIndex = HashIndexSlot[HashIndexSize(kMaxEntries)];
+
+  // Creates an EntryCache. If a hash index is provided, key hash lookups use
+  // it instead of scanning every KeyDescriptor. The hash index must have at
+  // least HashIndexSize(descriptors.max_size()) slots; it is cleared by
+  // Reset(). If a value cache is provided, values can be cached with their
+  // KeyDescriptors. If a key prefix index is provided, the namespace of each
+  // key added with AddNew is recorded in it.
   constexpr EntryCache(Vector<KeyDescriptor>& descriptors,
                        Address* addresses,
-                       size_t redundancy)
+                       size_t redundancy,
+                       std::span<HashIndexSlot> hash_index = {},
+                       ValueCache* value_cache = nullptr,
+                       KeyPrefixIndex* key_prefix_index = nullptr)
       : descriptors_(descriptors),
         addresses_(addresses),
-        redundancy_(redundancy) {}
+        redundancy_(redundancy),
+        hash_index_(hash_index),
+        value_cache_(value_cache),
+        key_prefix_index_(key_prefix_index) {}
+
+  // Clears all KeyDescriptors, cached values, and key prefixes.
+  void Reset() const;
+
+  // Sets *value to the entry's cached value and returns true if the value is
+  // cached for the entry's current transaction ID.
+  bool FindCachedValue(const EntryMetadata& metadata,
+                       std::span<const std::byte>* value) const {
+    return value_cache_ != nullptr &&
+           value_cache_->Find(
+               descriptor_index(metadata), metadata.transaction_id(), value);
+  }
 
-  // Clears all KeyDescriptors.
-  void Reset() const { descriptors_.clear(); }
+  // Caches the entry's value, if there is a value cache.
+  void CacheValue(const EntryMetadata& metadata,
+                  std::span<const std::byte> value) const {
+    if (value_cache_ != nullptr) {
+      value_cache_->Store(
+          descriptor_index(metadata), metadata.transaction_id(), value);
+    }
+  }
+
+  // Removes the entry's value from the value cache, if it is cached. Must be
+  // called when the entry is rewritten or moved.
+  void InvalidateCachedValue(const EntryMetadata& metadata) const {
+    if (value_cache_ != nullptr) {
+      value_cache_->Invalidate(descriptor_index(metadata));
+    }
+  }
+
+  // Records the namespace of the entry's key, if there is a key prefix index.
+  void SetKeyPrefix(const EntryMetadata& metadata, Key key) const {
+    if (key_prefix_index_ != nullptr) {
+      key_prefix_index_->Set(descriptor_index(metadata), key);
+    }
+  }
+
+  // Returns false if the entry's key is known not to start with the prefix.
+  // Returns true if it may, or if there is no key prefix index.
+  bool KeyPrefixMayMatch(const EntryMetadata& metadata, Key prefix) const {
+    return key_prefix_index_ == nullptr ||
+           key_prefix_index_->MayMatch(descriptor_index(metadata), prefix);
+  }
+
+  // True if the entry's key namespace is recorded in the key prefix index.
+  bool KeyPrefixKnown(const EntryMetadata& metadata) const {
+    return key_prefix_index_ != nullptr &&
+           key_prefix_index_->known(descriptor_index(metadata));
+  }
 
   // Finds the metadata for an entry matching a particular key. Searches for a
   // KeyDescriptor that matches this key and sets *metadata to point to it if
@@ -173,15 +262,21 @@ class EntryCache {
                       EntryMetadata* metadata) const;
 
   // Adds a new descriptor to the descriptor list. The entry MUST be unique and
-  // the EntryCache must NOT be full!
-  EntryMetadata AddNew(const KeyDescriptor& entry, Address address) const;
+  // the EntryCache must NOT be full! Descriptors MUST keep the key hash they
+  // are added with, since the hash index is not updated when they change. If
+  // the key is provided, its namespace is recorded in the key prefix index.
+  EntryMetadata AddNew(const KeyDescriptor& entry,
+                       Address address,
+                       Key key = {}) const;
 
   // Adds a new descriptor, overwrites an existing one, or adds an additional
   // redundant address to one. The sector size is included for checking that
-  // redundant entries are in different sectors.
+  // redundant entries are in different sectors. The key, if provided, is
+  // passed to AddNew.
   Status AddNewOrUpdateExisting(const KeyDescriptor& descriptor,
                                 Address address,
-                                size_t sector_size_bytes) const;
+                                size_t sector_size_bytes,
+                                Key key = {}) const;
 
   // Returns a pointer to an array of redundancy() addresses for temporary use.
   // This is used by the KeyValueStore to track reserved addresses when finding
@@ -205,6 +300,17 @@ class EntryCache {
   // The maximum number of entries supported by this EntryCache.
   size_t max_entries() const { return descriptors_.max_size(); }
 
+  // The KeyDescriptors, in the order they were added.
+  std::span<const KeyDescriptor> descriptors() const {
+    return std::span(descriptors_.data(), descriptors_.size());
+  }
+
+  // The address lists for the KeyDescriptors. Each descriptor has redundancy()
+  // address slots, with unused slots set to an invalid address.
+  std::span<const Address> address_lists() const {
+    return std::span(addresses_, descriptors_.size() * redundancy_);
+  }
+
   iterator begin() const { return {this, descriptors_.begin()}; }
   const_iterator cbegin() const { return {this, descriptors_.begin()}; }
 
@@ -212,8 +318,18 @@ class EntryCache {
   const_iterator cend() const { return {this, descriptors_.end()}; }
 
  private:
+  // Returns the index of the descriptor with the specified key hash, or -1 if
+  // there is none.
   int FindIndex(uint32_t key_hash) const;
 
+  // Adds the descriptor at the specified index to the hash index, if present.
+  void AddToHashIndex(size_t descriptor_index) const;
+
+  size_t HashIndexStart(uint32_t key_hash) const {
+    // Fold the upper bits in, since the index mask only keeps the lower bits.
+    return (key_hash ^ (key_hash >> 16)) & (hash_index_.size() - 1);
+  }
+
   // Adds the address to the descriptor at the specified index if there is an
   // address slot available.
   void AddAddressIfRoom(size_t descriptor_index, Address address) const;
@@ -227,9 +343,23 @@ class EntryCache {
 
   Address* ResetAddresses(size_t descriptor_index, Address address) const;
 
+  size_t descriptor_index(const EntryMetadata& metadata) const {
+    return metadata.descriptor_ - descriptors_.begin();
+  }
+
   Vector<KeyDescriptor>& descriptors_;
   FlashPartition::Address* const addresses_;
   const size_t redundancy_;
+
+  // Open-addressed, linearly probed table of descriptor indices. Empty if the
+  // EntryCache has no hash index.
+  const std::span<HashIndexSlot> hash_index_;
+
+  // Optional cache of values, indexed by descriptor index.
+  ValueCache* const value_cache_;
+
+  // Optional namespace tags for the keys, indexed by descriptor index.
+  KeyPrefixIndex* const key_prefix_index_;
 };
 
 }  // namespace internal
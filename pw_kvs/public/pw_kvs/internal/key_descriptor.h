@@ -28,6 +28,10 @@ struct KeyDescriptor {
   uint32_t transaction_id;
 
   EntryState state;  // TODO: Pack into transaction ID? or something?
+
+  // The number of delta entries that are applied to read the value. This fits
+  // in what would otherwise be padding.
+  uint8_t delta_count = 0;
 };
 
 }  // namespace internal
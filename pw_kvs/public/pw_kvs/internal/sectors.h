@@ -20,6 +20,7 @@
 
 #include "pw_containers/vector.h"
 #include "pw_kvs/flash_memory.h"
+#include "pw_kvs/wear_leveling_policy.h"
 
 namespace pw {
 namespace kvs {
@@ -103,11 +104,13 @@ class Sectors {
 
   constexpr Sectors(Vector<SectorDescriptor>& sectors,
                     FlashPartition& partition,
-                    const SectorDescriptor** temp_sectors_to_skip)
+                    const SectorDescriptor** temp_sectors_to_skip,
+                    const WearLevelingPolicy* wear_leveling_policy = nullptr)
       : descriptors_(sectors),
         partition_(partition),
         last_new_(nullptr),
-        temp_sectors_to_skip_(temp_sectors_to_skip) {}
+        temp_sectors_to_skip_(temp_sectors_to_skip),
+        wear_leveling_policy_(wear_leveling_policy) {}
 
   // Resets the Sectors list. Must be called before using the object.
   void Reset() {
@@ -217,6 +220,15 @@ class Sectors {
 
   SectorDescriptor& WearLeveledSectorFromIndex(size_t idx) const;
 
+  // Returns the wear reported by the wear leveling policy, or 0 if there is no
+  // policy. With no policy all sectors are equally worn, so selection falls
+  // back to rotating through the sectors from last_new_.
+  size_t Wear(const SectorDescriptor& sector) const {
+    return wear_leveling_policy_ == nullptr
+               ? 0
+               : wear_leveling_policy_->SectorWear(Index(sector));
+  }
+
   Vector<SectorDescriptor>& descriptors_;
   FlashPartition& partition_;
 
@@ -225,6 +237,8 @@ class Sectors {
   // Temp buffer with space for redundancy * 2 - 1 sector pointers. This list is
   // used to track sectors that should be excluded from Find functions.
   const SectorDescriptor** const temp_sectors_to_skip_;
+
+  const WearLevelingPolicy* const wear_leveling_policy_;
 };
 
 }  // namespace internal
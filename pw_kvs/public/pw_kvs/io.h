@@ -83,25 +83,14 @@ class OutputToMethod final : public Output {
 
  private:
   using Return = typename internal::FunctionTraits<decltype(kMethod)>::Return;
-  template <T kMethodImpl = kMethod>
-  typename std::enable_if<std::is_void<typename internal::FunctionTraits<
-                              decltype(kMethodImpl)>::Return>::value,
-                          StatusWithSize>::type
-  DoWriteImpl(std::span<const std::byte> data) {
-    (object_.*kMethod)(data);
-    return StatusWithSize(data.size());
-  }
-
-  template <T kMethodImpl = kMethod>
-  typename std::enable_if<!std::is_void<typename internal::FunctionTraits<
-                              decltype(kMethodImpl)>::Return>::value,
-                          StatusWithSize>::type
-  DoWriteImpl(std::span<const std::byte> data) {
-    return (object_.*kMethod)(data);
-  }
 
   StatusWithSize DoWrite(std::span<const std::byte> data) override {
-    return DoWriteImpl(data);
+    if constexpr (std::is_void_v<Return>) {
+      (object_.*kMethod)(data);
+      return StatusWithSize(data.size());
+    } else {
+      return (object_.*kMethod)(data);
+    }
   }
 
  private:
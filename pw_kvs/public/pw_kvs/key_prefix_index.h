@@ -0,0 +1,98 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_kvs/key.h"
+
+namespace pw::kvs {
+
+// Optional RAM index of each key's namespace, which lets
+// KeyValueStore::ForEachWithPrefix skip keys without reading them from flash.
+// A key's namespace is the key up to and including its first '/', or the whole
+// key if it has no '/'. For each KeyDescriptor, the index keeps a tag derived
+// from the hash of the key's namespace.
+//
+// Tags are recorded when keys are written or loaded from flash. Keys loaded
+// from a checkpoint have no tag until they are first read by
+// ForEachWithPrefix; keys with no tag are always read.
+//
+// A KeyPrefixIndex is provided to a KeyValueStore through
+// Options::key_prefix_index. It is declared as a KeyPrefixIndexBuffer, which
+// allocates a tag for each of the KVS's entries.
+class KeyPrefixIndex {
+ public:
+  static constexpr uint32_t kUnknown = 0;
+
+  // The number of descriptors with tags.
+  size_t max_entries() const { return tags_.size(); }
+
+  // The number of keys that ForEachWithPrefix did not read from flash.
+  uint32_t skipped_keys() const { return skipped_keys_; }
+
+  void ResetCounters() { skipped_keys_ = 0; }
+
+  // Clears all tags.
+  void Clear();
+
+  // Records the namespace of the key for the descriptor.
+  void Set(size_t descriptor_index, Key key) {
+    if (descriptor_index < tags_.size()) {
+      tags_[descriptor_index] = Tag(key);
+    }
+  }
+
+  // Returns true if the descriptor's key may start with the prefix. Returns
+  // false only if the key is known to be in a different namespace, which is
+  // counted as a skipped key. A prefix without a '/' may match keys in any
+  // namespace.
+  bool MayMatch(size_t descriptor_index, Key prefix);
+
+  // Returns true if the descriptor has a tag.
+  bool known(size_t descriptor_index) const {
+    return descriptor_index < tags_.size() &&
+           tags_[descriptor_index] != kUnknown;
+  }
+
+ protected:
+  constexpr KeyPrefixIndex(std::span<uint32_t> tags)
+      : tags_(tags), skipped_keys_(0) {}
+
+ private:
+  // Returns the length of the key's namespace, including the '/', or 0 if the
+  // key has no '/'.
+  static size_t NamespaceLength(Key key);
+
+  // The tag for the key's namespace. Never kUnknown.
+  static uint32_t Tag(Key key);
+
+  const std::span<uint32_t> tags_;
+  uint32_t skipped_keys_;
+};
+
+template <size_t kMaxEntries>
+class KeyPrefixIndexBuffer : public KeyPrefixIndex {
+ public:
+  KeyPrefixIndexBuffer() : KeyPrefixIndex(tags_) { Clear(); }
+
+ private:
+  static_assert(kMaxEntries > 0u);
+
+  uint32_t tags_[kMaxEntries];
+};
+
+}  // namespace pw::kvs
@@ -16,6 +16,7 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <span>
 #include <type_traits>
 
@@ -23,12 +24,16 @@
 #include "pw_kvs/checksum.h"
 #include "pw_kvs/flash_memory.h"
 #include "pw_kvs/format.h"
+#include "pw_kvs/internal/delta.h"
 #include "pw_kvs/internal/entry.h"
 #include "pw_kvs/internal/entry_cache.h"
 #include "pw_kvs/internal/key_descriptor.h"
 #include "pw_kvs/internal/sectors.h"
 #include "pw_kvs/internal/span_traits.h"
 #include "pw_kvs/key.h"
+#include "pw_kvs/key_prefix_index.h"
+#include "pw_kvs/value_cache.h"
+#include "pw_kvs/wear_leveling_policy.h"
 #include "pw_status/status.h"
 #include "pw_status/status_with_size.h"
 
@@ -77,6 +82,31 @@ struct Options {
 
   // Verify an in-flash entry's checksum after writing it.
   bool verify_on_write = true;
+
+  // Optional source of per-sector wear information, such as erase counts. If
+  // set, the KVS prefers less worn sectors when selecting an empty sector to
+  // write to and when selecting a sector to garbage collect. The policy must
+  // outlive the KVS.
+  const WearLevelingPolicy* wear_leveling_policy = nullptr;
+
+  // Optional RAM cache for values. If set, values read with Get are cached and
+  // later reads of the same value are served from RAM until the key is
+  // written, deleted, or relocated. The cache must outlive the KVS and must not
+  // be shared with another KVS.
+  ValueCache* value_cache = nullptr;
+
+  // Optional RAM index of key namespaces. If set, ForEachWithPrefix reads only
+  // the keys in the prefix's namespace from flash. The index must have room for
+  // the KVS's max_size() entries, must outlive the KVS, and must not be shared
+  // with another KVS.
+  KeyPrefixIndex* key_prefix_index = nullptr;
+
+  // Start erasing a garbage collected sector with FlashPartition::StartErase and
+  // return without waiting for the erase to finish. Writes continue in other
+  // sectors while the erase is in progress. The KVS waits for the erase only
+  // when it needs the erased sector or starts another erase. The flash must
+  // support reads and writes of other sectors while a sector is erased.
+  bool erase_in_background = false;
 };
 
 class KeyValueStore {
@@ -120,6 +150,24 @@ class KeyValueStore {
                      std::span<std::byte> value,
                      size_t offset_bytes = 0) const;
 
+  // Sets *value to a span of the value of an entry in memory-mapped flash, so
+  // that the value can be used without copying it. The entry's checksum is
+  // verified before the span is provided.
+  //
+  // The span refers directly to the entry in flash. It is invalidated by any
+  // operation that writes to or erases the KVS, since garbage collection may
+  // relocate the entry and erase its sector.
+  //
+  //                    OK: *value refers to the value in flash
+  //             NOT_FOUND: the key is not present in the KVS
+  //             DATA_LOSS: found the entry, but the data was corrupted
+  //   FAILED_PRECONDITION: the KVS is not initialized
+  //         UNIMPLEMENTED: the flash memory is not memory mapped, or the value
+  //                        is stored as deltas and must be read with Get
+  //      INVALID_ARGUMENT: key is empty or too long
+  //
+  Status GetMapped(Key key, std::span<const std::byte>* value) const;
+
   // This overload of Get accepts a pointer to a trivially copyable object.
   // If the value is an array, call Get with
   // std::as_writable_bytes(std::span(array)), or pass a pointer to the array
@@ -162,6 +210,81 @@ class KeyValueStore {
     return PutBytes(key, std::as_bytes(std::span<const T>(&value, 1)));
   }
 
+  // A key-value pair to write as part of a batch. The key and value are
+  // referenced, not copied, so they must remain valid until the batch is
+  // written.
+  struct BatchEntry {
+    Key key;
+    std::span<const std::byte> value;
+  };
+
+  // Stages up to kMaxEntries key-value pairs to write together with PutBatch.
+  template <size_t kMaxEntries>
+  class Batch {
+   public:
+    constexpr Batch() = default;
+
+    // Adds a key-value pair to the batch. The value may be a std::span of bytes
+    // or a trivially copyable object.
+    //
+    //                    OK: the pair was added to the batch
+    //    RESOURCE_EXHAUSTED: the batch is full
+    //
+    template <typename T,
+              typename std::enable_if_t<ConvertsToSpan<T>::value>* = nullptr>
+    Status Put(const Key& key, const T& value) {
+      return Add(key, std::as_bytes(internal::make_span(value)));
+    }
+
+    template <typename T,
+              typename std::enable_if_t<!ConvertsToSpan<T>::value>* = nullptr>
+    Status Put(const Key& key, const T& value) {
+      CheckThatObjectCanBePutOrGet<T>();
+      return Add(key, std::as_bytes(std::span<const T>(&value, 1)));
+    }
+
+    void clear() { entries_.clear(); }
+
+    std::span<const BatchEntry> entries() const {
+      return std::span(entries_.data(), entries_.size());
+    }
+
+   private:
+    Status Add(const Key& key, std::span<const std::byte> value) {
+      if (entries_.full()) {
+        return Status::ResourceExhausted();
+      }
+      entries_.push_back({key, value});
+      return OkStatus();
+    }
+
+    Vector<BatchEntry, kMaxEntries> entries_;
+  };
+
+  // Adds or updates several key-value entries as a single transaction. The
+  // entries are appended contiguously to one sector (per redundant copy) with a
+  // single transaction ID. The final entry commits the batch; if the batch is
+  // interrupted before it is committed, none of its entries take effect.
+  //
+  // All entries in the batch, including padding, must fit within one sector.
+  //
+  //                    OK: all entries were successfully added or updated
+  //             DATA_LOSS: checksum validation failed after writing the data
+  //    RESOURCE_EXHAUSTED: there is not enough space to add the entries
+  //        ALREADY_EXISTS: an entry could not be added because a different key
+  //                        with the same hash is already in the KVS
+  //   FAILED_PRECONDITION: the KVS is not initialized
+  //      INVALID_ARGUMENT: the batch is empty or does not fit in a sector, a
+  //                        key is repeated, empty, or too long, or a value is
+  //                        too large
+  //
+  Status PutBatch(std::span<const BatchEntry> entries);
+
+  template <size_t kMaxEntries>
+  Status PutBatch(const Batch<kMaxEntries>& batch) {
+    return PutBatch(batch.entries());
+  }
+
   // Removes a key-value entry from the KVS.
   //
   //                    OK: the entry was successfully added or updated
@@ -211,6 +334,50 @@ class KeyValueStore {
   // that makes sense for the KVS implementation.
   Status PartialMaintenance();
 
+  // Perform a bounded step of garbage collection. Garbage collecting a sector
+  // is split across multiple calls, so StepMaintenance can be called
+  // periodically, such as from an idle task, without blocking for the time it
+  // takes to relocate a full sector. Progress is kept between calls.
+  //
+  // Each call either relocates valid entries out of the sector being garbage
+  // collected, stopping once at least max_bytes_to_relocate bytes of entries
+  // have been moved, or erases the sector once it holds no valid entries. The
+  // sector is not writable while it is being garbage collected. Only sectors
+  // with reclaimable bytes are garbage collected.
+  //
+  // Entries are only relocated to sectors other than the KVS's always free
+  // sector, so the KVS stays consistent if it is reinitialized between steps.
+  // If there is no other space for an entry, the rest of the sector is garbage
+  // collected in one step, as with PartialMaintenance.
+  //
+  // If configured for at least lazy recovery, any needed repair of corruption
+  // is done before starting garbage collection of a new sector.
+  //
+  //                    OK: a step of garbage collection was performed
+  //             NOT_FOUND: there are no sectors with reclaimable bytes
+  //   FAILED_PRECONDITION: the KVS is not initialized
+  //
+  Status StepMaintenance(size_t max_bytes_to_relocate);
+
+  // Writes a checkpoint of the KVS's in-memory state to flash. If the
+  // checkpoint is still current at the next Init, Init restores the state from
+  // it instead of reading and verifying every entry in every sector.
+  //
+  // The checkpoint is written as the only entry in an empty sector. It is
+  // discarded, by erasing its sector, before the next write or erase to the
+  // KVS's flash, so Init only uses a checkpoint that matches the flash
+  // contents. Call WriteCheckpoint after the last update before a reboot, such
+  // as during a controlled shutdown. When Init uses a checkpoint, entries are
+  // not verified until they are read.
+  //
+  //                    OK: the checkpoint was written
+  //    RESOURCE_EXHAUSTED: there is no empty sector for the checkpoint other
+  //                        than the always free sector, or the checkpoint is
+  //                        larger than a sector
+  //   FAILED_PRECONDITION: the KVS is not initialized or needs maintenance
+  //
+  Status WriteCheckpoint();
+
   void LogDebugInfo() const;
 
   // Classes and functions to support STL-style iteration.
@@ -242,6 +409,7 @@ class KeyValueStore {
 
    private:
     friend class iterator;
+    friend class KeyValueStore;
 
     constexpr Item(const KeyValueStore& kvs,
                    const internal::EntryCache::const_iterator& item_iterator)
@@ -296,6 +464,20 @@ class KeyValueStore {
   iterator begin() const;
   iterator end() const { return iterator(*this, entry_cache_.end()); }
 
+  // Calls function(const Item&) for each valid key that starts with the
+  // prefix, in the same order as iteration. Equivalent to iterating over the
+  // KVS and checking each key, except that with Options::key_prefix_index, keys
+  // in other namespaces are not read from flash. Prefixes without a '/' read
+  // every key.
+  template <typename Function>
+  void ForEachWithPrefix(Key prefix, Function&& function) const {
+    for (iterator it = begin(); it != end(); ++it) {
+      if (ReadKeyIfPrefixMatches(it.item_, prefix)) {
+        function(static_cast<const Item&>(it.item_));
+      }
+    }
+  }
+
   // Returns the number of valid entries in the KeyValueStore.
   size_t size() const { return entry_cache_.present_entries(); }
 
@@ -319,6 +501,29 @@ class KeyValueStore {
 
   StorageStats GetStorageStats() const;
 
+  // Flash traffic caused by one kind of operation.
+  struct IoCounters {
+    size_t bytes_read;
+    size_t bytes_written;
+    size_t sector_erases;
+  };
+
+  // Flash traffic split by the operation that caused it, as measured by
+  // FlashPartition::bytes_read() and bytes_written(). Traffic is attributed to
+  // the innermost operation, so garbage collection to make space for a Put is
+  // counted as garbage collection. Reads by Get and iteration, and checkpoint
+  // writes, are not counted. The counters are kept across Init() calls.
+  struct IoStats {
+    IoCounters put;                 // Put, PutBatch, and Delete
+    IoCounters garbage_collection;  // Relocating entries and erasing sectors
+    IoCounters repair;              // Repair and EnsureEntryRedundancy
+    IoCounters init;                // Reading entries in Init
+  };
+
+  IoStats GetIoStats() const { return io_stats_; }
+
+  void ResetIoStats() { io_stats_ = {}; }
+
   // Level of redundancy to use for writing entries.
   size_t redundancy() const { return entry_cache_.redundancy(); }
 
@@ -355,7 +560,8 @@ class KeyValueStore {
                 Vector<SectorDescriptor>& sector_descriptor_list,
                 const SectorDescriptor** temp_sectors_to_skip,
                 Vector<KeyDescriptor>& key_descriptor_list,
-                Address* addresses);
+                Address* addresses,
+                std::span<internal::EntryCache::HashIndexSlot> hash_index);
 
  private:
   using EntryMetadata = internal::EntryMetadata;
@@ -371,8 +577,37 @@ class KeyValueStore {
         "std::as_writable_bytes(std::span(&value, 1)).");
   }
 
+  // Tracks a batch of entries found while loading a sector during Init. The
+  // batch's entries are only loaded once its commit entry is found.
+  struct PendingBatch {
+    bool active;
+    // True if the previous entry in the sector was corrupt. To be safe, a batch
+    // that follows corrupt data is treated as if its first entries were lost.
+    bool follows_corruption;
+    bool intact;
+    Address first_address;
+    uint32_t transaction_id;
+  };
+
   Status InitializeMetadata();
-  Status LoadEntry(Address entry_address, Address* next_entry_address);
+
+  // Restores the sector and entry metadata from a checkpoint written by
+  // WriteCheckpoint. Returns NOT_FOUND if there is no checkpoint, or another
+  // error if the checkpoint cannot be used.
+  Status LoadCheckpoint();
+  Status RestoreCheckpoint(const Entry& checkpoint);
+
+  // Reads the first entry in the sector, if it is a checkpoint entry.
+  Status ReadCheckpointEntry(const SectorDescriptor& sector, Entry* checkpoint);
+
+  // Erases the current checkpoint, if there is one. Called before any change
+  // to flash, since the checkpoint is out of date after the change.
+  Status DiscardCheckpoint();
+  Status LoadEntry(Address entry_address,
+                   Address* next_entry_address,
+                   PendingBatch& pending_batch);
+  Status LoadBatchEntries(Address first_address, Address commit_address);
+  Status AddLoadedEntry(const Entry& entry);
   Status ScanForEntry(const SectorDescriptor& sector,
                       Address start_address,
                       Address* next_entry_address);
@@ -381,6 +616,10 @@ class KeyValueStore {
 
   StatusWithSize ValueSize(const EntryMetadata& metadata) const;
 
+  // Reads the item's key and returns true if it starts with the prefix. The key
+  // is not read if the key prefix index shows that it cannot match.
+  bool ReadKeyIfPrefixMatches(Item& item, Key prefix) const;
+
   Status ReadEntry(const EntryMetadata& metadata, Entry& entry) const;
 
   // Finds the metadata for an entry matching a particular key. Searches for a
@@ -410,6 +649,19 @@ class KeyValueStore {
                      std::span<std::byte> value_buffer,
                      size_t offset_bytes) const;
 
+  // Reads the value from flash, bypassing the value cache. Caches the value if
+  // the whole value is read successfully.
+  StatusWithSize GetFromFlash(Key key,
+                              const EntryMetadata& metadata,
+                              std::span<std::byte> value_buffer,
+                              size_t offset_bytes) const;
+
+  // Reads a value that is stored as a delta chain ending with the newest entry.
+  StatusWithSize GetFromDeltaChain(const Entry& newest,
+                                   const EntryMetadata& metadata,
+                                   std::span<std::byte> value_buffer,
+                                   size_t offset_bytes) const;
+
   Status FixedSizeGet(Key key, void* value, size_t size_bytes) const;
 
   Status FixedSizeGet(Key key,
@@ -427,12 +679,43 @@ class KeyValueStore {
 
   Status WriteEntryForNewKey(Key key, std::span<const std::byte> value);
 
+  Status CheckBatch(std::span<const BatchEntry> entries, size_t* batch_size);
+
+  // Writes a copy of all entries in a batch at the provided address.
+  Status AppendBatch(std::span<const BatchEntry> entries,
+                     Address address,
+                     uint32_t transaction_id);
+
   Status WriteEntry(Key key,
                     std::span<const std::byte> value,
                     EntryState new_state,
                     EntryMetadata* prior_metadata = nullptr,
                     const internal::Entry* prior_entry = nullptr);
 
+  // Determines whether a new value should be written as a delta of the prior
+  // entry. If so, loads the prior value's chain and finds the changes. No
+  // changes means the value is unchanged and nothing needs to be written.
+  bool PlanDeltaEntry(const EntryMetadata& prior_metadata,
+                      const Entry& prior_entry,
+                      EntryState new_state,
+                      std::span<const std::byte> value,
+                      internal::DeltaChain& chain,
+                      internal::DeltaPatches& patches) const;
+
+  Status WriteDeltaEntry(Key key,
+                         std::span<const std::byte> value,
+                         EntryMetadata& prior_metadata,
+                         const Entry& prior_entry,
+                         const internal::DeltaPatches& patches);
+
+  // Removes the valid bytes of the older entries in a key's delta chain, which
+  // become stale once the key is written with a full entry.
+  void ReleaseDeltaChain(const EntryMetadata& metadata);
+
+  // Sets *on_primary to whether all entries in the chain ending with the newest
+  // entry use the primary format.
+  Status DeltaChainOnPrimaryFormat(const Entry& newest, bool* on_primary);
+
   EntryMetadata CreateOrUpdateKeyDescriptor(const Entry& new_entry,
                                             Key key,
                                             EntryMetadata* prior_metadata,
@@ -449,19 +732,44 @@ class KeyValueStore {
                            size_t entry_size,
                            std::span<const Address> addresses_to_skip);
 
+  // Finds space like Sectors::FindSpace, first waiting for the background
+  // erase if there is no other space.
+  Status FindSpaceForWrite(SectorDescriptor** sector,
+                           size_t entry_size,
+                           std::span<const Address> addresses_to_skip);
+
   Status MarkSectorCorruptIfNotOk(Status status, SectorDescriptor* sector);
 
   Status AppendEntry(const Entry& entry,
                      Key key,
                      std::span<const std::byte> value);
 
+  // Checks the result of writing a new entry and updates its sector.
+  Status FinishAppendEntry(const Entry& entry, StatusWithSize write_result);
+
   StatusWithSize CopyEntryToSector(Entry& entry,
                                    SectorDescriptor* new_sector,
                                    Address new_address);
 
+  // Whether relocating an entry may use the sector that is normally kept free
+  // for garbage collection.
+  enum class RelocationSpace {
+    kIncludingFreeSector,
+    kExcludingFreeSector,
+  };
+
   Status RelocateEntry(const EntryMetadata& metadata,
                        KeyValueStore::Address& address,
-                       std::span<const Address> addresses_to_skip);
+                       std::span<const Address> addresses_to_skip,
+                       RelocationSpace space =
+                           RelocationSpace::kIncludingFreeSector);
+
+  // Replaces a delta-encoded value with a full entry, so that the entries in
+  // its chain become stale. The new entries are not written to sector_to_gc.
+  Status CompactDeltaChain(EntryMetadata& metadata,
+                           SectorDescriptor* sector_to_gc,
+                           std::span<const Address> reserved_addresses,
+                           RelocationSpace space);
 
   // Perform all maintenance possible, including all neeeded repairing of
   // corruption and garbage collection of reclaimable space in the KVS. When
@@ -484,12 +792,26 @@ class KeyValueStore {
 
   Status RelocateKeyAddressesInSector(
       SectorDescriptor& sector_to_gc,
-      const EntryMetadata& descriptor,
-      std::span<const Address> addresses_to_skip);
+      EntryMetadata& descriptor,
+      std::span<const Address> addresses_to_skip,
+      RelocationSpace space = RelocationSpace::kIncludingFreeSector);
 
   Status GarbageCollectSector(SectorDescriptor& sector_to_gc,
                               std::span<const Address> addresses_to_skip);
 
+  // Erases a sector that has no valid entries, if it is not already empty. If
+  // Options::erase_in_background is set, the erase may still be in progress
+  // when this returns.
+  Status EraseSectorWithNoValidEntries(SectorDescriptor& sector);
+
+  // Checks whether the background erase, if any, finished. If it did, the
+  // sector is made writable. Returns UNAVAILABLE while the erase is in
+  // progress, or the erase's error if it failed.
+  Status PollBackgroundErase();
+
+  // Waits for the background erase, if any, to finish.
+  Status FinishBackgroundErase();
+
   // Ensure that all entries are on the primary (first) format. Entries that are
   // not on the primary format are rewritten.
   //
@@ -522,8 +844,9 @@ class KeyValueStore {
   // List of sectors used by this KVS.
   internal::Sectors sectors_;
 
-  // Unordered list of KeyDescriptors. Finding a key requires scanning and
-  // verifying a match by reading the actual entry.
+  // Unordered list of KeyDescriptors with a hash index by key hash. Finding a
+  // key requires looking up its hash and verifying a match by reading the
+  // actual entry.
   internal::EntryCache entry_cache_;
 
   Options options_;
@@ -559,7 +882,54 @@ class KeyValueStore {
   };
   InternalStats internal_stats_;
 
+  enum class IoCause { kNone, kPut, kGarbageCollection, kRepair, kInit };
+
+  // Attributes the flash traffic while it is in scope to a cause. Scopes nest,
+  // and traffic is attributed to the innermost scope.
+  class IoScope {
+   public:
+    IoScope(KeyValueStore& kvs, IoCause cause)
+        : kvs_(kvs), previous_cause_(kvs.io_cause_) {
+      kvs_.SetIoCause(cause);
+    }
+
+    ~IoScope() { kvs_.SetIoCause(previous_cause_); }
+
+    IoScope(const IoScope&) = delete;
+    IoScope& operator=(const IoScope&) = delete;
+
+   private:
+    KeyValueStore& kvs_;
+    const IoCause previous_cause_;
+  };
+
+  // Adds the traffic since the last cause change to the current cause's
+  // counters, then changes the cause.
+  void SetIoCause(IoCause cause);
+
+  // The counters for the current cause, or nullptr if there is none.
+  IoCounters* CurrentIoCounters();
+
+  IoStats io_stats_;
+  IoCause io_cause_;
+  size_t io_bytes_read_mark_;
+  size_t io_bytes_written_mark_;
+
   uint32_t last_transaction_id_;
+
+  // The sector StepMaintenance is garbage collecting, or nullptr if none, and
+  // the index of the next entry to check for relocation out of it.
+  SectorDescriptor* step_gc_sector_;
+  size_t step_gc_next_entry_;
+
+  // The sector holding a checkpoint that matches the flash contents, or
+  // nullptr if there is none. The sector is not writable while it holds the
+  // checkpoint.
+  SectorDescriptor* checkpoint_sector_;
+
+  // The sector being erased in the background, or nullptr if none. The sector
+  // is not writable until the erase finishes.
+  SectorDescriptor* erasing_sector_;
 };
 
 template <size_t kMaxEntries,
@@ -594,7 +964,8 @@ class KeyValueStoreBuffer : public KeyValueStore {
                       sectors_,
                       temp_sectors_to_skip_,
                       key_descriptors_,
-                      addresses_) {
+                      addresses_,
+                      hash_index_) {
     std::copy(formats.begin(), formats.end(), formats_.begin());
   }
 
@@ -603,6 +974,9 @@ class KeyValueStoreBuffer : public KeyValueStore {
   static_assert(kMaxUsableSectors > 0u);
   static_assert(kRedundancy > 0u);
   static_assert(kEntryFormats > 0u);
+  static_assert(kMaxEntries < std::numeric_limits<
+                                  internal::EntryCache::HashIndexSlot>::max(),
+                "kMaxEntries is too large for the EntryCache hash index");
 
   Vector<SectorDescriptor, kMaxUsableSectors> sectors_;
 
@@ -623,6 +997,10 @@ class KeyValueStoreBuffer : public KeyValueStore {
   // KeyDescriptors.
   internal::EntryCache::AddressList<kRedundancy, kMaxEntries> addresses_;
 
+  // Hash index of the KeyDescriptors, which makes finding a key's descriptor
+  // O(1) instead of a scan of all KeyDescriptors.
+  internal::EntryCache::HashIndex<kMaxEntries> hash_index_;
+
   // EntryFormats that can be read by this KeyValueStore.
   std::array<EntryFormat, kEntryFormats> formats_;
 };
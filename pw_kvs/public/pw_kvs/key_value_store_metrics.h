@@ -0,0 +1,86 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "pw_kvs/key_value_store.h"
+#include "pw_metric/metric.h"
+
+namespace pw::kvs {
+
+// Exports a KeyValueStore's flash traffic counters as pw_metric metrics, so
+// they can be reported remotely through the MetricService. Add metrics() to the
+// group served by the MetricService, and call Update() to copy the KVS's
+// current counters into the metrics, such as before the metrics are read.
+//
+// The write amplification of Put is the sum of the *_bytes_written metrics
+// divided by put_bytes_written.
+class KeyValueStoreMetrics {
+ public:
+  KeyValueStoreMetrics(const KeyValueStore& kvs) : kvs_(kvs) {}
+
+  KeyValueStoreMetrics(const KeyValueStoreMetrics&) = delete;
+  KeyValueStoreMetrics& operator=(const KeyValueStoreMetrics&) = delete;
+
+  metric::Group& metrics() { return metrics_; }
+  const metric::Group& metrics() const { return metrics_; }
+
+  // Copies the KVS's IoStats and sector erase count into the metrics. Values
+  // larger than a uint32_t are saturated.
+  void Update() {
+    const KeyValueStore::IoStats stats = kvs_.GetIoStats();
+    Set(put_bytes_read_, stats.put.bytes_read);
+    Set(put_bytes_written_, stats.put.bytes_written);
+    Set(put_sector_erases_, stats.put.sector_erases);
+    Set(gc_bytes_read_, stats.garbage_collection.bytes_read);
+    Set(gc_bytes_written_, stats.garbage_collection.bytes_written);
+    Set(gc_sector_erases_, stats.garbage_collection.sector_erases);
+    Set(repair_bytes_read_, stats.repair.bytes_read);
+    Set(repair_bytes_written_, stats.repair.bytes_written);
+    Set(repair_sector_erases_, stats.repair.sector_erases);
+    Set(init_bytes_read_, stats.init.bytes_read);
+    Set(init_bytes_written_, stats.init.bytes_written);
+    Set(init_sector_erases_, stats.init.sector_erases);
+    Set(sector_erases_, kvs_.GetStorageStats().sector_erase_count);
+  }
+
+ private:
+  static void Set(metric::TypedMetric<uint32_t>& metric, size_t value) {
+    metric.Set(value > std::numeric_limits<uint32_t>::max()
+                   ? std::numeric_limits<uint32_t>::max()
+                   : static_cast<uint32_t>(value));
+  }
+
+  const KeyValueStore& kvs_;
+
+  PW_METRIC_GROUP(metrics_, "kvs");
+  PW_METRIC(metrics_, put_bytes_read_, "put_bytes_read", 0u);
+  PW_METRIC(metrics_, put_bytes_written_, "put_bytes_written", 0u);
+  PW_METRIC(metrics_, put_sector_erases_, "put_sector_erases", 0u);
+  PW_METRIC(metrics_, gc_bytes_read_, "gc_bytes_read", 0u);
+  PW_METRIC(metrics_, gc_bytes_written_, "gc_bytes_written", 0u);
+  PW_METRIC(metrics_, gc_sector_erases_, "gc_sector_erases", 0u);
+  PW_METRIC(metrics_, repair_bytes_read_, "repair_bytes_read", 0u);
+  PW_METRIC(metrics_, repair_bytes_written_, "repair_bytes_written", 0u);
+  PW_METRIC(metrics_, repair_sector_erases_, "repair_sector_erases", 0u);
+  PW_METRIC(metrics_, init_bytes_read_, "init_bytes_read", 0u);
+  PW_METRIC(metrics_, init_bytes_written_, "init_bytes_written", 0u);
+  PW_METRIC(metrics_, init_sector_erases_, "init_sector_erases", 0u);
+  PW_METRIC(metrics_, sector_erases_, "sector_erases", 0u);
+};
+
+}  // namespace pw::kvs
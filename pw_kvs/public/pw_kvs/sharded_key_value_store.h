@@ -0,0 +1,193 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+#include "pw_kvs/internal/hash.h"
+#include "pw_kvs/key.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw {
+namespace kvs {
+
+// A key-value store made of several KeyValueStores, called shards, each on its
+// own flash partition. Each key is stored in one shard, selected by the key's
+// hash, so the shards may be on flash banks that are programmed and erased
+// independently.
+//
+// The shards do not share any state. Writes and garbage collection in one shard
+// do not access the other shards. KeyValueStore is not thread safe, but
+// operations on keys in different shards may run concurrently if each shard is
+// protected by its own lock.
+//
+// The shards must be used only through the ShardedKeyValueStore, other than
+// for shard-specific operations like maintenance, since keys are looked up in
+// the shard their hash selects. Adding or removing shards changes which shard
+// most keys belong to.
+class ShardedKeyValueStore {
+ public:
+  // The shards are referenced, not copied, and must outlive the
+  // ShardedKeyValueStore. There must be at least one shard.
+  constexpr ShardedKeyValueStore(std::span<KeyValueStore* const> shards)
+      : shards_(shards) {}
+
+  // Initializes each shard. Every shard is initialized, even if another shard
+  // fails to initialize. Returns the first error, as described for
+  // KeyValueStore::Init.
+  Status Init() { return ForEachShard(&KeyValueStore::Init); }
+
+  // True if every shard is initialized.
+  bool initialized() const;
+
+  // Equivalent to KeyValueStore::Get on the key's shard.
+  StatusWithSize Get(Key key,
+                     std::span<std::byte> value,
+                     size_t offset_bytes = 0) const {
+    return shard(key).Get(key, value, offset_bytes);
+  }
+
+  template <typename Pointer,
+            typename = std::enable_if_t<std::is_pointer<Pointer>::value>>
+  Status Get(const Key& key, const Pointer& pointer) const {
+    return shard(key).Get(key, pointer);
+  }
+
+  // Equivalent to KeyValueStore::GetMapped on the key's shard.
+  Status GetMapped(Key key, std::span<const std::byte>* value) const {
+    return shard(key).GetMapped(key, value);
+  }
+
+  // Equivalent to KeyValueStore::Put on the key's shard. Keys only need unique
+  // hashes within their shard, but since the shard is selected by the hash,
+  // keys with the same hash are always in the same shard.
+  template <typename T>
+  Status Put(const Key& key, const T& value) {
+    return shard(key).Put(key, value);
+  }
+
+  // Equivalent to KeyValueStore::Delete on the key's shard.
+  Status Delete(Key key) { return shard(key).Delete(key); }
+
+  // Equivalent to KeyValueStore::ValueSize on the key's shard.
+  StatusWithSize ValueSize(Key key) const { return shard(key).ValueSize(key); }
+
+  // Performs the maintenance on every shard, even if it fails for a shard.
+  // Returns the first error.
+  Status HeavyMaintenance() {
+    return ForEachShard(&KeyValueStore::HeavyMaintenance);
+  }
+
+  Status FullMaintenance() {
+    return ForEachShard(&KeyValueStore::FullMaintenance);
+  }
+
+  Status PartialMaintenance() {
+    return ForEachShard(&KeyValueStore::PartialMaintenance);
+  }
+
+  // Performs a step of garbage collection on every shard that has reclaimable
+  // bytes. Returns NOT_FOUND if no shard has reclaimable bytes, or the first
+  // other error, as described for KeyValueStore::StepMaintenance.
+  Status StepMaintenance(size_t max_bytes_to_relocate);
+
+  // The shard that holds the key.
+  KeyValueStore& shard(Key key) const { return *shards_[ShardIndex(key)]; }
+
+  // The index in shards() of the shard that holds the key. The shard is chosen
+  // from the high bits of the hash, since each shard's entry cache indexes its
+  // keys by the low bits.
+  size_t ShardIndex(Key key) const {
+    return static_cast<size_t>(
+        (uint64_t(internal::Hash(key)) * shards_.size()) >> 32);
+  }
+
+  std::span<KeyValueStore* const> shards() const { return shards_; }
+
+  // Iterates over the items in each shard in turn. Items are not in any
+  // particular order.
+  class iterator {
+   public:
+    iterator& operator++();
+
+    iterator& operator++(int) { return operator++(); }
+
+    const KeyValueStore::Item& operator*() { return **shard_iterator_; }
+
+    const KeyValueStore::Item* operator->() { return &operator*(); }
+
+    bool operator==(const iterator& rhs) const {
+      return shard_index_ == rhs.shard_index_ &&
+             *shard_iterator_ == *rhs.shard_iterator_;
+    }
+
+    bool operator!=(const iterator& rhs) const { return !(*this == rhs); }
+
+   private:
+    friend class ShardedKeyValueStore;
+
+    iterator(std::span<KeyValueStore* const> shards,
+             size_t shard_index,
+             const KeyValueStore::iterator& shard_iterator)
+        : shards_(shards), shard_index_(shard_index) {
+      shard_iterator_.emplace(shard_iterator);
+    }
+
+    // Moves to the next shard until there is an item or no shards remain.
+    void SkipEmptyShards();
+
+    std::span<KeyValueStore* const> shards_;
+    size_t shard_index_;
+
+    // KeyValueStore::iterator is not assignable, so it is re-created in place
+    // when moving to the next shard.
+    std::optional<KeyValueStore::iterator> shard_iterator_;
+  };
+
+  using const_iterator = iterator;  // Standard alias for iterable types.
+
+  iterator begin() const;
+  iterator end() const {
+    return iterator(shards_, shards_.size() - 1, shards_.back()->end());
+  }
+
+  // The total number of valid entries in all shards.
+  size_t size() const;
+
+  size_t max_size() const;
+
+  bool empty() const { return size() == 0u; }
+
+  // The sum of every shard's storage stats.
+  KeyValueStore::StorageStats GetStorageStats() const;
+
+  // True if an error was detected in any shard.
+  bool error_detected() const;
+
+ private:
+  // Calls the operation on every shard, even if it fails for a shard. Returns
+  // the first error.
+  Status ForEachShard(Status (KeyValueStore::*operation)());
+
+  std::span<KeyValueStore* const> shards_;
+};
+
+}  // namespace kvs
+}  // namespace pw
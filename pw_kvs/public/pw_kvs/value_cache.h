@@ -0,0 +1,123 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace pw::kvs {
+
+// Optional RAM cache of recently read values. Keys that are read frequently
+// but rarely written can be served from RAM instead of flash. Values are cached
+// by the index of their KeyDescriptor and are invalidated when the key is
+// written, deleted, or relocated by garbage collection.
+//
+// A ValueCache is provided to a KeyValueStore through Options::value_cache. It
+// is declared as a ValueCacheBuffer, which allocates the cache's storage.
+class ValueCache {
+ public:
+  // Metadata for a cached value.
+  struct Slot {
+    uint32_t transaction_id;
+    uint16_t descriptor_index;
+    uint16_t value_size;
+  };
+
+  static constexpr uint16_t kEmptySlot = UINT16_MAX;
+
+  // The number of values in the cache.
+  size_t slot_count() const { return slots_.size(); }
+
+  // The largest value that is cached. Larger values are always read from
+  // flash.
+  size_t max_value_size() const { return max_value_size_; }
+
+  // The number of reads that were served from the cache.
+  uint32_t hits() const { return hits_; }
+
+  // The number of reads of cacheable values that had to go to flash.
+  uint32_t misses() const { return misses_; }
+
+  void ResetCounters() {
+    hits_ = 0;
+    misses_ = 0;
+  }
+
+  // Removes all values from the cache.
+  void Clear();
+
+  // Sets *value to the cached value for the descriptor and returns true if it
+  // is cached. The value is only found if it was cached for the same
+  // transaction ID. Counts a hit or a miss.
+  bool Find(size_t descriptor_index,
+            uint32_t transaction_id,
+            std::span<const std::byte>* value);
+
+  // Caches a value for the descriptor, replacing any value already cached for
+  // it. If the cache is full, values are evicted in round-robin order.
+  // Values larger than max_value_size() are not cached.
+  void Store(size_t descriptor_index,
+             uint32_t transaction_id,
+             std::span<const std::byte> value);
+
+  // Removes the value for the descriptor from the cache, if present.
+  void Invalidate(size_t descriptor_index);
+
+ protected:
+  constexpr ValueCache(std::span<Slot> slots,
+                       std::byte* values,
+                       size_t max_value_size)
+      : slots_(slots),
+        values_(values),
+        max_value_size_(max_value_size),
+        next_eviction_(0),
+        hits_(0),
+        misses_(0) {}
+
+ private:
+  // Returns the slot with the descriptor index, or nullptr if there is none.
+  // Finds an unused slot if descriptor_index is kEmptySlot.
+  Slot* FindSlot(uint16_t descriptor_index);
+
+  std::byte* value(const Slot& slot) const {
+    return &values_[(&slot - slots_.data()) * max_value_size_];
+  }
+
+  const std::span<Slot> slots_;
+  std::byte* const values_;
+  const size_t max_value_size_;
+
+  size_t next_eviction_;
+  uint32_t hits_;
+  uint32_t misses_;
+};
+
+template <size_t kSlots, size_t kMaxValueSizeBytes>
+class ValueCacheBuffer : public ValueCache {
+ public:
+  ValueCacheBuffer() : ValueCache(slots_, values_, kMaxValueSizeBytes) {
+    Clear();
+  }
+
+ private:
+  static_assert(kSlots > 0u);
+  static_assert(kMaxValueSizeBytes > 0u);
+  static_assert(kMaxValueSizeBytes < UINT16_MAX);
+
+  Slot slots_[kSlots];
+  std::byte values_[kSlots * kMaxValueSizeBytes];
+};
+
+}  // namespace pw::kvs
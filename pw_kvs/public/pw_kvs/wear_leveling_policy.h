@@ -0,0 +1,34 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+namespace pw::kvs {
+
+// Provides per-sector wear information to the KVS. When a policy is set in the
+// KVS Options, sector selection for new writes and for garbage collection
+// prefers sectors with lower wear. Without a policy, sectors are selected by
+// rotating through the partition.
+class WearLevelingPolicy {
+ public:
+  virtual ~WearLevelingPolicy() = default;
+
+  // Returns a relative measure of how worn a sector is, such as its erase
+  // count. Lower values are less worn. The index is relative to the start of
+  // the KVS's partition.
+  virtual size_t SectorWear(size_t sector_index) const = 0;
+};
+
+}  // namespace pw::kvs
@@ -30,8 +30,21 @@
 static_assert((PW_KVS_MAX_FLASH_ALIGNMENT >= 16UL),
               "Max flash alignment is required to be at least 16");
 
+// The size of the stack buffer used to read entries when verifying their
+// checksums and when scanning sectors for entries. Larger buffers need fewer
+// flash reads.
+#ifndef PW_KVS_READ_BUFFER_SIZE_BYTES
+#define PW_KVS_READ_BUFFER_SIZE_BYTES 128UL
+#endif  // PW_KVS_READ_BUFFER_SIZE_BYTES
+
+static_assert((PW_KVS_READ_BUFFER_SIZE_BYTES >= 32UL) &&
+                  (PW_KVS_READ_BUFFER_SIZE_BYTES % 16UL == 0UL),
+              "The read buffer size must be a multiple of 16 and at least 32");
+
 namespace pw::kvs {
 
 inline constexpr size_t kMaxFlashAlignment = PW_KVS_MAX_FLASH_ALIGNMENT;
 
+inline constexpr size_t kReadBufferSizeBytes = PW_KVS_READ_BUFFER_SIZE_BYTES;
+
 }  // namespace pw::kvs
@@ -127,16 +127,19 @@ Status Sectors::Find(FindMode find_mode,
         first_empty_sector = sector;
       } else {
         at_least_two_empty_sectors = true;
+        if (Wear(*sector) < Wear(*first_empty_sector)) {
+          first_empty_sector = sector;
+        }
       }
     }
   }
 
   // Tier 2 check: If the scan for a partial sector does not find a suitable
-  // sector, use the first empty sector that was found. Normally it is required
-  // to keep 1 empty sector after the sector found here, but that rule does not
-  // apply during GC.
+  // sector, use the least worn empty sector that was found, preferring the
+  // first one found on ties. Normally it is required to keep 1 empty sector
+  // after the sector found here, but that rule does not apply during GC.
   if (first_empty_sector != nullptr && at_least_two_empty_sectors) {
-    DBG("  Found a usable empty sector; returning the first found (%u)",
+    DBG("  Found a usable empty sector; returning the least worn (%u)",
         Index(first_empty_sector));
     last_new_ = first_empty_sector;
     *found_sector = first_empty_sector;
@@ -179,29 +182,39 @@ SectorDescriptor* Sectors::FindSectorToGarbageCollect(
                                   reserved_addresses.size());
 
   // Step 1: Try to find a sectors with stale keys and no valid keys (no
-  // relocation needed). Use the first such sector found, as that will help the
-  // KVS "rotate" around the partition. Initially this would select the sector
-  // with the most reclaimable space, but that can cause GC sector selection to
-  // "ping-pong" between two sectors when updating large keys.
+  // relocation needed). Use the least worn such sector, preferring the first
+  // one found on ties, as that will help the KVS "rotate" around the partition.
+  // Initially this would select the sector with the most reclaimable space, but
+  // that can cause GC sector selection to "ping-pong" between two sectors when
+  // updating large keys.
   for (size_t i = 0; i < descriptors_.size(); ++i) {
     SectorDescriptor& sector = WearLeveledSectorFromIndex(i);
     if ((sector.valid_bytes() == 0) &&
         (sector.RecoverableBytes(sector_size_bytes) > 0) &&
-        !Contains(sectors_to_skip, &sector)) {
+        !Contains(sectors_to_skip, &sector) &&
+        (sector_candidate == nullptr ||
+         Wear(sector) < Wear(*sector_candidate))) {
       sector_candidate = &sector;
-      break;
+      if (wear_leveling_policy_ == nullptr) {
+        break;
+      }
     }
   }
 
   // Step 2: If step 1 yields no sectors, just find the sector with the most
-  // reclaimable bytes but no addresses to avoid.
+  // reclaimable bytes but no addresses to avoid. Break ties with the least
+  // worn sector.
   if (sector_candidate == nullptr) {
     for (size_t i = 0; i < descriptors_.size(); ++i) {
       SectorDescriptor& sector = WearLeveledSectorFromIndex(i);
-      if ((sector.RecoverableBytes(sector_size_bytes) > candidate_bytes) &&
+      const size_t recoverable_bytes =
+          sector.RecoverableBytes(sector_size_bytes);
+      if ((recoverable_bytes > candidate_bytes ||
+           (recoverable_bytes > 0 && recoverable_bytes == candidate_bytes &&
+            Wear(sector) < Wear(*sector_candidate))) &&
           !Contains(sectors_to_skip, &sector)) {
         sector_candidate = &sector;
-        candidate_bytes = sector.RecoverableBytes(sector_size_bytes);
+        candidate_bytes = recoverable_bytes;
       }
     }
   }
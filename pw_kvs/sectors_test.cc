@@ -14,6 +14,8 @@
 
 #include "pw_kvs/internal/sectors.h"
 
+#include <array>
+
 #include "gtest/gtest.h"
 #include "pw_kvs/fake_flash_memory.h"
 
@@ -79,8 +81,113 @@ TEST_F(SectorsTest, NextWritableAddress_PartiallyWrittenSector) {
   EXPECT_EQ(123u, sectors_.NextWritableAddress(*sectors_.begin()));
 }
 
-// TODO: Add tests for FindSpace, FindSpaceDuringGarbageCollection, and
-// FindSectorToGarbageCollect.
+TEST_F(SectorsTest, FindSpace_WithoutWearPolicy_RotatesFromLastNew) {
+  SectorDescriptor* found = nullptr;
+  ASSERT_EQ(OkStatus(), sectors_.FindSpace(&found, 32, {}));
+  EXPECT_EQ(1u, sectors_.Index(found));
+}
+
+TEST_F(SectorsTest, FindSectorToGarbageCollect_WithoutWearPolicy_FirstStale) {
+  sectors_.FromAddress(2 * 128).RemoveWritableBytes(64);
+  sectors_.FromAddress(7 * 128).RemoveWritableBytes(64);
+
+  SectorDescriptor* found = sectors_.FindSectorToGarbageCollect({});
+  ASSERT_NE(nullptr, found);
+  EXPECT_EQ(2u, sectors_.Index(found));
+}
+
+class FakeWearLevelingPolicy : public WearLevelingPolicy {
+ public:
+  FakeWearLevelingPolicy() { wear.fill(10); }
+
+  size_t SectorWear(size_t sector_index) const override {
+    return wear[sector_index];
+  }
+
+  std::array<size_t, 16> wear;
+};
+
+class SectorsWearTest : public ::testing::Test {
+ protected:
+  SectorsWearTest()
+      : partition_(&flash_),
+        sectors_(sector_descriptors_,
+                 partition_,
+                 temp_sectors_to_skip_,
+                 &policy_) {
+    sectors_.Reset();
+  }
+
+  FakeFlashMemoryBuffer<128, 16> flash_;
+  FlashPartition partition_;
+  FakeWearLevelingPolicy policy_;
+  Vector<SectorDescriptor, 32> sector_descriptors_;
+  const SectorDescriptor* temp_sectors_to_skip_[2];
+  Sectors sectors_;
+};
+
+TEST_F(SectorsWearTest, FindSpace_PrefersLeastWornEmptySector) {
+  policy_.wear[5] = 1;
+  policy_.wear[12] = 3;
+
+  SectorDescriptor* found = nullptr;
+  ASSERT_EQ(OkStatus(), sectors_.FindSpace(&found, 32, {}));
+  EXPECT_EQ(5u, sectors_.Index(found));
+  EXPECT_EQ(found, sectors_.last_new());
+}
+
+TEST_F(SectorsWearTest, FindSpace_PrefersPartialSectorOverLessWornEmpty) {
+  policy_.wear[5] = 1;
+  sectors_.FromAddress(9 * 128).RemoveWritableBytes(32);
+  sectors_.FromAddress(9 * 128).AddValidBytes(32);
+
+  SectorDescriptor* found = nullptr;
+  ASSERT_EQ(OkStatus(), sectors_.FindSpace(&found, 32, {}));
+  EXPECT_EQ(9u, sectors_.Index(found));
+}
+
+TEST_F(SectorsWearTest, FindSpace_EqualWear_RotatesFromLastNew) {
+  SectorDescriptor* found = nullptr;
+  ASSERT_EQ(OkStatus(), sectors_.FindSpace(&found, 32, {}));
+  EXPECT_EQ(1u, sectors_.Index(found));
+}
+
+TEST_F(SectorsWearTest, FindSectorToGarbageCollect_PrefersLeastWornStale) {
+  policy_.wear[7] = 2;
+  sectors_.FromAddress(2 * 128).RemoveWritableBytes(64);
+  sectors_.FromAddress(7 * 128).RemoveWritableBytes(64);
+
+  SectorDescriptor* found = sectors_.FindSectorToGarbageCollect({});
+  ASSERT_NE(nullptr, found);
+  EXPECT_EQ(7u, sectors_.Index(found));
+}
+
+TEST_F(SectorsWearTest, FindSectorToGarbageCollect_SkipsReservedSectors) {
+  policy_.wear[7] = 2;
+  sectors_.FromAddress(2 * 128).RemoveWritableBytes(64);
+  sectors_.FromAddress(7 * 128).RemoveWritableBytes(64);
+
+  const FlashPartition::Address reserved[] = {7 * 128};
+
+  SectorDescriptor* found = sectors_.FindSectorToGarbageCollect(reserved);
+  ASSERT_NE(nullptr, found);
+  EXPECT_EQ(2u, sectors_.Index(found));
+}
+
+TEST_F(SectorsWearTest, FindSectorToGarbageCollect_BreaksTiesByWear) {
+  policy_.wear[9] = 4;
+  for (size_t index : {3u, 9u}) {
+    SectorDescriptor& sector = sectors_.FromAddress(index * 128);
+    sector.RemoveWritableBytes(96);
+    sector.AddValidBytes(32);
+  }
+
+  SectorDescriptor* found = sectors_.FindSectorToGarbageCollect({});
+  ASSERT_NE(nullptr, found);
+  EXPECT_EQ(9u, sectors_.Index(found));
+}
+
+// TODO: Add tests for FindSpaceDuringGarbageCollection.
 
 }  // namespace
 }  // namespace pw::kvs::internal
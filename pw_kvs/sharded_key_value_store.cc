@@ -0,0 +1,114 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/sharded_key_value_store.h"
+
+namespace pw::kvs {
+
+bool ShardedKeyValueStore::initialized() const {
+  for (const KeyValueStore* shard : shards_) {
+    if (!shard->initialized()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Status ShardedKeyValueStore::ForEachShard(
+    Status (KeyValueStore::*operation)()) {
+  Status overall_status = OkStatus();
+  for (KeyValueStore* shard : shards_) {
+    const Status status = (shard->*operation)();
+    if (overall_status.ok()) {
+      overall_status = status;
+    }
+  }
+  return overall_status;
+}
+
+Status ShardedKeyValueStore::StepMaintenance(size_t max_bytes_to_relocate) {
+  Status overall_status = Status::NotFound();
+  for (KeyValueStore* shard : shards_) {
+    const Status status = shard->StepMaintenance(max_bytes_to_relocate);
+    if (status.IsNotFound()) {
+      continue;
+    }
+    if (overall_status.ok() || overall_status.IsNotFound()) {
+      overall_status = status;
+    }
+  }
+  return overall_status;
+}
+
+ShardedKeyValueStore::iterator& ShardedKeyValueStore::iterator::operator++() {
+  ++*shard_iterator_;
+  SkipEmptyShards();
+  return *this;
+}
+
+void ShardedKeyValueStore::iterator::SkipEmptyShards() {
+  while (*shard_iterator_ == shards_[shard_index_]->end() &&
+         shard_index_ + 1 < shards_.size()) {
+    shard_index_ += 1;
+    shard_iterator_.emplace(shards_[shard_index_]->begin());
+  }
+}
+
+ShardedKeyValueStore::iterator ShardedKeyValueStore::begin() const {
+  iterator it(shards_, 0, shards_.front()->begin());
+  it.SkipEmptyShards();
+  return it;
+}
+
+size_t ShardedKeyValueStore::size() const {
+  size_t total = 0;
+  for (const KeyValueStore* shard : shards_) {
+    total += shard->size();
+  }
+  return total;
+}
+
+size_t ShardedKeyValueStore::max_size() const {
+  size_t total = 0;
+  for (const KeyValueStore* shard : shards_) {
+    total += shard->max_size();
+  }
+  return total;
+}
+
+KeyValueStore::StorageStats ShardedKeyValueStore::GetStorageStats() const {
+  KeyValueStore::StorageStats total = {};
+  for (const KeyValueStore* shard : shards_) {
+    const KeyValueStore::StorageStats stats = shard->GetStorageStats();
+    total.writable_bytes += stats.writable_bytes;
+    total.in_use_bytes += stats.in_use_bytes;
+    total.reclaimable_bytes += stats.reclaimable_bytes;
+    total.sector_erase_count += stats.sector_erase_count;
+    total.corrupt_sectors_recovered += stats.corrupt_sectors_recovered;
+    total.missing_redundant_entries_recovered +=
+        stats.missing_redundant_entries_recovered;
+  }
+  return total;
+}
+
+bool ShardedKeyValueStore::error_detected() const {
+  for (const KeyValueStore* shard : shards_) {
+    if (shard->error_detected()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace pw::kvs
@@ -0,0 +1,191 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/sharded_key_value_store.h"
+
+#include <array>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+
+namespace pw::kvs {
+namespace {
+
+constexpr size_t kMaxEntries = 16;
+constexpr size_t kSectors = 4;
+
+ChecksumCrc16 checksum;
+
+// For KVS magic value always use a random 32 bit integer rather than a
+// human readable 4 bytes. See pw_kvs/format.h for more information.
+constexpr EntryFormat kFormat{.magic = 0x1e6ba9c1, .checksum = &checksum};
+
+constexpr const char* kKeys[] = {
+    "zero", "one", "two", "three", "four", "five", "six", "seven"};
+
+class ShardedKeyValueStoreTest : public ::testing::Test {
+ protected:
+  ShardedKeyValueStoreTest()
+      : flash_{FakeFlashMemoryBuffer<512, kSectors>(16),
+               FakeFlashMemoryBuffer<512, kSectors>(16)},
+        partitions_{FlashPartition(&flash_[0]), FlashPartition(&flash_[1])},
+        shards_{KeyValueStoreBuffer<kMaxEntries, kSectors>(&partitions_[0],
+                                                           kFormat),
+                KeyValueStoreBuffer<kMaxEntries, kSectors>(&partitions_[1],
+                                                           kFormat)},
+        shard_pointers_{&shards_[0], &shards_[1]},
+        kvs_(shard_pointers_) {}
+
+  void SetUp() override {
+    for (FlashPartition& partition : partitions_) {
+      ASSERT_EQ(OkStatus(), partition.Erase());
+    }
+    ASSERT_EQ(OkStatus(), kvs_.Init());
+  }
+
+  std::array<FakeFlashMemoryBuffer<512, kSectors>, 2> flash_;
+  std::array<FlashPartition, 2> partitions_;
+  std::array<KeyValueStoreBuffer<kMaxEntries, kSectors>, 2> shards_;
+  std::array<KeyValueStore*, 2> shard_pointers_;
+  ShardedKeyValueStore kvs_;
+};
+
+TEST_F(ShardedKeyValueStoreTest, Init) {
+  EXPECT_TRUE(kvs_.initialized());
+  EXPECT_TRUE(kvs_.empty());
+  EXPECT_EQ(2 * kMaxEntries, kvs_.max_size());
+}
+
+TEST_F(ShardedKeyValueStoreTest, PutAndGet_StoredInKeyShard) {
+  for (uint32_t i = 0; i < std::size(kKeys); ++i) {
+    ASSERT_EQ(OkStatus(), kvs_.Put(kKeys[i], i));
+  }
+  EXPECT_EQ(std::size(kKeys), kvs_.size());
+
+  size_t keys_in_shard[2] = {};
+  for (uint32_t i = 0; i < std::size(kKeys); ++i) {
+    const size_t index = kvs_.ShardIndex(kKeys[i]);
+    ASSERT_LT(index, 2u);
+    keys_in_shard[index] += 1;
+
+    // The key is only in its own shard.
+    uint32_t value = 0;
+    ASSERT_EQ(OkStatus(), kvs_.Get(kKeys[i], &value));
+    EXPECT_EQ(i, value);
+    ASSERT_EQ(OkStatus(), shards_[index].Get(kKeys[i], &value));
+    EXPECT_EQ(Status::NotFound(), shards_[1 - index].Get(kKeys[i], &value));
+    EXPECT_EQ(sizeof(value), kvs_.ValueSize(kKeys[i]).size());
+  }
+
+  // Both shards are used by this set of keys.
+  EXPECT_EQ(keys_in_shard[0], shards_[0].size());
+  EXPECT_EQ(keys_in_shard[1], shards_[1].size());
+  EXPECT_NE(0u, shards_[0].size());
+  EXPECT_NE(0u, shards_[1].size());
+}
+
+TEST_F(ShardedKeyValueStoreTest, Delete) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", uint32_t(5)));
+  ASSERT_EQ(OkStatus(), kvs_.Delete("key"));
+
+  uint32_t value;
+  EXPECT_EQ(Status::NotFound(), kvs_.Get("key", &value));
+  EXPECT_EQ(Status::NotFound(), kvs_.Delete("key"));
+  EXPECT_TRUE(kvs_.empty());
+}
+
+TEST_F(ShardedKeyValueStoreTest, Iteration_VisitsEveryShard) {
+  EXPECT_EQ(kvs_.begin(), kvs_.end());
+
+  for (uint32_t i = 0; i < std::size(kKeys); ++i) {
+    ASSERT_EQ(OkStatus(), kvs_.Put(kKeys[i], i));
+  }
+
+  bool found[std::size(kKeys)] = {};
+  size_t count = 0;
+  for (const KeyValueStore::Item& item : kvs_) {
+    count += 1;
+
+    uint32_t value = 0;
+    ASSERT_EQ(OkStatus(), item.Get(&value));
+    ASSERT_LT(value, std::size(kKeys));
+    EXPECT_STREQ(kKeys[value], item.key());
+    EXPECT_FALSE(found[value]);
+    found[value] = true;
+  }
+  EXPECT_EQ(std::size(kKeys), count);
+}
+
+TEST_F(ShardedKeyValueStoreTest, Iteration_SkipsEmptyShards) {
+  // Put a key in only the second shard.
+  const char* key = nullptr;
+  for (const char* candidate : kKeys) {
+    if (kvs_.ShardIndex(candidate) == 1u) {
+      key = candidate;
+      break;
+    }
+  }
+  ASSERT_NE(nullptr, key);
+  ASSERT_EQ(OkStatus(), kvs_.Put(key, uint32_t(1)));
+
+  ShardedKeyValueStore::iterator it = kvs_.begin();
+  ASSERT_NE(kvs_.end(), it);
+  EXPECT_STREQ(key, it->key());
+  ++it;
+  EXPECT_EQ(kvs_.end(), it);
+}
+
+TEST_F(ShardedKeyValueStoreTest, Maintenance_AllShards) {
+  // Rewrite every key to leave stale entries in both shards.
+  for (uint32_t i = 0; i < std::size(kKeys); ++i) {
+    ASSERT_EQ(OkStatus(), kvs_.Put(kKeys[i], i));
+    ASSERT_EQ(OkStatus(), kvs_.Put(kKeys[i], i + 1));
+  }
+  EXPECT_NE(0u, shards_[0].GetStorageStats().reclaimable_bytes);
+  EXPECT_NE(0u, shards_[1].GetStorageStats().reclaimable_bytes);
+
+  ASSERT_EQ(OkStatus(), kvs_.HeavyMaintenance());
+
+  const KeyValueStore::StorageStats stats = kvs_.GetStorageStats();
+  EXPECT_EQ(0u, stats.reclaimable_bytes);
+  EXPECT_EQ(2u, stats.sector_erase_count);
+  EXPECT_EQ(Status::NotFound(), kvs_.StepMaintenance(1));
+  EXPECT_FALSE(kvs_.error_detected());
+}
+
+TEST_F(ShardedKeyValueStoreTest, StepMaintenance_StepsEachShard) {
+  for (uint32_t i = 0; i < std::size(kKeys); ++i) {
+    ASSERT_EQ(OkStatus(), kvs_.Put(kKeys[i], i));
+    ASSERT_EQ(OkStatus(), kvs_.Put(kKeys[i], i + 1));
+  }
+
+  Status status;
+  do {
+    status = kvs_.StepMaintenance(64);
+  } while (status.ok());
+  EXPECT_EQ(Status::NotFound(), status);
+  EXPECT_EQ(0u, kvs_.GetStorageStats().reclaimable_bytes);
+
+  for (uint32_t i = 0; i < std::size(kKeys); ++i) {
+    uint32_t value = 0;
+    ASSERT_EQ(OkStatus(), kvs_.Get(kKeys[i], &value));
+    EXPECT_EQ(i + 1, value);
+  }
+}
+
+}  // namespace
+}  // namespace pw::kvs
@@ -0,0 +1,88 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/value_cache.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace pw::kvs {
+
+void ValueCache::Clear() {
+  for (Slot& slot : slots_) {
+    slot.descriptor_index = kEmptySlot;
+  }
+  next_eviction_ = 0;
+}
+
+bool ValueCache::Find(size_t descriptor_index,
+                      uint32_t transaction_id,
+                      std::span<const std::byte>* value_out) {
+  const Slot* slot =
+      descriptor_index < kEmptySlot ? FindSlot(descriptor_index) : nullptr;
+  if (slot == nullptr || slot->transaction_id != transaction_id) {
+    misses_ += 1;
+    return false;
+  }
+
+  hits_ += 1;
+  *value_out = std::span(value(*slot), slot->value_size);
+  return true;
+}
+
+void ValueCache::Store(size_t descriptor_index,
+                       uint32_t transaction_id,
+                       std::span<const std::byte> value_to_cache) {
+  if (value_to_cache.size() > max_value_size_ ||
+      descriptor_index >= kEmptySlot) {
+    return;
+  }
+
+  Slot* slot = FindSlot(descriptor_index);
+
+  if (slot == nullptr) {
+    slot = FindSlot(kEmptySlot);
+  }
+
+  // If the cache is full, evict values in round-robin order.
+  if (slot == nullptr) {
+    slot = &slots_[next_eviction_];
+    next_eviction_ = (next_eviction_ + 1) % slots_.size();
+  }
+
+  slot->transaction_id = transaction_id;
+  slot->descriptor_index = static_cast<uint16_t>(descriptor_index);
+  slot->value_size = static_cast<uint16_t>(value_to_cache.size());
+  std::memcpy(value(*slot), value_to_cache.data(), value_to_cache.size());
+}
+
+void ValueCache::Invalidate(size_t descriptor_index) {
+  if (descriptor_index >= kEmptySlot) {
+    return;
+  }
+
+  Slot* slot = FindSlot(descriptor_index);
+  if (slot != nullptr) {
+    slot->descriptor_index = kEmptySlot;
+  }
+}
+
+ValueCache::Slot* ValueCache::FindSlot(uint16_t descriptor_index) {
+  auto slot = std::find_if(slots_.begin(), slots_.end(), [&](const Slot& s) {
+    return s.descriptor_index == descriptor_index;
+  });
+  return slot == slots_.end() ? nullptr : &*slot;
+}
+
+}  // namespace pw::kvs
@@ -0,0 +1,133 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/value_cache.h"
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+
+namespace pw::kvs {
+namespace {
+
+using std::byte;
+
+constexpr auto kValue1 = bytes::Array<1, 2, 3>();
+constexpr auto kValue2 = bytes::Array<4, 5, 6, 7>();
+
+class ValueCacheTest : public ::testing::Test {
+ protected:
+  static constexpr size_t kSlots = 2;
+  static constexpr size_t kMaxValueSize = 4;
+
+  ValueCacheBuffer<kSlots, kMaxValueSize> cache_;
+  std::span<const byte> value_;
+};
+
+TEST_F(ValueCacheTest, Empty) {
+  EXPECT_EQ(kSlots, cache_.slot_count());
+  EXPECT_EQ(kMaxValueSize, cache_.max_value_size());
+  EXPECT_FALSE(cache_.Find(0, 1, &value_));
+  EXPECT_EQ(0u, cache_.hits());
+  EXPECT_EQ(1u, cache_.misses());
+}
+
+TEST_F(ValueCacheTest, StoreAndFind) {
+  cache_.Store(3, 10, kValue1);
+
+  ASSERT_TRUE(cache_.Find(3, 10, &value_));
+  ASSERT_EQ(kValue1.size(), value_.size());
+  EXPECT_EQ(0, std::memcmp(kValue1.data(), value_.data(), value_.size()));
+  EXPECT_EQ(1u, cache_.hits());
+  EXPECT_EQ(0u, cache_.misses());
+}
+
+TEST_F(ValueCacheTest, StoreEmptyValue) {
+  cache_.Store(3, 10, {});
+
+  ASSERT_TRUE(cache_.Find(3, 10, &value_));
+  EXPECT_EQ(0u, value_.size());
+}
+
+TEST_F(ValueCacheTest, Find_DifferentTransactionId_Misses) {
+  cache_.Store(3, 10, kValue1);
+
+  EXPECT_FALSE(cache_.Find(3, 11, &value_));
+  EXPECT_EQ(0u, cache_.hits());
+  EXPECT_EQ(1u, cache_.misses());
+}
+
+TEST_F(ValueCacheTest, Store_ReplacesValueForSameDescriptor) {
+  cache_.Store(3, 10, kValue1);
+  cache_.Store(3, 11, kValue2);
+  cache_.Store(4, 12, kValue1);
+
+  ASSERT_TRUE(cache_.Find(3, 11, &value_));
+  EXPECT_EQ(0, std::memcmp(kValue2.data(), value_.data(), value_.size()));
+  EXPECT_TRUE(cache_.Find(4, 12, &value_));
+}
+
+TEST_F(ValueCacheTest, Store_TooLarge_NotCached) {
+  constexpr auto kLargeValue = bytes::Array<1, 2, 3, 4, 5>();
+  cache_.Store(3, 10, kLargeValue);
+
+  EXPECT_FALSE(cache_.Find(3, 10, &value_));
+}
+
+TEST_F(ValueCacheTest, Store_Full_EvictsOldest) {
+  cache_.Store(1, 10, kValue1);
+  cache_.Store(2, 11, kValue1);
+  cache_.Store(3, 12, kValue2);
+
+  EXPECT_FALSE(cache_.Find(1, 10, &value_));
+  EXPECT_TRUE(cache_.Find(2, 11, &value_));
+  EXPECT_TRUE(cache_.Find(3, 12, &value_));
+}
+
+TEST_F(ValueCacheTest, Invalidate) {
+  cache_.Store(1, 10, kValue1);
+  cache_.Store(2, 11, kValue1);
+
+  cache_.Invalidate(1);
+  EXPECT_FALSE(cache_.Find(1, 10, &value_));
+  EXPECT_TRUE(cache_.Find(2, 11, &value_));
+
+  // The invalidated slot is reused before any value is evicted.
+  cache_.Store(3, 12, kValue2);
+  EXPECT_TRUE(cache_.Find(2, 11, &value_));
+  EXPECT_TRUE(cache_.Find(3, 12, &value_));
+}
+
+TEST_F(ValueCacheTest, Clear) {
+  cache_.Store(1, 10, kValue1);
+  cache_.Store(2, 11, kValue1);
+
+  cache_.Clear();
+  EXPECT_FALSE(cache_.Find(1, 10, &value_));
+  EXPECT_FALSE(cache_.Find(2, 11, &value_));
+}
+
+TEST_F(ValueCacheTest, ResetCounters) {
+  cache_.Store(1, 10, kValue1);
+  EXPECT_TRUE(cache_.Find(1, 10, &value_));
+  EXPECT_FALSE(cache_.Find(2, 10, &value_));
+
+  cache_.ResetCounters();
+  EXPECT_EQ(0u, cache_.hits());
+  EXPECT_EQ(0u, cache_.misses());
+}
+
+}  // namespace
+}  // namespace pw::kvs
@@ -0,0 +1,33 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log/filter.h"
+
+#include <algorithm>
+
+extern "C" {
+
+uint8_t pw_log_module_filter[PW_LOG_FILTER_MODULE_COUNT] = {};
+
+void pw_log_SetModuleLevel(size_t module_index, int level) {
+  if (module_index >= PW_LOG_FILTER_MODULE_COUNT) {
+    return;
+  }
+  // Set the bits for every level below level.
+  level = std::clamp(level, 0, 8);
+  pw_log_module_filter[module_index] =
+      static_cast<uint8_t>((1u << level) - 1u);
+}
+
+}  // extern "C"
@@ -0,0 +1,98 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_LOG_MODULE_NAME "FILTER_TEST"
+#define PW_LOG_MODULE_FILTER_INDEX 3
+
+#include "pw_log/filter.h"
+
+#include "gtest/gtest.h"
+#include "pw_log/levels.h"
+#include "pw_log/options.h"
+
+namespace {
+
+// Mimics the facade's PW_LOG, which only evaluates the arguments of enabled
+// statements.
+#define TEST_LOG(level, argument)     \
+  do {                                \
+    if (PW_LOG_ENABLE_IF(level, 0)) { \
+      static_cast<void>(argument);    \
+    }                                 \
+  } while (0)
+
+class LogFilter : public ::testing::Test {
+ protected:
+  ~LogFilter() { pw_log_SetModuleLevel(PW_LOG_MODULE_FILTER_INDEX, 0); }
+};
+
+TEST_F(LogFilter, EveryLevelEnabledByDefault) {
+  EXPECT_TRUE(PW_LOG_ENABLE_IF(PW_LOG_LEVEL_DEBUG, 0));
+  EXPECT_TRUE(PW_LOG_ENABLE_IF(PW_LOG_LEVEL_CRITICAL, 0));
+}
+
+TEST_F(LogFilter, SetModuleLevel_DisablesLowerLevels) {
+  pw_log_SetModuleLevel(PW_LOG_MODULE_FILTER_INDEX, PW_LOG_LEVEL_WARN);
+
+  EXPECT_FALSE(PW_LOG_ENABLE_IF(PW_LOG_LEVEL_DEBUG, 0));
+  EXPECT_FALSE(PW_LOG_ENABLE_IF(PW_LOG_LEVEL_INFO, 0));
+  EXPECT_TRUE(PW_LOG_ENABLE_IF(PW_LOG_LEVEL_WARN, 0));
+  EXPECT_TRUE(PW_LOG_ENABLE_IF(PW_LOG_LEVEL_CRITICAL, 0));
+}
+
+TEST_F(LogFilter, SetModuleLevel_OtherModulesUnaffected) {
+  pw_log_SetModuleLevel(PW_LOG_MODULE_FILTER_INDEX + 1, PW_LOG_LEVEL_CRITICAL);
+
+  EXPECT_TRUE(PW_LOG_ENABLE_IF(PW_LOG_LEVEL_DEBUG, 0));
+  EXPECT_FALSE(
+      PW_LOG_FILTER_LEVEL_ENABLED(PW_LOG_MODULE_FILTER_INDEX + 1, 1));
+
+  pw_log_SetModuleLevel(PW_LOG_MODULE_FILTER_INDEX + 1, 0);
+}
+
+TEST_F(LogFilter, SetModuleLevel_AboveCriticalDisablesModule) {
+  pw_log_SetModuleLevel(PW_LOG_MODULE_FILTER_INDEX, PW_LOG_LEVEL_CRITICAL + 1);
+  EXPECT_FALSE(PW_LOG_ENABLE_IF(PW_LOG_LEVEL_CRITICAL, 0));
+}
+
+TEST_F(LogFilter, SetModuleLevel_IgnoresInvalidIndex) {
+  pw_log_SetModuleLevel(PW_LOG_FILTER_MODULE_COUNT, PW_LOG_LEVEL_CRITICAL);
+  EXPECT_TRUE(PW_LOG_ENABLE_IF(PW_LOG_LEVEL_DEBUG, 0));
+}
+
+TEST_F(LogFilter, FilteredLogsDoNotEvaluateArguments) {
+  int evaluations = 0;
+  TEST_LOG(PW_LOG_LEVEL_INFO, ++evaluations);
+  EXPECT_EQ(1, evaluations);
+
+  pw_log_SetModuleLevel(PW_LOG_MODULE_FILTER_INDEX, PW_LOG_LEVEL_ERROR);
+  TEST_LOG(PW_LOG_LEVEL_INFO, ++evaluations);
+  EXPECT_EQ(1, evaluations);
+}
+
+// Redefine the compile-time module switch, as if a later source file disabled
+// its module.
+#undef PW_LOG_MODULE_ENABLED
+#define PW_LOG_MODULE_ENABLED 0
+
+TEST_F(LogFilter, DisabledModuleIsConstantFalse) {
+  // The run-time filter is not read, so the check is a constant expression.
+  static_assert(!PW_LOG_ENABLE_IF(PW_LOG_LEVEL_CRITICAL, 0));
+
+  int evaluations = 0;
+  TEST_LOG(PW_LOG_LEVEL_CRITICAL, ++evaluations);
+  EXPECT_EQ(0, evaluations);
+}
+
+}  // namespace
@@ -0,0 +1,56 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// This file declares the run-time log filter table, which has one byte per
+// module. Bit N of a module's byte disables logs at level N, so the table
+// starts zeroed, with every log enabled. Source files opt
+// in to run-time filtering by defining PW_LOG_MODULE_FILTER_INDEX to their
+// module's index in the table, before any #includes:
+//
+//   #define PW_LOG_MODULE_NAME "BLE"
+//   #define PW_LOG_MODULE_FILTER_INDEX 3
+//
+//   #include "pw_log/log.h"
+//
+// The default PW_LOG_ENABLE_IF then checks the module's byte before the log
+// statement's arguments are evaluated, so filtered logs cost one load and
+// test. Filtering at run time requires linking the pw_log:filter library.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "pw_preprocessor/util.h"
+
+// The number of modules in the run-time filter table. This must be the same
+// for the whole build, so set it with a build-wide define.
+#ifndef PW_LOG_FILTER_MODULE_COUNT
+#define PW_LOG_FILTER_MODULE_COUNT 32
+#endif  // PW_LOG_FILTER_MODULE_COUNT
+
+// Evaluates to nonzero if logs at level are enabled for the module.
+#define PW_LOG_FILTER_LEVEL_ENABLED(module_index, level) \
+  (((pw_log_module_filter[module_index] >> (level)) & 1u) == 0u)
+
+PW_EXTERN_C_START
+
+// The run-time filter table.
+extern uint8_t pw_log_module_filter[PW_LOG_FILTER_MODULE_COUNT];
+
+// Enables logs at or above level for the module, and disables logs below it.
+// A level above PW_LOG_LEVEL_CRITICAL disables the module. Indices outside
+// the table are ignored.
+void pw_log_SetModuleLevel(size_t module_index, int level);
+
+PW_EXTERN_C_END
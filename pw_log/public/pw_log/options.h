@@ -60,10 +60,35 @@
 #define PW_LOG_LEVEL PW_LOG_LEVEL_DEBUG
 #endif  // PW_LOG_LEVEL
 
+// Default: Module enabled
+//
+// Setting this to 0 disables every log statement in the source file. This is
+// compile-time filtering: disabled statements are compiled out, and their
+// arguments are never evaluated.
+#ifndef PW_LOG_MODULE_ENABLED
+#define PW_LOG_MODULE_ENABLED 1
+#endif  // PW_LOG_MODULE_ENABLED
+
+// Default: Run-time module filtering
+//
+// If PW_LOG_MODULE_FILTER_INDEX is defined, logs are also filtered at run time
+// by the module's entry in the filter table declared in pw_log/filter.h.
+#ifdef PW_LOG_MODULE_FILTER_INDEX
+#include "pw_log/filter.h"
+#define PW_LOG_MODULE_RUNTIME_ENABLED(level) \
+  PW_LOG_FILTER_LEVEL_ENABLED(PW_LOG_MODULE_FILTER_INDEX, level)
+#else
+#define PW_LOG_MODULE_RUNTIME_ENABLED(level) 1
+#endif  // PW_LOG_MODULE_FILTER_INDEX
+
 // Default: Log enabled expression
 //
 // This expression determines whether or not the statement is enabled and
-// should be passed to the backend.
+// should be passed to the backend. It is checked before the statement's
+// arguments are evaluated. The compile-time checks come first, so statements
+// they disable are compiled out without reading the run-time filter.
 #ifndef PW_LOG_ENABLE_IF
-#define PW_LOG_ENABLE_IF(level, flags) ((level) >= PW_LOG_LEVEL)
+#define PW_LOG_ENABLE_IF(level, flags)                 \
+  (PW_LOG_MODULE_ENABLED && (level) >= PW_LOG_LEVEL && \
+   PW_LOG_MODULE_RUNTIME_ENABLED(level))
 #endif  // PW_LOG_ENABLE_IF
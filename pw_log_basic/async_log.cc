@@ -0,0 +1,138 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// The queue is a bounded multi-producer ring in which each slot has a sequence
+// number. A slot at ring position p is free when its sequence is p, and holds
+// a log when its sequence is p + 1. Producers claim positions by advancing
+// write_position_ with a compare-and-swap, fill the slot, then publish it by
+// setting its sequence. The single consumer frees a slot by setting its
+// sequence to the position it will have on the next lap of the ring.
+
+#include "pw_log_basic/async_log.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_assert/assert.h"
+#include "pw_log_basic/log_basic.h"
+#include "pw_string/string_builder.h"
+#include "pw_sys_io/sys_io.h"
+
+namespace pw::log_basic {
+namespace {
+
+AsyncLogWriter* async_writer = nullptr;
+
+void WriteLine(std::string_view log) { sys_io::WriteLine(log); }
+
+}  // namespace
+
+AsyncLogWriter::AsyncLogWriter(std::span<Slot> slots,
+                               OverflowPolicy policy,
+                               void (*write_log)(std::string_view))
+    : slots_(slots),
+      policy_(policy),
+      write_log_(write_log != nullptr ? write_log : WriteLine),
+      write_position_(0),
+      read_position_(0),
+      dropped_(0) {
+  // Positions wrap around at 2^32, which only preserves their slot if the
+  // number of slots is a power of two. One slot cannot tell a free slot from
+  // a full one, since both have a sequence one more than the last position.
+  PW_DCHECK(slots_.size() >= 2u && (slots_.size() & (slots_.size() - 1)) == 0);
+  for (size_t i = 0; i < slots_.size(); ++i) {
+    slots_[i].sequence_.store(i, std::memory_order_relaxed);
+  }
+}
+
+void AsyncLogWriter::Write(std::string_view log) {
+  if (TryQueue(log)) {
+    logs_available_.release();
+    return;
+  }
+
+  if (policy_ == OverflowPolicy::kWrite) {
+    write_log_(log);
+  } else {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+bool AsyncLogWriter::TryQueue(std::string_view log) {
+  uint32_t position = write_position_.load(std::memory_order_relaxed);
+  Slot* slot;
+
+  while (true) {
+    slot = &slots_[position & (slots_.size() - 1)];
+    const uint32_t sequence = slot->sequence_.load(std::memory_order_acquire);
+    const int32_t lag = static_cast<int32_t>(sequence - position);
+
+    if (lag == 0) {
+      // The slot is free; claim it. On failure, position is updated.
+      if (write_position_.compare_exchange_weak(
+              position, position + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (lag < 0) {
+      return false;  // The slot still holds a log from the last lap: full.
+    } else {
+      // Another producer claimed the slot first.
+      position = write_position_.load(std::memory_order_relaxed);
+    }
+  }
+
+  slot->size_ = static_cast<uint8_t>(std::min(log.size(), kMaxLogSize));
+  std::memcpy(slot->log_, log.data(), slot->size_);
+  slot->sequence_.store(position + 1, std::memory_order_release);
+  return true;
+}
+
+size_t AsyncLogWriter::Drain() {
+  size_t written = 0;
+
+  while (true) {
+    Slot& slot = slots_[read_position_ & (slots_.size() - 1)];
+    if (slot.sequence_.load(std::memory_order_acquire) != read_position_ + 1) {
+      break;  // Empty, or the next log is still being copied in.
+    }
+
+    write_log_(std::string_view(slot.log_, slot.size_));
+    slot.sequence_.store(read_position_ + slots_.size(),
+                         std::memory_order_release);
+    read_position_ += 1;
+    written += 1;
+  }
+
+  if (const size_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+      dropped > 0) {
+    StringBuffer<48> message;
+    message.Format("[%u logs dropped]", static_cast<unsigned>(dropped));
+    write_log_(message);
+  }
+  return written;
+}
+
+void AsyncLogWriter::Run() {
+  while (true) {
+    logs_available_.acquire();
+    Drain();
+  }
+}
+
+void SetAsyncOutput(AsyncLogWriter& writer) {
+  async_writer = &writer;
+  SetOutput([](std::string_view log) { async_writer->Write(log); });
+}
+
+}  // namespace pw::log_basic
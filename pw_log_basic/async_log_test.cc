@@ -0,0 +1,138 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_basic/async_log.h"
+
+#include <array>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "pw_log/levels.h"
+#include "pw_log_basic/log_basic.h"
+
+namespace pw::log_basic {
+namespace {
+
+std::array<std::string, 8> written_logs;
+size_t written_count = 0;
+
+void CaptureLog(std::string_view log) {
+  written_logs[written_count % written_logs.size()] = log;
+  written_count += 1;
+}
+
+class AsyncLog : public ::testing::Test {
+ protected:
+  AsyncLog() { written_count = 0; }
+};
+
+TEST_F(AsyncLog, Write_QueuesUntilDrained) {
+  std::array<AsyncLogWriter::Slot, 4> slots;
+  AsyncLogWriter writer(
+      slots, AsyncLogWriter::OverflowPolicy::kDrop, CaptureLog);
+
+  writer.Write("first");
+  writer.Write("second");
+  EXPECT_EQ(0u, written_count);
+
+  EXPECT_EQ(2u, writer.Drain());
+  ASSERT_EQ(2u, written_count);
+  EXPECT_EQ("first", written_logs[0]);
+  EXPECT_EQ("second", written_logs[1]);
+
+  EXPECT_EQ(0u, writer.Drain());
+  EXPECT_EQ(2u, written_count);
+}
+
+TEST_F(AsyncLog, Write_ReusesSlotsAroundTheRing) {
+  std::array<AsyncLogWriter::Slot, 2> slots;
+  AsyncLogWriter writer(
+      slots, AsyncLogWriter::OverflowPolicy::kDrop, CaptureLog);
+
+  for (int i = 0; i < 5; ++i) {
+    writer.Write("a");
+    writer.Write("b");
+    EXPECT_EQ(2u, writer.Drain());
+  }
+  EXPECT_EQ(10u, written_count);
+  EXPECT_EQ(0u, writer.dropped());
+}
+
+TEST_F(AsyncLog, Overflow_DropPolicyCountsAndReportsDrops) {
+  std::array<AsyncLogWriter::Slot, 2> slots;
+  AsyncLogWriter writer(
+      slots, AsyncLogWriter::OverflowPolicy::kDrop, CaptureLog);
+
+  writer.Write("kept 1");
+  writer.Write("kept 2");
+  writer.Write("dropped 1");
+  writer.Write("dropped 2");
+  EXPECT_EQ(0u, written_count);
+  EXPECT_EQ(2u, writer.dropped());
+
+  EXPECT_EQ(2u, writer.Drain());
+  ASSERT_EQ(3u, written_count);
+  EXPECT_EQ("kept 1", written_logs[0]);
+  EXPECT_EQ("kept 2", written_logs[1]);
+  EXPECT_EQ("[2 logs dropped]", written_logs[2]);
+  EXPECT_EQ(0u, writer.dropped());
+}
+
+TEST_F(AsyncLog, Overflow_WritePolicyWritesInCaller) {
+  std::array<AsyncLogWriter::Slot, 2> slots;
+  AsyncLogWriter writer(
+      slots, AsyncLogWriter::OverflowPolicy::kWrite, CaptureLog);
+
+  writer.Write("queued 1");
+  writer.Write("queued 2");
+  writer.Write("written now");
+  ASSERT_EQ(1u, written_count);
+  EXPECT_EQ("written now", written_logs[0]);
+  EXPECT_EQ(0u, writer.dropped());
+
+  EXPECT_EQ(2u, writer.Drain());
+  EXPECT_EQ("queued 1", written_logs[1]);
+  EXPECT_EQ("queued 2", written_logs[2]);
+}
+
+TEST_F(AsyncLog, Write_TruncatesLongLogs) {
+  std::array<AsyncLogWriter::Slot, 2> slots;
+  AsyncLogWriter writer(
+      slots, AsyncLogWriter::OverflowPolicy::kDrop, CaptureLog);
+
+  const std::string long_log(AsyncLogWriter::kMaxLogSize + 10, '!');
+  writer.Write(long_log);
+  writer.Drain();
+  ASSERT_EQ(1u, written_count);
+  EXPECT_EQ(long_log.substr(0, AsyncLogWriter::kMaxLogSize), written_logs[0]);
+}
+
+TEST_F(AsyncLog, SetAsyncOutput_QueuesPwLogOutput) {
+  std::array<AsyncLogWriter::Slot, 2> slots;
+  AsyncLogWriter writer(
+      slots, AsyncLogWriter::OverflowPolicy::kDrop, CaptureLog);
+  SetAsyncOutput(writer);
+
+  pw_Log(PW_LOG_LEVEL_INFO, 0, "", "", 0, "", "Value: %d", 42);
+  EXPECT_EQ(0u, written_count);
+
+  EXPECT_EQ(1u, writer.Drain());
+  ASSERT_EQ(1u, written_count);
+  EXPECT_NE(std::string::npos, written_logs[0].find("Value: 42"));
+
+  SetOutput(CaptureLog);
+}
+
+}  // namespace
+}  // namespace pw::log_basic
@@ -0,0 +1,114 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "pw_sync/binary_semaphore.h"
+
+namespace pw::log_basic {
+
+// Queues formatted logs so a low priority thread can write them, rather than
+// the thread that logged. Logging costs formatting plus a copy into the queue,
+// instead of a write to a slow output such as a UART.
+//
+// The queue is a lock-free ring of fixed-size slots. Any number of threads may
+// queue logs; one thread writes them. Queueing claims a slot with an atomic
+// compare-and-swap, so it never waits on the writer or takes a lock, and can
+// be done from interrupts.
+//
+// When the queue is full, the overflow policy decides what happens to a log:
+// kDrop counts and drops it, which keeps logging latency bounded, and kWrite
+// writes it directly in the caller, which loses no logs but costs the caller
+// a full write. Dropped logs are reported by the writer thread.
+//
+// Example:
+//
+//   std::array<AsyncLogWriter::Slot, 32> log_slots;
+//   AsyncLogWriter log_writer(log_slots);
+//
+//   int main() {
+//     SetAsyncOutput(log_writer);
+//     // Create a low priority thread that calls log_writer.Run().
+//   }
+class AsyncLogWriter {
+ public:
+  // The longest log that is queued; pw_log_basic logs are at most this long.
+  // Longer logs are truncated.
+  static constexpr size_t kMaxLogSize = 149;
+
+  enum class OverflowPolicy {
+    kDrop,
+    kWrite,
+  };
+
+  class Slot {
+   public:
+    constexpr Slot() : sequence_(0), size_(0), log_{} {}
+
+   private:
+    friend class AsyncLogWriter;
+
+    // Position in the ring for which this slot is free (equal) or holds a log
+    // (one more).
+    std::atomic<uint32_t> sequence_;
+    uint8_t size_;
+    char log_[kMaxLogSize];
+  };
+
+  // The number of slots must be a power of two, and at least 2. Logs are
+  // written with write_log, which defaults to pw::sys_io::WriteLine.
+  explicit AsyncLogWriter(std::span<Slot> slots,
+                          OverflowPolicy policy = OverflowPolicy::kDrop,
+                          void (*write_log)(std::string_view) = nullptr);
+
+  AsyncLogWriter(const AsyncLogWriter&) = delete;
+  AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+
+  // Queues a log and wakes the writer thread. Safe to call from any thread or
+  // interrupt.
+  void Write(std::string_view log);
+
+  // Writes the queued logs, then reports logs dropped since the last report.
+  // Returns the number of logs written. Only one thread may call this.
+  size_t Drain();
+
+  // Writes logs as they are queued. This never returns; call it from a
+  // dedicated low priority thread.
+  [[noreturn]] void Run();
+
+  // Logs dropped since the last report.
+  size_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+ private:
+  bool TryQueue(std::string_view log);
+
+  const std::span<Slot> slots_;
+  const OverflowPolicy policy_;
+  void (*const write_log_)(std::string_view);
+
+  std::atomic<uint32_t> write_position_;
+  uint32_t read_position_;
+  std::atomic<size_t> dropped_;
+  sync::BinarySemaphore logs_available_;
+};
+
+// Sets pw_log_basic's output to queue logs in the writer.
+void SetAsyncOutput(AsyncLogWriter& writer);
+
+}  // namespace pw::log_basic
@@ -0,0 +1,405 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_multisink/flash_log_store.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_checksum/crc32.h"
+#include "pw_kvs/alignment.h"
+#include "pw_log_multisink_private/log_entry.h"
+#include "pw_status/try.h"
+#include "pw_varint/varint.h"
+
+namespace pw::log_rpc {
+
+uint32_t FlashLogStore::SegmentHeader::CalculateChecksum() const {
+  SegmentHeader header = *this;
+  header.checksum = 0;
+  return checksum::Crc32::Calculate(std::as_bytes(std::span(&header, 1)));
+}
+
+FlashLogStore::FlashLogStore(kvs::FlashPartition& partition,
+                             std::span<Segment> segments,
+                             ByteSpan write_buffer)
+    : partition_(partition), segments_(segments), write_buffer_(write_buffer) {}
+
+size_t FlashLogStore::HeaderSize() const {
+  return AlignUp(sizeof(SegmentHeader), partition_.alignment_bytes());
+}
+
+Status FlashLogStore::Init() {
+  initialized_ = false;
+
+  const size_t alignment = partition_.alignment_bytes();
+  if (segments_.size() < partition_.sector_count() ||
+      (alignment != 1u && alignment % 2 != 0) ||
+      write_buffer_.size() < alignment ||
+      write_buffer_.size() % alignment != 0 ||
+      SectorSize() <= HeaderSize() + kLengthSize) {
+    return Status::FailedPrecondition();
+  }
+
+  has_segment_ = false;
+  for (size_t sector = 0; sector < partition_.sector_count(); ++sector) {
+    PW_TRY(ReadSegment(sector));
+    if (InUse(sector) &&
+        (!has_segment_ ||
+         segments_[sector].number_ > segments_[current_sector_].number_)) {
+      current_sector_ = sector;
+      has_segment_ = true;
+    }
+  }
+
+  buffered_ = 0;
+  next_sequence_ = 0;
+  if (has_segment_) {
+    PW_TRY(ResumeSegment());
+  }
+
+  initialized_ = true;
+  return OkStatus();
+}
+
+Status FlashLogStore::ReadSegment(size_t sector) {
+  Segment& segment = segments_[sector];
+
+  SegmentHeader header;
+  PW_TRY(partition_.Read(SectorAddress(sector), sizeof(header), &header)
+             .status());
+
+  if (header.magic == kSegmentMagic &&
+      header.checksum == header.CalculateChecksum()) {
+    segment.state_ = Segment::State::kInUse;
+    segment.number_ = header.number;
+    segment.first_sequence_ = header.first_sequence;
+    segment.first_timestamp_ = header.first_timestamp;
+    return OkStatus();
+  }
+
+  bool erased;
+  PW_TRY(partition_.IsRegionErased(SectorAddress(sector), SectorSize(), &erased));
+  segment.state_ = erased ? Segment::State::kErased : Segment::State::kUnknown;
+  return OkStatus();
+}
+
+Status FlashLogStore::ResumeSegment() {
+  uint32_t sequence = segments_[current_sector_].first_sequence_;
+  size_t offset = HeaderSize();
+
+  while (true) {
+    size_t entry_offset;
+    size_t entry_size;
+    Result<size_t> next =
+        NextRecord(current_sector_, offset, SectorSize(), &entry_offset,
+                   &entry_size);
+    if (!next.ok()) {
+      // A write was interrupted. Keep the entries before it, but do not write
+      // to this segment again.
+      flushed_offset_ = offset;
+      write_offset_ = SectorSize();
+      break;
+    }
+    if (entry_size == 0u) {
+      flushed_offset_ = offset;
+      write_offset_ = AlignUp(offset, partition_.alignment_bytes());
+      break;
+    }
+    sequence += 1;
+    offset = next.value();
+  }
+
+  next_sequence_ = sequence;
+  return OkStatus();
+}
+
+Status FlashLogStore::Append(ConstByteSpan entry, int64_t timestamp) {
+  if (!initialized_) {
+    return Status::FailedPrecondition();
+  }
+
+  const size_t record_size = RecordSize(entry.size());
+  if (entry.empty() || entry.size() >= kErasedLength ||
+      record_size > SectorSize() - HeaderSize()) {
+    return Status::InvalidArgument();
+  }
+
+  if (!has_segment_ || write_offset_ + buffered_ + record_size > SectorSize()) {
+    PW_TRY(Flush());
+    PW_TRY(StartSegment(timestamp));
+  }
+
+  const size_t record_start = write_offset_ + buffered_;
+  const std::byte length[kLengthSize] = {
+      static_cast<std::byte>(entry.size() & 0xff),
+      static_cast<std::byte>(entry.size() >> 8),
+  };
+  PW_TRY(Buffer(length));
+  PW_TRY(Buffer(entry));
+  if (entry.size() % 2 != 0) {
+    PW_TRY(BufferPadding(1));
+  }
+  next_sequence_ += 1;
+
+  // Earlier records are in flash once any part of this one is written.
+  if (record_start + record_size <= write_offset_) {
+    flushed_offset_ = record_start + record_size;
+  } else if (record_start <= write_offset_) {
+    flushed_offset_ = record_start;
+  }
+  return OkStatus();
+}
+
+Status FlashLogStore::Flush() {
+  if (!initialized_) {
+    return Status::FailedPrecondition();
+  }
+  if (buffered_ == 0u) {
+    return OkStatus();
+  }
+
+  // Records are an even size, so the padding starts with a zero length.
+  PW_TRY(BufferPadding(Padding(buffered_, partition_.alignment_bytes())));
+  if (buffered_ != 0u) {
+    PW_TRY(WriteBuffer());
+  }
+  flushed_offset_ = write_offset_;
+  return OkStatus();
+}
+
+Status FlashLogStore::StartSegment(int64_t timestamp) {
+  const size_t sector =
+      has_segment_ ? (current_sector_ + 1) % partition_.sector_count() : 0;
+  Segment& segment = segments_[sector];
+
+  if (segment.state_ != Segment::State::kErased) {
+    segment.state_ = Segment::State::kUnknown;
+    PW_TRY(partition_.Erase(SectorAddress(sector), 1));
+  }
+
+  const uint32_t number =
+      has_segment_ ? segments_[current_sector_].number_ + 1 : 0;
+  segment.state_ = Segment::State::kInUse;
+  segment.number_ = number;
+  segment.first_sequence_ = next_sequence_;
+  segment.first_timestamp_ = timestamp;
+
+  current_sector_ = sector;
+  has_segment_ = true;
+  write_offset_ = 0;
+  buffered_ = 0;
+  flushed_offset_ = HeaderSize();
+
+  SegmentHeader header = {
+      .magic = kSegmentMagic,
+      .number = number,
+      .first_sequence = next_sequence_,
+      .checksum = 0,
+      .first_timestamp = timestamp,
+  };
+  header.checksum = header.CalculateChecksum();
+  PW_TRY(Buffer(std::as_bytes(std::span(&header, 1))));
+  return BufferPadding(HeaderSize() - sizeof(header));
+}
+
+Status FlashLogStore::Buffer(ConstByteSpan data) {
+  while (!data.empty()) {
+    const size_t size = std::min(data.size(), write_buffer_.size() - buffered_);
+    std::memcpy(&write_buffer_[buffered_], data.data(), size);
+    buffered_ += size;
+    data = data.subspan(size);
+
+    if (buffered_ == write_buffer_.size()) {
+      PW_TRY(WriteBuffer());
+    }
+  }
+  return OkStatus();
+}
+
+Status FlashLogStore::BufferPadding(size_t size) {
+  while (size > 0u) {
+    const size_t chunk = std::min(size, write_buffer_.size() - buffered_);
+    std::memset(&write_buffer_[buffered_], 0, chunk);
+    buffered_ += chunk;
+    size -= chunk;
+
+    if (buffered_ == write_buffer_.size()) {
+      PW_TRY(WriteBuffer());
+    }
+  }
+  return OkStatus();
+}
+
+Status FlashLogStore::WriteBuffer() {
+  PW_TRY(partition_
+             .Write(SectorAddress(current_sector_) + write_offset_,
+                    write_buffer_.first(buffered_))
+             .status());
+  write_offset_ += buffered_;
+  buffered_ = 0;
+  return OkStatus();
+}
+
+Result<size_t> FlashLogStore::NextRecord(size_t sector,
+                                         size_t offset,
+                                         size_t limit,
+                                         size_t* entry_offset,
+                                         size_t* entry_size) {
+  *entry_size = 0;
+
+  while (offset + kLengthSize <= limit) {
+    std::byte bytes[kLengthSize];
+    PW_TRY(partition_.Read(SectorAddress(sector) + offset, bytes).status());
+    const uint16_t length =
+        static_cast<uint16_t>(bytes[0]) | (static_cast<uint16_t>(bytes[1]) << 8);
+
+    if (length == kErasedLength) {
+      break;
+    }
+    if (length == kPaddingLength) {
+      offset = AlignUp(offset + 1, partition_.alignment_bytes());
+      continue;
+    }
+    if (offset + RecordSize(length) > limit) {
+      return Status::DataLoss();
+    }
+
+    *entry_offset = offset + kLengthSize;
+    *entry_size = length;
+    return offset + RecordSize(length);
+  }
+  return offset;
+}
+
+Result<size_t> FlashLogStore::FindSector(uint32_t sequence) const {
+  bool found = false;
+  size_t found_sector = 0;
+
+  for (size_t sector = 0; sector < partition_.sector_count(); ++sector) {
+    const Segment& segment = segments_[sector];
+    if (InUse(sector) && segment.first_sequence_ <= sequence &&
+        (!found ||
+         segment.first_sequence_ > segments_[found_sector].first_sequence_)) {
+      found_sector = sector;
+      found = true;
+    }
+  }
+
+  if (!found) {
+    return Status::NotFound();
+  }
+  return found_sector;
+}
+
+Result<LogEntries> FlashLogStore::ReadEntries(uint32_t first_sequence,
+                                              LogEntriesBuffer entries_buffer) {
+  if (!initialized_) {
+    return Status::FailedPrecondition();
+  }
+  if (first_sequence >= next_sequence_) {
+    return LogEntries{.entries = ConstByteSpan(), .entry_count = 0};
+  }
+
+  Result<size_t> found = FindSector(first_sequence);
+  PW_TRY(found.status());
+
+  size_t sector = found.value();
+  uint32_t sequence = segments_[sector].first_sequence_;
+  size_t offset = HeaderSize();
+  size_t used = 0;
+  size_t entry_count = 0;
+
+  while (true) {
+    const size_t limit =
+        sector == current_sector_ ? flushed_offset_ : SectorSize();
+    size_t entry_offset;
+    size_t entry_size;
+    Result<size_t> next =
+        NextRecord(sector, offset, limit, &entry_offset, &entry_size);
+    if (!next.ok()) {
+      if (entry_count == 0u) {
+        return next.status();
+      }
+      break;
+    }
+
+    if (entry_size == 0u) {
+      // Continue with the next segment, unless this is the newest.
+      if (sector == current_sector_) {
+        break;
+      }
+      sector = (sector + 1) % partition_.sector_count();
+      if (!InUse(sector)) {
+        break;
+      }
+      sequence = segments_[sector].first_sequence_;
+      offset = HeaderSize();
+      continue;
+    }
+
+    if (sequence >= first_sequence) {
+      const size_t prefix_size = 1 + varint::EncodedSize(entry_size);
+      if (used + prefix_size + entry_size > entries_buffer.size()) {
+        if (entry_count == 0u) {
+          return Status::ResourceExhausted();
+        }
+        break;
+      }
+
+      entries_buffer[used] = internal::kLogKey;
+      varint::Encode(entry_size, entries_buffer.subspan(used + 1));
+      PW_TRY(partition_
+                 .Read(SectorAddress(sector) + entry_offset,
+                       entries_buffer.subspan(used + prefix_size, entry_size))
+                 .status());
+      used += prefix_size + entry_size;
+      entry_count += 1;
+    }
+
+    sequence += 1;
+    offset = next.value();
+  }
+
+  return LogEntries{.entries = entries_buffer.first(used),
+                    .entry_count = entry_count};
+}
+
+uint32_t FlashLogStore::FindSequence(int64_t timestamp) const {
+  bool found = false;
+  uint32_t sequence = 0;
+
+  for (size_t sector = 0; sector < partition_.sector_count(); ++sector) {
+    const Segment& segment = segments_[sector];
+    if (InUse(sector) && segment.first_timestamp_ <= timestamp &&
+        (!found || segment.first_sequence_ > sequence)) {
+      sequence = segment.first_sequence_;
+      found = true;
+    }
+  }
+
+  return found ? sequence : oldest_sequence();
+}
+
+uint32_t FlashLogStore::oldest_sequence() const {
+  uint32_t oldest = next_sequence_;
+  for (size_t sector = 0; sector < partition_.sector_count(); ++sector) {
+    if (InUse(sector)) {
+      oldest = std::min(oldest, segments_[sector].first_sequence_);
+    }
+  }
+  return oldest;
+}
+
+}  // namespace pw::log_rpc
@@ -0,0 +1,227 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_multisink/flash_log_store.h"
+
+#include <array>
+#include <cstring>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_protobuf/decoder.h"
+
+namespace pw::log_rpc {
+namespace {
+
+constexpr size_t kSectorSize = 256;
+constexpr size_t kSectorCount = 4;
+constexpr size_t kAlignment = 16;
+constexpr size_t kWriteBufferSize = 64;
+
+ConstByteSpan AsBytes(std::string_view entry) {
+  return std::as_bytes(std::span(entry.data(), entry.size()));
+}
+
+// Checks that entries is a pw.log.LogEntries message holding the expected
+// entries, in order.
+void ExpectEntries(const LogEntries& entries,
+                   std::initializer_list<std::string_view> expected) {
+  EXPECT_EQ(expected.size(), entries.entry_count);
+
+  protobuf::Decoder decoder(entries.entries);
+  for (std::string_view entry : expected) {
+    ASSERT_EQ(OkStatus(), decoder.Next());
+    EXPECT_EQ(1u, decoder.FieldNumber());
+    ConstByteSpan bytes;
+    ASSERT_EQ(OkStatus(), decoder.ReadBytes(&bytes));
+    EXPECT_EQ(entry,
+              std::string_view(reinterpret_cast<const char*>(bytes.data()),
+                               bytes.size()));
+  }
+  EXPECT_EQ(Status::OutOfRange(), decoder.Next());
+}
+
+class FlashLogStoreTest : public ::testing::Test {
+ protected:
+  FlashLogStoreTest()
+      : flash_(kAlignment), partition_(&flash_), store_(partition_) {}
+
+  kvs::FakeFlashMemoryBuffer<kSectorSize, kSectorCount> flash_;
+  kvs::FlashPartition partition_;
+  FlashLogStoreBuffer<kSectorCount, kWriteBufferSize> store_;
+  std::array<std::byte, 256> read_buffer_;
+};
+
+TEST_F(FlashLogStoreTest, Append_BeforeInit) {
+  EXPECT_EQ(Status::FailedPrecondition(), store_.Append(AsBytes("log"), 0));
+}
+
+TEST_F(FlashLogStoreTest, Init_TooFewSegments) {
+  FlashLogStoreBuffer<kSectorCount - 1, kWriteBufferSize> store(partition_);
+  EXPECT_EQ(Status::FailedPrecondition(), store.Init());
+}
+
+TEST_F(FlashLogStoreTest, Init_UnalignedWriteBuffer) {
+  FlashLogStoreBuffer<kSectorCount, kAlignment + 2> store(partition_);
+  EXPECT_EQ(Status::FailedPrecondition(), store.Init());
+}
+
+TEST_F(FlashLogStoreTest, Init_Empty) {
+  ASSERT_EQ(OkStatus(), store_.Init());
+  EXPECT_EQ(0u, store_.next_sequence());
+  EXPECT_EQ(0u, store_.oldest_sequence());
+
+  Result<LogEntries> entries = store_.ReadEntries(0, read_buffer_);
+  ASSERT_EQ(OkStatus(), entries.status());
+  EXPECT_EQ(0u, entries.value().entry_count);
+}
+
+TEST_F(FlashLogStoreTest, Append_InvalidEntries) {
+  ASSERT_EQ(OkStatus(), store_.Init());
+  EXPECT_EQ(Status::InvalidArgument(), store_.Append(ConstByteSpan(), 0));
+
+  std::array<std::byte, kSectorSize> too_large = {};
+  EXPECT_EQ(Status::InvalidArgument(), store_.Append(too_large, 0));
+}
+
+TEST_F(FlashLogStoreTest, ReadEntries_OnlyFlushedEntries) {
+  ASSERT_EQ(OkStatus(), store_.Init());
+  ASSERT_EQ(OkStatus(), store_.Append(AsBytes("first"), 1));
+  ASSERT_EQ(OkStatus(), store_.Append(AsBytes("second"), 2));
+  EXPECT_EQ(2u, store_.next_sequence());
+
+  Result<LogEntries> entries = store_.ReadEntries(0, read_buffer_);
+  ASSERT_EQ(OkStatus(), entries.status());
+  EXPECT_EQ(0u, entries.value().entry_count);
+
+  ASSERT_EQ(OkStatus(), store_.Flush());
+  entries = store_.ReadEntries(0, read_buffer_);
+  ASSERT_EQ(OkStatus(), entries.status());
+  ExpectEntries(entries.value(), {"first", "second"});
+
+  entries = store_.ReadEntries(1, read_buffer_);
+  ASSERT_EQ(OkStatus(), entries.status());
+  ExpectEntries(entries.value(), {"second"});
+}
+
+TEST_F(FlashLogStoreTest, ReadEntries_EntriesWrittenWhenBufferFills) {
+  ASSERT_EQ(OkStatus(), store_.Init());
+  for (int i = 0; i < 6; ++i) {
+    ASSERT_EQ(OkStatus(), store_.Append(AsBytes("0123456789abcdef"), i));
+  }
+
+  // The write buffer was last written partway through the last entry, so only
+  // the entries before it can be read.
+  Result<LogEntries> entries = store_.ReadEntries(0, read_buffer_);
+  ASSERT_EQ(OkStatus(), entries.status());
+  EXPECT_EQ(5u, entries.value().entry_count);
+}
+
+TEST_F(FlashLogStoreTest, ReadEntries_FlushAfterFlush) {
+  ASSERT_EQ(OkStatus(), store_.Init());
+  ASSERT_EQ(OkStatus(), store_.Append(AsBytes("a"), 1));
+  ASSERT_EQ(OkStatus(), store_.Flush());
+  ASSERT_EQ(OkStatus(), store_.Append(AsBytes("bcd"), 2));
+  ASSERT_EQ(OkStatus(), store_.Flush());
+  ASSERT_EQ(OkStatus(), store_.Flush());
+
+  Result<LogEntries> entries = store_.ReadEntries(0, read_buffer_);
+  ASSERT_EQ(OkStatus(), entries.status());
+  ExpectEntries(entries.value(), {"a", "bcd"});
+}
+
+TEST_F(FlashLogStoreTest, ReadEntries_SmallBuffer) {
+  ASSERT_EQ(OkStatus(), store_.Init());
+  ASSERT_EQ(OkStatus(), store_.Append(AsBytes("first"), 1));
+  ASSERT_EQ(OkStatus(), store_.Append(AsBytes("second"), 2));
+  ASSERT_EQ(OkStatus(), store_.Flush());
+
+  std::array<std::byte, 9> buffer;
+  Result<LogEntries> entries = store_.ReadEntries(0, buffer);
+  ASSERT_EQ(OkStatus(), entries.status());
+  ExpectEntries(entries.value(), {"first"});
+
+  entries = store_.ReadEntries(1, buffer);
+  ASSERT_EQ(OkStatus(), entries.status());
+  ExpectEntries(entries.value(), {"second"});
+
+  std::array<std::byte, 4> tiny_buffer;
+  EXPECT_EQ(Status::ResourceExhausted(),
+            store_.ReadEntries(0, tiny_buffer).status());
+}
+
+TEST_F(FlashLogStoreTest, Init_ResumesAfterReset) {
+  ASSERT_EQ(OkStatus(), store_.Init());
+  ASSERT_EQ(OkStatus(), store_.Append(AsBytes("before"), 1));
+  ASSERT_EQ(OkStatus(), store_.Flush());
+  ASSERT_EQ(OkStatus(), store_.Append(AsBytes("lost"), 2));
+
+  FlashLogStoreBuffer<kSectorCount, kWriteBufferSize> store(partition_);
+  ASSERT_EQ(OkStatus(), store.Init());
+  EXPECT_EQ(1u, store.next_sequence());
+
+  ASSERT_EQ(OkStatus(), store.Append(AsBytes("after"), 3));
+  ASSERT_EQ(OkStatus(), store.Flush());
+
+  Result<LogEntries> entries = store.ReadEntries(0, read_buffer_);
+  ASSERT_EQ(OkStatus(), entries.status());
+  ExpectEntries(entries.value(), {"before", "after"});
+}
+
+TEST_F(FlashLogStoreTest, Append_SpansSegments) {
+  ASSERT_EQ(OkStatus(), store_.Init());
+  // Each record is 40 bytes, so 5 fit in a segment after its 32-byte header.
+  constexpr std::string_view kEntry = "0123456789abcdef0123456789abcdef012345";
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_EQ(OkStatus(), store_.Append(AsBytes(kEntry), i));
+  }
+  ASSERT_EQ(OkStatus(), store_.Flush());
+
+  std::array<std::byte, 512> buffer;
+  Result<LogEntries> entries = store_.ReadEntries(3, buffer);
+  ASSERT_EQ(OkStatus(), entries.status());
+  EXPECT_EQ(5u, entries.value().entry_count);
+
+  EXPECT_EQ(0u, store_.FindSequence(4));
+  EXPECT_EQ(5u, store_.FindSequence(5));
+  EXPECT_EQ(5u, store_.FindSequence(100));
+}
+
+TEST_F(FlashLogStoreTest, Append_ErasesOldestSegment) {
+  ASSERT_EQ(OkStatus(), store_.Init());
+  constexpr std::string_view kEntry = "0123456789abcdef0123456789abcdef012345";
+  for (size_t i = 0; i < 5 * kSectorCount + 1; ++i) {
+    ASSERT_EQ(OkStatus(), store_.Append(AsBytes(kEntry), i));
+  }
+  ASSERT_EQ(OkStatus(), store_.Flush());
+
+  EXPECT_EQ(5u, store_.oldest_sequence());
+  EXPECT_EQ(Status::NotFound(), store_.ReadEntries(4, read_buffer_).status());
+  EXPECT_EQ(5u, store_.FindSequence(0));
+
+  Result<LogEntries> entries = store_.ReadEntries(20, read_buffer_);
+  ASSERT_EQ(OkStatus(), entries.status());
+  EXPECT_EQ(1u, entries.value().entry_count);
+
+  // The index is rebuilt after a reset.
+  FlashLogStoreBuffer<kSectorCount, kWriteBufferSize> store(partition_);
+  ASSERT_EQ(OkStatus(), store.Init());
+  EXPECT_EQ(5u, store.oldest_sequence());
+  EXPECT_EQ(21u, store.next_sequence());
+  EXPECT_EQ(20u, store.FindSequence(20));
+}
+
+}  // namespace
+}  // namespace pw::log_rpc
@@ -0,0 +1,201 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_multisink_private/log_entry.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_log/levels.h"
+#include "pw_log_proto/log.pwpb.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_varint/varint.h"
+
+namespace pw::log_rpc::internal {
+
+static_assert(
+    kLogKey ==
+    static_cast<std::byte>(protobuf::MakeKey(
+        static_cast<uint32_t>(log::LogEntries::Fields::ENTRIES),
+        protobuf::WireType::kDelimited)));
+
+Result<ConstByteSpan> EncodeTokenizedLogEntry(ByteSpan buffer,
+                                              ConstByteSpan message,
+                                              uint32_t flags,
+                                              uint32_t level,
+                                              uint32_t line,
+                                              uint32_t thread,
+                                              int64_t timestamp,
+                                              size_t dropped) {
+  protobuf::NestedEncoder nested_encoder(buffer);
+  log::LogEntry::Encoder encoder(&nested_encoder);
+
+  encoder.WriteMessageTokenized(message);
+  encoder.WriteLineLevel(
+      (level & PW_LOG_LEVEL_BITMASK) |
+      ((line << PW_LOG_LEVEL_BITWIDTH) & ~PW_LOG_LEVEL_BITMASK));
+  encoder.WriteFlags(flags);
+  encoder.WriteThreadTokenized(thread);
+
+  // BatchCopier delta encodes the timestamp when entries are batched.
+  encoder.WriteTimestamp(timestamp);
+
+  if (dropped > 0) {
+    encoder.WriteDropped(dropped);
+  }
+
+  return nested_encoder.Encode();
+}
+
+Result<ConstByteSpan> EncodeDroppedLogEntry(ByteSpan buffer, size_t dropped) {
+  protobuf::NestedEncoder nested_encoder(buffer);
+  log::LogEntry::Encoder encoder(&nested_encoder);
+  encoder.WriteDropped(dropped);
+  return nested_encoder.Encode();
+}
+
+StatusWithSize CopyEntry(ByteSpan buffer,
+                         std::byte key,
+                         ConstByteSpan data,
+                         ConstByteSpan wrapped_data) {
+  const size_t size = data.size_bytes() + wrapped_data.size_bytes();
+  const size_t preamble_bytes = sizeof(key) + varint::EncodedSize(size);
+  if (buffer.size_bytes() < preamble_bytes + size) {
+    return StatusWithSize::ResourceExhausted();
+  }
+
+  buffer[0] = key;
+  varint::Encode(size, buffer.subspan(sizeof(key)));
+  std::copy(data.begin(), data.end(), buffer.begin() + preamble_bytes);
+  std::copy(wrapped_data.begin(),
+            wrapped_data.end(),
+            buffer.begin() + preamble_bytes + data.size_bytes());
+  return StatusWithSize(preamble_bytes + size);
+}
+
+namespace {
+
+constexpr uint32_t kTimestampField =
+    static_cast<uint32_t>(log::LogEntry::Fields::TIMESTAMP);
+constexpr std::byte kElapsedTimeKey = static_cast<std::byte>(protobuf::MakeKey(
+    static_cast<uint32_t>(log::LogEntry::Fields::ELAPSED_TIME_SINCE_LAST_ENTRY),
+    protobuf::WireType::kVarint));
+
+// Finds the timestamp field of an encoded pw.log.LogEntry. Sets the offset and
+// size of the field, including its key, and returns false if the entry has no
+// timestamp or cannot be parsed.
+bool FindTimestamp(ConstByteSpan entry,
+                   size_t* field_offset,
+                   size_t* field_size,
+                   int64_t* timestamp) {
+  size_t offset = 0;
+  while (offset < entry.size()) {
+    const size_t key_offset = offset;
+    uint64_t key;
+    size_t bytes = varint::Decode(entry.subspan(offset), &key);
+    if (bytes == 0) {
+      return false;
+    }
+    offset += bytes;
+
+    uint64_t value;
+    switch (static_cast<protobuf::WireType>(key & protobuf::kWireTypeMask)) {
+      case protobuf::WireType::kVarint:
+        bytes = varint::Decode(entry.subspan(offset), &value);
+        if (bytes == 0) {
+          return false;
+        }
+        offset += bytes;
+        if ((key >> protobuf::kFieldNumberShift) == kTimestampField) {
+          *field_offset = key_offset;
+          *field_size = offset - key_offset;
+          *timestamp = static_cast<int64_t>(value);
+          return true;
+        }
+        break;
+      case protobuf::WireType::kDelimited:
+        bytes = varint::Decode(entry.subspan(offset), &value);
+        if (bytes == 0 || value > entry.size() - offset - bytes) {
+          return false;
+        }
+        offset += bytes + value;
+        break;
+      case protobuf::WireType::kFixed32:
+        offset += sizeof(uint32_t);
+        break;
+      case protobuf::WireType::kFixed64:
+        offset += sizeof(uint64_t);
+        break;
+      default:
+        return false;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+StatusWithSize BatchCopier::CopyEntry(ByteSpan buffer,
+                                      std::byte key,
+                                      ConstByteSpan data,
+                                      ConstByteSpan wrapped_data) {
+  const StatusWithSize copied =
+      internal::CopyEntry(buffer, key, data, wrapped_data);
+  if (!copied.ok()) {
+    return copied;
+  }
+
+  const size_t size = data.size_bytes() + wrapped_data.size_bytes();
+  const size_t preamble_bytes = copied.size() - size;
+  ByteSpan entry = buffer.subspan(preamble_bytes, size);
+
+  size_t field_offset;
+  size_t field_size;
+  int64_t timestamp;
+  if (!FindTimestamp(entry, &field_offset, &field_size, &timestamp)) {
+    return copied;
+  }
+
+  const int64_t delta = timestamp - last_timestamp_;
+  const bool replace = has_timestamp_ && delta >= 0 &&
+                       sizeof(kElapsedTimeKey) + varint::EncodedSize(delta) <
+                           field_size;
+  has_timestamp_ = true;
+  last_timestamp_ = timestamp;
+  if (!replace) {
+    return copied;
+  }
+
+  // Replace the timestamp field in place, moving the fields after it down.
+  const size_t delta_size = sizeof(kElapsedTimeKey) + varint::EncodedSize(delta);
+  const size_t field_end = field_offset + field_size;
+  std::memmove(&entry[field_offset + delta_size],
+               &entry[field_end],
+               size - field_end);
+  entry[field_offset] = kElapsedTimeKey;
+  varint::Encode(static_cast<uint64_t>(delta),
+                 entry.subspan(field_offset + sizeof(kElapsedTimeKey)));
+
+  // The entry's size may now need fewer bytes, shortening the preamble.
+  const size_t new_size = size - (field_size - delta_size);
+  const size_t new_preamble_bytes =
+      sizeof(key) + varint::EncodedSize(new_size);
+  if (new_preamble_bytes != preamble_bytes) {
+    std::memmove(&buffer[new_preamble_bytes], entry.data(), new_size);
+  }
+  varint::Encode(new_size, buffer.subspan(sizeof(key)));
+  return StatusWithSize(new_preamble_bytes + new_size);
+}
+
+}  // namespace pw::log_rpc::internal
@@ -14,20 +14,15 @@
 
 #include "pw_log_multisink/log_queue.h"
 
-#include "pw_log/levels.h"
-#include "pw_log_proto/log.pwpb.h"
-#include "pw_protobuf/wire_format.h"
+#include <algorithm>
+
+#include "pw_log_multisink_private/log_entry.h"
 #include "pw_status/try.h"
+#include "pw_varint/varint.h"
 
 namespace pw::log_rpc {
-namespace {
-
-using pw::protobuf::WireType;
-constexpr std::byte kLogKey = static_cast<std::byte>(pw::protobuf::MakeKey(
-    static_cast<uint32_t>(pw::log::LogEntries::Fields::ENTRIES),
-    WireType::kDelimited));
 
-}  // namespace
+using internal::kLogKey;
 
 Status LogQueue::PushTokenizedMessage(ConstByteSpan message,
                                       uint32_t flags,
@@ -35,44 +30,47 @@ Status LogQueue::PushTokenizedMessage(ConstByteSpan message,
                                       uint32_t line,
                                       uint32_t thread,
                                       int64_t timestamp) {
-  pw::protobuf::NestedEncoder nested_encoder(encode_buffer_);
-  pw::log::LogEntry::Encoder encoder(&nested_encoder);
-  Status status;
-
-  encoder.WriteMessageTokenized(message);
-  encoder.WriteLineLevel(
-      (level & PW_LOG_LEVEL_BITMASK) |
-      ((line << PW_LOG_LEVEL_BITWIDTH) & ~PW_LOG_LEVEL_BITMASK));
-  encoder.WriteFlags(flags);
-  encoder.WriteThreadTokenized(thread);
-
-  // TODO(prashanthsw): Add support for delta encoding of the timestamp.
-  encoder.WriteTimestamp(timestamp);
-
-  if (dropped_entries_ > 0) {
-    encoder.WriteDropped(dropped_entries_);
+  // Encode the entry in place in the ring buffer.
+  const size_t reserve_size = ReserveSize();
+  ByteSpan entry_buffer;
+  Status status = ring_buffer_.TryReserve(
+      reserve_size, &entry_buffer, std::byte(kLogKey));
+  if (!status.ok()) {
+    dropped_entries_++;
+    latest_dropped_timestamp_ = timestamp;
+    return status;
   }
 
-  ConstByteSpan log_entry;
-  status = nested_encoder.Encode(&log_entry);
-  if (!status.ok() || log_entry.size_bytes() > max_log_entry_size_) {
-    // If an encoding failure occurs or the constructed log entry is larger
-    // than the configured max size, map the error to INTERNAL. If the
-    // underlying allocation of this encode buffer or the nested encoding
-    // sequencing are at fault, they are not the caller's responsibility. If
-    // the log entry is larger than the max allowed size, the log is dropped
-    // intentionally, and it is expected that the caller accepts this
-    // possibility.
-    status = PW_STATUS_INTERNAL;
+  const Result<ConstByteSpan> log_entry =
+      internal::EncodeTokenizedLogEntry(entry_buffer,
+                                        message,
+                                        flags,
+                                        level,
+                                        line,
+                                        thread,
+                                        timestamp,
+                                        dropped_entries_);
+  status = log_entry.status();
+  if (status.ok()) {
+    status = ring_buffer_.Commit(log_entry.value().size_bytes());
   } else {
-    // Try to push back the encoded log entry.
-    status = ring_buffer_.TryPushBack(log_entry, std::byte(kLogKey));
+    ring_buffer_.Commit(0);
+    if (reserve_size < max_log_entry_size_) {
+      // The entry did not fit in the free space of the ring buffer.
+      status = Status::ResourceExhausted();
+    } else {
+      // If an encoding failure occurs or the constructed log entry is larger
+      // than the configured max size, map the error to INTERNAL. If the
+      // nested encoding sequencing is at fault, it is not the caller's
+      // responsibility. If the log entry is larger than the max allowed size,
+      // the log is dropped intentionally, and it is expected that the caller
+      // accepts this possibility.
+      status = PW_STATUS_INTERNAL;
+    }
   }
 
   if (!status.ok()) {
-    // The ring buffer may hit the RESOURCE_EXHAUSTED state, causing us
-    // to drop packets. However, this check captures all failures from
-    // Encode and TryPushBack, as any failure here causes packet drop.
+    // Any failure here causes packet drop.
     dropped_entries_++;
     latest_dropped_timestamp_ = timestamp;
     return status;
@@ -82,6 +80,19 @@ Status LogQueue::PushTokenizedMessage(ConstByteSpan message,
   return OkStatus();
 }
 
+size_t LogQueue::ReserveSize() {
+  // Reserving the max log entry size when less is free would drop entries
+  // that fit. If no data byte fits, reserve the max size so the ring buffer
+  // reports why.
+  const size_t free_bytes = log_buffer_size_ - ring_buffer_.TotalUsedBytes();
+  const size_t preamble_bytes =
+      sizeof(kLogKey) + varint::EncodedSize(max_log_entry_size_);
+  if (free_bytes <= preamble_bytes) {
+    return max_log_entry_size_;
+  }
+  return std::min(max_log_entry_size_, free_bytes - preamble_bytes);
+}
+
 Result<LogEntries> LogQueue::Pop(LogEntriesBuffer entry_buffer) {
   size_t ring_buffer_entry_size = 0;
   PW_TRY(pop_status_for_test_);
@@ -105,16 +116,25 @@ LogEntries LogQueue::PopMultiple(LogEntriesBuffer entries_buffer) {
   // ensure that the front entry of the ring buffer can be popped.
   PW_DCHECK_UINT_GE(entries_buffer.size_bytes(), max_log_entry_size_);
 
-  while (ring_buffer_.EntryCount() > 0 &&
-         (entries_buffer.size_bytes() - offset) > max_log_entry_size_) {
-    const Result<LogEntries> result = Pop(entries_buffer.subspan(offset));
-    if (!result.ok()) {
-      break;
-    }
-    offset += result.value().entries.size_bytes();
-    entry_count += result.value().entry_count;
+  if (!pop_status_for_test_.ok()) {
+    return LogEntries{.entries = ConstByteSpan(), .entry_count = 0};
   }
 
+  // Copy entries out and pop them in a single pass over the ring buffer,
+  // until the next entry does not fit. Each entry's preamble is the key and
+  // the size of a pw.log.LogEntries entries field. Timestamps after the first
+  // are delta encoded.
+  internal::BatchCopier copier;
+  ring_buffer_.PeekAndPopFront([&](std::byte key,
+                                   ConstByteSpan data,
+                                   ConstByteSpan wrapped_data) {
+    const StatusWithSize copied = copier.CopyEntry(
+        entries_buffer.subspan(offset), key, data, wrapped_data);
+    offset += copied.size();
+    entry_count += copied.ok() ? 1 : 0;
+    return copied.status();
+  });
+
   return LogEntries{.entries = ConstByteSpan(entries_buffer.first(offset)),
                     .entry_count = entry_count};
 }
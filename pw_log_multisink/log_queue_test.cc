@@ -85,7 +85,7 @@ void VerifyLogEntry(pw::protobuf::Decoder& log_decoder,
 
 TEST(LogQueue, SinglePushPopTokenizedMessage) {
   std::byte log_buffer[kLogBufferSize];
-  LogQueueWithEncodeBuffer<kEncodeBufferSize> log_queue(log_buffer);
+  LogQueue log_queue(log_buffer);
 
   EXPECT_EQ(OkStatus(),
             log_queue.PushTokenizedMessage(
@@ -115,7 +115,7 @@ TEST(LogQueue, MultiplePushPopTokenizedMessage) {
   constexpr size_t kEntryCount = 3;
 
   std::byte log_buffer[1024];
-  LogQueueWithEncodeBuffer<kEncodeBufferSize> log_queue(log_buffer);
+  LogQueue log_queue(log_buffer);
 
   for (size_t i = 0; i < kEntryCount; i++) {
     EXPECT_EQ(OkStatus(),
@@ -149,7 +149,7 @@ TEST(LogQueue, PopMultiple) {
   constexpr size_t kEntryCount = 3;
 
   std::byte log_buffer[kLogBufferSize];
-  LogQueueWithEncodeBuffer<kEncodeBufferSize> log_queue(log_buffer);
+  LogQueue log_queue(log_buffer);
 
   for (size_t i = 0; i < kEntryCount; i++) {
     EXPECT_EQ(OkStatus(),
@@ -179,11 +179,11 @@ TEST(LogQueue, PopMultiple) {
   }
 }
 
-TEST(LogQueue, TooSmallEncodeBuffer) {
-  constexpr size_t kSmallBuffer = 1;
+TEST(LogQueue, TooSmallMaxLogEntrySize) {
+  constexpr size_t kSmallEntry = 1;
 
   std::byte log_buffer[kLogBufferSize];
-  LogQueueWithEncodeBuffer<kSmallBuffer> log_queue(log_buffer);
+  LogQueue log_queue(log_buffer, kSmallEntry);
   EXPECT_EQ(Status::Internal(),
             log_queue.PushTokenizedMessage(
                 std::as_bytes(std::span(kTokenizedMessage)),
@@ -200,8 +200,7 @@ TEST(LogQueue, TooSmallLogBuffer) {
 
   // Expect OUT_OF_RANGE when the buffer is smaller than a preamble.
   std::byte log_buffer[kLogBufferSize];
-  LogQueueWithEncodeBuffer<kEncodeBufferSize> log_queue_small(
-      std::span(log_buffer, kSmallerThanPreamble));
+  LogQueue log_queue_small(std::span(log_buffer, kSmallerThanPreamble));
   EXPECT_EQ(Status::OutOfRange(),
             log_queue_small.PushTokenizedMessage(
                 std::as_bytes(std::span(kTokenizedMessage)),
@@ -212,7 +211,7 @@ TEST(LogQueue, TooSmallLogBuffer) {
                 kTimestamp));
 
   // Expect RESOURCE_EXHAUSTED when there's not enough space for the chunk.
-  LogQueueWithEncodeBuffer<kEncodeBufferSize> log_queue_medium(log_buffer);
+  LogQueue log_queue_medium(log_buffer);
   for (size_t i = 0; i < kEntryCount; i++) {
     log_queue_medium.PushTokenizedMessage(
         std::as_bytes(std::span(kTokenizedMessage)),
@@ -232,4 +231,86 @@ TEST(LogQueue, TooSmallLogBuffer) {
                 kTimestamp));
 }
 
+TEST(LogQueue, BufferSmallerThanMaxLogEntrySize) {
+  constexpr size_t kSmallBuffer = 64;
+  constexpr size_t kEntryCount = 2;
+
+  // Entries are encoded in place, so entries smaller than the max log entry
+  // size fit even when less than the max size is free.
+  std::byte log_buffer[kSmallBuffer];
+  LogQueue log_queue(log_buffer);
+  for (size_t i = 0; i < kEntryCount; i++) {
+    EXPECT_EQ(OkStatus(),
+              log_queue.PushTokenizedMessage(
+                  std::as_bytes(std::span(kTokenizedMessage)),
+                  kFlags,
+                  kLevel,
+                  kLine,
+                  kTokenizedThread,
+                  kTimestamp));
+  }
+
+  std::byte log_entries[kLogBufferSize];
+  LogEntries entries = log_queue.PopMultiple(log_entries);
+  EXPECT_EQ(kEntryCount, entries.entry_count);
+}
+
+TEST(LogQueue, PopMultiple_DeltaEncodesTimestamps) {
+  constexpr int64_t kStart = 1'000'000'000;
+  constexpr int64_t kTimestamps[] = {kStart, kStart + 5, kStart + 300, kStart};
+  // The first timestamp is absolute, as is the last, which is earlier than the
+  // one before it.
+  constexpr uint32_t kExpectedFields[] = {5, 6, 6, 5};
+  constexpr int64_t kExpectedValues[] = {kStart, 5, 295, kStart};
+
+  std::byte log_buffer[kLogBufferSize];
+  LogQueue log_queue(log_buffer);
+  for (int64_t timestamp : kTimestamps) {
+    ASSERT_EQ(OkStatus(),
+              log_queue.PushTokenizedMessage(
+                  std::as_bytes(std::span(kTokenizedMessage)),
+                  kFlags,
+                  kLevel,
+                  kLine,
+                  kTokenizedThread,
+                  timestamp));
+  }
+
+  std::byte log_entries[kLogBufferSize];
+  LogEntries entries = log_queue.PopMultiple(log_entries);
+  ASSERT_EQ(std::size(kTimestamps), entries.entry_count);
+
+  // The absolute timestamp takes 6 bytes; the deltas take 2 and 3.
+  constexpr size_t kExpectedSavings[] = {0, 4, 3, 0};
+
+  protobuf::Decoder log_decoder(entries.entries);
+  int64_t timestamp = 0;
+  size_t absolute_entry_size = 0;
+  for (size_t i = 0; i < std::size(kTimestamps); ++i) {
+    ConstByteSpan entry;
+    ASSERT_EQ(OkStatus(), log_decoder.Next());
+    ASSERT_EQ(OkStatus(), log_decoder.ReadBytes(&entry));
+    if (i == 0) {
+      absolute_entry_size = entry.size();
+    }
+    EXPECT_EQ(absolute_entry_size - kExpectedSavings[i], entry.size());
+
+    protobuf::Decoder entry_decoder(entry);
+    bool found = false;
+    while (entry_decoder.Next().ok()) {
+      const uint32_t field = entry_decoder.FieldNumber();
+      if (field == 5 || field == 6) {
+        int64_t value;
+        ASSERT_EQ(OkStatus(), entry_decoder.ReadInt64(&value));
+        EXPECT_EQ(kExpectedFields[i], field);
+        EXPECT_EQ(kExpectedValues[i], value);
+        timestamp = field == 5 ? value : timestamp + value;
+        found = true;
+      }
+    }
+    EXPECT_TRUE(found);
+    EXPECT_EQ(kTimestamps[i], timestamp);
+  }
+}
+
 }  // namespace pw::log_rpc
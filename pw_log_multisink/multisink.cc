@@ -0,0 +1,208 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_multisink/multisink.h"
+
+#include <algorithm>
+
+#include "pw_assert/assert.h"
+#include "pw_log_multisink_private/log_entry.h"
+#include "pw_status/try.h"
+#include "pw_varint/varint.h"
+
+namespace pw::log_rpc {
+
+using internal::kLogKey;
+
+Result<size_t> MultiSink::Drain::WriteDroppedEntry(ByteSpan buffer) {
+  const size_t dropped = dropped_entries();
+  if (dropped == reported_drops_) {
+    return 0;
+  }
+
+  // A LogEntry with only the dropped field set.
+  std::byte entry_buffer[16];
+  const Result<ConstByteSpan> entry =
+      internal::EncodeDroppedLogEntry(entry_buffer, dropped - reported_drops_);
+  PW_TRY(entry.status());
+  const StatusWithSize copied =
+      internal::CopyEntry(buffer, kLogKey, entry.value());
+  PW_TRY(copied.status());
+  reported_drops_ = dropped;
+  return copied.size();
+}
+
+Result<LogEntries> MultiSink::Drain::Pop(LogEntriesBuffer entry_buffer) {
+  if (multisink_ == nullptr) {
+    return Status::FailedPrecondition();
+  }
+  // The caller must provide a buffer that is at minimum max_log_entry_size, to
+  // ensure that the front entry of the ring buffer can be popped.
+  PW_DCHECK_UINT_GE(entry_buffer.size_bytes(), multisink_->max_log_entry_size_);
+
+  // Report dropped entries before the entries after them.
+  const Result<size_t> dropped_entry_size = WriteDroppedEntry(entry_buffer);
+  PW_TRY(dropped_entry_size.status());
+  if (dropped_entry_size.value() > 0) {
+    return LogEntries{.entries = ConstByteSpan(
+                          entry_buffer.first(dropped_entry_size.value())),
+                      .entry_count = 1};
+  }
+
+  size_t ring_buffer_entry_size = 0;
+  PW_TRY(reader_.PeekFrontWithPreamble(entry_buffer, &ring_buffer_entry_size));
+  PW_DCHECK_OK(reader_.PopFront());
+
+  return LogEntries{
+      .entries = ConstByteSpan(entry_buffer.first(ring_buffer_entry_size)),
+      .entry_count = 1};
+}
+
+LogEntries MultiSink::Drain::PopMultiple(LogEntriesBuffer entries_buffer) {
+  if (multisink_ == nullptr) {
+    return LogEntries{.entries = ConstByteSpan(), .entry_count = 0};
+  }
+  // The caller must provide a buffer that is at minimum max_log_entry_size, to
+  // ensure that the front entry of the ring buffer can be popped.
+  PW_DCHECK_UINT_GE(entries_buffer.size_bytes(),
+                    multisink_->max_log_entry_size_);
+
+  size_t offset = 0;
+  size_t entry_count = 0;
+
+  // Report dropped entries before the entries after them.
+  const Result<size_t> dropped_entry_size = WriteDroppedEntry(entries_buffer);
+  if (!dropped_entry_size.ok()) {
+    return LogEntries{.entries = ConstByteSpan(), .entry_count = 0};
+  }
+  if (dropped_entry_size.value() > 0) {
+    offset = dropped_entry_size.value();
+    entry_count = 1;
+  }
+
+  // Copy entries out and pop them in a single pass over the ring buffer,
+  // until the next entry does not fit. Timestamps after the first are delta
+  // encoded.
+  internal::BatchCopier copier;
+  reader_.PeekAndPopFront([&](std::byte key,
+                              ConstByteSpan data,
+                              ConstByteSpan wrapped_data) {
+    const StatusWithSize copied = copier.CopyEntry(
+        entries_buffer.subspan(offset), key, data, wrapped_data);
+    offset += copied.size();
+    entry_count += copied.ok() ? 1 : 0;
+    return copied.status();
+  });
+
+  return LogEntries{.entries = ConstByteSpan(entries_buffer.first(offset)),
+                    .entry_count = entry_count};
+}
+
+Status MultiSink::AttachDrain(Drain& drain) {
+  if (drain.multisink_ != nullptr) {
+    return Status::InvalidArgument();
+  }
+  PW_TRY(ring_buffer_.AttachReader(drain.reader_));
+  drain.multisink_ = this;
+  drain.push_failures_ = 0;
+  drain.reported_drops_ = drain.reader_.DroppedEntries();
+  drains_.push_front(drain);
+  return OkStatus();
+}
+
+Status MultiSink::DetachDrain(Drain& drain) {
+  if (drain.multisink_ != this) {
+    return Status::InvalidArgument();
+  }
+  PW_TRY(ring_buffer_.DetachReader(drain.reader_));
+  drain.multisink_ = nullptr;
+  drains_.remove(drain);
+  return OkStatus();
+}
+
+Status MultiSink::PushTokenizedMessage(ConstByteSpan message,
+                                       uint32_t flags,
+                                       uint32_t level,
+                                       uint32_t line,
+                                       uint32_t thread,
+                                       int64_t timestamp) {
+  // First encode the entry into the free space, so no entries are replaced if
+  // the new entry fits. If it does not, reserve the max entry size, replacing
+  // the oldest entries of the slowest drains.
+  Status status = Status::ResourceExhausted();
+  if (const size_t free_size = FreeEntrySize(); free_size > 0) {
+    status = Encode(
+        free_size, false, message, flags, level, line, thread, timestamp);
+  }
+  if (status.IsResourceExhausted()) {
+    status = Encode(max_log_entry_size_,
+                    true,
+                    message,
+                    flags,
+                    level,
+                    line,
+                    thread,
+                    timestamp);
+  }
+
+  if (!status.ok()) {
+    // The entry is dropped for every drain.
+    for (Drain& drain : drains_) {
+      drain.push_failures_++;
+    }
+    return status;
+  }
+
+  for (Listener& listener : listeners_) {
+    listener.OnNewEntryAvailable();
+  }
+  return OkStatus();
+}
+
+Status MultiSink::Encode(size_t reserve_size,
+                         bool evict,
+                         ConstByteSpan message,
+                         uint32_t flags,
+                         uint32_t level,
+                         uint32_t line,
+                         uint32_t thread,
+                         int64_t timestamp) {
+  ByteSpan entry_buffer;
+  PW_TRY(evict ? ring_buffer_.Reserve(reserve_size, &entry_buffer, kLogKey)
+               : ring_buffer_.TryReserve(reserve_size, &entry_buffer, kLogKey));
+
+  const Result<ConstByteSpan> log_entry = internal::EncodeTokenizedLogEntry(
+      entry_buffer, message, flags, level, line, thread, timestamp, 0);
+  if (!log_entry.ok()) {
+    ring_buffer_.Commit(0);
+    // If the entry did not fit in less than the max size, it may still fit in
+    // the max size. Otherwise, as in LogQueue, the encoding failed or the
+    // entry is larger than the max size, and it is dropped intentionally.
+    return reserve_size < max_log_entry_size_ ? Status::ResourceExhausted()
+                                              : Status::Internal();
+  }
+  return ring_buffer_.Commit(log_entry.value().size_bytes());
+}
+
+size_t MultiSink::FreeEntrySize() {
+  const size_t free_bytes = log_buffer_size_ - ring_buffer_.TotalUsedBytes();
+  const size_t preamble_bytes =
+      sizeof(kLogKey) + varint::EncodedSize(max_log_entry_size_);
+  if (free_bytes <= preamble_bytes) {
+    return 0;
+  }
+  return std::min(max_log_entry_size_, free_bytes - preamble_bytes);
+}
+
+}  // namespace pw::log_rpc
@@ -0,0 +1,281 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_multisink/multisink.h"
+
+#include <array>
+
+#include "gtest/gtest.h"
+#include "pw_protobuf/decoder.h"
+
+namespace pw::log_rpc {
+namespace {
+
+constexpr size_t kEncodeBufferSize = 512;
+constexpr size_t kLogBufferSize = kEncodeBufferSize * 3;
+
+constexpr const char kTokenizedMessage[] = "msg_token";
+constexpr uint32_t kFlags = 0xF;
+constexpr uint32_t kLevel = 0b010;
+constexpr uint32_t kLine = 0b101011000;
+constexpr uint32_t kTokenizedThread = 0xF;
+
+constexpr uint32_t kLogEntryTimestampField = 5;
+constexpr uint32_t kLogEntryElapsedTimeField = 6;
+constexpr uint32_t kLogEntryDroppedField = 19;
+
+Status Push(MultiSink& multisink, int64_t timestamp) {
+  return multisink.PushTokenizedMessage(
+      std::as_bytes(std::span(kTokenizedMessage)),
+      kFlags,
+      kLevel,
+      kLine,
+      kTokenizedThread,
+      timestamp);
+}
+
+// Reads the next pw.log.LogEntries entry, and returns its timestamp, or -1 if
+// it is a "missed logs" entry, in which case dropped is set.
+int64_t NextEntry(protobuf::Decoder& decoder, uint32_t* dropped = nullptr) {
+  ConstByteSpan entry;
+  EXPECT_EQ(OkStatus(), decoder.Next());
+  EXPECT_EQ(1u, decoder.FieldNumber());
+  EXPECT_EQ(OkStatus(), decoder.ReadBytes(&entry));
+
+  protobuf::Decoder entry_decoder(entry);
+  while (entry_decoder.Next().ok()) {
+    if (entry_decoder.FieldNumber() == kLogEntryTimestampField) {
+      int64_t timestamp = 0;
+      EXPECT_EQ(OkStatus(), entry_decoder.ReadInt64(&timestamp));
+      return timestamp;
+    }
+    if (entry_decoder.FieldNumber() == kLogEntryDroppedField) {
+      uint32_t value = 0;
+      EXPECT_EQ(OkStatus(), entry_decoder.ReadUint32(&value));
+      if (dropped != nullptr) {
+        *dropped = value;
+      }
+      return -1;
+    }
+  }
+  ADD_FAILURE();  // The entry has no timestamp or dropped field.
+  return -2;
+}
+
+class CountingListener : public MultiSink::Listener {
+ public:
+  void OnNewEntryAvailable() override { count++; }
+  int count = 0;
+};
+
+TEST(MultiSink, DrainsReadIndependently) {
+  std::byte log_buffer[kLogBufferSize];
+  MultiSink multisink(log_buffer);
+  MultiSink::Drain fast;
+  MultiSink::Drain slow;
+  ASSERT_EQ(OkStatus(), multisink.AttachDrain(fast));
+  ASSERT_EQ(OkStatus(), multisink.AttachDrain(slow));
+
+  for (int64_t i = 0; i < 3; ++i) {
+    ASSERT_EQ(OkStatus(), Push(multisink, i));
+  }
+
+  // The fast drain reads everything; the slow drain still has every entry.
+  std::byte entries_buffer[kLogBufferSize];
+  LogEntries entries = fast.PopMultiple(entries_buffer);
+  EXPECT_EQ(3u, entries.entry_count);
+  EXPECT_EQ(0u, fast.PopMultiple(entries_buffer).entry_count);
+
+  std::byte entry_buffer[kEncodeBufferSize];
+  for (int64_t i = 0; i < 3; ++i) {
+    Result<LogEntries> entry = slow.Pop(entry_buffer);
+    ASSERT_EQ(OkStatus(), entry.status());
+    EXPECT_EQ(1u, entry.value().entry_count);
+    protobuf::Decoder decoder(entry.value().entries);
+    EXPECT_EQ(i, NextEntry(decoder));
+  }
+  EXPECT_EQ(Status::OutOfRange(), slow.Pop(entry_buffer).status());
+}
+
+TEST(MultiSink, SlowDrainDropsOldestEntries) {
+  constexpr size_t kSmallBuffer = 128;
+  constexpr int64_t kEntryCount = 20;
+
+  std::byte log_buffer[kSmallBuffer];
+  MultiSink multisink(log_buffer);
+  MultiSink::Drain fast;
+  MultiSink::Drain slow;
+  ASSERT_EQ(OkStatus(), multisink.AttachDrain(fast));
+  ASSERT_EQ(OkStatus(), multisink.AttachDrain(slow));
+
+  // The fast drain keeps up, so it never drops entries, even though the slow
+  // drain never reads and the buffer is full.
+  std::byte entries_buffer[kLogBufferSize];
+  for (int64_t i = 0; i < kEntryCount; ++i) {
+    ASSERT_EQ(OkStatus(), Push(multisink, i));
+    LogEntries entries = fast.PopMultiple(entries_buffer);
+    ASSERT_EQ(1u, entries.entry_count);
+    protobuf::Decoder decoder(entries.entries);
+    EXPECT_EQ(i, NextEntry(decoder));
+  }
+  EXPECT_EQ(0u, fast.dropped_entries());
+  ASSERT_GT(slow.dropped_entries(), 0u);
+
+  // The slow drain reports its drops, then reads the newest entries.
+  LogEntries entries = slow.PopMultiple(entries_buffer);
+  protobuf::Decoder decoder(entries.entries);
+  uint32_t dropped = 0;
+  EXPECT_EQ(-1, NextEntry(decoder, &dropped));
+  EXPECT_EQ(slow.dropped_entries(), dropped);
+  for (int64_t i = dropped; i < kEntryCount; ++i) {
+    EXPECT_EQ(i, NextEntry(decoder));
+  }
+  EXPECT_EQ(kEntryCount - dropped + 1,
+            static_cast<int64_t>(entries.entry_count));
+
+  // Drops are only reported once.
+  EXPECT_EQ(0u, slow.PopMultiple(entries_buffer).entry_count);
+}
+
+TEST(MultiSink, PopReportsDropsBeforeNextEntry) {
+  constexpr size_t kSmallBuffer = 128;
+
+  std::byte log_buffer[kSmallBuffer];
+  MultiSink multisink(log_buffer);
+  MultiSink::Drain drain;
+  ASSERT_EQ(OkStatus(), multisink.AttachDrain(drain));
+
+  for (int64_t i = 0; i < 20; ++i) {
+    ASSERT_EQ(OkStatus(), Push(multisink, i));
+  }
+  const size_t dropped = drain.dropped_entries();
+  ASSERT_GT(dropped, 0u);
+
+  std::byte entry_buffer[kEncodeBufferSize];
+  Result<LogEntries> entry = drain.Pop(entry_buffer);
+  ASSERT_EQ(OkStatus(), entry.status());
+  protobuf::Decoder dropped_decoder(entry.value().entries);
+  uint32_t reported = 0;
+  EXPECT_EQ(-1, NextEntry(dropped_decoder, &reported));
+  EXPECT_EQ(dropped, reported);
+
+  entry = drain.Pop(entry_buffer);
+  ASSERT_EQ(OkStatus(), entry.status());
+  protobuf::Decoder decoder(entry.value().entries);
+  EXPECT_EQ(static_cast<int64_t>(dropped), NextEntry(decoder));
+}
+
+TEST(MultiSink, FailedPushIsDroppedForEveryDrain) {
+  constexpr size_t kSmallEntry = 1;
+
+  std::byte log_buffer[kLogBufferSize];
+  MultiSink multisink(log_buffer, kSmallEntry);
+  MultiSink::Drain first;
+  MultiSink::Drain second;
+  ASSERT_EQ(OkStatus(), multisink.AttachDrain(first));
+  ASSERT_EQ(OkStatus(), multisink.AttachDrain(second));
+
+  EXPECT_EQ(Status::Internal(), Push(multisink, 0));
+  EXPECT_EQ(1u, first.dropped_entries());
+  EXPECT_EQ(1u, second.dropped_entries());
+}
+
+TEST(MultiSink, ListenersAreNotified) {
+  std::byte log_buffer[kLogBufferSize];
+  MultiSink multisink(log_buffer);
+  MultiSink::Drain drain;
+  ASSERT_EQ(OkStatus(), multisink.AttachDrain(drain));
+
+  CountingListener listener;
+  multisink.AttachListener(listener);
+  ASSERT_EQ(OkStatus(), Push(multisink, 0));
+  ASSERT_EQ(OkStatus(), Push(multisink, 1));
+  EXPECT_EQ(2, listener.count);
+
+  multisink.DetachListener(listener);
+  ASSERT_EQ(OkStatus(), Push(multisink, 2));
+  EXPECT_EQ(2, listener.count);
+}
+
+TEST(MultiSink, AttachAndDetach) {
+  std::byte log_buffer[kLogBufferSize];
+  MultiSink multisink(log_buffer);
+  MultiSink other(log_buffer);
+  MultiSink::Drain drain;
+
+  std::byte entry_buffer[kEncodeBufferSize];
+  EXPECT_EQ(Status::FailedPrecondition(), drain.Pop(entry_buffer).status());
+  EXPECT_EQ(Status::InvalidArgument(), multisink.DetachDrain(drain));
+
+  ASSERT_EQ(OkStatus(), multisink.AttachDrain(drain));
+  EXPECT_EQ(Status::InvalidArgument(), multisink.AttachDrain(drain));
+  EXPECT_EQ(Status::InvalidArgument(), other.AttachDrain(drain));
+  EXPECT_EQ(Status::InvalidArgument(), other.DetachDrain(drain));
+  ASSERT_EQ(OkStatus(), Push(multisink, 0));
+
+  EXPECT_EQ(OkStatus(), multisink.DetachDrain(drain));
+  EXPECT_EQ(Status::FailedPrecondition(), drain.Pop(entry_buffer).status());
+}
+
+TEST(MultiSink, PopMultiple_DeltaEncodesTimestamps) {
+  // With an absolute timestamp, an entry with this message takes 128 bytes, so
+  // delta encoding also shortens the entry's size prefix.
+  constexpr std::array<std::byte, 113> kLongMessage = {};
+  constexpr int64_t kStart = 1'000'000'000;
+  constexpr int64_t kTimestamps[] = {kStart, kStart + 5};
+
+  std::byte log_buffer[kLogBufferSize];
+  MultiSink multisink(log_buffer, kEncodeBufferSize);
+  MultiSink::Drain drain;
+  ASSERT_EQ(OkStatus(), multisink.AttachDrain(drain));
+  for (int64_t timestamp : kTimestamps) {
+    ASSERT_EQ(OkStatus(),
+              multisink.PushTokenizedMessage(kLongMessage,
+                                             kFlags,
+                                             kLevel,
+                                             kLine,
+                                             kTokenizedThread,
+                                             timestamp));
+  }
+
+  std::byte entries_buffer[kEncodeBufferSize];
+  LogEntries entries = drain.PopMultiple(entries_buffer);
+  ASSERT_EQ(2u, entries.entry_count);
+  EXPECT_EQ((1u + 2u + 128u) + (1u + 1u + 124u), entries.entries.size());
+
+  protobuf::Decoder decoder(entries.entries);
+  int64_t timestamp = 0;
+  for (int64_t expected_timestamp : kTimestamps) {
+    ConstByteSpan entry;
+    ASSERT_EQ(OkStatus(), decoder.Next());
+    ASSERT_EQ(OkStatus(), decoder.ReadBytes(&entry));
+
+    protobuf::Decoder entry_decoder(entry);
+    while (entry_decoder.Next().ok()) {
+      int64_t value = 0;
+      if (entry_decoder.FieldNumber() == kLogEntryTimestampField) {
+        ASSERT_EQ(OkStatus(), entry_decoder.ReadInt64(&value));
+        timestamp = value;
+      } else if (entry_decoder.FieldNumber() == kLogEntryElapsedTimeField) {
+        ASSERT_EQ(OkStatus(), entry_decoder.ReadInt64(&value));
+        timestamp += value;
+      }
+    }
+    EXPECT_EQ(expected_timestamp, timestamp);
+  }
+  EXPECT_EQ(Status::OutOfRange(), decoder.Next());
+}
+
+}  // namespace
+}  // namespace pw::log_rpc
@@ -0,0 +1,234 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_bytes/span.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_log_multisink/log_queue.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+// FlashLogStore persists encoded pw.log.LogEntry messages, such as those popped
+// from a LogQueue or MultiSink drain, to a flash partition, so logs survive a
+// reset or power loss.
+//
+// Each sector of the partition holds one segment. A segment starts with a
+// header recording its segment number and the sequence number and timestamp
+// of its first entry, followed by length-prefixed entries. Entries are
+// collected in a RAM write buffer and written in alignment-sized chunks, so
+// flash is written in large batches rather than once per entry. When the
+// partition is full, the oldest segment is erased to make room.
+//
+// The segment headers form an index kept in RAM, so reads seek to the segment
+// containing a sequence number or timestamp without scanning the partition.
+// Entries are read back as a pw.log.LogEntries message, which can be sent
+// directly in an RPC stream.
+//
+// Usage:
+// 0) Create a FlashLogStoreBuffer for the partition and call Init().
+// 1) FlashLogStore::Append() each entry with its timestamp.
+// 2) FlashLogStore::Flush() to write buffered entries, e.g. before sleeping.
+// 3) FlashLogStore::ReadEntries() from a sequence number, for example one
+//    found with FlashLogStore::FindSequence().
+//
+// FlashLogStore is not thread safe.
+namespace pw::log_rpc {
+
+class FlashLogStore {
+ public:
+  // The index entry for one sector.
+  class Segment {
+   public:
+    constexpr Segment() = default;
+
+   private:
+    friend class FlashLogStore;
+
+    enum class State : uint8_t {
+      kUnknown,  // Needs erasing before use.
+      kErased,
+      kInUse,
+    };
+
+    State state_ = State::kUnknown;
+    uint32_t number_ = 0;
+    uint32_t first_sequence_ = 0;
+    int64_t first_timestamp_ = 0;
+  };
+
+  // The segments must have an entry for each sector of the partition. The
+  // write buffer size must be a multiple of the partition's alignment, which
+  // must be 1 or even.
+  FlashLogStore(kvs::FlashPartition& partition,
+                std::span<Segment> segments,
+                ByteSpan write_buffer);
+
+  FlashLogStore(const FlashLogStore&) = delete;
+  FlashLogStore& operator=(const FlashLogStore&) = delete;
+
+  // Reads the segment headers to rebuild the index and find where to resume
+  // writing. Entries that were buffered but not flushed before a reset are
+  // lost.
+  // Returns:
+  //
+  //  OK - success.
+  //  FAILED_PRECONDITION - The segments or write buffer are too small for the
+  //  partition.
+  //  Other errors - Reading the partition failed.
+  Status Init();
+
+  // Buffers an encoded pw.log.LogEntry, writing the buffer to flash when it is
+  // full. The timestamp is recorded in the index if the entry starts a
+  // segment.
+  // Returns:
+  //
+  //  OK - success.
+  //  FAILED_PRECONDITION - Init() was not called.
+  //  INVALID_ARGUMENT - The entry is empty or larger than a segment can hold.
+  //  Other errors - Writing or erasing flash failed.
+  Status Append(ConstByteSpan entry, int64_t timestamp);
+
+  // Writes buffered entries to flash, padded to the partition's alignment.
+  Status Flush();
+
+  // Reads stored entries, starting at first_sequence, into the provided buffer
+  // as a pw.log.LogEntries message, until the next entry does not fit or no
+  // entries remain. Only flushed entries are read. The next read continues at
+  // first_sequence + entry_count.
+  // Returns:
+  //
+  //  OK - success; entry_count is 0 if first_sequence has not been written.
+  //  NOT_FOUND - first_sequence has been erased; read from oldest_sequence().
+  //  RESOURCE_EXHAUSTED - The buffer is too small for the first entry.
+  //  DATA_LOSS - A segment is corrupt.
+  Result<LogEntries> ReadEntries(uint32_t first_sequence,
+                                 LogEntriesBuffer entries_buffer);
+
+  // Returns the sequence number of the first entry of the newest segment that
+  // started at or before timestamp, or the oldest sequence number if every
+  // segment started later. Reading from it returns the entries around
+  // timestamp.
+  uint32_t FindSequence(int64_t timestamp) const;
+
+  // The sequence number of the oldest stored entry.
+  uint32_t oldest_sequence() const;
+
+  // The sequence number the next appended entry will have.
+  uint32_t next_sequence() const { return next_sequence_; }
+
+ private:
+  // Each segment starts with a header, padded to the partition's alignment.
+  struct SegmentHeader {
+    uint32_t magic;
+    uint32_t number;
+    uint32_t first_sequence;
+    uint32_t checksum;
+    int64_t first_timestamp;
+
+    uint32_t CalculateChecksum() const;
+  };
+
+  static constexpr uint32_t kSegmentMagic = 0x474c5770;  // "pWLG"
+
+  // Each entry is preceded by its 16-bit little-endian length and padded to
+  // an even size, so a length always fits before an alignment boundary. A
+  // length of 0 pads to the next alignment boundary; an erased length ends
+  // the segment.
+  static constexpr size_t kLengthSize = sizeof(uint16_t);
+  static constexpr uint16_t kPaddingLength = 0;
+  static constexpr uint16_t kErasedLength = 0xffff;
+
+  static constexpr size_t RecordSize(size_t entry_size) {
+    return kLengthSize + entry_size + (entry_size % 2);
+  }
+
+  size_t HeaderSize() const;
+  size_t SectorSize() const { return partition_.sector_size_bytes(); }
+  kvs::FlashPartition::Address SectorAddress(size_t sector) const {
+    return static_cast<kvs::FlashPartition::Address>(sector * SectorSize());
+  }
+
+  // Reads the header of a sector and updates its index entry.
+  Status ReadSegment(size_t sector);
+
+  // Finds the end of the written data in the current segment, counting its
+  // entries.
+  Status ResumeSegment();
+
+  // Erases the next sector if needed and buffers the header of a new segment
+  // there.
+  Status StartSegment(int64_t timestamp);
+
+  // Copies data or zero padding into the write buffer, writing it to flash
+  // each time it fills.
+  Status Buffer(ConstByteSpan data);
+  Status BufferPadding(size_t size);
+  Status WriteBuffer();
+
+  // Finds the record at or after offset in the sector, skipping padding, and
+  // returns the offset after it. Sets the entry's offset and size; the size is
+  // 0 if the segment ends before limit.
+  Result<size_t> NextRecord(size_t sector,
+                            size_t offset,
+                            size_t limit,
+                            size_t* entry_offset,
+                            size_t* entry_size);
+
+  // Returns the sector holding the sequence number, if it is stored.
+  Result<size_t> FindSector(uint32_t sequence) const;
+
+  bool InUse(size_t sector) const {
+    return segments_[sector].state_ == Segment::State::kInUse;
+  }
+
+  kvs::FlashPartition& partition_;
+  const std::span<Segment> segments_;
+  const ByteSpan write_buffer_;
+
+  bool initialized_ = false;
+
+  // The sector of the newest segment, if any segment is in use.
+  size_t current_sector_ = 0;
+  bool has_segment_ = false;
+
+  // Where the write buffer will be written in the current sector, and how
+  // many bytes it holds.
+  size_t write_offset_ = 0;
+  size_t buffered_ = 0;
+
+  // The offset in the current sector up to which entries have been flushed.
+  size_t flushed_offset_ = 0;
+
+  uint32_t next_sequence_ = 0;
+};
+
+// Provides the index and write buffer for a FlashLogStore.
+template <size_t kMaxSectors, size_t kWriteBufferSize>
+class FlashLogStoreBuffer : public FlashLogStore {
+ public:
+  explicit FlashLogStoreBuffer(kvs::FlashPartition& partition)
+      : FlashLogStore(partition, segments_, write_buffer_) {}
+
+ private:
+  std::array<Segment, kMaxSectors> segments_;
+  std::array<std::byte, kWriteBufferSize> write_buffer_;
+};
+
+}  // namespace pw::log_rpc
@@ -55,12 +55,13 @@ class LogQueue {
   // queue. When such an entry arrives, the queue increments its drop counter.
   // Calls to Pop and PopMultiple should be provided a buffer of at least the
   // configured max size.
-  LogQueue(ByteSpan log_buffer,
-           ByteSpan encode_buffer,
-           size_t max_log_entry_size = kLogEntryMaxSize)
+  //
+  // Log entries are encoded directly into log_buffer, so no separate encode
+  // buffer is needed.
+  LogQueue(ByteSpan log_buffer, size_t max_log_entry_size = kLogEntryMaxSize)
       : pop_status_for_test_(OkStatus()),
         max_log_entry_size_(max_log_entry_size),
-        encode_buffer_(encode_buffer),
+        log_buffer_size_(log_buffer.size_bytes()),
         ring_buffer_(true) {
     ring_buffer_.SetBuffer(log_buffer);
   }
@@ -70,11 +71,13 @@ class LogQueue {
   LogQueue(LogQueue&&) = delete;
   LogQueue& operator=(LogQueue&&) = delete;
 
-  // Construct a LogEntry proto message and push it into the ring buffer.
+  // Construct a LogEntry proto message in the ring buffer.
   // Returns:
   //
   //  OK - success.
-  //  FAILED_PRECONDITION - Failed when encoding the proto message.
+  //  INTERNAL - Failed when encoding the proto message, or the message is
+  //  larger than the max log entry size.
+  //  OUT_OF_RANGE - The log buffer is too small for a log entry.
   //  RESOURCE_EXHAUSTED - Not enough space in the buffer to write the entry.
   Status PushTokenizedMessage(ConstByteSpan message,
                               uint32_t flags,
@@ -99,36 +102,33 @@ class LogQueue {
   Result<LogEntries> Pop(LogEntriesBuffer entry_buffer);
 
   // Pop entries from the queue into the provided buffer. The provided buffer is
-  // filled until there is insufficient space for the next log entry.
+  // filled until there is insufficient space for the next log entry. Only the
+  // first entry has an absolute timestamp; later entries have the time since
+  // the previous entry in elapsed_time_since_last_entry, when that is shorter.
   // Returns:
   //
   // LogEntries - contains an encoded protobuf byte span of pw.log.LogEntries.
   LogEntries PopMultiple(LogEntriesBuffer entries_buffer);
 
+  // The number of entries in the queue.
+  size_t EntryCount() { return ring_buffer_.EntryCount(); }
+
  protected:
   friend class LogQueueTester;
   // For testing, status to return on calls to Pop.
   Status pop_status_for_test_;
 
  private:
+  // The number of bytes to reserve in the ring buffer for the next entry: the
+  // max log entry size, or less if less space is free.
+  size_t ReserveSize();
+
   const size_t max_log_entry_size_;
-  size_t dropped_entries_;
-  int64_t latest_dropped_timestamp_;
+  const size_t log_buffer_size_;
+  size_t dropped_entries_ = 0;
+  int64_t latest_dropped_timestamp_ = 0;
 
-  ByteSpan encode_buffer_;
   pw::ring_buffer::PrefixedEntryRingBuffer ring_buffer_{true};
 };
 
-// LogQueueWithEncodeBuffer is a LogQueue where the internal encode buffer is
-// created and managed by this class.
-template <size_t kEncodeBufferSize>
-class LogQueueWithEncodeBuffer : public LogQueue {
- public:
-  LogQueueWithEncodeBuffer(ByteSpan log_buffer)
-      : LogQueue(log_buffer, encode_buffer_) {}
-
- private:
-  std::byte encode_buffer_[kEncodeBufferSize];
-};
-
 }  // namespace pw::log_rpc
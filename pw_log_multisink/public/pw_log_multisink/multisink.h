@@ -0,0 +1,185 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_containers/intrusive_list.h"
+#include "pw_log_multisink/log_queue.h"
+#include "pw_result/result.h"
+#include "pw_ring_buffer/prefixed_entry_ring_buffer.h"
+#include "pw_status/status.h"
+
+// MultiSink is a log queue with several consumers, such as a UART and an RPC
+// channel, which read the same log entries at their own pace. Entries are
+// encoded once into one shared ring buffer, in the pw_log log.proto format,
+// and each consumer reads them through its own Drain.
+//
+// When the buffer is full, a new entry replaces the oldest entries of the
+// slowest drains, so a slow drain does not hold back a fast one. Each drain
+// counts the entries it lost, and reports them in a "missed logs" LogEntry,
+// with only the dropped field set, before its next entry.
+//
+// Listeners are notified when an entry is pushed, so consumers can wait for
+// entries rather than poll.
+//
+// Push logs:
+// 0) Create a MultiSink instance.
+// 1) MultiSink::PushTokenizedMessage().
+//
+// Pop logs:
+// 0) Attach a Drain for each consumer with MultiSink::AttachDrain().
+// 1) Optionally, attach a Listener to be told when entries arrive.
+// 2) For single entries, Drain::Pop().
+// 3) For multiple entries, Drain::PopMultiple().
+namespace pw::log_rpc {
+
+class MultiSink {
+ public:
+  // A consumer's read position in a MultiSink.
+  class Drain : public IntrusiveList<Drain>::Item {
+   public:
+    constexpr Drain() = default;
+
+    ~Drain() {
+      if (multisink_ != nullptr) {
+        multisink_->DetachDrain(*this);
+      }
+    }
+
+    Drain(const Drain&) = delete;
+    Drain& operator=(const Drain&) = delete;
+
+    // Pops the oldest entry for this drain into the provided buffer, as a
+    // pw.log.LogEntries message with one entry. If entries were dropped since
+    // the last pop, the entry is a "missed logs" entry instead, and the oldest
+    // entry is returned by the next pop. The buffer must be at least the max
+    // log entry size.
+    // Returns:
+    //
+    //  OK - success.
+    //  FAILED_PRECONDITION - The drain is not attached.
+    //  OUT_OF_RANGE - No entries for this drain to read.
+    Result<LogEntries> Pop(LogEntriesBuffer entry_buffer);
+
+    // Pops entries for this drain into the provided buffer, as a
+    // pw.log.LogEntries message, until the next entry does not fit. A "missed
+    // logs" entry is first if entries were dropped since the last pop. As with
+    // LogQueue::PopMultiple(), timestamps after the first are delta encoded.
+    // The buffer must be at least the max log entry size.
+    LogEntries PopMultiple(LogEntriesBuffer entries_buffer);
+
+    // The number of entries this drain has dropped, either because they were
+    // replaced before it read them, or because they failed to be pushed.
+    size_t dropped_entries() const {
+      return reader_.DroppedEntries() + push_failures_;
+    }
+
+   private:
+    friend class MultiSink;
+
+    // Writes a "missed logs" entry for the drops not yet reported, if any, to
+    // the start of buffer. Returns the number of bytes written.
+    Result<size_t> WriteDroppedEntry(ByteSpan buffer);
+
+    ring_buffer::PrefixedEntryRingBufferMulti::Reader reader_;
+    MultiSink* multisink_ = nullptr;
+    size_t push_failures_ = 0;
+    size_t reported_drops_ = 0;
+  };
+
+  // Notified when entries are pushed.
+  class Listener : public IntrusiveList<Listener>::Item {
+   public:
+    virtual ~Listener() = default;
+
+    // Called after an entry is pushed, from the thread that pushed it. This
+    // should be quick, for example releasing a semaphore the consumer waits
+    // on; it must not push to or pop from the MultiSink.
+    virtual void OnNewEntryAvailable() = 0;
+  };
+
+  // Constructs a MultiSink. As with LogQueue, the max log entry size limits
+  // the size of entries, and entries are encoded directly into log_buffer.
+  MultiSink(ByteSpan log_buffer, size_t max_log_entry_size = kLogEntryMaxSize)
+      : max_log_entry_size_(max_log_entry_size),
+        log_buffer_size_(log_buffer.size_bytes()),
+        ring_buffer_(true) {
+    ring_buffer_.SetBuffer(log_buffer);
+  }
+
+  MultiSink(const MultiSink&) = delete;
+  MultiSink& operator=(const MultiSink&) = delete;
+
+  // Attaches a drain, which reads entries pushed after it is attached, or the
+  // entries other drains have left to read. Entries pushed while no drain is
+  // attached are discarded.
+  // Returns:
+  //
+  //  OK - success.
+  //  INVALID_ARGUMENT - The drain is already attached.
+  Status AttachDrain(Drain& drain);
+
+  // Detaches a drain. Entries only it had left to read are discarded.
+  // Returns:
+  //
+  //  OK - success.
+  //  INVALID_ARGUMENT - The drain is not attached to this MultiSink.
+  Status DetachDrain(Drain& drain);
+
+  void AttachListener(Listener& listener) { listeners_.push_front(listener); }
+  void DetachListener(Listener& listener) { listeners_.remove(listener); }
+
+  // Constructs a LogEntry proto message in the ring buffer, replacing the
+  // oldest entries of the slowest drains if needed, and notifies listeners.
+  // Returns:
+  //
+  //  OK - success.
+  //  INTERNAL - Failed when encoding the proto message, or the message is
+  //  larger than the max log entry size.
+  //  OUT_OF_RANGE - The log buffer is too small for a log entry.
+  Status PushTokenizedMessage(ConstByteSpan message,
+                              uint32_t flags,
+                              uint32_t level,
+                              uint32_t line,
+                              uint32_t thread,
+                              int64_t timestamp);
+
+ private:
+  // Reserves reserve_size bytes, replacing entries if evict is set, and
+  // encodes the entry into them.
+  Status Encode(size_t reserve_size,
+                bool evict,
+                ConstByteSpan message,
+                uint32_t flags,
+                uint32_t level,
+                uint32_t line,
+                uint32_t thread,
+                int64_t timestamp);
+
+  // The free space for entry data, up to the max log entry size, or 0 if no
+  // data byte fits.
+  size_t FreeEntrySize();
+
+  const size_t max_log_entry_size_;
+  const size_t log_buffer_size_;
+
+  ring_buffer::PrefixedEntryRingBufferMulti ring_buffer_;
+  IntrusiveList<Drain> drains_;
+  IntrusiveList<Listener> listeners_;
+};
+
+}  // namespace pw::log_rpc
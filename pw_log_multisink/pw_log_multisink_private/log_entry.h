@@ -0,0 +1,73 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_protobuf/wire_format.h"
+#include "pw_result/result.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::log_rpc::internal {
+
+// The key of the entries field of pw.log.LogEntries, which precedes each
+// encoded pw.log.LogEntry in the ring buffer and in popped entries.
+inline constexpr std::byte kLogKey = static_cast<std::byte>(
+    protobuf::MakeKey(1 /* pw.log.LogEntries.entries */,
+                      protobuf::WireType::kDelimited));
+
+// Encodes a pw.log.LogEntry with a tokenized message into buffer. The dropped
+// field is only written if dropped is nonzero.
+Result<ConstByteSpan> EncodeTokenizedLogEntry(ByteSpan buffer,
+                                              ConstByteSpan message,
+                                              uint32_t flags,
+                                              uint32_t level,
+                                              uint32_t line,
+                                              uint32_t thread,
+                                              int64_t timestamp,
+                                              size_t dropped);
+
+// Encodes a pw.log.LogEntry that only counts dropped entries into buffer.
+Result<ConstByteSpan> EncodeDroppedLogEntry(ByteSpan buffer, size_t dropped);
+
+// Copies an entry read from the ring buffer, as data followed by wrapped_data,
+// to the start of buffer, preceded by its key and size. Returns the number of
+// bytes written, or RESOURCE_EXHAUSTED if the entry does not fit.
+StatusWithSize CopyEntry(ByteSpan buffer,
+                         std::byte key,
+                         ConstByteSpan data,
+                         ConstByteSpan wrapped_data = ConstByteSpan());
+
+// Copies entries into a pw.log.LogEntries batch as CopyEntry() does, delta
+// encoding timestamps. The first entry with a timestamp keeps it; each later
+// one has its timestamp replaced with elapsed_time_since_last_entry, relative
+// to the previous entry's timestamp, when that is smaller. Decoders recover
+// the timestamps by adding each delta to the previous timestamp in the batch.
+class BatchCopier {
+ public:
+  constexpr BatchCopier() = default;
+
+  StatusWithSize CopyEntry(ByteSpan buffer,
+                           std::byte key,
+                           ConstByteSpan data,
+                           ConstByteSpan wrapped_data = ConstByteSpan());
+
+ private:
+  bool has_timestamp_ = false;
+  int64_t last_timestamp_ = 0;
+};
+
+}  // namespace pw::log_rpc::internal
@@ -52,24 +52,46 @@ Status Logs::Flush() {
     dropped_entries_ = 0;
   }
 
-  // Write logs to the response writer. An important limitation of this
+  // Write logs to the response writer, packing as many as fit in each
+  // response, until the queue is empty. An important limitation of this
   // implementation is that if this RPC call fails, the logs are lost -
   // a subsequent call to the RPC will produce a drop count message.
-  ByteSpan payload = response_writer_.PayloadBuffer();
-  Result possible_logs = log_queue_.PopMultiple(payload);
-  PW_TRY(possible_logs.status());
-  if (possible_logs.value().entry_count == 0) {
+  while (response_writer_.AvailableCredits() > 0) {
+    ByteSpan payload = response_writer_.PayloadBuffer();
+    const LogEntries logs = log_queue_.PopMultiple(payload);
+    if (logs.entry_count == 0) {
+      return OkStatus();
+    }
+
+    Status status = response_writer_.Write(logs.entries);
+    if (!status.ok()) {
+      // On a failure to send logs, track the dropped entries.
+      dropped_entries_ += logs.entry_count;
+      return status;
+    }
+  }
+
+  return OkStatus();
+}
+
+Status Logs::Flush(chrono::SystemClock::time_point now) {
+  const size_t queued_entries = log_queue_.EntryCount();
+  if (queued_entries == 0) {
     return OkStatus();
   }
 
-  Status status = response_writer_.Write(possible_logs.value().entries);
-  if (!status.ok()) {
-    // On a failure to send logs, track the dropped entries.
-    dropped_entries_ = possible_logs.value().entry_count;
-    return status;
+  if (queued_entries < min_batch_entries_) {
+    if (!batch_pending_) {
+      batch_pending_ = true;
+      batch_start_ = now;
+    }
+    if (now - batch_start_ < max_batch_delay_) {
+      return OkStatus();
+    }
   }
 
-  return OkStatus();
+  batch_pending_ = false;
+  return Flush();
 }
 
 }  // namespace pw::log_rpc
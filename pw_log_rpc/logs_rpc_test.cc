@@ -14,8 +14,11 @@
 
 #include "pw_log_rpc/logs_rpc.h"
 
+#include <chrono>
+
 #include "gtest/gtest.h"
 #include "pw_log/log.h"
+#include "pw_log_proto/log.pwpb.h"
 #include "pw_rpc/raw_test_method_context.h"
 
 namespace pw::log_rpc {
@@ -23,13 +26,31 @@ namespace {
 
 #define LOGS_METHOD_CONTEXT PW_RAW_TEST_METHOD_CONTEXT(Logs, Get)
 
-constexpr size_t kEncodeBufferSize = 128;
-constexpr size_t kLogBufferSize = 4096;
+constexpr size_t kLogBufferSize = 128;
+
+using chrono::SystemClock;
+
+constexpr SystemClock::duration kBatchDelay =
+    std::chrono::duration_cast<SystemClock::duration>(
+        std::chrono::milliseconds(10));
+
+constexpr SystemClock::time_point kStart =
+    SystemClock::time_point(SystemClock::duration(0));
+
+// Counts the entries in a pw.log.LogEntries response.
+size_t CountEntries(ConstByteSpan response) {
+  log::LogEntries::Decoder decoder(response);
+  size_t entries = 0;
+  while (decoder.Next().ok()) {
+    EXPECT_EQ(log::LogEntries::Fields::ENTRIES, decoder.Field());
+    entries++;
+  }
+  return entries;
+}
 
-class LogQueueTester : public LogQueueWithEncodeBuffer<kLogBufferSize> {
+class LogQueueTester : public LogQueue {
  public:
-  LogQueueTester(ByteSpan log_queue)
-      : LogQueueWithEncodeBuffer<kLogBufferSize>(log_queue) {}
+  LogQueueTester(ByteSpan log_queue) : LogQueue(log_queue) {}
 
   void SetPopStatus(Status error_status) {
     pop_status_for_test_ = error_status;
@@ -51,12 +72,13 @@ class LogsService : public ::testing::Test {
     }
   }
 
-  static Logs& GetLogs(LOGS_METHOD_CONTEXT& context) {
+  template <typename Context>
+  static Logs& GetLogs(Context& context) {
     return (Logs&)(context.service());
   }
 
-  std::array<std::byte, kEncodeBufferSize> log_queue_buffer_;
-  LogQueueWithEncodeBuffer<kLogBufferSize> log_queue_;
+  std::array<std::byte, kLogBufferSize> log_queue_buffer_;
+  LogQueue log_queue_;
 };
 
 TEST_F(LogsService, Get) {
@@ -128,5 +150,91 @@ TEST_F(LogsService, QueueError) {
   EXPECT_EQ(0U, context.total_responses());
 }
 
+TEST_F(LogsService, FlushPacksEntriesIntoFewResponses) {
+  constexpr size_t kLogEntryCount = 12;
+  std::array<std::byte, kLogBufferSize * 4> large_log_buffer;
+  LogQueue large_log_queue(large_log_buffer);
+  std::array<std::byte, 1> rpc_buffer;
+  PW_RAW_TEST_METHOD_CONTEXT(Logs, Get, kLogEntryCount) context(
+      large_log_queue);
+
+  context.call(rpc_buffer);
+
+  constexpr char kTokenizedMessage[] = "message";
+  for (size_t i = 0; i < kLogEntryCount; i++) {
+    ASSERT_EQ(OkStatus(),
+              large_log_queue.PushTokenizedMessage(
+                  std::as_bytes(std::span(kTokenizedMessage)), 0, 0, 0, 0, 0));
+  }
+
+  // A single flush empties the queue. The entries do not fit in one
+  // response, but each response holds several of them.
+  EXPECT_EQ(OkStatus(), GetLogs(context).Flush());
+  EXPECT_EQ(0u, large_log_queue.EntryCount());
+  EXPECT_GT(context.total_responses(), 1u);
+  EXPECT_LT(context.total_responses(), kLogEntryCount / 2);
+
+  size_t entries = 0;
+  for (ConstByteSpan response : context.responses()) {
+    entries += CountEntries(response);
+  }
+  EXPECT_EQ(kLogEntryCount, entries);
+}
+
+TEST_F(LogsService, FlushWaitsForMinBatch) {
+  constexpr size_t kMinBatch = 3;
+  std::array<std::byte, 1> rpc_buffer;
+  LOGS_METHOD_CONTEXT context(log_queue_, kMinBatch, kBatchDelay);
+
+  context.call(rpc_buffer);
+
+  AddLogs(1);
+  EXPECT_EQ(OkStatus(), GetLogs(context).Flush(kStart));
+  EXPECT_EQ(OkStatus(), GetLogs(context).Flush(kStart + kBatchDelay / 2));
+  EXPECT_EQ(0u, context.total_responses());
+
+  // Once the batch is complete, it is sent before the delay passes.
+  AddLogs(kMinBatch - 1);
+  EXPECT_EQ(OkStatus(), GetLogs(context).Flush(kStart + kBatchDelay / 2));
+  ASSERT_EQ(1u, context.total_responses());
+  EXPECT_EQ(kMinBatch, CountEntries(context.responses().back()));
+}
+
+TEST_F(LogsService, FlushSendsPartialBatchAfterDelay) {
+  constexpr size_t kMinBatch = 3;
+  std::array<std::byte, 1> rpc_buffer;
+  LOGS_METHOD_CONTEXT context(log_queue_, kMinBatch, kBatchDelay);
+
+  context.call(rpc_buffer);
+
+  // The delay counts from the first flush that found entries waiting.
+  EXPECT_EQ(OkStatus(), GetLogs(context).Flush(kStart));
+  AddLogs(1);
+  EXPECT_EQ(OkStatus(), GetLogs(context).Flush(kStart + kBatchDelay));
+  EXPECT_EQ(0u, context.total_responses());
+
+  EXPECT_EQ(OkStatus(), GetLogs(context).Flush(kStart + kBatchDelay * 2));
+  ASSERT_EQ(1u, context.total_responses());
+  EXPECT_EQ(1u, CountEntries(context.responses().back()));
+
+  // The next batch waits the full delay again.
+  AddLogs(1);
+  EXPECT_EQ(OkStatus(), GetLogs(context).Flush(kStart + kBatchDelay * 3));
+  EXPECT_EQ(1u, context.total_responses());
+  EXPECT_EQ(OkStatus(), GetLogs(context).Flush(kStart + kBatchDelay * 4));
+  EXPECT_EQ(2u, context.total_responses());
+}
+
+TEST_F(LogsService, FlushWithoutBatchingWritesImmediately) {
+  std::array<std::byte, 1> rpc_buffer;
+  LOGS_METHOD_CONTEXT context(log_queue_);
+
+  context.call(rpc_buffer);
+
+  AddLogs(1);
+  EXPECT_EQ(OkStatus(), GetLogs(context).Flush(kStart));
+  EXPECT_EQ(1u, context.total_responses());
+}
+
 }  // namespace
 }  // namespace pw::log_rpc
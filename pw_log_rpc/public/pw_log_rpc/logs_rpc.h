@@ -14,6 +14,9 @@
 
 #pragma once
 
+#include <cstddef>
+
+#include "pw_chrono/system_clock.h"
 #include "pw_log/log.h"
 #include "pw_log_multisink/log_queue.h"
 #include "pw_log_proto/log.raw_rpc.pb.h"
@@ -26,9 +29,23 @@ namespace pw::log_rpc {
 //
 // The Get() method will return logs in the current queue immediately, but
 // someone else is responsible for pumping the log queue using Flush().
+//
+// Each response packs as many entries as fit in the channel's MTU. To avoid
+// sending many small responses, each paying for RPC and transport framing,
+// the owner can call Flush(now) periodically, for example from a low priority
+// thread. It holds entries back until min_batch_entries are queued, or until
+// max_batch_delay after it first found entries waiting.
 class Logs final : public pw::log::generated::Logs<Logs> {
  public:
-  Logs(LogQueue& log_queue) : log_queue_(log_queue), dropped_entries_(0) {}
+  Logs(LogQueue& log_queue,
+       size_t min_batch_entries = 1,
+       chrono::SystemClock::duration max_batch_delay =
+           chrono::SystemClock::duration::zero())
+      : log_queue_(log_queue),
+        min_batch_entries_(min_batch_entries),
+        max_batch_delay_(max_batch_delay),
+        dropped_entries_(0),
+        batch_pending_(false) {}
 
   // RPC API for the Logs that produces a log stream. This method will
   // return immediately, another class must call Flush() to push logs from
@@ -36,9 +53,16 @@ class Logs final : public pw::log::generated::Logs<Logs> {
   void Get(ServerContext&, ConstByteSpan, rpc::RawServerWriter& writer);
 
   // Interface for the owner of the service instance to flush all existing
-  // logs to the writer, if one is attached.
+  // logs to the writer, if one is attached. Entries are written in as few
+  // responses as fit them. If the writer is flow controlled, flushing stops
+  // when it runs out of credits, and the rest of the entries stay queued.
   Status Flush();
 
+  // Flushes all existing logs if at least min_batch_entries are queued, or if
+  // max_batch_delay has passed since a call first found entries waiting.
+  // Otherwise, does nothing.
+  Status Flush(chrono::SystemClock::time_point now);
+
   // Interface for the owner of the service instance to close the RPC, if
   // one is attached.
   void Finish() { response_writer_.Finish(); }
@@ -46,7 +70,13 @@ class Logs final : public pw::log::generated::Logs<Logs> {
  private:
   LogQueue& log_queue_;
   rpc::RawServerWriter response_writer_;
+  const size_t min_batch_entries_;
+  const chrono::SystemClock::duration max_batch_delay_;
   size_t dropped_entries_;
+
+  // When a call to Flush(now) first found entries waiting in a batch.
+  bool batch_pending_;
+  chrono::SystemClock::time_point batch_start_;
 };
 
 }  // namespace pw::log_rpc
@@ -0,0 +1,128 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_chrono/system_clock.h"
+
+namespace pw::log_tokenized {
+
+// Limits the rate of tokenized logs per format string, so a noisy log site,
+// such as a warning from a misbehaving peripheral, cannot flood the log
+// output. Each format string's token has a token bucket: a log is allowed if
+// the bucket has a credit, and each log uses one credit. Credits are refilled
+// at a fixed rate, up to the burst size.
+//
+// Logs that are not allowed are counted. When a log from the same format
+// string is next allowed, the handler can report how many were suppressed, and
+// ReportSuppressed() reports the counts of format strings that went quiet.
+//
+// Only the most recent format strings are tracked, up to the number of sites
+// the limiter is given. Logs from format strings that cannot be tracked are
+// allowed.
+//
+// RateLimiter is not thread safe; call it from the tokenized log handler while
+// holding the handler's lock.
+//
+// Example:
+//
+//   std::array<RateLimiter::Site, 16> sites;
+//   RateLimiter rate_limiter(sites, /*burst=*/5, std::chrono::seconds(1));
+//
+//   extern "C" void pw_tokenizer_HandleEncodedMessageWithPayload(
+//       pw_tokenizer_Payload payload, const uint8_t data[], size_t size) {
+//     std::lock_guard lock(log_lock);
+//     uint32_t suppressed;
+//     if (!rate_limiter.Allow(RateLimiter::Token(data, size),
+//                             pw::chrono::SystemClock::now(),
+//                             &suppressed)) {
+//       return;
+//     }
+//     if (suppressed > 0) {
+//       EmitSuppressedMessage(RateLimiter::Token(data, size), suppressed);
+//     }
+//     EmitLogMessage(data, size, payload);
+//   }
+class RateLimiter {
+ public:
+  class Site {
+   public:
+    constexpr Site() = default;
+
+   private:
+    friend class RateLimiter;
+
+    uint32_t token_ = 0;
+    uint32_t credits_ = 0;
+    uint32_t suppressed_ = 0;
+    bool in_use_ = false;
+    chrono::SystemClock::time_point last_refill_;
+    chrono::SystemClock::time_point last_log_;
+  };
+
+  // Allows bursts of up to burst logs per format string, refilled at one log
+  // per refill_interval.
+  RateLimiter(std::span<Site> sites,
+              uint32_t burst,
+              chrono::SystemClock::duration refill_interval);
+
+  RateLimiter(const RateLimiter&) = delete;
+  RateLimiter& operator=(const RateLimiter&) = delete;
+
+  // Returns the token of an encoded tokenized message, or 0 if it is too
+  // short to have one.
+  static uint32_t Token(const uint8_t* data, size_t size);
+
+  // Returns true if a log with the format string token may be emitted now.
+  // Sets suppressed to the number of logs with the token that were suppressed
+  // since the last one was allowed or reported; the caller should report them
+  // before the log.
+  bool Allow(uint32_t token,
+             chrono::SystemClock::time_point now,
+             uint32_t* suppressed);
+
+  // Calls report(token, count) for each format string with suppressed logs
+  // that has not logged for at least quiet_time, then clears its count. Call
+  // this periodically so suppressed logs are reported even if the site stops
+  // logging.
+  template <typename Function>
+  void ReportSuppressed(chrono::SystemClock::time_point now,
+                        chrono::SystemClock::duration quiet_time,
+                        Function&& report) {
+    for (Site& site : sites_) {
+      if (site.in_use_ && site.suppressed_ > 0u &&
+          now - site.last_log_ >= quiet_time) {
+        report(site.token_, site.suppressed_);
+        site.suppressed_ = 0;
+      }
+    }
+  }
+
+ private:
+  // Returns the site for the token, taking over the least recently used site
+  // without suppressed logs if the token is not tracked. Returns nullptr if
+  // every site has suppressed logs to report.
+  Site* FindSite(uint32_t token, chrono::SystemClock::time_point now);
+
+  void Refill(Site& site, chrono::SystemClock::time_point now) const;
+
+  const std::span<Site> sites_;
+  const uint32_t burst_;
+  const chrono::SystemClock::duration refill_interval_;
+};
+
+}  // namespace pw::log_tokenized
@@ -0,0 +1,105 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_tokenized/rate_limiter.h"
+
+namespace pw::log_tokenized {
+
+RateLimiter::RateLimiter(std::span<Site> sites,
+                         uint32_t burst,
+                         chrono::SystemClock::duration refill_interval)
+    : sites_(sites), burst_(burst), refill_interval_(refill_interval) {}
+
+uint32_t RateLimiter::Token(const uint8_t* data, size_t size) {
+  if (size < sizeof(uint32_t)) {
+    return 0;
+  }
+  // Tokens are encoded little endian at the start of the message.
+  return uint32_t(data[0]) | (uint32_t(data[1]) << 8) |
+         (uint32_t(data[2]) << 16) | (uint32_t(data[3]) << 24);
+}
+
+bool RateLimiter::Allow(uint32_t token,
+                        chrono::SystemClock::time_point now,
+                        uint32_t* suppressed) {
+  *suppressed = 0;
+
+  Site* const site = FindSite(token, now);
+  if (site == nullptr) {
+    return true;
+  }
+
+  Refill(*site, now);
+  site->last_log_ = now;
+
+  if (site->credits_ == 0u) {
+    site->suppressed_ += 1;
+    return false;
+  }
+
+  site->credits_ -= 1;
+  *suppressed = site->suppressed_;
+  site->suppressed_ = 0;
+  return true;
+}
+
+RateLimiter::Site* RateLimiter::FindSite(uint32_t token,
+                                         chrono::SystemClock::time_point now) {
+  Site* replacement = nullptr;
+
+  for (Site& site : sites_) {
+    if (site.in_use_ && site.token_ == token) {
+      return &site;
+    }
+    if (site.in_use_ && site.suppressed_ > 0u) {
+      continue;  // Keep sites until their suppressed logs are reported.
+    }
+    if (replacement == nullptr || !site.in_use_ ||
+        (replacement->in_use_ && site.last_log_ < replacement->last_log_)) {
+      replacement = &site;
+    }
+  }
+
+  if (replacement != nullptr) {
+    replacement->token_ = token;
+    replacement->credits_ = burst_;
+    replacement->suppressed_ = 0;
+    replacement->in_use_ = true;
+    replacement->last_refill_ = now;
+  }
+  return replacement;
+}
+
+void RateLimiter::Refill(Site& site,
+                         chrono::SystemClock::time_point now) const {
+  if (refill_interval_ <= chrono::SystemClock::duration::zero()) {
+    site.credits_ = burst_;
+    return;
+  }
+
+  const auto intervals = (now - site.last_refill_) / refill_interval_;
+  if (intervals <= 0) {
+    return;
+  }
+
+  if (static_cast<uint64_t>(intervals) >= burst_ - site.credits_) {
+    site.credits_ = burst_;
+    site.last_refill_ = now;
+  } else {
+    site.credits_ += static_cast<uint32_t>(intervals);
+    site.last_refill_ += intervals * refill_interval_;
+  }
+}
+
+}  // namespace pw::log_tokenized
@@ -0,0 +1,150 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_tokenized/rate_limiter.h"
+
+#include <array>
+
+#include "gtest/gtest.h"
+
+namespace pw::log_tokenized {
+namespace {
+
+using std::chrono::milliseconds;
+
+constexpr chrono::SystemClock::time_point kStart{};
+
+chrono::SystemClock::time_point At(milliseconds offset) {
+  return kStart +
+         std::chrono::duration_cast<chrono::SystemClock::duration>(offset);
+}
+
+class RateLimiterTest : public ::testing::Test {
+ protected:
+  RateLimiterTest() : limiter_(sites_, 2, milliseconds(100)) {}
+
+  bool Allow(uint32_t token, milliseconds now) {
+    return limiter_.Allow(token, At(now), &suppressed_);
+  }
+
+  std::array<RateLimiter::Site, 2> sites_;
+  RateLimiter limiter_;
+  uint32_t suppressed_ = 0;
+};
+
+TEST(RateLimiter, Token_ReadsLittleEndianToken) {
+  constexpr uint8_t kMessage[] = {0x78, 0x56, 0x34, 0x12, 0xff};
+  EXPECT_EQ(0x12345678u, RateLimiter::Token(kMessage, sizeof(kMessage)));
+  EXPECT_EQ(0u, RateLimiter::Token(kMessage, 3));
+}
+
+TEST_F(RateLimiterTest, Allow_BurstThenSuppresses) {
+  EXPECT_TRUE(Allow(1, milliseconds(0)));
+  EXPECT_TRUE(Allow(1, milliseconds(0)));
+  EXPECT_FALSE(Allow(1, milliseconds(0)));
+  EXPECT_FALSE(Allow(1, milliseconds(50)));
+}
+
+TEST_F(RateLimiterTest, Allow_RefillsAndReportsSuppressed) {
+  ASSERT_TRUE(Allow(1, milliseconds(0)));
+  ASSERT_TRUE(Allow(1, milliseconds(0)));
+  ASSERT_FALSE(Allow(1, milliseconds(10)));
+  ASSERT_FALSE(Allow(1, milliseconds(20)));
+  ASSERT_FALSE(Allow(1, milliseconds(30)));
+
+  EXPECT_TRUE(Allow(1, milliseconds(100)));
+  EXPECT_EQ(3u, suppressed_);
+
+  EXPECT_FALSE(Allow(1, milliseconds(110)));
+  EXPECT_TRUE(Allow(1, milliseconds(200)));
+  EXPECT_EQ(1u, suppressed_);
+}
+
+TEST_F(RateLimiterTest, Allow_RefillIsCappedAtBurst) {
+  ASSERT_TRUE(Allow(1, milliseconds(0)));
+  ASSERT_TRUE(Allow(1, milliseconds(0)));
+
+  EXPECT_TRUE(Allow(1, milliseconds(10000)));
+  EXPECT_TRUE(Allow(1, milliseconds(10000)));
+  EXPECT_FALSE(Allow(1, milliseconds(10000)));
+}
+
+TEST_F(RateLimiterTest, Allow_LimitsEachTokenSeparately) {
+  ASSERT_TRUE(Allow(1, milliseconds(0)));
+  ASSERT_TRUE(Allow(1, milliseconds(0)));
+  ASSERT_FALSE(Allow(1, milliseconds(0)));
+
+  EXPECT_TRUE(Allow(2, milliseconds(0)));
+  EXPECT_EQ(0u, suppressed_);
+}
+
+TEST_F(RateLimiterTest, Allow_AllowsUntrackedTokensWhenSitesHaveSuppressed) {
+  ASSERT_TRUE(Allow(1, milliseconds(0)));
+  ASSERT_TRUE(Allow(1, milliseconds(0)));
+  ASSERT_FALSE(Allow(1, milliseconds(0)));
+  ASSERT_TRUE(Allow(2, milliseconds(0)));
+  ASSERT_TRUE(Allow(2, milliseconds(0)));
+  ASSERT_FALSE(Allow(2, milliseconds(0)));
+
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_TRUE(Allow(3, milliseconds(0)));
+  }
+
+  // The suppressed counts of the tracked tokens are kept.
+  EXPECT_TRUE(Allow(1, milliseconds(100)));
+  EXPECT_EQ(1u, suppressed_);
+}
+
+TEST_F(RateLimiterTest, Allow_ReplacesLeastRecentlyUsedSite) {
+  ASSERT_TRUE(Allow(1, milliseconds(0)));
+  ASSERT_TRUE(Allow(2, milliseconds(10)));
+  ASSERT_TRUE(Allow(1, milliseconds(20)));
+
+  // Token 3 replaces token 2; token 1 is still tracked, with an empty bucket.
+  ASSERT_TRUE(Allow(3, milliseconds(30)));
+  EXPECT_FALSE(Allow(1, milliseconds(40)));
+
+  // Token 2 starts with a full bucket again when it replaces token 3.
+  EXPECT_TRUE(Allow(2, milliseconds(50)));
+  EXPECT_TRUE(Allow(2, milliseconds(50)));
+}
+
+TEST_F(RateLimiterTest, ReportSuppressed_ReportsQuietSites) {
+  ASSERT_TRUE(Allow(1, milliseconds(0)));
+  ASSERT_TRUE(Allow(1, milliseconds(0)));
+  ASSERT_FALSE(Allow(1, milliseconds(0)));
+  ASSERT_FALSE(Allow(1, milliseconds(50)));
+
+  int reports = 0;
+  auto report = [&reports](uint32_t token, uint32_t count) {
+    EXPECT_EQ(1u, token);
+    EXPECT_EQ(2u, count);
+    reports += 1;
+  };
+
+  limiter_.ReportSuppressed(At(milliseconds(100)), milliseconds(100), report);
+  EXPECT_EQ(0, reports);
+
+  limiter_.ReportSuppressed(At(milliseconds(150)), milliseconds(100), report);
+  EXPECT_EQ(1, reports);
+
+  limiter_.ReportSuppressed(At(milliseconds(500)), milliseconds(100), report);
+  EXPECT_EQ(1, reports);
+
+  EXPECT_TRUE(Allow(1, milliseconds(500)));
+  EXPECT_EQ(0u, suppressed_);
+}
+
+}  // namespace
+}  // namespace pw::log_tokenized
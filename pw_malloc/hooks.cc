@@ -0,0 +1,41 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_malloc/hooks.h"
+
+#include <atomic>
+
+namespace {
+
+std::atomic<const pw_MallocHooks*> hooks{nullptr};
+
+}  // namespace
+
+extern "C" void pw_MallocSetHooks(const pw_MallocHooks* new_hooks) {
+  hooks.store(new_hooks, std::memory_order_release);
+}
+
+extern "C" void pw_MallocHookAllocated(void* ptr, size_t size_bytes) {
+  const pw_MallocHooks* current = hooks.load(std::memory_order_acquire);
+  if (current != nullptr && current->allocated != nullptr) {
+    current->allocated(current->context, ptr, size_bytes);
+  }
+}
+
+extern "C" void pw_MallocHookFreed(void* ptr) {
+  const pw_MallocHooks* current = hooks.load(std::memory_order_acquire);
+  if (current != nullptr && current->freed != nullptr) {
+    current->freed(current->context, ptr);
+  }
+}
@@ -0,0 +1,50 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Hooks through which code may observe the allocations made by a pw_malloc
+// backend, for example to count the allocations made by a unit test.
+//
+// Backends call pw_MallocHookAllocated() after each successful allocation and
+// pw_MallocHookFreed() before each free. A realloc() is reported as a free of
+// the old pointer followed by an allocation of the new one.
+#pragma once
+
+#include <stddef.h>
+
+#include "pw_preprocessor/util.h"
+
+PW_EXTERN_C_START
+
+typedef struct {
+  // Called with each allocated pointer and the number of bytes requested.
+  void (*allocated)(void* context, void* ptr, size_t size_bytes);
+
+  // Called with each pointer about to be freed.
+  void (*freed)(void* context, void* ptr);
+
+  // Passed to the hooks.
+  void* context;
+} pw_MallocHooks;
+
+// Sets the hooks called on each allocation and free, replacing any previous
+// hooks. Passing NULL removes the hooks. The hooks are called from whichever
+// context calls malloc, so they must be safe to call from all of them. The
+// hooks object must outlive its use.
+void pw_MallocSetHooks(const pw_MallocHooks* hooks);
+
+// Called by pw_malloc backends to report allocations and frees.
+void pw_MallocHookAllocated(void* ptr, size_t size_bytes);
+void pw_MallocHookFreed(void* ptr);
+
+PW_EXTERN_C_END
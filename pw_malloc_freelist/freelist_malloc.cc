@@ -12,18 +12,123 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <cstring>
 #include <span>
 
+#include "pw_allocator/fixed_block_allocator.h"
 #include "pw_allocator/freelist_heap.h"
 #include "pw_boot_armv7m/boot.h"
+#include "pw_malloc/hooks.h"
 #include "pw_malloc/malloc.h"
+#include "pw_malloc_freelist/freelist_malloc.h"
 #include "pw_preprocessor/util.h"
 
+// Allocations of up to PW_MALLOC_FREELIST_POOL_BLOCK_SIZE bytes are taken from
+// a pool of PW_MALLOC_FREELIST_POOL_BLOCK_COUNT fixed size blocks, when there
+// is a free block, instead of from the freelist heap. The pool is disabled if
+// either is 0.
+#ifndef PW_MALLOC_FREELIST_POOL_BLOCK_SIZE
+#define PW_MALLOC_FREELIST_POOL_BLOCK_SIZE 0
+#endif  // PW_MALLOC_FREELIST_POOL_BLOCK_SIZE
+
+#ifndef PW_MALLOC_FREELIST_POOL_BLOCK_COUNT
+#define PW_MALLOC_FREELIST_POOL_BLOCK_COUNT 0
+#endif  // PW_MALLOC_FREELIST_POOL_BLOCK_COUNT
+
 namespace {
 std::aligned_storage_t<sizeof(pw::allocator::FreeListHeapBuffer<>),
                        alignof(pw::allocator::FreeListHeapBuffer<>)>
     buf;
 std::span<std::byte> pw_allocator_freelist_raw_heap;
+
+constexpr bool kPoolEnabled = PW_MALLOC_FREELIST_POOL_BLOCK_SIZE > 0 &&
+                              PW_MALLOC_FREELIST_POOL_BLOCK_COUNT > 0;
+
+// Pool blocks are aligned as malloc requires.
+constexpr size_t kPoolBlockSize =
+    (PW_MALLOC_FREELIST_POOL_BLOCK_SIZE + alignof(std::max_align_t) - 1) /
+    alignof(std::max_align_t) * alignof(std::max_align_t);
+
+alignas(std::max_align_t) std::byte pool_storage
+    [kPoolEnabled ? kPoolBlockSize * PW_MALLOC_FREELIST_POOL_BLOCK_COUNT : 1];
+std::aligned_storage_t<sizeof(pw::allocator::FixedBlockAllocator),
+                       alignof(pw::allocator::FixedBlockAllocator)>
+    pool_buf;
+pw::allocator::FixedBlockAllocator* pool;
+
+bool InPool(void* ptr) { return kPoolEnabled && pool->Contains(ptr); }
+
+void* AllocateUnhooked(size_t size) {
+  if (kPoolEnabled && size != 0 && size <= kPoolBlockSize) {
+    if (void* ptr = pool->Allocate(); ptr != nullptr) {
+      return ptr;
+    }
+  }
+  return pw_freelist_heap->Allocate(size);
+}
+
+void* Allocate(size_t size) {
+  void* ptr = AllocateUnhooked(size);
+  if (ptr != nullptr) {
+    pw_MallocHookAllocated(ptr, size);
+  }
+  return ptr;
+}
+
+void Free(void* ptr) {
+  if (ptr != nullptr) {
+    pw_MallocHookFreed(ptr);
+  }
+  if (InPool(ptr)) {
+    pool->Free(ptr);
+    return;
+  }
+  pw_freelist_heap->Free(ptr);
+}
+
+void* ReallocUnhooked(void* ptr, size_t size) {
+  if (!InPool(ptr)) {
+    return pw_freelist_heap->Realloc(ptr, size);
+  }
+
+  if (size == 0) {
+    pool->Free(ptr);
+    return nullptr;
+  }
+  if (size <= kPoolBlockSize) {
+    return ptr;
+  }
+
+  void* new_ptr = pw_freelist_heap->Allocate(size);
+  if (new_ptr == nullptr) {
+    return nullptr;
+  }
+  std::memcpy(new_ptr, ptr, kPoolBlockSize);
+  pool->Free(ptr);
+  return new_ptr;
+}
+
+// Reports a successful realloc as a free of the old pointer followed by an
+// allocation of the new one.
+void* Realloc(void* ptr, size_t size) {
+  void* new_ptr = ReallocUnhooked(ptr, size);
+  if (ptr != nullptr && (new_ptr != nullptr || size == 0)) {
+    pw_MallocHookFreed(ptr);
+  }
+  if (new_ptr != nullptr) {
+    pw_MallocHookAllocated(new_ptr, size);
+  }
+  return new_ptr;
+}
+
+void* Calloc(size_t num, size_t size) {
+  void* ptr = Allocate(num * size);
+  if (ptr != nullptr) {
+    std::memset(ptr, 0, num * size);
+  }
+  return ptr;
+}
+
 }  // namespace
 pw::allocator::FreeListHeapBuffer<>* pw_freelist_heap;
 
@@ -39,6 +144,14 @@ void pw_MallocInit() {
                 &pw_boot_heap_high_addr - &pw_boot_heap_low_addr);
   pw_freelist_heap = new (&buf)
       pw::allocator::FreeListHeapBuffer(pw_allocator_freelist_raw_heap);
+
+  // malloc may be called from several contexts, so the pool is lock-free.
+  if (kPoolEnabled) {
+    pool = new (&pool_buf) pw::allocator::FixedBlockAllocator(
+        pool_storage,
+        kPoolBlockSize,
+        pw::allocator::FixedBlockAllocator::Concurrency::kLockFree);
+  }
 }
 
 // Wrapper functions for malloc, free, realloc and calloc.
@@ -46,36 +159,32 @@ void pw_MallocInit() {
 // "__wrap_<function name>" with "<function_name>", and calling
 // "<function name>" will call "__wrap_<function name>" instead
 // Linker options are set in a config in "pw_malloc:pw_malloc_config".
-void* __wrap_malloc(size_t size) { return pw_freelist_heap->Allocate(size); }
+void* __wrap_malloc(size_t size) { return Allocate(size); }
 
-void __wrap_free(void* ptr) { pw_freelist_heap->Free(ptr); }
+void __wrap_free(void* ptr) { Free(ptr); }
 
-void* __wrap_realloc(void* ptr, size_t size) {
-  return pw_freelist_heap->Realloc(ptr, size);
-}
+void* __wrap_realloc(void* ptr, size_t size) { return Realloc(ptr, size); }
 
-void* __wrap_calloc(size_t num, size_t size) {
-  return pw_freelist_heap->Calloc(num, size);
-}
+void* __wrap_calloc(size_t num, size_t size) { return Calloc(num, size); }
 
 void* __wrap__malloc_r(struct _reent* r, size_t size) {
   PW_UNUSED(r);
-  return pw_freelist_heap->Allocate(size);
+  return Allocate(size);
 }
 
 void __wrap__free_r(struct _reent* r, void* ptr) {
   PW_UNUSED(r);
-  pw_freelist_heap->Free(ptr);
+  Free(ptr);
 }
 
 void* __wrap__realloc_r(struct _reent* r, void* ptr, size_t size) {
   PW_UNUSED(r);
-  return pw_freelist_heap->Realloc(ptr, size);
+  return Realloc(ptr, size);
 }
 
 void* __wrap__calloc_r(struct _reent* r, size_t num, size_t size) {
   PW_UNUSED(r);
-  return pw_freelist_heap->Calloc(num, size);
+  return Calloc(num, size);
 }
 #if __cplusplus
 }
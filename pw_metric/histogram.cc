@@ -0,0 +1,156 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_metric/histogram.h"
+
+#include <iterator>
+
+#include "pw_assert/assert.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::metric {
+namespace internal {
+namespace {
+
+// Tokenized strings must be assigned to a variable, so each name is declared
+// separately.
+#define _PW_METRIC_BUCKET_NAME(index) \
+  constexpr Token kBucket##index =    \
+      PW_TOKENIZE_STRING_DOMAIN("metrics", "bucket_" #index)
+
+_PW_METRIC_BUCKET_NAME(0);
+_PW_METRIC_BUCKET_NAME(1);
+_PW_METRIC_BUCKET_NAME(2);
+_PW_METRIC_BUCKET_NAME(3);
+_PW_METRIC_BUCKET_NAME(4);
+_PW_METRIC_BUCKET_NAME(5);
+_PW_METRIC_BUCKET_NAME(6);
+_PW_METRIC_BUCKET_NAME(7);
+_PW_METRIC_BUCKET_NAME(8);
+_PW_METRIC_BUCKET_NAME(9);
+_PW_METRIC_BUCKET_NAME(10);
+_PW_METRIC_BUCKET_NAME(11);
+_PW_METRIC_BUCKET_NAME(12);
+_PW_METRIC_BUCKET_NAME(13);
+_PW_METRIC_BUCKET_NAME(14);
+_PW_METRIC_BUCKET_NAME(15);
+_PW_METRIC_BUCKET_NAME(16);
+_PW_METRIC_BUCKET_NAME(17);
+_PW_METRIC_BUCKET_NAME(18);
+_PW_METRIC_BUCKET_NAME(19);
+_PW_METRIC_BUCKET_NAME(20);
+_PW_METRIC_BUCKET_NAME(21);
+_PW_METRIC_BUCKET_NAME(22);
+_PW_METRIC_BUCKET_NAME(23);
+_PW_METRIC_BUCKET_NAME(24);
+_PW_METRIC_BUCKET_NAME(25);
+_PW_METRIC_BUCKET_NAME(26);
+_PW_METRIC_BUCKET_NAME(27);
+_PW_METRIC_BUCKET_NAME(28);
+_PW_METRIC_BUCKET_NAME(29);
+_PW_METRIC_BUCKET_NAME(30);
+_PW_METRIC_BUCKET_NAME(31);
+_PW_METRIC_BUCKET_NAME(32);
+
+#undef _PW_METRIC_BUCKET_NAME
+
+constexpr Token kBucketNames[] = {
+    kBucket0,
+    kBucket1,
+    kBucket2,
+    kBucket3,
+    kBucket4,
+    kBucket5,
+    kBucket6,
+    kBucket7,
+    kBucket8,
+    kBucket9,
+    kBucket10,
+    kBucket11,
+    kBucket12,
+    kBucket13,
+    kBucket14,
+    kBucket15,
+    kBucket16,
+    kBucket17,
+    kBucket18,
+    kBucket19,
+    kBucket20,
+    kBucket21,
+    kBucket22,
+    kBucket23,
+    kBucket24,
+    kBucket25,
+    kBucket26,
+    kBucket27,
+    kBucket28,
+    kBucket29,
+    kBucket30,
+    kBucket31,
+    kBucket32,
+};
+
+}  // namespace
+
+Token HistogramBucketName(size_t index) {
+  PW_DCHECK_UINT_LT(index, std::size(kBucketNames));
+  return kBucketNames[index];
+}
+
+}  // namespace internal
+namespace {
+
+constexpr Token kCountName = PW_TOKENIZE_STRING_DOMAIN("metrics", "count");
+constexpr Token kSumName = PW_TOKENIZE_STRING_DOMAIN("metrics", "sum");
+constexpr Token kMinName = PW_TOKENIZE_STRING_DOMAIN("metrics", "min");
+constexpr Token kMaxName = PW_TOKENIZE_STRING_DOMAIN("metrics", "max");
+
+}  // namespace
+
+Summary::Summary(Token name)
+    : group_(name),
+      count_(kCountName, 0u),
+      sum_(kSumName, 0u),
+      min_(kMinName, 0u),
+      max_(kMaxName, 0u) {
+  // Groups list metrics in reverse order of adding.
+  group_.Add(max_);
+  group_.Add(min_);
+  group_.Add(sum_);
+  group_.Add(count_);
+}
+
+Summary::Summary(Token name, IntrusiveList<Group>& groups) : Summary(name) {
+  groups.push_front(group_);
+}
+
+void Summary::Record(uint32_t value) {
+  if (count_.value() == 0u || value < min_.value()) {
+    min_.Set(value);
+  }
+  if (count_.value() == 0u || value > max_.value()) {
+    max_.Set(value);
+  }
+  count_.Increment();
+  sum_.Increment(value);
+}
+
+void Summary::Reset() {
+  count_.Set(0u);
+  sum_.Set(0u);
+  min_.Set(0u);
+  max_.Set(0u);
+}
+
+}  // namespace pw::metric
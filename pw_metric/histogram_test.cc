@@ -0,0 +1,142 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_metric/histogram.h"
+
+#include "gtest/gtest.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::metric {
+namespace {
+
+TEST(Histogram, PowerOfTwoBuckets) {
+  Histogram<5> histogram(0x1234);
+  EXPECT_EQ(histogram.BucketIndex(0), 0u);
+  EXPECT_EQ(histogram.BucketIndex(1), 1u);
+  EXPECT_EQ(histogram.BucketIndex(2), 2u);
+  EXPECT_EQ(histogram.BucketIndex(3), 2u);
+  EXPECT_EQ(histogram.BucketIndex(4), 3u);
+  EXPECT_EQ(histogram.BucketIndex(7), 3u);
+  EXPECT_EQ(histogram.BucketIndex(8), 4u);
+  EXPECT_EQ(histogram.BucketIndex(0xffffffff), 4u);
+}
+
+TEST(Histogram, AllPowerOfTwoBuckets) {
+  Histogram<33> histogram(0x1234);
+  EXPECT_EQ(histogram.BucketIndex(0x7fffffff), 31u);
+  EXPECT_EQ(histogram.BucketIndex(0x80000000), 32u);
+  EXPECT_EQ(histogram.BucketIndex(0xffffffff), 32u);
+}
+
+TEST(Histogram, UserDefinedBuckets) {
+  static constexpr uint32_t kBounds[] = {10, 100, 1000};
+  Histogram<4> histogram(0x1234, kBounds);
+  EXPECT_EQ(histogram.BucketIndex(0), 0u);
+  EXPECT_EQ(histogram.BucketIndex(9), 0u);
+  EXPECT_EQ(histogram.BucketIndex(10), 1u);
+  EXPECT_EQ(histogram.BucketIndex(99), 1u);
+  EXPECT_EQ(histogram.BucketIndex(100), 2u);
+  EXPECT_EQ(histogram.BucketIndex(1000), 3u);
+  EXPECT_EQ(histogram.BucketIndex(0xffffffff), 3u);
+}
+
+TEST(Histogram, Record) {
+  Histogram<4> histogram(0x1234);
+  histogram.Record(0);
+  histogram.Record(1);
+  histogram.Record(3);
+  histogram.Record(2);
+  histogram.Record(1000);
+
+  EXPECT_EQ(histogram.count(0), 1u);
+  EXPECT_EQ(histogram.count(1), 1u);
+  EXPECT_EQ(histogram.count(2), 2u);
+  EXPECT_EQ(histogram.count(3), 1u);
+  EXPECT_EQ(histogram.snapshot().total(), 5u);
+
+  histogram.Reset();
+  EXPECT_EQ(histogram.snapshot().total(), 0u);
+}
+
+TEST(Histogram, MergeSnapshots) {
+  Histogram<3> a(0x1234);
+  Histogram<3> b(0x5678);
+  a.Record(0);
+  a.Record(5);
+  b.Record(1);
+  b.Record(5);
+  b.Record(9);
+
+  Histogram<3>::Snapshot merged = a.snapshot();
+  merged.Merge(b.snapshot());
+  EXPECT_EQ(merged.counts[0], 1u);
+  EXPECT_EQ(merged.counts[1], 1u);
+  EXPECT_EQ(merged.counts[2], 3u);
+  EXPECT_EQ(merged.total(), 5u);
+}
+
+TEST(Histogram, IsAGroupOfBuckets) {
+  PW_METRIC_GROUP(parent, "parent");
+  Histogram<3> histogram(0x1234, parent.children());
+
+  ASSERT_EQ(parent.children().size(), 1u);
+  EXPECT_EQ(&parent.children().front(), &histogram.group());
+  EXPECT_EQ(histogram.group().name(), 0x1234u);
+
+  histogram.Record(1);
+  constexpr Token kBucket0 = PW_TOKENIZE_STRING_DOMAIN("metrics", "bucket_0");
+  constexpr Token kBucket1 = PW_TOKENIZE_STRING_DOMAIN("metrics", "bucket_1");
+
+  // The buckets are listed in order.
+  ASSERT_EQ(histogram.group().metrics().size(), 3u);
+  auto bucket = histogram.group().metrics().begin();
+  EXPECT_EQ(bucket->name(), kBucket0 & 0x7fffffff);
+  EXPECT_EQ(bucket->as_int(), 0u);
+  ++bucket;
+  EXPECT_EQ(bucket->name(), kBucket1 & 0x7fffffff);
+  EXPECT_EQ(bucket->as_int(), 1u);
+}
+
+TEST(Summary, Record) {
+  Summary summary(0x1234);
+  EXPECT_EQ(summary.count(), 0u);
+  EXPECT_EQ(summary.min(), 0u);
+  EXPECT_EQ(summary.max(), 0u);
+
+  summary.Record(50);
+  summary.Record(20);
+  summary.Record(80);
+  EXPECT_EQ(summary.count(), 3u);
+  EXPECT_EQ(summary.sum(), 150u);
+  EXPECT_EQ(summary.min(), 20u);
+  EXPECT_EQ(summary.max(), 80u);
+
+  summary.Reset();
+  EXPECT_EQ(summary.count(), 0u);
+  summary.Record(90);
+  EXPECT_EQ(summary.min(), 90u);
+  EXPECT_EQ(summary.max(), 90u);
+}
+
+TEST(Summary, IsAGroupOfMetrics) {
+  PW_METRIC_GROUP(parent, "parent");
+  Summary summary(0x1234, parent.children());
+  ASSERT_EQ(parent.children().size(), 1u);
+  EXPECT_EQ(summary.group().metrics().size(), 4u);
+  constexpr Token kCount = PW_TOKENIZE_STRING_DOMAIN("metrics", "count");
+  EXPECT_EQ(summary.group().metrics().front().name(), kCount & 0x7fffffff);
+}
+
+}  // namespace
+}  // namespace pw::metric
@@ -18,6 +18,7 @@
 #include <span>
 
 #include "pw_log/log.h"
+#include "pw_metric_private/config.h"
 #include "pw_tokenizer/base64.h"
 
 namespace pw::metric {
@@ -47,6 +48,43 @@ const char* Indent(int level) {
   return kWhitespace8 + 8 - 2 * level;
 }
 
+void DumpMetric(const Metric& metric, int level) {
+  Base64EncodedToken encoded_name(metric.name());
+  const char* indent = Indent(level);
+  if (metric.is_float()) {
+    PW_LOG_INFO(
+        "%s \"%s\": %f,", indent, encoded_name.value(), metric.as_float());
+  } else {
+    PW_LOG_INFO("%s \"%s\": %u,",
+                indent,
+                encoded_name.value(),
+                static_cast<unsigned int>(metric.as_int()));
+  }
+}
+
+void DumpMetrics(const IntrusiveList<Metric>& metrics, int level) {
+  for (auto& m : metrics) {
+    DumpMetric(m, level);
+  }
+}
+
+void DumpGroups(const IntrusiveList<Group>& groups, int level);
+
+void DumpGroup(const Group& group, int level) {
+  Base64EncodedToken encoded_name(group.name());
+  const char* indent = Indent(level);
+  PW_LOG_INFO("%s \"%s\": {", indent, encoded_name.value());
+  DumpGroups(group.children(), level + 1);
+  DumpMetrics(group.metrics(), level + 1);
+  PW_LOG_INFO("%s }", indent);
+}
+
+void DumpGroups(const IntrusiveList<Group>& groups, int level) {
+  for (auto& group : groups) {
+    DumpGroup(group, level);
+  }
+}
+
 }  // namespace
 
 // Enable easier registration when used as a member.
@@ -59,48 +97,72 @@ Metric::Metric(Token name, uint32_t value, IntrusiveList<Metric>& metrics)
   metrics.push_front(*this);
 }
 
+// The value is read and written with the __atomic builtins rather than
+// std::atomic, so it stays in the union and the metric stays 12 bytes.
+// Relaxed 32-bit loads and stores are single instructions. Atomic increments
+// are an LDREX/STREX loop on ARMv7-M and ARMv8-M; ARMv6-M has no exclusive
+// access instructions, so GCC calls __atomic_fetch_add_4, which the platform
+// must provide (for example, by masking interrupts).
 float Metric::as_float() const {
   PW_DCHECK(is_float());
-  return float_;
+  float value;
+  __atomic_load(&float_, &value, __ATOMIC_RELAXED);
+  return value;
 }
 
 uint32_t Metric::as_int() const {
   PW_DCHECK(is_int());
-  return uint_;
+  return __atomic_load_n(&uint_, __ATOMIC_RELAXED);
 }
 
 void Metric::Increment(uint32_t amount) {
+#if PW_METRIC_ATOMIC_UPDATES
+  AtomicIncrement(amount);
+#else
   PW_DCHECK(is_int());
   uint_ += amount;
+#endif  // PW_METRIC_ATOMIC_UPDATES
 }
 
 void Metric::SetInt(uint32_t value) {
+#if PW_METRIC_ATOMIC_UPDATES
+  AtomicSetInt(value);
+#else
   PW_DCHECK(is_int());
   uint_ = value;
+#endif  // PW_METRIC_ATOMIC_UPDATES
 }
 
 void Metric::SetFloat(float value) {
+#if PW_METRIC_ATOMIC_UPDATES
+  AtomicSetFloat(value);
+#else
   PW_DCHECK(is_float());
   float_ = value;
+#endif  // PW_METRIC_ATOMIC_UPDATES
+}
+
+void Metric::AtomicIncrement(uint32_t amount) {
+  PW_DCHECK(is_int());
+  __atomic_fetch_add(&uint_, amount, __ATOMIC_RELAXED);
+}
+
+void Metric::AtomicSetInt(uint32_t value) {
+  PW_DCHECK(is_int());
+  __atomic_store_n(&uint_, value, __ATOMIC_RELAXED);
+}
+
+void Metric::AtomicSetFloat(float value) {
+  PW_DCHECK(is_float());
+  __atomic_store(&float_, &value, __ATOMIC_RELAXED);
 }
 
 void Metric::Dump(int level) {
-  Base64EncodedToken encoded_name(name());
-  const char* indent = Indent(level);
-  if (is_float()) {
-    PW_LOG_INFO("%s \"%s\": %f,", indent, encoded_name.value(), as_float());
-  } else {
-    PW_LOG_INFO("%s \"%s\": %u,",
-                indent,
-                encoded_name.value(),
-                static_cast<unsigned int>(as_int()));
-  }
+  DumpMetric(*this, level);
 }
 
 void Metric::Dump(IntrusiveList<Metric>& metrics, int level) {
-  for (auto& m : metrics) {
-    m.Dump(level);
-  }
+  DumpMetrics(metrics, level);
 }
 
 Group::Group(Token name) : name_(name) {}
@@ -110,18 +172,11 @@ Group::Group(Token name, IntrusiveList<Group>& groups) : name_(name) {
 }
 
 void Group::Dump(int level) {
-  Base64EncodedToken encoded_name(name());
-  const char* indent = Indent(level);
-  PW_LOG_INFO("%s \"%s\": {", indent, encoded_name.value());
-  Group::Dump(children(), level + 1);
-  Metric::Dump(metrics(), level + 1);
-  PW_LOG_INFO("%s }", indent);
+  DumpGroup(*this, level);
 }
 
 void Group::Dump(IntrusiveList<Group>& groups, int level) {
-  for (auto& group : groups) {
-    group.Dump(level);
-  }
+  DumpGroups(groups, level);
 }
 
 }  // namespace pw::metric
@@ -0,0 +1,140 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_metric/metric_index.h"
+
+#include <array>
+
+namespace pw::metric {
+namespace {
+
+// Keeps the first error of several operations.
+void Update(Status& status, Status new_status) {
+  if (status.ok()) {
+    status = new_status;
+  }
+}
+
+}  // namespace
+
+MetricIndex::MetricIndex(std::span<Entry> entries) : entries_(entries) {
+  Clear();
+}
+
+uint32_t MetricIndex::PathKey(std::span<const Token> path) {
+  // 32-bit FNV-1a over the tokens, a word at a time.
+  uint32_t key = 2166136261u;
+  for (Token token : path) {
+    key = (key ^ token) * 16777619u;
+  }
+  return key;
+}
+
+MetricIndex::Entry* MetricIndex::Slot(uint32_t key) const {
+  if (entries_.empty()) {
+    return nullptr;
+  }
+
+  // Linear probing. Entries are never removed individually, so the first
+  // empty entry ends the search.
+  size_t index = key % entries_.size();
+  for (size_t probes = 0; probes < entries_.size(); ++probes) {
+    Entry& entry = entries_[index];
+    if (entry.metric == nullptr || entry.key == key) {
+      return &entry;
+    }
+    index = (index + 1 == entries_.size()) ? 0 : index + 1;
+  }
+  return nullptr;
+}
+
+Status MetricIndex::Add(Metric& metric, std::span<const Token> path) {
+  const uint32_t key = PathKey(path);
+  Entry* entry = Slot(key);
+  if (entry == nullptr) {
+    return Status::ResourceExhausted();
+  }
+  if (entry->metric != nullptr) {
+    return entry->metric == &metric ? OkStatus() : Status::AlreadyExists();
+  }
+  entry->key = key;
+  entry->metric = &metric;
+  size_ += 1;
+  return OkStatus();
+}
+
+Status MetricIndex::Add(IntrusiveList<Metric>& metrics) {
+  Status status;
+  for (Metric& metric : metrics) {
+    Update(status, Add(metric));
+  }
+  return status;
+}
+
+Status MetricIndex::Add(IntrusiveList<Group>& groups) {
+  std::array<Token, kMaxDepth> path;
+  Status status;
+  for (Group& group : groups) {
+    Update(status, AddGroup(group, path, 0));
+  }
+  return status;
+}
+
+Status MetricIndex::AddGroup(Group& group,
+                             std::span<Token, kMaxDepth> path,
+                             size_t depth) {
+  // The group's metrics need one more token after the group's name.
+  if (depth + 2 > kMaxDepth) {
+    return Status::ResourceExhausted();
+  }
+  path[depth] = group.name();
+
+  Status status;
+  for (Group& child : group.children()) {
+    Update(status, AddGroup(child, path, depth + 1));
+  }
+  for (Metric& metric : group.metrics()) {
+    path[depth + 1] = metric.name();
+    Update(status, Add(metric, path.first(depth + 2)));
+  }
+  return status;
+}
+
+Metric* MetricIndex::Find(std::span<const Token> path) const {
+  const uint32_t key = PathKey(path);
+  const Entry* entry = Slot(key);
+  return entry == nullptr ? nullptr : entry->metric;
+}
+
+Status MetricIndex::Reset(std::span<const Token> path) const {
+  Metric* metric = Find(path);
+  if (metric == nullptr) {
+    return Status::NotFound();
+  }
+  if (metric->is_float()) {
+    metric->SetFloat(0.0f);
+  } else {
+    metric->SetInt(0u);
+  }
+  return OkStatus();
+}
+
+void MetricIndex::Clear() {
+  for (Entry& entry : entries_) {
+    entry = {0, nullptr};
+  }
+  size_ = 0;
+}
+
+}  // namespace pw::metric
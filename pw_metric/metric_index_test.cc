@@ -0,0 +1,146 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_metric/metric_index.h"
+
+#include <array>
+
+#include "gtest/gtest.h"
+
+namespace pw::metric {
+namespace {
+
+TEST(MetricIndex, FindsTopLevelMetrics) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC(root, a, "a", 1u);
+  PW_METRIC(root, b, "b", 2.0f);
+
+  std::array<MetricIndex::Entry, 8> storage;
+  MetricIndex index(storage);
+  EXPECT_EQ(OkStatus(), index.Add(root.metrics()));
+  EXPECT_EQ(2u, index.size());
+
+  EXPECT_EQ(&a, index.Find(a.name()));
+  EXPECT_EQ(&b, index.Find(b.name()));
+  EXPECT_EQ(nullptr, index.Find(0x1234));
+}
+
+TEST(MetricIndex, FindsMetricsInGroupsByPath) {
+  PW_METRIC_GROUP(outer, "outer");
+  PW_METRIC(outer, x, "x", 1u);
+  PW_METRIC_GROUP(inner, "inner");
+  PW_METRIC(inner, same_name, "x", 2u);
+  outer.Add(inner);
+
+  IntrusiveList<Group> groups;
+  groups.push_front(outer);
+
+  std::array<MetricIndex::Entry, 8> storage;
+  MetricIndex index(storage);
+  EXPECT_EQ(OkStatus(), index.Add(groups));
+  EXPECT_EQ(2u, index.size());
+
+  // Metrics with the same name in different groups are told apart by path.
+  const Token outer_path[] = {outer.name(), x.name()};
+  const Token inner_path[] = {outer.name(), inner.name(), same_name.name()};
+  EXPECT_EQ(&x, index.Find(outer_path));
+  EXPECT_EQ(&same_name, index.Find(inner_path));
+  EXPECT_EQ(nullptr, index.Find(x.name()));
+}
+
+TEST(MetricIndex, Reset) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC(root, i, "i", 10u);
+  PW_METRIC(root, f, "f", 1.5f);
+
+  std::array<MetricIndex::Entry, 4> storage;
+  MetricIndex index(storage);
+  ASSERT_EQ(OkStatus(), index.Add(root.metrics()));
+
+  const Token i_path[] = {i.name()};
+  const Token f_path[] = {f.name()};
+  const Token missing_path[] = {0x1234};
+  EXPECT_EQ(OkStatus(), index.Reset(i_path));
+  EXPECT_EQ(OkStatus(), index.Reset(f_path));
+  EXPECT_EQ(Status::NotFound(), index.Reset(missing_path));
+  EXPECT_EQ(0u, i.value());
+  EXPECT_EQ(0.0f, f.value());
+}
+
+TEST(MetricIndex, AddTwice_IsOk) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC(root, a, "a", 1u);
+
+  std::array<MetricIndex::Entry, 4> storage;
+  MetricIndex index(storage);
+  EXPECT_EQ(OkStatus(), index.Add(a));
+  EXPECT_EQ(OkStatus(), index.Add(a));
+  EXPECT_EQ(1u, index.size());
+}
+
+TEST(MetricIndex, SamePath_AlreadyExists) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC(root, a, "a", 1u);
+  PW_METRIC(root, another_a, "a", 2u);
+
+  std::array<MetricIndex::Entry, 4> storage;
+  MetricIndex index(storage);
+  EXPECT_EQ(OkStatus(), index.Add(a));
+  EXPECT_EQ(Status::AlreadyExists(), index.Add(another_a));
+  EXPECT_EQ(&a, index.Find(a.name()));
+}
+
+TEST(MetricIndex, Full_ResourceExhausted) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC(root, a, "a", 1u);
+  PW_METRIC(root, b, "b", 2u);
+  PW_METRIC(root, c, "c", 3u);
+
+  std::array<MetricIndex::Entry, 2> storage;
+  MetricIndex index(storage);
+  EXPECT_EQ(Status::ResourceExhausted(), index.Add(root.metrics()));
+  EXPECT_EQ(2u, index.size());
+
+  index.Clear();
+  EXPECT_EQ(0u, index.size());
+  EXPECT_EQ(OkStatus(), index.Add(c));
+  EXPECT_EQ(&c, index.Find(c.name()));
+}
+
+TEST(MetricIndex, TooDeep_ResourceExhausted) {
+  PW_METRIC_GROUP(g1, "g1");
+  PW_METRIC_GROUP(g2, "g2");
+  PW_METRIC_GROUP(g3, "g3");
+  PW_METRIC_GROUP(g4, "g4");
+  PW_METRIC(g3, shallow, "shallow", 1u);
+  PW_METRIC(g4, deep, "deep", 2u);
+  g1.Add(g2);
+  g2.Add(g3);
+  g3.Add(g4);
+
+  IntrusiveList<Group> groups;
+  groups.push_front(g1);
+
+  std::array<MetricIndex::Entry, 8> storage;
+  MetricIndex index(storage);
+  EXPECT_EQ(Status::ResourceExhausted(), index.Add(groups));
+
+  const Token shallow_path[] = {
+      g1.name(), g2.name(), g3.name(), shallow.name()};
+  EXPECT_EQ(&shallow, index.Find(shallow_path));
+  EXPECT_EQ(1u, index.size());
+}
+
+}  // namespace
+}  // namespace pw::metric
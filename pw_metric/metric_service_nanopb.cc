@@ -25,38 +25,75 @@
 namespace pw::metric {
 namespace {
 
+// Returns the bits of a metric's value, for comparing with the snapshot.
+uint32_t RawValue(const Metric& metric) {
+  if (metric.is_int()) {
+    return metric.as_int();
+  }
+  const float value = metric.as_float();
+  uint32_t raw;
+  std::memcpy(&raw, &value, sizeof(raw));
+  return raw;
+}
+
+// Copies a metric and its path into a proto metric.
+void CopyMetric(const Metric& metric,
+                std::span<const Token> path,
+                pw_metric_Metric& proto_metric) {
+  // Copy the path.
+  std::span<Token> proto_path(proto_metric.token_path);
+  PW_CHECK_INT_LE(path.size(), proto_path.size());
+  std::copy(path.begin(), path.end(), proto_path.begin());
+  proto_metric.token_path_count = path.size();
+
+  // Copy the metric value.
+  if (metric.is_float()) {
+    proto_metric.value.as_float = metric.as_float();
+    proto_metric.which_value = pw_metric_Metric_as_float_tag;
+  } else {
+    proto_metric.value.as_int = metric.as_int();
+    proto_metric.which_value = pw_metric_Metric_as_int_tag;
+  }
+}
+
+// The token path of a requested metric.
+std::span<const Token> RequestedPath(const pw_metric_Metric& proto_metric) {
+  return std::span<const Token>(proto_metric.token_path,
+                                proto_metric.token_path_count);
+}
+
 class MetricWriter {
  public:
-  MetricWriter(rpc::ServerWriter<pw_metric_MetricResponse>& response_writer)
+  MetricWriter(rpc::ServerWriter<pw_metric_MetricResponse>& response_writer,
+               std::span<uint32_t> snapshot,
+               bool changed_only)
       : response_(pw_metric_MetricResponse_init_zero),
-        response_writer_(response_writer) {}
+        response_writer_(response_writer),
+        snapshot_(snapshot),
+        changed_only_(changed_only) {}
 
   // TODO(keir): Figure out a pw_rpc mechanism to fill a streaming packet based
   // on transport MTU, rather than having this as a static knob. For example,
   // some transports may be able to fit 30 metrics; others, only 5.
-  void Write(const Metric& metric, const Vector<Token>& path) {
+  void Write(const Metric& metric, std::span<const Token> path) {
+    // Record the value in the snapshot, and skip it if it has not changed.
+    if (index_ < snapshot_.size()) {
+      const uint32_t value = RawValue(metric);
+      const bool changed = snapshot_[index_] != value;
+      snapshot_[index_] = value;
+      index_ += 1;
+      if (changed_only_ && !changed) {
+        return;
+      }
+    }
+
     // Nanopb doesn't offer an easy way to do bounds checking, so use span's
     // type deduction magic to figure out the max size.
     std::span<pw_metric_Metric> metrics(response_.metrics);
     PW_CHECK_INT_LT(response_.metrics_count, metrics.size());
 
-    // Grab the next available Metric slot to write to in the response.
-    pw_metric_Metric& proto_metric = response_.metrics[response_.metrics_count];
-
-    // Copy the path.
-    std::span<Token> proto_path(proto_metric.token_path);
-    PW_CHECK_INT_LE(path.size(), proto_path.size());
-    std::copy(path.begin(), path.end(), proto_path.begin());
-    proto_metric.token_path_count = path.size();
-
-    // Copy the metric value.
-    if (metric.is_float()) {
-      proto_metric.value.as_float = metric.as_float();
-      proto_metric.which_value = pw_metric_Metric_as_float_tag;
-    } else {
-      proto_metric.value.as_int = metric.as_int();
-      proto_metric.which_value = pw_metric_Metric_as_int_tag;
-    }
+    // Copy the metric into the next available Metric slot in the response.
+    CopyMetric(metric, path, response_.metrics[response_.metrics_count]);
 
     // Move write head to the next slot.
     response_.metrics_count++;
@@ -79,6 +116,10 @@ class MetricWriter {
   pw_metric_MetricResponse response_;
   // This RPC stream writer handle must be valid for the metric writer lifetime.
   rpc::ServerWriter<pw_metric_MetricResponse>& response_writer_;
+
+  std::span<uint32_t> snapshot_;
+  size_t index_ = 0;
+  const bool changed_only_;
 };
 
 // Walk a metric tree recursively; passing metrics with their path (names) to a
@@ -92,7 +133,7 @@ class MetricWalker {
   void Walk(const IntrusiveList<Metric>& metrics) {
     for (const auto& m : metrics) {
       ScopedName scoped_name(m.name(), *this);
-      writer_.Write(m, path_);
+      writer_.Write(m, std::span(path_.data(), path_.size()));
     }
   }
 
@@ -128,10 +169,25 @@ class MetricWalker {
 }  // namespace
 
 void MetricService::Get(ServerContext&,
-                        const pw_metric_MetricRequest& /* request */,
+                        const pw_metric_MetricRequest& request,
                         ServerWriter<pw_metric_MetricResponse>& response) {
-  // For now, ignore the request and just stream all the metrics back.
-  MetricWriter writer(response);
+  // With an index, stream back only the metrics at the requested paths.
+  if (index_ != nullptr && request.metrics_count > 0) {
+    MetricWriter writer(response, {}, false);
+    for (size_t i = 0; i < request.metrics_count; ++i) {
+      const std::span<const Token> path = RequestedPath(request.metrics[i]);
+      if (const Metric* metric = index_->Find(path); metric != nullptr) {
+        writer.Write(*metric, path);
+      }
+    }
+    writer.Flush();
+    return;
+  }
+
+  // Otherwise, ignore the requested paths and stream all the metrics back, or
+  // only the changed metrics if requested.
+  MetricWriter writer(
+      response, snapshot_, request.changed_only && snapshot_valid_);
   MetricWalker walker(writer);
 
   // This will stream all the metrics in the span of this Get() method call.
@@ -144,6 +200,29 @@ void MetricService::Get(ServerContext&,
   walker.Walk(metrics_);
   walker.Walk(groups_);
   writer.Flush();
+  snapshot_valid_ = !snapshot_.empty();
+}
+
+Status MetricService::Reset(ServerContext&,
+                            const pw_metric_MetricRequest& request,
+                            pw_metric_MetricResponse& response) {
+  if (index_ == nullptr) {
+    return Status::FailedPrecondition();
+  }
+
+  // The request and response hold the same number of metrics, so the previous
+  // value of every requested metric fits.
+  static_assert(sizeof(request.metrics) == sizeof(response.metrics));
+
+  for (size_t i = 0; i < request.metrics_count; ++i) {
+    const std::span<const Token> path = RequestedPath(request.metrics[i]);
+    if (const Metric* metric = index_->Find(path); metric != nullptr) {
+      CopyMetric(*metric, path, response.metrics[response.metrics_count]);
+      response.metrics_count++;
+      index_->Reset(path);
+    }
+  }
+  return OkStatus();
 }
 
 }  // namespace pw::metric
@@ -14,6 +14,9 @@
 
 #include "pw_metric/metric_service_nanopb.h"
 
+#include <array>
+#include <initializer_list>
+
 #include "gtest/gtest.h"
 #include "pw_log/log.h"
 #include "pw_rpc/nanopb_test_method_context.h"
@@ -25,6 +28,8 @@ namespace {
   PW_NANOPB_TEST_METHOD_CONTEXT( \
       MetricService, Get, 4, sizeof(pw_metric_MetricResponse))
 
+#define ResetMethodContext PW_NANOPB_TEST_METHOD_CONTEXT(MetricService, Reset)
+
 TEST(MetricService, EmptyGroupAndNoMetrics) {
   // Empty root group.
   PW_METRIC_GROUP(root, "/");
@@ -203,5 +208,170 @@ TEST(MetricService, TokenPaths) {
   }
 }
 
+TEST(MetricService, ChangedOnly_SendsChangedMetrics) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC(root, a, "a", 1u);
+  PW_METRIC(root, b, "b", 2u);
+
+  PW_METRIC_GROUP(inner, "inner");
+  PW_METRIC(inner, x, "x", 3u);
+  PW_METRIC(inner, y, "y", 4.0f);
+  root.Add(inner);
+
+  uint32_t snapshot[4] = {};
+  MetricMethodContext context(
+      root.metrics(), root.children(), std::span(snapshot));
+
+  // The first request returns every metric.
+  context.call({.changed_only = true});
+  EXPECT_EQ(OkStatus(), context.status());
+  ASSERT_EQ(1u, context.responses().size());
+  EXPECT_EQ(4, context.responses()[0].metrics_count);
+
+  // Nothing changed.
+  context.call({.changed_only = true});
+  EXPECT_EQ(OkStatus(), context.status());
+  EXPECT_EQ(0u, context.responses().size());
+
+  b.Increment();
+  y.Set(5.0f);
+  context.call({.changed_only = true});
+  EXPECT_EQ(OkStatus(), context.status());
+  ASSERT_EQ(1u, context.responses().size());
+  ASSERT_EQ(2, context.responses()[0].metrics_count);
+
+  uint32_t expected_b[] = {b_token, 0u};
+  uint32_t expected_y[] = {inner_token, y_token, 0u};
+  int found_matches = 0;
+  for (unsigned m = 0; m < 2; ++m) {
+    const pw_metric_Metric& metric = context.responses()[0].metrics[m];
+    if (TokenPathsMatch(expected_b, metric)) {
+      EXPECT_EQ(3u, metric.value.as_int);
+      found_matches++;
+    }
+    if (TokenPathsMatch(expected_y, metric)) {
+      EXPECT_EQ(5.0f, metric.value.as_float);
+      found_matches++;
+    }
+  }
+  EXPECT_EQ(2, found_matches);
+
+  // A full request still returns every metric.
+  context.call({});
+  ASSERT_EQ(1u, context.responses().size());
+  EXPECT_EQ(4, context.responses()[0].metrics_count);
+}
+
+TEST(MetricService, ChangedOnly_WithoutSnapshotSendsAll) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC(root, a, "a", 1u);
+  PW_METRIC(root, b, "b", 2u);
+
+  MetricMethodContext context(root.metrics(), root.children());
+  context.call({.changed_only = true});
+  context.call({.changed_only = true});
+  ASSERT_EQ(1u, context.responses().size());
+  EXPECT_EQ(2, context.responses()[0].metrics_count);
+}
+
+TEST(MetricService, ChangedOnly_MetricsPastSnapshotAlwaysSent) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC(root, a, "a", 1u);
+  PW_METRIC(root, b, "b", 2u);
+  PW_METRIC(root, c, "c", 3u);
+
+  uint32_t snapshot[1] = {};
+  MetricMethodContext context(
+      root.metrics(), root.children(), std::span(snapshot));
+  context.call({.changed_only = true});
+  context.call({.changed_only = true});
+  ASSERT_EQ(1u, context.responses().size());
+  EXPECT_EQ(2, context.responses()[0].metrics_count);
+}
+
+// Returns a request for the metrics at the given paths.
+pw_metric_MetricRequest PathRequest(
+    std::initializer_list<std::initializer_list<Token>> paths) {
+  pw_metric_MetricRequest request = pw_metric_MetricRequest_init_zero;
+  for (const auto& path : paths) {
+    pw_metric_Metric& metric = request.metrics[request.metrics_count++];
+    for (Token token : path) {
+      metric.token_path[metric.token_path_count++] = token;
+    }
+  }
+  return request;
+}
+
+TEST(MetricService, Index_GetsRequestedMetrics) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC(root, a, "a", 1u);
+  PW_METRIC(root, b, "b", 2u);
+
+  PW_METRIC_GROUP(inner, "inner");
+  PW_METRIC(inner, x, "x", 3u);
+  PW_METRIC(inner, y, "y", 4.0f);
+  root.Add(inner);
+
+  std::array<MetricIndex::Entry, 8> index_storage;
+  MetricIndex index(index_storage);
+  ASSERT_EQ(OkStatus(), index.Add(root.metrics()));
+  ASSERT_EQ(OkStatus(), index.Add(root.children()));
+
+  MetricMethodContext context(root.metrics(), root.children(), index);
+  context.call(PathRequest({{b.name()}, {inner.name(), y.name()}, {0x1234}}));
+  EXPECT_TRUE(context.done());
+  EXPECT_EQ(OkStatus(), context.status());
+
+  // Only the requested metrics are returned, in the order requested. The
+  // unknown path is skipped.
+  ASSERT_EQ(1u, context.responses().size());
+  ASSERT_EQ(2, context.responses()[0].metrics_count);
+  EXPECT_EQ(2u, context.responses()[0].metrics[0].value.as_int);
+  EXPECT_EQ(4.0f, context.responses()[0].metrics[1].value.as_float);
+
+  // Without paths, every metric is returned.
+  context.call({});
+  ASSERT_EQ(1u, context.responses().size());
+  EXPECT_EQ(4, context.responses()[0].metrics_count);
+}
+
+TEST(MetricService, Index_ResetsRequestedMetrics) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC(root, a, "a", 1u);
+  PW_METRIC(root, b, "b", 2u);
+
+  PW_METRIC_GROUP(inner, "inner");
+  PW_METRIC(inner, y, "y", 4.0f);
+  root.Add(inner);
+
+  std::array<MetricIndex::Entry, 8> index_storage;
+  MetricIndex index(index_storage);
+  ASSERT_EQ(OkStatus(), index.Add(root.metrics()));
+  ASSERT_EQ(OkStatus(), index.Add(root.children()));
+
+  ResetMethodContext context(root.metrics(), root.children(), index);
+  ASSERT_EQ(OkStatus(),
+            context.call(PathRequest({{b.name()}, {inner.name(), y.name()}})));
+
+  // The response has the values from before the reset.
+  ASSERT_EQ(2, context.response().metrics_count);
+  EXPECT_EQ(2u, context.response().metrics[0].value.as_int);
+  EXPECT_EQ(4.0f, context.response().metrics[1].value.as_float);
+
+  EXPECT_EQ(1u, a.value());
+  EXPECT_EQ(0u, b.value());
+  EXPECT_EQ(0.0f, y.value());
+}
+
+TEST(MetricService, Reset_WithoutIndexFails) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC(root, a, "a", 1u);
+
+  ResetMethodContext context(root.metrics(), root.children());
+  EXPECT_EQ(Status::FailedPrecondition(),
+            context.call(PathRequest({{a.name()}})));
+  EXPECT_EQ(1u, a.value());
+}
+
 }  // namespace
 }  // namespace pw::metric
@@ -14,6 +14,8 @@
 
 #include "pw_metric/metric.h"
 
+#include <limits>
+
 #include "gtest/gtest.h"
 #include "pw_log/log.h"
 
@@ -55,6 +57,30 @@ TEST(Metric, IntFromObject) {
   EXPECT_EQ(m.value(), 426u);
 }
 
+TEST(Metric, AtomicUpdates) {
+  TypedMetric<uint32_t> i(0x1234, static_cast<uint32_t>(10u));
+  i.AtomicIncrement();
+  EXPECT_EQ(i.value(), 11u);
+  i.AtomicIncrement(9u);
+  EXPECT_EQ(i.value(), 20u);
+  i.AtomicSet(7u);
+  EXPECT_EQ(i.value(), 7u);
+
+  // Atomic and plain updates can be mixed.
+  i.Increment();
+  EXPECT_EQ(i.value(), 8u);
+
+  TypedMetric<float> f(0x5678, 1.5f);
+  f.AtomicSet(2.5f);
+  EXPECT_EQ(f.value(), 2.5f);
+}
+
+TEST(Metric, AtomicIncrement_Wraps) {
+  TypedMetric<uint32_t> m(0x1234, std::numeric_limits<uint32_t>::max());
+  m.AtomicIncrement(2u);
+  EXPECT_EQ(m.value(), 1u);
+}
+
 TEST(m, IntFromMacroLocal) {
   PW_METRIC(m, "some_metric", 14u);
   EXPECT_TRUE(m.is_int());
@@ -0,0 +1,200 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#include "pw_containers/intrusive_list.h"
+#include "pw_metric/metric.h"
+
+namespace pw::metric {
+namespace internal {
+
+// The token of "bucket_<index>" in the "metrics" domain.
+Token HistogramBucketName(size_t index);
+
+}  // namespace internal
+
+// A distribution of uint32_t values, such as latencies, in a fixed number of
+// buckets. The histogram is a Group holding one uint32_t metric per bucket, so
+// it is dumped and served by MetricService like any other group. Buckets are
+// named "bucket_0", "bucket_1", and so on.
+//
+// By default, buckets are powers of two: bucket 0 counts zeros, and bucket i
+// counts values in [2^(i-1), 2^i). The last bucket also counts all larger
+// values. Recording is O(1).
+//
+// Buckets can instead have user-defined bounds: kBuckets - 1 sorted upper
+// bounds, where bucket i counts values in [bounds[i-1], bounds[i]), and the
+// last bucket counts values from the last bound up. Recording is a binary
+// search of the bounds. The bounds are not copied, so they must outlive the
+// histogram.
+//
+// Size: 16 bytes for the group, 12 bytes per bucket, and 8 bytes for the
+// bounds.
+//
+// Example:
+//
+//   class Radio {
+//    private:
+//     static constexpr Token kTxLatencyName =
+//         PW_TOKENIZE_STRING_DOMAIN("metrics", "tx_latency_us");
+//
+//     PW_METRIC_GROUP(metrics_, "radio");
+//     // Transmit latency in microseconds, from 0 up to 2^15.
+//     Histogram<16> tx_latency_us_{kTxLatencyName, metrics_.children()};
+//   };
+template <size_t kBuckets>
+class Histogram {
+ public:
+  static_assert(kBuckets >= 2 && kBuckets <= 33,
+                "A histogram has 2 to 33 buckets; 33 power of two buckets "
+                "cover every uint32_t value");
+
+  // The bucket counts of a histogram at one time. Snapshots of histograms with
+  // the same buckets, such as from several devices or time periods, can be
+  // merged.
+  struct Snapshot {
+    uint32_t total() const {
+      uint32_t total = 0;
+      for (uint32_t count : counts) {
+        total += count;
+      }
+      return total;
+    }
+
+    void Merge(const Snapshot& other) {
+      for (size_t i = 0; i < kBuckets; ++i) {
+        counts[i] += other.counts[i];
+      }
+    }
+
+    std::array<uint32_t, kBuckets> counts = {};
+  };
+
+  // A histogram with power of two buckets.
+  explicit Histogram(Token name)
+      : Histogram(name, {}, std::make_index_sequence<kBuckets>()) {}
+  Histogram(Token name, IntrusiveList<Group>& groups) : Histogram(name) {
+    groups.push_front(group_);
+  }
+
+  // A histogram with user-defined bucket bounds.
+  Histogram(Token name, std::span<const uint32_t, kBuckets - 1> upper_bounds)
+      : Histogram(name, upper_bounds, std::make_index_sequence<kBuckets>()) {}
+  Histogram(Token name,
+            std::span<const uint32_t, kBuckets - 1> upper_bounds,
+            IntrusiveList<Group>& groups)
+      : Histogram(name, upper_bounds) {
+    groups.push_front(group_);
+  }
+
+  // Disallow copy and assign.
+  Histogram(Histogram const&) = delete;
+  void operator=(const Histogram&) = delete;
+
+  void Record(uint32_t value) { buckets_[BucketIndex(value)].Increment(); }
+
+  // Returns the bucket a value is counted in.
+  size_t BucketIndex(uint32_t value) const {
+    if (upper_bounds_.empty()) {
+      const size_t bit_width =
+          value == 0 ? 0 : 32 - static_cast<size_t>(__builtin_clz(value));
+      return std::min(bit_width, kBuckets - 1);
+    }
+    return std::upper_bound(upper_bounds_.begin(), upper_bounds_.end(), value) -
+           upper_bounds_.begin();
+  }
+
+  uint32_t count(size_t bucket) const { return buckets_[bucket].value(); }
+
+  Snapshot snapshot() const {
+    Snapshot snapshot;
+    for (size_t i = 0; i < kBuckets; ++i) {
+      snapshot.counts[i] = buckets_[i].value();
+    }
+    return snapshot;
+  }
+
+  void Reset() {
+    for (TypedMetric<uint32_t>& bucket : buckets_) {
+      bucket.Set(0u);
+    }
+  }
+
+  Group& group() { return group_; }
+  const Group& group() const { return group_; }
+
+ private:
+  template <size_t... kIndices>
+  Histogram(Token name,
+            std::span<const uint32_t> upper_bounds,
+            std::index_sequence<kIndices...>)
+      : group_(name),
+        upper_bounds_(upper_bounds),
+        buckets_{{{internal::HistogramBucketName(kIndices), 0u}...}} {
+    // Groups list metrics in reverse order of adding; add the last bucket
+    // first so the buckets are listed in order.
+    for (size_t i = kBuckets; i > 0; --i) {
+      group_.Add(buckets_[i - 1]);
+    }
+  }
+
+  Group group_;
+  std::span<const uint32_t> upper_bounds_;
+  std::array<TypedMetric<uint32_t>, kBuckets> buckets_;
+};
+
+// The count, sum, minimum, and maximum of uint32_t values. Like Histogram, a
+// Summary is a Group holding uint32_t metrics, named "count", "sum", "min",
+// and "max". The sum wraps on overflow. Recording is O(1).
+//
+// Size: 16 bytes for the group and 48 bytes for the metrics.
+class Summary {
+ public:
+  explicit Summary(Token name);
+  Summary(Token name, IntrusiveList<Group>& groups);
+
+  // Disallow copy and assign.
+  Summary(Summary const&) = delete;
+  void operator=(const Summary&) = delete;
+
+  void Record(uint32_t value);
+
+  uint32_t count() const { return count_.value(); }
+  uint32_t sum() const { return sum_.value(); }
+
+  // The minimum and maximum are 0 if no values were recorded.
+  uint32_t min() const { return min_.value(); }
+  uint32_t max() const { return max_.value(); }
+
+  void Reset();
+
+  Group& group() { return group_; }
+  const Group& group() const { return group_; }
+
+ private:
+  Group group_;
+  TypedMetric<uint32_t> count_;
+  TypedMetric<uint32_t> sum_;
+  TypedMetric<uint32_t> min_;
+  TypedMetric<uint32_t> max_;
+};
+
+}  // namespace pw::metric
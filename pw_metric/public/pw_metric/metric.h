@@ -34,7 +34,10 @@ using tokenizer::Token;
 //
 // Size: 12 bytes / 96 bits - next, name, value.
 //
-// TODO(keir): Implement Set() and Increment() using atomics.
+// Reads are always atomic. Increment() and Set() are atomic when
+// PW_METRIC_ATOMIC_UPDATES is enabled; otherwise, AtomicIncrement() and
+// AtomicSet() make individual updates atomic.
+//
 // TODO(keir): Consider an alternative structure where metrics have pointers to
 // parent groups, which would enable (1) safe destruction and (2) safe static
 // initialization, but at the cost of an additional 4 bytes per metric and 4
@@ -82,7 +85,15 @@ class Metric : public IntrusiveList<Metric>::Item {
 
   void SetFloat(float value);
 
+  // Always atomic, regardless of PW_METRIC_ATOMIC_UPDATES.
+  void AtomicIncrement(uint32_t amount = 1);
+  void AtomicSetInt(uint32_t value);
+  void AtomicSetFloat(float value);
+
  private:
+  // MetricIndex resets metrics of either type.
+  friend class MetricIndex;
+
   // The name of this metric as a token; from PW_TOKENIZE_STRING("my_metric").
   // Last bit of the token is used to store int or float; 0 == int, 1 == float.
   Token name_and_type_;
@@ -116,6 +127,7 @@ class TypedMetric<float> : public Metric {
       : Metric(name, value, metrics) {}
 
   void Set(float value) { SetFloat(value); }
+  void AtomicSet(float value) { AtomicSetFloat(value); }
   float value() const { return Metric::as_float(); }
 
  private:
@@ -134,6 +146,13 @@ class TypedMetric<uint32_t> : public Metric {
 
   void Increment(uint32_t amount = 1u) { Metric::Increment(amount); }
   void Set(uint32_t value) { SetInt(value); }
+
+  // Atomic updates for metrics shared between threads, cores, or interrupts
+  // when PW_METRIC_ATOMIC_UPDATES is disabled.
+  void AtomicIncrement(uint32_t amount = 1u) {
+    Metric::AtomicIncrement(amount);
+  }
+  void AtomicSet(uint32_t value) { AtomicSetInt(value); }
   uint32_t value() const { return Metric::as_int(); }
 
  private:
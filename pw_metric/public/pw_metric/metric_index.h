@@ -0,0 +1,118 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_containers/intrusive_list.h"
+#include "pw_metric/metric.h"
+#include "pw_status/status.h"
+
+namespace pw::metric {
+
+// A flat hash table from a metric's token path to the metric, for finding
+// single metrics without walking the metric tree. The path is the tokens of
+// the parent groups, from the root, followed by the metric name; this is the
+// same path MetricService sends. A metric that is not in a group has a path of
+// just its name.
+//
+// The index is optional, and is built when metrics are registered, typically
+// by adding the global metric lists once after static initialization. The
+// storage is provided by the caller; keep it at least 25% larger than the
+// number of metrics so lookups stay short.
+//
+// Paths are hashed to 32 bits, and the paths themselves are not stored, so two
+// paths with the same hash cannot both be indexed; Add() reports the second as
+// AlreadyExists.
+//
+// Size: 8 bytes per entry on 32-bit targets.
+//
+// Example:
+//
+//   std::array<MetricIndex::Entry, 64> index_storage;
+//   MetricIndex index(index_storage);
+//
+//   int main() {
+//     index.Add(pw::metric::global_metrics);
+//     index.Add(pw::metric::global_groups);
+//     ...
+//   }
+class MetricIndex {
+ public:
+  struct Entry {
+    uint32_t key;
+    Metric* metric;
+  };
+
+  // The deepest path that can be indexed, matching the service's path limit.
+  static constexpr size_t kMaxDepth = 4;
+
+  explicit MetricIndex(std::span<Entry> entries);
+
+  // Disallow copy and assign.
+  MetricIndex(MetricIndex const&) = delete;
+  void operator=(const MetricIndex&) = delete;
+
+  // Adds a metric with the given path. Returns:
+  //
+  //   OK - the metric was added
+  //   ALREADY_EXISTS - another metric's path has the same hash
+  //   RESOURCE_EXHAUSTED - the index is full
+  //
+  Status Add(Metric& metric, std::span<const Token> path);
+
+  // Adds a metric that is not in a group.
+  Status Add(Metric& metric) {
+    const Token name = metric.name();
+    return Add(metric, std::span(&name, 1));
+  }
+
+  // Adds every metric in the list or groups, including subgroups. Metrics that
+  // cannot be added are skipped, and the first error is returned. Paths deeper
+  // than kMaxDepth are RESOURCE_EXHAUSTED.
+  Status Add(IntrusiveList<Metric>& metrics);
+  Status Add(IntrusiveList<Group>& groups);
+
+  // Returns the metric with the given path, or nullptr if there is none.
+  Metric* Find(std::span<const Token> path) const;
+  Metric* Find(Token name) const { return Find(std::span(&name, 1)); }
+
+  // Sets the metric with the given path to zero, of its type. Returns
+  // NOT_FOUND if there is no such metric.
+  Status Reset(std::span<const Token> path) const;
+
+  void Clear();
+
+  size_t size() const { return size_; }
+  size_t capacity() const { return entries_.size(); }
+
+  // The hash of a path, which is the key of its entry.
+  static uint32_t PathKey(std::span<const Token> path);
+
+ private:
+  // Adds the group's metrics and subgroups; path holds the parent groups'
+  // names in its first depth tokens.
+  Status AddGroup(Group& group, std::span<Token, kMaxDepth> path, size_t depth);
+
+  // Returns the entry for the key, or the empty entry where it would go.
+  // Returns nullptr if the key is not present and the index is full.
+  Entry* Slot(uint32_t key) const;
+
+  std::span<Entry> entries_;
+  size_t size_ = 0;
+};
+
+}  // namespace pw::metric
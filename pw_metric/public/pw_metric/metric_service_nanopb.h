@@ -18,6 +18,7 @@
 
 #include "pw_log/log.h"
 #include "pw_metric/metric.h"
+#include "pw_metric/metric_index.h"
 #include "pw_metric_proto/metric_service.rpc.pb.h"
 
 namespace pw::metric {
@@ -31,19 +32,47 @@ namespace pw::metric {
 // method is blocking, and sends all metrics at once (though batched). In the
 // future, we may switch to offering an async version where the Get() method
 // returns immediately, and someone else is responsible for pumping the queue.
+//
+// To send only the metrics which changed since the last Get() (when requested
+// with changed_only), the service needs storage for a snapshot of the values:
+// one uint32_t per metric, in the order they are walked. Metrics beyond the
+// end of the snapshot are always sent. There is one snapshot for all clients,
+// so a client only receives the changes since the last Get() by any client.
+//
+// With a MetricIndex of the same metrics, Get() can return only the metrics at
+// the requested token paths, and Reset() can reset them.
 class MetricService final : public generated::MetricService<MetricService> {
  public:
   MetricService(const IntrusiveList<Metric>& metrics,
-                const IntrusiveList<Group>& groups)
-      : metrics_(metrics), groups_(groups) {}
+                const IntrusiveList<Group>& groups,
+                std::span<uint32_t> snapshot = {},
+                const MetricIndex* index = nullptr)
+      : metrics_(metrics),
+        groups_(groups),
+        index_(index),
+        snapshot_(snapshot) {}
+
+  MetricService(const IntrusiveList<Metric>& metrics,
+                const IntrusiveList<Group>& groups,
+                const MetricIndex& index)
+      : MetricService(metrics, groups, {}, &index) {}
 
   void Get(ServerContext&,
            const pw_metric_MetricRequest& request,
            ServerWriter<pw_metric_MetricResponse>& response);
 
+  Status Reset(ServerContext&,
+               const pw_metric_MetricRequest& request,
+               pw_metric_MetricResponse& response);
+
  private:
   const IntrusiveList<Metric>& metrics_;
   const IntrusiveList<Group>& groups_;
+  const MetricIndex* index_;
+
+  // The values sent by the last Get(), used to skip unchanged metrics.
+  std::span<uint32_t> snapshot_;
+  bool snapshot_valid_ = false;
 };
 
 }  // namespace pw::metric
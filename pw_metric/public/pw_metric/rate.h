@@ -0,0 +1,152 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_containers/intrusive_list.h"
+#include "pw_metric/metric.h"
+
+namespace pw::metric {
+namespace internal {
+
+// The parts of Rate that do not depend on the window size.
+class RateBase {
+ public:
+  // Disallow copy and assign.
+  RateBase(RateBase const&) = delete;
+  void operator=(const RateBase&) = delete;
+
+  // Counts events at the current time.
+  void Record(uint32_t count = 1u) {
+    Record(count, chrono::SystemClock::now());
+  }
+
+  // Counts events at a time the caller already read from the SystemClock.
+  // Times must not go backwards.
+  void Record(uint32_t count, chrono::SystemClock::time_point now) {
+    if (now >= interval_end_) {
+      EndIntervals(now);
+    }
+    current_count_ += count;
+  }
+
+  // Ends the intervals which ended before now, without counting events. Call
+  // this periodically, or before reading, for the rate to drop when no events
+  // are recorded.
+  void Update() { Update(chrono::SystemClock::now()); }
+  void Update(chrono::SystemClock::time_point now) {
+    if (now >= interval_end_) {
+      EndIntervals(now);
+    }
+  }
+
+  // The mean count per interval over the window, as of the last interval end.
+  uint32_t rate() const { return rate_.value(); }
+
+  // The highest count in one interval since construction or Reset().
+  uint32_t peak() const { return peak_.value(); }
+
+  void Reset();
+
+  Group& group() { return group_; }
+  const Group& group() const { return group_; }
+
+ protected:
+  RateBase(Token name,
+           chrono::SystemClock::duration interval,
+           std::span<uint32_t> counts);
+  RateBase(Token name,
+           chrono::SystemClock::duration interval,
+           std::span<uint32_t> counts,
+           IntrusiveList<Group>& groups);
+  ~RateBase() = default;
+
+ private:
+  void EndIntervals(chrono::SystemClock::time_point now);
+
+  // Adds the count of an ended interval to the window.
+  void Push(uint32_t count);
+
+  Group group_;
+  TypedMetric<uint32_t> rate_;
+  TypedMetric<uint32_t> peak_;
+
+  const chrono::SystemClock::duration interval_;
+  chrono::SystemClock::time_point interval_end_;
+  uint32_t current_count_;
+
+  // The counts of the last ended intervals, a ring buffer with their sum.
+  std::span<uint32_t> counts_;
+  size_t next_;
+  uint32_t window_sum_;
+};
+
+}  // namespace internal
+
+// Tracks the rate of events, such as packets or interrupts, over a rolling
+// window of kIntervals intervals, and the peak rate of any one interval. Both
+// are counts per interval: with a one second interval, they are per second.
+//
+// Bursts shorter than the host's polling period are lost when rates are
+// computed by diffing counters on the host; the peak keeps them.
+//
+// The rate and peak are uint32_t metrics in a group, named "rate" and
+// "peak_rate", so they are dumped and served by MetricService like any other
+// group. They are updated when an interval ends, on the first Record() or
+// Update() after it. Recording is O(1): events are added to the current
+// interval, and ending intervals costs at most kIntervals steps, however long
+// the rate was idle.
+//
+// Rates are not thread safe; like other metrics, protect them with a lock if
+// they are recorded from several threads.
+//
+// Size: 16 bytes for the group, 24 bytes for the metrics, about 32 bytes of
+// state, and 4 bytes per interval.
+//
+// Example:
+//
+//   class Radio {
+//    private:
+//     static constexpr Token kRxPacketRateName =
+//         PW_TOKENIZE_STRING_DOMAIN("metrics", "rx_packets_per_s");
+//
+//     PW_METRIC_GROUP(metrics_, "radio");
+//     // Packets per second over the last 10 seconds, and the peak.
+//     Rate<10> rx_packet_rate_{
+//         kRxPacketRateName, std::chrono::seconds(1), metrics_.children()};
+//   };
+template <size_t kIntervals>
+class Rate : public internal::RateBase {
+ public:
+  static_assert(kIntervals > 0);
+
+  Rate(Token name, chrono::SystemClock::duration interval)
+      : RateBase(name, interval, counts_) {}
+  Rate(Token name,
+       chrono::SystemClock::duration interval,
+       IntrusiveList<Group>& groups)
+      : RateBase(name, interval, counts_, groups) {}
+
+ private:
+  // Zeroed by RateBase, which is constructed first; the array has no
+  // initializer, so it keeps those values.
+  std::array<uint32_t, kIntervals> counts_;
+};
+
+}  // namespace pw::metric
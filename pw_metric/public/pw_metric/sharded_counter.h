@@ -0,0 +1,105 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_assert/assert.h"
+#include "pw_containers/intrusive_list.h"
+#include "pw_metric/metric.h"
+
+namespace pw::metric {
+
+// A uint32_t counter for high-frequency events counted from several threads or
+// cores, such as packets or bytes. Each thread or core increments its own
+// shard, and each shard is on its own cache line, so increments do not bounce
+// a shared cache line between cores. The shards are only summed when the
+// counter is read: the total is a regular uint32_t metric, which Aggregate()
+// updates. Dump() and MetricService read the total as of the last Aggregate(),
+// so call Aggregate() before reading metrics, such as from the code that dumps
+// them or from a periodic timer.
+//
+// Increments are atomic, so a shard can be shared by a thread and interrupts,
+// but an increment is cheapest when each shard has one writer. The shard is
+// chosen by the caller, typically the current core or thread index.
+//
+// kShardAlignment should be the cache line size of the target. On targets
+// without a data cache, 4 avoids the padding.
+//
+// Size: kShardAlignment bytes per shard, plus the 12-byte total metric padded
+// to kShardAlignment.
+//
+// Example:
+//
+//   PW_METRIC_GROUP(radio_metrics, "radio");
+//
+//   constexpr Token kRxPacketsName =
+//       PW_TOKENIZE_STRING_DOMAIN("metrics", "rx_packets");
+//   ShardedCounter<kNumCores> rx_packets(kRxPacketsName,
+//                                        radio_metrics.metrics());
+//
+//   void OnPacket() { rx_packets.Increment(CurrentCore()); }
+//
+//   void DumpMetrics() {
+//     rx_packets.Aggregate();
+//     radio_metrics.Dump();
+//   }
+template <size_t kShards, size_t kShardAlignment = 64>
+class ShardedCounter {
+ public:
+  static_assert(kShards > 0);
+  static_assert(kShardAlignment >= sizeof(uint32_t) &&
+                    (kShardAlignment & (kShardAlignment - 1)) == 0,
+                "The shard alignment must be a power of two");
+
+  explicit ShardedCounter(Token name) : total_(name, 0u) {}
+  ShardedCounter(Token name, IntrusiveList<Metric>& metrics)
+      : total_(name, 0u, metrics) {}
+
+  // Disallow copy and assign.
+  ShardedCounter(ShardedCounter const&) = delete;
+  void operator=(const ShardedCounter&) = delete;
+
+  void Increment(size_t shard, uint32_t amount = 1u) {
+    PW_DCHECK_UINT_LT(shard, kShards);
+    __atomic_fetch_add(&shards_[shard].count, amount, __ATOMIC_RELAXED);
+  }
+
+  // Sums the shards. The sum wraps on overflow, like other metrics.
+  uint32_t value() const {
+    uint32_t sum = 0;
+    for (const Shard& shard : shards_) {
+      sum += __atomic_load_n(&shard.count, __ATOMIC_RELAXED);
+    }
+    return sum;
+  }
+
+  // Copies the sum of the shards into the counter's metric.
+  void Aggregate() { total_.Set(value()); }
+
+  // The metric holding the total as of the last Aggregate().
+  const TypedMetric<uint32_t>& metric() const { return total_; }
+
+ private:
+  struct alignas(kShardAlignment) Shard {
+    uint32_t count = 0;
+  };
+
+  std::array<Shard, kShards> shards_;
+  TypedMetric<uint32_t> total_;
+};
+
+}  // namespace pw::metric
@@ -0,0 +1,22 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// PW_METRIC_ATOMIC_UPDATES makes Increment() and Set() atomic for every metric,
+// so metrics can be updated from multiple threads, cores, or interrupts without
+// a lock. When disabled, updates are plain read-modify-writes, and individual
+// metrics can use AtomicIncrement() and AtomicSet() instead.
+#ifndef PW_METRIC_ATOMIC_UPDATES
+#define PW_METRIC_ATOMIC_UPDATES 0
+#endif  // PW_METRIC_ATOMIC_UPDATES
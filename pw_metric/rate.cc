@@ -0,0 +1,96 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_metric/rate.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::metric::internal {
+namespace {
+
+constexpr Token kRateName = PW_TOKENIZE_STRING_DOMAIN("metrics", "rate");
+constexpr Token kPeakRateName =
+    PW_TOKENIZE_STRING_DOMAIN("metrics", "peak_rate");
+
+}  // namespace
+
+RateBase::RateBase(Token name,
+                   chrono::SystemClock::duration interval,
+                   std::span<uint32_t> counts)
+    : group_(name),
+      rate_(kRateName, 0u),
+      peak_(kPeakRateName, 0u),
+      interval_(interval),
+      counts_(counts) {
+  // Groups list metrics in reverse order of adding.
+  group_.Add(peak_);
+  group_.Add(rate_);
+  Reset();
+}
+
+RateBase::RateBase(Token name,
+                   chrono::SystemClock::duration interval,
+                   std::span<uint32_t> counts,
+                   IntrusiveList<Group>& groups)
+    : RateBase(name, interval, counts) {
+  groups.push_front(group_);
+}
+
+void RateBase::Reset() {
+  // The first interval starts at the first Record() or Update().
+  interval_end_ = chrono::SystemClock::time_point::min();
+  current_count_ = 0;
+  std::fill(counts_.begin(), counts_.end(), 0u);
+  next_ = 0;
+  window_sum_ = 0;
+  rate_.Set(0u);
+  peak_.Set(0u);
+}
+
+void RateBase::Push(uint32_t count) {
+  window_sum_ -= counts_[next_];
+  counts_[next_] = count;
+  window_sum_ += count;
+  next_ = (next_ + 1 == counts_.size()) ? 0 : next_ + 1;
+}
+
+void RateBase::EndIntervals(chrono::SystemClock::time_point now) {
+  if (interval_end_ == chrono::SystemClock::time_point::min()) {
+    interval_end_ = now + interval_;
+    return;
+  }
+
+  // The current interval ended, and possibly more without any events.
+  const int64_t ended = (now - interval_end_) / interval_ + 1;
+
+  Push(current_count_);
+  if (current_count_ > peak_.value()) {
+    peak_.Set(current_count_);
+  }
+  current_count_ = 0;
+
+  // Idle intervals beyond the window size would only push more zeros.
+  const size_t idle = std::min(static_cast<size_t>(ended - 1), counts_.size());
+  for (size_t i = 0; i < idle; ++i) {
+    Push(0u);
+  }
+
+  interval_end_ += interval_ * ended;
+  rate_.Set(window_sum_ / counts_.size());
+}
+
+}  // namespace pw::metric::internal
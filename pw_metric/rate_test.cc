@@ -0,0 +1,128 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_metric/rate.h"
+
+#include <chrono>
+
+#include "gtest/gtest.h"
+
+namespace pw::metric {
+namespace {
+
+using chrono::SystemClock;
+
+constexpr SystemClock::duration kInterval =
+    std::chrono::duration_cast<SystemClock::duration>(
+        std::chrono::milliseconds(100));
+
+// A time a number of intervals after an arbitrary start.
+SystemClock::time_point At(int intervals) {
+  return SystemClock::time_point(std::chrono::seconds(1000)) +
+         kInterval * intervals;
+}
+
+TEST(Rate, NoEvents) {
+  Rate<4> rate(0x1234, kInterval);
+  rate.Update(At(0));
+  rate.Update(At(10));
+  EXPECT_EQ(0u, rate.rate());
+  EXPECT_EQ(0u, rate.peak());
+}
+
+TEST(Rate, RateIsMeanOfWindow) {
+  Rate<4> rate(0x1234, kInterval);
+
+  // 4, 8, 0, and 4 events in four intervals.
+  rate.Record(4, At(0));
+  rate.Record(8, At(1));
+  rate.Update(At(3));
+  EXPECT_EQ(3u, rate.rate());  // (4 + 8) / 4
+  rate.Record(4, At(3));
+
+  // The rate only changes when an interval ends.
+  EXPECT_EQ(3u, rate.rate());
+  rate.Update(At(4));
+  EXPECT_EQ(4u, rate.rate());  // (4 + 8 + 0 + 4) / 4
+  EXPECT_EQ(8u, rate.peak());
+
+  // The first interval leaves the window.
+  rate.Update(At(5));
+  EXPECT_EQ(3u, rate.rate());  // (8 + 0 + 4 + 0) / 4
+}
+
+TEST(Rate, PeakKeepsShortBurst) {
+  Rate<4> rate(0x1234, kInterval);
+  rate.Record(1, At(0));
+  rate.Record(100, At(1));
+  rate.Record(1, At(2));
+  rate.Update(At(20));
+
+  // The burst has left the window, but the peak remains.
+  EXPECT_EQ(0u, rate.rate());
+  EXPECT_EQ(100u, rate.peak());
+}
+
+TEST(Rate, EventsWithinAnIntervalAreSummed) {
+  Rate<2> rate(0x1234, kInterval);
+  rate.Record(1, At(0));
+  rate.Record(2, At(0) + kInterval / 2);
+  rate.Record(3, At(1) - SystemClock::duration(1));
+  rate.Update(At(1));
+  EXPECT_EQ(6u, rate.peak());
+  EXPECT_EQ(3u, rate.rate());
+}
+
+TEST(Rate, LongIdle_ClearsWindow) {
+  Rate<3> rate(0x1234, kInterval);
+  for (int i = 0; i < 3; ++i) {
+    rate.Record(9, At(i));
+  }
+  rate.Update(At(3));
+  EXPECT_EQ(9u, rate.rate());
+
+  rate.Record(3, At(1000));
+  EXPECT_EQ(0u, rate.rate());
+  rate.Update(At(1001));
+  EXPECT_EQ(1u, rate.rate());
+}
+
+TEST(Rate, Reset) {
+  Rate<2> rate(0x1234, kInterval);
+  rate.Record(5, At(0));
+  rate.Update(At(1));
+  EXPECT_EQ(5u, rate.peak());
+
+  rate.Reset();
+  EXPECT_EQ(0u, rate.rate());
+  EXPECT_EQ(0u, rate.peak());
+
+  // Intervals restart at the next event.
+  rate.Record(2, At(7) + kInterval / 2);
+  rate.Update(At(8));
+  EXPECT_EQ(0u, rate.peak());
+  rate.Update(At(8) + kInterval / 2);
+  EXPECT_EQ(2u, rate.peak());
+}
+
+TEST(Rate, IsAGroupOfMetrics) {
+  PW_METRIC_GROUP(root, "/");
+  Rate<2> rate(0x1234, kInterval, root.children());
+  EXPECT_EQ(&rate.group(), &root.children().front());
+  EXPECT_EQ(0x1234u, rate.group().name());
+  EXPECT_EQ(2u, rate.group().metrics().size());
+}
+
+}  // namespace
+}  // namespace pw::metric
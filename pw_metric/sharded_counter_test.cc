@@ -0,0 +1,75 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_metric/sharded_counter.h"
+
+#include <limits>
+
+#include "gtest/gtest.h"
+
+namespace pw::metric {
+namespace {
+
+TEST(ShardedCounter, SumsShards) {
+  ShardedCounter<3> counter(0x1234);
+  EXPECT_EQ(counter.value(), 0u);
+
+  counter.Increment(0);
+  counter.Increment(1, 10u);
+  counter.Increment(2, 100u);
+  counter.Increment(1);
+  EXPECT_EQ(counter.value(), 112u);
+}
+
+TEST(ShardedCounter, SumWraps) {
+  ShardedCounter<2> counter(0x1234);
+  counter.Increment(0, std::numeric_limits<uint32_t>::max());
+  counter.Increment(1, 2u);
+  EXPECT_EQ(counter.value(), 1u);
+}
+
+TEST(ShardedCounter, ShardsArePadded) {
+  ShardedCounter<4> counter(0x1234);
+  EXPECT_GE(sizeof(counter), 4u * 64u);
+
+  ShardedCounter<4, 4> unpadded(0x5678);
+  EXPECT_LT(sizeof(unpadded), 64u);
+}
+
+TEST(ShardedCounter, Aggregate_UpdatesMetric) {
+  PW_METRIC_GROUP(group, "group");
+  ShardedCounter<2> counter(0x1234, group.metrics());
+  ASSERT_EQ(group.metrics().size(), 1u);
+  EXPECT_EQ(&group.metrics().front(), &counter.metric());
+  EXPECT_EQ(counter.metric().name(), 0x1234u);
+
+  counter.Increment(0, 3u);
+  counter.Increment(1, 4u);
+  EXPECT_EQ(counter.metric().value(), 0u);
+
+  counter.Aggregate();
+  EXPECT_EQ(counter.metric().value(), 7u);
+}
+
+TEST(ShardedCounter, Dump_DoesNotAggregate) {
+  PW_METRIC_GROUP(group, "group");
+  ShardedCounter<2> counter(0x1234, group.metrics());
+  counter.Increment(1, 5u);
+
+  group.Dump();
+  EXPECT_EQ(counter.metric().value(), 0u);
+}
+
+}  // namespace
+}  // namespace pw::metric
@@ -0,0 +1,403 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Benchmarks pw_protobuf against nanopb. Messages typical of those sent by
+// embedded devices (a log entry, a batch of metrics, and a nested
+// configuration) are encoded and decoded repeatedly with both libraries. Both
+// libraries encode from and decode into the same nanopb-generated structs, so
+// they do the same work.
+//
+// Each case is benchmarked with pw_unit_test's benchmark helper and named with
+// the size of the state each library needs besides the message struct and the
+// encoded buffer. Neither library allocates from the heap (this
+// assumes nanopb is built without PB_ENABLE_MALLOC). Stack use is best compared
+// with the compiler's -fstack-usage output for the functions in this file.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pb_decode.h"
+#include "pb_encode.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_protobuf_benchmark_protos/benchmark.pb.h"
+#include "pw_protobuf_benchmark_protos/benchmark.pwpb.h"
+#include "pw_status/try.h"
+#include "pw_unit_test/benchmark.h"
+
+namespace pw::protobuf::benchmark {
+namespace {
+
+using unit_test::BenchmarkState;
+
+constexpr size_t kMaxEncodedSize = 128;
+
+using NanopbLogEntry = pw_protobuf_benchmark_LogEntry;
+using NanopbMetricBatch = pw_protobuf_benchmark_MetricBatch;
+using NanopbDeviceConfig = pw_protobuf_benchmark_DeviceConfig;
+
+// The sensor's packed calibration values are nested two levels deep.
+using ConfigEncoder = NestedEncoder<2>;
+
+// Benchmarks one library's encoding or decoding of a message, which processes
+// encoded_size bytes per iteration.
+template <typename Function>
+void RunCase(const char* message_name,
+             const char* name,
+             size_t state_size,
+             size_t encoded_size,
+             Function&& function) {
+  char case_name[64];
+  std::snprintf(case_name,
+                sizeof(case_name),
+                "%s, %s (%zu B state)",
+                message_name,
+                name,
+                state_size);
+  unit_test::RunBenchmark(
+      case_name,
+      {.bytes_per_iteration = static_cast<uint32_t>(encoded_size)},
+      [&function](BenchmarkState& state) {
+        for (auto _ : state) {
+          function();
+        }
+      });
+}
+
+// Copies a decoded string into a nanopb char array, which is null-terminated.
+template <size_t kSize>
+Status CopyString(std::string_view value, char (&out)[kSize]) {
+  if (value.size() >= kSize) {
+    return Status::ResourceExhausted();
+  }
+  std::memcpy(out, value.data(), value.size());
+  out[value.size()] = '\0';
+  return OkStatus();
+}
+
+// Returns OK if the decoder stopped at the end of the message.
+Status EndStatus(Status next_status) {
+  return next_status.IsOutOfRange() ? OkStatus() : Status::DataLoss();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// pw_protobuf encoders and decoders for each message.
+
+Result<ConstByteSpan> Encode(const NanopbLogEntry& entry, Encoder& encoder) {
+  LogEntry::Encoder log(&encoder);
+  log.WriteMessage(
+      std::as_bytes(std::span(entry.message.bytes, entry.message.size)));
+  log.WriteLineLevel(entry.line_level);
+  log.WriteFlags(entry.flags);
+  log.WriteTimestamp(entry.timestamp);
+  log.WriteThread(entry.thread);
+  return encoder.Encode();
+}
+
+Status Decode(ConstByteSpan encoded, NanopbLogEntry& entry) {
+  entry = NanopbLogEntry pw_protobuf_benchmark_LogEntry_init_zero;
+  LogEntry::Decoder decoder(encoded);
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    switch (decoder.Field()) {
+      case LogEntry::Fields::MESSAGE: {
+        std::span<const std::byte> message;
+        PW_TRY(decoder.ReadMessage(&message));
+        if (message.size() > sizeof(entry.message.bytes)) {
+          return Status::ResourceExhausted();
+        }
+        std::memcpy(entry.message.bytes, message.data(), message.size());
+        entry.message.size = message.size();
+        break;
+      }
+      case LogEntry::Fields::LINE_LEVEL:
+        PW_TRY(decoder.ReadLineLevel(&entry.line_level));
+        break;
+      case LogEntry::Fields::FLAGS:
+        PW_TRY(decoder.ReadFlags(&entry.flags));
+        break;
+      case LogEntry::Fields::TIMESTAMP:
+        PW_TRY(decoder.ReadTimestamp(&entry.timestamp));
+        break;
+      case LogEntry::Fields::THREAD: {
+        std::string_view thread;
+        PW_TRY(decoder.ReadThread(&thread));
+        PW_TRY(CopyString(thread, entry.thread));
+        break;
+      }
+    }
+  }
+  return EndStatus(status);
+}
+
+Result<ConstByteSpan> Encode(const NanopbMetricBatch& batch,
+                             Encoder& encoder) {
+  MetricBatch::Encoder metrics(&encoder);
+  for (pb_size_t i = 0; i < batch.metrics_count; ++i) {
+    Metric::Encoder metric = metrics.GetMetricsEncoder();
+    metric.WriteToken(batch.metrics[i].token);
+    metric.WriteAsFloat(batch.metrics[i].as_float);
+    metric.WriteAsInt(batch.metrics[i].as_int);
+  }
+  return encoder.Encode();
+}
+
+Status Decode(ConstByteSpan encoded, pw_protobuf_benchmark_Metric& metric) {
+  metric = pw_protobuf_benchmark_Metric pw_protobuf_benchmark_Metric_init_zero;
+  Metric::Decoder decoder(encoded);
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    switch (decoder.Field()) {
+      case Metric::Fields::TOKEN:
+        PW_TRY(decoder.ReadToken(&metric.token));
+        break;
+      case Metric::Fields::AS_FLOAT:
+        PW_TRY(decoder.ReadAsFloat(&metric.as_float));
+        break;
+      case Metric::Fields::AS_INT:
+        PW_TRY(decoder.ReadAsInt(&metric.as_int));
+        break;
+    }
+  }
+  return EndStatus(status);
+}
+
+Status Decode(ConstByteSpan encoded, NanopbMetricBatch& batch) {
+  batch = NanopbMetricBatch pw_protobuf_benchmark_MetricBatch_init_zero;
+  MetricBatch::Decoder decoder(encoded);
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    if (decoder.Field() != MetricBatch::Fields::METRICS) {
+      continue;
+    }
+    if (batch.metrics_count == std::size(batch.metrics)) {
+      return Status::ResourceExhausted();
+    }
+    std::span<const std::byte> metric;
+    PW_TRY(decoder.ReadMetrics(&metric));
+    PW_TRY(Decode(metric, batch.metrics[batch.metrics_count++]));
+  }
+  return EndStatus(status);
+}
+
+Result<ConstByteSpan> Encode(const NanopbDeviceConfig& config,
+                             Encoder& encoder) {
+  DeviceConfig::Encoder device(&encoder);
+  device.WriteVersion(config.version);
+  for (pb_size_t i = 0; i < config.channels_count; ++i) {
+    DeviceConfig::Channel::Encoder channel = device.GetChannelsEncoder();
+    channel.WriteId(config.channels[i].id);
+    channel.WriteBaudRate(config.channels[i].baud_rate);
+    channel.WriteEnabled(config.channels[i].enabled);
+  }
+  if (config.has_sensor) {
+    DeviceConfig::Sensor::Encoder sensor = device.GetSensorEncoder();
+    sensor.WriteName(config.sensor.name);
+    sensor.WriteSampleRateHz(config.sensor.sample_rate_hz);
+    sensor.WriteCalibration(std::span<const float>(
+        config.sensor.calibration, config.sensor.calibration_count));
+  }
+  return encoder.Encode();
+}
+
+Status Decode(ConstByteSpan encoded,
+              pw_protobuf_benchmark_DeviceConfig_Channel& channel) {
+  DeviceConfig::Channel::Decoder decoder(encoded);
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    switch (decoder.Field()) {
+      case DeviceConfig::Channel::Fields::ID:
+        PW_TRY(decoder.ReadId(&channel.id));
+        break;
+      case DeviceConfig::Channel::Fields::BAUD_RATE:
+        PW_TRY(decoder.ReadBaudRate(&channel.baud_rate));
+        break;
+      case DeviceConfig::Channel::Fields::ENABLED:
+        PW_TRY(decoder.ReadEnabled(&channel.enabled));
+        break;
+    }
+  }
+  return EndStatus(status);
+}
+
+Status Decode(ConstByteSpan encoded,
+              pw_protobuf_benchmark_DeviceConfig_Sensor& sensor) {
+  DeviceConfig::Sensor::Decoder decoder(encoded);
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    switch (decoder.Field()) {
+      case DeviceConfig::Sensor::Fields::NAME: {
+        std::string_view name;
+        PW_TRY(decoder.ReadName(&name));
+        PW_TRY(CopyString(name, sensor.name));
+        break;
+      }
+      case DeviceConfig::Sensor::Fields::SAMPLE_RATE_HZ:
+        PW_TRY(decoder.ReadSampleRateHz(&sensor.sample_rate_hz));
+        break;
+      case DeviceConfig::Sensor::Fields::CALIBRATION: {
+        StatusWithSize result = decoder.ReadCalibration(sensor.calibration);
+        PW_TRY(result.status());
+        sensor.calibration_count = result.size();
+        break;
+      }
+    }
+  }
+  return EndStatus(status);
+}
+
+Status Decode(ConstByteSpan encoded, NanopbDeviceConfig& config) {
+  config = NanopbDeviceConfig pw_protobuf_benchmark_DeviceConfig_init_zero;
+  DeviceConfig::Decoder decoder(encoded);
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    std::span<const std::byte> nested;
+    switch (decoder.Field()) {
+      case DeviceConfig::Fields::VERSION:
+        PW_TRY(decoder.ReadVersion(&config.version));
+        break;
+      case DeviceConfig::Fields::CHANNELS:
+        if (config.channels_count == std::size(config.channels)) {
+          return Status::ResourceExhausted();
+        }
+        PW_TRY(decoder.ReadChannels(&nested));
+        PW_TRY(Decode(nested, config.channels[config.channels_count++]));
+        break;
+      case DeviceConfig::Fields::SENSOR:
+        PW_TRY(decoder.ReadSensor(&nested));
+        PW_TRY(Decode(nested, config.sensor));
+        config.has_sensor = true;
+        break;
+    }
+  }
+  return EndStatus(status);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The benchmark.
+
+// Encodes and decodes the message with both libraries, checks that they agree,
+// and benchmarks each.
+template <typename EncoderType, typename Message, typename Fields>
+void Benchmark(const char* name, const Message& message, Fields fields) {
+  std::byte pwpb_buffer[kMaxEncodedSize];
+  pb_byte_t nanopb_buffer[kMaxEncodedSize];
+
+  // Encode once with each library to check the results and to get the encoded
+  // message for the decoding benchmarks.
+  EncoderType encoder(pwpb_buffer);
+  Result<ConstByteSpan> pwpb_encoded = Encode(message, encoder);
+  ASSERT_EQ(OkStatus(), pwpb_encoded.status());
+
+  pb_ostream_t ostream = pb_ostream_from_buffer(nanopb_buffer, kMaxEncodedSize);
+  ASSERT_TRUE(pb_encode(&ostream, fields, &message));
+  const std::span<const std::byte> nanopb_encoded =
+      std::as_bytes(std::span(nanopb_buffer, ostream.bytes_written));
+
+  ASSERT_EQ(nanopb_encoded.size(), pwpb_encoded.value().size());
+  EXPECT_EQ(0,
+            std::memcmp(nanopb_encoded.data(),
+                        pwpb_encoded.value().data(),
+                        nanopb_encoded.size()));
+
+  // Decoding and re-encoding the message must reproduce it.
+  Message decoded;
+  ASSERT_EQ(OkStatus(), Decode(pwpb_encoded.value(), decoded));
+  std::byte reencoded_buffer[kMaxEncodedSize];
+  EncoderType reencoder(reencoded_buffer);
+  Result<ConstByteSpan> reencoded = Encode(decoded, reencoder);
+  ASSERT_EQ(OkStatus(), reencoded.status());
+  ASSERT_EQ(reencoded.value().size(), pwpb_encoded.value().size());
+  EXPECT_EQ(0,
+            std::memcmp(reencoded.value().data(),
+                        pwpb_encoded.value().data(),
+                        reencoded.value().size()));
+
+  const size_t size = nanopb_encoded.size();
+  RunCase(name, "pwpb encode", sizeof(EncoderType), size, [&] {
+    EncoderType pwpb_encoder(pwpb_buffer);
+    unit_test::DoNotOptimize(Encode(message, pwpb_encoder));
+  });
+  RunCase(name, "nanopb encode", sizeof(pb_ostream_t), size, [&] {
+    pb_ostream_t stream =
+        pb_ostream_from_buffer(nanopb_buffer, kMaxEncodedSize);
+    unit_test::DoNotOptimize(pb_encode(&stream, fields, &message));
+  });
+
+  RunCase(name, "pwpb decode", sizeof(protobuf::Decoder), size, [&] {
+    unit_test::DoNotOptimize(Decode(pwpb_encoded.value(), decoded));
+  });
+  RunCase(name, "nanopb decode", sizeof(pb_istream_t), size, [&] {
+    pb_istream_t stream =
+        pb_istream_from_buffer(nanopb_buffer, ostream.bytes_written);
+    unit_test::DoNotOptimize(pb_decode(&stream, fields, &decoded));
+  });
+}
+
+TEST(ProtobufBenchmark, LogEntry) {
+  NanopbLogEntry entry = pw_protobuf_benchmark_LogEntry_init_zero;
+  constexpr uint8_t kTokenizedMessage[] = {
+      0x8f, 0x3a, 0x21, 0x7c, 0x04, 0xd2, 0x09, 0x06, 's', 'e', 'n', 's', 'o'};
+  std::memcpy(
+      entry.message.bytes, kTokenizedMessage, sizeof(kTokenizedMessage));
+  entry.message.size = sizeof(kTokenizedMessage);
+  entry.line_level = (123 << 3) | 2;
+  entry.flags = 1;
+  entry.timestamp = 1234567;
+  std::strcpy(entry.thread, "sensors");
+
+  Benchmark<NestedEncoder<>>(
+      "LogEntry", entry, pw_protobuf_benchmark_LogEntry_fields);
+}
+
+TEST(ProtobufBenchmark, MetricBatch) {
+  NanopbMetricBatch batch = pw_protobuf_benchmark_MetricBatch_init_zero;
+  batch.metrics_count = std::size(batch.metrics);
+  for (pb_size_t i = 0; i < batch.metrics_count; ++i) {
+    batch.metrics[i].token = 0x9e3779b9u * (i + 1);
+    batch.metrics[i].as_float = 1.5f * (i + 1);
+    batch.metrics[i].as_int = 100 * (i + 1);
+  }
+
+  Benchmark<NestedEncoder<>>(
+      "MetricBatch", batch, pw_protobuf_benchmark_MetricBatch_fields);
+}
+
+TEST(ProtobufBenchmark, DeviceConfig) {
+  NanopbDeviceConfig config = pw_protobuf_benchmark_DeviceConfig_init_zero;
+  config.version = 3;
+  config.channels_count = std::size(config.channels);
+  for (pb_size_t i = 0; i < config.channels_count; ++i) {
+    config.channels[i].id = i + 1;
+    config.channels[i].baud_rate = 115200;
+    config.channels[i].enabled = true;
+  }
+  config.has_sensor = true;
+  std::strcpy(config.sensor.name, "imu");
+  config.sensor.sample_rate_hz = 400;
+  config.sensor.calibration_count = std::size(config.sensor.calibration);
+  for (pb_size_t i = 0; i < config.sensor.calibration_count; ++i) {
+    config.sensor.calibration[i] = 0.25f * (i + 1);
+  }
+
+  Benchmark<ConfigEncoder>(
+      "DeviceConfig", config, pw_protobuf_benchmark_DeviceConfig_fields);
+}
+
+}  // namespace
+}  // namespace pw::protobuf::benchmark
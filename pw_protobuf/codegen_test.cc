@@ -314,5 +314,146 @@ TEST(Codegen, NonPigweedPackage) {
   EXPECT_EQ(encoder.Encode().status(), OkStatus());
 }
 
+TEST(CodegenDecoder, DispatchesOnFields) {
+  std::byte encode_buffer[64];
+  NestedEncoder<1, 3> encoder(encode_buffer);
+
+  Pigweed::Encoder pigweed(&encoder);
+  pigweed.WriteMagicNumber(73);
+  pigweed.WriteErrorMessage("not a typewriter");
+  pigweed.WriteBin(Pigweed::Protobuf::Binary::ZERO);
+  {
+    Pigweed::Pigweed::Encoder pigweed_pigweed = pigweed.GetPigweedEncoder();
+    pigweed_pigweed.WriteStatus(Bool::FILE_NOT_FOUND);
+  }
+
+  Result encoded = encoder.Encode();
+  ASSERT_EQ(encoded.status(), OkStatus());
+
+  uint32_t magic_number = 0;
+  std::string_view error_message;
+  Pigweed::Protobuf::Binary bin = Pigweed::Protobuf::Binary::ONE;
+  Bool status = Bool::TRUE;
+
+  Pigweed::Decoder decoder(encoded.value());
+  while (decoder.Next().ok()) {
+    switch (decoder.Field()) {
+      case Pigweed::Fields::MAGIC_NUMBER:
+        EXPECT_EQ(decoder.ReadMagicNumber(&magic_number), OkStatus());
+        break;
+      case Pigweed::Fields::ERROR_MESSAGE:
+        EXPECT_EQ(decoder.ReadErrorMessage(&error_message), OkStatus());
+        break;
+      case Pigweed::Fields::BIN:
+        EXPECT_EQ(decoder.ReadBin(&bin), OkStatus());
+        break;
+      case Pigweed::Fields::PIGWEED: {
+        std::span<const std::byte> nested;
+        ASSERT_EQ(decoder.ReadPigweed(&nested), OkStatus());
+        Pigweed::Pigweed::Decoder nested_decoder(nested);
+        ASSERT_EQ(nested_decoder.Next(), OkStatus());
+        ASSERT_EQ(nested_decoder.Field(), Pigweed::Pigweed::Fields::STATUS);
+        EXPECT_EQ(nested_decoder.ReadStatus(&status), OkStatus());
+        break;
+      }
+      default:
+        ADD_FAILURE();
+        break;
+    }
+  }
+
+  EXPECT_EQ(magic_number, 73u);
+  EXPECT_EQ(error_message, "not a typewriter");
+  EXPECT_EQ(bin, Pigweed::Protobuf::Binary::ZERO);
+  EXPECT_EQ(status, Bool::FILE_NOT_FOUND);
+}
+
+TEST(CodegenDecoder, PackedScalars_ReadInBulk) {
+  std::byte encode_buffer[64];
+  NestedEncoder encoder(encode_buffer);
+
+  RepeatedTest::Encoder repeated_test(&encoder);
+  constexpr uint32_t uint32s[] = {0, 16, 300, 48};
+  constexpr double doubles[] = {1.5, -2.25};
+  repeated_test.WriteUint32s(uint32s);
+  repeated_test.WriteDoubles(doubles);
+  repeated_test.WriteSint32s(-7);
+
+  Result encoded = encoder.Encode();
+  ASSERT_EQ(encoded.status(), OkStatus());
+
+  RepeatedTest::Decoder decoder(encoded.value());
+
+  uint32_t decoded_uint32s[8] = {};
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  ASSERT_EQ(decoder.Field(), RepeatedTest::Fields::UINT32S);
+  StatusWithSize result = decoder.ReadUint32s(decoded_uint32s);
+  ASSERT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result.size(), 4u);
+  EXPECT_EQ(decoded_uint32s[2], 300u);
+  EXPECT_EQ(decoded_uint32s[3], 48u);
+
+  double decoded_doubles[2] = {};
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  ASSERT_EQ(decoder.Field(), RepeatedTest::Fields::DOUBLES);
+  result = decoder.ReadDoubles(decoded_doubles);
+  ASSERT_EQ(result.size(), 2u);
+  EXPECT_EQ(decoded_doubles[0], 1.5);
+  EXPECT_EQ(decoded_doubles[1], -2.25);
+
+  // A non-packed value can be read into an array, too.
+  int32_t decoded_sint32s[2] = {};
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  ASSERT_EQ(decoder.Field(), RepeatedTest::Fields::SINT32S);
+  result = decoder.ReadSint32s(decoded_sint32s);
+  ASSERT_EQ(result.size(), 1u);
+  EXPECT_EQ(decoded_sint32s[0], -7);
+
+  EXPECT_EQ(decoder.Next(), Status::OutOfRange());
+}
+
+TEST(CodegenDecoder, StringsAndBytes_ReadAsViewsIntoBuffer) {
+  std::byte encode_buffer[64];
+  NestedEncoder encoder(encode_buffer);
+
+  Foo::Encoder foo(&encoder);
+  foo.WriteStr("not copied");
+  {
+    Bar::Encoder bar = foo.GetBarEncoder();
+    constexpr std::byte kData[] = {std::byte{1}, std::byte{2}, std::byte{3}};
+    bar.WriteData(kData);
+  }
+
+  Result encoded = encoder.Encode();
+  ASSERT_EQ(encoded.status(), OkStatus());
+  const std::byte* const begin = encoded.value().data();
+  const std::byte* const end = begin + encoded.value().size();
+  auto in_buffer = [begin, end](const void* data, size_t size) {
+    const std::byte* bytes = static_cast<const std::byte*>(data);
+    return bytes >= begin && bytes + size <= end;
+  };
+
+  Foo::Decoder decoder(encoded.value());
+
+  std::string_view str;
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  ASSERT_EQ(decoder.ReadStr(&str), OkStatus());
+  EXPECT_EQ(str, "not copied");
+  EXPECT_TRUE(in_buffer(str.data(), str.size()));
+
+  std::span<const std::byte> bar_bytes;
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  ASSERT_EQ(decoder.ReadBar(&bar_bytes), OkStatus());
+  EXPECT_TRUE(in_buffer(bar_bytes.data(), bar_bytes.size()));
+
+  Bar::Decoder bar_decoder(bar_bytes);
+  std::span<const std::byte> data;
+  ASSERT_EQ(bar_decoder.Next(), OkStatus());
+  ASSERT_EQ(bar_decoder.ReadData(&data), OkStatus());
+  ASSERT_EQ(data.size(), 3u);
+  EXPECT_EQ(data[2], std::byte{3});
+  EXPECT_TRUE(in_buffer(data.data(), data.size()));
+}
+
 }  // namespace
 }  // namespace pw::protobuf
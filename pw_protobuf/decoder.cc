@@ -14,11 +14,89 @@
 
 #include "pw_protobuf/decoder.h"
 
+#include <algorithm>
 #include <cstring>
 
 #include "pw_varint/varint.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif  // defined(__SSE2__)
+
 namespace pw::protobuf {
+namespace {
+
+// Stores a decoded varint as a 32- or 64-bit integer. Values are truncated to
+// 32 bits, as negative int32 values are encoded as 64-bit varints.
+void StoreVarint(uint64_t value, bool zigzag, std::byte* out, size_t size) {
+  if (zigzag) {
+    value = static_cast<uint64_t>(varint::ZigZagDecode(value));
+  }
+  if (size == sizeof(uint32_t)) {
+    const uint32_t value_32 = static_cast<uint32_t>(value);
+    std::memcpy(out, &value_32, sizeof(value_32));
+  } else {
+    std::memcpy(out, &value, sizeof(value));
+  }
+}
+
+constexpr uint64_t kContinuationBits = 0x8080808080808080u;
+
+// Returns the number of bytes at the start of data with their continuation bit
+// clear, each of which is a complete one-byte varint. Checks 16 bytes at a time
+// with SSE2 and 8 bytes at a time on other little-endian targets.
+size_t OneByteVarintRun(const std::byte* data, size_t size) {
+  size_t run = 0;
+#if defined(__SSE2__)
+  while (size - run >= sizeof(__m128i)) {
+    const int continuation = _mm_movemask_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + run)));
+    if (continuation != 0) {
+      return run + __builtin_ctz(continuation);
+    }
+    run += sizeof(__m128i);
+  }
+#endif  // defined(__SSE2__)
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  while (size - run >= sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + run, sizeof(word));
+    const uint64_t continuation = word & kContinuationBits;
+    if (continuation != 0) {
+      return run + __builtin_ctzll(continuation) / 8;
+    }
+    run += sizeof(word);
+  }
+#endif  // __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  while (run < size && (data[run] & std::byte{0x80}) == std::byte{0}) {
+    run += 1;
+  }
+  return run;
+}
+
+// Counts the varints in data, which end with the only byte in each varint that
+// has its continuation bit clear.
+size_t CountVarints(const std::byte* data, size_t size) {
+  size_t continuation_bytes = 0;
+  size_t i = 0;
+#if defined(__SSE2__)
+  for (; size - i >= sizeof(__m128i); i += sizeof(__m128i)) {
+    continuation_bytes += __builtin_popcount(_mm_movemask_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i))));
+  }
+#endif  // defined(__SSE2__)
+  for (; size - i >= sizeof(uint64_t); i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    continuation_bytes += __builtin_popcountll(word & kContinuationBits);
+  }
+  for (; i < size; ++i) {
+    continuation_bytes += (data[i] & std::byte{0x80}) != std::byte{0} ? 1 : 0;
+  }
+  return size - continuation_bytes;
+}
+
+}  // namespace
 
 Status Decoder::Next() {
   if (!previous_field_consumed_) {
@@ -33,6 +111,72 @@ Status Decoder::Next() {
   return FieldSize() == 0 ? Status::DataLoss() : OkStatus();
 }
 
+Status Decoder::Next(FieldMask fields) {
+  if (!previous_field_consumed_) {
+    if (Status status = SkipField(); !status.ok()) {
+      return status;
+    }
+  }
+
+  while (!proto_.empty()) {
+    uint64_t key;
+    const size_t key_size = varint::Decode(proto_, &key);
+    if (key_size == 0) {
+      return Status::DataLoss();
+    }
+
+    if (fields.contains(key >> kFieldNumberShift)) {
+      previous_field_consumed_ = false;
+      return FieldSize() == 0 ? Status::DataLoss() : OkStatus();
+    }
+
+    // Find the end of the unwanted field with as little work as possible.
+    std::span<const std::byte> remainder = proto_.subspan(key_size);
+    size_t value_size = 0;
+    switch (static_cast<WireType>(key & kWireTypeMask)) {
+      case WireType::kVarint: {
+        // The varint ends at the first byte with its high bit clear.
+        const size_t limit =
+            std::min(remainder.size(), varint::kMaxVarint64SizeBytes);
+        while (value_size < limit &&
+               (remainder[value_size] & std::byte{0x80}) != std::byte{0}) {
+          value_size += 1;
+        }
+        if (value_size == limit) {
+          return Status::DataLoss();
+        }
+        value_size += 1;
+        break;
+      }
+
+      case WireType::kDelimited: {
+        uint64_t length;
+        const size_t length_size = varint::Decode(remainder, &length);
+        if (length_size == 0 || length > remainder.size() - length_size) {
+          return Status::DataLoss();
+        }
+        value_size = length_size + length;
+        break;
+      }
+
+      case WireType::kFixed32:
+        value_size = sizeof(uint32_t);
+        break;
+
+      case WireType::kFixed64:
+        value_size = sizeof(uint64_t);
+        break;
+    }
+
+    if (value_size > remainder.size()) {
+      return Status::DataLoss();
+    }
+    proto_ = remainder.subspan(value_size);
+  }
+
+  return Status::OutOfRange();
+}
+
 Status Decoder::SkipField() {
   if (proto_.empty()) {
     return Status::OutOfRange();
@@ -231,6 +375,108 @@ Status Decoder::ReadDelimited(std::span<const std::byte>* out) {
   return OkStatus();
 }
 
+WireType Decoder::CurrentWireType() const {
+  uint64_t key = 0;
+  varint::Decode(proto_, &key);
+  return static_cast<WireType>(key & kWireTypeMask);
+}
+
+StatusWithSize Decoder::ReadPackedVarints(ByteSpan out,
+                                          size_t element_size,
+                                          bool zigzag) {
+  const size_t capacity = out.size() / element_size;
+
+  if (CurrentWireType() == WireType::kVarint) {
+    if (capacity == 0) {
+      return StatusWithSize::ResourceExhausted();
+    }
+    uint64_t value = 0;
+    if (Status status = ReadVarint(&value); !status.ok()) {
+      return StatusWithSize(status, 0);
+    }
+    StoreVarint(value, zigzag, out.data(), element_size);
+    return StatusWithSize(1);
+  }
+
+  const std::span<const std::byte> original_proto = proto_;
+  std::span<const std::byte> packed;
+  if (Status status = ReadDelimited(&packed); !status.ok()) {
+    return StatusWithSize(status, 0);
+  }
+
+  const size_t count = CountVarints(packed.data(), packed.size());
+  if (!packed.empty() && (packed.back() & std::byte{0x80}) != std::byte{0}) {
+    return StatusWithSize::DataLoss();
+  }
+  if (count > capacity) {
+    proto_ = original_proto;
+    previous_field_consumed_ = false;
+    return StatusWithSize::ResourceExhausted();
+  }
+
+  std::byte* next = out.data();
+  size_t i = 0;
+  while (true) {
+    // Most values in packed fields are small, so find runs of one-byte varints
+    // several bytes at a time and store them without decoding each one.
+    const size_t run = OneByteVarintRun(packed.data() + i, packed.size() - i);
+    for (size_t end = i + run; i < end; ++i) {
+      StoreVarint(static_cast<uint64_t>(packed[i]), zigzag, next, element_size);
+      next += element_size;
+    }
+    if (i == packed.size()) {
+      break;
+    }
+
+    uint64_t value;
+    const size_t bytes_read = varint::Decode(packed.subspan(i), &value);
+    if (bytes_read == 0) {
+      return StatusWithSize::DataLoss();
+    }
+    i += bytes_read;
+    StoreVarint(value, zigzag, next, element_size);
+    next += element_size;
+  }
+  return StatusWithSize(count);
+}
+
+StatusWithSize Decoder::ReadPackedFixed(ByteSpan out, size_t element_size) {
+  const size_t capacity = out.size() / element_size;
+  const WireType non_packed_type = element_size == sizeof(uint32_t)
+                                       ? WireType::kFixed32
+                                       : WireType::kFixed64;
+
+  if (CurrentWireType() == non_packed_type) {
+    if (capacity == 0) {
+      return StatusWithSize::ResourceExhausted();
+    }
+    if (Status status = ReadFixed(out.data(), element_size); !status.ok()) {
+      return StatusWithSize(status, 0);
+    }
+    return StatusWithSize(1);
+  }
+
+  const std::span<const std::byte> original_proto = proto_;
+  std::span<const std::byte> packed;
+  if (Status status = ReadDelimited(&packed); !status.ok()) {
+    return StatusWithSize(status, 0);
+  }
+  if (packed.size() % element_size != 0) {
+    return StatusWithSize::DataLoss();
+  }
+
+  const size_t count = packed.size() / element_size;
+  if (count > capacity) {
+    proto_ = original_proto;
+    previous_field_consumed_ = false;
+    return StatusWithSize::ResourceExhausted();
+  }
+
+  // Fixed-size values are stored little-endian, so they can be copied directly.
+  std::memcpy(out.data(), packed.data(), packed.size());
+  return StatusWithSize(count);
+}
+
 Status CallbackDecoder::Decode(std::span<const std::byte> proto) {
   if (handler_ == nullptr || state_ != kReady) {
     return Status::FailedPrecondition();
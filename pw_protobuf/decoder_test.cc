@@ -16,6 +16,7 @@
 
 #include "gtest/gtest.h"
 #include "pw_preprocessor/util.h"
+#include "pw_varint/varint.h"
 
 namespace pw::protobuf {
 namespace {
@@ -156,6 +157,204 @@ TEST(Decoder, Decode_SkipsUnusedFields) {
   EXPECT_EQ(decoder.Next(), Status::OutOfRange());
 }
 
+TEST(Decoder, NextInMask_SkipsOtherFields) {
+  // clang-format off
+  uint8_t encoded_proto[] = {
+    // type=int32, k=1, v=300
+    0x08, 0xac, 0x02,
+    // type=string, k=2, v="skipped"
+    0x12, 0x07, 's', 'k', 'i', 'p', 'p', 'e', 'd',
+    // type=fixed32, k=3, v=0xdeadbeef
+    0x1d, 0xef, 0xbe, 0xad, 0xde,
+    // type=uint32, k=4, v=7
+    0x20, 0x07,
+    // type=double, k=5, v=1.0
+    0x29, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0, 0x3f,
+    // type=uint32, k=100, v=1
+    0xa0, 0x06, 0x01,
+    // type=uint32, k=4, v=8
+    0x20, 0x08,
+  };
+  // clang-format on
+
+  constexpr FieldMask kFields(3, 4);
+  Decoder decoder(std::as_bytes(std::span(encoded_proto)));
+
+  uint32_t value = 0;
+  ASSERT_EQ(decoder.Next(kFields), OkStatus());
+  EXPECT_EQ(decoder.FieldNumber(), 3u);
+  ASSERT_EQ(decoder.Next(kFields), OkStatus());
+  EXPECT_EQ(decoder.FieldNumber(), 4u);
+  ASSERT_EQ(decoder.ReadUint32(&value), OkStatus());
+  EXPECT_EQ(value, 7u);
+  ASSERT_EQ(decoder.Next(kFields), OkStatus());
+  EXPECT_EQ(decoder.FieldNumber(), 4u);
+  ASSERT_EQ(decoder.ReadUint32(&value), OkStatus());
+  EXPECT_EQ(value, 8u);
+  EXPECT_EQ(decoder.Next(kFields), Status::OutOfRange());
+}
+
+TEST(Decoder, NextInMask_LargeFieldNumbers) {
+  constexpr FieldMask kFields(1, 100);
+  static_assert(kFields.contains(1));
+  static_assert(!kFields.contains(2));
+  // Every field above 63 is in the mask if any is.
+  static_assert(kFields.contains(100));
+  static_assert(kFields.contains(64));
+  static_assert(!FieldMask(1).contains(100));
+}
+
+TEST(Decoder, NextInMask_TruncatedSkippedField) {
+  // The length of field 2 runs past the end of the message.
+  uint8_t encoded_proto[] = {0x12, 0x05, 0x00, 0x00, 0x18, 0x01};
+  Decoder decoder(std::as_bytes(std::span(encoded_proto)));
+  EXPECT_EQ(decoder.Next(FieldMask(3)), Status::DataLoss());
+
+  // A skipped varint with no final byte.
+  uint8_t bad_varint[] = {0x10, 0x80, 0x80};
+  decoder.Reset(std::as_bytes(std::span(bad_varint)));
+  EXPECT_EQ(decoder.Next(FieldMask(3)), Status::DataLoss());
+}
+
+TEST(Decoder, ReadPackedVarints) {
+  // clang-format off
+  uint8_t encoded_proto[] = {
+    // type=repeated uint32, k=1, v={0, 50, 100, 150, 200}
+    0x0a, 0x07, 0x00, 0x32, 0x64, 0x96, 0x01, 0xc8, 0x01,
+    // type=repeated sint32, k=2, v={-100, -1, 0, 25}
+    0x12, 0x05, 0xc7, 0x01, 0x01, 0x00, 0x32,
+    // type=repeated int64, k=3, v={-1} (10-byte varint)
+    0x1a, 0x0a, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01,
+    // type=repeated uint32, k=1, v=300 (not packed)
+    0x08, 0xac, 0x02,
+  };
+  // clang-format on
+
+  Decoder decoder(std::as_bytes(std::span(encoded_proto)));
+
+  uint32_t uint32s[8] = {};
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  StatusWithSize result = decoder.ReadPackedUint32(uint32s);
+  EXPECT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result.size(), 5u);
+  EXPECT_EQ(uint32s[0], 0u);
+  EXPECT_EQ(uint32s[1], 50u);
+  EXPECT_EQ(uint32s[3], 150u);
+  EXPECT_EQ(uint32s[4], 200u);
+
+  int32_t sint32s[4] = {};
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  result = decoder.ReadPackedSint32(sint32s);
+  EXPECT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result.size(), 4u);
+  EXPECT_EQ(sint32s[0], -100);
+  EXPECT_EQ(sint32s[1], -1);
+  EXPECT_EQ(sint32s[2], 0);
+  EXPECT_EQ(sint32s[3], 25);
+
+  int64_t int64s[1] = {};
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  result = decoder.ReadPackedInt64(int64s);
+  EXPECT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result.size(), 1u);
+  EXPECT_EQ(int64s[0], -1);
+
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  result = decoder.ReadPackedUint32(uint32s);
+  EXPECT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result.size(), 1u);
+  EXPECT_EQ(uint32s[0], 300u);
+
+  EXPECT_EQ(decoder.Next(), Status::OutOfRange());
+}
+
+TEST(Decoder, ReadPackedVarints_TooSmall_LeavesFieldUnread) {
+  uint8_t encoded_proto[] = {0x0a, 0x03, 0x01, 0x02, 0x03, 0x10, 0x05};
+  Decoder decoder(std::as_bytes(std::span(encoded_proto)));
+
+  uint32_t values[2] = {};
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  EXPECT_EQ(decoder.ReadPackedUint32(values).status(),
+            Status::ResourceExhausted());
+
+  // The field can be read again with a larger buffer, or skipped.
+  uint32_t more_values[3] = {};
+  EXPECT_EQ(decoder.ReadPackedUint32(more_values).size(), 3u);
+  EXPECT_EQ(more_values[2], 3u);
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  EXPECT_EQ(decoder.FieldNumber(), 2u);
+}
+
+TEST(Decoder, ReadPackedVarints_LongRunsOfSmallValues) {
+  // Runs of one-byte varints of various lengths, separated by multi-byte
+  // varints, so that runs start and end at every offset within a word.
+  uint32_t expected[96];
+  for (uint32_t i = 0; i < std::size(expected); ++i) {
+    expected[i] = (i % 7 == 6 || i % 19 == 18) ? 128 + i : i;
+  }
+
+  std::byte encoded_proto[2 + sizeof(expected) * 2];
+  size_t size = 2;
+  for (uint32_t value : expected) {
+    size += varint::Encode(value, std::span(encoded_proto).subspan(size));
+  }
+  ASSERT_LT(size - 2, 128u);
+  encoded_proto[0] = std::byte{0x0a};
+  encoded_proto[1] = std::byte(size - 2);
+
+  Decoder decoder(std::span(encoded_proto, size));
+  uint32_t values[std::size(expected)] = {};
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  StatusWithSize result = decoder.ReadPackedUint32(values);
+  ASSERT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result.size(), std::size(expected));
+  for (size_t i = 0; i < std::size(expected); ++i) {
+    EXPECT_EQ(values[i], expected[i]);
+  }
+}
+
+TEST(Decoder, ReadPackedVarints_Truncated_DataLoss) {
+  uint8_t encoded_proto[] = {0x0a, 0x02, 0x01, 0x82};
+  Decoder decoder(std::as_bytes(std::span(encoded_proto)));
+
+  uint32_t values[4] = {};
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  EXPECT_EQ(decoder.ReadPackedUint32(values).status(), Status::DataLoss());
+}
+
+TEST(Decoder, ReadPackedFixed) {
+  // clang-format off
+  uint8_t encoded_proto[] = {
+    // type=repeated fixed32, k=1, v={0, 0xdeadbeef}
+    0x0a, 0x08, 0x00, 0x00, 0x00, 0x00, 0xef, 0xbe, 0xad, 0xde,
+    // type=repeated double, k=2, v=3.14159 (not packed)
+    0x11, 0x6e, 0x86, 0x1b, 0xf0, 0xf9, 0x21, 0x09, 0x40,
+    // type=repeated fixed32, k=3, length not a multiple of 4
+    0x1a, 0x03, 0x00, 0x00, 0x00,
+  };
+  // clang-format on
+
+  Decoder decoder(std::as_bytes(std::span(encoded_proto)));
+
+  uint32_t fixed32s[2] = {};
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  StatusWithSize result = decoder.ReadPackedFixed32(fixed32s);
+  EXPECT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result.size(), 2u);
+  EXPECT_EQ(fixed32s[0], 0u);
+  EXPECT_EQ(fixed32s[1], 0xdeadbeef);
+
+  double doubles[4] = {};
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  result = decoder.ReadPackedDouble(doubles);
+  EXPECT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result.size(), 1u);
+  EXPECT_EQ(doubles[0], 3.14159);
+
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  EXPECT_EQ(decoder.ReadPackedFixed32(fixed32s).status(), Status::DataLoss());
+}
+
 TEST(CallbackDecoder, Decode) {
   CallbackDecoder decoder;
   TestDecodeHandler handler;
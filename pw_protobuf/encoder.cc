@@ -108,6 +108,37 @@ Status Encoder::Push(uint32_t field_number) {
   return OkStatus();
 }
 
+Status Encoder::Push(uint32_t field_number, size_t size) {
+  if (!encode_status_.ok()) {
+    return encode_status_;
+  }
+
+  if (depth_ == blob_stack_.size() || depth_ == sizeof(sized_levels_) * 8) {
+    encode_status_ = Status::ResourceExhausted();
+    return encode_status_;
+  }
+
+  // Write the key and the final length of the nested field.
+  std::byte* original_cursor = cursor_;
+  WriteFieldKey(field_number, WireType::kDelimited);
+  if (Status status = WriteVarint(size); !status.ok()) {
+    return status;
+  }
+
+  if (size > RemainingSize()) {
+    encode_status_ = Status::ResourceExhausted();
+    return encode_status_;
+  }
+
+  // The parent's size includes the nested message up front, so writes to the
+  // nested message don't update it.
+  IncreaseParentSize(cursor_ - original_cursor + size);
+
+  sized_levels_ |= uint32_t(1) << depth_;
+  blob_stack_[depth_++] = reinterpret_cast<SizeType*>(cursor_ + size);
+  return OkStatus();
+}
+
 Status Encoder::Pop() {
   if (!encode_status_.ok()) {
     return encode_status_;
@@ -118,6 +149,19 @@ Status Encoder::Pop() {
     return encode_status_;
   }
 
+  if (IsSizedLevel(depth_ - 1)) {
+    --depth_;
+    sized_levels_ &= ~(uint32_t(1) << depth_);
+
+    // The length has already been written, so the nested message must end
+    // exactly where it said it would.
+    if (cursor_ != reinterpret_cast<std::byte*>(blob_stack_[depth_])) {
+      encode_status_ = Status::InvalidArgument();
+      return encode_status_;
+    }
+    return OkStatus();
+  }
+
   // Update the parent's size with how much total space the child will take
   // after its size field is varint encoded.
   SizeType child_size = *blob_stack_[--depth_];
@@ -15,6 +15,7 @@
 #include "pw_protobuf/encoder.h"
 
 #include "gtest/gtest.h"
+#include "pw_protobuf/serialized_size.h"
 
 namespace pw::protobuf {
 namespace {
@@ -219,6 +220,97 @@ TEST(Encoder, Nested) {
       0);
 }
 
+// Encodes a TestProto with nested messages, giving the size of the nested
+// messages up front if sized is true.
+Result<ConstByteSpan> EncodeNested(Encoder& encoder, bool sized) {
+  encoder.WriteUint32(kTestProtoMagicNumberField, 42);
+
+  constexpr size_t kPairSize =
+      SizeOfDelimitedField(kDoubleNestedProtoKeyField, 6) +
+      SizeOfDelimitedField(kDoubleNestedProtoValueField, 8);
+  constexpr size_t kNestedSize =
+      SizeOfDelimitedField(kNestedProtoHelloField, 5) +
+      SizeOfVarintField(kNestedProtoIdField, 999) +
+      SizeOfDelimitedField(kNestedProtoPairField, kPairSize);
+
+  sized ? encoder.Push(kTestProtoNestedField, kNestedSize)
+        : encoder.Push(kTestProtoNestedField);
+  encoder.WriteString(kNestedProtoHelloField, "world");
+  encoder.WriteUint32(kNestedProtoIdField, 999);
+
+  sized ? encoder.Push(kNestedProtoPairField, kPairSize)
+        : encoder.Push(kNestedProtoPairField);
+  encoder.WriteString(kDoubleNestedProtoKeyField, "device");
+  encoder.WriteString(kDoubleNestedProtoValueField, "left-soc");
+  encoder.Pop();
+
+  encoder.Pop();
+  encoder.WriteSint32(kTestProtoZiggyField, -13);
+  return encoder.Encode();
+}
+
+TEST(Encoder, NestedKnownSize_MatchesUnsized) {
+  std::byte unsized_buffer[64];
+  NestedEncoder<2, 2> unsized_encoder(unsized_buffer);
+  Result<ConstByteSpan> unsized = EncodeNested(unsized_encoder, false);
+  ASSERT_EQ(unsized.status(), OkStatus());
+
+  std::byte sized_buffer[64];
+  NestedEncoder<2, 2> sized_encoder(sized_buffer);
+  Result<ConstByteSpan> sized = EncodeNested(sized_encoder, true);
+  ASSERT_EQ(sized.status(), OkStatus());
+
+  ASSERT_EQ(sized.value().size(), unsized.value().size());
+  EXPECT_EQ(std::memcmp(sized.value().data(),
+                        unsized.value().data(),
+                        sized.value().size()),
+            0);
+}
+
+TEST(Encoder, NestedKnownSize_InsideUnsized) {
+  std::byte encode_buffer[32];
+  NestedEncoder<2, 2> encoder(encode_buffer);
+
+  EXPECT_EQ(encoder.Push(1), OkStatus());
+  EXPECT_EQ(encoder.Push(2, SizeOfVarintField(1, 300)), OkStatus());
+  EXPECT_EQ(encoder.WriteUint32(1, 300), OkStatus());
+  EXPECT_EQ(encoder.Pop(), OkStatus());
+  EXPECT_EQ(encoder.WriteUint32(3, 1), OkStatus());
+  EXPECT_EQ(encoder.Pop(), OkStatus());
+
+  constexpr uint8_t encoded_proto[] = {
+      0x0a, 0x07, 0x12, 0x03, 0x08, 0xac, 0x02, 0x18, 0x01};
+
+  Result result = encoder.Encode();
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.value().size(), sizeof(encoded_proto));
+  EXPECT_EQ(
+      std::memcmp(result.value().data(), encoded_proto, sizeof(encoded_proto)),
+      0);
+}
+
+TEST(Encoder, NestedKnownSize_WrongSize) {
+  std::byte encode_buffer[32];
+  NestedEncoder encoder(encode_buffer);
+
+  EXPECT_EQ(encoder.Push(1, 3), OkStatus());
+  EXPECT_EQ(encoder.WriteUint32(1, 1), OkStatus());
+  EXPECT_EQ(encoder.Pop(), Status::InvalidArgument());
+  EXPECT_EQ(encoder.Encode().status(), Status::InvalidArgument());
+
+  encoder.Clear();
+  EXPECT_EQ(encoder.Push(1, 1), OkStatus());
+  EXPECT_EQ(encoder.WriteUint32(1, 1), OkStatus());
+  EXPECT_EQ(encoder.Pop(), Status::InvalidArgument());
+}
+
+TEST(Encoder, NestedKnownSize_InsufficientSpace) {
+  std::byte encode_buffer[8];
+  NestedEncoder encoder(encode_buffer);
+
+  EXPECT_EQ(encoder.Push(1, 7), Status::ResourceExhausted());
+}
+
 TEST(Encoder, NestedDepthLimit) {
   std::byte encode_buffer[128];
   NestedEncoder<2, 2> encoder(encode_buffer);
@@ -14,6 +14,11 @@
 
 #include "pw_protobuf/find.h"
 
+#include <algorithm>
+#include <cstring>
+
+#include "pw_varint/varint.h"
+
 namespace pw::protobuf {
 
 Status FindDecodeHandler::ProcessField(CallbackDecoder& decoder,
@@ -38,4 +43,115 @@ Status FindDecodeHandler::ProcessField(CallbackDecoder& decoder,
   return subdecoder.Decode(submessage);
 }
 
+namespace internal {
+
+Status FieldIndexBase::Build(ConstByteSpan message,
+                             std::span<const uint32_t> field_numbers,
+                             std::span<ConstByteSpan> fields) {
+  std::fill(fields.begin(), fields.end(), ConstByteSpan());
+
+  Decoder decoder(message);
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    const uint32_t field_number = decoder.FieldNumber();
+    for (size_t i = 0; i < field_numbers.size(); ++i) {
+      if (field_numbers[i] == field_number) {
+        // Next() has checked that the field fits in the message.
+        fields[i] = decoder.proto_.first(decoder.FieldSize());
+        break;
+      }
+    }
+  }
+  return status.IsOutOfRange() ? OkStatus() : status;
+}
+
+}  // namespace internal
+
+namespace {
+
+// Finds the value of the last occurrence of the field, which must have the
+// wire type, in the message.
+Status FindValue(ByteSpan message,
+                 uint32_t field_number,
+                 WireType wire_type,
+                 ByteSpan& value) {
+  FieldIndex index(field_number);
+  if (Status status = index.Build(message); !status.ok()) {
+    return status;
+  }
+
+  const ConstByteSpan field = index.Field(field_number);
+  if (field.empty()) {
+    return Status::NotFound();
+  }
+
+  uint64_t key;
+  const size_t key_size = varint::Decode(field, &key);
+  if (static_cast<WireType>(key & kWireTypeMask) != wire_type) {
+    return Status::FailedPrecondition();
+  }
+
+  // The field is a subspan of the message, so find its mutable bytes.
+  value = message.subspan(field.data() - message.data() + key_size,
+                          field.size() - key_size);
+  return OkStatus();
+}
+
+template <typename T>
+Status OverwriteFixed(ByteSpan message,
+                      uint32_t field_number,
+                      WireType wire_type,
+                      T value) {
+  ByteSpan bytes;
+  if (Status status = FindValue(message, field_number, wire_type, bytes);
+      !status.ok()) {
+    return status;
+  }
+  // Fixed-size values are written in native byte order, as the Encoder does.
+  std::memcpy(bytes.data(), &value, sizeof(value));
+  return OkStatus();
+}
+
+}  // namespace
+
+Status OverwriteFixed32(ByteSpan message,
+                        uint32_t field_number,
+                        uint32_t value) {
+  return OverwriteFixed(message, field_number, WireType::kFixed32, value);
+}
+
+Status OverwriteFixed64(ByteSpan message,
+                        uint32_t field_number,
+                        uint64_t value) {
+  return OverwriteFixed(message, field_number, WireType::kFixed64, value);
+}
+
+Status OverwriteVarint(ByteSpan message,
+                       uint32_t field_number,
+                       uint64_t value) {
+  ByteSpan bytes;
+  if (Status status =
+          FindValue(message, field_number, WireType::kVarint, bytes);
+      !status.ok()) {
+    return status;
+  }
+
+  // The field is valid, so the varint ends at its first byte without a
+  // continuation bit.
+  size_t width = 1;
+  while ((bytes[width - 1] & std::byte{0x80}) != std::byte{0}) {
+    width += 1;
+  }
+  if (varint::EncodedSize(value) > width) {
+    return Status::OutOfRange();
+  }
+
+  for (size_t i = 0; i < width - 1; ++i) {
+    bytes[i] = static_cast<std::byte>(value & 0x7f) | std::byte{0x80};
+    value >>= 7;
+  }
+  bytes[width - 1] = static_cast<std::byte>(value);
+  return OkStatus();
+}
+
 }  // namespace pw::protobuf
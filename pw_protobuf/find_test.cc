@@ -14,6 +14,8 @@
 
 #include "pw_protobuf/find.h"
 
+#include <cstring>
+
 #include "gtest/gtest.h"
 
 namespace pw::protobuf {
@@ -88,5 +90,162 @@ TEST(FindDecodeHandler, MultiLevel_DoesntFindNonExistingNestedField) {
   EXPECT_FALSE(decoder.cancelled());
 }
 
+TEST(FieldIndex, Build_IndexesRequestedFields) {
+  FieldIndex index(1, 4, 6, 8);
+  ASSERT_EQ(OkStatus(), index.Build(std::as_bytes(std::span(encoded_proto))));
+
+  EXPECT_TRUE(index.Contains(1));
+  EXPECT_TRUE(index.Contains(4));
+  EXPECT_TRUE(index.Contains(6));
+  EXPECT_FALSE(index.Contains(8));
+
+  // Fields that are not indexed are not found.
+  EXPECT_FALSE(index.Contains(2));
+  Decoder decoder(std::as_bytes(std::span(encoded_proto)));
+  EXPECT_EQ(Status::NotFound(), index.Seek(2, decoder));
+
+  EXPECT_EQ(2u, index.Field(1).size());
+  EXPECT_EQ(13u, index.Field(6).size());
+}
+
+TEST(FieldIndex, Seek_ReadsFieldsInAnyOrder) {
+  FieldIndex index(7, 6, 4, 1);
+  ASSERT_EQ(OkStatus(), index.Build(std::as_bytes(std::span(encoded_proto))));
+  Decoder decoder(std::as_bytes(std::span(encoded_proto)));
+
+  std::string_view str;
+  ASSERT_EQ(OkStatus(), index.Seek(6, decoder));
+  EXPECT_EQ(6u, decoder.FieldNumber());
+  ASSERT_EQ(OkStatus(), decoder.ReadString(&str));
+  EXPECT_EQ("Hello world", str);
+
+  int32_t int32 = 0;
+  ASSERT_EQ(OkStatus(), index.Seek(1, decoder));
+  ASSERT_EQ(OkStatus(), decoder.ReadInt32(&int32));
+  EXPECT_EQ(42, int32);
+
+  double dbl = 0;
+  ASSERT_EQ(OkStatus(), index.Seek(4, decoder));
+  ASSERT_EQ(OkStatus(), decoder.ReadDouble(&dbl));
+  EXPECT_EQ(3.14159, dbl);
+
+  std::span<const std::byte> nested;
+  ASSERT_EQ(OkStatus(), index.Seek(7, decoder));
+  ASSERT_EQ(OkStatus(), decoder.ReadBytes(&nested));
+  EXPECT_EQ(2u, nested.size());
+
+  // The decoder is left at the end of the indexed field.
+  EXPECT_EQ(Status::OutOfRange(), decoder.Next());
+}
+
+TEST(FieldIndex, Build_RepeatedField_IndexesLastOccurrence) {
+  constexpr uint8_t proto[] = {0x08, 0x01, 0x10, 0x02, 0x08, 0x03};
+  FieldIndex index(1u);
+  ASSERT_EQ(OkStatus(), index.Build(std::as_bytes(std::span(proto))));
+
+  Decoder decoder(std::as_bytes(std::span(proto)));
+  uint32_t value = 0;
+  ASSERT_EQ(OkStatus(), index.Seek(1, decoder));
+  ASSERT_EQ(OkStatus(), decoder.ReadUint32(&value));
+  EXPECT_EQ(3u, value);
+}
+
+TEST(FieldIndex, Build_InvalidData_IndexesFieldsBeforeError) {
+  // Field 1 is valid, but field 2 claims more bytes than the message has.
+  constexpr uint8_t proto[] = {0x08, 0x01, 0x12, 0x05, 0x00};
+  FieldIndex index(1, 2);
+
+  EXPECT_EQ(Status::DataLoss(),
+            index.Build(std::as_bytes(std::span(proto))));
+  EXPECT_TRUE(index.Contains(1));
+  EXPECT_FALSE(index.Contains(2));
+}
+
+TEST(FieldIndex, Build_ReplacesPreviousIndex) {
+  constexpr uint8_t proto[] = {0x10, 0x01};
+  FieldIndex index(1, 2);
+  ASSERT_EQ(OkStatus(), index.Build(std::as_bytes(std::span(encoded_proto))));
+  ASSERT_EQ(OkStatus(), index.Build(std::as_bytes(std::span(proto))));
+
+  EXPECT_FALSE(index.Contains(1));
+  EXPECT_TRUE(index.Contains(2));
+}
+
+TEST(Overwrite, Fixed32) {
+  uint8_t proto[sizeof(encoded_proto)];
+  std::memcpy(proto, encoded_proto, sizeof(proto));
+  const ByteSpan message = std::as_writable_bytes(std::span(proto));
+
+  ASSERT_EQ(OkStatus(), OverwriteFixed32(message, 5, 0x01020304));
+
+  Decoder decoder(message);
+  FieldIndex index(5);
+  ASSERT_EQ(OkStatus(), index.Build(message));
+  ASSERT_EQ(OkStatus(), index.Seek(5, decoder));
+  uint32_t value = 0;
+  ASSERT_EQ(OkStatus(), decoder.ReadFixed32(&value));
+  EXPECT_EQ(0x01020304u, value);
+
+  // The rest of the message is unchanged.
+  EXPECT_EQ(0, std::memcmp(proto, encoded_proto, 16));
+  EXPECT_EQ(0,
+            std::memcmp(proto + 20, encoded_proto + 20, sizeof(proto) - 20));
+}
+
+TEST(Overwrite, Fixed64_Double) {
+  uint8_t proto[sizeof(encoded_proto)];
+  std::memcpy(proto, encoded_proto, sizeof(proto));
+  const ByteSpan message = std::as_writable_bytes(std::span(proto));
+
+  const double new_value = -2.5;
+  uint64_t bits;
+  std::memcpy(&bits, &new_value, sizeof(bits));
+  ASSERT_EQ(OkStatus(), OverwriteFixed64(message, 4, bits));
+
+  Decoder decoder(message);
+  double value = 0;
+  while (decoder.Next().ok() && decoder.FieldNumber() != 4) {
+  }
+  ASSERT_EQ(OkStatus(), decoder.ReadDouble(&value));
+  EXPECT_EQ(new_value, value);
+}
+
+TEST(Overwrite, WrongWireTypeOrMissing) {
+  uint8_t proto[sizeof(encoded_proto)];
+  std::memcpy(proto, encoded_proto, sizeof(proto));
+  const ByteSpan message = std::as_writable_bytes(std::span(proto));
+
+  EXPECT_EQ(Status::FailedPrecondition(), OverwriteFixed32(message, 4, 1));
+  EXPECT_EQ(Status::FailedPrecondition(), OverwriteFixed64(message, 1, 1));
+  EXPECT_EQ(Status::FailedPrecondition(), OverwriteVarint(message, 6, 1));
+  EXPECT_EQ(Status::NotFound(), OverwriteVarint(message, 8, 1));
+  EXPECT_EQ(0, std::memcmp(proto, encoded_proto, sizeof(proto)));
+}
+
+TEST(Overwrite, Varint_FitsInExistingWidth) {
+  // type=uint32, k=1, v=300 (two bytes); type=uint32, k=2, v=1
+  uint8_t proto[] = {0x08, 0xac, 0x02, 0x10, 0x01};
+  const ByteSpan message = std::as_writable_bytes(std::span(proto));
+
+  // Larger values that fit in two bytes are written as is.
+  ASSERT_EQ(OkStatus(), OverwriteVarint(message, 1, 16383));
+  EXPECT_EQ(std::byte{0xff}, message[1]);
+  EXPECT_EQ(std::byte{0x7f}, message[2]);
+
+  // Smaller values are padded to the same width.
+  ASSERT_EQ(OkStatus(), OverwriteVarint(message, 1, 5));
+  Decoder decoder(message);
+  uint32_t value = 0;
+  ASSERT_EQ(OkStatus(), decoder.Next());
+  ASSERT_EQ(OkStatus(), decoder.ReadUint32(&value));
+  EXPECT_EQ(5u, value);
+  ASSERT_EQ(OkStatus(), decoder.Next());
+  EXPECT_EQ(2u, decoder.FieldNumber());
+
+  // Values that need more bytes are rejected.
+  EXPECT_EQ(Status::OutOfRange(), OverwriteVarint(message, 1, 16384));
+  EXPECT_EQ(Status::OutOfRange(), OverwriteVarint(message, 2, 128));
+}
+
 }  // namespace
 }  // namespace pw::protobuf
@@ -13,6 +13,9 @@
 // the License.
 #pragma once
 
+#include <span>
+
+#include "pw_protobuf/decoder.h"
 #include "pw_protobuf/encoder.h"
 
 namespace pw::protobuf {
@@ -41,4 +44,24 @@ class ProtoMessageEncoder {
   uint32_t parent_field_;
 };
 
+// Base class for generated decoders. Wraps a low-level proto decoder, which the
+// generated class uses to read each field with the correct type.
+class ProtoMessageDecoder {
+ public:
+  constexpr ProtoMessageDecoder(std::span<const std::byte> proto)
+      : decoder_(proto) {}
+
+  // Advances to the next field in the message. See Decoder::Next().
+  Status Next() { return decoder_.Next(); }
+
+  // Advances to the next field in the mask. See Decoder::Next(FieldMask).
+  Status Next(FieldMask fields) { return decoder_.Next(fields); }
+
+  // Resets the decoder to start reading a new message.
+  void Reset(std::span<const std::byte> proto) { decoder_.Reset(proto); }
+
+ protected:
+  Decoder decoder_;
+};
+
 }  // namespace pw::protobuf
@@ -16,8 +16,10 @@
 #include <span>
 #include <string_view>
 
+#include "pw_bytes/span.h"
 #include "pw_protobuf/wire_format.h"
 #include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
 #include "pw_varint/varint.h"
 
 // This file defines a low-level event-based protobuf wire format decoder.
@@ -41,6 +43,37 @@
 //   }
 //
 namespace pw::protobuf {
+namespace internal {
+
+class FieldIndexBase;
+
+}  // namespace internal
+
+// A set of field numbers for Decoder::Next(FieldMask). The set is a bit mask,
+// so it is cheap to build at compile time and to check. Field numbers 1 to 63
+// are stored exactly; if any larger field number is added, all fields numbered
+// above 63 are in the set, and the caller must check their numbers.
+//
+//   constexpr FieldMask kWanted(Message::Fields::ID, Message::Fields::NAME);
+//
+class FieldMask {
+ public:
+  template <typename... FieldNumbers>
+  explicit constexpr FieldMask(FieldNumbers... field_numbers)
+      : bits_((Bit(static_cast<uint32_t>(field_numbers)) | ... | 0)) {}
+
+  constexpr bool contains(uint32_t field_number) const {
+    return (bits_ & Bit(field_number)) != 0;
+  }
+
+ private:
+  // Bit 0 stands for every field number above 63, as 0 is not a valid field.
+  static constexpr uint64_t Bit(uint32_t field_number) {
+    return uint64_t(1) << (field_number < 64 ? field_number : 0);
+  }
+
+  uint64_t bits_;
+};
 
 class Decoder {
  public:
@@ -63,6 +96,12 @@ class Decoder {
   //
   Status Next();
 
+  // Advances to the next field in the mask. Fields not in the mask are skipped
+  // without being validated beyond their keys and lengths: the bytes of a
+  // length-delimited field are jumped over, and varint values are not decoded.
+  // Returns the same values as Next().
+  Status Next(FieldMask fields);
+
   // Returns the field number of the field at the current cursor position.
   uint32_t FieldNumber() const;
 
@@ -133,6 +172,59 @@ class Decoder {
     return ReadDelimited(out);
   }
 
+  // Reads a repeated field into `out` and returns the number of values read.
+  // Both packed fields and single non-packed values are accepted. If `out` is
+  // too small, returns RESOURCE_EXHAUSTED without consuming the field.
+  StatusWithSize ReadPackedUint32(std::span<uint32_t> out) {
+    return ReadPackedVarints(std::as_writable_bytes(out), sizeof(uint32_t));
+  }
+
+  StatusWithSize ReadPackedUint64(std::span<uint64_t> out) {
+    return ReadPackedVarints(std::as_writable_bytes(out), sizeof(uint64_t));
+  }
+
+  StatusWithSize ReadPackedInt32(std::span<int32_t> out) {
+    return ReadPackedVarints(std::as_writable_bytes(out), sizeof(int32_t));
+  }
+
+  StatusWithSize ReadPackedInt64(std::span<int64_t> out) {
+    return ReadPackedVarints(std::as_writable_bytes(out), sizeof(int64_t));
+  }
+
+  StatusWithSize ReadPackedSint32(std::span<int32_t> out) {
+    return ReadPackedVarints(
+        std::as_writable_bytes(out), sizeof(int32_t), /*zigzag=*/true);
+  }
+
+  StatusWithSize ReadPackedSint64(std::span<int64_t> out) {
+    return ReadPackedVarints(
+        std::as_writable_bytes(out), sizeof(int64_t), /*zigzag=*/true);
+  }
+
+  StatusWithSize ReadPackedFixed32(std::span<uint32_t> out) {
+    return ReadPackedFixed(std::as_writable_bytes(out), sizeof(uint32_t));
+  }
+
+  StatusWithSize ReadPackedFixed64(std::span<uint64_t> out) {
+    return ReadPackedFixed(std::as_writable_bytes(out), sizeof(uint64_t));
+  }
+
+  StatusWithSize ReadPackedSfixed32(std::span<int32_t> out) {
+    return ReadPackedFixed(std::as_writable_bytes(out), sizeof(int32_t));
+  }
+
+  StatusWithSize ReadPackedSfixed64(std::span<int64_t> out) {
+    return ReadPackedFixed(std::as_writable_bytes(out), sizeof(int64_t));
+  }
+
+  StatusWithSize ReadPackedFloat(std::span<float> out) {
+    return ReadPackedFixed(std::as_writable_bytes(out), sizeof(float));
+  }
+
+  StatusWithSize ReadPackedDouble(std::span<double> out) {
+    return ReadPackedFixed(std::as_writable_bytes(out), sizeof(double));
+  }
+
   // Resets the decoder to start reading a new proto message.
   void Reset(std::span<const std::byte> proto) {
     proto_ = proto;
@@ -140,6 +232,9 @@ class Decoder {
   }
 
  private:
+  // Reads the bounds of fields to index them.
+  friend class internal::FieldIndexBase;
+
   // Advances the cursor to the next field in the proto.
   Status SkipField();
 
@@ -164,6 +259,17 @@ class Decoder {
 
   Status ReadDelimited(std::span<const std::byte>* out);
 
+  // Returns the wire type of the current field, which must be valid.
+  WireType CurrentWireType() const;
+
+  // Reads packed varints into an array of 32- or 64-bit integers.
+  StatusWithSize ReadPackedVarints(ByteSpan out,
+                                   size_t element_size,
+                                   bool zigzag = false);
+
+  // Reads packed fixed-size values into an array of the same size values.
+  StatusWithSize ReadPackedFixed(ByteSpan out, size_t element_size);
+
   std::span<const std::byte> proto_;
   bool previous_field_consumed_;
 };
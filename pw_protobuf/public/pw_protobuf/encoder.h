@@ -42,6 +42,7 @@ class Encoder {
         blob_count_(0),
         blob_stack_(stack),
         depth_(0),
+        sized_levels_(0),
         encode_status_(OkStatus()) {}
 
   // Disallow copy/assign to avoid confusion about who owns the buffer.
@@ -248,6 +249,13 @@ class Encoder {
   // Begins writing a sub-message with a specified field number.
   Status Push(uint32_t field_number);
 
+  // Begins writing a sub-message whose encoded size is known in advance, such
+  // as from the helpers in serialized_size.h. Its length is written once at its
+  // final width, so the message is not moved when it is finished. Exactly size
+  // bytes must be written before Pop(), which returns INVALID_ARGUMENT if the
+  // size was wrong.
+  Status Push(uint32_t field_number, size_t size);
+
   // Finishes writing a sub-message.
   Status Pop();
 
@@ -264,6 +272,7 @@ class Encoder {
     encode_status_ = OkStatus();
     blob_count_ = 0;
     depth_ = 0;
+    sized_levels_ = 0;
   }
 
   // Runs a final encoding pass over the intermediary data and returns the
@@ -318,11 +327,17 @@ class Encoder {
   Status WritePackedVarints(uint32_t field_number,
                             std::span<T> values,
                             bool zigzag) {
-    if (Status status = Push(field_number); !status.ok()) {
+    // Size the values first so that they don't have to be moved into place.
+    size_t size = 0;
+    for (T value : values) {
+      size += zigzag ? varint::EncodedSize(varint::ZigZagEncode(
+                           static_cast<std::make_signed_t<T>>(value)))
+                     : varint::EncodedSize(value);
+    }
+    if (Status status = Push(field_number, size); !status.ok()) {
       return status;
     }
 
-    std::byte* original_cursor = cursor_;
     for (T value : values) {
       if (zigzag) {
         WriteZigzagVarint(static_cast<std::make_signed_t<T>>(value));
@@ -330,18 +345,24 @@ class Encoder {
         WriteVarint(value);
       }
     }
-    IncreaseParentSize(cursor_ - original_cursor);
 
     return Pop();
   }
 
-  // Adds to the parent proto's size field in the buffer.
+  // Adds to the parent proto's size field in the buffer. A parent of known
+  // size already accounts for everything written to it.
   void IncreaseParentSize(size_t bytes) {
-    if (depth_ > 0) {
+    if (depth_ > 0 && !IsSizedLevel(depth_ - 1)) {
       *blob_stack_[depth_ - 1] += bytes;
     }
   }
 
+  // Returns true if the sub-message at the nesting level was started with a
+  // known size.
+  bool IsSizedLevel(size_t level) const {
+    return (sized_levels_ & (uint32_t(1) << level)) != 0;
+  }
+
   // Returns the size of `n` encoded as a varint.
   size_t VarintSizeBytes(uint64_t n) {
     size_t size_bytes = 1;
@@ -368,6 +389,10 @@ class Encoder {
   std::span<SizeType*> blob_stack_;
   size_t depth_;
 
+  // Bit set of the nesting levels that were started with a known size. Rather
+  // than a size field, their blob_stack_ entries point to where they must end.
+  uint32_t sized_levels_;
+
   Status encode_status_;
 };
 
@@ -13,7 +13,14 @@
 // the License.
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_bytes/span.h"
 #include "pw_protobuf/decoder.h"
+#include "pw_status/status.h"
 
 namespace pw::protobuf {
 
@@ -43,4 +50,132 @@ class FindDecodeHandler final : public DecodeHandler {
   FindDecodeHandler* nested_handler_;
 };
 
+namespace internal {
+
+class FieldIndexBase {
+ protected:
+  // Records the encoded key and value of the last occurrence of each of the
+  // field numbers in the message. Fields that do not occur are left empty.
+  static Status Build(ConstByteSpan message,
+                      std::span<const uint32_t> field_numbers,
+                      std::span<ConstByteSpan> fields);
+};
+
+}  // namespace internal
+
+// Records where a fixed set of fields are in a message in a single pass over
+// it, so that the fields can then be read in any order without searching the
+// message again. Use this instead of FindDecodeHandler when reading more than
+// one field from a large message.
+//
+// If a field occurs more than once, the last occurrence is indexed, which is
+// the value a singular field takes when decoded.
+//
+// Example usage:
+//
+//   FieldIndex index(Request::Fields::ID, Request::Fields::NAME);
+//   if (!index.Build(request).ok()) {
+//     return Status::DataLoss();
+//   }
+//
+//   Decoder decoder(request);
+//   uint32_t id;
+//   if (index.Seek(Request::Fields::ID, decoder).ok()) {
+//     decoder.ReadUint32(&id);
+//   }
+//
+template <size_t kFieldCount>
+class FieldIndex : private internal::FieldIndexBase {
+ public:
+  template <typename... FieldNumbers>
+  constexpr FieldIndex(FieldNumbers... field_numbers)
+      : field_numbers_{static_cast<uint32_t>(field_numbers)...}, fields_{} {
+    static_assert(sizeof...(FieldNumbers) == kFieldCount);
+  }
+
+  // Indexes the fields in a message, replacing any previous index. The message
+  // must outlive the index. Returns DATA_LOSS if the message is invalid, in
+  // which case only the fields before the invalid data are indexed.
+  Status Build(ConstByteSpan message) {
+    return FieldIndexBase::Build(message, field_numbers_, fields_);
+  }
+
+  // Returns true if the field was found in the message.
+  bool Contains(uint32_t field_number) const {
+    return !Field(field_number).empty();
+  }
+
+  template <typename FieldNumber>
+  bool Contains(FieldNumber field_number) const {
+    return Contains(static_cast<uint32_t>(field_number));
+  }
+
+  // Returns the encoded key and value of the field, or an empty span if the
+  // field was not found or is not one of the indexed fields.
+  ConstByteSpan Field(uint32_t field_number) const {
+    for (size_t i = 0; i < kFieldCount; ++i) {
+      if (field_numbers_[i] == field_number) {
+        return fields_[i];
+      }
+    }
+    return ConstByteSpan();
+  }
+
+  template <typename FieldNumber>
+  ConstByteSpan Field(FieldNumber field_number) const {
+    return Field(static_cast<uint32_t>(field_number));
+  }
+
+  // Resets the decoder so that its current field is the indexed field, which
+  // can then be read with the decoder's Read*() methods. Returns NOT_FOUND if
+  // the field was not found or is not one of the indexed fields.
+  Status Seek(uint32_t field_number, Decoder& decoder) const {
+    ConstByteSpan field = Field(field_number);
+    if (field.empty()) {
+      return Status::NotFound();
+    }
+    decoder.Reset(field);
+    return decoder.Next();
+  }
+
+  template <typename FieldNumber>
+  Status Seek(FieldNumber field_number, Decoder& decoder) const {
+    return Seek(static_cast<uint32_t>(field_number), decoder);
+  }
+
+ private:
+  const std::array<uint32_t, kFieldCount> field_numbers_;
+  std::array<ConstByteSpan, kFieldCount> fields_;
+};
+
+template <typename... FieldNumbers>
+FieldIndex(FieldNumbers...) -> FieldIndex<sizeof...(FieldNumbers)>;
+
+// The following functions overwrite the value of a field in an encoded message
+// in place, without decoding and re-encoding the message. For example, they can
+// update a timestamp or sequence number in a message that is already in a
+// buffer. The last occurrence of the field in the top level of the message is
+// overwritten, since that is the value it decodes to.
+//
+// Return values:
+//
+//                   OK: The field was overwritten.
+//            NOT_FOUND: The field is not in the message.
+//  FAILED_PRECONDITION: The field has a different wire type.
+//            DATA_LOSS: The message is invalid.
+//
+Status OverwriteFixed32(ByteSpan message,
+                        uint32_t field_number,
+                        uint32_t value);
+
+Status OverwriteFixed64(ByteSpan message,
+                        uint32_t field_number,
+                        uint64_t value);
+
+// Overwrites a varint field, such as a uint32, int64, or bool. The new value
+// must fit in the number of bytes the current value occupies, or OUT_OF_RANGE
+// is returned. Smaller values are padded to the same width with continuation
+// bytes, which all protobuf decoders accept.
+Status OverwriteVarint(ByteSpan message, uint32_t field_number, uint64_t value);
+
 }  // namespace pw::protobuf
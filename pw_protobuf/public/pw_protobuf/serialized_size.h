@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 #include "pw_protobuf/wire_format.h"
@@ -49,4 +50,30 @@ constexpr size_t SizeOfFieldKey(uint32_t field_number) {
   return varint::EncodedSize(field_number << kFieldNumberShift);
 }
 
+// The following return the serialized size of an entire field, including its
+// key. They can be summed to find the size of a nested message in advance, to
+// pass to Encoder::Push(field_number, size).
+
+constexpr size_t SizeOfVarintField(uint32_t field_number, uint64_t value) {
+  return SizeOfFieldKey(field_number) + varint::EncodedSize(value);
+}
+
+constexpr size_t SizeOfZigZagField(uint32_t field_number, int64_t value) {
+  return SizeOfVarintField(field_number, varint::ZigZagEncode(value));
+}
+
+constexpr size_t SizeOfFixed32Field(uint32_t field_number) {
+  return SizeOfFieldKey(field_number) + sizeof(uint32_t);
+}
+
+constexpr size_t SizeOfFixed64Field(uint32_t field_number) {
+  return SizeOfFieldKey(field_number) + sizeof(uint64_t);
+}
+
+constexpr size_t SizeOfDelimitedField(uint32_t field_number,
+                                      size_t length_bytes) {
+  return SizeOfFieldKey(field_number) + varint::EncodedSize(length_bytes) +
+         length_bytes;
+}
+
 }  // namespace pw::protobuf
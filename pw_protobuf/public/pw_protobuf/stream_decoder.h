@@ -0,0 +1,289 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+#include "pw_bytes/span.h"
+#include "pw_protobuf/wire_format.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
+
+namespace pw::protobuf {
+
+// A protobuf decoder that reads a message from a stream::Reader, so the message
+// never has to be in memory all at once. It has the same Next() / Read*() API
+// as Decoder, except that bytes and string fields are copied into a buffer
+// provided by the caller. Large bytes fields can be read incrementally with
+// GetBytesReader(), and nested messages are decoded with GetNestedDecoder().
+//
+// Reads from the stream go through the optional window buffer, which lets the
+// decoder read many small fields with few calls to the reader. Reads that are
+// at least as large as the window go directly to the destination.
+//
+// Example usage:
+//
+//   std::byte window[32];
+//   StreamDecoder decoder(reader, window);
+//   while (decoder.Next().ok()) {
+//     switch (decoder.FieldNumber()) {
+//       case 1:
+//         decoder.ReadUint32(&my_uint32);
+//         break;
+//       case 2: {
+//         StreamDecoder nested = decoder.GetNestedDecoder();
+//         // ... decode the nested message.
+//         break;
+//       }
+//     }
+//   }
+//
+class StreamDecoder {
+ public:
+  // A stream::Reader for the contents of a length-delimited field. The reader
+  // returns OUT_OF_RANGE at the end of the field. The decoder that created the
+  // reader cannot be used until the reader is destroyed.
+  class BytesReader : public stream::Reader {
+   public:
+    ~BytesReader();
+
+    BytesReader(const BytesReader&) = delete;
+    BytesReader& operator=(const BytesReader&) = delete;
+
+    // The total size of the field.
+    size_t field_size() const { return field_size_; }
+
+    size_t ConservativeReadLimit() const override {
+      return status_.ok() ? remaining_ : 0;
+    }
+
+   private:
+    friend class StreamDecoder;
+
+    constexpr BytesReader(StreamDecoder* decoder,
+                          size_t field_size,
+                          Status status)
+        : decoder_(decoder),
+          field_size_(field_size),
+          remaining_(field_size),
+          status_(status) {}
+
+    StatusWithSize DoRead(ByteSpan dest) override;
+
+    StreamDecoder* const decoder_;
+    const size_t field_size_;
+    size_t remaining_;
+    Status status_;
+  };
+
+  constexpr StreamDecoder(stream::Reader& reader, ByteSpan window = ByteSpan())
+      : StreamDecoder(&reader,
+                      nullptr,
+                      window,
+                      std::numeric_limits<size_t>::max(),
+                      OkStatus()) {}
+
+  // Releases the parent decoder, if this is a nested decoder. The parent skips
+  // any part of the nested message that was not read.
+  ~StreamDecoder();
+
+  StreamDecoder(const StreamDecoder&) = delete;
+  StreamDecoder& operator=(const StreamDecoder&) = delete;
+
+  // Advances to the next field in the proto, skipping the current field if it
+  // was not read.
+  //
+  // Return values:
+  //
+  //                   OK: Advanced to a valid proto field.
+  //         OUT_OF_RANGE: Reached the end of the proto message.
+  //            DATA_LOSS: Invalid protobuf data.
+  //  FAILED_PRECONDITION: A nested decoder or bytes reader is open.
+  //
+  // Errors reading from the stream are also returned. Other than
+  // OUT_OF_RANGE and FAILED_PRECONDITION, errors are permanent.
+  Status Next();
+
+  // Returns the field number of the field at the current cursor position.
+  uint32_t FieldNumber() const { return field_number_; }
+
+  // Reads a proto int32 value from the current cursor.
+  Status ReadInt32(int32_t* out) {
+    return ReadUint32(reinterpret_cast<uint32_t*>(out));
+  }
+
+  // Reads a proto uint32 value from the current cursor.
+  Status ReadUint32(uint32_t* out);
+
+  // Reads a proto int64 value from the current cursor.
+  Status ReadInt64(int64_t* out) {
+    return ReadVarintField(reinterpret_cast<uint64_t*>(out));
+  }
+
+  // Reads a proto uint64 value from the current cursor.
+  Status ReadUint64(uint64_t* out) { return ReadVarintField(out); }
+
+  // Reads a proto sint32 value from the current cursor.
+  Status ReadSint32(int32_t* out);
+
+  // Reads a proto sint64 value from the current cursor.
+  Status ReadSint64(int64_t* out);
+
+  // Reads a proto bool value from the current cursor.
+  Status ReadBool(bool* out);
+
+  // Reads a proto fixed32 value from the current cursor.
+  Status ReadFixed32(uint32_t* out) { return ReadFixed(out); }
+
+  // Reads a proto fixed64 value from the current cursor.
+  Status ReadFixed64(uint64_t* out) { return ReadFixed(out); }
+
+  // Reads a proto sfixed32 value from the current cursor.
+  Status ReadSfixed32(int32_t* out) {
+    return ReadFixed32(reinterpret_cast<uint32_t*>(out));
+  }
+
+  // Reads a proto sfixed64 value from the current cursor.
+  Status ReadSfixed64(int64_t* out) {
+    return ReadFixed64(reinterpret_cast<uint64_t*>(out));
+  }
+
+  // Reads a proto float value from the current cursor.
+  Status ReadFloat(float* out) {
+    static_assert(sizeof(float) == sizeof(uint32_t),
+                  "Float and uint32_t must be the same size for protobufs");
+    return ReadFixed(out);
+  }
+
+  // Reads a proto double value from the current cursor.
+  Status ReadDouble(double* out) {
+    static_assert(sizeof(double) == sizeof(uint64_t),
+                  "Double and uint64_t must be the same size for protobufs");
+    return ReadFixed(out);
+  }
+
+  // Copies a proto bytes value from the current cursor into `out` and returns
+  // its size. Returns RESOURCE_EXHAUSTED without reading anything if the field
+  // does not fit; the field can then be read with GetBytesReader().
+  StatusWithSize ReadBytes(ByteSpan out);
+
+  // Copies a proto string value from the current cursor into `out` and returns
+  // its size. The string is not null-terminated. Returns RESOURCE_EXHAUSTED
+  // without reading anything if the string does not fit.
+  StatusWithSize ReadString(std::span<char> out) {
+    return ReadBytes(std::as_writable_bytes(out));
+  }
+
+  // Returns a reader for the length-delimited field at the current cursor. If
+  // the field is not length-delimited, the reader returns FAILED_PRECONDITION.
+  BytesReader GetBytesReader();
+
+  // Returns a decoder for the nested message at the current cursor. If the
+  // field is not length-delimited, the decoder returns FAILED_PRECONDITION.
+  // This decoder cannot be used until the nested decoder is destroyed.
+  StreamDecoder GetNestedDecoder();
+
+ private:
+  constexpr StreamDecoder(stream::Reader* reader,
+                          StreamDecoder* parent,
+                          ByteSpan window,
+                          size_t limit,
+                          Status status)
+      : reader_(reader),
+        parent_(parent),
+        window_(window),
+        window_start_(0),
+        window_end_(0),
+        position_(0),
+        limit_(limit),
+        field_number_(0),
+        wire_type_(WireType::kVarint),
+        field_end_(0),
+        field_consumed_(true),
+        nested_open_(false),
+        status_(status) {}
+
+  // Reads a varint key-value pair from the current cursor position.
+  Status ReadVarintField(uint64_t* out);
+
+  // Reads a fixed-size key-value pair from the current cursor position.
+  Status ReadFixed(std::byte* out, size_t size);
+
+  template <typename T>
+  Status ReadFixed(T* out) {
+    static_assert(
+        sizeof(T) == sizeof(uint32_t) || sizeof(T) == sizeof(uint64_t),
+        "Protobuf fixed-size fields must be 32- or 64-bit");
+    return ReadFixed(reinterpret_cast<std::byte*>(out), sizeof(T));
+  }
+
+  // Checks that the current field can be read and has the expected type.
+  Status CheckField(WireType expected_type) const;
+
+  Status SkipField();
+
+  // Reads a varint from the stream. Returns OUT_OF_RANGE if the stream ends
+  // before the varint starts, or DATA_LOSS if it ends within the varint.
+  Status ReadVarint(uint64_t* out);
+
+  // Reads exactly dest.size() bytes. Returns OUT_OF_RANGE if the message or
+  // stream ends before any bytes are read, or DATA_LOSS if it ends partway.
+  Status ReadExact(ByteSpan dest);
+
+  // Reads and discards bytes.
+  Status Skip(size_t size);
+
+  // Reads from the stream through the window. Only used by the top-level
+  // decoder.
+  Status ReadFromStream(ByteSpan dest, size_t& bytes_read);
+
+  // Records a permanent error and returns it.
+  Status SetError(Status status) {
+    if (status_.ok()) {
+      status_ = status;
+    }
+    return status_;
+  }
+
+  // The stream, or null for a nested decoder.
+  stream::Reader* const reader_;
+
+  // The decoder that a nested decoder reads its message from.
+  StreamDecoder* const parent_;
+
+  const ByteSpan window_;
+  size_t window_start_;
+  size_t window_end_;
+
+  // The number of bytes of this message that have been read, and the size of
+  // the message.
+  size_t position_;
+  const size_t limit_;
+
+  uint32_t field_number_;
+  WireType wire_type_;
+
+  // For fixed-size and length-delimited fields, the position after the field.
+  size_t field_end_;
+  bool field_consumed_;
+
+  bool nested_open_;
+  Status status_;
+};
+
+}  // namespace pw::protobuf
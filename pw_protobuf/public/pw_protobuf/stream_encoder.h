@@ -0,0 +1,353 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+#include "pw_bytes/span.h"
+#include "pw_protobuf/serialized_size.h"
+#include "pw_protobuf/wire_format.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+#include "pw_varint/varint.h"
+
+namespace pw::protobuf {
+
+// A protobuf encoder that writes fields directly to a stream::Writer as they
+// are added, so the message never has to fit in RAM. Each scalar field is
+// written with a single call to the writer; bytes and string fields take two.
+//
+// The length of a length-delimited field must be written before its contents.
+// Packed repeated fields are sized before they are written, so they need no
+// extra memory. Nested messages are encoded into the scratch buffer and
+// written to the stream when they are finished, so the scratch buffer must
+// hold the largest nested message. Nested messages within nested messages
+// share the scratch buffer, with kMaxNestedHeaderSizeBytes reserved for each
+// level. The scratch buffer may be empty if no nested messages are written.
+//
+// Errors are sticky: after a write fails, all further writes return the same
+// error, which is also returned by status().
+class StreamEncoder {
+ public:
+  // Space reserved in the scratch buffer for the key and length of each nested
+  // message within a nested message.
+  static constexpr size_t kMaxNestedHeaderSizeBytes =
+      kMaxSizeOfFieldKey + kMaxSizeOfLength;
+
+  constexpr StreamEncoder(stream::Writer& writer, ByteSpan scratch_buffer)
+      : StreamEncoder(&writer, nullptr, 0, scratch_buffer, OkStatus()) {}
+
+  // Writes the nested message to its parent, if this is a nested encoder.
+  ~StreamEncoder();
+
+  StreamEncoder(const StreamEncoder&) = delete;
+  StreamEncoder& operator=(const StreamEncoder&) = delete;
+
+  // Writes a proto uint32 key-value pair.
+  Status WriteUint32(uint32_t field_number, uint32_t value) {
+    return WriteUint64(field_number, value);
+  }
+
+  // Writes a repeated uint32 using packed encoding.
+  Status WritePackedUint32(uint32_t field_number,
+                           std::span<const uint32_t> values) {
+    return WritePackedVarints(field_number, values, /*zigzag=*/false);
+  }
+
+  // Writes a proto uint64 key-value pair.
+  Status WriteUint64(uint32_t field_number, uint64_t value) {
+    return WriteVarintField(field_number, value);
+  }
+
+  // Writes a repeated uint64 using packed encoding.
+  Status WritePackedUint64(uint32_t field_number,
+                           std::span<const uint64_t> values) {
+    return WritePackedVarints(field_number, values, /*zigzag=*/false);
+  }
+
+  // Writes a proto int32 key-value pair.
+  Status WriteInt32(uint32_t field_number, int32_t value) {
+    return WriteUint64(field_number, value);
+  }
+
+  // Writes a repeated int32 using packed encoding.
+  Status WritePackedInt32(uint32_t field_number,
+                          std::span<const int32_t> values) {
+    return WritePackedVarints(field_number, values, /*zigzag=*/false);
+  }
+
+  // Writes a proto int64 key-value pair.
+  Status WriteInt64(uint32_t field_number, int64_t value) {
+    return WriteUint64(field_number, value);
+  }
+
+  // Writes a repeated int64 using packed encoding.
+  Status WritePackedInt64(uint32_t field_number,
+                          std::span<const int64_t> values) {
+    return WritePackedVarints(field_number, values, /*zigzag=*/false);
+  }
+
+  // Writes a proto sint32 key-value pair.
+  Status WriteSint32(uint32_t field_number, int32_t value) {
+    return WriteUint64(field_number, varint::ZigZagEncode(value));
+  }
+
+  // Writes a repeated sint32 using packed encoding.
+  Status WritePackedSint32(uint32_t field_number,
+                           std::span<const int32_t> values) {
+    return WritePackedVarints(field_number, values, /*zigzag=*/true);
+  }
+
+  // Writes a proto sint64 key-value pair.
+  Status WriteSint64(uint32_t field_number, int64_t value) {
+    return WriteUint64(field_number, varint::ZigZagEncode(value));
+  }
+
+  // Writes a repeated sint64 using packed encoding.
+  Status WritePackedSint64(uint32_t field_number,
+                           std::span<const int64_t> values) {
+    return WritePackedVarints(field_number, values, /*zigzag=*/true);
+  }
+
+  // Writes a proto bool key-value pair.
+  Status WriteBool(uint32_t field_number, bool value) {
+    return WriteUint32(field_number, static_cast<uint32_t>(value));
+  }
+
+  // Writes a proto fixed32 key-value pair.
+  Status WriteFixed32(uint32_t field_number, uint32_t value) {
+    return WriteFixedField(field_number, WireType::kFixed32, value);
+  }
+
+  // Writes a repeated fixed32 field using packed encoding.
+  Status WritePackedFixed32(uint32_t field_number,
+                            std::span<const uint32_t> values) {
+    return WriteBytes(field_number, std::as_bytes(values));
+  }
+
+  // Writes a proto fixed64 key-value pair.
+  Status WriteFixed64(uint32_t field_number, uint64_t value) {
+    return WriteFixedField(field_number, WireType::kFixed64, value);
+  }
+
+  // Writes a repeated fixed64 field using packed encoding.
+  Status WritePackedFixed64(uint32_t field_number,
+                            std::span<const uint64_t> values) {
+    return WriteBytes(field_number, std::as_bytes(values));
+  }
+
+  // Writes a proto sfixed32 key-value pair.
+  Status WriteSfixed32(uint32_t field_number, int32_t value) {
+    return WriteFixed32(field_number, static_cast<uint32_t>(value));
+  }
+
+  // Writes a repeated sfixed32 field using packed encoding.
+  Status WritePackedSfixed32(uint32_t field_number,
+                             std::span<const int32_t> values) {
+    return WriteBytes(field_number, std::as_bytes(values));
+  }
+
+  // Writes a proto sfixed64 key-value pair.
+  Status WriteSfixed64(uint32_t field_number, int64_t value) {
+    return WriteFixed64(field_number, static_cast<uint64_t>(value));
+  }
+
+  // Writes a repeated sfixed64 field using packed encoding.
+  Status WritePackedSfixed64(uint32_t field_number,
+                             std::span<const int64_t> values) {
+    return WriteBytes(field_number, std::as_bytes(values));
+  }
+
+  // Writes a proto float key-value pair.
+  Status WriteFloat(uint32_t field_number, float value) {
+    static_assert(sizeof(float) == sizeof(uint32_t),
+                  "Float and uint32_t are not the same size");
+    return WriteFixedField(field_number, WireType::kFixed32, value);
+  }
+
+  // Writes a repeated float field using packed encoding.
+  Status WritePackedFloat(uint32_t field_number,
+                          std::span<const float> values) {
+    return WriteBytes(field_number, std::as_bytes(values));
+  }
+
+  // Writes a proto double key-value pair.
+  Status WriteDouble(uint32_t field_number, double value) {
+    static_assert(sizeof(double) == sizeof(uint64_t),
+                  "Double and uint64_t are not the same size");
+    return WriteFixedField(field_number, WireType::kFixed64, value);
+  }
+
+  // Writes a repeated double field using packed encoding.
+  Status WritePackedDouble(uint32_t field_number,
+                           std::span<const double> values) {
+    return WriteBytes(field_number, std::as_bytes(values));
+  }
+
+  // Writes a proto bytes key-value pair.
+  Status WriteBytes(uint32_t field_number, ConstByteSpan value) {
+    if (Status status = WriteLengthDelimitedHeader(field_number, value.size());
+        !status.ok()) {
+      return status;
+    }
+    return Write(value);
+  }
+
+  // Writes a proto bytes key-value pair whose value is the chunks joined
+  // together. The chunks are written in place, so data that is split in
+  // memory, such as a ring buffer entry that wraps around, is not copied.
+  Status WriteBytes(uint32_t field_number,
+                    std::span<const ConstByteSpan> chunks);
+
+  // Writes a proto string key-value pair.
+  Status WriteString(uint32_t field_number, const char* value, size_t size) {
+    return WriteBytes(field_number, std::as_bytes(std::span(value, size)));
+  }
+
+  Status WriteString(uint32_t field_number, const char* value) {
+    return WriteString(field_number, value, std::strlen(value));
+  }
+
+  // Starts a nested message. Its fields are written to the returned encoder,
+  // which encodes them into the scratch buffer. When the returned encoder is
+  // destroyed, the nested message is written to this encoder. Nothing may be
+  // written to this encoder while the nested encoder exists.
+  //
+  //   {
+  //     StreamEncoder nested = encoder.GetNestedEncoder(kFieldNumber);
+  //     nested.WriteUint32(1, 1234);
+  //   }  // The nested message is written here.
+  //
+  StreamEncoder GetNestedEncoder(uint32_t field_number);
+
+  // Returns OK if every field has been encoded and written successfully, or the
+  // first error otherwise.
+  Status status() const { return status_; }
+
+ private:
+  constexpr StreamEncoder(stream::Writer* writer,
+                          StreamEncoder* parent,
+                          uint32_t field_number,
+                          ByteSpan memory,
+                          Status status)
+      : writer_(writer),
+        parent_(parent),
+        field_number_(field_number),
+        memory_(memory),
+        memory_size_(0),
+        nested_open_(false),
+        status_(status) {}
+
+  static constexpr bool ValidFieldNumber(uint32_t field_number) {
+    return field_number != 0 && field_number <= (1u << 29) - 1 &&
+           !(field_number >= 19000 && field_number <= 19999);
+  }
+
+  Status WriteVarintField(uint32_t field_number, uint64_t value);
+
+  template <typename T>
+  Status WriteFixedField(uint32_t field_number, WireType type, T value) {
+    std::array<std::byte, kMaxSizeOfFieldKey + sizeof(T)> field;
+    size_t size = 0;
+    if (Status status = EncodeKey(field_number, type, field, size);
+        !status.ok()) {
+      return status;
+    }
+    std::memcpy(&field[size], &value, sizeof(value));
+    return Write(std::span(field).first(size + sizeof(value)));
+  }
+
+  // Writes a list of varints in length-delimited packed encoding. If zigzag is
+  // true, zig-zag encodes each of the varints.
+  template <typename T>
+  Status WritePackedVarints(uint32_t field_number,
+                            std::span<const T> values,
+                            bool zigzag) {
+    auto encode = [zigzag](T value) -> uint64_t {
+      if (zigzag) {
+        return varint::ZigZagEncode(static_cast<std::make_signed_t<T>>(value));
+      }
+      return static_cast<uint64_t>(value);
+    };
+
+    size_t size = 0;
+    for (T value : values) {
+      size += varint::EncodedSize(encode(value));
+    }
+    if (Status status = WriteLengthDelimitedHeader(field_number, size);
+        !status.ok()) {
+      return status;
+    }
+
+    // Collect varints in a small buffer to avoid a write for each one.
+    std::array<std::byte, 8 * varint::kMaxVarint64SizeBytes> chunk;
+    size_t chunk_size = 0;
+    for (T value : values) {
+      if (chunk.size() - chunk_size < varint::kMaxVarint64SizeBytes) {
+        if (Status status = Write(std::span(chunk).first(chunk_size));
+            !status.ok()) {
+          return status;
+        }
+        chunk_size = 0;
+      }
+      chunk_size += varint::EncodeLittleEndianBase128(
+          encode(value), std::span(chunk).subspan(chunk_size));
+    }
+    return Write(std::span(chunk).first(chunk_size));
+  }
+
+  // Writes the key and length of a length-delimited field.
+  Status WriteLengthDelimitedHeader(uint32_t field_number, size_t size);
+
+  // Encodes a field key at the start of buffer. Sets size to its length.
+  Status EncodeKey(uint32_t field_number,
+                   WireType type,
+                   ByteSpan buffer,
+                   size_t& size);
+
+  // Writes encoded data to the stream or, for a nested encoder, to memory.
+  Status Write(ConstByteSpan data);
+
+  // Writes a finished nested message to this encoder.
+  void CloseNestedEncoder(StreamEncoder& nested);
+
+  // Records an error, if there is not one already, and returns the first error.
+  Status SetError(Status status) {
+    if (status_.ok()) {
+      status_ = status;
+    }
+    return status_;
+  }
+
+  // The stream, or null for a nested encoder.
+  stream::Writer* const writer_;
+
+  // The encoder that a nested encoder writes its message to when it is done.
+  StreamEncoder* const parent_;
+  const uint32_t field_number_;
+
+  // For the top-level encoder, the scratch buffer for nested messages. For a
+  // nested encoder, the memory that holds its message.
+  const ByteSpan memory_;
+  size_t memory_size_;
+
+  bool nested_open_;
+  Status status_;
+};
+
+}  // namespace pw::protobuf
@@ -35,6 +35,7 @@ PROTO_CC_EXTENSION = '.pwpb.cc'
 
 PROTOBUF_NAMESPACE = 'pw::protobuf'
 BASE_PROTO_CLASS = 'ProtoMessageEncoder'
+BASE_PROTO_DECODER_CLASS = 'ProtoMessageDecoder'
 
 
 # protoc captures stdout, so we need to printf debug to stderr.
@@ -507,6 +508,381 @@ PROTO_FIELD_METHODS: Dict[int, List] = {
 }
 
 
+class ReadMethod(ProtoMethod):
+    """Base class representing a decoder read method.
+
+    Read methods have following format (for the proto field foo):
+
+        Status ReadFoo({type}* value) {
+          return decoder_.Read{type}(value);
+        }
+
+    """
+    def name(self) -> str:
+        return 'Read{}'.format(self._field.name())
+
+    def should_appear(self) -> bool:
+        # Repeated scalars are only read with the packed method, which also
+        # accepts non-packed values. Overloading the two would be ambiguous
+        # for arrays, which decay to pointers.
+        if not self._field.is_repeated():
+            return True
+        return not any(
+            issubclass(method, PackedReadMethod)
+            for method in PROTO_FIELD_READ_METHODS[self._field.type()])
+
+    def return_type(self, from_root: bool = False) -> str:
+        return '::pw::Status'
+
+    def params(self) -> List[Tuple[str, str]]:
+        return [(f'{self._value_type()}*', 'value')]
+
+    def body(self) -> List[str]:
+        return [f'return decoder_.{self._decoder_fn()}(value);']
+
+    def in_class_definition(self) -> bool:
+        return True
+
+    def _value_type(self) -> str:
+        """The C++ type of the value read.
+
+        Defined in subclasses.
+        """
+        raise NotImplementedError()
+
+    def _decoder_fn(self) -> str:
+        """The decoder function to call.
+
+        Defined in subclasses.
+
+        e.g. 'ReadUint32', 'ReadBytes', etc.
+        """
+        raise NotImplementedError()
+
+
+class PackedReadMethod(ReadMethod):
+    """A method which reads a repeated scalar field into an array.
+
+    Only generated for repeated fields. Packed values are decoded in bulk, and
+    a single non-packed value is also accepted. The method returns the number of
+    values read.
+    """
+    def should_appear(self) -> bool:
+        return self._field.is_repeated()
+
+    def return_type(self, from_root: bool = False) -> str:
+        return '::pw::StatusWithSize'
+
+    def params(self) -> List[Tuple[str, str]]:
+        return [(f'std::span<{self._value_type()}>', 'values')]
+
+    def body(self) -> List[str]:
+        return [f'return decoder_.{self._decoder_fn()}(values);']
+
+
+#
+# The following code defines read methods for each of the
+# primitive protobuf types.
+#
+
+
+class DoubleReadMethod(ReadMethod):
+    """Method which reads a proto double value."""
+    def _value_type(self) -> str:
+        return 'double'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadDouble'
+
+
+class PackedDoubleReadMethod(PackedReadMethod):
+    """Method which reads a packed list of doubles."""
+    def _value_type(self) -> str:
+        return 'double'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadPackedDouble'
+
+
+class FloatReadMethod(ReadMethod):
+    """Method which reads a proto float value."""
+    def _value_type(self) -> str:
+        return 'float'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadFloat'
+
+
+class PackedFloatReadMethod(PackedReadMethod):
+    """Method which reads a packed list of floats."""
+    def _value_type(self) -> str:
+        return 'float'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadPackedFloat'
+
+
+class Int32ReadMethod(ReadMethod):
+    """Method which reads a proto int32 value."""
+    def _value_type(self) -> str:
+        return 'int32_t'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadInt32'
+
+
+class PackedInt32ReadMethod(PackedReadMethod):
+    """Method which reads a packed list of int32."""
+    def _value_type(self) -> str:
+        return 'int32_t'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadPackedInt32'
+
+
+class Sint32ReadMethod(ReadMethod):
+    """Method which reads a proto sint32 value."""
+    def _value_type(self) -> str:
+        return 'int32_t'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadSint32'
+
+
+class PackedSint32ReadMethod(PackedReadMethod):
+    """Method which reads a packed list of sint32."""
+    def _value_type(self) -> str:
+        return 'int32_t'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadPackedSint32'
+
+
+class Sfixed32ReadMethod(ReadMethod):
+    """Method which reads a proto sfixed32 value."""
+    def _value_type(self) -> str:
+        return 'int32_t'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadSfixed32'
+
+
+class PackedSfixed32ReadMethod(PackedReadMethod):
+    """Method which reads a packed list of sfixed32."""
+    def _value_type(self) -> str:
+        return 'int32_t'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadPackedSfixed32'
+
+
+class Int64ReadMethod(ReadMethod):
+    """Method which reads a proto int64 value."""
+    def _value_type(self) -> str:
+        return 'int64_t'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadInt64'
+
+
+class PackedInt64ReadMethod(PackedReadMethod):
+    """Method which reads a packed list of int64."""
+    def _value_type(self) -> str:
+        return 'int64_t'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadPackedInt64'
+
+
+class Sint64ReadMethod(ReadMethod):
+    """Method which reads a proto sint64 value."""
+    def _value_type(self) -> str:
+        return 'int64_t'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadSint64'
+
+
+class PackedSint64ReadMethod(PackedReadMethod):
+    """Method which reads a packed list of sint64."""
+    def _value_type(self) -> str:
+        return 'int64_t'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadPackedSint64'
+
+
+class Sfixed64ReadMethod(ReadMethod):
+    """Method which reads a proto sfixed64 value."""
+    def _value_type(self) -> str:
+        return 'int64_t'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadSfixed64'
+
+
+class PackedSfixed64ReadMethod(PackedReadMethod):
+    """Method which reads a packed list of sfixed64."""
+    def _value_type(self) -> str:
+        return 'int64_t'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadPackedSfixed64'
+
+
+class Uint32ReadMethod(ReadMethod):
+    """Method which reads a proto uint32 value."""
+    def _value_type(self) -> str:
+        return 'uint32_t'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadUint32'
+
+
+class PackedUint32ReadMethod(PackedReadMethod):
+    """Method which reads a packed list of uint32."""
+    def _value_type(self) -> str:
+        return 'uint32_t'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadPackedUint32'
+
+
+class Fixed32ReadMethod(ReadMethod):
+    """Method which reads a proto fixed32 value."""
+    def _value_type(self) -> str:
+        return 'uint32_t'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadFixed32'
+
+
+class PackedFixed32ReadMethod(PackedReadMethod):
+    """Method which reads a packed list of fixed32."""
+    def _value_type(self) -> str:
+        return 'uint32_t'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadPackedFixed32'
+
+
+class Uint64ReadMethod(ReadMethod):
+    """Method which reads a proto uint64 value."""
+    def _value_type(self) -> str:
+        return 'uint64_t'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadUint64'
+
+
+class PackedUint64ReadMethod(PackedReadMethod):
+    """Method which reads a packed list of uint64."""
+    def _value_type(self) -> str:
+        return 'uint64_t'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadPackedUint64'
+
+
+class Fixed64ReadMethod(ReadMethod):
+    """Method which reads a proto fixed64 value."""
+    def _value_type(self) -> str:
+        return 'uint64_t'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadFixed64'
+
+
+class PackedFixed64ReadMethod(PackedReadMethod):
+    """Method which reads a packed list of fixed64."""
+    def _value_type(self) -> str:
+        return 'uint64_t'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadPackedFixed64'
+
+
+class BoolReadMethod(ReadMethod):
+    """Method which reads a proto bool value."""
+    def _value_type(self) -> str:
+        return 'bool'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadBool'
+
+
+class BytesReadMethod(ReadMethod):
+    """Method which reads a proto bytes value.
+
+    Also used for submessages, which can then be decoded with their own
+    decoder class.
+    """
+    def _value_type(self) -> str:
+        return 'std::span<const std::byte>'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadBytes'
+
+
+class StringReadMethod(ReadMethod):
+    """Method which reads a proto string value."""
+    def _value_type(self) -> str:
+        return 'std::string_view'
+
+    def _decoder_fn(self) -> str:
+        return 'ReadString'
+
+
+class EnumReadMethod(ReadMethod):
+    """Method which reads a proto enum value."""
+    def _value_type(self) -> str:
+        return self._relative_type_namespace()
+
+    def body(self) -> List[str]:
+        return [
+            'uint32_t raw_value = 0;',
+            '::pw::Status status = decoder_.ReadUint32(&raw_value);',
+            'if (status.ok()) {',
+            f'  *value = static_cast<{self._value_type()}>(raw_value);',
+            '}',
+            'return status;',
+        ]
+
+
+# Mapping of protobuf field types to their decoder method definitions.
+PROTO_FIELD_READ_METHODS: Dict[int, List] = {
+    descriptor_pb2.FieldDescriptorProto.TYPE_DOUBLE:
+    [DoubleReadMethod, PackedDoubleReadMethod],
+    descriptor_pb2.FieldDescriptorProto.TYPE_FLOAT:
+    [FloatReadMethod, PackedFloatReadMethod],
+    descriptor_pb2.FieldDescriptorProto.TYPE_INT32:
+    [Int32ReadMethod, PackedInt32ReadMethod],
+    descriptor_pb2.FieldDescriptorProto.TYPE_SINT32:
+    [Sint32ReadMethod, PackedSint32ReadMethod],
+    descriptor_pb2.FieldDescriptorProto.TYPE_SFIXED32:
+    [Sfixed32ReadMethod, PackedSfixed32ReadMethod],
+    descriptor_pb2.FieldDescriptorProto.TYPE_INT64:
+    [Int64ReadMethod, PackedInt64ReadMethod],
+    descriptor_pb2.FieldDescriptorProto.TYPE_SINT64:
+    [Sint64ReadMethod, PackedSint64ReadMethod],
+    descriptor_pb2.FieldDescriptorProto.TYPE_SFIXED64:
+    [Sfixed64ReadMethod, PackedSfixed64ReadMethod],
+    descriptor_pb2.FieldDescriptorProto.TYPE_UINT32:
+    [Uint32ReadMethod, PackedUint32ReadMethod],
+    descriptor_pb2.FieldDescriptorProto.TYPE_FIXED32:
+    [Fixed32ReadMethod, PackedFixed32ReadMethod],
+    descriptor_pb2.FieldDescriptorProto.TYPE_UINT64:
+    [Uint64ReadMethod, PackedUint64ReadMethod],
+    descriptor_pb2.FieldDescriptorProto.TYPE_FIXED64:
+    [Fixed64ReadMethod, PackedFixed64ReadMethod],
+    descriptor_pb2.FieldDescriptorProto.TYPE_BOOL: [BoolReadMethod],
+    descriptor_pb2.FieldDescriptorProto.TYPE_BYTES: [BytesReadMethod],
+    descriptor_pb2.FieldDescriptorProto.TYPE_STRING: [StringReadMethod],
+    descriptor_pb2.FieldDescriptorProto.TYPE_MESSAGE: [BytesReadMethod],
+    descriptor_pb2.FieldDescriptorProto.TYPE_ENUM: [EnumReadMethod],
+}
+
+
 def generate_code_for_message(message: ProtoMessage, root: ProtoNode,
                               output: OutputFile) -> None:
     """Creates a C++ class for a protobuf message."""
@@ -550,6 +926,50 @@ def generate_code_for_message(message: ProtoMessage, root: ProtoNode,
     output.write_line('};')
 
 
+def generate_decoder_for_message(message: ProtoMessage, root: ProtoNode,
+                                 output: OutputFile) -> None:
+    """Creates a C++ decoder class for a protobuf message."""
+    assert message.type() == ProtoNode.Type.MESSAGE
+
+    base_class = f'{PROTOBUF_NAMESPACE}::{BASE_PROTO_DECODER_CLASS}'
+    output.write_line(
+        f'class {message.cpp_namespace(root)}::Decoder : public {base_class} {{'
+    )
+    output.write_line(' public:')
+
+    with output.indent():
+        output.write_line(
+            f'using {BASE_PROTO_DECODER_CLASS}::{BASE_PROTO_DECODER_CLASS};')
+
+        # Fields are dispatched by switching on the field enum, which the
+        # compiler turns into a jump table keyed on the field number.
+        output.write_line()
+        output.write_line('// Returns the field at the current position.')
+        output.write_line('Fields Field() const {')
+        with output.indent():
+            output.write_line(
+                'return static_cast<Fields>(decoder_.FieldNumber());')
+        output.write_line('}')
+
+        # Generate methods for each of the message's fields.
+        for field in message.fields():
+            for method_class in PROTO_FIELD_READ_METHODS[field.type()]:
+                method = method_class(field, message, root)
+                if not method.should_appear():
+                    continue
+
+                output.write_line()
+                output.write_line(
+                    f'{method.return_type()} '
+                    f'{method.name()}({method.param_string()}) {{')
+                with output.indent():
+                    for line in method.body():
+                        output.write_line(line)
+                output.write_line('}')
+
+    output.write_line('};')
+
+
 def define_not_in_class_methods(message: ProtoMessage, root: ProtoNode,
                                 output: OutputFile) -> None:
     """Defines methods for a message class that were previously declared."""
@@ -599,9 +1019,10 @@ def forward_declare(node: ProtoMessage, root: ProtoNode,
             output.write_line(f'{field.enum_name()} = {field.number()},')
     output.write_line('};')
 
-    # Declare the message's encoder class and all of its enums.
+    # Declare the message's encoder and decoder classes and all of its enums.
     output.write_line()
     output.write_line('class Encoder;')
+    output.write_line('class Decoder;')
     for child in node.children():
         if child.type() == ProtoNode.Type.ENUM:
             output.write_line()
@@ -627,7 +1048,8 @@ def generate_code_for_package(file_descriptor_proto, package: ProtoNode,
     output.write_line('#pragma once\n')
     output.write_line('#include <cstddef>')
     output.write_line('#include <cstdint>')
-    output.write_line('#include <span>\n')
+    output.write_line('#include <span>')
+    output.write_line('#include <string_view>\n')
     output.write_line('#include "pw_protobuf/codegen.h"')
 
     for imported_file in file_descriptor_proto.dependency:
@@ -657,6 +1079,9 @@ def generate_code_for_package(file_descriptor_proto, package: ProtoNode,
             output.write_line()
             generate_code_for_message(cast(ProtoMessage, node), package,
                                       output)
+            output.write_line()
+            generate_decoder_for_message(cast(ProtoMessage, node), package,
+                                         output)
 
     # Run a second pass through the classes, this time defining all of the
     # methods which were previously only declared.
@@ -0,0 +1,346 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_protobuf/stream_decoder.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "pw_varint/varint.h"
+
+namespace pw::protobuf {
+namespace {
+
+// The end of the stream within a field means the field was truncated.
+Status TruncatedIfOutOfRange(Status status) {
+  return status.IsOutOfRange() ? Status::DataLoss() : status;
+}
+
+}  // namespace
+
+StreamDecoder::BytesReader::~BytesReader() {
+  if (decoder_ != nullptr) {
+    decoder_->nested_open_ = false;
+  }
+}
+
+StatusWithSize StreamDecoder::BytesReader::DoRead(ByteSpan dest) {
+  if (!status_.ok()) {
+    return StatusWithSize(status_, 0);
+  }
+  if (remaining_ == 0) {
+    return StatusWithSize::OutOfRange();
+  }
+
+  const size_t size = std::min(dest.size(), remaining_);
+  if (Status status = decoder_->ReadExact(dest.first(size)); !status.ok()) {
+    status_ = decoder_->SetError(TruncatedIfOutOfRange(status));
+    return StatusWithSize(status_, 0);
+  }
+  remaining_ -= size;
+  return StatusWithSize(size);
+}
+
+StreamDecoder::~StreamDecoder() {
+  if (parent_ != nullptr) {
+    parent_->nested_open_ = false;
+  }
+}
+
+Status StreamDecoder::Next() {
+  if (nested_open_) {
+    return Status::FailedPrecondition();
+  }
+  if (!status_.ok()) {
+    return status_;
+  }
+
+  if (!field_consumed_) {
+    if (Status status = SkipField(); !status.ok()) {
+      return SetError(TruncatedIfOutOfRange(status));
+    }
+    field_consumed_ = true;
+  }
+
+  uint64_t key;
+  if (Status status = ReadVarint(&key); !status.ok()) {
+    // The message may only end between fields.
+    return status.IsOutOfRange() ? status : SetError(status);
+  }
+
+  const uint64_t field_number = key >> kFieldNumberShift;
+  if (field_number == 0 ||
+      field_number > std::numeric_limits<uint32_t>::max()) {
+    return SetError(Status::DataLoss());
+  }
+  field_number_ = static_cast<uint32_t>(field_number);
+  wire_type_ = static_cast<WireType>(key & kWireTypeMask);
+
+  uint64_t field_size = 0;
+  switch (wire_type_) {
+    case WireType::kVarint:
+      break;
+
+    case WireType::kDelimited:
+      if (Status status = ReadVarint(&field_size); !status.ok()) {
+        return SetError(TruncatedIfOutOfRange(status));
+      }
+      break;
+
+    case WireType::kFixed32:
+      field_size = sizeof(uint32_t);
+      break;
+
+    case WireType::kFixed64:
+      field_size = sizeof(uint64_t);
+      break;
+
+    default:
+      return SetError(Status::DataLoss());
+  }
+
+  if (field_size > limit_ - position_) {
+    return SetError(Status::DataLoss());
+  }
+  field_end_ = position_ + field_size;
+  field_consumed_ = false;
+  return OkStatus();
+}
+
+Status StreamDecoder::ReadUint32(uint32_t* out) {
+  uint64_t value = 0;
+  Status status = ReadUint64(&value);
+  if (!status.ok()) {
+    return status;
+  }
+  if (value > std::numeric_limits<uint32_t>::max()) {
+    return Status::OutOfRange();
+  }
+  *out = value;
+  return OkStatus();
+}
+
+Status StreamDecoder::ReadSint32(int32_t* out) {
+  int64_t value = 0;
+  Status status = ReadSint64(&value);
+  if (!status.ok()) {
+    return status;
+  }
+  if (value > std::numeric_limits<int32_t>::max()) {
+    return Status::OutOfRange();
+  }
+  *out = value;
+  return OkStatus();
+}
+
+Status StreamDecoder::ReadSint64(int64_t* out) {
+  uint64_t value = 0;
+  Status status = ReadUint64(&value);
+  if (!status.ok()) {
+    return status;
+  }
+  *out = varint::ZigZagDecode(value);
+  return OkStatus();
+}
+
+Status StreamDecoder::ReadBool(bool* out) {
+  uint64_t value = 0;
+  Status status = ReadUint64(&value);
+  if (!status.ok()) {
+    return status;
+  }
+  *out = value;
+  return OkStatus();
+}
+
+StatusWithSize StreamDecoder::ReadBytes(ByteSpan out) {
+  if (Status status = CheckField(WireType::kDelimited); !status.ok()) {
+    return StatusWithSize(status, 0);
+  }
+
+  const size_t size = field_end_ - position_;
+  if (size > out.size()) {
+    return StatusWithSize::ResourceExhausted();
+  }
+  if (Status status = ReadExact(out.first(size)); !status.ok()) {
+    return StatusWithSize(SetError(TruncatedIfOutOfRange(status)), 0);
+  }
+  field_consumed_ = true;
+  return StatusWithSize(size);
+}
+
+StreamDecoder::BytesReader StreamDecoder::GetBytesReader() {
+  if (Status status = CheckField(WireType::kDelimited); !status.ok()) {
+    return BytesReader(nullptr, 0, status);
+  }
+
+  nested_open_ = true;
+  return BytesReader(this, field_end_ - position_, OkStatus());
+}
+
+StreamDecoder StreamDecoder::GetNestedDecoder() {
+  if (Status status = CheckField(WireType::kDelimited); !status.ok()) {
+    return StreamDecoder(nullptr, nullptr, ByteSpan(), 0, status);
+  }
+
+  nested_open_ = true;
+  return StreamDecoder(
+      nullptr, this, ByteSpan(), field_end_ - position_, OkStatus());
+}
+
+Status StreamDecoder::ReadVarintField(uint64_t* out) {
+  if (Status status = CheckField(WireType::kVarint); !status.ok()) {
+    return status;
+  }
+  if (Status status = ReadVarint(out); !status.ok()) {
+    return SetError(TruncatedIfOutOfRange(status));
+  }
+  field_consumed_ = true;
+  return OkStatus();
+}
+
+Status StreamDecoder::ReadFixed(std::byte* out, size_t size) {
+  const WireType expected_wire_type =
+      size == sizeof(uint32_t) ? WireType::kFixed32 : WireType::kFixed64;
+  if (Status status = CheckField(expected_wire_type); !status.ok()) {
+    return status;
+  }
+  if (Status status = ReadExact(std::span(out, size)); !status.ok()) {
+    return SetError(TruncatedIfOutOfRange(status));
+  }
+  field_consumed_ = true;
+  return OkStatus();
+}
+
+Status StreamDecoder::CheckField(WireType expected_type) const {
+  if (!status_.ok()) {
+    return status_;
+  }
+  if (nested_open_ || field_consumed_ || wire_type_ != expected_type) {
+    return Status::FailedPrecondition();
+  }
+  return OkStatus();
+}
+
+Status StreamDecoder::SkipField() {
+  if (wire_type_ == WireType::kVarint) {
+    uint64_t value;
+    return ReadVarint(&value);
+  }
+  return Skip(field_end_ - position_);
+}
+
+Status StreamDecoder::ReadVarint(uint64_t* out) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < varint::kMaxVarint64SizeBytes; ++i) {
+    std::byte b;
+    if (Status status = ReadExact(std::span(&b, 1)); !status.ok()) {
+      return i == 0 ? status : TruncatedIfOutOfRange(status);
+    }
+    value |= static_cast<uint64_t>(b & std::byte{0x7f}) << (7 * i);
+    if ((b & std::byte{0x80}) == std::byte{0}) {
+      *out = value;
+      return OkStatus();
+    }
+  }
+  return Status::DataLoss();
+}
+
+Status StreamDecoder::ReadExact(ByteSpan dest) {
+  if (dest.empty()) {
+    return OkStatus();
+  }
+
+  const size_t available = limit_ - position_;
+  if (available == 0) {
+    return Status::OutOfRange();
+  }
+  if (dest.size() > available) {
+    return Status::DataLoss();
+  }
+
+  if (parent_ != nullptr) {
+    // The parent already checked that the nested message is within its bounds,
+    // so it ending early is always data loss.
+    if (Status status = parent_->ReadExact(dest); !status.ok()) {
+      return TruncatedIfOutOfRange(status);
+    }
+    position_ += dest.size();
+    return OkStatus();
+  }
+
+  if (reader_ == nullptr) {
+    return Status::FailedPrecondition();
+  }
+
+  size_t bytes_read = 0;
+  Status status = ReadFromStream(dest, bytes_read);
+  position_ += bytes_read;
+  return status;
+}
+
+Status StreamDecoder::Skip(size_t size) {
+  // Discard buffered data without copying it.
+  if (reader_ != nullptr) {
+    const size_t buffered = std::min(size, window_end_ - window_start_);
+    window_start_ += buffered;
+    position_ += buffered;
+    size -= buffered;
+  }
+
+  std::array<std::byte, 16> discard;
+  while (size > 0) {
+    const size_t chunk = std::min(size, discard.size());
+    if (Status status = ReadExact(std::span(discard).first(chunk));
+        !status.ok()) {
+      return TruncatedIfOutOfRange(status);
+    }
+    size -= chunk;
+  }
+  return OkStatus();
+}
+
+Status StreamDecoder::ReadFromStream(ByteSpan dest, size_t& bytes_read) {
+  while (bytes_read < dest.size()) {
+    if (window_start_ == window_end_) {
+      // Large reads bypass the window.
+      ByteSpan remaining = dest.subspan(bytes_read);
+      ByteSpan read_into = remaining.size() >= window_.size() ? remaining
+                                                              : window_;
+
+      Result<ByteSpan> result = reader_->Read(read_into);
+      if (!result.ok() || result.value().empty()) {
+        Status status = result.ok() ? Status::OutOfRange() : result.status();
+        return bytes_read == 0 ? status : TruncatedIfOutOfRange(status);
+      }
+
+      if (read_into.data() == remaining.data()) {
+        bytes_read += result.value().size();
+        continue;
+      }
+      window_start_ = 0;
+      window_end_ = result.value().size();
+    }
+
+    const size_t size =
+        std::min(window_end_ - window_start_, dest.size() - bytes_read);
+    std::memcpy(&dest[bytes_read], &window_[window_start_], size);
+    window_start_ += size;
+    bytes_read += size;
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::protobuf
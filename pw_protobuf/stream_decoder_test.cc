@@ -0,0 +1,276 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_protobuf/stream_decoder.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::protobuf {
+namespace {
+
+// clang-format off
+constexpr uint8_t kEncodedProto[] = {
+  // type=int32, k=1, v=42
+  0x08, 0x2a,
+  // type=sint32, k=2, v=-13
+  0x10, 0x19,
+  // type=bool, k=3, v=false
+  0x18, 0x00,
+  // type=double, k=4, v=3.14159
+  0x21, 0x6e, 0x86, 0x1b, 0xf0, 0xf9, 0x21, 0x09, 0x40,
+  // type=fixed32, k=5, v=0xdeadbeef
+  0x2d, 0xef, 0xbe, 0xad, 0xde,
+  // type=string, k=6, v="Hello world"
+  0x32, 0x0b, 'H', 'e', 'l', 'l', 'o', ' ', 'w', 'o', 'r', 'l', 'd',
+  // type=message, k=7, v={ k=1 int32 v=7, k=2 string v="hi" }
+  0x3a, 0x06, 0x08, 0x07, 0x12, 0x02, 'h', 'i',
+  // type=uint64, k=8, v=300
+  0x40, 0xac, 0x02,
+};
+// clang-format on
+
+// Reads from memory and counts the calls to Read().
+class CountingReader : public stream::Reader {
+ public:
+  CountingReader(ConstByteSpan data) : reader_(data) {}
+
+  size_t reads() const { return reads_; }
+
+ private:
+  StatusWithSize DoRead(ByteSpan dest) override {
+    reads_ += 1;
+    Result<ByteSpan> result = reader_.Read(dest);
+    if (!result.ok()) {
+      return StatusWithSize(result.status(), 0);
+    }
+    return StatusWithSize(result.value().size());
+  }
+
+  stream::MemoryReader reader_;
+  size_t reads_ = 0;
+};
+
+void DecodeAll(StreamDecoder& decoder) {
+  int32_t v1 = 0;
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  ASSERT_EQ(decoder.FieldNumber(), 1u);
+  EXPECT_EQ(decoder.ReadInt32(&v1), OkStatus());
+  EXPECT_EQ(v1, 42);
+
+  int32_t v2 = 0;
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  ASSERT_EQ(decoder.FieldNumber(), 2u);
+  EXPECT_EQ(decoder.ReadSint32(&v2), OkStatus());
+  EXPECT_EQ(v2, -13);
+
+  bool v3 = true;
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  ASSERT_EQ(decoder.FieldNumber(), 3u);
+  EXPECT_EQ(decoder.ReadBool(&v3), OkStatus());
+  EXPECT_FALSE(v3);
+
+  double v4 = 0;
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  ASSERT_EQ(decoder.FieldNumber(), 4u);
+  EXPECT_EQ(decoder.ReadDouble(&v4), OkStatus());
+  EXPECT_EQ(v4, 3.14159);
+
+  uint32_t v5 = 0;
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  ASSERT_EQ(decoder.FieldNumber(), 5u);
+  EXPECT_EQ(decoder.ReadFixed32(&v5), OkStatus());
+  EXPECT_EQ(v5, 0xdeadbeef);
+
+  char v6[16] = {};
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  ASSERT_EQ(decoder.FieldNumber(), 6u);
+  StatusWithSize result = decoder.ReadString(v6);
+  EXPECT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), 11u);
+  EXPECT_STREQ(v6, "Hello world");
+
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  ASSERT_EQ(decoder.FieldNumber(), 7u);
+  {
+    StreamDecoder nested = decoder.GetNestedDecoder();
+    int32_t nested_v1 = 0;
+    ASSERT_EQ(nested.Next(), OkStatus());
+    ASSERT_EQ(nested.FieldNumber(), 1u);
+    EXPECT_EQ(nested.ReadInt32(&nested_v1), OkStatus());
+    EXPECT_EQ(nested_v1, 7);
+
+    char nested_v2[4] = {};
+    ASSERT_EQ(nested.Next(), OkStatus());
+    ASSERT_EQ(nested.FieldNumber(), 2u);
+    EXPECT_EQ(nested.ReadString(nested_v2).size(), 2u);
+    EXPECT_STREQ(nested_v2, "hi");
+
+    EXPECT_EQ(nested.Next(), Status::OutOfRange());
+  }
+
+  uint64_t v8 = 0;
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  ASSERT_EQ(decoder.FieldNumber(), 8u);
+  EXPECT_EQ(decoder.ReadUint64(&v8), OkStatus());
+  EXPECT_EQ(v8, 300u);
+
+  EXPECT_EQ(decoder.Next(), Status::OutOfRange());
+}
+
+TEST(StreamDecoder, Decode) {
+  stream::MemoryReader reader(std::as_bytes(std::span(kEncodedProto)));
+  std::byte window[8];
+  StreamDecoder decoder(reader, window);
+  DecodeAll(decoder);
+}
+
+TEST(StreamDecoder, Decode_NoWindow) {
+  stream::MemoryReader reader(std::as_bytes(std::span(kEncodedProto)));
+  StreamDecoder decoder(reader);
+  DecodeAll(decoder);
+}
+
+TEST(StreamDecoder, Decode_WindowReducesReads) {
+  CountingReader unbuffered(std::as_bytes(std::span(kEncodedProto)));
+  StreamDecoder unbuffered_decoder(unbuffered);
+  DecodeAll(unbuffered_decoder);
+
+  CountingReader buffered(std::as_bytes(std::span(kEncodedProto)));
+  std::byte window[16];
+  StreamDecoder buffered_decoder(buffered, window);
+  DecodeAll(buffered_decoder);
+
+  EXPECT_LT(buffered.reads(), unbuffered.reads() / 4);
+}
+
+TEST(StreamDecoder, Decode_SkipsUnusedFields) {
+  stream::MemoryReader reader(std::as_bytes(std::span(kEncodedProto)));
+  std::byte window[4];
+  StreamDecoder decoder(reader, window);
+
+  // Only read the fourth and last fields.
+  EXPECT_EQ(decoder.Next(), OkStatus());
+  EXPECT_EQ(decoder.Next(), OkStatus());
+  EXPECT_EQ(decoder.Next(), OkStatus());
+  EXPECT_EQ(decoder.Next(), OkStatus());
+  ASSERT_EQ(decoder.FieldNumber(), 4u);
+  double v4 = 0;
+  EXPECT_EQ(decoder.ReadDouble(&v4), OkStatus());
+  EXPECT_EQ(v4, 3.14159);
+  EXPECT_EQ(decoder.Next(), OkStatus());
+  EXPECT_EQ(decoder.Next(), OkStatus());
+  EXPECT_EQ(decoder.Next(), OkStatus());
+  {
+    // Start reading the nested message, but leave it unfinished.
+    StreamDecoder nested = decoder.GetNestedDecoder();
+    EXPECT_EQ(nested.Next(), OkStatus());
+  }
+  EXPECT_EQ(decoder.Next(), OkStatus());
+  ASSERT_EQ(decoder.FieldNumber(), 8u);
+  uint32_t v8 = 0;
+  EXPECT_EQ(decoder.ReadUint32(&v8), OkStatus());
+  EXPECT_EQ(v8, 300u);
+  EXPECT_EQ(decoder.Next(), Status::OutOfRange());
+}
+
+TEST(StreamDecoder, BytesReader_ReadsFieldInChunks) {
+  stream::MemoryReader reader(std::as_bytes(std::span(kEncodedProto)));
+  std::byte window[4];
+  StreamDecoder decoder(reader, window);
+
+  for (int i = 0; i < 6; ++i) {
+    ASSERT_EQ(decoder.Next(), OkStatus());
+  }
+  char too_small[4];
+  EXPECT_EQ(decoder.ReadString(too_small).status(),
+            Status::ResourceExhausted());
+
+  char contents[16] = {};
+  {
+    StreamDecoder::BytesReader bytes = decoder.GetBytesReader();
+    EXPECT_EQ(bytes.field_size(), 11u);
+    EXPECT_EQ(decoder.Next(), Status::FailedPrecondition());
+
+    size_t total = 0;
+    while (true) {
+      Result<ByteSpan> result =
+          bytes.Read(std::as_writable_bytes(std::span(contents).subspan(
+              total, std::min<size_t>(3, sizeof(contents) - total))));
+      if (!result.ok()) {
+        EXPECT_EQ(result.status(), Status::OutOfRange());
+        break;
+      }
+      total += result.value().size();
+    }
+    EXPECT_EQ(total, 11u);
+  }
+  EXPECT_STREQ(contents, "Hello world");
+
+  EXPECT_EQ(decoder.Next(), OkStatus());
+  EXPECT_EQ(decoder.FieldNumber(), 7u);
+}
+
+TEST(StreamDecoder, WrongWireType_FailedPrecondition) {
+  stream::MemoryReader reader(std::as_bytes(std::span(kEncodedProto)));
+  StreamDecoder decoder(reader);
+
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  double value;
+  EXPECT_EQ(decoder.ReadDouble(&value), Status::FailedPrecondition());
+  EXPECT_EQ(decoder.GetNestedDecoder().Next(), Status::FailedPrecondition());
+
+  // The field can still be read with the correct type.
+  int32_t v1 = 0;
+  EXPECT_EQ(decoder.ReadInt32(&v1), OkStatus());
+  EXPECT_EQ(v1, 42);
+  EXPECT_EQ(decoder.ReadInt32(&v1), Status::FailedPrecondition());
+}
+
+TEST(StreamDecoder, TruncatedField_DataLoss) {
+  // The string field claims to be longer than the rest of the stream.
+  constexpr uint8_t encoded_proto[] = {0x08, 0x2a, 0x32, 0x0b, 'H', 'e'};
+  stream::MemoryReader reader(std::as_bytes(std::span(encoded_proto)));
+  StreamDecoder decoder(reader);
+
+  EXPECT_EQ(decoder.Next(), OkStatus());
+  EXPECT_EQ(decoder.Next(), OkStatus());
+  EXPECT_EQ(decoder.Next(), Status::DataLoss());
+  EXPECT_EQ(decoder.Next(), Status::DataLoss());
+}
+
+TEST(StreamDecoder, NestedFieldExceedsMessage_DataLoss) {
+  // A nested message whose field is longer than the nested message.
+  constexpr uint8_t encoded_proto[] = {0x0a, 0x03, 0x12, 0x05, 'a', 0x08, 0x01};
+  stream::MemoryReader reader(std::as_bytes(std::span(encoded_proto)));
+  StreamDecoder decoder(reader);
+
+  ASSERT_EQ(decoder.Next(), OkStatus());
+  StreamDecoder nested = decoder.GetNestedDecoder();
+  EXPECT_EQ(nested.Next(), Status::DataLoss());
+}
+
+TEST(StreamDecoder, InvalidFieldNumber_DataLoss) {
+  constexpr uint8_t encoded_proto[] = {0x00, 0x01};
+  stream::MemoryReader reader(std::as_bytes(std::span(encoded_proto)));
+  StreamDecoder decoder(reader);
+
+  EXPECT_EQ(decoder.Next(), Status::DataLoss());
+}
+
+}  // namespace
+}  // namespace pw::protobuf
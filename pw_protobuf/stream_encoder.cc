@@ -0,0 +1,151 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_protobuf/stream_encoder.h"
+
+#include <algorithm>
+
+namespace pw::protobuf {
+
+StreamEncoder::~StreamEncoder() {
+  if (parent_ != nullptr) {
+    parent_->CloseNestedEncoder(*this);
+  }
+}
+
+StreamEncoder StreamEncoder::GetNestedEncoder(uint32_t field_number) {
+  if (!ValidFieldNumber(field_number)) {
+    SetError(Status::InvalidArgument());
+  } else if (nested_open_) {
+    SetError(Status::FailedPrecondition());
+  }
+
+  // A failed nested encoder is not attached to this encoder.
+  if (!status_.ok()) {
+    return StreamEncoder(nullptr, nullptr, field_number, ByteSpan(), status_);
+  }
+
+  // A top-level encoder gives the whole scratch buffer to the nested message.
+  // A nested encoder gives the memory after its own message, leaving room for
+  // the nested message's key and length.
+  ByteSpan memory = memory_;
+  if (writer_ == nullptr) {
+    memory = memory_.subspan(std::min(
+        memory_size_ + kMaxNestedHeaderSizeBytes, memory_.size()));
+  }
+
+  nested_open_ = true;
+  return StreamEncoder(nullptr, this, field_number, memory, OkStatus());
+}
+
+void StreamEncoder::CloseNestedEncoder(StreamEncoder& nested) {
+  nested_open_ = false;
+
+  if (!nested.status_.ok()) {
+    SetError(nested.status_);
+    return;
+  }
+
+  if (!WriteLengthDelimitedHeader(nested.field_number_, nested.memory_size_)
+           .ok()) {
+    return;
+  }
+  Write(nested.memory_.first(nested.memory_size_));
+}
+
+Status StreamEncoder::WriteBytes(uint32_t field_number,
+                                 std::span<const ConstByteSpan> chunks) {
+  size_t size = 0;
+  for (ConstByteSpan chunk : chunks) {
+    size += chunk.size();
+  }
+  if (Status status = WriteLengthDelimitedHeader(field_number, size);
+      !status.ok()) {
+    return status;
+  }
+  for (ConstByteSpan chunk : chunks) {
+    if (chunk.empty()) {
+      continue;
+    }
+    if (Status status = Write(chunk); !status.ok()) {
+      return status;
+    }
+  }
+  return OkStatus();
+}
+
+Status StreamEncoder::WriteVarintField(uint32_t field_number, uint64_t value) {
+  std::array<std::byte, kMaxSizeOfFieldKey + varint::kMaxVarint64SizeBytes>
+      field;
+  size_t size = 0;
+  if (Status status = EncodeKey(field_number, WireType::kVarint, field, size);
+      !status.ok()) {
+    return status;
+  }
+  size += varint::EncodeLittleEndianBase128(value,
+                                            std::span(field).subspan(size));
+  return Write(std::span(field).first(size));
+}
+
+Status StreamEncoder::WriteLengthDelimitedHeader(uint32_t field_number,
+                                                 size_t size) {
+  std::array<std::byte, kMaxNestedHeaderSizeBytes> header;
+  size_t header_size = 0;
+  if (Status status =
+          EncodeKey(field_number, WireType::kDelimited, header, header_size);
+      !status.ok()) {
+    return status;
+  }
+  header_size += varint::EncodeLittleEndianBase128(
+      size, std::span(header).subspan(header_size));
+  return Write(std::span(header).first(header_size));
+}
+
+Status StreamEncoder::EncodeKey(uint32_t field_number,
+                                WireType type,
+                                ByteSpan buffer,
+                                size_t& size) {
+  if (!ValidFieldNumber(field_number)) {
+    return SetError(Status::InvalidArgument());
+  }
+  size = varint::EncodeLittleEndianBase128(MakeKey(field_number, type), buffer);
+  return OkStatus();
+}
+
+Status StreamEncoder::Write(ConstByteSpan data) {
+  if (!status_.ok()) {
+    return status_;
+  }
+  if (nested_open_) {
+    return SetError(Status::FailedPrecondition());
+  }
+
+  if (writer_ != nullptr) {
+    if (Status status = writer_->Write(data); !status.ok()) {
+      return SetError(status);
+    }
+    return OkStatus();
+  }
+
+  if (data.size() > memory_.size() - memory_size_) {
+    return SetError(Status::ResourceExhausted());
+  }
+  // A nested message is moved down over the space reserved for its header, so
+  // the source and destination may overlap.
+  std::memmove(&memory_[memory_size_], data.data(), data.size());
+  memory_size_ += data.size();
+  return OkStatus();
+}
+
+}  // namespace pw::protobuf
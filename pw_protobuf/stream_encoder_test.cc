@@ -0,0 +1,282 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_protobuf/stream_encoder.h"
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::protobuf {
+namespace {
+
+// The tests in this file use the same schemas as encoder_test.cc.
+constexpr uint32_t kTestProtoMagicNumberField = 1;
+constexpr uint32_t kTestProtoZiggyField = 2;
+constexpr uint32_t kTestProtoCyclesField = 3;
+constexpr uint32_t kTestProtoRatioField = 4;
+constexpr uint32_t kTestProtoErrorMessageField = 5;
+constexpr uint32_t kTestProtoNestedField = 6;
+
+constexpr uint32_t kNestedProtoHelloField = 1;
+constexpr uint32_t kNestedProtoIdField = 2;
+constexpr uint32_t kNestedProtoPairField = 3;
+
+constexpr uint32_t kDoubleNestedProtoKeyField = 1;
+constexpr uint32_t kDoubleNestedProtoValueField = 2;
+
+// Writes to memory and counts the calls to Write().
+class CountingWriter : public stream::Writer {
+ public:
+  CountingWriter(ByteSpan buffer) : writer_(buffer) {}
+
+  size_t writes() const { return writes_; }
+  ConstByteSpan data() const {
+    return ConstByteSpan(writer_.data(), writer_.bytes_written());
+  }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    writes_ += 1;
+    return writer_.Write(data);
+  }
+
+  stream::MemoryWriter writer_;
+  size_t writes_ = 0;
+};
+
+bool SameBytes(ConstByteSpan actual, ConstByteSpan expected) {
+  return actual.size() == expected.size() &&
+         std::memcmp(actual.data(), expected.data(), actual.size()) == 0;
+}
+
+TEST(StreamEncoder, EncodePrimitives_MatchesEncoder) {
+  std::byte stream_buffer[64];
+  CountingWriter writer(stream_buffer);
+  StreamEncoder encoder(writer, ByteSpan());
+
+  EXPECT_EQ(encoder.WriteUint32(kTestProtoMagicNumberField, 42), OkStatus());
+  EXPECT_EQ(encoder.WriteSint32(kTestProtoZiggyField, -13), OkStatus());
+  EXPECT_EQ(encoder.WriteFixed64(kTestProtoCyclesField, 0xdeadbeef8badf00d),
+            OkStatus());
+  EXPECT_EQ(encoder.WriteFloat(kTestProtoRatioField, 1.618034), OkStatus());
+  EXPECT_EQ(encoder.WriteString(kTestProtoErrorMessageField, "broken 💩"),
+            OkStatus());
+  EXPECT_EQ(encoder.status(), OkStatus());
+
+  std::byte encode_buffer[64];
+  NestedEncoder expected(encode_buffer);
+  expected.WriteUint32(kTestProtoMagicNumberField, 42);
+  expected.WriteSint32(kTestProtoZiggyField, -13);
+  expected.WriteFixed64(kTestProtoCyclesField, 0xdeadbeef8badf00d);
+  expected.WriteFloat(kTestProtoRatioField, 1.618034);
+  expected.WriteString(kTestProtoErrorMessageField, "broken 💩");
+
+  Result result = expected.Encode();
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_TRUE(SameBytes(writer.data(), result.value()));
+
+  // One write per scalar field and two for the string.
+  EXPECT_EQ(writer.writes(), 6u);
+}
+
+TEST(StreamEncoder, Nested_MatchesEncoder) {
+  std::byte stream_buffer[128];
+  stream::MemoryWriter writer(stream_buffer);
+  std::byte scratch[64];
+  StreamEncoder encoder(writer, scratch);
+
+  EXPECT_EQ(encoder.WriteUint32(kTestProtoMagicNumberField, 42), OkStatus());
+  {
+    StreamEncoder nested = encoder.GetNestedEncoder(kTestProtoNestedField);
+    EXPECT_EQ(nested.WriteString(kNestedProtoHelloField, "world"), OkStatus());
+    EXPECT_EQ(nested.WriteUint32(kNestedProtoIdField, 999), OkStatus());
+    {
+      StreamEncoder pair = nested.GetNestedEncoder(kNestedProtoPairField);
+      EXPECT_EQ(pair.WriteString(kDoubleNestedProtoKeyField, "version"),
+                OkStatus());
+      EXPECT_EQ(pair.WriteString(kDoubleNestedProtoValueField, "2.9.1"),
+                OkStatus());
+    }
+    {
+      StreamEncoder pair = nested.GetNestedEncoder(kNestedProtoPairField);
+      EXPECT_EQ(pair.WriteString(kDoubleNestedProtoKeyField, "device"),
+                OkStatus());
+      EXPECT_EQ(pair.WriteString(kDoubleNestedProtoValueField, "left-soc"),
+                OkStatus());
+    }
+  }
+  EXPECT_EQ(encoder.WriteSint32(kTestProtoZiggyField, -13), OkStatus());
+  EXPECT_EQ(encoder.status(), OkStatus());
+
+  std::byte encode_buffer[128];
+  NestedEncoder<5, 5> expected(encode_buffer);
+  expected.WriteUint32(kTestProtoMagicNumberField, 42);
+  expected.Push(kTestProtoNestedField);
+  expected.WriteString(kNestedProtoHelloField, "world");
+  expected.WriteUint32(kNestedProtoIdField, 999);
+  expected.Push(kNestedProtoPairField);
+  expected.WriteString(kDoubleNestedProtoKeyField, "version");
+  expected.WriteString(kDoubleNestedProtoValueField, "2.9.1");
+  expected.Pop();
+  expected.Push(kNestedProtoPairField);
+  expected.WriteString(kDoubleNestedProtoKeyField, "device");
+  expected.WriteString(kDoubleNestedProtoValueField, "left-soc");
+  expected.Pop();
+  expected.Pop();
+  expected.WriteSint32(kTestProtoZiggyField, -13);
+
+  Result result = expected.Encode();
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_TRUE(SameBytes(
+      std::span(writer.data(), writer.bytes_written()), result.value()));
+}
+
+TEST(StreamEncoder, Nested_WriteToParentWhileOpen_Fails) {
+  std::byte stream_buffer[32];
+  stream::MemoryWriter writer(stream_buffer);
+  std::byte scratch[32];
+  StreamEncoder encoder(writer, scratch);
+
+  {
+    StreamEncoder nested = encoder.GetNestedEncoder(1);
+    EXPECT_EQ(encoder.WriteUint32(2, 1), Status::FailedPrecondition());
+  }
+  EXPECT_EQ(encoder.status(), Status::FailedPrecondition());
+}
+
+TEST(StreamEncoder, Nested_ScratchTooSmall_PropagatesError) {
+  std::byte stream_buffer[32];
+  stream::MemoryWriter writer(stream_buffer);
+  std::byte scratch[4];
+  StreamEncoder encoder(writer, scratch);
+
+  {
+    StreamEncoder nested = encoder.GetNestedEncoder(1);
+    EXPECT_EQ(nested.WriteString(1, "too long"), Status::ResourceExhausted());
+  }
+  EXPECT_EQ(encoder.status(), Status::ResourceExhausted());
+  EXPECT_EQ(writer.bytes_written(), 0u);
+}
+
+TEST(StreamEncoder, NestedEmpty) {
+  std::byte stream_buffer[8];
+  stream::MemoryWriter writer(stream_buffer);
+  StreamEncoder encoder(writer, ByteSpan());
+
+  { StreamEncoder nested = encoder.GetNestedEncoder(1); }
+
+  EXPECT_EQ(encoder.status(), OkStatus());
+  constexpr uint8_t encoded_proto[] = {0x0a, 0x00};
+  EXPECT_TRUE(SameBytes(std::span(writer.data(), writer.bytes_written()),
+                        std::as_bytes(std::span(encoded_proto))));
+}
+
+TEST(StreamEncoder, InvalidFieldNumber) {
+  std::byte stream_buffer[16];
+  stream::MemoryWriter writer(stream_buffer);
+  StreamEncoder encoder(writer, ByteSpan());
+
+  EXPECT_EQ(encoder.WriteUint32(kTestProtoMagicNumberField, 42), OkStatus());
+  EXPECT_EQ(encoder.WriteBool(19091, false), Status::InvalidArgument());
+  // Errors are sticky.
+  EXPECT_EQ(encoder.WriteUint32(kTestProtoMagicNumberField, 42),
+            Status::InvalidArgument());
+  EXPECT_EQ(encoder.status(), Status::InvalidArgument());
+  EXPECT_EQ(writer.bytes_written(), 2u);
+}
+
+TEST(StreamEncoder, WriterFull_ReturnsWriterError) {
+  std::byte stream_buffer[4];
+  stream::MemoryWriter writer(stream_buffer);
+  StreamEncoder encoder(writer, ByteSpan());
+
+  EXPECT_EQ(encoder.WriteUint32(kTestProtoMagicNumberField, 42), OkStatus());
+  EXPECT_EQ(encoder.WriteFixed64(kTestProtoCyclesField, 1),
+            Status::ResourceExhausted());
+  EXPECT_EQ(encoder.status(), Status::ResourceExhausted());
+}
+
+TEST(StreamEncoder, WriteBytesChunks_MatchesEncoder) {
+  constexpr std::byte kData[] = {
+      std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4}, std::byte{5}};
+  const ConstByteSpan chunks[] = {
+      std::span(kData).first(2), ConstByteSpan(), std::span(kData).subspan(2)};
+
+  std::byte stream_buffer[32];
+  CountingWriter writer(stream_buffer);
+  StreamEncoder encoder(writer, ByteSpan());
+  EXPECT_EQ(encoder.WriteBytes(kTestProtoErrorMessageField, chunks),
+            OkStatus());
+  EXPECT_EQ(encoder.WriteBytes(kTestProtoErrorMessageField,
+                               std::span<const ConstByteSpan>()),
+            OkStatus());
+
+  std::byte encode_buffer[32];
+  NestedEncoder expected(encode_buffer);
+  expected.WriteBytes(kTestProtoErrorMessageField, kData);
+  expected.WriteBytes(kTestProtoErrorMessageField, ConstByteSpan());
+  Result result = expected.Encode();
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_TRUE(SameBytes(writer.data(), result.value()));
+
+  // One write per header and per non-empty chunk.
+  EXPECT_EQ(writer.writes(), 4u);
+}
+
+TEST(StreamEncoder, PackedVarints_MatchEncoder) {
+  // Enough values to take more than one chunk.
+  uint32_t values[40];
+  int32_t signed_values[40];
+  for (size_t i = 0; i < 40; ++i) {
+    values[i] = uint32_t(i * 0x01234567);
+    signed_values[i] = -int32_t(i * 1000);
+  }
+
+  std::byte stream_buffer[1024];
+  stream::MemoryWriter writer(stream_buffer);
+  StreamEncoder encoder(writer, ByteSpan());
+  EXPECT_EQ(encoder.WritePackedUint32(1, values), OkStatus());
+  EXPECT_EQ(encoder.WritePackedSint32(2, signed_values), OkStatus());
+
+  std::byte encode_buffer[1024];
+  NestedEncoder expected(encode_buffer);
+  expected.WritePackedUint32(1, values);
+  expected.WritePackedSint32(2, signed_values);
+
+  Result result = expected.Encode();
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_TRUE(SameBytes(
+      std::span(writer.data(), writer.bytes_written()), result.value()));
+}
+
+TEST(StreamEncoder, PackedFixed) {
+  std::byte stream_buffer[32];
+  stream::MemoryWriter writer(stream_buffer);
+  StreamEncoder encoder(writer, ByteSpan());
+
+  constexpr uint32_t values[] = {0, 50, 100, 150, 200};
+  EXPECT_EQ(encoder.WritePackedFixed32(1, values), OkStatus());
+
+  constexpr uint8_t encoded_proto[] = {
+      0x0a, 0x14, 0x00, 0x00, 0x00, 0x00, 0x32, 0x00, 0x00, 0x00, 0x64,
+      0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0xc8, 0x00, 0x00, 0x00};
+  EXPECT_TRUE(SameBytes(std::span(writer.data(), writer.bytes_written()),
+                        std::as_bytes(std::span(encoded_proto))));
+}
+
+}  // namespace
+}  // namespace pw::protobuf
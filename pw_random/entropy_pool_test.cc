@@ -0,0 +1,87 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_random/entropy_pool.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace pw::random {
+namespace {
+
+TEST(EntropyPool, Get_Empty_ResourceExhausted) {
+  EntropyPool<4> pool;
+  std::array<std::byte, 2> buffer;
+  const StatusWithSize result = pool.Get(buffer);
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(0u, result.size());
+  EXPECT_EQ(OkStatus(), pool.Get(ByteSpan()).status());
+}
+
+TEST(EntropyPool, Get_ReturnsInjectedBytesInOrder) {
+  EntropyPool<4> pool;
+  pool.InjectEntropyBits(0xabcd, 16);
+  pool.InjectEntropy(std::array{std::byte{0x12}});
+  EXPECT_EQ(3u, pool.available_bytes());
+
+  std::array<std::byte, 4> buffer = {};
+  const StatusWithSize result = pool.Get(buffer);
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(3u, result.size());
+  EXPECT_EQ(std::byte{0xab}, buffer[0]);
+  EXPECT_EQ(std::byte{0xcd}, buffer[1]);
+  EXPECT_EQ(std::byte{0x12}, buffer[2]);
+  EXPECT_EQ(0u, pool.available_bytes());
+}
+
+TEST(EntropyPool, InjectEntropyBits_PacksPartialBytes) {
+  EntropyPool<4> pool;
+  for (int i = 0; i < 7; ++i) {
+    pool.InjectEntropyBits(1, 1);
+  }
+  EXPECT_EQ(0u, pool.available_bytes());
+
+  pool.InjectEntropyBits(0x0, 1);
+  pool.InjectEntropyBits(0x1f, 5);
+  ASSERT_EQ(1u, pool.available_bytes());
+
+  pool.InjectEntropyBits(0x7, 3);
+  std::array<std::byte, 2> buffer = {};
+  ASSERT_EQ(OkStatus(), pool.Get(buffer).status());
+  EXPECT_EQ(std::byte{0xfe}, buffer[0]);
+  EXPECT_EQ(std::byte{0xff}, buffer[1]);
+}
+
+TEST(EntropyPool, InjectEntropyBits_DiscardsWhenFull) {
+  EntropyPool<2> pool;
+  pool.InjectEntropyBits(0x010203, 24);
+  EXPECT_EQ(2u, pool.available_bytes());
+
+  std::array<std::byte, 1> buffer = {};
+  ASSERT_EQ(OkStatus(), pool.Get(buffer).status());
+  EXPECT_EQ(std::byte{0x01}, buffer[0]);
+
+  // The buffered bytes wrap around the end of the pool.
+  pool.InjectEntropyBits(0x04, 8);
+  std::array<std::byte, 2> wrapped = {};
+  ASSERT_EQ(OkStatus(), pool.Get(wrapped).status());
+  EXPECT_EQ(std::byte{0x02}, wrapped[0]);
+  EXPECT_EQ(std::byte{0x04}, wrapped[1]);
+}
+
+}  // namespace
+}  // namespace pw::random
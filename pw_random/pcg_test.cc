@@ -0,0 +1,78 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_random/pcg.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace pw::random {
+namespace {
+
+// Output of the reference pcg32-demo program, which seeds with 42 and 54.
+constexpr uint32_t kReferenceResults[] = {
+    0xa15c02b7u,
+    0x7b47f409u,
+    0xba1d3330u,
+    0x83d2f293u,
+    0xbfa4784bu,
+    0xcbed606eu,
+};
+
+TEST(PcgRng32, ValidateReferenceSeries) {
+  PcgRng32 rng(42, 54);
+  for (uint32_t expected : kReferenceResults) {
+    uint32_t val = 0;
+    EXPECT_EQ(rng.GetInt(val).status(), OkStatus());
+    EXPECT_EQ(val, expected);
+  }
+}
+
+TEST(PcgRng32, Get_CombinesTwoValuesPerWord) {
+  PcgRng32 rng(42, 54);
+  uint64_t val = 0;
+  EXPECT_EQ(rng.GetInt(val).status(), OkStatus());
+  EXPECT_EQ(val, kReferenceResults[0] | (uint64_t(kReferenceResults[1]) << 32));
+}
+
+TEST(PcgRng32, Sequences_AreIndependent) {
+  PcgRng32 rng_1(42, 54);
+  PcgRng32 rng_2(42, 55);
+  uint64_t first_val = 0;
+  uint64_t second_val = 0;
+  EXPECT_EQ(rng_1.GetInt(first_val).status(), OkStatus());
+  EXPECT_EQ(rng_2.GetInt(second_val).status(), OkStatus());
+  EXPECT_NE(first_val, second_val);
+}
+
+TEST(PcgRng32, IncrementalEntropy) {
+  PcgRng32 rng_1(42);
+  uint64_t first_val = 0;
+  rng_1.InjectEntropyBits(0x6, 3);
+  EXPECT_EQ(rng_1.GetInt(first_val).status(), OkStatus());
+
+  PcgRng32 rng_2(42);
+  uint64_t second_val = 0;
+  rng_2.InjectEntropyBits(0x1, 1);
+  rng_2.InjectEntropyBits(0x1, 1);
+  rng_2.InjectEntropyBits(0x0, 1);
+  EXPECT_EQ(rng_2.GetInt(second_val).status(), OkStatus());
+
+  EXPECT_EQ(first_val, second_val);
+}
+
+}  // namespace
+}  // namespace pw::random
@@ -0,0 +1,108 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "pw_bytes/span.h"
+#include "pw_random/random.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::random {
+
+// A RandomGenerator that buffers true random data until it is needed. Entropy
+// from a hardware random number generator, ADC noise, or other sources is
+// injected as it becomes available, for example from an interrupt or while the
+// device is idle. Get() then returns the buffered data immediately, rather than
+// waiting for the hardware.
+//
+// Get() returns only injected entropy and never extrapolates it, so the pool
+// can be exhausted. Injected bits are packed into bytes, most significant bit
+// first; injecting bits one at a time has the same effect as injecting them all
+// at once. Entropy injected while the pool is full is discarded.
+//
+// EntropyPool is not thread or interrupt safe. Callers must synchronize access
+// if entropy is injected from an interrupt.
+template <size_t kPoolSizeBytes>
+class EntropyPool : public RandomGenerator {
+ public:
+  constexpr EntropyPool() = default;
+
+  // Copies buffered bytes to dest, oldest first. Returns OK if dest was filled,
+  // or RESOURCE_EXHAUSTED with the number of bytes written if the pool ran out.
+  StatusWithSize Get(ByteSpan dest) final {
+    const size_t count = std::min(dest.size_bytes(), size_);
+
+    // Copy in up to two pieces, since the buffered bytes may wrap around.
+    const size_t first = std::min(count, kPoolSizeBytes - head_);
+    std::memcpy(dest.data(), &pool_[head_], first);
+    std::memcpy(dest.data() + first, pool_.data(), count - first);
+
+    head_ = (head_ + count) % kPoolSizeBytes;
+    size_ -= count;
+
+    if (count < dest.size_bytes()) {
+      return StatusWithSize::ResourceExhausted(count);
+    }
+    return StatusWithSize(count);
+  }
+
+  void InjectEntropyBits(uint32_t data, uint_fast8_t num_bits) final {
+    if (num_bits == 0) {
+      return;
+    } else if (num_bits > 32) {
+      num_bits = 32;
+    }
+
+    const uint64_t mask = (uint64_t(1) << num_bits) - 1;
+    pending_bits_ = (pending_bits_ << num_bits) | (data & mask);
+    pending_bit_count_ += num_bits;
+
+    while (pending_bit_count_ >= 8u) {
+      pending_bit_count_ -= 8;
+      PushByte(std::byte(pending_bits_ >> pending_bit_count_));
+    }
+    pending_bits_ &= (uint64_t(1) << pending_bit_count_) - 1;
+  }
+
+  // The number of whole bytes of entropy that Get() can return.
+  size_t available_bytes() const { return size_; }
+
+  static constexpr size_t capacity() { return kPoolSizeBytes; }
+
+ private:
+  static_assert(kPoolSizeBytes > 0u, "The entropy pool must not be empty");
+
+  void PushByte(std::byte value) {
+    if (size_ == kPoolSizeBytes) {
+      return;
+    }
+    pool_[(head_ + size_) % kPoolSizeBytes] = value;
+    size_ += 1;
+  }
+
+  std::array<std::byte, kPoolSizeBytes> pool_ = {};
+  size_t head_ = 0;
+  size_t size_ = 0;
+
+  // Fewer than 8 injected bits that do not yet form a byte.
+  uint64_t pending_bits_ = 0;
+  uint_fast8_t pending_bit_count_ = 0;
+};
+
+}  // namespace pw::random
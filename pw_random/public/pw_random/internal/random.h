@@ -0,0 +1,55 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "pw_bytes/span.h"
+
+namespace pw::random::internal {
+
+// Fills dest with 64-bit values from next(). Whole words are copied with
+// fixed-size copies, which compile to single stores, and only the final partial
+// word is copied byte by byte.
+template <typename NextFunction>
+void FillWithWords(ByteSpan dest, NextFunction&& next) {
+  std::byte* out = dest.data();
+  std::byte* const end = out + dest.size_bytes();
+
+  while (end - out >= static_cast<ptrdiff_t>(sizeof(uint64_t))) {
+    const uint64_t value = next();
+    std::memcpy(out, &value, sizeof(value));
+    out += sizeof(value);
+  }
+
+  if (out != end) {
+    const uint64_t value = next();
+    std::memcpy(out, &value, static_cast<size_t>(end - out));
+  }
+}
+
+// Rotates the bits of state left by num_bits, which must be from 1 to 32, and
+// XORs the low num_bits bits of data into it. Injecting bits one at a time has
+// the same effect as injecting them all at once.
+constexpr uint64_t InjectBits(uint64_t state,
+                              uint32_t data,
+                              uint_fast8_t num_bits) {
+  const uint64_t rotated = (state << num_bits) | (state >> (64 - num_bits));
+  const uint64_t mask = (uint64_t(1) << num_bits) - 1;
+  return rotated ^ (data & mask);
+}
+
+}  // namespace pw::random::internal
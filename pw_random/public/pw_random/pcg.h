@@ -0,0 +1,98 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "pw_bytes/span.h"
+#include "pw_random/internal/random.h"
+#include "pw_random/random.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::random {
+
+// The PCG32 (XSH-RR) generator, which has 64 bits of state and produces 32-bit
+// values. It is small and has good statistical quality. Each distinct sequence
+// selects an independent stream, so generators with the same seed but
+// different sequences produce unrelated values.
+//
+// See: https://www.pcg-random.org/
+//
+// Entropy is injected into the state as it is for XorShiftStarRng64.
+//
+// This random generator is NOT cryptographically secure, and incorporates
+// pseudo-random generation to extrapolate any true injected entropy. The
+// distribution is not guaranteed to be uniform.
+class PcgRng32 : public RandomGenerator {
+ public:
+  static constexpr uint64_t kDefaultSequence = 0x6d1f1ce5ca5cadedu;
+
+  // Seeds the generator as the reference pcg32_srandom_r() function does.
+  PcgRng32(uint64_t initial_seed, uint64_t sequence = kDefaultSequence)
+      : state_(0), increment_((sequence << 1) | 1u) {
+    Regenerate32();
+    state_ += initial_seed;
+    Regenerate32();
+  }
+
+  // This generator uses entropy-seeded PRNG to never exhaust its random number
+  // pool. Whole 8-byte words are filled with two consecutive 32-bit values, the
+  // first in the low bits. The remaining bytes use one 32-bit value per 4
+  // bytes, so GetInt() with a 32-bit integer uses exactly one value.
+  StatusWithSize Get(ByteSpan dest) final {
+    const size_t whole_words_size = dest.size_bytes() & ~size_t(7);
+    internal::FillWithWords(dest.first(whole_words_size), [this] {
+      const uint64_t low = Regenerate32();
+      return low | (uint64_t(Regenerate32()) << 32);
+    });
+
+    for (ByteSpan rest = dest.subspan(whole_words_size); !rest.empty();) {
+      const uint32_t value = Regenerate32();
+      const size_t copy_size = std::min(rest.size_bytes(), sizeof(value));
+      std::memcpy(rest.data(), &value, copy_size);
+      rest = rest.subspan(copy_size);
+    }
+    return StatusWithSize(dest.size_bytes());
+  }
+
+  void InjectEntropyBits(uint32_t data, uint_fast8_t num_bits) final {
+    if (num_bits == 0) {
+      return;
+    } else if (num_bits > 32) {
+      num_bits = 32;
+    }
+    state_ = internal::InjectBits(state_, data, num_bits);
+  }
+
+ private:
+  static constexpr uint64_t kMultiplier = 6364136223846793005u;
+
+  uint32_t Regenerate32() {
+    const uint64_t old_state = state_;
+    state_ = old_state * kMultiplier + increment_;
+
+    const uint32_t xor_shifted =
+        static_cast<uint32_t>(((old_state >> 18) ^ old_state) >> 27);
+    const uint32_t rotation = static_cast<uint32_t>(old_state >> 59);
+    return (xor_shifted >> rotation) | (xor_shifted << ((32 - rotation) & 31));
+  }
+
+  uint64_t state_;
+  const uint64_t increment_;
+};
+
+}  // namespace pw::random
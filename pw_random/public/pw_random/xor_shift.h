@@ -18,6 +18,7 @@
 #include <span>
 
 #include "pw_bytes/span.h"
+#include "pw_random/internal/random.h"
 #include "pw_random/random.h"
 #include "pw_status/status_with_size.h"
 
@@ -38,15 +39,13 @@ class XorShiftStarRng64 : public RandomGenerator {
   // This generator uses entropy-seeded PRNG to never exhaust its random number
   // pool.
   StatusWithSize Get(ByteSpan dest) final {
-    const size_t bytes_written = dest.size_bytes();
-    while (!dest.empty()) {
-      uint64_t random = Regenerate();
-      size_t copy_size = std::min(dest.size_bytes(), sizeof(state_));
-      std::memcpy(dest.data(), &random, copy_size);
-      dest = dest.subspan(copy_size);
+    // State must be nonzero, or the algorithm will get stuck and always return
+    // zero. A nonzero state never becomes zero, so this is only checked once.
+    if (state_ == 0) {
+      state_--;
     }
-
-    return StatusWithSize(bytes_written);
+    internal::FillWithWords(dest, [this] { return Regenerate(); });
+    return StatusWithSize(dest.size_bytes());
   }
 
   // Entropy is injected by rotating the state by the number of entropy bits
@@ -60,29 +59,18 @@ class XorShiftStarRng64 : public RandomGenerator {
       num_bits = 32;
     }
 
-    // Rotate state.
-    uint64_t untouched_state = state_ >> (kNumStateBits - num_bits);
-    state_ = untouched_state | (state_ << num_bits);
-    // Zero-out all irrelevant bits, then XOR entropy into state.
-    uint32_t mask = (1 << num_bits) - 1;
-    state_ ^= (data & mask);
+    state_ = internal::InjectBits(state_, data, num_bits);
   }
 
  private:
   // Calculate and return the next value based on the "xorshift*" algorithm
   uint64_t Regenerate() {
-    // State must be nonzero, or the algorithm will get stuck and always return
-    // zero.
-    if (state_ == 0) {
-      state_--;
-    }
     state_ ^= state_ >> 12;
     state_ ^= state_ << 25;
     state_ ^= state_ >> 27;
     return state_ * kMultConst;
   }
   uint64_t state_;
-  static constexpr uint8_t kNumStateBits = sizeof(state_) * 8;
 
   // For information on why this constant was selected, see:
   // https://www.jstatsoft.org/article/view/v008i14
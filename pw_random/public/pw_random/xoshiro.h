@@ -0,0 +1,102 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_random/internal/random.h"
+#include "pw_random/random.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::random {
+
+// The "xoshiro256**" algorithm, a fast, general-purpose generator with 256 bits
+// of state. Its output has better statistical quality than xorshift*, and it
+// passes common test suites such as BigCrush.
+//
+// See: https://prng.di.unimi.it/
+//
+// The 64-bit seed is expanded into the full state with SplitMix64, as the
+// algorithm's authors recommend. Entropy is injected into the state as it is
+// for XorShiftStarRng64.
+//
+// This random generator is NOT cryptographically secure, and incorporates
+// pseudo-random generation to extrapolate any true injected entropy. The
+// distribution is not guaranteed to be uniform.
+class Xoshiro256StarStarRng : public RandomGenerator {
+ public:
+  Xoshiro256StarStarRng(uint64_t initial_seed) {
+    for (uint64_t& word : state_) {
+      word = SplitMix64(initial_seed);
+    }
+  }
+
+  // This generator uses entropy-seeded PRNG to never exhaust its random number
+  // pool.
+  StatusWithSize Get(ByteSpan dest) final {
+    internal::FillWithWords(dest, [this] { return Regenerate(); });
+    return StatusWithSize(dest.size_bytes());
+  }
+
+  void InjectEntropyBits(uint32_t data, uint_fast8_t num_bits) final {
+    if (num_bits == 0) {
+      return;
+    } else if (num_bits > 32) {
+      num_bits = 32;
+    }
+
+    // The next value is computed from state_[1], so entropy injected there
+    // affects the very next value.
+    state_[1] = internal::InjectBits(state_[1], data, num_bits);
+
+    // The state must not be all zeroes, or the generator always returns zero.
+    if ((state_[0] | state_[1] | state_[2] | state_[3]) == 0u) {
+      state_[1] = kSplitMixIncrement;
+    }
+  }
+
+ private:
+  static constexpr uint64_t kSplitMixIncrement = 0x9e3779b97f4a7c15;
+
+  static constexpr uint64_t RotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+  }
+
+  static constexpr uint64_t SplitMix64(uint64_t& state) {
+    uint64_t z = (state += kSplitMixIncrement);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+  }
+
+  uint64_t Regenerate() {
+    const uint64_t result = RotateLeft(state_[1] * 5, 7) * 9;
+    const uint64_t t = state_[1] << 17;
+
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = RotateLeft(state_[3], 45);
+
+    return result;
+  }
+
+  std::array<uint64_t, 4> state_;
+};
+
+}  // namespace pw::random
@@ -0,0 +1,76 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_random/xoshiro.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+namespace pw::random {
+namespace {
+
+constexpr uint64_t kSeed = 5;
+constexpr uint64_t kResults[] = {
+    0x49d55178ca54cf69u,
+    0x9a22115a4d2624dcu,
+    0xa648b1ccf0bbbbaeu,
+    0xd2511e20de933bc5u,
+};
+
+TEST(Xoshiro256StarStarRng, ValidateSeries) {
+  Xoshiro256StarStarRng rng(kSeed);
+  for (uint64_t expected : kResults) {
+    uint64_t val = 0;
+    EXPECT_EQ(rng.GetInt(val).status(), OkStatus());
+    EXPECT_EQ(val, expected);
+  }
+}
+
+TEST(Xoshiro256StarStarRng, Get_PartialWordsMatchWholeWords) {
+  Xoshiro256StarStarRng rng(kSeed);
+  std::array<std::byte, 11> buffer;
+  ASSERT_EQ(rng.Get(buffer).size(), buffer.size());
+
+  EXPECT_EQ(0, std::memcmp(buffer.data(), &kResults[0], sizeof(kResults[0])));
+  EXPECT_EQ(0, std::memcmp(&buffer[8], &kResults[1], 3));
+
+  // The rest of the second word is discarded.
+  uint64_t val = 0;
+  EXPECT_EQ(rng.GetInt(val).status(), OkStatus());
+  EXPECT_EQ(val, kResults[2]);
+}
+
+TEST(Xoshiro256StarStarRng, IncrementalEntropy) {
+  Xoshiro256StarStarRng rng_1(kSeed);
+  uint64_t first_val = 0;
+  rng_1.InjectEntropyBits(0x6, 3);
+  EXPECT_EQ(rng_1.GetInt(first_val).status(), OkStatus());
+  EXPECT_NE(first_val, kResults[0]);
+
+  Xoshiro256StarStarRng rng_2(kSeed);
+  uint64_t second_val = 0;
+  rng_2.InjectEntropyBits(0x1, 1);
+  rng_2.InjectEntropyBits(0x1, 1);
+  rng_2.InjectEntropyBits(0x0, 1);
+  EXPECT_EQ(rng_2.GetInt(second_val).status(), OkStatus());
+
+  EXPECT_EQ(first_val, second_val);
+}
+
+}  // namespace
+}  // namespace pw::random
@@ -0,0 +1,112 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_ring_buffer/persistent_prefixed_entry_ring_buffer.h"
+
+#include <cstring>
+
+#include "pw_checksum/crc32.h"
+
+namespace pw {
+namespace ring_buffer {
+
+using std::byte;
+
+namespace {
+
+// Changes if the header or entry format changes, so a region saved by other
+// firmware is not recovered.
+constexpr uint32_t kMagic = 0x52420001;
+constexpr uint32_t kUserPreambleFlag = 0x80000000;
+
+}  // namespace
+
+Status PersistentPrefixedEntryRingBuffer::SetBuffer(std::span<byte> region) {
+  if (region.data() == nullptr || region.size_bytes() <= kHeaderBytes) {
+    return Status::InvalidArgument();
+  }
+  Status status = ring_.SetBuffer(region.subspan(kHeaderBytes));
+  if (!status.ok()) {
+    return status;
+  }
+  header_ = region.data();
+
+  // The region is not aligned for the header, so it is copied.
+  Header header;
+  std::memcpy(&header, header_, sizeof(header));
+  recovered_ = header.magic == Magic() && header.checksum == Checksum(header) &&
+               header.data_bytes == region.size_bytes() - kHeaderBytes &&
+               ring_.RestoreState(header.state).ok();
+  if (!recovered_) {
+    SaveHeader();
+  }
+  return OkStatus();
+}
+
+void PersistentPrefixedEntryRingBuffer::Clear() {
+  ring_.Clear();
+  SaveHeader();
+}
+
+Status PersistentPrefixedEntryRingBuffer::PushBack(std::span<const byte> data,
+                                                   byte user_preamble_data) {
+  Status status = ring_.PushBack(data, user_preamble_data);
+  if (status.ok()) {
+    SaveHeader();
+  }
+  return status;
+}
+
+Status PersistentPrefixedEntryRingBuffer::TryPushBack(
+    std::span<const byte> data, byte user_preamble_data) {
+  Status status = ring_.TryPushBack(data, user_preamble_data);
+  if (status.ok()) {
+    SaveHeader();
+  }
+  return status;
+}
+
+Status PersistentPrefixedEntryRingBuffer::PopFront() {
+  Status status = ring_.PopFront();
+  if (status.ok()) {
+    SaveHeader();
+  }
+  return status;
+}
+
+uint32_t PersistentPrefixedEntryRingBuffer::Magic() const {
+  return user_preamble_ ? kMagic | kUserPreambleFlag : kMagic;
+}
+
+uint32_t PersistentPrefixedEntryRingBuffer::Checksum(const Header& header) {
+  checksum::Crc32 crc;
+  crc.Update(std::as_bytes(std::span(&header.magic, 1)));
+  crc.Update(std::as_bytes(std::span(&header.data_bytes, 1)));
+  crc.Update(std::as_bytes(std::span(&header.state.read_idx, 1)));
+  crc.Update(std::as_bytes(std::span(&header.state.write_idx, 1)));
+  crc.Update(std::as_bytes(std::span(&header.state.entry_count, 1)));
+  return crc.value();
+}
+
+void PersistentPrefixedEntryRingBuffer::SaveHeader() {
+  Header header;
+  header.magic = Magic();
+  header.data_bytes = ring_.buffer_bytes_;
+  header.state = ring_.GetState();
+  header.checksum = Checksum(header);
+  std::memcpy(header_, &header, sizeof(header));
+}
+
+}  // namespace ring_buffer
+}  // namespace pw
@@ -0,0 +1,146 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_ring_buffer/persistent_prefixed_entry_ring_buffer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "pw_unit_test/framework.h"
+
+using std::byte;
+
+namespace pw {
+namespace ring_buffer {
+namespace {
+
+constexpr size_t kRegionSize =
+    PersistentPrefixedEntryRingBuffer::kHeaderBytes + 32;
+
+Status PushBack(PersistentPrefixedEntryRingBuffer& ring, uint32_t value) {
+  return ring.PushBack(std::as_bytes(std::span(&value, 1)), byte(value));
+}
+
+uint32_t PeekFront(PersistentPrefixedEntryRingBuffer& ring) {
+  uint32_t value = 0;
+  size_t bytes_read;
+  EXPECT_EQ(ring.PeekFront(std::as_writable_bytes(std::span(&value, 1)),
+                           &bytes_read),
+            OkStatus());
+  EXPECT_EQ(bytes_read, sizeof(value));
+  return value;
+}
+
+TEST(PersistentPrefixedEntryRingBuffer, InvalidRegion) {
+  PersistentPrefixedEntryRingBuffer ring;
+  byte region[PersistentPrefixedEntryRingBuffer::kHeaderBytes];
+  EXPECT_EQ(ring.SetBuffer(std::span<byte>(nullptr, 10u)),
+            Status::InvalidArgument());
+  EXPECT_EQ(ring.SetBuffer(region), Status::InvalidArgument());
+}
+
+TEST(PersistentPrefixedEntryRingBuffer, UninitializedRegionIsCleared) {
+  byte region[kRegionSize];
+  std::memset(region, 0xa5, sizeof(region));
+
+  PersistentPrefixedEntryRingBuffer ring(true);
+  ASSERT_EQ(ring.SetBuffer(region), OkStatus());
+  EXPECT_FALSE(ring.recovered());
+  EXPECT_EQ(ring.EntryCount(), 0u);
+}
+
+TEST(PersistentPrefixedEntryRingBuffer, RecoversEntriesAfterReset) {
+  byte region[kRegionSize] = {};
+  {
+    PersistentPrefixedEntryRingBuffer ring(true);
+    ASSERT_EQ(ring.SetBuffer(region), OkStatus());
+
+    // Wrap the entries around the end of the buffer.
+    for (uint32_t i = 0; i < 20; ++i) {
+      ASSERT_EQ(PushBack(ring, i), OkStatus());
+    }
+    ASSERT_EQ(ring.PopFront(), OkStatus());
+  }
+
+  // A new ring buffer over the same region, as after a reset.
+  PersistentPrefixedEntryRingBuffer ring(true);
+  ASSERT_EQ(ring.SetBuffer(region), OkStatus());
+  EXPECT_TRUE(ring.recovered());
+
+  // Each entry is 6 bytes, so 5 fit in the 32 bytes, and one was popped.
+  ASSERT_EQ(ring.EntryCount(), 4u);
+  for (uint32_t i = 16; i < 20; ++i) {
+    byte entry[6];
+    size_t bytes_read;
+    ASSERT_EQ(ring.PeekFrontWithPreamble(entry, &bytes_read), OkStatus());
+    EXPECT_EQ(entry[0], byte(i));
+    EXPECT_EQ(PeekFront(ring), i);
+    ASSERT_EQ(ring.PopFront(), OkStatus());
+  }
+
+  // New entries can be added after the recovered ones.
+  EXPECT_EQ(PushBack(ring, 20), OkStatus());
+  EXPECT_EQ(PeekFront(ring), 20u);
+}
+
+TEST(PersistentPrefixedEntryRingBuffer, MismatchedSettingsAreNotRecovered) {
+  byte region[kRegionSize] = {};
+  {
+    PersistentPrefixedEntryRingBuffer ring(true);
+    ASSERT_EQ(ring.SetBuffer(region), OkStatus());
+    ASSERT_EQ(PushBack(ring, 1), OkStatus());
+  }
+
+  PersistentPrefixedEntryRingBuffer no_preamble_ring(false);
+  ASSERT_EQ(no_preamble_ring.SetBuffer(region), OkStatus());
+  EXPECT_FALSE(no_preamble_ring.recovered());
+  EXPECT_EQ(no_preamble_ring.EntryCount(), 0u);
+
+  ASSERT_EQ(PushBack(no_preamble_ring, 1), OkStatus());
+  PersistentPrefixedEntryRingBuffer smaller_ring(false);
+  ASSERT_EQ(smaller_ring.SetBuffer(std::span(region, kRegionSize - 1)),
+            OkStatus());
+  EXPECT_FALSE(smaller_ring.recovered());
+}
+
+TEST(PersistentPrefixedEntryRingBuffer, CorruptedStateIsNotRecovered) {
+  byte region[kRegionSize] = {};
+  {
+    PersistentPrefixedEntryRingBuffer ring;
+    ASSERT_EQ(ring.SetBuffer(region), OkStatus());
+    ASSERT_EQ(PushBack(ring, 1), OkStatus());
+    ASSERT_EQ(PushBack(ring, 2), OkStatus());
+  }
+
+  // Corrupt the size of the second entry, so the entries no longer end at the
+  // saved write index. The header itself is still valid.
+  region[PersistentPrefixedEntryRingBuffer::kHeaderBytes + 5] = byte(3);
+
+  PersistentPrefixedEntryRingBuffer ring;
+  ASSERT_EQ(ring.SetBuffer(region), OkStatus());
+  EXPECT_FALSE(ring.recovered());
+  EXPECT_EQ(ring.EntryCount(), 0u);
+
+  // Corrupt the header.
+  ASSERT_EQ(PushBack(ring, 1), OkStatus());
+  region[0] ^= byte(1);
+  PersistentPrefixedEntryRingBuffer corrupted_header_ring;
+  ASSERT_EQ(corrupted_header_ring.SetBuffer(region), OkStatus());
+  EXPECT_FALSE(corrupted_header_ring.recovered());
+}
+
+}  // namespace
+}  // namespace ring_buffer
+}  // namespace pw
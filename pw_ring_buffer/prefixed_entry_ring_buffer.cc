@@ -23,13 +23,16 @@ namespace ring_buffer {
 
 using std::byte;
 
-void PrefixedEntryRingBuffer::Clear() {
-  read_idx_ = 0;
+void PrefixedEntryRingBufferMulti::Clear() {
   write_idx_ = 0;
-  entry_count_ = 0;
+  reserved_bytes_ = 0;
+  for (Reader& reader : readers_) {
+    reader.read_idx_ = 0;
+    reader.entry_count_ = 0;
+  }
 }
 
-Status PrefixedEntryRingBuffer::SetBuffer(std::span<byte> buffer) {
+Status PrefixedEntryRingBufferMulti::SetBuffer(std::span<byte> buffer) {
   if ((buffer.data() == nullptr) ||  //
       (buffer.size_bytes() == 0) ||  //
       (buffer.size_bytes() > kMaxBufferBytes)) {
@@ -43,10 +46,39 @@ Status PrefixedEntryRingBuffer::SetBuffer(std::span<byte> buffer) {
   return OkStatus();
 }
 
-Status PrefixedEntryRingBuffer::InternalPushBack(std::span<const byte> data,
-                                                 byte user_preamble_data,
-                                                 bool drop_elements_if_needed) {
-  if (buffer_ == nullptr) {
+Status PrefixedEntryRingBufferMulti::AttachReader(Reader& reader) {
+  if (reader.ring_ != nullptr) {
+    return Status::InvalidArgument();
+  }
+
+  if (readers_.empty()) {
+    reader.read_idx_ = write_idx_;
+    reader.entry_count_ = 0;
+  } else {
+    const Reader& slowest = GetSlowestReader();
+    reader.read_idx_ = slowest.read_idx_;
+    reader.entry_count_ = slowest.entry_count_;
+  }
+  reader.dropped_entries_ = 0;
+  reader.ring_ = this;
+  readers_.push_back(reader);
+  return OkStatus();
+}
+
+Status PrefixedEntryRingBufferMulti::DetachReader(Reader& reader) {
+  if (reader.ring_ != this) {
+    return Status::InvalidArgument();
+  }
+  reader.ring_ = nullptr;
+  readers_.remove(reader);
+  return OkStatus();
+}
+
+Status PrefixedEntryRingBufferMulti::InternalPushBack(
+    std::span<const byte> data,
+    byte user_preamble_data,
+    bool drop_elements_if_needed) {
+  if (buffer_ == nullptr || reserved_bytes_ != 0) {
     return Status::FailedPrecondition();
   }
   if (data.size_bytes() == 0) {
@@ -66,7 +98,7 @@ Status PrefixedEntryRingBuffer::InternalPushBack(std::span<const byte> data,
     // PushBack() case: evict items as needed.
     // Drop old entries until we have space for the new entry.
     while (RawAvailableBytes() < total_write_bytes) {
-      PopFront();
+      EvictFront();
     }
   } else if (RawAvailableBytes() < total_write_bytes) {
     // TryPushBack() case: don't evict items.
@@ -79,7 +111,86 @@ Status PrefixedEntryRingBuffer::InternalPushBack(std::span<const byte> data,
   }
   RawWrite(std::span(varint_buf, varint_bytes));
   RawWrite(data);
-  entry_count_++;
+  AddEntryToReaders();
+  return OkStatus();
+}
+
+Status PrefixedEntryRingBufferMulti::InternalReserve(
+    size_t max_size,
+    std::span<byte>* reserved,
+    byte user_preamble_data,
+    bool drop_elements_if_needed) {
+  if (buffer_ == nullptr || reserved_bytes_ != 0) {
+    return Status::FailedPrecondition();
+  }
+  if (max_size == 0) {
+    return Status::InvalidArgument();
+  }
+
+  // Size the preamble for max_size; Commit pads the varint for smaller sizes.
+  size_t varint_bytes = varint::EncodedSize(max_size);
+  size_t preamble_bytes = (user_preamble_ ? 1 : 0) + varint_bytes;
+  size_t total_write_bytes = preamble_bytes + max_size;
+  if (buffer_bytes_ < total_write_bytes) {
+    return Status::OutOfRange();
+  }
+
+  if (drop_elements_if_needed) {
+    // Reserve() case: evict items as needed.
+    while (RawAvailableBytes() < total_write_bytes) {
+      EvictFront();
+    }
+  } else if (RawAvailableBytes() < total_write_bytes) {
+    // TryReserve() case: don't evict items.
+    return Status::ResourceExhausted();
+  }
+
+  // The preamble may wrap, but the data must be contiguous. If it would wrap,
+  // dering so the free space is at the end of the buffer.
+  size_t data_idx = IncrementIndex(write_idx_, preamble_bytes);
+  if (data_idx == buffer_bytes_) {
+    data_idx = 0;
+  }
+  if (data_idx + max_size > buffer_bytes_) {
+    Dering();
+    data_idx = write_idx_ + preamble_bytes;
+  }
+
+  reserved_bytes_ = max_size;
+  reserved_varint_bytes_ = varint_bytes;
+  reserved_user_preamble_ = user_preamble_data;
+  *reserved = std::span(buffer_ + data_idx, max_size);
+  return OkStatus();
+}
+
+Status PrefixedEntryRingBufferMulti::Commit(size_t size) {
+  if (reserved_bytes_ == 0) {
+    return Status::FailedPrecondition();
+  }
+  if (size > reserved_bytes_) {
+    return Status::OutOfRange();
+  }
+  reserved_bytes_ = 0;
+  if (size == 0) {
+    return OkStatus();
+  }
+
+  // Pad the varint to the reserved size. Each added byte continues the
+  // previous one and adds no bits, so the varint still decodes to size.
+  byte varint_buf[kMaxEntryPreambleBytes];
+  size_t varint_bytes = varint::Encode<size_t>(size, varint_buf);
+  for (; varint_bytes < reserved_varint_bytes_; ++varint_bytes) {
+    varint_buf[varint_bytes - 1] |= byte(0x80);
+    varint_buf[varint_bytes] = byte(0);
+  }
+
+  // The data is already in place after the preamble.
+  if (user_preamble_) {
+    RawWrite(std::span(&reserved_user_preamble_, 1));
+  }
+  RawWrite(std::span(varint_buf, varint_bytes));
+  write_idx_ = IncrementIndex(write_idx_, size);
+  AddEntryToReaders();
   return OkStatus();
 }
 
@@ -95,40 +206,77 @@ auto GetOutput(std::span<byte> data_out, size_t* write_index) {
   };
 }
 
-Status PrefixedEntryRingBuffer::PeekFront(std::span<byte> data,
-                                          size_t* bytes_read) {
+Status PrefixedEntryRingBufferMulti::Reader::PeekFront(std::span<byte> data,
+                                                       size_t* bytes_read) {
   *bytes_read = 0;
-  return InternalRead(GetOutput(data, bytes_read), false);
+  if (ring_ == nullptr) {
+    return Status::FailedPrecondition();
+  }
+  return ring_->InternalRead(*this, GetOutput(data, bytes_read), false);
 }
 
-Status PrefixedEntryRingBuffer::PeekFront(ReadOutput output) {
-  return InternalRead(output, false);
+Status PrefixedEntryRingBufferMulti::Reader::PeekFront(ReadOutput output) {
+  if (ring_ == nullptr) {
+    return Status::FailedPrecondition();
+  }
+  return ring_->InternalRead(*this, output, false);
 }
 
-Status PrefixedEntryRingBuffer::PeekFrontWithPreamble(std::span<byte> data,
-                                                      size_t* bytes_read) {
+Status PrefixedEntryRingBufferMulti::Reader::PeekFrontWithPreamble(
+    std::span<byte> data, size_t* bytes_read) {
   *bytes_read = 0;
-  return InternalRead(GetOutput(data, bytes_read), true);
+  if (ring_ == nullptr) {
+    return Status::FailedPrecondition();
+  }
+  return ring_->InternalRead(*this, GetOutput(data, bytes_read), true);
+}
+
+Status PrefixedEntryRingBufferMulti::Reader::PeekFrontWithPreamble(
+    ReadOutput output) {
+  if (ring_ == nullptr) {
+    return Status::FailedPrecondition();
+  }
+  return ring_->InternalRead(*this, output, true);
+}
+
+Status PrefixedEntryRingBufferMulti::Reader::PopFront() {
+  if (ring_ == nullptr) {
+    return Status::FailedPrecondition();
+  }
+  return ring_->InternalPopFront(*this);
 }
 
-Status PrefixedEntryRingBuffer::PeekFrontWithPreamble(ReadOutput output) {
-  return InternalRead(output, true);
+size_t PrefixedEntryRingBufferMulti::Reader::FrontEntryDataSizeBytes() {
+  if (ring_ == nullptr || EntryCount() == 0) {
+    return 0;
+  }
+  return ring_->FrontEntryInfo(read_idx_).data_bytes;
+}
+
+size_t PrefixedEntryRingBufferMulti::Reader::FrontEntryTotalSizeBytes() {
+  if (ring_ == nullptr || EntryCount() == 0) {
+    return 0;
+  }
+  EntryInfo info = ring_->FrontEntryInfo(read_idx_);
+  return info.preamble_bytes + info.data_bytes;
 }
 
 // T should be similar to Status (*read_output)(std::span<const byte>)
 template <typename T>
-Status PrefixedEntryRingBuffer::InternalRead(T read_output, bool get_preamble) {
+Status PrefixedEntryRingBufferMulti::InternalRead(Reader& reader,
+                                                  T read_output,
+                                                  bool get_preamble) {
   if (buffer_ == nullptr) {
     return Status::FailedPrecondition();
   }
-  if (EntryCount() == 0) {
+  if (reader.entry_count_ == 0) {
     return Status::OutOfRange();
   }
 
   // Figure out where to start reading (wrapped); accounting for preamble.
-  EntryInfo info = FrontEntryInfo();
+  EntryInfo info = FrontEntryInfo(reader.read_idx_);
   size_t read_bytes = info.data_bytes;
-  size_t data_read_idx = read_idx_;
+  size_t data_read_idx = reader.read_idx_;
   if (get_preamble) {
     read_bytes += info.preamble_bytes;
   } else {
@@ -148,69 +296,133 @@ Status PrefixedEntryRingBuffer::InternalRead(T read_output, bool get_preamble) {
   return status;
 }
 
-Status PrefixedEntryRingBuffer::PopFront() {
+Status PrefixedEntryRingBufferMulti::InternalPopFront(Reader& reader) {
   if (buffer_ == nullptr) {
     return Status::FailedPrecondition();
   }
-  if (EntryCount() == 0) {
+  if (reader.entry_count_ == 0) {
     return Status::OutOfRange();
   }
 
   // Advance the read pointer past the front entry to the next one.
-  EntryInfo info = FrontEntryInfo();
+  EntryInfo info = FrontEntryInfo(reader.read_idx_);
   size_t entry_bytes = info.preamble_bytes + info.data_bytes;
-  read_idx_ = IncrementIndex(read_idx_, entry_bytes);
-  entry_count_--;
+  reader.read_idx_ = IncrementIndex(reader.read_idx_, entry_bytes);
+  reader.entry_count_--;
   return OkStatus();
 }
 
-Status PrefixedEntryRingBuffer::Dering() {
-  if (buffer_ == nullptr) {
+PrefixedEntryRingBufferMulti::Reader&
+PrefixedEntryRingBufferMulti::GetSlowestReader() {
+  Reader* slowest = &readers_.front();
+  for (Reader& reader : readers_) {
+    if (reader.entry_count_ > slowest->entry_count_) {
+      slowest = &reader;
+    }
+  }
+  return *slowest;
+}
+
+void PrefixedEntryRingBufferMulti::EvictFront() {
+  // Readers with the same entry count are at the same entry, so each is
+  // popped in turn until the space is free.
+  Reader& slowest = GetSlowestReader();
+  slowest.dropped_entries_++;
+  InternalPopFront(slowest);
+}
+
+void PrefixedEntryRingBufferMulti::AddEntryToReaders() {
+  for (Reader& reader : readers_) {
+    reader.entry_count_++;
+  }
+}
+
+Status PrefixedEntryRingBufferMulti::Dering() {
+  if (buffer_ == nullptr || reserved_bytes_ != 0) {
     return Status::FailedPrecondition();
   }
+  // Without readers, no entries are kept.
+  if (readers_.empty()) {
+    write_idx_ = 0;
+    return OkStatus();
+  }
+
   // Check if by luck we're already deringed.
-  if (read_idx_ == 0) {
+  const size_t oldest_idx = GetSlowestReader().read_idx_;
+  if (oldest_idx == 0) {
     return OkStatus();
   }
 
   auto buffer_span = std::span(buffer_, buffer_bytes_);
   std::rotate(
-      buffer_span.begin(), buffer_span.begin() + read_idx_, buffer_span.end());
+      buffer_span.begin(), buffer_span.begin() + oldest_idx, buffer_span.end());
 
   // If the new index is past the end of the buffer,
   // alias it back (wrap) to the start of the buffer.
-  if (write_idx_ < read_idx_) {
-    write_idx_ += buffer_bytes_;
+  auto rotate_index = [this, oldest_idx](size_t& index) {
+    if (index < oldest_idx) {
+      index += buffer_bytes_;
+    }
+    index -= oldest_idx;
+  };
+  rotate_index(write_idx_);
+  for (Reader& reader : readers_) {
+    rotate_index(reader.read_idx_);
   }
-  write_idx_ -= read_idx_;
-  read_idx_ = 0;
   return OkStatus();
 }
 
-size_t PrefixedEntryRingBuffer::FrontEntryDataSizeBytes() {
-  if (EntryCount() == 0) {
-    return 0;
-  }
-  return FrontEntryInfo().data_bytes;
+PrefixedEntryRingBufferMulti::State PrefixedEntryRingBufferMulti::GetState() {
+  const Reader& reader = readers_.front();
+  return State{reader.read_idx_, write_idx_, reader.entry_count_};
 }
 
-size_t PrefixedEntryRingBuffer::FrontEntryTotalSizeBytes() {
-  if (EntryCount() == 0) {
-    return 0;
+Status PrefixedEntryRingBufferMulti::RestoreState(const State& state) {
+  if (buffer_ == nullptr || state.read_idx > buffer_bytes_ ||
+      state.write_idx > buffer_bytes_ || state.entry_count > buffer_bytes_) {
+    return Status::DataLoss();
   }
-  EntryInfo info = FrontEntryInfo();
-  return info.preamble_bytes + info.data_bytes;
+
+  // Walk the entries to check that they end at the write index without
+  // overlapping themselves.
+  size_t idx = state.read_idx;
+  size_t total_bytes = 0;
+  for (size_t i = 0; i < state.entry_count; ++i) {
+    EntryInfo info = FrontEntryInfo(idx);
+    if (info.preamble_bytes == (user_preamble_ ? 1u : 0u) ||
+        info.data_bytes == 0 || info.data_bytes > buffer_bytes_) {
+      return Status::DataLoss();
+    }
+    const size_t entry_bytes = info.preamble_bytes + info.data_bytes;
+    total_bytes += entry_bytes;
+    if (total_bytes > buffer_bytes_) {
+      return Status::DataLoss();
+    }
+    idx = IncrementIndex(idx, entry_bytes);
+  }
+  // Indices of 0 and buffer_bytes_ alias the same position.
+  if (idx % buffer_bytes_ != state.write_idx % buffer_bytes_) {
+    return Status::DataLoss();
+  }
+
+  Reader& reader = readers_.front();
+  reader.read_idx_ = state.read_idx;
+  reader.entry_count_ = state.entry_count;
+  write_idx_ = state.write_idx;
+  reserved_bytes_ = 0;
+  return OkStatus();
 }
 
-PrefixedEntryRingBuffer::EntryInfo PrefixedEntryRingBuffer::FrontEntryInfo() {
+PrefixedEntryRingBufferMulti::EntryInfo
+PrefixedEntryRingBufferMulti::FrontEntryInfo(size_t read_idx) {
   // Entry headers consists of: (optional prefix byte, varint size, data...)
 
   // Read the entry header; extract the varint and it's size in bytes.
   byte varint_buf[kMaxEntryPreambleBytes];
   RawRead(varint_buf,
-          IncrementIndex(read_idx_, user_preamble_ ? 1 : 0),
+          IncrementIndex(read_idx, user_preamble_ ? 1 : 0),
           kMaxEntryPreambleBytes);
-  uint64_t entry_size;
+  uint64_t entry_size = 0;
   size_t varint_size = varint::Decode(varint_buf, &entry_size);
 
   EntryInfo info = {};
@@ -221,20 +433,30 @@ PrefixedEntryRingBuffer::EntryInfo PrefixedEntryRingBuffer::FrontEntryInfo() {
 
 // Comparisons ordered for more probable early exits, assuming the reader is
 // not far behind the writer compared to the size of the ring.
-size_t PrefixedEntryRingBuffer::RawAvailableBytes() {
+size_t PrefixedEntryRingBufferMulti::RawAvailableBytes() {
+  // Case: No readers; nothing is kept.
+  if (readers_.empty()) {
+    return buffer_bytes_;
+  }
+
+  // Space is available up to the oldest entry any reader has left to read.
+  const Reader& slowest = GetSlowestReader();
+  const size_t read_idx = slowest.read_idx_;
+
   // Case: Not wrapped.
-  if (read_idx_ < write_idx_) {
-    return buffer_bytes_ - (write_idx_ - read_idx_);
+  if (read_idx < write_idx_) {
+    return buffer_bytes_ - (write_idx_ - read_idx);
   }
   // Case: Wrapped
-  if (read_idx_ > write_idx_) {
-    return read_idx_ - write_idx_;
+  if (read_idx > write_idx_) {
+    return read_idx - write_idx_;
   }
   // Case: Matched read and write heads; empty or full.
-  return entry_count_ ? 0 : buffer_bytes_;
+  return slowest.entry_count_ ? 0 : buffer_bytes_;
 }
 
-void PrefixedEntryRingBuffer::RawWrite(std::span<const std::byte> source) {
+void PrefixedEntryRingBufferMulti::RawWrite(
+    std::span<const std::byte> source) {
   // Write until the end of the source or the backing buffer.
   size_t bytes_until_wrap = buffer_bytes_ - write_idx_;
   size_t bytes_to_copy = std::min(source.size(), bytes_until_wrap);
@@ -248,9 +470,9 @@ void PrefixedEntryRingBuffer::RawWrite(std::span<const std::byte> source) {
   write_idx_ = IncrementIndex(write_idx_, source.size());
 }
 
-void PrefixedEntryRingBuffer::RawRead(byte* destination,
-                                      size_t source_idx,
-                                      size_t length_bytes) {
+void PrefixedEntryRingBufferMulti::RawRead(byte* destination,
+                                           size_t source_idx,
+                                           size_t length_bytes) {
   // Read the pre-wrap bytes.
   size_t bytes_until_wrap = buffer_bytes_ - source_idx;
   size_t bytes_to_copy = std::min(length_bytes, bytes_until_wrap);
@@ -262,7 +484,8 @@ void PrefixedEntryRingBuffer::RawRead(byte* destination,
   }
 }
 
-size_t PrefixedEntryRingBuffer::IncrementIndex(size_t index, size_t count) {
+size_t PrefixedEntryRingBufferMulti::IncrementIndex(size_t index,
+                                                    size_t count) {
   // Note: This doesn't use modulus (%) since the branch is cheaper, and we
   // guarantee that count will never be greater than buffer_bytes_.
   index += count;
@@ -16,6 +16,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 #include "pw_assert/assert.h"
 #include "pw_containers/vector.h"
@@ -370,7 +371,7 @@ TEST(PrefixedEntryRingBuffer, Dering) { DeringTest(true); }
 TEST(PrefixedEntryRingBuffer, DeringNoPreload) { DeringTest(false); }
 
 template <typename T>
-Status PushBack(PrefixedEntryRingBuffer& ring, T element) {
+Status PushBack(PrefixedEntryRingBufferMulti& ring, T element) {
   union {
     std::array<byte, sizeof(element)> buffer;
     T item;
@@ -380,7 +381,7 @@ Status PushBack(PrefixedEntryRingBuffer& ring, T element) {
 }
 
 template <typename T>
-Status TryPushBack(PrefixedEntryRingBuffer& ring, T element) {
+Status TryPushBack(PrefixedEntryRingBufferMulti& ring, T element) {
   union {
     std::array<byte, sizeof(element)> buffer;
     T item;
@@ -390,13 +391,13 @@ Status TryPushBack(PrefixedEntryRingBuffer& ring, T element) {
 }
 
 template <typename T>
-T PeekFront(PrefixedEntryRingBuffer& ring) {
+T PeekFront(PrefixedEntryRingBufferMulti::Reader& reader) {
   union {
     std::array<byte, sizeof(T)> buffer;
     T item;
   } aliased;
   size_t bytes_read = 0;
-  PW_CHECK_OK(ring.PeekFront(aliased.buffer, &bytes_read));
+  PW_CHECK_OK(reader.PeekFront(aliased.buffer, &bytes_read));
   PW_CHECK_INT_EQ(bytes_read, sizeof(T));
   return aliased.item;
 }
@@ -432,6 +433,332 @@ TEST(PrefixedEntryRingBuffer, TryPushBack) {
   EXPECT_EQ(PeekFront<int>(ring), 100);
 }
 
+TEST(PrefixedEntryRingBuffer, ReserveAndCommit) {
+  PrefixedEntryRingBuffer ring(true);
+  byte test_buffer[kTestBufferSize];
+  EXPECT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  std::span<byte> reserved;
+  ASSERT_EQ(ring.Reserve(10, &reserved, byte(0xaa)), OkStatus());
+  ASSERT_EQ(reserved.size(), 10u);
+  for (size_t i = 0; i < 6; ++i) {
+    reserved[i] = byte(i);
+  }
+  EXPECT_EQ(ring.EntryCount(), 0u);
+  EXPECT_EQ(ring.Commit(6), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), 1u);
+
+  byte output[16];
+  size_t bytes_read;
+  EXPECT_EQ(ring.PeekFrontWithPreamble(output, &bytes_read), OkStatus());
+  ASSERT_EQ(bytes_read, 8u);
+  EXPECT_EQ(output[0], byte(0xaa));
+  EXPECT_EQ(output[1], byte(6));
+  for (size_t i = 0; i < 6; ++i) {
+    EXPECT_EQ(output[2 + i], byte(i));
+  }
+}
+
+TEST(PrefixedEntryRingBuffer, CommitPadsVarint) {
+  PrefixedEntryRingBuffer ring;
+  byte test_buffer[512];
+  EXPECT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  // A 300 byte entry needs a two byte varint, so the varint of a 5 byte entry
+  // is padded.
+  std::span<byte> reserved;
+  ASSERT_EQ(ring.Reserve(300, &reserved), OkStatus());
+  for (size_t i = 0; i < 5; ++i) {
+    reserved[i] = byte(0x10 + i);
+  }
+  EXPECT_EQ(ring.Commit(5), OkStatus());
+  EXPECT_EQ(ring.FrontEntryDataSizeBytes(), 5u);
+  EXPECT_EQ(ring.FrontEntryTotalSizeBytes(), 7u);
+
+  byte output[8];
+  size_t bytes_read;
+  EXPECT_EQ(ring.PeekFront(output, &bytes_read), OkStatus());
+  ASSERT_EQ(bytes_read, 5u);
+  for (size_t i = 0; i < 5; ++i) {
+    EXPECT_EQ(output[i], byte(0x10 + i));
+  }
+}
+
+TEST(PrefixedEntryRingBuffer, ReserveDeringsToAvoidWrapping) {
+  PrefixedEntryRingBuffer ring;
+  byte test_buffer[kTestBufferSize];
+  EXPECT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  // Leave the write index near the end of the buffer, with one entry stored.
+  constexpr size_t kEntrySize = kTestBufferSize / 4;
+  byte entry[kEntrySize] = {};
+  for (int i = 0; i < 3; ++i) {
+    entry[0] = byte(i);
+    EXPECT_EQ(ring.PushBack(entry), OkStatus());
+  }
+  EXPECT_EQ(ring.PopFront(), OkStatus());
+  EXPECT_EQ(ring.PopFront(), OkStatus());
+
+  std::span<byte> reserved;
+  ASSERT_EQ(ring.TryReserve(kEntrySize, &reserved), OkStatus());
+  EXPECT_GE(reserved.data(), test_buffer);
+  EXPECT_LE(reserved.data() + reserved.size(), test_buffer + kTestBufferSize);
+  reserved[0] = byte(3);
+  EXPECT_EQ(ring.Commit(kEntrySize), OkStatus());
+
+  // Both entries survive, in order.
+  byte output[kEntrySize];
+  size_t bytes_read;
+  for (int i = 2; i < 4; ++i) {
+    EXPECT_EQ(ring.PeekFront(output, &bytes_read), OkStatus());
+    EXPECT_EQ(bytes_read, kEntrySize);
+    EXPECT_EQ(output[0], byte(i));
+    EXPECT_EQ(ring.PopFront(), OkStatus());
+  }
+  EXPECT_EQ(ring.EntryCount(), 0u);
+}
+
+TEST(PrefixedEntryRingBuffer, ReserveErrors) {
+  PrefixedEntryRingBuffer ring;
+  std::span<byte> reserved;
+  EXPECT_EQ(ring.Reserve(4, &reserved), Status::FailedPrecondition());
+
+  byte test_buffer[kTestBufferSize];
+  EXPECT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+  EXPECT_EQ(ring.Reserve(0, &reserved), Status::InvalidArgument());
+  EXPECT_EQ(ring.Reserve(kTestBufferSize, &reserved), Status::OutOfRange());
+  EXPECT_EQ(ring.Commit(1), Status::FailedPrecondition());
+
+  // Nothing else may be written while space is reserved.
+  ASSERT_EQ(ring.Reserve(4, &reserved), OkStatus());
+  EXPECT_EQ(ring.Reserve(4, &reserved), Status::FailedPrecondition());
+  EXPECT_EQ(ring.PushBack(reserved), Status::FailedPrecondition());
+  EXPECT_EQ(ring.Dering(), Status::FailedPrecondition());
+  EXPECT_EQ(ring.Commit(5), Status::OutOfRange());
+
+  // Committing no bytes discards the reservation.
+  EXPECT_EQ(ring.Commit(0), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), 0u);
+  EXPECT_EQ(ring.Commit(0), Status::FailedPrecondition());
+}
+
+TEST(PrefixedEntryRingBuffer, TryReserveDoesNotEvict) {
+  PrefixedEntryRingBuffer ring;
+  byte test_buffer[kTestBufferSize];
+  EXPECT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  byte entry[kTestBufferSize / 2] = {};
+  EXPECT_EQ(ring.PushBack(entry), OkStatus());
+
+  std::span<byte> reserved;
+  EXPECT_EQ(ring.TryReserve(sizeof(entry), &reserved),
+            Status::ResourceExhausted());
+  EXPECT_EQ(ring.EntryCount(), 1u);
+
+  // Reserve evicts the stored entry to make space.
+  ASSERT_EQ(ring.Reserve(sizeof(entry), &reserved), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), 0u);
+  EXPECT_EQ(ring.Commit(sizeof(entry)), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), 1u);
+}
+
+TEST(PrefixedEntryRingBuffer, PeekAndPopFrontVisitsWrappedEntries) {
+  PrefixedEntryRingBuffer ring(true);
+  byte test_buffer[kTestBufferSize];
+  EXPECT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  // Wrap the entries around the end of the buffer.
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(ring.PushBack(std::as_bytes(std::span(&i, 1)), byte(i)),
+              OkStatus());
+  }
+  const size_t entry_count = ring.EntryCount();
+  int next_value = 100 - static_cast<int>(entry_count);
+
+  size_t visited = 0;
+  auto visit = [&](byte user_preamble,
+                   std::span<const byte> data,
+                   std::span<const byte> wrapped_data) {
+    int value;
+    EXPECT_EQ(data.size() + wrapped_data.size(), sizeof(value));
+    std::memcpy(&value, data.data(), data.size());
+    std::memcpy(reinterpret_cast<byte*>(&value) + data.size(),
+                wrapped_data.data(),
+                wrapped_data.size());
+    EXPECT_EQ(value, next_value);
+    EXPECT_EQ(user_preamble, byte(next_value));
+    next_value++;
+    visited++;
+    return OkStatus();
+  };
+
+  EXPECT_EQ(ring.PeekAndPopFront(visit, 3), OkStatus());
+  EXPECT_EQ(visited, 3u);
+  EXPECT_EQ(ring.EntryCount(), entry_count - 3);
+
+  // The byte budget stops before the entry that would exceed it.
+  EXPECT_EQ(ring.PeekAndPopFront(visit, 10, 2 * sizeof(int) + 1),
+            OkStatus());
+  EXPECT_EQ(visited, 5u);
+  EXPECT_EQ(PeekFront<int>(ring), next_value);
+
+  EXPECT_EQ(ring.PeekAndPopFront(visit), OkStatus());
+  EXPECT_EQ(visited, entry_count);
+  EXPECT_EQ(ring.EntryCount(), 0u);
+  EXPECT_EQ(ring.PeekAndPopFront(visit), Status::OutOfRange());
+}
+
+TEST(PrefixedEntryRingBuffer, PeekAndPopFrontStopsOnError) {
+  PrefixedEntryRingBuffer ring;
+  byte test_buffer[kTestBufferSize];
+  EXPECT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(PushBack<int>(ring, i), OkStatus());
+  }
+
+  EXPECT_EQ(ring.PeekAndPopFront(
+                [](byte, std::span<const byte>, std::span<const byte>) {
+                  return OkStatus();
+                },
+                10,
+                sizeof(int) - 1),
+            Status::ResourceExhausted());
+  EXPECT_EQ(ring.EntryCount(), 4u);
+
+  int visited = 0;
+  EXPECT_EQ(ring.PeekAndPopFront(
+                [&visited](byte, std::span<const byte>, std::span<const byte>) {
+                  return ++visited == 3 ? Status::Unavailable() : OkStatus();
+                }),
+            Status::Unavailable());
+  EXPECT_EQ(ring.EntryCount(), 2u);
+  EXPECT_EQ(PeekFront<int>(ring), 2);
+}
+
+TEST(PrefixedEntryRingBufferMulti, EachReaderReadsAllEntries) {
+  PrefixedEntryRingBufferMulti ring;
+  byte test_buffer[kTestBufferSize];
+  EXPECT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  PrefixedEntryRingBufferMulti::Reader fast_reader;
+  PrefixedEntryRingBufferMulti::Reader slow_reader;
+  EXPECT_EQ(ring.AttachReader(fast_reader), OkStatus());
+  EXPECT_EQ(ring.AttachReader(slow_reader), OkStatus());
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(PushBack<int>(ring, i), OkStatus());
+  }
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(PeekFront<int>(fast_reader), i);
+    EXPECT_EQ(fast_reader.PopFront(), OkStatus());
+  }
+  EXPECT_EQ(fast_reader.EntryCount(), 0u);
+  EXPECT_EQ(fast_reader.PopFront(), Status::OutOfRange());
+
+  // Entries stay in the buffer until the slow reader pops them too.
+  EXPECT_EQ(slow_reader.EntryCount(), 3u);
+  EXPECT_EQ(ring.TotalUsedBytes(), 3 * (1 + sizeof(int)));
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(PeekFront<int>(slow_reader), i);
+    EXPECT_EQ(slow_reader.PopFront(), OkStatus());
+  }
+  EXPECT_EQ(ring.TotalUsedBytes(), 0u);
+}
+
+TEST(PrefixedEntryRingBufferMulti, SlowestReaderGovernsEviction) {
+  PrefixedEntryRingBufferMulti ring;
+  byte test_buffer[kTestBufferSize];
+  EXPECT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  PrefixedEntryRingBufferMulti::Reader fast_reader;
+  PrefixedEntryRingBufferMulti::Reader slow_reader;
+  EXPECT_EQ(ring.AttachReader(fast_reader), OkStatus());
+  EXPECT_EQ(ring.AttachReader(slow_reader), OkStatus());
+
+  // The slow reader never reads, so once the buffer is full each new entry
+  // evicts one of its oldest entries.
+  constexpr int kEntries = 100;
+  for (int i = 0; i < kEntries; ++i) {
+    EXPECT_EQ(PushBack<int>(ring, i), OkStatus());
+    EXPECT_EQ(PeekFront<int>(fast_reader), i);
+    EXPECT_EQ(fast_reader.PopFront(), OkStatus());
+  }
+  EXPECT_EQ(fast_reader.DroppedEntries(), 0u);
+  EXPECT_GT(slow_reader.DroppedEntries(), 0u);
+  EXPECT_EQ(slow_reader.DroppedEntries() + slow_reader.EntryCount(),
+            static_cast<size_t>(kEntries));
+  EXPECT_EQ(PeekFront<int>(slow_reader),
+            static_cast<int>(slow_reader.DroppedEntries()));
+
+  // Without room for new entries, TryPushBack does not evict.
+  EXPECT_EQ(TryPushBack<int>(ring, kEntries), Status::ResourceExhausted());
+}
+
+TEST(PrefixedEntryRingBufferMulti, AttachAndDetachReaders) {
+  PrefixedEntryRingBufferMulti ring;
+  byte test_buffer[kTestBufferSize];
+  EXPECT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  // Entries written without readers are not kept.
+  EXPECT_EQ(PushBack<int>(ring, 1), OkStatus());
+  EXPECT_EQ(ring.TotalUsedBytes(), 0u);
+
+  PrefixedEntryRingBufferMulti::Reader first_reader;
+  EXPECT_EQ(first_reader.PopFront(), Status::FailedPrecondition());
+  EXPECT_EQ(ring.AttachReader(first_reader), OkStatus());
+  EXPECT_EQ(ring.AttachReader(first_reader), Status::InvalidArgument());
+  EXPECT_EQ(first_reader.EntryCount(), 0u);
+
+  EXPECT_EQ(PushBack<int>(ring, 2), OkStatus());
+  EXPECT_EQ(PushBack<int>(ring, 3), OkStatus());
+
+  // A new reader starts at the oldest entry kept.
+  PrefixedEntryRingBufferMulti::Reader second_reader;
+  EXPECT_EQ(ring.AttachReader(second_reader), OkStatus());
+  EXPECT_EQ(second_reader.EntryCount(), 2u);
+  EXPECT_EQ(PeekFront<int>(second_reader), 2);
+
+  EXPECT_EQ(ring.DetachReader(first_reader), OkStatus());
+  EXPECT_EQ(ring.DetachReader(first_reader), Status::InvalidArgument());
+  EXPECT_EQ(second_reader.PopFront(), OkStatus());
+  EXPECT_EQ(PeekFront<int>(second_reader), 3);
+  EXPECT_EQ(ring.TotalUsedBytes(), 1 + sizeof(int));
+}
+
+TEST(PrefixedEntryRingBufferMulti, DeringKeepsEachReaderPosition) {
+  PrefixedEntryRingBufferMulti ring;
+  byte test_buffer[kTestBufferSize];
+  EXPECT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  PrefixedEntryRingBufferMulti::Reader fast_reader;
+  PrefixedEntryRingBufferMulti::Reader slow_reader;
+  EXPECT_EQ(ring.AttachReader(fast_reader), OkStatus());
+  EXPECT_EQ(ring.AttachReader(slow_reader), OkStatus());
+
+  // Wrap the entries around the end of the buffer.
+  int next_value = 0;
+  for (size_t i = 0; i < kTestBufferSize; ++i) {
+    EXPECT_EQ(PushBack<int>(ring, next_value++), OkStatus());
+  }
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(fast_reader.PopFront(), OkStatus());
+  }
+  const int fast_front = PeekFront<int>(fast_reader);
+  const int slow_front = PeekFront<int>(slow_reader);
+
+  EXPECT_EQ(ring.Dering(), OkStatus());
+  EXPECT_EQ(PeekFront<int>(fast_reader), fast_front);
+  EXPECT_EQ(PeekFront<int>(slow_reader), slow_front);
+
+  // The oldest entry is now at the start of the buffer.
+  size_t entry_count = slow_reader.EntryCount();
+  for (int value = slow_front; entry_count > 0; ++value, --entry_count) {
+    EXPECT_EQ(PeekFront<int>(slow_reader), value);
+    EXPECT_EQ(slow_reader.PopFront(), OkStatus());
+  }
+  EXPECT_EQ(PeekFront<int>(fast_reader), fast_front);
+}
+
 }  // namespace
 }  // namespace ring_buffer
 }  // namespace pw
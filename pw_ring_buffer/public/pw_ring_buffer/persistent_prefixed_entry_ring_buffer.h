@@ -0,0 +1,116 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_ring_buffer/prefixed_entry_ring_buffer.h"
+#include "pw_status/status.h"
+
+namespace pw {
+namespace ring_buffer {
+
+// A PrefixedEntryRingBuffer that keeps its indices in a header at the start of
+// its region, so that its entries survive a warm reset when the region is not
+// initialized at boot, such as in a .noinit section. The header holds a magic
+// number, the indices and a CRC32 of them, and is saved after each change to
+// the entries.
+//
+// On SetBuffer, the entries are recovered if the header is valid and matches
+// whole entries in the buffer. Otherwise, such as on a cold boot or if the
+// reset interrupted a write, the buffer is cleared.
+class PersistentPrefixedEntryRingBuffer {
+ public:
+  PersistentPrefixedEntryRingBuffer(bool user_preamble = false)
+      : ring_(user_preamble),
+        header_(nullptr),
+        user_preamble_(user_preamble),
+        recovered_(false) {}
+
+  PersistentPrefixedEntryRingBuffer(const PersistentPrefixedEntryRingBuffer&) =
+      delete;
+  PersistentPrefixedEntryRingBuffer& operator=(
+      const PersistentPrefixedEntryRingBuffer&) = delete;
+
+  // Set the region used by the ring buffer, and recover the entries saved in
+  // it, if any. The first kHeaderBytes bytes of the region hold the header,
+  // and the rest holds the entries. recovered() reports whether the entries
+  // were recovered or the buffer was cleared.
+  //
+  // Return values:
+  // OK - successfully set the region.
+  // INVALID_ARGUMENT - Argument was nullptr, or too small for the header and
+  // any entry.
+  Status SetBuffer(std::span<std::byte> region);
+
+  // True if SetBuffer recovered the entries saved in the region.
+  bool recovered() const { return recovered_; }
+
+  // Removes all data from the ring buffer.
+  void Clear();
+
+  // As PrefixedEntryRingBuffer::PushBack, and saves the header.
+  Status PushBack(std::span<const std::byte> data,
+                  std::byte user_preamble_data = std::byte(0));
+
+  // As PrefixedEntryRingBuffer::TryPushBack, and saves the header.
+  Status TryPushBack(std::span<const std::byte> data,
+                     std::byte user_preamble_data = std::byte(0));
+
+  // As PrefixedEntryRingBuffer::PeekFront.
+  Status PeekFront(std::span<std::byte> data, size_t* bytes_read) {
+    return ring_.PeekFront(data, bytes_read);
+  }
+
+  // As PrefixedEntryRingBuffer::PeekFrontWithPreamble.
+  Status PeekFrontWithPreamble(std::span<std::byte> data, size_t* bytes_read) {
+    return ring_.PeekFrontWithPreamble(data, bytes_read);
+  }
+
+  // As PrefixedEntryRingBuffer::PopFront, and saves the header.
+  Status PopFront();
+
+  size_t EntryCount() { return ring_.EntryCount(); }
+  size_t FrontEntryDataSizeBytes() { return ring_.FrontEntryDataSizeBytes(); }
+  size_t TotalUsedBytes() { return ring_.TotalUsedBytes(); }
+
+ private:
+  struct Header {
+    uint32_t magic;
+    uint32_t checksum;
+    size_t data_bytes;
+    PrefixedEntryRingBufferMulti::State state;
+  };
+
+ public:
+  // Size of the header at the start of the region.
+  static constexpr size_t kHeaderBytes = sizeof(Header);
+
+ private:
+  uint32_t Magic() const;
+  static uint32_t Checksum(const Header& header);
+
+  // Write the header for the ring buffer's current state to the region.
+  void SaveHeader();
+
+  PrefixedEntryRingBuffer ring_;
+  std::byte* header_;
+  const bool user_preamble_;
+  bool recovered_;
+};
+
+}  // namespace ring_buffer
+}  // namespace pw
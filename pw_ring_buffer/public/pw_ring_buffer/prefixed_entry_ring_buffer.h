@@ -13,9 +13,12 @@
 // the License.
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
+#include <limits>
 #include <span>
 
+#include "pw_containers/intrusive_list.h"
 #include "pw_status/status.h"
 
 namespace pw {
@@ -30,18 +33,129 @@ namespace ring_buffer {
 // The ring buffer holds the most recent entries stored in the buffer. Once
 // filled to capacity, incoming entries bump out the oldest entries to make
 // room. Entries are internally wrapped around as needed.
-class PrefixedEntryRingBuffer {
+//
+// Entries are read through Readers attached to the ring buffer, each with its
+// own read position, so several consumers can drain the same entries. The
+// slowest reader, with the most entries left to read, governs eviction: an
+// entry is only bumped out when that reader is popped past it, and is counted
+// in that reader's dropped entries.
+class PrefixedEntryRingBufferMulti {
  public:
   typedef Status (*ReadOutput)(std::span<const std::byte>);
 
-  PrefixedEntryRingBuffer(bool user_preamble = false)
+  class Reader : public IntrusiveList<Reader>::Item {
+   public:
+    constexpr Reader()
+        : ring_(nullptr), read_idx_(0), entry_count_(0), dropped_entries_(0) {}
+
+    ~Reader() {
+      if (ring_ != nullptr) {
+        ring_->DetachReader(*this);
+      }
+    }
+
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    // Read the oldest stored data chunk of data from the ring buffer to
+    // the provided destination std::span. The number of bytes read is written
+    // to bytes_read
+    //
+    // Return values:
+    // OK - Data successfully read from the ring buffer.
+    // FAILED_PRECONDITION - Buffer not initialized, or reader not attached.
+    // OUT_OF_RANGE - No entries in ring buffer to read.
+    // RESOURCE_EXHAUSTED - Destination data std::span was smaller number of
+    // bytes than the data size of the data chunk being read.  Available
+    // destination bytes were filled, remaining bytes of the data chunk were
+    // ignored.
+    Status PeekFront(std::span<std::byte> data, size_t* bytes_read);
+
+    Status PeekFront(ReadOutput output);
+
+    // Same as Read but includes the entry's preamble of optional user value
+    // and the varint of the data size
+    Status PeekFrontWithPreamble(std::span<std::byte> data,
+                                 size_t* bytes_read);
+
+    Status PeekFrontWithPreamble(ReadOutput output);
+
+    // Pop and discard the oldest stored data chunk of data from the ring
+    // buffer for this reader. Other readers still read the entry.
+    //
+    // Return values:
+    // OK - Data successfully read from the ring buffer.
+    // FAILED_PRECONDITION - Buffer not initialized, or reader not attached.
+    // OUT_OF_RANGE - No entries in ring buffer to pop.
+    Status PopFront();
+
+    // Visit up to max_entries of the oldest entries, in order, with data
+    // totalling at most max_bytes, and then pop them all at once. This parses
+    // each entry's preamble once, rather than for each call to PeekFront and
+    // PopFront. visit is called as
+    //
+    //   Status visit(std::byte user_preamble,
+    //                std::span<const std::byte> data,
+    //                std::span<const std::byte> wrapped_data)
+    //
+    // The entry data is data followed by wrapped_data, which is empty unless
+    // the entry wraps around the end of the buffer. user_preamble is zero if
+    // user_preamble was not set at class construction time. If visit returns
+    // an error, the entries before that one are popped and the error is
+    // returned. The ring buffer must not be written from visit.
+    //
+    // Return values:
+    // OK - Entries successfully visited and popped.
+    // FAILED_PRECONDITION - Buffer not initialized, or reader not attached.
+    // OUT_OF_RANGE - No entries in ring buffer to read.
+    // RESOURCE_EXHAUSTED - The data of the oldest entry is larger than
+    // max_bytes. No entries were popped.
+    template <typename Visitor>
+    Status PeekAndPopFront(
+        Visitor&& visit,
+        size_t max_entries = std::numeric_limits<size_t>::max(),
+        size_t max_bytes = std::numeric_limits<size_t>::max());
+
+    // Get the number of variable-length entries left for this reader to read.
+    //
+    // Return value:
+    // Entry count.
+    size_t EntryCount() { return entry_count_; }
+
+    // Get the size in bytes of the next chunk, not including preamble, to be
+    // read.
+    size_t FrontEntryDataSizeBytes();
+
+    // Get the size in bytes of the next chunk, including preamble and data
+    // chunk, to be read.
+    size_t FrontEntryTotalSizeBytes();
+
+    // Get the number of entries that were bumped out by writes before this
+    // reader read them.
+    size_t DroppedEntries() const { return dropped_entries_; }
+
+   private:
+    friend class PrefixedEntryRingBufferMulti;
+
+    PrefixedEntryRingBufferMulti* ring_;
+    size_t read_idx_;
+    size_t entry_count_;
+    size_t dropped_entries_;
+  };
+
+  PrefixedEntryRingBufferMulti(bool user_preamble = false)
       : buffer_(nullptr),
         buffer_bytes_(0),
         write_idx_(0),
-        read_idx_(0),
-        entry_count_(0),
+        reserved_bytes_(0),
+        reserved_varint_bytes_(0),
+        reserved_user_preamble_(std::byte(0)),
         user_preamble_(user_preamble) {}
 
+  PrefixedEntryRingBufferMulti(const PrefixedEntryRingBufferMulti&) = delete;
+  PrefixedEntryRingBufferMulti& operator=(const PrefixedEntryRingBufferMulti&) =
+      delete;
+
   // Set the raw buffer to be used by the ring buffer.
   //
   // Return values:
@@ -49,9 +163,26 @@ class PrefixedEntryRingBuffer {
   // INVALID_ARGUMENT - Argument was nullptr, size zero, or too large.
   Status SetBuffer(std::span<std::byte> buffer);
 
-  // Removes all data from the ring buffer.
+  // Removes all data from the ring buffer, for all readers.
   void Clear();
 
+  // Attach a reader to the ring buffer. The reader starts at the oldest entry
+  // held for the other readers, or at the next entry written if there are no
+  // other readers. Entries written while no reader is attached are discarded.
+  //
+  // Return values:
+  // OK - Reader successfully attached.
+  // INVALID_ARGUMENT - The reader is already attached to a ring buffer.
+  Status AttachReader(Reader& reader);
+
+  // Detach a reader from the ring buffer. Entries only it had left to read are
+  // discarded.
+  //
+  // Return values:
+  // OK - Reader successfully detached.
+  // INVALID_ARGUMENT - The reader is not attached to this ring buffer.
+  Status DetachReader(Reader& reader);
+
   // Write a chunk of data to the ring buffer. If available space is less than
   // size of data chunk to be written then silently pop and discard oldest
   // stored data chunks until space is available.
@@ -63,7 +194,7 @@ class PrefixedEntryRingBuffer {
   // Return values:
   // OK - Data successfully written to the ring buffer.
   // INVALID_ARGUMENT - Size of data to write is zero bytes
-  // FAILED_PRECONDITION - Buffer not initialized.
+  // FAILED_PRECONDITION - Buffer not initialized, or space is reserved.
   // OUT_OF_RANGE - Size of data is greater than buffer size.
   Status PushBack(std::span<const std::byte> data,
                   std::byte user_preamble_data = std::byte(0)) {
@@ -79,7 +210,7 @@ class PrefixedEntryRingBuffer {
   // Return values:
   // OK - Data successfully written to the ring buffer.
   // INVALID_ARGUMENT - Size of data to write is zero bytes
-  // FAILED_PRECONDITION - Buffer not initialized.
+  // FAILED_PRECONDITION - Buffer not initialized, or space is reserved.
   // OUT_OF_RANGE - Size of data is greater than buffer size.
   // RESOURCE_EXHAUSTED - The ring buffer doesn't have space for the data
   // without popping off existing elements.
@@ -88,34 +219,59 @@ class PrefixedEntryRingBuffer {
     return InternalPushBack(data, user_preamble_data, false);
   }
 
-  // Read the oldest stored data chunk of data from the ring buffer to
-  // the provided destination std::span. The number of bytes read is written to
-  // bytes_read
+  // Reserve space for an entry of up to max_size bytes, so that a producer can
+  // write, or encode, the entry directly into the ring buffer rather than into
+  // a separate buffer that PushBack copies from. On success, reserved is set
+  // to max_size contiguous bytes in the ring buffer. The entry is added once
+  // Commit is called with the number of bytes written. If available space is
+  // less than max_size plus the preamble, then silently pop and discard oldest
+  // stored data chunks until space is available.
+  //
+  // If the space for the entry would wrap around the end of the buffer, the
+  // buffer is deringed first, which moves all stored entries.
+  //
+  // Until Commit, entries may be read and popped, but no other entry may be
+  // written and the buffer cannot be deringed.
   //
   // Return values:
-  // OK - Data successfully read from the ring buffer.
-  // FAILED_PRECONDITION - Buffer not initialized.
-  // OUT_OF_RANGE - No entries in ring buffer to read.
-  // RESOURCE_EXHAUSTED - Destination data std::span was smaller number of bytes
-  // than the data size of the data chunk being read.  Available destination
-  // bytes were filled, remaining bytes of the data chunk were ignored.
-  Status PeekFront(std::span<std::byte> data, size_t* bytes_read);
-
-  Status PeekFront(ReadOutput output);
-
-  // Same as Read but includes the entry's preamble of optional user value and
-  // the varint of the data size
-  Status PeekFrontWithPreamble(std::span<std::byte> data, size_t* bytes_read);
+  // OK - Space successfully reserved in the ring buffer.
+  // INVALID_ARGUMENT - max_size is zero bytes
+  // FAILED_PRECONDITION - Buffer not initialized, or space already reserved.
+  // OUT_OF_RANGE - max_size is greater than buffer size.
+  Status Reserve(size_t max_size,
+                 std::span<std::byte>* reserved,
+                 std::byte user_preamble_data = std::byte(0)) {
+    return InternalReserve(max_size, reserved, user_preamble_data, true);
+  }
 
-  Status PeekFrontWithPreamble(ReadOutput output);
+  // Reserve space for an entry of up to max_size bytes, as Reserve does, if
+  // there is space available.
+  //
+  // Return values:
+  // OK - Space successfully reserved in the ring buffer.
+  // INVALID_ARGUMENT - max_size is zero bytes
+  // FAILED_PRECONDITION - Buffer not initialized, or space already reserved.
+  // OUT_OF_RANGE - max_size is greater than buffer size.
+  // RESOURCE_EXHAUSTED - The ring buffer doesn't have space for max_size bytes
+  // without popping off existing elements.
+  Status TryReserve(size_t max_size,
+                    std::span<std::byte>* reserved,
+                    std::byte user_preamble_data = std::byte(0)) {
+    return InternalReserve(max_size, reserved, user_preamble_data, false);
+  }
 
-  // Pop and discard the oldest stored data chunk of data from the ring buffer.
+  // Add the entry written to the space from Reserve or TryReserve, using the
+  // first size bytes of the space. A size of zero discards the reservation
+  // without adding an entry.
+  //
+  // If size needs a shorter varint than the reserved max_size, the varint is
+  // padded with continuation bytes, so entry data is never moved.
   //
   // Return values:
-  // OK - Data successfully read from the ring buffer.
-  // FAILED_PRECONDITION - Buffer not initialized.
-  // OUT_OF_RANGE - No entries in ring buffer to pop.
-  Status PopFront();
+  // OK - Entry successfully added, or reservation discarded.
+  // FAILED_PRECONDITION - No space is reserved.
+  // OUT_OF_RANGE - size is greater than the reserved max_size.
+  Status Commit(size_t size);
 
   // Dering the buffer by reordering entries internally in the buffer by
   // rotating to have the oldest entry is at the lowest address/index with
@@ -123,28 +279,37 @@ class PrefixedEntryRingBuffer {
   //
   // Return values:
   // OK - Buffer data successfully deringed.
-  // FAILED_PRECONDITION - Buffer not initialized.
+  // FAILED_PRECONDITION - Buffer not initialized, or space is reserved.
   Status Dering();
 
-  // Get the number of variable-length entries currently in the ring buffer.
-  //
-  // Return value:
-  // Entry count.
-  size_t EntryCount() { return entry_count_; }
-
   // Get the size in bytes of all the current entries in the ring buffer,
-  // including preamble and data chunk.
+  // including preamble and data chunk, for the slowest reader.
   size_t TotalUsedBytes() { return buffer_bytes_ - RawAvailableBytes(); }
 
-  // Get the size in bytes of the next chunk, not including preamble, to be
-  // read.
-  size_t FrontEntryDataSizeBytes();
+ private:
+  friend class PersistentPrefixedEntryRingBuffer;
+
+  // The indices of a ring buffer with a single reader, which a persistent ring
+  // buffer saves to recover its entries after a reset.
+  struct State {
+    size_t read_idx;
+    size_t write_idx;
+    size_t entry_count;
+  };
 
-  // Get the size in bytes of the next chunk, including preamble and data
-  // chunk, to be read.
-  size_t FrontEntryTotalSizeBytes();
+  // Get the state of the ring buffer. There must be exactly one reader.
+  State GetState();
+
+  // Restore a state from GetState on an earlier use of the same buffer, after
+  // checking that the entries between the read and write indices are whole
+  // entries. There must be exactly one reader.
+  //
+  // Return values:
+  // OK - State successfully restored.
+  // DATA_LOSS - The state does not match the entries in the buffer. The ring
+  // buffer is unchanged.
+  Status RestoreState(const State& state);
 
- private:
   struct EntryInfo {
     size_t preamble_bytes;
     size_t data_bytes;
@@ -153,7 +318,10 @@ class PrefixedEntryRingBuffer {
   // Internal version of Read used by all the public interface versions. T
   // should be of type ReadOutput.
   template <typename T>
-  Status InternalRead(T read_output, bool get_preamble);
+  Status InternalRead(Reader& reader, T read_output, bool get_preamble);
+
+  // Pop implementation for the public and eviction paths.
+  Status InternalPopFront(Reader& reader);
 
   // Push back implementation, which optionally discards front elements to fit
   // the incoming element.
@@ -161,9 +329,27 @@ class PrefixedEntryRingBuffer {
                           std::byte user_preamble_data,
                           bool pop_front_if_needed);
 
-  // Get info struct with the size of the preamble and data chunk for the next
-  // entry to be read.
-  EntryInfo FrontEntryInfo();
+  // Reserve implementation, which optionally discards front elements to fit
+  // the reserved element.
+  Status InternalReserve(size_t max_size,
+                         std::span<std::byte>* reserved,
+                         std::byte user_preamble_data,
+                         bool pop_front_if_needed);
+
+  // Get the reader with the most entries left to read. There must be at least
+  // one reader.
+  Reader& GetSlowestReader();
+
+  // Discard the oldest entry of the slowest reader, to make space for a new
+  // entry, and count it as dropped.
+  void EvictFront();
+
+  // Count a newly written entry for every reader.
+  void AddEntryToReaders();
+
+  // Get info struct with the size of the preamble and data chunk for the
+  // entry at the given read index.
+  EntryInfo FrontEntryInfo(size_t read_idx);
 
   // Get the raw number of available bytes free in the ring buffer. This is
   // not available bytes for data, since there is a variable size preamble for
@@ -186,8 +372,14 @@ class PrefixedEntryRingBuffer {
   size_t buffer_bytes_;
 
   size_t write_idx_;
-  size_t read_idx_;
-  size_t entry_count_;
+  IntrusiveList<Reader> readers_;
+
+  // The data bytes and the size of the varint reserved for the entry between
+  // Reserve and Commit. reserved_bytes_ is zero if no entry is reserved.
+  size_t reserved_bytes_;
+  size_t reserved_varint_bytes_;
+  std::byte reserved_user_preamble_;
+
   const bool user_preamble_;
 
   // Worst case size for the variable-sized preable that is prepended to
@@ -200,5 +392,65 @@ class PrefixedEntryRingBuffer {
       std::numeric_limits<size_t>::max() / 2;
 };
 
+template <typename Visitor>
+Status PrefixedEntryRingBufferMulti::Reader::PeekAndPopFront(
+    Visitor&& visit, size_t max_entries, size_t max_bytes) {
+  if (ring_ == nullptr || ring_->buffer_ == nullptr) {
+    return Status::FailedPrecondition();
+  }
+  if (entry_count_ == 0) {
+    return Status::OutOfRange();
+  }
+
+  size_t idx = read_idx_;
+  size_t entries = 0;
+  size_t bytes = 0;
+  Status status;
+  while (entries < max_entries && entries < entry_count_) {
+    const EntryInfo info = ring_->FrontEntryInfo(idx);
+    if (info.data_bytes > max_bytes - bytes) {
+      if (entries == 0) {
+        status = Status::ResourceExhausted();
+      }
+      break;
+    }
+
+    std::byte user_preamble = std::byte(0);
+    if (ring_->user_preamble_) {
+      ring_->RawRead(&user_preamble, idx, 1);
+    }
+    const size_t data_idx = ring_->IncrementIndex(idx, info.preamble_bytes);
+    const size_t bytes_until_wrap = ring_->buffer_bytes_ - data_idx;
+    const size_t first_bytes = std::min(info.data_bytes, bytes_until_wrap);
+    status = visit(
+        user_preamble,
+        std::span<const std::byte>(ring_->buffer_ + data_idx, first_bytes),
+        std::span<const std::byte>(ring_->buffer_,
+                                   info.data_bytes - first_bytes));
+    if (!status.ok()) {
+      break;
+    }
+
+    idx = ring_->IncrementIndex(idx, info.preamble_bytes + info.data_bytes);
+    bytes += info.data_bytes;
+    entries++;
+  }
+
+  // Pop all the visited entries at once.
+  read_idx_ = idx;
+  entry_count_ -= entries;
+  return status;
+}
+
+// A PrefixedEntryRingBufferMulti that is also its own, single reader.
+class PrefixedEntryRingBuffer : public PrefixedEntryRingBufferMulti,
+                                public PrefixedEntryRingBufferMulti::Reader {
+ public:
+  PrefixedEntryRingBuffer(bool user_preamble = false)
+      : PrefixedEntryRingBufferMulti(user_preamble) {
+    AttachReader(*this);
+  }
+};
+
 }  // namespace ring_buffer
 }  // namespace pw
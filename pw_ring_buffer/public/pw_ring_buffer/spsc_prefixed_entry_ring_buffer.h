@@ -0,0 +1,153 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <span>
+
+#include "pw_status/status.h"
+
+namespace pw {
+namespace ring_buffer {
+
+// A ring buffer of entries in the PrefixedEntryRingBuffer format, for a single
+// producer and a single consumer that may run concurrently, such as an
+// interrupt handler that pushes entries and a thread that pops them. No lock
+// or critical section is needed: the producer only updates the write index and
+// the consumer only updates the read index. Each index is published with
+// release ordering after the entry bytes are written or read, and loaded with
+// acquire ordering by the other side. This needs atomic loads and stores of
+// size_t on the target.
+//
+// As the producer cannot discard entries the consumer may be reading, entries
+// are never evicted: when the buffer is full, TryPushBack fails. One byte of
+// the buffer is kept free to tell a full buffer from an empty one.
+class SpscPrefixedEntryRingBuffer {
+ public:
+  SpscPrefixedEntryRingBuffer(bool user_preamble = false)
+      : buffer_(nullptr),
+        buffer_bytes_(0),
+        write_idx_(0),
+        read_idx_(0),
+        user_preamble_(user_preamble) {}
+
+  SpscPrefixedEntryRingBuffer(const SpscPrefixedEntryRingBuffer&) = delete;
+  SpscPrefixedEntryRingBuffer& operator=(const SpscPrefixedEntryRingBuffer&) =
+      delete;
+
+  // Set the raw buffer to be used by the ring buffer, and remove all entries.
+  // Must not be called concurrently with the producer or the consumer.
+  //
+  // Return values:
+  // OK - successfully set the raw buffer.
+  // INVALID_ARGUMENT - Argument was nullptr, or size is less than two bytes.
+  Status SetBuffer(std::span<std::byte> buffer);
+
+  // Producer: write a chunk of data to the ring buffer if there is space
+  // available.
+  //
+  // Preamble argument is a caller-provided value prepended to the front of the
+  // entry. It is only used if user_preamble was set at class construction
+  // time.
+  //
+  // Return values:
+  // OK - Data successfully written to the ring buffer.
+  // INVALID_ARGUMENT - Size of data to write is zero bytes
+  // FAILED_PRECONDITION - Buffer not initialized.
+  // OUT_OF_RANGE - Size of data is greater than buffer size.
+  // RESOURCE_EXHAUSTED - The ring buffer doesn't have space for the data.
+  Status TryPushBack(std::span<const std::byte> data,
+                     std::byte user_preamble_data = std::byte(0));
+
+  // Consumer: read the oldest stored data chunk of data from the ring buffer
+  // to the provided destination std::span. The number of bytes read is written
+  // to bytes_read.
+  //
+  // Return values:
+  // OK - Data successfully read from the ring buffer.
+  // FAILED_PRECONDITION - Buffer not initialized.
+  // OUT_OF_RANGE - No entries in ring buffer to read.
+  // RESOURCE_EXHAUSTED - Destination data std::span was smaller number of bytes
+  // than the data size of the data chunk being read.  Available destination
+  // bytes were filled, remaining bytes of the data chunk were ignored.
+  Status PeekFront(std::span<std::byte> data, size_t* bytes_read) {
+    return InternalPeekFront(data, bytes_read, false);
+  }
+
+  // Same as PeekFront but includes the entry's preamble of optional user value
+  // and the varint of the data size.
+  Status PeekFrontWithPreamble(std::span<std::byte> data, size_t* bytes_read) {
+    return InternalPeekFront(data, bytes_read, true);
+  }
+
+  // Consumer: pop and discard the oldest stored data chunk of data from the
+  // ring buffer, freeing its space for the producer.
+  //
+  // Return values:
+  // OK - Data successfully read from the ring buffer.
+  // FAILED_PRECONDITION - Buffer not initialized.
+  // OUT_OF_RANGE - No entries in ring buffer to pop.
+  Status PopFront();
+
+  // Consumer: get the size in bytes of the next chunk, not including preamble,
+  // to be read, or 0 if there are no entries.
+  size_t FrontEntryDataSizeBytes();
+
+  // Get the size in bytes of all the current entries in the ring buffer,
+  // including preamble and data chunk. This is a snapshot, which may be stale
+  // by the time it is used if the other side is running.
+  size_t TotalUsedBytes() const;
+
+ private:
+  struct EntryInfo {
+    size_t preamble_bytes;
+    size_t data_bytes;
+  };
+
+  Status InternalPeekFront(std::span<std::byte> data,
+                           size_t* bytes_read,
+                           bool get_preamble);
+
+  // Get info struct with the size of the preamble and data chunk for the
+  // entry at read_idx. There must be an entry there.
+  EntryInfo EntryInfoAt(size_t read_idx) const;
+
+  // Copy bytes into and out of the buffer at an index, handling wrap-around.
+  void RawWrite(size_t write_idx, std::span<const std::byte> source);
+  void RawRead(std::byte* destination, size_t source_idx, size_t length) const;
+
+  size_t IncrementIndex(size_t index, size_t count) const {
+    index += count;
+    return index >= buffer_bytes_ ? index - buffer_bytes_ : index;
+  }
+
+  std::byte* buffer_;
+  size_t buffer_bytes_;
+
+  // Only stored by the producer.
+  std::atomic<size_t> write_idx_;
+
+  // Only stored by the consumer.
+  std::atomic<size_t> read_idx_;
+
+  const bool user_preamble_;
+
+  // Worst case size for the variable-sized preable that is prepended to
+  // each entry.
+  static constexpr size_t kMaxEntryPreambleBytes = sizeof(size_t) + 1;
+};
+
+}  // namespace ring_buffer
+}  // namespace pw
@@ -0,0 +1,191 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_ring_buffer/spsc_prefixed_entry_ring_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_varint/varint.h"
+
+namespace pw {
+namespace ring_buffer {
+
+using std::byte;
+
+Status SpscPrefixedEntryRingBuffer::SetBuffer(std::span<byte> buffer) {
+  if (buffer.data() == nullptr || buffer.size_bytes() < 2) {
+    return Status::InvalidArgument();
+  }
+
+  buffer_ = buffer.data();
+  buffer_bytes_ = buffer.size_bytes();
+  write_idx_.store(0, std::memory_order_relaxed);
+  read_idx_.store(0, std::memory_order_relaxed);
+  return OkStatus();
+}
+
+Status SpscPrefixedEntryRingBuffer::TryPushBack(std::span<const byte> data,
+                                                byte user_preamble_data) {
+  if (buffer_ == nullptr) {
+    return Status::FailedPrecondition();
+  }
+  if (data.size_bytes() == 0) {
+    return Status::InvalidArgument();
+  }
+
+  byte varint_buf[kMaxEntryPreambleBytes];
+  size_t varint_bytes = varint::Encode<size_t>(data.size_bytes(), varint_buf);
+  size_t total_write_bytes =
+      (user_preamble_ ? 1 : 0) + varint_bytes + data.size_bytes();
+  if (buffer_bytes_ - 1 < total_write_bytes) {
+    return Status::OutOfRange();
+  }
+
+  // Acquire the read index so the consumer is done with the bytes it freed.
+  const size_t write_idx = write_idx_.load(std::memory_order_relaxed);
+  const size_t read_idx = read_idx_.load(std::memory_order_acquire);
+  const size_t used_bytes = write_idx >= read_idx
+                                ? write_idx - read_idx
+                                : buffer_bytes_ - (read_idx - write_idx);
+  if (buffer_bytes_ - 1 - used_bytes < total_write_bytes) {
+    return Status::ResourceExhausted();
+  }
+
+  size_t idx = write_idx;
+  if (user_preamble_) {
+    RawWrite(idx, std::span(&user_preamble_data, 1));
+    idx = IncrementIndex(idx, 1);
+  }
+  RawWrite(idx, std::span(varint_buf, varint_bytes));
+  idx = IncrementIndex(idx, varint_bytes);
+  RawWrite(idx, data);
+
+  // Publish the entry once all of its bytes are written.
+  write_idx_.store(IncrementIndex(idx, data.size_bytes()),
+                   std::memory_order_release);
+  return OkStatus();
+}
+
+Status SpscPrefixedEntryRingBuffer::InternalPeekFront(std::span<byte> data,
+                                                      size_t* bytes_read,
+                                                      bool get_preamble) {
+  *bytes_read = 0;
+  if (buffer_ == nullptr) {
+    return Status::FailedPrecondition();
+  }
+
+  // Acquire the write index so the producer's entry bytes are visible.
+  const size_t read_idx = read_idx_.load(std::memory_order_relaxed);
+  if (read_idx == write_idx_.load(std::memory_order_acquire)) {
+    return Status::OutOfRange();
+  }
+
+  EntryInfo info = EntryInfoAt(read_idx);
+  size_t entry_bytes = info.data_bytes;
+  size_t source_idx = read_idx;
+  if (get_preamble) {
+    entry_bytes += info.preamble_bytes;
+  } else {
+    source_idx = IncrementIndex(source_idx, info.preamble_bytes);
+  }
+
+  *bytes_read = std::min(entry_bytes, data.size_bytes());
+  RawRead(data.data(), source_idx, *bytes_read);
+  return *bytes_read == entry_bytes ? OkStatus() : Status::ResourceExhausted();
+}
+
+Status SpscPrefixedEntryRingBuffer::PopFront() {
+  if (buffer_ == nullptr) {
+    return Status::FailedPrecondition();
+  }
+
+  const size_t read_idx = read_idx_.load(std::memory_order_relaxed);
+  if (read_idx == write_idx_.load(std::memory_order_acquire)) {
+    return Status::OutOfRange();
+  }
+
+  // Release the entry's bytes to the producer once they are no longer read.
+  EntryInfo info = EntryInfoAt(read_idx);
+  read_idx_.store(
+      IncrementIndex(read_idx, info.preamble_bytes + info.data_bytes),
+      std::memory_order_release);
+  return OkStatus();
+}
+
+size_t SpscPrefixedEntryRingBuffer::FrontEntryDataSizeBytes() {
+  if (buffer_ == nullptr) {
+    return 0;
+  }
+  const size_t read_idx = read_idx_.load(std::memory_order_relaxed);
+  if (read_idx == write_idx_.load(std::memory_order_acquire)) {
+    return 0;
+  }
+  return EntryInfoAt(read_idx).data_bytes;
+}
+
+size_t SpscPrefixedEntryRingBuffer::TotalUsedBytes() const {
+  const size_t read_idx = read_idx_.load(std::memory_order_acquire);
+  const size_t write_idx = write_idx_.load(std::memory_order_acquire);
+  return write_idx >= read_idx ? write_idx - read_idx
+                               : buffer_bytes_ - (read_idx - write_idx);
+}
+
+SpscPrefixedEntryRingBuffer::EntryInfo SpscPrefixedEntryRingBuffer::EntryInfoAt(
+    size_t read_idx) const {
+  // Read the varint one byte at a time up to its last byte, so no bytes past
+  // the entry, which the producer may be writing, are read.
+  byte varint_buf[kMaxEntryPreambleBytes];
+  size_t idx = IncrementIndex(read_idx, user_preamble_ ? 1 : 0);
+  size_t varint_bytes = 0;
+  do {
+    varint_buf[varint_bytes++] = buffer_[idx];
+    idx = IncrementIndex(idx, 1);
+  } while ((varint_buf[varint_bytes - 1] & byte(0x80)) != byte(0) &&
+           varint_bytes < kMaxEntryPreambleBytes);
+  uint64_t entry_size = 0;
+  size_t varint_size =
+      varint::Decode(std::span(varint_buf, varint_bytes), &entry_size);
+
+  EntryInfo info = {};
+  info.preamble_bytes = (user_preamble_ ? 1 : 0) + varint_size;
+  info.data_bytes = entry_size;
+  return info;
+}
+
+void SpscPrefixedEntryRingBuffer::RawWrite(size_t write_idx,
+                                           std::span<const byte> source) {
+  size_t bytes_until_wrap = buffer_bytes_ - write_idx;
+  size_t bytes_to_copy = std::min(source.size(), bytes_until_wrap);
+  std::memcpy(buffer_ + write_idx, source.data(), bytes_to_copy);
+  if (bytes_to_copy < source.size()) {
+    std::memcpy(buffer_,
+                source.data() + bytes_to_copy,
+                source.size() - bytes_to_copy);
+  }
+}
+
+void SpscPrefixedEntryRingBuffer::RawRead(byte* destination,
+                                          size_t source_idx,
+                                          size_t length) const {
+  size_t bytes_until_wrap = buffer_bytes_ - source_idx;
+  size_t bytes_to_copy = std::min(length, bytes_until_wrap);
+  std::memcpy(destination, buffer_ + source_idx, bytes_to_copy);
+  if (bytes_to_copy < length) {
+    std::memcpy(destination + bytes_to_copy, buffer_, length - bytes_to_copy);
+  }
+}
+
+}  // namespace ring_buffer
+}  // namespace pw
@@ -0,0 +1,132 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_ring_buffer/spsc_prefixed_entry_ring_buffer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "pw_unit_test/framework.h"
+
+using std::byte;
+
+namespace pw {
+namespace ring_buffer {
+namespace {
+
+TEST(SpscPrefixedEntryRingBuffer, NoBuffer) {
+  SpscPrefixedEntryRingBuffer ring;
+
+  byte buf[32];
+  size_t count;
+
+  EXPECT_EQ(ring.SetBuffer(std::span<byte>(nullptr, 10u)),
+            Status::InvalidArgument());
+  EXPECT_EQ(ring.SetBuffer(std::span(buf, 1u)), Status::InvalidArgument());
+  EXPECT_EQ(ring.FrontEntryDataSizeBytes(), 0u);
+  EXPECT_EQ(ring.TryPushBack(buf), Status::FailedPrecondition());
+  EXPECT_EQ(ring.PeekFront(buf, &count), Status::FailedPrecondition());
+  EXPECT_EQ(count, 0u);
+  EXPECT_EQ(ring.PopFront(), Status::FailedPrecondition());
+}
+
+TEST(SpscPrefixedEntryRingBuffer, PushAndPop) {
+  SpscPrefixedEntryRingBuffer ring(true);
+  byte buffer[16];
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  byte output[8];
+  size_t count;
+  EXPECT_EQ(ring.PeekFront(output, &count), Status::OutOfRange());
+  EXPECT_EQ(ring.PopFront(), Status::OutOfRange());
+  EXPECT_EQ(ring.TryPushBack(std::span<const byte>()),
+            Status::InvalidArgument());
+
+  const byte entry[] = {byte(1), byte(2), byte(3)};
+  ASSERT_EQ(ring.TryPushBack(entry, byte(0x42)), OkStatus());
+  EXPECT_EQ(ring.TotalUsedBytes(), 5u);
+  EXPECT_EQ(ring.FrontEntryDataSizeBytes(), 3u);
+
+  ASSERT_EQ(ring.PeekFront(output, &count), OkStatus());
+  ASSERT_EQ(count, 3u);
+  EXPECT_EQ(std::memcmp(output, entry, sizeof(entry)), 0);
+
+  ASSERT_EQ(ring.PeekFrontWithPreamble(output, &count), OkStatus());
+  ASSERT_EQ(count, 5u);
+  EXPECT_EQ(output[0], byte(0x42));
+  EXPECT_EQ(output[1], byte(3));
+
+  EXPECT_EQ(ring.PeekFront(std::span(output, 2), &count),
+            Status::ResourceExhausted());
+  EXPECT_EQ(count, 2u);
+
+  EXPECT_EQ(ring.PopFront(), OkStatus());
+  EXPECT_EQ(ring.TotalUsedBytes(), 0u);
+  EXPECT_EQ(ring.FrontEntryDataSizeBytes(), 0u);
+}
+
+TEST(SpscPrefixedEntryRingBuffer, FullBufferIsNotOverwritten) {
+  SpscPrefixedEntryRingBuffer ring;
+  byte buffer[10];
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  // One byte is kept free, so at most 9 bytes of entries fit.
+  const byte entry[4] = {};
+  EXPECT_EQ(ring.TryPushBack(std::span(buffer, 9)), Status::OutOfRange());
+  ASSERT_EQ(ring.TryPushBack(entry), OkStatus());
+  EXPECT_EQ(ring.TryPushBack(entry), Status::ResourceExhausted());
+  ASSERT_EQ(ring.TryPushBack(std::span(entry, 3)), OkStatus());
+  EXPECT_EQ(ring.TotalUsedBytes(), 9u);
+  EXPECT_EQ(ring.TryPushBack(std::span(entry, 1)),
+            Status::ResourceExhausted());
+
+  EXPECT_EQ(ring.FrontEntryDataSizeBytes(), 4u);
+  ASSERT_EQ(ring.PopFront(), OkStatus());
+  EXPECT_EQ(ring.FrontEntryDataSizeBytes(), 3u);
+}
+
+TEST(SpscPrefixedEntryRingBuffer, EntriesWrapAround) {
+  SpscPrefixedEntryRingBuffer ring(true);
+  byte buffer[13];
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  // Entries of 6 bytes against a 13 byte buffer start at every offset, so the
+  // preamble, size and data each wrap around the end of the buffer.
+  byte output[4];
+  size_t count;
+  for (uint8_t i = 0; i < 100; ++i) {
+    const byte entry[] = {byte(i), byte(i + 1), byte(i + 2), byte(i + 3)};
+    ASSERT_EQ(ring.TryPushBack(entry, byte(i)), OkStatus());
+    if (i % 2 == 0) {
+      continue;
+    }
+
+    // Pop the entry before this one, then check this one is at the front.
+    ASSERT_EQ(ring.PopFront(), OkStatus());
+    ASSERT_EQ(ring.PeekFrontWithPreamble(output, &count),
+              Status::ResourceExhausted());
+    EXPECT_EQ(output[0], byte(i));
+    EXPECT_EQ(output[1], byte(4));
+    ASSERT_EQ(ring.PeekFront(output, &count), OkStatus());
+    ASSERT_EQ(count, 4u);
+    EXPECT_EQ(std::memcmp(output, entry, sizeof(entry)), 0);
+    ASSERT_EQ(ring.PopFront(), OkStatus());
+    ASSERT_EQ(ring.TotalUsedBytes(), 0u);
+  }
+}
+
+}  // namespace
+}  // namespace ring_buffer
+}  // namespace pw
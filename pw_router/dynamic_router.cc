@@ -0,0 +1,185 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_router/dynamic_router.h"
+
+#include <algorithm>
+#include <mutex>
+#include <optional>
+
+#include "pw_log/log.h"
+
+namespace pw::router {
+namespace {
+
+constexpr bool AddressLess(const DynamicRouter::Route& route,
+                           uint32_t address) {
+  return route.address < address;
+}
+
+}  // namespace
+
+DynamicRouter::DynamicRouter(PacketParser& parser,
+                             std::span<Route> first_table,
+                             std::span<Route> second_table)
+    : parser_(parser),
+      max_routes_(std::min(first_table.size(), second_table.size())),
+      tables_{{Table{first_table.data()}, Table{second_table.data()}}} {}
+
+Status DynamicRouter::RoutePacket(ConstByteSpan packet) {
+  uint32_t address;
+
+  {
+    // Only packet parsing is synchronized within the router; egresses must be
+    // synchronized externally.
+    std::lock_guard lock(parser_mutex_);
+
+    if (!parser_.Parse(packet)) {
+      PW_LOG_ERROR("DynamicRouter failed to parse packet; dropping");
+      parser_errors_.Increment();
+      return Status::DataLoss();
+    }
+
+    std::optional<uint32_t> result = parser_.GetDestinationAddress();
+    if (!result.has_value()) {
+      PW_LOG_ERROR("DynamicRouter packet does not have address; dropping");
+      parser_errors_.Increment();
+      return Status::DataLoss();
+    }
+
+    address = result.value();
+  }
+
+  Egress* egress = FindEgress(address);
+  if (egress == nullptr) {
+    PW_LOG_ERROR("DynamicRouter no route for address %u; dropping packet",
+                 static_cast<unsigned>(address));
+    route_errors_.Increment();
+    return Status::NotFound();
+  }
+
+  PW_LOG_DEBUG("DynamicRouter routing %u-byte packet to address %u",
+               static_cast<unsigned>(packet.size()),
+               static_cast<unsigned>(address));
+
+  if (Status status = egress->SendPacket(packet); !status.ok()) {
+    PW_LOG_ERROR("DynamicRouter egress error for address %u: %s",
+                 static_cast<unsigned>(address),
+                 status.str());
+    egress_errors_.Increment();
+    return Status::Unavailable();
+  }
+
+  return OkStatus();
+}
+
+Status DynamicRouter::AddRoute(uint32_t address, Egress& egress) {
+  std::lock_guard lock(update_mutex_);
+
+  const std::span<const Route> current =
+      tables_[active_.load()].active_routes();
+  const auto position =
+      std::lower_bound(current.begin(), current.end(), address, AddressLess);
+  const bool replace =
+      position != current.end() && position->address == address;
+
+  if (!replace && current.size() == max_routes_) {
+    return Status::ResourceExhausted();
+  }
+
+  Table* next = InactiveTable();
+  if (next == nullptr) {
+    return Status::Unavailable();
+  }
+
+  // Copy the routes before the new one, the new route, and the routes after.
+  Route* end = std::copy(current.begin(), position, next->routes);
+  *end++ = {address, &egress};
+  end = std::copy(replace ? position + 1 : position, current.end(), end);
+  next->size = static_cast<size_t>(end - next->routes);
+
+  Publish(*next);
+  return OkStatus();
+}
+
+Status DynamicRouter::RemoveRoute(uint32_t address) {
+  std::lock_guard lock(update_mutex_);
+
+  const std::span<const Route> current =
+      tables_[active_.load()].active_routes();
+  const auto position =
+      std::lower_bound(current.begin(), current.end(), address, AddressLess);
+
+  if (position == current.end() || position->address != address) {
+    return Status::NotFound();
+  }
+
+  Table* next = InactiveTable();
+  if (next == nullptr) {
+    return Status::Unavailable();
+  }
+
+  Route* end = std::copy(current.begin(), position, next->routes);
+  end = std::copy(position + 1, current.end(), end);
+  next->size = static_cast<size_t>(end - next->routes);
+
+  Publish(*next);
+  return OkStatus();
+}
+
+size_t DynamicRouter::route_count() const {
+  const TableReader reader(*this);
+  return reader.table().size;
+}
+
+DynamicRouter::TableReader::TableReader(const DynamicRouter& router) {
+  // Register as a reader of the active table. If an update made another table
+  // active in the meantime, the table may be about to be overwritten, so try
+  // again with the new active table.
+  while (true) {
+    const uint32_t index = router.active_.load();
+    table_ = &router.tables_[index];
+    table_->readers.fetch_add(1);
+    if (router.active_.load() == index) {
+      return;
+    }
+    table_->readers.fetch_sub(1);
+  }
+}
+
+Egress* DynamicRouter::FindEgress(uint32_t address) const {
+  const TableReader reader(*this);
+
+  const std::span<const Route> routes = reader.table().active_routes();
+  const auto route =
+      std::lower_bound(routes.begin(), routes.end(), address, AddressLess);
+  return route != routes.end() && route->address == address ? route->egress
+                                                            : nullptr;
+}
+
+DynamicRouter::Table* DynamicRouter::InactiveTable() {
+  Table& table = tables_[active_.load() ^ 1];
+  if (table.readers.load() != 0) {
+    PW_LOG_WARN("DynamicRouter lookup in progress; route update not applied");
+    return nullptr;
+  }
+  return &table;
+}
+
+void DynamicRouter::Publish(Table& table) {
+  active_.store(static_cast<uint32_t>(&table - tables_.data()));
+  route_updates_.Increment();
+}
+
+}  // namespace pw::router
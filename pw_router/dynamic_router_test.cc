@@ -0,0 +1,182 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_router/dynamic_router.h"
+
+#include <optional>
+
+#include "gtest/gtest.h"
+
+namespace pw::router {
+namespace {
+
+// Routes packets to the address in their first byte.
+class FirstByteParser : public PacketParser {
+ public:
+  bool Parse(ConstByteSpan packet) override {
+    address_ = packet.empty() ? std::nullopt
+                              : std::optional<uint32_t>(uint32_t(packet[0]));
+    return address_.has_value();
+  }
+
+  std::optional<uint32_t> GetDestinationAddress() const override {
+    return address_;
+  }
+
+ private:
+  std::optional<uint32_t> address_;
+};
+
+class CountingEgress : public Egress {
+ public:
+  Status SendPacket(ConstByteSpan) override {
+    count += 1;
+    return status;
+  }
+
+  size_t count = 0;
+  Status status;
+};
+
+constexpr std::byte kPacket1[] = {std::byte{1}};
+constexpr std::byte kPacket2[] = {std::byte{2}};
+constexpr std::byte kPacket3[] = {std::byte{3}};
+
+TEST(DynamicRouter, RoutePacket_NoRoutes) {
+  FirstByteParser parser;
+  DynamicRouterBuffer<4> router(parser);
+  EXPECT_EQ(0u, router.route_count());
+  EXPECT_EQ(4u, router.max_routes());
+
+  EXPECT_EQ(Status::NotFound(), router.RoutePacket(kPacket1));
+  EXPECT_EQ(Status::DataLoss(), router.RoutePacket({}));
+  EXPECT_EQ(2u, router.dropped_packets());
+}
+
+TEST(DynamicRouter, AddRoute_RoutesPackets) {
+  FirstByteParser parser;
+  CountingEgress first;
+  CountingEgress second;
+  DynamicRouterBuffer<4> router(parser);
+
+  ASSERT_EQ(OkStatus(), router.AddRoute(2, second));
+  ASSERT_EQ(OkStatus(), router.AddRoute(1, first));
+  EXPECT_EQ(2u, router.route_count());
+
+  EXPECT_EQ(OkStatus(), router.RoutePacket(kPacket1));
+  EXPECT_EQ(OkStatus(), router.RoutePacket(kPacket2));
+  EXPECT_EQ(OkStatus(), router.RoutePacket(kPacket2));
+  EXPECT_EQ(Status::NotFound(), router.RoutePacket(kPacket3));
+  EXPECT_EQ(1u, first.count);
+  EXPECT_EQ(2u, second.count);
+}
+
+TEST(DynamicRouter, AddRoute_ReplacesExistingRoute) {
+  FirstByteParser parser;
+  CountingEgress first;
+  CountingEgress second;
+  DynamicRouterBuffer<1> router(parser);
+
+  ASSERT_EQ(OkStatus(), router.AddRoute(1, first));
+  ASSERT_EQ(OkStatus(), router.AddRoute(1, second));
+  EXPECT_EQ(1u, router.route_count());
+
+  EXPECT_EQ(OkStatus(), router.RoutePacket(kPacket1));
+  EXPECT_EQ(0u, first.count);
+  EXPECT_EQ(1u, second.count);
+}
+
+TEST(DynamicRouter, AddRoute_TableFull) {
+  FirstByteParser parser;
+  CountingEgress egress;
+  DynamicRouterBuffer<2> router(parser);
+
+  ASSERT_EQ(OkStatus(), router.AddRoute(1, egress));
+  ASSERT_EQ(OkStatus(), router.AddRoute(3, egress));
+  EXPECT_EQ(Status::ResourceExhausted(), router.AddRoute(2, egress));
+  EXPECT_EQ(Status::NotFound(), router.RoutePacket(kPacket2));
+  EXPECT_EQ(OkStatus(), router.RoutePacket(kPacket3));
+}
+
+TEST(DynamicRouter, RemoveRoute) {
+  FirstByteParser parser;
+  CountingEgress egress;
+  DynamicRouterBuffer<4> router(parser);
+
+  ASSERT_EQ(OkStatus(), router.AddRoute(1, egress));
+  ASSERT_EQ(OkStatus(), router.AddRoute(2, egress));
+  ASSERT_EQ(OkStatus(), router.AddRoute(3, egress));
+  ASSERT_EQ(OkStatus(), router.RemoveRoute(2));
+  EXPECT_EQ(Status::NotFound(), router.RemoveRoute(2));
+  EXPECT_EQ(2u, router.route_count());
+
+  EXPECT_EQ(OkStatus(), router.RoutePacket(kPacket1));
+  EXPECT_EQ(Status::NotFound(), router.RoutePacket(kPacket2));
+  EXPECT_EQ(OkStatus(), router.RoutePacket(kPacket3));
+  EXPECT_EQ(2u, egress.count);
+}
+
+TEST(DynamicRouter, RoutePacket_CountsEgressErrors) {
+  FirstByteParser parser;
+  CountingEgress egress;
+  egress.status = Status::ResourceExhausted();
+  DynamicRouterBuffer<4> router(parser);
+
+  ASSERT_EQ(OkStatus(), router.AddRoute(1, egress));
+  EXPECT_EQ(Status::Unavailable(), router.RoutePacket(kPacket1));
+  EXPECT_EQ(1u, router.dropped_packets());
+}
+
+// Removes its own route when it sends a packet.
+class OneShotEgress : public Egress {
+ public:
+  OneShotEgress(DynamicRouter& router) : router_(router) {}
+
+  Status SendPacket(ConstByteSpan packet) override {
+    return router_.RemoveRoute(uint32_t(packet[0]));
+  }
+
+ private:
+  DynamicRouter& router_;
+};
+
+TEST(DynamicRouter, EgressCanUpdateRoutes) {
+  FirstByteParser parser;
+  DynamicRouterBuffer<4> router(parser);
+  OneShotEgress egress(router);
+
+  ASSERT_EQ(OkStatus(), router.AddRoute(1, egress));
+  EXPECT_EQ(OkStatus(), router.RoutePacket(kPacket1));
+  EXPECT_EQ(Status::NotFound(), router.RoutePacket(kPacket1));
+  EXPECT_EQ(0u, router.route_count());
+}
+
+TEST(DynamicRouter, RouteCount_DoesNotBlockUpdates) {
+  FirstByteParser parser;
+  CountingEgress egress;
+  DynamicRouterBuffer<4> router(parser);
+
+  // route_count() registers as a reader of the active table, so it must stop
+  // reading before an update needs the table.
+  for (uint32_t address = 1; address <= 4u; ++address) {
+    EXPECT_EQ(address - 1, router.route_count());
+    ASSERT_EQ(OkStatus(), router.AddRoute(address, egress));
+  }
+  EXPECT_EQ(4u, router.route_count());
+  EXPECT_EQ(OkStatus(), router.RemoveRoute(2));
+  EXPECT_EQ(3u, router.route_count());
+}
+
+}  // namespace
+}  // namespace pw::router
@@ -0,0 +1,168 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_bytes/span.h"
+#include "pw_metric/metric.h"
+#include "pw_router/egress.h"
+#include "pw_router/packet_parser.h"
+#include "pw_status/status.h"
+#include "pw_sync/mutex.h"
+
+namespace pw::router {
+
+// A packet router whose routes can change while it routes packets.
+//
+// The routes are kept in two tables, sorted by address. Route lookups read the
+// active table without taking a lock. Route updates copy the active table into
+// the inactive one, change the copy, and then atomically make it the active
+// table, so a lookup sees either the routes before an update or after it.
+//
+// An update overwrites the table that was active before the previous update.
+// If a lookup that started before the previous update is still reading that
+// table, the update fails with UNAVAILABLE rather than wait, and may be
+// retried. Lookups are short, since the router does not hold a table while an
+// egress sends a packet, so this is rare.
+//
+// Thread-safety:
+//   Route lookups are lock-free. Calls to the provided PacketParser, and route
+//   updates, are each synchronized with a mutex. Synchronization at the egress
+//   level must be implemented by derived egresses. A packet may be sent
+//   through an egress shortly after its route is removed, so egresses must
+//   outlive the router.
+//
+class DynamicRouter {
+ public:
+  struct Route {
+    uint32_t address;
+    Egress* egress;
+  };
+
+  // Stores up to the smaller of the two tables' sizes routes. The tables are
+  // used only by the router.
+  DynamicRouter(PacketParser& parser,
+                std::span<Route> first_table,
+                std::span<Route> second_table);
+
+  DynamicRouter(const DynamicRouter&) = delete;
+  DynamicRouter(DynamicRouter&&) = delete;
+  DynamicRouter& operator=(const DynamicRouter&) = delete;
+  DynamicRouter& operator=(DynamicRouter&&) = delete;
+
+  uint32_t dropped_packets() const {
+    return parser_errors_.value() + route_errors_.value() +
+           egress_errors_.value();
+  }
+
+  const metric::Group& metrics() { return metrics_; }
+
+  // Routes a single packet through the appropriate egress. Returns the same
+  // errors as StaticRouter::RoutePacket().
+  Status RoutePacket(ConstByteSpan packet);
+
+  // Routes packets for the address through the egress, replacing the address's
+  // existing route, if any. Returns one of the following:
+  //
+  //   OK - The route was added.
+  //   RESOURCE_EXHAUSTED - The routing table is full.
+  //   UNAVAILABLE - A lookup is still reading the inactive table.
+  //
+  Status AddRoute(uint32_t address, Egress& egress);
+
+  // Removes the route for the address. Returns one of the following:
+  //
+  //   OK - The route was removed.
+  //   NOT_FOUND - There is no route for the address.
+  //   UNAVAILABLE - A lookup is still reading the inactive table.
+  //
+  Status RemoveRoute(uint32_t address);
+
+  // The number of routes. Like a lookup, this reads the active table as a
+  // registered reader, so a concurrent update cannot overwrite it.
+  size_t route_count() const;
+
+  // The maximum number of routes.
+  size_t max_routes() const { return max_routes_; }
+
+ private:
+  struct Table {
+    Route* routes;
+    size_t size = 0;
+
+    // The number of lookups reading the table.
+    mutable std::atomic<uint32_t> readers = 0;
+
+    std::span<const Route> active_routes() const {
+      return std::span(routes, size);
+    }
+  };
+
+  // Registers as a reader of the active table while in scope, so that route
+  // updates do not overwrite the table while it is read.
+  class TableReader {
+   public:
+    explicit TableReader(const DynamicRouter& router);
+    ~TableReader() { table_->readers.fetch_sub(1); }
+
+    TableReader(const TableReader&) = delete;
+    TableReader& operator=(const TableReader&) = delete;
+
+    const Table& table() const { return *table_; }
+
+   private:
+    const Table* table_;
+  };
+
+  // Returns the egress for the address, or nullptr if there is no route.
+  Egress* FindEgress(uint32_t address) const;
+
+  // Returns the inactive table if no lookup is reading it. The update mutex
+  // must be held.
+  Table* InactiveTable();
+
+  // Makes the table active. The update mutex must be held.
+  void Publish(Table& table);
+
+  PacketParser& parser_;
+  const size_t max_routes_;
+  std::array<Table, 2> tables_;
+  std::atomic<uint32_t> active_ = 0;
+  sync::Mutex parser_mutex_;
+  sync::Mutex update_mutex_;
+  PW_METRIC_GROUP(metrics_, "dynamic_router");
+  PW_METRIC(metrics_, parser_errors_, "parser_errors", 0u);
+  PW_METRIC(metrics_, route_errors_, "route_errors", 0u);
+  PW_METRIC(metrics_, egress_errors_, "egress_errors", 0u);
+  PW_METRIC(metrics_, route_updates_, "route_updates", 0u);
+};
+
+// A DynamicRouter with internal tables for up to kMaxRoutes routes.
+template <size_t kMaxRoutes>
+class DynamicRouterBuffer final : public DynamicRouter {
+ public:
+  DynamicRouterBuffer(PacketParser& parser)
+      : DynamicRouter(parser, first_table_, second_table_) {}
+
+ private:
+  std::array<Route, kMaxRoutes> first_table_;
+  std::array<Route, kMaxRoutes> second_table_;
+};
+
+}  // namespace pw::router
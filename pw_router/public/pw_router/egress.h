@@ -13,10 +13,12 @@
 // the License.
 #pragma once
 
+#include <cstddef>
 #include <span>
 
 #include "pw_bytes/span.h"
 #include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
 
 namespace pw::router {
 
@@ -30,6 +32,26 @@ class Egress {
   //
   // TODO(frolv): Document possible return values.
   virtual Status SendPacket(ConstByteSpan packet) = 0;
+
+  // Sends several complete packets, in order. Returns the number of packets
+  // sent, with OK if all of them were sent, or otherwise the error for the
+  // first packet that was not sent.
+  //
+  // The default calls SendPacket() for each packet. Egresses that can send
+  // several packets at once, such as with a single vectored write, override
+  // this.
+  virtual StatusWithSize SendPackets(std::span<const ConstByteSpan> packets) {
+    Status status;
+    size_t sent = 0;
+    for (ConstByteSpan packet : packets) {
+      if (Status result = SendPacket(packet); !result.ok()) {
+        status = status.ok() ? result : status;
+      } else {
+        sent += 1;
+      }
+    }
+    return StatusWithSize(status, sent);
+  }
 };
 
 }  // namespace pw::router
@@ -0,0 +1,140 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <limits>
+
+#include "pw_bytes/span.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_metric/histogram.h"
+#include "pw_metric/metric.h"
+#include "pw_router/egress.h"
+#include "pw_status/status.h"
+#include "pw_sync/mutex.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::router {
+
+// An egress that queues packets in a bounded buffer and sends them through
+// another egress later, when ForwardPackets() is called. Placing a QueuedEgress
+// in front of a slow egress, such as a UART, lets a router hand off packets
+// without waiting for the transport, so one slow destination does not delay
+// packets for the others.
+//
+// Packets are copied into fixed-size slots. When the queue is full, or a packet
+// is larger than a slot, SendPacket() drops it and returns RESOURCE_EXHAUSTED.
+//
+// ForwardPackets() may be called from a forwarding thread or a poll loop, but
+// from only one thread at a time. The queued packet is not locked while it is
+// sent, so SendPacket() never waits for the egress.
+//
+// Metrics:
+//   queued_packets - Packets accepted into the queue.
+//   dropped_packets - Packets dropped because the queue was full or the packet
+//                     was too large.
+//   egress_errors - Queued packets that the egress did not accept.
+//   latency_us - The count, sum, minimum, and maximum time in microseconds
+//                that packets waited in the queue.
+//
+class QueuedEgress : public Egress {
+ public:
+  // The number of bytes of buffer needed per queued packet.
+  static constexpr size_t SlotSizeBytes(size_t max_packet_size_bytes) {
+    return sizeof(PacketHeader) + max_packet_size_bytes;
+  }
+
+  // Queues packets in the buffer, which holds
+  // buffer.size() / SlotSizeBytes(max_packet_size_bytes) packets.
+  QueuedEgress(Egress& egress,
+               ByteSpan buffer,
+               size_t max_packet_size_bytes,
+               chrono::VirtualSystemClock& clock =
+                   chrono::VirtualSystemClock::RealClock());
+
+  QueuedEgress(const QueuedEgress&) = delete;
+  QueuedEgress& operator=(const QueuedEgress&) = delete;
+
+  // Copies the packet into the queue. Returns RESOURCE_EXHAUSTED if the packet
+  // was dropped.
+  Status SendPacket(ConstByteSpan packet) override;
+
+  // Sends up to max_packets queued packets through the egress, oldest first.
+  // Returns the number of packets removed from the queue, including any that
+  // the egress did not accept.
+  size_t ForwardPackets(
+      size_t max_packets = std::numeric_limits<size_t>::max());
+
+  // The number of queued packets.
+  size_t size() const;
+
+  // The maximum number of queued packets.
+  size_t capacity() const { return slot_count_; }
+
+  size_t max_packet_size_bytes() const { return max_packet_size_bytes_; }
+
+  metric::Group& metrics() { return metrics_; }
+  const metric::Group& metrics() const { return metrics_; }
+
+  uint32_t dropped_packets() const { return dropped_packets_.value(); }
+  uint32_t egress_errors() const { return egress_errors_.value(); }
+  const metric::Summary& latency_us() const { return latency_us_; }
+
+ private:
+  struct PacketHeader {
+    size_t size_bytes;
+    chrono::SystemClock::time_point queued_at;
+  };
+
+  static constexpr metric::Token kLatencyUsName =
+      PW_TOKENIZE_STRING_DOMAIN("metrics", "latency_us");
+
+  std::byte* Slot(size_t index) const {
+    return buffer_.data() + index * SlotSizeBytes(max_packet_size_bytes_);
+  }
+
+  Egress& egress_;
+  ByteSpan buffer_;
+  size_t max_packet_size_bytes_;
+  size_t slot_count_;
+  chrono::VirtualSystemClock& clock_;
+
+  mutable sync::Mutex mutex_;
+  size_t head_ = 0;
+  size_t count_ = 0;
+
+  PW_METRIC_GROUP(metrics_, "queued_egress");
+  PW_METRIC(metrics_, queued_packets_, "queued_packets", 0u);
+  PW_METRIC(metrics_, dropped_packets_, "dropped_packets", 0u);
+  PW_METRIC(metrics_, egress_errors_, "egress_errors", 0u);
+  metric::Summary latency_us_{kLatencyUsName, metrics_.children()};
+};
+
+// A QueuedEgress with an internal buffer for kMaxPackets packets of up to
+// kMaxPacketSizeBytes bytes.
+template <size_t kMaxPackets, size_t kMaxPacketSizeBytes>
+class QueuedEgressBuffer final : public QueuedEgress {
+ public:
+  QueuedEgressBuffer(Egress& egress,
+                     chrono::VirtualSystemClock& clock =
+                         chrono::VirtualSystemClock::RealClock())
+      : QueuedEgress(egress, buffer_, kMaxPacketSizeBytes, clock) {}
+
+ private:
+  std::array<std::byte, kMaxPackets * SlotSizeBytes(kMaxPacketSizeBytes)>
+      buffer_;
+};
+
+}  // namespace pw::router
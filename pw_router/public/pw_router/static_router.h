@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <span>
 
 #include "pw_bytes/span.h"
@@ -20,12 +22,17 @@
 #include "pw_router/egress.h"
 #include "pw_router/packet_parser.h"
 #include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
 #include "pw_sync/mutex.h"
 
 namespace pw::router {
 
 // A packet router with a static routing table.
 //
+// If the routes are sorted by ascending address, routes are found with a binary
+// search instead of a linear scan. Routing is otherwise the same: a packet is
+// sent to the first route for its address.
+//
 // Thread-safety:
 //   Internal packet parsing and calls to the provided PacketParser are
 //   synchronized. Synchronization at the egress level must be implemented by
@@ -40,7 +47,21 @@ class StaticRouter {
   };
 
   StaticRouter(PacketParser& parser, std::span<const Route> routes)
-      : parser_(parser), routes_(routes) {}
+      : parser_(parser),
+        routes_(routes),
+        routes_sorted_(RoutesAreSorted(routes)) {}
+
+  // Returns true if the routes are in ascending address order, which allows
+  // StaticRouter to use a binary search. Large constexpr route tables can check
+  // this with a static_assert.
+  static constexpr bool RoutesAreSorted(std::span<const Route> routes) {
+    for (size_t i = 1; i < routes.size(); ++i) {
+      if (routes[i].address < routes[i - 1].address) {
+        return false;
+      }
+    }
+    return true;
+  }
 
   StaticRouter(const StaticRouter&) = delete;
   StaticRouter(StaticRouter&&) = delete;
@@ -64,9 +85,31 @@ class StaticRouter {
   //
   Status RoutePacket(ConstByteSpan packet);
 
+  // Routes several packets, such as frames received together, and sends each
+  // egress its packets with one SendPackets() call. Packets are parsed and
+  // grouped kMaxBatchPackets at a time; within a group, each egress receives
+  // its packets in their original order.
+  //
+  // Returns the number of packets sent, with OK if all of them were sent, or
+  // otherwise the RoutePacket() error for the first dropped packet found.
+  StatusWithSize RoutePackets(std::span<const ConstByteSpan> packets);
+
+  // The number of packets RoutePackets() parses and groups at a time.
+  static constexpr size_t kMaxBatchPackets = 16;
+
  private:
+  // Parses the packet and gets its address. The mutex must be held.
+  Status ParseAddress(ConstByteSpan packet, uint32_t& address);
+
+  // Returns the egress for the address, or nullptr if there is no route.
+  Egress* FindEgress(uint32_t address);
+
+  // Returns the first route for the address, or nullptr if there is none.
+  const Route* FindRoute(uint32_t address) const;
+
   PacketParser& parser_;
   std::span<const Route> routes_;
+  bool routes_sorted_;
   sync::Mutex mutex_;
   PW_METRIC_GROUP(metrics_, "static_router");
   PW_METRIC(metrics_, parser_errors_, "parser_errors", 0u);
@@ -0,0 +1,100 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_router/queued_egress.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <mutex>
+
+namespace pw::router {
+
+QueuedEgress::QueuedEgress(Egress& egress,
+                           ByteSpan buffer,
+                           size_t max_packet_size_bytes,
+                           chrono::VirtualSystemClock& clock)
+    : egress_(egress),
+      buffer_(buffer),
+      max_packet_size_bytes_(max_packet_size_bytes),
+      slot_count_(buffer.size_bytes() / SlotSizeBytes(max_packet_size_bytes)),
+      clock_(clock) {}
+
+Status QueuedEgress::SendPacket(ConstByteSpan packet) {
+  const PacketHeader header = {.size_bytes = packet.size_bytes(),
+                               .queued_at = clock_.now()};
+
+  std::lock_guard lock(mutex_);
+  if (count_ == slot_count_ || packet.size_bytes() > max_packet_size_bytes_) {
+    dropped_packets_.Increment();
+    return Status::ResourceExhausted();
+  }
+
+  // The slot after the last queued packet is never read by ForwardPackets()
+  // until count_ includes it, so it can be filled while ForwardPackets() sends
+  // the packet at head_.
+  std::byte* const slot = Slot((head_ + count_) % slot_count_);
+  std::memcpy(slot, &header, sizeof(header));
+  std::memcpy(slot + sizeof(header), packet.data(), packet.size_bytes());
+  count_ += 1;
+  queued_packets_.Increment();
+  return OkStatus();
+}
+
+size_t QueuedEgress::ForwardPackets(size_t max_packets) {
+  size_t forwarded = 0;
+
+  while (forwarded < max_packets) {
+    std::byte* slot;
+    {
+      std::lock_guard lock(mutex_);
+      if (count_ == 0u) {
+        break;
+      }
+      slot = Slot(head_);
+    }
+
+    PacketHeader header;
+    std::memcpy(&header, slot, sizeof(header));
+
+    const int64_t latency_us =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            clock_.now() - header.queued_at)
+            .count();
+    latency_us_.Record(static_cast<uint32_t>(std::clamp<int64_t>(
+        latency_us, 0, std::numeric_limits<uint32_t>::max())));
+
+    if (!egress_.SendPacket(ConstByteSpan(slot + sizeof(header),
+                                          header.size_bytes))
+             .ok()) {
+      egress_errors_.Increment();
+    }
+
+    std::lock_guard lock(mutex_);
+    head_ = (head_ + 1) % slot_count_;
+    count_ -= 1;
+    forwarded += 1;
+  }
+
+  return forwarded;
+}
+
+size_t QueuedEgress::size() const {
+  std::lock_guard lock(mutex_);
+  return count_;
+}
+
+}  // namespace pw::router
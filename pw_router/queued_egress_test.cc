@@ -0,0 +1,186 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_router/queued_egress.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "gtest/gtest.h"
+#include "pw_router/static_router.h"
+
+namespace pw::router {
+namespace {
+
+class FakeClock : public chrono::VirtualSystemClock {
+ public:
+  chrono::SystemClock::time_point now() override { return now_; }
+
+  void Advance(chrono::SystemClock::duration duration) { now_ += duration; }
+
+ private:
+  chrono::SystemClock::time_point now_;
+};
+
+// Records the first byte of each packet it is sent.
+class RecordingEgress : public Egress {
+ public:
+  Status SendPacket(ConstByteSpan packet) override {
+    first_bytes[count++] = packet.empty() ? std::byte{0} : packet[0];
+    sizes[count - 1] = packet.size();
+    return status;
+  }
+
+  std::array<std::byte, 8> first_bytes = {};
+  std::array<size_t, 8> sizes = {};
+  size_t count = 0;
+  Status status;
+};
+
+constexpr std::byte kPacket1[] = {std::byte{1}, std::byte{0}};
+constexpr std::byte kPacket2[] = {std::byte{2}};
+constexpr std::byte kPacket3[] = {std::byte{3}, std::byte{0}, std::byte{0}};
+
+TEST(QueuedEgress, SendPacket_QueuesUntilForwarded) {
+  RecordingEgress output;
+  QueuedEgressBuffer<4, 8> egress(output);
+  EXPECT_EQ(4u, egress.capacity());
+
+  ASSERT_EQ(OkStatus(), egress.SendPacket(kPacket1));
+  ASSERT_EQ(OkStatus(), egress.SendPacket(kPacket2));
+  EXPECT_EQ(2u, egress.size());
+  EXPECT_EQ(0u, output.count);
+
+  EXPECT_EQ(2u, egress.ForwardPackets());
+  EXPECT_EQ(0u, egress.size());
+  ASSERT_EQ(2u, output.count);
+  EXPECT_EQ(std::byte{1}, output.first_bytes[0]);
+  EXPECT_EQ(2u, output.sizes[0]);
+  EXPECT_EQ(std::byte{2}, output.first_bytes[1]);
+  EXPECT_EQ(1u, output.sizes[1]);
+}
+
+TEST(QueuedEgress, ForwardPackets_LimitsPacketCount) {
+  RecordingEgress output;
+  QueuedEgressBuffer<4, 8> egress(output);
+  ASSERT_EQ(OkStatus(), egress.SendPacket(kPacket1));
+  ASSERT_EQ(OkStatus(), egress.SendPacket(kPacket2));
+  ASSERT_EQ(OkStatus(), egress.SendPacket(kPacket3));
+
+  EXPECT_EQ(1u, egress.ForwardPackets(1));
+  EXPECT_EQ(2u, egress.size());
+  EXPECT_EQ(2u, egress.ForwardPackets(5));
+  EXPECT_EQ(0u, egress.ForwardPackets());
+  ASSERT_EQ(3u, output.count);
+  EXPECT_EQ(std::byte{3}, output.first_bytes[2]);
+}
+
+TEST(QueuedEgress, SendPacket_WrapsAroundBuffer) {
+  RecordingEgress output;
+  QueuedEgressBuffer<2, 8> egress(output);
+
+  for (std::byte value : {std::byte{1}, std::byte{2}, std::byte{3}}) {
+    ASSERT_EQ(OkStatus(), egress.SendPacket(std::span(&value, 1)));
+    EXPECT_EQ(1u, egress.ForwardPackets());
+  }
+  ASSERT_EQ(3u, output.count);
+  EXPECT_EQ(std::byte{3}, output.first_bytes[2]);
+}
+
+TEST(QueuedEgress, SendPacket_DropsWhenFullOrTooLarge) {
+  RecordingEgress output;
+  QueuedEgressBuffer<2, 2> egress(output);
+
+  EXPECT_EQ(Status::ResourceExhausted(), egress.SendPacket(kPacket3));
+  ASSERT_EQ(OkStatus(), egress.SendPacket(kPacket1));
+  ASSERT_EQ(OkStatus(), egress.SendPacket(kPacket2));
+  EXPECT_EQ(Status::ResourceExhausted(), egress.SendPacket(kPacket2));
+  EXPECT_EQ(2u, egress.dropped_packets());
+
+  EXPECT_EQ(2u, egress.ForwardPackets());
+  EXPECT_EQ(2u, output.count);
+}
+
+TEST(QueuedEgress, ForwardPackets_CountsEgressErrors) {
+  RecordingEgress output;
+  output.status = Status::Unavailable();
+  QueuedEgressBuffer<2, 8> egress(output);
+
+  ASSERT_EQ(OkStatus(), egress.SendPacket(kPacket1));
+  EXPECT_EQ(1u, egress.ForwardPackets());
+  EXPECT_EQ(0u, egress.size());
+  EXPECT_EQ(1u, output.count);
+  EXPECT_EQ(1u, egress.egress_errors());
+}
+
+TEST(QueuedEgress, ForwardPackets_RecordsLatency) {
+  FakeClock clock;
+  RecordingEgress output;
+  QueuedEgressBuffer<2, 8> egress(output, clock);
+
+  ASSERT_EQ(OkStatus(), egress.SendPacket(kPacket1));
+  clock.Advance(std::chrono::duration_cast<chrono::SystemClock::duration>(
+      std::chrono::milliseconds(3)));
+  ASSERT_EQ(OkStatus(), egress.SendPacket(kPacket2));
+  clock.Advance(std::chrono::duration_cast<chrono::SystemClock::duration>(
+      std::chrono::milliseconds(1)));
+  EXPECT_EQ(2u, egress.ForwardPackets());
+
+  EXPECT_EQ(2u, egress.latency_us().count());
+  EXPECT_EQ(1000u, egress.latency_us().min());
+  EXPECT_EQ(4000u, egress.latency_us().max());
+}
+
+class FirstByteParser : public PacketParser {
+ public:
+  bool Parse(ConstByteSpan packet) override {
+    address_ = packet.empty() ? std::nullopt
+                              : std::optional<uint32_t>(uint32_t(packet[0]));
+    return address_.has_value();
+  }
+
+  std::optional<uint32_t> GetDestinationAddress() const override {
+    return address_;
+  }
+
+ private:
+  std::optional<uint32_t> address_;
+};
+
+TEST(QueuedEgress, StaticRouter_FullQueueDoesNotBlockOtherRoutes) {
+  RecordingEgress slow_output;
+  RecordingEgress fast_output;
+  QueuedEgressBuffer<1, 8> slow(slow_output);
+  QueuedEgressBuffer<4, 8> fast(fast_output);
+  const StaticRouter::Route routes[] = {{1, slow}, {2, fast}};
+  FirstByteParser parser;
+  StaticRouter router(parser, routes);
+
+  EXPECT_EQ(OkStatus(), router.RoutePacket(kPacket1));
+  EXPECT_EQ(Status::Unavailable(), router.RoutePacket(kPacket1));
+  EXPECT_EQ(OkStatus(), router.RoutePacket(kPacket2));
+  EXPECT_EQ(OkStatus(), router.RoutePacket(kPacket2));
+
+  EXPECT_EQ(2u, fast.ForwardPackets());
+  EXPECT_EQ(1u, slow.ForwardPackets());
+  EXPECT_EQ(1u, slow.dropped_packets());
+  EXPECT_EQ(2u, fast_output.count);
+  EXPECT_EQ(1u, slow_output.count);
+}
+
+}  // namespace
+}  // namespace pw::router
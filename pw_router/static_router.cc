@@ -15,9 +15,11 @@
 #include "pw_router/static_router.h"
 
 #include <algorithm>
+#include <array>
 #include <mutex>
 
 #include "pw_log/log.h"
+#include "pw_status/try.h"
 
 namespace pw::router {
 
@@ -28,30 +30,11 @@ Status StaticRouter::RoutePacket(ConstByteSpan packet) {
     // Only packet parsing is synchronized within the router; egresses must be
     // synchronized externally.
     std::lock_guard lock(mutex_);
-
-    if (!parser_.Parse(packet)) {
-      PW_LOG_ERROR("StaticRouter failed to parse packet; dropping");
-      parser_errors_.Increment();
-      return Status::DataLoss();
-    }
-
-    std::optional<uint32_t> result = parser_.GetDestinationAddress();
-    if (!result.has_value()) {
-      PW_LOG_ERROR("StaticRouter packet does not have address; dropping");
-      parser_errors_.Increment();
-      return Status::DataLoss();
-    }
-
-    address = result.value();
+    PW_TRY(ParseAddress(packet, address));
   }
 
-  auto route = std::find_if(routes_.begin(), routes_.end(), [&](auto r) {
-    return r.address == address;
-  });
-  if (route == routes_.end()) {
-    PW_LOG_ERROR("StaticRouter no route for address %u; dropping packet",
-                 static_cast<unsigned>(address));
-    route_errors_.Increment();
+  Egress* egress = FindEgress(address);
+  if (egress == nullptr) {
     return Status::NotFound();
   }
 
@@ -59,7 +42,7 @@ Status StaticRouter::RoutePacket(ConstByteSpan packet) {
                static_cast<unsigned>(packet.size()),
                static_cast<unsigned>(address));
 
-  if (Status status = route->egress.SendPacket(packet); !status.ok()) {
+  if (Status status = egress->SendPacket(packet); !status.ok()) {
     PW_LOG_ERROR("StaticRouter egress error for address %u: %s",
                  static_cast<unsigned>(address),
                  status.str());
@@ -70,4 +53,120 @@ Status StaticRouter::RoutePacket(ConstByteSpan packet) {
   return OkStatus();
 }
 
+StatusWithSize StaticRouter::RoutePackets(
+    std::span<const ConstByteSpan> packets) {
+  Status status;
+  size_t sent = 0;
+
+  while (!packets.empty()) {
+    const std::span<const ConstByteSpan> batch =
+        packets.first(std::min(packets.size(), kMaxBatchPackets));
+    packets = packets.subspan(batch.size());
+
+    // The egress for each packet, or nullptr if the packet was dropped.
+    std::array<Egress*, kMaxBatchPackets> egresses;
+    std::array<uint32_t, kMaxBatchPackets> addresses;
+    std::array<Status, kMaxBatchPackets> parse_results;
+
+    {
+      // Parse the whole batch with one lock.
+      std::lock_guard lock(mutex_);
+      for (size_t i = 0; i < batch.size(); ++i) {
+        parse_results[i] = ParseAddress(batch[i], addresses[i]);
+      }
+    }
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+      egresses[i] = nullptr;
+      if (!parse_results[i].ok()) {
+        status = status.ok() ? parse_results[i] : status;
+        continue;
+      }
+
+      egresses[i] = FindEgress(addresses[i]);
+      if (egresses[i] == nullptr) {
+        status = status.ok() ? Status::NotFound() : status;
+      }
+    }
+
+    // Send each egress its packets, in order, with one call.
+    std::array<ConstByteSpan, kMaxBatchPackets> group;
+    for (size_t i = 0; i < batch.size(); ++i) {
+      Egress* const egress = egresses[i];
+      if (egress == nullptr) {
+        continue;
+      }
+
+      size_t count = 0;
+      for (size_t j = i; j < batch.size(); ++j) {
+        if (egresses[j] == egress) {
+          group[count++] = batch[j];
+          egresses[j] = nullptr;
+        }
+      }
+
+      const StatusWithSize result =
+          egress->SendPackets(std::span(group.data(), count));
+      sent += result.size();
+      if (!result.ok()) {
+        PW_LOG_ERROR("StaticRouter egress error for address %u: %s",
+                     static_cast<unsigned>(addresses[i]),
+                     result.status().str());
+        egress_errors_.Increment(static_cast<uint32_t>(count - result.size()));
+        status = status.ok() ? Status::Unavailable() : status;
+      }
+    }
+  }
+
+  return StatusWithSize(status, sent);
+}
+
+Status StaticRouter::ParseAddress(ConstByteSpan packet, uint32_t& address) {
+  if (!parser_.Parse(packet)) {
+    PW_LOG_ERROR("StaticRouter failed to parse packet; dropping");
+    parser_errors_.Increment();
+    return Status::DataLoss();
+  }
+
+  std::optional<uint32_t> result = parser_.GetDestinationAddress();
+  if (!result.has_value()) {
+    PW_LOG_ERROR("StaticRouter packet does not have address; dropping");
+    parser_errors_.Increment();
+    return Status::DataLoss();
+  }
+
+  address = result.value();
+  return OkStatus();
+}
+
+Egress* StaticRouter::FindEgress(uint32_t address) {
+  const Route* route = FindRoute(address);
+  if (route == nullptr) {
+    PW_LOG_ERROR("StaticRouter no route for address %u; dropping packet",
+                 static_cast<unsigned>(address));
+    route_errors_.Increment();
+    return nullptr;
+  }
+  return &route->egress;
+}
+
+const StaticRouter::Route* StaticRouter::FindRoute(uint32_t address) const {
+  if (routes_sorted_) {
+    // lower_bound finds the first of several routes for the address, as the
+    // linear scan does.
+    auto route = std::lower_bound(
+        routes_.begin(),
+        routes_.end(),
+        address,
+        [](const Route& r, uint32_t a) { return r.address < a; });
+    return route != routes_.end() && route->address == address ? &*route
+                                                               : nullptr;
+  }
+
+  auto route = std::find_if(routes_.begin(), routes_.end(), [&](auto r) {
+    return r.address == address;
+  });
+  return route != routes_.end() ? &*route : nullptr;
+}
+
 }  // namespace pw::router
@@ -14,6 +14,9 @@
 
 #include "pw_router/static_router.h"
 
+#include <array>
+#include <utility>
+
 #include "gtest/gtest.h"
 #include "pw_router/egress_function.h"
 
@@ -112,5 +115,158 @@ TEST(StaticRouter, RoutePacket_TracksNumberOfDrops) {
   EXPECT_EQ(router.dropped_packets(), 3u);
 }
 
+TEST(StaticRouter, RoutesAreSorted) {
+  constexpr StaticRouter::Route sorted[] = {
+      {1, GoodEgress}, {1, BadEgress}, {5, GoodEgress}};
+  constexpr StaticRouter::Route unsorted[] = {{2, GoodEgress}, {1, BadEgress}};
+  static_assert(StaticRouter::RoutesAreSorted(sorted));
+  static_assert(!StaticRouter::RoutesAreSorted(unsorted));
+  static_assert(StaticRouter::RoutesAreSorted({}));
+}
+
+// Returns routes to even addresses, with bad egresses at multiples of 8.
+template <size_t... kIndices>
+std::array<StaticRouter::Route, sizeof...(kIndices)> EvenRoutes(
+    std::index_sequence<kIndices...>) {
+  return {StaticRouter::Route{static_cast<uint32_t>(2 * kIndices),
+                              kIndices % 4 == 0 ? BadEgress : GoodEgress}...};
+}
+
+TEST(StaticRouter, RoutePacket_SortedRoutesFindEveryAddress) {
+  BasicPacketParser parser;
+  const auto routes = EvenRoutes(std::make_index_sequence<64>());
+  ASSERT_TRUE(StaticRouter::RoutesAreSorted(routes));
+  StaticRouter router(parser, std::span(routes));
+
+  for (uint32_t address = 0; address < 2 * routes.size() + 2; ++address) {
+    Status expected = OkStatus();
+    if (address % 2 != 0 || address >= 2 * routes.size()) {
+      expected = Status::NotFound();
+    } else if (address % 8 == 0) {
+      expected = Status::Unavailable();
+    }
+    EXPECT_EQ(router.RoutePacket(BasicPacket(address, 0xdddd).data()),
+              expected);
+  }
+}
+
+TEST(StaticRouter, RoutePacket_DuplicateAddressUsesFirstRoute) {
+  BasicPacketParser parser;
+  constexpr StaticRouter::Route sorted[] = {
+      {1, BadEgress}, {1, GoodEgress}, {2, GoodEgress}};
+  constexpr StaticRouter::Route unsorted[] = {
+      {2, GoodEgress}, {1, BadEgress}, {1, GoodEgress}};
+  StaticRouter sorted_router(parser, std::span(sorted));
+  StaticRouter unsorted_router(parser, std::span(unsorted));
+
+  EXPECT_EQ(sorted_router.RoutePacket(BasicPacket(1, 0xdddd).data()),
+            Status::Unavailable());
+  EXPECT_EQ(unsorted_router.RoutePacket(BasicPacket(1, 0xdddd).data()),
+            Status::Unavailable());
+}
+
+// Records each SendPackets() call and the payloads of the packets sent.
+class BatchEgress : public Egress {
+ public:
+  Status SendPacket(ConstByteSpan) override { return OkStatus(); }
+
+  StatusWithSize SendPackets(std::span<const ConstByteSpan> packets) override {
+    batch_sizes[calls++] = packets.size();
+    for (ConstByteSpan packet : packets) {
+      payloads[sent++] =
+          reinterpret_cast<const BasicPacket*>(packet.data())->payload;
+    }
+    return StatusWithSize(packets.size());
+  }
+
+  std::array<size_t, 8> batch_sizes = {};
+  std::array<uint64_t, 32> payloads = {};
+  size_t calls = 0;
+  size_t sent = 0;
+};
+
+TEST(StaticRouter, RoutePackets_SendsOneBatchPerEgress) {
+  BasicPacketParser parser;
+  BatchEgress first;
+  BatchEgress second;
+  const StaticRouter::Route routes[] = {{1, first}, {2, second}};
+  StaticRouter router(parser, std::span(routes));
+
+  const BasicPacket packets[] = {
+      {1, 10}, {2, 20}, {1, 11}, {1, 12}, {2, 21}};
+  const ConstByteSpan spans[] = {packets[0].data(),
+                                 packets[1].data(),
+                                 packets[2].data(),
+                                 packets[3].data(),
+                                 packets[4].data()};
+
+  const StatusWithSize result = router.RoutePackets(spans);
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(5u, result.size());
+
+  ASSERT_EQ(1u, first.calls);
+  EXPECT_EQ(3u, first.batch_sizes[0]);
+  EXPECT_EQ(10u, first.payloads[0]);
+  EXPECT_EQ(11u, first.payloads[1]);
+  EXPECT_EQ(12u, first.payloads[2]);
+
+  ASSERT_EQ(1u, second.calls);
+  EXPECT_EQ(2u, second.batch_sizes[0]);
+  EXPECT_EQ(20u, second.payloads[0]);
+  EXPECT_EQ(21u, second.payloads[1]);
+}
+
+// Returns packets to address 1 with their index as the payload.
+template <size_t... kIndices>
+std::array<BasicPacket, sizeof...(kIndices)> NumberedPackets(
+    std::index_sequence<kIndices...>) {
+  return {BasicPacket(1, kIndices)...};
+}
+
+TEST(StaticRouter, RoutePackets_SplitsLargeBatches) {
+  BasicPacketParser parser;
+  BatchEgress egress;
+  const StaticRouter::Route routes[] = {{1, egress}};
+  StaticRouter router(parser, std::span(routes));
+
+  constexpr size_t kPackets = StaticRouter::kMaxBatchPackets + 4;
+  const auto packets = NumberedPackets(std::make_index_sequence<kPackets>());
+  std::array<ConstByteSpan, kPackets> spans;
+  for (size_t i = 0; i < kPackets; ++i) {
+    spans[i] = packets[i].data();
+  }
+
+  const StatusWithSize result = router.RoutePackets(spans);
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(kPackets, result.size());
+
+  ASSERT_EQ(2u, egress.calls);
+  EXPECT_EQ(StaticRouter::kMaxBatchPackets, egress.batch_sizes[0]);
+  EXPECT_EQ(4u, egress.batch_sizes[1]);
+  for (size_t i = 0; i < kPackets; ++i) {
+    EXPECT_EQ(i, egress.payloads[i]);
+  }
+}
+
+TEST(StaticRouter, RoutePackets_TracksNumberOfDrops) {
+  BasicPacketParser parser;
+  constexpr StaticRouter::Route routes[] = {{1, GoodEgress}, {2, BadEgress}};
+  StaticRouter router(parser, std::span(routes));
+
+  BasicPacket bad_magic(1, 0xdddd);
+  bad_magic.magic = 0x1badda7a;
+  const BasicPacket packets[] = {{1, 0xdddd}, {42, 0xdddd}, {2, 0xdddd}};
+  const ConstByteSpan spans[] = {packets[0].data(),
+                                 bad_magic.data(),
+                                 packets[1].data(),
+                                 packets[2].data(),
+                                 packets[0].data()};
+
+  const StatusWithSize result = router.RoutePackets(spans);
+  EXPECT_EQ(Status::DataLoss(), result.status());
+  EXPECT_EQ(2u, result.size());
+  EXPECT_EQ(router.dropped_packets(), 3u);
+}
+
 }  // namespace
 }  // namespace pw::router
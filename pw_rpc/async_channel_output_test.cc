@@ -0,0 +1,131 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/async_channel_output.h"
+
+#include "gtest/gtest.h"
+
+namespace pw::rpc {
+namespace {
+
+class TestAsyncOutput : public AsyncChannelOutput<2, 16> {
+ public:
+  TestAsyncOutput() : AsyncChannelOutput("TestAsyncOutput") {}
+
+  std::span<const std::byte> last_sent() const { return last_sent_; }
+  size_t completed() const { return completed_; }
+  Status last_status() const { return last_status_; }
+
+  void set_start_status(Status status) { start_status_ = status; }
+
+ private:
+  Status StartSend(std::span<const std::byte> packet) override {
+    if (start_status_.ok()) {
+      last_sent_ = packet;
+    }
+    return start_status_;
+  }
+
+  void OnSendComplete(Status status) override {
+    completed_ += 1;
+    last_status_ = status;
+  }
+
+  std::span<const std::byte> last_sent_;
+  size_t completed_ = 0;
+  Status start_status_;
+  Status last_status_;
+};
+
+TEST(AsyncChannelOutput, AcquireBuffer_ReturnsEachBufferOnce) {
+  TestAsyncOutput output;
+
+  std::span<std::byte> first = output.AcquireBuffer();
+  std::span<std::byte> second = output.AcquireBuffer();
+
+  EXPECT_EQ(16u, first.size());
+  EXPECT_EQ(16u, second.size());
+  EXPECT_NE(first.data(), second.data());
+  EXPECT_TRUE(output.AcquireBuffer().empty());
+  EXPECT_EQ(2u, output.buffers_in_use());
+}
+
+TEST(AsyncChannelOutput, Send_KeepsBufferUntilSendComplete) {
+  TestAsyncOutput output;
+
+  std::span<std::byte> buffer = output.AcquireBuffer();
+  ASSERT_EQ(OkStatus(), output.SendAndReleaseBuffer(buffer.first(4)));
+
+  EXPECT_EQ(buffer.data(), output.last_sent().data());
+  EXPECT_EQ(4u, output.last_sent().size());
+  EXPECT_EQ(1u, output.buffers_in_use());
+  EXPECT_EQ(0u, output.completed());
+
+  output.SendComplete(output.last_sent(), Status::DataLoss());
+
+  EXPECT_EQ(0u, output.buffers_in_use());
+  EXPECT_EQ(1u, output.completed());
+  EXPECT_EQ(Status::DataLoss(), output.last_status());
+}
+
+TEST(AsyncChannelOutput, Send_EncodesNextPacketWhileFirstInFlight) {
+  TestAsyncOutput output;
+
+  std::span<std::byte> first = output.AcquireBuffer();
+  ASSERT_EQ(OkStatus(), output.SendAndReleaseBuffer(first.first(1)));
+
+  std::span<std::byte> second = output.AcquireBuffer();
+  ASSERT_FALSE(second.empty());
+  ASSERT_EQ(OkStatus(), output.SendAndReleaseBuffer(second.first(1)));
+  EXPECT_TRUE(output.AcquireBuffer().empty());
+
+  output.SendComplete(first.first(1), OkStatus());
+  EXPECT_EQ(first.data(), output.AcquireBuffer().data());
+}
+
+TEST(AsyncChannelOutput, Discard_ReleasesBuffer) {
+  TestAsyncOutput output;
+
+  output.DiscardBuffer(output.AcquireBuffer());
+
+  EXPECT_EQ(0u, output.buffers_in_use());
+  EXPECT_TRUE(output.last_sent().empty());
+  EXPECT_EQ(0u, output.completed());
+}
+
+TEST(AsyncChannelOutput, StartSendFails_ReleasesBuffer) {
+  TestAsyncOutput output;
+  output.set_start_status(Status::Unavailable());
+
+  std::span<std::byte> buffer = output.AcquireBuffer();
+  EXPECT_EQ(Status::Unavailable(), output.SendAndReleaseBuffer(buffer));
+
+  EXPECT_EQ(0u, output.buffers_in_use());
+  EXPECT_EQ(0u, output.completed());
+}
+
+TEST(AsyncChannelOutput, SendComplete_IgnoresForeignBuffer) {
+  TestAsyncOutput output;
+  std::byte other[4] = {};
+
+  std::span<std::byte> buffer = output.AcquireBuffer();
+  ASSERT_EQ(OkStatus(), output.SendAndReleaseBuffer(buffer));
+  output.SendComplete(other, OkStatus());
+
+  EXPECT_EQ(1u, output.buffers_in_use());
+  EXPECT_EQ(0u, output.completed());
+}
+
+}  // namespace
+}  // namespace pw::rpc
@@ -15,6 +15,7 @@
 #include "pw_rpc/internal/base_client_call.h"
 
 #include "pw_rpc/client.h"
+#include "pw_varint/varint.h"
 
 namespace pw::rpc::internal {
 
@@ -24,6 +25,35 @@ void BaseClientCall::Cancel() {
   }
 }
 
+Status BaseClientCall::StartClientStream() {
+  if (!active()) {
+    return Status::FailedPrecondition();
+  }
+  return channel_->Send(NewPacket(PacketType::REQUEST));
+}
+
+Status BaseClientCall::CloseClientStream() {
+  if (!active()) {
+    return Status::FailedPrecondition();
+  }
+  return channel_->Send(NewPacket(PacketType::CLIENT_STREAM_END));
+}
+
+Status BaseClientCall::GrantCredits(uint32_t responses) {
+  if (!active()) {
+    return Status::FailedPrecondition();
+  }
+
+  // Encode the StreamCredit payload, which has a single varint field.
+  std::byte payload[1 + varint::kMaxVarint32SizeBytes];
+  payload[0] = std::byte(
+      static_cast<uint32_t>(StreamCredit::Fields::RESPONSES) << 3);
+  const size_t size =
+      1 + varint::Encode(responses, std::span(payload).subspan(1));
+  return channel_->Send(
+      NewPacket(PacketType::STREAM_CREDIT, std::span(payload, size)));
+}
+
 std::span<std::byte> BaseClientCall::AcquirePayloadBuffer() {
   if (!active()) {
     return {};
@@ -34,12 +64,12 @@ std::span<std::byte> BaseClientCall::AcquirePayloadBuffer() {
 }
 
 Status BaseClientCall::ReleasePayloadBuffer(
-    std::span<const std::byte> payload) {
+    std::span<const std::byte> payload, PacketType type) {
   if (!active()) {
     return Status::FailedPrecondition();
   }
 
-  return channel_->Send(request_, NewPacket(PacketType::REQUEST, payload));
+  return channel_->Send(request_, NewPacket(type, payload));
 }
 
 Packet BaseClientCall::NewPacket(PacketType type,
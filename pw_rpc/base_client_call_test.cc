@@ -68,5 +68,24 @@ TEST(BaseClientCall, SendsPacketWithPayload) {
   EXPECT_EQ(std::memcmp(packet.payload().data(), payload, sizeof(payload)), 0);
 }
 
+TEST(BaseClientCall, ClientStream_SendsStartAndEndPackets) {
+  ClientContextForTest context;
+  BaseClientCall call(&context.channel(),
+                      context.kServiceId,
+                      context.kMethodId,
+                      [](BaseClientCall&, const Packet&) {});
+
+  EXPECT_EQ(OkStatus(), call.StartClientStream());
+  EXPECT_EQ(context.output().sent_packet().type(), PacketType::REQUEST);
+  EXPECT_TRUE(context.output().sent_packet().payload().empty());
+
+  EXPECT_EQ(OkStatus(), call.CloseClientStream());
+  EXPECT_EQ(context.output().sent_packet().type(),
+            PacketType::CLIENT_STREAM_END);
+  EXPECT_EQ(context.output().sent_packet().method_id(), context.kMethodId);
+  EXPECT_EQ(context.output().packet_count(), 2u);
+  EXPECT_TRUE(call.active());
+}
+
 }  // namespace
 }  // namespace pw::rpc::internal
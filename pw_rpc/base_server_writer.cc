@@ -14,14 +14,38 @@
 
 #include "pw_rpc/internal/base_server_writer.h"
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
 #include "pw_rpc/internal/method.h"
 #include "pw_rpc/internal/packet.h"
 #include "pw_rpc/internal/server.h"
+#include "pw_varint/varint.h"
 
 namespace pw::rpc::internal {
+namespace {
+
+// Each batched payload is a length-delimited ResponseBatch.payloads field.
+constexpr std::byte kBatchPayloadKey = std::byte(
+    (static_cast<uint32_t>(ResponseBatch::Fields::PAYLOADS) << 3) | 2);
+
+// Space reserved before each batched payload for its key and length.
+constexpr size_t kMaxBatchPrefixBytes = 1 + varint::kMaxVarint32SizeBytes;
 
-BaseServerWriter::BaseServerWriter(ServerCall& call)
-    : call_(call), state_(kOpen) {
+}  // namespace
+
+BaseServerWriter::BaseServerWriter(ServerCall& call, MethodType type)
+    : call_(call),
+      client_stream_handler_(nullptr),
+      batch_size_(0),
+      credits_(0),
+      type_(type),
+      flow_control_(false),
+      client_stream_open_(type == MethodType::kClientStreaming ||
+                          type == MethodType::kBidirectionalStreaming),
+      state_(kOpen) {
   call_.server().RegisterWriter(*this);
 }
 
@@ -39,6 +63,16 @@ BaseServerWriter& BaseServerWriter::operator=(BaseServerWriter&& other) {
 
   call_ = std::move(other.call_);
   response_ = std::move(other.response_);
+  client_stream_handler_ = other.client_stream_handler_;
+  batch_buffer_ = other.batch_buffer_;
+  batch_size_ = other.batch_size_;
+  type_ = other.type_;
+  credits_ = other.credits_;
+  flow_control_ = other.flow_control_;
+  client_stream_open_ = other.client_stream_open_;
+  other.client_stream_handler_ = nullptr;
+  other.batch_buffer_ = {};
+  other.batch_size_ = 0;
 
   return *this;
 }
@@ -50,21 +84,32 @@ void BaseServerWriter::Finish(Status status) {
     return;
   }
 
+  if (type_ == MethodType::kClientStreaming) {
+    CloseAndSendResponse({}, status);
+    return;
+  }
+
+  Flush();
+  batch_buffer_ = {};
+
   // If the ServerWriter implementer or user forgets to release an acquired
   // buffer before finishing, release it here.
   if (!response_.empty()) {
-    ReleasePayloadBuffer();
+    call_.channel().Release(response_);
   }
 
   Close();
 
   // Send a control packet indicating that the stream (and RPC) has terminated.
-  call_.channel().Send(Packet(PacketType::SERVER_STREAM_END,
-                              call_.channel().id(),
-                              call_.service().id(),
-                              method().id(),
-                              {},
-                              status));
+  const Packet stream_end(PacketType::SERVER_STREAM_END,
+                          call_.channel().id(),
+                          call_.service().id(),
+                          method().id(),
+                          {},
+                          status);
+  if (call_.channel().Send(stream_end).ok()) {
+    call_.server().PacketSent(stream_end);
+  }
 }
 
 std::span<std::byte> BaseServerWriter::AcquirePayloadBuffer() {
@@ -72,6 +117,11 @@ std::span<std::byte> BaseServerWriter::AcquirePayloadBuffer() {
     return {};
   }
 
+  if (batching()) {
+    return batch_buffer_.subspan(
+        std::min(batch_size_ + kMaxBatchPrefixBytes, batch_buffer_.size()));
+  }
+
   // Only allow having one active buffer at a time.
   if (response_.empty()) {
     response_ = call_.channel().AcquireBuffer();
@@ -80,12 +130,46 @@ std::span<std::byte> BaseServerWriter::AcquirePayloadBuffer() {
   return response_.payload(ResponsePacket());
 }
 
+bool BaseServerWriter::PayloadBufferContains(
+    std::span<const std::byte> payload) const {
+  if (response_.Contains(payload)) {
+    return true;
+  }
+  return batching() && payload.data() >= batch_buffer_.data() &&
+         payload.data() + payload.size() <=
+             batch_buffer_.data() + batch_buffer_.size();
+}
+
 Status BaseServerWriter::ReleasePayloadBuffer(
     std::span<const std::byte> payload) {
   if (!open()) {
     return Status::FailedPrecondition();
   }
-  return call_.channel().Send(response_, ResponsePacket(payload));
+  if (flow_control_ && credits_ == 0u) {
+    ReleasePayloadBuffer();
+    return Status::ResourceExhausted();
+  }
+
+  Status status;
+  if (batching()) {
+    status = AddToBatch(payload);
+
+    // The payload may have been built in a channel buffer acquired before
+    // batching was enabled. It has been copied, so release the buffer.
+    if (!response_.empty()) {
+      call_.channel().Release(response_);
+    }
+  } else {
+    const Packet packet = ResponsePacket(payload);
+    status = call_.channel().Send(response_, packet);
+    if (status.ok()) {
+      call_.server().PacketSent(packet);
+    }
+  }
+  if (flow_control_ && status.ok()) {
+    credits_ -= 1;
+  }
+  return status;
 }
 
 Status BaseServerWriter::ReleasePayloadBuffer() {
@@ -93,10 +177,100 @@ Status BaseServerWriter::ReleasePayloadBuffer() {
     return Status::FailedPrecondition();
   }
 
-  call_.channel().Release(response_);
+  // While batching, payloads are built in the batch buffer, so there may be no
+  // channel buffer to release.
+  if (!batching() || !response_.empty()) {
+    call_.channel().Release(response_);
+  }
+  return OkStatus();
+}
+
+Status BaseServerWriter::EnableBatching(std::span<std::byte> batch_buffer) {
+  DisableBatching();
+
+  if (!open()) {
+    return Status::FailedPrecondition();
+  }
+
+  // The batch is sent in one packet, so it may only use as much of the buffer
+  // as fits in the payload of the channel's packets.
+  const bool acquired = response_.empty();
+  if (acquired) {
+    response_ = call_.channel().AcquireBuffer();
+  }
+  const size_t max_batch_size = response_.payload(ResponsePacket()).size();
+  if (acquired) {
+    call_.channel().Release(response_);
+  }
+
+  if (max_batch_size == 0u) {
+    return Status::ResourceExhausted();
+  }
+
+  batch_buffer_ =
+      batch_buffer.first(std::min(batch_buffer.size(), max_batch_size));
   return OkStatus();
 }
 
+void BaseServerWriter::DisableBatching() {
+  Flush();
+  batch_buffer_ = {};
+}
+
+Status BaseServerWriter::Flush() {
+  if (!open()) {
+    return Status::FailedPrecondition();
+  }
+  if (!batch_pending()) {
+    return OkStatus();
+  }
+
+  // The batch is copied into a channel buffer only when it is sent. Other
+  // packets may use the channel's buffer between batched responses.
+  const size_t batch_size = std::exchange(batch_size_, 0);
+
+  if (response_.empty()) {
+    response_ = call_.channel().AcquireBuffer();
+  }
+  std::span<std::byte> payload = response_.payload(ResponsePacket());
+  if (batch_size > payload.size()) {
+    call_.channel().Release(response_);
+    return Status::ResourceExhausted();
+  }
+  std::memcpy(payload.data(), batch_buffer_.data(), batch_size);
+
+  Packet packet = ResponsePacket(payload.first(batch_size));
+  packet.set_type(PacketType::RESPONSE_BATCH);
+
+  Status status = call_.channel().Send(response_, packet);
+  if (status.ok()) {
+    call_.server().PacketSent(packet);
+  }
+  return status;
+}
+
+Status BaseServerWriter::CloseAndSendResponse(
+    std::span<const std::byte> payload, Status status) {
+  if (!open()) {
+    return Status::FailedPrecondition();
+  }
+
+  Close();
+
+  if (response_.empty()) {
+    response_ = call_.channel().AcquireBuffer();
+  }
+
+  Packet packet = ResponsePacket(payload);
+  packet.set_status(status);
+
+  const Status result = call_.channel().Send(response_, packet);
+  if (result.ok()) {
+    call_.server().PacketSent(packet);
+  }
+  return result;
+}
+
 void BaseServerWriter::Close() {
   if (!open()) {
     return;
@@ -106,6 +280,44 @@ void BaseServerWriter::Close() {
   state_ = kClosed;
 }
 
+void BaseServerWriter::AddCredits(uint32_t credits) {
+  credits_ = credits > std::numeric_limits<uint32_t>::max() - credits_
+                 ? std::numeric_limits<uint32_t>::max()
+                 : credits_ + credits;
+}
+
+Status BaseServerWriter::HandleClientStream(const Packet& packet) {
+  if (packet.type() == PacketType::CLIENT_STREAM_END) {
+    client_stream_open_ = false;
+    if (client_stream_handler_ != nullptr) {
+      client_stream_handler_->ClientStreamEnd();
+    }
+    return OkStatus();
+  }
+
+  if (client_stream_handler_ == nullptr) {
+    return OkStatus();
+  }
+  return client_stream_handler_->ReceivedPayload(method(), packet.payload());
+}
+
+Status BaseServerWriter::AddToBatch(std::span<const std::byte> payload) {
+  // A payload from AcquirePayloadBuffer() was written after the space reserved
+  // for its prefix, so it is moved back to follow the prefix's actual size.
+  // Payloads from other buffers are copied.
+  const size_t prefix_size = 1 + varint::EncodedSize(payload.size());
+  if (batch_size_ + prefix_size + payload.size() > batch_buffer_.size()) {
+    return Status::OutOfRange();
+  }
+
+  std::byte* entry = batch_buffer_.data() + batch_size_;
+  std::memmove(entry + prefix_size, payload.data(), payload.size());
+  entry[0] = kBatchPayloadKey;
+  varint::Encode(payload.size(), std::span(entry + 1, prefix_size - 1));
+  batch_size_ += prefix_size + payload.size();
+  return OkStatus();
+}
+
 Packet BaseServerWriter::ResponsePacket(
     std::span<const std::byte> payload) const {
   return Packet(PacketType::RESPONSE,
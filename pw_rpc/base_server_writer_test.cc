@@ -18,6 +18,7 @@
 #include <array>
 #include <cstdint>
 #include <cstring>
+#include <limits>
 
 #include "gtest/gtest.h"
 #include "pw_rpc/internal/test_method.h"
@@ -154,15 +155,50 @@ TEST(ServerWriter, Open_SendsPacketWithPayload) {
   constexpr byte data[] = {byte{0xf0}, byte{0x0d}};
   ASSERT_EQ(OkStatus(), writer.Write(data));
 
-  byte encoded[64];
-  auto result = context.packet(data).Encode(encoded);
-  ASSERT_EQ(OkStatus(), result.status());
+  const Packet expected = context.packet(data);
+  const Packet& sent = context.output().sent_packet();
 
-  EXPECT_EQ(result.value().size(), context.output().sent_data().size());
-  EXPECT_EQ(
-      0,
-      std::memcmp(
-          encoded, context.output().sent_data().data(), result.value().size()));
+  EXPECT_EQ(expected.type(), sent.type());
+  EXPECT_EQ(expected.channel_id(), sent.channel_id());
+  EXPECT_EQ(expected.service_id(), sent.service_id());
+  EXPECT_EQ(expected.method_id(), sent.method_id());
+  EXPECT_EQ(expected.status(), sent.status());
+  ASSERT_EQ(sizeof(data), sent.payload().size());
+  EXPECT_EQ(0, std::memcmp(data, sent.payload().data(), sizeof(data)));
+}
+
+TEST(ServerWriter, MethodObserver_ReportsResponsesAndStreamEnd) {
+  ServerContextForTest<TestService> context(TestService::method.method());
+  TestMethodObserver observer;
+  context.server().set_method_observer(&observer);
+  FakeServerWriter writer(context.get());
+
+  constexpr byte data[] = {byte{0xf0}, byte{0x0d}};
+  ASSERT_EQ(OkStatus(), writer.Write(data));
+  ASSERT_EQ(OkStatus(), writer.Write(data));
+
+  EXPECT_EQ(2u, observer.responses);
+  EXPECT_EQ(2 * sizeof(data), observer.response_bytes);
+  EXPECT_EQ(context.kServiceId, observer.last_service_id);
+  EXPECT_EQ(context.get().method().id(), observer.last_method_id);
+
+  writer.Finish(Status::Aborted());
+
+  EXPECT_EQ(3u, observer.responses);
+  EXPECT_EQ(Status::Aborted(), observer.last_status);
+}
+
+TEST(ServerWriter, MethodObserver_FailedSendNotReported) {
+  ServerContextForTest<TestService> context(TestService::method.method());
+  TestMethodObserver observer;
+  context.server().set_method_observer(&observer);
+  FakeServerWriter writer(context.get());
+
+  context.output().set_send_status(Status::Unavailable());
+
+  constexpr byte data[] = {byte{0xf0}, byte{0x0d}};
+  EXPECT_EQ(Status::Unavailable(), writer.Write(data));
+  EXPECT_EQ(0u, observer.responses);
 }
 
 TEST(ServerWriter, Closed_IgnoresPacket) {
@@ -175,6 +211,154 @@ TEST(ServerWriter, Closed_IgnoresPacket) {
   EXPECT_EQ(Status::FailedPrecondition(), writer.Write(data));
 }
 
+TEST(ServerWriter, Batching_SendsResponsesInOnePacket) {
+  ServerContextForTest<TestService> context(TestService::method.method());
+  FakeServerWriter writer(context.get());
+  std::array<byte, 32> batch_buffer;
+  ASSERT_EQ(OkStatus(), writer.EnableBatching(batch_buffer));
+
+  constexpr byte data[] = {byte{0xf0}, byte{0x0d}};
+  ASSERT_EQ(OkStatus(), writer.Write(data));
+  ASSERT_EQ(OkStatus(), writer.Write(std::span(data, 1)));
+  EXPECT_EQ(0u, context.output().packet_count());
+
+  ASSERT_EQ(OkStatus(), writer.Flush());
+  ASSERT_EQ(1u, context.output().packet_count());
+
+  const Packet& packet = context.output().sent_packet();
+  EXPECT_EQ(packet.type(), PacketType::RESPONSE_BATCH);
+  EXPECT_EQ(packet.method_id(), context.get().method().id());
+
+  // Each payload is a length-delimited ResponseBatch.payloads field.
+  constexpr byte expected[] = {byte{0x0a},
+                               byte{2},
+                               byte{0xf0},
+                               byte{0x0d},
+                               byte{0x0a},
+                               byte{1},
+                               byte{0xf0}};
+  ASSERT_EQ(sizeof(expected), packet.payload().size());
+  EXPECT_EQ(0,
+            std::memcmp(expected, packet.payload().data(), sizeof(expected)));
+
+  // Nothing is sent if no responses are batched.
+  EXPECT_EQ(OkStatus(), writer.Flush());
+  EXPECT_EQ(1u, context.output().packet_count());
+}
+
+TEST(ServerWriter, Batching_OtherPacketsDoNotOverwriteBatch) {
+  ServerContextForTest<TestService> context(TestService::method.method());
+  FakeServerWriter writer(context.get());
+  std::array<byte, 32> batch_buffer;
+  ASSERT_EQ(OkStatus(), writer.EnableBatching(batch_buffer));
+
+  constexpr byte data[] = {byte{0xf0}, byte{0x0d}};
+  ASSERT_EQ(OkStatus(), writer.Write(data));
+
+  // Another packet uses the channel's buffer before the batch is sent.
+  constexpr byte other_data[] = {byte{0xab}, byte{0xcd}, byte{0xef}};
+  ASSERT_EQ(OkStatus(),
+            context.get().channel().Send(context.packet(other_data)));
+  ASSERT_EQ(1u, context.output().packet_count());
+
+  ASSERT_EQ(OkStatus(), writer.Write(std::span(data, 1)));
+  ASSERT_EQ(OkStatus(), writer.Flush());
+  ASSERT_EQ(2u, context.output().packet_count());
+
+  const Packet& packet = context.output().sent_packet();
+  EXPECT_EQ(packet.type(), PacketType::RESPONSE_BATCH);
+  constexpr byte expected[] = {byte{0x0a},
+                               byte{2},
+                               byte{0xf0},
+                               byte{0x0d},
+                               byte{0x0a},
+                               byte{1},
+                               byte{0xf0}};
+  ASSERT_EQ(sizeof(expected), packet.payload().size());
+  EXPECT_EQ(0,
+            std::memcmp(expected, packet.payload().data(), sizeof(expected)));
+}
+
+TEST(ServerWriter, Batching_EnableWhenClosed_FailsPrecondition) {
+  ServerContextForTest<TestService> context(TestService::method.method());
+  FakeServerWriter writer(context.get());
+  writer.Finish();
+
+  std::array<byte, 32> batch_buffer;
+  EXPECT_EQ(Status::FailedPrecondition(), writer.EnableBatching(batch_buffer));
+  EXPECT_FALSE(writer.batching());
+}
+
+TEST(ServerWriter, Batching_FinishSendsBatchFirst) {
+  ServerContextForTest<TestService> context(TestService::method.method());
+  FakeServerWriter writer(context.get());
+  std::array<byte, 32> batch_buffer;
+  ASSERT_EQ(OkStatus(), writer.EnableBatching(batch_buffer));
+
+  constexpr byte data[] = {byte{0xf0}, byte{0x0d}};
+  ASSERT_EQ(OkStatus(), writer.Write(data));
+  writer.Finish();
+
+  ASSERT_EQ(2u, context.output().packet_count());
+  EXPECT_EQ(context.output().sent_packet().type(),
+            PacketType::SERVER_STREAM_END);
+  EXPECT_TRUE(writer.output_buffer().empty());
+}
+
+TEST(ServerWriter, Batching_DisableSendsBatch) {
+  ServerContextForTest<TestService> context(TestService::method.method());
+  FakeServerWriter writer(context.get());
+  std::array<byte, 32> batch_buffer;
+  ASSERT_EQ(OkStatus(), writer.EnableBatching(batch_buffer));
+
+  constexpr byte data[] = {byte{0xf0}, byte{0x0d}};
+  ASSERT_EQ(OkStatus(), writer.Write(data));
+  writer.DisableBatching();
+
+  ASSERT_EQ(1u, context.output().packet_count());
+  EXPECT_EQ(context.output().sent_packet().type(), PacketType::RESPONSE_BATCH);
+
+  ASSERT_EQ(OkStatus(), writer.Write(data));
+  ASSERT_EQ(2u, context.output().packet_count());
+  EXPECT_EQ(context.output().sent_packet().type(), PacketType::RESPONSE);
+}
+
+TEST(ServerWriter, FlowControl_DropsResponsesWithoutCredit) {
+  ServerContextForTest<TestService> context(TestService::method.method());
+  FakeServerWriter writer(context.get());
+  EXPECT_EQ(std::numeric_limits<uint32_t>::max(), writer.AvailableCredits());
+
+  writer.EnableFlowControl(1);
+  EXPECT_EQ(1u, writer.AvailableCredits());
+
+  constexpr byte data[] = {byte{0xf0}, byte{0x0d}};
+  ASSERT_EQ(OkStatus(), writer.Write(data));
+  EXPECT_EQ(0u, writer.AvailableCredits());
+  EXPECT_EQ(1u, context.output().packet_count());
+
+  EXPECT_EQ(Status::ResourceExhausted(), writer.Write(data));
+  EXPECT_EQ(1u, context.output().packet_count());
+  EXPECT_TRUE(writer.output_buffer().empty());
+}
+
+TEST(ServerWriter, FlowControl_BatchedResponsesUseCredits) {
+  ServerContextForTest<TestService> context(TestService::method.method());
+  FakeServerWriter writer(context.get());
+  std::array<byte, 32> batch_buffer;
+  ASSERT_EQ(OkStatus(), writer.EnableBatching(batch_buffer));
+  writer.EnableFlowControl(1);
+
+  constexpr byte data[] = {byte{0xf0}, byte{0x0d}};
+  ASSERT_EQ(OkStatus(), writer.Write(data));
+  EXPECT_EQ(Status::ResourceExhausted(), writer.Write(data));
+
+  // The dropped response does not discard the batch.
+  ASSERT_EQ(OkStatus(), writer.Flush());
+  ASSERT_EQ(1u, context.output().packet_count());
+  EXPECT_EQ(context.output().sent_packet().type(), PacketType::RESPONSE_BATCH);
+  EXPECT_EQ(4u, context.output().sent_packet().payload().size());
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace pw::rpc
@@ -22,12 +22,15 @@ namespace pw::rpc::internal {
 using std::byte;
 
 std::span<byte> Channel::OutputBuffer::payload(const Packet& packet) const {
-  const size_t reserved_size = packet.MinEncodedSizeBytes();
-  return reserved_size <= buffer_.size() ? buffer_.subspan(reserved_size)
-                                         : std::span<byte>();
+  return buffer_.subspan(packet.PayloadOffset(buffer_.size()));
 }
 
 Status Channel::Send(OutputBuffer& buffer, const internal::Packet& packet) {
+  if (buffer.empty()) {
+    output().DiscardBuffer(buffer.buffer_);
+    return Status::ResourceExhausted();
+  }
+
   Result encoded = packet.Encode(buffer.buffer_);
 
   if (!encoded.ok()) {
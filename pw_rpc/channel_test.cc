@@ -54,6 +54,16 @@ TEST(Channel, OutputBuffer_EmptyBuffer) {
   EXPECT_TRUE(buffer.payload(kTestPacket).empty());
 }
 
+TEST(Channel, OutputBuffer_NoBuffer_ReturnsResourceExhausted) {
+  TestOutput<0> output;
+  internal::Channel channel(100, &output);
+
+  Channel::OutputBuffer output_buffer = channel.AcquireBuffer();
+  EXPECT_EQ(Status::ResourceExhausted(),
+            channel.Send(output_buffer, kTestPacket));
+  EXPECT_EQ(0u, output.packet_count());
+}
+
 TEST(Channel, OutputBuffer_TooSmall) {
   TestOutput<kReservedSize - 1> output;
   internal::Channel channel(100, &output);
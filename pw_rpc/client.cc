@@ -14,7 +14,10 @@
 
 #include "pw_rpc/client.h"
 
+#include <algorithm>
+
 #include "pw_log/log.h"
+#include "pw_protobuf/decoder.h"
 #include "pw_rpc/internal/packet.h"
 
 namespace pw::rpc {
@@ -23,6 +26,7 @@ namespace {
 using internal::BaseClientCall;
 using internal::Packet;
 using internal::PacketType;
+namespace ResponseBatch = internal::ResponseBatch;
 
 }  // namespace
 
@@ -45,11 +49,7 @@ Status Client::ProcessPacket(ConstByteSpan data) {
     return Status::DataLoss();
   }
 
-  auto call = std::find_if(calls_.begin(), calls_.end(), [&](auto& c) {
-    return c.channel().id() == packet.channel_id() &&
-           c.service_id() == packet.service_id() &&
-           c.method_id() == packet.method_id();
-  });
+  BaseClientCall* call = FindCall(packet);
 
   auto channel = std::find_if(channels_.begin(), channels_.end(), [&](auto& c) {
     return c.id() == packet.channel_id();
@@ -60,7 +60,7 @@ Status Client::ProcessPacket(ConstByteSpan data) {
     return Status::NotFound();
   }
 
-  if (call == calls_.end()) {
+  if (call == nullptr) {
     PW_LOG_WARN("RPC client received a packet for a request it did not make");
     channel->Send(Packet::ClientError(packet, Status::FailedPrecondition()));
     return Status::NotFound();
@@ -75,6 +75,8 @@ Status Client::ProcessPacket(ConstByteSpan data) {
       call->HandleResponse(packet);
       RemoveCall(*call);
       break;
+    case PacketType::RESPONSE_BATCH:
+      return ProcessResponseBatch(packet);
     default:
       return Status::Unimplemented();
   }
@@ -82,20 +84,158 @@ Status Client::ProcessPacket(ConstByteSpan data) {
   return OkStatus();
 }
 
+Status Client::ProcessResponseBatch(const Packet& batch) {
+  Packet response = batch;
+  response.set_type(PacketType::RESPONSE);
+
+  protobuf::Decoder decoder(batch.payload());
+  Status status;
+
+  while ((status = decoder.Next()).ok()) {
+    if (static_cast<ResponseBatch::Fields>(decoder.FieldNumber()) !=
+        ResponseBatch::Fields::PAYLOADS) {
+      continue;
+    }
+
+    ConstByteSpan payload;
+    if (!decoder.ReadBytes(&payload).ok()) {
+      break;
+    }
+
+    // A response handler may cancel the call, so it is looked up again for
+    // each response.
+    BaseClientCall* call = FindCall(response);
+    if (call == nullptr) {
+      return OkStatus();
+    }
+
+    response.set_payload(payload);
+    call->HandleResponse(response);
+  }
+
+  if (!status.IsOutOfRange()) {
+    PW_LOG_WARN("RPC client failed to decode a response batch");
+    return Status::DataLoss();
+  }
+  return OkStatus();
+}
+
+void Client::FailCall(BaseClientCall& call, Status status) {
+  Packet packet = call.NewPacket(PacketType::SERVER_ERROR);
+  packet.set_status(status);
+  call.HandleResponse(packet);
+  call.Unregister();
+}
+
+BaseClientCall* Client::FindCall(uint32_t channel_id,
+                                 uint32_t service_id,
+                                 uint32_t method_id) {
+  auto matches = [&](const BaseClientCall& call) {
+    return call.channel().id() == channel_id &&
+           call.service_id() == service_id && call.method_id() == method_id;
+  };
+
+  if constexpr (cfg::kClientCallTableSize > 0) {
+    size_t index = CallTableIndex(channel_id, service_id, method_id);
+    for (size_t i = 0; i < call_table_.size(); ++i) {
+      BaseClientCall* call = call_table_[index];
+      if (call == nullptr) {
+        break;
+      }
+      if (matches(*call)) {
+        return call;
+      }
+      index = (index + 1) % call_table_.size();
+    }
+  }
+
+  auto call = std::find_if(calls_.begin(), calls_.end(), matches);
+  return call == calls_.end() ? nullptr : &*call;
+}
+
 Status Client::RegisterCall(BaseClientCall& call) {
-  auto existing_call = std::find_if(calls_.begin(), calls_.end(), [&](auto& c) {
-    return c.channel().id() == call.channel().id() &&
-           c.service_id() == call.service_id() &&
-           c.method_id() == call.method_id();
-  });
-  if (existing_call != calls_.end()) {
+  if (FindCall(call.channel().id(), call.service_id(), call.method_id()) !=
+      nullptr) {
     PW_LOG_WARN(
         "RPC client tried to call same method multiple times; aborting.");
     return Status::FailedPrecondition();
   }
 
-  calls_.push_front(call);
+  if (!AddToCallTable(call)) {
+    calls_.push_front(call);
+  }
   return OkStatus();
 }
 
+void Client::RemoveCall(BaseClientCall& call) {
+  if (!RemoveFromCallTable(call)) {
+    calls_.remove(call);
+  }
+  if (call_observer_ != nullptr) {
+    call_observer_->CallRemoved(call);
+  }
+}
+
+bool Client::AddToCallTable(BaseClientCall& call) {
+  if constexpr (cfg::kClientCallTableSize > 0) {
+    size_t index =
+        CallTableIndex(call.channel().id(), call.service_id(), call.method_id());
+    for (size_t i = 0; i < call_table_.size(); ++i) {
+      if (call_table_[index] == nullptr) {
+        call_table_[index] = &call;
+        table_calls_ += 1;
+        return true;
+      }
+      index = (index + 1) % call_table_.size();
+    }
+  }
+  return false;
+}
+
+bool Client::RemoveFromCallTable(const BaseClientCall& call) {
+  if constexpr (cfg::kClientCallTableSize > 0) {
+    constexpr size_t kSize = cfg::kClientCallTableSize;
+
+    size_t gap =
+        CallTableIndex(call.channel().id(), call.service_id(), call.method_id());
+    size_t i = 0;
+    for (; i < kSize && call_table_[gap] != &call; ++i) {
+      if (call_table_[gap] == nullptr) {
+        return false;
+      }
+      gap = (gap + 1) % kSize;
+    }
+    if (i == kSize) {
+      return false;
+    }
+
+    // Shift the following entries in the probe sequence back into the gap,
+    // unless they are already at or after their own index, so that lookups do
+    // not stop early at an empty entry.
+    size_t next = gap;
+    for (i = 1; i < kSize; ++i) {
+      next = (next + 1) % kSize;
+      BaseClientCall* const entry = call_table_[next];
+      if (entry == nullptr) {
+        break;
+      }
+
+      const size_t home = CallTableIndex(
+          entry->channel().id(), entry->service_id(), entry->method_id());
+      const bool home_in_gap_to_next =
+          gap < next ? (gap < home && home <= next)
+                     : (gap < home || home <= next);
+      if (!home_in_gap_to_next) {
+        call_table_[gap] = entry;
+        gap = next;
+      }
+    }
+
+    call_table_[gap] = nullptr;
+    table_calls_ -= 1;
+    return true;
+  }
+  return false;
+}
+
 }  // namespace pw::rpc
@@ -0,0 +1,111 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/client_deadlines.h"
+
+#include <algorithm>
+
+#include "pw_rpc/internal/config.h"
+
+namespace pw::rpc {
+namespace {
+
+using internal::BaseClientCall;
+
+constexpr chrono::SystemClock::duration kDeadlineResolution =
+    std::chrono::milliseconds(cfg::kClientDeadlineResolutionMs);
+
+using Tick = chrono::TimerWheel::Tick;
+
+// Deadlines are rounded up to a tick, so calls never time out early. Times
+// before the clock's epoch are tick 0.
+Tick DeadlineTick(chrono::SystemClock::time_point deadline) {
+  const chrono::SystemClock::duration since_epoch = deadline.time_since_epoch();
+  if (since_epoch <= since_epoch.zero()) {
+    return 0;
+  }
+  const bool partial_tick =
+      since_epoch % kDeadlineResolution != kDeadlineResolution.zero();
+  return Tick(since_epoch / kDeadlineResolution + (partial_tick ? 1 : 0));
+}
+
+Tick CurrentTick(chrono::SystemClock::time_point now) {
+  const chrono::SystemClock::duration since_epoch = now.time_since_epoch();
+  if (since_epoch <= since_epoch.zero()) {
+    return 0;
+  }
+  return Tick(since_epoch / kDeadlineResolution);
+}
+
+}  // namespace
+
+ClientDeadlines::ClientDeadlines(Client& client, std::span<Deadline> deadlines)
+    : client_(client), deadlines_(deadlines), timed_out_calls_(0) {
+  client_.call_observer_ = this;
+}
+
+ClientDeadlines::~ClientDeadlines() { client_.call_observer_ = nullptr; }
+
+Status ClientDeadlines::SetDeadline(BaseClientCall& call,
+                                    chrono::SystemClock::time_point deadline) {
+  if (!call.active()) {
+    return Status::FailedPrecondition();
+  }
+
+  Deadline* entry = Find(&call);
+  if (entry == nullptr) {
+    entry = Find(nullptr);
+    if (entry == nullptr) {
+      return Status::ResourceExhausted();
+    }
+    entry->call = &call;
+  }
+
+  wheel_.Schedule(*entry, DeadlineTick(deadline));
+  return OkStatus();
+}
+
+void ClientDeadlines::ExpireCalls(chrono::SystemClock::time_point now) {
+  // The wheel cannot move backwards, so an earlier time only expires the calls
+  // that are already due.
+  wheel_.Advance(std::max(CurrentTick(now), wheel_.now()));
+
+  // Expired calls are popped one at a time, since a response handler may
+  // cancel or destroy other calls, which removes them from the expired list.
+  while (chrono::TimerWheel::Timer* timer = wheel_.PopExpired()) {
+    Deadline& entry = static_cast<Deadline&>(*timer);
+    BaseClientCall& call = *entry.call;
+    entry.call = nullptr;
+    timed_out_calls_ += 1;
+
+    client_.FailCall(call, Status::DeadlineExceeded());
+  }
+}
+
+void ClientDeadlines::CallRemoved(BaseClientCall& call) {
+  if (Deadline* entry = Find(&call); entry != nullptr) {
+    wheel_.Cancel(*entry);
+    entry->call = nullptr;
+  }
+}
+
+ClientDeadlines::Deadline* ClientDeadlines::Find(const BaseClientCall* call) {
+  auto entry = std::find_if(
+      deadlines_.begin(), deadlines_.end(), [call](const Deadline& deadline) {
+        return deadline.call == call;
+      });
+  return entry == deadlines_.end() ? nullptr : &*entry;
+}
+
+}  // namespace pw::rpc
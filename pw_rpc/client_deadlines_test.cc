@@ -0,0 +1,212 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/client_deadlines.h"
+
+#include <chrono>
+
+#include "gtest/gtest.h"
+#include "pw_rpc/internal/packet.h"
+#include "pw_rpc_private/internal_test_utils.h"
+
+namespace pw::rpc {
+namespace {
+
+using internal::BaseClientCall;
+using internal::Packet;
+using internal::PacketType;
+
+class TestClientCall : public BaseClientCall {
+ public:
+  constexpr TestClientCall(Channel* channel,
+                           uint32_t service_id,
+                           uint32_t method_id)
+      : BaseClientCall(channel, service_id, method_id, ProcessPacket) {}
+
+  static void ProcessPacket(BaseClientCall& call, const Packet& packet) {
+    static_cast<TestClientCall&>(call).HandlePacket(packet);
+  }
+
+  void HandlePacket(const Packet& packet) {
+    invoked_ = true;
+    responses_ += 1;
+    last_type_ = packet.type();
+    last_status_ = packet.status();
+  }
+
+  constexpr bool invoked() const { return invoked_; }
+  constexpr size_t responses() const { return responses_; }
+  constexpr PacketType last_type() const { return last_type_; }
+  constexpr Status last_status() const { return last_status_; }
+
+ private:
+  bool invoked_ = false;
+  size_t responses_ = 0;
+  PacketType last_type_ = {};
+  Status last_status_;
+};
+
+using Time = chrono::SystemClock::time_point;
+using std::chrono::milliseconds;
+
+TEST(ClientDeadlines, FailsCallWithDeadlineExceeded) {
+  ClientContextForTest context;
+  ClientDeadlinesBuffer<2> deadlines(context.client());
+
+  TestClientCall call(
+      &context.channel(), context.kServiceId, context.kMethodId);
+  ASSERT_EQ(OkStatus(), deadlines.SetDeadline(call, Time(milliseconds(1000))));
+
+  deadlines.ExpireCalls(Time(milliseconds(1000)));
+
+  EXPECT_EQ(1u, call.responses());
+  EXPECT_EQ(PacketType::SERVER_ERROR, call.last_type());
+  EXPECT_EQ(Status::DeadlineExceeded(), call.last_status());
+  EXPECT_FALSE(call.active());
+  EXPECT_EQ(0u, context.client().active_calls());
+  EXPECT_EQ(1u, deadlines.timed_out_calls());
+}
+
+TEST(ClientDeadlines, DoesNotExpireEarly) {
+  ClientContextForTest context;
+  ClientDeadlinesBuffer<2> deadlines(context.client());
+
+  TestClientCall call(
+      &context.channel(), context.kServiceId, context.kMethodId);
+  ASSERT_EQ(OkStatus(), deadlines.SetDeadline(call, Time(milliseconds(1001))));
+
+  deadlines.ExpireCalls(Time(milliseconds(1000)));
+  EXPECT_FALSE(call.invoked());
+  EXPECT_TRUE(call.active());
+
+  // Deadlines are rounded up to the deadline resolution.
+  const milliseconds resolution(cfg::kClientDeadlineResolutionMs);
+  deadlines.ExpireCalls(Time(milliseconds(1000) + resolution));
+  EXPECT_EQ(Status::DeadlineExceeded(), call.last_status());
+}
+
+TEST(ClientDeadlines, ExpiresAfterManyRevolutions) {
+  ClientContextForTest context;
+  ClientDeadlinesBuffer<2> deadlines(context.client());
+
+  TestClientCall call(
+      &context.channel(), context.kServiceId, context.kMethodId);
+  ASSERT_EQ(OkStatus(), deadlines.SetDeadline(call, Time(milliseconds(5000))));
+
+  deadlines.ExpireCalls(Time(milliseconds(10)));
+  deadlines.ExpireCalls(Time(milliseconds(4990)));
+  EXPECT_FALSE(call.invoked());
+
+  deadlines.ExpireCalls(Time(milliseconds(60000)));
+  EXPECT_EQ(Status::DeadlineExceeded(), call.last_status());
+}
+
+TEST(ClientDeadlines, CancelledWhenStreamEnds) {
+  ClientContextForTest context;
+  ClientDeadlinesBuffer<2> deadlines(context.client());
+
+  TestClientCall call(
+      &context.channel(), context.kServiceId, context.kMethodId);
+  ASSERT_EQ(OkStatus(), deadlines.SetDeadline(call, Time(milliseconds(1000))));
+  ASSERT_EQ(OkStatus(), context.SendPacket(PacketType::SERVER_STREAM_END));
+
+  deadlines.ExpireCalls(Time(milliseconds(2000)));
+
+  EXPECT_EQ(1u, call.responses());
+  EXPECT_EQ(PacketType::SERVER_STREAM_END, call.last_type());
+  EXPECT_EQ(0u, deadlines.timed_out_calls());
+}
+
+TEST(ClientDeadlines, CancelledWhenCallDestroyed) {
+  ClientContextForTest context;
+  ClientDeadlinesBuffer<2> deadlines(context.client());
+
+  {
+    TestClientCall call(
+        &context.channel(), context.kServiceId, context.kMethodId);
+    ASSERT_EQ(OkStatus(),
+              deadlines.SetDeadline(call, Time(milliseconds(1000))));
+  }
+
+  deadlines.ExpireCalls(Time(milliseconds(2000)));
+  EXPECT_EQ(0u, deadlines.timed_out_calls());
+}
+
+TEST(ClientDeadlines, EarlierTimeDoesNotMoveBack) {
+  ClientContextForTest context;
+  ClientDeadlinesBuffer<2> deadlines(context.client());
+
+  TestClientCall call(
+      &context.channel(), context.kServiceId, context.kMethodId);
+  deadlines.ExpireCalls(Time(milliseconds(2000)));
+  ASSERT_EQ(OkStatus(), deadlines.SetDeadline(call, Time(milliseconds(1000))));
+
+  // A deadline that already passed expires at the next check, even if the time
+  // given is earlier than the previous check.
+  deadlines.ExpireCalls(Time(milliseconds(500)));
+  EXPECT_EQ(Status::DeadlineExceeded(), call.last_status());
+  EXPECT_EQ(1u, deadlines.timed_out_calls());
+}
+
+TEST(ClientDeadlines, InactiveCall_FailedPrecondition) {
+  ClientContextForTest context;
+  ClientDeadlinesBuffer<2> deadlines(context.client());
+
+  TestClientCall call(
+      &context.channel(), context.kServiceId, context.kMethodId);
+  deadlines.ExpireCalls(Time(milliseconds(0)));
+  ASSERT_EQ(OkStatus(), deadlines.SetDeadline(call, Time(milliseconds(10))));
+  deadlines.ExpireCalls(Time(milliseconds(10)));
+
+  EXPECT_EQ(Status::FailedPrecondition(),
+            deadlines.SetDeadline(call, Time(milliseconds(1000))));
+}
+
+TEST(ClientDeadlines, Full_ResourceExhausted) {
+  ClientContextForTest context;
+  ClientDeadlinesBuffer<1> deadlines(context.client());
+
+  TestClientCall call(&context.channel(), context.kServiceId, 1);
+  TestClientCall other_call(&context.channel(), context.kServiceId, 2);
+  ASSERT_EQ(OkStatus(), deadlines.SetDeadline(call, Time(milliseconds(1000))));
+
+  EXPECT_EQ(Status::ResourceExhausted(),
+            deadlines.SetDeadline(other_call, Time(milliseconds(1000))));
+
+  // Setting a new deadline for the same call reuses its entry.
+  EXPECT_EQ(OkStatus(), deadlines.SetDeadline(call, Time(milliseconds(2000))));
+  deadlines.ExpireCalls(Time(milliseconds(1000)));
+  EXPECT_FALSE(call.invoked());
+}
+
+TEST(ClientDeadlines, Full_EntryFreedWhenCallEnds) {
+  ClientContextForTest context;
+  ClientDeadlinesBuffer<1> deadlines(context.client());
+
+  TestClientCall other_call(&context.channel(), context.kServiceId, 2);
+  {
+    TestClientCall call(&context.channel(), context.kServiceId, 1);
+    ASSERT_EQ(OkStatus(),
+              deadlines.SetDeadline(call, Time(milliseconds(1000))));
+  }
+
+  EXPECT_EQ(OkStatus(),
+            deadlines.SetDeadline(other_call, Time(milliseconds(1000))));
+  deadlines.ExpireCalls(Time(milliseconds(1000)));
+  EXPECT_EQ(Status::DeadlineExceeded(), other_call.last_status());
+  EXPECT_EQ(1u, deadlines.timed_out_calls());
+}
+
+}  // namespace
+}  // namespace pw::rpc
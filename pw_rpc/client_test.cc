@@ -14,6 +14,9 @@
 
 #include "pw_rpc/client.h"
 
+#include <cstring>
+#include <optional>
+
 #include "gtest/gtest.h"
 #include "pw_rpc/internal/packet.h"
 #include "pw_rpc_private/internal_test_utils.h"
@@ -36,12 +39,33 @@ class TestClientCall : public BaseClientCall {
     static_cast<TestClientCall&>(call).HandlePacket(packet);
   }
 
-  void HandlePacket(const Packet&) { invoked_ = true; }
+  void HandlePacket(const Packet& packet) {
+    invoked_ = true;
+    responses_ += 1;
+    last_type_ = packet.type();
+    last_status_ = packet.status();
+    last_payload_size_ = packet.payload().size();
+    if (!packet.payload().empty()) {
+      last_payload_first_byte_ = packet.payload()[0];
+    }
+  }
 
   constexpr bool invoked() const { return invoked_; }
+  constexpr size_t responses() const { return responses_; }
+  constexpr PacketType last_type() const { return last_type_; }
+  constexpr Status last_status() const { return last_status_; }
+  constexpr size_t last_payload_size() const { return last_payload_size_; }
+  constexpr std::byte last_payload_first_byte() const {
+    return last_payload_first_byte_;
+  }
 
  private:
   bool invoked_ = false;
+  size_t responses_ = 0;
+  PacketType last_type_ = {};
+  Status last_status_;
+  size_t last_payload_size_ = 0;
+  std::byte last_payload_first_byte_ = {};
 };
 
 TEST(Client, ProcessPacket_InvokesARegisteredClientCall) {
@@ -54,6 +78,45 @@ TEST(Client, ProcessPacket_InvokesARegisteredClientCall) {
   EXPECT_TRUE(call.invoked());
 }
 
+TEST(Client, ProcessPacket_PassesEachBatchedResponseToTheCall) {
+  ClientContextForTest context;
+
+  TestClientCall call(
+      &context.channel(), context.kServiceId, context.kMethodId);
+
+  constexpr std::byte batch[] = {std::byte{0x0a},
+                                 std::byte{1},
+                                 std::byte{0x42},
+                                 std::byte{0x0a},
+                                 std::byte{2},
+                                 std::byte{0x43},
+                                 std::byte{0x44}};
+  EXPECT_EQ(context.SendPacket(PacketType::RESPONSE_BATCH, OkStatus(), batch),
+            OkStatus());
+
+  EXPECT_EQ(call.responses(), 2u);
+  EXPECT_EQ(call.last_payload_size(), 2u);
+  EXPECT_EQ(call.last_payload_first_byte(), std::byte{0x43});
+}
+
+TEST(Client, ProcessPacket_ReturnsDataLossOnBadBatch) {
+  ClientContextForTest context;
+
+  TestClientCall call(
+      &context.channel(), context.kServiceId, context.kMethodId);
+
+  // The second payload is truncated.
+  constexpr std::byte batch[] = {std::byte{0x0a},
+                                 std::byte{1},
+                                 std::byte{0x42},
+                                 std::byte{0x0a},
+                                 std::byte{2},
+                                 std::byte{0x43}};
+  EXPECT_EQ(context.SendPacket(PacketType::RESPONSE_BATCH, OkStatus(), batch),
+            Status::DataLoss());
+  EXPECT_EQ(call.responses(), 1u);
+}
+
 TEST(Client, ProcessPacket_SendsClientErrorOnUnregisteredCall) {
   ClientContextForTest context;
 
@@ -84,5 +147,87 @@ TEST(Client, ProcessPacket_ReturnsInvalidArgumentOnServerPacket) {
             Status::InvalidArgument());
 }
 
+Status SendResponseForMethod(ClientContextForTest<>& context,
+                             uint32_t method_id) {
+  Packet packet(PacketType::RESPONSE,
+                context.kChannelId,
+                context.kServiceId,
+                method_id);
+  std::byte buffer[64];
+  Result encoded = packet.Encode(buffer);
+  EXPECT_EQ(OkStatus(), encoded.status());
+  return context.client().ProcessPacket(encoded.value_or(ConstByteSpan()));
+}
+
+// More calls than fit in the call table, so some are found by scanning.
+constexpr uint32_t kManyCalls = 3 * cfg::kClientCallTableSize + 1;
+
+TEST(Client, ProcessPacket_FindsEachOfManyCalls) {
+  ClientContextForTest context;
+  std::optional<TestClientCall> calls[kManyCalls];
+
+  for (uint32_t i = 0; i < kManyCalls; ++i) {
+    calls[i].emplace(&context.channel(), context.kServiceId, i + 1);
+  }
+  EXPECT_EQ(kManyCalls, context.client().active_calls());
+
+  for (uint32_t i = 0; i < kManyCalls; ++i) {
+    ASSERT_EQ(OkStatus(), SendResponseForMethod(context, i + 1));
+    EXPECT_EQ(1u, calls[i]->responses());
+  }
+}
+
+TEST(Client, ProcessPacket_FindsRemainingCallsAfterRemovals) {
+  ClientContextForTest context;
+  std::optional<TestClientCall> calls[kManyCalls];
+
+  for (uint32_t i = 0; i < kManyCalls; ++i) {
+    calls[i].emplace(&context.channel(), context.kServiceId, i + 1);
+  }
+  for (uint32_t i = 0; i < kManyCalls; i += 2) {
+    calls[i].reset();
+  }
+  EXPECT_EQ(kManyCalls / 2, context.client().active_calls());
+
+  for (uint32_t i = 0; i < kManyCalls; ++i) {
+    if (calls[i].has_value()) {
+      ASSERT_EQ(OkStatus(), SendResponseForMethod(context, i + 1));
+      EXPECT_EQ(1u, calls[i]->responses());
+    } else {
+      EXPECT_EQ(Status::NotFound(), SendResponseForMethod(context, i + 1));
+    }
+  }
+
+  // Freed table entries are reused.
+  for (uint32_t i = 0; i < kManyCalls; i += 2) {
+    calls[i].emplace(&context.channel(), context.kServiceId, i + 1);
+  }
+  EXPECT_EQ(kManyCalls, context.client().active_calls());
+  for (uint32_t i = 0; i < kManyCalls; i += 2) {
+    ASSERT_EQ(OkStatus(), SendResponseForMethod(context, i + 1));
+    EXPECT_EQ(1u, calls[i]->responses());
+  }
+}
+
+TEST(Client, GrantCredits_SendsStreamCreditPacket) {
+  ClientContextForTest context;
+
+  TestClientCall call(
+      &context.channel(), context.kServiceId, context.kMethodId);
+  EXPECT_EQ(call.GrantCredits(300), OkStatus());
+
+  ASSERT_EQ(context.output().packet_count(), 1u);
+  const Packet& packet = context.output().sent_packet();
+  EXPECT_EQ(packet.type(), PacketType::STREAM_CREDIT);
+  EXPECT_EQ(packet.service_id(), context.kServiceId);
+  EXPECT_EQ(packet.method_id(), context.kMethodId);
+
+  constexpr std::byte expected[] = {
+      std::byte{0x08}, std::byte{0xac}, std::byte{0x02}};
+  ASSERT_EQ(packet.payload().size(), sizeof(expected));
+  EXPECT_EQ(std::memcmp(packet.payload().data(), expected, sizeof(expected)),
+            0);
+}
+
 }  // namespace
 }  // namespace pw::rpc
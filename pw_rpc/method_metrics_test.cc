@@ -0,0 +1,262 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/method_metrics.h"
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <ratio>
+
+#include "gtest/gtest.h"
+
+namespace pw::rpc {
+namespace {
+
+using metric::Token;
+
+constexpr uint32_t kServiceId = 16;
+constexpr uint32_t kMethodId = 111;
+constexpr uint32_t kOtherMethodId = 222;
+
+constexpr Token kCalls = PW_TOKENIZE_STRING_DOMAIN("metrics", "calls");
+constexpr Token kErrors = PW_TOKENIZE_STRING_DOMAIN("metrics", "errors");
+constexpr Token kBytesIn = PW_TOKENIZE_STRING_DOMAIN("metrics", "bytes_in");
+constexpr Token kBytesOut = PW_TOKENIZE_STRING_DOMAIN("metrics", "bytes_out");
+constexpr Token kHandlerUs = PW_TOKENIZE_STRING_DOMAIN("metrics", "handler_us");
+constexpr Token kUnder100us =
+    PW_TOKENIZE_STRING_DOMAIN("metrics", "handler_under_100us");
+constexpr Token kUnder1ms =
+    PW_TOKENIZE_STRING_DOMAIN("metrics", "handler_under_1ms");
+constexpr Token kUnder10ms =
+    PW_TOKENIZE_STRING_DOMAIN("metrics", "handler_under_10ms");
+constexpr Token kUnder100ms =
+    PW_TOKENIZE_STRING_DOMAIN("metrics", "handler_under_100ms");
+constexpr Token kOver100ms =
+    PW_TOKENIZE_STRING_DOMAIN("metrics", "handler_over_100ms");
+constexpr Token kUntrackedCalls =
+    PW_TOKENIZE_STRING_DOMAIN("metrics", "untracked_calls");
+
+// Bucket boundaries are in microseconds, so they can only be tested exactly
+// with a system clock that has at least microsecond resolution.
+constexpr bool kMicrosecondClock =
+    std::ratio_less_equal_v<chrono::SystemClock::period, std::micro>;
+
+chrono::SystemClock::duration Microseconds(int64_t us) {
+  return std::chrono::duration_cast<chrono::SystemClock::duration>(
+      std::chrono::microseconds(us));
+}
+
+// Clock that only advances when told to, so handler durations are exact.
+class TestClock : public chrono::VirtualSystemClock {
+ public:
+  chrono::SystemClock::time_point now() override { return now_; }
+
+  void Advance(chrono::SystemClock::duration duration) { now_ += duration; }
+
+ private:
+  chrono::SystemClock::time_point now_;
+};
+
+// Reports a call to a method whose handler runs for the given time.
+template <size_t kMaxMethods>
+void CallMethod(MethodMetrics<kMaxMethods>& metrics,
+                TestClock& clock,
+                uint32_t method_id,
+                chrono::SystemClock::duration handler_time) {
+  metrics.RequestReceived(kServiceId, method_id, 0);
+  clock.Advance(handler_time);
+  metrics.HandlerReturned(kServiceId, method_id);
+}
+
+// Returns the group of metrics for a method, which is named by its ID.
+const metric::Group* FindMethod(const metric::Group& methods,
+                                uint32_t method_id) {
+  for (const metric::Group& group : methods.children()) {
+    if (group.name() == method_id) {
+      return &group;
+    }
+  }
+  return nullptr;
+}
+
+// Returns the value of the metric with the given name, or fails the test if
+// there is no such metric.
+uint32_t Value(const metric::Group& group, Token name) {
+  for (const metric::Metric& metric : group.metrics()) {
+    // Metric names are stored without the token's top bit.
+    if (metric.name() == (name & 0x7fffffff)) {
+      return metric.as_int();
+    }
+  }
+  ADD_FAILURE();
+  return 0;
+}
+
+TEST(MethodMetrics, NoCalls_NoMethodGroups) {
+  MethodMetrics<2> metrics;
+
+  EXPECT_TRUE(metrics.metrics().children().empty());
+  EXPECT_EQ(Value(metrics.metrics(), kUntrackedCalls), 0u);
+}
+
+TEST(MethodMetrics, RequestReceived_CountsCallsAndBytes) {
+  MethodMetrics<2> metrics;
+
+  metrics.RequestReceived(kServiceId, kMethodId, 10);
+  metrics.RequestReceived(kServiceId, kMethodId, 32);
+
+  const metric::Group* method = FindMethod(metrics.metrics(), kMethodId);
+  ASSERT_NE(method, nullptr);
+  EXPECT_EQ(Value(*method, kCalls), 2u);
+  EXPECT_EQ(Value(*method, kBytesIn), 42u);
+  EXPECT_EQ(Value(*method, kBytesOut), 0u);
+  EXPECT_EQ(Value(*method, kErrors), 0u);
+}
+
+TEST(MethodMetrics, ResponseSent_CountsBytesAndErrors) {
+  MethodMetrics<2> metrics;
+  metrics.RequestReceived(kServiceId, kMethodId, 0);
+
+  metrics.ResponseSent(kServiceId, kMethodId, 5, OkStatus());
+  metrics.ResponseSent(kServiceId, kMethodId, 7, OkStatus());
+  metrics.ResponseSent(kServiceId, kMethodId, 0, Status::NotFound());
+  metrics.ResponseSent(kServiceId, kMethodId, 0, Status::Cancelled());
+
+  const metric::Group* method = FindMethod(metrics.metrics(), kMethodId);
+  ASSERT_NE(method, nullptr);
+  EXPECT_EQ(Value(*method, kBytesOut), 12u);
+  EXPECT_EQ(Value(*method, kErrors), 2u);
+  EXPECT_EQ(Value(*method, kCalls), 1u);
+}
+
+TEST(MethodMetrics, MethodsAreTrackedSeparately) {
+  MethodMetrics<2> metrics;
+
+  metrics.RequestReceived(kServiceId, kMethodId, 1);
+  metrics.RequestReceived(kServiceId, kOtherMethodId, 2);
+  metrics.RequestReceived(kServiceId, kOtherMethodId, 3);
+  metrics.ResponseSent(kServiceId, kOtherMethodId, 0, Status::Internal());
+
+  const metric::Group* method = FindMethod(metrics.metrics(), kMethodId);
+  const metric::Group* other = FindMethod(metrics.metrics(), kOtherMethodId);
+  ASSERT_NE(method, nullptr);
+  ASSERT_NE(other, nullptr);
+
+  EXPECT_EQ(Value(*method, kCalls), 1u);
+  EXPECT_EQ(Value(*method, kBytesIn), 1u);
+  EXPECT_EQ(Value(*method, kErrors), 0u);
+  EXPECT_EQ(Value(*other, kCalls), 2u);
+  EXPECT_EQ(Value(*other, kBytesIn), 5u);
+  EXPECT_EQ(Value(*other, kErrors), 1u);
+}
+
+TEST(MethodMetrics, HandlerReturned_SumsDurations) {
+  TestClock clock;
+  MethodMetrics<1> metrics(clock);
+
+  CallMethod(metrics, clock, kMethodId, Microseconds(2'000));
+  clock.Advance(Microseconds(7'000));  // Time between calls is not counted.
+  CallMethod(metrics, clock, kMethodId, Microseconds(500'000));
+
+  const metric::Group* method = FindMethod(metrics.metrics(), kMethodId);
+  ASSERT_NE(method, nullptr);
+  EXPECT_EQ(Value(*method, kHandlerUs), 502'000u);
+  EXPECT_EQ(Value(*method, kUnder10ms), 1u);
+  EXPECT_EQ(Value(*method, kOver100ms), 1u);
+}
+
+TEST(MethodMetrics, HandlerReturned_BucketBoundaries) {
+  if constexpr (!kMicrosecondClock) {
+    return;
+  }
+
+  TestClock clock;
+  MethodMetrics<1> metrics(clock);
+
+  // Each bucket's upper bound is exclusive.
+  for (int64_t us : {0, 99, 100, 999, 1'000, 9'999, 10'000, 99'999, 100'000}) {
+    CallMethod(metrics, clock, kMethodId, Microseconds(us));
+  }
+
+  const metric::Group* method = FindMethod(metrics.metrics(), kMethodId);
+  ASSERT_NE(method, nullptr);
+  EXPECT_EQ(Value(*method, kUnder100us), 2u);
+  EXPECT_EQ(Value(*method, kUnder1ms), 2u);
+  EXPECT_EQ(Value(*method, kUnder10ms), 2u);
+  EXPECT_EQ(Value(*method, kUnder100ms), 2u);
+  EXPECT_EQ(Value(*method, kOver100ms), 1u);
+  EXPECT_EQ(Value(*method, kHandlerUs), 222'196u);
+}
+
+TEST(MethodMetrics, HandlerReturned_NegativeDurationCountsAsZero) {
+  TestClock clock;
+  MethodMetrics<1> metrics(clock);
+
+  CallMethod(metrics, clock, kMethodId, Microseconds(-5'000));
+
+  const metric::Group* method = FindMethod(metrics.metrics(), kMethodId);
+  ASSERT_NE(method, nullptr);
+  EXPECT_EQ(Value(*method, kHandlerUs), 0u);
+  EXPECT_EQ(Value(*method, kUnder100us), 1u);
+}
+
+TEST(MethodMetrics, LargeValues_Saturate) {
+  TestClock clock;
+  MethodMetrics<1> metrics(clock);
+
+  // About 5000 seconds, which is more microseconds than fit in 32 bits.
+  CallMethod(metrics, clock, kMethodId, Microseconds(5'000'000'000));
+
+  const metric::Group* method = FindMethod(metrics.metrics(), kMethodId);
+  ASSERT_NE(method, nullptr);
+  EXPECT_EQ(Value(*method, kHandlerUs), std::numeric_limits<uint32_t>::max());
+  EXPECT_EQ(Value(*method, kOver100ms), 1u);
+}
+
+TEST(MethodMetrics, TableFull_CountsUntrackedCalls) {
+  MethodMetrics<1> metrics;
+
+  metrics.RequestReceived(kServiceId, kMethodId, 1);
+  metrics.RequestReceived(kServiceId, kOtherMethodId, 2);
+  metrics.RequestReceived(kServiceId, kOtherMethodId, 3);
+  metrics.RequestReceived(kServiceId + 1, kMethodId, 4);
+
+  EXPECT_EQ(Value(metrics.metrics(), kUntrackedCalls), 3u);
+  EXPECT_EQ(FindMethod(metrics.metrics(), kOtherMethodId), nullptr);
+
+  const metric::Group* method = FindMethod(metrics.metrics(), kMethodId);
+  ASSERT_NE(method, nullptr);
+  EXPECT_EQ(Value(*method, kCalls), 1u);
+  EXPECT_EQ(Value(*method, kBytesIn), 1u);
+}
+
+TEST(MethodMetrics, TableFull_IgnoresEventsForUntrackedMethods) {
+  TestClock clock;
+  MethodMetrics<1> metrics(clock);
+  metrics.RequestReceived(kServiceId, kMethodId, 0);
+
+  CallMethod(metrics, clock, kOtherMethodId, Microseconds(50));
+  metrics.ResponseSent(kServiceId, kOtherMethodId, 9, Status::Internal());
+
+  const metric::Group* method = FindMethod(metrics.metrics(), kMethodId);
+  ASSERT_NE(method, nullptr);
+  EXPECT_EQ(Value(*method, kHandlerUs), 0u);
+  EXPECT_EQ(Value(*method, kUnder100us), 0u);
+  EXPECT_EQ(Value(*method, kBytesOut), 0u);
+  EXPECT_EQ(Value(*method, kErrors), 0u);
+}
+
+}  // namespace
+}  // namespace pw::rpc
@@ -41,6 +41,25 @@ class TestService final : public generated::TestService<TestService> {
 
     writer.Finish(static_cast<Status::Code>(request.status_code));
   }
+
+  void TestClientStreamRpc(
+      ServerContext&,
+      ServerReader<pw_rpc_test_TestRequest, pw_rpc_test_TestStreamResponse>&
+          reader) {
+    last_reader = std::move(reader);
+  }
+
+  void TestBidirectionalStreamRpc(
+      ServerContext&,
+      ServerReaderWriter<pw_rpc_test_TestRequest,
+                         pw_rpc_test_TestStreamResponse>& reader_writer) {
+    last_reader_writer = std::move(reader_writer);
+  }
+
+  ServerReader<pw_rpc_test_TestRequest, pw_rpc_test_TestStreamResponse>
+      last_reader;
+  ServerReaderWriter<pw_rpc_test_TestRequest, pw_rpc_test_TestStreamResponse>
+      last_reader_writer;
 };
 
 }  // namespace test
@@ -187,5 +206,39 @@ TEST(NanopbCodegen, Client_InvokesServerStreamingRpcWithCallback) {
   EXPECT_EQ(handler.status(), Status::NotFound());
 }
 
+TEST(NanopbCodegen, Client_InvokesClientStreamingRpcWithCallback) {
+  constexpr uint32_t service_id = internal::Hash("pw.rpc.test.TestService");
+  constexpr uint32_t method_id = internal::Hash("TestClientStreamRpc");
+
+  ClientContextForTest<128, 128, 99, service_id, method_id> context;
+  TestUnaryResponseHandler<pw_rpc_test_TestStreamResponse> handler;
+
+  auto call =
+      TestServiceClient::TestClientStreamRpc(context.channel(), handler);
+  EXPECT_EQ(context.output().packet_count(), 1u);
+  EXPECT_EQ(context.output().sent_packet().type(),
+            internal::PacketType::REQUEST);
+  EXPECT_TRUE(context.output().sent_packet().payload().empty());
+
+  pw_rpc_test_TestRequest request{.integer = 5, .status_code = 0};
+  EXPECT_EQ(OkStatus(), call.SendClientStreamRequest(&request));
+  auto packet = context.output().sent_packet();
+  EXPECT_EQ(packet.type(), internal::PacketType::CLIENT_STREAM);
+  EXPECT_EQ(packet.method_id(), method_id);
+  PW_DECODE_PB(pw_rpc_test_TestRequest, sent_proto, packet.payload());
+  EXPECT_EQ(sent_proto.integer, 5);
+
+  EXPECT_EQ(OkStatus(), call.CloseClientStream());
+  EXPECT_EQ(context.output().sent_packet().type(),
+            internal::PacketType::CLIENT_STREAM_END);
+
+  PW_ENCODE_PB(
+      pw_rpc_test_TestStreamResponse, response, .chunk = {}, .number = 3u);
+  context.SendResponse(Status::Unauthenticated(), response);
+  ASSERT_EQ(handler.responses_received(), 1u);
+  EXPECT_EQ(handler.last_status(), Status::Unauthenticated());
+  EXPECT_EQ(handler.last_response().number, 3u);
+}
+
 }  // namespace
 }  // namespace pw::rpc
@@ -32,6 +32,13 @@ class MixedService1 : public test::generated::TestService<MixedService1> {
     called_streaming_method = true;
   }
 
+  void TestClientStreamRpc(ServerContext&, RawServerReader&) {}
+
+  void TestBidirectionalStreamRpc(
+      ServerContext&,
+      ServerReaderWriter<pw_rpc_test_TestRequest,
+                         pw_rpc_test_TestStreamResponse>&) {}
+
   bool called_streaming_method = false;
 };
 
@@ -47,6 +54,13 @@ class MixedService2 : public test::generated::TestService<MixedService2> {
     called_streaming_method = true;
   }
 
+  void TestClientStreamRpc(
+      ServerContext&,
+      ServerReader<pw_rpc_test_TestRequest, pw_rpc_test_TestStreamResponse>&) {
+  }
+
+  void TestBidirectionalStreamRpc(ServerContext&, RawServerReaderWriter&) {}
+
   bool called_streaming_method = false;
 };
 
@@ -18,15 +18,25 @@ namespace pw::rpc {
 namespace internal {
 
 Status BaseNanopbClientCall::SendRequest(const void* request_struct) {
+  return EncodeAndSend(request_struct, PacketType::REQUEST);
+}
+
+Status BaseNanopbClientCall::SendClientStreamRequest(
+    const void* request_struct) {
+  return EncodeAndSend(request_struct, PacketType::CLIENT_STREAM);
+}
+
+Status BaseNanopbClientCall::EncodeAndSend(const void* request_struct,
+                                           PacketType type) {
   std::span<std::byte> buffer = AcquirePayloadBuffer();
 
   StatusWithSize sws = serde_.EncodeRequest(buffer, request_struct);
   if (!sws.ok()) {
-    ReleasePayloadBuffer({});
+    ReleasePayloadBuffer({}, type);
     return sws.status();
   }
 
-  return ReleasePayloadBuffer(buffer.first(sws.size()));
+  return ReleasePayloadBuffer(buffer.first(sws.size()), type);
 }
 
 }  // namespace internal
@@ -18,6 +18,7 @@
 #include "pb_encode.h"
 #include "pw_log/log.h"
 #include "pw_rpc/internal/packet.h"
+#include "pw_rpc/internal/server.h"
 
 namespace pw::rpc::internal {
 
@@ -27,18 +28,18 @@ void NanopbMethod::CallUnary(ServerCall& call,
                              const Packet& request,
                              void* request_struct,
                              void* response_struct) const {
-  if (!DecodeRequest(call.channel(), request, request_struct)) {
+  if (!DecodeRequest(call, request, request_struct)) {
     return;
   }
 
   const Status status = function_.unary(call, request_struct, response_struct);
-  SendResponse(call.channel(), request, response_struct, status);
+  SendResponse(call, request, response_struct, status);
 }
 
 void NanopbMethod::CallServerStreaming(ServerCall& call,
                                        const Packet& request,
                                        void* request_struct) const {
-  if (!DecodeRequest(call.channel(), request, request_struct)) {
+  if (!DecodeRequest(call, request, request_struct)) {
     return;
   }
 
@@ -46,7 +47,34 @@ void NanopbMethod::CallServerStreaming(ServerCall& call,
   function_.server_streaming(call, request_struct, server_writer);
 }
 
-bool NanopbMethod::DecodeRequest(Channel& channel,
+void NanopbMethod::CallUnaryDecoder(ServerCall& call,
+                                    const Packet& request,
+                                    void* response_struct) const {
+  protobuf::Decoder decoder(request.payload());
+  const Status status =
+      function_.unary_decoder(call, decoder, response_struct);
+  SendResponse(call, request, response_struct, status);
+}
+
+void NanopbMethod::CallServerStreamingDecoder(ServerCall& call,
+                                              const Packet& request) const {
+  protobuf::Decoder decoder(request.payload());
+  internal::BaseServerWriter server_writer(call);
+  function_.server_streaming_decoder(call, decoder, server_writer);
+}
+
+void NanopbMethod::CallClientStreaming(ServerCall& call) const {
+  internal::BaseServerWriter reader(call, MethodType::kClientStreaming);
+  function_.client_streaming(call, reader);
+}
+
+void NanopbMethod::CallBidirectionalStreaming(ServerCall& call) const {
+  internal::BaseServerWriter reader_writer(
+      call, MethodType::kBidirectionalStreaming);
+  function_.bidirectional_streaming(call, reader_writer);
+}
+
+bool NanopbMethod::DecodeRequest(ServerCall& call,
                                  const Packet& request,
                                  void* proto_struct) const {
   if (serde_.DecodeRequest(proto_struct, request.payload())) {
@@ -54,16 +82,19 @@ bool NanopbMethod::DecodeRequest(Channel& channel,
   }
 
   PW_LOG_WARN("Failed to decode request payload from channel %u",
-              unsigned(channel.id()));
-  channel.Send(Packet::ServerError(request, Status::DataLoss()));
+              unsigned(call.channel().id()));
+  const Packet error = Packet::ServerError(request, Status::DataLoss());
+  if (call.channel().Send(error).ok()) {
+    call.server().PacketSent(error);
+  }
   return false;
 }
 
-void NanopbMethod::SendResponse(Channel& channel,
+void NanopbMethod::SendResponse(ServerCall& call,
                                 const Packet& request,
                                 const void* response_struct,
                                 Status status) const {
-  Channel::OutputBuffer response_buffer = channel.AcquireBuffer();
+  Channel::OutputBuffer response_buffer = call.channel().AcquireBuffer();
   std::span payload_buffer = response_buffer.payload(request);
 
   StatusWithSize encoded = EncodeResponse(response_struct, payload_buffer);
@@ -73,18 +104,21 @@ void NanopbMethod::SendResponse(Channel& channel,
 
     response.set_payload(payload_buffer.first(encoded.size()));
     response.set_status(status);
-    if (channel.Send(response_buffer, response).ok()) {
+    if (call.channel().Send(response_buffer, response).ok()) {
+      call.server().PacketSent(response);
       return;
     }
 
     // Re-acquire the buffer to encode an error packet.
-    response_buffer = channel.AcquireBuffer();
+    response_buffer = call.channel().AcquireBuffer();
   }
 
   PW_LOG_WARN("Failed to encode response packet for channel %u",
-              unsigned(channel.id()));
-  channel.Send(response_buffer,
-               Packet::ServerError(request, Status::Internal()));
+              unsigned(call.channel().id()));
+  const Packet error = Packet::ServerError(request, Status::Internal());
+  if (call.channel().Send(response_buffer, error).ok()) {
+    call.server().PacketSent(error);
+  }
 }
 
 }  // namespace pw::rpc::internal
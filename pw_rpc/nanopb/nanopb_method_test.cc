@@ -89,17 +89,84 @@ void StartStream(ServerContext&,
   last_writer = std::move(writer);
 }
 
+int64_t last_decoded_integer;
+
+Status AddFiveWithDecoder(ServerContext&,
+                          protobuf::Decoder& request,
+                          pw_rpc_test_TestResponse& response) {
+  Status status;
+  while ((status = request.Next()).ok()) {
+    if (request.FieldNumber() == 1u &&
+        !request.ReadInt64(&last_decoded_integer).ok()) {
+      return Status::DataLoss();
+    }
+  }
+  if (!status.IsOutOfRange()) {
+    return Status::DataLoss();
+  }
+  response.value = last_decoded_integer + 5;
+  return Status::Unauthenticated();
+}
+
+void StartStreamWithDecoder(ServerContext&,
+                            protobuf::Decoder& request,
+                            ServerWriter<pw_rpc_test_TestResponse>& writer) {
+  while (request.Next().ok()) {
+    if (request.FieldNumber() == 1u) {
+      request.ReadInt64(&last_decoded_integer);
+    }
+  }
+  last_writer = std::move(writer);
+}
+
+ServerReader<pw_rpc_test_TestRequest, pw_rpc_test_TestResponse> last_reader;
+ServerReaderWriter<pw_rpc_test_TestRequest, pw_rpc_test_TestResponse>
+    last_reader_writer;
+
+void StartClientStream(
+    ServerContext&,
+    ServerReader<pw_rpc_test_TestRequest, pw_rpc_test_TestResponse>& reader) {
+  last_reader = std::move(reader);
+}
+
+void StartBidirectionalStream(
+    ServerContext&,
+    ServerReaderWriter<pw_rpc_test_TestRequest, pw_rpc_test_TestResponse>&
+        reader_writer) {
+  last_reader_writer = std::move(reader_writer);
+}
+
+class TestClientStreamHandler
+    : public ClientStreamHandler<pw_rpc_test_TestRequest> {
+ public:
+  void ReceivedRequest(const pw_rpc_test_TestRequest& request) override {
+    requests += 1;
+    last_integer = request.integer;
+  }
+
+  size_t requests = 0;
+  int64_t last_integer = 0;
+};
+
 class FakeService : public Service {
  public:
   FakeService(uint32_t id) : Service(id, kMethods) {}
 
-  static constexpr std::array<NanopbMethodUnion, 3> kMethods = {
+  static constexpr std::array<NanopbMethodUnion, 7> kMethods = {
       NanopbMethod::Unary<DoNothing>(
           10u, pw_rpc_test_Empty_fields, pw_rpc_test_Empty_fields),
       NanopbMethod::Unary<AddFive>(
           11u, pw_rpc_test_TestRequest_fields, pw_rpc_test_TestResponse_fields),
       NanopbMethod::ServerStreaming<StartStream>(
           12u, pw_rpc_test_TestRequest_fields, pw_rpc_test_TestResponse_fields),
+      NanopbMethod::Unary<AddFiveWithDecoder>(
+          13u, pw_rpc_test_TestRequest_fields, pw_rpc_test_TestResponse_fields),
+      NanopbMethod::ServerStreaming<StartStreamWithDecoder>(
+          14u, pw_rpc_test_TestRequest_fields, pw_rpc_test_TestResponse_fields),
+      NanopbMethod::ClientStreaming<StartClientStream>(
+          15u, pw_rpc_test_TestRequest_fields, pw_rpc_test_TestResponse_fields),
+      NanopbMethod::BidirectionalStreaming<StartBidirectionalStream>(
+          16u, pw_rpc_test_TestRequest_fields, pw_rpc_test_TestResponse_fields),
   };
 };
 
@@ -234,5 +301,143 @@ TEST(NanopbMethod,
   EXPECT_EQ(Status::Internal(), last_writer.Write({.value = 1}));  // Too big
 }
 
+TEST(NanopbMethod, UnaryRpcWithDecoder_SendsResponse) {
+  PW_ENCODE_PB(
+      pw_rpc_test_TestRequest, request, .integer = 123, .status_code = 0);
+
+  const NanopbMethod& method =
+      std::get<3>(FakeService::kMethods).nanopb_method();
+  ServerContextForTest<FakeService> context(method);
+  method.Invoke(context.get(), context.packet(request));
+
+  const Packet& response = context.output().sent_packet();
+  EXPECT_EQ(response.status(), Status::Unauthenticated());
+
+  PW_ENCODE_PB(pw_rpc_test_TestResponse, expected, .value = 128);
+  ASSERT_EQ(expected.size(), response.payload().size());
+  EXPECT_EQ(0,
+            std::memcmp(
+                expected.data(), response.payload().data(), expected.size()));
+
+  EXPECT_EQ(123, last_decoded_integer);
+}
+
+TEST(NanopbMethod, UnaryRpcWithDecoder_InvalidPayload_ReturnsMethodStatus) {
+  // Field 1 with a truncated varint value.
+  std::array<byte, 2> bad_payload{byte{0x08}, byte{0x80}};
+
+  const NanopbMethod& method =
+      std::get<3>(FakeService::kMethods).nanopb_method();
+  ServerContextForTest<FakeService> context(method);
+  method.Invoke(context.get(), context.packet(bad_payload));
+
+  // The payload is not decoded in advance, so the method reports the error.
+  const Packet& packet = context.output().sent_packet();
+  EXPECT_EQ(PacketType::RESPONSE, packet.type());
+  EXPECT_EQ(Status::DataLoss(), packet.status());
+}
+
+TEST(NanopbMethod, ServerStreamingRpcWithDecoder_SendsResponse) {
+  PW_ENCODE_PB(
+      pw_rpc_test_TestRequest, request, .integer = 555, .status_code = 0);
+
+  const NanopbMethod& method =
+      std::get<4>(FakeService::kMethods).nanopb_method();
+  ServerContextForTest<FakeService> context(method);
+
+  method.Invoke(context.get(), context.packet(request));
+  EXPECT_EQ(0u, context.output().packet_count());
+  EXPECT_EQ(555, last_decoded_integer);
+
+  EXPECT_EQ(OkStatus(), last_writer.Write({.value = 100}));
+  EXPECT_EQ(1u, context.output().packet_count());
+}
+
+TEST(NanopbMethod, ClientStreamingRpc_DecodesRequests) {
+  const NanopbMethod& method =
+      std::get<5>(FakeService::kMethods).nanopb_method();
+  ServerContextForTest<FakeService> context(method);
+  TestClientStreamHandler handler;
+
+  method.Invoke(context.get(), context.packet({}));
+  EXPECT_EQ(0u, context.output().packet_count());
+  last_reader.set_handler(handler);
+
+  PW_ENCODE_PB(
+      pw_rpc_test_TestRequest, request, .integer = 42, .status_code = 0);
+  EXPECT_EQ(OkStatus(), context.SendPacket(PacketType::CLIENT_STREAM, request));
+  EXPECT_EQ(OkStatus(), context.SendPacket(PacketType::CLIENT_STREAM, request));
+
+  EXPECT_EQ(2u, handler.requests);
+  EXPECT_EQ(42, handler.last_integer);
+  EXPECT_EQ(0u, context.output().packet_count());
+}
+
+TEST(NanopbMethod, ServerReader_Finish_SendsResponse) {
+  const NanopbMethod& method =
+      std::get<5>(FakeService::kMethods).nanopb_method();
+  ServerContextForTest<FakeService> context(method);
+
+  method.Invoke(context.get(), context.packet({}));
+
+  EXPECT_EQ(OkStatus(),
+            last_reader.Finish({.value = 7}, Status::Unauthenticated()));
+  EXPECT_FALSE(last_reader.open());
+
+  const Packet& packet = context.output().sent_packet();
+  EXPECT_EQ(PacketType::RESPONSE, packet.type());
+  EXPECT_EQ(Status::Unauthenticated(), packet.status());
+
+  PW_DECODE_PB(pw_rpc_test_TestResponse, response, packet.payload());
+  EXPECT_EQ(7, response.value);
+}
+
+TEST(NanopbMethod, ClientStreamingRpc_InvalidRequest_SendsError) {
+  std::array<byte, 8> bad_payload{byte{0xFF}, byte{0xAA}, byte{0xDD}};
+
+  const NanopbMethod& method =
+      std::get<5>(FakeService::kMethods).nanopb_method();
+  ServerContextForTest<FakeService> context(method);
+  TestClientStreamHandler handler;
+
+  method.Invoke(context.get(), context.packet({}));
+  last_reader.set_handler(handler);
+
+  EXPECT_EQ(OkStatus(),
+            context.SendPacket(PacketType::CLIENT_STREAM, bad_payload));
+
+  const Packet& packet = context.output().sent_packet();
+  EXPECT_EQ(PacketType::SERVER_ERROR, packet.type());
+  EXPECT_EQ(Status::DataLoss(), packet.status());
+  EXPECT_EQ(0u, handler.requests);
+  EXPECT_FALSE(last_reader.open());
+}
+
+TEST(NanopbMethod, BidirectionalStreamingRpc_ReadsAndWrites) {
+  const NanopbMethod& method =
+      std::get<6>(FakeService::kMethods).nanopb_method();
+  ServerContextForTest<FakeService> context(method);
+  TestClientStreamHandler handler;
+
+  method.Invoke(context.get(), context.packet({}));
+  last_reader_writer.set_handler(handler);
+
+  PW_ENCODE_PB(
+      pw_rpc_test_TestRequest, request, .integer = 99, .status_code = 0);
+  EXPECT_EQ(OkStatus(), context.SendPacket(PacketType::CLIENT_STREAM, request));
+  EXPECT_EQ(99, handler.last_integer);
+
+  EXPECT_EQ(OkStatus(), last_reader_writer.Write({.value = 100}));
+  EXPECT_EQ(PacketType::RESPONSE, context.output().sent_packet().type());
+
+  EXPECT_EQ(OkStatus(), context.SendPacket(PacketType::CLIENT_STREAM_END));
+  EXPECT_FALSE(last_reader_writer.client_stream_open());
+
+  last_reader_writer.Finish();
+  EXPECT_EQ(PacketType::SERVER_STREAM_END,
+            context.output().sent_packet().type());
+  EXPECT_EQ(2u, context.output().packet_count());
+}
+
 }  // namespace
 }  // namespace pw::rpc::internal
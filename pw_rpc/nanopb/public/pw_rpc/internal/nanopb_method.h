@@ -19,6 +19,7 @@
 #include <span>
 #include <type_traits>
 
+#include "pw_protobuf/decoder.h"
 #include "pw_rpc/internal/base_server_writer.h"
 #include "pw_rpc/internal/config.h"
 #include "pw_rpc/internal/method.h"
@@ -50,6 +51,67 @@ class ServerWriter : public internal::BaseServerWriter {
   //       codes are determined by the ChannelOutput implementation
   //
   Status Write(const T& response);
+
+ private:
+  // Encodes the response to the payload buffer and releases it.
+  Status EncodeAndRelease(const T& response);
+};
+
+// Receives the requests of a client or bidirectional stream, decoded into
+// Nanopb structs.
+template <typename Request>
+class ClientStreamHandler : public internal::BaseClientStreamHandler {
+ public:
+  // Called with each request in the stream.
+  virtual void ReceivedRequest(const Request& request) = 0;
+
+ private:
+  Status ReceivedPayload(const internal::Method& method,
+                         std::span<const std::byte> payload) final;
+};
+
+// Server side of a Nanopb client streaming RPC. Requests are passed to the
+// handler as they arrive; the RPC ends with a single response.
+template <typename Request, typename Response>
+class ServerReader : public internal::BaseServerWriter {
+ public:
+  constexpr ServerReader() = default;
+
+  ServerReader(ServerReader&&) = default;
+  ServerReader& operator=(ServerReader&&) = default;
+
+  // Sets the handler for the client's requests. The handler must outlive the
+  // ServerReader, or be replaced before it goes out of scope.
+  void set_handler(ClientStreamHandler<Request>& handler) {
+    set_client_stream_handler(&handler);
+  }
+
+  // Sends the response and ends the RPC. Returns the following Status codes:
+  //
+  //   OK - the response was successfully sent
+  //   FAILED_PRECONDITION - the reader is closed
+  //   INTERNAL - pw_rpc was unable to encode the Nanopb protobuf; the reader
+  //       remains open
+  //   other errors - the ChannelOutput failed to send the packet
+  //
+  Status Finish(const Response& response, Status status = OkStatus());
+};
+
+// Server side of a Nanopb bidirectional streaming RPC. Responses are written as
+// with a ServerWriter, and requests are passed to the handler.
+template <typename Request, typename Response>
+class ServerReaderWriter : public ServerWriter<Response> {
+ public:
+  constexpr ServerReaderWriter() = default;
+
+  ServerReaderWriter(ServerReaderWriter&&) = default;
+  ServerReaderWriter& operator=(ServerReaderWriter&&) = default;
+
+  // Sets the handler for the client's requests. The handler must outlive the
+  // ServerReaderWriter, or be replaced before it goes out of scope.
+  void set_handler(ClientStreamHandler<Request>& handler) {
+    this->set_client_stream_handler(&handler);
+  }
 };
 
 namespace internal {
@@ -101,6 +163,98 @@ struct MethodTraits<void (T::*)(
   using Service = T;
 };
 
+// MethodTraits specialization for a static unary method that decodes its
+// request with a pw_protobuf Decoder instead of into a Nanopb struct.
+template <typename ResponseType>
+struct MethodTraits<Status (*)(
+    ServerContext&, protobuf::Decoder&, ResponseType&)> {
+  using Implementation = NanopbMethod;
+  using Request = protobuf::Decoder;
+  using Response = ResponseType;
+
+  static constexpr MethodType kType = MethodType::kUnary;
+  static constexpr bool kServerStreaming = false;
+  static constexpr bool kClientStreaming = false;
+};
+
+// MethodTraits specialization for a unary method that decodes its request with
+// a pw_protobuf Decoder.
+template <typename T, typename ResponseType>
+struct MethodTraits<Status (T::*)(
+    ServerContext&, protobuf::Decoder&, ResponseType&)>
+    : public MethodTraits<Status (*)(
+          ServerContext&, protobuf::Decoder&, ResponseType&)> {
+  using Service = T;
+};
+
+// MethodTraits specialization for a static server streaming method that
+// decodes its request with a pw_protobuf Decoder.
+template <typename ResponseType>
+struct MethodTraits<void (*)(
+    ServerContext&, protobuf::Decoder&, ServerWriter<ResponseType>&)> {
+  using Implementation = NanopbMethod;
+  using Request = protobuf::Decoder;
+  using Response = ResponseType;
+
+  static constexpr MethodType kType = MethodType::kServerStreaming;
+  static constexpr bool kServerStreaming = true;
+  static constexpr bool kClientStreaming = false;
+};
+
+// MethodTraits specialization for a server streaming method that decodes its
+// request with a pw_protobuf Decoder.
+template <typename T, typename ResponseType>
+struct MethodTraits<void (T::*)(
+    ServerContext&, protobuf::Decoder&, ServerWriter<ResponseType>&)>
+    : public MethodTraits<void (*)(
+          ServerContext&, protobuf::Decoder&, ServerWriter<ResponseType>&)> {
+  using Service = T;
+};
+
+// MethodTraits specialization for a static client streaming method.
+template <typename RequestType, typename ResponseType>
+struct MethodTraits<void (*)(ServerContext&,
+                             ServerReader<RequestType, ResponseType>&)> {
+  using Implementation = NanopbMethod;
+  using Request = RequestType;
+  using Response = ResponseType;
+
+  static constexpr MethodType kType = MethodType::kClientStreaming;
+  static constexpr bool kServerStreaming = false;
+  static constexpr bool kClientStreaming = true;
+};
+
+// MethodTraits specialization for a client streaming method.
+template <typename T, typename RequestType, typename ResponseType>
+struct MethodTraits<void (T::*)(ServerContext&,
+                                ServerReader<RequestType, ResponseType>&)>
+    : public MethodTraits<void (*)(ServerContext&,
+                                   ServerReader<RequestType, ResponseType>&)> {
+  using Service = T;
+};
+
+// MethodTraits specialization for a static bidirectional streaming method.
+template <typename RequestType, typename ResponseType>
+struct MethodTraits<void (*)(ServerContext&,
+                             ServerReaderWriter<RequestType, ResponseType>&)> {
+  using Implementation = NanopbMethod;
+  using Request = RequestType;
+  using Response = ResponseType;
+
+  static constexpr MethodType kType = MethodType::kBidirectionalStreaming;
+  static constexpr bool kServerStreaming = true;
+  static constexpr bool kClientStreaming = true;
+};
+
+// MethodTraits specialization for a bidirectional streaming method.
+template <typename T, typename RequestType, typename ResponseType>
+struct MethodTraits<void (T::*)(
+    ServerContext&, ServerReaderWriter<RequestType, ResponseType>&)>
+    : public MethodTraits<void (*)(
+          ServerContext&, ServerReaderWriter<RequestType, ResponseType>&)> {
+  using Service = T;
+};
+
 template <auto method>
 using Request = typename MethodTraits<decltype(method)>::Request;
 
@@ -117,6 +271,13 @@ using Response = typename MethodTraits<decltype(method)>::Response;
 // pointer to an "invoker" function that calls that function, and pointers to
 // the Nanopb descriptors used to encode and decode request and response
 // structs.
+//
+// A method may instead take its request as a protobuf::Decoder&, which reads
+// the fields directly from the request packet's payload. No request struct is
+// allocated or decoded, so a method that reads only a few fields, or iterates
+// over a large repeated field, avoids copying the whole request. The Decoder
+// does not validate the payload in advance; the method should return
+// DATA_LOSS if decoding fails.
 class NanopbMethod : public Method {
  public:
   template <auto method>
@@ -129,50 +290,122 @@ class NanopbMethod : public Method {
   static constexpr NanopbMethod Unary(uint32_t id,
                                       NanopbMessageDescriptor request,
                                       NanopbMessageDescriptor response) {
-    // Define a wrapper around the user-defined function that takes the
-    // request and response protobuf structs as void*. This wrapper is stored
-    // generically in the Function union, defined below.
-    //
-    // In optimized builds, the compiler inlines the user-defined function into
-    // this wrapper, elminating any overhead.
-    constexpr UnaryFunction wrapper =
-        [](ServerCall& call, const void* req, void* resp) {
-          return CallMethodImplFunction<method>(
-              call,
-              *static_cast<const Request<method>*>(req),
-              *static_cast<Response<method>*>(resp));
-        };
+    if constexpr (kDecodesWithDecoder<method>) {
+      constexpr UnaryDecoderFunction wrapper =
+          [](ServerCall& call, protobuf::Decoder& req, void* resp) {
+            return CallMethodImplFunction<method>(
+                call, req, *static_cast<Response<method>*>(resp));
+          };
+      return NanopbMethod(
+          id,
+          UnaryDecoderInvoker<AllocateSpaceFor<Response<method>>()>,
+          Function{.unary_decoder = wrapper},
+          request,
+          response);
+    } else {
+      // Define a wrapper around the user-defined function that takes the
+      // request and response protobuf structs as void*. This wrapper is
+      // stored generically in the Function union, defined below.
+      //
+      // In optimized builds, the compiler inlines the user-defined function
+      // into this wrapper, elminating any overhead.
+      constexpr UnaryFunction wrapper =
+          [](ServerCall& call, const void* req, void* resp) {
+            return CallMethodImplFunction<method>(
+                call,
+                *static_cast<const Request<method>*>(req),
+                *static_cast<Response<method>*>(resp));
+          };
+      return NanopbMethod(id,
+                          UnaryInvoker<AllocateSpaceFor<Request<method>>(),
+                                       AllocateSpaceFor<Response<method>>()>,
+                          Function{.unary = wrapper},
+                          request,
+                          response);
+    }
+  }
+
+  // Creates a NanopbMethod for a server-streaming RPC.
+  template <auto method>
+  static constexpr NanopbMethod ServerStreaming(
+      uint32_t id,
+      NanopbMessageDescriptor request,
+      NanopbMessageDescriptor response) {
+    if constexpr (kDecodesWithDecoder<method>) {
+      constexpr ServerStreamingDecoderFunction wrapper =
+          [](ServerCall& call,
+             protobuf::Decoder& req,
+             BaseServerWriter& writer) {
+            return CallMethodImplFunction<method>(
+                call,
+                req,
+                static_cast<ServerWriter<Response<method>>&>(writer));
+          };
+      return NanopbMethod(id,
+                          ServerStreamingDecoderInvoker,
+                          Function{.server_streaming_decoder = wrapper},
+                          request,
+                          response);
+    } else {
+      // Define a wrapper around the user-defined function that takes the
+      // request struct as void* and a BaseServerWriter instead of the
+      // templated ServerWriter class. This wrapper is stored generically in
+      // the Function union, defined below.
+      constexpr ServerStreamingFunction wrapper =
+          [](ServerCall& call, const void* req, BaseServerWriter& writer) {
+            return CallMethodImplFunction<method>(
+                call,
+                *static_cast<const Request<method>*>(req),
+                static_cast<ServerWriter<Response<method>>&>(writer));
+          };
+      return NanopbMethod(
+          id,
+          ServerStreamingInvoker<AllocateSpaceFor<Request<method>>()>,
+          Function{.server_streaming = wrapper},
+          request,
+          response);
+    }
+  }
+
+  // Creates a NanopbMethod for a client streaming RPC. Requests are decoded
+  // as they arrive by the ClientStreamHandler set on the ServerReader.
+  template <auto method>
+  static constexpr NanopbMethod ClientStreaming(
+      uint32_t id,
+      NanopbMessageDescriptor request,
+      NanopbMessageDescriptor response) {
+    constexpr StreamFunction wrapper = [](ServerCall& call,
+                                          BaseServerWriter& reader) {
+      return CallMethodImplFunction<method>(
+          call,
+          static_cast<ServerReader<Request<method>, Response<method>>&>(
+              reader));
+    };
     return NanopbMethod(id,
-                        UnaryInvoker<AllocateSpaceFor<Request<method>>(),
-                                     AllocateSpaceFor<Response<method>>()>,
-                        Function{.unary = wrapper},
+                        ClientStreamingInvoker,
+                        Function{.client_streaming = wrapper},
                         request,
                         response);
   }
 
-  // Creates a NanopbMethod for a server-streaming RPC.
+  // Creates a NanopbMethod for a bidirectional streaming RPC.
   template <auto method>
-  static constexpr NanopbMethod ServerStreaming(
+  static constexpr NanopbMethod BidirectionalStreaming(
       uint32_t id,
       NanopbMessageDescriptor request,
       NanopbMessageDescriptor response) {
-    // Define a wrapper around the user-defined function that takes the request
-    // struct as void* and a BaseServerWriter instead of the templated
-    // ServerWriter class. This wrapper is stored generically in the Function
-    // union, defined below.
-    constexpr ServerStreamingFunction wrapper =
-        [](ServerCall& call, const void* req, BaseServerWriter& writer) {
-          return CallMethodImplFunction<method>(
-              call,
-              *static_cast<const Request<method>*>(req),
-              static_cast<ServerWriter<Response<method>>&>(writer));
-        };
-    return NanopbMethod(
-        id,
-        ServerStreamingInvoker<AllocateSpaceFor<Request<method>>()>,
-        Function{.server_streaming = wrapper},
-        request,
-        response);
+    constexpr StreamFunction wrapper = [](ServerCall& call,
+                                          BaseServerWriter& reader_writer) {
+      return CallMethodImplFunction<method>(
+          call,
+          static_cast<ServerReaderWriter<Request<method>, Response<method>>&>(
+              reader_writer));
+    };
+    return NanopbMethod(id,
+                        BidirectionalStreamingInvoker,
+                        Function{.bidirectional_streaming = wrapper},
+                        request,
+                        response);
   }
 
   // Represents an invalid method. Used to reduce error message verbosity.
@@ -186,6 +419,13 @@ class NanopbMethod : public Method {
     return serde_.EncodeResponse(buffer, proto_struct);
   }
 
+  // Decodes a request protobuf with Nanopb to the provided buffer. Used for
+  // requests in client and bidirectional streams.
+  bool DecodeRequest(std::span<const std::byte> request,
+                     void* proto_struct) const {
+    return serde_.DecodeRequest(proto_struct, request);
+  }
+
   // Decodes a response protobuf with Nanopb to the provided buffer. For testing
   // use.
   bool DecodeResponse(std::span<const std::byte> response,
@@ -194,6 +434,11 @@ class NanopbMethod : public Method {
   }
 
  private:
+  // True if the method takes its request as a protobuf::Decoder.
+  template <auto method>
+  static constexpr bool kDecodesWithDecoder =
+      std::is_same_v<Request<method>, protobuf::Decoder>;
+
   // Generic version of the unary RPC function signature:
   //
   //   Status(ServerCall&, const Request&, Response&)
@@ -210,13 +455,33 @@ class NanopbMethod : public Method {
                                            const void* request,
                                            BaseServerWriter& writer);
 
+  // Versions of the unary and server streaming function signatures for methods
+  // that take their request as a protobuf::Decoder.
+  using UnaryDecoderFunction = Status (*)(ServerCall&,
+                                          protobuf::Decoder& request,
+                                          void* response);
+  using ServerStreamingDecoderFunction = void (*)(ServerCall&,
+                                                  protobuf::Decoder& request,
+                                                  BaseServerWriter& writer);
+
+  // Generic version of the client and bidirectional streaming RPC function
+  // signatures:
+  //
+  //   void(ServerCall&, ServerReader<Request, Response>&)
+  //   void(ServerCall&, ServerReaderWriter<Request, Response>&)
+  //
+  using StreamFunction = void (*)(ServerCall&, BaseServerWriter& reader);
+
   // The Function union stores a pointer to a generic version of the
   // user-defined RPC function. Using a union instead of void* avoids
   // reinterpret_cast, which keeps this class fully constexpr.
   union Function {
     UnaryFunction unary;
     ServerStreamingFunction server_streaming;
-    // TODO(hepler): Add client_streaming and bidi_streaming
+    UnaryDecoderFunction unary_decoder;
+    ServerStreamingDecoderFunction server_streaming_decoder;
+    StreamFunction client_streaming;
+    StreamFunction bidirectional_streaming;
   };
 
   // Allocates space for a struct. Rounds up to a reasonable minimum size to
@@ -242,7 +507,16 @@ class NanopbMethod : public Method {
                            const Packet& request,
                            void* request_struct) const;
 
-  // TODO(hepler): Add CallClientStreaming and CallBidiStreaming
+  void CallUnaryDecoder(ServerCall& call,
+                        const Packet& request,
+                        void* response_struct) const;
+
+  void CallServerStreamingDecoder(ServerCall& call,
+                                  const Packet& request) const;
+
+  void CallClientStreaming(ServerCall& call) const;
+
+  void CallBidirectionalStreaming(ServerCall& call) const;
 
   // Invoker function for unary RPCs. Allocates request and response structs by
   // size, with maximum alignment, to avoid generating unnecessary copies of
@@ -277,14 +551,50 @@ class NanopbMethod : public Method {
         call, request, &request_struct);
   }
 
+  // Invoker function for unary RPCs that take a protobuf::Decoder. Only
+  // allocates a response struct, since the request is decoded in place.
+  template <size_t response_size>
+  static void UnaryDecoderInvoker(const Method& method,
+                                  ServerCall& call,
+                                  const Packet& request) {
+    _PW_RPC_NANOPB_STRUCT_STORAGE_CLASS
+    std::aligned_storage_t<response_size, alignof(std::max_align_t)>
+        response_struct{};
+
+    static_cast<const NanopbMethod&>(method).CallUnaryDecoder(
+        call, request, &response_struct);
+  }
+
+  // Invoker function for server streaming RPCs that take a protobuf::Decoder.
+  static void ServerStreamingDecoderInvoker(const Method& method,
+                                            ServerCall& call,
+                                            const Packet& request) {
+    static_cast<const NanopbMethod&>(method).CallServerStreamingDecoder(
+        call, request);
+  }
+
+  // Invoker functions for client and bidirectional streaming RPCs. The
+  // REQUEST packet that starts the RPC has no payload, so it is not decoded.
+  static void ClientStreamingInvoker(const Method& method,
+                                     ServerCall& call,
+                                     const Packet&) {
+    static_cast<const NanopbMethod&>(method).CallClientStreaming(call);
+  }
+
+  static void BidirectionalStreamingInvoker(const Method& method,
+                                            ServerCall& call,
+                                            const Packet&) {
+    static_cast<const NanopbMethod&>(method).CallBidirectionalStreaming(call);
+  }
+
   // Decodes a request protobuf with Nanopb to the provided buffer. Sends an
   // error packet if the request failed to decode.
-  bool DecodeRequest(Channel& channel,
+  bool DecodeRequest(ServerCall& call,
                      const Packet& request,
                      void* proto_struct) const;
 
-  // Encodes a response and sends it over the provided channel.
-  void SendResponse(Channel& channel,
+  // Encodes a response and sends it over the call's channel.
+  void SendResponse(ServerCall& call,
                     const Packet& request,
                     const void* response_struct,
                     Status status) const;
@@ -304,6 +614,60 @@ Status ServerWriter<T>::Write(const T& response) {
     return Status::FailedPrecondition();
   }
 
+  // Without credit, the response is dropped before it is encoded.
+  if (AvailableCredits() == 0u) {
+    return Status::ResourceExhausted();
+  }
+
+  const bool batch_was_pending = batch_pending();
+  Status status = EncodeAndRelease(response);
+  if (status.ok() || !batch_was_pending) {
+    return status;
+  }
+
+  // The response did not fit after the batched responses. Send them and try
+  // again with the whole buffer.
+  if (status = Flush(); !status.ok()) {
+    return status;
+  }
+  return EncodeAndRelease(response);
+}
+
+template <typename Request>
+Status ClientStreamHandler<Request>::ReceivedPayload(
+    const internal::Method& method, std::span<const std::byte> payload) {
+  Request request{};
+  if (!static_cast<const internal::NanopbMethod&>(method).DecodeRequest(
+          payload, &request)) {
+    return Status::DataLoss();
+  }
+
+  ReceivedRequest(request);
+  return OkStatus();
+}
+
+template <typename Request, typename Response>
+Status ServerReader<Request, Response>::Finish(const Response& response,
+                                               Status status) {
+  if (!open()) {
+    return Status::FailedPrecondition();
+  }
+
+  std::span<std::byte> buffer = AcquirePayloadBuffer();
+
+  if (auto result =
+          static_cast<const internal::NanopbMethod&>(method()).EncodeResponse(
+              &response, buffer);
+      result.ok()) {
+    return CloseAndSendResponse(buffer.first(result.size()), status);
+  }
+
+  ReleasePayloadBuffer();
+  return Status::Internal();
+}
+
+template <typename T>
+Status ServerWriter<T>::EncodeAndRelease(const T& response) {
   std::span<std::byte> buffer = AcquirePayloadBuffer();
 
   if (auto result =
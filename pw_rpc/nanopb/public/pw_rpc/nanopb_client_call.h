@@ -61,6 +61,10 @@ class BaseNanopbClientCall : public BaseClientCall {
  public:
   Status SendRequest(const void* request_struct);
 
+  // Sends a request in a client or bidirectional stream that was started with
+  // StartClientStream().
+  Status SendClientStreamRequest(const void* request_struct);
+
  protected:
   constexpr BaseNanopbClientCall(
       rpc::Channel* channel,
@@ -75,6 +79,8 @@ class BaseNanopbClientCall : public BaseClientCall {
   constexpr const internal::NanopbMethodSerde& serde() const { return serde_; }
 
  private:
+  Status EncodeAndSend(const void* request_struct, PacketType type);
+
   internal::NanopbMethodSerde serde_;
 };
 
@@ -14,12 +14,41 @@
 
 #include "pw_rpc/internal/packet.h"
 
+#include <algorithm>
+
+#include "pw_bytes/endian.h"
 #include "pw_protobuf/decoder.h"
+#include "pw_protobuf/wire_format.h"
+#include "pw_varint/varint.h"
 
 namespace pw::rpc::internal {
 
 using std::byte;
 
+namespace {
+
+constexpr uint32_t MakeKey(RpcPacket::Fields field,
+                           protobuf::WireType wire_type) {
+  return protobuf::MakeKey(static_cast<uint32_t>(field), wire_type);
+}
+
+byte* CopyFixed32(uint32_t value, byte* out) {
+  const auto bytes = bytes::CopyInOrder(std::endian::little, value);
+  return std::copy(bytes.begin(), bytes.end(), out);
+}
+
+// Encodes value as a varint that exactly fills the output, adding continuation
+// bytes as needed. The output must be at least varint::EncodedSize(value).
+void EncodePaddedVarint(uint32_t value, ByteSpan output) {
+  for (size_t i = 0; i + 1 < output.size(); ++i) {
+    output[i] = byte((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+  output.back() = byte(value);
+}
+
+}  // namespace
+
 Result<Packet> Packet::FromBuffer(ConstByteSpan data) {
   Packet packet;
   Status status;
@@ -70,6 +99,12 @@ Result<Packet> Packet::FromBuffer(ConstByteSpan data) {
 }
 
 Result<ConstByteSpan> Packet::Encode(ByteSpan buffer) const {
+  const size_t offset = PayloadOffset(buffer.size());
+  if (!payload_.empty() && payload_.data() == buffer.data() + offset &&
+      payload_.size() <= buffer.size() - offset) {
+    return EncodeInPlace(buffer.first(offset + payload_.size()));
+  }
+
   pw::protobuf::NestedEncoder encoder(buffer);
   RpcPacket::Encoder rpc_packet(&encoder);
 
@@ -85,6 +120,17 @@ Result<ConstByteSpan> Packet::Encode(ByteSpan buffer) const {
   return encoder.Encode();
 }
 
+size_t Packet::PayloadOffset(size_t buffer_size) const {
+  const size_t reserved_size = MinEncodedSizeBytes();
+  if (reserved_size > buffer_size) {
+    return buffer_size;
+  }
+
+  // MinEncodedSizeBytes() reserves one byte for the payload length. Widen it to
+  // fit the length of any payload that fits in the buffer.
+  return reserved_size - 1 + varint::EncodedSize(buffer_size - reserved_size);
+}
+
 size_t Packet::MinEncodedSizeBytes() const {
   size_t reserved_size = 0;
 
@@ -105,4 +151,39 @@ size_t Packet::MinEncodedSizeBytes() const {
   return reserved_size;
 }
 
+ConstByteSpan Packet::EncodeInPlace(ByteSpan packet) const {
+  byte* out = packet.data();
+
+  *out++ = byte(MakeKey(RpcPacket::Fields::TYPE, protobuf::WireType::kVarint));
+  *out++ = byte(static_cast<uint8_t>(type_));
+
+  *out++ = byte(
+      MakeKey(RpcPacket::Fields::CHANNEL_ID, protobuf::WireType::kVarint));
+  out += varint::Encode(channel_id_,
+                        ByteSpan(out, varint::kMaxVarint32SizeBytes));
+
+  *out++ = byte(
+      MakeKey(RpcPacket::Fields::SERVICE_ID, protobuf::WireType::kFixed32));
+  out = CopyFixed32(service_id_, out);
+
+  *out++ = byte(
+      MakeKey(RpcPacket::Fields::METHOD_ID, protobuf::WireType::kFixed32));
+  out = CopyFixed32(method_id_, out);
+
+  *out++ = byte(MakeKey(RpcPacket::Fields::STATUS, protobuf::WireType::kVarint));
+  *out++ = byte(static_cast<uint8_t>(status_.code()));
+
+  // The payload length fills the space that remains before the payload, so it
+  // may be encoded with more bytes than it needs. Protobuf decoders accept
+  // varints with extra continuation bytes.
+  *out++ = byte(
+      MakeKey(RpcPacket::Fields::PAYLOAD, protobuf::WireType::kDelimited));
+  const byte* const payload_start =
+      packet.data() + packet.size() - payload_.size();
+  EncodePaddedVarint(payload_.size(),
+                     ByteSpan(out, static_cast<size_t>(payload_start - out)));
+
+  return packet;
+}
+
 }  // namespace pw::rpc::internal
@@ -14,6 +14,8 @@
 
 #include "pw_rpc/internal/packet.h"
 
+#include <cstring>
+
 #include "gtest/gtest.h"
 #include "pw_bytes/array.h"
 #include "pw_protobuf/codegen.h"
@@ -141,6 +143,60 @@ TEST(Packet, EncodeDecode) {
   EXPECT_EQ(decoded.status(), Status::Unavailable());
 }
 
+TEST(Packet, Encode_PayloadAtPayloadOffset_EncodesInPlace) {
+  byte buffer[64];
+  Packet packet(PacketType::RESPONSE, 1, 42, 100);
+
+  const size_t offset = packet.PayloadOffset(sizeof(buffer));
+  std::memcpy(&buffer[offset], kPayload.data(), kPayload.size());
+  packet.set_payload(std::span(buffer).subspan(offset, kPayload.size()));
+
+  auto result = packet.Encode(buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(buffer, result.value().data());
+  EXPECT_EQ(offset + kPayload.size(), result.value().size());
+
+  auto decoded = Packet::FromBuffer(result.value());
+  ASSERT_EQ(OkStatus(), decoded.status());
+  EXPECT_EQ(PacketType::RESPONSE, decoded.value().type());
+  EXPECT_EQ(1u, decoded.value().channel_id());
+  EXPECT_EQ(42u, decoded.value().service_id());
+  EXPECT_EQ(100u, decoded.value().method_id());
+  EXPECT_EQ(&buffer[offset], decoded.value().payload().data());
+  EXPECT_EQ(kPayload.size(), decoded.value().payload().size());
+}
+
+TEST(Packet, Encode_InPlaceWithPaddedPayloadLength) {
+  byte buffer[512];
+  Packet packet(PacketType::RESPONSE, 1, 42, 100);
+
+  // The payload length field is sized for 494-byte payloads (2 bytes), but the
+  // payload is only 4 bytes long.
+  const size_t offset = packet.PayloadOffset(sizeof(buffer));
+  ASSERT_EQ(packet.MinEncodedSizeBytes() + 1, offset);
+  std::memcpy(&buffer[offset], kPayload.data(), kPayload.size());
+  packet.set_payload(std::span(buffer).subspan(offset, kPayload.size()));
+  packet.set_status(Status::Unavailable());
+
+  auto result = packet.Encode(buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(offset + kPayload.size(), result.value().size());
+
+  auto decoded = Packet::FromBuffer(result.value());
+  ASSERT_EQ(OkStatus(), decoded.status());
+  EXPECT_EQ(Status::Unavailable(), decoded.value().status());
+  ASSERT_EQ(kPayload.size(), decoded.value().payload().size());
+  EXPECT_EQ(0,
+            std::memcmp(decoded.value().payload().data(),
+                        kPayload.data(),
+                        kPayload.size()));
+}
+
+TEST(Packet, PayloadOffset_BufferTooSmall) {
+  Packet packet(PacketType::RESPONSE, 1, 42, 100);
+  EXPECT_EQ(4u, packet.PayloadOffset(4));
+}
+
 constexpr size_t kReservedSize = 2 /* type */ + 2 /* channel */ +
                                  5 /* service */ + 5 /* method */ +
                                  2 /* payload key */ + 2 /* status */;
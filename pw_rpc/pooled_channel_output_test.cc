@@ -0,0 +1,108 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/pooled_channel_output.h"
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+namespace pw::rpc {
+namespace {
+
+class TestPooledOutput : public PooledChannelOutput<3, 8> {
+ public:
+  TestPooledOutput(sync::Mutex& mutex)
+      : PooledChannelOutput(mutex, "TestPooledOutput") {}
+
+  const std::byte* sent(size_t index) const { return sent_[index]; }
+  size_t sent_count() const { return sent_count_; }
+
+  void set_write_status(Status status) { write_status_ = status; }
+
+ private:
+  Status Write(std::span<const std::byte> packet) override {
+    std::memcpy(sent_[sent_count_], packet.data(), packet.size());
+    sent_count_ += 1;
+    return write_status_;
+  }
+
+  std::byte sent_[3][8] = {};
+  size_t sent_count_ = 0;
+  Status write_status_;
+};
+
+TEST(PooledChannelOutput, EachWriterGetsItsOwnBuffer) {
+  sync::Mutex mutex;
+  TestPooledOutput output(mutex);
+
+  std::span<std::byte> a = output.AcquireBuffer();
+  std::span<std::byte> b = output.AcquireBuffer();
+  std::span<std::byte> c = output.AcquireBuffer();
+
+  ASSERT_EQ(8u, a.size());
+  EXPECT_NE(a.data(), b.data());
+  EXPECT_NE(b.data(), c.data());
+  EXPECT_TRUE(output.AcquireBuffer().empty());
+  EXPECT_EQ(3u, output.buffers_in_use());
+
+  // The mutex is not held while buffers are acquired.
+  ASSERT_TRUE(mutex.try_lock());
+  mutex.unlock();
+
+  output.DiscardBuffer(a);
+  output.DiscardBuffer(b);
+  output.DiscardBuffer(c);
+}
+
+TEST(PooledChannelOutput, SendsInReleaseOrder) {
+  sync::Mutex mutex;
+  TestPooledOutput output(mutex);
+
+  std::span<std::byte> first = output.AcquireBuffer();
+  std::span<std::byte> second = output.AcquireBuffer();
+  first[0] = std::byte{1};
+  second[0] = std::byte{2};
+
+  EXPECT_EQ(OkStatus(), output.SendAndReleaseBuffer(second.first(1)));
+  EXPECT_EQ(OkStatus(), output.SendAndReleaseBuffer(first.first(1)));
+
+  ASSERT_EQ(2u, output.sent_count());
+  EXPECT_EQ(std::byte{2}, output.sent(0)[0]);
+  EXPECT_EQ(std::byte{1}, output.sent(1)[0]);
+  EXPECT_EQ(0u, output.buffers_in_use());
+}
+
+TEST(PooledChannelOutput, Discard_ReleasesWithoutWriting) {
+  sync::Mutex mutex;
+  TestPooledOutput output(mutex);
+
+  output.DiscardBuffer(output.AcquireBuffer());
+
+  EXPECT_EQ(0u, output.sent_count());
+  EXPECT_EQ(0u, output.buffers_in_use());
+}
+
+TEST(PooledChannelOutput, WriteError_ReleasesBuffer) {
+  sync::Mutex mutex;
+  TestPooledOutput output(mutex);
+  output.set_write_status(Status::Unavailable());
+
+  EXPECT_EQ(Status::Unavailable(),
+            output.SendAndReleaseBuffer(output.AcquireBuffer()));
+  EXPECT_EQ(0u, output.buffers_in_use());
+}
+
+}  // namespace
+}  // namespace pw::rpc
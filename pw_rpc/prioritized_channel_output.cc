@@ -0,0 +1,37 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/prioritized_channel_output.h"
+
+#include "pw_rpc/internal/packet.h"
+
+namespace pw::rpc::internal {
+
+Priority PacketPriority(std::span<const std::byte> packet,
+                        std::span<const MethodPriority> priorities) {
+  Result<Packet> decoded = Packet::FromBuffer(packet);
+  if (!decoded.ok()) {
+    return Priority::kNormal;
+  }
+
+  for (const MethodPriority& method : priorities) {
+    if (method.service_id() == decoded.value().service_id() &&
+        method.method_id() == decoded.value().method_id()) {
+      return method.priority();
+    }
+  }
+  return Priority::kNormal;
+}
+
+}  // namespace pw::rpc::internal
@@ -0,0 +1,200 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/prioritized_channel_output.h"
+
+#include "gtest/gtest.h"
+#include "pw_rpc/internal/packet.h"
+
+namespace pw::rpc {
+namespace {
+
+using internal::Packet;
+using internal::PacketType;
+
+constexpr MethodPriority kPriorities[] = {
+    MethodPriority("pw.test.Control", "Reset", Priority::kHigh),
+    MethodPriority("pw.test.Telemetry", "Stream", Priority::kLow),
+};
+
+constexpr uint32_t kControlId = internal::Hash("pw.test.Control");
+constexpr uint32_t kResetId = internal::Hash("Reset");
+constexpr uint32_t kTelemetryId = internal::Hash("pw.test.Telemetry");
+constexpr uint32_t kStreamId = internal::Hash("Stream");
+
+class TestPrioritizedOutput : public PrioritizedChannelOutput<4, 32> {
+ public:
+  TestPrioritizedOutput(sync::Mutex& mutex)
+      : PrioritizedChannelOutput(mutex, "TestPrioritizedOutput", kPriorities) {}
+
+  // Encodes a packet for the method and sends it through the output.
+  Status SendPacket(uint32_t service_id, uint32_t method_id) {
+    std::span<std::byte> buffer = AcquireBuffer();
+    if (buffer.empty()) {
+      return Status::ResourceExhausted();
+    }
+    Result<ConstByteSpan> encoded =
+        Packet(PacketType::RESPONSE, 1, service_id, method_id)
+            .Encode(buffer);
+    if (!encoded.ok()) {
+      DiscardBuffer(buffer);
+      return encoded.status();
+    }
+    return SendAndReleaseBuffer(encoded.value());
+  }
+
+  uint32_t sent_method(size_t index) const { return sent_methods_[index]; }
+  size_t sent_count() const { return sent_count_; }
+  size_t queued_notifications() const { return queued_notifications_; }
+
+  void set_write_status(Status status) { write_status_ = status; }
+
+ private:
+  Status Write(std::span<const std::byte> packet) override {
+    Result<Packet> decoded = Packet::FromBuffer(packet);
+    EXPECT_EQ(OkStatus(), decoded.status());
+    sent_methods_[sent_count_] = decoded.value().method_id();
+    sent_count_ += 1;
+    return write_status_;
+  }
+
+  void OnPacketQueued() override { queued_notifications_ += 1; }
+
+  uint32_t sent_methods_[8] = {};
+  size_t sent_count_ = 0;
+  size_t queued_notifications_ = 0;
+  Status write_status_;
+};
+
+TEST(PrioritizedChannelOutput, PacketPriority_LooksUpMethod) {
+  std::byte buffer[32];
+  auto encode = [&buffer](uint32_t service_id, uint32_t method_id) {
+    return Packet(PacketType::RESPONSE, 1, service_id, method_id)
+        .Encode(buffer)
+        .value();
+  };
+
+  EXPECT_EQ(Priority::kHigh,
+            internal::PacketPriority(encode(kControlId, kResetId), kPriorities));
+  EXPECT_EQ(
+      Priority::kLow,
+      internal::PacketPriority(encode(kTelemetryId, kStreamId), kPriorities));
+  EXPECT_EQ(
+      Priority::kNormal,
+      internal::PacketPriority(encode(kControlId, kStreamId), kPriorities));
+}
+
+TEST(PrioritizedChannelOutput, Send_QueuesUntilFlush) {
+  sync::Mutex mutex;
+  TestPrioritizedOutput output(mutex);
+
+  ASSERT_EQ(OkStatus(), output.SendPacket(kControlId, kResetId));
+
+  EXPECT_EQ(0u, output.sent_count());
+  EXPECT_EQ(1u, output.packets_queued());
+  EXPECT_EQ(1u, output.buffers_in_use());
+  EXPECT_EQ(1u, output.queued_notifications());
+
+  EXPECT_EQ(OkStatus(), output.Flush());
+  EXPECT_EQ(1u, output.sent_count());
+  EXPECT_EQ(0u, output.packets_queued());
+  EXPECT_EQ(0u, output.buffers_in_use());
+}
+
+TEST(PrioritizedChannelOutput, Flush_SendsHighPriorityBeforeBulkData) {
+  sync::Mutex mutex;
+  TestPrioritizedOutput output(mutex);
+
+  ASSERT_EQ(OkStatus(), output.SendPacket(kTelemetryId, kStreamId));
+  ASSERT_EQ(OkStatus(), output.SendPacket(kTelemetryId, kStreamId));
+  ASSERT_EQ(OkStatus(), output.SendPacket(kControlId, 123));
+  ASSERT_EQ(OkStatus(), output.SendPacket(kControlId, kResetId));
+
+  EXPECT_EQ(OkStatus(), output.Flush());
+  ASSERT_EQ(4u, output.sent_count());
+  EXPECT_EQ(kResetId, output.sent_method(0));
+  EXPECT_EQ(123u, output.sent_method(1));
+  EXPECT_EQ(kStreamId, output.sent_method(2));
+  EXPECT_EQ(kStreamId, output.sent_method(3));
+}
+
+TEST(PrioritizedChannelOutput, SamePriority_SentInOrder) {
+  sync::Mutex mutex;
+  TestPrioritizedOutput output(mutex);
+
+  ASSERT_EQ(OkStatus(), output.SendPacket(kControlId, 1));
+  ASSERT_EQ(OkStatus(), output.SendPacket(kControlId, 2));
+  ASSERT_EQ(OkStatus(), output.SendPacket(kControlId, 3));
+
+  // Reuse the first buffer so the queue order differs from the buffer order.
+  ASSERT_EQ(OkStatus(), output.SendNext());
+  ASSERT_EQ(OkStatus(), output.SendPacket(kControlId, 4));
+
+  EXPECT_EQ(OkStatus(), output.Flush());
+  ASSERT_EQ(4u, output.sent_count());
+  for (uint32_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(i + 1, output.sent_method(i));
+  }
+}
+
+TEST(PrioritizedChannelOutput, SendNext_EmptyQueue) {
+  sync::Mutex mutex;
+  TestPrioritizedOutput output(mutex);
+
+  EXPECT_EQ(Status::NotFound(), output.SendNext());
+  EXPECT_EQ(OkStatus(), output.Flush());
+}
+
+TEST(PrioritizedChannelOutput, QueuedPacketsHoldBuffers) {
+  sync::Mutex mutex;
+  TestPrioritizedOutput output(mutex);
+
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(OkStatus(), output.SendPacket(kTelemetryId, kStreamId));
+  }
+  EXPECT_EQ(Status::ResourceExhausted(),
+            output.SendPacket(kControlId, kResetId));
+
+  ASSERT_EQ(OkStatus(), output.SendNext());
+  EXPECT_EQ(OkStatus(), output.SendPacket(kControlId, kResetId));
+  ASSERT_EQ(OkStatus(), output.SendNext());
+  EXPECT_EQ(kResetId, output.sent_method(1));
+}
+
+TEST(PrioritizedChannelOutput, WriteFails_ReturnsFirstErrorAndDrains) {
+  sync::Mutex mutex;
+  TestPrioritizedOutput output(mutex);
+  output.set_write_status(Status::Unavailable());
+
+  ASSERT_EQ(OkStatus(), output.SendPacket(kControlId, 1));
+  ASSERT_EQ(OkStatus(), output.SendPacket(kControlId, 2));
+
+  EXPECT_EQ(Status::Unavailable(), output.Flush());
+  EXPECT_EQ(2u, output.sent_count());
+  EXPECT_EQ(0u, output.buffers_in_use());
+}
+
+TEST(PrioritizedChannelOutput, Discard_ReleasesBufferWithoutQueueing) {
+  sync::Mutex mutex;
+  TestPrioritizedOutput output(mutex);
+
+  output.DiscardBuffer(output.AcquireBuffer());
+
+  EXPECT_EQ(0u, output.buffers_in_use());
+  EXPECT_EQ(0u, output.packets_queued());
+  EXPECT_EQ(0u, output.queued_notifications());
+}
+
+}  // namespace
+}  // namespace pw::rpc
@@ -0,0 +1,82 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include "pw_rpc/channel.h"
+#include "pw_rpc/internal/channel_output_buffer_pool.h"
+#include "pw_status/status.h"
+
+namespace pw::rpc {
+
+// ChannelOutput for transports that send asynchronously, such as a UART or USB
+// driver that hands each packet to DMA. Packets are encoded into a pool of
+// kBufferCount buffers. SendAndReleaseBuffer() starts the transfer with
+// StartSend() and returns without waiting for it. The buffer stays in use until
+// the driver calls SendComplete(), which may be done from an interrupt. The
+// server or client can encode the next packet into another buffer while the
+// previous one is on the wire.
+//
+// If every buffer is in flight, AcquireBuffer() returns an empty span and the
+// send fails with RESOURCE_EXHAUSTED.
+template <size_t kBufferCount, size_t kBufferSize>
+class AsyncChannelOutput : public ChannelOutput {
+ public:
+  std::span<std::byte> AcquireBuffer() final { return pool_.Acquire(); }
+
+  Status SendAndReleaseBuffer(std::span<const std::byte> buffer) final {
+    if (buffer.empty()) {
+      pool_.Release(buffer);
+      return OkStatus();
+    }
+
+    Status status = StartSend(buffer);
+    if (!status.ok()) {
+      pool_.Release(buffer);
+    }
+    return status;
+  }
+
+  // Called by the driver when a transfer started by StartSend() finishes, with
+  // the packet that was passed to StartSend(). Returns the buffer to the pool
+  // and calls OnSendComplete(). Safe to call from an interrupt.
+  void SendComplete(std::span<const std::byte> packet, Status status) {
+    if (pool_.Release(packet)) {
+      OnSendComplete(status);
+    }
+  }
+
+  // The number of buffers that are acquired or in flight.
+  size_t buffers_in_use() const { return pool_.in_use(); }
+
+ protected:
+  constexpr AsyncChannelOutput(const char* name) : ChannelOutput(name) {}
+
+ private:
+  // Starts sending an encoded packet. Must not block until the transfer is
+  // done. Returns OK if the transfer was started, in which case the driver
+  // must later call SendComplete() with the same packet. On error, the buffer
+  // is returned to the pool immediately.
+  virtual Status StartSend(std::span<const std::byte> packet) = 0;
+
+  // Called from SendComplete() after the buffer is returned to the pool. Runs
+  // in the same context as SendComplete(), which may be an interrupt.
+  virtual void OnSendComplete(Status) {}
+
+  internal::ChannelOutputBufferPool<kBufferCount, kBufferSize> pool_;
+};
+
+}  // namespace pw::rpc
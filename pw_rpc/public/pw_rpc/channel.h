@@ -39,7 +39,9 @@ class ChannelOutput {
   constexpr const char* name() const { return name_; }
 
   // Acquire a buffer into which to write an outgoing RPC packet. The
-  // implementation is expected to handle synchronization if necessary.
+  // implementation is expected to handle synchronization if necessary. If no
+  // buffer is available, this may return an empty span, in which case pw_rpc
+  // fails the send with RESOURCE_EXHAUSTED.
   virtual std::span<std::byte> AcquireBuffer() = 0;
 
   // Sends the contents of a buffer previously obtained from AcquireBuffer().
@@ -13,22 +13,45 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <span>
 
 #include "pw_bytes/span.h"
 #include "pw_rpc/internal/base_client_call.h"
 #include "pw_rpc/internal/channel.h"
+#include "pw_rpc/internal/config.h"
+#include "pw_rpc/internal/hash.h"
 
 namespace pw::rpc {
 
+class ClientDeadlines;
+
+namespace internal {
+
+// Notified when a call is removed from a Client, so that optional features
+// like ClientDeadlines can drop their state for the call without the Client
+// depending on them.
+class ClientCallObserver {
+ public:
+  virtual void CallRemoved(BaseClientCall& call) = 0;
+
+ protected:
+  ~ClientCallObserver() = default;
+};
+
+}  // namespace internal
+
 class Client {
  public:
   // Creates a client that uses a set of RPC channels. Channels can be shared
   // between a client and a server, but not between multiple clients.
   constexpr Client(std::span<Channel> channels)
       : channels_(static_cast<internal::Channel*>(channels.data()),
-                  channels.size()) {
+                  channels.size()),
+        call_table_{},
+        table_calls_(0),
+        call_observer_(nullptr) {
     for (Channel& channel : channels_) {
       channel.set_client(this);
     };
@@ -47,16 +70,55 @@ class Client {
   //
   Status ProcessPacket(ConstByteSpan data);
 
-  size_t active_calls() const { return calls_.size(); }
+  size_t active_calls() const { return table_calls_ + calls_.size(); }
 
  private:
   friend class internal::BaseClientCall;
+  friend class ClientDeadlines;
 
   Status RegisterCall(internal::BaseClientCall& call);
-  void RemoveCall(const internal::BaseClientCall& call) { calls_.remove(call); }
+  void RemoveCall(internal::BaseClientCall& call);
+
+  // Passes the call a SERVER_ERROR packet with the status, as if the server
+  // had sent it, and unregisters the call.
+  void FailCall(internal::BaseClientCall& call, Status status);
+
+  // Returns the call for the packet's channel, service, and method, or nullptr.
+  internal::BaseClientCall* FindCall(const internal::Packet& packet) {
+    return FindCall(
+        packet.channel_id(), packet.service_id(), packet.method_id());
+  }
+
+  internal::BaseClientCall* FindCall(uint32_t channel_id,
+                                     uint32_t service_id,
+                                     uint32_t method_id);
+
+  // Adds a call to the call table. Returns false if the table is full.
+  bool AddToCallTable(internal::BaseClientCall& call);
+
+  // Removes a call from the call table. Returns false if it is not in the
+  // table.
+  bool RemoveFromCallTable(const internal::BaseClientCall& call);
+
+  static constexpr size_t CallTableIndex(uint32_t channel_id,
+                                         uint32_t service_id,
+                                         uint32_t method_id) {
+    return internal::TableIndex<cfg::kClientCallTableSize>(
+        channel_id ^ service_id ^ method_id);
+  }
+
+  // Passes each response in a RESPONSE_BATCH packet to its call.
+  Status ProcessResponseBatch(const internal::Packet& batch);
 
   std::span<internal::Channel> channels_;
-  IntrusiveList<internal::BaseClientCall> calls_;
+
+  // Open-addressed table of active calls, indexed by channel, service, and
+  // method ID with linear probing. Calls that do not fit in the table are kept
+  // in calls_.
+  std::array<internal::BaseClientCall*, cfg::kClientCallTableSize> call_table_;
+  size_t table_calls_;
+  IntrusiveDoublyLinkedList<internal::BaseClientCall> calls_;
+  internal::ClientCallObserver* call_observer_;
 };
 
 }  // namespace pw::rpc
@@ -0,0 +1,96 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_chrono/timer_wheel.h"
+#include "pw_rpc/client.h"
+#include "pw_rpc/internal/base_client_call.h"
+#include "pw_status/status.h"
+
+namespace pw::rpc {
+
+// Fails a Client's calls that are still active at their deadlines with
+// DEADLINE_EXCEEDED. The call's handler receives a SERVER_ERROR packet with
+// that status, and the call is unregistered.
+//
+// Deadlines are optional, so that clients which do not use them do not depend
+// on pw_chrono. Declare a ClientDeadlinesBuffer for the maximum number of calls
+// with deadlines at once. A Client may have one ClientDeadlines, which must be
+// destroyed before the Client.
+class ClientDeadlines : private internal::ClientCallObserver {
+ public:
+  ~ClientDeadlines();
+
+  ClientDeadlines(const ClientDeadlines&) = delete;
+  ClientDeadlines& operator=(const ClientDeadlines&) = delete;
+
+  // Fails the call with DEADLINE_EXCEEDED if it is still active at the
+  // deadline. Setting a new deadline replaces the previous one. Returns
+  //
+  //   OK - The deadline was set.
+  //   FAILED_PRECONDITION - The call is not active.
+  //   RESOURCE_EXHAUSTED - The maximum number of calls already have deadlines.
+  //
+  Status SetDeadline(internal::BaseClientCall& call,
+                     chrono::SystemClock::time_point deadline);
+
+  Status SetTimeout(internal::BaseClientCall& call,
+                    chrono::SystemClock::duration timeout) {
+    return SetDeadline(call, chrono::SystemClock::now() + timeout);
+  }
+
+  // Fails each call whose deadline has passed. This must be called
+  // periodically, such as from the thread that processes packets, for
+  // deadlines to take effect.
+  void ExpireCalls(chrono::SystemClock::time_point now);
+  void ExpireCalls() { ExpireCalls(chrono::SystemClock::now()); }
+
+  // The number of calls that have failed with DEADLINE_EXCEEDED.
+  uint32_t timed_out_calls() const { return timed_out_calls_; }
+
+ protected:
+  struct Deadline : public chrono::TimerWheel::Timer {
+    internal::BaseClientCall* call = nullptr;
+  };
+
+  ClientDeadlines(Client& client, std::span<Deadline> deadlines);
+
+ private:
+  void CallRemoved(internal::BaseClientCall& call) override;
+
+  Deadline* Find(const internal::BaseClientCall* call);
+
+  Client& client_;
+  std::span<Deadline> deadlines_;
+  chrono::TimerWheel wheel_;
+  uint32_t timed_out_calls_;
+};
+
+template <size_t kMaxCalls>
+class ClientDeadlinesBuffer : public ClientDeadlines {
+ public:
+  explicit ClientDeadlinesBuffer(Client& client)
+      : ClientDeadlines(client, deadlines_) {}
+
+ private:
+  std::array<Deadline, kMaxCalls> deadlines_;
+};
+
+}  // namespace pw::rpc
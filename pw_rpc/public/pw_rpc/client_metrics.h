@@ -0,0 +1,43 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_metric/metric.h"
+#include "pw_rpc/client_deadlines.h"
+
+namespace pw::rpc {
+
+// Exports a client's deadline counters as pw_metric metrics. Like
+// ServerMetrics, call Update() to copy the current counters into the metrics
+// before they are read.
+class ClientMetrics {
+ public:
+  ClientMetrics(const ClientDeadlines& deadlines) : deadlines_(deadlines) {}
+
+  ClientMetrics(const ClientMetrics&) = delete;
+  ClientMetrics& operator=(const ClientMetrics&) = delete;
+
+  metric::Group& metrics() { return metrics_; }
+  const metric::Group& metrics() const { return metrics_; }
+
+  void Update() { timed_out_calls_.Set(deadlines_.timed_out_calls()); }
+
+ private:
+  const ClientDeadlines& deadlines_;
+
+  PW_METRIC_GROUP(metrics_, "rpc_client");
+  PW_METRIC(metrics_, timed_out_calls_, "timed_out_calls", 0u);
+};
+
+}  // namespace pw::rpc
@@ -14,7 +14,7 @@
 #pragma once
 
 #include "pw_assert/assert.h"
-#include "pw_containers/intrusive_list.h"
+#include "pw_containers/intrusive_doubly_linked_list.h"
 #include "pw_rpc/internal/channel.h"
 #include "pw_rpc/internal/packet.h"
 #include "pw_status/status.h"
@@ -24,7 +24,7 @@ namespace pw::rpc::internal {
 // Base class representing an active client-side RPC call. Implementations
 // derive from this class and provide a packet handler function which is
 // called with a reference to the ClientCall object and the received packet.
-class BaseClientCall : public IntrusiveList<BaseClientCall>::Item {
+class BaseClientCall : public IntrusiveDoublyLinkedList<BaseClientCall>::Item {
  public:
   using ResponseHandler = void (*)(BaseClientCall&, const Packet&);
 
@@ -55,13 +55,30 @@ class BaseClientCall : public IntrusiveList<BaseClientCall>::Item {
 
   void Cancel();
 
+  // Starts a client or bidirectional stream. The REQUEST packet that starts
+  // the RPC has no payload; requests are then sent in CLIENT_STREAM packets.
+  Status StartClientStream();
+
+  // Tells the server that the client has finished sending requests in a client
+  // or bidirectional stream. The call remains active until the server
+  // finishes.
+  Status CloseClientStream();
+
+  // Allows a flow controlled server stream to send the specified number of
+  // additional responses.
+  Status GrantCredits(uint32_t responses);
+
  protected:
   constexpr Channel& channel() const { return *channel_; }
   constexpr uint32_t service_id() const { return service_id_; }
   constexpr uint32_t method_id() const { return method_id_; }
 
   std::span<std::byte> AcquirePayloadBuffer();
-  Status ReleasePayloadBuffer(std::span<const std::byte> payload);
+
+  // Sends the payload in a packet of the given type, which is REQUEST or, for
+  // requests in a client stream, CLIENT_STREAM.
+  Status ReleasePayloadBuffer(std::span<const std::byte> payload,
+                              PacketType type = PacketType::REQUEST);
 
   void Unregister();
 
@@ -14,13 +14,16 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <span>
 #include <utility>
 
-#include "pw_containers/intrusive_list.h"
+#include "pw_containers/intrusive_doubly_linked_list.h"
 #include "pw_rpc/internal/call.h"
 #include "pw_rpc/internal/channel.h"
 #include "pw_rpc/internal/method.h"
+#include "pw_rpc/internal/method_type.h"
 #include "pw_rpc/service.h"
 #include "pw_status/status.h"
 
@@ -32,16 +35,43 @@ namespace internal {
 
 class Packet;
 
+// Receives the requests that a client sends in a client or bidirectional
+// stream. Each protobuf implementation derives a handler that decodes the
+// payloads for the user.
+class BaseClientStreamHandler {
+ public:
+  virtual ~BaseClientStreamHandler() = default;
+
+  // Called with the payload of each CLIENT_STREAM packet. Returns DATA_LOSS if
+  // the payload could not be decoded, which ends the RPC.
+  virtual Status ReceivedPayload(const Method& method,
+                                 std::span<const std::byte> payload) = 0;
+
+  // Called when the client has finished sending requests.
+  virtual void ClientStreamEnd() {}
+};
+
 // Internal ServerWriter base class. ServerWriters are used to stream responses.
 // Implementations must provide a derived class that provides the interface for
 // sending responses.
-class BaseServerWriter : public IntrusiveList<BaseServerWriter>::Item {
+class BaseServerWriter
+    : public IntrusiveDoublyLinkedList<BaseServerWriter>::Item {
  public:
-  BaseServerWriter(ServerCall& call);
+  // Creates a writer for an RPC of the given type. Client and bidirectional
+  // streaming writers also receive the client's stream of requests.
+  BaseServerWriter(ServerCall& call,
+                   MethodType type = MethodType::kServerStreaming);
 
   BaseServerWriter(const BaseServerWriter&) = delete;
 
-  BaseServerWriter(BaseServerWriter&& other) : state_(kClosed) {
+  BaseServerWriter(BaseServerWriter&& other)
+      : client_stream_handler_(nullptr),
+        batch_size_(0),
+        credits_(0),
+        type_(MethodType::kServerStreaming),
+        flow_control_(false),
+        client_stream_open_(false),
+        state_(kClosed) {
     *this = std::move(other);
   }
 
@@ -58,11 +88,75 @@ class BaseServerWriter : public IntrusiveList<BaseServerWriter>::Item {
   uint32_t service_id() const { return call_.service().id(); }
   uint32_t method_id() const;
 
-  // Closes the ServerWriter, if it is open.
+  // True if the client may still send requests in a client or bidirectional
+  // stream.
+  bool client_stream_open() const { return open() && client_stream_open_; }
+
+  // Closes the ServerWriter, if it is open. Sends any batched responses first.
+  // A client streaming RPC ends with a RESPONSE packet with an empty payload;
+  // other RPCs end with a SERVER_STREAM_END packet.
   void Finish(Status status = OkStatus());
 
+  // Enables response batching. While batching, responses are collected in the
+  // provided buffer and sent together in one RESPONSE_BATCH packet, which saves
+  // the framing overhead of a packet per response. The batch is sent when a
+  // response does not fit in the rest of the buffer, when Flush() is called, or
+  // when the ServerWriter finishes.
+  //
+  // The buffer belongs to this ServerWriter until batching is disabled or the
+  // ServerWriter finishes. The channel's buffer is shared with other calls, so
+  // batched responses are never kept in it. A batch must fit in one packet, so
+  // only as much of the buffer as fits in a packet payload is used. Each
+  // response must fit in the buffer.
+  //
+  // Batched responses are delayed until the batch is sent, so call Flush()
+  // when responses must not wait, such as after a deadline.
+  //
+  // Returns FAILED_PRECONDITION if the ServerWriter is closed, or
+  // RESOURCE_EXHAUSTED if the channel has no buffer from which to size the
+  // batch.
+  Status EnableBatching(std::span<std::byte> batch_buffer);
+
+  // Sends the pending batch and stops batching responses.
+  void DisableBatching();
+
+  bool batching() const { return !batch_buffer_.empty(); }
+
+  // Sends the batched responses, if there are any. Returns the status of
+  // sending the RESPONSE_BATCH packet, or FAILED_PRECONDITION if the
+  // ServerWriter is closed.
+  Status Flush();
+
+  // Enables flow control for the stream. Each response uses one credit, and
+  // the client grants more credits with STREAM_CREDIT packets as it processes
+  // the responses. Responses written without credit are dropped, and the
+  // write returns RESOURCE_EXHAUSTED. Producers that must not lose responses
+  // check AvailableCredits() first and hold them until credits arrive.
+  //
+  // The client and server must agree on which streams are flow controlled,
+  // since the client must grant credits for the stream to progress.
+  void EnableFlowControl(uint32_t initial_credits) {
+    flow_control_ = true;
+    credits_ = initial_credits;
+  }
+
+  bool flow_control() const { return flow_control_; }
+
+  // The number of responses that may be sent before more credits are granted.
+  // Unlimited if flow control is not enabled.
+  uint32_t AvailableCredits() const {
+    return flow_control_ ? credits_ : std::numeric_limits<uint32_t>::max();
+  }
+
  protected:
-  constexpr BaseServerWriter() : state_{kClosed} {}
+  constexpr BaseServerWriter()
+      : client_stream_handler_(nullptr),
+        batch_size_(0),
+        credits_(0),
+        type_(MethodType::kServerStreaming),
+        flow_control_(false),
+        client_stream_open_(false),
+        state_{kClosed} {}
 
   const Method& method() const { return call_.method(); }
 
@@ -70,23 +164,70 @@ class BaseServerWriter : public IntrusiveList<BaseServerWriter>::Item {
 
   constexpr const Channel::OutputBuffer& buffer() const { return response_; }
 
+  // Returns a buffer for a response payload. While batching, this is the rest
+  // of the batch buffer after the batched responses.
   std::span<std::byte> AcquirePayloadBuffer();
 
-  // Releases the buffer, sending a packet with the specified payload.
+  // True if the payload is in a buffer returned by AcquirePayloadBuffer().
+  bool PayloadBufferContains(std::span<const std::byte> payload) const;
+
+  // Releases the buffer, sending a packet with the specified payload. While
+  // batching, adds the payload to the batch instead. With flow control, uses
+  // a credit, or drops the response if there are none.
   Status ReleasePayloadBuffer(std::span<const std::byte> payload);
 
-  // Releases the buffer without sending a packet.
+  // Releases the buffer without sending a packet. Batched responses are kept.
   Status ReleasePayloadBuffer();
 
+  // True if there are batched responses that have not been sent. A response
+  // that did not fit after them may fit once they are sent with Flush().
+  bool batch_pending() const { return batch_size_ != 0u; }
+
+  // Sets the handler for requests in a client or bidirectional stream.
+  // Requests that arrive while there is no handler are dropped.
+  void set_client_stream_handler(BaseClientStreamHandler* handler) {
+    client_stream_handler_ = handler;
+  }
+
+  // Closes the ServerWriter and sends a RESPONSE packet with the payload and
+  // status, which ends a client streaming RPC. The payload may be in the
+  // buffer from AcquirePayloadBuffer() or in an external buffer.
+  Status CloseAndSendResponse(std::span<const std::byte> payload,
+                              Status status);
+
  private:
   friend class rpc::Server;
 
   void Close();
 
+  // Passes a CLIENT_STREAM or CLIENT_STREAM_END packet to the handler.
+  Status HandleClientStream(const Packet& packet);
+
+  // Adds credits granted by the client in a STREAM_CREDIT packet.
+  void AddCredits(uint32_t credits);
+
   Packet ResponsePacket(std::span<const std::byte> payload = {}) const;
 
+  // Appends a payload to the batch.
+  Status AddToBatch(std::span<const std::byte> payload);
+
   ServerCall call_;
   Channel::OutputBuffer response_;
+  BaseClientStreamHandler* client_stream_handler_;
+
+  // Holds the encoded ResponseBatch while batching. Empty if not batching.
+  std::span<std::byte> batch_buffer_;
+
+  // Size of the encoded ResponseBatch at the start of batch_buffer_.
+  size_t batch_size_;
+
+  // The number of responses that may be sent, if flow control is enabled.
+  uint32_t credits_;
+
+  MethodType type_;
+  bool flow_control_;
+  bool client_stream_open_;
+
   enum { kClosed, kOpen } state_;
 };
 
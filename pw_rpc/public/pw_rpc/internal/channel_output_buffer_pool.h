@@ -0,0 +1,88 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <span>
+
+namespace pw::rpc::internal {
+
+// Fixed pool of packet buffers for ChannelOutputs that hand out more than one
+// buffer at a time. Ownership is tracked with atomic flags, so buffers may be
+// acquired and released from different threads or from interrupts without a
+// lock.
+template <size_t kBufferCount, size_t kBufferSize>
+class ChannelOutputBufferPool {
+ public:
+  static_assert(kBufferCount > 0u, "At least one buffer is required");
+  static_assert(kBufferSize > 0u, "Buffers cannot be empty");
+
+  constexpr ChannelOutputBufferPool() : buffers_{}, in_use_{} {}
+
+  ChannelOutputBufferPool(const ChannelOutputBufferPool&) = delete;
+  ChannelOutputBufferPool& operator=(const ChannelOutputBufferPool&) = delete;
+
+  // Returns a free buffer, or an empty span if all buffers are in use.
+  std::span<std::byte> Acquire() {
+    for (size_t i = 0; i < kBufferCount; ++i) {
+      if (!in_use_[i].exchange(true, std::memory_order_acquire)) {
+        return buffers_[i];
+      }
+    }
+    return {};
+  }
+
+  // Returns the buffer that contains the span to the pool. Returns false if
+  // the span is not from this pool.
+  bool Release(std::span<const std::byte> buffer) {
+    const size_t index = IndexOf(buffer);
+    if (index == kBufferCount) {
+      return false;
+    }
+    in_use_[index].store(false, std::memory_order_release);
+    return true;
+  }
+
+  bool Contains(std::span<const std::byte> buffer) const {
+    return IndexOf(buffer) != kBufferCount;
+  }
+
+  // The number of buffers that are currently acquired.
+  size_t in_use() const {
+    size_t count = 0;
+    for (const std::atomic<bool>& in_use : in_use_) {
+      count += in_use.load(std::memory_order_relaxed) ? 1 : 0;
+    }
+    return count;
+  }
+
+  // Returns the index of the buffer that contains the span, or kBufferCount if
+  // it is not from this pool.
+  size_t IndexOf(std::span<const std::byte> buffer) const {
+    const std::byte* const start = buffers_[0].data();
+    if (buffer.data() < start ||
+        buffer.data() >= start + kBufferCount * kBufferSize) {
+      return kBufferCount;
+    }
+    return static_cast<size_t>(buffer.data() - start) / kBufferSize;
+  }
+
+ private:
+  std::array<std::array<std::byte, kBufferSize>, kBufferCount> buffers_;
+  std::array<std::atomic<bool>, kBufferCount> in_use_;
+};
+
+}  // namespace pw::rpc::internal
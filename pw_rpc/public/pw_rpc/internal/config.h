@@ -16,6 +16,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 
 // The Nanopb-based pw_rpc implementation allocates memory to use for Nanopb
 // structs for the request and response protobufs. The template function that
@@ -55,3 +56,53 @@ inline constexpr size_t kNanopbStructMinBufferSize =
 #endif  // PW_RPC_NANOPB_STRUCT_BUFFER_STACK_ALLOCATE
 
 #undef PW_RPC_NANOPB_STRUCT_BUFFER_STACK_ALLOCATE
+
+// The RPC server caches channels in an open-addressed table by channel ID, so
+// finding a packet's channel does not scan all channels. This sets the number
+// of table entries. Channels beyond this count are still found by scanning.
+// Set this to a power of 2 that is at least the number of channels used; a table
+// of 0 entries disables the cache.
+#ifndef PW_RPC_CHANNEL_TABLE_SIZE
+#define PW_RPC_CHANNEL_TABLE_SIZE 8
+#endif  // PW_RPC_CHANNEL_TABLE_SIZE
+
+namespace pw::rpc::cfg {
+
+inline constexpr size_t kChannelTableSize = PW_RPC_CHANNEL_TABLE_SIZE;
+
+}  // namespace pw::rpc::cfg
+
+#undef PW_RPC_CHANNEL_TABLE_SIZE
+
+// pw::rpc::ClientDeadlines tracks call deadlines in a pw::chrono::TimerWheel.
+// This sets the length of one timer wheel tick, in milliseconds. Call deadlines
+// are rounded up to a whole tick, so calls may time out up to this much late.
+#ifndef PW_RPC_CLIENT_DEADLINE_RESOLUTION_MS
+#define PW_RPC_CLIENT_DEADLINE_RESOLUTION_MS 10
+#endif  // PW_RPC_CLIENT_DEADLINE_RESOLUTION_MS
+
+namespace pw::rpc::cfg {
+
+inline constexpr int64_t kClientDeadlineResolutionMs =
+    PW_RPC_CLIENT_DEADLINE_RESOLUTION_MS;
+
+}  // namespace pw::rpc::cfg
+
+#undef PW_RPC_CLIENT_DEADLINE_RESOLUTION_MS
+
+// The RPC client indexes active calls in an open-addressed table by channel,
+// service, and method ID, so finding the call for a response does not scan all
+// calls. This sets the number of table entries. Calls beyond this count are
+// still found by scanning. Set this to a power of 2 that is at least the number
+// of calls that are active at once; a table of 0 entries disables the index.
+#ifndef PW_RPC_CLIENT_CALL_TABLE_SIZE
+#define PW_RPC_CLIENT_CALL_TABLE_SIZE 8
+#endif  // PW_RPC_CLIENT_CALL_TABLE_SIZE
+
+namespace pw::rpc::cfg {
+
+inline constexpr size_t kClientCallTableSize = PW_RPC_CLIENT_CALL_TABLE_SIZE;
+
+}  // namespace pw::rpc::cfg
+
+#undef PW_RPC_CLIENT_CALL_TABLE_SIZE
@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string_view>
 
 #include "pw_preprocessor/compiler.h"
@@ -44,4 +46,30 @@ constexpr uint32_t Hash(std::string_view string)
   return hash;
 }
 
+// Returns the index of a 32-bit key in a table of kTableSize entries. This is
+// Fibonacci hashing: the key is multiplied by 2^32 divided by the golden ratio,
+// and the index is the top log2(kTableSize) bits of the product. The top bits
+// depend on every bit of the key, so small sequential keys such as channel IDs
+// are spread over the table.
+//
+// kTableSize must be a power of 2. Tables of 0 or 1 entries always use index 0.
+template <size_t kTableSize>
+constexpr size_t TableIndex(uint32_t key)
+    PW_NO_SANITIZE("unsigned-integer-overflow") {
+  static_assert((kTableSize & (kTableSize - 1)) == 0,
+                "Hash table sizes must be a power of 2");
+  static_assert(kTableSize <= (size_t(1) << 31),
+                "Hash table sizes must fit in 32 bits");
+
+  if constexpr (kTableSize <= 1) {
+    return 0;
+  } else {
+    int index_bits = 0;
+    while ((size_t(1) << index_bits) < kTableSize) {
+      index_bits += 1;
+    }
+    return static_cast<uint32_t>(key * 2654435761u) >> (32 - index_bits);
+  }
+}
+
 }  // namespace pw::rpc::internal
@@ -83,6 +83,9 @@ class Packet {
         status_(status) {}
 
   // Encodes the packet into its wire format. Returns the encoded size.
+  //
+  // If the payload was already written into the buffer at PayloadOffset(), the
+  // other fields are written in front of it and the payload is not copied.
   Result<ConstByteSpan> Encode(ByteSpan buffer) const;
 
   // Determines the space required to encode the packet proto fields for a
@@ -90,6 +93,12 @@ class Packet {
   // reserved space and available space for the payload.
   size_t MinEncodedSizeBytes() const;
 
+  // Returns where to write the payload in a buffer of the given size so that
+  // Encode() can encode the packet in place. This is MinEncodedSizeBytes(),
+  // plus room for the payload length of the largest payload that fits. Returns
+  // the buffer size if the fields do not fit.
+  size_t PayloadOffset(size_t buffer_size) const;
+
   enum Destination : bool { kServer, kClient };
 
   constexpr Destination destination() const {
@@ -115,6 +124,10 @@ class Packet {
   constexpr void set_status(Status status) { status_ = status; }
 
  private:
+  // Writes the fields in front of a payload that is already at the end of the
+  // packet buffer.
+  ConstByteSpan EncodeInPlace(ByteSpan packet) const;
+
   PacketType type_;
   uint32_t channel_id_;
   uint32_t service_id_;
@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include "pw_rpc/internal/packet.h"
 #include "pw_rpc/server.h"
 
 namespace pw::rpc::internal {
@@ -25,9 +26,20 @@ class Server : public rpc::Server {
     writers().push_front(writer);
   }
 
-  void RemoveWriter(const BaseServerWriter& writer) {
+  void RemoveWriter(BaseServerWriter& writer) {
     writers().remove(writer);
   }
+
+  // Reports a packet that was sent for a method call to the method observer,
+  // if there is one.
+  void PacketSent(const Packet& packet) const {
+    if (MethodObserver* observer = method_observer(); observer != nullptr) {
+      observer->ResponseSent(packet.service_id(),
+                             packet.method_id(),
+                             packet.payload().size(),
+                             packet.status());
+    }
+  }
 };
 
 }  // namespace pw::rpc::internal
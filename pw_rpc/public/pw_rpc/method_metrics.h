@@ -0,0 +1,174 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_metric/metric.h"
+#include "pw_rpc/method_observer.h"
+
+namespace pw::rpc {
+
+// MethodObserver that records per-method statistics as pw_metric metrics, so
+// they can be read remotely through the MetricService. Each method gets a
+// metric group named by its method ID with its call count, request and
+// response bytes, error count, total handler time, and a histogram of handler
+// durations. Up to kMaxMethods methods are tracked; calls to further methods
+// are only counted in untracked_calls. Handlers are timed from RequestReceived
+// to HandlerReturned with the given clock, which defaults to the system clock.
+//
+// Add metrics() to the group served by the MetricService and install the
+// MethodMetrics with Server::set_method_observer(). The metrics are not
+// synchronized, so the server must process packets and send responses from one
+// thread at a time.
+template <size_t kMaxMethods>
+class MethodMetrics : public MethodObserver {
+ public:
+  explicit MethodMetrics(chrono::VirtualSystemClock& clock =
+                             chrono::VirtualSystemClock::RealClock())
+      : clock_(clock) {}
+
+  MethodMetrics(const MethodMetrics&) = delete;
+  MethodMetrics& operator=(const MethodMetrics&) = delete;
+
+  metric::Group& metrics() { return metrics_; }
+  const metric::Group& metrics() const { return metrics_; }
+
+  void RequestReceived(uint32_t service_id,
+                       uint32_t method_id,
+                       size_t payload_size) override {
+    if (Method* method = FindOrAdd(service_id, method_id); method != nullptr) {
+      method->calls.Increment();
+      method->bytes_in.Increment(Saturate(payload_size));
+    } else {
+      untracked_calls_.Increment();
+    }
+
+    // The server invokes the handler right after reporting the request.
+    handler_start_ = clock_.now();
+  }
+
+  void HandlerReturned(uint32_t service_id, uint32_t method_id) override {
+    const chrono::SystemClock::time_point end = clock_.now();
+
+    Method* method = Find(service_id, method_id);
+    if (method == nullptr) {
+      return;
+    }
+
+    const int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(
+                           end - handler_start_)
+                           .count();
+    method->handler_us.Increment(Saturate(us < 0 ? 0 : us));
+
+    if (us < 100) {
+      method->handler_under_100us.Increment();
+    } else if (us < 1'000) {
+      method->handler_under_1ms.Increment();
+    } else if (us < 10'000) {
+      method->handler_under_10ms.Increment();
+    } else if (us < 100'000) {
+      method->handler_under_100ms.Increment();
+    } else {
+      method->handler_over_100ms.Increment();
+    }
+  }
+
+  void ResponseSent(uint32_t service_id,
+                    uint32_t method_id,
+                    size_t payload_size,
+                    Status status) override {
+    Method* method = Find(service_id, method_id);
+    if (method == nullptr) {
+      return;
+    }
+
+    method->bytes_out.Increment(Saturate(payload_size));
+    if (!status.ok()) {
+      method->errors.Increment();
+    }
+  }
+
+ private:
+  struct Method {
+    Method(uint32_t service, uint32_t method)
+        : service_id(service), method_id(method), group(method) {}
+
+    uint32_t service_id;
+    uint32_t method_id;
+
+    metric::Group group;
+    PW_METRIC(group, calls, "calls", 0u);
+    PW_METRIC(group, errors, "errors", 0u);
+    PW_METRIC(group, bytes_in, "bytes_in", 0u);
+    PW_METRIC(group, bytes_out, "bytes_out", 0u);
+    PW_METRIC(group, handler_us, "handler_us", 0u);
+    PW_METRIC(group, handler_under_100us, "handler_under_100us", 0u);
+    PW_METRIC(group, handler_under_1ms, "handler_under_1ms", 0u);
+    PW_METRIC(group, handler_under_10ms, "handler_under_10ms", 0u);
+    PW_METRIC(group, handler_under_100ms, "handler_under_100ms", 0u);
+    PW_METRIC(group, handler_over_100ms, "handler_over_100ms", 0u);
+  };
+
+  // Counters saturate rather than wrap when a single event is too large.
+  template <typename T>
+  static constexpr uint32_t Saturate(T value) {
+    return static_cast<uint64_t>(value) > std::numeric_limits<uint32_t>::max()
+               ? std::numeric_limits<uint32_t>::max()
+               : static_cast<uint32_t>(value);
+  }
+
+  Method* Find(uint32_t service_id, uint32_t method_id) {
+    for (std::optional<Method>& method : methods_) {
+      if (!method.has_value()) {
+        break;  // Methods are added in order, so the rest are empty.
+      }
+      if (method->service_id == service_id && method->method_id == method_id) {
+        return &method.value();
+      }
+    }
+    return nullptr;
+  }
+
+  Method* FindOrAdd(uint32_t service_id, uint32_t method_id) {
+    if (Method* method = Find(service_id, method_id); method != nullptr) {
+      return method;
+    }
+
+    for (std::optional<Method>& method : methods_) {
+      if (!method.has_value()) {
+        method.emplace(service_id, method_id);
+        metrics_.Add(method->group);
+        return &method.value();
+      }
+    }
+    return nullptr;
+  }
+
+  chrono::VirtualSystemClock& clock_;
+  chrono::SystemClock::time_point handler_start_;
+
+  PW_METRIC_GROUP(metrics_, "rpc_methods");
+  PW_METRIC(metrics_, untracked_calls_, "untracked_calls", 0u);
+
+  std::array<std::optional<Method>, kMaxMethods> methods_;
+};
+
+}  // namespace pw::rpc
@@ -0,0 +1,54 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_status/status.h"
+
+namespace pw::rpc {
+
+// Receives events for calls to a Server's methods, such as to profile which
+// methods use the most time and bandwidth. Install an observer with
+// Server::set_method_observer(). The functions are called synchronously from
+// the code that processes the request or sends the response, so they should
+// return quickly. The server does not read a clock; observers that measure
+// time, like MethodMetrics, take their own timestamps.
+class MethodObserver {
+ public:
+  virtual ~MethodObserver() = default;
+
+  // Called when a request for a method is received, before the method is
+  // invoked.
+  virtual void RequestReceived(uint32_t service_id,
+                               uint32_t method_id,
+                               size_t payload_size) = 0;
+
+  // Called when a method's handler returns, right after RequestReceived for
+  // the same call, so observers can time the handler with their own clock. For
+  // server streaming methods, this is when the handler returns, not when the
+  // stream ends.
+  virtual void HandlerReturned(uint32_t service_id, uint32_t method_id) = 0;
+
+  // Called for each packet the server successfully sends for a call to a
+  // method: responses, stream ends, and errors. The status is the one sent in
+  // the packet, which is OK for individual stream responses.
+  virtual void ResponseSent(uint32_t service_id,
+                            uint32_t method_id,
+                            size_t payload_size,
+                            Status status) = 0;
+};
+
+}  // namespace pw::rpc
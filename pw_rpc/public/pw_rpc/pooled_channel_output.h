@@ -0,0 +1,68 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <span>
+
+#include "pw_rpc/channel.h"
+#include "pw_rpc/internal/channel_output_buffer_pool.h"
+#include "pw_status/status.h"
+#include "pw_sync/mutex.h"
+
+namespace pw::rpc {
+
+// ChannelOutput with a pool of kBufferCount buffers for servers and clients
+// that send from multiple threads. Each writer acquires its own buffer, so
+// packets are encoded in parallel. The mutex is only held while Write() sends a
+// finished packet, so packets reach the transport whole and in the order they
+// are sent.
+//
+// SynchronizedChannelOutput, by contrast, holds its mutex from AcquireBuffer()
+// until the packet is sent, which serializes encoding as well.
+//
+// If every buffer is in use, AcquireBuffer() returns an empty span and the send
+// fails with RESOURCE_EXHAUSTED.
+template <size_t kBufferCount, size_t kBufferSize>
+class PooledChannelOutput : public ChannelOutput {
+ public:
+  std::span<std::byte> AcquireBuffer() final { return pool_.Acquire(); }
+
+  Status SendAndReleaseBuffer(std::span<const std::byte> buffer) final {
+    Status status;
+    if (!buffer.empty()) {
+      std::lock_guard lock(mutex_);
+      status = Write(buffer);
+    }
+    pool_.Release(buffer);
+    return status;
+  }
+
+  // The number of buffers that are currently acquired.
+  size_t buffers_in_use() const { return pool_.in_use(); }
+
+ protected:
+  constexpr PooledChannelOutput(sync::Mutex& mutex, const char* name)
+      : ChannelOutput(name), mutex_(mutex) {}
+
+ private:
+  // Sends an encoded packet. Called with the mutex held.
+  virtual Status Write(std::span<const std::byte> packet) = 0;
+
+  sync::Mutex& mutex_;
+  internal::ChannelOutputBufferPool<kBufferCount, kBufferSize> pool_;
+};
+
+}  // namespace pw::rpc
@@ -0,0 +1,194 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <string_view>
+
+#include "pw_rpc/channel.h"
+#include "pw_rpc/internal/channel_output_buffer_pool.h"
+#include "pw_rpc/internal/hash.h"
+#include "pw_status/status.h"
+#include "pw_sync/mutex.h"
+
+namespace pw::rpc {
+
+enum class Priority : uint8_t {
+  kLow = 0,
+  kNormal = 1,
+  kHigh = 2,
+};
+
+// Assigns a priority to all packets of an RPC method. The service name is the
+// full name from the .proto file, including the package (e.g.
+// "pw.rpc.EchoService").
+class MethodPriority {
+ public:
+  constexpr MethodPriority(std::string_view service,
+                           std::string_view method,
+                           Priority priority)
+      : service_id_(internal::Hash(service)),
+        method_id_(internal::Hash(method)),
+        priority_(priority) {}
+
+  constexpr uint32_t service_id() const { return service_id_; }
+  constexpr uint32_t method_id() const { return method_id_; }
+  constexpr Priority priority() const { return priority_; }
+
+ private:
+  uint32_t service_id_;
+  uint32_t method_id_;
+  Priority priority_;
+};
+
+namespace internal {
+
+// Decodes an encoded packet and returns the priority of its method. Packets for
+// methods that are not in the list, and packets that cannot be decoded, are
+// kNormal priority.
+Priority PacketPriority(std::span<const std::byte> packet,
+                        std::span<const MethodPriority> priorities);
+
+}  // namespace internal
+
+// A ChannelOutput that queues packets and sends them in priority order. Packets
+// are encoded into a pool of kBufferCount buffers, as in PooledChannelOutput.
+// Instead of being written immediately, sent packets wait in a queue until the
+// transport calls Flush() or SendNext(). The highest priority packet is written
+// first; packets of the same priority are written in the order they were sent.
+//
+// Priority is strict: low priority packets wait as long as higher priority
+// packets are queued.
+template <size_t kBufferCount, size_t kBufferSize>
+class PrioritizedChannelOutput : public ChannelOutput {
+ public:
+  std::span<std::byte> AcquireBuffer() final { return pool_.Acquire(); }
+
+  // Queues the packet. The buffer is released after the packet is written.
+  Status SendAndReleaseBuffer(std::span<const std::byte> buffer) final {
+    if (buffer.empty()) {
+      pool_.Release(buffer);
+      return OkStatus();
+    }
+
+    const size_t index = pool_.IndexOf(buffer);
+    if (index == kBufferCount) {
+      return Status::InvalidArgument();
+    }
+
+    const Priority priority = internal::PacketPriority(buffer, priorities_);
+    {
+      std::lock_guard lock(mutex_);
+      Entry& entry = queue_[index];
+      entry.packet = buffer;
+      entry.priority = priority;
+      entry.sequence = next_sequence_++;
+    }
+    OnPacketQueued();
+    return OkStatus();
+  }
+
+  // Writes the highest priority queued packet. Returns NOT_FOUND if no packets
+  // are queued, or the status from Write(). Must only be called from one
+  // thread at a time.
+  Status SendNext() {
+    std::span<const std::byte> packet;
+    {
+      std::lock_guard lock(mutex_);
+      Entry* next = nullptr;
+      for (Entry& entry : queue_) {
+        if (!entry.packet.empty() &&
+            (next == nullptr || entry.priority > next->priority ||
+             (entry.priority == next->priority &&
+              static_cast<int32_t>(entry.sequence - next->sequence) < 0))) {
+          next = &entry;
+        }
+      }
+      if (next == nullptr) {
+        return Status::NotFound();
+      }
+      packet = next->packet;
+      next->packet = {};
+    }
+
+    const Status status = Write(packet);
+    pool_.Release(packet);
+    return status;
+  }
+
+  // Writes queued packets until the queue is empty. Packets that are queued
+  // while flushing are written in priority order with the rest. Returns the
+  // first error from Write(); packets that fail to write are dropped.
+  Status Flush() {
+    Status result;
+    while (true) {
+      const Status status = SendNext();
+      if (status.IsNotFound()) {
+        return result;
+      }
+      if (result.ok()) {
+        result = status;
+      }
+    }
+  }
+
+  // The number of packets waiting to be written.
+  size_t packets_queued() const {
+    std::lock_guard lock(mutex_);
+    size_t count = 0;
+    for (const Entry& entry : queue_) {
+      count += entry.packet.empty() ? 0 : 1;
+    }
+    return count;
+  }
+
+  // The number of buffers that are acquired or queued.
+  size_t buffers_in_use() const { return pool_.in_use(); }
+
+ protected:
+  constexpr PrioritizedChannelOutput(sync::Mutex& mutex,
+                                     const char* name,
+                                     std::span<const MethodPriority> priorities)
+      : ChannelOutput(name),
+        mutex_(mutex),
+        priorities_(priorities),
+        queue_{},
+        next_sequence_(0) {}
+
+ private:
+  struct Entry {
+    std::span<const std::byte> packet;
+    Priority priority;
+    uint32_t sequence;
+  };
+
+  // Sends an encoded packet. Called from SendNext() without the mutex held.
+  virtual Status Write(std::span<const std::byte> packet) = 0;
+
+  // Called after a packet is queued, in the context of the thread that sent
+  // it. Transports may use this to wake the thread that calls Flush().
+  virtual void OnPacketQueued() {}
+
+  sync::Mutex& mutex_;
+  const std::span<const MethodPriority> priorities_;
+  internal::ChannelOutputBufferPool<kBufferCount, kBufferSize> pool_;
+  std::array<Entry, kBufferCount> queue_;
+  uint32_t next_sequence_;
+};
+
+}  // namespace pw::rpc
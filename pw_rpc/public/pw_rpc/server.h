@@ -13,15 +13,21 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <span>
 #include <tuple>
 
+#include "pw_containers/intrusive_doubly_linked_list.h"
 #include "pw_containers/intrusive_list.h"
 #include "pw_rpc/channel.h"
 #include "pw_rpc/internal/base_server_writer.h"
 #include "pw_rpc/internal/channel.h"
+#include "pw_rpc/internal/config.h"
+#include "pw_rpc/internal/hash.h"
 #include "pw_rpc/internal/method.h"
+#include "pw_rpc/method_observer.h"
 #include "pw_rpc/service.h"
 #include "pw_status/status.h"
 
@@ -31,13 +37,19 @@ class Server {
  public:
   constexpr Server(std::span<Channel> channels)
       : channels_(static_cast<internal::Channel*>(channels.data()),
-                  channels.size()) {}
+                  channels.size()),
+        channel_table_{},
+        channel_lookup_misses_(0),
+        method_observer_(nullptr) {}
 
   ~Server();
 
   // Registers a service with the server. This should not be called directly
   // with a Service; instead, use a generated class which inherits from it.
-  void RegisterService(Service& service) { services_.push_front(service); }
+  void RegisterService(Service& service) {
+    service.methods_sorted_ = service.MethodsSorted();
+    services_.push_front(service);
+  }
 
   // Processes an RPC packet. The packet may contain an RPC request or a control
   // packet, the result of which is processed in this function. Returns whether
@@ -52,23 +64,60 @@ class Server {
 
   constexpr size_t channel_count() const { return channels_.size(); }
 
+  // The number of packets whose channel was not in the channel table, so the
+  // channels were scanned. This includes packets for unknown channels.
+  uint32_t channel_lookup_misses() const { return channel_lookup_misses_; }
+
+  // Sets an observer that is notified of requests, handler durations, and
+  // responses for every method call. Pass nullptr to remove the observer. The
+  // observer must outlive the server or be removed before it is destroyed.
+  void set_method_observer(MethodObserver* observer) {
+    method_observer_ = observer;
+  }
+
  protected:
-  IntrusiveList<internal::BaseServerWriter>& writers() { return writers_; }
+  IntrusiveDoublyLinkedList<internal::BaseServerWriter>& writers() {
+    return writers_;
+  }
+
+  MethodObserver* method_observer() const { return method_observer_; }
 
  private:
   std::tuple<Service*, const internal::Method*> FindMethod(
       const internal::Packet& packet);
 
+  IntrusiveDoublyLinkedList<internal::BaseServerWriter>::iterator FindWriter(
+      const internal::Packet& packet);
+
   void HandleCancelPacket(const internal::Packet& request,
                           internal::Channel& channel);
+  void HandleClientStream(const internal::Packet& packet,
+                          internal::Channel& channel);
+  void HandleStreamCredit(const internal::Packet& packet,
+                          internal::Channel& channel);
   void HandleClientError(const internal::Packet& packet);
 
-  internal::Channel* FindChannel(uint32_t id) const;
+  internal::Channel* FindChannel(uint32_t id);
   internal::Channel* AssignChannel(uint32_t id, ChannelOutput& interface);
 
+  // Adds a channel to the channel table, if there is an empty entry.
+  void AddToChannelTable(internal::Channel& channel);
+
+  static constexpr size_t ChannelTableIndex(uint32_t id) {
+    return internal::TableIndex<cfg::kChannelTableSize>(id);
+  }
+
   std::span<internal::Channel> channels_;
+
+  // Open-addressed table of pointers into channels_, indexed by channel ID
+  // with linear probing. Channel IDs only change when an unassigned channel is
+  // assigned, and unassigned channels are not in the table, so entries are
+  // never removed.
+  std::array<internal::Channel*, cfg::kChannelTableSize> channel_table_;
+  uint32_t channel_lookup_misses_;
   IntrusiveList<Service> services_;
-  IntrusiveList<internal::BaseServerWriter> writers_;
+  IntrusiveDoublyLinkedList<internal::BaseServerWriter> writers_;
+  MethodObserver* method_observer_;
 };
 
 }  // namespace pw::rpc
@@ -0,0 +1,46 @@
+// Copyright 2020 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_metric/metric.h"
+#include "pw_rpc/server.h"
+
+namespace pw::rpc {
+
+// Exports a Server's counters as pw_metric metrics, so they can be reported
+// remotely through the MetricService. Add metrics() to the group served by the
+// MetricService, and call Update() to copy the server's current counters into
+// the metrics, such as before the metrics are read.
+class ServerMetrics {
+ public:
+  ServerMetrics(const Server& server) : server_(server) {}
+
+  ServerMetrics(const ServerMetrics&) = delete;
+  ServerMetrics& operator=(const ServerMetrics&) = delete;
+
+  metric::Group& metrics() { return metrics_; }
+  const metric::Group& metrics() const { return metrics_; }
+
+  void Update() {
+    channel_lookup_misses_.Set(server_.channel_lookup_misses());
+  }
+
+ private:
+  const Server& server_;
+
+  PW_METRIC_GROUP(metrics_, "rpc_server");
+  PW_METRIC(metrics_, channel_lookup_misses_, "channel_lookup_misses", 0u);
+};
+
+}  // namespace pw::rpc
@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <span>
@@ -39,26 +40,44 @@ class Service : public IntrusiveList<Service>::Item {
       : id_(id),
         methods_(methods.data()),
         method_size_(sizeof(T)),
-        method_count_(static_cast<uint16_t>(method_count)) {
+        method_count_(static_cast<uint16_t>(method_count)),
+        methods_sorted_(false) {
     static_assert(method_count <= std::numeric_limits<uint16_t>::max());
   }
 
   // For use by tests with only one method.
   template <typename T>
   constexpr Service(uint32_t id, const T& method)
-      : id_(id), methods_(&method), method_size_(sizeof(T)), method_count_(1) {}
+      : id_(id),
+        methods_(&method),
+        method_size_(sizeof(T)),
+        method_count_(1),
+        methods_sorted_(false) {}
 
  private:
   friend class Server;
   friend class ServiceTestHelper;
 
+  // True if the methods are in ascending order of ID, as generated services
+  // list them, so they can be binary searched. Checked when the service is
+  // registered, once the methods are initialized.
+  bool MethodsSorted() const;
+
   // Finds the method with the provided method_id. Returns nullptr if no match.
   const internal::Method* FindMethod(uint32_t method_id) const;
 
+  const internal::Method& MethodAt(size_t index) const {
+    const auto raw = reinterpret_cast<const std::byte*>(methods_);
+    return reinterpret_cast<const internal::MethodUnion*>(
+               raw + index * method_size_)
+        ->method();
+  }
+
   const uint32_t id_;
   const internal::MethodUnion* const methods_;
   const uint16_t method_size_;
   const uint16_t method_count_;
+  bool methods_sorted_;
 };
 
 }  // namespace pw::rpc
@@ -27,6 +27,7 @@
 #include "pw_rpc/internal/method.h"
 #include "pw_rpc/internal/packet.h"
 #include "pw_rpc/internal/server.h"
+#include "pw_rpc/method_observer.h"
 
 namespace pw::rpc {
 
@@ -75,6 +76,43 @@ class TestOutput : public ChannelOutput {
   Status send_status_;
 };
 
+// MethodObserver that records the events it receives.
+class TestMethodObserver : public MethodObserver {
+ public:
+  void RequestReceived(uint32_t service_id,
+                       uint32_t method_id,
+                       size_t payload_size) override {
+    requests += 1;
+    last_service_id = service_id;
+    last_method_id = method_id;
+    request_bytes += payload_size;
+  }
+
+  void HandlerReturned(uint32_t, uint32_t) override {
+    handlers_returned += 1;
+  }
+
+  void ResponseSent(uint32_t service_id,
+                    uint32_t method_id,
+                    size_t payload_size,
+                    Status status) override {
+    responses += 1;
+    last_service_id = service_id;
+    last_method_id = method_id;
+    response_bytes += payload_size;
+    last_status = status;
+  }
+
+  size_t requests = 0;
+  size_t handlers_returned = 0;
+  size_t responses = 0;
+  size_t request_bytes = 0;
+  size_t response_bytes = 0;
+  uint32_t last_service_id = 0;
+  uint32_t last_method_id = 0;
+  Status last_status;
+};
+
 // Version of the internal::Server with extra methods exposed for testing.
 class TestServer : public internal::Server {
  public:
@@ -111,7 +149,20 @@ class ServerContextForTest {
                             OkStatus());
   }
 
+  // Sends a packet for this context's method to the server, such as a request
+  // in a client stream. Returns the server's ProcessPacket status.
+  Status SendPacket(internal::PacketType type,
+                    std::span<const std::byte> payload = {}) {
+    internal::Packet packet(
+        type, kChannelId, kServiceId, context_.method().id(), payload);
+    std::byte buffer[output_buffer_size];
+    Result result = packet.Encode(buffer);
+    EXPECT_EQ(result.status(), OkStatus());
+    return server_.ProcessPacket(result.value_or(ConstByteSpan()), output_);
+  }
+
   internal::ServerCall& get() { return context_; }
+  auto& output() { return output_; }
   const auto& output() const { return output_; }
   TestServer& server() { return static_cast<TestServer&>(server_); }
 
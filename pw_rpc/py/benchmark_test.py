@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+# Copyright 2021 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Tests the RPC benchmark driver."""
+
+from types import SimpleNamespace
+import unittest
+
+from pw_status import Status
+
+from pw_rpc.benchmark import Benchmark, BenchmarkError, percentile
+
+
+class _FakeTimer:
+    """Advances by one second each time it is read."""
+    def __init__(self):
+        self.now = 0.0
+
+    def __call__(self) -> float:
+        self.now += 1.0
+        return self.now
+
+
+class _FakeStream:
+    def __init__(self, responses, status: Status):
+        self._responses = responses
+        self.status = status
+
+    def __iter__(self):
+        return iter(self._responses)
+
+
+class _FakeService:
+    def __init__(self, status: Status = Status.OK):
+        self.status = status
+        self.unary_calls = 0
+
+    def UnaryEcho(self, payload: bytes):  # pylint: disable=invalid-name
+        self.unary_calls += 1
+        return self.status, SimpleNamespace(payload=payload)
+
+    def ServerStream(self, count: int, size: int):  # pylint: disable=invalid-name
+        return _FakeStream(
+            [SimpleNamespace(payload=bytes(size)) for _ in range(count)],
+            self.status)
+
+
+class PercentileTest(unittest.TestCase):
+    """Tests the percentile function."""
+    def test_single_sample(self):
+        self.assertEqual(percentile([5.0], 50), 5.0)
+        self.assertEqual(percentile([5.0], 99), 5.0)
+
+    def test_nearest_rank(self):
+        samples = list(range(100, 0, -1))
+        self.assertEqual(percentile(samples, 50), 50)
+        self.assertEqual(percentile(samples, 99), 99)
+        self.assertEqual(percentile(samples, 100), 100)
+
+    def test_empty(self):
+        with self.assertRaises(ValueError):
+            percentile([], 50)
+
+
+class BenchmarkTest(unittest.TestCase):
+    """Tests the Benchmark class with a fake service."""
+    def setUp(self):
+        self._service = _FakeService()
+        self._benchmark = Benchmark(self._service, _FakeTimer())
+
+    def test_unary_latency(self):
+        result = self._benchmark.unary_latency(size=8, iterations=10)
+
+        self.assertEqual(self._service.unary_calls, 10)
+        self.assertEqual(len(result.samples), 10)
+        self.assertEqual(result.p50, 1.0)
+        self.assertEqual(result.p99, 1.0)
+
+    def test_unary_latency_error(self):
+        self._service.status = Status.UNAVAILABLE
+
+        with self.assertRaises(BenchmarkError):
+            self._benchmark.unary_latency(size=8, iterations=1)
+
+    def test_stream_throughput(self):
+        result = self._benchmark.stream_throughput(count=4, size=250_000)
+
+        self.assertEqual(result.responses, 4)
+        self.assertEqual(result.payload_bytes, 1_000_000)
+        self.assertEqual(result.seconds, 1.0)
+        self.assertEqual(result.megabytes_per_second, 1.0)
+
+    def test_stream_throughput_error(self):
+        self._service.status = Status.RESOURCE_EXHAUSTED
+
+        with self.assertRaises(BenchmarkError):
+            self._benchmark.stream_throughput(count=1, size=1)
+
+
+if __name__ == '__main__':
+    unittest.main()
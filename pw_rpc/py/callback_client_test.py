@@ -114,6 +114,18 @@ class CallbackClientImplTest(unittest.TestCase):
                                   status=status.value).SerializeToString(),
              process_status))
 
+    def _enqueue_response_batch(self, channel_id: int, method, responses):
+        batch = packet_pb2.ResponseBatch(
+            payloads=[r.SerializeToString() for r in responses])
+        self._next_packets.append(
+            (packet_pb2.RpcPacket(
+                type=packets.PacketType.RESPONSE_BATCH,
+                channel_id=channel_id,
+                service_id=method.service.id,
+                method_id=method.id,
+                payload=batch.SerializeToString()).SerializeToString(),
+             Status.OK))
+
     def _handle_request(self, data: bytes):
         # Disable this method to prevent infinite recursion if processing the
         # packet happens to send another packet.
@@ -236,6 +248,20 @@ class CallbackClientImplTest(unittest.TestCase):
                 4,
                 self._sent_payload(method.request_type).magic_number)
 
+    def test_invoke_server_streaming_batched_responses(self):
+        method = self._service.SomeServerStreaming.method
+
+        rep1 = method.response_type(payload='!!!')
+        rep2 = method.response_type(payload='?')
+
+        self._enqueue_response_batch(1, method, [rep1, rep2])
+        self._enqueue_response(1, method, response=rep1)
+        self._enqueue_stream_end(1, method, Status.ABORTED)
+
+        self.assertEqual(
+            [rep1, rep2, rep1],
+            list(self._service.SomeServerStreaming(magic_number=4)))
+
     def test_invoke_server_streaming_with_callback(self):
         method = self._service.SomeServerStreaming.method
 
@@ -291,6 +317,21 @@ class CallbackClientImplTest(unittest.TestCase):
             mock.call(rpc, Status.OK, None),
         ])
 
+    def test_invoke_server_streaming_grant_credits(self):
+        stub = self._service.SomeServerStreaming
+
+        call = stub.invoke(mock.Mock(), magic_number=3)
+        self.assertTrue(call.grant_credits(5))
+
+        self.assertEqual(self._last_request.type,
+                         packets.PacketType.STREAM_CREDIT)
+        self.assertEqual(
+            packets.decode_payload(self._last_request,
+                                   packet_pb2.StreamCredit).responses, 5)
+
+        call.cancel()
+        self.assertFalse(call.grant_credits(5))
+
     def test_ignore_bad_packets_with_pending_rpc(self):
         rpcs = self._client.channel(1).rpcs
         method = rpcs.pw.test1.PublicService.SomeUnary.method
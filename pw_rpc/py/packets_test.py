@@ -17,7 +17,7 @@
 import unittest
 
 from pw_status import Status
-from pw_rpc_protos.packet_pb2 import RpcPacket
+from pw_rpc_protos.packet_pb2 import ResponseBatch, RpcPacket, StreamCredit
 
 from pw_rpc import packets
 
@@ -63,6 +63,21 @@ class PacketsTest(unittest.TestCase):
                       service_id=8,
                       method_id=7))
 
+    def test_encode_stream_credit(self):
+        data = packets.encode_stream_credit((9, 8, 7), 300)
+
+        packet = RpcPacket()
+        packet.ParseFromString(data)
+
+        self.assertEqual(
+            packet,
+            RpcPacket(type=packets.PacketType.STREAM_CREDIT,
+                      channel_id=9,
+                      service_id=8,
+                      method_id=7,
+                      payload=StreamCredit(
+                          responses=300).SerializeToString()))
+
     def test_encode_client_error(self):
         data = packets.encode_client_error(_TEST_REQUEST, Status.NOT_FOUND)
 
@@ -81,6 +96,23 @@ class PacketsTest(unittest.TestCase):
         self.assertEqual(_TEST_REQUEST,
                          packets.decode(_TEST_REQUEST.SerializeToString()))
 
+    def test_unbatch(self):
+        payloads = [b'abc', b'', b'de']
+        batch = RpcPacket(
+            type=packets.PacketType.RESPONSE_BATCH,
+            channel_id=1,
+            service_id=2,
+            method_id=3,
+            payload=ResponseBatch(payloads=payloads).SerializeToString())
+
+        self.assertEqual([
+            RpcPacket(type=packets.PacketType.RESPONSE,
+                      channel_id=1,
+                      service_id=2,
+                      method_id=3,
+                      payload=payload) for payload in payloads
+        ], packets.unbatch(batch))
+
     def test_for_server(self):
         self.assertTrue(packets.for_server(_TEST_REQUEST))
 
@@ -0,0 +1,120 @@
+# Copyright 2021 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Measures RPC latency and throughput with the pw.rpc.Benchmark service.
+
+The Benchmark class takes the service's method clients, so it works with any
+transport. For example, with an HdlcRpcClient:
+
+  benchmark = Benchmark(client.rpcs().pw.rpc.Benchmark)
+  print(benchmark.unary_latency(size=64, iterations=1000))
+  print(benchmark.stream_throughput(count=1000, size=200))
+
+Times are measured on the client with time.perf_counter.
+"""
+
+import math
+import time
+from typing import Any, Callable, NamedTuple, Sequence
+
+
+class BenchmarkError(Exception):
+    """Raised when a benchmark RPC fails."""
+
+
+def percentile(samples: Sequence[float], percent: float) -> float:
+    """Returns the nearest-rank percentile of the samples."""
+    if not samples:
+        raise ValueError('At least one sample is required')
+
+    ordered = sorted(samples)
+    rank = math.ceil(percent / 100 * len(ordered))
+    return ordered[max(rank, 1) - 1]
+
+
+class LatencyResult(NamedTuple):
+    """Round-trip times of unary calls, in seconds."""
+    size: int
+    samples: Sequence[float]
+
+    @property
+    def p50(self) -> float:
+        return percentile(self.samples, 50)
+
+    @property
+    def p99(self) -> float:
+        return percentile(self.samples, 99)
+
+    def __str__(self) -> str:
+        return (f'{len(self.samples)} calls with {self.size} B payloads: '
+                f'p50 {self.p50 * 1e6:.0f} us, p99 {self.p99 * 1e6:.0f} us')
+
+
+class ThroughputResult(NamedTuple):
+    """Payload bytes received in a server stream and how long it took."""
+    responses: int
+    payload_bytes: int
+    seconds: float
+
+    @property
+    def megabytes_per_second(self) -> float:
+        if self.seconds <= 0:
+            return 0.0
+        return self.payload_bytes / self.seconds / 1e6
+
+    def __str__(self) -> str:
+        return (f'{self.responses} responses, {self.payload_bytes} B in '
+                f'{self.seconds:.3f} s: {self.megabytes_per_second:.3f} MB/s')
+
+
+class Benchmark:
+    """Runs benchmarks against a pw.rpc.Benchmark service client."""
+    def __init__(self,
+                 service: Any,
+                 timer: Callable[[], float] = time.perf_counter):
+        self._service = service
+        self._timer = timer
+
+    def unary_latency(self, size: int, iterations: int) -> LatencyResult:
+        """Times UnaryEcho calls with a payload of the given size."""
+        payload = bytes(size)
+        samples = []
+
+        for _ in range(iterations):
+            start = self._timer()
+            status, response = self._service.UnaryEcho(payload=payload)
+            samples.append(self._timer() - start)
+
+            if not status.ok():
+                raise BenchmarkError(f'UnaryEcho failed with {status}')
+            if response.payload != payload:
+                raise BenchmarkError('UnaryEcho returned the wrong payload')
+
+        return LatencyResult(size, samples)
+
+    def stream_throughput(self, count: int, size: int) -> ThroughputResult:
+        """Times a ServerStream call of count responses of the given size."""
+        responses = 0
+        payload_bytes = 0
+
+        start = self._timer()
+        call = self._service.ServerStream(count=count, size=size)
+        for response in call:
+            responses += 1
+            payload_bytes += len(response.payload)
+        seconds = self._timer() - start
+
+        if not call.status.ok():
+            raise BenchmarkError(f'ServerStream failed with {call.status}')
+
+        return ThroughputResult(responses, payload_bytes, seconds)
@@ -151,6 +151,10 @@ class _AsyncCall:
     def cancel(self) -> bool:
         return self._rpcs.send_cancel(self.rpc)
 
+    def grant_credits(self, responses: int) -> bool:
+        """Allows a flow controlled server stream to send more responses."""
+        return self._rpcs.send_stream_credit(self.rpc, responses)
+
     def __enter__(self) -> '_AsyncCall':
         return self
 
@@ -107,6 +107,19 @@ class PendingRpcs:
 
         return True
 
+    def send_stream_credit(self, rpc: PendingRpc, responses: int) -> bool:
+        """Allows a flow controlled server stream to send more responses.
+
+        Returns:
+          True if the credit was sent; False if the RPC was not pending
+        """
+        if rpc not in self._pending:
+            return False
+
+        rpc.channel.output(  # type: ignore
+            packets.encode_stream_credit(rpc, responses))
+        return True
+
     def get_pending(self, rpc: PendingRpc, status: Optional[Status]):
         """Gets the pending RPC's context. If status is set, clears the RPC."""
         if status is None:
@@ -337,6 +350,9 @@ class Client:
           DATA_LOSS - the packet could not be decoded
           INVALID_ARGUMENT - the packet is for a server, not a client
           NOT_FOUND - the packet's channel ID is not known to this client
+
+        A RESPONSE_BATCH packet is processed as a RESPONSE packet for each of
+        its responses.
         """
         try:
             packet = packets.decode(pw_rpc_raw_packet_data)
@@ -354,6 +370,25 @@ class Client:
             _LOG.warning('Unrecognized channel ID %d', packet.channel_id)
             return Status.NOT_FOUND
 
+        if packet.type == PacketType.RESPONSE_BATCH:
+            try:
+                responses = packets.unbatch(packet)
+            except packets.DecodeError as err:
+                _LOG.warning('Failed to decode response batch: %s', err)
+                return Status.DATA_LOSS
+
+            for response in responses:
+                self._process_packet(response, channel_client, impl_args,
+                                     impl_kwargs)
+            return Status.OK
+
+        return self._process_packet(packet, channel_client, impl_args,
+                                    impl_kwargs)
+
+    def _process_packet(self, packet: RpcPacket,
+                        channel_client: ChannelClient, impl_args: tuple,
+                        impl_kwargs: dict) -> Status:
+        """Processes a decoded packet for a known channel."""
         try:
             rpc = self._look_up_service_and_method(packet, channel_client)
         except ValueError as err:
@@ -15,7 +15,7 @@
 
 from datetime import datetime
 import os
-from typing import cast, Any, Callable, Iterable
+from typing import cast, Any, Callable, Iterable, List, NamedTuple
 
 from pw_protobuf.output_file import OutputFile
 from pw_protobuf.proto_tree import ProtoNode, ProtoService, ProtoServiceMethod
@@ -34,6 +34,9 @@ STUB_RESPONSE_TODO = (
 STUB_WRITER_TODO = (
     '// TODO: Send responses with the writer as appropriate for your '
     'application')
+STUB_READER_TODO = (
+    '// TODO: Set a handler on the reader to receive requests as appropriate '
+    'for your application')
 
 ServerWriterGenerator = Callable[[OutputFile], None]
 MethodGenerator = Callable[[ProtoServiceMethod, int, OutputFile], None]
@@ -142,7 +145,7 @@ def service_class(service: ProtoService, root: ProtoNode, output: OutputFile,
                           f' {len(service.methods())}> kMethods = {{')
 
         with output.indent(4):
-            for method in service.methods():
+            for method in _sorted_methods(service):
                 method_descriptor(method, pw_rpc.ids.calculate(method.name()),
                                   output)
 
@@ -162,7 +165,7 @@ def _method_lookup_table(service: ProtoService, output: OutputFile) -> None:
                       f'{len(service.methods())}> kMethodIds = {{')
 
     with output.indent(4):
-        for method in service.methods():
+        for method in _sorted_methods(service):
             method_id = pw_rpc.ids.calculate(method.name())
             output.write_line(
                 f'0x{method_id:08x},  // Hash of "{method.name()}"')
@@ -170,6 +173,12 @@ def _method_lookup_table(service: ProtoService, output: OutputFile) -> None:
     output.write_line('};\n')
 
 
+def _sorted_methods(service: ProtoService) -> List[ProtoServiceMethod]:
+    """Returns the methods in order of ID, so Service can binary search them."""
+    return sorted(service.methods(),
+                  key=lambda method: pw_rpc.ids.calculate(method.name()))
+
+
 StubFunction = Callable[[ProtoServiceMethod, OutputFile], None]
 
 _STUBS_COMMENT = r'''
@@ -193,9 +202,16 @@ _STUBS_COMMENT = r'''
 '''
 
 
+class StubFunctions(NamedTuple):
+    """Functions that generate the stub for each type of RPC method."""
+    unary: StubFunction
+    server_streaming: StubFunction
+    client_streaming: StubFunction
+    bidirectional_streaming: StubFunction
+
+
 def package_stubs(proto_package: ProtoNode, output: OutputFile,
-                  unary_stub: StubFunction,
-                  server_streaming_stub: StubFunction) -> None:
+                  stubs: StubFunctions) -> None:
 
     output.write_line('#ifdef _PW_RPC_COMPILE_GENERATED_SERVICE_STUBS')
     output.write_line(_STUBS_COMMENT)
@@ -211,8 +227,7 @@ def package_stubs(proto_package: ProtoNode, output: OutputFile,
 
     for node in proto_package:
         if node.type() == ProtoNode.Type.SERVICE:
-            _generate_service_stub(cast(ProtoService, node), output,
-                                   unary_stub, server_streaming_stub)
+            _generate_service_stub(cast(ProtoService, node), output, stubs)
 
     if proto_package.cpp_namespace():
         output.write_line(f'}}  // namespace {file_namespace}')
@@ -221,8 +236,7 @@ def package_stubs(proto_package: ProtoNode, output: OutputFile,
 
 
 def _generate_service_stub(service: ProtoService, output: OutputFile,
-                           unary_stub: StubFunction,
-                           server_streaming_stub: StubFunction) -> None:
+                           stubs: StubFunctions) -> None:
     output.write_line()
     output.write_line(
         f'class {service.name()} '
@@ -240,11 +254,12 @@ def _generate_service_stub(service: ProtoService, output: OutputFile,
                 blank_line = True
 
             if method.type() is ProtoServiceMethod.Type.UNARY:
-                unary_stub(method, output)
+                stubs.unary(method, output)
             elif method.type() is ProtoServiceMethod.Type.SERVER_STREAMING:
-                server_streaming_stub(method, output)
+                stubs.server_streaming(method, output)
+            elif method.type() is ProtoServiceMethod.Type.CLIENT_STREAMING:
+                stubs.client_streaming(method, output)
             else:
-                raise NotImplementedError(
-                    'Client and bidirectional streaming not yet implemented')
+                stubs.bidirectional_streaming(method, output)
 
     output.write_line('};\n')
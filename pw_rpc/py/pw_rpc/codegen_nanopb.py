@@ -59,6 +59,12 @@ def _generate_method_descriptor(method: ProtoServiceMethod, method_id: int,
 def _generate_server_writer_alias(output: OutputFile) -> None:
     output.write_line('template <typename T>')
     output.write_line('using ServerWriter = ::pw::rpc::ServerWriter<T>;')
+    output.write_line('template <typename Request, typename Response>')
+    output.write_line('using ServerReader = '
+                      '::pw::rpc::ServerReader<Request, Response>;')
+    output.write_line('template <typename Request, typename Response>')
+    output.write_line('using ServerReaderWriter = '
+                      '::pw::rpc::ServerReaderWriter<Request, Response>;')
 
 
 def _generate_code_for_service(service: ProtoService, root: ProtoNode,
@@ -76,19 +82,19 @@ def _generate_code_for_client_method(method: ProtoServiceMethod,
     res = method.response_type().nanopb_name()
     method_id = pw_rpc.ids.calculate(method.name())
 
-    if method.type() == ProtoServiceMethod.Type.UNARY:
-        callback = f'{RPC_NAMESPACE}::UnaryResponseHandler<{res}>'
-    elif method.type() == ProtoServiceMethod.Type.SERVER_STREAMING:
+    # Client and bidirectional streaming RPCs receive a single response or a
+    # stream of responses like unary and server streaming RPCs.
+    if method.server_streaming():
         callback = f'{RPC_NAMESPACE}::ServerStreamingResponseHandler<{res}>'
     else:
-        raise NotImplementedError(
-            'Only unary and server streaming RPCs are currently supported')
+        callback = f'{RPC_NAMESPACE}::UnaryResponseHandler<{res}>'
 
     output.write_line()
     output.write_line(f'static NanopbClientCall<\n    {callback}>')
     output.write_line(f'{method.name()}({RPC_NAMESPACE}::Channel& channel,')
     with output.indent(len(method.name()) + 1):
-        output.write_line(f'const {req}& request,')
+        if not method.client_streaming():
+            output.write_line(f'const {req}& request,')
         output.write_line(f'{callback}& callback) {{')
 
     with output.indent():
@@ -101,7 +107,11 @@ def _generate_code_for_client_method(method: ProtoServiceMethod,
             output.write_line('callback,')
             output.write_line(f'{req}_fields,')
             output.write_line(f'{res}_fields);')
-        output.write_line('call.SendRequest(&request);')
+        if method.client_streaming():
+            # Requests are sent with call.SendClientStreamRequest().
+            output.write_line('call.StartClientStream();')
+        else:
+            output.write_line('call.SendRequest(&request);')
         output.write_line('return call;')
 
     output.write_line('}')
@@ -192,6 +202,34 @@ def _server_streaming_stub(method: ProtoServiceMethod,
     output.write_line('}')
 
 
+def _client_streaming_stub(method: ProtoServiceMethod,
+                           output: OutputFile) -> None:
+    output.write_line(f'void {method.name()}(ServerContext&, '
+                      f'ServerReader<{method.request_type().nanopb_name()}, '
+                      f'{method.response_type().nanopb_name()}>& reader) {{')
+
+    with output.indent():
+        output.write_line(codegen.STUB_READER_TODO)
+        output.write_line('static_cast<void>(reader);')
+
+    output.write_line('}')
+
+
+def _bidirectional_streaming_stub(method: ProtoServiceMethod,
+                                  output: OutputFile) -> None:
+    output.write_line(
+        f'void {method.name()}(ServerContext&, '
+        f'ServerReaderWriter<{method.request_type().nanopb_name()}, '
+        f'{method.response_type().nanopb_name()}>& reader_writer) {{')
+
+    with output.indent():
+        output.write_line(codegen.STUB_READER_TODO)
+        output.write_line(codegen.STUB_WRITER_TODO)
+        output.write_line('static_cast<void>(reader_writer);')
+
+    output.write_line('}')
+
+
 def process_proto_file(proto_file) -> Iterable[OutputFile]:
     """Generates code for a single .proto file."""
 
@@ -201,7 +239,10 @@ def process_proto_file(proto_file) -> Iterable[OutputFile]:
     _generate_code_for_package(proto_file, package_root, output_file)
 
     output_file.write_line()
-    codegen.package_stubs(package_root, output_file, _unary_stub,
-                          _server_streaming_stub)
+    codegen.package_stubs(
+        package_root, output_file,
+        codegen.StubFunctions(_unary_stub, _server_streaming_stub,
+                              _client_streaming_stub,
+                              _bidirectional_streaming_stub))
 
     return [output_file]
@@ -52,6 +52,10 @@ def _generate_method_descriptor(method: ProtoServiceMethod, method_id: int,
 def _generate_server_writer_alias(output: OutputFile) -> None:
     output.write_line(
         f'using RawServerWriter = {RPC_NAMESPACE}::RawServerWriter;')
+    output.write_line(
+        f'using RawServerReader = {RPC_NAMESPACE}::RawServerReader;')
+    output.write_line('using RawServerReaderWriter = '
+                      f'{RPC_NAMESPACE}::RawServerReaderWriter;')
 
 
 def _generate_code_for_client(unused_service: ProtoService,
@@ -105,6 +109,31 @@ def _server_streaming_stub(method: ProtoServiceMethod,
     output.write_line('}')
 
 
+def _client_streaming_stub(method: ProtoServiceMethod,
+                           output: OutputFile) -> None:
+    output.write_line(f'void {method.name()}(ServerContext&, '
+                      'RawServerReader& reader) {')
+
+    with output.indent():
+        output.write_line(codegen.STUB_READER_TODO)
+        output.write_line('static_cast<void>(reader);')
+
+    output.write_line('}')
+
+
+def _bidirectional_streaming_stub(method: ProtoServiceMethod,
+                                  output: OutputFile) -> None:
+    output.write_line(f'void {method.name()}(ServerContext&, '
+                      'RawServerReaderWriter& reader_writer) {')
+
+    with output.indent():
+        output.write_line(codegen.STUB_READER_TODO)
+        output.write_line(codegen.STUB_WRITER_TODO)
+        output.write_line('static_cast<void>(reader_writer);')
+
+    output.write_line('}')
+
+
 def process_proto_file(proto_file) -> Iterable[OutputFile]:
     """Generates code for a single .proto file."""
 
@@ -114,7 +143,10 @@ def process_proto_file(proto_file) -> Iterable[OutputFile]:
     _generate_code_for_package(proto_file, package_root, output_file)
 
     output_file.write_line()
-    codegen.package_stubs(package_root, output_file, _unary_stub,
-                          _server_streaming_stub)
+    codegen.package_stubs(
+        package_root, output_file,
+        codegen.StubFunctions(_unary_stub, _server_streaming_stub,
+                              _client_streaming_stub,
+                              _bidirectional_streaming_stub))
 
     return [output_file]
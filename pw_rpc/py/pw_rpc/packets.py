@@ -35,6 +35,20 @@ def decode_payload(packet, payload_type):
     return payload
 
 
+def unbatch(packet) -> list:
+    """Returns a RESPONSE packet for each response in a RESPONSE_BATCH."""
+    batch = packet_pb2.ResponseBatch()
+    batch.MergeFromString(packet.payload)
+
+    return [
+        packet_pb2.RpcPacket(type=packet_pb2.PacketType.RESPONSE,
+                             channel_id=packet.channel_id,
+                             service_id=packet.service_id,
+                             method_id=packet.method_id,
+                             payload=payload) for payload in batch.payloads
+    ]
+
+
 def _ids(rpc: tuple) -> tuple:
     return tuple(item if isinstance(item, int) else item.id for item in rpc)
 
@@ -78,5 +92,16 @@ def encode_cancel(rpc: tuple) -> bytes:
         method_id=method).SerializeToString()
 
 
+def encode_stream_credit(rpc: tuple, responses: int) -> bytes:
+    channel, service, method = _ids(rpc)
+    return packet_pb2.RpcPacket(
+        type=packet_pb2.PacketType.STREAM_CREDIT,
+        channel_id=channel,
+        service_id=service,
+        method_id=method,
+        payload=packet_pb2.StreamCredit(
+            responses=responses).SerializeToString()).SerializeToString()
+
+
 def for_server(packet):
     return packet.type % 2 == 0
@@ -0,0 +1,97 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/benchmark_service_raw.h"
+
+#include <cstring>
+
+#include "pw_protobuf/decoder.h"
+#include "pw_protobuf/wire_format.h"
+#include "pw_rpc_protos/benchmark.pwpb.h"
+#include "pw_varint/varint.h"
+
+namespace pw::rpc {
+namespace {
+
+constexpr std::byte kPayloadKey = std::byte(
+    protobuf::MakeKey(static_cast<uint32_t>(Payload::Fields::PAYLOAD),
+                      protobuf::WireType::kDelimited));
+
+// Encodes a Payload message with size filler bytes. Returns the encoded
+// message, or an empty span if it does not fit in the buffer.
+ByteSpan EncodePayload(uint32_t size, ByteSpan buffer) {
+  if (buffer.empty()) {
+    return {};
+  }
+  buffer[0] = kPayloadKey;
+
+  const size_t length_size = varint::Encode(size, buffer.subspan(1));
+  const size_t prefix_size = 1 + length_size;
+  if (length_size == 0u || buffer.size() - prefix_size < size) {
+    return {};
+  }
+
+  std::memset(buffer.data() + prefix_size, 0xa5, size);
+  return buffer.first(prefix_size + size);
+}
+
+}  // namespace
+
+StatusWithSize BenchmarkService::UnaryEcho(ServerContext&,
+                                           ConstByteSpan request,
+                                           ByteSpan response) {
+  // The request is an encoded Payload, so it is also the encoded response.
+  if (request.size() > response.size()) {
+    return StatusWithSize::ResourceExhausted();
+  }
+
+  std::memcpy(response.data(), request.data(), request.size());
+  return StatusWithSize(request.size());
+}
+
+void BenchmarkService::ServerStream(ServerContext&,
+                                    ConstByteSpan request,
+                                    RawServerWriter& writer) {
+  uint32_t count = 0;
+  uint32_t size = 0;
+
+  protobuf::Decoder decoder(request);
+  while (decoder.Next().ok()) {
+    switch (static_cast<StreamRequest::Fields>(decoder.FieldNumber())) {
+      case StreamRequest::Fields::COUNT:
+        decoder.ReadUint32(&count);
+        break;
+      case StreamRequest::Fields::SIZE:
+        decoder.ReadUint32(&size);
+        break;
+    }
+  }
+
+  for (uint32_t i = 0; i < count; ++i) {
+    ByteSpan payload = EncodePayload(size, writer.PayloadBuffer());
+    if (payload.empty()) {
+      writer.Finish(Status::ResourceExhausted());
+      return;
+    }
+
+    if (Status status = writer.Write(payload); !status.ok()) {
+      writer.Finish(status);
+      return;
+    }
+  }
+
+  writer.Finish();
+}
+
+}  // namespace pw::rpc
@@ -0,0 +1,108 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/benchmark_service_raw.h"
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_rpc/raw_test_method_context.h"
+#include "pw_rpc_protos/benchmark.pwpb.h"
+
+namespace pw::rpc {
+namespace {
+
+ConstByteSpan EncodeStreamRequest(uint32_t count,
+                                  uint32_t size,
+                                  ByteSpan buffer) {
+  protobuf::NestedEncoder encoder(buffer);
+  StreamRequest::Encoder request(&encoder);
+  request.WriteCount(count);
+  request.WriteSize(size);
+  return encoder.Encode().value();
+}
+
+ConstByteSpan DecodePayload(ConstByteSpan message) {
+  ConstByteSpan payload;
+  protobuf::Decoder decoder(message);
+  while (decoder.Next().ok()) {
+    if (static_cast<Payload::Fields>(decoder.FieldNumber()) ==
+        Payload::Fields::PAYLOAD) {
+      decoder.ReadBytes(&payload);
+    }
+  }
+  return payload;
+}
+
+TEST(BenchmarkService, UnaryEcho_RespondsWithRequest) {
+  PW_RAW_TEST_METHOD_CONTEXT(BenchmarkService, UnaryEcho) context;
+
+  std::byte buffer[32];
+  protobuf::NestedEncoder encoder(buffer);
+  Payload::Encoder payload(&encoder);
+  constexpr std::byte kData[] = {std::byte{1}, std::byte{2}, std::byte{3}};
+  payload.WritePayload(kData);
+  ConstByteSpan request = encoder.Encode().value();
+
+  ASSERT_EQ(OkStatus(), context.call(request).status());
+  ASSERT_EQ(request.size(), context.response().size());
+  EXPECT_EQ(0,
+            std::memcmp(
+                request.data(), context.response().data(), request.size()));
+}
+
+TEST(BenchmarkService, UnaryEcho_TooLarge_ResourceExhausted) {
+  PW_RAW_TEST_METHOD_CONTEXT(BenchmarkService, UnaryEcho) context;
+
+  std::byte request[256] = {};
+  EXPECT_EQ(Status::ResourceExhausted(), context.call(request).status());
+}
+
+TEST(BenchmarkService, ServerStream_SendsRequestedResponses) {
+  PW_RAW_TEST_METHOD_CONTEXT(BenchmarkService, ServerStream) context;
+
+  std::byte buffer[16];
+  context.call(EncodeStreamRequest(5, 40, buffer));
+
+  EXPECT_TRUE(context.done());
+  EXPECT_EQ(OkStatus(), context.status());
+  EXPECT_EQ(5u, context.total_responses());
+  EXPECT_EQ(40u, DecodePayload(context.responses().back()).size());
+}
+
+TEST(BenchmarkService, ServerStream_EmptyRequest_FinishesImmediately) {
+  PW_RAW_TEST_METHOD_CONTEXT(BenchmarkService, ServerStream) context;
+
+  context.call({});
+
+  EXPECT_TRUE(context.done());
+  EXPECT_EQ(OkStatus(), context.status());
+  EXPECT_EQ(0u, context.total_responses());
+}
+
+TEST(BenchmarkService, ServerStream_PayloadTooLarge_ResourceExhausted) {
+  PW_RAW_TEST_METHOD_CONTEXT(BenchmarkService, ServerStream) context;
+
+  std::byte buffer[16];
+  context.call(EncodeStreamRequest(2, 1000, buffer));
+
+  EXPECT_TRUE(context.done());
+  EXPECT_EQ(Status::ResourceExhausted(), context.status());
+  EXPECT_EQ(0u, context.total_responses());
+}
+
+}  // namespace
+}  // namespace pw::rpc
@@ -56,6 +56,18 @@ class TestService final : public generated::TestService<TestService> {
     writer.Finish(status);
   }
 
+  void TestClientStreamRpc(ServerContext&, RawServerReader& reader) {
+    last_reader = std::move(reader);
+  }
+
+  void TestBidirectionalStreamRpc(ServerContext&,
+                                  RawServerReaderWriter& reader_writer) {
+    last_reader_writer = std::move(reader_writer);
+  }
+
+  RawServerReader last_reader;
+  RawServerReaderWriter last_reader_writer;
+
  private:
   static void DecodeRequest(ConstByteSpan request,
                             int64_t& integer,
@@ -0,0 +1,36 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_bytes/span.h"
+#include "pw_rpc_protos/benchmark.raw_rpc.pb.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::rpc {
+
+// Implements the Benchmark service with raw methods, so the measurements
+// include as little protobuf processing as possible.
+class BenchmarkService final
+    : public generated::Benchmark<BenchmarkService> {
+ public:
+  static StatusWithSize UnaryEcho(ServerContext&,
+                                  ConstByteSpan request,
+                                  ByteSpan response);
+
+  static void ServerStream(ServerContext&,
+                           ConstByteSpan request,
+                           RawServerWriter& writer);
+};
+
+}  // namespace pw::rpc
@@ -38,6 +38,63 @@ class RawServerWriter : public internal::BaseServerWriter {
   Status Write(ConstByteSpan response);
 };
 
+// Receives the raw request payloads of a client or bidirectional stream.
+class RawClientStreamHandler : public internal::BaseClientStreamHandler {
+ public:
+  // Called with each request in the stream. The payload is only valid for the
+  // duration of the call.
+  virtual void ReceivedRequest(ConstByteSpan request) = 0;
+
+ private:
+  Status ReceivedPayload(const internal::Method&,
+                         ConstByteSpan payload) final {
+    ReceivedRequest(payload);
+    return OkStatus();
+  }
+};
+
+// Server side of a raw client streaming RPC. Requests are passed to the
+// handler as they arrive; the RPC ends with a single response.
+class RawServerReader : public internal::BaseServerWriter {
+ public:
+  RawServerReader() = default;
+  RawServerReader(RawServerReader&&) = default;
+  RawServerReader& operator=(RawServerReader&&) = default;
+
+  ~RawServerReader();
+
+  // Sets the handler for the client's requests. The handler must outlive the
+  // RawServerReader, or be replaced before it goes out of scope.
+  void set_handler(RawClientStreamHandler& handler) {
+    set_client_stream_handler(&handler);
+  }
+
+  // Returns a buffer in which the response payload can be built.
+  ByteSpan PayloadBuffer() { return AcquirePayloadBuffer(); }
+
+  // Sends the response and ends the RPC. The payload can either be in the
+  // buffer previously acquired from PayloadBuffer(), or an arbitrary external
+  // buffer.
+  Status Finish(ConstByteSpan response, Status status = OkStatus()) {
+    return CloseAndSendResponse(response, status);
+  }
+};
+
+// Server side of a raw bidirectional streaming RPC. Responses are written as
+// with a RawServerWriter, and requests are passed to the handler.
+class RawServerReaderWriter : public RawServerWriter {
+ public:
+  RawServerReaderWriter() = default;
+  RawServerReaderWriter(RawServerReaderWriter&&) = default;
+  RawServerReaderWriter& operator=(RawServerReaderWriter&&) = default;
+
+  // Sets the handler for the client's requests. The handler must outlive the
+  // RawServerReaderWriter, or be replaced before it goes out of scope.
+  void set_handler(RawClientStreamHandler& handler) {
+    set_client_stream_handler(&handler);
+  }
+};
+
 namespace internal {
 
 // A RawMethod is a method invoker which does not perform any automatic protobuf
@@ -73,6 +130,29 @@ class RawMethod : public Method {
         id, ServerStreamingInvoker, Function{.server_streaming = wrapper});
   }
 
+  template <auto method>
+  static constexpr RawMethod ClientStreaming(uint32_t id) {
+    constexpr StreamFunction wrapper = [](ServerCall& call,
+                                          BaseServerWriter& reader) {
+      CallMethodImplFunction<method>(call,
+                                     static_cast<RawServerReader&>(reader));
+    };
+    return RawMethod(
+        id, ClientStreamingInvoker, Function{.client_streaming = wrapper});
+  }
+
+  template <auto method>
+  static constexpr RawMethod BidirectionalStreaming(uint32_t id) {
+    constexpr StreamFunction wrapper = [](ServerCall& call,
+                                          BaseServerWriter& reader_writer) {
+      CallMethodImplFunction<method>(
+          call, static_cast<RawServerReaderWriter&>(reader_writer));
+    };
+    return RawMethod(id,
+                     BidirectionalStreamingInvoker,
+                     Function{.bidirectional_streaming = wrapper});
+  }
+
   // Represents an invalid method. Used to reduce error message verbosity.
   static constexpr RawMethod Invalid() { return {0, InvalidInvoker, {}}; }
 
@@ -84,10 +164,16 @@ class RawMethod : public Method {
   using ServerStreamingFunction = void (*)(ServerCall&,
                                            ConstByteSpan,
                                            BaseServerWriter&);
+
+  // Client and bidirectional streaming RPCs receive their requests through the
+  // reader, so the function does not take a request.
+  using StreamFunction = void (*)(ServerCall&, BaseServerWriter&);
+
   union Function {
     UnaryFunction unary;
     ServerStreamingFunction server_streaming;
-    // TODO(frolv): Support client and bidirectional streaming.
+    StreamFunction client_streaming;
+    StreamFunction bidirectional_streaming;
   };
 
   constexpr RawMethod(uint32_t id, Invoker invoker, Function function)
@@ -105,8 +191,22 @@ class RawMethod : public Method {
     static_cast<const RawMethod&>(method).CallServerStreaming(call, request);
   }
 
+  static void ClientStreamingInvoker(const Method& method,
+                                     ServerCall& call,
+                                     const Packet&) {
+    static_cast<const RawMethod&>(method).CallClientStreaming(call);
+  }
+
+  static void BidirectionalStreamingInvoker(const Method& method,
+                                            ServerCall& call,
+                                            const Packet&) {
+    static_cast<const RawMethod&>(method).CallBidirectionalStreaming(call);
+  }
+
   void CallUnary(ServerCall& call, const Packet& request) const;
   void CallServerStreaming(ServerCall& call, const Packet& request) const;
+  void CallClientStreaming(ServerCall& call) const;
+  void CallBidirectionalStreaming(ServerCall& call) const;
 
   // Stores the user-defined RPC in a generic wrapper.
   Function function_;
@@ -145,5 +245,35 @@ struct MethodTraits<void (T::*)(
   using Service = T;
 };
 
+// MethodTraits specialization for a static raw client streaming method.
+template <>
+struct MethodTraits<void (*)(ServerContext&, RawServerReader&)> {
+  using Implementation = RawMethod;
+  static constexpr MethodType kType = MethodType::kClientStreaming;
+};
+
+// MethodTraits specialization for a raw client streaming method.
+template <typename T>
+struct MethodTraits<void (T::*)(ServerContext&, RawServerReader&)> {
+  using Implementation = RawMethod;
+  static constexpr MethodType kType = MethodType::kClientStreaming;
+  using Service = T;
+};
+
+// MethodTraits specialization for a static raw bidirectional streaming method.
+template <>
+struct MethodTraits<void (*)(ServerContext&, RawServerReaderWriter&)> {
+  using Implementation = RawMethod;
+  static constexpr MethodType kType = MethodType::kBidirectionalStreaming;
+};
+
+// MethodTraits specialization for a raw bidirectional streaming method.
+template <typename T>
+struct MethodTraits<void (T::*)(ServerContext&, RawServerReaderWriter&)> {
+  using Implementation = RawMethod;
+  static constexpr MethodType kType = MethodType::kBidirectionalStreaming;
+  using Service = T;
+};
+
 }  // namespace internal
 }  // namespace pw::rpc
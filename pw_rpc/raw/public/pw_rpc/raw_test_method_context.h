@@ -58,6 +58,17 @@ namespace pw::rpc {
 //     // iterate over the responses
 //   }
 //
+// For client and bidirectional streaming RPCs, context.call() invokes the
+// method. Requests are then sent to the handler the method set with
+// context.SendClientStream(request), and the client's stream is ended with
+// context.CloseClientStream(). A client streaming RPC is done when its response
+// is sent; a bidirectional streaming RPC is done when its stream ends.
+//
+//   PW_RAW_TEST_METHOD_CONTEXT(my::CoolService, TheBidiMethod) context;
+//   context.call();
+//   context.SendClientStream(encoded_request);
+//   EXPECT_EQ(1u, context.responses().size());
+//
 // PW_RAW_TEST_METHOD_CONTEXT forwards its constructor arguments to the
 // underlying service. For example:
 //
@@ -151,6 +162,17 @@ struct InvocationContext {
 
   using ResponseBuffer = std::array<std::byte, output_size>;
 
+  // Sends a client stream packet for the method through the server, which
+  // passes it to the RPC's reader.
+  Status SendClientStream(PacketType type, ConstByteSpan payload) {
+    std::array<std::byte, output_size> buffer;
+    Result<ConstByteSpan> packet =
+        Packet(type, channel.id(), service.id(), method_id, payload)
+            .Encode(buffer);
+    PW_ASSERT(packet.ok());
+    return server.ProcessPacket(packet.value(), output);
+  }
+
   MessageOutput<output_size> output;
   rpc::Channel channel;
   rpc::Server server;
@@ -248,6 +270,72 @@ class ServerStreamingContext {
   }
 };
 
+// Method invocation context for client and bidirectional streaming RPCs. The
+// service is registered with the context's server so that it can route client
+// stream packets to the method's reader.
+template <typename Service,
+          auto method,
+          uint32_t method_id,
+          size_t max_responses,
+          size_t output_size,
+          MethodType kType>
+class StreamingRequestContext {
+ private:
+  using Context =
+      InvocationContext<Service, method_id, max_responses, output_size>;
+  using Reader = std::conditional_t<kType == MethodType::kClientStreaming,
+                                    RawServerReader,
+                                    RawServerReaderWriter>;
+  Context ctx_;
+
+ public:
+  template <typename... Args>
+  StreamingRequestContext(Args&&... args) : ctx_(std::forward<Args>(args)...) {
+    ctx_.server.RegisterService(ctx_.service);
+  }
+
+  Service& service() { return ctx_.service; }
+
+  // Invokes the RPC, which starts the client's stream.
+  void call() {
+    ctx_.output.clear();
+    BaseServerWriter reader(ctx_.call, kType);
+    return CallMethodImplFunction<method>(ctx_.call,
+                                          static_cast<Reader&>(reader));
+  }
+
+  // Sends a request in the client's stream.
+  Status SendClientStream(ConstByteSpan request) {
+    return ctx_.SendClientStream(PacketType::CLIENT_STREAM, request);
+  }
+
+  // Ends the client's stream.
+  Status CloseClientStream() {
+    return ctx_.SendClientStream(PacketType::CLIENT_STREAM_END, {});
+  }
+
+  // The responses that have been recorded, as for a server streaming RPC. A
+  // client streaming RPC has at most one response.
+  const Vector<ByteSpan>& responses() const { return ctx_.responses; }
+
+  size_t total_responses() const { return ctx_.output.total_responses(); }
+
+  // True if the RPC has finished.
+  bool done() const {
+    if constexpr (kType == MethodType::kClientStreaming) {
+      return total_responses() > 0u;
+    } else {
+      return ctx_.output.stream_ended();
+    }
+  }
+
+  // The status of the RPC. Only valid if done() is true.
+  Status status() const {
+    PW_ASSERT(done());
+    return ctx_.output.last_status();
+  }
+};
+
 // Alias to select the type of the context object to use based on which type of
 // RPC it is for.
 template <typename Service,
@@ -262,9 +350,19 @@ using Context = std::tuple_element_t<
                                       method,
                                       method_id,
                                       responses,
-                                      output_size>
-               // TODO(hepler): Support client and bidi streaming
-               >>;
+                                      output_size>,
+               StreamingRequestContext<Service,
+                                       method,
+                                       method_id,
+                                       responses,
+                                       output_size,
+                                       MethodType::kClientStreaming>,
+               StreamingRequestContext<Service,
+                                       method,
+                                       method_id,
+                                       responses,
+                                       output_size,
+                                       MethodType::kBidirectionalStreaming>>>;
 
 template <size_t output_size>
 Status MessageOutput<output_size>::SendAndReleaseBuffer(
@@ -294,6 +392,7 @@ Status MessageOutput<output_size>::SendAndReleaseBuffer(
       break;
     }
     case internal::PacketType::SERVER_STREAM_END:
+    case internal::PacketType::SERVER_ERROR:
       stream_ended_ = true;
       break;
     default:
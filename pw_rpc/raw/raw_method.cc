@@ -18,6 +18,7 @@
 
 #include "pw_log/log.h"
 #include "pw_rpc/internal/packet.h"
+#include "pw_rpc/internal/server.h"
 
 namespace pw::rpc {
 
@@ -32,12 +33,26 @@ Status RawServerWriter::Write(ConstByteSpan response) {
     return Status::FailedPrecondition();
   }
 
-  if (buffer().Contains(response)) {
+  if (PayloadBufferContains(response)) {
     return ReleasePayloadBuffer(response);
   }
 
+  // Without credit, the response is dropped before it is copied.
+  if (AvailableCredits() == 0u) {
+    return Status::ResourceExhausted();
+  }
+
   std::span<std::byte> buffer = AcquirePayloadBuffer();
 
+  // If the response does not fit after the batched responses, send them to
+  // make room.
+  if (response.size() > buffer.size() && batch_pending()) {
+    if (Status status = Flush(); !status.ok()) {
+      return status;
+    }
+    buffer = AcquirePayloadBuffer();
+  }
+
   if (response.size() > buffer.size()) {
     ReleasePayloadBuffer();
     return Status::OutOfRange();
@@ -47,6 +62,12 @@ Status RawServerWriter::Write(ConstByteSpan response) {
   return ReleasePayloadBuffer(buffer.first(response.size()));
 }
 
+RawServerReader::~RawServerReader() {
+  if (!buffer().empty()) {
+    ReleasePayloadBuffer();
+  }
+}
+
 namespace internal {
 
 void RawMethod::CallUnary(ServerCall& call, const Packet& request) const {
@@ -59,12 +80,16 @@ void RawMethod::CallUnary(ServerCall& call, const Packet& request) const {
   response.set_payload(payload_buffer.first(sws.size()));
   response.set_status(sws.status());
   if (call.channel().Send(response_buffer, response).ok()) {
+    call.server().PacketSent(response);
     return;
   }
 
   PW_LOG_WARN("Failed to send response packet for channel %u",
               unsigned(call.channel().id()));
-  call.channel().Send(Packet::ServerError(request, Status::Internal()));
+  const Packet error = Packet::ServerError(request, Status::Internal());
+  if (call.channel().Send(error).ok()) {
+    call.server().PacketSent(error);
+  }
 }
 
 void RawMethod::CallServerStreaming(ServerCall& call,
@@ -73,5 +98,16 @@ void RawMethod::CallServerStreaming(ServerCall& call,
   function_.server_streaming(call, request.payload(), server_writer);
 }
 
+void RawMethod::CallClientStreaming(ServerCall& call) const {
+  internal::BaseServerWriter reader(call, MethodType::kClientStreaming);
+  function_.client_streaming(call, reader);
+}
+
+void RawMethod::CallBidirectionalStreaming(ServerCall& call) const {
+  internal::BaseServerWriter reader_writer(
+      call, MethodType::kBidirectionalStreaming);
+  function_.bidirectional_streaming(call, reader_writer);
+}
+
 }  // namespace internal
 }  // namespace pw::rpc
@@ -113,13 +113,41 @@ void StartStream(ServerContext&,
   last_writer = std::move(writer);
 }
 
+RawServerReader last_reader;
+RawServerReaderWriter last_reader_writer;
+
+void StartClientStream(ServerContext&, RawServerReader& reader) {
+  last_reader = std::move(reader);
+}
+
+void StartBidirectionalStream(ServerContext&,
+                              RawServerReaderWriter& reader_writer) {
+  last_reader_writer = std::move(reader_writer);
+}
+
+class TestClientStreamHandler : public RawClientStreamHandler {
+ public:
+  void ReceivedRequest(ConstByteSpan request) override {
+    requests += 1;
+    last_request_size = request.size();
+  }
+
+  void ClientStreamEnd() override { stream_ended = true; }
+
+  size_t requests = 0;
+  size_t last_request_size = 0;
+  bool stream_ended = false;
+};
+
 class FakeService : public Service {
  public:
   FakeService(uint32_t id) : Service(id, kMethods) {}
 
-  static constexpr std::array<RawMethodUnion, 2> kMethods = {
+  static constexpr std::array<RawMethodUnion, 4> kMethods = {
       RawMethod::Unary<AddFive>(10u),
       RawMethod::ServerStreaming<StartStream>(11u),
+      RawMethod::ClientStreaming<StartClientStream>(12u),
+      RawMethod::BidirectionalStreaming<StartBidirectionalStream>(13u),
   };
 };
 
@@ -228,6 +256,31 @@ TEST(RawServerWriter, Write_BufferTooSmall_ReturnsOutOfRange) {
   EXPECT_EQ(last_writer.Write(data), Status::OutOfRange());
 }
 
+TEST(RawServerWriter, Batching_SendsFullBatchToMakeRoom) {
+  const RawMethod& method = std::get<1>(FakeService::kMethods).raw_method();
+  ServerContextForTest<FakeService, 32> context(method);
+
+  method.Invoke(context.get(), context.packet({}));
+  std::array<std::byte, 32> batch_buffer;
+  ASSERT_EQ(last_writer.EnableBatching(batch_buffer), OkStatus());
+
+  // The packet leaves 14 bytes for the batch, so only that much of the batch
+  // buffer is used. 6 bytes are reserved for each response's key and length, so
+  // only one of these responses fits.
+  constexpr auto data = bytes::Array<0x0d, 0x06, 0xf0, 0x0d>();
+  ASSERT_EQ(last_writer.Write(data), OkStatus());
+  EXPECT_EQ(context.output().packet_count(), 0u);
+
+  ASSERT_EQ(last_writer.Write(data), OkStatus());
+  ASSERT_EQ(context.output().packet_count(), 1u);
+  const internal::Packet& packet = context.output().sent_packet();
+  EXPECT_EQ(packet.type(), internal::PacketType::RESPONSE_BATCH);
+  EXPECT_EQ(packet.payload().size(), 2u + data.size());
+
+  last_writer.Finish();
+  EXPECT_EQ(context.output().packet_count(), 3u);
+}
+
 TEST(RawServerWriter,
      Destructor_ReleasesAcquiredBufferWithoutSendingAndCloses) {
   const RawMethod& method = std::get<1>(FakeService::kMethods).raw_method();
@@ -247,5 +300,105 @@ TEST(RawServerWriter,
   EXPECT_EQ(output.sent_packet().type(), PacketType::SERVER_STREAM_END);
 }
 
+TEST(RawMethod, ClientStreamingRpc_PassesRequestsToHandler) {
+  const RawMethod& method = std::get<2>(FakeService::kMethods).raw_method();
+  ServerContextForTest<FakeService> context(method);
+  TestClientStreamHandler handler;
+
+  method.Invoke(context.get(), context.packet({}));
+  ASSERT_TRUE(last_reader.client_stream_open());
+  last_reader.set_handler(handler);
+
+  constexpr auto data = bytes::Array<0x0d, 0x06, 0xf0>();
+  EXPECT_EQ(OkStatus(), context.SendPacket(PacketType::CLIENT_STREAM, data));
+  EXPECT_EQ(OkStatus(), context.SendPacket(PacketType::CLIENT_STREAM, data));
+  EXPECT_EQ(OkStatus(), context.SendPacket(PacketType::CLIENT_STREAM_END));
+
+  EXPECT_EQ(0u, context.output().packet_count());
+  EXPECT_EQ(2u, handler.requests);
+  EXPECT_EQ(data.size(), handler.last_request_size);
+  EXPECT_TRUE(handler.stream_ended);
+  EXPECT_FALSE(last_reader.client_stream_open());
+  EXPECT_TRUE(last_reader.open());
+  last_reader.Finish({});
+}
+
+TEST(RawServerReader, Finish_SendsResponseWithStatus) {
+  const RawMethod& method = std::get<2>(FakeService::kMethods).raw_method();
+  ServerContextForTest<FakeService> context(method);
+
+  method.Invoke(context.get(), context.packet({}));
+
+  constexpr auto data = bytes::Array<0x0d, 0x06, 0xf0, 0x0d>();
+  EXPECT_EQ(OkStatus(), last_reader.Finish(data, Status::Unauthenticated()));
+  EXPECT_FALSE(last_reader.open());
+
+  ASSERT_EQ(1u, context.output().packet_count());
+  const Packet& packet = context.output().sent_packet();
+  EXPECT_EQ(packet.type(), PacketType::RESPONSE);
+  EXPECT_EQ(packet.method_id(), 12u);
+  EXPECT_EQ(packet.status(), Status::Unauthenticated());
+  ASSERT_EQ(packet.payload().size(), data.size());
+  EXPECT_EQ(std::memcmp(packet.payload().data(), data.data(), data.size()), 0);
+
+  EXPECT_EQ(Status::FailedPrecondition(), last_reader.Finish(data));
+}
+
+TEST(RawServerReader, ClientStreamAfterFinish_SendsError) {
+  const RawMethod& method = std::get<2>(FakeService::kMethods).raw_method();
+  ServerContextForTest<FakeService> context(method);
+
+  method.Invoke(context.get(), context.packet({}));
+  last_reader.Finish({});
+
+  EXPECT_EQ(OkStatus(), context.SendPacket(PacketType::CLIENT_STREAM));
+  const Packet& packet = context.output().sent_packet();
+  EXPECT_EQ(packet.type(), PacketType::SERVER_ERROR);
+  EXPECT_EQ(packet.status(), Status::FailedPrecondition());
+}
+
+TEST(RawServerReader, Destructor_SendsEmptyResponse) {
+  const RawMethod& method = std::get<2>(FakeService::kMethods).raw_method();
+  ServerContextForTest<FakeService> context(method);
+
+  method.Invoke(context.get(), context.packet({}));
+
+  { RawServerReader reader = std::move(last_reader); }
+
+  ASSERT_EQ(1u, context.output().packet_count());
+  const Packet& packet = context.output().sent_packet();
+  EXPECT_EQ(packet.type(), PacketType::RESPONSE);
+  EXPECT_EQ(packet.status(), OkStatus());
+  EXPECT_TRUE(packet.payload().empty());
+}
+
+TEST(RawMethod, BidirectionalStreamingRpc_ReadsAndWrites) {
+  const RawMethod& method = std::get<3>(FakeService::kMethods).raw_method();
+  ServerContextForTest<FakeService> context(method);
+  TestClientStreamHandler handler;
+
+  method.Invoke(context.get(), context.packet({}));
+  last_reader_writer.set_handler(handler);
+
+  constexpr auto data = bytes::Array<0x0d, 0x06, 0xf0, 0x0d>();
+  EXPECT_EQ(OkStatus(), context.SendPacket(PacketType::CLIENT_STREAM, data));
+  EXPECT_EQ(1u, handler.requests);
+
+  EXPECT_EQ(OkStatus(), last_reader_writer.Write(data));
+  EXPECT_EQ(context.output().sent_packet().type(), PacketType::RESPONSE);
+
+  EXPECT_EQ(OkStatus(), context.SendPacket(PacketType::CLIENT_STREAM_END));
+  EXPECT_TRUE(handler.stream_ended);
+
+  // The server may keep writing after the client's stream ends.
+  EXPECT_EQ(OkStatus(), last_reader_writer.Write(data));
+
+  last_reader_writer.Finish(Status::NotFound());
+  const Packet& packet = context.output().sent_packet();
+  EXPECT_EQ(packet.type(), PacketType::SERVER_STREAM_END);
+  EXPECT_EQ(packet.status(), Status::NotFound());
+  EXPECT_EQ(3u, context.output().packet_count());
+}
+
 }  // namespace
 }  // namespace pw::rpc::internal
@@ -17,6 +17,7 @@
 #include <algorithm>
 
 #include "pw_log/log.h"
+#include "pw_protobuf/decoder.h"
 #include "pw_rpc/internal/packet.h"
 #include "pw_rpc/internal/server.h"
 #include "pw_rpc/server_context.h"
@@ -28,6 +29,7 @@ using std::byte;
 
 using internal::Packet;
 using internal::PacketType;
+namespace StreamCredit = internal::StreamCredit;
 
 bool DecodePacket(ChannelOutput& interface,
                   std::span<const byte> data,
@@ -101,11 +103,21 @@ Status Server::ProcessPacket(std::span<const byte> data,
     case PacketType::REQUEST: {
       internal::ServerCall call(
           static_cast<internal::Server&>(*this), *channel, *service, *method);
+      if (method_observer_ == nullptr) {
+        method->Invoke(call, packet);
+        break;
+      }
+
+      method_observer_->RequestReceived(
+          packet.service_id(), packet.method_id(), packet.payload().size());
       method->Invoke(call, packet);
+      method_observer_->HandlerReturned(packet.service_id(),
+                                        packet.method_id());
       break;
     }
+    case PacketType::CLIENT_STREAM:
     case PacketType::CLIENT_STREAM_END:
-      // TODO(hepler): Support client streaming RPCs.
+      HandleClientStream(packet, *channel);
       break;
     case PacketType::CLIENT_ERROR:
       HandleClientError(packet);
@@ -113,6 +125,9 @@ Status Server::ProcessPacket(std::span<const byte> data,
     case PacketType::CANCEL_SERVER_STREAM:
       HandleCancelPacket(packet, *channel);
       break;
+    case PacketType::STREAM_CREDIT:
+      HandleStreamCredit(packet, *channel);
+      break;
     default:
       channel->Send(Packet::ServerError(packet, Status::Unimplemented()));
       PW_LOG_WARN("Unable to handle packet of type %u",
@@ -123,25 +138,37 @@ Status Server::ProcessPacket(std::span<const byte> data,
 
 std::tuple<Service*, const internal::Method*> Server::FindMethod(
     const internal::Packet& packet) {
-  // Packets always include service and method IDs.
-  auto service = std::find_if(services_.begin(), services_.end(), [&](auto& s) {
-    return s.id() == packet.service_id();
-  });
-
-  if (service == services_.end()) {
-    return {};
+  // Packets always include service and method IDs. The service found is moved
+  // to the front of the list, since consecutive packets are often for the same
+  // service.
+  auto previous = services_.before_begin();
+  for (auto service = services_.begin(); service != services_.end();
+       previous = service++) {
+    if (service->id() == packet.service_id()) {
+      Service& found = *service;
+      if (previous != services_.before_begin()) {
+        services_.erase_after(previous);
+        services_.push_front(found);
+      }
+      return {&found, found.FindMethod(packet.method_id())};
+    }
   }
 
-  return {&(*service), service->FindMethod(packet.method_id())};
+  return {};
 }
 
-void Server::HandleCancelPacket(const Packet& packet,
-                                internal::Channel& channel) {
-  auto writer = std::find_if(writers_.begin(), writers_.end(), [&](auto& w) {
+IntrusiveDoublyLinkedList<internal::BaseServerWriter>::iterator
+Server::FindWriter(const Packet& packet) {
+  return std::find_if(writers_.begin(), writers_.end(), [&](auto& w) {
     return w.channel_id() == packet.channel_id() &&
            w.service_id() == packet.service_id() &&
            w.method_id() == packet.method_id();
   });
+}
+
+void Server::HandleCancelPacket(const Packet& packet,
+                                internal::Channel& channel) {
+  auto writer = FindWriter(packet);
 
   if (writer == writers_.end()) {
     channel.Send(Packet::ServerError(packet, Status::FailedPrecondition()));
@@ -151,24 +178,81 @@ void Server::HandleCancelPacket(const Packet& packet,
   }
 }
 
+void Server::HandleClientStream(const Packet& packet,
+                                internal::Channel& channel) {
+  auto writer = FindWriter(packet);
+
+  if (writer == writers_.end() || !writer->client_stream_open()) {
+    channel.Send(Packet::ServerError(packet, Status::FailedPrecondition()));
+    PW_LOG_WARN("Received client stream packet for method that is not pending");
+    return;
+  }
+
+  // A request that cannot be decoded ends the RPC.
+  if (!writer->HandleClientStream(packet).ok()) {
+    writer->Close();
+    channel.Send(Packet::ServerError(packet, Status::DataLoss()));
+  }
+}
+
+void Server::HandleStreamCredit(const Packet& packet,
+                                internal::Channel& channel) {
+  protobuf::Decoder decoder(packet.payload());
+  uint32_t credits = 0;
+  Status status;
+
+  while ((status = decoder.Next()).ok()) {
+    if (static_cast<StreamCredit::Fields>(decoder.FieldNumber()) ==
+            StreamCredit::Fields::RESPONSES &&
+        !(status = decoder.ReadUint32(&credits)).ok()) {
+      break;
+    }
+  }
+
+  // The decoder returns OUT_OF_RANGE once the whole payload is read.
+  if (status != Status::OutOfRange()) {
+    channel.Send(Packet::ServerError(packet, Status::DataLoss()));
+    return;
+  }
+
+  // Credits may arrive after the stream finished, so they are ignored if the
+  // writer is gone.
+  auto writer = FindWriter(packet);
+  if (writer != writers_.end()) {
+    writer->AddCredits(credits);
+  }
+}
+
 void Server::HandleClientError(const Packet& packet) {
   // A client error indicates that the client received a packet that it did not
   // expect. If the packet belongs to a streaming RPC, cancel the stream without
   // sending a final SERVER_STREAM_END packet.
-  auto writer = std::find_if(writers_.begin(), writers_.end(), [&](auto& w) {
-    return w.channel_id() == packet.channel_id() &&
-           w.service_id() == packet.service_id() &&
-           w.method_id() == packet.method_id();
-  });
+  auto writer = FindWriter(packet);
 
   if (writer != writers_.end()) {
     writer->Close();
   }
 }
 
-internal::Channel* Server::FindChannel(uint32_t id) const {
+internal::Channel* Server::FindChannel(uint32_t id) {
+  if constexpr (cfg::kChannelTableSize > 0) {
+    size_t index = ChannelTableIndex(id);
+    for (size_t i = 0; i < channel_table_.size(); ++i) {
+      internal::Channel* channel = channel_table_[index];
+      if (channel == nullptr) {
+        break;
+      }
+      if (channel->id() == id) {
+        return channel;
+      }
+      index = (index + 1) % channel_table_.size();
+    }
+  }
+
+  channel_lookup_misses_ += 1;
   for (internal::Channel& c : channels_) {
     if (c.id() == id) {
+      AddToChannelTable(c);
       return &c;
     }
   }
@@ -177,13 +261,27 @@ internal::Channel* Server::FindChannel(uint32_t id) const {
 
 internal::Channel* Server::AssignChannel(uint32_t id,
                                          ChannelOutput& interface) {
-  internal::Channel* channel = FindChannel(Channel::kUnassignedChannelId);
-  if (channel == nullptr) {
-    return nullptr;
+  for (internal::Channel& channel : channels_) {
+    if (channel.id() == Channel::kUnassignedChannelId) {
+      channel = internal::Channel(id, &interface);
+      AddToChannelTable(channel);
+      return &channel;
+    }
   }
+  return nullptr;
+}
 
-  *channel = internal::Channel(id, &interface);
-  return channel;
+void Server::AddToChannelTable(internal::Channel& channel) {
+  if constexpr (cfg::kChannelTableSize > 0) {
+    size_t index = ChannelTableIndex(channel.id());
+    for (size_t i = 0; i < channel_table_.size(); ++i) {
+      if (channel_table_[index] == nullptr) {
+        channel_table_[index] = &channel;
+        return;
+      }
+      index = (index + 1) % channel_table_.size();
+    }
+  }
 }
 
 }  // namespace pw::rpc
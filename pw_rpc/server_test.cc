@@ -109,6 +109,55 @@ TEST_F(BasicServer, ProcessPacket_ValidMethod_InvokesMethod) {
             0);
 }
 
+TEST_F(BasicServer, ProcessPacket_AlternatingServices_InvokesEachMethod) {
+  TestService other_service(43);
+  server_.RegisterService(other_service);
+
+  for (uint32_t channel_id = 1; channel_id <= 2; ++channel_id) {
+    EXPECT_EQ(OkStatus(),
+              server_.ProcessPacket(
+                  EncodeRequest(PacketType::REQUEST, channel_id, 42, 200),
+                  output_));
+    EXPECT_EQ(channel_id, service_.method(200).last_channel_id());
+
+    EXPECT_EQ(OkStatus(),
+              server_.ProcessPacket(
+                  EncodeRequest(PacketType::REQUEST, channel_id, 43, 100),
+                  output_));
+    EXPECT_EQ(channel_id, other_service.method(100).last_channel_id());
+  }
+  EXPECT_EQ(0u, service_.method(100).last_channel_id());
+  EXPECT_EQ(0u, other_service.method(200).last_channel_id());
+}
+
+TEST_F(BasicServer, ProcessPacket_MethodObserver_ReportsRequest) {
+  TestMethodObserver observer;
+  server_.set_method_observer(&observer);
+
+  EXPECT_EQ(OkStatus(),
+            server_.ProcessPacket(
+                EncodeRequest(PacketType::REQUEST, 1, 42, 200), output_));
+
+  EXPECT_EQ(1u, observer.requests);
+  EXPECT_EQ(1u, observer.handlers_returned);
+  EXPECT_EQ(42u, observer.last_service_id);
+  EXPECT_EQ(200u, observer.last_method_id);
+  EXPECT_EQ(sizeof(kDefaultPayload), observer.request_bytes);
+  EXPECT_EQ(1u, service_.method(200).last_channel_id());
+}
+
+TEST_F(BasicServer, ProcessPacket_MethodObserver_InvalidMethodNotReported) {
+  TestMethodObserver observer;
+  server_.set_method_observer(&observer);
+
+  EXPECT_EQ(OkStatus(),
+            server_.ProcessPacket(
+                EncodeRequest(PacketType::REQUEST, 1, 42, 27), output_));
+
+  EXPECT_EQ(0u, observer.requests);
+  EXPECT_EQ(0u, observer.handlers_returned);
+}
+
 TEST_F(BasicServer, ProcessPacket_IncompletePacket_NothingIsInvoked) {
   EXPECT_EQ(Status::DataLoss(),
             server_.ProcessPacket(
@@ -210,6 +259,31 @@ TEST_F(BasicServer,
   EXPECT_EQ(packet.method_id(), 27u);
 }
 
+TEST(Server, ProcessPacket_MoreChannelsThanChannelTable_FindsAll) {
+  constexpr uint32_t kChannelCount = cfg::kChannelTableSize + 4;
+  TestOutput<128> output;
+  std::array<Channel, kChannelCount> channels;
+  Server server(channels);
+  TestService service(42);
+  server.RegisterService(service);
+
+  byte request_buffer[64];
+  for (int round = 0; round < 2; ++round) {
+    for (uint32_t id = 1; id <= kChannelCount; ++id) {
+      auto request = Packet(PacketType::REQUEST, id, 42, 100, {})
+                         .Encode(request_buffer);
+      ASSERT_EQ(OkStatus(), request.status());
+      EXPECT_EQ(OkStatus(), server.ProcessPacket(request.value(), output));
+      EXPECT_EQ(service.method(100).last_channel_id(), id);
+    }
+  }
+
+  // Each channel is assigned on its first packet, which misses the table. The
+  // channels that did not fit in the table miss again.
+  EXPECT_EQ(server.channel_lookup_misses(),
+            kChannelCount + (kChannelCount - cfg::kChannelTableSize));
+}
+
 TEST_F(BasicServer, ProcessPacket_Cancel_MethodNotActive_SendsError) {
   // Set up a fake ServerWriter representing an ongoing RPC.
   EXPECT_EQ(OkStatus(),
@@ -308,5 +382,145 @@ TEST_F(MethodPending, ProcessPacket_CancelIncorrectMethod) {
   EXPECT_TRUE(writer_.open());
 }
 
+TEST_F(MethodPending, ProcessPacket_StreamCredit_AddsCredits) {
+  writer_.EnableFlowControl(1);
+
+  // A StreamCredit with responses = 300.
+  constexpr byte credit[] = {byte{0x08}, byte{0xac}, byte{0x02}};
+  EXPECT_EQ(OkStatus(),
+            server_.ProcessPacket(
+                EncodeRequest(PacketType::STREAM_CREDIT, 1, 42, 100, credit),
+                output_));
+
+  EXPECT_EQ(writer_.AvailableCredits(), 301u);
+  EXPECT_EQ(output_.packet_count(), 0u);
+}
+
+TEST_F(MethodPending, ProcessPacket_StreamCredit_Malformed_SendsError) {
+  writer_.EnableFlowControl(1);
+
+  constexpr byte truncated[] = {byte{0x08}, byte{0x80}};
+  EXPECT_EQ(OkStatus(),
+            server_.ProcessPacket(
+                EncodeRequest(PacketType::STREAM_CREDIT, 1, 42, 100, truncated),
+                output_));
+
+  EXPECT_EQ(output_.sent_packet().type(), PacketType::SERVER_ERROR);
+  EXPECT_EQ(output_.sent_packet().status(), Status::DataLoss());
+  EXPECT_EQ(writer_.AvailableCredits(), 1u);
+}
+
+TEST_F(BasicServer, ProcessPacket_StreamCredit_MethodNotActive_Ignored) {
+  constexpr byte credit[] = {byte{0x08}, byte{0x01}};
+  EXPECT_EQ(OkStatus(),
+            server_.ProcessPacket(
+                EncodeRequest(PacketType::STREAM_CREDIT, 1, 42, 100, credit),
+                output_));
+
+  EXPECT_EQ(output_.packet_count(), 0u);
+}
+
+TEST_F(BasicServer, ProcessPacket_ClientStream_MethodNotActive_SendsError) {
+  EXPECT_EQ(OkStatus(),
+            server_.ProcessPacket(
+                EncodeRequest(PacketType::CLIENT_STREAM, 1, 42, 100), output_));
+
+  EXPECT_EQ(output_.sent_packet().type(), PacketType::SERVER_ERROR);
+  EXPECT_EQ(output_.sent_packet().status(), Status::FailedPrecondition());
+}
+
+TEST_F(MethodPending, ProcessPacket_ClientStream_ServerStream_SendsError) {
+  EXPECT_EQ(OkStatus(),
+            server_.ProcessPacket(
+                EncodeRequest(PacketType::CLIENT_STREAM, 1, 42, 100), output_));
+
+  EXPECT_EQ(output_.sent_packet().type(), PacketType::SERVER_ERROR);
+  EXPECT_EQ(output_.sent_packet().status(), Status::FailedPrecondition());
+  EXPECT_TRUE(writer_.open());
+}
+
+class TestClientStreamHandler : public internal::BaseClientStreamHandler {
+ public:
+  Status ReceivedPayload(const internal::Method&,
+                         std::span<const byte>) override {
+    requests += 1;
+    return status;
+  }
+
+  void ClientStreamEnd() override { stream_ended = true; }
+
+  Status status;
+  int requests = 0;
+  bool stream_ended = false;
+};
+
+class TestReader : public internal::BaseServerWriter {
+ public:
+  TestReader(internal::ServerCall& call,
+             internal::BaseClientStreamHandler& handler)
+      : BaseServerWriter(call, internal::MethodType::kBidirectionalStreaming) {
+    set_client_stream_handler(&handler);
+  }
+};
+
+class ClientStreamPending : public BasicServer {
+ protected:
+  ClientStreamPending()
+      : call_(static_cast<internal::Server&>(server_),
+              static_cast<internal::Channel&>(channels_[0]),
+              service_,
+              service_.method(100)),
+        reader_(call_, handler_) {}
+
+  TestClientStreamHandler handler_;
+  internal::ServerCall call_;
+  TestReader reader_;
+};
+
+TEST_F(ClientStreamPending, ProcessPacket_ClientStream_CallsHandler) {
+  constexpr byte payload[] = {byte{0x08}, byte{0x01}};
+  EXPECT_EQ(OkStatus(),
+            server_.ProcessPacket(
+                EncodeRequest(PacketType::CLIENT_STREAM, 1, 42, 100, payload),
+                output_));
+  EXPECT_EQ(OkStatus(),
+            server_.ProcessPacket(
+                EncodeRequest(PacketType::CLIENT_STREAM_END, 1, 42, 100),
+                output_));
+
+  EXPECT_EQ(handler_.requests, 1);
+  EXPECT_TRUE(handler_.stream_ended);
+  EXPECT_EQ(output_.packet_count(), 0u);
+  EXPECT_TRUE(reader_.open());
+  EXPECT_FALSE(reader_.client_stream_open());
+}
+
+TEST_F(ClientStreamPending, ProcessPacket_ClientStreamAfterEnd_SendsError) {
+  EXPECT_EQ(OkStatus(),
+            server_.ProcessPacket(
+                EncodeRequest(PacketType::CLIENT_STREAM_END, 1, 42, 100),
+                output_));
+  EXPECT_EQ(OkStatus(),
+            server_.ProcessPacket(
+                EncodeRequest(PacketType::CLIENT_STREAM, 1, 42, 100), output_));
+
+  EXPECT_EQ(handler_.requests, 0);
+  EXPECT_EQ(output_.sent_packet().type(), PacketType::SERVER_ERROR);
+  EXPECT_EQ(output_.sent_packet().status(), Status::FailedPrecondition());
+}
+
+TEST_F(ClientStreamPending, ProcessPacket_ClientStream_DecodeError_Closes) {
+  handler_.status = Status::DataLoss();
+  EXPECT_EQ(OkStatus(),
+            server_.ProcessPacket(
+                EncodeRequest(PacketType::CLIENT_STREAM, 1, 42, 100), output_));
+
+  EXPECT_EQ(handler_.requests, 1);
+  EXPECT_FALSE(reader_.open());
+  EXPECT_EQ(output_.packet_count(), 1u);
+  EXPECT_EQ(output_.sent_packet().type(), PacketType::SERVER_ERROR);
+  EXPECT_EQ(output_.sent_packet().status(), Status::DataLoss());
+}
+
 }  // namespace
 }  // namespace pw::rpc
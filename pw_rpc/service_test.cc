@@ -21,9 +21,16 @@ namespace pw::rpc {
 
 class ServiceTestHelper {
  public:
+  // Checks the method order, as Server::RegisterService does, and finds the
+  // method.
   static const internal::Method* FindMethod(Service& service, uint32_t id) {
+    service.methods_sorted_ = service.MethodsSorted();
     return service.FindMethod(id);
   }
+
+  static bool MethodsSorted(const Service& service) {
+    return service.MethodsSorted();
+  }
 };
 
 namespace {
@@ -67,6 +74,7 @@ class TestService : public Service {
 
 TEST(Service, MultipleMethods_FindMethod_Present) {
   TestService service;
+  EXPECT_TRUE(ServiceTestHelper::MethodsSorted(service));
   EXPECT_EQ(ServiceTestHelper::FindMethod(service, 123),
             &TestService::kMethods[0].method());
   EXPECT_EQ(ServiceTestHelper::FindMethod(service, 456),
@@ -82,6 +90,29 @@ TEST(Service, MultipleMethods_FindMethod_NotPresent) {
   EXPECT_EQ(ServiceTestHelper::FindMethod(service, 999), nullptr);
 }
 
+class UnsortedTestService : public Service {
+ public:
+  constexpr UnsortedTestService() : Service(0xabcd, kMethods) {}
+
+  static constexpr std::array<ServiceTestMethodUnion, 4> kMethods = {
+      ServiceTestMethod(789, 'a'),
+      ServiceTestMethod(123, 'b'),
+      ServiceTestMethod(999, 'c'),
+      ServiceTestMethod(456, 'd'),
+  };
+};
+
+TEST(Service, UnsortedMethods_FindMethod) {
+  UnsortedTestService service;
+  EXPECT_FALSE(ServiceTestHelper::MethodsSorted(service));
+  for (const ServiceTestMethodUnion& method : UnsortedTestService::kMethods) {
+    EXPECT_EQ(ServiceTestHelper::FindMethod(service, method.method().id()),
+              &method.method());
+  }
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 0), nullptr);
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 457), nullptr);
+}
+
 class EmptyTestService : public Service {
  public:
   constexpr EmptyTestService() : Service(0xabcd, kMethods) {}
@@ -0,0 +1,98 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/buffered_stream.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_status/try.h"
+
+namespace pw::stream {
+
+Status BufferedWriter::Flush() {
+  if (size_ == 0u) {
+    return OkStatus();
+  }
+  PW_TRY(output_.Write(buffer_.first(size_)));
+  size_ = 0;
+  return OkStatus();
+}
+
+Status BufferedWriter::DoWrite(ConstByteSpan data) {
+  if (data.size() > buffer_.size() - size_) {
+    PW_TRY(Flush());
+  }
+  if (data.size() >= buffer_.size()) {
+    return output_.Write(data);
+  }
+  std::memcpy(buffer_.data() + size_, data.data(), data.size());
+  size_ += data.size();
+  return OkStatus();
+}
+
+Result<ConstByteSpan> BufferedReader::Peek(size_t size_bytes) {
+  size_bytes = std::min(size_bytes, buffer_.size());
+
+  if (buffered_bytes() < size_bytes) {
+    // Move the buffered bytes to the front to make room at the end.
+    std::memmove(buffer_.data(), buffer_.data() + begin_, buffered_bytes());
+    end_ -= begin_;
+    begin_ = 0;
+
+    while (end_ < size_bytes) {
+      const Result<ByteSpan> result = input_.Read(buffer_.subspan(end_));
+      if (!result.ok()) {
+        if (end_ == 0u) {
+          return result.status();
+        }
+        break;
+      }
+      end_ += result.value().size();
+    }
+  }
+
+  return ConstByteSpan(
+      buffer_.subspan(begin_, std::min(size_bytes, buffered_bytes())));
+}
+
+StatusWithSize BufferedReader::DoRead(ByteSpan dest) {
+  if (dest.empty()) {
+    return StatusWithSize(0);
+  }
+
+  if (buffered_bytes() == 0u) {
+    begin_ = 0;
+    end_ = 0;
+
+    if (dest.size() >= buffer_.size()) {
+      const Result<ByteSpan> result = input_.Read(dest);
+      return result.ok() ? StatusWithSize(result.value().size())
+                         : StatusWithSize(result.status(), 0);
+    }
+
+    const Result<ByteSpan> result = input_.Read(buffer_);
+    if (!result.ok()) {
+      return StatusWithSize(result.status(), 0);
+    }
+    end_ = result.value().size();
+  }
+
+  const size_t size = std::min(dest.size(), buffered_bytes());
+  std::memcpy(dest.data(), buffer_.data() + begin_, size);
+  begin_ += size;
+  return StatusWithSize(size);
+}
+
+}  // namespace pw::stream
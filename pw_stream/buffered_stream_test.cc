@@ -0,0 +1,191 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/buffered_stream.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::stream {
+namespace {
+
+// Counts the calls to DoWrite() and DoRead() of the wrapped memory streams.
+class CountingWriter : public Writer {
+ public:
+  CountingWriter(ByteSpan dest) : writer_(dest) {}
+
+  ConstByteSpan WrittenData() const { return writer_.WrittenData(); }
+  size_t ConservativeWriteLimit() const override {
+    return writer_.ConservativeWriteLimit();
+  }
+
+  size_t writes = 0;
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    writes += 1;
+    return writer_.Write(data);
+  }
+
+  MemoryWriter writer_;
+};
+
+class CountingReader : public Reader {
+ public:
+  CountingReader(ConstByteSpan source) : reader_(source) {}
+
+  size_t reads = 0;
+
+ private:
+  StatusWithSize DoRead(ByteSpan dest) override {
+    reads += 1;
+    Result<ByteSpan> result = reader_.Read(dest);
+    return result.ok() ? StatusWithSize(result.value().size())
+                       : StatusWithSize(result.status(), 0);
+  }
+
+  MemoryReader reader_;
+};
+
+constexpr std::array<std::byte, 10> kData = {
+    std::byte{0}, std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4},
+    std::byte{5}, std::byte{6}, std::byte{7}, std::byte{8}, std::byte{9}};
+
+TEST(BufferedWriter, SmallWrites_CombinedOnFlush) {
+  std::byte sink[16];
+  CountingWriter output(sink);
+  BufferedWriterBuffer<8> writer(output);
+
+  for (size_t i = 0; i < 6; ++i) {
+    ASSERT_EQ(OkStatus(), writer.Write(kData[i]));
+  }
+  EXPECT_EQ(0u, output.writes);
+  EXPECT_EQ(6u, writer.buffered_bytes());
+
+  ASSERT_EQ(OkStatus(), writer.Flush());
+  EXPECT_EQ(1u, output.writes);
+  EXPECT_EQ(0u, writer.buffered_bytes());
+  ASSERT_EQ(6u, output.WrittenData().size());
+  EXPECT_EQ(0, std::memcmp(kData.data(), output.WrittenData().data(), 6));
+}
+
+TEST(BufferedWriter, FullBuffer_FlushesBeforeWrite) {
+  std::byte sink[16];
+  CountingWriter output(sink);
+  BufferedWriterBuffer<4> writer(output);
+
+  ASSERT_EQ(OkStatus(), writer.Write(std::span(kData).first(3)));
+  ASSERT_EQ(OkStatus(), writer.Write(std::span(kData).subspan(3, 3)));
+  EXPECT_EQ(1u, output.writes);
+  EXPECT_EQ(3u, writer.buffered_bytes());
+
+  // A write as large as the buffer goes straight to the output.
+  ASSERT_EQ(OkStatus(), writer.Write(std::span(kData).subspan(6, 4)));
+  EXPECT_EQ(3u, output.writes);
+  EXPECT_EQ(0u, writer.buffered_bytes());
+
+  ASSERT_EQ(kData.size(), output.WrittenData().size());
+  EXPECT_EQ(
+      0, std::memcmp(kData.data(), output.WrittenData().data(), kData.size()));
+}
+
+TEST(BufferedWriter, FlushFails_KeepsData) {
+  std::byte sink[2];
+  CountingWriter output(sink);
+  BufferedWriterBuffer<4> writer(output);
+
+  ASSERT_EQ(OkStatus(), writer.Write(std::span(kData).first(3)));
+  EXPECT_EQ(Status::ResourceExhausted(), writer.Flush());
+  EXPECT_EQ(3u, writer.buffered_bytes());
+}
+
+TEST(BufferedReader, SmallReads_ReadInputOnce) {
+  CountingReader input(kData);
+  BufferedReaderBuffer<16> reader(input);
+
+  for (size_t i = 0; i < kData.size(); ++i) {
+    std::byte b;
+    Result<ByteSpan> result = reader.Read(&b, 1);
+    ASSERT_EQ(OkStatus(), result.status());
+    EXPECT_EQ(kData[i], b);
+  }
+  EXPECT_EQ(1u, input.reads);
+
+  std::byte b;
+  EXPECT_EQ(Status::OutOfRange(), reader.Read(&b, 1).status());
+}
+
+TEST(BufferedReader, LargeRead_BypassesBuffer) {
+  CountingReader input(kData);
+  BufferedReaderBuffer<4> reader(input);
+
+  std::byte first[2];
+  ASSERT_EQ(2u, reader.Read(first).value().size());
+  EXPECT_EQ(2u, reader.buffered_bytes());
+
+  // Buffered bytes are returned first, then large reads go to the input.
+  std::byte rest[8];
+  ASSERT_EQ(2u, reader.Read(rest).value().size());
+  EXPECT_EQ(kData[2], rest[0]);
+  ASSERT_EQ(6u, reader.Read(rest).value().size());
+  EXPECT_EQ(kData[4], rest[0]);
+  EXPECT_EQ(kData[9], rest[5]);
+}
+
+TEST(BufferedReader, Peek_DoesNotConsume) {
+  CountingReader input(kData);
+  BufferedReaderBuffer<8> reader(input);
+
+  Result<ConstByteSpan> peeked = reader.Peek(3);
+  ASSERT_EQ(OkStatus(), peeked.status());
+  ASSERT_EQ(3u, peeked.value().size());
+  EXPECT_EQ(kData[2], peeked.value()[2]);
+
+  std::byte bytes[5];
+  ASSERT_EQ(5u, reader.Read(bytes).value().size());
+  EXPECT_EQ(kData[0], bytes[0]);
+  EXPECT_EQ(kData[4], bytes[4]);
+}
+
+TEST(BufferedReader, Peek_RefillsAfterPartialConsume) {
+  CountingReader input(kData);
+  BufferedReaderBuffer<8> reader(input);
+
+  std::byte bytes[6];
+  ASSERT_EQ(6u, reader.Read(bytes).value().size());
+  EXPECT_EQ(2u, reader.buffered_bytes());
+
+  // Peeking more than is buffered moves the buffered bytes forward and reads.
+  Result<ConstByteSpan> peeked = reader.Peek(4);
+  ASSERT_EQ(OkStatus(), peeked.status());
+  ASSERT_EQ(4u, peeked.value().size());
+  EXPECT_EQ(kData[6], peeked.value()[0]);
+  EXPECT_EQ(kData[9], peeked.value()[3]);
+
+  // Peeking past the end returns what is available.
+  EXPECT_EQ(4u, reader.Peek(8).value().size());
+}
+
+TEST(BufferedReader, Peek_EmptyInput) {
+  CountingReader input(ConstByteSpan{});
+  BufferedReaderBuffer<8> reader(input);
+  EXPECT_EQ(Status::OutOfRange(), reader.Peek(1).status());
+}
+
+}  // namespace
+}  // namespace pw::stream
@@ -14,6 +14,7 @@
 
 #include "pw_stream/memory_stream.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstring>
 
@@ -29,13 +30,55 @@ Status MemoryWriter::DoWrite(ConstByteSpan data) {
     return Status::ResourceExhausted();
   }
 
-  size_t bytes_to_write = data.size_bytes();
-  std::memcpy(dest_.data() + bytes_written_, data.data(), bytes_to_write);
-  bytes_written_ += bytes_to_write;
+  CopyTo(position_, data);
+  position_ += data.size_bytes();
+  return OkStatus();
+}
 
+Status MemoryWriter::DoWriteVectored(std::span<const ConstByteSpan> data) {
+  size_t size_bytes = 0;
+  for (ConstByteSpan span : data) {
+    size_bytes += span.size_bytes();
+  }
+
+  if (ConservativeWriteLimit() == 0) {
+    return Status::OutOfRange();
+  }
+  if (ConservativeWriteLimit() < size_bytes) {
+    return Status::ResourceExhausted();
+  }
+
+  for (ConstByteSpan span : data) {
+    CopyTo(position_, span);
+    position_ += span.size_bytes();
+  }
+  return OkStatus();
+}
+
+Status MemoryWriter::DoSeek(size_t offset) {
+  if (offset > bytes_written_) {
+    return Status::InvalidArgument();
+  }
+  position_ = offset;
   return OkStatus();
 }
 
+Status MemoryWriter::DoWriteAt(size_t offset, ConstByteSpan data) {
+  if (offset > bytes_written_) {
+    return Status::InvalidArgument();
+  }
+  if (data.size_bytes() > dest_.size_bytes() - offset) {
+    return Status::ResourceExhausted();
+  }
+  CopyTo(offset, data);
+  return OkStatus();
+}
+
+void MemoryWriter::CopyTo(size_t offset, ConstByteSpan data) {
+  std::memcpy(dest_.data() + offset, data.data(), data.size_bytes());
+  bytes_written_ = std::max(bytes_written_, offset + data.size_bytes());
+}
+
 StatusWithSize MemoryReader::DoRead(ByteSpan dest) {
   if (source_.size_bytes() == bytes_read_) {
     return StatusWithSize::OutOfRange();
@@ -50,4 +93,23 @@ StatusWithSize MemoryReader::DoRead(ByteSpan dest) {
   return StatusWithSize(bytes_to_read);
 }
 
+Status MemoryReader::DoSeek(size_t offset) {
+  if (offset > source_.size_bytes()) {
+    return Status::InvalidArgument();
+  }
+  bytes_read_ = offset;
+  return OkStatus();
+}
+
+StatusWithSize MemoryReader::DoReadAt(size_t offset, ByteSpan dest) const {
+  if (offset >= source_.size_bytes()) {
+    return StatusWithSize::OutOfRange();
+  }
+
+  const size_t bytes_to_read =
+      std::min(dest.size_bytes(), source_.size_bytes() - offset);
+  std::memcpy(dest.data(), source_.data() + offset, bytes_to_read);
+  return StatusWithSize(bytes_to_read);
+}
+
 }  // namespace pw::stream
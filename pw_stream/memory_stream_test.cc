@@ -132,6 +132,139 @@ TEST(MemoryWriter, ValidateContents_SingleByteWrites) {
 }
 
 #define TESTING_CHECK_FAILURES_IS_SUPPORTED 0
+TEST(MemoryWriter, WriteChain) {
+  std::byte header_buffer[4] = {std::byte{1}, std::byte{2}};
+  std::byte payload_buffer[3] = {std::byte{3}, std::byte{4}, std::byte{5}};
+  ByteChain::Chunk header(ByteSpan(header_buffer), 0, 2);
+  ByteChain::Chunk empty(ByteSpan{});
+  ByteChain::Chunk payload(payload_buffer);
+  ByteChain chain;
+  chain.push_back(header);
+  chain.push_back(empty);
+  chain.push_back(payload);
+
+  std::byte buffer[8] = {};
+  MemoryWriter memory_writer(buffer);
+  ASSERT_EQ(OkStatus(), memory_writer.Write(chain));
+  ASSERT_EQ(5u, memory_writer.bytes_written());
+  for (size_t i = 0; i < 5u; ++i) {
+    EXPECT_EQ(std::byte(i + 1), buffer[i]);
+  }
+}
+
+TEST(MemoryWriter, WriteChain_TooLarge_WritesNothing) {
+  std::byte payload_buffer[3] = {};
+  ByteChain::Chunk first(payload_buffer);
+  ByteChain::Chunk second(payload_buffer);
+  ByteChain chain;
+  chain.push_back(first);
+  chain.push_back(second);
+
+  std::byte buffer[5] = {};
+  MemoryWriter memory_writer(buffer);
+  EXPECT_EQ(Status::ResourceExhausted(), memory_writer.Write(chain));
+  EXPECT_EQ(0u, memory_writer.bytes_written());
+}
+
+TEST(MemoryWriter, WriteVectored) {
+  constexpr std::array<std::byte, 2> kHeader = {std::byte{1}, std::byte{2}};
+  constexpr std::array<std::byte, 3> kPayload = {
+      std::byte{3}, std::byte{4}, std::byte{5}};
+  const ConstByteSpan spans[] = {kHeader, ConstByteSpan(), kPayload};
+
+  std::byte buffer[8] = {};
+  MemoryWriter memory_writer(buffer);
+  ASSERT_EQ(OkStatus(), memory_writer.Write(spans));
+  ASSERT_EQ(5u, memory_writer.bytes_written());
+  for (size_t i = 0; i < 5u; ++i) {
+    EXPECT_EQ(std::byte(i + 1), buffer[i]);
+  }
+}
+
+TEST(MemoryWriter, WriteVectored_TooLarge_WritesNothing) {
+  std::byte payload[3] = {};
+  const ConstByteSpan spans[] = {payload, payload};
+
+  std::byte buffer[5] = {};
+  MemoryWriter memory_writer(buffer);
+  EXPECT_EQ(Status::ResourceExhausted(), memory_writer.Write(spans));
+  EXPECT_EQ(0u, memory_writer.bytes_written());
+
+  MemoryWriter full_writer(ByteSpan{});
+  EXPECT_EQ(Status::OutOfRange(), full_writer.Write(spans));
+}
+
+TEST(MemoryWriter, Seek_OverwritesWithoutTruncating) {
+  std::byte buffer[8] = {};
+  MemoryWriter writer(buffer);
+  const std::byte data[4] = {
+      std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4}};
+  ASSERT_EQ(OkStatus(), writer.Write(data));
+
+  ASSERT_EQ(OkStatus(), writer.Seek(1));
+  EXPECT_EQ(1u, writer.Tell());
+  ASSERT_EQ(OkStatus(), writer.Write(std::byte{9}));
+  EXPECT_EQ(2u, writer.Tell());
+  EXPECT_EQ(4u, writer.bytes_written());
+  EXPECT_EQ(std::byte{9}, buffer[1]);
+  EXPECT_EQ(std::byte{3}, buffer[2]);
+
+  // Writing past the end of the written data extends it.
+  ASSERT_EQ(OkStatus(), writer.Write(data));
+  EXPECT_EQ(6u, writer.bytes_written());
+
+  EXPECT_EQ(Status::InvalidArgument(), writer.Seek(7));
+}
+
+TEST(MemoryWriter, WriteAt) {
+  std::byte buffer[6] = {};
+  MemoryWriter writer(buffer);
+  const std::byte data[2] = {std::byte{1}, std::byte{2}};
+  ASSERT_EQ(OkStatus(), writer.Write(data));
+
+  ASSERT_EQ(OkStatus(), writer.WriteAt(0, std::span(data).first(1)));
+  ASSERT_EQ(OkStatus(), writer.WriteAt(2, data));
+  EXPECT_EQ(2u, writer.Tell());
+  EXPECT_EQ(4u, writer.bytes_written());
+
+  EXPECT_EQ(Status::InvalidArgument(), writer.WriteAt(5, data));
+  EXPECT_EQ(Status::ResourceExhausted(),
+            writer.WriteAt(4, std::span(buffer).first(3)));
+}
+
+TEST(MemoryReader, Seek) {
+  constexpr std::array<std::byte, 4> kSource = {
+      std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4}};
+  MemoryReader reader(kSource);
+
+  ASSERT_EQ(OkStatus(), reader.Seek(2));
+  EXPECT_EQ(2u, reader.Tell());
+  std::byte b;
+  ASSERT_EQ(OkStatus(), reader.Read(&b, 1).status());
+  EXPECT_EQ(std::byte{3}, b);
+  EXPECT_EQ(3u, reader.Tell());
+
+  ASSERT_EQ(OkStatus(), reader.Seek(4));
+  EXPECT_EQ(Status::OutOfRange(), reader.Read(&b, 1).status());
+  EXPECT_EQ(Status::InvalidArgument(), reader.Seek(5));
+}
+
+TEST(MemoryReader, ReadAt_DoesNotMovePosition) {
+  constexpr std::array<std::byte, 4> kSource = {
+      std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4}};
+  MemoryReader reader(kSource);
+
+  std::byte dest[3] = {};
+  StatusWithSize result = reader.ReadAt(2, dest);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(2u, result.size());
+  EXPECT_EQ(std::byte{3}, dest[0]);
+  EXPECT_EQ(std::byte{4}, dest[1]);
+  EXPECT_EQ(0u, reader.Tell());
+
+  EXPECT_EQ(Status::OutOfRange(), reader.ReadAt(4, dest).status());
+}
+
 #if TESTING_CHECK_FAILURES_IS_SUPPORTED
 
 // TODO(amontanez): Ensure that this test triggers an assert.
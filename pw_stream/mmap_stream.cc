@@ -0,0 +1,215 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/mmap_stream.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace pw::stream {
+
+Status MmapReader::Open(const char* path) {
+  if (data_.data() != nullptr) {
+    return Status::FailedPrecondition();
+  }
+
+  const int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return errno == ENOENT ? Status::NotFound() : Status::Internal();
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    close(fd);
+    return Status::Internal();
+  }
+
+  position_ = 0;
+  const size_t size_bytes = static_cast<size_t>(info.st_size);
+  if (size_bytes == 0u) {  // Empty files cannot be mapped.
+    close(fd);
+    data_ = ConstByteSpan();
+    return OkStatus();
+  }
+
+  // The mapping remains valid after the file is closed.
+  void* const mapping = mmap(nullptr, size_bytes, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return Status::Internal();
+  }
+
+  // Large files are usually read from start to end, so read ahead.
+  madvise(mapping, size_bytes, MADV_SEQUENTIAL);
+  data_ = ConstByteSpan(static_cast<const std::byte*>(mapping), size_bytes);
+  return OkStatus();
+}
+
+void MmapReader::Close() {
+  if (data_.data() != nullptr) {
+    munmap(const_cast<std::byte*>(data_.data()), data_.size_bytes());
+  }
+  data_ = ConstByteSpan();
+  position_ = 0;
+}
+
+Result<ConstByteSpan> MmapReader::ReadView(size_t size_bytes) {
+  if (ConservativeReadLimit() == 0u) {
+    return Status::OutOfRange();
+  }
+  const ConstByteSpan view =
+      data_.subspan(position_, std::min(size_bytes, ConservativeReadLimit()));
+  position_ += view.size_bytes();
+  return view;
+}
+
+StatusWithSize MmapReader::DoRead(ByteSpan dest) {
+  const StatusWithSize result = DoReadAt(position_, dest);
+  position_ += result.size();
+  return result;
+}
+
+Status MmapReader::DoSeek(size_t offset) {
+  if (offset > data_.size_bytes()) {
+    return Status::InvalidArgument();
+  }
+  position_ = offset;
+  return OkStatus();
+}
+
+StatusWithSize MmapReader::DoReadAt(size_t offset, ByteSpan dest) const {
+  if (offset >= data_.size_bytes()) {
+    return StatusWithSize::OutOfRange();
+  }
+
+  const size_t bytes_to_read =
+      std::min(dest.size_bytes(), data_.size_bytes() - offset);
+  std::memcpy(dest.data(), data_.data() + offset, bytes_to_read);
+  return StatusWithSize(bytes_to_read);
+}
+
+Status MmapWriter::Open(const char* path, size_t capacity_bytes) {
+  if (fd_ >= 0) {
+    return Status::FailedPrecondition();
+  }
+  if (capacity_bytes == 0u) {
+    return Status::InvalidArgument();
+  }
+
+  const int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return Status::Internal();
+  }
+
+  if (ftruncate(fd, static_cast<off_t>(capacity_bytes)) != 0) {
+    close(fd);
+    return Status::Internal();
+  }
+
+  void* const mapping = mmap(
+      nullptr, capacity_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mapping == MAP_FAILED) {
+    close(fd);
+    return Status::Internal();
+  }
+
+  fd_ = fd;
+  data_ = ByteSpan(static_cast<std::byte*>(mapping), capacity_bytes);
+  position_ = 0;
+  bytes_written_ = 0;
+  return OkStatus();
+}
+
+Status MmapWriter::Sync() {
+  if (fd_ < 0) {
+    return Status::FailedPrecondition();
+  }
+  if (msync(data_.data(), data_.size_bytes(), MS_SYNC) != 0) {
+    return Status::Internal();
+  }
+  return OkStatus();
+}
+
+Status MmapWriter::Close() {
+  if (fd_ < 0) {
+    return OkStatus();
+  }
+
+  munmap(data_.data(), data_.size_bytes());
+  const bool truncated =
+      ftruncate(fd_, static_cast<off_t>(bytes_written_)) == 0;
+  close(fd_);
+
+  fd_ = -1;
+  data_ = ByteSpan();
+  position_ = 0;
+  bytes_written_ = 0;
+  return truncated ? OkStatus() : Status::Internal();
+}
+
+Result<ByteSpan> MmapWriter::WriteView(size_t size_bytes) {
+  if (size_bytes > ConservativeWriteLimit()) {
+    return Status::ResourceExhausted();
+  }
+  const ByteSpan view = data_.subspan(position_, size_bytes);
+  position_ += size_bytes;
+  Extend(position_);
+  return view;
+}
+
+Status MmapWriter::DoWrite(ConstByteSpan data) {
+  if (ConservativeWriteLimit() == 0u) {
+    return Status::OutOfRange();
+  }
+  if (ConservativeWriteLimit() < data.size_bytes()) {
+    return Status::ResourceExhausted();
+  }
+
+  std::memcpy(data_.data() + position_, data.data(), data.size_bytes());
+  position_ += data.size_bytes();
+  Extend(position_);
+  return OkStatus();
+}
+
+Status MmapWriter::DoSeek(size_t offset) {
+  if (offset > bytes_written_) {
+    return Status::InvalidArgument();
+  }
+  position_ = offset;
+  return OkStatus();
+}
+
+Status MmapWriter::DoWriteAt(size_t offset, ConstByteSpan data) {
+  if (offset > bytes_written_) {
+    return Status::InvalidArgument();
+  }
+  if (data.size_bytes() > data_.size_bytes() - offset) {
+    return Status::ResourceExhausted();
+  }
+  std::memcpy(data_.data() + offset, data.data(), data.size_bytes());
+  Extend(offset + data.size_bytes());
+  return OkStatus();
+}
+
+void MmapWriter::Extend(size_t end) {
+  bytes_written_ = std::max(bytes_written_, end);
+}
+
+}  // namespace pw::stream
@@ -0,0 +1,178 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/mmap_stream.h"
+
+#include <unistd.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+namespace pw::stream {
+namespace {
+
+constexpr std::array<std::byte, 10> kData = {
+    std::byte{0}, std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4},
+    std::byte{5}, std::byte{6}, std::byte{7}, std::byte{8}, std::byte{9}};
+
+class MmapStreamTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::strcpy(path_, "/tmp/pw_stream_mmap_test_XXXXXX");
+    const int fd = mkstemp(path_);
+    ASSERT_GE(fd, 0);
+    close(fd);
+  }
+
+  void TearDown() override { std::remove(path_); }
+
+  void WriteFile(ConstByteSpan data) {
+    std::FILE* file = std::fopen(path_, "wb");
+    ASSERT_NE(nullptr, file);
+    EXPECT_EQ(data.size(), std::fwrite(data.data(), 1, data.size(), file));
+    std::fclose(file);
+  }
+
+  char path_[32];
+};
+
+TEST_F(MmapStreamTest, Reader_DataIsWholeFile) {
+  WriteFile(kData);
+  MmapReader reader;
+  ASSERT_EQ(OkStatus(), reader.Open(path_));
+  ASSERT_EQ(kData.size(), reader.data().size());
+  EXPECT_EQ(0, std::memcmp(kData.data(), reader.data().data(), kData.size()));
+  EXPECT_EQ(kData.size(), reader.ConservativeReadLimit());
+}
+
+TEST_F(MmapStreamTest, Reader_OpenMissingFile) {
+  MmapReader reader;
+  EXPECT_EQ(Status::NotFound(), reader.Open("/tmp/pw_stream_no_such_file"));
+}
+
+TEST_F(MmapStreamTest, Reader_OpenTwice) {
+  WriteFile(kData);
+  MmapReader reader;
+  ASSERT_EQ(OkStatus(), reader.Open(path_));
+  EXPECT_EQ(Status::FailedPrecondition(), reader.Open(path_));
+}
+
+TEST_F(MmapStreamTest, Reader_EmptyFile) {
+  MmapReader reader;
+  ASSERT_EQ(OkStatus(), reader.Open(path_));
+  EXPECT_TRUE(reader.data().empty());
+
+  std::array<std::byte, 4> buffer;
+  EXPECT_EQ(Status::OutOfRange(), reader.Read(buffer).status());
+  EXPECT_EQ(Status::OutOfRange(), reader.ReadView(1).status());
+}
+
+TEST_F(MmapStreamTest, Reader_ReadViewAdvances) {
+  WriteFile(kData);
+  MmapReader reader;
+  ASSERT_EQ(OkStatus(), reader.Open(path_));
+
+  Result<ConstByteSpan> view = reader.ReadView(4);
+  ASSERT_EQ(OkStatus(), view.status());
+  EXPECT_EQ(reader.data().data(), view.value().data());
+  EXPECT_EQ(4u, view.value().size());
+
+  view = reader.ReadView(100);
+  ASSERT_EQ(OkStatus(), view.status());
+  EXPECT_EQ(reader.data().data() + 4, view.value().data());
+  EXPECT_EQ(6u, view.value().size());
+
+  EXPECT_EQ(Status::OutOfRange(), reader.ReadView(1).status());
+}
+
+TEST_F(MmapStreamTest, Reader_ReadSeekAndReadAt) {
+  WriteFile(kData);
+  MmapReader reader;
+  ASSERT_EQ(OkStatus(), reader.Open(path_));
+
+  std::array<std::byte, 4> buffer;
+  ASSERT_EQ(OkStatus(), reader.Read(buffer).status());
+  EXPECT_EQ(std::byte{3}, buffer[3]);
+  EXPECT_EQ(4u, reader.Tell());
+
+  ASSERT_EQ(OkStatus(), reader.Seek(8));
+  Result<ByteSpan> result = reader.Read(buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(2u, result.value().size());
+  EXPECT_EQ(std::byte{9}, buffer[1]);
+  EXPECT_EQ(Status::InvalidArgument(), reader.Seek(11));
+
+  const StatusWithSize read_at = reader.ReadAt(5, buffer);
+  ASSERT_EQ(OkStatus(), read_at.status());
+  EXPECT_EQ(4u, read_at.size());
+  EXPECT_EQ(std::byte{5}, buffer[0]);
+  EXPECT_EQ(10u, reader.Tell());
+  EXPECT_EQ(Status::OutOfRange(), reader.ReadAt(10, buffer).status());
+}
+
+TEST_F(MmapStreamTest, Writer_CloseTruncatesToWrittenData) {
+  MmapWriter writer;
+  ASSERT_EQ(OkStatus(), writer.Open(path_, 4096));
+  ASSERT_EQ(OkStatus(), writer.Write(std::span(kData).first(6)));
+
+  Result<ByteSpan> view = writer.WriteView(4);
+  ASSERT_EQ(OkStatus(), view.status());
+  std::memcpy(view.value().data(), &kData[6], 4);
+  EXPECT_EQ(kData.size(), writer.bytes_written());
+  ASSERT_EQ(OkStatus(), writer.Sync());
+  ASSERT_EQ(OkStatus(), writer.Close());
+
+  MmapReader reader;
+  ASSERT_EQ(OkStatus(), reader.Open(path_));
+  ASSERT_EQ(kData.size(), reader.data().size());
+  EXPECT_EQ(0, std::memcmp(kData.data(), reader.data().data(), kData.size()));
+}
+
+TEST_F(MmapStreamTest, Writer_SeekAndWriteAt) {
+  MmapWriter writer;
+  ASSERT_EQ(OkStatus(), writer.Open(path_, 16));
+  ASSERT_EQ(OkStatus(), writer.Write(kData));
+
+  const std::byte value{0xab};
+  ASSERT_EQ(OkStatus(), writer.WriteAt(2, std::span(&value, 1)));
+  EXPECT_EQ(Status::InvalidArgument(),
+            writer.WriteAt(11, std::span(&value, 1)));
+  ASSERT_EQ(OkStatus(), writer.Seek(9));
+  ASSERT_EQ(OkStatus(), writer.Write(std::span(&value, 1)));
+  EXPECT_EQ(Status::InvalidArgument(), writer.Seek(11));
+
+  EXPECT_EQ(kData.size(), writer.bytes_written());
+  EXPECT_EQ(value, writer.WrittenData()[2]);
+  EXPECT_EQ(value, writer.WrittenData()[9]);
+}
+
+TEST_F(MmapStreamTest, Writer_CapacityExhausted) {
+  MmapWriter writer;
+  EXPECT_EQ(Status::InvalidArgument(), writer.Open(path_, 0));
+  ASSERT_EQ(OkStatus(), writer.Open(path_, 8));
+
+  EXPECT_EQ(Status::ResourceExhausted(), writer.Write(kData));
+  EXPECT_EQ(0u, writer.bytes_written());
+  EXPECT_EQ(Status::ResourceExhausted(), writer.WriteView(9).status());
+  ASSERT_EQ(OkStatus(), writer.WriteView(8).status());
+  EXPECT_EQ(Status::OutOfRange(), writer.Write(kData));
+}
+
+}  // namespace
+}  // namespace pw::stream
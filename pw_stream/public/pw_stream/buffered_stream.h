@@ -0,0 +1,121 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <limits>
+
+#include "pw_bytes/span.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
+
+namespace pw::stream {
+
+// BufferedWriter collects small writes in a caller-provided buffer and writes
+// them to another Writer in one call when the buffer fills or Flush() is
+// called. This turns the many small writes of byte-level encoders into a few
+// large writes to an unbuffered sink, such as a UART or socket.
+//
+// Writes at least as large as the buffer bypass it, after the buffered data is
+// flushed. Data is not flushed when the BufferedWriter is destroyed, so call
+// Flush() after the last write.
+class BufferedWriter : public Writer {
+ public:
+  constexpr BufferedWriter(Writer& output, ByteSpan buffer)
+      : output_(output), buffer_(buffer), size_(0) {}
+
+  // Writes the buffered data to the output. If the write fails, the data stays
+  // buffered, and the output's error is returned.
+  Status Flush();
+
+  // The number of bytes waiting to be flushed.
+  size_t buffered_bytes() const { return size_; }
+
+  size_t ConservativeWriteLimit() const override {
+    const size_t limit = output_.ConservativeWriteLimit();
+    if (limit == std::numeric_limits<size_t>::max()) {
+      return limit;
+    }
+    return limit > size_ ? limit - size_ : 0;
+  }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override;
+
+  Writer& output_;
+  ByteSpan buffer_;
+  size_t size_;
+};
+
+// A BufferedWriter with an internal buffer.
+template <size_t kBufferSizeBytes>
+class BufferedWriterBuffer final : public BufferedWriter {
+ public:
+  BufferedWriterBuffer(Writer& output) : BufferedWriter(output, buffer_) {}
+
+ private:
+  std::array<std::byte, kBufferSizeBytes> buffer_;
+};
+
+// BufferedReader reads from another Reader in buffer-sized chunks, so that many
+// small reads result in few reads from the input. Peek() returns upcoming bytes
+// without consuming them, which lets parsers look ahead.
+//
+// Reads at least as large as the buffer bypass it once the buffered data is
+// consumed.
+class BufferedReader : public Reader {
+ public:
+  constexpr BufferedReader(Reader& input, ByteSpan buffer)
+      : input_(input), buffer_(buffer), begin_(0), end_(0) {}
+
+  // Returns up to size_bytes of the next bytes without consuming them. Reads
+  // from the input until size_bytes are buffered, the buffer is full, or the
+  // input returns an error. Returns fewer bytes than requested if the input
+  // did not provide them, or the input's error if no bytes are buffered.
+  Result<ConstByteSpan> Peek(size_t size_bytes);
+
+  // The number of bytes that can be read without reading from the input.
+  size_t buffered_bytes() const { return end_ - begin_; }
+
+  size_t ConservativeReadLimit() const override {
+    const size_t limit = input_.ConservativeReadLimit();
+    if (limit == std::numeric_limits<size_t>::max()) {
+      return limit;
+    }
+    return limit + buffered_bytes();
+  }
+
+ private:
+  StatusWithSize DoRead(ByteSpan dest) override;
+
+  Reader& input_;
+  ByteSpan buffer_;
+  size_t begin_;
+  size_t end_;
+};
+
+// A BufferedReader with an internal buffer.
+template <size_t kBufferSizeBytes>
+class BufferedReaderBuffer final : public BufferedReader {
+ public:
+  BufferedReaderBuffer(Reader& input) : BufferedReader(input, buffer_) {}
+
+ private:
+  std::array<std::byte, kBufferSizeBytes> buffer_;
+};
+
+}  // namespace pw::stream
@@ -23,14 +23,18 @@
 
 namespace pw::stream {
 
-class MemoryWriter : public Writer {
+// MemoryWriter writes to a buffer in memory. Seek() moves the position of the
+// next Write() back within the written data, so that earlier bytes can be
+// overwritten without discarding the bytes after them.
+class MemoryWriter : public Writer, public Seekable, public PositionalWriter {
  public:
   MemoryWriter(ByteSpan dest) : dest_(dest) {}
 
+  // The size of the written data, which is the end of the furthest write.
   size_t bytes_written() const { return bytes_written_; }
 
   size_t ConservativeWriteLimit() const override {
-    return dest_.size_bytes() - bytes_written_;
+    return dest_.size_bytes() - position_;
   }
 
   ConstByteSpan WrittenData() const { return dest_.first(bytes_written_); }
@@ -44,7 +48,24 @@ class MemoryWriter : public Writer {
   // perform a partial write and Status::ResourceExhausted() will be returned.
   Status DoWrite(ConstByteSpan data) override;
 
+  // Checks the total size once, then copies each span. Either all of the data
+  // is written or none of it is.
+  Status DoWriteVectored(std::span<const ConstByteSpan> data) override;
+
+  // The offset may be anywhere in the written data, or at its end.
+  Status DoSeek(size_t offset) override;
+
+  size_t DoTell() const override { return position_; }
+
+  // The offset may be anywhere in the written data, or at its end. Writing past
+  // the end of the written data extends it.
+  Status DoWriteAt(size_t offset, ConstByteSpan data) override;
+
+  // Copies the data to the offset and extends the written data if needed.
+  void CopyTo(size_t offset, ConstByteSpan data);
+
   ByteSpan dest_;
+  size_t position_ = 0;
   size_t bytes_written_ = 0;
 };
 
@@ -57,7 +78,11 @@ class MemoryWriterBuffer final : public MemoryWriter {
   std::array<std::byte, size_bytes> buffer_;
 };
 
-class MemoryReader final : public Reader {
+// MemoryReader reads from a buffer in memory. Seek() moves the position of the
+// next Read() and ReadAt() reads from any offset.
+class MemoryReader final : public Reader,
+                           public Seekable,
+                           public PositionalReader {
  public:
   MemoryReader(ConstByteSpan source) : source_(source), bytes_read_(0) {}
 
@@ -76,6 +101,13 @@ class MemoryReader final : public Reader {
   // requested, this will perform a partial read and OK will still be returned.
   StatusWithSize DoRead(ByteSpan dest) override;
 
+  // The offset may be anywhere in the source, or at its end.
+  Status DoSeek(size_t offset) override;
+
+  size_t DoTell() const override { return bytes_read_; }
+
+  StatusWithSize DoReadAt(size_t offset, ByteSpan dest) const override;
+
   ConstByteSpan source_;
   size_t bytes_read_;
 };
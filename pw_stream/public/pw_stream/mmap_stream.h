@@ -0,0 +1,142 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+#include "pw_bytes/span.h"
+#include "pw_result/result.h"
+#include "pw_stream/stream.h"
+
+namespace pw::stream {
+
+// MmapReader reads a file through a read-only memory mapping. Instead of
+// copying the file into a buffer, the operating system pages it in as it is
+// read, so files larger than RAM can be read. data() and ReadView() return
+// views of the mapping without copying.
+//
+// MmapReader is only available on POSIX hosts.
+class MmapReader final : public Reader,
+                         public Seekable,
+                         public PositionalReader {
+ public:
+  MmapReader() = default;
+
+  MmapReader(const MmapReader&) = delete;
+  MmapReader& operator=(const MmapReader&) = delete;
+
+  ~MmapReader() { Close(); }
+
+  // Maps the file. Returns NOT_FOUND if the file does not exist,
+  // FAILED_PRECONDITION if a file is already open, or INTERNAL if the file
+  // could not be mapped.
+  Status Open(const char* path);
+
+  // Unmaps the file. Views of the file are invalid afterwards.
+  void Close();
+
+  // The whole file.
+  ConstByteSpan data() const { return data_; }
+
+  // Returns a view of up to size_bytes bytes at the position and advances the
+  // position past them. Returns OUT_OF_RANGE at the end of the file.
+  Result<ConstByteSpan> ReadView(size_t size_bytes);
+
+  size_t ConservativeReadLimit() const override {
+    return data_.size_bytes() - position_;
+  }
+
+ private:
+  StatusWithSize DoRead(ByteSpan dest) override;
+
+  // The offset may be anywhere in the file, or at its end.
+  Status DoSeek(size_t offset) override;
+
+  size_t DoTell() const override { return position_; }
+
+  StatusWithSize DoReadAt(size_t offset, ByteSpan dest) const override;
+
+  ConstByteSpan data_;
+  size_t position_ = 0;
+};
+
+// MmapWriter writes a file through a shared memory mapping of a fixed
+// capacity. WriteView() returns a view of the file to fill in place, so data
+// can be produced directly into the file without an intermediate buffer.
+//
+// Like MemoryWriter, Seek() and WriteAt() may move anywhere in the written
+// data, and bytes_written() is the end of the furthest write. Close() truncates
+// the file to bytes_written().
+//
+// MmapWriter is only available on POSIX hosts.
+class MmapWriter final : public Writer,
+                         public Seekable,
+                         public PositionalWriter {
+ public:
+  MmapWriter() = default;
+
+  MmapWriter(const MmapWriter&) = delete;
+  MmapWriter& operator=(const MmapWriter&) = delete;
+
+  ~MmapWriter() { Close(); }
+
+  // Creates or truncates the file, extends it to capacity_bytes, and maps it.
+  // Returns FAILED_PRECONDITION if a file is already open, INVALID_ARGUMENT if
+  // the capacity is 0, or INTERNAL if the file could not be created or mapped.
+  Status Open(const char* path, size_t capacity_bytes);
+
+  // Writes the mapped data back to the file and waits for it to complete.
+  Status Sync();
+
+  // Unmaps the file and truncates it to bytes_written(). Returns INTERNAL if
+  // the file could not be truncated.
+  Status Close();
+
+  // Returns a view of size_bytes bytes at the position to fill in place, and
+  // advances the position past them. The bytes count as written. Returns
+  // RESOURCE_EXHAUSTED if the view does not fit in the capacity.
+  Result<ByteSpan> WriteView(size_t size_bytes);
+
+  // The size of the written data, which is the end of the furthest write.
+  size_t bytes_written() const { return bytes_written_; }
+
+  ConstByteSpan WrittenData() const { return data_.first(bytes_written_); }
+
+  size_t ConservativeWriteLimit() const override {
+    return data_.size_bytes() - position_;
+  }
+
+ private:
+  // Either all of the data is written or none of it is.
+  Status DoWrite(ConstByteSpan data) override;
+
+  // The offset may be anywhere in the written data, or at its end.
+  Status DoSeek(size_t offset) override;
+
+  size_t DoTell() const override { return position_; }
+
+  // The offset may be anywhere in the written data, or at its end. Writing past
+  // the end of the written data extends it.
+  Status DoWriteAt(size_t offset, ConstByteSpan data) override;
+
+  // Marks the bytes before end as written.
+  void Extend(size_t end);
+
+  int fd_ = -1;
+  ByteSpan data_;
+  size_t position_ = 0;
+  size_t bytes_written_ = 0;
+};
+
+}  // namespace pw::stream
@@ -29,6 +29,31 @@ class NullWriter final : public Writer {
   Status DoWrite(ConstByteSpan) final { return OkStatus(); }
 };
 
+// NullWriter that counts the bytes and Write() calls it receives. Writing
+// through other writers to a CountingNullWriter measures how many calls the
+// layers above it make, and benchmarks can time those layers without the cost
+// of a real sink.
+class CountingNullWriter final : public Writer {
+ public:
+  size_t bytes_written() const { return bytes_written_; }
+  size_t write_count() const { return write_count_; }
+
+  void clear() {
+    bytes_written_ = 0;
+    write_count_ = 0;
+  }
+
+ private:
+  Status DoWrite(ConstByteSpan data) final {
+    bytes_written_ += data.size_bytes();
+    write_count_ += 1;
+    return OkStatus();
+  }
+
+  size_t bytes_written_ = 0;
+  size_t write_count_ = 0;
+};
+
 // Stream reader which never reads any bytes. Always returns OUT_OF_RANGE, which
 // indicates there is no more data to read.
 class NullReader final : public Reader {
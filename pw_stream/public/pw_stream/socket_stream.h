@@ -31,16 +31,55 @@ namespace pw::stream {
 static constexpr int kExitCode = -1;
 static constexpr int kInvalidFd = -1;
 
+// A Reader and Writer for one TCP connection.
+//
+// By default, reads and writes block. In non-blocking mode, Read() and Write()
+// return RESOURCE_EXHAUSTED instead of blocking when no data can be read or
+// written. Once a write has sent part of its data, it waits until the rest can
+// be sent, so frames are never split by other writes. Event loops can wait for
+// the connection with WaitUntilReadable() and WaitUntilWritable(), or pass
+// connection_fd() to poll() or epoll.
+//
+// Read() returns OUT_OF_RANGE once the peer closes the connection.
 class SocketStream : public Writer, public Reader {
  public:
   explicit SocketStream() {}
 
+  SocketStream(const SocketStream&) = delete;
+  SocketStream& operator=(const SocketStream&) = delete;
+
+  ~SocketStream() { Close(); }
+
   // Listen to the port and return after a client is connected
   Status Init(uint16_t port);
 
+  // Connects to a server at a numeric IPv4 address, such as "127.0.0.1".
+  Status Connect(const char* host, uint16_t port);
+
+  // Closes the connection and any listening socket opened by Init().
+  void Close();
+
+  // Switches the connection between blocking and non-blocking mode.
+  Status SetNonBlocking(bool non_blocking);
+
+  // Waits until the connection has data to read, or can accept writes. A
+  // negative timeout waits forever. Returns DEADLINE_EXCEEDED on timeout.
+  Status WaitUntilReadable(int timeout_ms = -1);
+  Status WaitUntilWritable(int timeout_ms = -1);
+
+  // The connection's file descriptor, for use with poll() or epoll.
+  int connection_fd() const { return conn_fd_; }
+
  private:
+  friend class ServerSocket;
+
   Status DoWrite(std::span<const std::byte> data) override;
 
+  // Write the buffers with sendmsg(), in batches.
+  Status DoWriteVectored(std::span<const ConstByteSpan> data) override;
+
+  Status DoWriteChain(const ByteChain& chain) override;
+
   StatusWithSize DoRead(ByteSpan dest) override;
 
   uint16_t listen_port_ = 0;
@@ -49,4 +88,52 @@ class SocketStream : public Writer, public Reader {
   struct sockaddr_in sockaddr_client_;
 };
 
+// Listens for TCP connections on a port and accepts each one into a
+// SocketStream, so that one server can serve several clients.
+//
+// Usage:
+//
+//   ServerSocket server;
+//   PW_TRY(server.Listen(33000));
+//   PW_TRY(server.SetNonBlocking(true));
+//
+//   // When poll() reports server.fd() readable:
+//   SocketStream& connection = connections[count++];
+//   PW_TRY(server.Accept(connection));
+//
+class ServerSocket {
+ public:
+  constexpr ServerSocket() = default;
+
+  ServerSocket(const ServerSocket&) = delete;
+  ServerSocket& operator=(const ServerSocket&) = delete;
+
+  ~ServerSocket() { Close(); }
+
+  // Listens on the port on all interfaces. Port 0 selects any free port, which
+  // port() then returns.
+  Status Listen(uint16_t port, int backlog = 4);
+
+  // Accepts a pending connection into the stream, which must not have an open
+  // connection. Blocks until a client connects, unless the server is in
+  // non-blocking mode, in which case it returns RESOURCE_EXHAUSTED if no
+  // connection is pending. The accepted connection is in blocking mode.
+  Status Accept(SocketStream& connection);
+
+  // Switches Accept() between blocking and non-blocking mode.
+  Status SetNonBlocking(bool non_blocking);
+
+  void Close();
+
+  uint16_t port() const { return port_; }
+
+  // The listening socket's file descriptor, which is readable when a
+  // connection is pending.
+  int fd() const { return fd_; }
+
+ private:
+  int fd_ = kInvalidFd;
+  uint16_t port_ = 0;
+};
+
 }  // namespace pw::stream
@@ -15,13 +15,16 @@
 
 #include <array>
 #include <cstddef>
+#include <limits>
 #include <span>
 
 #include "pw_assert/light.h"
+#include "pw_bytes/byte_chain.h"
 #include "pw_bytes/span.h"
 #include "pw_result/result.h"
 #include "pw_status/status.h"
 #include "pw_status/status_with_size.h"
+#include "pw_status/try.h"
 
 namespace pw::stream {
 
@@ -69,6 +72,23 @@ class Writer {
   }
   Status Write(const std::byte b) { return Write(&b, 1); }
 
+  // Writes the data of each chunk in the chain, in order, without first
+  // copying the chain into a contiguous buffer. Returns RESOURCE_EXHAUSTED
+  // without writing if ConservativeWriteLimit() is smaller than the chain.
+  // Otherwise, returns the first error from writing a chunk, in which case the
+  // preceding chunks were written.
+  Status Write(const ByteChain& chain) { return DoWriteChain(chain); }
+
+  // Writes the spans in order, as if they were one contiguous buffer, without
+  // first copying them together. This allows a header, payload, and trailer to
+  // be written in one operation by writers that support gather writes. Returns
+  // RESOURCE_EXHAUSTED without writing if ConservativeWriteLimit() is smaller
+  // than the total size. Otherwise, returns the first error from the writer, in
+  // which case the preceding spans may have been written.
+  Status Write(std::span<const ConstByteSpan> data) {
+    return DoWriteVectored(data);
+  }
+
   // Probable (not guaranteed) minimum number of bytes at this time that can be
   // written. This number is advisory and not guaranteed to write without a
   // RESOURCE_EXHAUSTED or OUT_OF_RANGE. As Writer processes/handles enqueued of
@@ -84,6 +104,37 @@ class Writer {
 
  private:
   virtual Status DoWrite(ConstByteSpan data) = 0;
+
+  // Writers that support gather writes, such as writev(), may override these
+  // to write multiple buffers in one operation. By default, they call DoWrite()
+  // for each non-empty buffer.
+  virtual Status DoWriteVectored(std::span<const ConstByteSpan> data) {
+    size_t size_bytes = 0;
+    for (ConstByteSpan span : data) {
+      size_bytes += span.size();
+    }
+    if (size_bytes > ConservativeWriteLimit()) {
+      return Status::ResourceExhausted();
+    }
+    for (ConstByteSpan span : data) {
+      if (!span.empty()) {
+        PW_TRY(DoWrite(span));
+      }
+    }
+    return OkStatus();
+  }
+
+  virtual Status DoWriteChain(const ByteChain& chain) {
+    if (chain.size() > ConservativeWriteLimit()) {
+      return Status::ResourceExhausted();
+    }
+    for (const ByteChain::Chunk& chunk : chain) {
+      if (!chunk.empty()) {
+        PW_TRY(DoWrite(chunk.data()));
+      }
+    }
+    return OkStatus();
+  }
 };
 
 // General-purpose reader interface
@@ -144,4 +195,76 @@ class Reader {
   virtual StatusWithSize DoRead(ByteSpan dest) = 0;
 };
 
+// Capability interface for streams with a position that can be moved, such as
+// a Reader or Writer backed by memory, flash, or a file. Implemented alongside
+// Reader or Writer.
+class Seekable {
+ public:
+  virtual ~Seekable() = default;
+
+  // Moves the position, as an offset from the start of the stream, at which the
+  // next Read() or Write() starts.
+  //
+  // Returns:
+  //
+  // OK - the position was moved.
+  // INVALID_ARGUMENT - offset is not within the stream.
+  Status Seek(size_t offset) { return DoSeek(offset); }
+
+  // Returns the current position, as an offset from the start of the stream.
+  size_t Tell() const { return DoTell(); }
+
+ private:
+  virtual Status DoSeek(size_t offset) = 0;
+  virtual size_t DoTell() const = 0;
+};
+
+// Capability interface for reading from any offset in a stream, without
+// changing the position used by Read(). Formats with offset tables can then be
+// parsed in place, without buffering the whole stream.
+class PositionalReader {
+ public:
+  virtual ~PositionalReader() = default;
+
+  // Reads up to dest.size_bytes() bytes starting at the offset.
+  //
+  // Returns:
+  //
+  // OK with size - number of bytes read, fewer than dest.size_bytes() if the
+  //     stream ends first.
+  // OUT_OF_RANGE - offset is not within the stream.
+  // [error status] - the read failed.
+  StatusWithSize ReadAt(size_t offset, ByteSpan dest) const {
+    PW_DASSERT(dest.empty() || dest.data() != nullptr);
+    return DoReadAt(offset, dest);
+  }
+
+ private:
+  virtual StatusWithSize DoReadAt(size_t offset, ByteSpan dest) const = 0;
+};
+
+// Capability interface for writing at any offset in a stream, without changing
+// the position used by Write(). This allows, for example, filling in a length
+// field after the data that follows it is written.
+class PositionalWriter {
+ public:
+  virtual ~PositionalWriter() = default;
+
+  // Writes the data starting at the offset.
+  //
+  // Returns:
+  //
+  // OK - the data was written.
+  // RESOURCE_EXHAUSTED - the data does not fit. No data written.
+  // INVALID_ARGUMENT - offset is not a valid place to write. No data written.
+  // [error status] - the write failed.
+  Status WriteAt(size_t offset, ConstByteSpan data) {
+    PW_DASSERT(data.empty() || data.data() != nullptr);
+    return DoWriteAt(offset, data);
+  }
+
+ private:
+  virtual Status DoWriteAt(size_t offset, ConstByteSpan data) = 0;
+};
+
 }  // namespace pw::stream
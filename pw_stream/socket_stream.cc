@@ -13,10 +13,141 @@
 // the License.
 
 #include "pw_stream/socket_stream.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/uio.h>
+
+#include <cerrno>
+
+#include "pw_status/try.h"
+
 namespace pw::stream {
 
 static constexpr uint32_t kMaxConcurrentUser = 1;
 
+// The number of buffers passed to each sendmsg() call. This is well below the
+// minimum IOV_MAX allowed by POSIX.
+static constexpr size_t kMaxIovecs = 16;
+
+namespace {
+
+// Writes to a closed connection return an error instead of raising SIGPIPE.
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif  // MSG_NOSIGNAL
+
+bool WouldBlock(int error) { return error == EAGAIN || error == EWOULDBLOCK; }
+
+// Waits until poll() reports one of the events on the file descriptor.
+Status WaitFor(int fd, short events, int timeout_ms) {
+  pollfd poll_fd = {.fd = fd, .events = events, .revents = 0};
+  while (true) {
+    const int result = poll(&poll_fd, 1, timeout_ms);
+    if (result > 0) {
+      return OkStatus();
+    }
+    if (result == 0) {
+      return Status::DeadlineExceeded();
+    }
+    if (errno != EINTR) {
+      return Status::Internal();
+    }
+  }
+}
+
+Status SetFileNonBlocking(int fd, bool non_blocking) {
+  const int flags = fcntl(fd, F_GETFL, 0);
+  if (flags < 0) {
+    return Status::Internal();
+  }
+  const int new_flags = non_blocking ? flags | O_NONBLOCK : flags & ~O_NONBLOCK;
+  if (fcntl(fd, F_SETFL, new_flags) < 0) {
+    return Status::Internal();
+  }
+  return OkStatus();
+}
+
+// Sends all of the buffers, continuing after partial sends. If a non-blocking
+// socket cannot accept any data before anything was sent, returns
+// RESOURCE_EXHAUSTED. Once some data is sent, waits for the socket to become
+// writable rather than leave the write incomplete. The iovecs are modified.
+Status SendAll(int fd, iovec* iovecs, size_t count, bool& sent_any) {
+  while (count > 0u) {
+    if (iovecs->iov_len == 0u) {
+      ++iovecs;
+      --count;
+      continue;
+    }
+
+    msghdr message = {};
+    message.msg_iov = iovecs;
+    message.msg_iovlen = count;
+    const ssize_t result = sendmsg(fd, &message, kSendFlags);
+
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (WouldBlock(errno)) {
+        if (!sent_any) {
+          return Status::ResourceExhausted();
+        }
+        PW_TRY(WaitFor(fd, POLLOUT, -1));
+        continue;
+      }
+      return Status::Internal();
+    }
+
+    sent_any = true;
+    size_t sent = static_cast<size_t>(result);
+    while (sent > 0u) {
+      if (sent >= iovecs->iov_len) {
+        sent -= iovecs->iov_len;
+        ++iovecs;
+        --count;
+      } else {
+        iovecs->iov_base = static_cast<std::byte*>(iovecs->iov_base) + sent;
+        iovecs->iov_len -= sent;
+        sent = 0;
+      }
+    }
+  }
+  return OkStatus();
+}
+
+// Collects buffers into iovecs and sends them when full.
+class IovecBatch {
+ public:
+  IovecBatch(int fd) : fd_(fd), count_(0), sent_any_(false) {}
+
+  Status Add(ConstByteSpan data) {
+    if (data.empty()) {
+      return OkStatus();
+    }
+    iovecs_[count_].iov_base = const_cast<std::byte*>(data.data());
+    iovecs_[count_].iov_len = data.size_bytes();
+    count_ += 1;
+    return count_ == iovecs_.size() ? Flush() : OkStatus();
+  }
+
+  Status Flush() {
+    const size_t count = count_;
+    count_ = 0;
+    return SendAll(fd_, iovecs_.data(), count, sent_any_);
+  }
+
+ private:
+  int fd_;
+  std::array<iovec, kMaxIovecs> iovecs_;
+  size_t count_;
+  bool sent_any_;
+};
+
+}  // namespace
+
 // Listen to the port and return after a client is connected
 Status SocketStream::Init(uint16_t port) {
   listen_port_ = port;
@@ -51,21 +182,151 @@ Status SocketStream::Init(uint16_t port) {
   return OkStatus();
 }
 
-Status SocketStream::DoWrite(std::span<const std::byte> data) {
-  ssize_t bytes_sent = send(conn_fd_, data.data(), data.size_bytes(), 0);
+Status SocketStream::Connect(const char* host, uint16_t port) {
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  if (inet_pton(AF_INET, host, &addr.sin_addr) != 1) {
+    return Status::InvalidArgument();
+  }
 
-  if (bytes_sent < 0 || static_cast<uint64_t>(bytes_sent) != data.size()) {
+  conn_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+  if (conn_fd_ == kInvalidFd) {
     return Status::Internal();
   }
+  if (connect(conn_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) <
+      0) {
+    Close();
+    return Status::Unavailable();
+  }
   return OkStatus();
 }
 
+void SocketStream::Close() {
+  if (conn_fd_ != kInvalidFd) {
+    close(conn_fd_);
+    conn_fd_ = kInvalidFd;
+  }
+  if (socket_fd_ != kInvalidFd) {
+    close(socket_fd_);
+    socket_fd_ = kInvalidFd;
+  }
+}
+
+Status SocketStream::SetNonBlocking(bool non_blocking) {
+  return SetFileNonBlocking(conn_fd_, non_blocking);
+}
+
+Status SocketStream::WaitUntilReadable(int timeout_ms) {
+  return WaitFor(conn_fd_, POLLIN, timeout_ms);
+}
+
+Status SocketStream::WaitUntilWritable(int timeout_ms) {
+  return WaitFor(conn_fd_, POLLOUT, timeout_ms);
+}
+
+Status SocketStream::DoWrite(std::span<const std::byte> data) {
+  iovec buffer = {.iov_base = const_cast<std::byte*>(data.data()),
+                  .iov_len = data.size_bytes()};
+  bool sent_any = false;
+  return SendAll(conn_fd_, &buffer, 1, sent_any);
+}
+
+Status SocketStream::DoWriteVectored(std::span<const ConstByteSpan> data) {
+  IovecBatch batch(conn_fd_);
+  for (ConstByteSpan span : data) {
+    PW_TRY(batch.Add(span));
+  }
+  return batch.Flush();
+}
+
+Status SocketStream::DoWriteChain(const ByteChain& chain) {
+  IovecBatch batch(conn_fd_);
+  for (const ByteChain::Chunk& chunk : chain) {
+    PW_TRY(batch.Add(chunk.data()));
+  }
+  return batch.Flush();
+}
+
 StatusWithSize SocketStream::DoRead(ByteSpan dest) {
-  ssize_t bytes_rcvd = recv(conn_fd_, dest.data(), dest.size_bytes(), 0);
-  if (bytes_rcvd < 0) {
-    return StatusWithSize::Internal();
+  while (true) {
+    ssize_t bytes_rcvd = recv(conn_fd_, dest.data(), dest.size_bytes(), 0);
+    if (bytes_rcvd < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (WouldBlock(errno)) {
+        return StatusWithSize::ResourceExhausted();
+      }
+      return StatusWithSize::Internal();
+    }
+    if (bytes_rcvd == 0 && !dest.empty()) {
+      return StatusWithSize::OutOfRange();  // The peer closed the connection.
+    }
+    return StatusWithSize(bytes_rcvd);
+  }
+}
+
+Status ServerSocket::Listen(uint16_t port, int backlog) {
+  fd_ = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd_ == kInvalidFd) {
+    return Status::Internal();
+  }
+
+  const int reuse = 1;
+  setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = INADDR_ANY;
+
+  if (bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+      listen(fd_, backlog) < 0) {
+    Close();
+    return Status::Internal();
+  }
+
+  socklen_t len = sizeof(addr);
+  if (getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &len) < 0) {
+    Close();
+    return Status::Internal();
+  }
+  port_ = ntohs(addr.sin_port);
+  return OkStatus();
+}
+
+Status ServerSocket::Accept(SocketStream& connection) {
+  if (connection.conn_fd_ != kInvalidFd) {
+    return Status::FailedPrecondition();
+  }
+
+  while (true) {
+    socklen_t len = sizeof(connection.sockaddr_client_);
+    const int fd = accept(
+        fd_, reinterpret_cast<sockaddr*>(&connection.sockaddr_client_), &len);
+    if (fd >= 0) {
+      connection.conn_fd_ = fd;
+      // Accepted sockets may inherit O_NONBLOCK from the listening socket.
+      return SetFileNonBlocking(fd, false);
+    }
+    if (errno == EINTR) {
+      continue;
+    }
+    return WouldBlock(errno) ? Status::ResourceExhausted()
+                             : Status::Internal();
+  }
+}
+
+Status ServerSocket::SetNonBlocking(bool non_blocking) {
+  return SetFileNonBlocking(fd_, non_blocking);
+}
+
+void ServerSocket::Close() {
+  if (fd_ != kInvalidFd) {
+    close(fd_);
+    fd_ = kInvalidFd;
   }
-  return StatusWithSize(bytes_rcvd);
 }
 
 };  // namespace pw::stream
@@ -0,0 +1,132 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/socket_stream.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+namespace pw::stream {
+namespace {
+
+class SocketStreamTest : public ::testing::Test {
+ protected:
+  void SetUp() override { ASSERT_EQ(OkStatus(), server_.Listen(0)); }
+
+  // Connects the client to the server and accepts the connection.
+  void Connect(SocketStream& client, SocketStream& connection) {
+    ASSERT_EQ(OkStatus(), client.Connect("127.0.0.1", server_.port()));
+    ASSERT_EQ(OkStatus(), server_.Accept(connection));
+  }
+
+  ServerSocket server_;
+};
+
+TEST_F(SocketStreamTest, Listen_PortZeroSelectsPort) {
+  EXPECT_NE(0u, server_.port());
+  EXPECT_NE(kInvalidFd, server_.fd());
+}
+
+TEST_F(SocketStreamTest, Connect_InvalidAddress) {
+  SocketStream client;
+  EXPECT_EQ(Status::InvalidArgument(), client.Connect("localhost", 1));
+}
+
+TEST_F(SocketStreamTest, Accept_SeveralConnections) {
+  std::array<SocketStream, 3> clients;
+  std::array<SocketStream, 3> connections;
+  for (size_t i = 0; i < clients.size(); ++i) {
+    Connect(clients[i], connections[i]);
+  }
+
+  for (size_t i = 0; i < clients.size(); ++i) {
+    const std::byte value = std::byte(i);
+    ASSERT_EQ(OkStatus(), clients[i].Write(std::span(&value, 1)));
+  }
+
+  for (size_t i = 0; i < connections.size(); ++i) {
+    std::byte value{0xff};
+    Result<ByteSpan> result = connections[i].Read(std::span(&value, 1));
+    ASSERT_EQ(OkStatus(), result.status());
+    ASSERT_EQ(1u, result.value().size());
+    EXPECT_EQ(std::byte(i), value);
+  }
+}
+
+TEST_F(SocketStreamTest, Accept_NonBlockingWithoutClient) {
+  ASSERT_EQ(OkStatus(), server_.SetNonBlocking(true));
+  SocketStream connection;
+  EXPECT_EQ(Status::ResourceExhausted(), server_.Accept(connection));
+  EXPECT_EQ(kInvalidFd, connection.connection_fd());
+}
+
+TEST_F(SocketStreamTest, Read_NonBlockingWithoutData) {
+  SocketStream client, connection;
+  Connect(client, connection);
+  ASSERT_EQ(OkStatus(), connection.SetNonBlocking(true));
+
+  std::array<std::byte, 4> buffer;
+  EXPECT_EQ(Status::ResourceExhausted(), connection.Read(buffer).status());
+  EXPECT_EQ(Status::DeadlineExceeded(), connection.WaitUntilReadable(0));
+
+  const std::byte value{0x5a};
+  ASSERT_EQ(OkStatus(), client.Write(std::span(&value, 1)));
+  ASSERT_EQ(OkStatus(), connection.WaitUntilReadable(1000));
+
+  Result<ByteSpan> result = connection.Read(buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(1u, result.value().size());
+  EXPECT_EQ(value, buffer[0]);
+}
+
+TEST_F(SocketStreamTest, Read_AfterPeerCloses) {
+  SocketStream client, connection;
+  Connect(client, connection);
+  client.Close();
+
+  std::array<std::byte, 4> buffer;
+  EXPECT_EQ(Status::OutOfRange(), connection.Read(buffer).status());
+}
+
+TEST_F(SocketStreamTest, WriteVectored_ArrivesInOrder) {
+  SocketStream client, connection;
+  Connect(client, connection);
+  EXPECT_EQ(OkStatus(), client.WaitUntilWritable(1000));
+
+  // More buffers than are sent in one sendmsg() call, including empty ones.
+  std::array<std::byte, 20> data;
+  std::array<ConstByteSpan, 40> buffers;
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = std::byte(i);
+    buffers[2 * i] = std::span(&data[i], 1);
+    buffers[2 * i + 1] = ConstByteSpan();
+  }
+  ASSERT_EQ(OkStatus(), client.Write(buffers));
+
+  std::array<std::byte, 20> received;
+  size_t total = 0;
+  while (total < received.size()) {
+    Result<ByteSpan> result =
+        connection.Read(std::span(received).subspan(total));
+    ASSERT_EQ(OkStatus(), result.status());
+    total += result.value().size();
+  }
+  EXPECT_EQ(0, std::memcmp(data.data(), received.data(), data.size()));
+}
+
+}  // namespace
+}  // namespace pw::stream
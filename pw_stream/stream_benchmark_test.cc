@@ -0,0 +1,252 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Benchmarks the cost of layering stream::Writers. Every case writes to a
+// CountingNullWriter, so only the layers above the sink are measured. Each case
+// is a pw_unit_test benchmark that reports its throughput, and checks how many
+// writes reached the sink.
+//
+// The cases cover the overhead of a virtual DoWrite() call compared with a
+// direct call, separate writes compared with a gather write, and a protobuf
+// record framed with HDLC, written directly and through a BufferedWriter.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+
+#include "gtest/gtest.h"
+#include "pw_hdlc/encoder.h"
+#include "pw_preprocessor/compiler.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_stream/buffered_stream.h"
+#include "pw_stream/null_stream.h"
+#include "pw_unit_test/benchmark.h"
+
+namespace pw::stream {
+namespace {
+
+using unit_test::BenchmarkOptions;
+using unit_test::BenchmarkState;
+
+constexpr size_t kWriteSizes[] = {1, 16, 256};
+constexpr size_t kPayloadSizes[] = {16, 256};
+
+constexpr size_t kMaxSize = 256;
+constexpr uint8_t kAddress = 'R';
+
+BenchmarkOptions BytesPerIteration(size_t bytes) {
+  return {.bytes_per_iteration = static_cast<uint32_t>(bytes)};
+}
+
+// Stands in for a sink that is called directly rather than through Writer.
+PW_NO_INLINE Status DirectWrite(CountingNullWriter& sink, ConstByteSpan data) {
+  return sink.Write(data);
+}
+
+// The benchmark loops are not inlined, so the compiler cannot see the type of
+// the writer and devirtualize DoWrite(). The loops count failures rather than
+// checking each write with EXPECT_EQ, which would cost more than the writes
+// being measured.
+PW_NO_INLINE void WriteChunks(BenchmarkState& state,
+                              Writer& writer,
+                              ConstByteSpan data) {
+  size_t failures = 0;
+  for (auto _ : state) {
+    failures += writer.Write(data).ok() ? 0 : 1;
+  }
+  EXPECT_EQ(0u, failures);
+}
+
+PW_NO_INLINE void WriteChunksDirect(BenchmarkState& state,
+                                    CountingNullWriter& sink,
+                                    ConstByteSpan data) {
+  size_t failures = 0;
+  for (auto _ : state) {
+    failures += DirectWrite(sink, data).ok() ? 0 : 1;
+  }
+  EXPECT_EQ(0u, failures);
+}
+
+TEST(StreamBenchmark, WriteDispatch) {
+  const std::array<std::byte, kMaxSize> data = {};
+  CountingNullWriter sink;
+  std::array<std::byte, kMaxSize> buffer;
+  BufferedWriter buffered(sink, buffer);
+  char name[64];
+
+  for (size_t size : kWriteSizes) {
+    const ConstByteSpan chunk = std::span(data).first(size);
+
+    std::snprintf(name, sizeof(name), "%zu-byte writes, direct call", size);
+    unit_test::RunBenchmark(
+        name, BytesPerIteration(size), [&](BenchmarkState& state) {
+          sink.clear();
+          WriteChunksDirect(state, sink, chunk);
+          EXPECT_EQ(sink.write_count(), state.iterations());
+        });
+
+    std::snprintf(name, sizeof(name), "%zu-byte writes, Writer::Write", size);
+    unit_test::RunBenchmark(
+        name, BytesPerIteration(size), [&](BenchmarkState& state) {
+          sink.clear();
+          WriteChunks(state, sink, chunk);
+          EXPECT_EQ(sink.write_count(), state.iterations());
+        });
+
+    // Writes smaller than the buffer are combined before reaching the sink.
+    std::snprintf(name, sizeof(name), "%zu-byte writes, BufferedWriter", size);
+    unit_test::RunBenchmark(
+        name, BytesPerIteration(size), [&](BenchmarkState& state) {
+          sink.clear();
+          WriteChunks(state, buffered, chunk);
+          EXPECT_EQ(OkStatus(), buffered.Flush());
+          EXPECT_EQ(sink.bytes_written(), state.iterations() * size);
+          EXPECT_LE(sink.write_count(),
+                    state.iterations() * size / buffer.size() + 1);
+        });
+  }
+}
+
+PW_NO_INLINE void WriteSeparately(BenchmarkState& state,
+                                  Writer& writer,
+                                  std::span<const ConstByteSpan> spans) {
+  size_t failures = 0;
+  for (auto _ : state) {
+    for (ConstByteSpan span : spans) {
+      failures += writer.Write(span).ok() ? 0 : 1;
+    }
+  }
+  EXPECT_EQ(0u, failures);
+}
+
+PW_NO_INLINE void WriteGathered(BenchmarkState& state,
+                                Writer& writer,
+                                std::span<const ConstByteSpan> spans) {
+  size_t failures = 0;
+  for (auto _ : state) {
+    failures += writer.Write(spans).ok() ? 0 : 1;
+  }
+  EXPECT_EQ(0u, failures);
+}
+
+TEST(StreamBenchmark, GatherWrite) {
+  const std::array<std::byte, kMaxSize> data = {};
+  const ConstByteSpan spans[] = {std::span(data).first(4),
+                                 std::span(data).first(kMaxSize),
+                                 std::span(data).first(4)};
+  const BenchmarkOptions options = BytesPerIteration(kMaxSize + 8);
+  CountingNullWriter sink;
+
+  // CountingNullWriter does not override DoWriteVectored(), so both cases make
+  // a sink write per span; they differ in the calls through Writer.
+  unit_test::RunBenchmark(
+      "header, payload, trailer: separate writes",
+      options,
+      [&](BenchmarkState& state) {
+        sink.clear();
+        WriteSeparately(state, sink, spans);
+        EXPECT_EQ(sink.write_count(), state.iterations() * std::size(spans));
+      });
+
+  unit_test::RunBenchmark(
+      "header, payload, trailer: gather write",
+      options,
+      [&](BenchmarkState& state) {
+        sink.clear();
+        WriteGathered(state, sink, spans);
+        EXPECT_EQ(sink.write_count(), state.iterations() * std::size(spans));
+      });
+}
+
+// Encodes a record with two integers and a payload, as a service might log.
+Result<ConstByteSpan> EncodeRecord(uint32_t sequence,
+                                   ConstByteSpan payload,
+                                   ByteSpan buffer) {
+  protobuf::NestedEncoder<> encoder(buffer);
+  encoder.WriteUint32(1, sequence);
+  encoder.WriteUint32(2, 0x12345678);
+  encoder.WriteBytes(3, payload);
+  return encoder.Encode();
+}
+
+enum class Layers { kProtobuf, kHdlc, kHdlcBuffered };
+
+PW_NO_INLINE void WriteRecords(BenchmarkState& state,
+                               Writer& writer,
+                               ConstByteSpan payload,
+                               Layers layers) {
+  std::array<std::byte, kMaxSize + 32> record_buffer;
+  size_t failures = 0;
+  uint32_t sequence = 0;
+
+  for (auto _ : state) {
+    Result<ConstByteSpan> record =
+        EncodeRecord(sequence++, payload, record_buffer);
+    if (!record.ok()) {
+      failures += 1;
+      continue;
+    }
+    if (layers != Layers::kProtobuf) {
+      failures +=
+          hdlc::WriteUIFrame(kAddress, record.value(), writer).ok() ? 0 : 1;
+    }
+  }
+  EXPECT_EQ(0u, failures);
+}
+
+TEST(StreamBenchmark, ProtobufHdlcChain) {
+  std::array<std::byte, kMaxSize> payload_buffer;
+  for (size_t i = 0; i < payload_buffer.size(); ++i) {
+    payload_buffer[i] = std::byte(i);  // Includes bytes that are escaped.
+  }
+  CountingNullWriter sink;
+  std::array<std::byte, 512> buffer;
+  BufferedWriter buffered(sink, buffer);
+  char name[64];
+
+  for (size_t size : kPayloadSizes) {
+    const ConstByteSpan payload = std::span(payload_buffer).first(size);
+    const BenchmarkOptions options = BytesPerIteration(size);
+
+    std::snprintf(name, sizeof(name), "%zu-byte payload, protobuf", size);
+    unit_test::RunBenchmark(name, options, [&](BenchmarkState& state) {
+      sink.clear();
+      WriteRecords(state, sink, payload, Layers::kProtobuf);
+      EXPECT_EQ(sink.write_count(), 0u);
+    });
+
+    // The HDLC encoder stages the pieces of a frame, so each frame reaches the
+    // sink in one or more writes. The BufferedWriter also combines frames.
+    std::snprintf(name, sizeof(name), "%zu-byte payload, protobuf+HDLC", size);
+    unit_test::RunBenchmark(name, options, [&](BenchmarkState& state) {
+      sink.clear();
+      WriteRecords(state, sink, payload, Layers::kHdlc);
+      EXPECT_GE(sink.write_count(), state.iterations());
+    });
+
+    std::snprintf(
+        name, sizeof(name), "%zu-byte payload, protobuf+HDLC+buffered", size);
+    unit_test::RunBenchmark(name, options, [&](BenchmarkState& state) {
+      sink.clear();
+      WriteRecords(state, buffered, payload, Layers::kHdlcBuffered);
+      EXPECT_EQ(OkStatus(), buffered.Flush());
+      EXPECT_LE(sink.write_count(), state.iterations());
+    });
+  }
+}
+
+}  // namespace
+}  // namespace pw::stream
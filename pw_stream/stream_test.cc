@@ -14,6 +14,7 @@
 
 #include "pw_stream/stream.h"
 
+#include <array>
 #include <limits>
 
 #include "gtest/gtest.h"
@@ -33,5 +34,61 @@ TEST(Stream, DefaultConservativeReadLimit) {
   EXPECT_EQ(stream.ConservativeReadLimit(), std::numeric_limits<size_t>::max());
 }
 
+TEST(Stream, CountingNullWriter_CountsBytesAndCalls) {
+  CountingNullWriter stream;
+  std::array<std::byte, 5> data = {};
+  ASSERT_EQ(OkStatus(), stream.Write(data));
+  ASSERT_EQ(OkStatus(), stream.Write(std::span(data).first(2)));
+  EXPECT_EQ(7u, stream.bytes_written());
+  EXPECT_EQ(2u, stream.write_count());
+
+  stream.clear();
+  EXPECT_EQ(0u, stream.bytes_written());
+  EXPECT_EQ(0u, stream.write_count());
+}
+
+// Records the size of each DoWrite() call.
+class RecordingWriter : public Writer {
+ public:
+  RecordingWriter(size_t limit = std::numeric_limits<size_t>::max())
+      : limit_(limit) {}
+
+  size_t ConservativeWriteLimit() const override { return limit_; }
+
+  std::array<size_t, 4> write_sizes = {};
+  size_t write_count = 0;
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    write_sizes[write_count++] = data.size();
+    return OkStatus();
+  }
+
+  size_t limit_;
+};
+
+TEST(Stream, WriteVectored_DefaultWritesEachNonEmptySpan) {
+  std::byte header[2] = {};
+  std::byte payload[5] = {};
+  std::byte trailer[1] = {};
+  const ConstByteSpan spans[] = {header, ConstByteSpan(), payload, trailer};
+
+  RecordingWriter writer;
+  ASSERT_EQ(OkStatus(), writer.Write(spans));
+  ASSERT_EQ(3u, writer.write_count);
+  EXPECT_EQ(2u, writer.write_sizes[0]);
+  EXPECT_EQ(5u, writer.write_sizes[1]);
+  EXPECT_EQ(1u, writer.write_sizes[2]);
+}
+
+TEST(Stream, WriteVectored_DefaultChecksLimit) {
+  std::byte payload[5] = {};
+  const ConstByteSpan spans[] = {payload, payload};
+
+  RecordingWriter writer(9);
+  EXPECT_EQ(Status::ResourceExhausted(), writer.Write(spans));
+  EXPECT_EQ(0u, writer.write_count);
+}
+
 }  // namespace
 }  // namespace pw::stream
@@ -14,9 +14,289 @@
 
 #include "pw_string/format.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "pw_string/internal/format.h"
+#include "pw_string/type_to_string.h"
+#include "pw_string/util.h"
 
 namespace pw::string {
+namespace internal {
+namespace {
+
+// Writes the digits of the value in the conversion's base. Returns the number
+// of digits.
+size_t WriteDigits(char type, uint64_t value, std::span<char, 24> digits) {
+  if (type == 'x' || type == 'X') {
+    const size_t count = IntToHexString(value, digits).size();
+    if (type == 'X') {
+      for (size_t i = 0; i < count; ++i) {
+        if (digits[i] >= 'a') {
+          digits[i] -= 'a' - 'A';
+        }
+      }
+    }
+    return count;
+  }
+
+  if (type == 'o') {
+    size_t count = 0;
+    for (uint64_t remaining = value; remaining != 0u; remaining >>= 3) {
+      count += 1;
+    }
+    count = count == 0u ? 1 : count;
+    for (size_t i = count; i > 0u; --i) {
+      digits[i - 1] = static_cast<char>('0' + (value & 7u));
+      value >>= 3;
+    }
+    return count;
+  }
+
+  return IntToString(value, digits).size();
+}
+
+// Reads an integer argument, returning its magnitude and sign.
+uint64_t ReadInteger(const Conversion& conversion,
+                     va_list& args,
+                     bool& negative) {
+  negative = false;
+  if (conversion.is_signed_integer()) {
+    int64_t value;
+    switch (conversion.length) {
+      case LengthModifier::kChar:
+        value = static_cast<signed char>(va_arg(args, int));
+        break;
+      case LengthModifier::kShort:
+        value = static_cast<short>(va_arg(args, int));
+        break;
+      case LengthModifier::kLong:
+        value = va_arg(args, long);
+        break;
+      case LengthModifier::kLongLong:
+        value = va_arg(args, long long);
+        break;
+      case LengthModifier::kMax:
+        value = va_arg(args, intmax_t);
+        break;
+      case LengthModifier::kSize:
+        value = va_arg(args, std::make_signed_t<size_t>);
+        break;
+      case LengthModifier::kPtrDiff:
+        value = va_arg(args, ptrdiff_t);
+        break;
+      case LengthModifier::kNone:
+      case LengthModifier::kLongDouble:
+      default:
+        value = va_arg(args, int);
+        break;
+    }
+    negative = value < 0;
+    // Negate as unsigned so that the minimum value does not overflow.
+    return negative ? 0u - static_cast<uint64_t>(value)
+                    : static_cast<uint64_t>(value);
+  }
+
+  switch (conversion.length) {
+    case LengthModifier::kChar:
+      return static_cast<unsigned char>(va_arg(args, unsigned));
+    case LengthModifier::kShort:
+      return static_cast<unsigned short>(va_arg(args, unsigned));
+    case LengthModifier::kLong:
+      return va_arg(args, unsigned long);
+    case LengthModifier::kLongLong:
+      return va_arg(args, unsigned long long);
+    case LengthModifier::kMax:
+      return va_arg(args, uintmax_t);
+    case LengthModifier::kSize:
+      return va_arg(args, size_t);
+    case LengthModifier::kPtrDiff:
+      return static_cast<std::make_unsigned_t<ptrdiff_t>>(
+          va_arg(args, ptrdiff_t));
+    case LengthModifier::kNone:
+    case LengthModifier::kLongDouble:
+    default:
+      return va_arg(args, unsigned);
+  }
+}
+
+}  // namespace
+
+void FormatOutput::Write(const char* data, size_t length) {
+  const size_t available = buffer_.size() - 1 - size_;
+  if (length > available) {
+    length = available;
+    truncated_ = true;
+  }
+  std::memcpy(&buffer_[size_], data, length);
+  size_ += length;
+}
+
+void FormatOutput::Fill(char ch, size_t count) {
+  const size_t available = buffer_.size() - 1 - size_;
+  if (count > available) {
+    count = available;
+    truncated_ = true;
+  }
+  std::memset(&buffer_[size_], ch, count);
+  size_ += count;
+}
+
+bool FormatOutput::WriteVsnprintf(const char* format, va_list args) {
+  const std::span<char> remaining = buffer_.subspan(size_);
+  const int result =
+      std::vsnprintf(remaining.data(), remaining.size(), format, args);
+
+  // If an error occurred, the number of characters written is unknown.
+  // Discard any output by terminating the buffer.
+  if (result < 0) {
+    buffer_[0] = '\0';
+    size_ = 0;
+    return false;
+  }
+
+  // If result >= remaining.size(), the output was truncated.
+  if (static_cast<size_t>(result) >= remaining.size()) {
+    size_ += remaining.size() - 1;
+    truncated_ = true;
+  } else {
+    size_ += result;
+  }
+  return true;
+}
+
+bool FormatOutput::WriteSnprintf(const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  const bool result = WriteVsnprintf(format, args);
+  va_end(args);
+  return result;
+}
+
+StatusWithSize FormatOutput::Finish() {
+  buffer_[size_] = '\0';
+  return StatusWithSize(truncated_ ? Status::ResourceExhausted() : OkStatus(),
+                        size_);
+}
+
+void FormatInteger(const Conversion& conversion,
+                   bool negative,
+                   uint64_t magnitude,
+                   FormatOutput& output) {
+  // Octal needs up to 22 digits for 64-bit values.
+  char digit_buffer[24];
+  size_t digit_count = WriteDigits(conversion.type, magnitude, digit_buffer);
+
+  // A precision of 0 prints no digits for 0.
+  if (conversion.precision == 0 && magnitude == 0u) {
+    digit_count = 0;
+  }
+
+  const size_t precision =
+      conversion.precision < 0 ? 0 : static_cast<size_t>(conversion.precision);
+  size_t zeroes = precision > digit_count ? precision - digit_count : 0;
+
+  char prefix[2];
+  size_t prefix_size = 0;
+  if (conversion.is_signed_integer()) {
+    if (negative) {
+      prefix[prefix_size++] = '-';
+    } else if (conversion.plus) {
+      prefix[prefix_size++] = '+';
+    } else if (conversion.space) {
+      prefix[prefix_size++] = ' ';
+    }
+  } else if (conversion.alternate) {
+    if (conversion.type == 'o') {
+      // The alternate form of octal always starts with a 0.
+      if (zeroes == 0u && (digit_count == 0u || digit_buffer[0] != '0')) {
+        zeroes = 1;
+      }
+    } else if (conversion.type != 'u' && magnitude != 0u) {
+      prefix[prefix_size++] = '0';
+      prefix[prefix_size++] = conversion.type;
+    }
+  }
+
+  const size_t width = static_cast<size_t>(conversion.width);
+  const size_t size = prefix_size + zeroes + digit_count;
+  const size_t padding = width > size ? width - size : 0;
+
+  // The 0 flag is ignored if a precision is given or the output is left
+  // aligned.
+  if (conversion.zero_pad && !conversion.left_align &&
+      conversion.precision < 0) {
+    output.Write(prefix, prefix_size);
+    output.Fill('0', padding + zeroes);
+  } else {
+    if (!conversion.left_align) {
+      output.Fill(' ', padding);
+    }
+    output.Write(prefix, prefix_size);
+    output.Fill('0', zeroes);
+  }
+
+  output.Write(digit_buffer, digit_count);
+
+  if (conversion.left_align) {
+    output.Fill(' ', padding);
+  }
+}
+
+void FormatIntegerBits(const Conversion& conversion,
+                       uint64_t bits,
+                       FormatOutput& output) {
+  const size_t bit_count = IntegerArgumentSize(conversion.length) * 8;
+  const uint64_t mask =
+      bit_count < 64u ? (uint64_t(1) << bit_count) - 1 : ~uint64_t(0);
+  bits &= mask;
+
+  const bool negative =
+      conversion.is_signed_integer() && ((bits >> (bit_count - 1)) & 1u) != 0;
+  FormatInteger(conversion, negative, negative ? (~bits + 1) & mask : bits,
+                output);
+}
+
+void FormatText(const Conversion& conversion,
+                const char* text,
+                size_t length,
+                FormatOutput& output) {
+  const size_t width = static_cast<size_t>(conversion.width);
+  const size_t padding = width > length ? width - length : 0;
+
+  if (!conversion.left_align) {
+    output.Fill(' ', padding);
+  }
+  output.Write(text, length);
+  if (conversion.left_align) {
+    output.Fill(' ', padding);
+  }
+}
+
+void FormatString(const Conversion& conversion,
+                  const char* text,
+                  FormatOutput& output) {
+  const size_t max_length = conversion.precision < 0
+                                ? std::numeric_limits<size_t>::max()
+                                : static_cast<size_t>(conversion.precision);
+  if (text == nullptr) {
+    // Match glibc, which prints "(null)" only if the precision allows it.
+    FormatText(conversion,
+               kNullPointerString.data(),
+               max_length < kNullPointerString.size()
+                   ? 0
+                   : kNullPointerString.size(),
+               output);
+  } else {
+    FormatText(conversion, text, Length(text, max_length), output);
+  }
+}
+
+}  // namespace internal
 
 StatusWithSize Format(std::span<char> buffer, const char* format, ...) {
   va_list args;
@@ -34,21 +314,70 @@ StatusWithSize FormatVaList(std::span<char> buffer,
     return StatusWithSize::ResourceExhausted();
   }
 
-  const int result = std::vsnprintf(buffer.data(), buffer.size(), format, args);
+  // Work on a copy of the va_list, since va_list may be an array type that
+  // cannot be passed by reference once it has decayed to a pointer.
+  va_list args_copy;
+  va_copy(args_copy, args);
 
-  // If an error occurred, the number of characters written is unknown.
-  // Discard any output by terminating the buffer.
-  if (result < 0) {
-    buffer[0] = '\0';
-    return StatusWithSize::InvalidArgument();
-  }
+  internal::FormatOutput output(buffer);
+  bool formatted = true;
+
+  while (true) {
+    // Copy the text up to the next conversion.
+    const char* const percent = std::strchr(format, '%');
+    if (percent == nullptr) {
+      output.Write(format, std::strlen(format));
+      break;
+    }
+    output.Write(format, percent - format);
+
+    if (percent[1] == '%') {
+      output.Write("%", 1);
+      format = percent + 2;
+      continue;
+    }
+
+    // Conversions which are not formatted directly, and invalid conversions,
+    // are left to std::vsnprintf along with the rest of the string.
+    const char* spec_end = percent + 1;
+    internal::Conversion conversion;
+    if (!internal::ParseConversion(spec_end, conversion) ||
+        !conversion.formatted_directly()) {
+      formatted = output.WriteVsnprintf(percent, args_copy);
+      break;
+    }
+
+    if (conversion.width_from_arg) {
+      conversion.width = va_arg(args_copy, int);
+      if (conversion.width < 0) {
+        conversion.left_align = true;
+        conversion.width = -conversion.width;
+      }
+    }
+    if (conversion.precision_from_arg) {
+      conversion.precision = va_arg(args_copy, int);
+      if (conversion.precision < 0) {
+        conversion.precision = -1;
+      }
+    }
 
-  // If result >= buffer.size(), the output was truncated and null-terminated.
-  if (static_cast<unsigned>(result) >= buffer.size()) {
-    return StatusWithSize::ResourceExhausted(buffer.size() - 1);
+    if (conversion.type == 'c') {
+      const char ch = static_cast<char>(va_arg(args_copy, int));
+      internal::FormatText(conversion, &ch, 1, output);
+    } else if (conversion.type == 's') {
+      internal::FormatString(
+          conversion, va_arg(args_copy, const char*), output);
+    } else {
+      bool negative;
+      const uint64_t magnitude =
+          internal::ReadInteger(conversion, args_copy, negative);
+      internal::FormatInteger(conversion, negative, magnitude, output);
+    }
+    format = spec_end;
   }
 
-  return StatusWithSize(result);
+  va_end(args_copy);
+  return formatted ? output.Finish() : StatusWithSize::InvalidArgument();
 }
 
 }  // namespace pw::string
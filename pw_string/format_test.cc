@@ -14,8 +14,14 @@
 
 #include "pw_string/format.h"
 
+#include <cinttypes>
 #include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
 #include <span>
+#include <string_view>
 
 #include "gtest/gtest.h"
 
@@ -65,6 +71,200 @@ TEST(Format, ArgumentLargerThanBuffer_ReturnsResourceExhausted) {
   EXPECT_STREQ("2big", buffer);
 }
 
+// Formats with both Format and std::snprintf and checks that they match.
+#define EXPECT_MATCHES_SNPRINTF(...)                                       \
+  do {                                                                     \
+    char expected[64];                                                     \
+    char actual[64];                                                       \
+    const int expected_size =                                              \
+        std::snprintf(expected, sizeof(expected), __VA_ARGS__);            \
+    const StatusWithSize result = Format(actual, __VA_ARGS__);             \
+    EXPECT_EQ(OkStatus(), result.status());                                \
+    EXPECT_EQ(static_cast<size_t>(expected_size), result.size());          \
+    EXPECT_STREQ(expected, actual);                                        \
+  } while (0)
+
+TEST(Format, Integers_MatchSnprintf) {
+  EXPECT_MATCHES_SNPRINTF("%d %i %u", 0, -1, 1u);
+  EXPECT_MATCHES_SNPRINTF("%d|%d", std::numeric_limits<int>::min(),
+                          std::numeric_limits<int>::max());
+  EXPECT_MATCHES_SNPRINTF("%lld|%llu",
+                          std::numeric_limits<long long>::min(),
+                          std::numeric_limits<unsigned long long>::max());
+  EXPECT_MATCHES_SNPRINTF("%hhd %hhu %hd %hu", 300, 300, 70000, 70000);
+  EXPECT_MATCHES_SNPRINTF("%ld %lu %jd %zu %td", -5l, 5ul, intmax_t{-6},
+                          size_t{7}, ptrdiff_t{-8});
+  EXPECT_MATCHES_SNPRINTF("%" PRId64 " %" PRIu32 " %" PRIx16, int64_t{-9},
+                          uint32_t{10}, uint16_t{0xabc});
+}
+
+TEST(Format, IntegerFlagsWidthAndPrecision_MatchSnprintf) {
+  EXPECT_MATCHES_SNPRINTF("[%5d][%-5d][%05d][%+d][% d]", 42, 42, -42, 42, 42);
+  EXPECT_MATCHES_SNPRINTF("[%.3d][%8.3d][%-8.3d]", 7, -7, 7);
+  EXPECT_MATCHES_SNPRINTF("[%.0d][%5.0d][%.0x][%#.0o]", 0, 0, 0u, 0u);
+  EXPECT_MATCHES_SNPRINTF("[%+05d][% 05d][%-+5d]", 3, 3, 3);
+  EXPECT_MATCHES_SNPRINTF("[%*d][%-*d][%*d]", 4, 1, 4, 2, -4, 3);
+  EXPECT_MATCHES_SNPRINTF("[%.*d][%.*d]", 3, 5, -1, 6);
+}
+
+TEST(Format, HexAndOctal_MatchSnprintf) {
+  EXPECT_MATCHES_SNPRINTF("%x %X %o", 0xdeadbeefu, 0xdeadbeefu, 0755u);
+  EXPECT_MATCHES_SNPRINTF("%#x %#X %#o %#x %#o", 255u, 255u, 8u, 0u, 0u);
+  EXPECT_MATCHES_SNPRINTF("[%08x][%#010x][%-#8X][%#.4o]", 0xabu, 0xabu, 0xabu,
+                          8u);
+  EXPECT_MATCHES_SNPRINTF("%llx %llo",
+                          std::numeric_limits<unsigned long long>::max(),
+                          std::numeric_limits<unsigned long long>::max());
+}
+
+TEST(Format, CharsAndStrings_MatchSnprintf) {
+  EXPECT_MATCHES_SNPRINTF("[%c][%3c][%-3c]", 'a', 'b', 'c');
+  EXPECT_MATCHES_SNPRINTF("[%s][%6s][%-6s][%.2s][%6.2s]", "abc", "abc", "abc",
+                          "abc", "abc");
+  EXPECT_MATCHES_SNPRINTF("[%*s][%.*s]", -5, "ab", 1, "ab");
+  EXPECT_MATCHES_SNPRINTF("100%% %s%%", "done");
+}
+
+TEST(Format, UnsupportedConversions_UseVsnprintf) {
+  EXPECT_MATCHES_SNPRINTF("%d %.2f %s", 1, 2.5, "three");
+  EXPECT_MATCHES_SNPRINTF("%s %e %x", "e", 1e10, 0x10u);
+  EXPECT_MATCHES_SNPRINTF("%5d|%g|%*d", 4, 0.25, 3, 9);
+  int value = 0;
+  EXPECT_MATCHES_SNPRINTF("%p", static_cast<void*>(&value));
+}
+
+TEST(Format, NullString) {
+  char buffer[16];
+  const char* null_string = nullptr;
+  EXPECT_EQ(OkStatus(), Format(buffer, "[%s]", null_string).status());
+  EXPECT_STREQ("[(null)]", buffer);
+}
+
+TEST(Format, TruncatedConversion_ReturnsResourceExhausted) {
+  char buffer[6];
+  auto result = Format(buffer, "%d%s", 1234, "abc");
+
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(5u, result.size());
+  EXPECT_STREQ("1234a", buffer);
+
+  result = Format(buffer, "%08x", 0x1234u);
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_STREQ("00001", buffer);
+
+  result = Format(buffer, "%d %.1f", 12, 3.25);
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(5u, result.size());
+  EXPECT_STREQ("12 3.", buffer);
+}
+
+// Formats with both PW_STRING_FORMAT and std::snprintf and checks that they
+// match.
+#define EXPECT_COMPILED_MATCHES_SNPRINTF(...)                              \
+  do {                                                                     \
+    char expected[64];                                                     \
+    char actual[64];                                                       \
+    const int expected_size =                                              \
+        std::snprintf(expected, sizeof(expected), __VA_ARGS__);            \
+    const StatusWithSize result = PW_STRING_FORMAT(actual, __VA_ARGS__);   \
+    EXPECT_EQ(OkStatus(), result.status());                                \
+    EXPECT_EQ(static_cast<size_t>(expected_size), result.size());          \
+    EXPECT_STREQ(expected, actual);                                        \
+  } while (0)
+
+TEST(CompiledFormat, TextOnly) {
+  char buffer[16];
+  auto result = PW_STRING_FORMAT(buffer, "100%% done");
+
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(9u, result.size());
+  EXPECT_STREQ("100% done", buffer);
+}
+
+TEST(CompiledFormat, Integers_MatchSnprintf) {
+  EXPECT_COMPILED_MATCHES_SNPRINTF("%d %i %u", 0, -1, 1u);
+  EXPECT_COMPILED_MATCHES_SNPRINTF("%d|%d", std::numeric_limits<int>::min(),
+                                   std::numeric_limits<int>::max());
+  EXPECT_COMPILED_MATCHES_SNPRINTF(
+      "%lld|%llu", std::numeric_limits<long long>::min(),
+      std::numeric_limits<unsigned long long>::max());
+  EXPECT_COMPILED_MATCHES_SNPRINTF("%hhd %hhu %hd %hu", 300, 300, 70000,
+                                   70000);
+  EXPECT_COMPILED_MATCHES_SNPRINTF("[%5d][%-5d][%05d][%+d][% d]", 42, 42, -42,
+                                   42, 42);
+  EXPECT_COMPILED_MATCHES_SNPRINTF("[%.3d][%8.3d][%.0d]", 7, -7, 0);
+  EXPECT_COMPILED_MATCHES_SNPRINTF("%#x %#X %#o %08x", 255u, 255u, 8u, 0xabu);
+}
+
+TEST(CompiledFormat, NarrowIntegers_ConvertLikePrintf) {
+  char buffer[32];
+  const int8_t small = -5;
+  const uint16_t medium = 65535;
+  EXPECT_EQ(OkStatus(),
+            PW_STRING_FORMAT(buffer, "%d %u %x", small, medium, small)
+                .status());
+  EXPECT_STREQ("-5 65535 fffffffb", buffer);
+
+  EXPECT_EQ(OkStatus(),
+            PW_STRING_FORMAT(buffer, "%u %d", -1, 4000000000u).status());
+  EXPECT_STREQ("4294967295 -294967296", buffer);
+}
+
+TEST(CompiledFormat, CharsAndStrings_MatchSnprintf) {
+  EXPECT_COMPILED_MATCHES_SNPRINTF("[%c][%3c][%-3c]", 'a', 'b', 'c');
+  EXPECT_COMPILED_MATCHES_SNPRINTF("[%s][%6s][%-6s][%.2s]", "abc", "abc",
+                                   "abc", "abc");
+}
+
+TEST(CompiledFormat, StringView) {
+  constexpr std::string_view kView("abcdef", 3);
+  char buffer[32];
+  EXPECT_EQ(OkStatus(),
+            PW_STRING_FORMAT(buffer, "[%s][%5s][%.2s]", kView, kView, kView)
+                .status());
+  EXPECT_STREQ("[abc][  abc][ab]", buffer);
+}
+
+TEST(CompiledFormat, FloatsAndPointers_MatchSnprintf) {
+  EXPECT_COMPILED_MATCHES_SNPRINTF("%d %.2f %s", 1, 2.5, "three");
+  EXPECT_COMPILED_MATCHES_SNPRINTF("%8.3e|%g|%Lf", 1e10, 0.25f, 1.5L);
+  int value = 0;
+  EXPECT_COMPILED_MATCHES_SNPRINTF("%p", static_cast<void*>(&value));
+}
+
+TEST(CompiledFormat, Truncated_ReturnsResourceExhausted) {
+  char buffer[6];
+  auto result = PW_STRING_FORMAT(buffer, "%d%s", 1234, "abc");
+
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(5u, result.size());
+  EXPECT_STREQ("1234a", buffer);
+
+  result = PW_STRING_FORMAT(buffer, "%d %.1f", 12, 3.25);
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(5u, result.size());
+  EXPECT_STREQ("12 3.", buffer);
+
+  result = PW_STRING_FORMAT(std::span<char>(), "%d", 1);
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+}
+
+// The format string is parsed at compile time.
+static_assert(internal::ConversionCount("%d%%%s") == 2u);
+static_assert(internal::CompileFormat<10, 1>("a%%b%-8.3fc").valid);
+static_assert(!internal::CompileFormat<2, 1>("%y").valid);
+static_assert(!internal::CompileFormat<3, 1>("%*d").valid);
+static_assert(internal::ArgumentsMatch<int, const char*>(
+    internal::CompileFormat<4, 2>("%d%s")));
+static_assert(!internal::ArgumentsMatch<long long>(
+    internal::CompileFormat<2, 1>("%d")));
+static_assert(!internal::ArgumentsMatch<double>(
+    internal::CompileFormat<2, 1>("%x")));
+static_assert(!internal::ArgumentsMatch<int>(
+    internal::CompileFormat<2, 1>("%s")));
+static_assert(!internal::ArgumentsMatch<int, int>(
+    internal::CompileFormat<2, 1>("%d")));
+
 StatusWithSize CallFormatWithVaList(std::span<char> buffer,
                                     const char* fmt,
                                     ...) {
@@ -0,0 +1,174 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_string/inline_string.h"
+
+#include <string_view>
+#include <type_traits>
+
+#include "gtest/gtest.h"
+#include "pw_string/string_builder.h"
+
+namespace pw {
+namespace {
+
+using namespace std::literals::string_view_literals;
+
+void TakesStringView(std::string_view expected, std::string_view actual) {
+  EXPECT_EQ(expected, actual);
+}
+
+TEST(InlineString, Construct_Empty) {
+  InlineString<4> str;
+  EXPECT_TRUE(str.empty());
+  EXPECT_EQ(0u, str.size());
+  EXPECT_STREQ("", str.c_str());
+  EXPECT_EQ(4u, str.capacity());
+  EXPECT_EQ(4u, str.max_size());
+}
+
+TEST(InlineString, Construct_FromStrings) {
+  EXPECT_EQ("abc"sv, InlineString<4>("abc"));
+  EXPECT_EQ("ab"sv, InlineString<4>("abc", 2));
+  EXPECT_EQ("xyz"sv, InlineString<4>("xyz"sv));
+  EXPECT_EQ("zzz"sv, InlineString<4>(3, 'z'));
+  EXPECT_STREQ("abcd", InlineString<4>("abcd").c_str());
+}
+
+TEST(InlineString, Construct_EmbeddedNull) {
+  InlineString<4> str("a\0b"sv);
+  EXPECT_EQ(3u, str.size());
+  EXPECT_EQ('b', str[2]);
+}
+
+TEST(InlineString, CopyAndAssign_DifferentCapacities) {
+  InlineString<4> small("abc");
+  InlineString<8> large(small);
+  EXPECT_EQ("abc"sv, large);
+
+  large = "1234";
+  small = large;
+  EXPECT_EQ("1234"sv, small);
+
+  InlineString<4> copy = small;
+  EXPECT_EQ(small, copy);
+
+  copy = 'x';
+  EXPECT_EQ("x"sv, copy);
+}
+
+TEST(InlineString, Assign_FromSelf) {
+  InlineString<8> str("abcdef");
+  str.assign(str.data() + 2, 3);
+  EXPECT_EQ("cde"sv, str);
+  str.assign(str.view().substr(1));
+  EXPECT_EQ("de"sv, str);
+}
+
+TEST(InlineString, Append) {
+  InlineString<11> str("ab");
+  str.append("cd").append("efg"sv).append(2, '!');
+  str += 'h';
+  str += "i";
+  EXPECT_EQ("abcdefg!!hi"sv, str);
+  EXPECT_EQ(11u, str.size());
+  EXPECT_EQ('\0', str.c_str()[str.size()]);
+}
+
+TEST(InlineString, Append_FromSelf) {
+  InlineString<8> str("abc");
+  str.append(str.view());
+  EXPECT_EQ("abcabc"sv, str);
+}
+
+TEST(InlineString, PushBackPopBack) {
+  InlineString<2> str;
+  str.push_back('a');
+  str.push_back('b');
+  EXPECT_EQ("ab"sv, str);
+  EXPECT_EQ('a', str.front());
+  EXPECT_EQ('b', str.back());
+
+  str.pop_back();
+  EXPECT_EQ("a"sv, str);
+  EXPECT_STREQ("a", str.c_str());
+}
+
+TEST(InlineString, Resize) {
+  InlineString<6> str("abc");
+  str.resize(5, '-');
+  EXPECT_EQ("abc--"sv, str);
+  str.resize(1);
+  EXPECT_EQ("a"sv, str);
+  EXPECT_STREQ("a", str.c_str());
+
+  str.clear();
+  EXPECT_TRUE(str.empty());
+  EXPECT_STREQ("", str.c_str());
+}
+
+TEST(InlineString, Iterators) {
+  InlineString<8> str("hello");
+  for (char& ch : str) {
+    ch = static_cast<char>(ch - 'a' + 'A');
+  }
+  EXPECT_EQ("HELLO"sv, str);
+  EXPECT_EQ(5, str.cend() - str.cbegin());
+}
+
+TEST(InlineString, SubstrAndCompare) {
+  const InlineString<8> str("abcdef");
+  EXPECT_EQ("cd"sv, str.substr(2, 2));
+  EXPECT_EQ("ef"sv, str.substr(4));
+  EXPECT_EQ(0, str.compare("abcdef"));
+  EXPECT_LT(str.compare("b"), 0);
+  EXPECT_GT(str.compare("abc"), 0);
+}
+
+TEST(InlineString, Comparison) {
+  InlineString<4> a("abc");
+  InlineString<8> b("abc");
+  EXPECT_TRUE(a == b);
+  EXPECT_TRUE(a == "abc");
+  EXPECT_TRUE("abc" == a);
+  EXPECT_TRUE(a == "abc"sv);
+  EXPECT_TRUE(a != "abd");
+  EXPECT_TRUE("ab" != a);
+
+  b += 'd';
+  EXPECT_TRUE(a != b);
+}
+
+TEST(InlineString, ConvertsToStringView) {
+  InlineString<8> str("view");
+  TakesStringView("view", str);
+}
+
+TEST(InlineString, StringBuilder_Interoperates) {
+  InlineString<16> str("answer");
+  StringBuffer<32> builder;
+  builder << str << '=' << 42;
+  EXPECT_EQ("answer=42"sv, builder.view());
+
+  str = builder;
+  EXPECT_EQ("answer=42"sv, str);
+  str.append(builder.view(), 6, 3);
+  EXPECT_EQ("answer=42=42"sv, str);
+}
+
+static_assert(std::is_convertible_v<InlineString<1>, std::string_view>);
+static_assert(sizeof(InlineString<7>) <= sizeof(size_t) + 8);
+
+}  // namespace
+}  // namespace pw
@@ -20,12 +20,49 @@
 // These functions return a StatusWithSize. The Status is set to reflect any
 // errors and the return value is always the number of characters written before
 // the null terminator.
+//
+// Integer (d, i, u, o, x, X), character (c), and string (s) conversions, with
+// any flags, width, precision, and length modifier, are formatted directly
+// with the pw_string integer and string functions. This is faster and uses
+// less stack than std::vsnprintf on most embedded C libraries. Starting at the
+// first other conversion, such as a floating point or pointer conversion, the
+// rest of the string is formatted with std::vsnprintf.
 
 #include <cstdarg>
 #include <span>
 
 #include "pw_preprocessor/compiler.h"
 #include "pw_status/status_with_size.h"
+#include "pw_string/internal/format.h"
+
+// Writes a printf-style formatted string to a buffer, like pw::string::Format,
+// but parses the format string at compile time. The format must be a string
+// literal. At run time, only the literal text is copied and the arguments are
+// converted. Evaluates to a StatusWithSize, like pw::string::Format.
+//
+//   char buffer[32];
+//   StatusWithSize result = PW_STRING_FORMAT(buffer, "%s: %5d", name, value);
+//
+// Invalid format strings and arguments whose types do not match their
+// conversions are compile errors. Integer arguments may be narrower than the
+// conversion's type, which they are converted to as printf would. %s accepts
+// anything convertible to std::string_view, which need not be null terminated.
+// Widths and precisions from arguments (*) and %n are not supported.
+#define PW_STRING_FORMAT(buffer, format, ...)                                 \
+  ([&](const auto&... pw_string_format_args) {                                \
+    static constexpr auto kPwStringFormat =                                  \
+        ::pw::string::internal::CompileFormat<                               \
+            ::pw::string::internal::FormatStringLength(format),              \
+            ::pw::string::internal::ConversionCount(format)>(format);        \
+    static_assert(kPwStringFormat.valid,                                     \
+                  "PW_STRING_FORMAT: Invalid or unsupported format string"); \
+    static_assert(::pw::string::internal::ArgumentsMatch<decltype(           \
+                      pw_string_format_args)...>(kPwStringFormat),           \
+                  "PW_STRING_FORMAT: The arguments do not match the format " \
+                  "string");                                                 \
+    return ::pw::string::internal::FormatCompiled(                           \
+        kPwStringFormat, buffer, pw_string_format_args...);                  \
+  }(__VA_ARGS__))
 
 namespace pw::string {
 
@@ -0,0 +1,264 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+#include "pw_assert/light.h"
+#include "pw_string/util.h"
+
+namespace pw {
+
+// InlineString is a fixed-capacity string stored inline, like std::string but
+// without dynamic allocation. It holds up to kCapacity characters plus a null
+// terminator, and stores its length alongside the characters, so size() is
+// O(1) and the string never has to be scanned for its null terminator.
+//
+// InlineString provides most of the std::string API. Operations that would
+// exceed the capacity, which would throw std::length_error for std::string,
+// crash with PW_ASSERT instead. Where truncation is preferable to crashing,
+// build the string with a StringBuilder, which reports truncation in its
+// status, and then assign it to the InlineString.
+//
+// InlineString converts implicitly to std::string_view, so it can be passed to
+// functions that take a std::string_view and written to a StringBuilder with
+// <<.
+// InlineStrings of different capacities may be assigned to and compared with
+// one another.
+//
+//   InlineString<16> name("sensor");
+//   name += '_';
+//   name.append(suffix);          // suffix is a std::string_view
+//   builder << name << ": " << value;
+//
+template <size_t kCapacity>
+class InlineString {
+ public:
+  using value_type = char;
+  using size_type = size_t;
+  using reference = char&;
+  using const_reference = const char&;
+  using pointer = char*;
+  using const_pointer = const char*;
+  using iterator = char*;
+  using const_iterator = const char*;
+
+  static constexpr size_t npos = std::string_view::npos;
+
+  InlineString() : size_(0) { buffer_[0] = '\0'; }
+
+  InlineString(size_t count, char ch) : size_(0) { assign(count, ch); }
+
+  InlineString(const char* str, size_t count) : size_(0) {
+    assign(str, count);
+  }
+
+  // Reads no more than kCapacity + 1 characters from str, so a string that
+  // does not fit is detected without scanning all of it.
+  InlineString(const char* str) : size_(0) { assign(str); }
+
+  InlineString(std::string_view str) : size_(0) { assign(str); }
+
+  InlineString(const InlineString& other) : size_(0) { assign(other.view()); }
+
+  template <size_t kOtherCapacity>
+  InlineString(const InlineString<kOtherCapacity>& other) : size_(0) {
+    assign(other.view());
+  }
+
+  InlineString& operator=(const InlineString& other) {
+    return assign(other.view());
+  }
+
+  template <size_t kOtherCapacity>
+  InlineString& operator=(const InlineString<kOtherCapacity>& other) {
+    return assign(other.view());
+  }
+
+  InlineString& operator=(const char* str) { return assign(str); }
+  InlineString& operator=(std::string_view str) { return assign(str); }
+
+  InlineString& operator=(char ch) { return assign(1, ch); }
+
+  InlineString& assign(size_t count, char ch) {
+    PW_ASSERT(count <= kCapacity);
+    std::memset(buffer_, ch, count);
+    return SetSize(count);
+  }
+
+  // str may point into this string.
+  InlineString& assign(const char* str, size_t count) {
+    PW_ASSERT(count <= kCapacity);
+    std::memmove(buffer_, str, count);
+    return SetSize(count);
+  }
+
+  InlineString& assign(const char* str) {
+    return assign(str, string::Length(str, kCapacity + 1));
+  }
+
+  InlineString& assign(std::string_view str) {
+    return assign(str.data(), str.size());
+  }
+
+  // Element access. Like std::string, indexing past the end is undefined.
+  char& operator[](size_t index) { return buffer_[index]; }
+  const char& operator[](size_t index) const { return buffer_[index]; }
+
+  char& front() { return buffer_[0]; }
+  const char& front() const { return buffer_[0]; }
+
+  char& back() { return buffer_[size_ - 1]; }
+  const char& back() const { return buffer_[size_ - 1]; }
+
+  // The string is always null terminated.
+  char* data() { return buffer_; }
+  const char* data() const { return buffer_; }
+  const char* c_str() const { return buffer_; }
+
+  std::string_view view() const { return std::string_view(buffer_, size_); }
+  operator std::string_view() const { return view(); }
+
+  iterator begin() { return buffer_; }
+  const_iterator begin() const { return buffer_; }
+  const_iterator cbegin() const { return buffer_; }
+
+  iterator end() { return buffer_ + size_; }
+  const_iterator end() const { return buffer_ + size_; }
+  const_iterator cend() const { return buffer_ + size_; }
+
+  // Capacity.
+  bool empty() const { return size_ == 0u; }
+  size_t size() const { return size_; }
+  size_t length() const { return size_; }
+  static constexpr size_t max_size() { return kCapacity; }
+  static constexpr size_t capacity() { return kCapacity; }
+
+  // Operations.
+  void clear() { SetSize(0); }
+
+  void push_back(char ch) {
+    PW_ASSERT(size_ < kCapacity);
+    buffer_[size_] = ch;
+    SetSize(size_ + 1);
+  }
+
+  void pop_back() {
+    PW_ASSERT(size_ > 0u);
+    SetSize(size_ - 1);
+  }
+
+  InlineString& append(size_t count, char ch) {
+    PW_ASSERT(count <= kCapacity - size_);
+    std::memset(buffer_ + size_, ch, count);
+    return SetSize(size_ + count);
+  }
+
+  // str may point into this string.
+  InlineString& append(const char* str, size_t count) {
+    PW_ASSERT(count <= kCapacity - size_);
+    std::memmove(buffer_ + size_, str, count);
+    return SetSize(size_ + count);
+  }
+
+  InlineString& append(const char* str) {
+    return append(str, string::Length(str, kCapacity - size_ + 1));
+  }
+
+  InlineString& append(std::string_view str) {
+    return append(str.data(), str.size());
+  }
+
+  // Appends up to count characters from str, starting at pos.
+  InlineString& append(std::string_view str, size_t pos, size_t count = npos) {
+    PW_ASSERT(pos <= str.size());
+    return append(str.substr(pos, count));
+  }
+
+  InlineString& operator+=(char ch) {
+    push_back(ch);
+    return *this;
+  }
+
+  InlineString& operator+=(const char* str) { return append(str); }
+  InlineString& operator+=(std::string_view str) { return append(str); }
+
+  // Truncates the string or extends it with copies of ch.
+  void resize(size_t count, char ch = '\0') {
+    if (count > size_) {
+      append(count - size_, ch);
+    } else {
+      SetSize(count);
+    }
+  }
+
+  // Returns a view of the substring at pos. Unlike std::string::substr, which
+  // returns a copy, the view is invalidated when the string changes.
+  std::string_view substr(size_t pos = 0, size_t count = npos) const {
+    PW_ASSERT(pos <= size_);
+    return view().substr(pos, count);
+  }
+
+  int compare(std::string_view other) const { return view().compare(other); }
+
+ private:
+  static_assert(kCapacity > 0u, "InlineStrings must hold at least 1 character");
+
+  InlineString& SetSize(size_t size) {
+    size_ = size;
+    buffer_[size_] = '\0';
+    return *this;
+  }
+
+  size_t size_;
+  char buffer_[kCapacity + 1];
+};
+
+// InlineStrings compare equal to strings with the same characters, whatever
+// their capacities.
+template <size_t kLhsCapacity, size_t kRhsCapacity>
+bool operator==(const InlineString<kLhsCapacity>& lhs,
+                const InlineString<kRhsCapacity>& rhs) {
+  return lhs.view() == rhs.view();
+}
+
+template <size_t kLhsCapacity, size_t kRhsCapacity>
+bool operator!=(const InlineString<kLhsCapacity>& lhs,
+                const InlineString<kRhsCapacity>& rhs) {
+  return lhs.view() != rhs.view();
+}
+
+template <size_t kCapacity>
+bool operator==(const InlineString<kCapacity>& lhs, std::string_view rhs) {
+  return lhs.view() == rhs;
+}
+
+template <size_t kCapacity>
+bool operator==(std::string_view lhs, const InlineString<kCapacity>& rhs) {
+  return lhs == rhs.view();
+}
+
+template <size_t kCapacity>
+bool operator!=(const InlineString<kCapacity>& lhs, std::string_view rhs) {
+  return lhs.view() != rhs;
+}
+
+template <size_t kCapacity>
+bool operator!=(std::string_view lhs, const InlineString<kCapacity>& rhs) {
+  return lhs != rhs.view();
+}
+
+}  // namespace pw
@@ -0,0 +1,479 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// Internal printf-style conversion parsing and formatting, shared by
+// pw::string::Format and PW_STRING_FORMAT.
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#include "pw_preprocessor/compiler.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::string::internal {
+
+enum class LengthModifier {
+  kNone,
+  kChar,        // hh
+  kShort,       // h
+  kLong,        // l
+  kLongLong,    // ll
+  kMax,         // j
+  kSize,        // z
+  kPtrDiff,     // t
+  kLongDouble,  // L
+};
+
+// A parsed conversion specification: %[flags][width][.precision][length]type.
+struct Conversion {
+  bool left_align = false;  // -
+  bool plus = false;        // +
+  bool space = false;       // ' '
+  bool alternate = false;   // #
+  bool zero_pad = false;    // 0
+
+  bool width_from_arg = false;      // *
+  bool precision_from_arg = false;  // .*
+  int width = 0;
+  int precision = -1;  // -1 if no precision was given.
+
+  LengthModifier length = LengthModifier::kNone;
+  char type = '\0';
+
+  constexpr bool is_signed_integer() const {
+    return type == 'd' || type == 'i';
+  }
+
+  constexpr bool is_integer() const {
+    return is_signed_integer() || type == 'u' || type == 'o' || type == 'x' ||
+           type == 'X';
+  }
+
+  constexpr bool is_floating_point() const {
+    switch (type) {
+      case 'f':
+      case 'F':
+      case 'e':
+      case 'E':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  // True for conversions which are formatted by FormatInteger and FormatText
+  // rather than std::vsnprintf.
+  constexpr bool formatted_directly() const {
+    return is_integer() || ((type == 'c' || type == 's') &&
+                            length == LengthModifier::kNone);
+  }
+};
+
+constexpr int ParseNumber(const char*& format) {
+  int value = 0;
+  while (*format >= '0' && *format <= '9') {
+    value = value * 10 + (*format++ - '0');
+  }
+  return value;
+}
+
+// The size of the integer which printf reads for an integer conversion.
+constexpr size_t IntegerArgumentSize(LengthModifier length) {
+  switch (length) {
+    case LengthModifier::kChar:
+      return sizeof(char);
+    case LengthModifier::kShort:
+      return sizeof(short);
+    case LengthModifier::kLong:
+      return sizeof(long);
+    case LengthModifier::kLongLong:
+      return sizeof(long long);
+    case LengthModifier::kMax:
+      return sizeof(intmax_t);
+    case LengthModifier::kSize:
+      return sizeof(size_t);
+    case LengthModifier::kPtrDiff:
+      return sizeof(ptrdiff_t);
+    case LengthModifier::kLongDouble:
+      return 0;
+    case LengthModifier::kNone:
+    default:
+      return sizeof(int);
+  }
+}
+
+// Parses the conversion specification following a '%' and advances format past
+// it. Returns false if it is not a valid conversion specification, other than
+// "%%", which is not a conversion.
+constexpr bool ParseConversion(const char*& format, Conversion& conversion) {
+  for (;; ++format) {
+    switch (*format) {
+      case '-':
+        conversion.left_align = true;
+        continue;
+      case '+':
+        conversion.plus = true;
+        continue;
+      case ' ':
+        conversion.space = true;
+        continue;
+      case '#':
+        conversion.alternate = true;
+        continue;
+      case '0':
+        conversion.zero_pad = true;
+        continue;
+    }
+    break;
+  }
+
+  if (*format == '*') {
+    conversion.width_from_arg = true;
+    format += 1;
+  } else {
+    conversion.width = ParseNumber(format);
+  }
+
+  if (*format == '.') {
+    format += 1;
+    if (*format == '*') {
+      conversion.precision_from_arg = true;
+      format += 1;
+    } else {
+      conversion.precision = ParseNumber(format);
+    }
+  }
+
+  switch (*format) {
+    case 'h':
+      format += 1;
+      conversion.length = LengthModifier::kShort;
+      if (*format == 'h') {
+        format += 1;
+        conversion.length = LengthModifier::kChar;
+      }
+      break;
+    case 'l':
+      format += 1;
+      conversion.length = LengthModifier::kLong;
+      if (*format == 'l') {
+        format += 1;
+        conversion.length = LengthModifier::kLongLong;
+      }
+      break;
+    case 'j':
+      format += 1;
+      conversion.length = LengthModifier::kMax;
+      break;
+    case 'z':
+      format += 1;
+      conversion.length = LengthModifier::kSize;
+      break;
+    case 't':
+      format += 1;
+      conversion.length = LengthModifier::kPtrDiff;
+      break;
+    case 'L':
+      format += 1;
+      conversion.length = LengthModifier::kLongDouble;
+      break;
+  }
+
+  conversion.type = *format;
+  if (!conversion.is_integer() && !conversion.is_floating_point() &&
+      conversion.type != 'c' && conversion.type != 's' &&
+      conversion.type != 'p' && conversion.type != 'n') {
+    return false;
+  }
+  format += 1;
+  return true;
+}
+
+// Collects formatted output in a buffer, always leaving room for the null
+// terminator. Output that does not fit is dropped and marks it truncated. The
+// buffer must not be empty.
+class FormatOutput {
+ public:
+  explicit FormatOutput(std::span<char> buffer) : buffer_(buffer), size_(0) {}
+
+  void Write(const char* data, size_t length);
+
+  void Fill(char ch, size_t count);
+
+  // Appends output formatted with std::vsnprintf. Returns false if
+  // std::vsnprintf failed, in which case the output is discarded.
+  bool WriteVsnprintf(const char* format, va_list args);
+
+  bool WriteSnprintf(const char* format, ...);
+
+  // Null terminates the output and returns its size. The status is
+  // RESOURCE_EXHAUSTED if any output was dropped.
+  StatusWithSize Finish();
+
+ private:
+  const std::span<char> buffer_;
+  size_t size_;
+  bool truncated_ = false;
+};
+
+// Formats an integer with the conversion's flags, width, and precision.
+void FormatInteger(const Conversion& conversion,
+                   bool negative,
+                   uint64_t magnitude,
+                   FormatOutput& output);
+
+// Formats an integer argument, given as its bits sign-extended to 64 bits, as
+// printf would after reading it as the conversion's integer type.
+void FormatIntegerBits(const Conversion& conversion,
+                       uint64_t bits,
+                       FormatOutput& output);
+
+// Formats a character or string with the conversion's flags and width. The
+// text is not null terminated.
+void FormatText(const Conversion& conversion,
+                const char* text,
+                size_t length,
+                FormatOutput& output);
+
+// Formats a null-terminated string, or "(null)" for nullptr, with the
+// conversion's flags, width, and precision.
+void FormatString(const Conversion& conversion,
+                  const char* text,
+                  FormatOutput& output);
+
+// Compile-time format strings for PW_STRING_FORMAT.
+
+// The number of conversions in a format string, not counting "%%".
+constexpr size_t ConversionCount(const char* format) {
+  size_t count = 0;
+  while (*format != '\0') {
+    if (*format++ == '%') {
+      if (*format == '%') {
+        format += 1;
+      } else {
+        count += 1;
+      }
+    }
+  }
+  return count;
+}
+
+constexpr size_t FormatStringLength(const char* format) {
+  size_t length = 0;
+  while (format[length] != '\0') {
+    length += 1;
+  }
+  return length;
+}
+
+// Conversions which are not formatted directly are passed to std::snprintf
+// with their specification, which may be up to this long.
+inline constexpr size_t kMaxConversionSpecSize = 15;
+
+struct CompiledConversion {
+  Conversion conversion;
+
+  // The end of the literal text which precedes this conversion.
+  size_t text_end = 0;
+
+  // The null-terminated conversion specification, such as "%8.3f".
+  char spec[kMaxConversionSpecSize + 1] = {};
+};
+
+// A format string parsed at compile time into its literal text, with "%%"
+// replaced by "%", and its conversions.
+template <size_t kTextSize, size_t kConversions>
+struct CompiledFormat {
+  char text[kTextSize + 1] = {};
+  size_t text_size = 0;
+  CompiledConversion conversions[kConversions == 0u ? 1 : kConversions] = {};
+  bool valid = true;
+};
+
+// Parses a format string. Conversions with widths or precisions from
+// arguments, %n, wide characters, and invalid conversions make it invalid.
+template <size_t kTextSize, size_t kConversions>
+constexpr CompiledFormat<kTextSize, kConversions> CompileFormat(
+    const char* format) {
+  CompiledFormat<kTextSize, kConversions> compiled;
+  size_t index = 0;
+
+  while (*format != '\0') {
+    if (*format != '%') {
+      compiled.text[compiled.text_size++] = *format++;
+      continue;
+    }
+
+    const char* const spec = format++;
+    if (*format == '%') {
+      compiled.text[compiled.text_size++] = '%';
+      format += 1;
+      continue;
+    }
+
+    CompiledConversion& compiled_conversion = compiled.conversions[index++];
+    Conversion& conversion = compiled_conversion.conversion;
+    compiled_conversion.text_end = compiled.text_size;
+
+    if (!ParseConversion(format, conversion) || conversion.width_from_arg ||
+        conversion.precision_from_arg || conversion.type == 'n' ||
+        (conversion.is_integer() &&
+         conversion.length == LengthModifier::kLongDouble) ||
+        ((conversion.type == 'c' || conversion.type == 's' ||
+          conversion.type == 'p') &&
+         conversion.length != LengthModifier::kNone) ||
+        (conversion.is_floating_point() &&
+         conversion.length != LengthModifier::kNone &&
+         conversion.length != LengthModifier::kLong &&
+         conversion.length != LengthModifier::kLongDouble) ||
+        static_cast<size_t>(format - spec) > kMaxConversionSpecSize) {
+      compiled.valid = false;
+      return compiled;
+    }
+
+    for (size_t i = 0; i < static_cast<size_t>(format - spec); ++i) {
+      compiled_conversion.spec[i] = spec[i];
+    }
+  }
+  return compiled;
+}
+
+// Checks that an argument's type matches what printf would read for the
+// conversion. Integers may be narrower, but not wider, than the conversion's
+// integer type.
+template <typename T>
+constexpr bool ArgumentMatches(const Conversion& conversion) {
+  using Arg = std::decay_t<T>;
+
+  if (conversion.is_integer() || conversion.type == 'c') {
+    if constexpr (std::is_integral_v<Arg>) {
+      const size_t size = IntegerArgumentSize(conversion.length);
+      return size != 0u && sizeof(Arg) <= (size < sizeof(int) ? sizeof(int)
+                                                               : size);
+    }
+    return false;
+  }
+  if (conversion.is_floating_point()) {
+    return std::is_floating_point_v<Arg> &&
+           std::is_same_v<Arg, long double> ==
+               (conversion.length == LengthModifier::kLongDouble);
+  }
+  if (conversion.type == 's') {
+    return std::is_convertible_v<Arg, std::string_view>;
+  }
+  if (conversion.type == 'p') {
+    return std::is_null_pointer_v<Arg> ||
+           std::is_convertible_v<Arg, const void*>;
+  }
+  return false;
+}
+
+template <typename... Args, size_t kTextSize, size_t kConversions>
+constexpr bool ArgumentsMatch(
+    const CompiledFormat<kTextSize, kConversions>& format) {
+  if (sizeof...(Args) != kConversions) {
+    return false;
+  }
+  size_t index = 0;
+  static_cast<void>(index);  // Unused if there are no arguments.
+  return (ArgumentMatches<Args>(format.conversions[index++].conversion) &&
+          ...);
+}
+
+// Writes the literal text before the conversion, then the argument.
+template <typename T>
+bool FormatArgument(const char* text,
+                    size_t& text_begin,
+                    const CompiledConversion& compiled_conversion,
+                    const T& value,
+                    FormatOutput& output) {
+  using Arg = std::decay_t<T>;
+  const Conversion& conversion = compiled_conversion.conversion;
+
+  output.Write(text + text_begin, compiled_conversion.text_end - text_begin);
+  text_begin = compiled_conversion.text_end;
+
+  if constexpr (std::is_integral_v<Arg>) {
+    if (conversion.type == 'c') {
+      const char ch = static_cast<char>(value);
+      FormatText(conversion, &ch, 1, output);
+    } else {
+      FormatIntegerBits(conversion, static_cast<uint64_t>(value), output);
+    }
+    return true;
+  } else if constexpr (std::is_floating_point_v<Arg>) {
+    return output.WriteSnprintf(compiled_conversion.spec, value);
+  } else if constexpr (std::is_null_pointer_v<Arg>) {
+    return output.WriteSnprintf(compiled_conversion.spec,
+                                static_cast<const void*>(value));
+  } else if constexpr (std::is_convertible_v<Arg, const char*>) {
+    // Character pointers may be printed as strings or as pointers.
+    if (conversion.type == 's') {
+      FormatString(conversion, value, output);
+      return true;
+    }
+    return output.WriteSnprintf(compiled_conversion.spec,
+                                static_cast<const void*>(value));
+  } else if constexpr (std::is_convertible_v<Arg, std::string_view>) {
+    const std::string_view view(value);
+    const size_t length =
+        conversion.precision < 0
+            ? view.size()
+            : std::min(view.size(), static_cast<size_t>(conversion.precision));
+    FormatText(conversion, view.data(), length, output);
+    return true;
+  } else {
+    return output.WriteSnprintf(compiled_conversion.spec,
+                                static_cast<const void*>(value));
+  }
+}
+
+template <size_t kTextSize, size_t kConversions, typename... Args>
+StatusWithSize FormatCompiled(
+    const CompiledFormat<kTextSize, kConversions>& format,
+    std::span<char> buffer,
+    const Args&... args) {
+  if (buffer.empty()) {
+    return StatusWithSize::ResourceExhausted();
+  }
+
+  FormatOutput output(buffer);
+  size_t text_begin = 0;
+  size_t index = 0;
+  static_cast<void>(index);  // Unused if there are no arguments.
+  const bool formatted = (FormatArgument(format.text,
+                                         text_begin,
+                                         format.conversions[index++],
+                                         args,
+                                         output) &&
+                          ...);
+  if (!formatted) {
+    return StatusWithSize::InvalidArgument();
+  }
+
+  output.Write(format.text + text_begin, format.text_size - text_begin);
+  return output.Finish();
+}
+
+}  // namespace pw::string::internal
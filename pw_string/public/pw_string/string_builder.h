@@ -229,14 +229,15 @@ class StringBuilder {
   // formatted string does not fit, the results are truncated and the status is
   // set to RESOURCE_EXHAUSTED.
   //
-  // Internally, calls string::Format, which calls std::vsnprintf.
+  // Internally, calls string::Format, which formats integers, characters, and
+  // strings without std::vsnprintf.
   PW_PRINTF_FORMAT(2, 3) StringBuilder& Format(const char* format, ...);
 
   // Appends a vsnprintf-style string with va_list arguments to the end of the
   // StringBuilder. If the formatted string does not fit, the results are
   // truncated and the status is set to RESOURCE_EXHAUSTED.
   //
-  // Internally, calls string::Format, which calls std::vsnprintf.
+  // Internally, calls string::FormatVaList.
   StringBuilder& FormatVaList(const char* format, va_list args);
 
   // Sets the StringBuilder's size. This function only truncates; if
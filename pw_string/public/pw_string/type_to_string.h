@@ -17,6 +17,7 @@
 // types to character buffers. Generally, the generic ToString function defined
 // in "pw_string/to_string.h" should be used instead of these functions.
 
+#include <array>
 #include <cstdint>
 #include <span>
 #include <string_view>
@@ -26,9 +27,46 @@
 
 namespace pw::string {
 
+namespace internal {
+
+// Powers of 10 (except 0) as an array. This table is fairly large (160 B), but
+// avoids having to recalculate these values for each DecimalDigitCount call.
+inline constexpr std::array<uint64_t, 20> kPowersOf10{
+    0ull,
+    10ull,                    // 10^1
+    100ull,                   // 10^2
+    1000ull,                  // 10^3
+    10000ull,                 // 10^4
+    100000ull,                // 10^5
+    1000000ull,               // 10^6
+    10000000ull,              // 10^7
+    100000000ull,             // 10^8
+    1000000000ull,            // 10^9
+    10000000000ull,           // 10^10
+    100000000000ull,          // 10^11
+    1000000000000ull,         // 10^12
+    10000000000000ull,        // 10^13
+    100000000000000ull,       // 10^14
+    1000000000000000ull,      // 10^15
+    10000000000000000ull,     // 10^16
+    100000000000000000ull,    // 10^17
+    1000000000000000000ull,   // 10^18
+    10000000000000000000ull,  // 10^19
+};
+
+}  // namespace internal
+
 // Returns the number of digits in the decimal representation of the provided
 // non-negative integer. Returns 1 for 0 or 1 + log base 10 for other numbers.
-uint_fast8_t DecimalDigitCount(uint64_t integer);
+constexpr uint_fast8_t DecimalDigitCount(uint64_t integer) {
+  // This fancy piece of code takes the log base 2, then approximates the
+  // change-of-base formula by multiplying by 1233 / 4096.
+  // TODO(hepler): Replace __builtin_clzll with std::countl_zeros in C++20.
+  const uint_fast8_t log_10 = (64 - __builtin_clzll(integer | 1)) * 1233 >> 12;
+
+  // Adjust the estimated log base 10 by comparing against the power of 10.
+  return log_10 + (integer < internal::kPowersOf10[log_10] ? 0u : 1u);
+}
 
 // Returns the number of digits in the hexadecimal representation of the
 // provided non-negative integer.
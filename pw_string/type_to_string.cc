@@ -14,6 +14,7 @@
 
 #include "pw_string/type_to_string.h"
 
+#include <array>
 #include <cmath>
 #include <cstddef>
 #include <cstring>
@@ -22,30 +23,34 @@
 namespace pw::string {
 namespace {
 
-// Powers of 10 (except 0) as an array. This table is fairly large (160 B), but
-// avoids having to recalculate these values for each DecimalDigitCount call.
-constexpr std::array<uint64_t, 20> kPowersOf10{
-    0ull,
-    10ull,                    // 10^1
-    100ull,                   // 10^2
-    1000ull,                  // 10^3
-    10000ull,                 // 10^4
-    100000ull,                // 10^5
-    1000000ull,               // 10^6
-    10000000ull,              // 10^7
-    100000000ull,             // 10^8
-    1000000000ull,            // 10^9
-    10000000000ull,           // 10^10
-    100000000000ull,          // 10^11
-    1000000000000ull,         // 10^12
-    10000000000000ull,        // 10^13
-    100000000000000ull,       // 10^14
-    1000000000000000ull,      // 10^15
-    10000000000000000ull,     // 10^16
-    100000000000000000ull,    // 10^17
-    1000000000000000000ull,   // 10^18
-    10000000000000000000ull,  // 10^19
-};
+// Each pair of characters is the two-digit decimal representation of its index.
+// Writing two digits per division halves the number of divisions, which are
+// slow on many microcontrollers.
+constexpr std::array<char, 200> kDigitPairs = [] {
+  std::array<char, 200> pairs{};
+  for (size_t i = 0; i < 100u; ++i) {
+    pairs[2 * i] = static_cast<char>('0' + i / 10);
+    pairs[2 * i + 1] = static_cast<char>('0' + i % 10);
+  }
+  return pairs;
+}();
+
+// Writes the lowest digit_count decimal digits of value, with leading 0s, to
+// the characters before end. Returns a pointer to the first digit written.
+constexpr char* WriteDecimalDigits(uint32_t value,
+                                   uint_fast8_t digit_count,
+                                   char* end) {
+  for (; digit_count >= 2u; digit_count -= 2) {
+    const uint32_t pair = 2 * (value % 100u);
+    value /= 100u;
+    *--end = kDigitPairs[pair + 1];
+    *--end = kDigitPairs[pair];
+  }
+  if (digit_count != 0u) {
+    *--end = static_cast<char>('0' + value % 10u);
+  }
+  return end;
+}
 
 StatusWithSize HandleExhaustedBuffer(std::span<char> buffer) {
   if (!buffer.empty()) {
@@ -56,16 +61,6 @@ StatusWithSize HandleExhaustedBuffer(std::span<char> buffer) {
 
 }  // namespace
 
-uint_fast8_t DecimalDigitCount(uint64_t integer) {
-  // This fancy piece of code takes the log base 2, then approximates the
-  // change-of-base formula by multiplying by 1233 / 4096.
-  // TODO(hepler): Replace __builtin_clzll with std::countl_zeros in C++20.
-  const uint_fast8_t log_10 = (64 - __builtin_clzll(integer | 1)) * 1233 >> 12;
-
-  // Adjust the estimated log base 10 by comparing against the power of 10.
-  return log_10 + (integer < kPowersOf10[log_10] ? 0u : 1u);
-}
-
 // std::to_chars is available for integers in recent versions of GCC. I looked
 // into switching to std::to_chars instead of this implementation. std::to_chars
 // increased binary size by 160 B on an -Os build (even after removing
@@ -73,7 +68,6 @@ uint_fast8_t DecimalDigitCount(uint64_t integer) {
 // think std::to_chars will be faster, so I kept this implementation for now.
 template <>
 StatusWithSize IntToString(uint64_t value, std::span<char> buffer) {
-  constexpr uint32_t base = 10;
   constexpr uint32_t max_uint32_base_power = 1'000'000'000;
   constexpr uint_fast8_t max_uint32_base_power_exponent = 9;
 
@@ -83,30 +77,24 @@ StatusWithSize IntToString(uint64_t value, std::span<char> buffer) {
     return HandleExhaustedBuffer(buffer);
   }
 
-  buffer[total_digits] = '\0';
+  // The digit count is known, so the digits are written from the end of the
+  // number to its start, without a separate reversing pass.
+  char* end = buffer.data() + total_digits;
+  *end = '\0';
 
+  // 64-bit division is slow on 32-bit platforms, so print large numbers in
+  // 32-bit chunks to minimize the number of 64-bit divisions.
   uint_fast8_t remaining = total_digits;
-  while (remaining > 0u) {
-    uint32_t lower_digits;     // the value of the lower digits to write
-    uint_fast8_t digit_count;  // the number of lower digits to write
-
-    // 64-bit division is slow on 32-bit platforms, so print large numbers in
-    // 32-bit chunks to minimize the number of 64-bit divisions.
-    if (value <= std::numeric_limits<uint32_t>::max()) {
-      lower_digits = value;
-      digit_count = remaining;
-    } else {
-      lower_digits = value % max_uint32_base_power;
-      digit_count = max_uint32_base_power_exponent;
-      value /= max_uint32_base_power;
-    }
-
-    // Write the specified number of digits, with leading 0s.
-    for (uint_fast8_t i = 0; i < digit_count; ++i) {
-      buffer[--remaining] = lower_digits % base + '0';
-      lower_digits /= base;
-    }
+  while (value > std::numeric_limits<uint32_t>::max()) {
+    end = WriteDecimalDigits(
+        static_cast<uint32_t>(value % max_uint32_base_power),
+        max_uint32_base_power_exponent,
+        end);
+    value /= max_uint32_base_power;
+    remaining -= max_uint32_base_power_exponent;
   }
+
+  WriteDecimalDigits(static_cast<uint32_t>(value), remaining, end);
   return StatusWithSize(total_digits);
 }
 
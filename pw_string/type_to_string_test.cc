@@ -57,6 +57,11 @@ TEST(Digits, DecimalDigits_20) {
   }
 }
 
+static_assert(DecimalDigitCount(0) == 1u);
+static_assert(DecimalDigitCount(99) == 2u);
+static_assert(DecimalDigitCount(100) == 3u);
+static_assert(DecimalDigitCount(std::numeric_limits<uint64_t>::max()) == 20u);
+
 TEST(Digits, HexDigits_AllOneDigit) {
   for (uint64_t i = 0; i < 0x10; ++i) {
     ASSERT_EQ(1u, HexDigitCount(i));
@@ -266,6 +271,23 @@ TEST(IntToString, UnsignedSweep) {
   }
 }
 
+TEST(IntToString, PowersOf10AndNeighbors) {
+  uint64_t power = 1;
+  for (int exponent = 0; exponent < 20; ++exponent, power *= 10) {
+    for (uint64_t value : {power - 1, power, power + 1, power * 9 / 7}) {
+      char buffer[21];
+      char printf_buffer[21];
+      int written = std::snprintf(printf_buffer,
+                                  sizeof(printf_buffer),
+                                  "%llu",
+                                  static_cast<unsigned long long>(value));
+      auto result = IntToString(value, buffer);
+      ASSERT_EQ(static_cast<size_t>(written), result.size());
+      ASSERT_STREQ(printf_buffer, buffer);
+    }
+  }
+}
+
 class IntToHexStringTest : public TestWithBuffer {};
 
 TEST_F(IntToHexStringTest, Sweep) {
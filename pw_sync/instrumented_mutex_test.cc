@@ -0,0 +1,83 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sync/instrumented_mutex.h"
+
+#include <chrono>
+#include <mutex>
+
+#include "gtest/gtest.h"
+
+using namespace std::chrono_literals;
+
+namespace pw::sync {
+namespace {
+
+constexpr metric::Token kName = PW_TOKENIZE_STRING_DOMAIN("metrics", "test");
+
+// TODO(pwbug/291): Add real concurrency tests once we have pw::thread.
+
+TEST(InstrumentedMutex, LockAndUnlock) {
+  InstrumentedMutex mutex(kName);
+  mutex.lock();
+  EXPECT_FALSE(mutex.try_lock());
+  EXPECT_FALSE(mutex.try_lock_for(1ms));
+  mutex.unlock();
+
+  {
+    std::lock_guard lock(mutex);
+    EXPECT_FALSE(mutex.try_lock());
+  }
+  EXPECT_TRUE(mutex.try_lock_for(1ms));
+  mutex.unlock();
+}
+
+#if PW_SYNC_INSTRUMENT_MUTEXES
+
+TEST(InstrumentedMutex, CountsAcquisitionsAndContention) {
+  InstrumentedMutex mutex(kName);
+  mutex.lock();
+  EXPECT_FALSE(mutex.try_lock());
+  EXPECT_FALSE(mutex.try_lock_for(1ms));
+  mutex.unlock();
+  EXPECT_TRUE(mutex.try_lock());
+  mutex.unlock();
+
+  EXPECT_EQ(2u, mutex.acquisitions());
+  EXPECT_EQ(2u, mutex.contended());
+  // Only contended acquisitions that succeed record a wait time.
+  EXPECT_EQ(0u, mutex.wait_us().snapshot().total());
+}
+
+TEST(InstrumentedMutex, RegisterMetrics) {
+  InstrumentedMutex mutex(kName);
+  PW_METRIC_GROUP(parent, "parent");
+  mutex.RegisterMetrics(parent);
+
+  ASSERT_EQ(1u, parent.children().size());
+  EXPECT_EQ(kName, parent.children().front().name());
+  EXPECT_EQ(2u, mutex.metrics().metrics().size());
+  EXPECT_EQ(1u, mutex.metrics().children().size());
+}
+
+#else
+
+TEST(InstrumentedMutex, SameSizeAsMutexWhenDisabled) {
+  EXPECT_EQ(sizeof(Mutex), sizeof(InstrumentedMutex));
+}
+
+#endif  // PW_SYNC_INSTRUMENT_MUTEXES
+
+}  // namespace
+}  // namespace pw::sync
@@ -0,0 +1,181 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_metric/histogram.h"
+#include "pw_metric/metric.h"
+#include "pw_sync/internal/config.h"
+#include "pw_sync/mutex.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::sync {
+
+// InstrumentedMutex is a Mutex that can measure its own contention. It is a
+// drop-in replacement for Mutex for locks suspected of being contended, such as
+// those in RPC and logging.
+//
+// When PW_SYNC_INSTRUMENT_MUTEXES is enabled, each InstrumentedMutex has a
+// metric group, named by the token passed to its constructor, with:
+//
+//   acquisitions - The number of times the mutex was locked.
+//   contended - The number of lock attempts that found the mutex held.
+//   wait_us - A histogram of the time in microseconds that contended lock()
+//             and successful timed lock calls waited for the mutex.
+//
+// The metrics are updated while the mutex is held, except for contended, which
+// is updated atomically. Call RegisterMetrics() to add the group to a parent,
+// such as one served by MetricService.
+//
+// When PW_SYNC_INSTRUMENT_MUTEXES is disabled, the default, InstrumentedMutex
+// is the same size as Mutex and forwards every call to it, and
+// RegisterMetrics() does nothing.
+//
+// Example:
+//
+//   pw::sync::InstrumentedMutex log_mutex(
+//       PW_TOKENIZE_STRING_DOMAIN("metrics", "log_mutex"));
+//
+//   void Init(pw::metric::Group& metrics) {
+//     log_mutex.RegisterMetrics(metrics);
+//   }
+//
+class InstrumentedMutex {
+ public:
+  // Wait time buckets are powers of two microseconds, up to 2^19 us (~0.5 s).
+  static constexpr size_t kWaitTimeBuckets = 21;
+
+  explicit InstrumentedMutex([[maybe_unused]] metric::Token name)
+#if PW_SYNC_INSTRUMENT_MUTEXES
+      : metrics_(name),
+        wait_us_(kWaitUsName, metrics_.children())
+#endif  // PW_SYNC_INSTRUMENT_MUTEXES
+  {
+  }
+
+  InstrumentedMutex(const InstrumentedMutex&) = delete;
+  InstrumentedMutex(InstrumentedMutex&&) = delete;
+  InstrumentedMutex& operator=(const InstrumentedMutex&) = delete;
+  InstrumentedMutex& operator=(InstrumentedMutex&&) = delete;
+
+  void lock() {
+#if PW_SYNC_INSTRUMENT_MUTEXES
+    if (mutex_.try_lock()) {
+      acquisitions_.Increment();
+      return;
+    }
+    contended_.AtomicIncrement();
+    const chrono::SystemClock::time_point start = chrono::SystemClock::now();
+    mutex_.lock();
+    RecordWait(start);
+#else
+    mutex_.lock();
+#endif  // PW_SYNC_INSTRUMENT_MUTEXES
+  }
+
+  bool try_lock() {
+#if PW_SYNC_INSTRUMENT_MUTEXES
+    if (mutex_.try_lock()) {
+      acquisitions_.Increment();
+      return true;
+    }
+    contended_.AtomicIncrement();
+    return false;
+#else
+    return mutex_.try_lock();
+#endif  // PW_SYNC_INSTRUMENT_MUTEXES
+  }
+
+  bool try_lock_for(chrono::SystemClock::duration for_at_least) {
+#if PW_SYNC_INSTRUMENT_MUTEXES
+    return try_lock_until(chrono::SystemClock::now() + for_at_least);
+#else
+    return mutex_.try_lock_for(for_at_least);
+#endif  // PW_SYNC_INSTRUMENT_MUTEXES
+  }
+
+  bool try_lock_until(chrono::SystemClock::time_point until_at_least) {
+#if PW_SYNC_INSTRUMENT_MUTEXES
+    if (mutex_.try_lock()) {
+      acquisitions_.Increment();
+      return true;
+    }
+    contended_.AtomicIncrement();
+    const chrono::SystemClock::time_point start = chrono::SystemClock::now();
+    if (!mutex_.try_lock_until(until_at_least)) {
+      return false;
+    }
+    RecordWait(start);
+    return true;
+#else
+    return mutex_.try_lock_until(until_at_least);
+#endif  // PW_SYNC_INSTRUMENT_MUTEXES
+  }
+
+  void unlock() { mutex_.unlock(); }
+
+  // Adds the mutex's metrics to the parent group, if instrumentation is
+  // enabled.
+  void RegisterMetrics([[maybe_unused]] metric::Group& parent) {
+#if PW_SYNC_INSTRUMENT_MUTEXES
+    parent.Add(metrics_);
+#endif  // PW_SYNC_INSTRUMENT_MUTEXES
+  }
+
+#if PW_SYNC_INSTRUMENT_MUTEXES
+  const metric::Group& metrics() const { return metrics_; }
+  uint32_t acquisitions() const { return acquisitions_.value(); }
+  uint32_t contended() const { return contended_.value(); }
+  const metric::Histogram<kWaitTimeBuckets>& wait_us() const {
+    return wait_us_;
+  }
+#endif  // PW_SYNC_INSTRUMENT_MUTEXES
+
+  Mutex& mutex() { return mutex_; }
+
+ private:
+  Mutex mutex_;
+
+#if PW_SYNC_INSTRUMENT_MUTEXES
+  static constexpr metric::Token kWaitUsName =
+      PW_TOKENIZE_STRING_DOMAIN("metrics", "wait_us");
+
+  // Records an acquisition that waited since start. The mutex must be held.
+  void RecordWait(chrono::SystemClock::time_point start) {
+    const int64_t wait_us =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            chrono::SystemClock::now() - start)
+            .count();
+    wait_us_.Record(static_cast<uint32_t>(
+        std::clamp<int64_t>(wait_us, 0, UINT32_MAX)));
+    acquisitions_.Increment();
+  }
+
+  metric::Group metrics_;
+  PW_METRIC(metrics_, acquisitions_, "acquisitions", 0u);
+  PW_METRIC(metrics_, contended_, "contended", 0u);
+  metric::Histogram<kWaitTimeBuckets> wait_us_;
+#endif  // PW_SYNC_INSTRUMENT_MUTEXES
+};
+
+#if !PW_SYNC_INSTRUMENT_MUTEXES
+static_assert(sizeof(InstrumentedMutex) == sizeof(Mutex),
+              "InstrumentedMutex must cost nothing when disabled");
+#endif  // !PW_SYNC_INSTRUMENT_MUTEXES
+
+}  // namespace pw::sync
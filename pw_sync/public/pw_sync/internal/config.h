@@ -0,0 +1,21 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// PW_SYNC_INSTRUMENT_MUTEXES makes pw::sync::InstrumentedMutex record
+// acquisition counts, contention, and wait times in pw_metric metrics. When
+// disabled, InstrumentedMutex is a plain Mutex with no overhead.
+#ifndef PW_SYNC_INSTRUMENT_MUTEXES
+#define PW_SYNC_INSTRUMENT_MUTEXES 0
+#endif  // PW_SYNC_INSTRUMENT_MUTEXES
@@ -0,0 +1,109 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_sync/binary_semaphore.h"
+#include "pw_sync/counting_semaphore.h"
+#include "pw_sync/mutex.h"
+
+namespace pw::sync {
+
+// SharedMutex is a reader-writer lock: any number of threads may hold it in
+// shared mode at once, such as to read a routing table, or one thread may hold
+// it in exclusive mode to modify the table. It implements the C++
+// SharedLockable requirements, so it works with std::shared_lock as well as
+// std::lock_guard.
+//
+// SharedMutex is built on the pw::sync Mutex, BinarySemaphore, and
+// CountingSemaphore facades, so it is available with any of their backends,
+// including FreeRTOS, ThreadX, and the STL. Waiting threads are handed the lock
+// directly when it is released, so a thread that wakes never has to compete
+// for it again.
+//
+// The entire API is thread safe, but none of it is IRQ safe. As with Mutex,
+// recursive locking is undefined behavior.
+class SharedMutex {
+ public:
+  // Which waiting threads get the lock when it becomes available.
+  enum class Priority {
+    // Once a writer is waiting, new readers wait until it has had the lock, so
+    // a steady stream of readers cannot starve writers.
+    kWriters,
+
+    // Readers get the lock whenever it is not held exclusively. Writers may
+    // wait as long as any reader holds the lock.
+    kReaders,
+  };
+
+  explicit SharedMutex(Priority priority = Priority::kWriters)
+      : priority_(priority) {}
+
+  SharedMutex(const SharedMutex&) = delete;
+  SharedMutex(SharedMutex&&) = delete;
+  SharedMutex& operator=(const SharedMutex&) = delete;
+  SharedMutex& operator=(SharedMutex&&) = delete;
+
+  // Locks the mutex exclusively, blocking indefinitely.
+  void lock();
+
+  // Attempts to lock the mutex exclusively without blocking. Returns true if
+  // the mutex was locked.
+  bool try_lock();
+
+  // Unlocks a mutex held exclusively.
+  void unlock();
+
+  // Locks the mutex in shared mode, blocking indefinitely.
+  void lock_shared();
+
+  // Attempts to lock the mutex in shared mode without blocking. Returns true if
+  // the mutex was locked.
+  bool try_lock_shared();
+
+  // Unlocks a mutex held in shared mode.
+  void unlock_shared();
+
+ private:
+  // Returns true if a new reader may take the lock. The state mutex must be
+  // held.
+  bool ReaderMayLock() const {
+    return !writer_active_ &&
+           (priority_ == Priority::kReaders || writers_waiting_ == 0);
+  }
+
+  // Hands the lock to waiting threads after it is released. The state mutex
+  // must be held.
+  void WakeWaiters();
+
+  const Priority priority_;
+
+  // Guards the state below.
+  Mutex state_mutex_;
+
+  // The number of readers holding the lock.
+  size_t readers_ = 0;
+  bool writer_active_ = false;
+
+  size_t readers_waiting_ = 0;
+  size_t writers_waiting_ = 0;
+
+  // Released once per waiting reader or writer that is handed the lock.
+  CountingSemaphore readers_ready_;
+  BinarySemaphore writer_ready_;
+};
+
+}  // namespace pw::sync
@@ -0,0 +1,78 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_chrono/system_clock.h"
+#include "pw_sync_backend/thread_notification_native.h"
+
+namespace pw::sync {
+
+// ThreadNotification is a synchronization primitive that lets a single thread
+// wait to be notified, such as of a flushed log or a completed RPC send.
+//
+// It acts like a BinarySemaphore that only one thread may ever wait on. That
+// restriction lets backends use primitives that are much cheaper than a full
+// semaphore, such as FreeRTOS task notifications. release() is IRQ safe, as is
+// try_acquire(); the blocking calls are thread safe, but only one thread may
+// block on a notification at a time.
+//
+// WARNING: In order to support global statically constructed
+// ThreadNotifications, the backend MUST ensure that any initialization required
+// in your environment prior to the creation and/or initialization of the native
+// notification (e.g. kernel initialization), is done before or during the
+// invocation of the global static C++ constructors.
+class ThreadNotification {
+ public:
+  using native_handle_type = backend::NativeThreadNotificationHandle;
+
+  ThreadNotification();
+  ~ThreadNotification();
+  ThreadNotification(const ThreadNotification&) = delete;
+  ThreadNotification(ThreadNotification&&) = delete;
+  ThreadNotification& operator=(const ThreadNotification&) = delete;
+  ThreadNotification& operator=(ThreadNotification&&) = delete;
+
+  // Blocks indefinitely until the thread is notified, then clears the
+  // notification. This is thread safe, but only one thread may block at a time.
+  void acquire();
+
+  // Returns true and clears the notification if the thread was notified.
+  // This is IRQ safe.
+  bool try_acquire();
+
+  // Blocks for at least the specified duration until the thread is notified.
+  // Returns true and clears the notification if the thread was notified.
+  // This is thread safe, but only one thread may block at a time.
+  bool try_acquire_for(chrono::SystemClock::duration for_at_least);
+
+  // Blocks until at least the specified time point until the thread is
+  // notified. Returns true and clears the notification if the thread was
+  // notified. This is thread safe, but only one thread may block at a time.
+  bool try_acquire_until(chrono::SystemClock::time_point until_at_least);
+
+  // Notifies the waiting thread, or if no thread is waiting, the next thread to
+  // wait. Notifications do not accumulate: releasing a notification that is
+  // already set has no effect. This is IRQ safe.
+  void release();
+
+  native_handle_type native_handle();
+
+ private:
+  // This may be a wrapper around a native type with additional members.
+  backend::NativeThreadNotification native_type_;
+};
+
+}  // namespace pw::sync
+
+#include "pw_sync_backend/thread_notification_inline.h"
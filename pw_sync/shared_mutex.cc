@@ -0,0 +1,100 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sync/shared_mutex.h"
+
+#include <mutex>
+
+#include "pw_assert/assert.h"
+
+namespace pw::sync {
+
+void SharedMutex::lock() {
+  {
+    std::lock_guard lock(state_mutex_);
+    if (!writer_active_ && readers_ == 0) {
+      writer_active_ = true;
+      return;
+    }
+    writers_waiting_ += 1;
+  }
+  // WakeWaiters() marks this thread as the writer before releasing it.
+  writer_ready_.acquire();
+}
+
+bool SharedMutex::try_lock() {
+  std::lock_guard lock(state_mutex_);
+  if (writer_active_ || readers_ != 0) {
+    return false;
+  }
+  writer_active_ = true;
+  return true;
+}
+
+void SharedMutex::unlock() {
+  std::lock_guard lock(state_mutex_);
+  PW_DCHECK(writer_active_, "SharedMutex is not locked exclusively");
+  writer_active_ = false;
+  WakeWaiters();
+}
+
+void SharedMutex::lock_shared() {
+  {
+    std::lock_guard lock(state_mutex_);
+    if (ReaderMayLock()) {
+      readers_ += 1;
+      return;
+    }
+    readers_waiting_ += 1;
+  }
+  // WakeWaiters() counts this thread as a reader before releasing it.
+  readers_ready_.acquire();
+}
+
+bool SharedMutex::try_lock_shared() {
+  std::lock_guard lock(state_mutex_);
+  if (!ReaderMayLock()) {
+    return false;
+  }
+  readers_ += 1;
+  return true;
+}
+
+void SharedMutex::unlock_shared() {
+  std::lock_guard lock(state_mutex_);
+  PW_DCHECK_UINT_NE(readers_, 0u, "SharedMutex is not locked in shared mode");
+  readers_ -= 1;
+  if (readers_ == 0) {
+    WakeWaiters();
+  }
+}
+
+void SharedMutex::WakeWaiters() {
+  const bool wake_writer =
+      writers_waiting_ != 0 &&
+      (priority_ == Priority::kWriters || readers_waiting_ == 0);
+
+  if (wake_writer) {
+    writers_waiting_ -= 1;
+    writer_active_ = true;
+    writer_ready_.release();
+  } else if (readers_waiting_ != 0) {
+    // Admit every waiting reader at once.
+    readers_ += readers_waiting_;
+    readers_ready_.release(static_cast<ptrdiff_t>(readers_waiting_));
+    readers_waiting_ = 0;
+  }
+}
+
+}  // namespace pw::sync
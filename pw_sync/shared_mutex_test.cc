@@ -0,0 +1,87 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sync/shared_mutex.h"
+
+#include <mutex>
+#include <shared_mutex>
+
+#include "gtest/gtest.h"
+
+namespace pw::sync {
+namespace {
+
+// TODO(pwbug/291): Add real concurrency tests once we have pw::thread.
+
+TEST(SharedMutex, LockExclusive) {
+  SharedMutex mutex;
+  mutex.lock();
+  EXPECT_FALSE(mutex.try_lock());
+  EXPECT_FALSE(mutex.try_lock_shared());
+  mutex.unlock();
+
+  EXPECT_TRUE(mutex.try_lock());
+  mutex.unlock();
+}
+
+TEST(SharedMutex, LockShared_AllowsOtherReaders) {
+  SharedMutex mutex;
+  mutex.lock_shared();
+  EXPECT_TRUE(mutex.try_lock_shared());
+  EXPECT_FALSE(mutex.try_lock());
+
+  mutex.unlock_shared();
+  EXPECT_FALSE(mutex.try_lock());
+  mutex.unlock_shared();
+
+  EXPECT_TRUE(mutex.try_lock());
+  mutex.unlock();
+}
+
+TEST(SharedMutex, StandardLockTypes) {
+  SharedMutex mutex;
+  {
+    std::shared_lock first(mutex);
+    std::shared_lock second(mutex);
+    EXPECT_FALSE(mutex.try_lock());
+  }
+  {
+    std::lock_guard lock(mutex);
+    EXPECT_FALSE(mutex.try_lock_shared());
+  }
+  EXPECT_TRUE(mutex.try_lock_shared());
+  mutex.unlock_shared();
+}
+
+SharedMutex static_mutex;
+TEST(SharedMutex, LockStatic) {
+  static_mutex.lock_shared();
+  EXPECT_FALSE(static_mutex.try_lock());
+  static_mutex.unlock_shared();
+  static_mutex.lock();
+  static_mutex.unlock();
+}
+
+TEST(SharedMutex, ReaderPriority) {
+  SharedMutex mutex(SharedMutex::Priority::kReaders);
+  mutex.lock_shared();
+  EXPECT_TRUE(mutex.try_lock_shared());
+  mutex.unlock_shared();
+  mutex.unlock_shared();
+  EXPECT_TRUE(mutex.try_lock());
+  mutex.unlock();
+}
+
+}  // namespace
+}  // namespace pw::sync
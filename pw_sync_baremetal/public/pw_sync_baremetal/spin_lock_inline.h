@@ -13,23 +13,85 @@
 // the License.
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+
 #include "pw_assert/light.h"
 #include "pw_sync/spin_lock.h"
-#include "pw_sync/yield_core.h"
+
+#if defined(__ARM_ARCH_PROFILE) && __ARM_ARCH_PROFILE == 'M'
+#define _PW_SYNC_BAREMETAL_CORTEX_M 1
+#else
+#define _PW_SYNC_BAREMETAL_CORTEX_M 0
+#endif  // defined(__ARM_ARCH_PROFILE) && __ARM_ARCH_PROFILE == 'M'
 
 namespace pw::sync {
+namespace backend {
+
+// Masks interrupts and returns the previous mask. On Cortex-M this saves
+// PRIMASK and sets it with a single CPSID instruction. The memory clobber keeps
+// the compiler from moving accesses to the protected data out of the critical
+// section.
+inline uint32_t MaskInterrupts() {
+#if _PW_SYNC_BAREMETAL_CORTEX_M
+  uint32_t primask;
+  asm volatile(
+      "mrs %0, primask\n"
+      "cpsid i"
+      : "=r"(primask)
+      :
+      : "memory");
+  return primask;
+#else
+  // TODO(pwbug/303): Use the pw_interrupt API here to disable interrupts on
+  // other architectures.
+  return 0;
+#endif  // _PW_SYNC_BAREMETAL_CORTEX_M
+}
+
+// Restores the interrupt mask returned by MaskInterrupts().
+inline void RestoreInterrupts([[maybe_unused]] uint32_t mask) {
+#if _PW_SYNC_BAREMETAL_CORTEX_M
+  asm volatile("msr primask, %0" : : "r"(mask) : "memory");
+#endif  // _PW_SYNC_BAREMETAL_CORTEX_M
+}
+
+}  // namespace backend
 
-inline SpinLock::SpinLock() : native_type_() {}
+inline SpinLock::SpinLock()
+    : native_type_{.locked = false, .saved_interrupt_mask = 0} {}
 
+// Baremetal targets have a single core, so a held lock can never be released
+// while interrupts are masked; fail rather than deadlock.
 inline void SpinLock::lock() { PW_ASSERT(try_lock()); }
 
 inline bool SpinLock::try_lock() {
-  // TODO(pwbug/303): Use the pw_interrupt API here to disable interrupts.
-  return !native_type_.test_and_set(std::memory_order_acquire);
+  const uint32_t saved_interrupt_mask = backend::MaskInterrupts();
+
+#if _PW_SYNC_BAREMETAL_CORTEX_M
+  // With interrupts masked nothing else can run, so plain loads and stores
+  // suffice. This avoids the exclusive load and store retry loop of a
+  // read-modify-write, which ARMv6-M does not support at all.
+  if (native_type_.locked.load(std::memory_order_relaxed)) {
+    backend::RestoreInterrupts(saved_interrupt_mask);
+    return false;
+  }
+  native_type_.locked.store(true, std::memory_order_relaxed);
+#else
+  if (native_type_.locked.exchange(true, std::memory_order_acquire)) {
+    backend::RestoreInterrupts(saved_interrupt_mask);
+    return false;
+  }
+#endif  // _PW_SYNC_BAREMETAL_CORTEX_M
+
+  native_type_.saved_interrupt_mask = saved_interrupt_mask;
+  return true;
 }
 
 inline void SpinLock::unlock() {
-  native_type_.clear(std::memory_order_release);
+  const uint32_t saved_interrupt_mask = native_type_.saved_interrupt_mask;
+  native_type_.locked.store(false, std::memory_order_release);
+  backend::RestoreInterrupts(saved_interrupt_mask);
 }
 
 inline SpinLock::native_handle_type SpinLock::native_handle() {
@@ -37,3 +99,5 @@ inline SpinLock::native_handle_type SpinLock::native_handle() {
 }
 
 }  // namespace pw::sync
+
+#undef _PW_SYNC_BAREMETAL_CORTEX_M
@@ -14,10 +14,14 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 
 namespace pw::sync::backend {
 
-using NativeSpinLock = std::atomic_flag;
-using NativeSpinLockHandle = std::atomic_flag&;
+struct NativeSpinLock {
+  std::atomic<bool> locked;  // Used to detect recursion.
+  uint32_t saved_interrupt_mask;
+};
+using NativeSpinLockHandle = NativeSpinLock&;
 
 }  // namespace pw::sync::backend
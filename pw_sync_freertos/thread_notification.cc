@@ -0,0 +1,146 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sync/thread_notification.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "FreeRTOS.h"
+#include "pw_assert/assert.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_chrono_freertos/system_clock_constants.h"
+#include "pw_interrupt/context.h"
+#include "pw_sync/spin_lock.h"
+#include "task.h"
+
+using pw::chrono::SystemClock;
+using pw::chrono::freertos::kMaxTimeout;
+
+namespace pw::sync {
+namespace {
+
+// Guards the state of every ThreadNotification. The critical sections are only
+// a few instructions long, so one lock is shared rather than adding one to each
+// notification.
+SpinLock notification_lock;
+
+// Waits for a direct to task notification on notification index 0.
+bool WaitForNotification(TickType_t ticks) {
+  return ulTaskNotifyTake(pdTRUE, ticks) != 0;
+}
+
+}  // namespace
+
+void ThreadNotification::acquire() {
+  // Enforce the pw::sync::ThreadNotification IRQ contract.
+  PW_DCHECK(!interrupt::InInterruptContext());
+  {
+    std::lock_guard lock(notification_lock);
+    // Enforce that only one thread waits at a time.
+    PW_DCHECK(native_type_.blocked_thread == nullptr);
+    if (native_type_.notified) {
+      native_type_.notified = false;
+      return;
+    }
+    native_type_.blocked_thread = xTaskGetCurrentTaskHandle();
+  }
+
+#if INCLUDE_vTaskSuspend == 1  // This means portMAX_DELAY is indefinite.
+  const bool notified = WaitForNotification(portMAX_DELAY);
+  PW_DCHECK(notified);
+#else
+  // In case we need to block for longer than the FreeRTOS delay can represent
+  // repeatedly wait until notified.
+  while (!WaitForNotification(kMaxTimeout.count())) {
+  }
+#endif  // INCLUDE_vTaskSuspend
+}
+
+bool ThreadNotification::try_acquire() {
+  std::lock_guard lock(notification_lock);
+  const bool notified = native_type_.notified;
+  native_type_.notified = false;
+  return notified;
+}
+
+bool ThreadNotification::try_acquire_for(SystemClock::duration for_at_least) {
+  // Enforce the pw::sync::ThreadNotification IRQ contract.
+  PW_DCHECK(!interrupt::InInterruptContext());
+  {
+    std::lock_guard lock(notification_lock);
+    // Enforce that only one thread waits at a time.
+    PW_DCHECK(native_type_.blocked_thread == nullptr);
+    if (native_type_.notified) {
+      native_type_.notified = false;
+      return true;
+    }
+    native_type_.blocked_thread = xTaskGetCurrentTaskHandle();
+  }
+
+  // Clamp negative durations to be 0 which maps to non-blocking.
+  for_at_least = std::max(for_at_least, SystemClock::duration::zero());
+
+  while (for_at_least > kMaxTimeout) {
+    if (WaitForNotification(kMaxTimeout.count())) {
+      return true;
+    }
+    for_at_least -= kMaxTimeout;
+  }
+  if (WaitForNotification(for_at_least.count())) {
+    return true;
+  }
+
+  {
+    std::lock_guard lock(notification_lock);
+    if (native_type_.blocked_thread != nullptr) {
+      // Timed out without being released.
+      native_type_.blocked_thread = nullptr;
+      return false;
+    }
+  }
+
+  // release() notified the task after the wait timed out. Consume the pending
+  // notification so that it does not satisfy a later wait.
+  WaitForNotification(0);
+  return true;
+}
+
+void ThreadNotification::release() {
+  const bool in_interrupt = interrupt::InInterruptContext();
+  BaseType_t woke_higher_task = pdFALSE;
+  {
+    std::lock_guard lock(notification_lock);
+    if (native_type_.blocked_thread == nullptr) {
+      native_type_.notified = true;
+      return;
+    }
+
+    // Notify the task while holding the lock, so that a task that just timed
+    // out can consume the notification without blocking.
+    TaskHandle_t blocked_thread = native_type_.blocked_thread;
+    native_type_.blocked_thread = nullptr;
+    if (in_interrupt) {
+      vTaskNotifyGiveFromISR(blocked_thread, &woke_higher_task);
+    } else {  // Task context
+      xTaskNotifyGive(blocked_thread);
+    }
+  }
+
+  if (in_interrupt) {
+    portYIELD_FROM_ISR(woke_higher_task);
+  }
+}
+
+}  // namespace pw::sync
@@ -0,0 +1,85 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_assert/light.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_interrupt/context.h"
+#include "pw_sync/thread_notification.h"
+#include "tx_api.h"
+
+namespace pw::sync {
+namespace backend {
+
+inline constexpr char kThreadNotificationName[] = "pw::ThreadNotification";
+
+// The event flag that represents the notification.
+inline constexpr ULONG kThreadNotificationFlag = 1;
+
+}  // namespace backend
+
+inline ThreadNotification::ThreadNotification() : native_type_() {
+  PW_ASSERT(tx_event_flags_create(
+                &native_type_,
+                const_cast<char*>(backend::kThreadNotificationName)) ==
+            TX_SUCCESS);
+}
+
+inline ThreadNotification::~ThreadNotification() {
+  PW_ASSERT(tx_event_flags_delete(&native_type_) == TX_SUCCESS);
+}
+
+inline void ThreadNotification::release() {
+  // Setting a flag that is already set has no effect.
+  PW_ASSERT(tx_event_flags_set(&native_type_,
+                               backend::kThreadNotificationFlag,
+                               TX_OR) == TX_SUCCESS);
+}
+
+inline void ThreadNotification::acquire() {
+  // Enforce the pw::sync::ThreadNotification IRQ contract.
+  PW_DASSERT(!interrupt::InInterruptContext());
+  ULONG actual_flags;
+  PW_ASSERT(tx_event_flags_get(&native_type_,
+                               backend::kThreadNotificationFlag,
+                               TX_OR_CLEAR,
+                               &actual_flags,
+                               TX_WAIT_FOREVER) == TX_SUCCESS);
+}
+
+inline bool ThreadNotification::try_acquire() {
+  ULONG actual_flags;
+  const UINT result = tx_event_flags_get(&native_type_,
+                                         backend::kThreadNotificationFlag,
+                                         TX_OR_CLEAR,
+                                         &actual_flags,
+                                         TX_NO_WAIT);
+  if (result == TX_NO_EVENTS) {
+    return false;
+  }
+  PW_ASSERT(result == TX_SUCCESS);
+  return true;
+}
+
+inline bool ThreadNotification::try_acquire_until(
+    chrono::SystemClock::time_point until_at_least) {
+  return try_acquire_for(until_at_least - chrono::SystemClock::now());
+}
+
+inline ThreadNotification::native_handle_type
+ThreadNotification::native_handle() {
+  return native_type_;
+}
+
+}  // namespace pw::sync
@@ -84,28 +84,44 @@ Status WriteByte(std::byte b);
 // are returned as part of the StatusWithSize.
 StatusWithSize WriteLine(const std::string_view& s);
 
-// Fill a byte std::span from the sys io backend using ReadByte().
-// Implemented by: Facade
+// Fill a byte std::span from the sys io backend.
+// Implemented by: Backend, or the facade's default_putget_bytes library
 //
-// This function is implemented by this facade and simply uses ReadByte() to
-// read enough bytes to fill the destination span. If there's an error reading a
-// byte, the read is aborted and the contents of the destination span are
-// undefined. This function blocks until either an error occurs, or all bytes
-// are successfully read from the backend's ReadByte() implementation.
+// The default implementation in default_putget_bytes simply uses ReadByte() to
+// read enough bytes to fill the destination span. Backends may instead
+// implement this function directly, for example by reading a hardware FIFO or
+// using DMA, and then must not link default_putget_bytes. If there's an error
+// reading a byte, the read is aborted and the contents of the destination span
+// are undefined. This function blocks until either an error occurs, or all
+// bytes are successfully read from the backend.
 //
 // Return status is OkStatus() if the destination span was successfully
 // filled. In all cases, the number of bytes successuflly read to the
 // destination span are returned as part of the StatusWithSize.
 StatusWithSize ReadBytes(std::span<std::byte> dest);
 
-// Write std::span of bytes out the sys io backend using WriteByte().
-// Implemented by: Facade
+// Read the bytes that are available from the sys io backend, up to the size of
+// the destination span, without blocking.
+// Implemented by: Backend, or the facade's default_putget_bytes library
 //
-// This function is implemented by this facade and simply writes the source
-// contents using WriteByte(). If an error writing a byte is encountered, the
+// The default implementation calls TryReadByte() until no byte is available or
+// the destination span is full.
+//
+// Returns OkStatus() - At least one byte was read. The number of bytes read is
+//                      returned as part of the StatusWithSize.
+//         Status::Unavailable() - No bytes are available to read; try later.
+//         Status::Unimplemented() - Not supported on this target.
+StatusWithSize TryReadBytes(std::span<std::byte> dest);
+
+// Write std::span of bytes out the sys io backend.
+// Implemented by: Backend, or the facade's default_putget_bytes library
+//
+// The default implementation in default_putget_bytes simply writes the source
+// contents using WriteByte(). Backends may instead implement this function
+// directly, for example by filling a hardware FIFO or using DMA, and then must
+// not link default_putget_bytes. If an error writing a byte is encountered, the
 // write is aborted and the error status returned. This function blocks until
-// either an error occurs, or all bytes are successfully read from the backend's
-// WriteByte() implementation.
+// either an error occurs, or all bytes are successfully written to the backend.
 //
 // Return status is OkStatus() if all the bytes from the source span were
 // successfully written. In all cases, the number of bytes successfully written
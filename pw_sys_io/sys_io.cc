@@ -26,6 +26,20 @@ StatusWithSize ReadBytes(std::span<std::byte> dest) {
   return StatusWithSize(dest.size_bytes());
 }
 
+StatusWithSize TryReadBytes(std::span<std::byte> dest) {
+  for (size_t i = 0; i < dest.size_bytes(); ++i) {
+    Status result = TryReadByte(&dest[i]);
+    if (!result.ok()) {
+      // Running out of bytes after reading some is not an error.
+      if (i > 0u && result == Status::Unavailable()) {
+        return StatusWithSize(i);
+      }
+      return StatusWithSize(result, i);
+    }
+  }
+  return StatusWithSize(dest.size_bytes());
+}
+
 StatusWithSize WriteBytes(std::span<const std::byte> src) {
   for (size_t i = 0; i < src.size_bytes(); ++i) {
     Status result = WriteByte(src[i]);
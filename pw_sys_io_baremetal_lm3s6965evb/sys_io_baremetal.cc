@@ -25,14 +25,15 @@ constexpr uint32_t kSystemCoreClock = 12000000;
 
 // UART status flags.
 constexpr uint32_t kTxFifoEmptyMask = 0b10000000;
-constexpr uint32_t kTxFifoFullMask = 0b1000000;
-constexpr uint32_t kRxFifoFullMask = 0b100000;
+constexpr uint32_t kRxFifoFullMask = 0b1000000;
+constexpr uint32_t kTxFifoFullMask = 0b100000;
 constexpr uint32_t kRxFifoEmptyMask = 0b10000;
 constexpr uint32_t kTxBusyMask = 0b1000;
 
 // UART line control flags.
-// Default: 8n1
+// Default: 8n1 with the 16-byte transmit and receive FIFOs enabled.
 constexpr uint32_t kDefaultLineControl = 0x60;
+constexpr uint32_t kFifoEnableMask = 0x10;
 
 // UART control flags.
 constexpr uint32_t kUartEnableMask = 0x1;
@@ -79,7 +80,7 @@ extern "C" void pw_sys_io_Init() {
   }
   // Set baud rate.
   SetBaudRate(kSystemCoreClock, /*target_baud=*/115200);
-  uart0.line_control = kDefaultLineControl;
+  uart0.line_control = kDefaultLineControl | kFifoEnableMask;
   uart0.control |= kUartEnableMask;
 }
 
@@ -101,7 +102,7 @@ Status TryReadByte(std::byte* dest) {
     // Writing anything to this register clears all errors.
     uart0.receive_error = 0xff;
   }
-  if (!(uart0.status_flags & kRxFifoFullMask)) {
+  if (uart0.status_flags & kRxFifoEmptyMask) {
     return Status::Unavailable();
   }
   *dest = static_cast<std::byte>(uart0.data_register);
@@ -121,6 +122,43 @@ Status WriteByte(std::byte b) {
   return OkStatus();
 }
 
+// The span functions move bytes in bursts through the 16-byte FIFOs. Reads
+// drain every byte the receive FIFO holds, and writes fill the transmit FIFO
+// rather than waiting for it to empty after each byte.
+StatusWithSize ReadBytes(std::span<std::byte> dest) {
+  size_t bytes_read = 0;
+  while (bytes_read < dest.size_bytes()) {
+    const StatusWithSize result = TryReadBytes(dest.subspan(bytes_read));
+    bytes_read += result.size();
+  }
+  return StatusWithSize(bytes_read);
+}
+
+StatusWithSize TryReadBytes(std::span<std::byte> dest) {
+  if (uart0.receive_error) {
+    // Writing anything to this register clears all errors.
+    uart0.receive_error = 0xff;
+  }
+  size_t bytes_read = 0;
+  while (bytes_read < dest.size_bytes() &&
+         !(uart0.status_flags & kRxFifoEmptyMask)) {
+    dest[bytes_read++] = static_cast<std::byte>(uart0.data_register);
+  }
+  if (bytes_read == 0u && !dest.empty()) {
+    return StatusWithSize::Unavailable();
+  }
+  return StatusWithSize(bytes_read);
+}
+
+StatusWithSize WriteBytes(std::span<const std::byte> src) {
+  for (std::byte b : src) {
+    while (uart0.status_flags & kTxFifoFullMask) {
+    }
+    uart0.data_register = static_cast<uint32_t>(b);
+  }
+  return StatusWithSize(src.size_bytes());
+}
+
 // Writes a string using pw::sys_io, and add newline characters at the end.
 StatusWithSize WriteLine(const std::string_view& s) {
   size_t chars_written = 0;
@@ -200,6 +200,39 @@ Status WriteByte(std::byte b) {
   return OkStatus();
 }
 
+// USART1 has a single data register rather than a FIFO, so the span functions
+// still move one byte at a time. They poll the status register directly rather
+// than calling ReadByte() and WriteByte() for each byte, so the next byte is
+// ready as soon as the data register is.
+StatusWithSize ReadBytes(std::span<std::byte> dest) {
+  for (std::byte& b : dest) {
+    while (!(usart1.status & kReadDataReady)) {
+    }
+    b = static_cast<std::byte>(usart1.data_register);
+  }
+  return StatusWithSize(dest.size_bytes());
+}
+
+StatusWithSize TryReadBytes(std::span<std::byte> dest) {
+  size_t bytes_read = 0;
+  while (bytes_read < dest.size_bytes() && (usart1.status & kReadDataReady)) {
+    dest[bytes_read++] = static_cast<std::byte>(usart1.data_register);
+  }
+  if (bytes_read == 0u && !dest.empty()) {
+    return StatusWithSize::Unavailable();
+  }
+  return StatusWithSize(bytes_read);
+}
+
+StatusWithSize WriteBytes(std::span<const std::byte> src) {
+  for (std::byte b : src) {
+    while (!(usart1.status & kTxRegisterEmpty)) {
+    }
+    usart1.data_register = static_cast<uint32_t>(b);
+  }
+  return StatusWithSize(src.size_bytes());
+}
+
 // Writes a string using pw::sys_io, and add newline characters at the end.
 StatusWithSize WriteLine(const std::string_view& s) {
   size_t chars_written = 0;
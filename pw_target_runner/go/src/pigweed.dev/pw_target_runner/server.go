@@ -22,6 +22,7 @@ import (
 	"fmt"
 	"log"
 	"net"
+	"sync/atomic"
 	"time"
 
 	"google.golang.org/grpc"
@@ -76,6 +77,14 @@ func (s *Server) RegisterWorker(worker DeviceRunner) {
 	s.workerPool.RegisterWorker(worker)
 }
 
+// LoadTimingHistory loads the run times of executables from a file, which is
+// then updated as executables are run. The run times are used to start the
+// executables expected to take longest first, so a batch of executables spread
+// across the server's workers finishes sooner.
+func (s *Server) LoadTimingHistory(path string) error {
+	return s.workerPool.Timings().Load(path)
+}
+
 // RunBinary runs an executable through a worker in the server, returning
 // the worker's response. The function blocks until the executable has been
 // processed.
@@ -98,13 +107,56 @@ func (s *Server) RunBinary(path string) (*RunResponse, error) {
 		return nil, res.Err
 	}
 
+	s.recordResult(res)
+	return res, nil
+}
+
+// RunBinaries queues a batch of executables at once, so that the worker pool
+// can order all of them by expected run time, and calls handleResponse with
+// each worker's response as soon as it is available. The function blocks until
+// all of the executables have been processed or handleResponse returns an
+// error.
+func (s *Server) RunBinaries(
+	paths []string,
+	handleResponse func(*RunResponse) error,
+) error {
+	if !s.active {
+		return errServerNotRunning
+	}
+
+	// The channel holds every response so that workers never block on it,
+	// even if this function returns early.
+	resChan := make(chan *RunResponse, len(paths))
+
+	for _, path := range paths {
+		s.workerPool.QueueExecutable(&RunRequest{
+			Path:            path,
+			ResponseChannel: resChan,
+		})
+	}
+
+	for range paths {
+		res := <-resChan
+		if res.Err != nil {
+			return res.Err
+		}
+
+		s.recordResult(res)
+		if err := handleResponse(res); err != nil {
+			return err
+		}
+	}
+
+	return nil
+}
+
+// recordResult updates the server's task counters with a run's result.
+func (s *Server) recordResult(res *RunResponse) {
 	if res.Status == pb.RunStatus_SUCCESS {
-		s.tasksPassed++
+		atomic.AddUint32(&s.tasksPassed, 1)
 	} else {
-		s.tasksFailed++
+		atomic.AddUint32(&s.tasksFailed, 1)
 	}
-
-	return res, nil
 }
 
 // Serve starts the gRPC server on its configured port. Bind must have been
@@ -140,13 +192,34 @@ func (s *pwTargetRunnerService) RunBinary(
 		return nil, status.Error(codes.Internal, "Internal server error")
 	}
 
-	res := &pb.RunBinaryResponse{
+	return toRunBinaryResponse(runRes), nil
+}
+
+// RunBinaries runs a batch of executables on-device, streaming each result
+// back as soon as its executable has run.
+func (s *pwTargetRunnerService) RunBinaries(
+	desc *pb.RunBinariesRequest,
+	stream pb.TargetRunner_RunBinariesServer,
+) error {
+	err := s.server.RunBinaries(desc.FilePaths, func(runRes *RunResponse) error {
+		return stream.Send(toRunBinaryResponse(runRes))
+	})
+	if err != nil {
+		return status.Error(codes.Internal, "Internal server error")
+	}
+
+	return nil
+}
+
+// toRunBinaryResponse converts a worker's response to an RPC response.
+func toRunBinaryResponse(runRes *RunResponse) *pb.RunBinaryResponse {
+	return &pb.RunBinaryResponse{
 		Result:      runRes.Status,
 		QueueTimeNs: uint64(runRes.QueueTime),
 		RunTimeNs:   uint64(runRes.RunTime),
 		Output:      runRes.Output,
+		FilePath:    runRes.Path,
 	}
-	return res, nil
 }
 
 // Status returns information about the server.
@@ -156,8 +229,9 @@ func (s *pwTargetRunnerService) Status(
 ) (*pb.ServerStatus, error) {
 	resp := &pb.ServerStatus{
 		UptimeNs:    uint64(time.Since(s.server.startTime)),
-		TasksPassed: s.server.tasksPassed,
-		TasksFailed: s.server.tasksFailed,
+		TasksQueued: uint32(s.server.workerPool.QueueLength()),
+		TasksPassed: atomic.LoadUint32(&s.server.tasksPassed),
+		TasksFailed: atomic.LoadUint32(&s.server.tasksFailed),
 	}
 
 	return resp, nil
@@ -0,0 +1,116 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+package pw_target_runner
+
+import (
+	"encoding/json"
+	"io/ioutil"
+	"os"
+	"path/filepath"
+	"sync"
+	"time"
+)
+
+// TimingHistory records how long each executable has taken to run. The worker
+// pool uses it to estimate the run time of queued executables so that the
+// longest ones are started first.
+//
+// Each executable's estimate is an exponential moving average of its run
+// times, weighted toward recent runs so that the estimate follows changes to
+// the executable. Executables are identified by their path.
+type TimingHistory struct {
+	lock     sync.Mutex
+	runTimes map[string]time.Duration
+	path     string
+}
+
+// newTimingHistory creates an empty timing history which is not saved.
+func newTimingHistory() *TimingHistory {
+	return &TimingHistory{runTimes: make(map[string]time.Duration)}
+}
+
+// Load reads run times previously saved to a file, replacing any recorded
+// run times. Subsequent recorded run times are saved to the same file. A
+// missing file is not an error; it is created when a run time is recorded.
+func (h *TimingHistory) Load(path string) error {
+	h.lock.Lock()
+	defer h.lock.Unlock()
+
+	h.path = path
+	h.runTimes = make(map[string]time.Duration)
+
+	content, err := ioutil.ReadFile(path)
+	if os.IsNotExist(err) {
+		return nil
+	}
+	if err != nil {
+		return err
+	}
+
+	return json.Unmarshal(content, &h.runTimes)
+}
+
+// Estimate returns the expected run time of an executable, and false if the
+// executable has not been run before.
+func (h *TimingHistory) Estimate(path string) (time.Duration, bool) {
+	h.lock.Lock()
+	defer h.lock.Unlock()
+
+	runTime, ok := h.runTimes[path]
+	return runTime, ok
+}
+
+// Record adds a run time for an executable to the history, saving the history
+// if it was loaded from a file.
+func (h *TimingHistory) Record(path string, runTime time.Duration) error {
+	h.lock.Lock()
+	defer h.lock.Unlock()
+
+	if previous, ok := h.runTimes[path]; ok {
+		h.runTimes[path] = (previous + runTime) / 2
+	} else {
+		h.runTimes[path] = runTime
+	}
+
+	if h.path == "" {
+		return nil
+	}
+	return h.save()
+}
+
+// save writes the history to its file. The file is replaced atomically so that
+// an interrupted write does not lose the history.
+func (h *TimingHistory) save() error {
+	content, err := json.MarshalIndent(h.runTimes, "", "  ")
+	if err != nil {
+		return err
+	}
+
+	tmp, err := ioutil.TempFile(filepath.Dir(h.path), ".timing_history")
+	if err != nil {
+		return err
+	}
+	defer os.Remove(tmp.Name())
+
+	if _, err := tmp.Write(content); err != nil {
+		tmp.Close()
+		return err
+	}
+	if err := tmp.Close(); err != nil {
+		return err
+	}
+
+	return os.Rename(tmp.Name(), h.path)
+}
@@ -15,6 +15,7 @@
 package pw_target_runner
 
 import (
+	"container/heap"
 	"errors"
 	"fmt"
 	"log"
@@ -36,10 +37,59 @@ type RunRequest struct {
 
 	// Time when the request was queued. Internal to the worker pool.
 	queueStart time.Time
+
+	// Expected run time of the executable, from the pool's timing history.
+	// Internal to the worker pool.
+	expectedRunTime time.Duration
+
+	// Whether the executable has a timing history. Internal to the worker
+	// pool.
+	hasEstimate bool
+
+	// Order in which the request was queued. Internal to the worker pool.
+	sequence uint64
+}
+
+// runQueue is a priority queue of run requests, implementing heap.Interface.
+// Executables without a timing history come first, as they may be long and
+// running them early gives them the most time to finish. The rest are ordered
+// by expected run time, longest first, so that short executables fill in the
+// gaps between long ones at the end of a batch. Requests with equal priority
+// are run in the order they were queued.
+type runQueue []*RunRequest
+
+func (q runQueue) Len() int { return len(q) }
+
+func (q runQueue) Less(i, j int) bool {
+	a, b := q[i], q[j]
+	if a.hasEstimate != b.hasEstimate {
+		return !a.hasEstimate
+	}
+	if a.expectedRunTime != b.expectedRunTime {
+		return a.expectedRunTime > b.expectedRunTime
+	}
+	return a.sequence < b.sequence
+}
+
+func (q runQueue) Swap(i, j int) { q[i], q[j] = q[j], q[i] }
+
+func (q *runQueue) Push(x interface{}) { *q = append(*q, x.(*RunRequest)) }
+
+func (q *runQueue) Pop() interface{} {
+	old := *q
+	n := len(old)
+	req := old[n-1]
+	old[n-1] = nil
+	*q = old[:n-1]
+	return req
 }
 
 // RunResponse is the response sent after a run request is processed.
 type RunResponse struct {
+	// Filesystem path to the executable that was run. Set by the worker
+	// pool.
+	Path string
+
 	// Length of time that the run request was queued before being handled
 	// by a worker. Set by the worker pool.
 	QueueTime time.Duration
@@ -78,14 +128,22 @@ type DeviceRunner interface {
 
 // WorkerPool represents a collection of device runners which run on-device
 // binaries. The worker pool distributes requests to run binaries among its
-// available workers.
+// available workers, starting the executables expected to take longest first.
+// Run times are recorded in the pool's timing history.
 type WorkerPool struct {
 	activeWorkers uint32
 	logger        *log.Logger
 	workers       []DeviceRunner
 	waitGroup     sync.WaitGroup
-	reqChannel    chan *RunRequest
-	quitChannel   chan bool
+	timings       *TimingHistory
+
+	// Guards the fields below; cond is signaled when a request is queued
+	// or the pool is stopping.
+	lock     sync.Mutex
+	cond     *sync.Cond
+	queue    runQueue
+	sequence uint64
+	stopping bool
 }
 
 var (
@@ -96,12 +154,13 @@ var (
 // newWorkerPool creates an empty worker pool.
 func newWorkerPool(name string) *WorkerPool {
 	logPrefix := fmt.Sprintf("[%s] ", name)
-	return &WorkerPool{
-		logger:      log.New(os.Stdout, logPrefix, log.LstdFlags),
-		workers:     make([]DeviceRunner, 0),
-		reqChannel:  make(chan *RunRequest, 1024),
-		quitChannel: make(chan bool, 64),
+	p := &WorkerPool{
+		logger:  log.New(os.Stdout, logPrefix, log.LstdFlags),
+		workers: make([]DeviceRunner, 0),
+		timings: newTimingHistory(),
 	}
+	p.cond = sync.NewCond(&p.lock)
+	return p
 }
 
 // RegisterWorker adds a new worker to the pool. This cannot be done when the
@@ -138,12 +197,18 @@ func (p *WorkerPool) Stop() {
 		return
 	}
 
-	// Send N quit commands to the workers and wait for them to exit.
-	for i := uint32(0); i < p.activeWorkers; i++ {
-		p.quitChannel <- true
-	}
+	// Wake all of the workers and wait for them to exit.
+	p.lock.Lock()
+	p.stopping = true
+	p.cond.Broadcast()
+	p.lock.Unlock()
+
 	p.waitGroup.Wait()
 
+	p.lock.Lock()
+	p.stopping = false
+	p.lock.Unlock()
+
 	p.logger.Println("All workers in pool stopped")
 }
 
@@ -152,6 +217,18 @@ func (p *WorkerPool) Active() bool {
 	return p.activeWorkers > 0
 }
 
+// Timings returns the pool's timing history.
+func (p *WorkerPool) Timings() *TimingHistory {
+	return p.timings
+}
+
+// QueueLength returns the number of requests waiting for a worker.
+func (p *WorkerPool) QueueLength() int {
+	p.lock.Lock()
+	defer p.lock.Unlock()
+	return len(p.queue)
+}
+
 // QueueExecutable adds an executable to the worker pool's queue. If no workers
 // are registered in the pool, this operation fails and an immediate response is
 // sent back to the requester indicating the error.
@@ -164,11 +241,39 @@ func (p *WorkerPool) QueueExecutable(req *RunRequest) {
 		return
 	}
 
-	p.logger.Printf("Queueing executable %s\n", req.Path)
+	req.expectedRunTime, req.hasEstimate = p.timings.Estimate(req.Path)
+	if req.hasEstimate {
+		p.logger.Printf("Queueing executable %s (expected to run in %v)\n",
+			req.Path, req.expectedRunTime)
+	} else {
+		p.logger.Printf("Queueing executable %s\n", req.Path)
+	}
+
+	p.lock.Lock()
+	defer p.lock.Unlock()
 
 	// Start tracking how long the request is queued.
 	req.queueStart = time.Now()
-	p.reqChannel <- req
+	req.sequence = p.sequence
+	p.sequence++
+	heap.Push(&p.queue, req)
+	p.cond.Signal()
+}
+
+// nextRequest blocks until a request is queued, and removes the highest
+// priority request from the queue. Returns nil if the pool is stopping; the
+// queue is processed only while the pool is not stopping.
+func (p *WorkerPool) nextRequest() *RunRequest {
+	p.lock.Lock()
+	defer p.lock.Unlock()
+
+	for !p.stopping && len(p.queue) == 0 {
+		p.cond.Wait()
+	}
+	if p.stopping {
+		return nil
+	}
+	return heap.Pop(&p.queue).(*RunRequest)
 }
 
 // runWorker is a function run by the worker pool in a separate goroutine for
@@ -185,39 +290,28 @@ func (p *WorkerPool) runWorker(worker DeviceRunner) {
 		return
 	}
 
-processLoop:
 	for {
-		// Force the quit channel to be processed before the request
-		// channel by using a select statement with an empty default
-		// case to make the read non-blocking. If the quit channel is
-		// empty, the code will fall through to the main select below.
-		select {
-		case q, ok := <-p.quitChannel:
-			if q || !ok {
-				break processLoop
-			}
-		default:
+		req := p.nextRequest()
+		if req == nil {
+			break
 		}
 
-		select {
-		case q, ok := <-p.quitChannel:
-			if q || !ok {
-				break processLoop
-			}
-		case req, ok := <-p.reqChannel:
-			if !ok {
-				continue
-			}
+		queueTime := time.Since(req.queueStart)
 
-			queueTime := time.Since(req.queueStart)
+		runStart := time.Now()
+		res := worker.HandleRunRequest(req)
+		res.RunTime = time.Since(runStart)
 
-			runStart := time.Now()
-			res := worker.HandleRunRequest(req)
-			res.RunTime = time.Since(runStart)
+		res.Path = req.Path
+		res.QueueTime = queueTime
 
-			res.QueueTime = queueTime
-			req.ResponseChannel <- res
+		if res.Err == nil && res.Status != pb.RunStatus_SKIPPED {
+			if err := p.timings.Record(req.Path, res.RunTime); err != nil {
+				p.logger.Printf("Failed to save timing history: %v\n", err)
+			}
 		}
+
+		req.ResponseChannel <- res
 	}
 
 	worker.WorkerExit()
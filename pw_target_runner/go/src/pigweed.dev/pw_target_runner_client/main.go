@@ -18,6 +18,7 @@ import (
 	"errors"
 	"flag"
 	"fmt"
+	"io"
 	"log"
 	"path/filepath"
 	"time"
@@ -65,6 +66,59 @@ func (c *Client) RunBinary(path string) error {
 		return err
 	}
 
+	printResponse(path, res)
+
+	if res.Result != pb.RunStatus_SUCCESS {
+		return errors.New("Binary run was unsuccessful")
+	}
+
+	return nil
+}
+
+// RunBinaries sends a RunBinaries RPC to the target runner service, printing
+// each result as the server streams it back.
+func (c *Client) RunBinaries(paths []string) error {
+	req := &pb.RunBinariesRequest{}
+	for _, path := range paths {
+		abspath, err := filepath.Abs(path)
+		if err != nil {
+			return err
+		}
+		req.FilePaths = append(req.FilePaths, abspath)
+	}
+
+	client := pb.NewTargetRunnerClient(c.conn)
+	stream, err := client.RunBinaries(context.Background(), req)
+	if err != nil {
+		return err
+	}
+
+	failures := 0
+	for {
+		res, err := stream.Recv()
+		if err == io.EOF {
+			break
+		}
+		if err != nil {
+			return err
+		}
+
+		printResponse(res.FilePath, res)
+		if res.Result != pb.RunStatus_SUCCESS {
+			failures++
+		}
+	}
+
+	if failures != 0 {
+		return fmt.Errorf("%d of %d binary runs were unsuccessful",
+			failures, len(paths))
+	}
+
+	return nil
+}
+
+// printResponse prints the result of running a binary.
+func printResponse(path string, res *pb.RunBinaryResponse) {
 	fmt.Printf("%s\n", path)
 	fmt.Printf(
 		"Queued for %v, ran in %v\n\n",
@@ -72,12 +126,6 @@ func (c *Client) RunBinary(path string) error {
 		time.Duration(res.RunTimeNs),
 	)
 	fmt.Println(string(res.Output))
-
-	if res.Result != pb.RunStatus_SUCCESS {
-		return errors.New("Binary run was unsuccessful")
-	}
-
-	return nil
 }
 
 func main() {
@@ -87,7 +135,14 @@ func main() {
 
 	flag.Parse()
 
-	if *pathPtr == "" {
+	// Any positional arguments are additional binaries, which are sent to
+	// the server as a single batch.
+	paths := flag.Args()
+	if *pathPtr != "" {
+		paths = append([]string{*pathPtr}, paths...)
+	}
+
+	if len(paths) == 0 {
 		log.Fatalf("Must provide -binary option")
 	}
 
@@ -96,7 +151,13 @@ func main() {
 		log.Fatalf("Failed to create gRPC client: %v", err)
 	}
 
-	if err := cli.RunBinary(*pathPtr); err != nil {
+	if len(paths) == 1 {
+		err = cli.RunBinary(paths[0])
+	} else {
+		err = cli.RunBinaries(paths)
+	}
+
+	if err != nil {
 		log.Println("Failed to run executable on target:")
 		log.Println("")
 
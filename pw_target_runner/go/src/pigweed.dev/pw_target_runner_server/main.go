@@ -51,6 +51,13 @@ func configureServerFromFile(s *pw_target_runner.Server, filepath string) error
 
 	log.Printf("Parsed server configuration from %s\n", filepath)
 
+	if history := config.GetTimingHistoryFile(); history != "" {
+		if err := s.LoadTimingHistory(history); err != nil {
+			return err
+		}
+		log.Printf("Loaded timing history from %s\n", history)
+	}
+
 	runners := config.GetRunner()
 	if runners == nil {
 		return nil
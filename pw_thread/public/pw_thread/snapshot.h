@@ -0,0 +1,60 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "pw_status/status_with_size.h"
+#include "pw_thread/id.h"
+
+namespace pw::thread {
+
+// The state of one thread when a snapshot was taken. Fields the backend or its
+// RTOS configuration cannot provide are empty.
+struct ThreadSnapshot {
+  // The thread's name, which points into the thread's control block and is
+  // only valid while the thread exists. nullptr if the thread has no name.
+  const char* name;
+
+  Id id;
+
+  // How long the thread has run, in ticks of the backend's run-time counter.
+  // The thread's CPU load between two snapshots is the change in its run_time
+  // divided by the change in TotalRunTime().
+  std::optional<uint64_t> run_time;
+
+  std::optional<size_t> stack_size_bytes;
+
+  // The least free stack the thread has had, which is its stack's high-water
+  // mark. A thread with plenty of free stack left may be given a smaller one.
+  std::optional<size_t> stack_min_free_bytes;
+};
+
+// Takes a snapshot of every thread, for finding CPU-hungry threads and sizing
+// stacks. Returns the number of snapshots filled in. Returns RESOURCE_EXHAUSTED
+// if there are more threads than snapshots, with as many snapshots as fit.
+//
+// This is thread safe, not IRQ safe. Backends may stop scheduling or mask
+// interrupts while measuring stacks, so this is meant for diagnostics, not for
+// time critical code.
+StatusWithSize SnapshotThreads(std::span<ThreadSnapshot> snapshots);
+
+// The backend's run-time counter, against which ThreadSnapshot::run_time is
+// measured, or an empty optional if run times are not available.
+std::optional<uint64_t> TotalRunTime();
+
+}  // namespace pw::thread
@@ -0,0 +1,126 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_thread/id.h"
+#include "pw_thread_backend/thread_native.h"
+
+// Backends which can wait for a thread to finish set this to 1 and provide
+// Thread::join().
+#ifndef PW_THREAD_JOINING_ENABLED
+#define PW_THREAD_JOINING_ENABLED 0
+#endif  // PW_THREAD_JOINING_ENABLED
+
+namespace pw::thread {
+
+// The Options contain the parameters needed for a thread to start, such as its
+// priority, stack, and core affinity.
+//
+// Options are backend specific and ergo the generic base class cannot be
+// directly instantiated. Each backend provides its own Options, such as
+// pw::thread::freertos::Options, which derives from this class. Code which
+// creates threads must therefore know which backend it is built with, while
+// code which runs on threads, such as a ThreadCore, does not.
+class Options {
+ protected:
+  constexpr Options() = default;
+};
+
+// The ThreadCore is an interface for an object which a thread runs, as an
+// alternative to a static function and argument. For example, a WorkQueue is a
+// ThreadCore.
+class ThreadCore {
+ public:
+  virtual ~ThreadCore() = default;
+
+  // Runs the object's work on the current thread.
+  void Start() { Run(); }
+
+ private:
+  friend class Thread;
+
+  static void Entry(void* thread_core) {
+    static_cast<ThreadCore*>(thread_core)->Start();
+  }
+
+  virtual void Run() = 0;
+};
+
+// The Thread is a handle to a thread of execution, modeled after std::thread.
+//
+// A thread starts running immediately after the Thread is constructed, at the
+// point set by the backend's scheduler. Before the Thread is destroyed or
+// assigned to, the thread must be detached or, if PW_THREAD_JOINING_ENABLED,
+// joined.
+//
+// Unlike std::thread, the thread's storage is not allocated dynamically; the
+// backend's Options say where its stack and control block live.
+class Thread {
+ public:
+  using native_handle_type = backend::NativeThreadHandle;
+  using ThreadRoutine = void (*)(void* arg);
+
+  // Creates a Thread which does not represent a thread of execution.
+  Thread();
+
+  // Creates a thread which runs entry(arg) with the given options, which must
+  // be the backend's Options type.
+  Thread(const Options& options, ThreadRoutine entry, void* arg = nullptr);
+
+  // Creates a thread which runs thread_core.Start() with the given options,
+  // which must be the backend's Options type.
+  Thread(const Options& options, ThreadCore& thread_core)
+      : Thread(options, ThreadCore::Entry, &thread_core) {}
+
+  // Takes over the thread represented by other, which then represents no
+  // thread. This Thread must not represent a thread.
+  Thread& operator=(Thread&& other);
+
+  // This Thread must not represent a thread.
+  ~Thread();
+
+  Thread(const Thread&) = delete;
+  Thread(Thread&&) = delete;
+  Thread& operator=(const Thread&) = delete;
+
+  // Returns the ID of the thread, or Id() if this Thread does not represent a
+  // thread.
+  Id get_id() const;
+
+  // Returns whether this Thread represents a thread which has not been joined
+  // or detached.
+  bool joinable() const { return get_id() != Id(); }
+
+#if PW_THREAD_JOINING_ENABLED
+  // Blocks until the thread finishes. Afterwards this Thread represents no
+  // thread.
+  void join();
+#endif  // PW_THREAD_JOINING_ENABLED
+
+  // Lets the thread run on its own. Afterwards this Thread represents no
+  // thread. The thread's storage remains in use until the thread finishes.
+  void detach();
+
+  // Exchanges the threads represented by this Thread and other.
+  void swap(Thread& other);
+
+  native_handle_type native_handle();
+
+ private:
+  backend::NativeThread native_type_;
+};
+
+}  // namespace pw::thread
+
+#include "pw_thread_backend/thread_inline.h"
@@ -0,0 +1,114 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_metric/metric.h"
+#include "pw_status/status.h"
+#include "pw_sync/spin_lock.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/thread.h"
+
+namespace pw::thread {
+
+// A function to run on a WorkQueue's thread, and the argument to pass it.
+struct WorkItem {
+  void (*function)(void* arg);
+  void* arg;
+};
+
+// The WorkQueue runs deferred work on a dedicated thread, so that threads which
+// must respond quickly can hand off slow work, such as flushing logs, draining
+// trace buffers, or compacting a key-value store.
+//
+// Work is queued in a fixed-capacity buffer and run in the order it was queued.
+// PushWork() is IRQ safe and never blocks, so work may be queued from
+// interrupts. The WorkQueue is a ThreadCore; start it on a thread with the
+// backend's Options:
+//
+//   pw::thread::WorkQueueWithBuffer<10> work_queue;
+//
+//   pw::thread::Thread(options, work_queue).detach();
+//   work_queue.PushWork(FlushLogs, &log_buffer);
+//
+// Metrics:
+//   max_queue_used - The most work items that were queued at once.
+//   rejected_work - Work items that PushWork() did not queue.
+//
+class WorkQueue : public ThreadCore {
+ public:
+  explicit WorkQueue(std::span<WorkItem> queue_storage)
+      : queue_(queue_storage) {}
+
+  WorkQueue(const WorkQueue&) = delete;
+  WorkQueue& operator=(const WorkQueue&) = delete;
+
+  // Queues function(arg) to run on the work queue's thread. Returns
+  // RESOURCE_EXHAUSTED if the queue is full, or FAILED_PRECONDITION if
+  // RequestStop() was called. This is IRQ safe.
+  Status PushWork(void (*function)(void* arg), void* arg = nullptr);
+
+  // Asks the work queue's thread to return once all queued work has run.
+  // Work cannot be queued afterwards. This is IRQ safe.
+  void RequestStop();
+
+  // The number of queued work items, not including any being run.
+  size_t size() const;
+
+  size_t capacity() const { return queue_.size(); }
+
+  metric::Group& metrics() { return metrics_; }
+  const metric::Group& metrics() const { return metrics_; }
+
+  uint32_t max_queue_used() const { return max_queue_used_.value(); }
+  uint32_t rejected_work() const { return rejected_work_.value(); }
+
+ private:
+  // Runs queued work until RequestStop() is called and the queue is empty.
+  void Run() override;
+
+  // Removes the oldest work item from the queue. Returns false if the queue is
+  // empty.
+  bool PopWork(WorkItem& item);
+
+  std::span<WorkItem> queue_;
+
+  // Wakes the work queue's thread when work is queued or a stop is requested.
+  sync::ThreadNotification work_notification_;
+
+  mutable sync::SpinLock lock_;
+  size_t head_ = 0;
+  size_t count_ = 0;
+  bool stop_requested_ = false;
+
+  PW_METRIC_GROUP(metrics_, "work_queue");
+  PW_METRIC(metrics_, max_queue_used_, "max_queue_used", 0u);
+  PW_METRIC(metrics_, rejected_work_, "rejected_work", 0u);
+};
+
+// A WorkQueue with an internal buffer for kCapacity work items.
+template <size_t kCapacity>
+class WorkQueueWithBuffer final : public WorkQueue {
+ public:
+  WorkQueueWithBuffer() : WorkQueue(queue_storage_) {}
+
+ private:
+  std::array<WorkItem, kCapacity> queue_storage_;
+};
+
+}  // namespace pw::thread
@@ -0,0 +1,78 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/snapshot.h"
+
+#include <array>
+
+#include "gtest/gtest.h"
+#include "pw_thread/id.h"
+
+namespace pw::thread {
+namespace {
+
+// Room for the test thread and any threads the RTOS itself runs.
+constexpr size_t kMaxThreads = 32;
+
+TEST(Snapshot, IncludesCurrentThread) {
+  std::array<ThreadSnapshot, kMaxThreads> snapshots;
+  const StatusWithSize result = SnapshotThreads(snapshots);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_GT(result.size(), 0u);
+
+  const ThreadSnapshot* current = nullptr;
+  for (size_t i = 0; i < result.size(); ++i) {
+    const ThreadSnapshot& snapshot = snapshots[i];
+    EXPECT_NE(Id(), snapshot.id);
+    if (snapshot.stack_size_bytes.has_value() &&
+        snapshot.stack_min_free_bytes.has_value()) {
+      EXPECT_LE(snapshot.stack_min_free_bytes.value(),
+                snapshot.stack_size_bytes.value());
+    }
+    if (snapshot.id == this_thread::get_id()) {
+      current = &snapshot;
+    }
+  }
+  ASSERT_NE(nullptr, current);
+
+  // This thread is running, so its stack cannot be entirely unused.
+  if (current->stack_size_bytes.has_value() &&
+      current->stack_min_free_bytes.has_value()) {
+    EXPECT_LT(current->stack_min_free_bytes.value(),
+              current->stack_size_bytes.value());
+  }
+}
+
+TEST(Snapshot, TooManyThreads) {
+  std::array<ThreadSnapshot, 0> snapshots;
+  const StatusWithSize result = SnapshotThreads(snapshots);
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(0u, result.size());
+}
+
+TEST(Snapshot, RunTimeIncreases) {
+  const std::optional<uint64_t> before = TotalRunTime();
+  std::array<ThreadSnapshot, kMaxThreads> snapshots;
+  ASSERT_EQ(OkStatus(), SnapshotThreads(snapshots).status());
+  const std::optional<uint64_t> after = TotalRunTime();
+
+  ASSERT_EQ(before.has_value(), after.has_value());
+  if (after.has_value()) {
+    EXPECT_LE(before.value(), after.value());
+    EXPECT_TRUE(snapshots[0].run_time.has_value());
+  }
+}
+
+}  // namespace
+}  // namespace pw::thread
@@ -0,0 +1,120 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <chrono>
+
+#include "gtest/gtest.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/id.h"
+#include "pw_thread/sleep.h"
+#include "pw_thread/test_threads.h"
+#include "pw_thread/thread.h"
+
+using pw::chrono::SystemClock;
+using pw::thread::test::TestOptionsThread0;
+using pw::thread::test::TestOptionsThread1;
+using namespace std::chrono_literals;
+
+namespace pw::thread {
+namespace {
+
+// Notifications are global so they outlive the threads which release them.
+sync::ThreadNotification thread_0_done;
+sync::ThreadNotification thread_1_done;
+
+void ReleaseNotification(void* notification) {
+  static_cast<sync::ThreadNotification*>(notification)->release();
+}
+
+// Waits until a thread which released done has finished, so that its test
+// options may be used again.
+void WaitUntilFinished(Thread& thread, sync::ThreadNotification& done) {
+  done.acquire();
+#if PW_THREAD_JOINING_ENABLED
+  thread.join();
+#else
+  thread.detach();
+  // The thread may not have returned yet. Give it time to.
+  this_thread::sleep_for(std::chrono::ceil<SystemClock::duration>(10ms));
+#endif  // PW_THREAD_JOINING_ENABLED
+  EXPECT_FALSE(thread.joinable());
+}
+
+TEST(Thread, DefaultIds) {
+  Thread not_executing_thread;
+  EXPECT_EQ(not_executing_thread.get_id(), Id());
+  EXPECT_FALSE(not_executing_thread.joinable());
+}
+
+TEST(Thread, RunsRoutine) {
+  Thread thread(TestOptionsThread0(), ReleaseNotification, &thread_0_done);
+  EXPECT_TRUE(thread.joinable());
+  EXPECT_NE(thread.get_id(), Id());
+  EXPECT_NE(thread.get_id(), this_thread::get_id());
+  WaitUntilFinished(thread, thread_0_done);
+}
+
+TEST(Thread, ReusesOptionsAfterThreadFinishes) {
+  for (int i = 0; i < 3; ++i) {
+    Thread thread(TestOptionsThread0(), ReleaseNotification, &thread_0_done);
+    WaitUntilFinished(thread, thread_0_done);
+  }
+}
+
+TEST(Thread, RunsTwoThreads) {
+  Thread thread_0(TestOptionsThread0(), ReleaseNotification, &thread_0_done);
+  Thread thread_1(TestOptionsThread1(), ReleaseNotification, &thread_1_done);
+  EXPECT_NE(thread_0.get_id(), thread_1.get_id());
+  WaitUntilFinished(thread_0, thread_0_done);
+  WaitUntilFinished(thread_1, thread_1_done);
+}
+
+TEST(Thread, SwapAndMoveAssign) {
+  Thread thread_0(TestOptionsThread0(), ReleaseNotification, &thread_0_done);
+  const Id id = thread_0.get_id();
+
+  Thread thread_1;
+  thread_1.swap(thread_0);
+  EXPECT_FALSE(thread_0.joinable());
+  EXPECT_EQ(id, thread_1.get_id());
+
+  thread_0 = std::move(thread_1);
+  EXPECT_FALSE(thread_1.joinable());
+  EXPECT_EQ(id, thread_0.get_id());
+  WaitUntilFinished(thread_0, thread_0_done);
+}
+
+class NotifyingCore : public ThreadCore {
+ public:
+  bool ran() const { return ran_; }
+
+ private:
+  void Run() override {
+    ran_ = true;
+    thread_0_done.release();
+  }
+
+  bool ran_ = false;
+};
+
+TEST(Thread, RunsThreadCore) {
+  NotifyingCore core;
+  Thread thread(TestOptionsThread0(), core);
+  WaitUntilFinished(thread, thread_0_done);
+  EXPECT_TRUE(core.ran());
+}
+
+}  // namespace
+}  // namespace pw::thread
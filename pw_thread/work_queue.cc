@@ -0,0 +1,86 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/work_queue.h"
+
+#include <mutex>
+
+namespace pw::thread {
+
+Status WorkQueue::PushWork(void (*function)(void* arg), void* arg) {
+  {
+    std::lock_guard lock(lock_);
+    if (stop_requested_) {
+      rejected_work_.Increment();
+      return Status::FailedPrecondition();
+    }
+    if (count_ == queue_.size()) {
+      rejected_work_.Increment();
+      return Status::ResourceExhausted();
+    }
+
+    queue_[(head_ + count_) % queue_.size()] = {function, arg};
+    count_ += 1;
+    if (count_ > max_queue_used_.value()) {
+      max_queue_used_.Set(static_cast<uint32_t>(count_));
+    }
+  }
+  work_notification_.release();
+  return OkStatus();
+}
+
+void WorkQueue::RequestStop() {
+  {
+    std::lock_guard lock(lock_);
+    stop_requested_ = true;
+  }
+  work_notification_.release();
+}
+
+size_t WorkQueue::size() const {
+  std::lock_guard lock(lock_);
+  return count_;
+}
+
+bool WorkQueue::PopWork(WorkItem& item) {
+  std::lock_guard lock(lock_);
+  if (count_ == 0) {
+    return false;
+  }
+  item = queue_[head_];
+  head_ = (head_ + 1) % queue_.size();
+  count_ -= 1;
+  return true;
+}
+
+void WorkQueue::Run() {
+  while (true) {
+    work_notification_.acquire();
+
+    // Work is run without holding the lock, so more may be queued meanwhile.
+    // Keep going until the queue is empty rather than waiting for another
+    // notification for each item.
+    WorkItem item;
+    while (PopWork(item)) {
+      item.function(item.arg);
+    }
+
+    std::lock_guard lock(lock_);
+    if (stop_requested_ && count_ == 0) {
+      return;
+    }
+  }
+}
+
+}  // namespace pw::thread
@@ -0,0 +1,143 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/work_queue.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+#include "gtest/gtest.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/sleep.h"
+#include "pw_thread/test_threads.h"
+#include "pw_thread/thread.h"
+
+using pw::chrono::SystemClock;
+using namespace std::chrono_literals;
+
+namespace pw::thread {
+namespace {
+
+// Records the order in which work items ran.
+struct Recorder {
+  static void Record(void* arg) {
+    WorkItemArg& item = *static_cast<WorkItemArg*>(arg);
+    item.recorder->order[item.recorder->count++] = item.value;
+  }
+
+  struct WorkItemArg {
+    Recorder* recorder;
+    int value;
+  };
+
+  std::array<int, 8> order = {};
+  size_t count = 0;
+};
+
+TEST(WorkQueue, PushWork_RejectsWhenFull) {
+  WorkQueueWithBuffer<2> work_queue;
+  Recorder recorder;
+  Recorder::WorkItemArg arg = {&recorder, 1};
+  EXPECT_EQ(2u, work_queue.capacity());
+
+  EXPECT_EQ(OkStatus(), work_queue.PushWork(Recorder::Record, &arg));
+  EXPECT_EQ(OkStatus(), work_queue.PushWork(Recorder::Record, &arg));
+  EXPECT_EQ(Status::ResourceExhausted(),
+            work_queue.PushWork(Recorder::Record, &arg));
+  EXPECT_EQ(2u, work_queue.size());
+  EXPECT_EQ(2u, work_queue.max_queue_used());
+  EXPECT_EQ(1u, work_queue.rejected_work());
+  EXPECT_EQ(0u, recorder.count);
+}
+
+TEST(WorkQueue, RequestStop_RejectsWork) {
+  WorkQueueWithBuffer<2> work_queue;
+  Recorder recorder;
+  Recorder::WorkItemArg arg = {&recorder, 1};
+
+  work_queue.RequestStop();
+  EXPECT_EQ(Status::FailedPrecondition(),
+            work_queue.PushWork(Recorder::Record, &arg));
+  EXPECT_EQ(0u, work_queue.size());
+  EXPECT_EQ(1u, work_queue.rejected_work());
+}
+
+struct QueueMoreWork {
+  static void Run(void* arg) {
+    QueueMoreWork& self = *static_cast<QueueMoreWork*>(arg);
+    self.status = self.work_queue->PushWork(Recorder::Record, self.arg);
+    self.work_queue->RequestStop();
+  }
+
+  WorkQueue* work_queue;
+  Recorder::WorkItemArg* arg;
+  Status status;
+};
+
+TEST(WorkQueue, Start_RunsQueuedWorkInOrderThenStops) {
+  WorkQueueWithBuffer<2> work_queue;
+  Recorder recorder;
+  Recorder::WorkItemArg args[] = {{&recorder, 1}, {&recorder, 2}};
+  QueueMoreWork queue_more = {&work_queue, &args[1], Status::Unknown()};
+
+  ASSERT_EQ(OkStatus(), work_queue.PushWork(Recorder::Record, &args[0]));
+  ASSERT_EQ(OkStatus(), work_queue.PushWork(QueueMoreWork::Run, &queue_more));
+
+  // Run the queue on this thread. The work queued while running wraps around
+  // the end of the queue, and runs before Start() returns.
+  work_queue.Start();
+  EXPECT_EQ(OkStatus(), queue_more.status);
+  ASSERT_EQ(2u, recorder.count);
+  EXPECT_EQ(1, recorder.order[0]);
+  EXPECT_EQ(2, recorder.order[1]);
+  EXPECT_EQ(0u, work_queue.size());
+}
+
+// Global so that it outlives the work queue's thread.
+sync::ThreadNotification work_done;
+
+void ReleaseNotification(void* notification) {
+  static_cast<sync::ThreadNotification*>(notification)->release();
+}
+
+TEST(WorkQueue, RunsWorkOnThread) {
+  WorkQueueWithBuffer<4> work_queue;
+  Thread thread(test::TestOptionsThread0(), work_queue);
+
+  Recorder recorder;
+  Recorder::WorkItemArg args[] = {{&recorder, 1}, {&recorder, 2}};
+  ASSERT_EQ(OkStatus(), work_queue.PushWork(Recorder::Record, &args[0]));
+  ASSERT_EQ(OkStatus(), work_queue.PushWork(Recorder::Record, &args[1]));
+  ASSERT_EQ(OkStatus(), work_queue.PushWork(ReleaseNotification, &work_done));
+  work_done.acquire();
+
+  ASSERT_EQ(2u, recorder.count);
+  EXPECT_EQ(1, recorder.order[0]);
+  EXPECT_EQ(2, recorder.order[1]);
+  EXPECT_NE(0u, work_queue.max_queue_used());
+
+  work_queue.RequestStop();
+#if PW_THREAD_JOINING_ENABLED
+  thread.join();
+#else
+  thread.detach();
+  // The work queue's thread may not have returned yet. Give it time to.
+  this_thread::sleep_for(std::chrono::ceil<SystemClock::duration>(10ms));
+#endif  // PW_THREAD_JOINING_ENABLED
+}
+
+}  // namespace
+}  // namespace pw::thread
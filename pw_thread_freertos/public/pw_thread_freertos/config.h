@@ -0,0 +1,24 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// pw::thread::SnapshotThreads() copies the state of every task into a static
+// buffer with room for this many tasks. A snapshot fails with
+// RESOURCE_EXHAUSTED when there are more tasks than this.
+#ifndef PW_THREAD_FREERTOS_CFG_MAX_SNAPSHOT_THREADS
+#define PW_THREAD_FREERTOS_CFG_MAX_SNAPSHOT_THREADS 16
+#endif  // PW_THREAD_FREERTOS_CFG_MAX_SNAPSHOT_THREADS
+
+static_assert(PW_THREAD_FREERTOS_CFG_MAX_SNAPSHOT_THREADS > 0,
+              "Invalid max snapshot threads configuration");
@@ -0,0 +1,63 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+#include "FreeRTOS.h"
+#include "pw_thread/thread.h"
+#include "task.h"
+
+namespace pw::thread::freertos {
+
+// The Context is the static storage for a thread: its stack and its task
+// control block. Threads are created with xTaskCreateStatic, so the FreeRTOS
+// backend never allocates memory.
+//
+// A Context may be used by one thread at a time. Once that thread has returned,
+// the Context may be used to create another thread, which first deletes the
+// finished task.
+class Context {
+ public:
+  explicit Context(std::span<StackType_t> stack) : stack_(stack) {}
+
+  Context(const Context&) = delete;
+  Context& operator=(const Context&) = delete;
+
+ private:
+  friend Thread;
+
+  static void RunThread(void* void_context_ptr);
+
+  std::span<StackType_t> stack_;
+  StaticTask_t tcb_;
+  TaskHandle_t task_handle_ = nullptr;
+  Thread::ThreadRoutine entry_ = nullptr;
+  void* arg_ = nullptr;
+  bool thread_done_ = false;
+};
+
+// A Context with a stack of kStackSizeWords words.
+template <size_t kStackSizeWords>
+class ContextWithStack final : public Context {
+ public:
+  ContextWithStack() : Context(stack_storage_) {}
+
+ private:
+  std::array<StackType_t, kStackSizeWords> stack_storage_;
+};
+
+}  // namespace pw::thread::freertos
@@ -0,0 +1,89 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "FreeRTOS.h"
+#include "pw_thread/thread.h"
+#include "pw_thread_freertos/context.h"
+#include "task.h"
+
+// Core affinity is only available in SMP builds of FreeRTOS.
+#if defined(configNUMBER_OF_CORES) && defined(configUSE_CORE_AFFINITY)
+#if configNUMBER_OF_CORES > 1 && configUSE_CORE_AFFINITY == 1
+#define PW_THREAD_FREERTOS_CORE_AFFINITY_ENABLED 1
+#endif  // configNUMBER_OF_CORES > 1 && configUSE_CORE_AFFINITY == 1
+#endif  // defined(configNUMBER_OF_CORES) && defined(configUSE_CORE_AFFINITY)
+
+#ifndef PW_THREAD_FREERTOS_CORE_AFFINITY_ENABLED
+#define PW_THREAD_FREERTOS_CORE_AFFINITY_ENABLED 0
+#endif  // PW_THREAD_FREERTOS_CORE_AFFINITY_ENABLED
+
+namespace pw::thread::freertos {
+
+// The Options for the FreeRTOS backend. A Context must be set. For example:
+//
+//   pw::thread::freertos::ContextWithStack<1024> log_flush_context;
+//
+//   pw::thread::Thread(pw::thread::freertos::Options()
+//                          .set_name("LogFlush")
+//                          .set_priority(kLogFlushPriority)
+//                          .set_context(log_flush_context),
+//                      log_flush_work_queue)
+//       .detach();
+class Options : public thread::Options {
+ public:
+  static constexpr UBaseType_t kDefaultPriority = tskIDLE_PRIORITY + 1;
+
+  constexpr Options() = default;
+
+  // The name is copied into the task control block and truncated to
+  // configMAX_TASK_NAME_LEN characters.
+  constexpr Options& set_name(const char* name) {
+    name_ = name;
+    return *this;
+  }
+
+  // Priorities range from tskIDLE_PRIORITY to configMAX_PRIORITIES - 1.
+  constexpr Options& set_priority(UBaseType_t priority) {
+    priority_ = priority;
+    return *this;
+  }
+
+  // The stack and control block for the thread, which must outlive it.
+  constexpr Options& set_context(Context& context) {
+    context_ = &context;
+    return *this;
+  }
+
+#if PW_THREAD_FREERTOS_CORE_AFFINITY_ENABLED
+  // Bit N of the mask lets the thread run on core N. By default the thread may
+  // run on any core.
+  constexpr Options& set_core_affinity(UBaseType_t core_affinity_mask) {
+    core_affinity_mask_ = core_affinity_mask;
+    return *this;
+  }
+#endif  // PW_THREAD_FREERTOS_CORE_AFFINITY_ENABLED
+
+ private:
+  friend Thread;
+
+  const char* name_ = "pw::Thread";
+  UBaseType_t priority_ = kDefaultPriority;
+  Context* context_ = nullptr;
+#if PW_THREAD_FREERTOS_CORE_AFFINITY_ENABLED
+  UBaseType_t core_affinity_mask_ = tskNO_AFFINITY;
+#endif  // PW_THREAD_FREERTOS_CORE_AFFINITY_ENABLED
+};
+
+}  // namespace pw::thread::freertos
@@ -0,0 +1,89 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/snapshot.h"
+
+#include <algorithm>
+#include <array>
+
+#include "FreeRTOS.h"
+#include "pw_thread_freertos/config.h"
+#include "task.h"
+
+static_assert(configUSE_TRACE_FACILITY == 1,
+              "The FreeRTOS pw::thread::SnapshotThreads() backend requires "
+              "uxTaskGetSystemState");
+
+namespace pw::thread {
+namespace {
+
+// uxTaskGetSystemState() needs room for every task. The buffer is static to
+// keep it off the caller's stack, and is only used with the scheduler
+// suspended.
+std::array<TaskStatus_t, PW_THREAD_FREERTOS_CFG_MAX_SNAPSHOT_THREADS>
+    task_statuses;
+
+}  // namespace
+
+StatusWithSize SnapshotThreads(std::span<ThreadSnapshot> snapshots) {
+  vTaskSuspendAll();
+
+  // Returns 0 if the buffer cannot hold every task. Measuring each task's
+  // stack high-water mark scans its stack.
+  const UBaseType_t task_count = uxTaskGetSystemState(
+      task_statuses.data(), task_statuses.size(), nullptr);
+  if (task_count == 0) {
+    xTaskResumeAll();
+    return StatusWithSize::ResourceExhausted();
+  }
+
+  const size_t count = std::min<size_t>(task_count, snapshots.size());
+  for (size_t i = 0; i < count; ++i) {
+    const TaskStatus_t& status = task_statuses[i];
+    ThreadSnapshot& snapshot = snapshots[i];
+    snapshot.name = status.pcTaskName;
+    snapshot.id = Id(status.xHandle);
+#if configGENERATE_RUN_TIME_STATS == 1
+    snapshot.run_time = status.ulRunTimeCounter;
+#else
+    snapshot.run_time = std::nullopt;
+#endif  // configGENERATE_RUN_TIME_STATS == 1
+    // FreeRTOS does not report a task's stack size.
+    snapshot.stack_size_bytes = std::nullopt;
+    snapshot.stack_min_free_bytes =
+        size_t(status.usStackHighWaterMark) * sizeof(StackType_t);
+  }
+
+  xTaskResumeAll();
+  if (count < task_count) {
+    return StatusWithSize::ResourceExhausted(count);
+  }
+  return StatusWithSize(count);
+}
+
+std::optional<uint64_t> TotalRunTime() {
+#if configGENERATE_RUN_TIME_STATS == 1
+#ifdef portALT_GET_RUN_TIME_COUNTER_VALUE
+  uint32_t run_time;
+  portALT_GET_RUN_TIME_COUNTER_VALUE(run_time);
+  return run_time;
+#else
+  return portGET_RUN_TIME_COUNTER_VALUE();
+#endif  // portALT_GET_RUN_TIME_COUNTER_VALUE
+#else
+  return std::nullopt;
+#endif  // configGENERATE_RUN_TIME_STATS == 1
+}
+
+}  // namespace pw::thread
@@ -0,0 +1,94 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/thread.h"
+
+#include "FreeRTOS.h"
+#include "pw_assert/assert.h"
+#include "pw_thread_freertos/context.h"
+#include "pw_thread_freertos/options.h"
+#include "task.h"
+
+static_assert(configSUPPORT_STATIC_ALLOCATION == 1,
+              "The FreeRTOS pw::thread::Thread backend creates threads with "
+              "xTaskCreateStatic");
+static_assert(INCLUDE_vTaskSuspend == 1 && INCLUDE_vTaskDelete == 1,
+              "The FreeRTOS pw::thread::Thread backend requires vTaskSuspend "
+              "and vTaskDelete");
+
+namespace pw::thread {
+namespace freertos {
+
+void Context::RunThread(void* void_context_ptr) {
+  Context& context = *static_cast<Context*>(void_context_ptr);
+  context.entry_(context.arg_);
+
+  // FreeRTOS tasks must not return. A task which deletes itself is only cleaned
+  // up later by the idle task, with no way to tell when its control block is
+  // free again, so the task suspends itself instead. The next thread created
+  // with this context deletes it.
+  taskENTER_CRITICAL();
+  context.thread_done_ = true;
+  taskEXIT_CRITICAL();
+  vTaskSuspend(nullptr);
+}
+
+}  // namespace freertos
+
+Thread::Thread(const thread::Options& facade_options,
+               ThreadRoutine entry,
+               void* arg)
+    : native_type_(nullptr) {
+  // Only the backend's Options can exist in this build, so the cast is safe.
+  const auto& options = static_cast<const freertos::Options&>(facade_options);
+  PW_CHECK_NOTNULL(options.context_,
+                   "The FreeRTOS Thread backend requires a Context");
+  PW_CHECK_UINT_LT(options.priority_, configMAX_PRIORITIES);
+  freertos::Context& context = *options.context_;
+
+  if (context.task_handle_ != nullptr) {
+    taskENTER_CRITICAL();
+    const bool thread_done = context.thread_done_;
+    taskEXIT_CRITICAL();
+    PW_CHECK(thread_done,
+             "A Context may only be reused once its thread has returned");
+    vTaskDelete(context.task_handle_);
+  }
+
+  context.entry_ = entry;
+  context.arg_ = arg;
+  context.thread_done_ = false;
+#if PW_THREAD_FREERTOS_CORE_AFFINITY_ENABLED
+  context.task_handle_ =
+      xTaskCreateStaticAffinitySet(freertos::Context::RunThread,
+                                   options.name_,
+                                   context.stack_.size(),
+                                   &context,
+                                   options.priority_,
+                                   context.stack_.data(),
+                                   &context.tcb_,
+                                   options.core_affinity_mask_);
+#else
+  context.task_handle_ = xTaskCreateStatic(freertos::Context::RunThread,
+                                           options.name_,
+                                           context.stack_.size(),
+                                           &context,
+                                           options.priority_,
+                                           context.stack_.data(),
+                                           &context.tcb_);
+#endif  // PW_THREAD_FREERTOS_CORE_AFFINITY_ENABLED
+  native_type_ = context.task_handle_;
+}
+
+}  // namespace pw::thread
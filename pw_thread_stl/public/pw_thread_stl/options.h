@@ -0,0 +1,29 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_thread/thread.h"
+
+namespace pw::thread::stl {
+
+// The Options for the STL backend. std::thread offers no portable way to set a
+// thread's priority, stack, or core affinity, so there are none; the operating
+// system allocates the stack. The Options exist so that code written against
+// the Thread facade can be built with the STL backend on a host.
+class Options : public thread::Options {
+ public:
+  constexpr Options() = default;
+};
+
+}  // namespace pw::thread::stl
@@ -0,0 +1,100 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_thread/thread.h"
+#include "pw_thread_threadx/context.h"
+#include "tx_api.h"
+
+namespace pw::thread::threadx {
+
+// The Options for the ThreadX backend. A Context must be set. For example:
+//
+//   pw::thread::threadx::ContextWithStack<1024> log_flush_context;
+//
+//   pw::thread::Thread(pw::thread::threadx::Options()
+//                          .set_name("LogFlush")
+//                          .set_priority(kLogFlushPriority)
+//                          .set_context(log_flush_context),
+//                      log_flush_work_queue)
+//       .detach();
+class Options : public thread::Options {
+ public:
+  // ThreadX has no idle thread, so the lowest priority is a safe default.
+  static constexpr UINT kDefaultPriority = TX_MAX_PRIORITIES - 1;
+
+  constexpr Options() = default;
+
+  // The name must outlive the thread, as ThreadX does not copy it.
+  constexpr Options& set_name(const char* name) {
+    name_ = name;
+    return *this;
+  }
+
+  // Priorities range from 0, the highest, to TX_MAX_PRIORITIES - 1.
+  constexpr Options& set_priority(UINT priority) {
+    priority_ = priority;
+    return *this;
+  }
+
+  // Only threads with a priority higher than the threshold may preempt this
+  // thread. By default, the threshold is the thread's priority, which disables
+  // preemption-threshold.
+  constexpr Options& set_preemption_threshold(UINT preemption_threshold) {
+    preemption_threshold_ = preemption_threshold;
+    preemption_threshold_set_ = true;
+    return *this;
+  }
+
+  // The number of ticks the thread may run before other ready threads of the
+  // same priority run. Defaults to TX_NO_TIME_SLICE.
+  constexpr Options& set_time_slice_interval(ULONG time_slice_interval) {
+    time_slice_interval_ = time_slice_interval;
+    return *this;
+  }
+
+  // The stack and control block for the thread, which must outlive it.
+  constexpr Options& set_context(Context& context) {
+    context_ = &context;
+    return *this;
+  }
+
+#ifdef TX_THREAD_SMP_MAX_CORES
+  // Bit N of the map keeps the thread off core N. By default the thread may run
+  // on any core. This is only available in SMP builds of ThreadX.
+  constexpr Options& set_core_exclusion_map(ULONG core_exclusion_map) {
+    core_exclusion_map_ = core_exclusion_map;
+    return *this;
+  }
+#endif  // TX_THREAD_SMP_MAX_CORES
+
+ private:
+  friend Thread;
+
+  constexpr UINT preemption_threshold() const {
+    return preemption_threshold_set_ ? preemption_threshold_ : priority_;
+  }
+
+  const char* name_ = "pw::Thread";
+  UINT priority_ = kDefaultPriority;
+  UINT preemption_threshold_ = 0;
+  bool preemption_threshold_set_ = false;
+  ULONG time_slice_interval_ = TX_NO_TIME_SLICE;
+  Context* context_ = nullptr;
+#ifdef TX_THREAD_SMP_MAX_CORES
+  ULONG core_exclusion_map_ = 0;
+#endif  // TX_THREAD_SMP_MAX_CORES
+};
+
+}  // namespace pw::thread::threadx
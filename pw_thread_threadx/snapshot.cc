@@ -0,0 +1,84 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/snapshot.h"
+
+#include "pw_thread/id.h"
+#include "tx_api.h"
+#include "tx_thread.h"
+
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+#include "tx_execution_profile.h"
+#endif  // TX_EXECUTION_PROFILE_ENABLE
+
+namespace pw::thread {
+
+StatusWithSize SnapshotThreads(std::span<ThreadSnapshot> snapshots) {
+  // Keep threads from being created or deleted while walking the list of
+  // created threads. The stack high-water mark is tracked by ThreadX as threads
+  // run, so no stacks are scanned with interrupts masked.
+  const UINT previous_posture = tx_interrupt_control(TX_INT_DISABLE);
+
+  const ULONG thread_count = _tx_thread_created_count;
+  TX_THREAD* thread = _tx_thread_created_ptr;
+  size_t count = 0;
+  for (; count < thread_count && count < snapshots.size(); ++count) {
+    ThreadSnapshot& snapshot = snapshots[count];
+    snapshot.name = thread->tx_thread_name;
+    snapshot.id = Id(thread);
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+    EXECUTION_TIME run_time;
+    _tx_execution_thread_time_get(thread, &run_time);
+    snapshot.run_time = run_time;
+#else
+    snapshot.run_time = std::nullopt;
+#endif  // TX_EXECUTION_PROFILE_ENABLE
+    snapshot.stack_size_bytes = thread->tx_thread_stack_size;
+#ifdef TX_ENABLE_STACK_CHECKING
+    // Stacks grow down from tx_thread_stack_end.
+    snapshot.stack_min_free_bytes =
+        static_cast<size_t>(static_cast<const char*>(
+                                thread->tx_thread_stack_highest_ptr) -
+                            static_cast<const char*>(
+                                thread->tx_thread_stack_start));
+#else
+    snapshot.stack_min_free_bytes = std::nullopt;
+#endif  // TX_ENABLE_STACK_CHECKING
+    thread = thread->tx_thread_created_next;
+  }
+
+  tx_interrupt_control(previous_posture);
+  if (count < thread_count) {
+    return StatusWithSize::ResourceExhausted(count);
+  }
+  return StatusWithSize(count);
+}
+
+std::optional<uint64_t> TotalRunTime() {
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+  // ThreadX has no idle thread, so the total includes the time spent idle and
+  // in interrupts as well as in threads.
+  EXECUTION_TIME thread_time;
+  EXECUTION_TIME isr_time;
+  EXECUTION_TIME idle_time;
+  _tx_execution_thread_total_time_get(&thread_time);
+  _tx_execution_isr_time_get(&isr_time);
+  _tx_execution_idle_time_get(&idle_time);
+  return uint64_t(thread_time) + isr_time + idle_time;
+#else
+  return std::nullopt;
+#endif  // TX_EXECUTION_PROFILE_ENABLE
+}
+
+}  // namespace pw::thread
@@ -0,0 +1,47 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/test_threads.h"
+
+#include <cstddef>
+
+#include "pw_thread_threadx/context.h"
+#include "pw_thread_threadx/options.h"
+#include "tx_api.h"
+
+namespace pw::thread::test {
+namespace {
+
+constexpr size_t kTestStackSizeWords = 8192 / sizeof(ULONG);
+
+threadx::ContextWithStack<kTestStackSizeWords> thread_0_context;
+threadx::ContextWithStack<kTestStackSizeWords> thread_1_context;
+
+}  // namespace
+
+const Options& TestOptionsThread0() {
+  static const threadx::Options thread_0_options =
+      threadx::Options().set_name("pw::TestThread0").set_context(
+          thread_0_context);
+  return thread_0_options;
+}
+
+const Options& TestOptionsThread1() {
+  static const threadx::Options thread_1_options =
+      threadx::Options().set_name("pw::TestThread1").set_context(
+          thread_1_context);
+  return thread_1_options;
+}
+
+}  // namespace pw::thread::test
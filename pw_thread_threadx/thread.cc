@@ -0,0 +1,88 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/thread.h"
+
+#include "pw_assert/assert.h"
+#include "pw_thread_threadx/context.h"
+#include "pw_thread_threadx/options.h"
+#include "tx_api.h"
+
+static_assert(sizeof(ULONG) >= sizeof(void*),
+              "The ThreadX pw::thread::Thread backend passes a pointer as the "
+              "thread's ULONG entry input");
+
+namespace pw::thread {
+namespace threadx {
+
+void Context::RunThread(ULONG void_context_ptr) {
+  Context& context = *reinterpret_cast<Context*>(void_context_ptr);
+  context.entry_(context.arg_);
+  // Returning completes the ThreadX thread. The next thread created with this
+  // context deletes it.
+}
+
+}  // namespace threadx
+
+Thread::Thread(const thread::Options& facade_options,
+               ThreadRoutine entry,
+               void* arg)
+    : native_type_(nullptr) {
+  // Only the backend's Options can exist in this build, so the cast is safe.
+  const auto& options = static_cast<const threadx::Options&>(facade_options);
+  PW_CHECK_NOTNULL(options.context_,
+                   "The ThreadX Thread backend requires a Context");
+  PW_CHECK_UINT_LT(options.priority_, TX_MAX_PRIORITIES);
+  threadx::Context& context = *options.context_;
+
+  if (context.in_use_) {
+    // Deleting fails unless the thread has completed or been terminated.
+    PW_CHECK_UINT_EQ(
+        TX_SUCCESS,
+        tx_thread_delete(&context.tcb_),
+        "A Context may only be reused once its thread has returned");
+  }
+
+  context.entry_ = entry;
+  context.arg_ = arg;
+  context.in_use_ = true;
+
+#ifdef TX_THREAD_SMP_MAX_CORES
+  // Set the core exclusions before the thread first runs.
+  constexpr UINT kAutoStart = TX_DONT_START;
+#else
+  constexpr UINT kAutoStart = TX_AUTO_START;
+#endif  // TX_THREAD_SMP_MAX_CORES
+  PW_CHECK_UINT_EQ(
+      TX_SUCCESS,
+      tx_thread_create(&context.tcb_,
+                       const_cast<CHAR*>(options.name_),
+                       threadx::Context::RunThread,
+                       reinterpret_cast<ULONG>(&context),
+                       context.stack_.data(),
+                       context.stack_.size_bytes(),
+                       options.priority_,
+                       options.preemption_threshold(),
+                       options.time_slice_interval_,
+                       kAutoStart));
+#ifdef TX_THREAD_SMP_MAX_CORES
+  PW_CHECK_UINT_EQ(
+      TX_SUCCESS,
+      tx_thread_smp_core_exclude(&context.tcb_, options.core_exclusion_map_));
+  PW_CHECK_UINT_EQ(TX_SUCCESS, tx_thread_resume(&context.tcb_));
+#endif  // TX_THREAD_SMP_MAX_CORES
+  native_type_ = &context.tcb_;
+}
+
+}  // namespace pw::thread
@@ -0,0 +1,203 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_tokenizer/compact_token_database.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace pw::tokenizer {
+namespace {
+
+using RawEntry = TokenDatabase::RawEntry;
+
+constexpr char kMagicAndVersion[] = {'T', 'O', 'K', 'E', 'N', 'S', '\1', '\0'};
+
+constexpr size_t kHeaderSize = 16;
+constexpr size_t kEntryCountOffset = 8;
+constexpr size_t kBlockSizeOffset = 12;
+constexpr size_t kWordCountOffset = 14;
+
+constexpr uint8_t kEscape = 0x7F;
+constexpr uint8_t kFirstWord = 0x80;
+
+uint32_t ReadUint32(const uint8_t* bytes) {
+  return bytes[0] | bytes[1] << 8 | bytes[2] << 16 |
+         static_cast<uint32_t>(bytes[3]) << 24;
+}
+
+uint16_t ReadUint16(const uint8_t* bytes) {
+  return static_cast<uint16_t>(bytes[0] | bytes[1] << 8);
+}
+
+size_t BlockCount(size_t entry_count, size_t block_size) {
+  return (entry_count + block_size - 1) / block_size;
+}
+
+// The block offsets follow the entries, and the word offsets follow them.
+size_t BlockOffsets(size_t entry_count) {
+  return kHeaderSize + entry_count * sizeof(RawEntry);
+}
+
+size_t WordOffsets(size_t entry_count, size_t block_size) {
+  return BlockOffsets(entry_count) +
+         BlockCount(entry_count, block_size) * sizeof(uint32_t);
+}
+
+// Checks that each offset in the table refers to a byte in the database.
+bool OffsetsAreValid(const uint8_t* table, size_t count, size_t size) {
+  for (size_t i = 0; i < count; ++i) {
+    if (ReadUint32(table + i * sizeof(uint32_t)) >= size) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+CompactTokenDatabase CompactTokenDatabase::FromBytes(const uint8_t* data,
+                                                     size_t size) {
+  if (size < kHeaderSize ||
+      std::memcmp(data, kMagicAndVersion, sizeof(kMagicAndVersion)) != 0 ||
+      reinterpret_cast<uintptr_t>(data) % alignof(RawEntry) != 0u) {
+    return CompactTokenDatabase();
+  }
+
+  const size_t entry_count = ReadUint32(data + kEntryCountOffset);
+  const uint16_t block_size = ReadUint16(data + kBlockSizeOffset);
+  const uint16_t word_count = ReadUint16(data + kWordCountOffset);
+
+  if (block_size == 0u || word_count > kMaxWords ||
+      entry_count > (size - kHeaderSize) / sizeof(RawEntry)) {
+    return CompactTokenDatabase();
+  }
+
+  const size_t words = WordOffsets(entry_count, block_size);
+  if (size < words + word_count * sizeof(uint32_t)) {
+    return CompactTokenDatabase();
+  }
+
+  // Every string ends at or before the final null terminator, so strings that
+  // start within the data can be read without checking the size again.
+  if (data[size - 1] != '\0' ||
+      !OffsetsAreValid(data + BlockOffsets(entry_count),
+                       BlockCount(entry_count, block_size),
+                       size) ||
+      !OffsetsAreValid(data + words, word_count, size)) {
+    return CompactTokenDatabase();
+  }
+
+  return CompactTokenDatabase(data, entry_count, block_size, word_count);
+}
+
+TokenDatabase::Entries CompactTokenDatabase::Find(
+    const uint32_t token, std::span<char> string_buffer) const {
+  const RawEntry* const begin = entries();
+  const RawEntry* const end = begin + entry_count_;
+
+  const RawEntry* first = std::lower_bound(
+      begin, end, token, [](const RawEntry& entry, uint32_t t) {
+        return entry.token < t;
+      });
+  const RawEntry* const last = std::upper_bound(
+      first, end, token, [](uint32_t t, const RawEntry& entry) {
+        return t < entry.token;
+      });
+
+  // The strings of consecutive entries are stored consecutively, so only the
+  // first string must be found through the block offsets.
+  const RawEntry* found = first;
+  if (first != last) {
+    const uint8_t* string = CompressedString(first - begin);
+    size_t written = 0;
+
+    for (; found != last; ++found) {
+      const size_t size =
+          Decompress(string, string_buffer.subspan(written));
+      if (size == 0u) {
+        break;
+      }
+      written += size;
+      string += std::strlen(reinterpret_cast<const char*>(string)) + 1;
+    }
+  }
+
+  return TokenDatabase::Entries(
+      TokenDatabase::Iterator(first, string_buffer.data()),
+      TokenDatabase::Iterator(found, nullptr));
+}
+
+const RawEntry* CompactTokenDatabase::entries() const {
+  return data_ == nullptr
+             ? nullptr
+             : reinterpret_cast<const RawEntry*>(data_ + kHeaderSize);
+}
+
+const uint8_t* CompactTokenDatabase::CompressedString(size_t index) const {
+  const uint8_t* string =
+      data_ + ReadUint32(data_ + BlockOffsets(entry_count_) +
+                         index / block_size_ * sizeof(uint32_t));
+
+  // Skip the strings before this one in its block. Neither words nor escaped
+  // bytes are ever zero, so each string ends at its first null byte.
+  for (size_t i = 0; i < index % block_size_; ++i) {
+    string += std::strlen(reinterpret_cast<const char*>(string)) + 1;
+  }
+  return string;
+}
+
+size_t CompactTokenDatabase::Decompress(const uint8_t* string,
+                                        std::span<char> output) const {
+  if (output.empty()) {
+    return 0;
+  }
+
+  // Leave room for the null terminator while decompressing.
+  const size_t capacity = output.size() - 1;
+  size_t written = 0;
+
+  for (; *string != '\0'; ++string) {
+    if (*string >= kFirstWord) {
+      const size_t word = *string - kFirstWord;
+      if (word >= word_count_) {
+        return 0;  // The string is corrupt.
+      }
+
+      const char* word_string = reinterpret_cast<const char*>(
+          data_ + ReadUint32(data_ + WordOffsets(entry_count_, block_size_) +
+                             word * sizeof(uint32_t)));
+      const size_t length = std::strlen(word_string);
+      if (length > capacity - written) {
+        return 0;
+      }
+      std::memcpy(&output[written], word_string, length);
+      written += length;
+      continue;
+    }
+
+    if (*string == kEscape && string[1] != '\0') {
+      string += 1;
+    }
+    if (written == capacity) {
+      return 0;
+    }
+    output[written++] = static_cast<char>(*string);
+  }
+
+  output[written] = '\0';
+  return written + 1;
+}
+
+}  // namespace pw::tokenizer
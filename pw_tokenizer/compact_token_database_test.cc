@@ -0,0 +1,154 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_tokenizer/compact_token_database.h"
+
+#include <array>
+#include <cstring>
+#include <string_view>
+
+#include "gtest/gtest.h"
+
+namespace pw::tokenizer {
+namespace {
+
+using namespace std::literals::string_view_literals;
+
+// Four entries in blocks of two, with two dictionary words. The two entries
+// for token 5 are in different blocks.
+alignas(TokenDatabase::RawEntry) constexpr char kData[] =
+    "TOKENS\1\0\x04\0\0\0\x02\0\x02\0"
+    // Entries
+    "\x01\0\0\0\xFF\xFF\xFF\xFF"
+    "\x05\0\0\0\xFF\xFF\xFF\xFF"
+    "\x05\0\0\0\x01\x02\xE5\x07"
+    "\x09\0\0\0\xFF\xFF\xFF\xFF"
+    // Block offsets
+    "\x48\0\0\0"
+    "\x59\0\0\0"
+    // Word offsets
+    "\x40\0\0\0"
+    "\x45\0\0\0"
+    // Words
+    "the \0"
+    "%s\0"
+    // Strings
+    "Hello, \x80world\0"
+    "\x80\x81\0"
+    "caf\x7F\xC3\x7F\xA9\0"
+    "\x7F\x7F!";  // Last byte is null terminator.
+
+class CompactTokenDatabaseTest : public ::testing::Test {
+ protected:
+  CompactTokenDatabaseTest()
+      : db_(CompactTokenDatabase::Create(kData)), buffer_{} {}
+
+  CompactTokenDatabase db_;
+  std::array<char, 64> buffer_;
+};
+
+TEST_F(CompactTokenDatabaseTest, ValidData) {
+  EXPECT_TRUE(db_.ok());
+  EXPECT_EQ(db_.size(), 4u);
+}
+
+TEST_F(CompactTokenDatabaseTest, Find_SingleEntry) {
+  TokenDatabase::Entries entries = db_.Find(1, buffer_);
+  ASSERT_EQ(entries.size(), 1u);
+  EXPECT_EQ(entries[0].token, 1u);
+  EXPECT_EQ(entries[0].date_removed, 0xFFFFFFFFu);
+  EXPECT_EQ(entries[0].string, "Hello, the world"sv);
+}
+
+TEST_F(CompactTokenDatabaseTest, Find_EntriesInDifferentBlocks) {
+  TokenDatabase::Entries entries = db_.Find(5, buffer_);
+  ASSERT_EQ(entries.size(), 2u);
+  EXPECT_EQ(entries[0].string, "the %s"sv);
+  EXPECT_EQ(entries[0].date_removed, 0xFFFFFFFFu);
+  EXPECT_EQ(entries[1].string, "caf\xC3\xA9"sv);
+  EXPECT_EQ(entries[1].date_removed, 0x07E50201u);
+}
+
+TEST_F(CompactTokenDatabaseTest, Find_EscapedBytes) {
+  TokenDatabase::Entries entries = db_.Find(9, buffer_);
+  ASSERT_EQ(entries.size(), 1u);
+  EXPECT_EQ(entries[0].string, "\x7F!"sv);
+}
+
+TEST_F(CompactTokenDatabaseTest, Find_Missing) {
+  EXPECT_TRUE(db_.Find(0, buffer_).empty());
+  EXPECT_TRUE(db_.Find(2, buffer_).empty());
+  EXPECT_TRUE(db_.Find(10, buffer_).empty());
+}
+
+TEST_F(CompactTokenDatabaseTest, Find_SmallBuffer_OmitsEntries) {
+  TokenDatabase::Entries entries =
+      db_.Find(5, std::span(buffer_).first(sizeof("the %s")));
+  ASSERT_EQ(entries.size(), 1u);
+  EXPECT_EQ(entries[0].string, "the %s"sv);
+
+  EXPECT_TRUE(db_.Find(5, std::span(buffer_).first(6)).empty());
+  EXPECT_TRUE(db_.Find(5, std::span<char>()).empty());
+}
+
+TEST(CompactTokenDatabase, Empty) {
+  alignas(TokenDatabase::RawEntry) constexpr char kEmpty[] =
+      "TOKENS\1\0\0\0\0\0\x10\0\0";  // Last byte is null terminator.
+  const CompactTokenDatabase db = CompactTokenDatabase::Create(kEmpty);
+  EXPECT_TRUE(db.ok());
+  EXPECT_EQ(db.size(), 0u);
+
+  std::array<char, 8> buffer;
+  EXPECT_TRUE(db.Find(0, buffer).empty());
+}
+
+TEST(CompactTokenDatabase, DefaultConstructed) {
+  constexpr CompactTokenDatabase db;
+  static_assert(!db.ok());
+  static_assert(db.size() == 0u);
+
+  std::array<char, 8> buffer;
+  EXPECT_TRUE(db.Find(0, buffer).empty());
+}
+
+// Copies kData with a modification and checks that the result is invalid.
+template <size_t kOffset, size_t kSize>
+bool CreatesInvalidDatabase(const char (&replacement)[kSize]) {
+  alignas(TokenDatabase::RawEntry) std::array<char, sizeof(kData)> data;
+  std::memcpy(data.data(), kData, sizeof(kData));
+  std::memcpy(&data[kOffset], replacement, kSize - 1);
+  return !CompactTokenDatabase::Create(data).ok();
+}
+
+TEST(CompactTokenDatabase, InvalidData) {
+  EXPECT_TRUE(CreatesInvalidDatabase<6>("\0\0"));          // Version 0
+  EXPECT_TRUE(CreatesInvalidDatabase<8>("\xFF\0\0\0"));    // Entry count
+  EXPECT_TRUE(CreatesInvalidDatabase<12>("\0\0"));         // Block size
+  EXPECT_TRUE(CreatesInvalidDatabase<14>("\x81\0"));       // Word count
+  EXPECT_TRUE(CreatesInvalidDatabase<52>("\xFF\0\0\0"));   // Block offset
+  EXPECT_TRUE(CreatesInvalidDatabase<60>("\xFF\0\0\0"));   // Word offset
+  EXPECT_TRUE(CreatesInvalidDatabase<sizeof(kData) - 1>("!"));  // No null
+
+  EXPECT_FALSE(CompactTokenDatabase::Create(std::string_view(kData, 15)).ok());
+}
+
+TEST(CompactTokenDatabase, MisalignedData_IsInvalid) {
+  alignas(TokenDatabase::RawEntry) std::array<char, sizeof(kData) + 1> data;
+  std::memcpy(&data[1], kData, sizeof(kData));
+  EXPECT_FALSE(
+      CompactTokenDatabase::Create(std::span(data).subspan(1)).ok());
+}
+
+}  // namespace
+}  // namespace pw::tokenizer
@@ -24,6 +24,18 @@
 namespace pw::tokenizer {
 namespace {
 
+// Status bytes for interned string arguments. A reference is the marker
+// followed by a one-byte ID. An announcement is the marker, the ID, and a plain
+// string. These values must match encode_args.h.
+constexpr uint8_t kInternedStringReference = 0x7Fu;
+constexpr uint8_t kInternedStringAnnouncement = 0xFFu;
+
+// Returns the number of bytes before the plain string encoding, which is 2 for
+// interned string announcements and 0 otherwise.
+size_t InternedStringPrefixSize(const std::span<const uint8_t>& arguments) {
+  return arguments[0] == kInternedStringAnnouncement ? 2 : 0;
+}
+
 // Functions for parsing a printf format specifier.
 size_t SkipFlags(const char* str) {
   size_t i = 0;
@@ -90,6 +102,30 @@ std::string ErrorMessage(ArgStatus status,
   return result;
 }
 
+// Formats a value with snprintf and appends it to output. Short values are
+// formatted on the stack to avoid calling snprintf twice. Returns false if
+// snprintf fails.
+template <typename T>
+bool AppendFormatted(std::string& output, const char* format, T value) {
+  char buffer[64];
+  const int size = std::snprintf(buffer, sizeof(buffer), format, value);
+
+  if (size < 0) {
+    return false;
+  }
+
+  if (static_cast<size_t>(size) < sizeof(buffer)) {
+    output.append(buffer, size);
+    return true;
+  }
+
+  const size_t start = output.size();
+  output.resize(start + size + 1);
+  std::snprintf(&output[start], size + 1, format, value);
+  output.pop_back();  // Remove the trailing \0.
+  return true;
+}
+
 }  // namespace
 
 DecodedArg::DecodedArg(ArgStatus error,
@@ -177,27 +213,44 @@ DecodedArg StringSegment::DecodeString(
     return DecodedArg(ArgStatus::kMissing, text_);
   }
 
+  // This decoder does not track interned strings, so references to them
+  // cannot be expanded.
+  if (arguments[0] == kInternedStringReference) {
+    return DecodedArg(ArgStatus::kDecodeError,
+                      text_,
+                      std::min<size_t>(2, arguments.size()),
+                      "interned string");
+  }
+
+  const size_t prefix = InternedStringPrefixSize(arguments);
+  if (arguments.size() <= prefix) {
+    return DecodedArg(ArgStatus::kDecodeError, text_, arguments.size());
+  }
+
+  const uint8_t* const string = &arguments[prefix];
+  const size_t available = arguments.size() - prefix - 1;
+
   ArgStatus status =
-      (arguments[0] & 0x80u) == 0u ? ArgStatus::kOk : ArgStatus::kTruncated;
+      (string[0] & 0x80u) == 0u ? ArgStatus::kOk : ArgStatus::kTruncated;
 
-  const uint_fast8_t size = arguments[0] & 0x7Fu;
+  const uint_fast8_t size = string[0] & 0x7Fu;
 
-  if (arguments.size() - 1 < size) {
+  if (available < size) {
     status.Update(ArgStatus::kDecodeError);
-    return DecodedArg(
-        status,
-        text_,
-        arguments.size(),
-        {reinterpret_cast<const char*>(&arguments[1]), arguments.size() - 1});
+    return DecodedArg(status,
+                      text_,
+                      arguments.size(),
+                      {reinterpret_cast<const char*>(&string[1]), available});
   }
 
-  std::string value(reinterpret_cast<const char*>(&arguments[1]), size);
+  std::string value(reinterpret_cast<const char*>(&string[1]), size);
 
   if (status.HasError(ArgStatus::kTruncated)) {
     value.append("[...]");
   }
 
-  return DecodedArg::FromValue(text_.c_str(), value.c_str(), 1 + size, status);
+  return DecodedArg::FromValue(
+      text_.c_str(), value.c_str(), prefix + 1 + size, status);
 }
 
 DecodedArg StringSegment::DecodeInteger(
@@ -271,6 +324,133 @@ DecodedArg StringSegment::Skip() const {
   }
 }
 
+bool StringSegment::AppendString(const std::span<const uint8_t>& arguments,
+                                 std::string& output,
+                                 size_t& bytes_decoded) const {
+  if (arguments.empty()) {
+    return false;
+  }
+
+  // References to interned strings cannot be expanded by this decoder.
+  if (arguments[0] == kInternedStringReference) {
+    bytes_decoded = std::min<size_t>(2, arguments.size());
+    return false;
+  }
+
+  const size_t prefix = InternedStringPrefixSize(arguments);
+  if (arguments.size() <= prefix) {
+    bytes_decoded = arguments.size();
+    return false;
+  }
+
+  const uint8_t* const string = &arguments[prefix];
+  const bool truncated = (string[0] & 0x80u) != 0u;
+  const uint_fast8_t size = string[0] & 0x7Fu;
+
+  if (arguments.size() - prefix - 1 < size) {
+    bytes_decoded = arguments.size();
+    return false;
+  }
+  bytes_decoded = prefix + 1 + size;
+
+  // Copy the string to null terminate it. Encoded strings are at most 127
+  // bytes, so the copy fits on the stack.
+  constexpr std::string_view kTruncated = "[...]";
+  std::array<char, 0x7Fu + kTruncated.size() + 1> value;
+  std::memcpy(value.data(), &string[1], size);
+  size_t length = size;
+
+  if (truncated) {
+    kTruncated.copy(&value[length], kTruncated.size());
+    length += kTruncated.size();
+  }
+  value[length] = '\0';
+
+  return AppendFormatted(output, text_.c_str(), value.data());
+}
+
+bool StringSegment::AppendInteger(const std::span<const uint8_t>& arguments,
+                                  std::string& output,
+                                  size_t& bytes_decoded) const {
+  if (arguments.empty()) {
+    return false;
+  }
+
+  int64_t value;
+  bytes_decoded = varint::Decode(std::as_bytes(arguments), &value);
+
+  if (bytes_decoded == 0u) {
+    bytes_decoded = std::min(varint::kMaxVarint64SizeBytes, arguments.size());
+    return false;
+  }
+
+  // Unsigned ints need to be masked to their bit width due to sign extension.
+  if (type_ == kUnsigned32) {
+    value &= 0xFFFFFFFFu;
+  }
+
+  if (local_size_ == k32Bit) {
+    return AppendFormatted(
+        output, text_.c_str(), static_cast<uint32_t>(value));
+  }
+  return AppendFormatted(output, text_.c_str(), value);
+}
+
+bool StringSegment::AppendFloatingPoint(
+    const std::span<const uint8_t>& arguments,
+    std::string& output,
+    size_t& bytes_decoded) const {
+  if (arguments.size() < sizeof(float)) {
+    return false;
+  }
+
+  float value;
+  std::memcpy(&value, arguments.data(), sizeof(value));
+  bytes_decoded = sizeof(value);
+  return AppendFormatted(output, text_.c_str(), value);
+}
+
+bool StringSegment::AppendTo(std::span<const uint8_t>& arguments,
+                             std::string& output) const {
+  size_t bytes_decoded = 0;
+  bool ok = false;
+
+  switch (type_) {
+    case kLiteral:
+      output.append(text_);
+      return true;
+    case kPercent:
+      output.push_back('%');
+      return true;
+    case kString:
+      ok = AppendString(arguments, output, bytes_decoded);
+      break;
+    case kSignedInt:
+    case kUnsigned32:
+    case kUnsigned64:
+      ok = AppendInteger(arguments, output, bytes_decoded);
+      break;
+    case kFloatingPoint:
+      ok = AppendFloatingPoint(arguments, output, bytes_decoded);
+      break;
+  }
+
+  arguments = arguments.subspan(bytes_decoded);
+
+  if (!ok) {
+    output.append(text_);
+  }
+  return ok;
+}
+
+void StringSegment::AppendSkipped(std::string& output) const {
+  if (type_ == kPercent) {
+    output.push_back('%');
+  } else {
+    output.append(text_);
+  }
+}
+
 std::string DecodedFormatString::value() const {
   std::string output;
 
@@ -353,4 +533,20 @@ DecodedFormatString FormatString::Format(
   return DecodedFormatString(std::move(results), arguments.size());
 }
 
+bool FormatString::AppendTo(std::span<const uint8_t> arguments,
+                            std::string& output) const {
+  bool ok = true;
+
+  for (const StringSegment& segment : segments_) {
+    if (ok) {
+      ok = segment.AppendTo(arguments, output);
+    } else {
+      // After an error, skip decoding the remaining arguments.
+      segment.AppendSkipped(output);
+    }
+  }
+
+  return ok && arguments.empty();
+}
+
 }  // namespace pw::tokenizer
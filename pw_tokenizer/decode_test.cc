@@ -77,6 +77,44 @@ TEST(TokenizedStringDecode, TokenizedStringDecodingTestCases) {
   }
 }
 
+TEST(TokenizedStringDecode, AppendTo_MatchesFormat) {
+  std::string output;
+
+  for (const auto& [format, expected, args] :
+       test::tokenized_string_decoding::kTestData) {
+    if (!FormatIsSupported(format)) {
+      continue;
+    }
+    const FormatString format_string(format);
+    const DecodedFormatString decoded = format_string.Format(args);
+
+    output.clear();
+    const std::span<const uint8_t> arg_bytes(
+        reinterpret_cast<const uint8_t*>(args.data()), args.size());
+    ASSERT_EQ(format_string.AppendTo(arg_bytes, output), decoded.ok());
+    ASSERT_EQ(output, decoded.value());
+  }
+}
+
+TEST(TokenizedStringDecode, AppendTo_AppendsToExistingOutput) {
+  std::string output = "> ";
+  EXPECT_TRUE(kTwoArgs.AppendTo(
+      std::span(reinterpret_cast<const uint8_t*>("\6\x89musketeer"), 11),
+      output));
+  EXPECT_EQ(output, "> The 3 musketeer[...]");
+
+  EXPECT_FALSE(kTwoArgs.AppendTo(std::span<const uint8_t>(), output));
+  EXPECT_EQ(output, "> The 3 musketeer[...]The %d %s");
+}
+
+TEST(TokenizedStringDecode, AppendTo_LongValue) {
+  const FormatString format("%100d|");
+  std::string output;
+  EXPECT_TRUE(format.AppendTo(
+      std::span(reinterpret_cast<const uint8_t*>("\x02"), 1), output));
+  EXPECT_EQ(output, std::string(99, ' ') + "1|");
+}
+
 TEST(TokenizedStringDecode, FullyDecodeInput_ZeroRemainingBytes) {
   auto result = kOneArg.Format("\5hello");
   EXPECT_EQ(result.value(), "Hello hello");
@@ -99,6 +137,29 @@ TEST(TokenizedStringDecode, Truncation_NotAnError) {
   EXPECT_EQ(result.decoding_errors(), 0u);
 }
 
+TEST(TokenizedStringDecode, InternedStringAnnouncement_DecodesString) {
+  auto result = kTwoArgs.Format("\6\xff\x03\x09musketeer");
+  EXPECT_EQ(result.value(), "The 3 musketeer");
+  EXPECT_EQ(result.remaining_bytes(), 0u);
+  EXPECT_EQ(result.decoding_errors(), 0u);
+
+  std::string output;
+  EXPECT_TRUE(kTwoArgs.AppendTo(
+      std::span(reinterpret_cast<const uint8_t*>("\6\xff\x03\x09musketeer"),
+                13),
+      output));
+  EXPECT_EQ(output, "The 3 musketeer");
+}
+
+TEST(TokenizedStringDecode, InternedStringReference_IsError) {
+  auto result = kTwoArgs.Format("\6\x7f\x03");
+  EXPECT_EQ(result.value(), "The 3 %s");
+  EXPECT_EQ(result.value_with_errors(),
+            "The 3 " ERR("%s ERROR (interned string)"));
+  EXPECT_EQ(result.remaining_bytes(), 0u);
+  EXPECT_EQ(result.decoding_errors(), 1u);
+}
+
 TEST(TokenizedStringDecode, WrongStringLenth_IsErrorAndConsumesRestOfString) {
   auto result = kTwoArgs.Format("\6\x0amusketeer");
   EXPECT_EQ(result.value(), "The 3 %s");
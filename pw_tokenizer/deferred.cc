@@ -0,0 +1,248 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_tokenizer/deferred.h"
+
+#include <array>
+#include <cstring>
+
+#include "pw_tokenizer_private/encode_args.h"
+#include "pw_varint/varint.h"
+
+namespace pw::tokenizer {
+namespace {
+
+// A captured message is stored as the payload, token, and argument types,
+// followed by the arguments as they were read with va_arg. Integers and
+// doubles are stored in native byte order. Strings are stored in their encoded
+// form, since the encoding is just a copy.
+template <typename T>
+uint8_t* Store(uint8_t* output, T value) {
+  std::memcpy(output, &value, sizeof(value));
+  return output + sizeof(value);
+}
+
+// Stores an argument if it fits. Returns the stored size, or 0 if it did not
+// fit.
+template <typename T>
+size_t StoreArg(T value, const std::span<uint8_t>& output) {
+  if (output.size() < sizeof(value)) {
+    return 0;
+  }
+  std::memcpy(output.data(), &value, sizeof(value));
+  return sizeof(value);
+}
+
+template <typename T>
+T Load(const uint8_t*& input) {
+  T value;
+  std::memcpy(&value, input, sizeof(value));
+  input += sizeof(value);
+  return value;
+}
+
+// Copies an encoded string, truncating it if the output is too small.
+// Interned strings cannot be truncated, so they are omitted if they do not fit.
+size_t CopyString(const uint8_t* string, std::span<uint8_t> output) {
+  if (output.empty()) {
+    return 0;
+  }
+
+  if (string[0] == kInternedStringReference ||
+      string[0] == kInternedStringAnnouncement) {
+    const size_t size = EncodedStringSizeBytes(string);
+    if (size > output.size()) {
+      return 0;
+    }
+    std::memcpy(output.data(), string, size);
+    return size;
+  }
+
+  size_t length = string[0] & 0x7Fu;
+  uint8_t status = string[0];
+
+  if (length + 1 > output.size()) {
+    length = output.size() - 1;
+    status = static_cast<uint8_t>(length | 0x80u);
+  }
+
+  output[0] = status;
+  std::memcpy(&output[1], &string[1], length);
+  return length + 1;
+}
+
+DeferredEncoder global_deferred_encoder;
+
+}  // namespace
+
+Status DeferredEncoder::SetBuffer(std::span<std::byte> buffer) {
+  return ring_buffer_.SetBuffer(buffer);
+}
+
+Status DeferredEncoder::Capture(pw_tokenizer_Payload payload,
+                                pw_tokenizer_Token token,
+                                _pw_tokenizer_ArgTypes types,
+                                va_list args) {
+  std::array<uint8_t, kMaxCaptureSizeBytes> entry;
+  uint8_t* const end = entry.data() + entry.size();
+
+  uint8_t* output = Store(entry.data(), payload);
+  output = Store(output, token);
+  uint8_t* const types_output = output;
+  output += sizeof(types);
+
+  const size_t arg_count = types & PW_TOKENIZER_TYPE_COUNT_MASK;
+  _pw_tokenizer_ArgTypes remaining_types =
+      types >> PW_TOKENIZER_TYPE_COUNT_SIZE_BITS;
+
+  size_t captured = 0;
+  for (; captured < arg_count; ++captured, remaining_types >>= 2) {
+    const std::span<uint8_t> remaining(
+        output, static_cast<size_t>(end - output));
+
+    // How many bytes were stored; 0 indicates that there wasn't enough space.
+    size_t argument_bytes = 0;
+
+    switch (remaining_types & 0b11u) {
+      case PW_TOKENIZER_ARG_TYPE_INT:
+        argument_bytes = StoreArg(va_arg(args, int), remaining);
+        break;
+      case PW_TOKENIZER_ARG_TYPE_INT64:
+        argument_bytes = StoreArg(va_arg(args, int64_t), remaining);
+        break;
+      case PW_TOKENIZER_ARG_TYPE_DOUBLE:
+        argument_bytes = StoreArg(va_arg(args, double), remaining);
+        break;
+      case PW_TOKENIZER_ARG_TYPE_STRING:
+        argument_bytes = EncodeString(va_arg(args, const char*), remaining);
+        break;
+    }
+
+    if (argument_bytes == 0u) {
+      break;
+    }
+    output += argument_bytes;
+  }
+
+  // Record only the arguments that were captured.
+  types = (types & ~static_cast<_pw_tokenizer_ArgTypes>(
+                       PW_TOKENIZER_TYPE_COUNT_MASK)) |
+          static_cast<_pw_tokenizer_ArgTypes>(captured);
+  Store(types_output, types);
+
+  const std::span<const std::byte> data = std::as_bytes(
+      std::span(entry.data(), static_cast<size_t>(output - entry.data())));
+
+  std::lock_guard lock(producer_lock_);
+  const Status status = ring_buffer_.TryPushBack(data);
+  if (!status.ok()) {
+    dropped_ += 1;
+  }
+  return status;
+}
+
+StatusWithSize DeferredEncoder::EncodeNext(pw_tokenizer_Payload& payload,
+                                           std::span<uint8_t> output) {
+  std::array<uint8_t, kMaxCaptureSizeBytes> entry;
+  size_t entry_size = 0;
+  if (Status status =
+          ring_buffer_.PeekFront(std::as_writable_bytes(std::span(entry)),
+                                 &entry_size);
+      !status.ok()) {
+    return StatusWithSize(status, 0);
+  }
+  ring_buffer_.PopFront();
+
+  const uint8_t* input = entry.data();
+  payload = Load<pw_tokenizer_Payload>(input);
+  const pw_tokenizer_Token token = Load<pw_tokenizer_Token>(input);
+  _pw_tokenizer_ArgTypes types = Load<_pw_tokenizer_ArgTypes>(input);
+
+  if (output.size() < sizeof(token)) {
+    return StatusWithSize::ResourceExhausted();
+  }
+  std::memcpy(output.data(), &token, sizeof(token));
+  size_t encoded_bytes = sizeof(token);
+
+  size_t arg_count = types & PW_TOKENIZER_TYPE_COUNT_MASK;
+  types >>= PW_TOKENIZER_TYPE_COUNT_SIZE_BITS;
+
+  for (; arg_count != 0u; --arg_count, types >>= 2) {
+    const std::span<uint8_t> remaining = output.subspan(encoded_bytes);
+    size_t argument_bytes = 0;
+
+    switch (types & 0b11u) {
+      case PW_TOKENIZER_ARG_TYPE_INT:
+        argument_bytes = varint::Encode(Load<int>(input),
+                                        std::as_writable_bytes(remaining));
+        break;
+      case PW_TOKENIZER_ARG_TYPE_INT64:
+        argument_bytes = varint::Encode(Load<int64_t>(input),
+                                        std::as_writable_bytes(remaining));
+        break;
+      case PW_TOKENIZER_ARG_TYPE_DOUBLE: {
+        const float value = static_cast<float>(Load<double>(input));
+        if (remaining.size() >= sizeof(value)) {
+          std::memcpy(remaining.data(), &value, sizeof(value));
+          argument_bytes = sizeof(value);
+        }
+        break;
+      }
+      case PW_TOKENIZER_ARG_TYPE_STRING:
+        argument_bytes = CopyString(input, remaining);
+        input += EncodedStringSizeBytes(input);
+        break;
+    }
+
+    // If zero bytes were encoded, the output buffer is full.
+    if (argument_bytes == 0u) {
+      break;
+    }
+    encoded_bytes += argument_bytes;
+  }
+
+  return StatusWithSize(encoded_bytes);
+}
+
+size_t DeferredEncoder::HandleCapturedMessages() {
+  size_t handled = 0;
+  EncodedMessage encoded;
+  pw_tokenizer_Payload payload;
+
+  while (true) {
+    const StatusWithSize result = EncodeNext(
+        payload,
+        std::span(reinterpret_cast<uint8_t*>(&encoded), sizeof(encoded)));
+    if (!result.ok()) {
+      return handled;
+    }
+    pw_tokenizer_HandleEncodedMessageWithPayload(
+        payload, reinterpret_cast<const uint8_t*>(&encoded), result.size());
+    handled += 1;
+  }
+}
+
+DeferredEncoder& GlobalDeferredEncoder() { return global_deferred_encoder; }
+
+extern "C" void _pw_tokenizer_CaptureWithPayload(pw_tokenizer_Payload payload,
+                                                 pw_tokenizer_Token token,
+                                                 _pw_tokenizer_ArgTypes types,
+                                                 ...) {
+  va_list args;
+  va_start(args, types);
+  global_deferred_encoder.Capture(payload, token, types, args);
+  va_end(args);
+}
+
+}  // namespace pw::tokenizer
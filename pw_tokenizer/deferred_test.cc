@@ -0,0 +1,208 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Route PW_TOKENIZE_TO_GLOBAL_HANDLER_WITH_PAYLOAD to the deferred encoder.
+#undef PW_TOKENIZER_CFG_DEFERRED_ENCODING
+#define PW_TOKENIZER_CFG_DEFERRED_ENCODING 1
+
+#include "pw_tokenizer/deferred.h"
+
+#include <array>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::tokenizer {
+namespace {
+
+constexpr pw_tokenizer_Payload kPayload = 0xC0FFEE;
+constexpr pw_tokenizer_Token kToken = 0x12345678;
+
+Status CaptureArgs(DeferredEncoder& encoder,
+                   pw_tokenizer_Token token,
+                   _pw_tokenizer_ArgTypes types,
+                   ...) {
+  va_list args;
+  va_start(args, types);
+  const Status status = encoder.Capture(kPayload, token, types, args);
+  va_end(args);
+  return status;
+}
+
+#define CAPTURE(encoder, ...)         \
+  CaptureArgs(encoder,                \
+              kToken,                 \
+              PW_TOKENIZER_ARG_TYPES(__VA_ARGS__) PW_COMMA_ARGS(__VA_ARGS__))
+
+// Captures and encodes a message and checks that it matches the message that
+// the global handler macros encode immediately.
+#define EXPECT_DEFERRED_MATCHES(...)                                           \
+  do {                                                                         \
+    std::array<uint8_t, PW_TOKENIZER_CFG_ENCODING_BUFFER_SIZE_BYTES> expected; \
+    size_t expected_size = expected.size();                                    \
+    _pw_tokenizer_ToBuffer(expected.data(),                                    \
+                           &expected_size,                                     \
+                           kToken,                                             \
+                           PW_TOKENIZER_ARG_TYPES(__VA_ARGS__)                 \
+                               PW_COMMA_ARGS(__VA_ARGS__));                    \
+    ASSERT_EQ(OkStatus(), CAPTURE(encoder_, __VA_ARGS__));                     \
+    pw_tokenizer_Payload payload = 0;                                          \
+    StatusWithSize result = encoder_.EncodeNext(payload, output_);             \
+    ASSERT_EQ(OkStatus(), result.status());                                    \
+    EXPECT_EQ(kPayload, payload);                                              \
+    ASSERT_EQ(expected_size, result.size());                                   \
+    EXPECT_EQ(0,                                                               \
+              std::memcmp(expected.data(), output_.data(), result.size()));    \
+  } while (0)
+
+class DeferredEncoderTest : public ::testing::Test {
+ protected:
+  DeferredEncoderTest() : output_{} {
+    EXPECT_EQ(OkStatus(), encoder_.SetBuffer(buffer_));
+  }
+
+  std::array<std::byte, 256> buffer_;
+  std::array<uint8_t, 64> output_;
+  DeferredEncoder encoder_;
+};
+
+TEST_F(DeferredEncoderTest, Empty_ReturnsOutOfRange) {
+  pw_tokenizer_Payload payload = 0;
+  EXPECT_EQ(Status::OutOfRange(),
+            encoder_.EncodeNext(payload, output_).status());
+}
+
+TEST_F(DeferredEncoderTest, NoArguments) { EXPECT_DEFERRED_MATCHES(); }
+
+TEST_F(DeferredEncoderTest, Integers) {
+  EXPECT_DEFERRED_MATCHES(0, -1, 1, INT32_MAX, INT32_MIN);
+  EXPECT_DEFERRED_MATCHES(int64_t(-1), INT64_MAX, INT64_MIN, 'c', true);
+}
+
+TEST_F(DeferredEncoderTest, FloatingPoint) {
+  EXPECT_DEFERRED_MATCHES(1.5f, -2.25, 0.0);
+}
+
+TEST_F(DeferredEncoderTest, Strings) {
+  const char* null_string = nullptr;
+  EXPECT_DEFERRED_MATCHES("", "Hello", null_string, 123);
+}
+
+TEST_F(DeferredEncoderTest, LongString_IsTruncated) {
+  EXPECT_DEFERRED_MATCHES(
+      "This string is longer than the encoding buffer, so it cannot be "
+      "encoded in full and must be truncated.");
+}
+
+TEST_F(DeferredEncoderTest, StringIsCopiedWhenCaptured) {
+  char string[] = "before";
+  ASSERT_EQ(OkStatus(), CAPTURE(encoder_, static_cast<const char*>(string)));
+  std::memcpy(string, "after!", sizeof(string));
+
+  pw_tokenizer_Payload payload = 0;
+  StatusWithSize result = encoder_.EncodeNext(payload, output_);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(4u + 7u, result.size());
+  EXPECT_EQ(0, std::memcmp("\6before", &output_[4], 7));
+}
+
+TEST_F(DeferredEncoderTest, MessagesAreEncodedInOrder) {
+  ASSERT_EQ(OkStatus(), CAPTURE(encoder_, 1));
+  ASSERT_EQ(OkStatus(), CAPTURE(encoder_, 2));
+
+  pw_tokenizer_Payload payload = 0;
+  ASSERT_EQ(5u, encoder_.EncodeNext(payload, output_).size());
+  EXPECT_EQ(2u, output_[4]);  // zig-zag encoded 1
+  ASSERT_EQ(5u, encoder_.EncodeNext(payload, output_).size());
+  EXPECT_EQ(4u, output_[4]);  // zig-zag encoded 2
+  EXPECT_EQ(Status::OutOfRange(),
+            encoder_.EncodeNext(payload, output_).status());
+}
+
+TEST_F(DeferredEncoderTest, SmallOutput_OmitsArguments) {
+  ASSERT_EQ(OkStatus(), CAPTURE(encoder_, 1, 2, 3));
+
+  pw_tokenizer_Payload payload = 0;
+  StatusWithSize result =
+      encoder_.EncodeNext(payload, std::span(output_).first(6));
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(6u, result.size());
+}
+
+TEST_F(DeferredEncoderTest, OutputTooSmallForToken_DiscardsMessage) {
+  ASSERT_EQ(OkStatus(), CAPTURE(encoder_, 1));
+
+  pw_tokenizer_Payload payload = 0;
+  EXPECT_EQ(Status::ResourceExhausted(),
+            encoder_.EncodeNext(payload, std::span(output_).first(3)).status());
+  EXPECT_EQ(Status::OutOfRange(),
+            encoder_.EncodeNext(payload, output_).status());
+}
+
+TEST_F(DeferredEncoderTest, Full_DropsMessages) {
+  Status status;
+  size_t captured = 0;
+  while ((status = CAPTURE(encoder_, "Fill the buffer")).ok()) {
+    captured += 1;
+  }
+
+  EXPECT_EQ(Status::ResourceExhausted(), status);
+  EXPECT_EQ(1u, encoder_.dropped());
+
+  pw_tokenizer_Payload payload = 0;
+  for (size_t i = 0; i < captured; ++i) {
+    EXPECT_EQ(OkStatus(), encoder_.EncodeNext(payload, output_).status());
+  }
+  EXPECT_EQ(OkStatus(), CAPTURE(encoder_, "Room again"));
+}
+
+TEST(DeferredEncoder, NoBuffer_DropsMessages) {
+  DeferredEncoder encoder;
+  EXPECT_EQ(Status::FailedPrecondition(), CAPTURE(encoder, 1));
+  EXPECT_EQ(1u, encoder.dropped());
+}
+
+pw_tokenizer_Payload handled_payload;
+std::array<uint8_t, 64> handled_message;
+size_t handled_size;
+
+TEST(GlobalDeferredEncoder, Macro_CapturesForHandler) {
+  std::array<std::byte, 128> buffer;
+  ASSERT_EQ(OkStatus(), GlobalDeferredEncoder().SetBuffer(buffer));
+
+  handled_size = 0;
+  PW_TOKENIZE_TO_GLOBAL_HANDLER_WITH_PAYLOAD(7, "%d %s", -1, "ok");
+  EXPECT_EQ(0u, handled_size);  // Nothing is encoded until it is drained.
+
+  EXPECT_EQ(1u, GlobalDeferredEncoder().HandleCapturedMessages());
+  EXPECT_EQ(7u, handled_payload);
+  ASSERT_EQ(4u + 1u + 3u, handled_size);
+  EXPECT_EQ(0, std::memcmp("\1\2ok", &handled_message[4], 4));
+
+  EXPECT_EQ(0u, GlobalDeferredEncoder().HandleCapturedMessages());
+}
+
+}  // namespace
+
+extern "C" void pw_tokenizer_HandleEncodedMessageWithPayload(
+    pw_tokenizer_Payload payload,
+    const uint8_t encoded_message[],
+    size_t size_bytes) {
+  handled_payload = payload;
+  handled_size = size_bytes;
+  std::memcpy(handled_message.data(), encoded_message, size_bytes);
+}
+
+}  // namespace pw::tokenizer
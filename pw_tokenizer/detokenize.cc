@@ -15,6 +15,7 @@
 #include "pw_tokenizer/detokenize.h"
 
 #include <algorithm>
+#include <iterator>
 
 #include "pw_tokenizer/internal/decode.h"
 
@@ -33,6 +34,10 @@ std::string UnknownTokenMessage(uint32_t value) {
   return output;
 }
 
+uint32_t ReadToken(std::span<const uint8_t> encoded) {
+  return encoded[3] << 24 | encoded[2] << 16 | encoded[1] << 8 | encoded[0];
+}
+
 // Decoding result with the date removed, for sorting.
 using DecodingResult = std::pair<DecodedFormatString, uint32_t>;
 
@@ -65,6 +70,20 @@ bool IsBetterResult(const DecodingResult& lhs, const DecodingResult& rhs) {
   return lhs.second > rhs.second;
 }
 
+// FNV-1a, which is fast for the short messages that are typically cached.
+uint64_t HashMessage(std::span<const uint8_t> encoded) {
+  uint64_t hash = 0xcbf29ce484222325u;
+  for (uint8_t byte : encoded) {
+    hash = (hash ^ byte) * 0x100000001b3u;
+  }
+  return hash;
+}
+
+std::string_view AsString(std::span<const uint8_t> encoded) {
+  return std::string_view(reinterpret_cast<const char*>(encoded.data()),
+                          encoded.size());
+}
+
 }  // namespace
 
 DetokenizedString::DetokenizedString(
@@ -97,7 +116,52 @@ std::string DetokenizedString::BestStringWithErrors() const {
   return matches_[0].value_with_errors();
 }
 
-Detokenizer::Detokenizer(const TokenDatabase& database) {
+Detokenizer::ResultCache& Detokenizer::ResultCache::operator=(
+    const ResultCache& other) {
+  capacity_ = other.capacity_;
+  entries_.clear();
+  index_.clear();
+  return *this;
+}
+
+const Detokenizer::ResultCache::Entry* Detokenizer::ResultCache::Find(
+    uint64_t hash, std::span<const uint8_t> encoded) {
+  const auto found = index_.find(hash);
+  if (found == index_.end() || found->second->encoded != AsString(encoded)) {
+    return nullptr;
+  }
+  entries_.splice(entries_.begin(), entries_, found->second);
+  return &entries_.front();
+}
+
+void Detokenizer::ResultCache::Insert(uint64_t hash,
+                                      std::span<const uint8_t> encoded,
+                                      std::string_view value,
+                                      bool ok) {
+  const auto found = index_.find(hash);
+
+  // Reuse the entry for a colliding message or the least recently used entry.
+  std::list<Entry>::iterator entry;
+  if (found != index_.end()) {
+    entry = found->second;
+  } else if (entries_.size() < capacity_) {
+    entry = entries_.emplace(entries_.begin());
+  } else {
+    entry = std::prev(entries_.end());
+    index_.erase(entry->hash);
+  }
+
+  entries_.splice(entries_.begin(), entries_, entry);
+  entry->hash = hash;
+  entry->encoded.assign(AsString(encoded));
+  entry->value.assign(value);
+  entry->ok = ok;
+  index_[hash] = entry;
+}
+
+Detokenizer::Detokenizer(const TokenDatabase& database,
+                         size_t result_cache_size)
+    : cache_(result_cache_size) {
   for (const auto& entry : database) {
     database_[entry.token].emplace_back(entry.string, entry.date_removed);
   }
@@ -110,8 +174,7 @@ DetokenizedString Detokenizer::Detokenize(
     return DetokenizedString();
   }
 
-  const uint32_t token =
-      encoded[3] << 24 | encoded[2] << 16 | encoded[1] << 8 | encoded[0];
+  const uint32_t token = ReadToken(encoded);
 
   const auto result = database_.find(token);
 
@@ -122,4 +185,47 @@ DetokenizedString Detokenizer::Detokenize(
                            encoded.subspan(sizeof(token)));
 }
 
+bool Detokenizer::DetokenizeTo(std::span<const uint8_t> encoded,
+                               std::string& output) const {
+  if (!cache_.enabled()) {
+    return AppendBestString(encoded, output);
+  }
+
+  const uint64_t hash = HashMessage(encoded);
+  if (const ResultCache::Entry* cached = cache_.Find(hash, encoded)) {
+    output.append(cached->value);
+    return cached->ok;
+  }
+
+  const size_t start = output.size();
+  const bool ok = AppendBestString(encoded, output);
+  cache_.Insert(hash, encoded, std::string_view(output).substr(start), ok);
+  return ok;
+}
+
+bool Detokenizer::AppendBestString(std::span<const uint8_t> encoded,
+                                   std::string& output) const {
+  if (encoded.size() < sizeof(uint32_t)) {
+    return false;
+  }
+
+  const uint32_t token = ReadToken(encoded);
+
+  const auto result = database_.find(token);
+  if (result == database_.end()) {
+    return false;
+  }
+
+  const std::span<const uint8_t> arguments = encoded.subspan(sizeof(token));
+
+  // Without collisions, format the only match directly into the output.
+  if (result->second.size() == 1u) {
+    return result->second[0].first.AppendTo(arguments, output);
+  }
+
+  const DetokenizedString detokenized(token, result->second, arguments);
+  output.append(detokenized.BestString());
+  return detokenized.ok();
+}
+
 }  // namespace pw::tokenizer
@@ -18,11 +18,13 @@
 // argument formats at random, when then decodes this data and tries to match
 // it to tokens in the database.
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <vector>
 
+#include "pw_fuzzer/execution_budget.h"
 #include "pw_fuzzer/fuzzed_data_provider.h"
 #include "pw_preprocessor/util.h"
 #include "pw_tokenizer/detokenize.h"
@@ -57,10 +59,17 @@ alignas(TokenDatabase::RawEntry) constexpr char kBasicData[] =
     "333\0"
     "FOUR";
 
+// Detokenizing should take time linear in the size of the input. Allocations
+// also grow with the input, since each detokenized string is allocated, so
+// only time is limited.
+constexpr auto kBudget = fuzzer::ExecutionBudget().Time(
+    std::chrono::milliseconds(10), std::chrono::microseconds(20));
+
 }  // namespace
 
 extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
   static Detokenizer detokenizer(TokenDatabase::Create<kBasicData>());
+  fuzzer::BudgetScope budget(kBudget, size);
 
   FuzzedDataProvider provider(data, size);
 
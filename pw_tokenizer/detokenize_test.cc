@@ -14,7 +14,9 @@
 
 #include "pw_tokenizer/detokenize.h"
 
+#include <string>
 #include <string_view>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -164,6 +166,125 @@ TEST_F(DetokenizeWithArgs, Successful) {
   }
 }
 
+TEST_F(DetokenizeWithArgs, DetokenizeTo_MatchesBestString) {
+  std::string output;
+  for (std::string_view data : {"\x0A\x0B\x0C\x0D\5force\4Luke"sv,
+                                "\x0E\x0F\x00\x01\4\4them"sv,
+                                "\xAA\xAA\xAA\xAA\xfc\x01"sv,
+                                "\x00\x00\x00\x00MORE data"sv,
+                                "\x0A\x0B\x0C\x0D\5force"sv,
+                                "\x0E\x0F\x00\x01\xFF"sv,
+                                "\x23\xab\xc9\x87"sv,
+                                "\x0A\x0B"sv}) {
+    const DetokenizedString expected = detok_.Detokenize(data);
+    output.clear();
+    EXPECT_EQ(detok_.DetokenizeTo(
+                  std::span(reinterpret_cast<const uint8_t*>(data.data()),
+                            data.size()),
+                  output),
+              expected.ok());
+    EXPECT_EQ(output, expected.BestString());
+  }
+}
+
+TEST_F(DetokenizeWithArgs, DetokenizeBatch) {
+  constexpr std::string_view kLuke = "\x0A\x0B\x0C\x0D\5force\4Luke"sv;
+  constexpr std::string_view kThem = "\x0E\x0F\x00\x01\4\4them"sv;
+  auto bytes = [](std::string_view data) {
+    return std::span(reinterpret_cast<const uint8_t*>(data.data()),
+                     data.size());
+  };
+  const std::span<const uint8_t> messages[] = {
+      bytes(kLuke), bytes("\x23\xab\xc9\x87"sv), bytes(kThem)};
+
+  std::vector<std::string> results;
+  detok_.DetokenizeBatch(messages, [&results](std::string_view message) {
+    results.emplace_back(message);
+  });
+
+  ASSERT_EQ(results.size(), 3u);
+  EXPECT_EQ(results[0], "Use the force, Luke.");
+  EXPECT_EQ(results[1], "");
+  EXPECT_EQ(results[2], "Now there are 2 of them!");
+}
+
+class DetokenizeWithResultCache : public ::testing::Test {
+ protected:
+  DetokenizeWithResultCache() : detok_(kWithArgs, 2), uncached_(kWithArgs) {}
+
+  // Checks that the cached result matches the uncached result. Detokenizes
+  // into a non-empty string to check that only the new text is cached.
+  void ExpectMatchesUncached(std::string_view data) {
+    const std::span bytes(reinterpret_cast<const uint8_t*>(data.data()),
+                          data.size());
+    std::string expected = "> ";
+    const bool expected_ok = uncached_.DetokenizeTo(bytes, expected);
+
+    std::string output = "> ";
+    EXPECT_EQ(detok_.DetokenizeTo(bytes, output), expected_ok);
+    EXPECT_EQ(output, expected);
+  }
+
+  Detokenizer detok_;
+  Detokenizer uncached_;
+};
+
+constexpr std::string_view kCacheTestMessages[] = {
+    "\x0A\x0B\x0C\x0D\5force\4Luke"sv,
+    "\x0E\x0F\x00\x01\4\4them"sv,
+    "\x0E\x0F\x00\x01\6\4them"sv,
+    "\x0A\x0B\x0C\x0D\5force"sv,
+    "\x23\xab\xc9\x87"sv,
+    "\x0A\x0B"sv,
+};
+
+TEST_F(DetokenizeWithResultCache, RepeatedMessages_MatchUncached) {
+  for (int i = 0; i < 3; ++i) {
+    for (std::string_view data : kCacheTestMessages) {
+      ExpectMatchesUncached(data);
+      ExpectMatchesUncached(data);
+    }
+  }
+}
+
+TEST_F(DetokenizeWithResultCache, EvictedMessages_MatchUncached) {
+  for (int i = 0; i < 3; ++i) {
+    for (std::string_view data : kCacheTestMessages) {
+      ExpectMatchesUncached(data);
+    }
+  }
+}
+
+TEST_F(DetokenizeWithResultCache, Copy_MatchesUncached) {
+  ExpectMatchesUncached(kCacheTestMessages[0]);
+
+  Detokenizer copy = detok_;
+  detok_ = copy;
+  for (std::string_view data : kCacheTestMessages) {
+    ExpectMatchesUncached(data);
+  }
+}
+
+TEST_F(DetokenizeWithResultCache, DetokenizeBatch) {
+  auto bytes = [](std::string_view data) {
+    return std::span(reinterpret_cast<const uint8_t*>(data.data()),
+                     data.size());
+  };
+  const std::span<const uint8_t> messages[] = {bytes(kCacheTestMessages[1]),
+                                               bytes(kCacheTestMessages[0]),
+                                               bytes(kCacheTestMessages[1])};
+
+  std::vector<std::string> results;
+  detok_.DetokenizeBatch(messages, [&results](std::string_view message) {
+    results.emplace_back(message);
+  });
+
+  ASSERT_EQ(results.size(), 3u);
+  EXPECT_EQ(results[0], "Now there are 2 of them!");
+  EXPECT_EQ(results[1], "Use the force, Luke.");
+  EXPECT_EQ(results[2], "Now there are 2 of them!");
+}
+
 TEST_F(DetokenizeWithArgs, ExtraDataError) {
   auto error = detok_.Detokenize("\x00\x00\x00\x00MORE data"sv);
   EXPECT_FALSE(error.ok());
@@ -280,6 +401,25 @@ TEST_F(DetokenizeWithCollisions, Collision_PreferStillPresentString) {
   }
 }
 
+TEST_F(DetokenizeWithCollisions, DetokenizeTo_UsesBestMatch) {
+  std::string output;
+  EXPECT_FALSE(detok_.DetokenizeTo(
+      std::span(reinterpret_cast<const uint8_t*>("\xBB\xBB\xBB\xBB\x00"), 5),
+      output));
+  EXPECT_EQ(output, "Two ints 0 %d");
+}
+
+TEST_F(DetokenizeWithCollisions, DetokenizeTo_CachedUsesBestMatch) {
+  Detokenizer cached(kWithCollisions, 4);
+  for (int i = 0; i < 2; ++i) {
+    std::string output;
+    EXPECT_FALSE(cached.DetokenizeTo(
+        std::span(reinterpret_cast<const uint8_t*>("\xBB\xBB\xBB\xBB\x00"), 5),
+        output));
+    EXPECT_EQ(output, "Two ints 0 %d");
+  }
+}
+
 TEST_F(DetokenizeWithCollisions, Collision_TracksAllMatches) {
   auto result = detok_.Detokenize("\0\0\0\0"sv);
   EXPECT_EQ(result.matches().size(), 7u);
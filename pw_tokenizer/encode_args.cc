@@ -15,6 +15,8 @@
 #include "pw_tokenizer_private/encode_args.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstring>
 
 #include "pw_preprocessor/compiler.h"
@@ -54,10 +56,100 @@ size_t EncodeFloat(float value, const std::span<uint8_t>& output) {
   return sizeof(value);
 }
 
-size_t EncodeString(const char* string, const std::span<uint8_t>& output) {
-  // The top bit of the status byte indicates if the string was truncated.
-  static constexpr size_t kMaxStringLength = 0x7Fu;
+// The top bit of the status byte indicates if the string was truncated.
+constexpr size_t kMaxStringLength = 0x7Fu;
+
+#if PW_TOKENIZER_CFG_INTERNED_STRINGS > 0
+
+static_assert(PW_TOKENIZER_CFG_INTERNED_STRINGS < 0x80u,
+              "PW_TOKENIZER_CFG_INTERNED_STRINGS must be less than 128, so "
+              "that IDs are encoded in a single byte");
+
+// Strings shorter than a reference are not worth interning. Announcements
+// must fit in the space of the longest plain string encoding.
+constexpr size_t kMinInternedStringLength = 3;
+constexpr size_t kMaxInternedStringLength = kMaxStringLength - 3;
+
+// Remembers recently encoded strings by address and hash. A string is only
+// referenced if both match, so a buffer that was reused for different contents
+// is announced again. Entries are replaced round-robin.
+class InternedStrings {
+ public:
+  // Encodes a reference to or an announcement of the string. Returns 0 if the
+  // string should be encoded as a plain string instead.
+  size_t Encode(const char* string, const std::span<uint8_t>& output) {
+    // Find the length and hash the contents in one pass.
+    size_t length = 0;
+    uint32_t hash = 0;
+    while (string[length] != '\0') {
+      if (length == kMaxInternedStringLength) {
+        return 0;
+      }
+      hash = hash * 65599u + static_cast<uint8_t>(string[length]);
+      length += 1;
+    }
+
+    // Encoding may be interrupted by another message. Rather than wait, send
+    // the interrupting message's strings in full.
+    if (length < kMinInternedStringLength || output.size() < 2u ||
+        busy_.test_and_set(std::memory_order_acquire)) {
+      return 0;
+    }
+
+    if (clear_requested_.exchange(false, std::memory_order_relaxed)) {
+      entries_ = {};
+      next_ = 0;
+    }
+
+    size_t encoded_bytes = 0;
+
+    for (size_t id = 0; id < entries_.size(); ++id) {
+      if (entries_[id].string == string && entries_[id].hash == hash) {
+        output[0] = kInternedStringReference;
+        output[1] = static_cast<uint8_t>(id);
+        encoded_bytes = 2;
+        break;
+      }
+    }
+
+    if (encoded_bytes == 0u && output.size() >= length + 3) {
+      const size_t id = next_;
+      next_ = (next_ + 1) % entries_.size();
+      entries_[id] = {string, hash};
+
+      output[0] = kInternedStringAnnouncement;
+      output[1] = static_cast<uint8_t>(id);
+      output[2] = static_cast<uint8_t>(length);
+      std::memcpy(&output[3], string, length);
+      encoded_bytes = length + 3;
+    }
+
+    busy_.clear(std::memory_order_release);
+    return encoded_bytes;
+  }
+
+  // Forgets all strings the next time a string is encoded.
+  void Clear() { clear_requested_.store(true, std::memory_order_relaxed); }
+
+ private:
+  struct Entry {
+    const char* string;
+    uint32_t hash;
+  };
 
+  std::array<Entry, PW_TOKENIZER_CFG_INTERNED_STRINGS> entries_ = {};
+  size_t next_ = 0;
+  std::atomic_flag busy_ = ATOMIC_FLAG_INIT;
+  std::atomic<bool> clear_requested_{false};
+};
+
+InternedStrings interned_strings;
+
+#endif  // PW_TOKENIZER_CFG_INTERNED_STRINGS > 0
+
+}  // namespace
+
+size_t EncodeString(const char* string, const std::span<uint8_t>& output) {
   if (output.empty()) {  // At least one byte is needed for the status/size.
     return 0;
   }
@@ -66,6 +158,13 @@ size_t EncodeString(const char* string, const std::span<uint8_t>& output) {
     string = "NULL";
   }
 
+#if PW_TOKENIZER_CFG_INTERNED_STRINGS > 0
+  const size_t interned_bytes = interned_strings.Encode(string, output);
+  if (interned_bytes != 0u) {
+    return interned_bytes;
+  }
+#endif  // PW_TOKENIZER_CFG_INTERNED_STRINGS > 0
+
   // Subtract 1 to save room for the status byte.
   const size_t max_bytes = std::min(output.size(), kMaxStringLength) - 1;
 
@@ -87,8 +186,6 @@ size_t EncodeString(const char* string, const std::span<uint8_t>& output) {
   return bytes_to_copy + 1;  // include the status byte in the total
 }
 
-}  // namespace
-
 size_t EncodeArgs(_pw_tokenizer_ArgTypes types,
                   va_list args,
                   std::span<uint8_t> output) {
@@ -131,5 +228,21 @@ size_t EncodeArgs(_pw_tokenizer_ArgTypes types,
   return encoded_bytes;
 }
 
+// The inline encoding functions call this to encode strings with interning.
+#if _PW_TOKENIZER_INLINE_ENCODING && PW_TOKENIZER_CFG_INTERNED_STRINGS > 0
+
+size_t internal::EncodeInternedString(const char* string, uint8_t* output) {
+  return tokenizer::EncodeString(
+      string, std::span(output, internal::kMaxEncodedStringSizeBytes));
+}
+
+#endif  // _PW_TOKENIZER_INLINE_ENCODING && PW_TOKENIZER_CFG_INTERNED_STRINGS
+
+extern "C" void pw_tokenizer_ClearInternedStrings(void) {
+#if PW_TOKENIZER_CFG_INTERNED_STRINGS > 0
+  interned_strings.Clear();
+#endif  // PW_TOKENIZER_CFG_INTERNED_STRINGS > 0
+}
+
 }  // namespace tokenizer
 }  // namespace pw
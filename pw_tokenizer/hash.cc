@@ -16,6 +16,43 @@
 
 namespace pw {
 namespace tokenizer {
+namespace {
+
+// Hashes four characters per iteration. The four products are independent of
+// each other, so they can be computed in parallel, instead of waiting on the
+// previous character's coefficient. This is equivalent to
+// PwTokenizer65599FixedLengthHash.
+uint32_t UnrolledFixedLengthHash(const uint8_t* string,
+                                 size_t string_length,
+                                 size_t hash_length)
+    PW_NO_SANITIZE("unsigned-integer-overflow") {
+  constexpr uint32_t k1 = k65599HashConstant;
+  constexpr uint32_t k2 = k1 * k1;
+  constexpr uint32_t k3 = k2 * k1;
+  constexpr uint32_t k4 = k3 * k1;
+
+  const size_t length = string_length < hash_length ? string_length
+                                                    : hash_length;
+
+  uint32_t hash = string_length;
+  uint32_t coefficient = k1;
+  size_t i = 0;
+
+  for (; i + 4 <= length; i += 4) {
+    hash += coefficient * (string[i] + k1 * string[i + 1] +
+                           k2 * string[i + 2] + k3 * string[i + 3]);
+    coefficient *= k4;
+  }
+
+  for (; i < length; ++i) {
+    hash += coefficient * string[i];
+    coefficient *= k1;
+  }
+
+  return hash;
+}
+
+}  // namespace
 
 extern "C" uint32_t pw_tokenizer_65599FixedLengthHash(const char* string,
                                                       size_t string_length,
@@ -24,5 +61,18 @@ extern "C" uint32_t pw_tokenizer_65599FixedLengthHash(const char* string,
       std::string_view(string, string_length), hash_length);
 }
 
+extern "C" void pw_tokenizer_65599FixedLengthHashes(const char* strings,
+                                                    const size_t* offsets,
+                                                    size_t string_count,
+                                                    size_t hash_length,
+                                                    uint32_t* hashes) {
+  const uint8_t* const data = reinterpret_cast<const uint8_t*>(strings);
+
+  for (size_t i = 0; i < string_count; ++i) {
+    hashes[i] = UnrolledFixedLengthHash(
+        data + offsets[i], offsets[i + 1] - offsets[i], hash_length);
+  }
+}
+
 }  // namespace tokenizer
 }  // namespace pw
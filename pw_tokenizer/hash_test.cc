@@ -18,6 +18,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <string>
 
 #include "gtest/gtest.h"
 #include "pw_preprocessor/util.h"
@@ -56,6 +57,28 @@ TEST(Hashing, GeneratedCasesAtRuntime) {
   }
 }
 
+TEST(Hashing, MultipleStrings_MatchGeneratedCases) {
+  for (const auto [string, hash_length, python_hash, macro_hash] : kHashTests) {
+    // Hash each string along with a prefix of itself to check the offsets.
+    const std::string_view prefix = string.substr(0, string.size() / 2);
+    const std::string strings = std::string(string) + std::string(prefix);
+    const size_t offsets[] = {0, string.size(), strings.size()};
+    uint32_t hashes[2] = {};
+
+    pw_tokenizer_65599FixedLengthHashes(
+        strings.data(), offsets, 2, hash_length, hashes);
+    EXPECT_EQ(hashes[0], python_hash);
+    EXPECT_EQ(hashes[1], PwTokenizer65599FixedLengthHash(prefix, hash_length));
+  }
+}
+
+TEST(Hashing, MultipleStrings_Empty) {
+  const size_t offsets[] = {0};
+  uint32_t hash = 123;
+  pw_tokenizer_65599FixedLengthHashes("", offsets, 0, 80, &hash);
+  EXPECT_EQ(123u, hash);
+}
+
 // Gets the size of the string, excluding the null terminator. A uint32_t is
 // used instead of a size_t since the hash calculation requires a uint32_t.
 template <uint32_t size_with_null>
@@ -0,0 +1,199 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Enable inline encoding for this test only. The inline encoding functions are
+// declared in pw_tokenizer/internal/inline_encoding.h, which tokenize.h
+// includes when this option is set.
+#undef PW_TOKENIZER_CFG_INLINE_ENCODING
+#define PW_TOKENIZER_CFG_INLINE_ENCODING 1
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::tokenizer::internal {
+namespace {
+
+static_assert(_PW_TOKENIZER_INLINE_ENCODING == 1);
+
+static_assert(kMaxEncodedSizeBytes<> == 4u);
+static_assert(kMaxEncodedSizeBytes<int, char, bool> == 4u + 3 * 5);
+static_assert(kMaxEncodedSizeBytes<long long, double> == 4u + 10 + 4);
+static_assert(kMaxEncodedSizeBytes<const char*> == 4u + 127);
+
+constexpr pw_tokenizer_Token kToken = 0x12345678;
+
+enum Color { kRed = -1, kBlue = 1000 };
+
+using Buffer = std::array<uint8_t, 256>;
+
+// Packs the argument types like PW_TOKENIZER_ARG_TYPES, which cannot expand a
+// parameter pack.
+template <typename... Args>
+constexpr _pw_tokenizer_ArgTypes ArgTypes() {
+  _pw_tokenizer_ArgTypes types = sizeof...(Args);
+  unsigned shift = PW_TOKENIZER_TYPE_COUNT_SIZE_BITS;
+  ((types |= VarargsType<Args>() << shift, shift += 2), ...);
+  return types;
+}
+
+static_assert(ArgTypes<>() == PW_TOKENIZER_ARG_TYPES());
+static_assert(ArgTypes<int, double, const char*, int64_t>() ==
+              PW_TOKENIZER_ARG_TYPES(1, 1.0, "", int64_t(1)));
+
+// Encodes with the varargs function, which the inline encoding must match.
+template <typename... Args>
+size_t EncodeVarargs(Buffer& buffer, size_t size, Args... args) {
+  _pw_tokenizer_ToBuffer(buffer.data(),
+                         &size,
+                         kToken,
+                         ArgTypes<Args...>(),
+                         args...);
+  return size;
+}
+
+template <typename... Args>
+size_t EncodeInline(Buffer& buffer, size_t size, Args... args) {
+  ToBuffer(buffer.data(),
+           &size,
+           kToken,
+           ArgTypes<Args...>(),
+           args...);
+  return size;
+}
+
+// Checks that both encodings produce the same result for every argument.
+template <typename... Args>
+void ExpectSameEncoding(Args... args) {
+  Buffer expected = {};
+  Buffer actual = {};
+  const size_t expected_size =
+      EncodeVarargs(expected, expected.size(), args...);
+  const size_t actual_size = EncodeInline(actual, actual.size(), args...);
+
+  ASSERT_EQ(expected_size, actual_size);
+  EXPECT_EQ(0, std::memcmp(expected.data(), actual.data(), actual_size));
+}
+
+TEST(InlineEncoding, NoArguments) {
+  Buffer buffer = {};
+  EXPECT_EQ(4u, EncodeInline(buffer, buffer.size()));
+  EXPECT_EQ(0x78u, buffer[0]);
+  EXPECT_EQ(0x12u, buffer[3]);
+}
+
+TEST(InlineEncoding, Integers_MatchVarargs) {
+  ExpectSameEncoding(0);
+  ExpectSameEncoding(1, -1, 63, -64, 64, -65);
+  ExpectSameEncoding(INT32_MAX, INT32_MIN, UINT32_MAX);
+  ExpectSameEncoding(static_cast<short>(-300),
+                     static_cast<unsigned char>(255));
+  ExpectSameEncoding('a', true, false);
+  ExpectSameEncoding(kRed, kBlue);
+}
+
+TEST(InlineEncoding, Int64_MatchesVarargs) {
+  ExpectSameEncoding(static_cast<long long>(0));
+  ExpectSameEncoding(INT64_MAX, INT64_MIN, UINT64_MAX);
+  ExpectSameEncoding(
+      static_cast<int64_t>(-1), 5, static_cast<int64_t>(1) << 40);
+}
+
+TEST(InlineEncoding, FloatingPoint_MatchesVarargs) {
+  ExpectSameEncoding(0.0f, -1.5f, 3.25);
+  ExpectSameEncoding(1, 2.5, static_cast<int64_t>(3));
+}
+
+TEST(InlineEncoding, Strings_MatchVarargs) {
+  ExpectSameEncoding("");
+  ExpectSameEncoding("Hello", ", world!");
+
+  const char* null_string = nullptr;
+  ExpectSameEncoding(null_string);
+
+  char long_string[200];
+  std::memset(long_string, 'x', sizeof(long_string) - 1);
+  long_string[sizeof(long_string) - 1] = '\0';
+  ExpectSameEncoding(static_cast<const char*>(long_string));
+  ExpectSameEncoding(1, static_cast<const char*>(long_string), 2);
+}
+
+TEST(InlineEncoding, Pointers_MatchVarargs) {
+  int value = 0;
+  ExpectSameEncoding(&value, static_cast<const void*>(&value));
+  ExpectSameEncoding(nullptr);
+}
+
+TEST(InlineEncoding, SmallBuffer_FallsBackToVarargs) {
+  Buffer expected = {};
+  Buffer actual = {};
+
+  // Too small for a maximum-length string, but large enough for this one.
+  const size_t expected_size = EncodeVarargs(expected, 16, "Hi!", 123);
+  const size_t actual_size = EncodeInline(actual, 16, "Hi!", 123);
+  ASSERT_EQ(expected_size, actual_size);
+  EXPECT_EQ(0, std::memcmp(expected.data(), actual.data(), actual_size));
+
+  // Too small for the string, which is truncated.
+  EXPECT_EQ(EncodeVarargs(expected, 6, "Hello"),
+            EncodeInline(actual, 6, "Hello"));
+  EXPECT_EQ(0, std::memcmp(expected.data(), actual.data(), 6));
+
+  // Too small for the token.
+  EXPECT_EQ(0u, EncodeInline(actual, 3, 1));
+}
+
+Buffer callback_buffer;
+size_t callback_size;
+
+void SetCallbackBuffer(const uint8_t* data, size_t size) {
+  std::memcpy(callback_buffer.data(), data, size);
+  callback_size = size;
+}
+
+TEST(InlineEncoding, ToCallback_MatchesVarargs) {
+  Buffer expected = {};
+  const size_t expected_size =
+      EncodeVarargs(expected, expected.size(), -5, 2.5f, "hi");
+
+  callback_size = 0;
+  ToCallback(SetCallbackBuffer,
+             kToken,
+             PW_TOKENIZER_ARG_TYPES(-5, 2.5f, "hi"),
+             -5,
+             2.5f,
+             "hi");
+  ASSERT_EQ(expected_size, callback_size);
+  EXPECT_EQ(
+      0, std::memcmp(expected.data(), callback_buffer.data(), callback_size));
+}
+
+TEST(InlineEncoding, Macros_UseInlineEncoding) {
+  Buffer buffer = {};
+  size_t size = buffer.size();
+  PW_TOKENIZE_TO_BUFFER(buffer.data(), &size, "The answer: %d", 42);
+  ASSERT_EQ(5u, size);
+  EXPECT_EQ(84u, buffer[4]);
+
+  callback_size = 0;
+  PW_TOKENIZE_TO_CALLBACK(SetCallbackBuffer, "%s!", "Hi");
+  ASSERT_EQ(7u, callback_size);
+  EXPECT_EQ(0, std::memcmp("\x02Hi", &callback_buffer[4], 3));
+}
+
+}  // namespace
+}  // namespace pw::tokenizer::internal
@@ -0,0 +1,143 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// This test is built with encode_args.cc and
+// PW_TOKENIZER_CFG_INTERNED_STRINGS=4, since the option affects the encoder.
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::tokenizer {
+namespace {
+
+static_assert(PW_TOKENIZER_CFG_INTERNED_STRINGS == 4);
+
+class InternedStrings : public ::testing::Test {
+ protected:
+  InternedStrings() : buffer_{}, size_(0) {
+    pw_tokenizer_ClearInternedStrings();
+  }
+
+  // Encodes a "%s" message and returns the encoded argument.
+  std::span<const uint8_t> Encode(const char* string,
+                                  size_t buffer_size = sizeof(buffer_)) {
+    size_ = buffer_size;
+    PW_TOKENIZE_TO_BUFFER(buffer_.data(), &size_, "%s", string);
+    return std::span(buffer_).subspan(4, size_ - 4);
+  }
+
+  // Checks that the argument is an announcement of the string with the ID.
+  void ExpectAnnouncement(std::span<const uint8_t> arg,
+                          uint8_t id,
+                          const char* string) {
+    const size_t length = std::strlen(string);
+    ASSERT_EQ(3u + length, arg.size());
+    EXPECT_EQ(0xFFu, arg[0]);
+    EXPECT_EQ(id, arg[1]);
+    EXPECT_EQ(length, arg[2]);
+    EXPECT_EQ(0, std::memcmp(string, &arg[3], length));
+  }
+
+  void ExpectReference(std::span<const uint8_t> arg, uint8_t id) {
+    ASSERT_EQ(2u, arg.size());
+    EXPECT_EQ(0x7Fu, arg[0]);
+    EXPECT_EQ(id, arg[1]);
+  }
+
+  std::array<uint8_t, 256> buffer_;
+  size_t size_;
+};
+
+constexpr const char* kNames[] = {"zero", "one", "two", "three", "four"};
+
+TEST_F(InternedStrings, FirstUse_Announces) {
+  ExpectAnnouncement(Encode(kNames[0]), 0, kNames[0]);
+  ExpectAnnouncement(Encode(kNames[1]), 1, kNames[1]);
+}
+
+TEST_F(InternedStrings, SecondUse_References) {
+  Encode(kNames[0]);
+  Encode(kNames[1]);
+  ExpectReference(Encode(kNames[0]), 0);
+  ExpectReference(Encode(kNames[1]), 1);
+  ExpectReference(Encode(kNames[0]), 0);
+}
+
+TEST_F(InternedStrings, SameMessage_AnnouncesThenReferences) {
+  size_ = buffer_.size();
+  PW_TOKENIZE_TO_BUFFER(buffer_.data(), &size_, "%s %s", kNames[2], kNames[2]);
+  ASSERT_EQ(4u + 6u + 2u, size_);
+  ExpectAnnouncement(std::span(buffer_).subspan(4, 6), 0, kNames[2]);
+  ExpectReference(std::span(buffer_).subspan(10, 2), 0);
+}
+
+TEST_F(InternedStrings, ContentsChanged_AnnouncesAgain) {
+  char name[] = "abc";
+  ExpectAnnouncement(Encode(name), 0, "abc");
+  ExpectReference(Encode(name), 0);
+
+  name[2] = 'd';
+  ExpectAnnouncement(Encode(name), 1, "abd");
+  ExpectReference(Encode(name), 1);
+}
+
+TEST_F(InternedStrings, ShortString_IsNotInterned) {
+  std::span<const uint8_t> arg = Encode("ab");
+  ASSERT_EQ(3u, arg.size());
+  EXPECT_EQ(0, std::memcmp("\2ab", arg.data(), 3));
+}
+
+TEST_F(InternedStrings, LongString_IsNotInterned) {
+  char long_string[126];
+  std::memset(long_string, 'x', sizeof(long_string) - 1);
+  long_string[sizeof(long_string) - 1] = '\0';
+
+  std::span<const uint8_t> arg = Encode(long_string);
+  ASSERT_EQ(126u, arg.size());
+  EXPECT_EQ(125u, arg[0]);
+  EXPECT_EQ(126u, Encode(long_string).size());
+}
+
+TEST_F(InternedStrings, Full_ReplacesOldestEntry) {
+  for (uint8_t id = 0; id < 4u; ++id) {
+    ExpectAnnouncement(Encode(kNames[id]), id, kNames[id]);
+  }
+
+  ExpectAnnouncement(Encode(kNames[4]), 0, kNames[4]);
+  ExpectAnnouncement(Encode(kNames[0]), 1, kNames[0]);
+  ExpectReference(Encode(kNames[2]), 2);
+}
+
+TEST_F(InternedStrings, Clear_AnnouncesAgain) {
+  Encode(kNames[3]);
+  ExpectReference(Encode(kNames[3]), 0);
+
+  pw_tokenizer_ClearInternedStrings();
+  ExpectAnnouncement(Encode(kNames[3]), 0, kNames[3]);
+}
+
+TEST_F(InternedStrings, AnnouncementDoesNotFit_EncodesPlainString) {
+  std::span<const uint8_t> arg = Encode(kNames[3], 4 + 6);
+  ASSERT_EQ(6u, arg.size());
+  EXPECT_EQ(0, std::memcmp("\5three", arg.data(), 6));
+
+  ExpectAnnouncement(Encode(kNames[3]), 0, kNames[3]);
+}
+
+}  // namespace
+}  // namespace pw::tokenizer
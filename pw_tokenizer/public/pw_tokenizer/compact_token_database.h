@@ -0,0 +1,121 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+
+#include "pw_tokenizer/token_database.h"
+
+namespace pw::tokenizer {
+
+// Reads entries from a compact binary token database, which is smaller than
+// the standard binary format and is intended for devices that detokenize
+// their own logs from a database in flash. This class does not copy or modify
+// the contents of the database.
+//
+// The compact format has the same header and 8-byte entries as the format read
+// by TokenDatabase, but with version 1 and two extra header fields. The
+// strings are compressed with a dictionary of up to 128 common words and are
+// divided into blocks, so a string is found without scanning the whole table.
+// All fields are little-endian, and all offsets are from the start of the
+// database.
+//
+//            Header
+//            ======
+//   Offset  Size  Field
+//   -----------------------------------
+//        0     6  Magic number (TOKENS)
+//        6     2  Version (01 00)
+//        8     4  Entry count
+//       12     2  Entries per string block
+//       14     2  Word count (at most 128)
+//
+// The header is followed by these tables:
+//
+//   1. Entries, sorted by token, as in the TokenDatabase format.
+//   2. The offset of the first string in each block, as uint32_t.
+//   3. The offset of each dictionary word, as uint32_t.
+//   4. The dictionary words, as null-terminated strings.
+//   5. A null-terminated compressed string for each entry, in order.
+//
+// In compressed strings, bytes 0x80-0xFF refer to dictionary words 0-127, and
+// 0x7F escapes the byte that follows it, which is copied as is. Other bytes
+// are copied as is.
+//
+// Find binary searches the entries and decompresses the strings for the token
+// into a caller-provided buffer. Finding a string scans at most one block, so
+// lookups are O(log n) in the number of entries.
+class CompactTokenDatabase {
+ public:
+  static constexpr size_t kMaxWords = 128;
+
+  // Creates a CompactTokenDatabase from the provided byte array. The array may
+  // be a span, array, or other container type, and must be aligned for a
+  // TokenDatabase::RawEntry. If the data is not valid, returns a
+  // default-constructed database for which ok() is false.
+  template <typename ByteArray>
+  static CompactTokenDatabase Create(const ByteArray& database_bytes) {
+    static_assert(sizeof(*std::data(database_bytes)) == 1u);
+    return FromBytes(reinterpret_cast<const uint8_t*>(std::data(database_bytes)),
+                     std::size(database_bytes));
+  }
+
+  // Creates a database with no data. ok() returns false.
+  constexpr CompactTokenDatabase()
+      : data_(nullptr), entry_count_(0), block_size_(0), word_count_(0) {}
+
+  // Returns all entries associated with this token. Their strings are
+  // decompressed into string_buffer, one after another, and the entries refer
+  // to them there, so the entries are valid only as long as the buffer is not
+  // modified. Entries whose strings do not fit in the buffer are omitted.
+  TokenDatabase::Entries Find(uint32_t token,
+                              std::span<char> string_buffer) const;
+
+  // Returns the total number of entries (unique token-string pairs).
+  constexpr size_t size() const { return entry_count_; }
+
+  // True if this database was constructed with valid data.
+  constexpr bool ok() const { return data_ != nullptr; }
+
+ private:
+  static CompactTokenDatabase FromBytes(const uint8_t* data, size_t size);
+
+  constexpr CompactTokenDatabase(const uint8_t* data,
+                                 size_t entry_count,
+                                 uint16_t block_size,
+                                 uint16_t word_count)
+      : data_(data),
+        entry_count_(entry_count),
+        block_size_(block_size),
+        word_count_(word_count) {}
+
+  const TokenDatabase::RawEntry* entries() const;
+
+  // Returns the compressed string for the entry at the index.
+  const uint8_t* CompressedString(size_t index) const;
+
+  // Decompresses a string and its null terminator into the output. Returns the
+  // number of characters written, or 0 if the string did not fit.
+  size_t Decompress(const uint8_t* string, std::span<char> output) const;
+
+  const uint8_t* data_;
+  size_t entry_count_;
+  uint16_t block_size_;
+  uint16_t word_count_;
+};
+
+}  // namespace pw::tokenizer
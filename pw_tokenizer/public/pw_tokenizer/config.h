@@ -66,3 +66,34 @@ static_assert(PW_TOKENIZER_CFG_ARG_TYPES_SIZE_BYTES == 4 ||
 #ifndef PW_TOKENIZER_CFG_ENCODING_BUFFER_SIZE_BYTES
 #define PW_TOKENIZER_CFG_ENCODING_BUFFER_SIZE_BYTES 52
 #endif  // PW_TOKENIZER_CFG_ENCODING_BUFFER_SIZE_BYTES
+
+// In C++17, the PW_TOKENIZE_TO_BUFFER, PW_TOKENIZE_TO_CALLBACK, and
+// PW_TOKENIZE_TO_GLOBAL_HANDLER macros can encode arguments with templates
+// instead of a varargs function. The argument types are then resolved at
+// compile time and each call site encodes its arguments with straight-line
+// code. This is faster, particularly for integer arguments, but adds code to
+// every call site, so it is disabled by default. C code always uses the varargs
+// functions.
+#ifndef PW_TOKENIZER_CFG_INLINE_ENCODING
+#define PW_TOKENIZER_CFG_INLINE_ENCODING 0
+#endif  // PW_TOKENIZER_CFG_INLINE_ENCODING
+
+// If enabled, PW_TOKENIZE_TO_GLOBAL_HANDLER_WITH_PAYLOAD does not encode
+// messages. Instead, it copies the token and raw arguments to the ring buffer
+// of pw::tokenizer::GlobalDeferredEncoder(), which a background thread drains
+// with HandleCapturedMessages(). This moves the encoding out of time-critical
+// code, such as interrupt handlers. Requires the pw_tokenizer:deferred library.
+#ifndef PW_TOKENIZER_CFG_DEFERRED_ENCODING
+#define PW_TOKENIZER_CFG_DEFERRED_ENCODING 0
+#endif  // PW_TOKENIZER_CFG_DEFERRED_ENCODING
+
+// The number of string arguments to remember for string interning. When this
+// is nonzero, the first time a string argument of 3 to 124 characters is
+// encoded, it is sent once with a small ID. Later arguments that point to the
+// same unchanged string are encoded as a 2-byte reference to that ID. This
+// shrinks messages that repeat the same %s argument, such as thread or module
+// names. Decoders must track the IDs from the start of the stream to expand
+// the references. Must be less than 128. Disabled (0) by default.
+#ifndef PW_TOKENIZER_CFG_INTERNED_STRINGS
+#define PW_TOKENIZER_CFG_INTERNED_STRINGS 0
+#endif  // PW_TOKENIZER_CFG_INTERNED_STRINGS
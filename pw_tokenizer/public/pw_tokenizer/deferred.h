@@ -0,0 +1,116 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+
+#include "pw_ring_buffer/spsc_prefixed_entry_ring_buffer.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_sync/spin_lock.h"
+#include "pw_tokenizer/config.h"
+#include "pw_tokenizer/tokenize_to_global_handler_with_payload.h"
+
+namespace pw::tokenizer {
+
+// Captures tokenized messages in a ring buffer without encoding them, and
+// encodes them later, outside of the code that produced them. Capturing a
+// message copies the payload, token, argument types, and the raw argument
+// values. Strings are copied when captured, since they may not outlive the
+// call. The varint encoding happens when a message is taken out of the buffer.
+//
+// Messages may be captured from any thread or interrupt; captures are
+// serialized with a SpinLock. Only one thread may encode messages at a time.
+// The encoding thread never blocks capturing, since the ring buffer is a
+// single-producer, single-consumer ring buffer that needs no lock between the
+// two sides. If the ring buffer is full, new messages are dropped and counted.
+//
+// The token and raw arguments take up to
+// PW_TOKENIZER_CFG_ENCODING_BUFFER_SIZE_BYTES, like encoded messages. Raw
+// integers and doubles are usually larger than their encodings, so messages
+// with many arguments may be truncated sooner than if they were encoded
+// immediately.
+class DeferredEncoder {
+ public:
+  // The largest ring buffer entry for a captured message. The token and raw
+  // arguments are limited to the size of the encoding buffer.
+  static constexpr size_t kMaxCaptureSizeBytes =
+      sizeof(pw_tokenizer_Payload) + sizeof(_pw_tokenizer_ArgTypes) +
+      PW_TOKENIZER_CFG_ENCODING_BUFFER_SIZE_BYTES;
+
+  DeferredEncoder() : dropped_(0) {}
+
+  DeferredEncoder(const DeferredEncoder&) = delete;
+  DeferredEncoder& operator=(const DeferredEncoder&) = delete;
+
+  // Sets the memory for the ring buffer and discards any captured messages.
+  // Messages captured before a buffer is set are dropped. Must not be called
+  // while messages are being captured or encoded.
+  Status SetBuffer(std::span<std::byte> buffer);
+
+  // Copies a message's payload, token, and raw arguments to the ring buffer.
+  //
+  // Return values:
+  //
+  //                   OK: The message was captured.
+  //   RESOURCE_EXHAUSTED: The ring buffer is full; the message was dropped.
+  //  FAILED_PRECONDITION: No buffer was set; the message was dropped.
+  //
+  Status Capture(pw_tokenizer_Payload payload,
+                 pw_tokenizer_Token token,
+                 _pw_tokenizer_ArgTypes types,
+                 va_list args);
+
+  // Removes the oldest captured message and encodes it to the output buffer in
+  // the standard tokenized format. Arguments that do not fit are omitted, as
+  // with the other encoding functions. Returns the encoded size.
+  //
+  // Return values:
+  //
+  //                   OK: A message was encoded.
+  //         OUT_OF_RANGE: There are no captured messages.
+  //   RESOURCE_EXHAUSTED: The output buffer is too small for the token; the
+  //                       message was discarded.
+  //
+  StatusWithSize EncodeNext(pw_tokenizer_Payload& payload,
+                            std::span<uint8_t> output);
+
+  // Encodes all captured messages and passes each to
+  // pw_tokenizer_HandleEncodedMessageWithPayload. Returns the number of
+  // messages handled. Call this from a low-priority thread.
+  size_t HandleCapturedMessages();
+
+  // The number of messages dropped because they could not be captured.
+  size_t dropped() {
+    std::lock_guard lock(producer_lock_);
+    return dropped_;
+  }
+
+ private:
+  ring_buffer::SpscPrefixedEntryRingBuffer ring_buffer_;
+  sync::SpinLock producer_lock_;
+  size_t dropped_;
+};
+
+// The DeferredEncoder that captures messages from
+// PW_TOKENIZE_TO_GLOBAL_HANDLER_WITH_PAYLOAD when
+// PW_TOKENIZER_CFG_DEFERRED_ENCODING is enabled. Its buffer must be set before
+// messages can be captured.
+DeferredEncoder& GlobalDeferredEncoder();
+
+}  // namespace pw::tokenizer
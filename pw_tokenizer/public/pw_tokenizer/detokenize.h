@@ -22,12 +22,27 @@
 //   DetokenizedString result = detok.Detokenize(my_data);
 //   std::cout << result.BestString() << '\n';
 //
+// To detokenize many messages, such as a log stream, use DetokenizeTo or
+// DetokenizeBatch, which format the best string for each message directly into
+// a reused buffer:
+//
+//   detok.DetokenizeBatch(messages, [](std::string_view message) {
+//     std::cout << message << '\n';
+//   });
+//
+// Streams in which identical messages repeat, such as periodic status logs,
+// can enable a cache of formatted results for DetokenizeTo and DetokenizeBatch:
+//
+//   Detokenizer detok(TokenDatabase::Create(data), /*result_cache_size=*/256);
+//
 #pragma once
 
 #include <cstddef>
 #include <cstdint>
+#include <list>
 #include <span>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -76,7 +91,14 @@ class Detokenizer {
  public:
   // Constructs a detokenizer from a TokenDatabase. The TokenDatabase is not
   // referenced by the Detokenizer after construction; its memory can be freed.
-  Detokenizer(const TokenDatabase& database);
+  //
+  // If result_cache_size is nonzero, DetokenizeTo keeps the formatted results
+  // of up to that many distinct encoded messages, and repeated messages are
+  // copied from the cache instead of being decoded again. The least recently
+  // used result is evicted when the cache is full. Since the cache is updated
+  // by the const detokenization functions, a Detokenizer with a cache must not
+  // be used from multiple threads at once.
+  Detokenizer(const TokenDatabase& database, size_t result_cache_size = 0);
 
   // Decodes and detokenizes the encoded message. Returns a DetokenizedString
   // that stores all possible detokenized string results.
@@ -91,8 +113,76 @@ class Detokenizer {
         std::span(static_cast<const uint8_t*>(encoded), size_bytes));
   }
 
+  // Detokenizes the encoded message and appends the best string to output. The
+  // result is the same as Detokenize(encoded).BestString(), but unless the
+  // token has collisions, no DetokenizedString is built and the message is
+  // formatted directly into output. Nothing is allocated if output has enough
+  // capacity. Returns the same value as Detokenize(encoded).ok().
+  //
+  // If the result cache is enabled, the result is cached, and messages that
+  // are already cached are appended without being decoded.
+  bool DetokenizeTo(std::span<const uint8_t> encoded,
+                    std::string& output) const;
+
+  // Detokenizes each of the encoded messages in order and calls sink with the
+  // best string for each as a std::string_view. One buffer is reused for every
+  // message, so the std::string_view is only valid during the call to sink.
+  template <typename Sink>
+  void DetokenizeBatch(std::span<const std::span<const uint8_t>> messages,
+                       Sink&& sink) const {
+    std::string buffer;
+    for (std::span<const uint8_t> message : messages) {
+      buffer.clear();
+      DetokenizeTo(message, buffer);
+      sink(std::string_view(buffer));
+    }
+  }
+
  private:
+  // Bounded LRU cache of best strings, keyed by a hash of the encoded message.
+  // The encoded message is stored with each result to rule out collisions.
+  class ResultCache {
+   public:
+    struct Entry {
+      uint64_t hash;
+      std::string encoded;
+      std::string value;
+      bool ok;
+    };
+
+    explicit ResultCache(size_t capacity) : capacity_(capacity) {}
+
+    // The index refers to the cache's own list, so copies start out empty.
+    ResultCache(const ResultCache& other) : capacity_(other.capacity_) {}
+    ResultCache& operator=(const ResultCache& other);
+
+    ResultCache(ResultCache&&) = default;
+    ResultCache& operator=(ResultCache&&) = default;
+
+    bool enabled() const { return capacity_ != 0u; }
+
+    // Returns the cached result for the message or nullptr if there is none.
+    // A found entry becomes the most recently used.
+    const Entry* Find(uint64_t hash, std::span<const uint8_t> encoded);
+
+    // Caches a result, evicting the least recently used one if full.
+    void Insert(uint64_t hash,
+                std::span<const uint8_t> encoded,
+                std::string_view value,
+                bool ok);
+
+   private:
+    size_t capacity_;
+    std::list<Entry> entries_;  // Most recently used first.
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index_;
+  };
+
+  // Appends the best string for the message; the uncached DetokenizeTo.
+  bool AppendBestString(std::span<const uint8_t> encoded,
+                        std::string& output) const;
+
   std::unordered_map<uint32_t, std::vector<TokenizedStringEntry>> database_;
+  mutable ResultCache cache_;
 };
 
 }  // namespace pw::tokenizer
@@ -111,3 +111,17 @@ constexpr uint32_t PwTokenizer65599FixedLengthHash(
 PW_EXTERN_C uint32_t pw_tokenizer_65599FixedLengthHash(const char* string,
                                                        size_t string_length,
                                                        size_t hash_length);
+
+// Calculates the fixed-length hashes of many strings at once. This is intended
+// for host tools, such as the Python token database scripts, which call it
+// through the pw_tokenizer:hash_library shared library.
+//
+// The strings are stored back to back in one buffer. String i occupies bytes
+// offsets[i] to offsets[i + 1], so offsets has string_count + 1 entries. The
+// strings may contain null characters. The hash of string i is written to
+// hashes[i].
+PW_EXTERN_C void pw_tokenizer_65599FixedLengthHashes(const char* strings,
+                                                     const size_t* offsets,
+                                                     size_t string_count,
+                                                     size_t hash_length,
+                                                     uint32_t* hashes);
@@ -136,6 +136,14 @@ class StringSegment {
   // Skips decoding this StringSegment. Literals and %% are expanded as normal.
   DecodedArg Skip() const;
 
+  // Decodes this StringSegment and appends it to output as it would appear in
+  // DecodedFormatString::value(). Advances arguments past the bytes that were
+  // decoded. If decoding fails, appends the format specifier and returns false.
+  bool AppendTo(std::span<const uint8_t>& arguments, std::string& output) const;
+
+  // Appends this StringSegment to output as it appears when skipped.
+  void AppendSkipped(std::string& output) const;
+
   bool empty() const { return text_.empty(); }
 
   const std::string& text() const { return text_; }
@@ -176,6 +184,18 @@ class StringSegment {
   DecodedArg DecodeFloatingPoint(
       const std::span<const uint8_t>& arguments) const;
 
+  bool AppendString(const std::span<const uint8_t>& arguments,
+                    std::string& output,
+                    size_t& bytes_decoded) const;
+
+  bool AppendInteger(const std::span<const uint8_t>& arguments,
+                     std::string& output,
+                     size_t& bytes_decoded) const;
+
+  bool AppendFloatingPoint(const std::span<const uint8_t>& arguments,
+                           std::string& output,
+                           size_t& bytes_decoded) const;
+
   std::string text_;
   Type type_;
   ArgSize local_size_;  // Arg size to use for snprintf on this machine.
@@ -236,6 +256,13 @@ class FormatString {
                             arguments.size()));
   }
 
+  // Formats this format string according to the provided encoded arguments and
+  // appends the result to output. The result is the same as
+  // Format(arguments).value(), but no DecodedFormatString is built, so nothing
+  // is allocated if output has enough capacity. Returns the same value as
+  // Format(arguments).ok().
+  bool AppendTo(std::span<const uint8_t> arguments, std::string& output) const;
+
  private:
   std::vector<StringSegment> segments_;
 };
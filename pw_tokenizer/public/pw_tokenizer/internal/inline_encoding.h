@@ -0,0 +1,195 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// This header provides the C++17 encoding functions used by the tokenization
+// macros when PW_TOKENIZER_CFG_INLINE_ENCODING is enabled. They take the same
+// arguments as the varargs encoding functions, but the argument types are known
+// at compile time, so each call site encodes its arguments with straight-line
+// code instead of decoding the _pw_tokenizer_ArgTypes at run time.
+//
+// The largest possible encoded size of the arguments is also known at compile
+// time. If the output buffer is at least that large, arguments are encoded
+// without any further size checks. Otherwise, these functions fall back to the
+// varargs encoding functions, which check the size of each argument.
+//
+// This header is included by pw_tokenizer/tokenize.h. Do not include it
+// directly.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "pw_tokenizer/config.h"
+#include "pw_tokenizer/internal/argument_types.h"
+
+namespace pw {
+namespace tokenizer {
+namespace internal {
+
+// Strings are encoded with a one-byte length and status prefix. At most 126
+// characters are encoded, which matches the varargs encoding when the output
+// has room for the longest string.
+inline constexpr size_t kMaxEncodedStringSizeBytes = 0x7Fu;
+
+// The largest number of bytes an argument of type T can be encoded as.
+template <typename T>
+constexpr size_t MaxEncodedArgSize() {
+  constexpr _pw_tokenizer_ArgTypes kType = VarargsType<T>();
+
+  if constexpr (kType == PW_TOKENIZER_ARG_TYPE_INT) {
+    return 5;  // A zig-zag encoded 32-bit varint.
+  } else if constexpr (kType == PW_TOKENIZER_ARG_TYPE_INT64) {
+    return 10;  // A zig-zag encoded 64-bit varint.
+  } else if constexpr (kType == PW_TOKENIZER_ARG_TYPE_DOUBLE) {
+    return sizeof(float);
+  } else {
+    return kMaxEncodedStringSizeBytes;
+  }
+}
+
+// The largest size of a message with a token and arguments of these types.
+template <typename... Args>
+inline constexpr size_t kMaxEncodedSizeBytes =
+    sizeof(pw_tokenizer_Token) + (size_t(0) + ... + MaxEncodedArgSize<Args>());
+
+inline uint8_t* EncodeVarint(uint64_t value, uint8_t* output) {
+  while (value > 0x7Fu) {
+    *output++ = static_cast<uint8_t>(value | 0x80u);
+    value >>= 7;
+  }
+  *output++ = static_cast<uint8_t>(value);
+  return output;
+}
+
+inline uint8_t* EncodeZigZag(int64_t value, uint8_t* output) {
+  return EncodeVarint(
+      (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63),
+      output);
+}
+
+#if PW_TOKENIZER_CFG_INTERNED_STRINGS > 0
+
+// Encodes a string argument with string interning. Defined in encode_args.cc.
+// The output must have room for kMaxEncodedStringSizeBytes bytes. Returns the
+// encoded size.
+size_t EncodeInternedString(const char* string, uint8_t* output);
+
+#endif  // PW_TOKENIZER_CFG_INTERNED_STRINGS > 0
+
+inline uint8_t* EncodeString(const char* string, uint8_t* output) {
+#if PW_TOKENIZER_CFG_INTERNED_STRINGS > 0
+  // Interned strings are tracked by the out-of-line string encoder.
+  return output + EncodeInternedString(string, output);
+#else
+  if (string == nullptr) {
+    string = "NULL";
+  }
+
+  size_t length = 0;
+  uint8_t overflow_bit = 0;
+
+  while (string[length] != '\0') {
+    if (length == kMaxEncodedStringSizeBytes - 1) {
+      overflow_bit = 0x80u;
+      break;
+    }
+    length += 1;
+  }
+
+  output[0] = static_cast<uint8_t>(length | overflow_bit);
+  std::memcpy(output + 1, string, length);
+  return output + 1 + length;
+#endif  // PW_TOKENIZER_CFG_INTERNED_STRINGS > 0
+}
+
+// Encodes an argument the same way that a varargs encoding function encodes
+// the value it reads with va_arg. The output must have room for
+// MaxEncodedArgSize<T>() bytes.
+template <typename T>
+uint8_t* EncodeArg(T value, uint8_t* output) {
+  constexpr _pw_tokenizer_ArgTypes kType = VarargsType<T>();
+
+  if constexpr (kType == PW_TOKENIZER_ARG_TYPE_DOUBLE) {
+    const float float_value = static_cast<float>(value);
+    std::memcpy(output, &float_value, sizeof(float_value));
+    return output + sizeof(float_value);
+  } else if constexpr (kType == PW_TOKENIZER_ARG_TYPE_STRING) {
+    return EncodeString(value, output);
+  } else {
+    // Arguments are read as int or int64_t, so convert them to those types.
+    using Integer = std::conditional_t<kType == PW_TOKENIZER_ARG_TYPE_INT64,
+                                       int64_t,
+                                       int>;
+    if constexpr (std::is_null_pointer_v<T>) {
+      return EncodeZigZag(0, output);
+    } else if constexpr (std::is_pointer_v<T>) {
+      return EncodeZigZag(
+          static_cast<Integer>(reinterpret_cast<uintptr_t>(value)), output);
+    } else {
+      return EncodeZigZag(static_cast<Integer>(value), output);
+    }
+  }
+}
+
+// Encodes the token and arguments. The buffer must have room for
+// kMaxEncodedSizeBytes<Args...> bytes. Returns the encoded size.
+template <typename... Args>
+size_t EncodeMessage(uint8_t* buffer, pw_tokenizer_Token token, Args... args) {
+  std::memcpy(buffer, &token, sizeof(token));
+  uint8_t* output = buffer + sizeof(token);
+  ((output = EncodeArg(args, output)), ...);
+  return static_cast<size_t>(output - buffer);
+}
+
+// True if a message with these argument types always fits in the encoding
+// buffer used by PW_TOKENIZE_TO_CALLBACK and the global handler macros.
+template <typename... Args>
+inline constexpr bool kFitsInEncodingBuffer =
+    kMaxEncodedSizeBytes<Args...> <=
+    PW_TOKENIZER_CFG_ENCODING_BUFFER_SIZE_BYTES;
+
+template <typename... Args>
+void ToBuffer(void* buffer,
+              size_t* buffer_size_bytes,
+              pw_tokenizer_Token token,
+              _pw_tokenizer_ArgTypes types,
+              Args... args) {
+  if (*buffer_size_bytes < kMaxEncodedSizeBytes<Args...>) {
+    _pw_tokenizer_ToBuffer(buffer, buffer_size_bytes, token, types, args...);
+    return;
+  }
+  *buffer_size_bytes =
+      EncodeMessage(static_cast<uint8_t*>(buffer), token, args...);
+}
+
+template <typename... Args>
+void ToCallback(void (*callback)(const uint8_t* encoded_message,
+                                 size_t size_bytes),
+                pw_tokenizer_Token token,
+                _pw_tokenizer_ArgTypes types,
+                Args... args) {
+  if constexpr (kFitsInEncodingBuffer<Args...>) {
+    static_cast<void>(types);
+    uint8_t buffer[kMaxEncodedSizeBytes<Args...>];
+    callback(buffer, EncodeMessage(buffer, token, args...));
+  } else {
+    _pw_tokenizer_ToCallback(callback, token, types, args...);
+  }
+}
+
+}  // namespace internal
+}  // namespace tokenizer
+}  // namespace pw
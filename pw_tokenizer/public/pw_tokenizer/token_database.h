@@ -17,6 +17,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <iterator>
+#include <span>
 
 namespace pw::tokenizer {
 
@@ -48,9 +49,11 @@ namespace pw::tokenizer {
 // Entries are sorted by token. A string table with a null-terminated string for
 // each entry in order follows the entries.
 //
-// Entries are accessed by iterating over the database. A O(n) Find function is
-// also provided. In typical use, a TokenDatabase is preprocessed by a
-// Detokenizer into a std::unordered_map.
+// Entries are accessed by iterating over the database or with Find, which
+// binary searches the entries. Finding an entry's string requires scanning the
+// string table up to it, unless a string index built with BuildStringIndex is
+// provided. In typical use, a TokenDatabase is preprocessed by a Detokenizer
+// into a std::unordered_map.
 class TokenDatabase {
  public:
   // Internal struct that describes how the underlying binary token database
@@ -196,9 +199,26 @@ class TokenDatabase {
   // Creates a database with no data. ok() returns false.
   constexpr TokenDatabase() : begin_{.data = nullptr}, end_{.data = nullptr} {}
 
-  // Returns all entries associated with this token. This is a O(n) operation.
+  // Returns all entries associated with this token. The entries are found with
+  // a binary search, but finding their strings scans the string table up to
+  // them, which is O(n) in the size of the string table.
   Entries Find(uint32_t token) const;
 
+  // Returns all entries associated with this token, using an index built by
+  // BuildStringIndex to find their strings. This is a O(log n) operation. If
+  // the index has fewer than size() offsets, falls back to Find(token).
+  Entries Find(uint32_t token, std::span<const uint32_t> string_index) const;
+
+  // Fills string_index with the offset of each entry's string in the string
+  // table, for use with Find. Returns false without writing anything if
+  // string_index has fewer than size() elements. For example:
+  //
+  //   std::array<uint32_t, kEntryCount> string_index;
+  //   database.BuildStringIndex(string_index);
+  //   TokenDatabase::Entries entries = database.Find(token, string_index);
+  //
+  bool BuildStringIndex(std::span<uint32_t> string_index) const;
+
   // Returns the total number of entries (unique token-string pairs).
   constexpr size_t size() const {
     return (end_.data - begin_.data) / sizeof(RawEntry);
@@ -220,6 +240,14 @@ class TokenDatabase {
 
   static_assert(sizeof(Header) == 2 * sizeof(RawEntry));
 
+  // Binary searches for the range of entries with this token.
+  void FindRange(uint32_t token,
+                 const RawEntry*& first,
+                 const RawEntry*& last) const;
+
+  // The start of the string table, which immediately follows the entries.
+  constexpr const char* strings() const { return end_.data; }
+
   template <typename ByteArray>
   static constexpr bool HasValidHeader(const ByteArray& bytes) {
     static_assert(sizeof(*std::data(bytes)) == 1u);
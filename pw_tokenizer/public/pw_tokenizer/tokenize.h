@@ -99,15 +99,15 @@ typedef uint32_t pw_tokenizer_Token;
                                __VA_ARGS__)
 
 // Same as PW_TOKENIZE_TO_BUFFER, but tokenizes to the specified domain.
-#define PW_TOKENIZE_TO_BUFFER_DOMAIN(                          \
-    domain, buffer, buffer_size_pointer, format, ...)          \
-  do {                                                         \
-    _PW_TOKENIZE_FORMAT_STRING(domain, format, __VA_ARGS__);   \
-    _pw_tokenizer_ToBuffer(buffer,                             \
-                           buffer_size_pointer,                \
-                           _pw_tokenizer_token,                \
-                           PW_TOKENIZER_ARG_TYPES(__VA_ARGS__) \
-                               PW_COMMA_ARGS(__VA_ARGS__));    \
+#define PW_TOKENIZE_TO_BUFFER_DOMAIN(                                  \
+    domain, buffer, buffer_size_pointer, format, ...)                  \
+  do {                                                                 \
+    _PW_TOKENIZE_FORMAT_STRING(domain, format, __VA_ARGS__);           \
+    _PW_TOKENIZER_ENCODE(ToBuffer)(buffer,                             \
+                                   buffer_size_pointer,                \
+                                   _pw_tokenizer_token,                \
+                                   PW_TOKENIZER_ARG_TYPES(__VA_ARGS__) \
+                                       PW_COMMA_ARGS(__VA_ARGS__));    \
   } while (0)
 
 // Encodes a tokenized string and arguments to a buffer on the stack. The
@@ -142,13 +142,13 @@ typedef uint32_t pw_tokenizer_Token;
   PW_TOKENIZE_TO_CALLBACK_DOMAIN(                      \
       PW_TOKENIZER_DEFAULT_DOMAIN, callback, format, __VA_ARGS__)
 
-#define PW_TOKENIZE_TO_CALLBACK_DOMAIN(domain, callback, format, ...) \
-  do {                                                                \
-    _PW_TOKENIZE_FORMAT_STRING(domain, format, __VA_ARGS__);          \
-    _pw_tokenizer_ToCallback(callback,                                \
-                             _pw_tokenizer_token,                     \
-                             PW_TOKENIZER_ARG_TYPES(__VA_ARGS__)      \
-                                 PW_COMMA_ARGS(__VA_ARGS__));         \
+#define PW_TOKENIZE_TO_CALLBACK_DOMAIN(domain, callback, format, ...)    \
+  do {                                                                   \
+    _PW_TOKENIZE_FORMAT_STRING(domain, format, __VA_ARGS__);             \
+    _PW_TOKENIZER_ENCODE(ToCallback)(callback,                           \
+                                     _pw_tokenizer_token,                \
+                                     PW_TOKENIZER_ARG_TYPES(__VA_ARGS__) \
+                                         PW_COMMA_ARGS(__VA_ARGS__));    \
   } while (0)
 
 PW_EXTERN_C_START
@@ -167,6 +167,13 @@ void _pw_tokenizer_ToCallback(void (*callback)(const uint8_t* encoded_message,
                               _pw_tokenizer_ArgTypes types,
                               ...);
 
+// Forgets the strings remembered for string interning, so that each string is
+// announced again before it is referenced. Call this when the decoder may have
+// missed announcements, such as when a new connection is established or after
+// messages are dropped. Has no effect if PW_TOKENIZER_CFG_INTERNED_STRINGS is
+// 0. Safe to call from any thread or interrupt.
+void pw_tokenizer_ClearInternedStrings(void);
+
 // This empty function allows the compiler to check the format string.
 static inline void pw_tokenizer_CheckFormatString(const char* format, ...)
     PW_PRINTF_FORMAT(1, 2);
@@ -180,6 +187,18 @@ PW_EXTERN_C_END
 // These macros implement string tokenization. They should not be used directly;
 // use one of the PW_TOKENIZE_* macros above instead.
 
+// Selects the function that encodes a tokenized message: the C++ template with
+// the same name if PW_TOKENIZER_CFG_INLINE_ENCODING is enabled, or the varargs
+// function otherwise.
+#if defined(__cplusplus) && __cplusplus >= 201703L && \
+    PW_TOKENIZER_CFG_INLINE_ENCODING
+#define _PW_TOKENIZER_INLINE_ENCODING 1
+#define _PW_TOKENIZER_ENCODE(function) ::pw::tokenizer::internal::function
+#else
+#define _PW_TOKENIZER_INLINE_ENCODING 0
+#define _PW_TOKENIZER_ENCODE(function) _pw_tokenizer_##function
+#endif  // PW_TOKENIZER_CFG_INLINE_ENCODING
+
 // This macro takes a printf-style format string and corresponding arguments. It
 // checks that the arguments are correct, stores the format string in a special
 // section, and calculates the string's token at compile time.
@@ -284,3 +303,7 @@ using Token = ::pw_tokenizer_Token;
 #define _PW_TOKENIZER_SECTION \
   PW_KEEP_IN_SECTION(PW_STRINGIFY(_PW_TOKENIZER_UNIQUE(.pw_tokenizer.entries.)))
 #endif  // __APPLE__
+
+#if _PW_TOKENIZER_INLINE_ENCODING
+#include "pw_tokenizer/internal/inline_encoding.h"
+#endif  // _PW_TOKENIZER_INLINE_ENCODING
@@ -47,12 +47,12 @@
       PW_TOKENIZER_DEFAULT_DOMAIN, format, __VA_ARGS__)
 
 // Same as PW_TOKENIZE_TO_GLOBAL_HANDLER, but tokenizes to the specified domain.
-#define PW_TOKENIZE_TO_GLOBAL_HANDLER_DOMAIN(domain, format, ...)     \
-  do {                                                                \
-    _PW_TOKENIZE_FORMAT_STRING(domain, format, __VA_ARGS__);          \
-    _pw_tokenizer_ToGlobalHandler(_pw_tokenizer_token,                \
-                                  PW_TOKENIZER_ARG_TYPES(__VA_ARGS__) \
-                                      PW_COMMA_ARGS(__VA_ARGS__));    \
+#define PW_TOKENIZE_TO_GLOBAL_HANDLER_DOMAIN(domain, format, ...)        \
+  do {                                                                   \
+    _PW_TOKENIZE_FORMAT_STRING(domain, format, __VA_ARGS__);             \
+    _PW_TOKENIZER_ENCODE(ToGlobalHandler)(                               \
+        _pw_tokenizer_token,                                             \
+        PW_TOKENIZER_ARG_TYPES(__VA_ARGS__) PW_COMMA_ARGS(__VA_ARGS__)); \
   } while (0)
 
 PW_EXTERN_C_START
@@ -70,3 +70,29 @@ void _pw_tokenizer_ToGlobalHandler(pw_tokenizer_Token token,
                                    ...);
 
 PW_EXTERN_C_END
+
+#if _PW_TOKENIZER_INLINE_ENCODING
+
+namespace pw {
+namespace tokenizer {
+namespace internal {
+
+template <typename... Args>
+void ToGlobalHandler(pw_tokenizer_Token token,
+                     _pw_tokenizer_ArgTypes types,
+                     Args... args) {
+  if constexpr (kFitsInEncodingBuffer<Args...>) {
+    static_cast<void>(types);
+    uint8_t buffer[kMaxEncodedSizeBytes<Args...>];
+    pw_tokenizer_HandleEncodedMessage(buffer,
+                                      EncodeMessage(buffer, token, args...));
+  } else {
+    _pw_tokenizer_ToGlobalHandler(token, types, args...);
+  }
+}
+
+}  // namespace internal
+}  // namespace tokenizer
+}  // namespace pw
+
+#endif  // _PW_TOKENIZER_INLINE_ENCODING
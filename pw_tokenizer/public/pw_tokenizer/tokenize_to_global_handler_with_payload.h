@@ -50,12 +50,22 @@
     domain, payload, format, ...)                                        \
   do {                                                                   \
     _PW_TOKENIZE_FORMAT_STRING(domain, format, __VA_ARGS__);             \
-    _pw_tokenizer_ToGlobalHandlerWithPayload(                            \
+    _PW_TOKENIZER_WITH_PAYLOAD_FUNCTION(                                 \
         payload,                                                         \
         _pw_tokenizer_token,                                             \
         PW_TOKENIZER_ARG_TYPES(__VA_ARGS__) PW_COMMA_ARGS(__VA_ARGS__)); \
   } while (0)
 
+// Selects the function that the macro above calls. With deferred encoding,
+// messages are captured for pw::tokenizer::GlobalDeferredEncoder() to encode
+// later.
+#if PW_TOKENIZER_CFG_DEFERRED_ENCODING
+#define _PW_TOKENIZER_WITH_PAYLOAD_FUNCTION _pw_tokenizer_CaptureWithPayload
+#else
+#define _PW_TOKENIZER_WITH_PAYLOAD_FUNCTION \
+  _PW_TOKENIZER_ENCODE(ToGlobalHandlerWithPayload)
+#endif  // PW_TOKENIZER_CFG_DEFERRED_ENCODING
+
 PW_EXTERN_C_START
 
 typedef uintptr_t pw_tokenizer_Payload;
@@ -75,4 +85,40 @@ void _pw_tokenizer_ToGlobalHandlerWithPayload(pw_tokenizer_Payload payload,
                                               _pw_tokenizer_ArgTypes types,
                                               ...);
 
+// Captures the token and raw arguments for deferred encoding. Defined in the
+// pw_tokenizer:deferred library. Do not call it directly; instead, use the
+// PW_TOKENIZE_TO_GLOBAL_HANDLER_WITH_PAYLOAD macro with
+// PW_TOKENIZER_CFG_DEFERRED_ENCODING enabled.
+void _pw_tokenizer_CaptureWithPayload(pw_tokenizer_Payload payload,
+                                      pw_tokenizer_Token token,
+                                      _pw_tokenizer_ArgTypes types,
+                                      ...);
+
 PW_EXTERN_C_END
+
+#if _PW_TOKENIZER_INLINE_ENCODING
+
+namespace pw {
+namespace tokenizer {
+namespace internal {
+
+template <typename... Args>
+void ToGlobalHandlerWithPayload(pw_tokenizer_Payload payload,
+                                pw_tokenizer_Token token,
+                                _pw_tokenizer_ArgTypes types,
+                                Args... args) {
+  if constexpr (kFitsInEncodingBuffer<Args...>) {
+    static_cast<void>(types);
+    uint8_t buffer[kMaxEncodedSizeBytes<Args...>];
+    pw_tokenizer_HandleEncodedMessageWithPayload(
+        payload, buffer, EncodeMessage(buffer, token, args...));
+  } else {
+    _pw_tokenizer_ToGlobalHandlerWithPayload(payload, token, types, args...);
+  }
+}
+
+}  // namespace internal
+}  // namespace tokenizer
+}  // namespace pw
+
+#endif  // _PW_TOKENIZER_INLINE_ENCODING
@@ -43,6 +43,31 @@ static_assert(offsetof(EncodedMessage, args) == sizeof(EncodedMessage::token) &&
                       sizeof(EncodedMessage),
               "EncodedMessage should not have padding bytes between members");
 
+// Plain strings are at most 126 characters, so the status bytes 0x7F and 0xFF
+// are never used for them. Interned strings use these values. A reference is
+// 0x7F followed by the ID. An announcement is 0xFF, the ID, and the string in
+// the plain string encoding. These values must match decode.cc and decode.py.
+constexpr uint8_t kInternedStringReference = 0x7Fu;
+constexpr uint8_t kInternedStringAnnouncement = 0xFFu;
+
+// Encodes a string argument: a status byte with the length and a truncation
+// flag, followed by up to 126 characters. If PW_TOKENIZER_CFG_INTERNED_STRINGS
+// is enabled, the string may be encoded as an interned string reference or
+// announcement instead. Returns the encoded size, or 0 if the output is empty.
+size_t EncodeString(const char* string, const std::span<uint8_t>& output);
+
+// Returns the size of a string argument encoded by EncodeString.
+inline size_t EncodedStringSizeBytes(const uint8_t* encoded) {
+  switch (encoded[0]) {
+    case kInternedStringReference:
+      return 2;
+    case kInternedStringAnnouncement:
+      return 3 + (encoded[2] & 0x7Fu);
+    default:
+      return 1 + (encoded[0] & 0x7Fu);
+  }
+}
+
 // Encodes a tokenized string's arguments to a buffer. The
 // _pw_tokenizer_ArgTypes parameter specifies the argument types, in place of a
 // format string.
@@ -23,7 +23,7 @@ import tempfile
 import unittest
 from unittest import mock
 
-from pw_tokenizer import database
+from pw_tokenizer import database, tokens
 
 # This is an ELF file with only the pw_tokenizer sections. It was created
 # from a tokenize_test binary built for the STM32F429i Discovery board. The
@@ -187,6 +187,17 @@ class DatabaseCommandLineTest(unittest.TestCase):
         self.assertEqual(CSV_DEFAULT_DOMAIN.splitlines(),
                          self._csv.read_text().splitlines())
 
+    def test_create_compact(self):
+        compact = self._dir / 'db.bin'
+        run_cli('create', '--type', 'compact', '--database', compact,
+                self._elf)
+
+        # Write the compact database as CSV to verify its contents.
+        run_cli('create', '--database', self._csv, compact)
+
+        self.assertEqual(CSV_DEFAULT_DOMAIN.splitlines(),
+                         self._csv.read_text().splitlines())
+
     def test_add_does_not_recalculate_tokens(self):
         db_with_custom_token = '01234567,          ,"hello"'
 
@@ -219,6 +230,38 @@ class DatabaseCommandLineTest(unittest.TestCase):
         self.assertEqual(new_csv.splitlines(),
                          self._csv.read_text().splitlines())
 
+    def test_update_matches_add_and_mark_removals(self):
+        expected = self._dir / 'expected.csv'
+        expected.write_text(CSV_TEST_DOMAIN)
+        run_cli('add', '--database', expected, self._elf)
+        run_cli('mark_removals', '--database', expected, '--date',
+                '1998-09-04', self._elf)
+
+        self._csv.write_text(CSV_TEST_DOMAIN)
+        run_cli('update', '--database', self._csv, '--date', '1998-09-04',
+                self._elf)
+
+        self.assertEqual(expected.read_bytes(), self._csv.read_bytes())
+
+    def test_update_reuses_cache_and_skips_unchanged_database(self):
+        cache = self._dir / 'cache.json'
+        self._csv.write_text(CSV_DEFAULT_DOMAIN)
+        run_cli('update', '--database', self._csv, '--cache', cache,
+                self._elf)
+        self.assertTrue(cache.exists())
+
+        db = tokens.DatabaseFile(self._csv)
+        self.assertFalse(
+            database.update_database(db, [str(self._elf)], cache=cache))
+
+        with mock.patch.object(database, '_database_from_elf') as read_elf:
+            self.assertFalse(
+                database.update_database(db, [str(self._elf)], cache=cache))
+            read_elf.assert_not_called()
+
+        self.assertEqual(CSV_DEFAULT_DOMAIN.splitlines(),
+                         self._csv.read_text().splitlines())
+
     def test_purge(self):
         self._csv.write_text(CSV_ALL_DOMAINS)
 
@@ -68,6 +68,44 @@ class TestDecodeTokenized(unittest.TestCase):
                          '0x00000001<[%d ERROR]><[%d SKIPPED]>')
 
 
+class TestInternedStrings(unittest.TestCase):
+    """Tests decoding interned string announcements and references."""
+    def test_announcement_decodes_string(self):
+        args, remaining = decode.FormatString('%s!').decode(b'\xff\x05\x03abc')
+        self.assertEqual(args[0].value, 'abc')
+        self.assertEqual(args[0].interned_id, 5)
+        self.assertEqual(args[0].raw_data, b'\xff\x05\x03abc')
+        self.assertEqual(remaining, b'')
+
+    def test_reference_uses_interned_strings(self):
+        fmt = decode.FormatString('%s and %d')
+        self.assertEqual(fmt.format(b'\x7f\x02\x04', False, {2: 'hi'}).value,
+                         'hi and 2')
+
+    def test_reference_within_message(self):
+        self.assertEqual(decode.decode('%s %s', b'\xff\x00\x03abc\x7f\x00'),
+                         'abc abc')
+
+    def test_decode_does_not_modify_interned_strings(self):
+        strings = {1: 'one'}
+        decode.FormatString('%s').format(b'\xff\x00\x03abc', False, strings)
+        self.assertEqual(strings, {1: 'one'})
+
+    def test_unknown_reference_is_error(self):
+        self.assertEqual(
+            decode.decode('%s %d', b'\x7f\x03\x02', True),
+            '{} {}'.format(error('%s ERROR', 'unknown interned string 3'),
+                           error('%d SKIPPED', 1)))
+
+    def test_incomplete_interned_strings_are_errors(self):
+        self.assertEqual(decode.decode('%s', b'\x7f', True),
+                         error('%s ERROR'))
+        self.assertEqual(decode.decode('%s', b'\xff\x00', True),
+                         error('%s ERROR'))
+        self.assertEqual(decode.decode('%s', b'\xff\x00\x03a', True),
+                         error('%s ERROR', 'a'))
+
+
 class TestIntegerDecoding(unittest.TestCase):
     """Test decoding variable-length integers."""
     def test_decode_generated_data(self):
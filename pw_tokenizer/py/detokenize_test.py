@@ -301,6 +301,55 @@ class DetokenizeTest(unittest.TestCase):
         self.assertEqual(expected_tokens,
                          frozenset(detok.database.token_to_entries.keys()))
 
+    def test_detokenize_with_mapped_database(self):
+        with io.BytesIO() as fd:
+            tokens.write_binary(
+                tokens.Database(
+                    [tokens.TokenizedStringEntry(0x11223344, 'Hello %s')]),
+                fd)
+            detok = detokenize.Detokenizer(tokens.MappedDatabase(
+                fd.getvalue()))
+
+        self.assertEqual(str(detok.detokenize(b'\x44\x33\x22\x11\x02hi')),
+                         'Hello hi')
+        self.assertFalse(detok.detokenize(b'\x44\x33\x22\x10').ok())
+
+
+class DetokenizeInternedStrings(unittest.TestCase):
+    """Tests detokenizing messages with interned string arguments."""
+    def setUp(self):
+        super().setUp()
+        self.detok = detokenize.Detokenizer(
+            tokens.Database([
+                tokens.TokenizedStringEntry(1, 'Thread %s: %d'),
+                tokens.TokenizedStringEntry(2, 'Done'),
+            ]))
+
+    def test_announced_string_is_referenced_by_later_messages(self):
+        announce = b'\1\0\0\0\xff\x02\x04main\x02'
+        reference = b'\1\0\0\0\x7f\x02\x04'
+
+        self.assertEqual(str(self.detok.detokenize(announce)), 'Thread main: 1')
+        self.assertEqual(str(self.detok.detokenize(b'\2\0\0\0')), 'Done')
+        self.assertEqual(str(self.detok.detokenize(reference)),
+                         'Thread main: 2')
+        self.assertEqual(self.detok.interned_strings, {2: 'main'})
+
+    def test_reannouncement_replaces_string(self):
+        self.detok.detokenize(b'\1\0\0\0\xff\x00\x03one\x00')
+        self.detok.detokenize(b'\1\0\0\0\xff\x00\x03two\x00')
+        self.assertEqual(str(self.detok.detokenize(b'\1\0\0\0\x7f\x00\x00')),
+                         'Thread two: 0')
+
+    def test_unknown_reference_is_unsuccessful(self):
+        result = self.detok.detokenize(b'\1\0\0\0\x7f\x05\x00')
+        self.assertFalse(result.ok())
+        self.assertEqual(self.detok.interned_strings, {})
+
+    def test_failed_message_does_not_announce(self):
+        self.detok.detokenize(b'\1\0\0\0\xff\x00\x03one')  # missing %d
+        self.assertEqual(self.detok.interned_strings, {})
+
 
 class DetokenizeWithCollisions(unittest.TestCase):
     """Tests collision resolution."""
@@ -539,6 +588,29 @@ class DetokenizeBase64(unittest.TestCase):
             self.assertEqual(
                 expected, detokenize.detokenize_base64(self.detok, data, b'$'))
 
+    def test_detokenize_base64_parallel(self):
+        data = b'\n'.join(data for data, _ in self.TEST_CASES) * 10
+        expected = b'\n'.join(expected for _, expected in self.TEST_CASES) * 10
+
+        output = io.BytesIO()
+        detokenize.detokenize_base64_parallel(self.detok,
+                                              data,
+                                              output,
+                                              '$',
+                                              jobs=2,
+                                              chunk_size=16)
+        self.assertEqual(expected, output.getvalue())
+
+    def test_detokenize_base64_parallel_no_newlines(self):
+        output = io.BytesIO()
+        detokenize.detokenize_base64_parallel(self.detok,
+                                              self.JELLO + b'?' + self.JELLO,
+                                              output,
+                                              '$',
+                                              jobs=2,
+                                              chunk_size=1)
+        self.assertEqual(b'Jello, world!?Jello, world!', output.getvalue())
+
 
 class DetokenizeBase64InfiniteRecursion(unittest.TestCase):
     """Tests that infinite Bas64 token recursion resolves."""
@@ -28,8 +28,8 @@ from pathlib import Path
 import re
 import struct
 import sys
-from typing import (Any, Callable, Dict, Iterable, Iterator, List, Pattern,
-                    Set, TextIO, Tuple, Union)
+from typing import (Any, Callable, Dict, Iterable, Iterator, List, Optional,
+                    Pattern, Set, TextIO, Tuple, Union)
 
 try:
     from pw_tokenizer import elf_reader, tokens
@@ -135,6 +135,66 @@ def _database_from_elf(elf, domain: Pattern[str]) -> tokens.Database:
     return tokens.Database([])
 
 
+class ElfEntryCache:
+    """Caches the entries read from ELF files between database updates.
+
+    Reading the tokenized string sections is the slowest part of updating a
+    database from large ELF files. ELFs are identified by path and domain. If an
+    ELF's size and modification time match the previous run, its entries are
+    loaded from the cache instead. The cache is stored as JSON.
+    """
+    _VERSION = 1
+
+    def __init__(self, path: Optional[Path] = None):
+        self.path = path
+        self.hits = 0
+        self._files: Dict[str, Dict[str, Any]] = {}
+        self._used: Set[str] = set()
+
+        if path is not None and path.exists():
+            try:
+                contents = json.loads(path.read_text())
+            except ValueError:
+                _LOG.warning('Ignoring corrupt ELF entry cache %s', path)
+                return
+
+            if contents.get('version') == self._VERSION:
+                self._files = contents['files']
+
+    def read(self, elf: Path, domain: Pattern[str]) -> tokens.Database:
+        """Reads entries from an ELF, or from the cache if it is unchanged."""
+        key = f'{elf.resolve()}#{domain.pattern}'
+        stat = elf.stat()
+        signature = [stat.st_size, stat.st_mtime_ns]
+        self._used.add(key)
+
+        cached = self._files.get(key)
+        if cached is not None and cached['signature'] == signature:
+            self.hits += 1
+            return tokens.Database(
+                tokens.TokenizedStringEntry(token, string, entry_domain)
+                for token, entry_domain, string in cached['entries'])
+
+        with elf.open('rb') as fd:
+            database = _database_from_elf(fd, domain)
+
+        self._files[key] = dict(
+            signature=signature,
+            entries=[[entry.token, entry.domain, entry.string]
+                     for entry in database.entries()],
+        )
+        return database
+
+    def save(self) -> None:
+        """Writes the entries for ELFs read in this run to the cache file."""
+        if self.path is None:
+            return
+
+        files = {key: self._files[key] for key in sorted(self._used)}
+        self.path.write_text(
+            json.dumps(dict(version=self._VERSION, files=files)))
+
+
 def tokenization_domains(elf) -> Iterator[str]:
     """Lists all tokenization domains in an ELF file."""
     reader = _elf_reader(elf)
@@ -174,6 +234,9 @@ def _load_token_database(db, domain: Pattern[str]) -> tokens.Database:
     if isinstance(db, tokens.Database):
         return db
 
+    if isinstance(db, tokens.MappedDatabase):
+        return tokens.Database(db.entries())
+
     if isinstance(db, elf_reader.Elf):
         return _database_from_elf(db, domain)
 
@@ -277,6 +340,8 @@ def _handle_create(databases, database, force, output_type, include, exclude,
             tokens.write_csv(database, fd)
         elif output_type == 'binary':
             tokens.write_binary(database, fd)
+        elif output_type == 'compact':
+            tokens.write_compact(database, fd)
         else:
             raise ValueError(f'Unknown database type "{output_type}"')
 
@@ -290,7 +355,7 @@ def _handle_add(token_database, databases):
     for source in databases:
         token_database.add(source.entries())
 
-    token_database.write_to_file()
+    token_database.write_to_file_if_changed()
 
     _LOG.info('Added %d entries to %s',
               len(token_database) - initial, token_database.path)
@@ -301,12 +366,67 @@ def _handle_mark_removals(token_database, databases, date):
         (entry for entry in tokens.Database.merged(*databases).entries()
          if not entry.date_removed), date)
 
-    token_database.write_to_file()
+    token_database.write_to_file_if_changed()
 
     _LOG.info('Marked %d of %d entries as removed in %s', len(marked_removed),
               len(token_database), token_database.path)
 
 
+def _load_update_inputs(inputs: Iterable[str],
+                        cache: ElfEntryCache) -> Iterator[tokens.Database]:
+    """Loads ELFs through the cache and other databases directly."""
+    for value in inputs:
+        path, _, domain = value.partition('#')
+        domain_pattern = re.compile(domain)
+
+        for file in expand_paths_or_globs(path):
+            if elf_reader.compatible_file(file):
+                yield cache.read(file, domain_pattern)
+            elif domain:
+                raise ValueError(f'{file} is not an ELF file, '
+                                 f'but the "{domain}" domain was specified')
+            else:
+                yield load_token_database(file)
+
+
+def update_database(token_database: tokens.DatabaseFile,
+                    inputs: Iterable[str],
+                    date: Optional[datetime] = None,
+                    cache: Optional[Path] = None) -> bool:
+    """Adds new entries and marks missing entries as removed in one pass.
+
+    The result is identical to running the add and mark_removals commands with
+    the same inputs. ELFs that have not changed since the previous update are
+    read from the cache, if one is provided, and the database file is only
+    rewritten if its contents change.
+
+    Returns:
+      True if the database file was rewritten
+    """
+    entry_cache = ElfEntryCache(cache)
+    current = tokens.Database.merged(
+        *_load_update_inputs(inputs, entry_cache))
+
+    initial = len(token_database)
+    token_database.add(current.entries())
+    marked_removed = token_database.mark_removals(
+        (entry for entry in current.entries() if not entry.date_removed), date)
+
+    written = token_database.write_to_file_if_changed()
+    entry_cache.save()
+
+    _LOG.info(
+        'Added %d and marked %d entries as removed in %s (%s); '
+        '%d ELF files read from the cache', len(token_database) - initial,
+        len(marked_removed), token_database.path,
+        'updated' if written else 'unchanged', entry_cache.hits)
+    return written
+
+
+def _handle_update(token_database, inputs, date, cache):
+    update_database(token_database, inputs, date, cache)
+
+
 def _handle_purge(token_database, before):
     purged = token_database.purge(before)
     token_database.write_to_file()
@@ -457,7 +577,7 @@ def _parse_args():
         '-t',
         '--type',
         dest='output_type',
-        choices=('csv', 'binary'),
+        choices=('csv', 'binary', 'compact'),
         default='csv',
         help='Which type of database to create. (default: csv)')
     subparser.add_argument('-f',
@@ -534,6 +654,33 @@ def _parse_args():
         help=('The removal date to use for all strings. '
               'May be YYYY-MM-DD or "today". (default: today)'))
 
+    # The 'update' command adds entries and marks removals incrementally.
+    subparser = subparsers.add_parser(
+        'update',
+        parents=[option_db],
+        help=('Adds new strings and marks missing strings as removed, like '
+              'running add and mark_removals. Unchanged ELF files are read '
+              'from a cache, and the database is only rewritten if it '
+              'changes.'))
+    subparser.set_defaults(handler=_handle_update)
+    subparser.add_argument(
+        'inputs',
+        metavar='elf_or_token_database',
+        nargs='+',
+        help=('ELF or token database files from which to read strings and '
+              'tokens. For ELF files, the tokenization domain may be '
+              'specified after the path as #domain_name.'))
+    subparser.add_argument(
+        '--date',
+        type=year_month_day,
+        help=('The removal date to use for all strings. '
+              'May be YYYY-MM-DD or "today". (default: today)'))
+    subparser.add_argument(
+        '--cache',
+        type=Path,
+        help=('File in which to cache the entries read from ELF files between '
+              'updates. Created if it does not exist.'))
+
     # The 'purge' command removes old entries.
     subparser = subparsers.add_parser(
         'purge',
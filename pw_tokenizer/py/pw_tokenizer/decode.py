@@ -20,9 +20,17 @@ Missing, truncated, or otherwise corrupted arguments are handled and displayed
 in the resulting string with an error message.
 """
 
+import collections
 import re
 import struct
-from typing import Iterable, List, NamedTuple, Match, Sequence, Tuple
+from typing import (Iterable, List, Mapping, MutableMapping, NamedTuple, Match,
+                    Optional, Sequence, Tuple)
+
+# Status bytes for interned string arguments, which plain strings never use.
+# A reference is the marker followed by a one-byte ID. An announcement is the
+# marker, the ID, and a plain string. These values must match encode_args.h.
+INTERNED_STRING_REFERENCE = 0x7f
+INTERNED_STRING_ANNOUNCEMENT = 0xff
 
 
 def zigzag_decode(value: int) -> int:
@@ -84,14 +92,24 @@ class FormatSpec:
                 self._REMAP_TYPE.get(self.type, self.type)
             ])
 
-    def decode(self, encoded_arg: bytes) -> 'DecodedArg':
-        """Decodes the provided data according to this format specifier."""
+    def decode(
+        self,
+        encoded_arg: bytes,
+        interned_strings: Optional[Mapping[int, str]] = None
+    ) -> 'DecodedArg':
+        """Decodes the provided data according to this format specifier.
+
+        Args:
+          encoded_arg: the encoded argument, followed by any other data
+          interned_strings: the strings announced so far, by ID, with which to
+              expand interned string references
+        """
         if self.type == '%':  # literal %
             return DecodedArg(self, (),
                               b'')  # Use () as the value for % formatting.
 
         if self.type == 's':  # string
-            return self._decode_string(encoded_arg)
+            return self._decode_string(encoded_arg, interned_strings or {})
 
         if self.type == 'c':  # character
             return self._decode_char(encoded_arg)
@@ -151,11 +169,40 @@ class FormatSpec:
                           self._PACKED_FLOAT.unpack_from(encoded)[0],
                           encoded[:4])
 
-    def _decode_string(self, encoded: bytes) -> 'DecodedArg':
-        """Reads a unicode string from the encoded data."""
+    def _decode_string(self, encoded: bytes,
+                       interned_strings: Mapping[int, str]) -> 'DecodedArg':
+        """Reads a plain or interned string from the encoded data."""
         if not encoded:
             return DecodedArg.missing(self)
 
+        if encoded[0] == INTERNED_STRING_REFERENCE:
+            raw_data = encoded[:2]
+            if len(raw_data) < 2:
+                return DecodedArg(self, None, raw_data,
+                                  DecodedArg.DECODE_ERROR)
+
+            try:
+                return DecodedArg(self, interned_strings[raw_data[1]],
+                                  raw_data)
+            except KeyError:
+                return DecodedArg(
+                    self, 'unknown interned string {}'.format(raw_data[1]),
+                    raw_data, DecodedArg.DECODE_ERROR)
+
+        if encoded[0] == INTERNED_STRING_ANNOUNCEMENT:
+            if len(encoded) < 3:
+                return DecodedArg(self, None, encoded,
+                                  DecodedArg.DECODE_ERROR)
+
+            arg = self._decode_plain_string(encoded[2:])
+            arg.raw_data = encoded[:2] + arg.raw_data
+            arg.interned_id = encoded[1]
+            return arg
+
+        return self._decode_plain_string(encoded)
+
+    def _decode_plain_string(self, encoded: bytes) -> 'DecodedArg':
+        """Reads a unicode string from the encoded data."""
         size_and_status = encoded[0]
         status = DecodedArg.OK
 
@@ -231,6 +278,9 @@ class DecodedArg:
         self._status = status
         self.error = error
 
+        # The ID with which a string argument was announced, if it was.
+        self.interned_id: Optional[int] = None
+
     def ok(self) -> bool:
         """The argument was decoded without errors."""
         return self.status == self.OK or self.status == self.TRUNCATED
@@ -321,22 +371,38 @@ class FormatString:
 
         return segments
 
-    def decode(self, encoded: bytes) -> Tuple[Sequence[DecodedArg], bytes]:
+    def decode(
+        self,
+        encoded: bytes,
+        interned_strings: Optional[Mapping[int, str]] = None
+    ) -> Tuple[Sequence[DecodedArg], bytes]:
         """Decodes arguments according to the format string.
 
+        Strings announced by an argument may be referenced by later arguments
+        in the same message. The interned_strings mapping is not modified;
+        announced strings are reported by each DecodedArg's interned_id.
+
         Args:
           encoded: bytes; the encoded arguments
+          interned_strings: the strings announced in earlier messages, by ID
 
         Returns:
           tuple with the decoded arguments and any unparsed data
         """
         decoded_args = []
 
+        # Announcements in this message are added to the front of the chain.
+        strings: MutableMapping[int, str] = collections.ChainMap(
+            {}, interned_strings or {})
+
         fatal_error = False
         index = 0
 
         for spec in self.specifiers:
-            arg = spec.decode(encoded[index:])
+            arg = spec.decode(encoded[index:], strings)
+
+            if arg.interned_id is not None and arg.ok():
+                strings[arg.interned_id] = arg.value
 
             if fatal_error:
                 # After an error is encountered, continue to attempt to parse
@@ -351,21 +417,25 @@ class FormatString:
 
         return tuple(decoded_args), encoded[index:]
 
-    def format(self,
-               encoded_args: bytes,
-               show_errors: bool = False) -> FormattedString:
+    def format(
+        self,
+        encoded_args: bytes,
+        show_errors: bool = False,
+        interned_strings: Optional[Mapping[int, str]] = None
+    ) -> FormattedString:
         """Decodes arguments and formats the string with them.
 
         Args:
           encoded_args: the arguments to decode and format the string with
           show_errors: if True, an error message is used in place of the %
               conversion specifier when an argument fails to decode
+          interned_strings: the strings announced in earlier messages, by ID
 
         Returns:
           tuple with the formatted string, decoded arguments, and remaining data
         """
         # Insert formatted arguments in place of each format specifier.
-        args, remaining = self.decode(encoded_args)
+        args, remaining = self.decode(encoded_args, interned_strings)
 
         if show_errors:
             self._segments[1::2] = (arg.format() for arg in args)
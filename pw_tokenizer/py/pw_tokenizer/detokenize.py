@@ -37,6 +37,7 @@ import binascii
 from datetime import datetime
 import io
 import logging
+import multiprocessing
 import os
 from pathlib import Path
 import re
@@ -45,7 +46,8 @@ import struct
 import sys
 import time
 from typing import (BinaryIO, Callable, Dict, List, Iterable, Iterator, Match,
-                    NamedTuple, Optional, Pattern, Tuple, Union)
+                    MutableMapping, NamedTuple, Optional, Pattern, Tuple,
+                    Union)
 
 try:
     from pw_tokenizer import database, decode, tokens
@@ -66,7 +68,14 @@ class DetokenizedString:
                  token: Optional[int],
                  format_string_entries: Iterable[tuple],
                  encoded_message: bytes,
-                 show_errors: bool = False):
+                 show_errors: bool = False,
+                 interned_strings: Optional[MutableMapping[int, str]] = None):
+        """Decodes a message with each of the format strings for its token.
+
+        If interned_strings is provided, it is used to expand interned string
+        references, and strings announced by the best successful result are
+        added to it.
+        """
         self.token = token
         self.encoded_message = encoded_message
         self._show_errors = show_errors
@@ -78,7 +87,7 @@ class DetokenizedString:
 
         for entry, fmt in format_string_entries:
             result = fmt.format(encoded_message[ENCODED_TOKEN.size:],
-                                show_errors)
+                                show_errors, interned_strings)
 
             # Sort competing entries so the most likely matches appear first.
             # Decoded strings are prioritized by whether they
@@ -109,6 +118,11 @@ class DetokenizedString:
             else:
                 self.failures.append(result)
 
+        if interned_strings is not None and self.successes:
+            for arg in self.successes[0].args:
+                if arg.interned_id is not None:
+                    interned_strings[arg.interned_id] = arg.value
+
     def ok(self) -> bool:
         """True if exactly one string decoded the arguments successfully."""
         return len(self.successes) == 1
@@ -173,13 +187,28 @@ class Detokenizer:
 
         Args:
           *token_database_or_elf: a path or file object for an ELF or CSV
-              database, a tokens.Database, or an elf_reader.Elf
+              database, a tokens.Database, a tokens.MappedDatabase, or an
+              elf_reader.Elf
           show_errors: if True, an error message is used in place of the %
               conversion specifier when an argument fails to decode
         """
-        self.database = database.load_token_database(*token_database_or_elf)
+        self.database: Union[tokens.Database, tokens.MappedDatabase]
+
+        if (len(token_database_or_elf) == 1 and isinstance(
+                token_database_or_elf[0], tokens.MappedDatabase)):
+            # Search a memory-mapped database in place instead of loading it.
+            self.database = token_database_or_elf[0]
+        else:
+            self.database = database.load_token_database(
+                *token_database_or_elf)
+
         self.show_errors = show_errors
 
+        # Strings announced by string arguments, by ID. Devices that intern
+        # strings announce each string once, then refer to it by ID, so
+        # messages must be detokenized in the order they were encoded.
+        self.interned_strings: Dict[int, str] = {}
+
         # Cache FormatStrings for faster lookup & formatting.
         self._cache: Dict[int, List[_TokenizedFormatString]] = {}
 
@@ -203,7 +232,7 @@ class Detokenizer:
 
         token, = ENCODED_TOKEN.unpack_from(encoded_message)
         return DetokenizedString(token, self.lookup(token), encoded_message,
-                                 self.show_errors)
+                                 self.show_errors, self.interned_strings)
 
 
 class AutoUpdatingDetokenizer:
@@ -250,8 +279,10 @@ class AutoUpdatingDetokenizer:
 
             if any(path.updated() for path in self.paths):
                 _LOG.info('Changes detected; reloading token database')
+                interned_strings = self._detokenizer.interned_strings
                 self._detokenizer = Detokenizer(*(path.load()
                                                   for path in self.paths))
+                self._detokenizer.interned_strings = interned_strings
 
         return self._detokenizer.detokenize(data)
 
@@ -425,6 +456,79 @@ def detokenize_base64(detokenizer: _Detokenizer,
     return output.getvalue()
 
 
+class _Worker:
+    """State of each worker process in detokenize_base64_parallel."""
+    detokenizer: Optional[_Detokenizer] = None
+    prefix = BASE64_PREFIX
+    recursion = DEFAULT_RECURSION
+
+    @classmethod
+    def init(cls, detokenizer: _Detokenizer, prefix: bytes,
+             recursion: int) -> None:
+        cls.detokenizer = detokenizer
+        cls.prefix = prefix
+        cls.recursion = recursion
+
+    @classmethod
+    def detokenize(cls, chunk: bytes) -> bytes:
+        assert cls.detokenizer is not None
+        return detokenize_base64(cls.detokenizer, chunk, cls.prefix,
+                                 cls.recursion)
+
+
+def _split_lines(data: bytes, chunk_size: int) -> Iterator[bytes]:
+    """Splits data into chunks of at least chunk_size bytes at line ends."""
+    start = 0
+    while start < len(data):
+        end = data.find(b'\n', start + chunk_size - 1)
+        end = len(data) if end == -1 else end + 1
+        yield data[start:end]
+        start = end
+
+
+DEFAULT_CHUNK_SIZE = 1 << 20
+
+
+def detokenize_base64_parallel(detokenizer: _Detokenizer,
+                               data: bytes,
+                               output: BinaryIO,
+                               prefix: Union[str, bytes] = BASE64_PREFIX,
+                               recursion: int = DEFAULT_RECURSION,
+                               jobs: Optional[int] = None,
+                               chunk_size: int = DEFAULT_CHUNK_SIZE) -> None:
+    """Decodes prefixed Base64 messages in data with multiple processes.
+
+    The data is split into chunks at line boundaries. Base64 messages cannot
+    contain newlines, so no message is split. The chunks are detokenized by a
+    pool of worker processes and written to the output in their original order,
+    so the output is the same as from detokenize_base64_to_file.
+
+    Each worker process receives a copy of the detokenizer when it starts. On
+    platforms that fork processes, the copy shares the parent's memory until it
+    is modified, so the token database is not duplicated up front.
+
+    Workers do not share interned strings, so references to strings announced
+    in another chunk are not expanded. Use detokenize_base64_to_file for data
+    from devices that intern strings.
+
+    Args:
+      detokenizer: the detokenizer with which to decode messages
+      data: the binary data to decode
+      output: the file to which to write the decoded data
+      prefix: one-character byte string that signals the start of a message
+      recursion: how many levels to recursively decode
+      jobs: the number of worker processes; defaults to the number of CPUs
+      chunk_size: the approximate number of bytes to give each worker at once
+    """
+    prefix = prefix.encode() if isinstance(prefix, str) else prefix
+
+    with multiprocessing.Pool(jobs, _Worker.init,
+                              (detokenizer, prefix, recursion)) as pool:
+        for result in pool.imap(_Worker.detokenize,
+                                _split_lines(data, chunk_size)):
+            output.write(result)
+
+
 def _follow_and_detokenize_file(detokenizer: _Detokenizer,
                                 file: BinaryIO,
                                 output: BinaryIO,
@@ -445,7 +549,8 @@ def _follow_and_detokenize_file(detokenizer: _Detokenizer,
 
 
 def _handle_base64(databases, input_file: BinaryIO, output: BinaryIO,
-                   prefix: str, show_errors: bool, follow: bool) -> None:
+                   prefix: str, show_errors: bool, follow: bool,
+                   jobs: int) -> None:
     """Handles the base64 command line option."""
     # argparse.FileType doesn't correctly handle - for binary files.
     if input_file is sys.stdin:
@@ -459,6 +564,13 @@ def _handle_base64(databases, input_file: BinaryIO, output: BinaryIO,
 
     if follow:
         _follow_and_detokenize_file(detokenizer, input_file, output, prefix)
+    elif input_file.seekable() and jobs != 1:
+        # Split large seekable files across multiple processes.
+        detokenize_base64_parallel(detokenizer,
+                                   input_file.read(),
+                                   output,
+                                   prefix,
+                                   jobs=jobs or None)
     elif input_file.seekable():
         # Process seekable files all at once, which is MUCH faster.
         detokenize_base64_to_file(detokenizer, input_file.read(), output,
@@ -510,6 +622,14 @@ def _parse_args() -> argparse.Namespace:
         default=BASE64_PREFIX,
         help=('The one-character prefix that signals the start of a '
               'Base64-encoded message. (default: $)'))
+    subparser.add_argument(
+        '-j',
+        '--jobs',
+        type=int,
+        default=1,
+        help=('The number of processes with which to detokenize a seekable '
+              'input file; 0 uses one per CPU. Output order is preserved. '
+              '(default: 1)'))
     subparser.add_argument(
         '-s',
         '--show_errors',
@@ -13,17 +13,25 @@
 # the License.
 """Builds and manages databases of tokenized strings."""
 
+import array
 import collections
 import csv
+import ctypes
 from dataclasses import dataclass
 from datetime import datetime
+import functools
 import io
+import itertools
 import logging
+import mmap
+import operator
+import os
 from pathlib import Path
 import re
 import struct
 from typing import (BinaryIO, Callable, Dict, Iterable, Iterator, List,
-                    NamedTuple, Optional, Pattern, Tuple, Union, ValuesView)
+                    NamedTuple, Optional, Pattern, Sequence, Tuple, Union,
+                    ValuesView)
 
 DATE_FORMAT = '%Y-%m-%d'
 DEFAULT_DOMAIN = ''
@@ -38,11 +46,22 @@ DEFAULT_C_HASH_LENGTH = 128
 
 TOKENIZER_HASH_CONSTANT = 65599
 
+# If set, the path to the pw_tokenizer:hash_library shared library, which
+# hashes strings in bulk much faster than Python.
+HASH_LIBRARY_ENV_VAR = 'PW_TOKENIZER_HASH_LIBRARY'
+
 _LOG = logging.getLogger('pw_tokenizer')
 
+# The hash coefficients (65599^1, 65599^2, ...), extended as needed.
+_HASH_COEFFICIENTS: List[int] = [TOKENIZER_HASH_CONSTANT]
+
+
+def _hash_coefficients(count: int) -> List[int]:
+    while len(_HASH_COEFFICIENTS) < count:
+        _HASH_COEFFICIENTS.append(
+            (_HASH_COEFFICIENTS[-1] * TOKENIZER_HASH_CONSTANT) % 2**32)
 
-def _value(char: Union[int, str]) -> int:
-    return char if isinstance(char, int) else ord(char)
+    return _HASH_COEFFICIENTS
 
 
 def pw_tokenizer_65599_fixed_length_hash(string: Union[str, bytes],
@@ -52,20 +71,80 @@ def pw_tokenizer_65599_fixed_length_hash(string: Union[str, bytes],
     This hash function is only used when adding tokens from legacy-style
     tokenized strings in an ELF, which do not include the token.
     """
-    hash_value = len(string)
-    coefficient = TOKENIZER_HASH_CONSTANT
-
-    for char in string[:hash_length]:
-        hash_value = (hash_value + coefficient * _value(char)) % 2**32
-        coefficient = (coefficient * TOKENIZER_HASH_CONSTANT) % 2**32
-
-    return hash_value
+    hashed = string[:hash_length]
+    values = hashed if isinstance(hashed, bytes) else map(ord, hashed)
+    return (len(string) + sum(
+        map(operator.mul, _hash_coefficients(len(hashed)), values))) % 2**32
 
 
 def default_hash(string: Union[str, bytes]) -> int:
     return pw_tokenizer_65599_fixed_length_hash(string, DEFAULT_C_HASH_LENGTH)
 
 
+_NativeHash = Callable[[List[bytes], int], List[int]]
+
+
+@functools.lru_cache(maxsize=None)
+def _load_native_hash() -> Optional[_NativeHash]:
+    """Loads the bulk hash function from HASH_LIBRARY_ENV_VAR, if it is set."""
+    path = os.environ.get(HASH_LIBRARY_ENV_VAR)
+    if not path:
+        return None
+
+    try:
+        function = ctypes.CDLL(path).pw_tokenizer_65599FixedLengthHashes
+    except (OSError, AttributeError) as err:
+        _LOG.warning('Failed to load the hash library %s: %s', path, err)
+        return None
+
+    function.argtypes = (ctypes.c_char_p, ctypes.POINTER(ctypes.c_size_t),
+                         ctypes.c_size_t, ctypes.c_size_t,
+                         ctypes.POINTER(ctypes.c_uint32))
+    function.restype = None
+
+    def native_hash_strings(strings: List[bytes],
+                            hash_length: int) -> List[int]:
+        offsets = (ctypes.c_size_t * (len(strings) + 1))(
+            0, *itertools.accumulate(len(string) for string in strings))
+        hashes = (ctypes.c_uint32 * len(strings))()
+        function(b''.join(strings), offsets, len(strings), hash_length,
+                 hashes)
+        return list(hashes)
+
+    return native_hash_strings
+
+
+def hash_strings(strings: Sequence[Union[str, bytes]],
+                 hash_length: int = DEFAULT_C_HASH_LENGTH) -> List[int]:
+    """Hashes many strings with pw_tokenizer_65599_fixed_length_hash.
+
+    If the PW_TOKENIZER_HASH_LIBRARY environment variable is set to the path of
+    the pw_tokenizer:hash_library shared library, the hashes are calculated
+    natively. The native library hashes bytes, so str values that are not
+    ASCII are still hashed in Python, by code point.
+    """
+    native_hash = _load_native_hash()
+    if native_hash is None:
+        return [
+            pw_tokenizer_65599_fixed_length_hash(string, hash_length)
+            for string in strings
+        ]
+
+    encoded: List[Optional[bytes]] = [
+        string if isinstance(string, bytes) else
+        string.encode() if string.isascii() else None for string in strings
+    ]
+    native_hashes = iter(
+        native_hash([data for data in encoded if data is not None],
+                    hash_length))
+
+    return [
+        next(native_hashes) if data is not None else
+        pw_tokenizer_65599_fixed_length_hash(string, hash_length)
+        for string, data in zip(strings, encoded)
+    ]
+
+
 class _EntryKey(NamedTuple):
     """Uniquely refers to an entry."""
     token: int
@@ -131,6 +210,12 @@ class Database:
             domain: str = DEFAULT_DOMAIN,
             tokenize: Callable[[str], int] = default_hash) -> 'Database':
         """Creates a Database from an iterable of strings."""
+        if tokenize is default_hash:  # Hash the strings in bulk.
+            strings = list(strings)
+            return cls(
+                TokenizedStringEntry(token, string, domain)
+                for token, string in zip(hash_strings(strings), strings))
+
         return cls((TokenizedStringEntry(tokenize(string), string, domain)
                     for string in strings))
 
@@ -371,15 +456,27 @@ def _check_that_file_is_csv_database(path: Path) -> None:
         ) from err
 
 
+def _check_binary_magic(magic: bytes, source) -> None:
+    if magic != BINARY_FORMAT.magic:
+        raise DatabaseFormatError(
+            f'Binary token database magic number mismatch (found {magic!r}, '
+            f'expected {BINARY_FORMAT.magic!r}) while reading from {source}')
+
+
+def _binary_date_removed(day: int, month: int,
+                         year: int) -> Optional[datetime]:
+    try:
+        return datetime(year, month, day)
+    except ValueError:
+        return None
+
+
 def parse_binary(fd: BinaryIO) -> Iterable[TokenizedStringEntry]:
     """Parses TokenizedStringEntries from a binary token database file."""
     magic, entry_count = BINARY_FORMAT.header.unpack(
         fd.read(BINARY_FORMAT.header.size))
 
-    if magic != BINARY_FORMAT.magic:
-        raise DatabaseFormatError(
-            f'Binary token database magic number mismatch (found {magic!r}, '
-            f'expected {BINARY_FORMAT.magic!r}) while reading from {fd}')
+    _check_binary_magic(magic, fd)
 
     entries = []
 
@@ -387,12 +484,7 @@ def parse_binary(fd: BinaryIO) -> Iterable[TokenizedStringEntry]:
         token, day, month, year = BINARY_FORMAT.entry.unpack(
             fd.read(BINARY_FORMAT.entry.size))
 
-        try:
-            date_removed: Optional[datetime] = datetime(year, month, day)
-        except ValueError:
-            date_removed = None
-
-        entries.append((token, date_removed))
+        entries.append((token, _binary_date_removed(day, month, year)))
 
     # Read the entire string table and define a function for looking up strings.
     string_table = fd.read()
@@ -408,6 +500,23 @@ def parse_binary(fd: BinaryIO) -> Iterable[TokenizedStringEntry]:
         yield TokenizedStringEntry(token, string, DEFAULT_DOMAIN, removed)
 
 
+def _pack_binary_entry(entry: TokenizedStringEntry) -> bytes:
+    if entry.date_removed:
+        removed_day = entry.date_removed.day
+        removed_month = entry.date_removed.month
+        removed_year = entry.date_removed.year
+    else:
+        # If there is no removal date, use the special value 0xffffffff for
+        # the day/month/year. That ensures that still-present tokens appear
+        # as the newest tokens when sorted by removal date.
+        removed_day = 0xff
+        removed_month = 0xff
+        removed_year = 0xffff
+
+    return BINARY_FORMAT.entry.pack(entry.token, removed_day, removed_month,
+                                    removed_year)
+
+
 def write_binary(database: Database, fd: BinaryIO) -> None:
     """Writes the database as packed binary to the provided binary file."""
     entries = sorted(database.entries())
@@ -417,33 +526,293 @@ def write_binary(database: Database, fd: BinaryIO) -> None:
     string_table = bytearray()
 
     for entry in entries:
-        if entry.date_removed:
-            removed_day = entry.date_removed.day
-            removed_month = entry.date_removed.month
-            removed_year = entry.date_removed.year
-        else:
-            # If there is no removal date, use the special value 0xffffffff for
-            # the day/month/year. That ensures that still-present tokens appear
-            # as the newest tokens when sorted by removal date.
-            removed_day = 0xff
-            removed_month = 0xff
-            removed_year = 0xffff
-
         string_table += entry.string.encode()
         string_table.append(0)
 
-        fd.write(
-            BINARY_FORMAT.entry.pack(entry.token, removed_day, removed_month,
-                                     removed_year))
+        fd.write(_pack_binary_entry(entry))
 
     fd.write(string_table)
 
 
+class _CompactFileFormat(NamedTuple):
+    """Attributes of the compact binary token database file format.
+
+    The compact format is read by pw::tokenizer::CompactTokenDatabase. See
+    pw_tokenizer/compact_token_database.h for a description of the format.
+    """
+
+    magic: bytes = b'TOKENS\1\0'
+    header: struct.Struct = struct.Struct('<8sIHH')
+    offset: struct.Struct = struct.Struct('<I')
+    block_size: int = 16
+    max_words: int = 128
+    escape: int = 0x7f
+    first_word: int = 0x80
+
+    # Strings are split into words, with the spaces that follow them, and runs
+    # of punctuation, so that common words become dictionary entries.
+    word: Pattern[str] = re.compile(r'\w+ ?|[^\w\s]+ ?|\s')
+
+
+COMPACT_FORMAT = _CompactFileFormat()
+
+
+def file_is_compact_database(fd: BinaryIO) -> bool:
+    """True if the file starts with the compact database magic string."""
+    try:
+        fd.seek(0)
+        magic = fd.read(len(COMPACT_FORMAT.magic))
+        fd.seek(0)
+        return COMPACT_FORMAT.magic == magic
+    except IOError:
+        return False
+
+
+def _compact_dictionary(strings: Iterable[str]) -> List[str]:
+    """Selects the words that save the most space as dictionary entries."""
+    counts = collections.Counter(
+        word for string in strings
+        for word in COMPACT_FORMAT.word.findall(string))
+
+    # Each use of a word saves all but one of its bytes. Storing the word costs
+    # its bytes, a null terminator, and a 4-byte offset.
+    savings = []
+    for word, count in counts.items():
+        size = len(word.encode())
+        saved = count * (size - 1) - size - 1 - COMPACT_FORMAT.offset.size
+        if saved > 0:
+            savings.append((saved, word))
+
+    savings.sort(reverse=True)
+    return [word for _, word in savings[:COMPACT_FORMAT.max_words]]
+
+
+def _compact_string(string: str, words: Dict[str, int]) -> bytes:
+    """Compresses a string, replacing dictionary words with their indices."""
+    compressed = bytearray()
+
+    for word in COMPACT_FORMAT.word.findall(string):
+        if word in words:
+            compressed.append(COMPACT_FORMAT.first_word + words[word])
+            continue
+
+        for byte in word.encode():
+            if byte >= COMPACT_FORMAT.escape:
+                compressed.append(COMPACT_FORMAT.escape)
+            compressed.append(byte)
+
+    compressed.append(0)
+    return bytes(compressed)
+
+
+def write_compact(database: Database,
+                  fd: BinaryIO,
+                  block_size: int = COMPACT_FORMAT.block_size) -> None:
+    """Writes the database in the compact binary format to the file.
+
+    Strings are compressed with a dictionary of common words and grouped into
+    blocks of block_size strings. Larger blocks make the database slightly
+    smaller, but lookups must skip over more strings.
+    """
+    entries = sorted(database.entries())
+    words = _compact_dictionary(entry.string for entry in entries)
+    word_indices = {word: index for index, word in enumerate(words)}
+    strings = [_compact_string(entry.string, word_indices) for entry in entries]
+
+    block_count = (len(entries) + block_size - 1) // block_size
+    offset = (COMPACT_FORMAT.header.size +
+              len(entries) * BINARY_FORMAT.entry.size +
+              (block_count + len(words)) * COMPACT_FORMAT.offset.size)
+
+    word_table = bytearray()
+    word_offsets = bytearray()
+    for word in words:
+        word_offsets += COMPACT_FORMAT.offset.pack(offset + len(word_table))
+        word_table += word.encode() + b'\0'
+
+    offset += len(word_table)
+
+    block_offsets = bytearray()
+    for index in range(0, len(strings), block_size):
+        block_offsets += COMPACT_FORMAT.offset.pack(offset)
+        offset += sum(
+            len(string) for string in strings[index:index + block_size])
+
+    fd.write(
+        COMPACT_FORMAT.header.pack(COMPACT_FORMAT.magic, len(entries),
+                                   block_size, len(words)))
+    fd.write(b''.join(_pack_binary_entry(entry) for entry in entries))
+    fd.write(block_offsets)
+    fd.write(word_offsets)
+    fd.write(word_table)
+    fd.write(b''.join(strings))
+
+
+def parse_compact(fd: BinaryIO) -> Iterable[TokenizedStringEntry]:
+    """Parses TokenizedStringEntries from a compact binary database file."""
+    data = fd.read()
+
+    magic, entry_count, block_size, word_count = (
+        COMPACT_FORMAT.header.unpack_from(data))
+
+    if magic != COMPACT_FORMAT.magic:
+        raise DatabaseFormatError(
+            f'Compact token database magic number mismatch (found {magic!r}, '
+            f'expected {COMPACT_FORMAT.magic!r}) while reading from {fd}')
+
+    offset = COMPACT_FORMAT.header.size
+    entries = []
+    for _ in range(entry_count):
+        token, day, month, year = BINARY_FORMAT.entry.unpack_from(data, offset)
+        entries.append((token, _binary_date_removed(day, month, year)))
+        offset += BINARY_FORMAT.entry.size
+
+    block_count = (entry_count + block_size - 1) // block_size
+    offset += block_count * COMPACT_FORMAT.offset.size
+
+    words = []
+    for _ in range(word_count):
+        start, = COMPACT_FORMAT.offset.unpack_from(data, offset)
+        words.append(data[start:data.index(b'\0', start)])
+        offset += COMPACT_FORMAT.offset.size
+
+    # The strings follow the last word, or the offsets if there are no words.
+    if words:
+        offset = data.index(b'\0', start) + 1
+
+    for token, removed in entries:
+        string = bytearray()
+        while data[offset] != 0:
+            byte = data[offset]
+            if byte >= COMPACT_FORMAT.first_word:
+                string += words[byte - COMPACT_FORMAT.first_word]
+            else:
+                if byte == COMPACT_FORMAT.escape:
+                    offset += 1
+                string.append(data[offset])
+            offset += 1
+
+        offset += 1
+        yield TokenizedStringEntry(token, string.decode(), DEFAULT_DOMAIN,
+                                   removed)
+
+
+class MappedDatabase:
+    """A binary token database that is searched without parsing it.
+
+    The database file is memory-mapped, so opening it takes constant time
+    regardless of its size. Entries are found with a binary search over the
+    sorted entry table. Strings are located with an index of string offsets,
+    which is built the first time a string is read.
+
+    A MappedDatabase is read-only. It may be passed directly to a Detokenizer
+    or loaded into a Database with load_token_database.
+    """
+    def __init__(self, path_or_data: Union[Path, str, bytes]):
+        """Maps a binary token database file or wraps binary database data."""
+        self._path: Optional[Path] = None
+
+        if isinstance(path_or_data, (str, Path)):
+            self._path = Path(path_or_data)
+            with self._path.open('rb') as fd:
+                try:
+                    self._data: Union[bytes, mmap.mmap] = mmap.mmap(
+                        fd.fileno(), 0, access=mmap.ACCESS_READ)
+                except ValueError as err:  # The file is empty.
+                    raise DatabaseFormatError(
+                        f'{self._path} is not a binary token database'
+                    ) from err
+        else:
+            self._data = path_or_data
+
+        if len(self._data) < BINARY_FORMAT.header.size:
+            raise DatabaseFormatError(
+                'Binary token database is too short for its header')
+
+        magic, self._entry_count = BINARY_FORMAT.header.unpack_from(self._data)
+        _check_binary_magic(magic, self._path or 'data')
+
+        self._string_table = (BINARY_FORMAT.header.size +
+                              self._entry_count * BINARY_FORMAT.entry.size)
+        if len(self._data) < self._string_table:
+            raise DatabaseFormatError(
+                f'Binary token database has {self._entry_count} entries, but '
+                'is too short to contain them')
+
+        # Total length of the strings before each string; built as needed.
+        self._string_lengths: Optional[array.array] = None
+
+    def __reduce__(self):
+        """Pickles the database by path, so it is mapped again when loaded."""
+        return MappedDatabase, (self._path or bytes(self._data), )
+
+    def _token(self, index: int) -> int:
+        return struct.unpack_from(
+            '<I', self._data,
+            BINARY_FORMAT.header.size + index * BINARY_FORMAT.entry.size)[0]
+
+    def _string(self, index: int) -> str:
+        if self._string_lengths is None:
+            # Splitting the string table, measuring, and summing all happen in
+            # C, which is much faster than finding each string in Python.
+            self._string_lengths = array.array(
+                'Q',
+                itertools.accumulate(map(
+                    len, self._data[self._string_table:].split(b'\0')),
+                                     initial=0))
+
+        start = self._string_table + self._string_lengths[index] + index
+        end = start + (self._string_lengths[index + 1] -
+                       self._string_lengths[index])
+        return self._data[start:end].decode()
+
+    def _entry(self, index: int) -> TokenizedStringEntry:
+        token, day, month, year = BINARY_FORMAT.entry.unpack_from(
+            self._data,
+            BINARY_FORMAT.header.size + index * BINARY_FORMAT.entry.size)
+        return TokenizedStringEntry(token, self._string(index),
+                                    DEFAULT_DOMAIN,
+                                    _binary_date_removed(day, month, year))
+
+    def lookup(self, token: int) -> List[TokenizedStringEntry]:
+        """Returns the entries for a token, found with a binary search."""
+        low, high = 0, self._entry_count
+        while low < high:
+            middle = (low + high) // 2
+            if self._token(middle) < token:
+                low = middle + 1
+            else:
+                high = middle
+
+        entries = []
+        while low < self._entry_count and self._token(low) == token:
+            entries.append(self._entry(low))
+            low += 1
+
+        return entries
+
+    def __getitem__(self, token: int) -> List[TokenizedStringEntry]:
+        return self.lookup(token)
+
+    @property
+    def token_to_entries(self) -> 'MappedDatabase':
+        """Looks up entries by token, like Database.token_to_entries."""
+        return self
+
+    def entries(self) -> Iterator[TokenizedStringEntry]:
+        """Yields every entry in the database, in order."""
+        return (self._entry(i) for i in range(self._entry_count))
+
+    def __len__(self) -> int:
+        """Returns the number of entries in the database."""
+        return self._entry_count
+
+
 class DatabaseFile(Database):
     """A token database that is associated with a particular file.
 
     This class adds the write_to_file() method that writes to file from which it
-    was created in the correct format (CSV or binary).
+    was created in the correct format (CSV, binary, or compact binary).
     """
     def __init__(self, path: Union[Path, str]):
         self.path = Path(path)
@@ -455,6 +824,11 @@ class DatabaseFile(Database):
                 self._export = write_binary
                 return
 
+            if file_is_compact_database(fd):
+                super().__init__(parse_compact(fd))
+                self._export = write_compact
+                return
+
         # Read the path as a CSV file.
         _check_that_file_is_csv_database(self.path)
         with self.path.open('r', newline='') as file:
@@ -465,3 +839,19 @@ class DatabaseFile(Database):
         """Exports in the original format to the original or provided path."""
         with open(self.path if path is None else path, 'wb') as fd:
             self._export(self, fd)
+
+    def write_to_file_if_changed(self) -> bool:
+        """Rewrites the original file only if its contents would change.
+
+        Returns:
+          True if the file was written
+        """
+        with io.BytesIO() as fd:
+            self._export(self, fd)
+            data = fd.getvalue()
+
+        if self.path.read_bytes() == data:
+            return False
+
+        self.path.write_bytes(data)
+        return True
@@ -21,6 +21,7 @@ from pathlib import Path
 import tempfile
 from typing import Iterator
 import unittest
+from unittest import mock
 
 from pw_tokenizer import tokens
 from pw_tokenizer.tokens import default_hash, _LOG
@@ -100,6 +101,64 @@ def _entries(*strings: str) -> Iterator[tokens.TokenizedStringEntry]:
         yield tokens.TokenizedStringEntry(default_hash(string), string)
 
 
+def _reference_hash(string, hash_length: int) -> int:
+    """Straightforward version of the hash, as in pw_tokenizer/hash.h."""
+    hash_value = len(string)
+    coefficient = 65599
+
+    for char in string[:hash_length]:
+        value = char if isinstance(char, int) else ord(char)
+        hash_value = (hash_value + coefficient * value) % 2**32
+        coefficient = (coefficient * 65599) % 2**32
+
+    return hash_value
+
+
+_HASH_TEST_STRINGS = ('', 'a', '\0\0', 'Hello, %s!', 'o000', b'\xff\x00byte',
+                      'non-ASCII: \u00e9\u20ac', 'x' * 200)
+
+
+class HashTest(unittest.TestCase):
+    """Tests the Python hashing functions."""
+    def test_fixed_length_hash_matches_reference(self):
+        for string in _HASH_TEST_STRINGS:
+            for hash_length in (1, 4, 80, 96, 128, 1000):
+                self.assertEqual(
+                    tokens.pw_tokenizer_65599_fixed_length_hash(
+                        string, hash_length),
+                    _reference_hash(string, hash_length))
+
+    def test_hash_strings_without_library(self):
+        with mock.patch.object(tokens, '_load_native_hash', lambda: None):
+            self.assertEqual(
+                tokens.hash_strings(_HASH_TEST_STRINGS, 80),
+                [_reference_hash(s, 80) for s in _HASH_TEST_STRINGS])
+
+    def test_hash_strings_with_library_passes_only_bytes(self):
+        calls = []
+
+        def native_hash(strings, hash_length):
+            calls.append(strings)
+            return [_reference_hash(s, hash_length) for s in strings]
+
+        with mock.patch.object(tokens, '_load_native_hash',
+                               lambda: native_hash):
+            self.assertEqual(
+                tokens.hash_strings(_HASH_TEST_STRINGS, 96),
+                [_reference_hash(s, 96) for s in _HASH_TEST_STRINGS])
+
+        # Non-ASCII str values are hashed by code point in Python.
+        self.assertEqual(len(calls), 1)
+        self.assertEqual(len(calls[0]), len(_HASH_TEST_STRINGS) - 1)
+        self.assertTrue(all(isinstance(s, bytes) for s in calls[0]))
+
+    def test_from_strings_uses_default_hash(self):
+        db = tokens.Database.from_strings(['one', 'two'], 'domain')
+        self.assertEqual(
+            sorted((e.token, e.string, e.domain) for e in db.entries()),
+            sorted((default_hash(s), s, 'domain') for s in ['one', 'two']))
+
+
 class TokenDatabaseTest(unittest.TestCase):
     """Tests the token database class."""
     def test_csv(self):
@@ -392,6 +451,55 @@ class TokenDatabaseTest(unittest.TestCase):
 
         self.assertEqual(str(db), CSV_DATABASE)
 
+    def test_compact_format_round_trip(self):
+        db = read_db_from_csv(CSV_DATABASE)
+
+        for block_size in (1, 3, 16):
+            with io.BytesIO() as fd:
+                tokens.write_compact(db, fd, block_size)
+                fd.seek(0)
+                self.assertTrue(tokens.file_is_compact_database(fd))
+                self.assertFalse(tokens.file_is_binary_database(fd))
+                compact_db = tokens.Database(tokens.parse_compact(fd))
+
+            self.assertEqual(str(compact_db), CSV_DATABASE)
+
+    def test_compact_format_parse(self):
+        # Two words ("the " and "%s") and strings in blocks of two.
+        data = (b'TOKENS\1\0\x04\0\0\0\x02\0\x02\0'
+                b'\x01\0\0\0\xff\xff\xff\xff\x05\0\0\0\xff\xff\xff\xff'
+                b'\x05\0\0\0\x01\x02\xe5\x07\x09\0\0\0\xff\xff\xff\xff'
+                b'\x48\0\0\0\x59\0\0\0\x40\0\0\0\x45\0\0\0the \0%s\0'
+                b'Hello, \x80world\0\x80\x81\0caf\x7f\xc3\x7f\xa9\0\x7f\x7f!\0')
+
+        with io.BytesIO(data) as fd:
+            entries = list(tokens.parse_compact(fd))
+
+        self.assertEqual([(e.token, e.string, e.date_removed) for e in entries],
+                         [(1, 'Hello, the world', None), (5, 'the %s', None),
+                          (5, 'caf\u00e9', datetime.datetime(2021, 2, 1)),
+                          (9, '\x7f!', None)])
+
+    def test_compact_format_compresses_common_words(self):
+        db = tokens.Database.from_strings(
+            f'The {name} task failed to start: %s' for name in
+            ('network', 'display', 'sensor', 'logging', 'storage', 'audio'))
+
+        with io.BytesIO() as fd:
+            tokens.write_binary(db, fd)
+            binary_size = len(fd.getvalue())
+
+        with io.BytesIO() as fd:
+            tokens.write_compact(db, fd)
+            compact = fd.getvalue()
+
+        self.assertLess(len(compact), binary_size)
+        self.assertIn(b'failed \0', compact)
+
+        with io.BytesIO(compact) as fd:
+            self.assertEqual(str(tokens.Database(tokens.parse_compact(fd))),
+                             str(db))
+
 
 class TestDatabaseFile(unittest.TestCase):
     """Tests the DatabaseFile class."""
@@ -415,6 +523,23 @@ class TestDatabaseFile(unittest.TestCase):
         self.assertEqual(self._path.read_text(),
                          CSV_DATABASE + 'ffffffff,          ,"New entry!"\n')
 
+    def test_update_compact_file(self):
+        with self._path.open('wb') as fd:
+            tokens.write_compact(read_db_from_csv(CSV_DATABASE), fd)
+
+        db = tokens.DatabaseFile(self._path)
+        self.assertEqual(str(db), CSV_DATABASE)
+
+        db.add([tokens.TokenizedStringEntry(0xffffffff, 'New entry!')])
+        db.write_to_file()
+
+        with self._path.open('rb') as fd:
+            self.assertTrue(tokens.file_is_compact_database(fd))
+            compact_db = tokens.Database(tokens.parse_compact(fd))
+
+        self.assertEqual(str(compact_db),
+                         CSV_DATABASE + 'ffffffff,          ,"New entry!"\n')
+
     def test_csv_file_too_short_raises_exception(self):
         self._path.write_text('1234')
 
@@ -434,6 +559,67 @@ class TestDatabaseFile(unittest.TestCase):
             tokens.DatabaseFile(self._path)
 
 
+class TestMappedDatabase(unittest.TestCase):
+    """Tests the MappedDatabase class."""
+    def setUp(self):
+        file = tempfile.NamedTemporaryFile(delete=False)
+        file.write(BINARY_DATABASE)
+        file.close()
+        self._path = Path(file.name)
+
+    def tearDown(self):
+        self._path.unlink()
+
+    def test_entries_match_parsed_database(self):
+        db = tokens.Database(tokens.MappedDatabase(self._path).entries())
+        self.assertEqual(str(db), CSV_DATABASE)
+
+    def test_lookup(self):
+        db = tokens.MappedDatabase(self._path)
+        self.assertEqual(len(db), 16)
+
+        for entry in read_db_from_csv(CSV_DATABASE).entries():
+            self.assertEqual(db.lookup(entry.token), [entry])
+
+        self.assertEqual(db.lookup(1), [])
+        self.assertEqual(db.lookup(0xffffffff), [])
+
+    def test_lookup_collisions(self):
+        db = tokens.Database(_entries('a', 'b'))
+        db.add([tokens.TokenizedStringEntry(default_hash('a'), 'collision')])
+
+        with io.BytesIO() as fd:
+            tokens.write_binary(db, fd)
+            mapped = tokens.MappedDatabase(fd.getvalue())
+
+        self.assertEqual(
+            sorted(e.string for e in mapped.lookup(default_hash('a'))),
+            ['a', 'collision'])
+        self.assertEqual([e.string for e in mapped[default_hash('b')]], ['b'])
+
+    def test_empty_database(self):
+        with io.BytesIO() as fd:
+            tokens.write_binary(tokens.Database(), fd)
+            db = tokens.MappedDatabase(fd.getvalue())
+
+        self.assertEqual(len(db), 0)
+        self.assertEqual(db.lookup(0), [])
+
+    def test_bad_magic_raises_exception(self):
+        with self.assertRaises(tokens.DatabaseFormatError):
+            tokens.MappedDatabase(b'TOKENZ\0\0' + BINARY_DATABASE[8:])
+
+    def test_truncated_raises_exception(self):
+        with self.assertRaises(tokens.DatabaseFormatError):
+            tokens.MappedDatabase(BINARY_DATABASE[:40])
+
+    def test_empty_file_raises_exception(self):
+        self._path.write_bytes(b'')
+
+        with self.assertRaises(tokens.DatabaseFormatError):
+            tokens.MappedDatabase(self._path)
+
+
 class TestFilter(unittest.TestCase):
     """Tests the filtering functionality."""
     def setUp(self):
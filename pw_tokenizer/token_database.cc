@@ -14,7 +14,21 @@
 
 #include "pw_tokenizer/token_database.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace pw::tokenizer {
+namespace {
+
+// Returns the string that follows count null-terminated strings.
+const char* SkipStrings(const char* string, size_t count) {
+  for (; count > 0u; --count) {
+    string += std::strlen(string) + 1;
+  }
+  return string;
+}
+
+}  // namespace
 
 TokenDatabase::Entry TokenDatabase::Entries::operator[](size_t index) const {
   Iterator it = begin();
@@ -24,18 +38,58 @@ TokenDatabase::Entry TokenDatabase::Entries::operator[](size_t index) const {
   return it.entry();
 }
 
+void TokenDatabase::FindRange(const uint32_t token,
+                              const RawEntry*& first,
+                              const RawEntry*& last) const {
+  first = std::lower_bound(
+      begin_.entry, end_.entry, token, [](const RawEntry& entry, uint32_t t) {
+        return entry.token < t;
+      });
+  last = std::upper_bound(
+      first, end_.entry, token, [](uint32_t t, const RawEntry& entry) {
+        return t < entry.token;
+      });
+}
+
 TokenDatabase::Entries TokenDatabase::Find(const uint32_t token) const {
-  Iterator first = begin();
-  while (first != end() && token > first->token) {
-    ++first;
+  const RawEntry* first;
+  const RawEntry* last;
+  FindRange(token, first, last);
+
+  const char* first_string = SkipStrings(strings(), first - begin_.entry);
+  return Entries(Iterator(first, first_string),
+                 Iterator(last, SkipStrings(first_string, last - first)));
+}
+
+TokenDatabase::Entries TokenDatabase::Find(
+    const uint32_t token, std::span<const uint32_t> string_index) const {
+  if (string_index.size() < size()) {
+    return Find(token);
   }
 
-  Iterator last = first;
-  while (last != end() && token == last->token) {
-    ++last;
+  const RawEntry* first;
+  const RawEntry* last;
+  FindRange(token, first, last);
+
+  auto string_for = [this, string_index](const RawEntry* entry) {
+    const size_t index = entry - begin_.entry;
+    return index < size() ? strings() + string_index[index] : nullptr;
+  };
+  return Entries(Iterator(first, string_for(first)),
+                 Iterator(last, string_for(last)));
+}
+
+bool TokenDatabase::BuildStringIndex(std::span<uint32_t> string_index) const {
+  if (string_index.size() < size()) {
+    return false;
   }
 
-  return Entries(first, last);
+  const char* string = strings();
+  for (size_t i = 0; i < size(); ++i) {
+    string_index[i] = static_cast<uint32_t>(string - strings());
+    string += std::strlen(string) + 1;
+  }
+  return true;
 }
 
 }  // namespace pw::tokenizer
@@ -17,10 +17,12 @@
 // derived from the fuzz data) is set. We then run iterations and 'find'
 // operations on this database.
 
+#include <chrono>
 #include <cstring>
 #include <span>
 
 #include "pw_fuzzer/asan_interface.h"
+#include "pw_fuzzer/execution_budget.h"
 #include "pw_fuzzer/fuzzed_data_provider.h"
 #include "pw_preprocessor/util.h"
 #include "pw_tokenizer/token_database.h"
@@ -45,6 +47,13 @@ constexpr size_t kFuzzDataSizeMax = 4096;
 constexpr size_t kEntryCountOffset = 8;
 constexpr size_t kEntryCountSize = 4;
 
+// Creating, searching, and iterating over the database should take linear time
+// and not allocate. The only allocations are the fuzzer's own vectors.
+constexpr auto kBudget =
+    fuzzer::ExecutionBudget()
+        .Time(std::chrono::milliseconds(10), std::chrono::microseconds(10))
+        .Allocations(16, 0);
+
 void SetTokenEntryCountInBuffer(uint8_t* buffer, uint32_t count) {
   memcpy(buffer + kEntryCountOffset, &count, kEntryCountSize);
 }
@@ -72,6 +81,8 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
     return 0;
   }
 
+  fuzzer::BudgetScope budget(kBudget, size);
+
   FuzzedDataProvider provider(data, size);
 
   // Initialize the token header with either a valid or invalid header
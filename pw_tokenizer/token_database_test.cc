@@ -14,6 +14,7 @@
 
 #include "pw_tokenizer/token_database.h"
 
+#include <array>
 #include <cstring>
 #include <string>
 #include <string_view>
@@ -238,6 +239,54 @@ TEST(TokenDatabase, MultipleEntriesWithSameToken) {
   }
 }
 
+TEST(TokenDatabase, BuildStringIndex_TooSmall) {
+  std::array<uint32_t, 4> string_index{};
+  EXPECT_FALSE(kCollisions.BuildStringIndex(string_index));
+  EXPECT_EQ(string_index[0], 0u);
+}
+
+TEST(TokenDatabase, FindWithStringIndex) {
+  std::array<uint32_t, 5> string_index;
+  ASSERT_TRUE(kCollisions.BuildStringIndex(string_index));
+  EXPECT_EQ(string_index[0], 0u);
+  EXPECT_EQ(string_index[1], 4u);
+  EXPECT_EQ(string_index[2], 12u);
+
+  TokenDatabase::Entries match = kCollisions.Find(1, string_index);
+  ASSERT_EQ(match.size(), 3u);
+  EXPECT_STREQ(match[0].string, "hi!");
+  EXPECT_STREQ(match[1].string, "goodbye");
+  EXPECT_STREQ(match[2].string, ":)");
+
+  match = kCollisions.Find(0xff, string_index);
+  ASSERT_EQ(match.size(), 1u);
+  EXPECT_STREQ(match[0].string, "");
+
+  EXPECT_TRUE(kCollisions.Find(0, string_index).empty());
+  EXPECT_TRUE(kCollisions.Find(3, string_index).empty());
+  EXPECT_TRUE(kCollisions.Find(0x100, string_index).empty());
+}
+
+TEST(TokenDatabase, FindWithStringIndex_IndexTooSmall) {
+  std::array<uint32_t, 1> string_index{};
+  TokenDatabase::Entries match = kBasicDatabase.Find(2, string_index);
+  ASSERT_EQ(match.size(), 1u);
+  EXPECT_STREQ(match[0].string, "goodbye");
+}
+
+TEST(TokenDatabase, FindWithStringIndex_MatchesFind) {
+  std::array<uint32_t, 3> string_index;
+  ASSERT_TRUE(kBasicDatabase.BuildStringIndex(string_index));
+
+  for (const TokenDatabase::Entry& entry : kBasicDatabase) {
+    TokenDatabase::Entries match = kBasicDatabase.Find(entry.token);
+    TokenDatabase::Entries indexed =
+        kBasicDatabase.Find(entry.token, string_index);
+    ASSERT_EQ(match.size(), indexed.size());
+    EXPECT_EQ(match[0].string, indexed[0].string);
+  }
+}
+
 TEST(TokenDatabase, Empty) {
   constexpr TokenDatabase empty_db = TokenDatabase::Create<kEmptyData>();
   static_assert(empty_db.size() == 0u);
@@ -0,0 +1,245 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Benchmarks tokenization and detokenization. Tokenized messages with a range
+// of argument counts and types are encoded repeatedly, as in the logging hot
+// path. Messages are then detokenized with a generated database of several
+// thousand entries, with and without the Detokenizer's result cache. Each
+// case is a pw_unit_test benchmark of one message, construction, or lookup per
+// iteration.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "pw_tokenizer/detokenize.h"
+#include "pw_tokenizer/hash.h"
+#include "pw_tokenizer/token_database.h"
+#include "pw_tokenizer/tokenize.h"
+#include "pw_unit_test/benchmark.h"
+
+namespace pw::tokenizer {
+namespace {
+
+using unit_test::BenchmarkState;
+
+constexpr size_t kDatabaseEntries = 4096;
+
+// Distinct messages to detokenize. Detokenizing cycles through them, so they
+// repeat as log messages do.
+constexpr size_t kDistinctMessages = 256;
+
+// Arguments are read from volatile variables in each iteration so that the
+// compiler cannot encode them in advance.
+volatile int int_arg = -1234;
+volatile long long int64_arg = 1ll << 40;
+volatile double double_arg = 3.25;
+const char* volatile string_arg = "sensor";
+
+// Benchmarks tokenizing the message to a buffer. The format string must be a
+// literal, so this is a macro.
+#define BENCHMARK_TOKENIZE(name, ...)                                    \
+  unit_test::RunBenchmark(name, {}, [](BenchmarkState& state) {          \
+    std::array<uint8_t, 64> buffer;                                      \
+    size_t encoded_bytes = 0;                                            \
+    for (auto _ : state) {                                               \
+      size_t size = buffer.size();                                       \
+      PW_TOKENIZE_TO_BUFFER(buffer.data(), &size, __VA_ARGS__);          \
+      encoded_bytes += size;                                             \
+    }                                                                    \
+    EXPECT_GE(encoded_bytes, state.iterations() * sizeof(uint32_t));     \
+  })
+
+TEST(TokenizerBenchmark, Tokenize) {
+  BENCHMARK_TOKENIZE("no arguments", "The system is ready");
+  BENCHMARK_TOKENIZE("1 int", "Battery at %d%%", int(int_arg));
+  BENCHMARK_TOKENIZE("4 ints",
+                     "Position %d, %d, %d; heading %d",
+                     int(int_arg),
+                     int(int_arg),
+                     int(int_arg),
+                     int(int_arg));
+  BENCHMARK_TOKENIZE("8 ints",
+                     "%d %d %d %d %d %d %d %d",
+                     int(int_arg),
+                     int(int_arg),
+                     int(int_arg),
+                     int(int_arg),
+                     int(int_arg),
+                     int(int_arg),
+                     int(int_arg),
+                     int(int_arg));
+  BENCHMARK_TOKENIZE("1 int64", "Uptime %lld us", (long long)int64_arg);
+  BENCHMARK_TOKENIZE("1 double", "Temperature %f C", double(double_arg));
+  BENCHMARK_TOKENIZE(
+      "1 string", "Reading from %s", static_cast<const char*>(string_arg));
+  BENCHMARK_TOKENIZE("int, string, double, int64",
+                     "%d: %s is %f after %lld us",
+                     int(int_arg),
+                     static_cast<const char*>(string_arg),
+                     double(double_arg),
+                     (long long)int64_arg);
+}
+
+// A binary token database generated at run time, and messages that use it.
+class Detokenization : public ::testing::Test {
+ protected:
+  Detokenization() {
+    BuildDatabase();
+    BuildMessages();
+  }
+
+  // Each entry is a distinct format string with an int and a string argument.
+  void BuildDatabase() {
+    std::vector<std::pair<uint32_t, std::string>> entries;
+    for (size_t i = 0; i < kDatabaseEntries; ++i) {
+      std::string string = "Task " + std::to_string(i) +
+                           " reported %d events from the %s driver";
+      entries.emplace_back(Hash(string), std::move(string));
+    }
+    std::sort(entries.begin(), entries.end());
+
+    AppendToDatabase("TOKENS\0\0", 8);
+    AppendToDatabase(uint32_t(entries.size()));
+    AppendToDatabase(uint32_t(0));
+
+    for (const auto& entry : entries) {
+      AppendToDatabase(entry.first);
+      AppendToDatabase(uint32_t(0xFFFFFFFF));
+      tokens_.push_back(entry.first);
+    }
+    for (const auto& entry : entries) {
+      AppendToDatabase(entry.second.c_str(), entry.second.size() + 1);
+    }
+  }
+
+  void BuildMessages() {
+    for (size_t i = 0; i < kDistinctMessages; ++i) {
+      std::array<uint8_t, 64> buffer;
+      size_t size = buffer.size();
+      const int events = int(i);
+      const char* driver = (i % 2 == 0) ? "uart" : "spi";
+      _pw_tokenizer_ToBuffer(buffer.data(),
+                             &size,
+                             tokens_[i * 7919 % tokens_.size()],
+                             PW_TOKENIZER_ARG_TYPES(events, driver),
+                             events,
+                             driver);
+      messages_.emplace_back(buffer.data(), buffer.data() + size);
+    }
+  }
+
+  template <typename T>
+  void AppendToDatabase(T value) {
+    AppendToDatabase(&value, sizeof(value));
+  }
+
+  void AppendToDatabase(const void* data, size_t size) {
+    const auto* bytes = static_cast<const char*>(data);
+    database_bytes_.insert(database_bytes_.end(), bytes, bytes + size);
+  }
+
+  std::span<const uint8_t> message(size_t i) const {
+    return messages_[i % messages_.size()];
+  }
+
+  TokenDatabase database() const {
+    return TokenDatabase::Create(database_bytes_);
+  }
+
+  std::vector<char> database_bytes_;
+  std::vector<uint32_t> tokens_;
+  std::vector<std::vector<uint8_t>> messages_;
+};
+
+TEST_F(Detokenization, Detokenize) {
+  ASSERT_TRUE(database().ok());
+
+  unit_test::RunBenchmark(
+      "construct Detokenizer", {}, [this](BenchmarkState& state) {
+        for (auto _ : state) {
+          const Detokenizer detokenizer(database());
+          unit_test::DoNotOptimize(detokenizer);
+        }
+      });
+
+  const Detokenizer detokenizer(database());
+  const Detokenizer cached_detokenizer(database(), kDistinctMessages);
+
+  unit_test::RunBenchmark(
+      "Detokenize().BestString()", {}, [&](BenchmarkState& state) {
+        size_t characters = 0;
+        size_t i = 0;
+        for (auto _ : state) {
+          characters +=
+              detokenizer.Detokenize(message(i++)).BestString().size();
+        }
+        EXPECT_GT(characters, 0u);
+      });
+
+  auto detokenize_to = [this](const Detokenizer& detokenizer_under_test) {
+    return [this, &detokenizer_under_test](BenchmarkState& state) {
+      std::string output;
+      uint32_t ok = 0;
+      size_t i = 0;
+      for (auto _ : state) {
+        output.clear();
+        if (detokenizer_under_test.DetokenizeTo(message(i++), output)) {
+          ok += 1;
+        }
+      }
+      EXPECT_EQ(ok, state.iterations());
+    };
+  };
+  unit_test::RunBenchmark("DetokenizeTo", {}, detokenize_to(detokenizer));
+  unit_test::RunBenchmark("DetokenizeTo, result cache",
+                          {},
+                          detokenize_to(cached_detokenizer));
+}
+
+TEST_F(Detokenization, FindInTokenDatabase) {
+  const TokenDatabase db = database();
+  ASSERT_TRUE(db.ok());
+
+  std::vector<uint32_t> string_index(db.size());
+  ASSERT_TRUE(db.BuildStringIndex(string_index));
+
+  unit_test::RunBenchmark("Find", {}, [&](BenchmarkState& state) {
+    uint32_t found = 0;
+    size_t i = 0;
+    for (auto _ : state) {
+      found += db.Find(tokens_[i++ % tokens_.size()]).size();
+    }
+    EXPECT_EQ(found, state.iterations());
+  });
+
+  unit_test::RunBenchmark(
+      "Find with string index", {}, [&](BenchmarkState& state) {
+        uint32_t found = 0;
+        size_t i = 0;
+        for (auto _ : state) {
+          found += db.Find(tokens_[i++ % tokens_.size()], string_index).size();
+        }
+        EXPECT_EQ(found, state.iterations());
+      });
+}
+
+}  // namespace
+}  // namespace pw::tokenizer
@@ -25,7 +25,7 @@ from enum import Enum
 import json
 import logging
 import struct
-from typing import Iterable, NamedTuple
+from typing import Iterable, Iterator, NamedTuple, TextIO
 
 _LOG = logging.getLogger('pw_trace')
 
@@ -47,7 +47,7 @@ class TraceEvent(NamedTuple):
     event_type: TraceType
     module: str
     label: str
-    timestamp_us: int
+    timestamp_us: float
     group: str = ""
     trace_id: int = 0
     flags: int = 0
@@ -66,7 +66,29 @@ def event_has_trace_id(event_type):
 
 def generate_trace_json(events: Iterable[TraceEvent]):
     """Generates a list of JSON lines from provided trace events."""
-    json_lines = []
+    return list(iter_trace_json(events))
+
+
+def write_trace_json(events: Iterable[TraceEvent], output: TextIO) -> int:
+    """Writes trace events to a file as a Chrome JSON array.
+
+    Events are converted and written one at a time, so the events may come from
+    a generator and the trace does not need to fit in memory. Returns the
+    number of events written.
+    """
+    count = 0
+    output.write('[\n')
+    for line in iter_trace_json(events):
+        if count:
+            output.write(',\n')
+        output.write(line)
+        count += 1
+    output.write('\n]\n')
+    return count
+
+
+def iter_trace_json(events: Iterable[TraceEvent]) -> Iterator[str]:
+    """Yields a JSON line for each valid trace event."""
     for event in events:
         if event.module is None or event.timestamp_us is None or \
            event.event_type is None or event.label is None:
@@ -144,6 +166,4 @@ def generate_trace_json(events: Iterable[TraceEvent]):
                 line["args"] = {"data": event.data.hex()}
 
         # Encode as JSON
-        json_lines.append(json.dumps(line))
-
-    return json_lines
+        yield json.dumps(line)
@@ -14,6 +14,7 @@
 # the License.
 """Tests the trace module."""
 
+import io
 import json
 import struct
 import unittest
@@ -178,5 +179,28 @@ class TestTraceGenerateJson(unittest.TestCase):
             })
 
 
+class TestTraceWriteJson(unittest.TestCase):
+    """Tests writing JSON trace files."""
+    def test_write_json_array(self):
+        output = io.StringIO()
+        self.assertEqual(len(test_events),
+                         trace.write_trace_json(iter(test_events), output))
+        self.assertEqual(test_json, json.loads(output.getvalue()))
+
+    def test_write_json_no_events(self):
+        output = io.StringIO()
+        self.assertEqual(0, trace.write_trace_json([], output))
+        self.assertEqual([], json.loads(output.getvalue()))
+
+    def test_write_json_skips_invalid_events(self):
+        output = io.StringIO()
+        events = [
+            trace.TraceEvent(trace.TraceType.Invalid, "m", "L", 1),
+            test_events[0],
+        ]
+        self.assertEqual(1, trace.write_trace_json(events, output))
+        self.assertEqual(test_json[:1], json.loads(output.getvalue()))
+
+
 if __name__ == '__main__':
     unittest.main()
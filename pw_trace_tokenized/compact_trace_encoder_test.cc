@@ -0,0 +1,132 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_trace_tokenized/internal/compact_trace_encoder.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+namespace pw::trace::internal {
+namespace {
+
+class CompactTraceEncoderTest : public ::testing::Test {
+ protected:
+  CompactTraceEncoderTest() : encoder_(4), buffer_{} {}
+
+  size_t EncodeEvent(uint32_t token, uint64_t delta) {
+    return encoder_.EncodeEvent(token, delta, buffer_);
+  }
+
+  uint8_t control() const { return static_cast<uint8_t>(buffer_[0]); }
+
+  uint32_t literal_token(size_t offset) const {
+    uint32_t token;
+    std::memcpy(&token, &buffer_[offset], sizeof(token));
+    return token;
+  }
+
+  CompactTraceEncoder encoder_;
+  std::array<std::byte, CompactTraceEncoder::kMaxHeaderSizeBytes> buffer_;
+};
+
+TEST_F(CompactTraceEncoderTest, NeedsSyncPoint_BeforeFirstEvent) {
+  EXPECT_TRUE(encoder_.NeedsSyncPoint());
+  EXPECT_EQ(2u, encoder_.EncodeSyncPoint(100, buffer_));
+  EXPECT_EQ(buffer_[0], CompactTraceEncoder::kSyncPoint);
+  EXPECT_EQ(buffer_[1], std::byte{100});
+  EXPECT_FALSE(encoder_.NeedsSyncPoint());
+}
+
+TEST_F(CompactTraceEncoderTest, NeedsSyncPoint_AfterInterval) {
+  encoder_.EncodeSyncPoint(0, buffer_);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_FALSE(encoder_.NeedsSyncPoint());
+    EncodeEvent(1, 0);
+  }
+  EXPECT_TRUE(encoder_.NeedsSyncPoint());
+}
+
+TEST_F(CompactTraceEncoderTest, RequestSyncPoint) {
+  encoder_.EncodeSyncPoint(0, buffer_);
+  encoder_.RequestSyncPoint();
+  EXPECT_TRUE(encoder_.NeedsSyncPoint());
+}
+
+TEST_F(CompactTraceEncoderTest, LiteralToken_ThenTableReference) {
+  encoder_.EncodeSyncPoint(0, buffer_);
+
+  ASSERT_EQ(5u, EncodeEvent(0x12345678, 3));
+  EXPECT_EQ(control(), 0x03);
+  EXPECT_EQ(literal_token(1), 0x12345678u);
+
+  ASSERT_EQ(5u, EncodeEvent(0xABCD, 14));
+  EXPECT_EQ(control(), 0x0E);
+  EXPECT_EQ(literal_token(1), 0xABCDu);
+
+  ASSERT_EQ(1u, EncodeEvent(0x12345678, 0));
+  EXPECT_EQ(control(), 0x80);
+
+  ASSERT_EQ(1u, EncodeEvent(0xABCD, 7));
+  EXPECT_EQ(control(), 0x97);
+}
+
+TEST_F(CompactTraceEncoderTest, LargeDelta_FollowsControlByte) {
+  encoder_.EncodeSyncPoint(0, buffer_);
+  EncodeEvent(1, 0);
+
+  ASSERT_EQ(2u, EncodeEvent(1, 15));
+  EXPECT_EQ(control(), 0x8F);
+  EXPECT_EQ(buffer_[1], std::byte{15});
+
+  ASSERT_EQ(3u, EncodeEvent(1, 300));
+  EXPECT_EQ(control(), 0x8F);
+  EXPECT_EQ(buffer_[1], std::byte{0xAC});
+  EXPECT_EQ(buffer_[2], std::byte{0x02});
+
+  ASSERT_EQ(6u, EncodeEvent(2, 15));
+  EXPECT_EQ(control(), 0x0F);
+  EXPECT_EQ(literal_token(2), 2u);
+}
+
+TEST_F(CompactTraceEncoderTest, FullTable_ReplacesOldestEntry) {
+  encoder_.EncodeSyncPoint(0, buffer_);
+  for (uint32_t token = 0; token < CompactTraceEncoder::kTokenTableSize;
+       ++token) {
+    EXPECT_EQ(5u, EncodeEvent(token, 0));
+  }
+
+  // Token 8 replaces token 0 in entry 0.
+  EXPECT_EQ(5u, EncodeEvent(8, 0));
+  EXPECT_EQ(1u, EncodeEvent(8, 0));
+  EXPECT_EQ(control(), 0x80);
+  EXPECT_EQ(5u, EncodeEvent(0, 0));
+
+  EXPECT_EQ(1u, EncodeEvent(7, 0));
+  EXPECT_EQ(control(), 0xF0);
+}
+
+TEST_F(CompactTraceEncoderTest, SyncPoint_ResetsTable) {
+  encoder_.EncodeSyncPoint(0, buffer_);
+  EncodeEvent(1, 0);
+  EXPECT_EQ(1u, EncodeEvent(1, 0));
+
+  EXPECT_EQ(3u, encoder_.EncodeSyncPoint(1000, buffer_));
+  EXPECT_EQ(5u, EncodeEvent(1, 0));
+}
+
+}  // namespace
+}  // namespace pw::trace::internal
@@ -0,0 +1,75 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//==============================================================================
+//
+// Trace time source for ARMv7-M and ARMv8-M cores which counts CPU cycles with
+// the DWT cycle counter (CYCCNT). Reading the time is a single register load.
+
+#include <cstdint>
+
+#include "pw_trace_tokenized/trace_tokenized.h"
+
+static_assert(PW_TRACE_CYCLE_COUNTER_FREQUENCY_HZ > 0,
+              "PW_TRACE_CYCLE_COUNTER_FREQUENCY_HZ must be set to the CPU "
+              "clock frequency to use the cycle counter trace time");
+
+namespace {
+
+volatile uint32_t& demcr = *reinterpret_cast<volatile uint32_t*>(0xE000EDFCu);
+volatile uint32_t& dwt_ctrl =
+    *reinterpret_cast<volatile uint32_t*>(0xE0001000u);
+volatile uint32_t& dwt_cyccnt =
+    *reinterpret_cast<volatile uint32_t*>(0xE0001004u);
+
+constexpr uint32_t kDemcrTraceEnable = 1u << 24;  // TRCENA
+constexpr uint32_t kDwtCtrlCycleCounterEnable = 1u << 0;  // CYCCNTENA
+
+// The cycle counter is enabled during static initialization, so that reading
+// the time does not need to check it.
+bool EnableCycleCounter() {
+  demcr |= kDemcrTraceEnable;
+  dwt_cyccnt = 0;
+  dwt_ctrl |= kDwtCtrlCycleCounterEnable;
+  return true;
+}
+
+[[maybe_unused]] const bool cycle_counter_enabled = EnableCycleCounter();
+
+// The 32-bit counter wraps every 2^32 cycles, which is about 43 seconds at
+// 100 MHz. A 32-bit time type handles a single wrap between events, since the
+// time delta is computed with unsigned subtraction. A wider time type is
+// extended in software, which requires the time to be read at least once per
+// wrap, under PW_TRACE_LOCK.
+uint32_t last_count = 0;
+PW_TRACE_TIME_TYPE wraps = 0;
+
+}  // namespace
+
+PW_TRACE_TIME_TYPE pw_trace_GetTraceTime() {
+  const uint32_t count = dwt_cyccnt;
+  if constexpr (sizeof(PW_TRACE_TIME_TYPE) <= sizeof(uint32_t)) {
+    return static_cast<PW_TRACE_TIME_TYPE>(count);
+  } else {
+    if (count < last_count) {
+      wraps += 1;
+    }
+    last_count = count;
+    return static_cast<PW_TRACE_TIME_TYPE>(
+        (static_cast<uint64_t>(wraps) << 32) | count);
+  }
+}
+
+size_t pw_trace_GetTraceTimeTicksPerSecond() {
+  return PW_TRACE_CYCLE_COUNTER_FREQUENCY_HZ;
+}
@@ -0,0 +1,159 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_trace_tokenized/internal/per_core_trace_buffers.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace pw::trace::internal {
+namespace {
+
+constexpr size_t kCores = 3;
+using Buffers = PerCoreTraceBuffers<kCores, 64>;
+
+struct DrainedEvent {
+  size_t core;
+  PW_TRACE_TIME_TYPE time;
+  uint32_t token;
+  size_t size;
+};
+
+// Records an event whose header is a token, with optional data.
+Status Record(Buffers& buffers,
+              size_t core,
+              PW_TRACE_TIME_TYPE time,
+              uint32_t token,
+              std::span<const std::byte> data = {}) {
+  return buffers.Record(
+      core, time, std::as_bytes(std::span(&token, 1)), data);
+}
+
+std::vector<DrainedEvent> Drain(Buffers& buffers) {
+  std::vector<DrainedEvent> events;
+  const size_t drained = buffers.Drain(
+      [&events](size_t core,
+                PW_TRACE_TIME_TYPE time,
+                std::span<const std::byte> event) {
+        uint32_t token = 0;
+        std::memcpy(&token, event.data(), sizeof(token));
+        events.push_back({core, time, token, event.size()});
+      });
+  EXPECT_EQ(drained, events.size());
+  return events;
+}
+
+TEST(PerCoreTraceBuffers, Drain_Empty) {
+  Buffers buffers;
+  EXPECT_TRUE(Drain(buffers).empty());
+}
+
+TEST(PerCoreTraceBuffers, Drain_SingleCore_InOrder) {
+  Buffers buffers;
+  ASSERT_EQ(OkStatus(), Record(buffers, 1, 10, 0xA));
+  ASSERT_EQ(OkStatus(), Record(buffers, 1, 20, 0xB));
+
+  std::vector<DrainedEvent> events = Drain(buffers);
+  ASSERT_EQ(events.size(), 2u);
+  EXPECT_EQ(events[0].core, 1u);
+  EXPECT_EQ(events[0].time, 10u);
+  EXPECT_EQ(events[0].token, 0xAu);
+  EXPECT_EQ(events[1].time, 20u);
+  EXPECT_EQ(events[1].token, 0xBu);
+
+  EXPECT_TRUE(Drain(buffers).empty());
+}
+
+TEST(PerCoreTraceBuffers, Drain_MergesCoresByTime) {
+  Buffers buffers;
+  ASSERT_EQ(OkStatus(), Record(buffers, 0, 3, 3));
+  ASSERT_EQ(OkStatus(), Record(buffers, 0, 4, 4));
+  ASSERT_EQ(OkStatus(), Record(buffers, 1, 1, 1));
+  ASSERT_EQ(OkStatus(), Record(buffers, 1, 6, 6));
+  ASSERT_EQ(OkStatus(), Record(buffers, 2, 2, 2));
+  ASSERT_EQ(OkStatus(), Record(buffers, 2, 5, 5));
+
+  std::vector<DrainedEvent> events = Drain(buffers);
+  ASSERT_EQ(events.size(), 6u);
+  constexpr size_t kExpectedCores[] = {1, 2, 0, 0, 2, 1};
+  for (size_t i = 0; i < events.size(); ++i) {
+    EXPECT_EQ(events[i].time, i + 1);
+    EXPECT_EQ(events[i].token, i + 1);
+    EXPECT_EQ(events[i].core, kExpectedCores[i]);
+  }
+}
+
+TEST(PerCoreTraceBuffers, Drain_IncludesData) {
+  Buffers buffers;
+  constexpr std::byte kData[] = {std::byte{1}, std::byte{2}, std::byte{3}};
+  ASSERT_EQ(OkStatus(), Record(buffers, 0, 7, 0x1234, kData));
+
+  std::vector<std::byte> event;
+  EXPECT_EQ(1u,
+            buffers.Drain([&event](size_t,
+                                   PW_TRACE_TIME_TYPE,
+                                   std::span<const std::byte> bytes) {
+              event.assign(bytes.begin(), bytes.end());
+            }));
+  ASSERT_EQ(event.size(), sizeof(uint32_t) + sizeof(kData));
+  EXPECT_EQ(0, std::memcmp(&event[sizeof(uint32_t)], kData, sizeof(kData)));
+}
+
+TEST(PerCoreTraceBuffers, Record_InvalidCore) {
+  Buffers buffers;
+  EXPECT_EQ(Status::InvalidArgument(), Record(buffers, kCores, 1, 1));
+  EXPECT_TRUE(Drain(buffers).empty());
+}
+
+TEST(PerCoreTraceBuffers, Record_TooLarge_IsDropped) {
+  Buffers buffers;
+  std::array<std::byte, Buffers::kMaxEventSizeBytes> data{};
+  EXPECT_EQ(Status::OutOfRange(), Record(buffers, 2, 1, 1, data));
+  EXPECT_EQ(buffers.dropped(2), 1u);
+  EXPECT_EQ(buffers.dropped(0), 0u);
+  EXPECT_TRUE(Drain(buffers).empty());
+}
+
+TEST(PerCoreTraceBuffers, Record_FullBuffer_IsDropped) {
+  Buffers buffers;
+  size_t recorded = 0;
+  while (Record(buffers, 0, recorded, 1).ok()) {
+    recorded += 1;
+  }
+  EXPECT_GT(recorded, 0u);
+  EXPECT_EQ(buffers.dropped(0), 1u);
+
+  // Other cores are unaffected.
+  EXPECT_EQ(OkStatus(), Record(buffers, 1, 0, 1));
+
+  EXPECT_EQ(Drain(buffers).size(), recorded + 1);
+  EXPECT_EQ(OkStatus(), Record(buffers, 0, 0, 1));
+}
+
+TEST(PerCoreTraceBuffers, Clear) {
+  Buffers buffers;
+  ASSERT_EQ(OkStatus(), Record(buffers, 0, 1, 1));
+  ASSERT_EQ(OkStatus(), Record(buffers, 2, 2, 2));
+
+  buffers.Clear();
+  EXPECT_TRUE(Drain(buffers).empty());
+}
+
+}  // namespace
+}  // namespace pw::trace::internal
@@ -64,12 +64,20 @@ extern size_t pw_trace_GetTraceTimeTicksPerSecond();
 #define PW_TRACE_GET_TIME_DELTA(last_time, current_time) \
   ((current_time) - (last_time))
 #ifdef __cplusplus
+#include <type_traits>
 static_assert(
     std::is_unsigned<PW_TRACE_TIME_TYPE>::value,
     "Default time delta implementation only works for unsigned time types.");
 #endif  // __cplusplus
 #endif  // PW_TRACE_GET_TIME_DELTA
 
+// PW_TRACE_CYCLE_COUNTER_FREQUENCY_HZ is the CPU clock frequency, which is the
+// tick rate of the cycle counter trace time (cycle_counter_trace_time.cc). It
+// must be set when that time source is used.
+#ifndef PW_TRACE_CYCLE_COUNTER_FREQUENCY_HZ
+#define PW_TRACE_CYCLE_COUNTER_FREQUENCY_HZ 0
+#endif  // PW_TRACE_CYCLE_COUNTER_FREQUENCY_HZ
+
 // --- Config options for callbacks ----
 
 // PW_TRACE_CONFIG_MAX_EVENT_CALLBACKS is the maximum number of event callbacks
@@ -84,6 +92,12 @@ static_assert(
 #define PW_TRACE_CONFIG_MAX_SINKS 2
 #endif  // PW_TRACE_CONFIG_MAX_SINKS
 
+// PW_TRACE_CONFIG_MAX_SAMPLING_RULES is the maximum number of trace references
+// which can have a sample rate or rate limit at a time.
+#ifndef PW_TRACE_CONFIG_MAX_SAMPLING_RULES
+#define PW_TRACE_CONFIG_MAX_SAMPLING_RULES 4
+#endif  // PW_TRACE_CONFIG_MAX_SAMPLING_RULES
+
 // --- Config options for locks ---
 
 // PW_TRACE_LOCK  Is is also called when registering and unregistering callbacks
@@ -119,6 +133,65 @@ static_assert(
 #define PW_TRACE_QUEUE_UNLOCK()
 #endif  // PW_TRACE_QUEUE_UNLOCK
 
+// --- Config options for the compact encoding ---
+
+// PW_TRACE_COMPACT_ENCODING, when enabled, encodes events in the compact trace
+// format, which packs small time deltas into a control byte and replaces
+// recently used tokens with a table index. Decode the output with the --compact
+// option of pw_trace_tokenized/py/trace_tokenized.py.
+#ifndef PW_TRACE_COMPACT_ENCODING
+#define PW_TRACE_COMPACT_ENCODING 0
+#endif  // PW_TRACE_COMPACT_ENCODING
+
+// PW_TRACE_COMPACT_SYNC_INTERVAL_EVENTS is the number of events between sync
+// points in the compact encoding. Each sync point holds the absolute time, so
+// events can be decoded from the first sync point still in a trace buffer.
+// Sync points add about 5 bytes each.
+#ifndef PW_TRACE_COMPACT_SYNC_INTERVAL_EVENTS
+#define PW_TRACE_COMPACT_SYNC_INTERVAL_EVENTS 32
+#endif  // PW_TRACE_COMPACT_SYNC_INTERVAL_EVENTS
+
+// --- Config options for per-core buffers ---
+
+// PW_TRACE_PER_CORE_BUFFERS, when enabled, records each event to a lock-free
+// buffer for the core it happens on, instead of passing it through the shared
+// event queue under PW_TRACE_TRY_LOCK. Events reach the sinks only when
+// pw::trace::TokenizedTrace::Instance().DrainPerCoreBuffers() is called, which
+// merges the buffers in order of time.
+#ifndef PW_TRACE_PER_CORE_BUFFERS
+#define PW_TRACE_PER_CORE_BUFFERS 0
+#endif  // PW_TRACE_PER_CORE_BUFFERS
+
+// PW_TRACE_CORE_COUNT is the number of per-core buffers.
+#ifndef PW_TRACE_CORE_COUNT
+#define PW_TRACE_CORE_COUNT 1
+#endif  // PW_TRACE_CORE_COUNT
+
+// PW_TRACE_GET_CORE_ID returns the index of the buffer to record to, from 0 to
+// PW_TRACE_CORE_COUNT - 1. This is usually the current core, but may instead
+// be a thread index to give each thread its own buffer.
+#ifndef PW_TRACE_GET_CORE_ID
+#define PW_TRACE_GET_CORE_ID() (0)
+#endif  // PW_TRACE_GET_CORE_ID
+
+// PW_TRACE_PER_CORE_BUFFER_SIZE_BYTES is the size of each per-core buffer.
+#ifndef PW_TRACE_PER_CORE_BUFFER_SIZE_BYTES
+#define PW_TRACE_PER_CORE_BUFFER_SIZE_BYTES 256
+#endif  // PW_TRACE_PER_CORE_BUFFER_SIZE_BYTES
+
+// PW_TRACE_CORE_LOCK and PW_TRACE_CORE_UNLOCK surround recording an event to
+// the current core's buffer. Each buffer supports one writer at a time, so if
+// events are traced from code which may preempt other tracing on the same
+// core, such as interrupt handlers, these must prevent it, for example by
+// masking interrupts on the current core. They need not block other cores.
+#ifndef PW_TRACE_CORE_LOCK
+#define PW_TRACE_CORE_LOCK()
+#endif  // PW_TRACE_CORE_LOCK
+
+#ifndef PW_TRACE_CORE_UNLOCK
+#define PW_TRACE_CORE_UNLOCK()
+#endif  // PW_TRACE_CORE_UNLOCK
+
 // --- Config options for optional trace buffer ---
 
 // PW_TRACE_BUFFER_SIZE_BYTES is the size in bytes of the optional trace buffer.
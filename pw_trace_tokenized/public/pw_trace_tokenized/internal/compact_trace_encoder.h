@@ -0,0 +1,159 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//==============================================================================
+//
+// Encodes trace event headers in the compact trace format, which is used by
+// the tokenized trace backend when PW_TRACE_COMPACT_ENCODING is enabled.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include "pw_varint/varint.h"
+
+namespace pw {
+namespace trace {
+namespace internal {
+
+// Each compact event header starts with a control byte:
+//
+//   1iii dddd  Token from entry iii of the token table, time delta dddd.
+//   0000 dddd  Token follows as 4 bytes and is added to the table, delta dddd.
+//   0001 0000  Sync point: the absolute time follows as a varint.
+//
+// Deltas from 0 to 14 are packed into the control byte. A delta of 15 or more
+// is stored as 15 (0xF), and the full delta follows the control byte as a
+// varint. The trace ID and data follow the header, as in the standard format.
+//
+// The token table holds the last kTokenTableSize distinct literal tokens, which
+// replace each other in round-robin order. Repeated events, such as the start
+// and end of a span in a loop, are usually found in the table, so their tokens
+// are not repeated.
+//
+// A sync point resets the token table and gives the time of the event which
+// follows it, which is encoded with a delta of 0. Sync points are emitted
+// periodically, so a decoder can start from any sync point, such as after the
+// oldest events in a ring buffer were overwritten.
+class CompactTraceEncoder {
+ public:
+  static constexpr size_t kTokenTableSize = 8;
+
+  // Control, varint time delta, and token.
+  static constexpr size_t kMaxHeaderSizeBytes =
+      1 + varint::kMaxVarint64SizeBytes + sizeof(uint32_t);
+
+  // Control and varint time.
+  static constexpr size_t kMaxSyncPointSizeBytes =
+      1 + varint::kMaxVarint64SizeBytes;
+
+  static constexpr std::byte kSyncPoint{0x10};
+
+  // Emits a sync point after every sync_interval_events events. A sync point
+  // is always emitted before the first event.
+  explicit constexpr CompactTraceEncoder(size_t sync_interval_events)
+      : sync_interval_events_(sync_interval_events),
+        events_since_sync_(0),
+        sync_requested_(true),
+        table_size_(0),
+        next_entry_(0),
+        table_{} {}
+
+  // True if EncodeSyncPoint must be called before the next event.
+  constexpr bool NeedsSyncPoint() const {
+    return sync_requested_ || events_since_sync_ >= sync_interval_events_;
+  }
+
+  // Emits a sync point before the next event, for example after the buffer
+  // the events are written to was cleared.
+  constexpr void RequestSyncPoint() { sync_requested_ = true; }
+
+  // Encodes a sync point with the time of the next event. The output must be
+  // at least kMaxSyncPointSizeBytes. Returns the number of bytes written.
+  size_t EncodeSyncPoint(uint64_t time, std::span<std::byte> output) {
+    events_since_sync_ = 0;
+    sync_requested_ = false;
+    table_size_ = 0;
+    next_entry_ = 0;
+
+    output[0] = kSyncPoint;
+    return 1 + varint::Encode(time, output.subspan(1));
+  }
+
+  // Encodes the header for an event. The output must be at least
+  // kMaxHeaderSizeBytes. Returns the number of bytes written.
+  size_t EncodeEvent(uint32_t token,
+                     uint64_t time_delta,
+                     std::span<std::byte> output) {
+    events_since_sync_ += 1;
+
+    const size_t entry = Find(token);
+    uint8_t control = time_delta < kDeltaFollows
+                          ? static_cast<uint8_t>(time_delta)
+                          : kDeltaFollows;
+    if (entry < table_size_) {
+      control |= kTokenFromTable | static_cast<uint8_t>(entry << 4);
+    }
+
+    output[0] = std::byte(control);
+    size_t size = 1;
+    if (time_delta >= kDeltaFollows) {
+      size += varint::Encode(time_delta, output.subspan(size));
+    }
+
+    if (entry >= table_size_) {
+      std::memcpy(&output[size], &token, sizeof(token));
+      size += sizeof(token);
+      Insert(token);
+    }
+    return size;
+  }
+
+ private:
+  static constexpr uint8_t kTokenFromTable = 0x80;
+  static constexpr uint8_t kDeltaFollows = 0x0F;
+
+  // Returns the table entry with the token, or table_size_ if there is none.
+  size_t Find(uint32_t token) const {
+    for (size_t i = 0; i < table_size_; ++i) {
+      if (table_[i] == token) {
+        return i;
+      }
+    }
+    return table_size_;
+  }
+
+  void Insert(uint32_t token) {
+    table_[next_entry_] = token;
+    next_entry_ = (next_entry_ + 1) % kTokenTableSize;
+    if (table_size_ < kTokenTableSize) {
+      table_size_ += 1;
+    }
+  }
+
+  const size_t sync_interval_events_;
+  size_t events_since_sync_;
+  bool sync_requested_;
+
+  size_t table_size_;
+  size_t next_entry_;
+  std::array<uint32_t, kTokenTableSize> table_;
+};
+
+}  // namespace internal
+}  // namespace trace
+}  // namespace pw
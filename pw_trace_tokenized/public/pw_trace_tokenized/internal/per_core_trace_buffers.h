@@ -0,0 +1,191 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//==============================================================================
+//
+// Lock-free trace event buffers, one per core, which are merged by timestamp
+// when drained. Used by the tokenized trace backend when
+// PW_TRACE_PER_CORE_BUFFERS is enabled.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+#include "pw_ring_buffer/spsc_prefixed_entry_ring_buffer.h"
+#include "pw_status/status.h"
+#include "pw_trace_tokenized/config.h"
+#include "pw_varint/varint.h"
+
+namespace pw {
+namespace trace {
+namespace internal {
+
+// Holds a single-producer, single-consumer ring buffer for each core. Events
+// are recorded to the buffer of the core they happen on, so cores never
+// contend for a lock while tracing. Each entry stores the absolute trace time
+// of the event followed by its encoded header and data.
+//
+// Each buffer supports a single writer at a time: code which records events on
+// a core must not be preempted by other code which records events on the same
+// core. A single consumer at a time may drain the buffers, concurrently with
+// the writers.
+template <size_t kCores, size_t kBufferSizeBytes>
+class PerCoreTraceBuffers {
+ public:
+  static_assert(kCores > 0u, "At least one core is required");
+
+  // The largest encoded event: the token, trace id, and data.
+  static constexpr size_t kMaxEventSizeBytes =
+      sizeof(uint32_t) + varint::kMaxVarint32SizeBytes +
+      PW_TRACE_BUFFER_MAX_DATA_SIZE_BYTES;
+
+  PerCoreTraceBuffers() {
+    for (Core& core : cores_) {
+      core.buffer.SetBuffer(core.storage);
+    }
+  }
+
+  PerCoreTraceBuffers(const PerCoreTraceBuffers&) = delete;
+  PerCoreTraceBuffers& operator=(const PerCoreTraceBuffers&) = delete;
+
+  // Producer: records an event, which is the header followed by the data, to
+  // the buffer of the core. Events which do not fit are dropped and counted.
+  //
+  // Return values:
+  // OK - The event was recorded.
+  // INVALID_ARGUMENT - The core is out of range.
+  // OUT_OF_RANGE - The event is larger than kMaxEventSizeBytes.
+  // RESOURCE_EXHAUSTED - The core's buffer is full.
+  Status Record(size_t core,
+                PW_TRACE_TIME_TYPE time,
+                std::span<const std::byte> header,
+                std::span<const std::byte> data) {
+    if (core >= kCores) {
+      return Status::InvalidArgument();
+    }
+    if (header.size() + data.size() > kMaxEventSizeBytes) {
+      cores_[core].dropped.fetch_add(1, std::memory_order_relaxed);
+      return Status::OutOfRange();
+    }
+
+    std::array<std::byte, kMaxEntrySizeBytes> entry;
+    std::memcpy(entry.data(), &time, sizeof(time));
+    std::memcpy(&entry[sizeof(time)], header.data(), header.size());
+    if (!data.empty()) {
+      std::memcpy(
+          &entry[sizeof(time) + header.size()], data.data(), data.size());
+    }
+
+    const Status status = cores_[core].buffer.TryPushBack(
+        std::span(entry).first(sizeof(time) + header.size() + data.size()));
+    if (!status.ok()) {
+      cores_[core].dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    return status;
+  }
+
+  // Consumer: removes the buffered events from all cores, and calls
+  // handle_event for each, in order of time. The function is called as
+  //
+  //   handle_event(size_t core, PW_TRACE_TIME_TYPE time,
+  //                std::span<const std::byte> event)
+  //
+  // Times are compared directly, so the trace time must not wrap while events
+  // are buffered. Events from each core are always handled in the order they
+  // were recorded. Returns the number of events handled.
+  template <typename Function>
+  size_t Drain(Function&& handle_event) {
+    std::array<Pending, kCores> pending;
+    for (size_t core = 0; core < kCores; ++core) {
+      Peek(core, pending[core]);
+    }
+
+    size_t handled = 0;
+    while (true) {
+      size_t next = kCores;
+      for (size_t core = 0; core < kCores; ++core) {
+        if (pending[core].size != 0u &&
+            (next == kCores || pending[core].time < pending[next].time)) {
+          next = core;
+        }
+      }
+      if (next == kCores) {
+        return handled;
+      }
+
+      handle_event(next,
+                   pending[next].time,
+                   std::span<const std::byte>(pending[next].entry)
+                       .subspan(sizeof(PW_TRACE_TIME_TYPE),
+                                pending[next].size -
+                                    sizeof(PW_TRACE_TIME_TYPE)));
+      handled += 1;
+
+      cores_[next].buffer.PopFront();
+      Peek(next, pending[next]);
+    }
+  }
+
+  // Consumer: discards all buffered events.
+  void Clear() {
+    for (Core& core : cores_) {
+      while (core.buffer.PopFront().ok()) {
+      }
+    }
+  }
+
+  // Returns the number of events dropped on a core since construction.
+  size_t dropped(size_t core) const {
+    return core < kCores ? cores_[core].dropped.load(std::memory_order_relaxed)
+                         : 0u;
+  }
+
+ private:
+  static constexpr size_t kMaxEntrySizeBytes =
+      sizeof(PW_TRACE_TIME_TYPE) + kMaxEventSizeBytes;
+
+  struct Core {
+    ring_buffer::SpscPrefixedEntryRingBuffer buffer;
+    std::atomic<size_t> dropped{0};
+    std::array<std::byte, kBufferSizeBytes> storage;
+  };
+
+  // The oldest entry in a core's buffer, or size 0 if it is empty.
+  struct Pending {
+    PW_TRACE_TIME_TYPE time;
+    size_t size;
+    std::array<std::byte, kMaxEntrySizeBytes> entry;
+  };
+
+  void Peek(size_t core, Pending& pending) {
+    pending.size = 0;
+    if (!cores_[core].buffer.PeekFront(pending.entry, &pending.size).ok() ||
+        pending.size < sizeof(PW_TRACE_TIME_TYPE)) {
+      pending.size = 0;
+      return;
+    }
+    std::memcpy(&pending.time, pending.entry.data(), sizeof(pending.time));
+  }
+
+  std::array<Core, kCores> cores_;
+};
+
+}  // namespace internal
+}  // namespace trace
+}  // namespace pw
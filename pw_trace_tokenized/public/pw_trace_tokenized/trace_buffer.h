@@ -17,6 +17,7 @@
 #pragma once
 
 #include "pw_ring_buffer/prefixed_entry_ring_buffer.h"
+#include "pw_status/status.h"
 #include "pw_trace_tokenized/config.h"
 #include "pw_trace_tokenized/trace_tokenized.h"
 #include "pw_varint/varint.h"
@@ -31,5 +32,26 @@ void ClearBuffer();
 // Get the ring buffer which contains the data.
 pw::ring_buffer::PrefixedEntryRingBuffer* GetBuffer();
 
+// Flight recorder mode: the buffer records continuously, overwriting the
+// oldest events, until it is triggered. After a trigger, the buffer records
+// events_after_trigger more events and then freezes, so the events around the
+// trigger are kept until they are read. A frozen buffer drops new events, and
+// resumes recording once it has been drained with PopFront, or is cleared with
+// ClearBuffer.
+
+// Triggers the buffer from code, such as an assert handler or a watchdog.
+// Does nothing if the buffer is already triggered or frozen.
+void TriggerBufferFreeze(size_t events_after_trigger);
+
+// Triggers the buffer when an event with this trace reference (see
+// PW_TRACE_REF) is recorded. The trigger event itself is recorded, followed by
+// events_after_trigger more events. Replaces any previous trigger event.
+pw::Status SetBufferFreezeTrigger(uint32_t trace_ref,
+                                  size_t events_after_trigger);
+void ClearBufferFreezeTrigger();
+
+// True once the buffer has frozen after a trigger, until it resumes.
+bool IsBufferFrozen();
+
 }  // namespace trace
 }  // namespace pw
@@ -0,0 +1,100 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//==============================================================================
+//
+// This file provides an RPC service which streams events from the trace buffer
+// as they are produced.
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "pw_bytes/span.h"
+#include "pw_result/result.h"
+#include "pw_ring_buffer/prefixed_entry_ring_buffer.h"
+#include "pw_status/status.h"
+#include "pw_trace_protos/trace_rpc.raw_rpc.pb.h"
+#include "pw_trace_tokenized/config.h"
+#include "pw_varint/varint.h"
+
+namespace pw::trace {
+
+// The TraceService streams encoded trace events to a client. GetTraceData()
+// attaches a reader to the trace buffer, starting from its oldest event, and
+// the owner of the service calls Flush() periodically to send the events read
+// since the last call. The trace buffer works as a sliding window: events are
+// only lost if they are overwritten before they are flushed, so long captures
+// do not depend on the size of the buffer.
+//
+// Events are copied out of the buffer under PW_TRACE_LOCK, and sent after the
+// lock is released, so tracing continues while events are sent.
+class TraceService final
+    : public pw::trace::generated::TraceService<TraceService> {
+ public:
+  // Typically constructed with *pw::trace::GetBuffer().
+  TraceService(ring_buffer::PrefixedEntryRingBufferMulti& trace_buffer)
+      : trace_buffer_(trace_buffer),
+        reported_drops_(0),
+        unsent_events_(0),
+        event_buffer_{} {}
+
+  // RPC method which starts a stream of trace events. Returns immediately;
+  // events are sent by Flush().
+  void GetTraceData(ServerContext&,
+                    ConstByteSpan,
+                    rpc::RawServerWriter& writer);
+
+  // Sends the events in the trace buffer which have not been sent yet, in as
+  // many responses as needed. Each response reports the number of events
+  // dropped since the previous one. If a response cannot be sent, stops and
+  // returns the error; the events in that response are reported as dropped,
+  // and the rest are sent by the next call.
+  Status Flush();
+
+  // Ends the stream, if one is open.
+  void Finish() { response_writer_.Finish(); }
+
+ private:
+  struct Response {
+    ConstByteSpan encoded;
+    size_t reader_drops;   // The reader's dropped count when encoded.
+    size_t unsent_events;  // The unsent_events_ count when encoded.
+    size_t events_read;    // Events removed from the buffer.
+    size_t events_sent;    // Events in the response.
+  };
+
+  // Returns the number of events dropped since the last response.
+  size_t DroppedEvents() const;
+
+  // Encodes the dropped count and up to max_events events, as many as fit in
+  // the payload, and removes the events from the buffer.
+  Status EncodeResponse(ByteSpan payload,
+                        size_t max_events,
+                        Response& response);
+
+  ring_buffer::PrefixedEntryRingBufferMulti& trace_buffer_;
+  ring_buffer::PrefixedEntryRingBufferMulti::Reader reader_;
+  rpc::RawServerWriter response_writer_;
+
+  // The reader's dropped entry count at the last response.
+  size_t reported_drops_;
+
+  // Events which were read, but could not be sent.
+  size_t unsent_events_;
+
+  // Holds an event which wraps around the end of the trace buffer.
+  std::array<std::byte, PW_TRACE_BUFFER_MAX_BLOCK_SIZE_BYTES> event_buffer_;
+};
+
+}  // namespace pw::trace
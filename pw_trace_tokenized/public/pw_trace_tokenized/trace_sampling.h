@@ -0,0 +1,120 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//==============================================================================
+//
+// The file provides built-in sampling and rate limiting of trace events for the
+// tokenized trace module.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "pw_status/status.h"
+#include "pw_trace_tokenized/config.h"
+#include "pw_trace_tokenized/trace_tokenized.h"
+
+namespace pw {
+namespace trace {
+
+// Sampling rules reduce the number of events recorded for a trace reference,
+// so that events in hot code can be left enabled. A trace reference is the
+// token of an event's type, module, group, and label, as returned by
+// PW_TRACE_REF(). Each rule can combine:
+//
+//   - Sampling: record 1 in N events. Events with a trace ID are sampled by
+//     ID, so all events of a sampled trace ID are recorded together. Other
+//     events are sampled by count.
+//   - Rate limiting: a token bucket which allows bursts of up to burst events,
+//     refilled at events_per_second.
+//
+// Rules are applied after the event callbacks, so events skipped by a callback
+// do not use up the rate limit. A span's start and end events have different
+// trace references, so rules for spans should usually be set on both.
+//
+// Rules are checked where event callbacks are called: under the trace lock, or
+// on the event's core with PW_TRACE_PER_CORE_BUFFERS. When no rules are set,
+// the only cost to each event is a single comparison.
+class SamplingImpl {
+ public:
+  // Records 1 in one_in_n events with this trace reference. A one_in_n of 0 or
+  // 1 records every event. Returns RESOURCE_EXHAUSTED if there is no free rule
+  // for a new trace reference.
+  pw::Status SetSampleRate(uint32_t trace_ref, uint32_t one_in_n);
+
+  // Records at most events_per_second events with this trace reference on
+  // average, with bursts of up to burst events. An events_per_second of 0
+  // removes the limit. Returns RESOURCE_EXHAUSTED if there is no free rule for
+  // a new trace reference.
+  pw::Status SetRateLimit(uint32_t trace_ref,
+                          uint32_t events_per_second,
+                          uint32_t burst);
+
+  // Removes the sample rate and rate limit for this trace reference.
+  pw::Status ClearRule(uint32_t trace_ref);
+  void ClearAllRules();
+
+  // Returns true if the event should be recorded, and updates the rule's
+  // state. Called by the tokenized trace backend for each event.
+  bool ShouldRecord(uint32_t trace_ref,
+                    EventType event_type,
+                    uint32_t trace_id,
+                    PW_TRACE_TIME_TYPE trace_time);
+
+  bool HasRules() const { return rule_count_ > 0; }
+
+  // The number of events which were not recorded because of a rule.
+  size_t skipped_events() const { return skipped_events_; }
+
+ private:
+  struct Rule {
+    uint32_t trace_ref;  // 0 if the rule is free.
+
+    uint32_t sample_rate;
+    uint32_t sample_count;
+
+    // The token bucket holds credit in trace time ticks, and each event costs
+    // ticks_per_event. Credit is capped at burst events.
+    uint64_t ticks_per_event;  // 0 if there is no rate limit.
+    uint64_t max_credit;
+    uint64_t credit;
+    PW_TRACE_TIME_TYPE last_time;
+    bool has_last_time;
+  };
+
+  // Returns the rule for the trace reference, adding it if add is true.
+  Rule* Find(uint32_t trace_ref, bool add);
+  void RemoveIfUnused(Rule& rule);
+
+  static bool Sample(Rule& rule, EventType event_type, uint32_t trace_id);
+  static bool TakeFromBucket(Rule& rule, PW_TRACE_TIME_TYPE trace_time);
+
+  Rule rules_[PW_TRACE_CONFIG_MAX_SAMPLING_RULES] = {};
+  size_t rule_count_ = 0;
+  size_t skipped_events_ = 0;
+};
+
+// A singleton object of the SamplingImpl class which is used by the tokenized
+// trace backend.
+// Example: pw::trace::Sampling::Instance().SetSampleRate(ref, 100);
+class Sampling {
+ public:
+  static SamplingImpl& Instance() { return instance_; }
+
+ private:
+  static SamplingImpl instance_;
+};
+
+}  // namespace trace
+}  // namespace pw
@@ -34,6 +34,9 @@
 #include "pw_trace_tokenized/internal/trace_tokenized_internal.h"
 
 #ifdef __cplusplus
+#include "pw_trace_tokenized/internal/compact_trace_encoder.h"
+#include "pw_trace_tokenized/internal/per_core_trace_buffers.h"
+
 namespace pw {
 namespace trace {
 
@@ -118,11 +121,20 @@ class TokenizedTraceImpl {
   void Enable(bool enable) {
     if (enable != enabled_ && enable) {
       event_queue_.Clear();
+#if PW_TRACE_COMPACT_ENCODING
+      compact_encoder_.RequestSyncPoint();
+#endif  // PW_TRACE_COMPACT_ENCODING
     }
     enabled_ = enable;
   }
   bool IsEnabled() const { return enabled_; }
 
+  // Records an event with the tick rate of the trace time, which host tools
+  // use to convert times in the trace to real time. Call this after enabling
+  // tracing when the time source is not in microseconds, such as the cycle
+  // counter time source.
+  void EmitTimeCalibration();
+
   void HandleTraceEvent(uint32_t trace_token,
                         EventType event_type,
                         const char* module,
@@ -131,14 +143,56 @@ class TokenizedTraceImpl {
                         const void* data_buffer,
                         size_t data_size);
 
+#if PW_TRACE_COMPACT_ENCODING
+  // Emits a sync point before the next event, so that the events which follow
+  // can be decoded without the preceding ones.
+  void RequestSyncPoint() { compact_encoder_.RequestSyncPoint(); }
+#endif  // PW_TRACE_COMPACT_ENCODING
+
+#if PW_TRACE_PER_CORE_BUFFERS
+  using PerCoreBuffers =
+      internal::PerCoreTraceBuffers<PW_TRACE_CORE_COUNT,
+                                    PW_TRACE_PER_CORE_BUFFER_SIZE_BYTES>;
+
+  // Sends the events recorded in the per-core buffers to the sinks, merged in
+  // order of time. Returns the number of events sent.
+  size_t DrainPerCoreBuffers();
+
+  const PerCoreBuffers& per_core_buffers() const { return per_core_buffers_; }
+#endif  // PW_TRACE_PER_CORE_BUFFERS
+
  private:
   using TraceQueue = internal::TraceQueue<PW_TRACE_QUEUE_SIZE_EVENTS>;
   PW_TRACE_TIME_TYPE last_trace_time_ = 0;
   bool enabled_ = false;
   TraceQueue event_queue_;
+#if PW_TRACE_PER_CORE_BUFFERS
+  PerCoreBuffers per_core_buffers_;
+#endif  // PW_TRACE_PER_CORE_BUFFERS
+#if PW_TRACE_COMPACT_ENCODING
+  internal::CompactTraceEncoder compact_encoder_{
+      PW_TRACE_COMPACT_SYNC_INTERVAL_EVENTS};
+#endif  // PW_TRACE_COMPACT_ENCODING
 
   void HandleNextItemInQueue(
       const volatile TraceQueue::QueueEventBlock* event_block);
+
+#if PW_TRACE_PER_CORE_BUFFERS
+  void RecordOnCurrentCore(uint32_t trace_token,
+                           EventType event_type,
+                           const char* module,
+                           uint32_t trace_id,
+                           uint8_t flags,
+                           const void* data_buffer,
+                           size_t data_size);
+#endif  // PW_TRACE_PER_CORE_BUFFERS
+
+  // Encodes the token and the time elapsed since the last event sent to the
+  // sinks, and updates the last event time. In the compact encoding, this may
+  // first send a sync point to the sinks.
+  size_t EncodeHeader(uint32_t trace_token,
+                      PW_TRACE_TIME_TYPE trace_time,
+                      std::span<std::byte> header);
 };
 
 // A singleton object of the TokenizedTraceImpl class which can be used to
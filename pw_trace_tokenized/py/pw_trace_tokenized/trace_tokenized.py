@@ -19,9 +19,14 @@ trace files.
 Example usage:
 python pw_trace_tokenized/py/trace_tokenized.py -i trace.bin -o trace.json
 ./out/host_clang_debug/obj/pw_trace_tokenized/bin/trace_tokenized_example_basic
+
+Traces are converted as they are read, so large captures do not need to fit in
+memory. Pass -i once per core to merge traces from per-core buffers by time.
 """
+from contextlib import ExitStack
 from enum import IntEnum
 import argparse
+import heapq
 import logging
 import struct
 import sys
@@ -123,6 +128,11 @@ def parse_trace_event(buffer, db, last_time, ticks_per_second=1000):
     timestamp_us = last_time + us_per_tick * time_delta
     idx += time_bytes
 
+    return _parse_trace_id_and_data(buffer, idx, token_string, timestamp_us)
+
+
+def _parse_trace_id_and_data(buffer, idx, token_string, timestamp_us):
+    """Decodes the rest of an event, which follows the token and time."""
     # Trace ID
     trace_id = None
     if has_trace_id(token_string) and idx < len(buffer):
@@ -138,29 +148,185 @@ def parse_trace_event(buffer, db, last_time, ticks_per_second=1000):
     return create_trace_event(token_string, timestamp_us, trace_id, data)
 
 
-def get_trace_events_from_file(databases, input_file_name):
-    """Handles the decoding traces."""
-
-    db = tokens.Database.merged(*databases)
-    last_timestamp = 0
-    events = []
-    with open(input_file_name, "rb") as input_file:
-        bytes_read = input_file.read()
-        idx = 0
-
-        while idx + 1 < len(bytes_read):
-            # Read size
-            size = int(bytes_read[idx])
-            if idx + size > len(bytes_read):
-                _LOG.error("incomplete file")
-                break
+def _lookup_token_string(db, token):
+    entries = db.token_to_entries[token]
+    if len(entries) == 0:
+        _LOG.error("token not found: %08x", token)
+        return None
+    return str(entries[0])
+
+
+class StandardDecoder:
+    """Decodes events in the standard encoding, which start with the 4-byte
+    token and the varint time delta from the previous event."""
+    def __init__(self, db, ticks_per_second=1000):
+        self._db = db
+        self._us_per_tick = 1000000 / ticks_per_second
+        self._timestamp_us = 0
+
+    def decode(self, buffer):
+        """Decodes an event; returns None if its token is not known."""
+        token = struct.unpack('I', buffer[:4])[0]
+        time_delta, time_bytes = varint_decode(buffer[4:])
+        self._timestamp_us += self._us_per_tick * time_delta
+
+        token_string = _lookup_token_string(self._db, token)
+        if token_string is None:
+            return None
+        return _parse_trace_id_and_data(buffer, 4 + time_bytes, token_string,
+                                        self._timestamp_us)
+
+
+class CompactDecoder:
+    """Decodes events in the compact encoding (PW_TRACE_COMPACT_ENCODING).
+
+    Each event starts with a control byte, which either refers to an entry in a
+    table of recent tokens or is followed by a literal token. Events before the
+    first sync point are skipped, since they may refer to tokens and times from
+    events which are no longer in the trace.
+    """
+    TOKEN_TABLE_SIZE = 8
+    SYNC_POINT = 0x10
+
+    _TOKEN_FROM_TABLE = 0x80
+    _DELTA_FOLLOWS = 0x0F
+
+    def __init__(self, db, ticks_per_second=1000):
+        self._db = db
+        self._us_per_tick = 1000000 / ticks_per_second
+        self._synced = False
+        self._timestamp_us = 0
+        self._table = []
+        self._next_entry = 0
+
+    def decode(self, buffer):
+        """Decodes an event; returns None for sync points or skipped events."""
+        control = buffer[0]
+        idx = 1
+
+        if control == self.SYNC_POINT:
+            ticks, _ = varint_decode(buffer[idx:])
+            self._timestamp_us = self._us_per_tick * ticks
+            self._table = []
+            self._next_entry = 0
+            self._synced = True
+            return None
+
+        if not self._synced:
+            return None
+
+        time_delta = control & self._DELTA_FOLLOWS
+        if time_delta == self._DELTA_FOLLOWS:
+            time_delta, time_bytes = varint_decode(buffer[idx:])
+            idx += time_bytes
+        self._timestamp_us += self._us_per_tick * time_delta
+
+        if control & self._TOKEN_FROM_TABLE:
+            entry = (control >> 4) & (self.TOKEN_TABLE_SIZE - 1)
+            if entry >= len(self._table):
+                _LOG.error("invalid token table entry: %d", entry)
+                return None
+            token = self._table[entry]
+        elif control & 0x70 == 0:
+            token = struct.unpack('I', buffer[idx:idx + 4])[0]
+            idx += 4
+            self._add_token(token)
+        else:
+            _LOG.error("invalid control byte: %02x", control)
+            return None
+
+        token_string = _lookup_token_string(self._db, token)
+        if token_string is None:
+            return None
+
+        return _parse_trace_id_and_data(buffer, idx, token_string,
+                                        self._timestamp_us)
+
+    def _add_token(self, token):
+        # Tokens replace each other in round-robin order, as on the device.
+        if len(self._table) < self.TOKEN_TABLE_SIZE:
+            self._table.append(token)
+        else:
+            self._table[self._next_entry] = token
+        self._next_entry = (self._next_entry + 1) % self.TOKEN_TABLE_SIZE
+
+
+# The event recorded by TokenizedTrace::EmitTimeCalibration(). Its data is the
+# tick rate of the trace time as a little-endian uint64.
+TIME_CALIBRATION_MODULE = "pw_trace"
+TIME_CALIBRATION_LABEL = "time_calibration"
+
+
+def is_time_calibration(event):
+    return (event.module == TIME_CALIBRATION_MODULE
+            and event.label == TIME_CALIBRATION_LABEL
+            and len(event.data or b"") == 8)
+
+
+def _read_entries(input_file):
+    """Yields the size-prefixed entries in a trace file, one at a time."""
+    while True:
+        size = input_file.read(1)
+        if not size:
+            return
+        entry = input_file.read(size[0])
+        if len(entry) < size[0]:
+            _LOG.error("incomplete file")
+            return
+        yield entry
+
+
+def _decode_file(db, input_file, compact, ticks_per_second):
+    """Yields the events in one trace file, with times in microseconds.
+
+    Events are decoded in ticks, then converted to microseconds with the tick
+    rate from the most recent time calibration event, or ticks_per_second
+    before the first one. Fractional microseconds are kept, so traces from fast
+    time sources such as a cycle counter keep their resolution.
+    """
+    # Decode with one tick per microsecond, so times are in ticks.
+    decoder = (CompactDecoder(db, ticks_per_second=1000000)
+               if compact else StandardDecoder(db, ticks_per_second=1000000))
+    us_per_tick = 1000000 / ticks_per_second
 
-            event = parse_trace_event(bytes_read[idx + 1:idx + 1 + size], db,
-                                      last_timestamp)
-            last_timestamp = event.timestamp_us
-            events.append(event)
-            idx = idx + size + 1
-    return events
+    for entry in _read_entries(input_file):
+        event = decoder.decode(entry)
+        if event is None:
+            continue
+        if is_time_calibration(event):
+            us_per_tick = 1000000 / struct.unpack('<Q', event.data)[0]
+        yield event._replace(timestamp_us=event.timestamp_us * us_per_tick)
+
+
+def iter_trace_events(db,
+                      input_file_names,
+                      compact=False,
+                      ticks_per_second=1000):
+    """Decodes trace files, yielding events one at a time.
+
+    Args:
+      db: a tokens.Database or tokens.MappedDatabase with the trace tokens
+      input_file_names: the trace files; events from several files, such as the
+          buffers of each core, are merged in order of time
+      compact: whether the traces use the compact encoding
+      ticks_per_second: the tick rate if a trace has no calibration event
+    """
+    with ExitStack() as stack:
+        streams = [
+            _decode_file(db, stack.enter_context(open(name, "rb")), compact,
+                         ticks_per_second) for name in input_file_names
+        ]
+        yield from heapq.merge(*streams, key=lambda event: event.timestamp_us)
+
+
+def get_trace_events_from_file(databases,
+                               input_file_name,
+                               compact=False,
+                               ticks_per_second=1000):
+    """Handles the decoding traces."""
+    return list(
+        iter_trace_events(tokens.Database.merged(*databases),
+                          [input_file_name], compact, ticks_per_second))
 
 
 def _parse_args():
@@ -171,29 +337,54 @@ def _parse_args():
         formatter_class=argparse.RawDescriptionHelpFormatter)
     parser.add_argument(
         'databases',
-        nargs='+',
+        nargs='*',
         action=database.LoadTokenDatabases,
         help='Databases (ELF, binary, or CSV) to use to lookup tokens.')
+    parser.add_argument(
+        '--mapped-database',
+        type=tokens.MappedDatabase,
+        help=('A binary token database to search in place with a memory map, '
+              'instead of loading it, for large databases.'))
     parser.add_argument(
         '-i',
         '--input',
-        dest='input_file',
-        help='The binary trace input file, generated using trace_to_file.h.')
+        dest='input_files',
+        action='append',
+        required=True,
+        help=('The binary trace input file, generated using trace_to_file.h. '
+              'Repeat for the traces of each core to merge them by time.'))
     parser.add_argument('-o',
                         '--output',
                         dest='output_file',
                         help=('The json file to which to write the output.'))
+    parser.add_argument(
+        '--compact',
+        action='store_true',
+        help='The trace uses the compact encoding (PW_TRACE_COMPACT_ENCODING).')
+    parser.add_argument(
+        '--ticks-per-second',
+        type=int,
+        default=1000,
+        help=('The tick rate of the trace time, if the trace does not have a '
+              'time calibration event.'))
 
     return parser.parse_args()
 
 
 def _main(args):
-    events = get_trace_events_from_file(args.databases, args.input_file)
-    json_lines = trace.generate_trace_json(events)
-
+    if args.mapped_database is not None:
+        if args.databases:
+            sys.exit('ERROR: Use either --mapped-database or databases.')
+        db = args.mapped_database
+    elif args.databases:
+        db = tokens.Database.merged(*args.databases)
+    else:
+        sys.exit('ERROR: A token database is required.')
+
+    events = iter_trace_events(db, args.input_files, args.compact,
+                               args.ticks_per_second)
     with open(args.output_file, 'w') as output_file:
-        for line in json_lines:
-            output_file.write("%s,\n" % line)
+        trace.write_trace_json(events, output_file)
 
 
 if __name__ == '__main__':
@@ -18,12 +18,73 @@
 
 #include "pw_preprocessor/util.h"
 #include "pw_trace_tokenized/trace_callback.h"
+#include "pw_trace_tokenized/trace_sampling.h"
 #include "pw_trace_tokenized/trace_tokenized.h"
 #include "pw_varint/varint.h"
 
 namespace pw {
 namespace trace {
 
+namespace {
+
+// The largest encoded token and time delta, in either encoding.
+constexpr size_t kMaxTokenAndTimeSizeBytes =
+    internal::CompactTraceEncoder::kMaxHeaderSizeBytes;
+static_assert(kMaxTokenAndTimeSizeBytes >=
+              sizeof(uint32_t) + pw::varint::kMaxVarint64SizeBytes);
+
+// Calls the registered event callbacks and returns their combined flags. Sets
+// PW_TRACE_EVENT_RETURN_FLAGS_SKIP_EVENT if the event should not be recorded,
+// including if tracing is disabled.
+pw_trace_TraceEventReturnFlags CallEventCallbacks(
+    const TokenizedTraceImpl& trace,
+    uint32_t trace_token,
+    EventType event_type,
+    const char* module,
+    uint32_t trace_id,
+    uint8_t flags) {
+  // Call any event callback which is registered to receive every event.
+  pw_trace_TraceEventReturnFlags ret_flags = 0;
+  ret_flags |=
+      Callbacks::Instance().CallEventCallbacks(CallbacksImpl::kCallOnEveryEvent,
+                                               trace_token,
+                                               event_type,
+                                               module,
+                                               trace_id,
+                                               flags);
+  // Return if disabled.
+  if ((PW_TRACE_EVENT_RETURN_FLAGS_SKIP_EVENT & ret_flags) ||
+      !trace.IsEnabled()) {
+    return ret_flags | PW_TRACE_EVENT_RETURN_FLAGS_SKIP_EVENT;
+  }
+
+  // Call any event callback not already called.
+  ret_flags |= Callbacks::Instance().CallEventCallbacks(
+      CallbacksImpl::kCallOnlyWhenEnabled,
+      trace_token,
+      event_type,
+      module,
+      trace_id,
+      flags);
+  // Skip if disabled (from a callback) or if a callback has indicated the
+  // sample should be skipped.
+  if (!trace.IsEnabled()) {
+    ret_flags |= PW_TRACE_EVENT_RETURN_FLAGS_SKIP_EVENT;
+  }
+
+  // Apply sampling rules last, so skipped events do not use up rate limits.
+  SamplingImpl& sampling = Sampling::Instance();
+  if (!(PW_TRACE_EVENT_RETURN_FLAGS_SKIP_EVENT & ret_flags) &&
+      sampling.HasRules() &&
+      !sampling.ShouldRecord(
+          trace_token, event_type, trace_id, PW_TRACE_GET_TIME())) {
+    ret_flags |= PW_TRACE_EVENT_RETURN_FLAGS_SKIP_EVENT;
+  }
+  return ret_flags;
+}
+
+}  // namespace
+
 TokenizedTraceImpl TokenizedTrace::instance_;
 CallbacksImpl Callbacks::instance_;
 
@@ -40,6 +101,12 @@ void TokenizedTraceImpl::HandleTraceEvent(uint32_t trace_token,
     return;
   }
 
+#if PW_TRACE_PER_CORE_BUFFERS
+  RecordOnCurrentCore(
+      trace_token, event_type, module, trace_id, flags, data_buffer, data_size);
+  return;
+#endif  // PW_TRACE_PER_CORE_BUFFERS
+
   // Create trace event
   PW_TRACE_QUEUE_LOCK();
   if (!event_queue_
@@ -80,54 +147,110 @@ void TokenizedTraceImpl::HandleNextItemInQueue(
       const_cast<const std::byte*>(event_block->data_buffer);
   size_t data_size = event_block->data_size;
 
-  // Call any event callback which is registered to receive every event.
-  pw_trace_TraceEventReturnFlags ret_flags = 0;
-  ret_flags |=
-      Callbacks::Instance().CallEventCallbacks(CallbacksImpl::kCallOnEveryEvent,
-                                               trace_token,
-                                               event_type,
-                                               module,
-                                               trace_id,
-                                               flags);
-  // Return if disabled.
-  if ((PW_TRACE_EVENT_RETURN_FLAGS_SKIP_EVENT & ret_flags) || !enabled_) {
-    return;
-  }
-
-  // Call any event callback not already called.
-  ret_flags |= Callbacks::Instance().CallEventCallbacks(
-      CallbacksImpl::kCallOnlyWhenEnabled,
-      trace_token,
-      event_type,
-      module,
-      trace_id,
-      flags);
-  // Return if disabled (from a callback) or if a callback has indicated the
-  // sample should be skipped.
-  if ((PW_TRACE_EVENT_RETURN_FLAGS_SKIP_EVENT & ret_flags) || !enabled_) {
+  const pw_trace_TraceEventReturnFlags ret_flags = CallEventCallbacks(
+      *this, trace_token, event_type, module, trace_id, flags);
+  if (PW_TRACE_EVENT_RETURN_FLAGS_SKIP_EVENT & ret_flags) {
     return;
   }
 
   // Create header to store trace info
   static constexpr size_t kMaxHeaderSize =
-      sizeof(trace_token) + pw::varint::kMaxVarint64SizeBytes +  // time
-      pw::varint::kMaxVarint64SizeBytes;                         // trace_id
+      kMaxTokenAndTimeSizeBytes +         // token and time
+      pw::varint::kMaxVarint64SizeBytes;  // trace_id
   std::byte header[kMaxHeaderSize];
-  memcpy(header, &trace_token, sizeof(trace_token));
-  size_t header_size = sizeof(trace_token);
+  size_t header_size =
+      EncodeHeader(trace_token, pw_trace_GetTraceTime(), header);
+
+  // Calculate packet id if needed.
+  if (PW_TRACE_HAS_TRACE_ID(event_type)) {
+    header_size +=
+        pw::varint::Encode(trace_id,
+                           std::span<std::byte>(&header[header_size],
+                                                kMaxHeaderSize - header_size));
+  }
+
+  // Send encoded output to any registered trace sinks.
+  Callbacks::Instance().CallSinks(
+      std::span<const std::byte>(header, header_size),
+      std::span<const std::byte>(
+          reinterpret_cast<const std::byte*>(data_buffer), data_size));
+  // Disable after processing if an event callback had set the flag.
+  if (PW_TRACE_EVENT_RETURN_FLAGS_DISABLE_AFTER_PROCESSING & ret_flags) {
+    enabled_ = false;
+  }
+}
 
+void TokenizedTraceImpl::EmitTimeCalibration() {
+  static constexpr uint32_t kTimeCalibrationRef =
+      PW_TRACE_REF_DATA(PW_TRACE_TYPE_INSTANT,
+                        "pw_trace",
+                        "time_calibration",
+                        PW_TRACE_FLAGS_DEFAULT,
+                        PW_TRACE_GROUP_LABEL_DEFAULT,
+                        "@pw_py_struct_fmt:<Q");
+  const uint64_t ticks_per_second = PW_TRACE_GET_TIME_TICKS_PER_SECOND();
+  HandleTraceEvent(kTimeCalibrationRef,
+                   PW_TRACE_TYPE_INSTANT,
+                   "pw_trace",
+                   PW_TRACE_TRACE_ID_DEFAULT,
+                   PW_TRACE_FLAGS_DEFAULT,
+                   &ticks_per_second,
+                   sizeof(ticks_per_second));
+}
+
+size_t TokenizedTraceImpl::EncodeHeader(uint32_t trace_token,
+                                        PW_TRACE_TIME_TYPE trace_time,
+                                        std::span<std::byte> header) {
   // Compute delta of time elapsed since last trace entry.
-  PW_TRACE_TIME_TYPE trace_time = pw_trace_GetTraceTime();
   PW_TRACE_TIME_TYPE delta =
       (last_trace_time_ == 0)
           ? 0
           : PW_TRACE_GET_TIME_DELTA(last_trace_time_, trace_time);
-  header_size += pw::varint::Encode(
-      delta,
-      std::span<std::byte>(&header[header_size], kMaxHeaderSize - header_size));
   last_trace_time_ = trace_time;
 
-  // Calculate packet id if needed.
+#if PW_TRACE_COMPACT_ENCODING
+  // The sync point holds the time of this event, so its delta is 0.
+  if (compact_encoder_.NeedsSyncPoint()) {
+    std::byte sync_point[internal::CompactTraceEncoder::kMaxSyncPointSizeBytes];
+    Callbacks::Instance().CallSinks(
+        std::span<const std::byte>(
+            sync_point,
+            compact_encoder_.EncodeSyncPoint(trace_time, sync_point)),
+        std::span<const std::byte>());
+    delta = 0;
+  }
+  return compact_encoder_.EncodeEvent(trace_token, delta, header);
+#else
+  memcpy(header.data(), &trace_token, sizeof(trace_token));
+  return sizeof(trace_token) +
+         pw::varint::Encode(delta, header.subspan(sizeof(trace_token)));
+#endif  // PW_TRACE_COMPACT_ENCODING
+}
+
+#if PW_TRACE_PER_CORE_BUFFERS
+void TokenizedTraceImpl::RecordOnCurrentCore(uint32_t trace_token,
+                                             EventType event_type,
+                                             const char* module,
+                                             uint32_t trace_id,
+                                             uint8_t flags,
+                                             const void* data_buffer,
+                                             size_t data_size) {
+  // Event callbacks run on the core the event happens on, since the event is
+  // not queued.
+  const pw_trace_TraceEventReturnFlags ret_flags = CallEventCallbacks(
+      *this, trace_token, event_type, module, trace_id, flags);
+  if (PW_TRACE_EVENT_RETURN_FLAGS_SKIP_EVENT & ret_flags) {
+    return;
+  }
+
+  // The time is encoded when draining, as a delta from the previous event on
+  // any core.
+  static constexpr size_t kMaxHeaderSize =
+      sizeof(trace_token) + pw::varint::kMaxVarint32SizeBytes;  // trace_id
+  std::byte header[kMaxHeaderSize];
+  memcpy(header, &trace_token, sizeof(trace_token));
+  size_t header_size = sizeof(trace_token);
+
   if (PW_TRACE_HAS_TRACE_ID(event_type)) {
     header_size +=
         pw::varint::Encode(trace_id,
@@ -135,17 +258,45 @@ void TokenizedTraceImpl::HandleNextItemInQueue(
                                                 kMaxHeaderSize - header_size));
   }
 
-  // Send encoded output to any registered trace sinks.
-  Callbacks::Instance().CallSinks(
+  // The core ID and time are read with the core locked, so events are
+  // recorded to each buffer in order of time.
+  PW_TRACE_CORE_LOCK();
+  // Dropped events are counted by the buffer.
+  per_core_buffers_.Record(
+      PW_TRACE_GET_CORE_ID(),
+      PW_TRACE_GET_TIME(),
       std::span<const std::byte>(header, header_size),
       std::span<const std::byte>(
           reinterpret_cast<const std::byte*>(data_buffer), data_size));
-  // Disable after processing if an event callback had set the flag.
+  PW_TRACE_CORE_UNLOCK();
+
+  // Disable after recording if an event callback had set the flag.
   if (PW_TRACE_EVENT_RETURN_FLAGS_DISABLE_AFTER_PROCESSING & ret_flags) {
     enabled_ = false;
   }
 }
 
+size_t TokenizedTraceImpl::DrainPerCoreBuffers() {
+  PW_TRACE_LOCK();
+  const size_t drained = per_core_buffers_.Drain(
+      [this](size_t,
+             PW_TRACE_TIME_TYPE time,
+             std::span<const std::byte> event) {
+        // Encode the token and time delta, as in queued events.
+        uint32_t trace_token;
+        memcpy(&trace_token, event.data(), sizeof(trace_token));
+        std::byte header[kMaxTokenAndTimeSizeBytes];
+        const size_t header_size = EncodeHeader(trace_token, time, header);
+
+        Callbacks::Instance().CallSinks(
+            std::span<const std::byte>(header, header_size),
+            event.subspan(sizeof(uint32_t)));
+      });
+  PW_TRACE_UNLOCK();
+  return drained;
+}
+#endif  // PW_TRACE_PER_CORE_BUFFERS
+
 pw_trace_TraceEventReturnFlags CallbacksImpl::CallEventCallbacks(
     CallOnEveryEvent called_on_every_event,
     uint32_t trace_ref,
@@ -0,0 +1,143 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Benchmarks the cost of a trace event through the tokenized trace backend.
+// PW_TRACE_INSTANT, PW_TRACE_START/PW_TRACE_END pairs, and
+// PW_TRACE_INSTANT_DATA are traced with tracing disabled, enabled with nothing
+// registered, with a sink, and with an event callback and a sink. Each case is
+// a pw_unit_test benchmark, in which an iteration traces one event or one
+// start and end pair.
+
+// clang-format off
+#define PW_TRACE_MODULE_NAME "BENCH"
+
+#include "pw_trace/trace.h"
+#include "pw_trace_tokenized/trace_callback.h"
+#include "pw_trace_tokenized/trace_tokenized.h"
+// clang-format on
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "gtest/gtest.h"
+#include "pw_unit_test/benchmark.h"
+
+namespace pw::trace {
+namespace {
+
+using unit_test::BenchmarkState;
+
+size_t sink_bytes = 0;
+size_t callback_events = 0;
+
+void SinkStartBlock(void*, size_t size) { sink_bytes += size; }
+void SinkAddBytes(void*, const void*, size_t) {}
+void SinkEndBlock(void*) {}
+
+pw_trace_TraceEventReturnFlags EventCallback(
+    void*, uint32_t, pw_trace_EventType, const char*, uint32_t, uint8_t) {
+  callback_events += 1;
+  return PW_TRACE_EVENT_RETURN_FLAGS_NONE;
+}
+
+// The data traced with PW_TRACE_INSTANT_DATA.
+volatile uint32_t data_value = 0x1234;
+
+enum class Setup {
+  kDisabled,
+  kEnabled,
+  kSink,
+  kCallbackAndSink,
+};
+
+// Configures tracing for a case, and restores the default configuration when
+// the case ends.
+class ScopedSetup {
+ public:
+  explicit ScopedSetup(Setup setup) {
+    sink_bytes = 0;
+    callback_events = 0;
+    if (setup == Setup::kCallbackAndSink) {
+      Callbacks::Instance().RegisterEventCallback(EventCallback);
+    }
+    if (setup == Setup::kSink || setup == Setup::kCallbackAndSink) {
+      Callbacks::Instance().RegisterSink(
+          SinkStartBlock, SinkAddBytes, SinkEndBlock);
+    }
+    PW_TRACE_SET_ENABLED(setup != Setup::kDisabled);
+  }
+
+  ~ScopedSetup() {
+    PW_TRACE_SET_ENABLED(false);
+    Callbacks::Instance().UnregisterAllEventCallbacks();
+    Callbacks::Instance().UnregisterAllSinks();
+  }
+};
+
+// Benchmarks the trace statements with each setup. The setup is configured
+// for each repetition, outside of the timed loop. The trace macros need
+// literal labels, so this is a macro.
+#define BENCHMARK_TRACE(label, events_per_iteration, ...)                      \
+  do {                                                                         \
+    static constexpr struct {                                                  \
+      const char* name;                                                        \
+      Setup setup;                                                             \
+    } kCases[] = {                                                             \
+        {"disabled", Setup::kDisabled},                                        \
+        {"enabled", Setup::kEnabled},                                          \
+        {"sink", Setup::kSink},                                                \
+        {"callback and sink", Setup::kCallbackAndSink},                        \
+    };                                                                         \
+    for (const auto& benchmark_case : kCases) {                                \
+      char case_name[64];                                                      \
+      std::snprintf(                                                           \
+          case_name, sizeof(case_name), "%s, %s", label, benchmark_case.name); \
+      const Setup setup = benchmark_case.setup;                                \
+      unit_test::RunBenchmark(case_name, {}, [setup](BenchmarkState& state) {  \
+        ScopedSetup scoped_setup(setup);                                       \
+        for (auto _ : state) {                                                 \
+          __VA_ARGS__;                                                         \
+        }                                                                      \
+        if (setup == Setup::kSink || setup == Setup::kCallbackAndSink) {       \
+          EXPECT_GT(sink_bytes, 0u);                                           \
+        }                                                                      \
+        if (setup == Setup::kCallbackAndSink) {                                \
+          EXPECT_EQ(callback_events,                                           \
+                    size_t{state.iterations()} * (events_per_iteration));      \
+        }                                                                      \
+      });                                                                      \
+    }                                                                          \
+  } while (0)
+
+TEST(TraceBenchmark, Instant) {
+  BENCHMARK_TRACE("PW_TRACE_INSTANT", 1, PW_TRACE_INSTANT("instant"));
+}
+
+TEST(TraceBenchmark, StartEnd) {
+  BENCHMARK_TRACE("PW_TRACE_START and PW_TRACE_END",
+                  2,
+                  PW_TRACE_START("span");
+                  PW_TRACE_END("span"));
+}
+
+TEST(TraceBenchmark, InstantData) {
+  BENCHMARK_TRACE("PW_TRACE_INSTANT_DATA", 1, {
+    const uint32_t value = data_value;
+    PW_TRACE_INSTANT_DATA("data", "@pw_py_struct_fmt:I", &value, sizeof(value));
+  });
+}
+
+}  // namespace
+}  // namespace pw::trace
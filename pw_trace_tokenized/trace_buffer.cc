@@ -59,15 +59,100 @@ class TraceBuffer {
     if (buffer->block_idx_ != buffer->block_size_) {
       return;  // Block is too large, skipping.
     }
+    if (buffer->state_ == State::kFrozen) {
+      if (buffer->ring_buffer_.EntryCount() != 0) {
+        return;  // Keep the frozen events until they are read.
+      }
+      buffer->state_ = State::kRecording;
+#if PW_TRACE_COMPACT_ENCODING
+      // This event was encoded relative to the dropped events, so drop it too
+      // and restart the encoding from the next event.
+      TokenizedTrace::Instance().RequestSyncPoint();
+      return;
+#endif  // PW_TRACE_COMPACT_ENCODING
+    }
     buffer->ring_buffer_.PushBack(std::span<const std::byte>(
         &buffer->current_block_[0], buffer->block_size_));
+    if (buffer->state_ == State::kTriggered) {
+      buffer->CountEventAfterTrigger();
+    }
+  }
+
+  static pw_trace_TraceEventReturnFlags TriggerCallback(
+      void* user_data,
+      uint32_t trace_ref,
+      pw_trace_EventType,
+      const char*,
+      uint32_t,
+      uint8_t) {
+    TraceBuffer* buffer = reinterpret_cast<TraceBuffer*>(user_data);
+    if (trace_ref == buffer->trigger_ref_) {
+      // Count the trigger event, which is recorded after the callback.
+      buffer->Trigger(buffer->events_after_trigger_ + 1);
+    }
+    return PW_TRACE_EVENT_RETURN_FLAGS_NONE;
+  }
+
+  // Must be called with the trace lock held.
+  void Trigger(size_t events_to_record) {
+    if (state_ != State::kRecording) {
+      return;
+    }
+    state_ = State::kTriggered;
+    events_to_record_ = events_to_record;
+    if (events_to_record_ == 0) {
+      state_ = State::kFrozen;
+    }
+  }
+
+  pw::Status SetTrigger(uint32_t trace_ref, size_t events_after_trigger) {
+    ClearTrigger();
+    trigger_ref_ = trace_ref;
+    events_after_trigger_ = events_after_trigger;
+    return Callbacks::Instance().RegisterEventCallback(
+        TriggerCallback,
+        CallbacksImpl::kCallOnlyWhenEnabled,
+        this,
+        &trigger_callback_handle_);
+  }
+
+  void ClearTrigger() {
+    if (trigger_callback_handle_ != kNoTriggerCallback) {
+      Callbacks::Instance().UnregisterEventCallback(trigger_callback_handle_);
+      trigger_callback_handle_ = kNoTriggerCallback;
+    }
+  }
+
+  void Clear() {
+    ring_buffer_.Clear();
+    state_ = State::kRecording;
   }
 
+  bool frozen() const { return state_ == State::kFrozen; }
+
   pw::ring_buffer::PrefixedEntryRingBuffer& RingBuffer() {
     return ring_buffer_;
   };
 
  private:
+  enum class State { kRecording, kTriggered, kFrozen };
+
+  static constexpr CallbacksImpl::EventCallbackHandle kNoTriggerCallback =
+      static_cast<CallbacksImpl::EventCallbackHandle>(-1);
+
+  void CountEventAfterTrigger() {
+    events_to_record_ -= 1;
+    if (events_to_record_ == 0) {
+      state_ = State::kFrozen;
+    }
+  }
+
+  State state_ = State::kRecording;
+  size_t events_to_record_ = 0;
+  uint32_t trigger_ref_ = 0;
+  size_t events_after_trigger_ = 0;
+  CallbacksImpl::EventCallbackHandle trigger_callback_handle_ =
+      kNoTriggerCallback;
   uint16_t block_size_ = 0;
   uint16_t block_idx_ = 0;
   std::byte current_block_[PW_TRACE_BUFFER_MAX_BLOCK_SIZE_BYTES];
@@ -81,11 +166,32 @@ TraceBuffer trace_buffer_instance;
 
 }  // namespace
 
-void ClearBuffer() { trace_buffer_instance.RingBuffer().Clear(); }
+void ClearBuffer() {
+  trace_buffer_instance.Clear();
+#if PW_TRACE_COMPACT_ENCODING
+  // Events after the clear must not depend on the cleared events.
+  TokenizedTrace::Instance().RequestSyncPoint();
+#endif  // PW_TRACE_COMPACT_ENCODING
+}
 
 pw::ring_buffer::PrefixedEntryRingBuffer* GetBuffer() {
   return &trace_buffer_instance.RingBuffer();
 }
 
+void TriggerBufferFreeze(size_t events_after_trigger) {
+  PW_TRACE_LOCK();
+  trace_buffer_instance.Trigger(events_after_trigger);
+  PW_TRACE_UNLOCK();
+}
+
+pw::Status SetBufferFreezeTrigger(uint32_t trace_ref,
+                                  size_t events_after_trigger) {
+  return trace_buffer_instance.SetTrigger(trace_ref, events_after_trigger);
+}
+
+void ClearBufferFreezeTrigger() { trace_buffer_instance.ClearTrigger(); }
+
+bool IsBufferFrozen() { return trace_buffer_instance.frozen(); }
+
 }  // namespace trace
 }  // namespace pw
\ No newline at end of file
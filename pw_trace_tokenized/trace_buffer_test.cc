@@ -16,6 +16,8 @@
 
 #include "pw_trace_tokenized/trace_buffer.h"
 
+#include <cstring>
+
 #include "gtest/gtest.h"
 #include "pw_trace/trace.h"
 
@@ -140,4 +142,139 @@ TEST(TokenizedTrace, BlockTooLarge) {
   uint8_t data[PW_TRACE_BUFFER_MAX_BLOCK_SIZE_BYTES];
   PW_TRACE_INSTANT_DATA("Test", "data", data, sizeof(data));
   EXPECT_EQ(buf->EntryCount(), 0u);
-}
\ No newline at end of file
+}
+namespace {
+
+// Returns the count held by the event at the front of the buffer, or -1 if the
+// buffer is empty.
+int ReadFrontCount(pw::ring_buffer::PrefixedEntryRingBuffer* buf) {
+  std::byte value[PW_TRACE_BUFFER_MAX_BLOCK_SIZE_BYTES];
+  size_t bytes_read = 0;
+  if (!buf->PeekFront(std::span<std::byte>(value), &bytes_read).ok()) {
+    return -1;
+  }
+  int count;
+  std::memcpy(&count, &value[bytes_read - sizeof(count)], sizeof(count));
+  return count;
+}
+
+// Traces an event holding each count from first up to last.
+void TraceCounts(int first, int last) {
+  for (int count = first; count < last; ++count) {
+    PW_TRACE_INSTANT_DATA("Test", "count", &count, sizeof(count));
+  }
+}
+
+}  // namespace
+
+TEST(TokenizedTrace, Freeze_RecordsEventsAfterTrigger) {
+  PW_TRACE_SET_ENABLED(true);
+  pw::trace::ClearBuffer();
+  pw::ring_buffer::PrefixedEntryRingBuffer* buf = pw::trace::GetBuffer();
+
+  TraceCounts(0, 2);
+  pw::trace::TriggerBufferFreeze(3);
+  EXPECT_FALSE(pw::trace::IsBufferFrozen());
+  TraceCounts(2, 5);
+  EXPECT_TRUE(pw::trace::IsBufferFrozen());
+
+  // Events after the freeze are dropped.
+  TraceCounts(5, 10);
+  EXPECT_EQ(buf->EntryCount(), 5u);
+  EXPECT_EQ(ReadFrontCount(buf), 0);
+  pw::trace::ClearBuffer();
+}
+
+TEST(TokenizedTrace, Freeze_ZeroEventsAfterTrigger) {
+  PW_TRACE_SET_ENABLED(true);
+  pw::trace::ClearBuffer();
+  pw::ring_buffer::PrefixedEntryRingBuffer* buf = pw::trace::GetBuffer();
+
+  TraceCounts(0, 1);
+  pw::trace::TriggerBufferFreeze(0);
+  EXPECT_TRUE(pw::trace::IsBufferFrozen());
+  TraceCounts(1, 3);
+  EXPECT_EQ(buf->EntryCount(), 1u);
+  pw::trace::ClearBuffer();
+}
+
+TEST(TokenizedTrace, Freeze_KeepsEventsAroundTrigger) {
+  PW_TRACE_SET_ENABLED(true);
+  pw::trace::ClearBuffer();
+  pw::ring_buffer::PrefixedEntryRingBuffer* buf = pw::trace::GetBuffer();
+
+  // Wrap the buffer several times before the trigger.
+  TraceCounts(0, 200);
+  pw::trace::TriggerBufferFreeze(2);
+  TraceCounts(200, 300);
+
+  // The newest events kept are the ones just after the trigger.
+  int last = -1;
+  while (buf->EntryCount() > 0) {
+    last = ReadFrontCount(buf);
+    buf->PopFront();
+  }
+  EXPECT_EQ(last, 201);
+}
+
+TEST(TokenizedTrace, Freeze_ResumesWhenDrained) {
+  PW_TRACE_SET_ENABLED(true);
+  pw::trace::ClearBuffer();
+  pw::ring_buffer::PrefixedEntryRingBuffer* buf = pw::trace::GetBuffer();
+
+  TraceCounts(0, 2);
+  pw::trace::TriggerBufferFreeze(0);
+  buf->PopFront();
+  TraceCounts(2, 3);
+  EXPECT_TRUE(pw::trace::IsBufferFrozen());
+  EXPECT_EQ(ReadFrontCount(buf), 1);
+
+  buf->PopFront();
+  TraceCounts(3, 5);
+  EXPECT_FALSE(pw::trace::IsBufferFrozen());
+  EXPECT_EQ(ReadFrontCount(buf), 3);
+  pw::trace::ClearBuffer();
+}
+
+TEST(TokenizedTrace, Freeze_ClearResumes) {
+  PW_TRACE_SET_ENABLED(true);
+  pw::trace::ClearBuffer();
+  pw::ring_buffer::PrefixedEntryRingBuffer* buf = pw::trace::GetBuffer();
+
+  pw::trace::TriggerBufferFreeze(0);
+  EXPECT_TRUE(pw::trace::IsBufferFrozen());
+  pw::trace::ClearBuffer();
+  EXPECT_FALSE(pw::trace::IsBufferFrozen());
+  TraceCounts(0, 1);
+  EXPECT_EQ(buf->EntryCount(), 1u);
+  pw::trace::ClearBuffer();
+}
+
+TEST(TokenizedTrace, Freeze_TriggerEvent) {
+  PW_TRACE_SET_ENABLED(true);
+  pw::trace::ClearBuffer();
+  pw::ring_buffer::PrefixedEntryRingBuffer* buf = pw::trace::GetBuffer();
+
+  constexpr uint32_t kTriggerRef = PW_TRACE_REF(PW_TRACE_TYPE_INSTANT,
+                                                "TST",
+                                                "Trigger",
+                                                PW_TRACE_FLAGS_DEFAULT,
+                                                PW_TRACE_GROUP_LABEL_DEFAULT);
+  ASSERT_EQ(pw::trace::SetBufferFreezeTrigger(kTriggerRef, 2), pw::OkStatus());
+
+  TraceCounts(0, 3);
+  EXPECT_FALSE(pw::trace::IsBufferFrozen());
+  PW_TRACE_INSTANT("Trigger");
+  TraceCounts(3, 10);
+  EXPECT_TRUE(pw::trace::IsBufferFrozen());
+
+  // 3 events before, the trigger event, and 2 events after.
+  EXPECT_EQ(buf->EntryCount(), 6u);
+
+  pw::trace::ClearBufferFreezeTrigger();
+  pw::trace::ClearBuffer();
+  PW_TRACE_INSTANT("Trigger");
+  TraceCounts(0, 5);
+  EXPECT_FALSE(pw::trace::IsBufferFrozen());
+  pw::trace::ClearBuffer();
+}
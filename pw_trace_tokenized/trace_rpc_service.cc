@@ -0,0 +1,155 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_trace_tokenized/trace_rpc_service.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_protobuf/encoder.h"
+#include "pw_status/try.h"
+#include "pw_trace_protos/trace_rpc.pwpb.h"
+
+namespace pw::trace {
+namespace {
+
+// The encoded size of a field with a one-byte key.
+constexpr size_t VarintFieldSize(size_t value) {
+  return 1 + varint::EncodedSize(value);
+}
+
+constexpr size_t BytesFieldSize(size_t size) {
+  return 1 + varint::EncodedSize(size) + size;
+}
+
+}  // namespace
+
+void TraceService::GetTraceData(ServerContext&,
+                                ConstByteSpan,
+                                rpc::RawServerWriter& writer) {
+  response_writer_ = std::move(writer);
+
+  // Start a new stream from the oldest event in the buffer.
+  PW_TRACE_LOCK();
+  trace_buffer_.DetachReader(reader_);
+  trace_buffer_.AttachReader(reader_);
+  PW_TRACE_UNLOCK();
+  reported_drops_ = 0;
+  unsent_events_ = 0;
+}
+
+Status TraceService::Flush() {
+  // If the response writer was not initialized or has since been closed,
+  // ignore the flush operation.
+  if (!response_writer_.open()) {
+    return OkStatus();
+  }
+
+  // Only send the events which are in the buffer now, so that events which
+  // are produced while flushing do not keep this from returning.
+  PW_TRACE_LOCK();
+  size_t events_to_send = reader_.EntryCount();
+  const size_t dropped = DroppedEvents();
+  PW_TRACE_UNLOCK();
+
+  if (events_to_send == 0u && dropped == 0u) {
+    return OkStatus();
+  }
+
+  Response response;
+  do {
+    response = {};
+    PW_TRY(EncodeResponse(
+        response_writer_.PayloadBuffer(), events_to_send, response));
+
+    // The events were removed from the buffer when they were encoded, so if
+    // the response cannot be sent, they are reported as dropped.
+    const Status status = response_writer_.Write(response.encoded);
+    if (!status.ok()) {
+      unsent_events_ += response.events_sent;
+      return status;
+    }
+    reported_drops_ = response.reader_drops;
+    unsent_events_ -= response.unsent_events;
+
+    events_to_send -= std::min(events_to_send, response.events_read);
+  } while (events_to_send > 0u && response.events_read > 0u);
+
+  return OkStatus();
+}
+
+size_t TraceService::DroppedEvents() const {
+  return reader_.DroppedEntries() - reported_drops_ + unsent_events_;
+}
+
+Status TraceService::EncodeResponse(ByteSpan payload,
+                                    size_t max_events,
+                                    Response& response) {
+  protobuf::NestedEncoder nested_encoder(payload);
+  TraceData::Encoder encoder(&nested_encoder);
+  size_t remaining = payload.size();
+
+  PW_TRACE_LOCK();
+  response.reader_drops = reader_.DroppedEntries();
+  response.unsent_events = unsent_events_;
+
+  const size_t dropped = DroppedEvents();
+  if (dropped > 0u) {
+    encoder.WriteDropped(dropped);
+    remaining -= std::min(remaining, VarintFieldSize(dropped));
+  }
+
+  // Encode as many events as fit in the payload. Events which are dropped
+  // while encoding are reported in the next response.
+  const Status status = reader_.PeekAndPopFront(
+      [&](std::byte, ConstByteSpan data, ConstByteSpan wrapped_data) {
+        const size_t size = data.size() + wrapped_data.size();
+        if (BytesFieldSize(size) > remaining) {
+          return Status::ResourceExhausted();
+        }
+        response.events_read += 1;
+
+        if (!wrapped_data.empty()) {
+          if (size > event_buffer_.size()) {
+            unsent_events_ += 1;  // Too large to copy; drop the event.
+            return OkStatus();
+          }
+          std::memcpy(event_buffer_.data(), data.data(), data.size());
+          std::memcpy(&event_buffer_[data.size()],
+                      wrapped_data.data(),
+                      wrapped_data.size());
+          data = ConstByteSpan(event_buffer_.data(), size);
+        }
+
+        remaining -= BytesFieldSize(size);
+        response.events_sent += 1;
+        return encoder.WriteEvents(data);
+      },
+      max_events);
+
+  // An event which can never fit in a response is dropped.
+  if (status.IsResourceExhausted() && response.events_read == 0u) {
+    reader_.PopFront();
+    unsent_events_ += 1;
+    response.events_read = 1;
+  }
+  PW_TRACE_UNLOCK();
+
+  Result<ConstByteSpan> encoded = nested_encoder.Encode();
+  PW_TRY(encoded.status());
+  response.encoded = encoded.value();
+  return OkStatus();
+}
+
+}  // namespace pw::trace
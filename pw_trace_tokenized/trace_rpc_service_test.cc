@@ -0,0 +1,163 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_trace_tokenized/trace_rpc_service.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_rpc/raw_test_method_context.h"
+
+namespace pw::trace {
+namespace {
+
+#define TRACE_METHOD_CONTEXT \
+  PW_RAW_TEST_METHOD_CONTEXT(TraceService, GetTraceData)
+
+// A decoded TraceData response.
+struct Response {
+  std::array<std::byte, 8> first_event{};
+  size_t event_count = 0;
+  uint32_t dropped = 0;
+};
+
+Response Decode(ConstByteSpan encoded) {
+  Response response;
+  protobuf::Decoder decoder(encoded);
+  while (decoder.Next().ok()) {
+    if (decoder.FieldNumber() == 1) {
+      ConstByteSpan event;
+      EXPECT_EQ(OkStatus(), decoder.ReadBytes(&event));
+      if (response.event_count == 0u) {
+        std::copy(event.begin(),
+                  event.begin() + std::min(event.size(), size_t(8)),
+                  response.first_event.begin());
+      }
+      response.event_count += 1;
+    } else if (decoder.FieldNumber() == 2) {
+      EXPECT_EQ(OkStatus(), decoder.ReadUint32(&response.dropped));
+    }
+  }
+  return response;
+}
+
+class TraceServiceTest : public ::testing::Test {
+ protected:
+  TraceServiceTest() { trace_buffer_.SetBuffer(buffer_); }
+
+  // Pushes events of 4 bytes, each filled with its index.
+  void AddEvents(size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      std::array<std::byte, 4> event;
+      event.fill(std::byte(next_event_++));
+      trace_buffer_.PushBack(event);
+    }
+  }
+
+  static TraceService& GetService(TRACE_METHOD_CONTEXT& context) {
+    return static_cast<TraceService&>(context.service());
+  }
+
+  std::array<std::byte, 64> buffer_;
+  ring_buffer::PrefixedEntryRingBuffer trace_buffer_;
+  uint8_t next_event_ = 0;
+};
+
+TEST_F(TraceServiceTest, Flush_WithoutStream_DoesNothing) {
+  TRACE_METHOD_CONTEXT context(trace_buffer_);
+  AddEvents(2);
+  EXPECT_EQ(OkStatus(), GetService(context).Flush());
+  EXPECT_EQ(0u, context.total_responses());
+}
+
+TEST_F(TraceServiceTest, Flush_SendsBufferedEvents) {
+  TRACE_METHOD_CONTEXT context(trace_buffer_);
+  AddEvents(3);
+  context.call({});
+
+  EXPECT_EQ(OkStatus(), GetService(context).Flush());
+  ASSERT_EQ(1u, context.total_responses());
+  const Response response = Decode(context.responses()[0]);
+  EXPECT_EQ(3u, response.event_count);
+  EXPECT_EQ(std::byte{0}, response.first_event[0]);
+  EXPECT_EQ(0u, response.dropped);
+
+  // Nothing new to send.
+  EXPECT_EQ(OkStatus(), GetService(context).Flush());
+  EXPECT_EQ(1u, context.total_responses());
+}
+
+TEST_F(TraceServiceTest, Flush_StreamsNewEvents) {
+  TRACE_METHOD_CONTEXT context(trace_buffer_);
+  context.call({});
+
+  for (uint8_t i = 0; i < 3; ++i) {
+    AddEvents(2);
+    EXPECT_EQ(OkStatus(), GetService(context).Flush());
+  }
+
+  ASSERT_EQ(3u, context.total_responses());
+  const Response last = Decode(context.responses()[2]);
+  EXPECT_EQ(2u, last.event_count);
+  EXPECT_EQ(std::byte{4}, last.first_event[0]);
+
+  GetService(context).Finish();
+  EXPECT_TRUE(context.done());
+}
+
+TEST_F(TraceServiceTest, Flush_ReportsOverwrittenEvents) {
+  TRACE_METHOD_CONTEXT context(trace_buffer_);
+  context.call({});
+
+  // Each event takes 5 bytes, so the 64-byte buffer holds 12 of them.
+  AddEvents(15);
+  EXPECT_EQ(OkStatus(), GetService(context).Flush());
+
+  ASSERT_EQ(1u, context.total_responses());
+  const Response response = Decode(context.responses()[0]);
+  EXPECT_EQ(12u, response.event_count);
+  EXPECT_EQ(3u, response.dropped);
+  EXPECT_EQ(std::byte{3}, response.first_event[0]);
+
+  // The drops are only reported once.
+  AddEvents(1);
+  EXPECT_EQ(OkStatus(), GetService(context).Flush());
+  EXPECT_EQ(0u, Decode(context.responses()[1]).dropped);
+}
+
+TEST_F(TraceServiceTest, Flush_SplitsEventsAcrossResponses) {
+  std::array<std::byte, 512> large_buffer;
+  trace_buffer_.SetBuffer(large_buffer);
+
+  TRACE_METHOD_CONTEXT context(trace_buffer_);
+  context.call({});
+
+  // 40 events of 6 encoded bytes do not fit in one 128-byte packet.
+  AddEvents(40);
+  EXPECT_EQ(OkStatus(), GetService(context).Flush());
+
+  ASSERT_GT(context.total_responses(), 1u);
+  size_t events = 0;
+  for (ConstByteSpan response : context.responses()) {
+    events += Decode(response).event_count;
+  }
+  EXPECT_EQ(40u, events);
+}
+
+}  // namespace
+}  // namespace pw::trace
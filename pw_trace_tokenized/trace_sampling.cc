@@ -0,0 +1,165 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_trace_tokenized/trace_sampling.h"
+
+#include <algorithm>
+
+#include "pw_trace/trace.h"
+
+namespace pw {
+namespace trace {
+
+SamplingImpl Sampling::instance_;
+
+pw::Status SamplingImpl::SetSampleRate(uint32_t trace_ref, uint32_t one_in_n) {
+  pw::Status status = PW_STATUS_OK;
+  PW_TRACE_LOCK();
+  Rule* rule = Find(trace_ref, /*add=*/one_in_n > 1);
+  if (rule != nullptr) {
+    rule->sample_rate = one_in_n > 1 ? one_in_n : 0;
+    rule->sample_count = 0;
+    RemoveIfUnused(*rule);
+  } else if (one_in_n > 1) {
+    status = PW_STATUS_RESOURCE_EXHAUSTED;
+  }
+  PW_TRACE_UNLOCK();
+  return status;
+}
+
+pw::Status SamplingImpl::SetRateLimit(uint32_t trace_ref,
+                                      uint32_t events_per_second,
+                                      uint32_t burst) {
+  pw::Status status = PW_STATUS_OK;
+  PW_TRACE_LOCK();
+  Rule* rule = Find(trace_ref, /*add=*/events_per_second > 0);
+  if (rule != nullptr) {
+    rule->ticks_per_event = 0;
+    if (events_per_second > 0) {
+      rule->ticks_per_event = std::max<uint64_t>(
+          PW_TRACE_GET_TIME_TICKS_PER_SECOND() / events_per_second, 1);
+      rule->max_credit = rule->ticks_per_event * std::max<uint32_t>(burst, 1);
+      rule->credit = rule->max_credit;
+      rule->has_last_time = false;
+    }
+    RemoveIfUnused(*rule);
+  } else if (events_per_second > 0) {
+    status = PW_STATUS_RESOURCE_EXHAUSTED;
+  }
+  PW_TRACE_UNLOCK();
+  return status;
+}
+
+pw::Status SamplingImpl::ClearRule(uint32_t trace_ref) {
+  pw::Status status = PW_STATUS_NOT_FOUND;
+  PW_TRACE_LOCK();
+  Rule* rule = Find(trace_ref, /*add=*/false);
+  if (rule != nullptr) {
+    rule->sample_rate = 0;
+    rule->ticks_per_event = 0;
+    RemoveIfUnused(*rule);
+    status = PW_STATUS_OK;
+  }
+  PW_TRACE_UNLOCK();
+  return status;
+}
+
+void SamplingImpl::ClearAllRules() {
+  PW_TRACE_LOCK();
+  for (Rule& rule : rules_) {
+    rule = {};
+  }
+  rule_count_ = 0;
+  skipped_events_ = 0;
+  PW_TRACE_UNLOCK();
+}
+
+bool SamplingImpl::ShouldRecord(uint32_t trace_ref,
+                                EventType event_type,
+                                uint32_t trace_id,
+                                PW_TRACE_TIME_TYPE trace_time) {
+  Rule* rule = Find(trace_ref, /*add=*/false);
+  if (rule == nullptr) {
+    return true;
+  }
+
+  // Sample first, so events which are sampled out do not use up the limit.
+  if (Sample(*rule, event_type, trace_id) &&
+      TakeFromBucket(*rule, trace_time)) {
+    return true;
+  }
+  skipped_events_ += 1;
+  return false;
+}
+
+SamplingImpl::Rule* SamplingImpl::Find(uint32_t trace_ref, bool add) {
+  Rule* free_rule = nullptr;
+  for (Rule& rule : rules_) {
+    if (rule.trace_ref == trace_ref && trace_ref != 0) {
+      return &rule;
+    }
+    if (rule.trace_ref == 0 && free_rule == nullptr) {
+      free_rule = &rule;
+    }
+  }
+  if (!add || free_rule == nullptr) {
+    return nullptr;
+  }
+  *free_rule = {};
+  free_rule->trace_ref = trace_ref;
+  rule_count_ += 1;
+  return free_rule;
+}
+
+void SamplingImpl::RemoveIfUnused(Rule& rule) {
+  if (rule.sample_rate == 0 && rule.ticks_per_event == 0) {
+    rule = {};
+    rule_count_ -= 1;
+  }
+}
+
+bool SamplingImpl::Sample(Rule& rule,
+                          EventType event_type,
+                          uint32_t trace_id) {
+  if (rule.sample_rate == 0) {
+    return true;
+  }
+  if (PW_TRACE_HAS_TRACE_ID(event_type)) {
+    return trace_id % rule.sample_rate == 0;
+  }
+  const bool sampled = rule.sample_count == 0;
+  rule.sample_count = (rule.sample_count + 1) % rule.sample_rate;
+  return sampled;
+}
+
+bool SamplingImpl::TakeFromBucket(Rule& rule, PW_TRACE_TIME_TYPE trace_time) {
+  if (rule.ticks_per_event == 0) {
+    return true;
+  }
+  if (rule.has_last_time) {
+    const uint64_t elapsed = PW_TRACE_GET_TIME_DELTA(rule.last_time, trace_time);
+    rule.credit = std::min(rule.credit + elapsed, rule.max_credit);
+  }
+  rule.last_time = trace_time;
+  rule.has_last_time = true;
+
+  if (rule.credit < rule.ticks_per_event) {
+    return false;
+  }
+  rule.credit -= rule.ticks_per_event;
+  return true;
+}
+
+}  // namespace trace
+}  // namespace pw
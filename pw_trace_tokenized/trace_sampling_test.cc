@@ -0,0 +1,134 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_trace_tokenized/trace_sampling.h"
+
+#include "gtest/gtest.h"
+
+namespace pw::trace {
+namespace {
+
+constexpr uint32_t kRef = 0x1234;
+constexpr uint32_t kOtherRef = 0x5678;
+
+// The fake trace time used by the tests has 1 tick per second.
+class TraceSamplingTest : public ::testing::Test {
+ protected:
+  bool Record(uint32_t ref, PW_TRACE_TIME_TYPE time = 0) {
+    return sampling_.ShouldRecord(ref, PW_TRACE_TYPE_INSTANT, 0, time);
+  }
+
+  SamplingImpl sampling_;
+};
+
+TEST_F(TraceSamplingTest, NoRules_RecordsEverything) {
+  EXPECT_FALSE(sampling_.HasRules());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(Record(kRef));
+  }
+  EXPECT_EQ(0u, sampling_.skipped_events());
+}
+
+TEST_F(TraceSamplingTest, SampleRate_RecordsOneInN) {
+  ASSERT_EQ(OkStatus(), sampling_.SetSampleRate(kRef, 4));
+  EXPECT_TRUE(sampling_.HasRules());
+
+  size_t recorded = 0;
+  for (int i = 0; i < 12; ++i) {
+    recorded += Record(kRef) ? 1 : 0;
+    EXPECT_TRUE(Record(kOtherRef));
+  }
+  EXPECT_EQ(3u, recorded);
+  EXPECT_EQ(9u, sampling_.skipped_events());
+}
+
+TEST_F(TraceSamplingTest, SampleRate_ByTraceId) {
+  ASSERT_EQ(OkStatus(), sampling_.SetSampleRate(kRef, 2));
+
+  for (uint32_t id = 0; id < 4; ++id) {
+    const bool sampled = id % 2 == 0;
+    EXPECT_EQ(sampled,
+              sampling_.ShouldRecord(kRef, PW_TRACE_TYPE_ASYNC_START, id, 0));
+    EXPECT_EQ(sampled,
+              sampling_.ShouldRecord(kRef, PW_TRACE_TYPE_ASYNC_END, id, 0));
+  }
+}
+
+TEST_F(TraceSamplingTest, RateLimit_AllowsBurstThenRefills) {
+  ASSERT_EQ(OkStatus(), sampling_.SetRateLimit(kRef, 1, 3));
+
+  EXPECT_TRUE(Record(kRef, 10));
+  EXPECT_TRUE(Record(kRef, 10));
+  EXPECT_TRUE(Record(kRef, 10));
+  EXPECT_FALSE(Record(kRef, 10));
+
+  // One event per second.
+  EXPECT_TRUE(Record(kRef, 11));
+  EXPECT_FALSE(Record(kRef, 11));
+
+  // The bucket holds at most the burst.
+  EXPECT_TRUE(Record(kRef, 100));
+  EXPECT_TRUE(Record(kRef, 100));
+  EXPECT_TRUE(Record(kRef, 100));
+  EXPECT_FALSE(Record(kRef, 100));
+  EXPECT_EQ(3u, sampling_.skipped_events());
+}
+
+TEST_F(TraceSamplingTest, SampledOutEvents_DoNotUseRateLimit) {
+  ASSERT_EQ(OkStatus(), sampling_.SetSampleRate(kRef, 2));
+  ASSERT_EQ(OkStatus(), sampling_.SetRateLimit(kRef, 1, 2));
+
+  EXPECT_TRUE(Record(kRef));
+  EXPECT_FALSE(Record(kRef));
+  EXPECT_TRUE(Record(kRef));
+  EXPECT_FALSE(Record(kRef));
+  EXPECT_FALSE(Record(kRef));  // Sampled, but over the rate limit.
+}
+
+TEST_F(TraceSamplingTest, ClearRule) {
+  ASSERT_EQ(OkStatus(), sampling_.SetSampleRate(kRef, 100));
+  EXPECT_TRUE(Record(kRef));
+  EXPECT_FALSE(Record(kRef));
+
+  EXPECT_EQ(OkStatus(), sampling_.ClearRule(kRef));
+  EXPECT_FALSE(sampling_.HasRules());
+  EXPECT_TRUE(Record(kRef));
+  EXPECT_EQ(Status::NotFound(), sampling_.ClearRule(kRef));
+}
+
+TEST_F(TraceSamplingTest, DisablingBothLimits_RemovesRule) {
+  ASSERT_EQ(OkStatus(), sampling_.SetSampleRate(kRef, 2));
+  ASSERT_EQ(OkStatus(), sampling_.SetRateLimit(kRef, 1, 1));
+  ASSERT_EQ(OkStatus(), sampling_.SetSampleRate(kRef, 1));
+  EXPECT_TRUE(sampling_.HasRules());
+  ASSERT_EQ(OkStatus(), sampling_.SetRateLimit(kRef, 0, 0));
+  EXPECT_FALSE(sampling_.HasRules());
+}
+
+TEST_F(TraceSamplingTest, TooManyRules) {
+  for (uint32_t ref = 1; ref <= PW_TRACE_CONFIG_MAX_SAMPLING_RULES; ++ref) {
+    ASSERT_EQ(OkStatus(), sampling_.SetSampleRate(ref, 2));
+  }
+  EXPECT_EQ(Status::ResourceExhausted(), sampling_.SetSampleRate(kRef, 2));
+  EXPECT_EQ(Status::ResourceExhausted(), sampling_.SetRateLimit(kRef, 1, 1));
+
+  // Updating an existing rule still works.
+  EXPECT_EQ(OkStatus(), sampling_.SetRateLimit(1, 1, 1));
+
+  sampling_.ClearAllRules();
+  EXPECT_EQ(OkStatus(), sampling_.SetSampleRate(kRef, 2));
+}
+
+}  // namespace
+}  // namespace pw::trace
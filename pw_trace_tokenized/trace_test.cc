@@ -18,6 +18,7 @@
 #include "pw_trace/trace.h"
 #include "pw_trace_tokenized/trace_tokenized.h"
 #include "pw_trace_tokenized/trace_callback.h"
+#include "pw_trace_tokenized/trace_sampling.h"
 // clang-format on
 
 #include <deque>
@@ -26,9 +27,9 @@
 namespace {
 
 // Moving these to other lines will require updating the variables
-#define kTraceFunctionLine 32
-#define kTraceFunctionGroupLine 33
-#define kTraceFunctionIdLine 35
+#define kTraceFunctionLine 33
+#define kTraceFunctionGroupLine 34
+#define kTraceFunctionIdLine 36
 void TraceFunction() { PW_TRACE_FUNCTION(); }
 void TraceFunctionGroup() { PW_TRACE_FUNCTION("FunctionGroup"); }
 void TraceFunctionTraceId(uint32_t id) {
@@ -378,6 +379,34 @@ TEST(TokenizedTrace, SkipModule) {
   EXPECT_TRUE(test_interface.GetEvents().empty());
 }
 
+TEST(TokenizedTrace, SampleRate) {
+  TraceTestInterface test_interface;
+  const uint32_t trace_ref = PW_TRACE_REF(PW_TRACE_TYPE_INSTANT,
+                                          "TST",
+                                          "Sampled",
+                                          PW_TRACE_FLAGS_DEFAULT,
+                                          PW_TRACE_GROUP_LABEL_DEFAULT);
+  ASSERT_EQ(pw::trace::Sampling::Instance().SetSampleRate(trace_ref, 3),
+            pw::OkStatus());
+
+  for (int i = 0; i < 6; ++i) {
+    PW_TRACE_INSTANT("Sampled");
+    PW_TRACE_INSTANT("Test");
+  }
+  pw::trace::Sampling::Instance().ClearAllRules();
+
+  // Check results
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Sampled");
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Test");
+  }
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Sampled");
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Test");
+  }
+  EXPECT_TRUE(test_interface.GetEvents().empty());
+}
+
 TEST(TokenizedTrace, DisableBeforeTrace) {
   TraceTestInterface test_interface;
 
@@ -538,6 +567,26 @@ TEST(TokenizedTrace, Data) {
   EXPECT_TRUE(test_interface.GetEvents().empty());
 }
 
+TEST(TokenizedTrace, TimeCalibration) {
+  TraceTestInterface test_interface;
+
+  pw::trace::TokenizedTrace::Instance().EmitTimeCalibration();
+
+  // Check results
+  ASSERT_EQ(test_interface.GetEvents().size(), 1u);
+  const TraceTestInterface::TraceInfo& event =
+      test_interface.GetEvents().front();
+  const uint32_t calibration_ref =
+      PW_TRACE_REF_DATA(PW_TRACE_TYPE_INSTANT,
+                        "pw_trace",
+                        "time_calibration",
+                        PW_TRACE_FLAGS_DEFAULT,
+                        PW_TRACE_GROUP_LABEL_DEFAULT,
+                        "@pw_py_struct_fmt:<Q");
+  EXPECT_EQ(event.trace_ref, calibration_ref);
+  EXPECT_EQ(event.event_type, PW_TRACE_TYPE_INSTANT);
+}
+
 // Create some helper macros that generated some test trace data based from a
 // number, and can check that it is correct.
 constexpr std::byte kTestData[] = {
@@ -0,0 +1,109 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/internal/chunk.h"
+
+#include "pw_protobuf/decoder.h"
+#include "pw_status/try.h"
+#include "pw_transfer_proto/transfer.pwpb.h"
+
+namespace pw::transfer::internal {
+
+namespace ProtoChunk = ::pw::transfer::Chunk;
+
+Status DecodeChunk(ConstByteSpan message, Chunk& chunk) {
+  chunk = {};
+
+  protobuf::Decoder decoder(message);
+  Status status;
+  uint32_t value;
+
+  while ((status = decoder.Next()).ok()) {
+    switch (static_cast<ProtoChunk::Fields>(decoder.FieldNumber())) {
+      case ProtoChunk::Fields::TRANSFER_ID:
+        PW_TRY(decoder.ReadUint32(&chunk.transfer_id));
+        break;
+      case ProtoChunk::Fields::PENDING_BYTES:
+        PW_TRY(decoder.ReadUint32(&value));
+        chunk.pending_bytes = value;
+        break;
+      case ProtoChunk::Fields::MAX_CHUNK_SIZE_BYTES:
+        PW_TRY(decoder.ReadUint32(&value));
+        chunk.max_chunk_size_bytes = value;
+        break;
+      case ProtoChunk::Fields::OFFSET:
+        PW_TRY(decoder.ReadUint64(&chunk.offset));
+        break;
+      case ProtoChunk::Fields::DATA:
+        PW_TRY(decoder.ReadBytes(&chunk.data));
+        break;
+      case ProtoChunk::Fields::REMAINING_BYTES: {
+        uint64_t remaining;
+        PW_TRY(decoder.ReadUint64(&remaining));
+        chunk.remaining_bytes = remaining;
+        break;
+      }
+      case ProtoChunk::Fields::STATUS:
+        PW_TRY(decoder.ReadUint32(&value));
+        chunk.status = static_cast<Status::Code>(value);
+        break;
+      case ProtoChunk::Fields::TYPE:
+        PW_TRY(decoder.ReadUint32(&value));
+        chunk.type = static_cast<Chunk::Type>(value);
+        break;
+
+      // Ignore unknown fields, which may be added in later versions.
+    }
+  }
+
+  // The decoder returns OUT_OF_RANGE once the whole message is read.
+  return status == Status::OutOfRange() ? OkStatus() : Status::DataLoss();
+}
+
+Result<ConstByteSpan> EncodeChunk(const Chunk& chunk, ByteSpan buffer) {
+  protobuf::NestedEncoder encoder(buffer);
+  ProtoChunk::Encoder chunk_encoder(&encoder);
+
+  chunk_encoder.WriteTransferId(chunk.transfer_id);
+
+  if (chunk.type != Chunk::Type::kData) {
+    chunk_encoder.WriteType(static_cast<ProtoChunk::Type>(chunk.type));
+  }
+  if (chunk.pending_bytes.has_value()) {
+    chunk_encoder.WritePendingBytes(chunk.pending_bytes.value());
+  }
+  if (chunk.max_chunk_size_bytes.has_value()) {
+    chunk_encoder.WriteMaxChunkSizeBytes(chunk.max_chunk_size_bytes.value());
+  }
+  if (chunk.offset != 0u) {
+    chunk_encoder.WriteOffset(chunk.offset);
+  }
+  if (!chunk.data.empty()) {
+    chunk_encoder.WriteData(chunk.data);
+  }
+  if (chunk.remaining_bytes.has_value()) {
+    chunk_encoder.WriteRemainingBytes(chunk.remaining_bytes.value());
+  }
+  if (chunk.status.has_value()) {
+    chunk_encoder.WriteStatus(chunk.status.value().code());
+  }
+
+  Result<ConstByteSpan> result = encoder.Encode();
+  if (!result.ok()) {
+    return Status::ResourceExhausted();
+  }
+  return result;
+}
+
+}  // namespace pw::transfer::internal
@@ -0,0 +1,106 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/internal/chunk.h"
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+
+namespace pw::transfer::internal {
+namespace {
+
+TEST(Chunk, EncodeDecode_Data) {
+  constexpr auto kData = bytes::Array<1, 2, 3, 4>();
+
+  Chunk chunk;
+  chunk.transfer_id = 7;
+  chunk.offset = 4096;
+  chunk.data = kData;
+
+  std::byte buffer[32];
+  Result<ConstByteSpan> encoded = EncodeChunk(chunk, buffer);
+  ASSERT_EQ(OkStatus(), encoded.status());
+
+  Chunk decoded;
+  ASSERT_EQ(OkStatus(), DecodeChunk(encoded.value(), decoded));
+  EXPECT_EQ(7u, decoded.transfer_id);
+  EXPECT_EQ(Chunk::Type::kData, decoded.type);
+  EXPECT_EQ(4096u, decoded.offset);
+  ASSERT_EQ(kData.size(), decoded.data.size());
+  EXPECT_EQ(0, std::memcmp(kData.data(), decoded.data.data(), kData.size()));
+  EXPECT_FALSE(decoded.pending_bytes.has_value());
+  EXPECT_FALSE(decoded.remaining_bytes.has_value());
+  EXPECT_FALSE(decoded.status.has_value());
+}
+
+TEST(Chunk, EncodeDecode_Parameters) {
+  Chunk chunk;
+  chunk.transfer_id = 3;
+  chunk.type = Chunk::Type::kParametersContinue;
+  chunk.offset = 64;
+  chunk.pending_bytes = 512;
+  chunk.max_chunk_size_bytes = 128;
+
+  std::byte buffer[32];
+  Result<ConstByteSpan> encoded = EncodeChunk(chunk, buffer);
+  ASSERT_EQ(OkStatus(), encoded.status());
+
+  Chunk decoded;
+  ASSERT_EQ(OkStatus(), DecodeChunk(encoded.value(), decoded));
+  EXPECT_EQ(Chunk::Type::kParametersContinue, decoded.type);
+  EXPECT_EQ(64u, decoded.offset);
+  EXPECT_EQ(512u, decoded.pending_bytes.value());
+  EXPECT_EQ(128u, decoded.max_chunk_size_bytes.value());
+  EXPECT_TRUE(decoded.data.empty());
+}
+
+TEST(Chunk, EncodeDecode_ZeroValuedFieldsArePresent) {
+  Chunk chunk;
+  chunk.transfer_id = 1;
+  chunk.remaining_bytes = 0;
+  chunk.status = OkStatus();
+
+  std::byte buffer[16];
+  Result<ConstByteSpan> encoded = EncodeChunk(chunk, buffer);
+  ASSERT_EQ(OkStatus(), encoded.status());
+
+  Chunk decoded;
+  ASSERT_EQ(OkStatus(), DecodeChunk(encoded.value(), decoded));
+  EXPECT_EQ(0u, decoded.remaining_bytes.value());
+  EXPECT_EQ(OkStatus(), decoded.status.value());
+}
+
+TEST(Chunk, Encode_BufferTooSmall) {
+  constexpr auto kData = bytes::Array<1, 2, 3, 4, 5, 6, 7, 8>();
+
+  Chunk chunk;
+  chunk.transfer_id = 1;
+  chunk.data = kData;
+
+  std::byte buffer[8];
+  EXPECT_EQ(Status::ResourceExhausted(), EncodeChunk(chunk, buffer).status());
+}
+
+TEST(Chunk, Decode_Malformed) {
+  // A varint that does not terminate.
+  constexpr auto kMalformed = bytes::Array<0x08, 0xff>();
+
+  Chunk chunk;
+  EXPECT_EQ(Status::DataLoss(), DecodeChunk(kMalformed, chunk));
+}
+
+}  // namespace
+}  // namespace pw::transfer::internal
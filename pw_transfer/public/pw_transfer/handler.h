@@ -0,0 +1,150 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_containers/intrusive_list.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+
+namespace pw::transfer {
+
+class TransferService;
+
+namespace internal {
+
+// A resource that can be transferred, identified by its transfer ID. Handlers
+// are registered with a TransferService, which calls the Prepare and Finalize
+// functions at the start and end of each transfer. The handler also holds the
+// service's state for its transfer, so a transfer that is interrupted can be
+// resumed from where it stopped.
+class Handler : public IntrusiveList<Handler>::Item {
+ public:
+  virtual ~Handler() = default;
+
+  constexpr uint32_t id() const { return transfer_id_; }
+
+  // Called at the start of a read transfer, before the first data is read.
+  // Returns OK if the transfer may proceed; the status is sent to the client
+  // otherwise.
+  virtual Status PrepareRead() { return Status::PermissionDenied(); }
+
+  // Called at the end of a read transfer, with the status the client sent or
+  // the error that ended the transfer.
+  virtual void FinalizeRead(Status) {}
+
+  // Called at the start of a write transfer, before the first data is
+  // written. Returns OK if the transfer may proceed.
+  virtual Status PrepareWrite() { return Status::PermissionDenied(); }
+
+  // Called at the end of a write transfer. The status is OK if all of the data
+  // was written. Returns the status to send to the client; the handler can
+  // report an error here, for example if the data fails to verify.
+  virtual Status FinalizeWrite(Status status) { return status; }
+
+  // Moves the reader to the offset so that data can be sent again, for a
+  // client that lost data or resumes a read transfer. Readers that cannot seek
+  // return UNIMPLEMENTED, which ends the transfer.
+  virtual Status SeekReader(size_t) { return Status::Unimplemented(); }
+
+ protected:
+  constexpr Handler(uint32_t transfer_id,
+                    stream::Reader* reader,
+                    stream::Writer* writer)
+      : transfer_id_(transfer_id),
+        reader_(reader),
+        writer_(writer),
+        state_(State::kInactive),
+        offset_(0),
+        window_end_(0),
+        max_chunk_size_bytes_(0),
+        recovering_(false) {}
+
+  void set_reader(stream::Reader& reader) { reader_ = &reader; }
+  void set_writer(stream::Writer& writer) { writer_ = &writer; }
+
+ private:
+  friend class pw::transfer::TransferService;
+
+  enum class State : uint8_t { kInactive, kReading, kWriting };
+
+  uint32_t transfer_id_;
+  stream::Reader* reader_;
+  stream::Writer* writer_;
+
+  // State of the current transfer, managed by the TransferService. offset_ is
+  // the next offset to send in a read or to receive in a write; window_end_ is
+  // the end of the receiver's window.
+  State state_;
+  uint64_t offset_;
+  uint64_t window_end_;
+  uint32_t max_chunk_size_bytes_;
+
+  // Set when a write transfer has asked the client to retransmit, until the
+  // retransmitted data arrives.
+  bool recovering_;
+};
+
+}  // namespace internal
+
+// A resource that clients can read, but not write. Data is read from a
+// stream::Reader.
+class ReadOnlyHandler : public internal::Handler {
+ public:
+  constexpr ReadOnlyHandler(uint32_t transfer_id)
+      : internal::Handler(transfer_id, nullptr, nullptr) {}
+
+  constexpr ReadOnlyHandler(uint32_t transfer_id, stream::Reader& reader)
+      : internal::Handler(transfer_id, &reader, nullptr) {}
+
+  Status PrepareRead() override { return OkStatus(); }
+
+  using internal::Handler::set_reader;
+};
+
+// A resource that clients can write, but not read. Data is written to a
+// stream::Writer, such as a BlobStore::BlobWriter.
+class WriteOnlyHandler : public internal::Handler {
+ public:
+  constexpr WriteOnlyHandler(uint32_t transfer_id)
+      : internal::Handler(transfer_id, nullptr, nullptr) {}
+
+  constexpr WriteOnlyHandler(uint32_t transfer_id, stream::Writer& writer)
+      : internal::Handler(transfer_id, nullptr, &writer) {}
+
+  Status PrepareWrite() override { return OkStatus(); }
+
+  using internal::Handler::set_writer;
+};
+
+// A resource that clients can read and write.
+class ReadWriteHandler : public internal::Handler {
+ public:
+  constexpr ReadWriteHandler(uint32_t transfer_id)
+      : internal::Handler(transfer_id, nullptr, nullptr) {}
+
+  constexpr ReadWriteHandler(uint32_t transfer_id,
+                             stream::Reader& reader,
+                             stream::Writer& writer)
+      : internal::Handler(transfer_id, &reader, &writer) {}
+
+  Status PrepareRead() override { return OkStatus(); }
+  Status PrepareWrite() override { return OkStatus(); }
+
+  using internal::Handler::set_reader;
+  using internal::Handler::set_writer;
+};
+
+}  // namespace pw::transfer
@@ -0,0 +1,53 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include "pw_bytes/span.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+
+namespace pw::transfer::internal {
+
+// Decoded form of the pw.transfer.Chunk message. Optional fields are only
+// encoded if they are set.
+struct Chunk {
+  enum class Type : uint32_t {
+    kData = 0,
+    kStart = 1,
+    kParametersRetransmit = 2,
+    kParametersContinue = 3,
+  };
+
+  uint32_t transfer_id = 0;
+  Type type = Type::kData;
+  std::optional<uint32_t> pending_bytes;
+  std::optional<uint32_t> max_chunk_size_bytes;
+  uint64_t offset = 0;
+  ConstByteSpan data;
+  std::optional<uint64_t> remaining_bytes;
+  std::optional<Status> status;
+};
+
+// Decodes a chunk. The chunk's data refers to the message. Returns DATA_LOSS
+// if the message is not a valid chunk.
+Status DecodeChunk(ConstByteSpan message, Chunk& chunk);
+
+// Encodes a chunk into the buffer. Returns RESOURCE_EXHAUSTED if it does not
+// fit.
+Result<ConstByteSpan> EncodeChunk(const Chunk& chunk, ByteSpan buffer);
+
+}  // namespace pw::transfer::internal
@@ -0,0 +1,114 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_containers/intrusive_list.h"
+#include "pw_transfer/handler.h"
+#include "pw_transfer/internal/chunk.h"
+#include "pw_transfer_proto/transfer.raw_rpc.pb.h"
+
+namespace pw::transfer {
+
+// Serves reads and writes of the resources registered with it. Data is sent in
+// chunks, pipelined within a window of pending bytes that the receiver
+// advertises and slides forward as data arrives. Each chunk carries its offset,
+// so the receiver detects lost data and asks the sender to retransmit from the
+// last offset it received.
+//
+// Any number of transfers may be active at once. The state of each transfer is
+// kept in its handler, so a transfer survives the end of the RPC that carried
+// it and can be resumed on a new one.
+class TransferService : public generated::Transfer<TransferService> {
+ public:
+  // The transfer data buffer holds the data of a chunk read from a handler's
+  // reader, so it limits the size of the chunks sent in read transfers. It is
+  // also the largest chunk accepted in write transfers. max_pending_bytes is
+  // the window offered to clients in write transfers.
+  constexpr TransferService(ByteSpan transfer_data_buffer,
+                            uint32_t max_pending_bytes)
+      : read_stream_handler_(*this, Direction::kRead),
+        write_stream_handler_(*this, Direction::kWrite),
+        chunk_data_buffer_(transfer_data_buffer),
+        max_pending_bytes_(max_pending_bytes) {}
+
+  TransferService(const TransferService&) = delete;
+  TransferService& operator=(const TransferService&) = delete;
+
+  void Read(ServerContext&, RawServerReaderWriter& reader_writer);
+
+  void Write(ServerContext&, RawServerReaderWriter& reader_writer);
+
+  void RegisterHandler(internal::Handler& handler) {
+    handlers_.push_front(handler);
+  }
+
+  void UnregisterHandler(internal::Handler& handler) {
+    handlers_.remove(handler);
+  }
+
+ private:
+  enum class Direction : bool { kRead, kWrite };
+
+  // Passes the chunks of a Read or Write stream to the service.
+  class StreamHandler : public rpc::RawClientStreamHandler {
+   public:
+    constexpr StreamHandler(TransferService& service, Direction direction)
+        : service_(service), direction_(direction) {}
+
+    void ReceivedRequest(ConstByteSpan request) override;
+
+   private:
+    TransferService& service_;
+    Direction direction_;
+  };
+
+  void HandleReadChunk(const internal::Chunk& chunk);
+  void HandleWriteChunk(const internal::Chunk& chunk);
+
+  // Sends data chunks until the client's window is full or the data ends.
+  void SendReadWindow(internal::Handler& handler);
+
+  // Sends the window for a write transfer, starting at the handler's offset.
+  void SendWriteParameters(internal::Handler& handler,
+                           internal::Chunk::Type type);
+
+  // Ends a transfer with an error and reports it to the client.
+  void FinishRead(internal::Handler& handler, Status status);
+  void FinishWrite(internal::Handler& handler, Status status);
+
+  // Sends a chunk with only a transfer ID and a status.
+  void SendStatus(RawServerReaderWriter& stream,
+                  uint32_t transfer_id,
+                  Status status);
+
+  Status SendChunk(RawServerReaderWriter& stream,
+                   const internal::Chunk& chunk);
+
+  internal::Handler* FindHandler(uint32_t transfer_id);
+
+  IntrusiveList<internal::Handler> handlers_;
+
+  RawServerReaderWriter read_stream_;
+  RawServerReaderWriter write_stream_;
+  StreamHandler read_stream_handler_;
+  StreamHandler write_stream_handler_;
+
+  ByteSpan chunk_data_buffer_;
+  uint32_t max_pending_bytes_;
+};
+
+}  // namespace pw::transfer
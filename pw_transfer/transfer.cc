@@ -0,0 +1,304 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/transfer.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace pw::transfer {
+
+using internal::Chunk;
+using internal::Handler;
+
+void TransferService::Read(ServerContext&,
+                           RawServerReaderWriter& reader_writer) {
+  read_stream_ = std::move(reader_writer);
+  read_stream_.set_handler(read_stream_handler_);
+}
+
+void TransferService::Write(ServerContext&,
+                            RawServerReaderWriter& reader_writer) {
+  write_stream_ = std::move(reader_writer);
+  write_stream_.set_handler(write_stream_handler_);
+}
+
+void TransferService::StreamHandler::ReceivedRequest(ConstByteSpan request) {
+  Chunk chunk;
+
+  // Chunks that cannot be decoded are dropped. The transfer recovers as it
+  // would from a lost chunk.
+  if (!internal::DecodeChunk(request, chunk).ok()) {
+    return;
+  }
+
+  if (direction_ == Direction::kRead) {
+    service_.HandleReadChunk(chunk);
+  } else {
+    service_.HandleWriteChunk(chunk);
+  }
+}
+
+void TransferService::HandleReadChunk(const Chunk& chunk) {
+  Handler* handler = FindHandler(chunk.transfer_id);
+  if (handler == nullptr) {
+    SendStatus(read_stream_, chunk.transfer_id, Status::NotFound());
+    return;
+  }
+
+  // The client sends a status when it has received all of the data, or to
+  // abort the transfer.
+  if (chunk.status.has_value()) {
+    if (handler->state_ == Handler::State::kReading) {
+      handler->state_ = Handler::State::kInactive;
+      handler->FinalizeRead(chunk.status.value());
+    }
+    return;
+  }
+
+  const bool retransmit = chunk.type == Chunk::Type::kParametersRetransmit;
+
+  if (handler->state_ != Handler::State::kReading) {
+    Status status;
+    if (!retransmit || !chunk.pending_bytes.has_value()) {
+      status = Status::FailedPrecondition();
+    } else if (handler->state_ == Handler::State::kWriting) {
+      status = Status::Unavailable();
+    } else if (handler->reader_ == nullptr) {
+      status = Status::FailedPrecondition();
+    } else {
+      status = handler->PrepareRead();
+    }
+
+    if (!status.ok()) {
+      SendStatus(read_stream_, chunk.transfer_id, status);
+      return;
+    }
+
+    handler->state_ = Handler::State::kReading;
+    handler->offset_ = 0;
+  }
+
+  if (!chunk.pending_bytes.has_value()) {
+    FinishRead(*handler, Status::InvalidArgument());
+    return;
+  }
+
+  // A retransmit restarts the data from the client's offset. Data after the
+  // offset in a continue is still in flight, so it is not sent again.
+  if (retransmit && chunk.offset != handler->offset_) {
+    if (Status status = handler->SeekReader(chunk.offset); !status.ok()) {
+      FinishRead(*handler, status);
+      return;
+    }
+    handler->offset_ = chunk.offset;
+  }
+
+  handler->window_end_ = chunk.offset + chunk.pending_bytes.value();
+  handler->max_chunk_size_bytes_ = static_cast<uint32_t>(std::min<size_t>(
+      chunk.max_chunk_size_bytes.value_or(std::numeric_limits<uint32_t>::max()),
+      chunk_data_buffer_.size()));
+
+  if (handler->max_chunk_size_bytes_ == 0u) {
+    FinishRead(*handler, Status::InvalidArgument());
+    return;
+  }
+
+  SendReadWindow(*handler);
+}
+
+void TransferService::SendReadWindow(Handler& handler) {
+  while (handler.offset_ < handler.window_end_) {
+    const size_t chunk_size = static_cast<size_t>(
+        std::min<uint64_t>(handler.window_end_ - handler.offset_,
+                           handler.max_chunk_size_bytes_));
+
+    Chunk chunk;
+    chunk.transfer_id = handler.id();
+    chunk.offset = handler.offset_;
+
+    Result<ByteSpan> data =
+        handler.reader_->Read(chunk_data_buffer_.first(chunk_size));
+
+    if (data.status() == Status::OutOfRange()) {
+      // The transfer ends when the client acknowledges the end of the data
+      // with a status.
+      chunk.remaining_bytes = 0;
+      SendChunk(read_stream_, chunk);
+      return;
+    }
+
+    if (!data.ok()) {
+      FinishRead(handler, data.status());
+      return;
+    }
+
+    // Stop if the reader has no data yet. The client asks for more later.
+    if (data.value().empty()) {
+      return;
+    }
+
+    // The reader has moved past this data, so the offset advances even if the
+    // chunk is not sent. The client asks for it again when it sees the gap.
+    chunk.data = data.value();
+    handler.offset_ += data.value().size();
+
+    if (!SendChunk(read_stream_, chunk).ok()) {
+      return;
+    }
+  }
+}
+
+void TransferService::HandleWriteChunk(const Chunk& chunk) {
+  Handler* handler = FindHandler(chunk.transfer_id);
+  if (handler == nullptr) {
+    SendStatus(write_stream_, chunk.transfer_id, Status::NotFound());
+    return;
+  }
+
+  // A status from the client aborts the transfer.
+  if (chunk.status.has_value()) {
+    if (handler->state_ == Handler::State::kWriting) {
+      handler->state_ = Handler::State::kInactive;
+      handler->FinalizeWrite(chunk.status.value());
+    }
+    return;
+  }
+
+  if (chunk.type == Chunk::Type::kStart) {
+    if (handler->state_ != Handler::State::kWriting) {
+      Status status;
+      if (handler->state_ == Handler::State::kReading) {
+        status = Status::Unavailable();
+      } else if (handler->writer_ == nullptr) {
+        status = Status::FailedPrecondition();
+      } else {
+        status = handler->PrepareWrite();
+      }
+
+      if (!status.ok()) {
+        SendStatus(write_stream_, chunk.transfer_id, status);
+        return;
+      }
+
+      handler->state_ = Handler::State::kWriting;
+      handler->offset_ = 0;
+    }
+
+    // Starting a transfer that is already active resumes it from the last
+    // offset that was received.
+    handler->recovering_ = false;
+    SendWriteParameters(*handler, Chunk::Type::kParametersRetransmit);
+    return;
+  }
+
+  if (handler->state_ != Handler::State::kWriting) {
+    SendStatus(write_stream_, chunk.transfer_id, Status::FailedPrecondition());
+    return;
+  }
+
+  // A chunk past the expected offset means data was lost. The client is asked
+  // once to send again from the expected offset; the chunks it already sent
+  // are dropped until the retransmitted data arrives. Duplicates of data that
+  // was already received are also dropped.
+  if (chunk.offset != handler->offset_) {
+    if (chunk.offset > handler->offset_ && !handler->recovering_) {
+      handler->recovering_ = true;
+      SendWriteParameters(*handler, Chunk::Type::kParametersRetransmit);
+    }
+    return;
+  }
+
+  handler->recovering_ = false;
+
+  if (chunk.data.size() > handler->window_end_ - handler->offset_ ||
+      chunk.data.size() > chunk_data_buffer_.size()) {
+    FinishWrite(*handler, Status::OutOfRange());
+    return;
+  }
+
+  if (!chunk.data.empty()) {
+    if (Status status = handler->writer_->Write(chunk.data); !status.ok()) {
+      FinishWrite(*handler, status);
+      return;
+    }
+    handler->offset_ += chunk.data.size();
+  }
+
+  if (chunk.remaining_bytes == 0u) {
+    FinishWrite(*handler, OkStatus());
+    return;
+  }
+
+  // Slide the window once half of it is used, so the client keeps sending
+  // while the new parameters are on their way.
+  if (handler->window_end_ - handler->offset_ <= max_pending_bytes_ / 2) {
+    SendWriteParameters(*handler, Chunk::Type::kParametersContinue);
+  }
+}
+
+void TransferService::SendWriteParameters(Handler& handler, Chunk::Type type) {
+  handler.window_end_ = handler.offset_ + max_pending_bytes_;
+
+  Chunk parameters;
+  parameters.transfer_id = handler.id();
+  parameters.type = type;
+  parameters.offset = handler.offset_;
+  parameters.pending_bytes = max_pending_bytes_;
+  parameters.max_chunk_size_bytes =
+      static_cast<uint32_t>(chunk_data_buffer_.size());
+
+  SendChunk(write_stream_, parameters);
+}
+
+void TransferService::FinishRead(Handler& handler, Status status) {
+  handler.state_ = Handler::State::kInactive;
+  handler.FinalizeRead(status);
+  SendStatus(read_stream_, handler.id(), status);
+}
+
+void TransferService::FinishWrite(Handler& handler, Status status) {
+  handler.state_ = Handler::State::kInactive;
+  SendStatus(write_stream_, handler.id(), handler.FinalizeWrite(status));
+}
+
+void TransferService::SendStatus(RawServerReaderWriter& stream,
+                                 uint32_t transfer_id,
+                                 Status status) {
+  Chunk chunk;
+  chunk.transfer_id = transfer_id;
+  chunk.status = status;
+  SendChunk(stream, chunk);
+}
+
+Status TransferService::SendChunk(RawServerReaderWriter& stream,
+                                  const Chunk& chunk) {
+  Result<ConstByteSpan> encoded =
+      internal::EncodeChunk(chunk, stream.PayloadBuffer());
+  if (!encoded.ok()) {
+    return encoded.status();
+  }
+  return stream.Write(encoded.value());
+}
+
+Handler* TransferService::FindHandler(uint32_t transfer_id) {
+  auto handler = std::find_if(handlers_.begin(),
+                              handlers_.end(),
+                              [transfer_id](const Handler& h) {
+                                return h.id() == transfer_id;
+                              });
+  return handler == handlers_.end() ? nullptr : &(*handler);
+}
+
+}  // namespace pw::transfer
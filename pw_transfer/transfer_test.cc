@@ -0,0 +1,336 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/transfer.h"
+
+#include <array>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_rpc/raw_test_method_context.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::transfer {
+namespace {
+
+using internal::Chunk;
+
+// Sends chunks to the service and decodes the chunks it responds with.
+template <typename Context>
+class ChunkContext {
+ public:
+  ChunkContext(Context& context) : context_(context) { context_.call(); }
+
+  void Send(const Chunk& chunk) {
+    std::byte buffer[64];
+    Result<ConstByteSpan> encoded = internal::EncodeChunk(chunk, buffer);
+    ASSERT_EQ(OkStatus(), encoded.status());
+    ASSERT_EQ(OkStatus(), context_.SendClientStream(encoded.value()));
+  }
+
+  size_t responses() const { return context_.total_responses(); }
+
+  // Decodes the response at the index, counting from the most recent.
+  Chunk response(size_t from_last = 0) const {
+    const auto& responses = context_.responses();
+    Chunk chunk;
+    EXPECT_EQ(OkStatus(),
+              internal::DecodeChunk(responses[responses.size() - 1 - from_last],
+                                    chunk));
+    return chunk;
+  }
+
+ private:
+  Context& context_;
+};
+
+Chunk Parameters(uint32_t transfer_id,
+                 Chunk::Type type,
+                 uint64_t offset,
+                 uint32_t pending_bytes,
+                 uint32_t max_chunk_size_bytes = 8) {
+  Chunk chunk;
+  chunk.transfer_id = transfer_id;
+  chunk.type = type;
+  chunk.offset = offset;
+  chunk.pending_bytes = pending_bytes;
+  chunk.max_chunk_size_bytes = max_chunk_size_bytes;
+  return chunk;
+}
+
+Chunk Data(uint32_t transfer_id, uint64_t offset, ConstByteSpan data) {
+  Chunk chunk;
+  chunk.transfer_id = transfer_id;
+  chunk.offset = offset;
+  chunk.data = data;
+  return chunk;
+}
+
+Chunk StatusChunk(uint32_t transfer_id, Status status) {
+  Chunk chunk;
+  chunk.transfer_id = transfer_id;
+  chunk.status = status;
+  return chunk;
+}
+
+constexpr std::array<std::byte, 32> kData = [] {
+  std::array<std::byte, 32> data{};
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = std::byte(i);
+  }
+  return data;
+}();
+
+class TestReadHandler : public ReadOnlyHandler {
+ public:
+  TestReadHandler(uint32_t id, ConstByteSpan data)
+      : ReadOnlyHandler(id), reader_(data) {
+    set_reader(reader_);
+  }
+
+  void FinalizeRead(Status status) override {
+    finalized = true;
+    finalize_status = status;
+  }
+
+  bool finalized = false;
+  Status finalize_status;
+
+ private:
+  stream::MemoryReader reader_;
+};
+
+class ReadTransfer : public ::testing::Test {
+ protected:
+  ReadTransfer()
+      : handler_(3, kData),
+        context_(transfer_buffer_, 64),
+        chunks_(context_) {
+    context_.service().RegisterHandler(handler_);
+  }
+
+  std::array<std::byte, 16> transfer_buffer_;
+  TestReadHandler handler_;
+  PW_RAW_TEST_METHOD_CONTEXT(TransferService, Read, 10, 128) context_;
+  ChunkContext<decltype(context_)> chunks_;
+};
+
+TEST_F(ReadTransfer, SendsDataInWindow) {
+  chunks_.Send(Parameters(3, Chunk::Type::kParametersRetransmit, 0, 16));
+
+  ASSERT_EQ(2u, chunks_.responses());
+  Chunk first = chunks_.response(1);
+  EXPECT_EQ(3u, first.transfer_id);
+  EXPECT_EQ(0u, first.offset);
+  ASSERT_EQ(8u, first.data.size());
+  EXPECT_EQ(0, std::memcmp(first.data.data(), kData.data(), 8));
+
+  Chunk second = chunks_.response();
+  EXPECT_EQ(8u, second.offset);
+  ASSERT_EQ(8u, second.data.size());
+  EXPECT_EQ(0, std::memcmp(second.data.data(), &kData[8], 8));
+}
+
+TEST_F(ReadTransfer, Continue_SendsOnlyNewData) {
+  chunks_.Send(Parameters(3, Chunk::Type::kParametersRetransmit, 0, 16));
+  ASSERT_EQ(2u, chunks_.responses());
+
+  // The client has received the first chunk and slides the window forward.
+  chunks_.Send(Parameters(3, Chunk::Type::kParametersContinue, 8, 16));
+
+  ASSERT_EQ(3u, chunks_.responses());
+  EXPECT_EQ(16u, chunks_.response().offset);
+}
+
+TEST_F(ReadTransfer, EndOfData_WaitsForClientStatus) {
+  chunks_.Send(Parameters(3, Chunk::Type::kParametersRetransmit, 0, 64));
+
+  // Four data chunks, then a chunk marking the end of the data.
+  ASSERT_EQ(5u, chunks_.responses());
+  Chunk last = chunks_.response();
+  EXPECT_EQ(32u, last.offset);
+  EXPECT_TRUE(last.data.empty());
+  EXPECT_EQ(0u, last.remaining_bytes.value());
+  EXPECT_FALSE(handler_.finalized);
+
+  chunks_.Send(StatusChunk(3, OkStatus()));
+  EXPECT_TRUE(handler_.finalized);
+  EXPECT_EQ(OkStatus(), handler_.finalize_status);
+}
+
+TEST_F(ReadTransfer, RetransmitWithoutSeek_EndsTransfer) {
+  chunks_.Send(Parameters(3, Chunk::Type::kParametersRetransmit, 0, 16));
+  ASSERT_EQ(2u, chunks_.responses());
+
+  // The second chunk was lost.
+  chunks_.Send(Parameters(3, Chunk::Type::kParametersRetransmit, 8, 16));
+
+  ASSERT_EQ(3u, chunks_.responses());
+  EXPECT_EQ(Status::Unimplemented(), chunks_.response().status.value());
+  EXPECT_TRUE(handler_.finalized);
+  EXPECT_EQ(Status::Unimplemented(), handler_.finalize_status);
+}
+
+TEST_F(ReadTransfer, UnknownTransfer_SendsNotFound) {
+  chunks_.Send(Parameters(99, Chunk::Type::kParametersRetransmit, 0, 16));
+
+  ASSERT_EQ(1u, chunks_.responses());
+  EXPECT_EQ(99u, chunks_.response().transfer_id);
+  EXPECT_EQ(Status::NotFound(), chunks_.response().status.value());
+}
+
+class TestWriteHandler : public WriteOnlyHandler {
+ public:
+  TestWriteHandler(uint32_t id) : WriteOnlyHandler(id), writer_(buffer_) {
+    set_writer(writer_);
+  }
+
+  Status PrepareWrite() override { return prepare_status; }
+
+  Status FinalizeWrite(Status status) override {
+    finalized = true;
+    finalize_status = status;
+    return status;
+  }
+
+  ConstByteSpan written() const { return writer_.WrittenData(); }
+
+  Status prepare_status;
+  bool finalized = false;
+  Status finalize_status;
+
+ private:
+  std::array<std::byte, 64> buffer_ = {};
+  stream::MemoryWriter writer_;
+};
+
+class WriteTransfer : public ::testing::Test {
+ protected:
+  WriteTransfer()
+      : handler_(7), context_(transfer_buffer_, 16), chunks_(context_) {
+    context_.service().RegisterHandler(handler_);
+  }
+
+  void Start() {
+    Chunk start;
+    start.transfer_id = 7;
+    start.type = Chunk::Type::kStart;
+    chunks_.Send(start);
+  }
+
+  std::array<std::byte, 8> transfer_buffer_;
+  TestWriteHandler handler_;
+  PW_RAW_TEST_METHOD_CONTEXT(TransferService, Write, 10, 128) context_;
+  ChunkContext<decltype(context_)> chunks_;
+};
+
+TEST_F(WriteTransfer, Start_SendsParameters) {
+  Start();
+
+  ASSERT_EQ(1u, chunks_.responses());
+  Chunk parameters = chunks_.response();
+  EXPECT_EQ(7u, parameters.transfer_id);
+  EXPECT_EQ(Chunk::Type::kParametersRetransmit, parameters.type);
+  EXPECT_EQ(0u, parameters.offset);
+  EXPECT_EQ(16u, parameters.pending_bytes.value());
+  EXPECT_EQ(8u, parameters.max_chunk_size_bytes.value());
+}
+
+TEST_F(WriteTransfer, PrepareFails_SendsStatus) {
+  handler_.prepare_status = Status::PermissionDenied();
+  Start();
+
+  ASSERT_EQ(1u, chunks_.responses());
+  EXPECT_EQ(Status::PermissionDenied(), chunks_.response().status.value());
+}
+
+TEST_F(WriteTransfer, Data_SlidesWindowWhenHalfUsed) {
+  Start();
+
+  chunks_.Send(Data(7, 0, std::span(kData).first(4)));
+  EXPECT_EQ(1u, chunks_.responses());
+
+  chunks_.Send(Data(7, 4, std::span(kData).subspan(4, 4)));
+  ASSERT_EQ(2u, chunks_.responses());
+
+  Chunk parameters = chunks_.response();
+  EXPECT_EQ(Chunk::Type::kParametersContinue, parameters.type);
+  EXPECT_EQ(8u, parameters.offset);
+  EXPECT_EQ(16u, parameters.pending_bytes.value());
+}
+
+TEST_F(WriteTransfer, LastChunk_FinalizesAndSendsStatus) {
+  Start();
+
+  Chunk last = Data(7, 0, std::span(kData).first(6));
+  last.remaining_bytes = 0;
+  chunks_.Send(last);
+
+  EXPECT_TRUE(handler_.finalized);
+  EXPECT_EQ(OkStatus(), handler_.finalize_status);
+  ASSERT_EQ(6u, handler_.written().size());
+  EXPECT_EQ(0, std::memcmp(handler_.written().data(), kData.data(), 6));
+
+  ASSERT_EQ(2u, chunks_.responses());
+  EXPECT_EQ(OkStatus(), chunks_.response().status.value());
+}
+
+TEST_F(WriteTransfer, LostChunk_RequestsRetransmitOnce) {
+  Start();
+
+  chunks_.Send(Data(7, 0, std::span(kData).first(4)));
+  // The chunk at offset 4 is lost.
+  chunks_.Send(Data(7, 8, std::span(kData).subspan(8, 4)));
+  chunks_.Send(Data(7, 12, std::span(kData).subspan(12, 4)));
+
+  ASSERT_EQ(2u, chunks_.responses());
+  Chunk retransmit = chunks_.response();
+  EXPECT_EQ(Chunk::Type::kParametersRetransmit, retransmit.type);
+  EXPECT_EQ(4u, retransmit.offset);
+
+  chunks_.Send(Data(7, 4, std::span(kData).subspan(4, 4)));
+  ASSERT_EQ(8u, handler_.written().size());
+  EXPECT_EQ(0, std::memcmp(handler_.written().data(), kData.data(), 8));
+}
+
+TEST_F(WriteTransfer, StartWhileActive_ResumesFromOffset) {
+  Start();
+  chunks_.Send(Data(7, 0, std::span(kData).first(4)));
+
+  Start();
+
+  Chunk parameters = chunks_.response();
+  EXPECT_EQ(Chunk::Type::kParametersRetransmit, parameters.type);
+  EXPECT_EQ(4u, parameters.offset);
+  EXPECT_FALSE(handler_.finalized);
+}
+
+TEST_F(WriteTransfer, DataBeforeStart_SendsFailedPrecondition) {
+  chunks_.Send(Data(7, 0, std::span(kData).first(4)));
+
+  ASSERT_EQ(1u, chunks_.responses());
+  EXPECT_EQ(Status::FailedPrecondition(), chunks_.response().status.value());
+  EXPECT_TRUE(handler_.written().empty());
+}
+
+TEST_F(WriteTransfer, ClientStatus_AbortsTransfer) {
+  Start();
+  chunks_.Send(StatusChunk(7, Status::Cancelled()));
+
+  EXPECT_TRUE(handler_.finalized);
+  EXPECT_EQ(Status::Cancelled(), handler_.finalize_status);
+}
+
+}  // namespace
+}  // namespace pw::transfer
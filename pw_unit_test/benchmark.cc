@@ -0,0 +1,113 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_unit_test/benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace pw::unit_test {
+namespace {
+
+// Automatically chosen iterations stop doubling here.
+constexpr uint32_t kMaxIterations = uint32_t(1) << 30;
+
+uint64_t ToNanoseconds(BenchmarkState::Clock::duration duration) {
+  return uint64_t(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+}
+
+}  // namespace
+
+std::optional<BenchmarkState::Clock::duration> BenchmarkState::Run(
+    internal::BenchmarkFunction function, void* context, uint32_t iterations) {
+  BenchmarkState state(iterations);
+  function(context, state);
+  if (!state.completed_) {
+    return std::nullopt;
+  }
+  return state.elapsed_;
+}
+
+namespace internal {
+
+TestBenchmark RunBenchmark(const char* name,
+                           const BenchmarkOptions& options,
+                           BenchmarkFunction function,
+                           void* context) {
+  TestBenchmark benchmark = {
+      .name = name,
+      .iterations = options.iterations,
+      .repetitions = 0,
+      .min_ns = std::numeric_limits<uint64_t>::max(),
+      .mean_ns = 0,
+      .max_ns = 0,
+      .stddev_ns = 0,
+      .bytes_per_iteration = options.bytes_per_iteration,
+  };
+
+  const auto run = [&] {
+    return BenchmarkState::Run(function, context, benchmark.iterations);
+  };
+
+  // Calibration also warms up the benchmark.
+  if (benchmark.iterations == 0u) {
+    const uint64_t min_ns = uint64_t(options.min_repetition_time_us) * 1000;
+    for (benchmark.iterations = 1;; benchmark.iterations *= 2) {
+      const auto elapsed = run();
+      if (!elapsed.has_value()) {
+        return benchmark;
+      }
+      if (ToNanoseconds(elapsed.value()) >= min_ns ||
+          benchmark.iterations >= kMaxIterations) {
+        break;
+      }
+    }
+  }
+
+  for (uint32_t i = 0; i < options.warmup_repetitions; ++i) {
+    if (!run().has_value()) {
+      return benchmark;
+    }
+  }
+
+  double sum = 0;
+  double sum_of_squares = 0;
+  for (uint32_t i = 0; i < std::max(options.repetitions, 1u); ++i) {
+    const auto elapsed = run();
+    if (!elapsed.has_value()) {
+      benchmark.repetitions = 0;
+      return benchmark;
+    }
+    const uint64_t ns = ToNanoseconds(elapsed.value());
+    benchmark.min_ns = std::min(benchmark.min_ns, ns);
+    benchmark.max_ns = std::max(benchmark.max_ns, ns);
+    sum += double(ns);
+    sum_of_squares += double(ns) * double(ns);
+    benchmark.repetitions += 1;
+  }
+
+  const double mean = sum / benchmark.repetitions;
+  const double variance = sum_of_squares / benchmark.repetitions - mean * mean;
+  benchmark.mean_ns = uint64_t(mean + 0.5);
+  benchmark.stddev_ns = variance > 0 ? uint64_t(std::sqrt(variance) + 0.5) : 0;
+
+  Framework::Get().BenchmarkResult(benchmark);
+  return benchmark;
+}
+
+}  // namespace internal
+}  // namespace pw::unit_test
@@ -0,0 +1,148 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_unit_test/benchmark.h"
+
+#include <chrono>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace pw::unit_test {
+namespace {
+
+PW_BENCHMARK(Benchmark, DefaultOptions) {
+  uint32_t value = 0;
+  for (auto _ : state) {
+    value += 1;
+    DoNotOptimize(value);
+  }
+}
+
+PW_BENCHMARK_WITH_OPTIONS(Benchmark,
+                          WithOptions,
+                          BenchmarkOptions{
+                              .iterations = 100,
+                              .repetitions = 2,
+                          }) {
+  uint32_t value = 0;
+  for (auto _ : state) {
+    value += 1;
+    DoNotOptimize(value);
+  }
+  EXPECT_EQ(100u, value);
+}
+
+uint32_t calls;
+uint32_t iterations;
+
+void CountIterations(BenchmarkState& state) {
+  calls += 1;
+  for (auto _ : state) {
+    iterations += 1;
+  }
+}
+
+TEST(Benchmark, RunBenchmark_FixedIterations) {
+  calls = 0;
+  iterations = 0;
+  const TestBenchmark result = RunBenchmark("count",
+                                            BenchmarkOptions{
+                                                .iterations = 10,
+                                                .repetitions = 3,
+                                                .warmup_repetitions = 2,
+                                            },
+                                            CountIterations);
+  EXPECT_STREQ("count", result.name);
+  EXPECT_EQ(5u, calls);
+  EXPECT_EQ(50u, iterations);
+  EXPECT_EQ(10u, result.iterations);
+  EXPECT_EQ(3u, result.repetitions);
+  EXPECT_LE(result.min_ns, result.mean_ns);
+  EXPECT_LE(result.mean_ns, result.max_ns);
+}
+
+TEST(Benchmark, RunBenchmark_ChoosesIterations) {
+  calls = 0;
+  const TestBenchmark result = RunBenchmark("auto",
+                                            BenchmarkOptions{
+                                                .iterations = 0,
+                                                .repetitions = 2,
+                                                .warmup_repetitions = 0,
+                                                .min_repetition_time_us = 100,
+                                            },
+                                            CountIterations);
+  EXPECT_EQ(2u, result.repetitions);
+  EXPECT_GE(result.iterations, 1u);
+  EXPECT_EQ(0u, result.iterations & (result.iterations - 1));
+  EXPECT_GT(calls, 2u);
+}
+
+void BusyWait(std::chrono::microseconds duration) {
+  const auto start = BenchmarkState::Clock::now();
+  while (BenchmarkState::Clock::now() - start < duration) {
+  }
+}
+
+void PauseEachIteration(BenchmarkState& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    BusyWait(std::chrono::microseconds(2000));
+    state.ResumeTiming();
+  }
+}
+
+TEST(Benchmark, PauseTiming_ExcludesPausedWork) {
+  const TestBenchmark result = RunBenchmark("paused",
+                                            BenchmarkOptions{
+                                                .iterations = 3,
+                                                .repetitions = 1,
+                                                .warmup_repetitions = 0,
+                                            },
+                                            PauseEachIteration);
+  EXPECT_EQ(1u, result.repetitions);
+  EXPECT_LT(result.max_ns, 2'000'000u);
+}
+
+TEST(Benchmark, RunBenchmark_Lambda) {
+  for (uint32_t size : {4u, 16u}) {
+    uint32_t bytes = 0;
+    const TestBenchmark result = RunBenchmark("lambda",
+                                              BenchmarkOptions{
+                                                  .iterations = 10,
+                                                  .repetitions = 1,
+                                                  .warmup_repetitions = 0,
+                                                  .bytes_per_iteration = size,
+                                              },
+                                              [&](BenchmarkState& state) {
+                                                for (auto _ : state) {
+                                                  bytes += size;
+                                                }
+                                              });
+    EXPECT_EQ(1u, result.repetitions);
+    EXPECT_EQ(10 * size, bytes);
+    EXPECT_EQ(size, result.bytes_per_iteration);
+  }
+}
+
+void ReturnEarly(BenchmarkState&) {}
+
+TEST(Benchmark, RunBenchmark_LoopMustComplete) {
+  const TestBenchmark result =
+      RunBenchmark("early", BenchmarkOptions{}, ReturnEarly);
+  EXPECT_EQ(0u, result.repetitions);
+}
+
+}  // namespace
+}  // namespace pw::unit_test
@@ -23,6 +23,14 @@ void RegisterEventHandler(EventHandler* event_handler) {
   internal::Framework::Get().RegisterEventHandler(event_handler);
 }
 
+void RegisterMemoryMonitor(MemoryMonitor* memory_monitor) {
+  internal::Framework::Get().RegisterMemoryMonitor(memory_monitor);
+}
+
+TestMemoryUsage CurrentTestMemoryUsage() {
+  return internal::Framework::Get().CurrentMemoryUsage();
+}
+
 namespace internal {
 
 // Singleton instance of the unit test framework class.
@@ -75,7 +83,24 @@ void Framework::StartTest(const TestInfo& test) {
   }
 }
 
+void Framework::StartMemoryMonitor(const void* stack_top) {
+  if (memory_monitor_ != nullptr) {
+    memory_monitor_->TestCaseStart(stack_top);
+  }
+}
+
 void Framework::EndCurrentTest() {
+  if (memory_monitor_ != nullptr) {
+    // Stop measuring before dispatching events, so that the event handlers'
+    // own memory use is not attributed to the test.
+    const TestMemoryUsage memory_usage = memory_monitor_->Measure();
+    memory_monitor_->TestCaseEnd();
+    if (event_handler_ != nullptr) {
+      event_handler_->TestCaseMemoryUsage(current_test_->test_case(),
+                                          memory_usage);
+    }
+  }
+
   switch (current_result_) {
     case TestResult::kSuccess:
       run_tests_summary_.passed_tests++;
@@ -115,6 +140,19 @@ void Framework::ExpectationResult(const char* expression,
   event_handler_->TestCaseExpect(current_test_->test_case(), expectation);
 }
 
+void Framework::BenchmarkResult(const TestBenchmark& benchmark) {
+  if (event_handler_ != nullptr) {
+    event_handler_->TestCaseBenchmark(current_test_->test_case(), benchmark);
+  }
+}
+
+TestMemoryUsage Framework::CurrentMemoryUsage() const {
+  if (memory_monitor_ == nullptr || current_test_ == nullptr) {
+    return TestMemoryUsage{};
+  }
+  return memory_monitor_->Measure();
+}
+
 bool TestInfo::enabled() const {
   constexpr size_t kStringSize = sizeof("DISABLED_") - 1;
   return std::strncmp("DISABLED_", test_case().test_name, kStringSize) != 0 &&
@@ -79,6 +79,53 @@ void LoggingEventHandler::TestCaseExpect(const TestCase& test_case,
          expectation.evaluated_expression);
 }
 
+void LoggingEventHandler::TestCaseBenchmark(const TestCase&,
+                                            const TestBenchmark& benchmark) {
+  // Log times per iteration with one decimal place.
+  const auto tenths = [&benchmark](uint64_t ns) {
+    return static_cast<unsigned long long>(ns * 10 / benchmark.iterations);
+  };
+  PW_LOG_INFO(
+      "[ BENCHMARK] %s: %llu.%llu ns/iteration (min %llu.%llu, max %llu.%llu, "
+      "stddev %llu.%llu), %u repetitions of %u iterations",
+      benchmark.name,
+      tenths(benchmark.mean_ns) / 10,
+      tenths(benchmark.mean_ns) % 10,
+      tenths(benchmark.min_ns) / 10,
+      tenths(benchmark.min_ns) % 10,
+      tenths(benchmark.max_ns) / 10,
+      tenths(benchmark.max_ns) % 10,
+      tenths(benchmark.stddev_ns) / 10,
+      tenths(benchmark.stddev_ns) % 10,
+      static_cast<unsigned>(benchmark.repetitions),
+      static_cast<unsigned>(benchmark.iterations));
+
+  // Log the throughput in MB/s, which is bytes per microsecond, with one
+  // decimal place.
+  if (benchmark.bytes_per_iteration != 0u && benchmark.mean_ns != 0u) {
+    const auto tenths_mb_per_s = static_cast<unsigned long long>(
+        uint64_t(benchmark.bytes_per_iteration) * benchmark.iterations *
+        10'000 / benchmark.mean_ns);
+    PW_LOG_INFO("[ BENCHMARK] %s: %llu.%llu MB/s (%u bytes/iteration)",
+                benchmark.name,
+                tenths_mb_per_s / 10,
+                tenths_mb_per_s % 10,
+                static_cast<unsigned>(benchmark.bytes_per_iteration));
+  }
+}
+
+void LoggingEventHandler::TestCaseMemoryUsage(
+    const TestCase&, const TestMemoryUsage& memory_usage) {
+  PW_LOG_INFO(
+      "[  MEMORY  ] %u bytes of stack%s, %u heap allocations (%u bytes), "
+      "%u frees",
+      static_cast<unsigned>(memory_usage.stack_bytes),
+      memory_usage.stack_limit_reached ? " or more" : "",
+      static_cast<unsigned>(memory_usage.heap_allocations),
+      static_cast<unsigned>(memory_usage.heap_bytes_allocated),
+      static_cast<unsigned>(memory_usage.heap_frees));
+}
+
 void LoggingEventHandler::TestCaseDisabled(const TestCase& test) {
   PW_LOG_DEBUG("Skipping disabled test %s.%s", test.suite_name, test.test_name);
 }
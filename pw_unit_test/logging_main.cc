@@ -14,9 +14,16 @@
 
 #include "pw_unit_test/framework.h"
 #include "pw_unit_test/logging_event_handler.h"
+#include "pw_unit_test/memory_usage.h"
 
 int main() {
   pw::unit_test::LoggingEventHandler handler;
   pw::unit_test::RegisterEventHandler(&handler);
+
+#if PW_UNIT_TEST_STACK_PAINT_BYTES > 0
+  pw::unit_test::MemoryUsageMonitor memory_monitor(
+      PW_UNIT_TEST_STACK_PAINT_BYTES);
+  pw::unit_test::RegisterMemoryMonitor(&memory_monitor);
+#endif  // PW_UNIT_TEST_STACK_PAINT_BYTES > 0
   return RUN_ALL_TESTS();
 }
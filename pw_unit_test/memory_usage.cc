@@ -0,0 +1,123 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_unit_test/memory_usage.h"
+
+#include <cstdint>
+
+#include "pw_preprocessor/compiler.h"
+
+namespace pw::unit_test {
+namespace {
+
+constexpr uint8_t kStackPattern = 0x5e;
+
+// Bytes just below the painting function's frame which are left unpainted, so
+// that the painting function does not overwrite its own locals or spills.
+constexpr uintptr_t kStackGuardBytes = 256;
+
+// Paints the stack from begin up to the guard below this function's frame.
+// Returns the end of the painted region, which is begin if nothing was painted.
+// The stack below the frame is not in use, so it is not instrumented.
+PW_NO_INLINE PW_NO_SANITIZE("address") const std::byte* PaintStack(
+    const std::byte* begin) {
+  const uintptr_t end =
+      reinterpret_cast<uintptr_t>(__builtin_frame_address(0)) -
+      kStackGuardBytes;
+  if (reinterpret_cast<uintptr_t>(begin) >= end) {
+    return begin;
+  }
+
+  volatile uint8_t* bytes =
+      reinterpret_cast<volatile uint8_t*>(const_cast<std::byte*>(begin));
+  const size_t size_bytes = end - reinterpret_cast<uintptr_t>(begin);
+  for (size_t offset = 0; offset < size_bytes; ++offset) {
+    bytes[offset] = kStackPattern;
+  }
+  return reinterpret_cast<const std::byte*>(end);
+}
+
+// Returns the lowest byte in the painted region which no longer holds the
+// pattern, or end if the region is untouched.
+PW_NO_INLINE PW_NO_SANITIZE("address") const std::byte* FindDeepestUse(
+    const std::byte* begin, const std::byte* end) {
+  const volatile uint8_t* bytes =
+      reinterpret_cast<const volatile uint8_t*>(begin);
+  const size_t size_bytes = static_cast<size_t>(end - begin);
+  size_t offset = 0;
+  while (offset < size_bytes && bytes[offset] == kStackPattern) {
+    ++offset;
+  }
+  return begin + offset;
+}
+
+}  // namespace
+
+MemoryUsageMonitor::MemoryUsageMonitor(size_t stack_paint_bytes)
+    : stack_paint_bytes_(stack_paint_bytes) {
+  hooks_.allocated = &Allocated;
+  hooks_.freed = &Freed;
+  hooks_.context = this;
+}
+
+void MemoryUsageMonitor::TestCaseStart(const void* stack_top) {
+  stack_top_ = static_cast<const std::byte*>(stack_top);
+  painted_begin_ = stack_top_;
+  painted_end_ = stack_top_;
+  if (stack_paint_bytes_ != 0u &&
+      reinterpret_cast<uintptr_t>(stack_top_) > stack_paint_bytes_) {
+    painted_begin_ = stack_top_ - stack_paint_bytes_;
+    painted_end_ = PaintStack(painted_begin_);
+  }
+
+  heap_allocations_.store(0, std::memory_order_relaxed);
+  heap_frees_.store(0, std::memory_order_relaxed);
+  heap_bytes_allocated_.store(0, std::memory_order_relaxed);
+  pw_MallocSetHooks(&hooks_);
+}
+
+TestMemoryUsage MemoryUsageMonitor::Measure() const {
+  TestMemoryUsage usage = {};
+
+  if (painted_begin_ != stack_top_) {
+    // The stack above the painted region was in use while painting, so at
+    // least the distance from the top to the painted region is reported. If
+    // nothing could be painted, the whole region counts as used.
+    const std::byte* deepest = FindDeepestUse(painted_begin_, painted_end_);
+    usage.stack_bytes = static_cast<uint32_t>(stack_top_ - deepest);
+    usage.stack_limit_reached = deepest == painted_begin_;
+  }
+
+  usage.heap_allocations = heap_allocations_.load(std::memory_order_relaxed);
+  usage.heap_frees = heap_frees_.load(std::memory_order_relaxed);
+  usage.heap_bytes_allocated =
+      heap_bytes_allocated_.load(std::memory_order_relaxed);
+  return usage;
+}
+
+void MemoryUsageMonitor::TestCaseEnd() { pw_MallocSetHooks(nullptr); }
+
+void MemoryUsageMonitor::Allocated(void* context, void*, size_t size_bytes) {
+  MemoryUsageMonitor& monitor = *static_cast<MemoryUsageMonitor*>(context);
+  monitor.heap_allocations_.fetch_add(1, std::memory_order_relaxed);
+  monitor.heap_bytes_allocated_.fetch_add(static_cast<uint32_t>(size_bytes),
+                                          std::memory_order_relaxed);
+}
+
+void MemoryUsageMonitor::Freed(void* context, void*) {
+  static_cast<MemoryUsageMonitor*>(context)->heap_frees_.fetch_add(
+      1, std::memory_order_relaxed);
+}
+
+}  // namespace pw::unit_test
@@ -0,0 +1,136 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_unit_test/memory_usage.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "pw_preprocessor/compiler.h"
+
+namespace pw::unit_test {
+namespace {
+
+// Writes to size_bytes bytes of stack. The stack is allocated with alloca so
+// that it stays on the stack even when sanitizers move local arrays elsewhere.
+PW_NO_INLINE void UseStack(size_t size_bytes) {
+  volatile uint8_t* buffer =
+      static_cast<volatile uint8_t*>(__builtin_alloca(size_bytes));
+  for (size_t i = 0; i < size_bytes; ++i) {
+    buffer[i] = static_cast<uint8_t>(i);
+  }
+}
+
+int allocation;
+
+TEST(MemoryUsageMonitor, Stack_MeasuresDeepestUse) {
+  MemoryUsageMonitor monitor(8192);
+  monitor.TestCaseStart(__builtin_frame_address(0));
+  UseStack(1024);
+  const TestMemoryUsage usage = monitor.Measure();
+  monitor.TestCaseEnd();
+
+  EXPECT_GE(usage.stack_bytes, 1024u);
+  EXPECT_LT(usage.stack_bytes, 8192u);
+  EXPECT_FALSE(usage.stack_limit_reached);
+}
+
+TEST(MemoryUsageMonitor, Stack_DeeperUseMeasuresMore) {
+  MemoryUsageMonitor monitor(8192);
+  monitor.TestCaseStart(__builtin_frame_address(0));
+  UseStack(512);
+  const uint32_t shallow = monitor.Measure().stack_bytes;
+  UseStack(4096);
+  const uint32_t deep = monitor.Measure().stack_bytes;
+  monitor.TestCaseEnd();
+
+  EXPECT_GE(deep, shallow + 4096u - 512u);
+}
+
+TEST(MemoryUsageMonitor, Stack_LimitReached) {
+  MemoryUsageMonitor monitor(1024);
+  monitor.TestCaseStart(__builtin_frame_address(0));
+  UseStack(2048);
+  const TestMemoryUsage usage = monitor.Measure();
+  monitor.TestCaseEnd();
+
+  EXPECT_EQ(usage.stack_bytes, 1024u);
+  EXPECT_TRUE(usage.stack_limit_reached);
+}
+
+TEST(MemoryUsageMonitor, Stack_NotMeasuredWithoutPainting) {
+  MemoryUsageMonitor monitor(0);
+  monitor.TestCaseStart(__builtin_frame_address(0));
+  UseStack(1024);
+  const TestMemoryUsage usage = monitor.Measure();
+  monitor.TestCaseEnd();
+
+  EXPECT_EQ(usage.stack_bytes, 0u);
+  EXPECT_FALSE(usage.stack_limit_reached);
+}
+
+TEST(MemoryUsageMonitor, Heap_CountsAllocationsAndFrees) {
+  MemoryUsageMonitor monitor(0);
+  monitor.TestCaseStart(__builtin_frame_address(0));
+  pw_MallocHookAllocated(&allocation, 16);
+  pw_MallocHookAllocated(&allocation, 8);
+  pw_MallocHookFreed(&allocation);
+  const TestMemoryUsage usage = monitor.Measure();
+  monitor.TestCaseEnd();
+
+  EXPECT_EQ(usage.heap_allocations, 2u);
+  EXPECT_EQ(usage.heap_bytes_allocated, 24u);
+  EXPECT_EQ(usage.heap_frees, 1u);
+}
+
+TEST(MemoryUsageMonitor, Heap_CountsOnlyDuringTestCase) {
+  MemoryUsageMonitor monitor(0);
+  monitor.TestCaseStart(__builtin_frame_address(0));
+  pw_MallocHookAllocated(&allocation, 16);
+  monitor.TestCaseEnd();
+  pw_MallocHookAllocated(&allocation, 16);
+  EXPECT_EQ(monitor.Measure().heap_allocations, 1u);
+
+  monitor.TestCaseStart(__builtin_frame_address(0));
+  EXPECT_EQ(monitor.Measure().heap_allocations, 0u);
+  EXPECT_EQ(monitor.Measure().heap_bytes_allocated, 0u);
+  monitor.TestCaseEnd();
+}
+
+class FixedMemoryMonitor : public MemoryMonitor {
+ public:
+  void TestCaseStart(const void*) override {}
+  TestMemoryUsage Measure() const override {
+    TestMemoryUsage usage = {};
+    usage.stack_bytes = 123;
+    usage.heap_allocations = 4;
+    return usage;
+  }
+  void TestCaseEnd() override {}
+};
+
+TEST(MemoryUsageMonitor, CurrentTestMemoryUsage_UsesRegisteredMonitor) {
+  FixedMemoryMonitor monitor;
+  RegisterMemoryMonitor(&monitor);
+  const TestMemoryUsage usage = CurrentTestMemoryUsage();
+  RegisterMemoryMonitor(nullptr);
+
+  EXPECT_EQ(usage.stack_bytes, 123u);
+  EXPECT_EQ(usage.heap_allocations, 4u);
+  EXPECT_EQ(CurrentTestMemoryUsage().stack_bytes, 0u);
+}
+
+}  // namespace
+}  // namespace pw::unit_test
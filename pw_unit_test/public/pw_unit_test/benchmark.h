@@ -0,0 +1,221 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include "pw_chrono/high_resolution_clock.h"
+#include "pw_preprocessor/concat.h"
+#include "pw_unit_test/event_handler.h"
+#include "pw_unit_test/framework.h"
+
+// Defines a test case which benchmarks the loop over its state, with the
+// default BenchmarkOptions. The statistics are reported through the registered
+// event handler, alongside the test's other results.
+//
+//   PW_BENCHMARK(Varint, Encode) {
+//     std::byte buffer[10];
+//     for (auto _ : state) {
+//       pw::unit_test::DoNotOptimize(pw::varint::Encode(1234567, buffer));
+//     }
+//   }
+//
+// The test case fails if the body returns before its loop completes.
+#define PW_BENCHMARK(test_suite_name, benchmark_name) \
+  PW_BENCHMARK_WITH_OPTIONS(                          \
+      test_suite_name, benchmark_name, ::pw::unit_test::BenchmarkOptions())
+
+// Defines a benchmark with options, which follow the names as an expression of
+// type BenchmarkOptions:
+//
+//   PW_BENCHMARK_WITH_OPTIONS(Varint,
+//                             Encode,
+//                             pw::unit_test::BenchmarkOptions{
+//                                 .iterations = 1000,
+//                                 .repetitions = 10,
+//                             }) {
+//     ...
+//   }
+//
+#define PW_BENCHMARK_WITH_OPTIONS(test_suite_name, benchmark_name, ...)    \
+  static void _PW_BENCHMARK_FUNCTION(test_suite_name, benchmark_name)(     \
+      ::pw::unit_test::BenchmarkState & state);                            \
+                                                                           \
+  PW_TEST(test_suite_name, benchmark_name) {                               \
+    if (::pw::unit_test::RunBenchmark(                                     \
+            #benchmark_name,                                               \
+            __VA_ARGS__,                                                   \
+            _PW_BENCHMARK_FUNCTION(test_suite_name, benchmark_name))       \
+            .repetitions == 0u) {                                          \
+      _PW_TEST_MESSAGE("The benchmark loop runs to completion",            \
+                       "The benchmark returned before its loop completed", \
+                       false);                                             \
+    }                                                                      \
+  }                                                                        \
+                                                                           \
+  static void _PW_BENCHMARK_FUNCTION(test_suite_name, benchmark_name)(     \
+      [[maybe_unused]] ::pw::unit_test::BenchmarkState & state)
+
+#define _PW_BENCHMARK_FUNCTION(test_suite_name, benchmark_name) \
+  PW_CONCAT(test_suite_name, _, benchmark_name, _Benchmark)
+
+namespace pw::unit_test {
+
+struct BenchmarkOptions {
+  // Iterations of the loop in each repetition. If 0, the iterations are
+  // doubled, starting from 1, until a repetition takes at least
+  // min_repetition_time_us.
+  uint32_t iterations = 0;
+
+  // Timed repetitions, from which the statistics are calculated.
+  uint32_t repetitions = 5;
+
+  // Untimed repetitions which run first, to warm up caches and branch
+  // predictors.
+  uint32_t warmup_repetitions = 1;
+
+  // The shortest repetition when the iterations are chosen automatically.
+  uint32_t min_repetition_time_us = 10000;
+
+  // Bytes processed by each iteration, such as the size of a buffer being
+  // encoded. If set, the throughput is reported as well as the times.
+  uint32_t bytes_per_iteration = 0;
+};
+
+class BenchmarkState;
+
+namespace internal {
+
+using BenchmarkFunction = void (*)(void* context, BenchmarkState& state);
+
+TestBenchmark RunBenchmark(const char* name,
+                           const BenchmarkOptions& options,
+                           BenchmarkFunction function,
+                           void* context);
+
+}  // namespace internal
+
+// The state of a benchmark's repetition, over which its body loops. Only the
+// loop is timed; setup before it and checks after it are not.
+class BenchmarkState {
+ public:
+  using Clock = chrono::HighResolutionClock;
+
+  // Iterating over the state yields Values, which are unused. The destructor
+  // keeps compilers from warning that the loop variable is unused.
+  struct Value {
+    ~Value() {}
+  };
+
+  class Iterator {
+   public:
+    Value operator*() const { return {}; }
+
+    Iterator& operator++() {
+      remaining_ -= 1;
+      return *this;
+    }
+
+    // Stops the timer when the iterations are complete.
+    bool operator!=(const Iterator&) {
+      if (remaining_ != 0u) {
+        return true;
+      }
+      state_->Finish();
+      return false;
+    }
+
+   private:
+    friend class BenchmarkState;
+
+    constexpr Iterator(BenchmarkState* state, uint32_t remaining)
+        : state_(state), remaining_(remaining) {}
+
+    BenchmarkState* state_;
+    uint32_t remaining_;
+  };
+
+  BenchmarkState(const BenchmarkState&) = delete;
+  BenchmarkState& operator=(const BenchmarkState&) = delete;
+
+  // Starts the timer.
+  Iterator begin() {
+    start_ = Clock::now();
+    return Iterator(this, iterations_);
+  }
+
+  Iterator end() { return Iterator(this, 0); }
+
+  // Excludes work within the loop, such as resetting an input, from the time.
+  void PauseTiming() { elapsed_ += Clock::now() - start_; }
+  void ResumeTiming() { start_ = Clock::now(); }
+
+  // The iterations in this repetition.
+  uint32_t iterations() const { return iterations_; }
+
+ private:
+  friend TestBenchmark internal::RunBenchmark(
+      const char* name,
+      const BenchmarkOptions& options,
+      internal::BenchmarkFunction function,
+      void* context);
+
+  explicit constexpr BenchmarkState(uint32_t iterations)
+      : iterations_(iterations) {}
+
+  // Runs one repetition and returns how long its loop took, or std::nullopt if
+  // the loop did not complete.
+  static std::optional<Clock::duration> Run(
+      internal::BenchmarkFunction function, void* context, uint32_t iterations);
+
+  void Finish() {
+    elapsed_ += Clock::now() - start_;
+    completed_ = true;
+  }
+
+  uint32_t iterations_;
+  bool completed_ = false;
+  Clock::time_point start_;
+  Clock::duration elapsed_ = Clock::duration(0);
+};
+
+// Runs a benchmark within the current test case and reports its statistics
+// through the event handler. The function is called with a BenchmarkState for
+// each repetition; it may be a lambda that captures the benchmark's inputs, so
+// one test case can run a benchmark for each of several inputs. Returns the
+// statistics, or statistics with 0 repetitions if the function returned before
+// its loop completed.
+template <typename Function>
+TestBenchmark RunBenchmark(const char* name,
+                           const BenchmarkOptions& options,
+                           Function&& function) {
+  auto call = [&function](BenchmarkState& state) { function(state); };
+  return internal::RunBenchmark(
+      name,
+      options,
+      [](void* context, BenchmarkState& state) {
+        (*static_cast<decltype(call)*>(context))(state);
+      },
+      &call);
+}
+
+// Prevents the compiler from optimizing away the computation of a value which
+// a benchmark does not otherwise use.
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}  // namespace pw::unit_test
@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <cstdint>
+
 namespace pw {
 namespace unit_test {
 
@@ -78,6 +80,47 @@ struct TestExpectation {
   bool success;
 };
 
+// Statistics from a benchmark run by a test case. Each repetition times the
+// same number of iterations of the benchmark's loop. The durations are of whole
+// repetitions, so the time per iteration is the duration divided by iterations.
+struct TestBenchmark {
+  // Name of the benchmark.
+  const char* name;
+
+  // Timed iterations in each repetition.
+  uint32_t iterations;
+
+  // Number of timed repetitions.
+  uint32_t repetitions;
+
+  // The shortest, mean, and longest repetition, and the standard deviation of
+  // the repetitions, in nanoseconds.
+  uint64_t min_ns;
+  uint64_t mean_ns;
+  uint64_t max_ns;
+  uint64_t stddev_ns;
+
+  // Bytes processed by each iteration, or 0 if the benchmark did not set it.
+  uint32_t bytes_per_iteration;
+};
+
+// The stack and heap used by a test case, measured by a MemoryMonitor.
+struct TestMemoryUsage {
+  // The deepest stack used by the test case, in bytes. This includes a small,
+  // fixed overhead from the framework's own calls.
+  uint32_t stack_bytes;
+
+  // True if the test case used all of the stack that the monitor painted, in
+  // which case stack_bytes is only a lower bound.
+  bool stack_limit_reached;
+
+  // The number of heap allocations and frees made by the test case, and the
+  // total bytes it allocated.
+  uint32_t heap_allocations;
+  uint32_t heap_frees;
+  uint32_t heap_bytes_allocated;
+};
+
 struct RunTestsSummary {
   // The number of passed tests among the run tests.
   int passed_tests;
@@ -113,6 +156,13 @@ class EventHandler {
   // result of the expectation.
   virtual void TestCaseExpect(const TestCase& test_case,
                               const TestExpectation& expectation) = 0;
+
+  // Called when a benchmark within a test case completes.
+  virtual void TestCaseBenchmark(const TestCase&, const TestBenchmark&) {}
+
+  // Called before TestCaseEnd with the memory used by the test case, if a
+  // MemoryMonitor is registered.
+  virtual void TestCaseMemoryUsage(const TestCase&, const TestMemoryUsage&) {}
 };
 
 // Sets the event handler for a test run. Must be called before RUN_ALL_TESTS()
@@ -141,6 +141,37 @@ StatusWithSize UnknownTypeToString(const T& value, std::span<char> buffer) {
 
 namespace unit_test {
 
+// Measures the stack and heap that each test case uses. A MemoryMonitor is
+// called around each test case; see pw_unit_test/memory_usage.h for the
+// standard implementation.
+class MemoryMonitor {
+ public:
+  virtual ~MemoryMonitor() = default;
+
+  // Called before each test case is constructed. stack_top is the address of
+  // the frame from which the test case runs.
+  virtual void TestCaseStart(const void* stack_top) = 0;
+
+  // Returns the memory used by the current test case so far.
+  virtual TestMemoryUsage Measure() const = 0;
+
+  // Called after each test case is destroyed, before its memory use is
+  // reported.
+  virtual void TestCaseEnd() = 0;
+};
+
+// Sets the monitor which measures the memory used by each test case. Must be
+// called before RUN_ALL_TESTS(). Pass nullptr to stop measuring.
+void RegisterMemoryMonitor(MemoryMonitor* memory_monitor);
+
+// Returns the memory used by the current test case so far, so that tests may
+// check it against a budget:
+//
+//   EXPECT_LE(pw::unit_test::CurrentTestMemoryUsage().stack_bytes, 1024u);
+//
+// Returns all zeroes if no MemoryMonitor is registered.
+TestMemoryUsage CurrentTestMemoryUsage();
+
 class Test;
 
 namespace internal {
@@ -158,6 +189,7 @@ class Framework {
         run_tests_summary_{.passed_tests = 0, .failed_tests = 0},
         exit_status_(0),
         event_handler_(nullptr),
+        memory_monitor_(nullptr),
         memory_pool_() {}
 
   static Framework& Get() { return framework_; }
@@ -172,6 +204,11 @@ class Framework {
     event_handler_ = event_handler;
   }
 
+  // Sets the monitor which measures the memory used by each test case.
+  void RegisterMemoryMonitor(MemoryMonitor* memory_monitor) {
+    memory_monitor_ = memory_monitor;
+  }
+
   // Runs all registered test cases, returning a status of 0 if all succeeded or
   // nonzero if there were any failures. Test events that occur during the run
   // are sent to the registered event handler, if any.
@@ -201,6 +238,9 @@ class Framework {
     // uninitialized memory.
     std::memset(&framework.memory_pool_, 0xa5, sizeof(framework.memory_pool_));
 
+    // Begin measuring memory use once the test is about to be constructed.
+    framework.StartMemoryMonitor(__builtin_frame_address(0));
+
     // Construct the test object within the static memory pool. The StartTest
     // function has already been called by the TestInfo at this point.
     TestInstance* test_instance = new (&framework.memory_pool_) TestInstance;
@@ -251,10 +291,21 @@ class Framework {
                          int line,
                          bool success);
 
+  // Dispatches an event with the statistics of a benchmark which the current
+  // test case ran.
+  void BenchmarkResult(const TestBenchmark& benchmark);
+
+  // Returns the memory used by the current test case so far.
+  TestMemoryUsage CurrentMemoryUsage() const;
+
  private:
   // Sets current_test_ and dispatches an event indicating that a test started.
   void StartTest(const TestInfo& test);
 
+  // Starts measuring the memory used by the current test case, if a monitor is
+  // registered.
+  void StartMemoryMonitor(const void* stack_top);
+
   // Dispatches event indicating that a test finished and clears current_test_.
   void EndCurrentTest();
 
@@ -280,6 +331,9 @@ class Framework {
   // Handler to which to dispatch test events.
   EventHandler* event_handler_;
 
+  // Monitor which measures the memory used by each test case, if any.
+  MemoryMonitor* memory_monitor_;
+
   // Memory region in which to construct test case classes as they are run.
   // TODO(frolv): Make the memory pool size configurable.
   static constexpr size_t kTestMemoryPoolSizeBytes = 16384;
@@ -33,6 +33,10 @@ class RpcEventHandler : public EventHandler {
   void TestCaseExpect(const TestCase& test_case,
                       const TestExpectation& expectation) override;
   void TestCaseDisabled(const TestCase& test_case) override;
+  void TestCaseBenchmark(const TestCase& test_case,
+                         const TestBenchmark& benchmark) override;
+  void TestCaseMemoryUsage(const TestCase& test_case,
+                           const TestMemoryUsage& memory_usage) override;
 
  private:
   UnitTestService& service_;
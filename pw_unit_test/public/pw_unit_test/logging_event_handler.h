@@ -31,6 +31,10 @@ class LoggingEventHandler : public EventHandler {
   void TestCaseExpect(const TestCase& test_case,
                       const TestExpectation& expectation) override;
   void TestCaseDisabled(const TestCase& test_case) override;
+  void TestCaseBenchmark(const TestCase& test_case,
+                         const TestBenchmark& benchmark) override;
+  void TestCaseMemoryUsage(const TestCase& test_case,
+                           const TestMemoryUsage& memory_usage) override;
 
  private:
   bool verbose_;
@@ -0,0 +1,82 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_malloc/hooks.h"
+#include "pw_unit_test/event_handler.h"
+#include "pw_unit_test/framework.h"
+
+// The stack, in bytes, which the standard unit test main functions paint to
+// measure each test case's memory use. 0 disables measurement.
+#ifndef PW_UNIT_TEST_STACK_PAINT_BYTES
+#define PW_UNIT_TEST_STACK_PAINT_BYTES 0
+#endif  // PW_UNIT_TEST_STACK_PAINT_BYTES
+
+namespace pw::unit_test {
+
+// Measures the stack and heap used by each test case.
+//
+// Stack use is measured by painting a region of stack below the test case's
+// frame with a pattern before the test runs, and finding the deepest byte that
+// the test overwrote. Only stack_paint_bytes bytes are painted, so deeper stack
+// use is not measured; TestMemoryUsage::stack_limit_reached is set if the whole
+// region was used. The stack must grow downward and have room for the painted
+// region. Under AddressSanitizer, stack variables may be moved off the stack,
+// so the measured stack use is not meaningful.
+//
+// Heap use is counted through the pw_malloc hooks, so it is only measured on
+// targets whose malloc is provided by a pw_malloc backend. While a test runs,
+// the monitor replaces any other pw_malloc hooks.
+//
+// To measure memory use, register a monitor in the test's main() before
+// RUN_ALL_TESTS():
+//
+//   pw::unit_test::MemoryUsageMonitor monitor(/*stack_paint_bytes=*/4096);
+//   pw::unit_test::RegisterMemoryMonitor(&monitor);
+//
+class MemoryUsageMonitor final : public MemoryMonitor {
+ public:
+  explicit MemoryUsageMonitor(size_t stack_paint_bytes);
+
+  MemoryUsageMonitor(const MemoryUsageMonitor&) = delete;
+  MemoryUsageMonitor& operator=(const MemoryUsageMonitor&) = delete;
+
+  void TestCaseStart(const void* stack_top) override;
+
+  TestMemoryUsage Measure() const override;
+
+  void TestCaseEnd() override;
+
+ private:
+  static void Allocated(void* context, void* ptr, size_t size_bytes);
+  static void Freed(void* context, void* ptr);
+
+  const size_t stack_paint_bytes_;
+  pw_MallocHooks hooks_;
+
+  // The frame of the test case and the painted region below it.
+  const std::byte* stack_top_ = nullptr;
+  const std::byte* painted_begin_ = nullptr;
+  const std::byte* painted_end_ = nullptr;
+
+  std::atomic<uint32_t> heap_allocations_{0};
+  std::atomic<uint32_t> heap_frees_{0};
+  std::atomic<uint32_t> heap_bytes_allocated_{0};
+};
+
+}  // namespace pw::unit_test
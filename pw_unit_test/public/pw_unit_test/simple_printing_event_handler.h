@@ -51,6 +51,10 @@ class SimplePrintingEventHandler : public EventHandler {
   void TestCaseExpect(const TestCase& test_case,
                       const TestExpectation& expectation) override;
   void TestCaseDisabled(const TestCase& test_case) override;
+  void TestCaseBenchmark(const TestCase& test_case,
+                         const TestBenchmark& benchmark) override;
+  void TestCaseMemoryUsage(const TestCase& test_case,
+                           const TestMemoryUsage& memory_usage) override;
 
  private:
   void WriteLine(const char* format, ...) PW_PRINTF_FORMAT(2, 3);
@@ -48,6 +48,8 @@ class UnitTestService final : public generated::UnitTest<UnitTestService> {
   void WriteTestCaseEnd(TestResult result);
   void WriteTestCaseDisabled(const TestCase& test_case);
   void WriteTestCaseExpectation(const TestExpectation& expectation);
+  void WriteTestCaseBenchmark(const TestBenchmark& benchmark);
+  void WriteTestCaseMemoryUsage(const TestMemoryUsage& memory_usage);
 
   internal::RpcEventHandler handler_;
   RawServerWriter writer_;
@@ -51,6 +51,53 @@ class TestExpectation:
         return f'TestExpectation({str(self)})'
 
 
+@dataclass(frozen=True)
+class TestBenchmark:
+    """Statistics of a benchmark; durations are of whole repetitions."""
+    name: str
+    iterations: int
+    repetitions: int
+    min_ns: int
+    mean_ns: int
+    max_ns: int
+    stddev_ns: int
+    bytes_per_iteration: int = 0
+
+    def __str__(self) -> str:
+        def per_iteration(ns: int) -> float:
+            return ns / self.iterations if self.iterations else 0.0
+
+        text = (f'{self.name}: {per_iteration(self.mean_ns):.1f} ns/iteration '
+                f'(min {per_iteration(self.min_ns):.1f}, '
+                f'max {per_iteration(self.max_ns):.1f}, '
+                f'stddev {per_iteration(self.stddev_ns):.1f}), '
+                f'{self.repetitions} repetitions of {self.iterations} '
+                'iterations')
+        if self.bytes_per_iteration and self.mean_ns:
+            # Bytes per nanosecond times 1000 is MB/s.
+            mb_per_s = (self.bytes_per_iteration * self.iterations * 1000 /
+                        self.mean_ns)
+            text += f', {mb_per_s:.1f} MB/s'
+        return text
+
+
+@dataclass(frozen=True)
+class TestMemoryUsage:
+    """The stack and heap used by a test case."""
+    stack_bytes: int
+    stack_limit_reached: bool
+    heap_allocations: int
+    heap_frees: int
+    heap_bytes_allocated: int
+
+    def __str__(self) -> str:
+        or_more = ' or more' if self.stack_limit_reached else ''
+        return (f'{self.stack_bytes} bytes of stack{or_more}, '
+                f'{self.heap_allocations} heap allocations '
+                f'({self.heap_bytes_allocated} bytes), '
+                f'{self.heap_frees} frees')
+
+
 class EventHandler(abc.ABC):
     @abc.abstractmethod
     def run_all_tests_start(self):
@@ -77,6 +124,14 @@ class EventHandler(abc.ABC):
                          expectation: TestExpectation):
         """Called after each expect/assert statement within a test case."""
 
+    def test_case_benchmark(self, test_case: TestCase,
+                            benchmark: TestBenchmark):
+        """Called when a benchmark within a test case completes."""
+
+    def test_case_memory_usage(self, test_case: TestCase,
+                               memory_usage: TestMemoryUsage):
+        """Called before test_case_end with the memory the test used."""
+
 
 class LoggingEventHandler(EventHandler):
     """Event handler that logs test events using Google Test format."""
@@ -109,6 +164,14 @@ class LoggingEventHandler(EventHandler):
         log('      Expected: %s', expectation.expression)
         log('        Actual: %s', expectation.evaluated_expression)
 
+    def test_case_benchmark(self, test_case: TestCase,
+                            benchmark: TestBenchmark):
+        _LOG.info('[ BENCHMARK] %s', benchmark)
+
+    def test_case_memory_usage(self, test_case: TestCase,
+                               memory_usage: TestMemoryUsage):
+        _LOG.info('[  MEMORY  ] %s', memory_usage)
+
 
 def run_tests(
     rpcs: pw_rpc.client.Services,
@@ -155,5 +218,30 @@ def run_tests(
                     raw_expectation.success,
                 )
                 event_handler.test_case_expect(current_test_case, expectation)
+            elif response.HasField('test_case_benchmark'):
+                raw_benchmark = response.test_case_benchmark
+                benchmark = TestBenchmark(
+                    raw_benchmark.name,
+                    raw_benchmark.iterations,
+                    raw_benchmark.repetitions,
+                    raw_benchmark.min_ns,
+                    raw_benchmark.mean_ns,
+                    raw_benchmark.max_ns,
+                    raw_benchmark.stddev_ns,
+                    raw_benchmark.bytes_per_iteration,
+                )
+                event_handler.test_case_benchmark(current_test_case,
+                                                  benchmark)
+            elif response.HasField('test_case_memory_usage'):
+                raw_memory_usage = response.test_case_memory_usage
+                memory_usage = TestMemoryUsage(
+                    raw_memory_usage.stack_bytes,
+                    raw_memory_usage.stack_limit_reached,
+                    raw_memory_usage.heap_allocations,
+                    raw_memory_usage.heap_frees,
+                    raw_memory_usage.heap_bytes_allocated,
+                )
+                event_handler.test_case_memory_usage(current_test_case,
+                                                     memory_usage)
 
     return all_tests_passed
@@ -41,4 +41,14 @@ void RpcEventHandler::TestCaseDisabled(const TestCase& test_case) {
   service_.WriteTestCaseDisabled(test_case);
 }
 
+void RpcEventHandler::TestCaseBenchmark(const TestCase&,
+                                        const TestBenchmark& benchmark) {
+  service_.WriteTestCaseBenchmark(benchmark);
+}
+
+void RpcEventHandler::TestCaseMemoryUsage(const TestCase&,
+                                          const TestMemoryUsage& memory_usage) {
+  service_.WriteTestCaseMemoryUsage(memory_usage);
+}
+
 }  // namespace pw::unit_test::internal
@@ -14,6 +14,7 @@
 
 #include "pw_log/log.h"
 #include "pw_rpc_system_server/rpc_server.h"
+#include "pw_unit_test/memory_usage.h"
 #include "pw_unit_test/unit_test_service.h"
 
 namespace {
@@ -26,6 +27,12 @@ int main() {
   pw::rpc::system_server::Init();
   pw::rpc::system_server::Server().RegisterService(unit_test_service);
 
+#if PW_UNIT_TEST_STACK_PAINT_BYTES > 0
+  pw::unit_test::MemoryUsageMonitor memory_monitor(
+      PW_UNIT_TEST_STACK_PAINT_BYTES);
+  pw::unit_test::RegisterMemoryMonitor(&memory_monitor);
+#endif  // PW_UNIT_TEST_STACK_PAINT_BYTES > 0
+
   PW_LOG_INFO("Starting pw_rpc server");
   pw::rpc::system_server::Start();
 
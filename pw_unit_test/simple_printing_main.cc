@@ -17,6 +17,7 @@
 
 #include "pw_sys_io/sys_io.h"
 #include "pw_unit_test/framework.h"
+#include "pw_unit_test/memory_usage.h"
 #include "pw_unit_test/simple_printing_event_handler.h"
 
 int main() {
@@ -30,5 +31,11 @@ int main() {
       });
 
   pw::unit_test::RegisterEventHandler(&handler);
+
+#if PW_UNIT_TEST_STACK_PAINT_BYTES > 0
+  pw::unit_test::MemoryUsageMonitor memory_monitor(
+      PW_UNIT_TEST_STACK_PAINT_BYTES);
+  pw::unit_test::RegisterMemoryMonitor(&memory_monitor);
+#endif  // PW_UNIT_TEST_STACK_PAINT_BYTES > 0
   return RUN_ALL_TESTS();
 }
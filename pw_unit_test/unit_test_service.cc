@@ -106,4 +106,34 @@ void UnitTestService::WriteTestCaseExpectation(
   });
 }
 
+void UnitTestService::WriteTestCaseBenchmark(const TestBenchmark& benchmark) {
+  WriteEvent([&](Event::Encoder& event) {
+    TestCaseBenchmark::Encoder test_case_benchmark =
+        event.GetTestCaseBenchmarkEncoder();
+    test_case_benchmark.WriteName(benchmark.name);
+    test_case_benchmark.WriteIterations(benchmark.iterations);
+    test_case_benchmark.WriteRepetitions(benchmark.repetitions);
+    test_case_benchmark.WriteMinNs(benchmark.min_ns);
+    test_case_benchmark.WriteMeanNs(benchmark.mean_ns);
+    test_case_benchmark.WriteMaxNs(benchmark.max_ns);
+    test_case_benchmark.WriteStddevNs(benchmark.stddev_ns);
+    test_case_benchmark.WriteBytesPerIteration(benchmark.bytes_per_iteration);
+  });
+}
+
+void UnitTestService::WriteTestCaseMemoryUsage(
+    const TestMemoryUsage& memory_usage) {
+  WriteEvent([&](Event::Encoder& event) {
+    TestCaseMemoryUsage::Encoder test_case_memory_usage =
+        event.GetTestCaseMemoryUsageEncoder();
+    test_case_memory_usage.WriteStackBytes(memory_usage.stack_bytes);
+    test_case_memory_usage.WriteStackLimitReached(
+        memory_usage.stack_limit_reached);
+    test_case_memory_usage.WriteHeapAllocations(memory_usage.heap_allocations);
+    test_case_memory_usage.WriteHeapFrees(memory_usage.heap_frees);
+    test_case_memory_usage.WriteHeapBytesAllocated(
+        memory_usage.heap_bytes_allocated);
+  });
+}
+
 }  // namespace pw::unit_test
@@ -0,0 +1,113 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_varint/prefix_varint.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "gtest/gtest.h"
+
+namespace pw::varint {
+namespace {
+
+TEST(PrefixVarint, EncodedSize) {
+  EXPECT_EQ(1u, PrefixEncodedSize(0));
+  EXPECT_EQ(1u, PrefixEncodedSize(127));
+  EXPECT_EQ(2u, PrefixEncodedSize(128));
+  EXPECT_EQ(2u, PrefixEncodedSize((1u << 14) - 1));
+  EXPECT_EQ(3u, PrefixEncodedSize(1u << 14));
+  EXPECT_EQ(8u, PrefixEncodedSize((uint64_t(1) << 56) - 1));
+  EXPECT_EQ(9u, PrefixEncodedSize(uint64_t(1) << 56));
+  EXPECT_EQ(9u, PrefixEncodedSize(std::numeric_limits<uint64_t>::max()));
+}
+
+TEST(PrefixVarint, Encode_KnownBytes) {
+  std::array<std::byte, kMaxPrefixVarintSizeBytes> buffer{};
+
+  ASSERT_EQ(1u, PrefixEncode(5, buffer));
+  EXPECT_EQ(std::byte{0x0b}, buffer[0]);
+
+  ASSERT_EQ(2u, PrefixEncode(300, buffer));
+  EXPECT_EQ(std::byte{0xb2}, buffer[0]);  // 300 << 2 | 0b10 = 0x4b2
+  EXPECT_EQ(std::byte{0x04}, buffer[1]);
+
+  ASSERT_EQ(9u, PrefixEncode(0x0123456789abcdef, buffer));
+  EXPECT_EQ(std::byte{0x00}, buffer[0]);
+  EXPECT_EQ(std::byte{0xef}, buffer[1]);
+  EXPECT_EQ(std::byte{0x01}, buffer[8]);
+}
+
+TEST(PrefixVarint, DecodedSize_FromFirstByte) {
+  EXPECT_EQ(1u, PrefixDecodedSize(std::byte{0xff}));
+  EXPECT_EQ(2u, PrefixDecodedSize(std::byte{0x02}));
+  EXPECT_EQ(7u, PrefixDecodedSize(std::byte{0x40}));
+  EXPECT_EQ(8u, PrefixDecodedSize(std::byte{0x80}));
+  EXPECT_EQ(9u, PrefixDecodedSize(std::byte{0x00}));
+}
+
+TEST(PrefixVarint, EncodeDecode_AllSizes) {
+  for (unsigned bits = 0; bits <= 64; ++bits) {
+    const uint64_t value =
+        bits == 64 ? std::numeric_limits<uint64_t>::max()
+                   : (uint64_t(1) << bits) - 1;
+    std::array<std::byte, kMaxPrefixVarintSizeBytes> buffer{};
+
+    const size_t size = PrefixEncode(value, buffer);
+    ASSERT_EQ(PrefixEncodedSize(value), size);
+    ASSERT_EQ(size, PrefixDecodedSize(buffer[0]));
+
+    uint64_t decoded = 0;
+    ASSERT_EQ(size, PrefixDecode(std::span(buffer).first(size), &decoded));
+    EXPECT_EQ(value, decoded);
+  }
+}
+
+TEST(PrefixVarint, EncodeFixedSize_PadsAndDecodes) {
+  std::array<std::byte, kMaxPrefixVarintSizeBytes> buffer{};
+  for (size_t size = 2; size <= kMaxPrefixVarintSizeBytes; ++size) {
+    ASSERT_EQ(size, PrefixEncode(100, size, buffer));
+    EXPECT_EQ(size, PrefixDecodedSize(buffer[0]));
+
+    uint64_t decoded = 0;
+    EXPECT_EQ(size, PrefixDecode(buffer, &decoded));
+    EXPECT_EQ(100u, decoded);
+  }
+}
+
+TEST(PrefixVarint, EncodeFixedSize_TooSmall_ReturnsZero) {
+  std::array<std::byte, kMaxPrefixVarintSizeBytes> buffer{};
+  EXPECT_EQ(0u, PrefixEncode(128, 1, buffer));
+  EXPECT_EQ(0u, PrefixEncode(1, 10, buffer));
+}
+
+TEST(PrefixVarint, Encode_OutputTooSmall_ReturnsZero) {
+  std::array<std::byte, 2> buffer{};
+  EXPECT_EQ(0u, PrefixEncode(1u << 14, buffer));
+  EXPECT_EQ(0u, PrefixEncode(0, std::span<std::byte>()));
+}
+
+TEST(PrefixVarint, Decode_Truncated_ReturnsZero) {
+  std::array<std::byte, kMaxPrefixVarintSizeBytes> buffer{};
+  ASSERT_EQ(3u, PrefixEncode(1u << 14, buffer));
+
+  uint64_t decoded = 0;
+  EXPECT_EQ(0u, PrefixDecode(std::span(buffer).first(2), &decoded));
+  EXPECT_EQ(0u, PrefixDecode(std::span<const std::byte>(), &decoded));
+}
+
+}  // namespace
+}  // namespace pw::varint
@@ -0,0 +1,125 @@
+// Copyright 2021 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "pw_polyfill/language_feature_macros.h"
+
+// Prefix varints encode an unsigned integer in 1 to 9 bytes, like LEB128
+// varints, but store the length in the first byte instead of in a continuation
+// bit in every byte. An N-byte prefix varint (N <= 8) starts with N - 1 zero
+// bits followed by a one bit, counting from the least significant bit of the
+// first byte. The remaining 7 * N bits hold the integer, little endian. A
+// first byte of 0 is followed by the full 64-bit integer in 8 bytes.
+//
+//   Size  First byte   Integer bits
+//   1     xxxxxxx1     7
+//   2     xxxxxx10     14
+//   ...
+//   8     10000000     56
+//   9     00000000     64
+//
+// Since the size is known from the first byte, a decoder can read or skip a
+// prefix varint without a loop, and encoding and decoding each need a single
+// branch. Prefix varints are not compatible with protobuf varints; use them
+// for internal formats only.
+namespace pw::varint {
+
+// The maximum number of bytes occupied by a prefix varint.
+PW_INLINE_VARIABLE constexpr size_t kMaxPrefixVarintSizeBytes = 9;
+
+// Returns the number of bytes needed to prefix varint encode the integer.
+constexpr size_t PrefixEncodedSize(uint64_t integer) {
+  const size_t bits = size_t(64 - __builtin_clzll(integer | 1u));
+  return bits > 56u ? kMaxPrefixVarintSizeBytes : (bits + 6) / 7;
+}
+
+// Returns the size of a prefix varint from its first byte.
+constexpr size_t PrefixDecodedSize(std::byte first_byte) {
+  return size_t(__builtin_ctz(unsigned(first_byte) | 0x100u)) + 1;
+}
+
+namespace internal {
+
+// Stores the low size_bytes bytes of the word in little-endian order.
+inline void StorePrefixVarint(uint64_t word,
+                              size_t size_bytes,
+                              std::byte* output) {
+  for (size_t i = 0; i < size_bytes; ++i) {
+    output[i] = std::byte(word >> (8 * i));
+  }
+}
+
+// Loads size_bytes bytes (at most 8) as a little-endian word.
+inline uint64_t LoadPrefixVarint(const std::byte* input, size_t size_bytes) {
+  uint64_t word = 0;
+  for (size_t i = 0; i < size_bytes; ++i) {
+    word |= uint64_t(input[i]) << (8 * i);
+  }
+  return word;
+}
+
+}  // namespace internal
+
+// Encodes the integer as a prefix varint of exactly size_bytes bytes, which
+// allows reserving a fixed-size field and filling it in later. Returns the
+// number of bytes written, or 0 if size_bytes is too small for the integer,
+// larger than kMaxPrefixVarintSizeBytes, or larger than the output.
+inline size_t PrefixEncode(uint64_t integer,
+                           size_t size_bytes,
+                           std::span<std::byte> output) {
+  if (size_bytes < PrefixEncodedSize(integer) ||
+      size_bytes > kMaxPrefixVarintSizeBytes || size_bytes > output.size()) {
+    return 0;
+  }
+  if (size_bytes == kMaxPrefixVarintSizeBytes) {
+    output[0] = std::byte{0};
+    internal::StorePrefixVarint(integer, 8, &output[1]);
+  } else {
+    internal::StorePrefixVarint(
+        (integer << size_bytes) | (uint64_t(1) << (size_bytes - 1)),
+        size_bytes,
+        output.data());
+  }
+  return size_bytes;
+}
+
+// Encodes the integer as a prefix varint in as few bytes as possible. Returns
+// the number of bytes written, or 0 if the output is too small.
+inline size_t PrefixEncode(uint64_t integer, std::span<std::byte> output) {
+  return PrefixEncode(integer, PrefixEncodedSize(integer), output);
+}
+
+// Decodes a prefix varint. Returns the number of bytes read, or 0 if the input
+// is shorter than the varint.
+inline size_t PrefixDecode(std::span<const std::byte> input, uint64_t* value) {
+  if (input.empty()) {
+    return 0;
+  }
+  const size_t size_bytes = PrefixDecodedSize(input[0]);
+  if (size_bytes > input.size()) {
+    return 0;
+  }
+  if (size_bytes == kMaxPrefixVarintSizeBytes) {
+    *value = internal::LoadPrefixVarint(&input[1], 8);
+  } else {
+    *value = internal::LoadPrefixVarint(input.data(), size_bytes) >> size_bytes;
+  }
+  return size_bytes;
+}
+
+}  // namespace pw::varint
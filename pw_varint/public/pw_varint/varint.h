@@ -133,6 +133,33 @@ inline size_t Decode(const std::span<const std::byte>& input, uint64_t* value) {
   return pw_VarintDecode(input.data(), input.size(), value);
 }
 
+// Encodes a sequence of integers as consecutive varints, such as the contents
+// of a packed repeated protobuf field. Signed integers are ZigZag encoded.
+//
+// Returns the number of bytes written, or 0 if the encoded integers did not all
+// fit in the output. Varints of up to 8 bytes are written with a single 8-byte
+// store when there is room, so bytes of the output after the returned size may
+// be overwritten.
+size_t EncodeMany(std::span<const uint64_t> integers,
+                  std::span<std::byte> output);
+size_t EncodeMany(std::span<const int64_t> integers,
+                  std::span<std::byte> output);
+
+// Decodes consecutive varints from the input until the input or the output is
+// exhausted, or an invalid or truncated varint is found. Values decoded into
+// signed integers are ZigZag decoded. Varints of up to 8 bytes are decoded a
+// word at a time, without branching on each byte.
+//
+// Returns the number of integers decoded. If bytes_read is provided, it is set
+// to the number of input bytes consumed; if this is less than the input size
+// and the output is not full, the input contained an invalid varint.
+size_t DecodeMany(std::span<const std::byte> input,
+                  std::span<uint64_t> output,
+                  size_t* bytes_read = nullptr);
+size_t DecodeMany(std::span<const std::byte> input,
+                  std::span<int64_t> output,
+                  size_t* bytes_read = nullptr);
+
 // Returns a size of an integer when encoded as a varint.
 constexpr size_t EncodedSize(uint64_t integer) {
   return integer == 0 ? 1 : (64 - __builtin_clzll(integer) + 6) / 7;
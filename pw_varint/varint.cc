@@ -15,13 +15,155 @@
 #include "pw_varint/varint.h"
 
 #include <algorithm>
+#include <cstring>
+#include <type_traits>
 
 namespace pw {
 namespace varint {
+namespace {
+
+// The continuation bit of each byte in a 64-bit word.
+constexpr uint64_t kContinuationBits = 0x8080808080808080u;
+
+// Varints of up to 8 bytes, which hold up to 56 bits, are encoded and decoded
+// a word at a time.
+constexpr size_t kWordSizeBytes = 8;
+constexpr uint64_t kMaxWordVarint = (uint64_t(1) << 56) - 1;
+
+// Reads 8 bytes as a little-endian word.
+uint64_t ReadWord(const std::byte* bytes) {
+  uint64_t word;
+  std::memcpy(&word, bytes, sizeof(word));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  word = __builtin_bswap64(word);
+#endif  // __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  return word;
+}
+
+// Packs the low 7 bits of each byte of the word into a 56-bit integer.
+constexpr uint64_t CompressGroups(uint64_t word) {
+  word &= ~kContinuationBits;
+  word = ((word & 0x7f007f007f007f00u) >> 1) | (word & 0x007f007f007f007fu);
+  word = ((word & 0x3fff00003fff0000u) >> 2) | (word & 0x00003fff00003fffu);
+  word = ((word & 0x0fffffff00000000u) >> 4) | (word & 0x000000000fffffffu);
+  return word;
+}
+
+// Spreads a 56-bit integer into 7-bit groups, one per byte. The inverse of
+// CompressGroups.
+constexpr uint64_t SpreadGroups(uint64_t value) {
+  value = ((value & 0x00fffffff0000000u) << 4) | (value & 0x000000000fffffffu);
+  value = ((value & 0x0fffc0000fffc000u) << 2) | (value & 0x00003fff00003fffu);
+  value = ((value & 0x3f803f803f803f80u) << 1) | (value & 0x007f007f007f007fu);
+  return value;
+}
+
+static_assert(CompressGroups(SpreadGroups(kMaxWordVarint)) == kMaxWordVarint);
+static_assert(SpreadGroups(300) == 0x022c);
+
+// Decodes a varint of up to 8 bytes from a word without a branch per byte.
+// Returns 0 if the word contains no terminating byte.
+size_t DecodeWord(const std::byte* input, uint64_t* output) {
+  // Single-byte varints are the most common, so check for them first.
+  if ((input[0] & std::byte(0x80)) == std::byte(0)) {
+    *output = uint64_t(input[0]);
+    return 1;
+  }
+
+  const uint64_t word = ReadWord(input);
+  const uint64_t terminators = ~word & kContinuationBits;
+  if (terminators == 0u) {
+    return 0;
+  }
+
+  // The lowest terminator bit is the top bit of the varint's last byte.
+  const unsigned bits = unsigned(__builtin_ctzll(terminators)) + 1;
+  const uint64_t varint =
+      bits == 64u ? word : word & ((uint64_t(1) << bits) - 1);
+  *output = CompressGroups(varint);
+  return bits / 8;
+}
+
+// EncodedSize without a branch for 0.
+constexpr size_t BranchlessEncodedSize(uint64_t integer) {
+  return size_t(64 - __builtin_clzll(integer | 1u) + 6) / 7;
+}
+
+// Returns the encoding of an integer of up to 56 bits as a little-endian word.
+constexpr uint64_t EncodeToWord(uint64_t integer, size_t size) {
+  return SpreadGroups(integer) |
+         (kContinuationBits & ((uint64_t(1) << (8 * (size - 1))) - 1));
+}
+
+// Encodes an integer of up to 56 bits without a branch per bit group.
+size_t EncodeWord(uint64_t integer, std::byte* output) {
+  const size_t size = EncodedSize(integer);
+  const uint64_t word = EncodeToWord(integer, size);
+  for (size_t i = 0; i < size; ++i) {
+    output[i] = std::byte(word >> (8 * i));
+  }
+  return size;
+}
+
+// Encodes an integer of up to 56 bits with a single 8-byte store. The output
+// must have room for 8 bytes; bytes after the varint are overwritten.
+size_t EncodeWordUnchecked(uint64_t integer, std::byte* output) {
+  const size_t size = BranchlessEncodedSize(integer);
+  uint64_t word = EncodeToWord(integer, size);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  word = __builtin_bswap64(word);
+#endif  // __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  std::memcpy(output, &word, sizeof(word));
+  return size;
+}
+
+template <typename T>
+size_t EncodeManyImpl(std::span<const T> integers,
+                          std::span<std::byte> output) {
+  size_t written = 0;
+  for (T value : integers) {
+    uint64_t integer;
+    if constexpr (std::is_signed_v<T>) {
+      integer = ZigZagEncode(value);
+    } else {
+      integer = value;
+    }
+
+    // Single-byte varints are the most common, so check for them first.
+    if (integer < 0x80u && written < output.size()) {
+      output[written++] = std::byte(integer);
+      continue;
+    }
+
+    size_t size;
+    if (integer <= kMaxWordVarint &&
+        output.size() - written >= kWordSizeBytes) {
+      size = EncodeWordUnchecked(integer, output.data() + written);
+    } else {
+      size = pw_VarintEncode(
+          integer, output.data() + written, output.size() - written);
+      if (size == 0u) {
+        return 0;
+      }
+    }
+    written += size;
+  }
+  return written;
+}
+
+}  // namespace
 
 extern "C" size_t pw_VarintEncode(uint64_t integer,
                                   void* output,
                                   size_t output_size) {
+  if (integer < 0x80u && output_size != 0u) {
+    *static_cast<std::byte*>(output) = std::byte(integer);
+    return 1;
+  }
+  if (integer <= kMaxWordVarint && EncodedSize(integer) <= output_size) {
+    return EncodeWord(integer, static_cast<std::byte*>(output));
+  }
+
   size_t written = 0;
   std::byte* buffer = static_cast<std::byte*>(output);
 
@@ -52,6 +194,12 @@ extern "C" size_t pw_VarintDecode(const void* input,
   uint_fast8_t count = 0;
   const std::byte* buffer = static_cast<const std::byte*>(input);
 
+  if (input_size >= kWordSizeBytes) {
+    if (const size_t size = DecodeWord(buffer, output); size != 0u) {
+      return size;
+    }
+  }
+
   // The largest 64-bit ints require 10 B.
   const size_t max_count = std::min(kMaxVarint64SizeBytes, input_size);
 
@@ -83,6 +231,62 @@ extern "C" size_t pw_VarintZigZagDecode(const void* input,
   return bytes;
 }
 
+size_t EncodeMany(std::span<const uint64_t> integers,
+                  std::span<std::byte> output) {
+  return EncodeManyImpl(integers, output);
+}
+
+size_t EncodeMany(std::span<const int64_t> integers,
+                  std::span<std::byte> output) {
+  return EncodeManyImpl(integers, output);
+}
+
+size_t DecodeMany(std::span<const std::byte> input,
+                  std::span<uint64_t> output,
+                  size_t* bytes_read) {
+  const std::byte* const begin = input.data();
+  const std::byte* const end = begin + input.size();
+  const std::byte* position = begin;
+  size_t decoded = 0;
+
+  // While 8 bytes remain, decode a word at a time. Fall back to the bytewise
+  // decoder for the tail of the input and for varints longer than 8 bytes.
+  while (decoded < output.size() && position != end) {
+    size_t size = 0;
+    if (size_t(end - position) >= kWordSizeBytes) {
+      size = DecodeWord(position, &output[decoded]);
+    }
+    if (size == 0u) {
+      size = pw_VarintDecode(position, end - position, &output[decoded]);
+      if (size == 0u) {
+        break;
+      }
+    }
+    position += size;
+    decoded += 1;
+  }
+
+  if (bytes_read != nullptr) {
+    *bytes_read = size_t(position - begin);
+  }
+  return decoded;
+}
+
+size_t DecodeMany(std::span<const std::byte> input,
+                  std::span<int64_t> output,
+                  size_t* bytes_read) {
+  // Decode in place, accessing the output as uint64_t (which may alias
+  // int64_t), then ZigZag decode each value.
+  const size_t decoded = DecodeMany(
+      input,
+      std::span(reinterpret_cast<uint64_t*>(output.data()), output.size()),
+      bytes_read);
+  for (size_t i = 0; i < decoded; ++i) {
+    output[i] = ZigZagDecode(static_cast<uint64_t>(output[i]));
+  }
+  return decoded;
+}
+
 extern "C" size_t pw_VarintEncodedSize(uint64_t integer) {
   return EncodedSize(integer);
 }
@@ -17,6 +17,7 @@
 #include <cinttypes>
 #include <cstdint>
 #include <cstring>
+#include <array>
 #include <limits>
 
 #include "gtest/gtest.h"
@@ -825,5 +826,128 @@ TEST(Varint, ZigZagEncodedSize) {
   EXPECT_EQ(ZigZagEncodedSize(std::numeric_limits<int64_t>::max()), 10u);
 }
 
+// Values at every boundary between encoded sizes, to cover the word-at-a-time
+// and bytewise paths.
+std::array<uint64_t, 30> BoundaryValues() {
+  std::array<uint64_t, 30> values{};
+  size_t i = 0;
+  for (unsigned bits = 7; bits < 64; bits += 7) {
+    values[i++] = (uint64_t(1) << bits) - 1;
+    values[i++] = uint64_t(1) << bits;
+    values[i++] = (uint64_t(1) << bits) + 1;
+  }
+  values[i++] = 0;
+  values[i++] = 1;
+  values[i++] = std::numeric_limits<uint64_t>::max();
+  return values;
+}
+
+TEST(Varint, EncodeDecode_AllSizes_MatchesBytewise) {
+  for (uint64_t value : BoundaryValues()) {
+    // Large output and input buffers take the word-at-a-time paths.
+    std::array<std::byte, 16> buffer{};
+    const size_t size = Encode(value, buffer);
+    ASSERT_EQ(EncodedSize(value), size);
+
+    uint64_t decoded = 0;
+    ASSERT_EQ(size, Decode(buffer, &decoded));
+    EXPECT_EQ(value, decoded);
+
+    // Exactly-sized buffers take the bytewise paths.
+    std::array<std::byte, 16> exact{};
+    ASSERT_EQ(size, Encode(value, std::span(exact).first(size)));
+    EXPECT_EQ(0, std::memcmp(buffer.data(), exact.data(), size));
+
+    decoded = 0;
+    ASSERT_EQ(size, Decode(std::span(exact).first(size), &decoded));
+    EXPECT_EQ(value, decoded);
+  }
+}
+
+TEST(Varint, EncodeMany_DecodeMany_Unsigned) {
+  const std::array<uint64_t, 30> values = BoundaryValues();
+  std::array<std::byte, 30 * kMaxVarint64SizeBytes> buffer;
+
+  const size_t size = EncodeMany(values, buffer);
+  size_t expected_size = 0;
+  for (uint64_t value : values) {
+    expected_size += EncodedSize(value);
+  }
+  ASSERT_EQ(expected_size, size);
+
+  std::array<uint64_t, 30> decoded{};
+  size_t bytes_read = 0;
+  EXPECT_EQ(values.size(),
+            DecodeMany(std::span(buffer).first(size), decoded, &bytes_read));
+  EXPECT_EQ(size, bytes_read);
+  EXPECT_EQ(values, decoded);
+}
+
+TEST(Varint, EncodeMany_DecodeMany_Signed) {
+  constexpr std::array<int64_t, 6> kValues = {
+      0, -1, 1, -300, std::numeric_limits<int64_t>::min(), 123456789};
+  std::array<std::byte, 64> buffer;
+
+  const size_t size = EncodeMany(kValues, buffer);
+  ASSERT_NE(0u, size);
+
+  std::array<int64_t, 6> decoded{};
+  EXPECT_EQ(kValues.size(), DecodeMany(std::span(buffer).first(size), decoded));
+  EXPECT_EQ(kValues, decoded);
+}
+
+TEST(Varint, EncodeMany_ExactlySizedOutput) {
+  constexpr std::array<uint64_t, 4> kValues = {70000, 1, 300, 0x123456789};
+  std::array<std::byte, 3 + 1 + 2 + 5> expected;
+  size_t size = 0;
+  for (uint64_t value : kValues) {
+    size += Encode(value, std::span(expected).subspan(size));
+  }
+  ASSERT_EQ(expected.size(), size);
+
+  std::array<std::byte, expected.size()> output{};
+  EXPECT_EQ(expected.size(), EncodeMany(kValues, output));
+  EXPECT_EQ(expected, output);
+}
+
+TEST(Varint, EncodeMany_OutputTooSmall_ReturnsZero) {
+  constexpr std::array<uint64_t, 3> kValues = {1, 300, 70000};
+  std::array<std::byte, 5> buffer;
+  EXPECT_EQ(0u, EncodeMany(kValues, buffer));
+}
+
+TEST(Varint, DecodeMany_StopsWhenOutputFull) {
+  constexpr std::array<uint64_t, 3> kValues = {1, 300, 70000};
+  std::array<std::byte, 16> buffer;
+  ASSERT_EQ(6u, EncodeMany(kValues, buffer));
+
+  std::array<uint64_t, 2> decoded{};
+  size_t bytes_read = 0;
+  EXPECT_EQ(2u, DecodeMany(buffer, decoded, &bytes_read));
+  EXPECT_EQ(3u, bytes_read);
+  EXPECT_EQ(1u, decoded[0]);
+  EXPECT_EQ(300u, decoded[1]);
+}
+
+TEST(Varint, DecodeMany_StopsAtTruncatedVarint) {
+  constexpr std::array<std::byte, 4> kInput = {
+      std::byte{0x05}, std::byte{0xac}, std::byte{0x02}, std::byte{0x80}};
+  std::array<uint64_t, 4> decoded{};
+  size_t bytes_read = 0;
+  EXPECT_EQ(2u, DecodeMany(kInput, decoded, &bytes_read));
+  EXPECT_EQ(3u, bytes_read);
+  EXPECT_EQ(5u, decoded[0]);
+  EXPECT_EQ(300u, decoded[1]);
+}
+
+TEST(Varint, DecodeMany_StopsAtOverlongVarint) {
+  std::array<std::byte, 12> input;
+  input.fill(std::byte{0xff});
+  std::array<uint64_t, 2> decoded{};
+  size_t bytes_read = 1;
+  EXPECT_EQ(0u, DecodeMany(input, decoded, &bytes_read));
+  EXPECT_EQ(0u, bytes_read);
+}
+
 }  // namespace
 }  // namespace pw::varint